@@ -32,6 +32,13 @@ void ReleaseFreeMemory() {
     release_free_memory_function();
 }
 
+void GetHeapSample(std::string* writer) {
+  thunks::GetHeapSampleFunction get_heap_sample_function =
+      base::allocator::thunks::GetGetHeapSampleFunction();
+  if (get_heap_sample_function)
+    get_heap_sample_function(writer);
+}
+
 void SetGetPropertyFunction(
     thunks::GetPropertyFunction get_property_function) {
   DCHECK_EQ(base::allocator::thunks::GetGetPropertyFunction(),
@@ -53,5 +60,12 @@ void SetReleaseFreeMemoryFunction(
       release_free_memory_function);
 }
 
+void SetGetHeapSampleFunction(
+    thunks::GetHeapSampleFunction get_heap_sample_function) {
+  DCHECK_EQ(base::allocator::thunks::GetGetHeapSampleFunction(),
+            reinterpret_cast<thunks::GetHeapSampleFunction>(NULL));
+  base::allocator::thunks::SetGetHeapSampleFunction(get_heap_sample_function);
+}
+
 }  // namespace allocator
 }  // namespace base
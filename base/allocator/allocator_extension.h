@@ -7,6 +7,8 @@
 
 #include <stddef.h> // for size_t
 
+#include <string>
+
 #include "base/allocator/allocator_extension_thunks.h"
 #include "base/base_export.h"
 #include "build/build_config.h"
@@ -34,6 +36,14 @@ BASE_EXPORT void GetStats(char* buffer, int buffer_length);
 // system.
 BASE_EXPORT void ReleaseFreeMemory();
 
+// Request that the allocator append the stack traces of a sample of the
+// live allocations, along with the bytes attributed to each, to |writer|.
+// The output is in the text heap profile format understood by pprof. It is
+// empty unless the allocator supports sampling and sampling was enabled when
+// the process started; for tcmalloc, by setting TCMALLOC_SAMPLE_PARAMETER to
+// the average number of bytes allocated between two samples.
+BASE_EXPORT void GetHeapSample(std::string* writer);
+
 
 // These settings allow specifying a callback used to implement the allocator
 // extension functions.  These are optional, but if set they must only be set
@@ -52,6 +62,9 @@ BASE_EXPORT void SetGetStatsFunction(
 BASE_EXPORT void SetReleaseFreeMemoryFunction(
     thunks::ReleaseFreeMemoryFunction release_free_memory_function);
 
+BASE_EXPORT void SetGetHeapSampleFunction(
+    thunks::GetHeapSampleFunction get_heap_sample_function);
+
 }  // namespace allocator
 }  // namespace base
 
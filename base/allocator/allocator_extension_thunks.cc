@@ -20,6 +20,7 @@ namespace thunks {
 static GetPropertyFunction g_get_property_function = NULL;
 static GetStatsFunction g_get_stats_function = NULL;
 static ReleaseFreeMemoryFunction g_release_free_memory_function = NULL;
+static GetHeapSampleFunction g_get_heap_sample_function = NULL;
 
 void SetGetPropertyFunction(GetPropertyFunction get_property_function) {
   g_get_property_function = get_property_function;
@@ -46,6 +47,14 @@ ReleaseFreeMemoryFunction GetReleaseFreeMemoryFunction() {
   return g_release_free_memory_function;
 }
 
+void SetGetHeapSampleFunction(GetHeapSampleFunction get_heap_sample_function) {
+  g_get_heap_sample_function = get_heap_sample_function;
+}
+
+GetHeapSampleFunction GetGetHeapSampleFunction() {
+  return g_get_heap_sample_function;
+}
+
 }  // namespace thunks
 }  // namespace allocator
 }  // namespace base
@@ -7,6 +7,8 @@
 
 #include <stddef.h> // for size_t
 
+#include <string>
+
 namespace base {
 namespace allocator {
 namespace thunks {
@@ -28,6 +30,10 @@ void SetReleaseFreeMemoryFunction(
     ReleaseFreeMemoryFunction release_free_memory_function);
 ReleaseFreeMemoryFunction GetReleaseFreeMemoryFunction();
 
+typedef void (*GetHeapSampleFunction)(std::string* writer);
+void SetGetHeapSampleFunction(GetHeapSampleFunction get_heap_sample_function);
+GetHeapSampleFunction GetGetHeapSampleFunction();
+
 }  // namespace thunks
 }  // namespace allocator
 }  // namespace base
@@ -278,6 +278,10 @@ static void release_free_memory_thunk() {
   MallocExtension::instance()->ReleaseFreeMemory();
 }
 
+static void get_heap_sample_thunk(std::string* writer) {
+  MallocExtension::instance()->GetHeapSample(writer);
+}
+
 // The CRT heap initialization stub.
 extern "C" int _heap_init() {
 #ifdef ENABLE_DYNAMIC_ALLOCATOR_SWITCHING
@@ -327,6 +331,7 @@ extern "C" int _heap_init() {
   base::allocator::thunks::SetGetStatsFunction(get_stats_thunk);
   base::allocator::thunks::SetReleaseFreeMemoryFunction(
       release_free_memory_thunk);
+  base::allocator::thunks::SetGetHeapSampleFunction(get_heap_sample_thunk);
 
   return 1;
 }
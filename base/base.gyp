@@ -416,6 +416,7 @@
         'json/string_escape_unittest.cc',
         'lazy_instance_unittest.cc',
         'linked_list_unittest.cc',
+        'lock_free_task_queue_unittest.cc',
         'logging_unittest.cc',
         'mac/bind_objc_block_unittest.mm',
         'mac/foundation_util_unittest.mm',
@@ -425,6 +426,7 @@
         'md5_unittest.cc',
         'memory/aligned_memory_unittest.cc',
         'memory/linked_ptr_unittest.cc',
+        'memory/memory_pressure_listener_unittest.cc',
         'memory/mru_cache_unittest.cc',
         'memory/ref_counted_memory_unittest.cc',
         'memory/ref_counted_unittest.cc',
@@ -790,6 +792,24 @@
         }],
       ],
     },
+    {
+      'target_name': 'base_perftests',
+      'type': '<(gtest_target_type)',
+      'dependencies': [
+        'base',
+        'test_support_base',
+        'test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'sources': [
+        'json/json_parser_perftest.cc',
+        'message_loop_perftest.cc',
+        'sha1_perftest.cc',
+        'threading/sequenced_worker_pool_perftest.cc',
+        'tracked_objects_perftest.cc',
+        'utf_string_conversions_perftest.cc',
+      ],
+    },
   ],
   'conditions': [
     ['OS!="ios"', {
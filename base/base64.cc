@@ -4,23 +4,18 @@
 
 #include "base/base64.h"
 
+#include <string.h>
+
 #include "third_party/modp_b64/modp_b64.h"
 
 namespace base {
 
 bool Base64Encode(const StringPiece& input, std::string* output) {
+  // |input| may point into |output|, so encode into a separate string.
   std::string temp;
-  temp.resize(modp_b64_encode_len(input.size()));  // makes room for null byte
-
-  // null terminates result since result is base64 text!
-  int input_size = static_cast<int>(input.size());
-
-  // modp_b64_encode_len() returns at least 1, so temp[0] is safe to use.
-  int output_size = modp_b64_encode(&(temp[0]), input.data(), input_size);
-  if (output_size < 0)
-    return false;
-
-  temp.resize(output_size);  // strips off null byte
+  temp.resize(Base64EncodedLength(input.size()));
+  if (!temp.empty())
+    Base64EncodeToBuffer(input, &temp[0]);
   output->swap(temp);
   return true;
 }
@@ -40,4 +35,44 @@ bool Base64Decode(const StringPiece& input, std::string* output) {
   return true;
 }
 
+size_t Base64EncodedLength(size_t input_len) {
+  // modp_b64_encode_len() includes room for a null byte.
+  return modp_b64_encode_len(input_len) - 1;
+}
+
+size_t Base64EncodeToBuffer(const StringPiece& input, char* output) {
+  // modp_b64_encode() null-terminates its output. Encode all but the last
+  // group of up to three bytes in place, so that the null byte lands where
+  // that group goes, and encode the last group on the stack.
+  size_t input_size = input.size();
+  if (!input_size)
+    return 0;
+  size_t head_size = (input_size - 1) / 3 * 3;
+  size_t output_size = modp_b64_encode(output, input.data(),
+                                       static_cast<int>(head_size));
+
+  char tail[modp_b64_encode_len(3)];
+  int tail_size = modp_b64_encode(tail, input.data() + head_size,
+                                  static_cast<int>(input_size - head_size));
+  memcpy(output + output_size, tail, tail_size);
+  return output_size + tail_size;
+}
+
+size_t Base64DecodedMaxLength(size_t input_len) {
+  // This is tighter than modp_b64_decode_len(): the decoder never writes past
+  // the bytes it produces.
+  return (input_len + 3) / 4 * 3;
+}
+
+bool Base64DecodeToBuffer(const StringPiece& input,
+                          char* output,
+                          size_t* output_len) {
+  int output_size = modp_b64_decode(output, input.data(),
+                                    static_cast<int>(input.size()));
+  if (output_size < 0)
+    return false;
+  *output_len = output_size;
+  return true;
+}
+
 }  // namespace base
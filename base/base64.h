@@ -20,6 +20,29 @@ BASE_EXPORT bool Base64Encode(const StringPiece& input, std::string* output);
 // otherwise.  The output string is only modified if successful.
 BASE_EXPORT bool Base64Decode(const StringPiece& input, std::string* output);
 
+// The following functions work on caller-provided buffers, so that callers
+// that hash, sign or embed the result need no intermediate std::string.
+
+// Returns the length of the base64 encoding of |input_len| bytes.
+BASE_EXPORT size_t Base64EncodedLength(size_t input_len);
+
+// Encodes |input| in base64 into |output|, which must have room for
+// Base64EncodedLength(input.size()) characters, and returns the number of
+// characters written. The output is not null-terminated.
+BASE_EXPORT size_t Base64EncodeToBuffer(const StringPiece& input, char* output);
+
+// Returns the maximum number of bytes that decoding |input_len| base64
+// characters can produce.
+BASE_EXPORT size_t Base64DecodedMaxLength(size_t input_len);
+
+// Decodes the base64 |input| into |output|, which must have room for
+// Base64DecodedMaxLength(input.size()) bytes. Returns true and puts the
+// number of bytes written in |*output_len| if successful; the contents of
+// |output| are undefined otherwise.
+BASE_EXPORT bool Base64DecodeToBuffer(const StringPiece& input,
+                                      char* output,
+                                      size_t* output_len);
+
 }  // namespace base
 
 #endif  // BASE_BASE64_H__
@@ -25,4 +25,42 @@ TEST(Base64Test, Basic) {
   EXPECT_EQ(kText, decoded);
 }
 
+TEST(Base64Test, InPlace) {
+  std::string text = "hello world";
+  EXPECT_TRUE(Base64Encode(text, &text));
+  EXPECT_EQ("aGVsbG8gd29ybGQ=", text);
+  EXPECT_TRUE(Base64Decode(text, &text));
+  EXPECT_EQ("hello world", text);
+}
+
+TEST(Base64Test, Buffers) {
+  const std::string kText = "Many hands make light work.";
+
+  // Cover every length of the final group, with a guard byte after the
+  // output to catch overruns.
+  for (size_t length = 0; length <= kText.size(); ++length) {
+    StringPiece input(kText.data(), length);
+    std::string expected;
+    EXPECT_TRUE(Base64Encode(input, &expected));
+    ASSERT_EQ(expected.size(), Base64EncodedLength(length));
+
+    std::string encoded(expected.size() + 1, '#');
+    EXPECT_EQ(expected.size(), Base64EncodeToBuffer(input, &encoded[0]));
+    EXPECT_EQ(expected + "#", encoded);
+
+    size_t max_length = Base64DecodedMaxLength(encoded.size() - 1);
+    std::string decoded(max_length + 1, '#');
+    size_t decoded_length = 0;
+    EXPECT_TRUE(Base64DecodeToBuffer(expected, &decoded[0], &decoded_length));
+    EXPECT_EQ(length, decoded_length);
+    EXPECT_EQ(input, StringPiece(decoded.data(), decoded_length));
+    EXPECT_EQ('#', decoded[max_length]);
+  }
+
+  char buffer[16];
+  size_t decoded_length = 0;
+  EXPECT_FALSE(Base64DecodeToBuffer("aGVsbG8", buffer, &decoded_length));
+  EXPECT_FALSE(Base64DecodeToBuffer("aGV*bG8=", buffer, &decoded_length));
+}
+
 }  // namespace base
@@ -6,6 +6,7 @@
 
 #include <string.h>
 
+#include "base/basictypes.h"
 #include "build/build_config.h"
 
 #if defined(ARCH_CPU_X86_FAMILY)
@@ -30,6 +31,9 @@ CPU::CPU()
     has_ssse3_(false),
     has_sse41_(false),
     has_sse42_(false),
+    has_avx_(false),
+    has_avx2_(false),
+    has_sha_(false),
     cpu_vendor_("unknown") {
   Initialize();
 }
@@ -78,6 +82,19 @@ void __cpuidex(int cpu_info[4], int info_type, int info_index) {
 }
 
 #endif
+
+// Reads an extended control register.  Spelled as bytes because older
+// assemblers do not know the xgetbv mnemonic.
+uint64 _xgetbv(uint32 xcr) {
+  uint32 eax, edx;
+  __asm__ volatile (
+    ".byte 0x0f, 0x01, 0xd0\n"
+    : "=a"(eax), "=d"(edx)
+    : "c"(xcr)
+  );
+  return (static_cast<uint64>(edx) << 32) | eax;
+}
+
 #endif  // _MSC_VER
 #endif  // ARCH_CPU_X86_FAMILY
 
@@ -118,6 +135,18 @@ void CPU::Initialize() {
     has_ssse3_ = (cpu_info[2] & 0x00000200) != 0;
     has_sse41_ = (cpu_info[2] & 0x00080000) != 0;
     has_sse42_ = (cpu_info[2] & 0x00100000) != 0;
+    // AVX needs both the CPU flag and the OS enabling XSAVE of the XMM and
+    // YMM state, which XCR0 bits 1 and 2 report.
+    has_avx_ = (cpu_info[2] & 0x10000000) != 0 &&
+               (cpu_info[2] & 0x08000000) != 0 &&
+               (_xgetbv(0) & 6) == 6;
+  }
+
+  // Structured extended feature flags.
+  if (num_ids >= 7) {
+    __cpuidex(cpu_info, 7, 0);
+    has_sha_ = (cpu_info[1] & 0x20000000) != 0;
+    has_avx2_ = has_avx_ && (cpu_info[1] & 0x00000020) != 0;
   }
 #endif
 }
@@ -32,6 +32,10 @@ class BASE_EXPORT CPU {
   bool has_ssse3() const { return has_ssse3_; }
   bool has_sse41() const { return has_sse41_; }
   bool has_sse42() const { return has_sse42_; }
+  // AVX and AVX2 are only reported when the OS saves the YMM registers.
+  bool has_avx() const { return has_avx_; }
+  bool has_avx2() const { return has_avx2_; }
+  bool has_sha() const { return has_sha_; }
 
  private:
   // Query the processor for CPUID information.
@@ -50,6 +54,9 @@ class BASE_EXPORT CPU {
   bool has_ssse3_;
   bool has_sse41_;
   bool has_sse42_;
+  bool has_avx_;
+  bool has_avx2_;
+  bool has_sha_;
   std::string cpu_vendor_;
 };
 
@@ -43,7 +43,13 @@ namespace debug {
 // Controls the number of trace events we will buffer in-memory
 // before throwing them away.
 const size_t kTraceEventBufferSize = 500000;
+// The number of events kept in RECORD_CONTINUOUSLY mode before the oldest
+// ones get overwritten.
+const size_t kTraceEventRingBufferSize = kTraceEventBufferSize / 4;
 const size_t kTraceEventBatchSize = 1000;
+// The number of events a thread buffers privately before moving them to the
+// main buffer under TraceLog::lock_.
+const size_t kTraceEventThreadChunkSize = 64;
 
 #define TRACE_EVENT_MAX_CATEGORIES 100
 
@@ -66,10 +72,6 @@ const int g_category_categories_exhausted = 1;
 const int g_category_metadata = 2;
 int g_category_index = 3; // skip initial 3 categories
 
-// The most-recently captured name of the current thread
-LazyInstance<ThreadLocalPointer<const char> >::Leaky
-    g_current_thread_name = LAZY_INSTANCE_INITIALIZER;
-
 void AppendValueAsJSON(unsigned char type,
                        TraceEvent::TraceValue value,
                        std::string* out) {
@@ -318,6 +320,82 @@ void TraceResultBuffer::Finish() {
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+// The events recorded by one thread since they were last moved to the main
+// buffer. Owned by the TraceLog and kept after its thread exits so that its
+// events still get flushed.
+class TraceLog::ThreadLocalEventBuffer {
+ public:
+  ThreadLocalEventBuffer()
+      : thread_id_(static_cast<int>(PlatformThread::CurrentId())),
+        current_thread_name_(NULL),
+        first_event_index_(0) {
+  }
+
+  int thread_id() const { return thread_id_; }
+
+  // Only accessed on the owning thread.
+  const char* current_thread_name() const { return current_thread_name_; }
+  void set_current_thread_name(const char* name) {
+    current_thread_name_ = name;
+  }
+
+  Lock* lock() { return &lock_; }
+
+  // The remaining methods must be called with lock() held.
+
+  bool IsFull() const { return events_.size() >= kTraceEventThreadChunkSize; }
+
+  // Returns an index that identifies |event| to FindEvent() and
+  // RemoveEvent() for as long as it remains in this buffer.
+  int AddEvent(const TraceEvent& event) {
+    if (events_.empty())
+      events_.reserve(kTraceEventThreadChunkSize);
+    events_.push_back(event);
+    return (first_event_index_ + static_cast<int>(events_.size()) - 1) &
+        kIndexMask;
+  }
+
+  // Returns NULL if the event with |index| is no longer in this buffer.
+  TraceEvent* FindEvent(int index) {
+    size_t offset = OffsetOf(index);
+    return offset < events_.size() ? &events_[offset] : NULL;
+  }
+
+  void RemoveEvent(int index) {
+    size_t offset = OffsetOf(index);
+    DCHECK_LT(offset, events_.size());
+    events_.erase(events_.begin() + offset);
+  }
+
+  // Moves all buffered events to the back of |events|. Indices returned by
+  // AddEvent() so far become stale.
+  void TakeEvents(std::vector<TraceEvent>* events) {
+    events->insert(events->end(), events_.begin(), events_.end());
+    first_event_index_ =
+        (first_event_index_ + static_cast<int>(events_.size())) & kIndexMask;
+    // Release the memory; threads that stop tracing should not keep a chunk.
+    std::vector<TraceEvent>().swap(events_);
+  }
+
+ private:
+  // Indices wrap around, and are kept non-negative since -1 means that no
+  // event was added.
+  static const int kIndexMask = 0x7fffffff;
+
+  size_t OffsetOf(int index) const {
+    return static_cast<size_t>((index - first_event_index_) & kIndexMask);
+  }
+
+  Lock lock_;
+  const int thread_id_;
+  const char* current_thread_name_;
+  // The index of events_[0].
+  int first_event_index_;
+  std::vector<TraceEvent> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadLocalEventBuffer);
+};
+
 TraceLog::NotificationHelper::NotificationHelper(TraceLog* trace_log)
     : trace_log_(trace_log),
       notification_(0) {
@@ -347,8 +425,11 @@ TraceLog* TraceLog::GetInstance() {
 
 TraceLog::TraceLog()
     : enabled_(false),
+      record_mode_(RECORD_UNTIL_FULL),
+      ring_start_(0),
+      buffer_is_full_(0),
       dispatching_to_observer_list_(false),
-      watch_category_(NULL) {
+      watch_category_(0) {
   // Trace is enabled or disabled on one thread while other threads are
   // accessing the enabled flag. We don't care whether edge-case events are
   // traced or not, so we allow races on the enabled flag to keep the trace
@@ -460,7 +541,8 @@ void TraceLog::GetKnownCategories(std::vector<std::string>* categories) {
 }
 
 void TraceLog::SetEnabled(const std::vector<std::string>& included_categories,
-                          const std::vector<std::string>& excluded_categories) {
+                          const std::vector<std::string>& excluded_categories,
+                          RecordMode record_mode) {
   AutoLock lock(lock_);
   if (enabled_)
     return;
@@ -476,7 +558,16 @@ void TraceLog::SetEnabled(const std::vector<std::string>& included_categories,
                     OnTraceLogWillEnable());
   dispatching_to_observer_list_ = false;
 
+  if (record_mode != record_mode_) {
+    // Flush() has not been called since the previous trace; keep its events
+    // but lay them out for the new mode.
+    UnwrapMainBufferWhileLocked();
+    record_mode_ = record_mode;
+  }
   logged_events_.reserve(1024);
+  subtle::NoBarrier_Store(&buffer_is_full_,
+      logged_events_.size() >= GetMainBufferCapacity() &&
+      record_mode_ == RECORD_UNTIL_FULL);
   enabled_ = true;
   included_categories_ = included_categories;
   excluded_categories_ = excluded_categories;
@@ -488,7 +579,8 @@ void TraceLog::SetEnabled(const std::vector<std::string>& included_categories,
     EnableMatchingCategories(excluded_categories_, 0);
 }
 
-void TraceLog::SetEnabled(const std::string& categories) {
+void TraceLog::SetEnabled(const std::string& categories,
+                          RecordMode record_mode) {
   std::vector<std::string> included, excluded;
   // Tokenize list of categories, delimited by ','.
   StringTokenizer tokens(categories, ",");
@@ -506,7 +598,7 @@ void TraceLog::SetEnabled(const std::string& categories) {
     else
       excluded.push_back(category);
   }
-  SetEnabled(included, excluded);
+  SetEnabled(included, excluded, record_mode);
 }
 
 void TraceLog::GetEnabledTraceCategories(
@@ -520,28 +612,38 @@ void TraceLog::GetEnabledTraceCategories(
 }
 
 void TraceLog::SetDisabled() {
-  AutoLock lock(lock_);
-  if (!enabled_)
-    return;
+  {
+    AutoLock lock(lock_);
+    if (!enabled_)
+      return;
 
-  if (dispatching_to_observer_list_) {
-    DLOG(ERROR)
-        << "Cannot manipulate TraceLog::Enabled state from an observer.";
-    return;
-  }
+    if (dispatching_to_observer_list_) {
+      DLOG(ERROR)
+          << "Cannot manipulate TraceLog::Enabled state from an observer.";
+      return;
+    }
 
-  dispatching_to_observer_list_ = true;
-  FOR_EACH_OBSERVER(EnabledStateChangedObserver, enabled_state_observer_list_,
-                    OnTraceLogWillDisable());
-  dispatching_to_observer_list_ = false;
+    dispatching_to_observer_list_ = true;
+    FOR_EACH_OBSERVER(EnabledStateChangedObserver,
+                      enabled_state_observer_list_,
+                      OnTraceLogWillDisable());
+    dispatching_to_observer_list_ = false;
+
+    enabled_ = false;
+    included_categories_.clear();
+    excluded_categories_.clear();
+    subtle::NoBarrier_Store(&watch_category_, 0);
+    watch_event_name_ = "";
+    for (int i = 0; i < g_category_index; i++)
+      g_category_enabled[i] = 0;
+  }  // release lock
 
-  enabled_ = false;
-  included_categories_.clear();
-  excluded_categories_.clear();
-  watch_category_ = NULL;
-  watch_event_name_ = "";
-  for (int i = 0; i < g_category_index; i++)
-    g_category_enabled[i] = 0;
+  // Collect the events still held by threads so that the metadata events
+  // come last and are not overwritten in RECORD_CONTINUOUSLY mode.
+  MoveAllThreadEventsToMainBuffer();
+
+  AutoLock lock(lock_);
+  UnwrapMainBufferWhileLocked();
   AddThreadNameMetadataEvents();
   AddClockSyncMetadataEvents();
 }
@@ -563,7 +665,8 @@ void TraceLog::RemoveEnabledStateObserver(
 }
 
 float TraceLog::GetBufferPercentFull() const {
-  return (float)((double)logged_events_.size()/(double)kTraceEventBufferSize);
+  return (float)((double)logged_events_.size()/
+                 (double)GetMainBufferCapacity());
 }
 
 void TraceLog::SetNotificationCallback(
@@ -573,10 +676,14 @@ void TraceLog::SetNotificationCallback(
 }
 
 void TraceLog::Flush(const TraceLog::OutputCallback& cb) {
+  MoveAllThreadEventsToMainBuffer();
+
   std::vector<TraceEvent> previous_logged_events;
   {
     AutoLock lock(lock_);
+    UnwrapMainBufferWhileLocked();
     previous_logged_events.swap(logged_events_);
+    subtle::NoBarrier_Store(&buffer_is_full_, 0);
   }  // release lock
 
   for (size_t i = 0;
@@ -605,77 +712,59 @@ int TraceLog::AddTraceEvent(char phase,
                             unsigned char flags) {
   DCHECK(name);
   TimeTicks now = TimeTicks::NowFromSystemTraceTime();
+  // Both flags are read without locking; we don't care whether events that
+  // race with enabling, disabling or filling up the trace are recorded.
+  if (!*category_enabled)
+    return -1;
+  if (subtle::NoBarrier_Load(&buffer_is_full_))
+    return -1;
+
+  ThreadLocalEventBuffer* buffer = GetThreadLocalEventBuffer();
+  UpdateThreadName(buffer);
+
+  if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
+    id ^= process_id_hash_;
+
   NotificationHelper notifier(this);
   int ret_begin_id = -1;
   {
-    AutoLock lock(lock_);
-    if (!*category_enabled)
-      return -1;
-    if (logged_events_.size() >= kTraceEventBufferSize)
-      return -1;
-
-    int thread_id = static_cast<int>(PlatformThread::CurrentId());
-
-    const char* new_name = PlatformThread::GetName();
-    // Check if the thread name has been set or changed since the previous
-    // call (if any), but don't bother if the new name is empty. Note this will
-    // not detect a thread name change within the same char* buffer address: we
-    // favor common case performance over corner case correctness.
-    if (new_name != g_current_thread_name.Get().Get() &&
-        new_name && *new_name) {
-      g_current_thread_name.Get().Set(new_name);
-      base::hash_map<int, std::string>::iterator existing_name =
-          thread_names_.find(thread_id);
-      if (existing_name == thread_names_.end()) {
-        // This is a new thread id, and a new name.
-        thread_names_[thread_id] = new_name;
-      } else {
-        // This is a thread id that we've seen before, but potentially with a
-        // new name.
-        std::vector<base::StringPiece> existing_names;
-        Tokenize(existing_name->second, ",", &existing_names);
-        bool found = std::find(existing_names.begin(),
-                               existing_names.end(),
-                               new_name) != existing_names.end();
-        if (!found) {
-          existing_name->second.push_back(',');
-          existing_name->second.append(new_name);
-        }
-      }
-    }
+    // Only contended while another thread is flushing this buffer.
+    AutoLock buffer_lock(*buffer->lock());
 
     if (threshold_begin_id > -1) {
       DCHECK(phase == TRACE_EVENT_PHASE_END);
-      size_t begin_i = static_cast<size_t>(threshold_begin_id);
-      // Return now if there has been a flush since the begin event was posted.
-      if (begin_i >= logged_events_.size())
-        return -1;
-      // Determine whether to drop the begin/end pair.
-      TimeDelta elapsed = now - logged_events_[begin_i].timestamp();
-      if (elapsed < TimeDelta::FromMicroseconds(threshold)) {
-        // Remove begin event and do not add end event.
-        // This will be expensive if there have been other events in the
-        // mean time (should be rare).
-        logged_events_.erase(logged_events_.begin() + begin_i);
-        return -1;
+      // If the begin event already left this thread's buffer it can no
+      // longer be dropped, so the end event is kept to match it.
+      TraceEvent* begin_event = buffer->FindEvent(threshold_begin_id);
+      if (begin_event) {
+        // Determine whether to drop the begin/end pair.
+        TimeDelta elapsed = now - begin_event->timestamp();
+        if (elapsed < TimeDelta::FromMicroseconds(threshold)) {
+          // Remove begin event and do not add end event.
+          buffer->RemoveEvent(threshold_begin_id);
+          return -1;
+        }
       }
     }
 
-    if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
-      id ^= process_id_hash_;
-
-    ret_begin_id = static_cast<int>(logged_events_.size());
-    logged_events_.push_back(
-        TraceEvent(thread_id,
+    ret_begin_id = buffer->AddEvent(
+        TraceEvent(buffer->thread_id(),
                    now, phase, category_enabled, name, id,
                    num_args, arg_names, arg_types, arg_values,
                    flags));
 
-    if (logged_events_.size() == kTraceEventBufferSize)
-      notifier.AddNotificationWhileLocked(TRACE_BUFFER_FULL);
-
-    if (watch_category_ == category_enabled && watch_event_name_ == name)
-      notifier.AddNotificationWhileLocked(EVENT_WATCH_NOTIFICATION);
+    bool is_watch_category = reinterpret_cast<const unsigned char*>(
+        subtle::NoBarrier_Load(&watch_category_)) == category_enabled;
+    if (buffer->IsFull() || is_watch_category) {
+      AutoLock lock(lock_);
+      if (buffer->IsFull())
+        MoveThreadEventsWhileLocked(buffer, &notifier);
+      if (watch_category_ == reinterpret_cast<subtle::AtomicWord>(
+              category_enabled) &&
+          watch_event_name_ == name) {
+        notifier.AddNotificationWhileLocked(EVENT_WATCH_NOTIFICATION);
+      }
+    }
   }  // release lock
 
   notifier.SendNotificationIfAny();
@@ -709,10 +798,12 @@ void TraceLog::AddTraceEventEtw(char phase,
 void TraceLog::SetWatchEvent(const std::string& category_name,
                              const std::string& event_name) {
   const unsigned char* category = GetCategoryEnabled(category_name.c_str());
+  MoveAllThreadEventsToMainBuffer();
   int notify_count = 0;
   {
     AutoLock lock(lock_);
-    watch_category_ = category;
+    subtle::NoBarrier_Store(&watch_category_,
+                            reinterpret_cast<subtle::AtomicWord>(category));
     watch_event_name_ = event_name;
 
     // First, search existing events for watch event because we want to catch it
@@ -737,10 +828,108 @@ void TraceLog::SetWatchEvent(const std::string& category_name,
 
 void TraceLog::CancelWatchEvent() {
   AutoLock lock(lock_);
-  watch_category_ = NULL;
+  subtle::NoBarrier_Store(&watch_category_, 0);
   watch_event_name_ = "";
 }
 
+TraceLog::ThreadLocalEventBuffer* TraceLog::GetThreadLocalEventBuffer() {
+  ThreadLocalEventBuffer* buffer = thread_local_event_buffer_.Get();
+  if (!buffer) {
+    buffer = new ThreadLocalEventBuffer;
+    thread_local_event_buffer_.Set(buffer);
+    AutoLock lock(lock_);
+    thread_event_buffers_.push_back(buffer);
+  }
+  return buffer;
+}
+
+void TraceLog::UpdateThreadName(ThreadLocalEventBuffer* buffer) {
+  const char* new_name = PlatformThread::GetName();
+  // Check if the thread name has been set or changed since the previous
+  // call (if any), but don't bother if the new name is empty. Note this will
+  // not detect a thread name change within the same char* buffer address: we
+  // favor common case performance over corner case correctness.
+  if (new_name == buffer->current_thread_name() || !new_name || !*new_name)
+    return;
+  buffer->set_current_thread_name(new_name);
+
+  AutoLock lock(lock_);
+  int thread_id = buffer->thread_id();
+  base::hash_map<int, std::string>::iterator existing_name =
+      thread_names_.find(thread_id);
+  if (existing_name == thread_names_.end()) {
+    // This is a new thread id, and a new name.
+    thread_names_[thread_id] = new_name;
+  } else {
+    // This is a thread id that we've seen before, but potentially with a
+    // new name.
+    std::vector<base::StringPiece> existing_names;
+    Tokenize(existing_name->second, ",", &existing_names);
+    bool found = std::find(existing_names.begin(),
+                           existing_names.end(),
+                           new_name) != existing_names.end();
+    if (!found) {
+      existing_name->second.push_back(',');
+      existing_name->second.append(new_name);
+    }
+  }
+}
+
+void TraceLog::MoveThreadEventsWhileLocked(ThreadLocalEventBuffer* buffer,
+                                           NotificationHelper* notifier) {
+  buffer->lock()->AssertAcquired();
+  lock_.AssertAcquired();
+  std::vector<TraceEvent> events;
+  buffer->TakeEvents(&events);
+  for (size_t i = 0; i < events.size(); ++i)
+    AddEventToMainBufferWhileLocked(events[i], notifier);
+}
+
+void TraceLog::MoveAllThreadEventsToMainBuffer() {
+  std::vector<ThreadLocalEventBuffer*> buffers;
+  {
+    AutoLock lock(lock_);
+    buffers.assign(thread_event_buffers_.begin(), thread_event_buffers_.end());
+  }
+
+  NotificationHelper notifier(this);
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    AutoLock buffer_lock(*buffers[i]->lock());
+    AutoLock lock(lock_);
+    MoveThreadEventsWhileLocked(buffers[i], &notifier);
+  }
+  notifier.SendNotificationIfAny();
+}
+
+void TraceLog::AddEventToMainBufferWhileLocked(const TraceEvent& event,
+                                               NotificationHelper* notifier) {
+  size_t capacity = GetMainBufferCapacity();
+  if (logged_events_.size() < capacity) {
+    logged_events_.push_back(event);
+    if (logged_events_.size() == capacity &&
+        record_mode_ == RECORD_UNTIL_FULL) {
+      subtle::NoBarrier_Store(&buffer_is_full_, 1);
+      notifier->AddNotificationWhileLocked(TRACE_BUFFER_FULL);
+    }
+  } else if (record_mode_ == RECORD_CONTINUOUSLY) {
+    logged_events_[ring_start_] = event;
+    ring_start_ = (ring_start_ + 1) % logged_events_.size();
+  }
+}
+
+void TraceLog::UnwrapMainBufferWhileLocked() {
+  lock_.AssertAcquired();
+  std::rotate(logged_events_.begin(),
+              logged_events_.begin() + ring_start_,
+              logged_events_.end());
+  ring_start_ = 0;
+}
+
+size_t TraceLog::GetMainBufferCapacity() const {
+  return record_mode_ == RECORD_CONTINUOUSLY ? kTraceEventRingBufferSize :
+                                                kTraceEventBufferSize;
+}
+
 void TraceLog::AddClockSyncMetadataEvents() {
 #if defined(OS_ANDROID)
   // Since Android does not support sched_setaffinity, we cannot establish clock
@@ -802,6 +991,20 @@ void TraceLog::AddThreadNameMetadataEvents() {
   }
 }
 
+size_t TraceLog::GetEventsSize() {
+  MoveAllThreadEventsToMainBuffer();
+  AutoLock lock(lock_);
+  return logged_events_.size();
+}
+
+const TraceEvent& TraceLog::GetEventAt(size_t index) {
+  MoveAllThreadEventsToMainBuffer();
+  AutoLock lock(lock_);
+  UnwrapMainBufferWhileLocked();
+  DCHECK(index < logged_events_.size());
+  return logged_events_[index];
+}
+
 void TraceLog::DeleteForTesting() {
   DeleteTraceLogForTesting::Delete();
 }
@@ -11,13 +11,16 @@
 #include <string>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_vector.h"
 #include "base/observer_list.h"
 #include "base/string_util.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/thread_local.h"
 #include "base/timer.h"
 
 // Older style trace macros with explicit id and extra data
@@ -166,6 +169,16 @@ class BASE_EXPORT TraceLog {
     EVENT_WATCH_NOTIFICATION = 1 << 1
   };
 
+  // Determines what happens once the trace buffer fills up.
+  enum RecordMode {
+    // Drop all further events and send TRACE_BUFFER_FULL.
+    RECORD_UNTIL_FULL,
+    // Overwrite the oldest events. The buffer is smaller in this mode and
+    // memory use stays bounded, so tracing can be left enabled indefinitely
+    // and Flush()ed when something interesting happens.
+    RECORD_CONTINUOUSLY
+  };
+
   static TraceLog* GetInstance();
 
   // Get set of known categories. This can change as new code paths are reached.
@@ -180,8 +193,10 @@ class BASE_EXPORT TraceLog {
   // Else if included_categories is non-empty, only those are traced.
   // Else if excluded_categories is non-empty, everything but those are traced.
   // Wildcards * and ? are supported (see MatchPattern in string_util.h).
+  // |record_mode| controls what happens once the trace buffer is full.
   void SetEnabled(const std::vector<std::string>& included_categories,
-                  const std::vector<std::string>& excluded_categories);
+                  const std::vector<std::string>& excluded_categories,
+                  RecordMode record_mode = RECORD_UNTIL_FULL);
 
   // |categories| is a comma-delimited list of category wildcards.
   // A category can have an optional '-' prefix to make it an excluded category.
@@ -191,7 +206,8 @@ class BASE_EXPORT TraceLog {
   // Example: SetEnabled("test_MyTest*");
   // Example: SetEnabled("test_MyTest*,test_OtherStuff");
   // Example: SetEnabled("-excluded_category1,-excluded_category2");
-  void SetEnabled(const std::string& categories);
+  void SetEnabled(const std::string& categories,
+                  RecordMode record_mode = RECORD_UNTIL_FULL);
 
   // Retieves the categories set via a prior call to SetEnabled(). Only
   // meaningful if |IsEnabled()| is true.
@@ -203,6 +219,7 @@ class BASE_EXPORT TraceLog {
   // Helper method to enable/disable tracing for all categories.
   void SetEnabled(bool enabled);
   bool IsEnabled() { return enabled_; }
+  RecordMode record_mode() const { return record_mode_; }
 
   // Enabled state listeners give a callback when tracing is enabled or
   // disabled. This can be used to tie into other library's tracing systems
@@ -293,12 +310,10 @@ class BASE_EXPORT TraceLog {
   // Allows resurrecting our singleton instance post-AtExit processing.
   static void Resurrect();
 
-  // Allow tests to inspect TraceEvents.
-  size_t GetEventsSize() const { return logged_events_.size(); }
-  const TraceEvent& GetEventAt(size_t index) const {
-    DCHECK(index < logged_events_.size());
-    return logged_events_[index];
-  }
+  // Allow tests to inspect TraceEvents. Both first move any events still
+  // held in per-thread buffers into the main buffer.
+  size_t GetEventsSize();
+  const TraceEvent& GetEventAt(size_t index);
 
   void SetProcessID(int process_id);
 
@@ -330,19 +345,53 @@ class BASE_EXPORT TraceLog {
     int notification_;
   };
 
+  // Events are first appended to a buffer private to the calling thread,
+  // which is only locked by its owning thread and by flushes, and are moved
+  // to |logged_events_| under |lock_| one chunk at a time. When both locks
+  // are needed, a ThreadLocalEventBuffer's lock is always taken first.
+  class ThreadLocalEventBuffer;
+
   TraceLog();
   ~TraceLog();
   const unsigned char* GetCategoryEnabledInternal(const char* name);
   void AddThreadNameMetadataEvents();
   void AddClockSyncMetadataEvents();
 
-  // TODO(nduca): switch to per-thread trace buffers to reduce thread
-  // synchronization.
+  // Returns the calling thread's event buffer, creating it if needed.
+  ThreadLocalEventBuffer* GetThreadLocalEventBuffer();
+  // Records the name of the calling thread if it changed since its last
+  // event.
+  void UpdateThreadName(ThreadLocalEventBuffer* buffer);
+
+  // Moves the events in |buffer| to |logged_events_|. Called with both
+  // |buffer|'s lock and |lock_| held.
+  void MoveThreadEventsWhileLocked(ThreadLocalEventBuffer* buffer,
+                                   NotificationHelper* notifier);
+  // Moves the events of every thread to |logged_events_|. Must be called
+  // without holding |lock_|.
+  void MoveAllThreadEventsToMainBuffer();
+  // Appends |event| to |logged_events_|, overwriting the oldest event or
+  // dropping |event| once the buffer is full depending on |record_mode_|.
+  void AddEventToMainBufferWhileLocked(const TraceEvent& event,
+                                       NotificationHelper* notifier);
+  // Rotates |logged_events_| so that the oldest event comes first.
+  void UnwrapMainBufferWhileLocked();
+  size_t GetMainBufferCapacity() const;
+
   // This lock protects TraceLog member accesses from arbitrary threads.
   Lock lock_;
   bool enabled_;
+  RecordMode record_mode_;
   NotificationCallback notification_callback_;
   std::vector<TraceEvent> logged_events_;
+  // In RECORD_CONTINUOUSLY mode, the index of the oldest event once
+  // |logged_events_| has wrapped around. Zero otherwise.
+  size_t ring_start_;
+  // Set once |logged_events_| is full in RECORD_UNTIL_FULL mode so that
+  // threads can drop events without taking |lock_|.
+  subtle::Atomic32 buffer_is_full_;
+  ScopedVector<ThreadLocalEventBuffer> thread_event_buffers_;
+  ThreadLocalPointer<ThreadLocalEventBuffer> thread_local_event_buffer_;
   std::vector<std::string> included_categories_;
   std::vector<std::string> excluded_categories_;
   bool dispatching_to_observer_list_;
@@ -355,8 +404,9 @@ class BASE_EXPORT TraceLog {
 
   int process_id_;
 
-  // Allow tests to wake up when certain events occur.
-  const unsigned char* watch_category_;
+  // Allow tests to wake up when certain events occur. |watch_category_| is
+  // also read without |lock_| to avoid locking on every event.
+  subtle::AtomicWord watch_category_;
   std::string watch_event_name_;
 
   DISALLOW_COPY_AND_ASSIGN(TraceLog);
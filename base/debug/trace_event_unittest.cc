@@ -960,6 +960,23 @@ TEST_F(TraceEventTestFixture, DataCapturedThreshold) {
   EXPECT_NOT_FIND_BE_("4thresholdlong2");
 }
 
+// Test that a thresholded begin event that has already been moved out of its
+// thread's buffer keeps its end event.
+TEST_F(TraceEventTestFixture, DataCapturedThresholdAcrossThreadChunks) {
+  ManualTestSetUp();
+  BeginTrace();
+
+  {
+    TRACE_EVENT_IF_LONGER_THAN0(100000000, "time", "threshold many events");
+    for (int i = 0; i < 1000; ++i)
+      TRACE_EVENT_INSTANT0("time", "filler");
+  }
+
+  EndTraceAndFlush();
+
+  EXPECT_FIND_BE_("threshold many events");
+}
+
 // Test EVENT_WATCH_NOTIFICATION
 TEST_F(TraceEventTestFixture, EventWatchNotification) {
   ManualTestSetUp();
@@ -1193,6 +1210,43 @@ TEST_F(TraceEventTestFixture, DataCapturedManyThreads) {
                                            num_threads, num_events);
 }
 
+// Test that RECORD_CONTINUOUSLY keeps the newest events and the metadata.
+TEST_F(TraceEventTestFixture, RecordContinuously) {
+  ManualTestSetUp();
+  TraceLog* tracer = TraceLog::GetInstance();
+  PlatformThread::SetName("RecordContinuouslyThread");
+  event_watch_notification_ = 0;
+  tracer->SetEnabled(std::string("*"), TraceLog::RECORD_CONTINUOUSLY);
+  EXPECT_EQ(TraceLog::RECORD_CONTINUOUSLY, tracer->record_mode());
+
+  // More events than either buffer size.
+  const size_t kNumEvents = 600000;
+  TRACE_EVENT_INSTANT0("all", "overwritten");
+  for (size_t i = 0; i < kNumEvents; ++i)
+    TRACE_EVENT_INSTANT0("all", "kept");
+
+  size_t num_events = tracer->GetEventsSize();
+  EXPECT_LT(num_events, kNumEvents);
+  EXPECT_LE(tracer->GetBufferPercentFull(), 1.0f);
+  EXPECT_STREQ("kept", tracer->GetEventAt(0).name());
+  EXPECT_STREQ("kept", tracer->GetEventAt(num_events - 1).name());
+
+  tracer->SetDisabled();
+  ASSERT_EQ(num_events + 1, tracer->GetEventsSize());
+  EXPECT_STREQ("kept", tracer->GetEventAt(0).name());
+  EXPECT_STREQ("thread_name", tracer->GetEventAt(num_events).name());
+
+  // The next trace starts out empty in the default mode.
+  tracer->Flush(base::Bind(&TraceEventTestFixture::OnTraceDataCollected,
+                           base::Unretained(this)));
+  EXPECT_EQ(0u, tracer->GetEventsSize());
+  BeginTrace();
+  EXPECT_EQ(TraceLog::RECORD_UNTIL_FULL, tracer->record_mode());
+  TRACE_EVENT_INSTANT0("all", "until full");
+  EXPECT_EQ(1u, tracer->GetEventsSize());
+  EndTraceAndFlush();
+}
+
 // Test that thread and process names show up in the trace
 TEST_F(TraceEventTestFixture, ThreadNames) {
   ManualTestSetUp();
@@ -7,8 +7,11 @@
 
 #include "base/files/file_path_watcher.h"
 
+#include <set>
+
 #include "base/logging.h"
 #include "base/message_loop.h"
+#include "base/timer.h"
 
 namespace base {
 namespace files {
@@ -38,8 +41,56 @@ class FilePathWatcherDelegate : public base::files::FilePathWatcher::Delegate {
   DISALLOW_COPY_AND_ASSIGN(FilePathWatcherDelegate);
 };
 
+// A delegate implementation for the batched callback interface. Changes are
+// collected for the delay after the first one, and reported together.
+class BatchingFilePathWatcherDelegate
+    : public base::files::FilePathWatcher::Delegate {
+ public:
+  BatchingFilePathWatcherDelegate(
+      base::TimeDelta delay,
+      const FilePathWatcher::BatchCallback& callback)
+      : delay_(delay),
+        callback_(callback) {}
+
+  // FilePathWatcher::Delegate implementation.
+  virtual void OnFilePathChanged(const FilePath& path) OVERRIDE {
+    changed_paths_.insert(path);
+    if (!timer_.IsRunning())
+      timer_.Start(FROM_HERE, delay_, this,
+                   &BatchingFilePathWatcherDelegate::ReportChanges);
+  }
+
+  virtual void OnFilePathError(const FilePath& path) OVERRIDE {
+    timer_.Stop();
+    changed_paths_.clear();
+    callback_.Run(std::vector<FilePath>(1, path), true);
+  }
+
+ private:
+  virtual ~BatchingFilePathWatcherDelegate() {}
+
+  void ReportChanges() {
+    // The callback may delete the watcher, and with it the last reference
+    // to this delegate.
+    scoped_refptr<BatchingFilePathWatcherDelegate> protect(this);
+    std::vector<FilePath> paths(changed_paths_.begin(), changed_paths_.end());
+    changed_paths_.clear();
+    callback_.Run(paths, false);
+  }
+
+  const base::TimeDelta delay_;
+  FilePathWatcher::BatchCallback callback_;
+  std::set<FilePath> changed_paths_;
+  base::OneShotTimer<BatchingFilePathWatcherDelegate> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchingFilePathWatcherDelegate);
+};
+
 }  // namespace
 
+FilePathWatcher::BatchOptions::BatchOptions() : recursive(false) {
+}
+
 FilePathWatcher::~FilePathWatcher() {
   impl_->Cancel();
 }
@@ -62,9 +113,26 @@ FilePathWatcher::PlatformDelegate::~PlatformDelegate() {
   DCHECK(is_cancelled());
 }
 
+bool FilePathWatcher::PlatformDelegate::WatchChanges(const FilePath& path,
+                                                     bool recursive,
+                                                     Delegate* delegate) {
+  if (recursive)
+    return false;
+  return Watch(path, delegate);
+}
+
 bool FilePathWatcher::Watch(const FilePath& path, const Callback& callback) {
   return Watch(path, new FilePathWatcherDelegate(callback));
 }
 
+bool FilePathWatcher::WatchBatched(const FilePath& path,
+                                   const BatchOptions& options,
+                                   const BatchCallback& callback) {
+  DCHECK(path.IsAbsolute());
+  return impl_->WatchChanges(
+      path, options.recursive,
+      new BatchingFilePathWatcherDelegate(options.delay, callback));
+}
+
 }  // namespace files
 }  // namespace base
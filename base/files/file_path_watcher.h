@@ -7,12 +7,15 @@
 #ifndef BASE_FILES_FILE_PATH_WATCHER_H_
 #define BASE_FILES_FILE_PATH_WATCHER_H_
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop_proxy.h"
+#include "base/time.h"
 
 namespace base {
 namespace files {
@@ -33,6 +36,27 @@ class BASE_EXPORT FilePathWatcher {
   // that case, the callback won't be invoked again.
   typedef base::Callback<void(const FilePath& path, bool error)> Callback;
 
+  // Callback type for WatchBatched(). |paths| holds each path that changed
+  // since the previous call, once. If |error| is true, |paths| holds the
+  // watched path and the callback won't be invoked again.
+  typedef base::Callback<void(const std::vector<FilePath>& paths, bool error)>
+      BatchCallback;
+
+  // Options for WatchBatched().
+  struct BASE_EXPORT BatchOptions {
+    BatchOptions();
+
+    // How long changes are collected for after the first one, before they
+    // are reported together. Zero reports the changes the platform noticed
+    // together, such as those of one inotify read on Linux.
+    base::TimeDelta delay;
+
+    // Whether to watch the whole tree below a watched directory, rather than
+    // only the directory and its direct children. Only Linux supports it;
+    // WatchBatched() fails elsewhere.
+    bool recursive;
+  };
+
   // Declares the callback client code implements to receive notifications. Note
   // that implementations of this interface should not keep a reference to the
   // corresponding FileWatcher object to prevent a reference cycle.
@@ -61,6 +85,14 @@ class BASE_EXPORT FilePathWatcher {
     virtual bool Watch(const FilePath& path,
                        Delegate* delegate) WARN_UNUSED_RESULT = 0;
 
+    // Like Watch(), but notifies |delegate| with each path that changed below
+    // |path| rather than with |path| itself and, if |recursive|, watches the
+    // whole tree below |path|. The default implementation reports |path| for
+    // every change and fails if |recursive| is true.
+    virtual bool WatchChanges(const FilePath& path,
+                              bool recursive,
+                              Delegate* delegate) WARN_UNUSED_RESULT;
+
     // Stop watching. This is called from FilePathWatcher's dtor in order to
     // allow to shut down properly while the object is still alive.
     // It can be called from any thread.
@@ -123,6 +155,14 @@ class BASE_EXPORT FilePathWatcher {
   // be invoked on the same loop. Returns true on success.
   bool Watch(const FilePath& path, const Callback& callback);
 
+  // Like the Watch() above, but invokes |callback| with the set of paths
+  // that changed, at most once per |options.delay|, so that a directory that
+  // receives many writes does not flood the loop with notifications. Where
+  // the platform cannot tell which file changed, |path| is reported.
+  bool WatchBatched(const FilePath& path,
+                    const BatchOptions& options,
+                    const BatchCallback& callback);
+
  private:
   scoped_refptr<PlatformDelegate> impl_;
 
@@ -5,6 +5,7 @@
 #include "base/files/file_path_watcher.h"
 
 #include <set>
+#include <vector>
 
 #if defined(OS_WIN)
 #include <windows.h>
@@ -148,6 +149,65 @@ void QuitLoopWatchCallback(MessageLoop* loop,
   loop->PostTask(FROM_HERE, loop->QuitClosure());
 }
 
+// Records the paths reported to a FilePathWatcher::BatchCallback on the loop
+// of the test, and quits it once a given path has been reported.
+class BatchCollector : public base::RefCountedThreadSafe<BatchCollector> {
+ public:
+  BatchCollector()
+      : loop_(base::MessageLoopProxy::current()),
+        batch_count_(0) {}
+
+  // Called from the file thread.
+  void OnChange(const std::vector<FilePath>& paths, bool error) {
+    EXPECT_FALSE(error);
+    loop_->PostTask(FROM_HERE,
+                    base::Bind(&BatchCollector::RecordChange, this, paths));
+  }
+
+  // Runs the loop of the test until |path| has been reported.
+  void WaitFor(const FilePath& path) {
+    ASSERT_TRUE(loop_->BelongsToCurrentThread());
+    awaited_path_ = path;
+    if (!paths_.count(path))
+      MessageLoop::current()->Run();
+    awaited_path_.clear();
+  }
+
+  const std::set<FilePath>& paths() const { return paths_; }
+  int batch_count() const { return batch_count_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<BatchCollector>;
+  ~BatchCollector() {}
+
+  void RecordChange(const std::vector<FilePath>& paths) {
+    ++batch_count_;
+    // Each path is reported once per batch.
+    EXPECT_EQ(paths.size(),
+              std::set<FilePath>(paths.begin(), paths.end()).size());
+    paths_.insert(paths.begin(), paths.end());
+    if (!awaited_path_.empty() && paths_.count(awaited_path_))
+      MessageLoop::current()->Quit();
+  }
+
+  scoped_refptr<base::MessageLoopProxy> loop_;
+  std::set<FilePath> paths_;
+  int batch_count_;
+  FilePath awaited_path_;
+};
+
+void SetupBatchedWatch(const FilePath& target,
+                       FilePathWatcher* watcher,
+                       const FilePathWatcher::BatchOptions& options,
+                       BatchCollector* collector,
+                       bool* result,
+                       base::WaitableEvent* completion) {
+  *result = watcher->WatchBatched(
+      target, options,
+      base::Bind(&BatchCollector::OnChange, make_scoped_refptr(collector)));
+  completion->Signal();
+}
+
 class FilePathWatcherTest : public testing::Test {
  public:
   FilePathWatcherTest()
@@ -196,6 +256,20 @@ class FilePathWatcherTest : public testing::Test {
     return result;
   }
 
+  bool SetupBatchedWatch(const FilePath& target,
+                         FilePathWatcher* watcher,
+                         const FilePathWatcher::BatchOptions& options,
+                         BatchCollector* collector) WARN_UNUSED_RESULT {
+    base::WaitableEvent completion(false, false);
+    bool result;
+    file_thread_.message_loop_proxy()->PostTask(
+        FROM_HERE,
+        base::Bind(base::files::SetupBatchedWatch, target, watcher, options,
+                   make_scoped_refptr(collector), &result, &completion));
+    completion.Wait();
+    return result;
+  }
+
   bool WaitForEvents() WARN_UNUSED_RESULT {
     collector_->Reset();
     loop_.Run();
@@ -532,6 +606,30 @@ TEST_F(FilePathWatcherTest, MoveChild) {
   ASSERT_TRUE(WaitForEvents());
 }
 
+// Verify that a batched watch of a file reports the file.
+TEST_F(FilePathWatcherTest, BatchedFile) {
+  FilePathWatcher watcher;
+  scoped_refptr<BatchCollector> collector(new BatchCollector);
+  ASSERT_TRUE(SetupBatchedWatch(test_file(), &watcher,
+                                FilePathWatcher::BatchOptions(), collector));
+
+  ASSERT_TRUE(WriteFile(test_file(), "content"));
+  collector->WaitFor(test_file());
+  EXPECT_EQ(1u, collector->paths().size());
+}
+
+#if !defined(OS_LINUX)
+// Only the Linux implementation watches directories recursively.
+TEST_F(FilePathWatcherTest, RecursiveNotSupported) {
+  FilePathWatcher watcher;
+  scoped_refptr<BatchCollector> collector(new BatchCollector);
+  FilePathWatcher::BatchOptions options;
+  options.recursive = true;
+  EXPECT_FALSE(SetupBatchedWatch(temp_dir_.path(), &watcher, options,
+                                 collector));
+}
+#endif  // !OS_LINUX
+
 #if !defined(OS_LINUX)
 // Linux implementation of FilePathWatcher doesn't catch attribute changes.
 // http://crbug.com/78043
@@ -552,6 +650,65 @@ TEST_F(FilePathWatcherTest, FileAttributesChanged) {
 
 #if defined(OS_LINUX)
 
+// Verify that the changes to a directory during the delay are reported
+// together, each changed file once.
+TEST_F(FilePathWatcherTest, BatchedDirectoryChanges) {
+  FilePath dir(temp_dir_.path().AppendASCII("dir"));
+  ASSERT_TRUE(file_util::CreateDirectory(dir));
+  FilePathWatcher watcher;
+  scoped_refptr<BatchCollector> collector(new BatchCollector);
+  FilePathWatcher::BatchOptions options;
+  options.delay = TestTimeouts::tiny_timeout();
+  ASSERT_TRUE(SetupBatchedWatch(dir, &watcher, options, collector));
+
+  std::set<FilePath> files;
+  for (int i = 0; i < 10; ++i) {
+    FilePath file(dir.AppendASCII(base::StringPrintf("file%d", i)));
+    ASSERT_TRUE(WriteFile(file, "content"));
+    ASSERT_TRUE(WriteFile(file, "content v2"));
+    files.insert(file);
+  }
+  collector->WaitFor(*files.rbegin());
+  EXPECT_EQ(files, collector->paths());
+  EXPECT_EQ(1, collector->batch_count());
+}
+
+// Verify that a recursive watch reports changes in the subdirectories that
+// existed when it started, and in those created since.
+TEST_F(FilePathWatcherTest, RecursiveWatch) {
+  FilePath dir(temp_dir_.path().AppendASCII("dir"));
+  FilePath old_subdir(dir.AppendASCII("old").AppendASCII("nested"));
+  ASSERT_TRUE(file_util::CreateDirectory(old_subdir));
+  FilePathWatcher watcher;
+  scoped_refptr<BatchCollector> collector(new BatchCollector);
+  FilePathWatcher::BatchOptions options;
+  options.recursive = true;
+  ASSERT_TRUE(SetupBatchedWatch(dir, &watcher, options, collector));
+
+  FilePath old_file(old_subdir.AppendASCII("file"));
+  ASSERT_TRUE(WriteFile(old_file, "content"));
+  collector->WaitFor(old_file);
+
+  // The nested directory may be created before the watch of its parent is
+  // added, and must be watched anyway.
+  FilePath new_subdir(dir.AppendASCII("new").AppendASCII("nested"));
+  ASSERT_TRUE(file_util::CreateDirectory(new_subdir));
+  collector->WaitFor(dir.AppendASCII("new"));
+  FilePath new_file(new_subdir.AppendASCII("file"));
+  ASSERT_TRUE(WriteFile(new_file, "content"));
+  collector->WaitFor(new_file);
+
+  // A directory moved into the tree is watched too.
+  FilePath outside(temp_dir_.path().AppendASCII("outside"));
+  ASSERT_TRUE(file_util::CreateDirectory(outside));
+  FilePath moved(new_subdir.AppendASCII("moved"));
+  ASSERT_TRUE(file_util::Move(outside, moved));
+  collector->WaitFor(moved);
+  FilePath moved_file(moved.AppendASCII("file"));
+  ASSERT_TRUE(WriteFile(moved_file, "content"));
+  collector->WaitFor(moved_file);
+}
+
 // Verify that creating a symlink is caught.
 TEST_F(FilePathWatcherTest, CreateLink) {
   FilePathWatcher watcher;
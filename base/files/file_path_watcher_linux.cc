@@ -12,6 +12,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -45,6 +46,26 @@ class InotifyReader {
   typedef int Watch;  // Watch descriptor used by AddWatch and RemoveWatch.
   static const Watch kInvalidWatch = -1;
 
+  // An inotify event, as handed to the watchers.
+  struct Event {
+    Event(Watch watch, const FilePath::StringType& child, bool created,
+          bool is_dir)
+        : watch(watch),
+          child(child),
+          created(created),
+          is_dir(is_dir) {}
+
+    // The watch that fired.
+    Watch watch;
+    // What has changed, relative to the path watched by |watch|.
+    FilePath::StringType child;
+    // True if |child| appeared.
+    bool created;
+    // True if |child| is a directory.
+    bool is_dir;
+  };
+  typedef std::vector<Event> EventVector;
+
   // Watch directory |path| for changes. |watcher| will be notified on each
   // change. Returns kInvalidWatch on failure.
   Watch AddWatch(const FilePath& path, FilePathWatcherImpl* watcher);
@@ -52,8 +73,9 @@ class InotifyReader {
   // Remove |watch|. Returns true on success.
   bool RemoveWatch(Watch watch, FilePathWatcherImpl* watcher);
 
-  // Callback for InotifyReaderTask.
-  void OnInotifyEvent(const inotify_event* event);
+  // Callback for InotifyReaderTask, with the events of one read. Each watcher
+  // is handed all of the events that concern it at once.
+  void OnInotifyEvents(const EventVector& events);
 
  private:
   friend struct ::base::DefaultLazyInstanceTraits<InotifyReader>;
@@ -89,19 +111,23 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
  public:
   FilePathWatcherImpl();
 
-  // Called for each event coming from the watch. |fired_watch| identifies the
-  // watch that fired, |child| indicates what has changed, and is relative to
-  // the currently watched path for |fired_watch|. The flag |created| is true if
-  // the object appears.
-  void OnFilePathChanged(InotifyReader::Watch fired_watch,
-                         const FilePath::StringType& child,
-                         bool created);
+  // Called with the events of one inotify read that come from the watches of
+  // this instance. Switches to the |message_loop_| thread if necessary.
+  void OnFilePathsChanged(const InotifyReader::EventVector& events);
 
   // Start watching |path| for changes and notify |delegate| on each change.
   // Returns true if watch for |path| has been added successfully.
   virtual bool Watch(const FilePath& path,
                      FilePathWatcher::Delegate* delegate) OVERRIDE;
 
+  // Like Watch(), but reports the paths that changed. If |recursive|, the
+  // subdirectories of |path| are watched too: they are walked once when
+  // |path| appears, and then only the directories that are created or moved
+  // below it are.
+  virtual bool WatchChanges(const FilePath& path,
+                            bool recursive,
+                            FilePathWatcher::Delegate* delegate) OVERRIDE;
+
   // Cancel the watch. This unregisters the instance with InotifyReader.
   virtual void Cancel() OVERRIDE;
 
@@ -132,10 +158,36 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
   };
   typedef std::vector<WatchEntry> WatchVector;
 
+  // The watches of the directories below |target_|, with their paths.
+  typedef std::map<InotifyReader::Watch, FilePath> SubdirWatchMap;
+
+  // Handles |event|, adding the paths to notify the delegate with to
+  // |changed_paths|. Returns false if the watch failed.
+  bool HandleEvent(const InotifyReader::Event& event,
+                   std::set<FilePath>* changed_paths) WARN_UNUSED_RESULT;
+
   // Reconfigure to watch for the most specific parent directory of |target_|
   // that exists. Updates |watched_path_|. Returns true on success.
   bool UpdateWatches() WARN_UNUSED_RESULT;
 
+  // Watches |dir|, which is below |target_|, and the directories below it.
+  // If |changed_paths| is not NULL, the paths found below |dir| are added to
+  // it, since they may have appeared before |dir| was watched. Returns false
+  // if a directory that exists could not be watched.
+  bool AddSubdirWatches(const FilePath& dir,
+                        std::set<FilePath>* changed_paths) WARN_UNUSED_RESULT;
+
+  // Adds or removes the watches of |dir| and of the directories below it,
+  // after |dir| was |created|, moved in, deleted or moved away.
+  bool UpdateSubdirWatches(const FilePath& dir,
+                           bool created,
+                           std::set<FilePath>* changed_paths)
+      WARN_UNUSED_RESULT;
+
+  // Removes the watches of |dir| and of the directories below it, or all of
+  // |subdir_watches_| if |dir| is empty.
+  void RemoveSubdirWatches(const FilePath& dir);
+
   // Delegate to notify upon changes.
   scoped_refptr<FilePathWatcher::Delegate> delegate_;
 
@@ -147,6 +199,17 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
   // |target_| and always stores an empty next component name in |subdir_|.
   WatchVector watches_;
 
+  // Whether the delegate is notified with the paths that changed, rather
+  // than with |target_|.
+  bool report_changes_;
+
+  // Whether the directories below |target_| are watched, in
+  // |subdir_watches_|. They were set up for the watch of |target_| in
+  // |subdir_watches_root_|, and are set up again if it changes.
+  bool recursive_;
+  SubdirWatchMap subdir_watches_;
+  InotifyReader::Watch subdir_watches_root_;
+
   DISALLOW_COPY_AND_ASSIGN(FilePathWatcherImpl);
 };
 
@@ -196,14 +259,23 @@ void InotifyReaderCallback(InotifyReader* reader, int inotify_fd,
       return;
     }
 
+    InotifyReader::EventVector events;
     ssize_t i = 0;
     while (i < bytes_read) {
       inotify_event* event = reinterpret_cast<inotify_event*>(&buffer[i]);
       size_t event_size = sizeof(inotify_event) + event->len;
       DCHECK(i + event_size <= static_cast<size_t>(bytes_read));
-      reader->OnInotifyEvent(event);
+      if (!(event->mask & IN_IGNORED)) {
+        events.push_back(InotifyReader::Event(
+            event->wd,
+            event->len ? event->name : FILE_PATH_LITERAL(""),
+            (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0,
+            (event->mask & IN_ISDIR) != 0));
+      }
       i += event_size;
     }
+    if (!events.empty())
+      reader->OnInotifyEvents(events);
   }
 }
 
@@ -278,46 +350,81 @@ bool InotifyReader::RemoveWatch(Watch watch,
   return true;
 }
 
-void InotifyReader::OnInotifyEvent(const inotify_event* event) {
-  if (event->mask & IN_IGNORED)
-    return;
-
-  FilePath::StringType child(event->len ? event->name : FILE_PATH_LITERAL(""));
+void InotifyReader::OnInotifyEvents(const EventVector& events) {
   base::AutoLock auto_lock(lock_);
 
-  for (WatcherSet::iterator watcher = watchers_[event->wd].begin();
-       watcher != watchers_[event->wd].end();
-       ++watcher) {
-    (*watcher)->OnFilePathChanged(event->wd,
-                                  child,
-                                  event->mask & (IN_CREATE | IN_MOVED_TO));
+  // Group the events by watcher, in order, so that a burst of changes costs
+  // each watcher a single task.
+  typedef std::map<FilePathWatcherImpl*, EventVector> EventsByWatcher;
+  EventsByWatcher events_by_watcher;
+  for (EventVector::const_iterator event = events.begin();
+       event != events.end(); ++event) {
+    base::hash_map<Watch, WatcherSet>::const_iterator watchers =
+        watchers_.find(event->watch);
+    if (watchers == watchers_.end())
+      continue;
+    for (WatcherSet::const_iterator watcher = watchers->second.begin();
+         watcher != watchers->second.end();
+         ++watcher) {
+      events_by_watcher[*watcher].push_back(*event);
+    }
+  }
+
+  for (EventsByWatcher::const_iterator i = events_by_watcher.begin();
+       i != events_by_watcher.end(); ++i) {
+    i->first->OnFilePathsChanged(i->second);
   }
 }
 
 FilePathWatcherImpl::FilePathWatcherImpl()
-    : delegate_(NULL) {
+    : delegate_(NULL),
+      report_changes_(false),
+      recursive_(false),
+      subdir_watches_root_(InotifyReader::kInvalidWatch) {
 }
 
-void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
-                                            const FilePath::StringType& child,
-                                            bool created) {
+void FilePathWatcherImpl::OnFilePathsChanged(
+    const InotifyReader::EventVector& events) {
   if (!message_loop()->BelongsToCurrentThread()) {
     // Switch to message_loop_ to access watches_ safely.
     message_loop()->PostTask(FROM_HERE,
-        base::Bind(&FilePathWatcherImpl::OnFilePathChanged,
+        base::Bind(&FilePathWatcherImpl::OnFilePathsChanged,
                    this,
-                   fired_watch,
-                   child,
-                   created));
+                   events));
     return;
   }
 
   DCHECK(MessageLoopForIO::current());
 
-  // Find the entry in |watches_| that corresponds to |fired_watch|.
+  // The watch may have been cancelled since the events were read.
+  if (!delegate_)
+    return;
+
+  std::set<FilePath> changed_paths;
+  for (InotifyReader::EventVector::const_iterator event = events.begin();
+       event != events.end(); ++event) {
+    if (!HandleEvent(*event, &changed_paths)) {
+      delegate_->OnFilePathError(target_);
+      return;
+    }
+  }
+
+  // The delegate may cancel the watch when notified.
+  for (std::set<FilePath>::const_iterator path = changed_paths.begin();
+       path != changed_paths.end() && delegate_; ++path) {
+    delegate_->OnFilePathChanged(*path);
+  }
+}
+
+bool FilePathWatcherImpl::HandleEvent(const InotifyReader::Event& event,
+                                      std::set<FilePath>* changed_paths) {
+  const FilePath::StringType& child = event.child;
+  const bool created = event.created;
+
+  // Find the entry in |watches_| that corresponds to |event.watch|.
   WatchVector::const_iterator watch_entry(watches_.begin());
   for ( ; watch_entry != watches_.end(); ++watch_entry) {
-    if (fired_watch == watch_entry->watch_) {
+    if (event.watch == watch_entry->watch_) {
       // Check whether a path component of |target_| changed.
       bool change_on_target_path = child.empty() ||
           ((child == watch_entry->subdir_) && watch_entry->linkname_.empty()) ||
@@ -337,9 +444,17 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
       // as changes to symlinks on the target path will not have
       // IN_ISDIR set in the event masks. As a result we may sometimes
       // call UpdateWatches() unnecessarily.
-      if (change_on_target_path && !UpdateWatches()) {
-        delegate_->OnFilePathError(target_);
-        return;
+      if (change_on_target_path && !UpdateWatches())
+        return false;
+
+      // Keep watching the tree below |target_| as directories come and go
+      // directly in it.
+      bool in_target = watch_entry->subdir_.empty() &&
+          watch_entry->linkname_.empty() && !child.empty();
+      if (recursive_ && in_target && event.is_dir &&
+          !UpdateSubdirWatches(target_.Append(child), created,
+                               changed_paths)) {
+        return false;
       }
 
       // Report the following events:
@@ -353,11 +468,24 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
       if (target_changed ||
           (change_on_target_path && !created) ||
           (change_on_target_path && file_util::PathExists(target_))) {
-        delegate_->OnFilePathChanged(target_);
-        return;
+        changed_paths->insert(report_changes_ && in_target ?
+                              target_.Append(child) : target_);
+        return true;
       }
     }
   }
+
+  // Otherwise the change may be in a directory below |target_|.
+  SubdirWatchMap::const_iterator subdir(subdir_watches_.find(event.watch));
+  if (subdir == subdir_watches_.end())
+    return true;
+  FilePath path(child.empty() ? subdir->second : subdir->second.Append(child));
+  if (event.is_dir && !child.empty() &&
+      !UpdateSubdirWatches(path, created, changed_paths)) {
+    return false;
+  }
+  changed_paths->insert(path);
+  return true;
 }
 
 bool FilePathWatcherImpl::Watch(const FilePath& path,
@@ -382,6 +510,14 @@ bool FilePathWatcherImpl::Watch(const FilePath& path,
   return UpdateWatches();
 }
 
+bool FilePathWatcherImpl::WatchChanges(const FilePath& path,
+                                       bool recursive,
+                                       FilePathWatcher::Delegate* delegate) {
+  report_changes_ = true;
+  recursive_ = recursive;
+  return Watch(path, delegate);
+}
+
 void FilePathWatcherImpl::Cancel() {
   if (!delegate_) {
     // Watch was never called, or the |message_loop_| thread is already gone.
@@ -414,6 +550,7 @@ void FilePathWatcherImpl::CancelOnMessageLoopThread() {
       g_inotify_reader.Get().RemoveWatch(watch_entry->watch_, this);
   }
   watches_.clear();
+  RemoveSubdirWatches(FilePath());
   target_.clear();
 }
 
@@ -470,9 +607,85 @@ bool FilePathWatcherImpl::UpdateWatches() {
     path = path.Append(watch_entry->subdir_);
   }
 
+  // Walk the tree below |target_| again only if |target_| itself changed,
+  // such as when it was deleted and created again.
+  if (recursive_ && watches_.back().watch_ != subdir_watches_root_) {
+    RemoveSubdirWatches(FilePath());
+    subdir_watches_root_ = watches_.back().watch_;
+    if (subdir_watches_root_ != InotifyReader::kInvalidWatch &&
+        watches_.back().linkname_.empty()) {
+      file_util::FileEnumerator enumerator(
+          target_, false,
+          file_util::FileEnumerator::DIRECTORIES |
+          file_util::FileEnumerator::SHOW_SYM_LINKS);
+      for (FilePath dir = enumerator.Next(); !dir.empty();
+           dir = enumerator.Next()) {
+        if (!AddSubdirWatches(dir, NULL))
+          return false;
+      }
+    }
+  }
+
   return true;
 }
 
+bool FilePathWatcherImpl::UpdateSubdirWatches(
+    const FilePath& dir,
+    bool created,
+    std::set<FilePath>* changed_paths) {
+  // A directory may be reported as created after the walk of its parent
+  // already watched it. Its watch is kept then, since removing it would drop
+  // the events queued for it.
+  if (created)
+    return AddSubdirWatches(dir, changed_paths);
+  RemoveSubdirWatches(dir);
+  return true;
+}
+
+bool FilePathWatcherImpl::AddSubdirWatches(const FilePath& dir,
+                                           std::set<FilePath>* changed_paths) {
+  // Symbolic links are not followed, so that a link cycle does not make the
+  // walk endless.
+  int file_type = file_util::FileEnumerator::DIRECTORIES |
+                  file_util::FileEnumerator::SHOW_SYM_LINKS;
+  if (changed_paths)
+    file_type |= file_util::FileEnumerator::FILES;
+  file_util::FileEnumerator enumerator(dir, true, file_type);
+  for (FilePath path = dir; !path.empty(); path = enumerator.Next()) {
+    if (path != dir) {
+      if (changed_paths)
+        changed_paths->insert(path);
+      file_util::FileEnumerator::FindInfo info;
+      enumerator.GetFindInfo(&info);
+      if (!file_util::FileEnumerator::IsDirectory(info))
+        continue;
+    }
+    InotifyReader::Watch watch = g_inotify_reader.Get().AddWatch(path, this);
+    if (watch != InotifyReader::kInvalidWatch) {
+      subdir_watches_[watch] = path;
+    } else if (file_util::DirectoryExists(path)) {
+      // Most likely the limit of inotify watches was reached.
+      DPLOG(WARNING) << "Watch failed for " << path.value();
+      return false;
+    }
+  }
+  return true;
+}
+
+void FilePathWatcherImpl::RemoveSubdirWatches(const FilePath& dir) {
+  SubdirWatchMap::iterator i = subdir_watches_.begin();
+  while (i != subdir_watches_.end()) {
+    if (dir.empty() || dir == i->second || dir.IsParent(i->second)) {
+      g_inotify_reader.Get().RemoveWatch(i->first, this);
+      subdir_watches_.erase(i++);
+    } else {
+      ++i;
+    }
+  }
+  if (dir.empty())
+    subdir_watches_root_ = InotifyReader::kInvalidWatch;
+}
+
 }  // namespace
 
 FilePathWatcher::FilePathWatcher() {
@@ -197,6 +197,7 @@ JSONParser::JSONParser(int options)
       stack_depth_(0),
       line_number_(0),
       index_last_line_(0),
+      delegate_(NULL),
       error_code_(JSONReader::JSON_NO_ERROR),
       error_line_(0),
       error_column_(0) {
@@ -221,43 +222,16 @@ Value* JSONParser::Parse(const StringPiece& input) {
   // be used anywhere.
   if (!(options_ & JSON_DETACHABLE_CHILDREN)) {
     input_copy = input.as_string();
-    start_pos_ = input_copy.data();
+    StartParsing(input_copy.data(), input_copy.length());
   } else {
-    start_pos_ = input.data();
-  }
-  pos_ = start_pos_;
-  end_pos_ = start_pos_ + input.length();
-  index_ = 0;
-  line_number_ = 1;
-  index_last_line_ = 0;
-
-  error_code_ = JSONReader::JSON_NO_ERROR;
-  error_line_ = 0;
-  error_column_ = 0;
-
-  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
-  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
-  // ParseNextToken function mis-treating a Unicode BOM as an invalid
-  // character and returning NULL.
-  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
-      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
-      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
-    NextNChars(3);
+    StartParsing(input.data(), input.length());
   }
 
   // Parse the first and any nested tokens.
   scoped_ptr<Value> root(ParseNextToken());
-  if (!root.get())
+  if (!root.get() || !FinishParsing())
     return NULL;
 
-  // Make sure the input stream is at an end.
-  if (GetNextToken() != T_END_OF_INPUT) {
-    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
-      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
-      return NULL;
-    }
-  }
-
   // Dictionaries and lists can contain JSONStringValues, so wrap them in a
   // hidden root.
   if (!(options_ & JSON_DETACHABLE_CHILDREN)) {
@@ -277,6 +251,18 @@ Value* JSONParser::Parse(const StringPiece& input) {
   return root.release();
 }
 
+bool JSONParser::ParseWithDelegate(const StringPiece& input,
+                                   JSONReaderDelegate* delegate) {
+  DCHECK(delegate);
+  // No Value holds on to the input, so it can be read in place.
+  StartParsing(input.data(), input.length());
+
+  delegate_ = delegate;
+  bool result = EmitNextToken() && FinishParsing();
+  delegate_ = NULL;
+  return result;
+}
+
 JSONReader::JsonParseError JSONParser::error_code() const {
   return error_code_;
 }
@@ -366,6 +352,40 @@ void JSONParser::NextNChars(int n) {
   pos_ += n;
 }
 
+void JSONParser::StartParsing(const char* input, size_t length) {
+  start_pos_ = input;
+  pos_ = start_pos_;
+  end_pos_ = start_pos_ + length;
+  index_ = 0;
+  line_number_ = 1;
+  index_last_line_ = 0;
+
+  error_code_ = JSONReader::JSON_NO_ERROR;
+  error_line_ = 0;
+  error_column_ = 0;
+
+  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
+  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
+  // ParseNextToken function mis-treating a Unicode BOM as an invalid
+  // character and returning NULL.
+  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
+      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
+      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
+    NextNChars(3);
+  }
+}
+
+bool JSONParser::FinishParsing() {
+  // Make sure the input stream is at an end.
+  if (GetNextToken() != T_END_OF_INPUT) {
+    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
+      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
+      return false;
+    }
+  }
+  return true;
+}
+
 JSONParser::Token JSONParser::GetNextToken() {
   EatWhitespaceAndComments();
   if (!CanConsume(1))
@@ -608,6 +628,142 @@ Value* JSONParser::ConsumeString() {
   }
 }
 
+bool JSONParser::EmitNextToken() {
+  return EmitToken(GetNextToken());
+}
+
+bool JSONParser::EmitToken(Token token) {
+  switch (token) {
+    case T_OBJECT_BEGIN:
+      return EmitDictionary();
+    case T_ARRAY_BEGIN:
+      return EmitList();
+    case T_STRING:
+      return EmitString();
+    case T_NUMBER: {
+      bool is_int;
+      int num_int;
+      double num_double;
+      if (!ConsumeNumberRaw(&is_int, &num_int, &num_double))
+        return false;
+      return is_int ? delegate_->OnInteger(num_int) :
+                      delegate_->OnDouble(num_double);
+    }
+    case T_BOOL_TRUE:
+      return ConsumeLiteralRaw("true") && delegate_->OnBoolean(true);
+    case T_BOOL_FALSE:
+      return ConsumeLiteralRaw("false") && delegate_->OnBoolean(false);
+    case T_NULL:
+      return ConsumeLiteralRaw("null") && delegate_->OnNull();
+    default:
+      ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+      return false;
+  }
+}
+
+bool JSONParser::EmitDictionary() {
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!delegate_->OnDictionaryBegin())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_OBJECT_END) {
+    if (token != T_STRING) {
+      ReportError(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, 1);
+      return false;
+    }
+
+    StringBuilder key;
+    if (!ConsumeStringRaw(&key))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token != T_OBJECT_PAIR_SEPARATOR) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
+    }
+
+    bool keep_going = key.CanBeStringPiece() ?
+        delegate_->OnDictionaryKey(key.AsStringPiece()) :
+        delegate_->OnDictionaryKey(key.AsString());
+    if (!keep_going)
+      return false;
+
+    NextChar();
+    if (!EmitNextToken())
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_OBJECT_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
+      }
+    } else if (token != T_OBJECT_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 0);
+      return false;
+    }
+  }
+
+  return delegate_->OnDictionaryEnd();
+}
+
+bool JSONParser::EmitList() {
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!delegate_->OnListBegin())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_ARRAY_END) {
+    if (!EmitToken(token))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_ARRAY_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
+      }
+    } else if (token != T_ARRAY_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
+    }
+  }
+
+  return delegate_->OnListEnd();
+}
+
+bool JSONParser::EmitString() {
+  StringBuilder string;
+  if (!ConsumeStringRaw(&string))
+    return false;
+
+  // Unlike ConsumeString(), there is no Value to outlive the input, so the
+  // string is passed by reference whenever it needs no decoding.
+  if (string.CanBeStringPiece())
+    return delegate_->OnString(string.AsStringPiece());
+  return delegate_->OnString(string.AsString());
+}
+
 bool JSONParser::ConsumeStringRaw(StringBuilder* out) {
   if (*pos_ != '"') {
     ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
@@ -812,6 +968,19 @@ void JSONParser::DecodeUTF8(const int32& point, StringBuilder* dest) {
 }
 
 Value* JSONParser::ConsumeNumber() {
+  bool is_int;
+  int num_int;
+  double num_double;
+  if (!ConsumeNumberRaw(&is_int, &num_int, &num_double))
+    return NULL;
+  if (is_int)
+    return Value::CreateIntegerValue(num_int);
+  return Value::CreateDoubleValue(num_double);
+}
+
+bool JSONParser::ConsumeNumberRaw(bool* is_int,
+                                  int* int_out,
+                                  double* double_out) {
   const char* num_start = pos_;
   const int start_index = index_;
   int end_index = start_index;
@@ -821,7 +990,7 @@ Value* JSONParser::ConsumeNumber() {
 
   if (!ReadInt(false)) {
     ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-    return NULL;
+    return false;
   }
   end_index = index_;
 
@@ -829,12 +998,12 @@ Value* JSONParser::ConsumeNumber() {
   if (*pos_ == '.') {
     if (!CanConsume(1)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -846,7 +1015,7 @@ Value* JSONParser::ConsumeNumber() {
       NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -866,7 +1035,7 @@ Value* JSONParser::ConsumeNumber() {
       break;
     default:
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
   }
 
   pos_ = exit_pos;
@@ -874,17 +1043,18 @@ Value* JSONParser::ConsumeNumber() {
 
   StringPiece num_string(num_start, end_index - start_index);
 
-  int num_int;
-  if (StringToInt(num_string, &num_int))
-    return Value::CreateIntegerValue(num_int);
+  if (StringToInt(num_string, int_out)) {
+    *is_int = true;
+    return true;
+  }
 
-  double num_double;
-  if (base::StringToDouble(num_string.as_string(), &num_double) &&
-      IsFinite(num_double)) {
-    return Value::CreateDoubleValue(num_double);
+  if (base::StringToDouble(num_string.as_string(), double_out) &&
+      IsFinite(*double_out)) {
+    *is_int = false;
+    return true;
   }
 
-  return NULL;
+  return false;
 }
 
 bool JSONParser::ReadInt(bool allow_leading_zeros) {
@@ -908,45 +1078,34 @@ bool JSONParser::ReadInt(bool allow_leading_zeros) {
 
 Value* JSONParser::ConsumeLiteral() {
   switch (*pos_) {
-    case 't': {
-      const char* kTrueLiteral = "true";
-      const int kTrueLen = static_cast<int>(strlen(kTrueLiteral));
-      if (!CanConsume(kTrueLen - 1) ||
-          !StringsAreEqual(pos_, kTrueLiteral, kTrueLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    case 't':
+      if (!ConsumeLiteralRaw("true"))
         return NULL;
-      }
-      NextNChars(kTrueLen - 1);
       return Value::CreateBooleanValue(true);
-    }
-    case 'f': {
-      const char* kFalseLiteral = "false";
-      const int kFalseLen = static_cast<int>(strlen(kFalseLiteral));
-      if (!CanConsume(kFalseLen - 1) ||
-          !StringsAreEqual(pos_, kFalseLiteral, kFalseLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    case 'f':
+      if (!ConsumeLiteralRaw("false"))
         return NULL;
-      }
-      NextNChars(kFalseLen - 1);
       return Value::CreateBooleanValue(false);
-    }
-    case 'n': {
-      const char* kNullLiteral = "null";
-      const int kNullLen = static_cast<int>(strlen(kNullLiteral));
-      if (!CanConsume(kNullLen - 1) ||
-          !StringsAreEqual(pos_, kNullLiteral, kNullLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    case 'n':
+      if (!ConsumeLiteralRaw("null"))
         return NULL;
-      }
-      NextNChars(kNullLen - 1);
       return Value::CreateNullValue();
-    }
     default:
       ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
       return NULL;
   }
 }
 
+bool JSONParser::ConsumeLiteralRaw(const char* literal) {
+  const int len = static_cast<int>(strlen(literal));
+  if (!CanConsume(len - 1) || !StringsAreEqual(pos_, literal, len)) {
+    ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    return false;
+  }
+  NextNChars(len - 1);
+  return true;
+}
+
 // static
 bool JSONParser::StringsAreEqual(const char* one, const char* two, size_t len) {
   return strncmp(one, two, len) == 0;
@@ -67,6 +67,13 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // result as a Value owned by the caller.
   Value* Parse(const StringPiece& input);
 
+  // Parses the input string according to the set options, reporting its
+  // structure to |delegate| as it is read instead of building a Value. Returns
+  // false if the input is malformed or if |delegate| stopped the parse; in the
+  // latter case error_code() is JSON_NO_ERROR.
+  bool ParseWithDelegate(const StringPiece& input,
+                         JSONReaderDelegate* delegate);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -154,6 +161,15 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Performs the equivalent of NextChar N times.
   void NextNChars(int n);
 
+  // Winds the parser to the start of the |length| bytes at |input|, skipping
+  // a leading UTF-8 Byte-Order-Mark, and clears any previous error.
+  void StartParsing(const char* input, size_t length);
+
+  // Called after the root value has been consumed. Returns true if nothing
+  // but whitespace and comments remains in the input, and reports an error
+  // otherwise.
+  bool FinishParsing();
+
   // Skips over whitespace and comments to find the next token in the stream.
   // This does not advance the parser for non-whitespace or comment chars.
   Token GetNextToken();
@@ -184,6 +200,16 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Calls through ConsumeStringRaw and wraps it in a value.
   Value* ConsumeString();
 
+  // The counterparts of ParseToken/ConsumeDictionary/ConsumeList/ConsumeString
+  // used by ParseWithDelegate(). Rather than returning a Value, these report
+  // what they consume to |delegate_|. They return false on a parse error or
+  // when the delegate asks to stop.
+  bool EmitNextToken();
+  bool EmitToken(Token token);
+  bool EmitDictionary();
+  bool EmitList();
+  bool EmitString();
+
   // Assuming that the parser is wound to a double quote, this parses a string,
   // decoding any escape sequences and converts UTF-16 to UTF-8. Returns true on
   // success and Swap()s the result into |out|. Returns false on failure with
@@ -203,6 +229,9 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
   Value* ConsumeNumber();
+  // Does the work for ConsumeNumber(). On success, stores the number in either
+  // |int_out| or |double_out| and sets |is_int| accordingly.
+  bool ConsumeNumberRaw(bool* is_int, int* int_out, double* double_out);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
@@ -210,6 +239,9 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Consumes the literal values of |true|, |false|, and |null|, assuming the
   // parser is wound to the first character of any of those.
   Value* ConsumeLiteral();
+  // Consumes |literal| if the parser is wound to it, and reports an error
+  // otherwise.
+  bool ConsumeLiteralRaw(const char* literal);
 
   // Compares two string buffers of a given length.
   static bool StringsAreEqual(const char* left, const char* right, size_t len);
@@ -249,6 +281,10 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // The last value of |index_| on the previous line.
   int index_last_line_;
 
+  // The receiver of parse events during ParseWithDelegate(). Weak, and NULL
+  // otherwise.
+  JSONReaderDelegate* delegate_;
+
   // Error information.
   JSONReader::JsonParseError error_code_;
   int error_line_;
@@ -0,0 +1,172 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/json/json_value_converter.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const int kNumRecords = 20000;
+const int kNumIterations = 10;
+
+// A record shaped like the entries of a typical web service response or
+// extension manifest list: a few scalars, a nested object and some arrays.
+struct Owner {
+  std::string name;
+  int id;
+
+  Owner() : id(0) {}
+
+  static void RegisterJSONConverter(base::JSONValueConverter<Owner>* c) {
+    c->RegisterStringField("name", &Owner::name);
+    c->RegisterIntField("id", &Owner::id);
+  }
+};
+
+struct Record {
+  int id;
+  std::string title;
+  std::string url;
+  double score;
+  bool enabled;
+  Owner owner;
+  ScopedVector<std::string> tags;
+  ScopedVector<int> sizes;
+
+  Record() : id(0), score(0), enabled(false) {}
+
+  static void RegisterJSONConverter(base::JSONValueConverter<Record>* c) {
+    c->RegisterIntField("id", &Record::id);
+    c->RegisterStringField("title", &Record::title);
+    c->RegisterStringField("url", &Record::url);
+    c->RegisterDoubleField("score", &Record::score);
+    c->RegisterBoolField("enabled", &Record::enabled);
+    c->RegisterNestedField("owner", &Record::owner);
+    c->RegisterRepeatedString("tags", &Record::tags);
+    c->RegisterRepeatedInt("sizes", &Record::sizes);
+  }
+};
+
+struct Document {
+  int version;
+  ScopedVector<Record> records;
+
+  Document() : version(0) {}
+
+  static void RegisterJSONConverter(base::JSONValueConverter<Document>* c) {
+    c->RegisterIntField("version", &Document::version);
+    c->RegisterRepeatedMessage("records", &Document::records);
+  }
+};
+
+std::string MakeDocument() {
+  std::string json = "{\"version\": 3, \"records\": [\n";
+  for (int i = 0; i < kNumRecords; ++i) {
+    base::StringAppendF(&json,
+        "%s  {\"id\": %d, \"title\": \"Item number %d \\u2013 sample\", "
+        "\"url\": \"http://www.example.com/items/%d?ref=list&page=%d\", "
+        "\"score\": %d.%03d, \"enabled\": %s, "
+        "\"owner\": {\"name\": \"user%d\", \"id\": %d, \"unused\": null}, "
+        "\"tags\": [\"alpha\", \"beta\", \"tag%d\"], "
+        "\"sizes\": [16, 32, 48, %d], "
+        "\"description\": \"An attribute that no field is registered for.\"}",
+        i ? ",\n" : "", i, i, i, i / 100, i % 100, i % 1000,
+        i % 2 ? "true" : "false", i % 97, i % 97, i % 13, i);
+  }
+  json += "\n]}\n";
+  return json;
+}
+
+// Accepts every event, so that the raw cost of the event stream is measured.
+class NullDelegate : public base::JSONReaderDelegate {
+ public:
+  NullDelegate() : count_(0) {}
+  virtual ~NullDelegate() {}
+
+  virtual bool OnNull() OVERRIDE { return Count(); }
+  virtual bool OnBoolean(bool value) OVERRIDE { return Count(); }
+  virtual bool OnInteger(int value) OVERRIDE { return Count(); }
+  virtual bool OnDouble(double value) OVERRIDE { return Count(); }
+  virtual bool OnString(const base::StringPiece& value) OVERRIDE {
+    return Count();
+  }
+  virtual bool OnDictionaryBegin() OVERRIDE { return Count(); }
+  virtual bool OnDictionaryKey(const base::StringPiece& key) OVERRIDE {
+    return Count();
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Count(); }
+  virtual bool OnListBegin() OVERRIDE { return Count(); }
+  virtual bool OnListEnd() OVERRIDE { return Count(); }
+
+  int count() const { return count_; }
+
+ private:
+  bool Count() {
+    ++count_;
+    return true;
+  }
+
+  int count_;
+};
+
+class JSONParserPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    json_ = MakeDocument();
+  }
+
+  std::string json_;
+};
+
+}  // namespace
+
+TEST_F(JSONParserPerfTest, Read) {
+  PerfTimeLogger timer("JSON_Read");
+  for (int i = 0; i < kNumIterations; ++i) {
+    scoped_ptr<base::Value> value(base::JSONReader::Read(json_));
+    ASSERT_TRUE(value.get());
+  }
+  timer.Done();
+}
+
+TEST_F(JSONParserPerfTest, ReadWithDelegate) {
+  PerfTimeLogger timer("JSON_ReadWithDelegate");
+  for (int i = 0; i < kNumIterations; ++i) {
+    NullDelegate delegate;
+    ASSERT_TRUE(base::JSONReader::ReadWithDelegate(
+        json_, base::JSON_PARSE_RFC, &delegate, NULL, NULL));
+  }
+  timer.Done();
+}
+
+TEST_F(JSONParserPerfTest, ReadAndConvert) {
+  base::JSONValueConverter<Document> converter;
+  PerfTimeLogger timer("JSON_ReadAndConvert");
+  for (int i = 0; i < kNumIterations; ++i) {
+    scoped_ptr<base::Value> value(base::JSONReader::Read(json_));
+    Document document;
+    ASSERT_TRUE(converter.Convert(*value, &document));
+    ASSERT_EQ(static_cast<size_t>(kNumRecords), document.records.size());
+  }
+  timer.Done();
+}
+
+TEST_F(JSONParserPerfTest, ConvertFromJSON) {
+  base::JSONValueConverter<Document> converter;
+  PerfTimeLogger timer("JSON_ConvertFromJSON");
+  for (int i = 0; i < kNumIterations; ++i) {
+    Document document;
+    ASSERT_TRUE(converter.ConvertFromJSON(json_, &document));
+    ASSERT_EQ(static_cast<size_t>(kNumRecords), document.records.size());
+  }
+  timer.Done();
+}
@@ -68,6 +68,24 @@ Value* JSONReader::ReadAndReturnError(const StringPiece& json,
   return NULL;
 }
 
+// static
+bool JSONReader::ReadWithDelegate(const StringPiece& json,
+                                  int options,
+                                  JSONReaderDelegate* delegate,
+                                  int* error_code_out,
+                                  std::string* error_msg_out) {
+  internal::JSONParser parser(options);
+  if (parser.ParseWithDelegate(json, delegate))
+    return true;
+
+  if (error_code_out)
+    *error_code_out = parser.error_code();
+  if (error_msg_out)
+    *error_msg_out = parser.GetErrorMessage();
+
+  return false;
+}
+
 // static
 std::string JSONReader::ErrorCodeToString(JsonParseError error_code) {
   switch (error_code) {
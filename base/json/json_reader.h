@@ -60,6 +60,34 @@ enum JSONParserOptions {
   JSON_DETACHABLE_CHILDREN = 1 << 1,
 };
 
+// Receives the contents of a JSON document from JSONReader::ReadWithDelegate()
+// as a stream of events, in document order, without a Value tree being built.
+// Each method returns true to continue parsing or false to stop.
+//
+// Events are delivered as the input is read, so a delegate may see the start
+// of a document that later turns out to be malformed.
+class BASE_EXPORT JSONReaderDelegate {
+ public:
+  virtual bool OnNull() = 0;
+  virtual bool OnBoolean(bool value) = 0;
+  virtual bool OnInteger(int value) = 0;
+  virtual bool OnDouble(double value) = 0;
+  // |value| is only valid for the duration of the call.
+  virtual bool OnString(const StringPiece& value) = 0;
+
+  virtual bool OnDictionaryBegin() = 0;
+  // Called with each key, before the events for its value. |key| is only
+  // valid for the duration of the call.
+  virtual bool OnDictionaryKey(const StringPiece& key) = 0;
+  virtual bool OnDictionaryEnd() = 0;
+
+  virtual bool OnListBegin() = 0;
+  virtual bool OnListEnd() = 0;
+
+ protected:
+  virtual ~JSONReaderDelegate() {}
+};
+
 class BASE_EXPORT JSONReader {
  public:
   // Error codes during parsing.
@@ -111,6 +139,16 @@ class BASE_EXPORT JSONReader {
                                    int* error_code_out,
                                    std::string* error_msg_out);
 
+  // Reads and parses |json| like ReadAndReturnError(), but reports the
+  // contents to |delegate| instead of returning a Value. Returns true if the
+  // whole input was read. If |delegate| stops the parse, returns false and
+  // sets |error_code_out| to JSON_NO_ERROR.
+  static bool ReadWithDelegate(const StringPiece& json,
+                               int options,  // JSONParserOptions
+                               JSONReaderDelegate* delegate,
+                               int* error_code_out,
+                               std::string* error_msg_out);
+
   // Converts a JSON parse error code into a human readable message.
   // Returns an empty string if error_code is JSON_NO_ERROR.
   static std::string ErrorCodeToString(JsonParseError error_code);
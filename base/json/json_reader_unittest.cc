@@ -10,6 +10,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
 #include "base/string_piece.h"
+#include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
 #include "build/build_config.h"
@@ -17,6 +18,54 @@
 
 namespace base {
 
+namespace {
+
+// Records the events it receives as a compact string, and stops the parse
+// after |max_events| of them.
+class RecordingDelegate : public JSONReaderDelegate {
+ public:
+  explicit RecordingDelegate(int max_events)
+      : max_events_(max_events), num_events_(0) {}
+  virtual ~RecordingDelegate() {}
+
+  virtual bool OnNull() OVERRIDE { return Record("null"); }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Record(value ? "true" : "false");
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Record(StringPrintf("i%d", value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Record(StringPrintf("d%g", value));
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    return Record("s" + value.as_string());
+  }
+  virtual bool OnDictionaryBegin() OVERRIDE { return Record("{"); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return Record("k" + key.as_string());
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Record("}"); }
+  virtual bool OnListBegin() OVERRIDE { return Record("["); }
+  virtual bool OnListEnd() OVERRIDE { return Record("]"); }
+
+  const std::string& events() const { return events_; }
+
+ private:
+  bool Record(const std::string& event) {
+    if (!events_.empty())
+      events_ += " ";
+    events_ += event;
+    return ++num_events_ < max_events_;
+  }
+
+  const int max_events_;
+  int num_events_;
+  std::string events_;
+};
+
+}  // namespace
+
 TEST(JSONReaderTest, Reading) {
   // some whitespace checking
   scoped_ptr<Value> root;
@@ -645,4 +694,73 @@ TEST(JSONReaderTest, IllegalTrailingNull) {
   EXPECT_EQ(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, reader.error_code());
 }
 
+TEST(JSONReaderTest, ReadWithDelegate) {
+  RecordingDelegate delegate(1000);
+  EXPECT_TRUE(JSONReader::ReadWithDelegate(
+      "\xEF\xBB\xBF{\"a\": [1, -2.5, true, false, null], /* c */\n"
+      " \"b\\u0041\": {\"c\": \"d\\n\"}, \"e\": []}",
+      JSON_PARSE_RFC, &delegate, NULL, NULL));
+  EXPECT_EQ("{ ka [ i1 d-2.5 true false null ] kbA { kc sd\n } ke [ ] }",
+            delegate.events());
+
+  RecordingDelegate scalar_delegate(1000);
+  EXPECT_TRUE(JSONReader::ReadWithDelegate("  \"str\"  ", JSON_PARSE_RFC,
+                                           &scalar_delegate, NULL, NULL));
+  EXPECT_EQ("sstr", scalar_delegate.events());
+
+  RecordingDelegate trailing_delegate(1000);
+  EXPECT_TRUE(JSONReader::ReadWithDelegate("[1,]", JSON_ALLOW_TRAILING_COMMAS,
+                                           &trailing_delegate, NULL, NULL));
+  EXPECT_EQ("[ i1 ]", trailing_delegate.events());
+}
+
+TEST(JSONReaderTest, ReadWithDelegateErrors) {
+  const char* invalid_json[] = {
+      "{\"foo\"",
+      "[1,]",
+      "[1 2]",
+      "{foo: 1}",
+      "[1] 2",
+      "\"\\u123g\"",
+  };
+
+  for (size_t i = 0; i < arraysize(invalid_json); ++i) {
+    RecordingDelegate delegate(1000);
+    int error_code = JSONReader::JSON_NO_ERROR;
+    std::string error_message;
+    EXPECT_FALSE(JSONReader::ReadWithDelegate(invalid_json[i], JSON_PARSE_RFC,
+                                              &delegate, &error_code,
+                                              &error_message));
+    EXPECT_NE(JSONReader::JSON_NO_ERROR, error_code);
+    EXPECT_NE("", error_message);
+
+    // The tree-building parser reports the same error.
+    int read_error_code = JSONReader::JSON_NO_ERROR;
+    std::string read_error_message;
+    EXPECT_FALSE(JSONReader::ReadAndReturnError(invalid_json[i],
+                                                JSON_PARSE_RFC,
+                                                &read_error_code,
+                                                &read_error_message));
+    EXPECT_EQ(read_error_code, error_code);
+    EXPECT_EQ(read_error_message, error_message);
+  }
+
+  // Nesting is limited as for Read().
+  std::string too_deep = std::string(101, '[') + std::string(101, ']');
+  RecordingDelegate delegate(1000);
+  int error_code = JSONReader::JSON_NO_ERROR;
+  EXPECT_FALSE(JSONReader::ReadWithDelegate(too_deep, JSON_PARSE_RFC,
+                                            &delegate, &error_code, NULL));
+  EXPECT_EQ(JSONReader::JSON_TOO_MUCH_NESTING, error_code);
+}
+
+TEST(JSONReaderTest, ReadWithDelegateStops) {
+  RecordingDelegate delegate(3);
+  int error_code = JSONReader::JSON_SYNTAX_ERROR;
+  EXPECT_FALSE(JSONReader::ReadWithDelegate("[1, 2, 3, 4]", JSON_PARSE_RFC,
+                                            &delegate, &error_code, NULL));
+  EXPECT_EQ("[ i1 i2", delegate.events());
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, error_code);
+}
+
 }  // namespace base
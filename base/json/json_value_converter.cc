@@ -0,0 +1,265 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_value_converter.h"
+
+#include "base/json/json_reader.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Builds a child value and attaches it to its parent dictionary or list.
+class ChildValueSink : public ValueBuilderSink {
+ public:
+  ChildValueSink(DictionaryValue* dictionary, const StringPiece& key)
+      : dictionary_(dictionary),
+        key_(key.as_string()),
+        list_(NULL) {
+  }
+
+  explicit ChildValueSink(ListValue* list)
+      : dictionary_(NULL),
+        list_(list) {
+  }
+
+ protected:
+  virtual bool OnValueBuilt(Value* value) OVERRIDE {
+    if (dictionary_)
+      dictionary_->SetWithoutPathExpansion(key_, value);
+    else
+      list_->Append(value);
+    return true;
+  }
+
+ private:
+  DictionaryValue* dictionary_;
+  std::string key_;
+  ListValue* list_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChildValueSink);
+};
+
+// Routes the parse events to the sink of the value they belong to. Values
+// for which no sink is created are skipped, along with everything nested in
+// them.
+class SinkDispatcher : public JSONReaderDelegate {
+ public:
+  explicit SinkDispatcher(ValueSink* root_sink)
+      : root_sink_(root_sink),
+        skip_depth_(0) {
+  }
+
+  virtual ~SinkDispatcher() {}
+
+  virtual bool OnNull() OVERRIDE {
+    scoped_ptr<ValueSink> sink(TakeNextSink());
+    return !sink.get() || sink->OnNull();
+  }
+
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    scoped_ptr<ValueSink> sink(TakeNextSink());
+    return !sink.get() || sink->OnBoolean(value);
+  }
+
+  virtual bool OnInteger(int value) OVERRIDE {
+    scoped_ptr<ValueSink> sink(TakeNextSink());
+    return !sink.get() || sink->OnInteger(value);
+  }
+
+  virtual bool OnDouble(double value) OVERRIDE {
+    scoped_ptr<ValueSink> sink(TakeNextSink());
+    return !sink.get() || sink->OnDouble(value);
+  }
+
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    scoped_ptr<ValueSink> sink(TakeNextSink());
+    return !sink.get() || sink->OnString(value);
+  }
+
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    ValueSink* sink = TakeNextSink();
+    if (!sink) {
+      ++skip_depth_;
+      return true;
+    }
+    open_sinks_.push_back(sink);
+    in_list_.push_back(false);
+    return sink->OnDictionaryBegin();
+  }
+
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    if (!skip_depth_)
+      key_sink_.reset(open_sinks_.back()->CreateSinkForKey(key));
+    return true;
+  }
+
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    return EndContainer();
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    ValueSink* sink = TakeNextSink();
+    if (!sink) {
+      ++skip_depth_;
+      return true;
+    }
+    open_sinks_.push_back(sink);
+    in_list_.push_back(true);
+    return sink->OnListBegin();
+  }
+
+  virtual bool OnListEnd() OVERRIDE {
+    return EndContainer();
+  }
+
+ private:
+  // Returns the sink for the value that is starting, or NULL if the value is
+  // being skipped. The caller takes ownership.
+  ValueSink* TakeNextSink() {
+    if (skip_depth_)
+      return NULL;
+    if (open_sinks_.empty())
+      return root_sink_.release();
+    if (in_list_.back())
+      return open_sinks_.back()->CreateSinkForElement();
+    return key_sink_.release();
+  }
+
+  bool EndContainer() {
+    if (skip_depth_) {
+      --skip_depth_;
+      return true;
+    }
+    bool result = open_sinks_.back()->OnEnd();
+    open_sinks_.erase(open_sinks_.end() - 1);
+    in_list_.pop_back();
+    return result;
+  }
+
+  // The sink for the document's root value, until that value starts.
+  scoped_ptr<ValueSink> root_sink_;
+
+  // The sinks of the dictionaries and lists currently being read, innermost
+  // last, and whether each of them is a list.
+  ScopedVector<ValueSink> open_sinks_;
+  std::vector<bool> in_list_;
+
+  // The sink for the value of the dictionary key just read.
+  scoped_ptr<ValueSink> key_sink_;
+
+  // The number of containers entered inside a skipped value.
+  int skip_depth_;
+
+  DISALLOW_COPY_AND_ASSIGN(SinkDispatcher);
+};
+
+}  // namespace
+
+ValueSink::ValueSink() {
+}
+
+ValueSink::~ValueSink() {
+}
+
+bool ValueSink::OnNull() {
+  return false;
+}
+
+bool ValueSink::OnBoolean(bool value) {
+  return false;
+}
+
+bool ValueSink::OnInteger(int value) {
+  return false;
+}
+
+bool ValueSink::OnDouble(double value) {
+  return false;
+}
+
+bool ValueSink::OnString(const StringPiece& value) {
+  return false;
+}
+
+bool ValueSink::OnDictionaryBegin() {
+  return false;
+}
+
+bool ValueSink::OnListBegin() {
+  return false;
+}
+
+ValueSink* ValueSink::CreateSinkForKey(const StringPiece& key) {
+  NOTREACHED();
+  return NULL;
+}
+
+ValueSink* ValueSink::CreateSinkForElement() {
+  NOTREACHED();
+  return NULL;
+}
+
+bool ValueSink::OnEnd() {
+  return true;
+}
+
+ValueBuilderSink::ValueBuilderSink() {
+}
+
+ValueBuilderSink::~ValueBuilderSink() {
+}
+
+bool ValueBuilderSink::OnNull() {
+  return OnValueBuilt(Value::CreateNullValue());
+}
+
+bool ValueBuilderSink::OnBoolean(bool value) {
+  return OnValueBuilt(Value::CreateBooleanValue(value));
+}
+
+bool ValueBuilderSink::OnInteger(int value) {
+  return OnValueBuilt(Value::CreateIntegerValue(value));
+}
+
+bool ValueBuilderSink::OnDouble(double value) {
+  return OnValueBuilt(Value::CreateDoubleValue(value));
+}
+
+bool ValueBuilderSink::OnString(const StringPiece& value) {
+  return OnValueBuilt(new StringValue(value.as_string()));
+}
+
+bool ValueBuilderSink::OnDictionaryBegin() {
+  container_.reset(new DictionaryValue);
+  return true;
+}
+
+bool ValueBuilderSink::OnListBegin() {
+  container_.reset(new ListValue);
+  return true;
+}
+
+ValueSink* ValueBuilderSink::CreateSinkForKey(const StringPiece& key) {
+  return new ChildValueSink(static_cast<DictionaryValue*>(container_.get()),
+                            key);
+}
+
+ValueSink* ValueBuilderSink::CreateSinkForElement() {
+  return new ChildValueSink(static_cast<ListValue*>(container_.get()));
+}
+
+bool ValueBuilderSink::OnEnd() {
+  return OnValueBuilt(container_.release());
+}
+
+bool ConvertJSONToSink(const StringPiece& json, ValueSink* root_sink) {
+  SinkDispatcher dispatcher(root_sink);
+  return JSONReader::ReadWithDelegate(json, JSON_PARSE_RFC, &dispatcher,
+                                      NULL, NULL);
+}
+
+}  // namespace internal
+}  // namespace base
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -15,6 +16,7 @@
 #include "base/stl_util.h"
 #include "base/string16.h"
 #include "base/string_piece.h"
+#include "base/utf_string_conversions.h"
 #include "base/values.h"
 
 // JSONValueConverter converts a JSON value into a C++ struct in a
@@ -82,6 +84,15 @@
 //           "your_enum", &Message::ye, &ConvertFunc);
 //     }
 //   };
+//
+// If the input is still a JSON string, ConvertFromJSON() fills the struct
+// straight from the parser's event stream instead, without building a Value
+// tree first:
+//   converter.ConvertFromJSON(json_string, &message);
+// It accepts and rejects the same documents as Convert() on the parsed value,
+// except that a field whose key appears more than once is converted once per
+// occurrence. Fields registered with RegisterCustomValueField() or
+// RegisterRepeatedCustomValue() still see a Value, built just for them.
 
 namespace base {
 
@@ -90,6 +101,71 @@ class JSONValueConverter;
 
 namespace internal {
 
+// Receives the parse events for one JSON value during ConvertFromJSON() and
+// stores it into the field it was created for. The default implementations
+// reject the value, so subclasses only handle the types their field accepts.
+class BASE_EXPORT ValueSink {
+ public:
+  ValueSink();
+  virtual ~ValueSink();
+
+  // Each of these returns false if the value does not fit the field.
+  virtual bool OnNull();
+  virtual bool OnBoolean(bool value);
+  virtual bool OnInteger(int value);
+  virtual bool OnDouble(double value);
+  virtual bool OnString(const StringPiece& value);
+  virtual bool OnDictionaryBegin();
+  virtual bool OnListBegin();
+
+  // Once OnDictionaryBegin() or OnListBegin() has succeeded, these return the
+  // sink for the value of |key| or for the next list element. The caller
+  // takes ownership. A NULL sink means that the value is skipped.
+  virtual ValueSink* CreateSinkForKey(const StringPiece& key);
+  virtual ValueSink* CreateSinkForElement();
+
+  // Called at the end of the dictionary or list. Returns false if the
+  // conversion has failed.
+  virtual bool OnEnd();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ValueSink);
+};
+
+// A sink that collects its events into a Value, for converters that need to
+// see one.
+class BASE_EXPORT ValueBuilderSink : public ValueSink {
+ public:
+  ValueBuilderSink();
+  virtual ~ValueBuilderSink();
+
+  virtual bool OnNull() OVERRIDE;
+  virtual bool OnBoolean(bool value) OVERRIDE;
+  virtual bool OnInteger(int value) OVERRIDE;
+  virtual bool OnDouble(double value) OVERRIDE;
+  virtual bool OnString(const StringPiece& value) OVERRIDE;
+  virtual bool OnDictionaryBegin() OVERRIDE;
+  virtual bool OnListBegin() OVERRIDE;
+  virtual ValueSink* CreateSinkForKey(const StringPiece& key) OVERRIDE;
+  virtual ValueSink* CreateSinkForElement() OVERRIDE;
+  virtual bool OnEnd() OVERRIDE;
+
+ protected:
+  // Called once the whole value has been read. Takes ownership of |value|.
+  virtual bool OnValueBuilt(base::Value* value) = 0;
+
+ private:
+  // The dictionary or list being built, if the value is one.
+  scoped_ptr<base::Value> container_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueBuilderSink);
+};
+
+// Parses |json| and feeds it to |root_sink|, which this takes ownership of.
+// Returns false if |json| is malformed or a sink rejected a value.
+BASE_EXPORT bool ConvertJSONToSink(const StringPiece& json,
+                                   ValueSink* root_sink);
+
 template<typename StructType>
 class FieldConverterBase {
  public:
@@ -97,6 +173,8 @@ class FieldConverterBase {
   virtual ~FieldConverterBase() {}
   virtual bool ConvertField(const base::Value& value, StructType* obj)
       const = 0;
+  // Returns a sink that stores a streamed value into this field of |obj|.
+  virtual ValueSink* CreateFieldSink(StructType* obj) const = 0;
   const std::string& field_path() const { return field_path_; }
 
  private:
@@ -109,8 +187,38 @@ class ValueConverter {
  public:
   virtual ~ValueConverter() {}
   virtual bool Convert(const base::Value& value, FieldType* field) const = 0;
+
+  // Returns a sink that stores a streamed value into |field|. By default the
+  // value is built and handed to Convert().
+  virtual ValueSink* CreateSink(FieldType* field) const;
 };
 
+template <typename FieldType>
+class ValueConvertingSink : public ValueBuilderSink {
+ public:
+  ValueConvertingSink(const ValueConverter<FieldType>* converter,
+                      FieldType* field)
+      : converter_(converter),
+        field_(field) {
+  }
+
+ protected:
+  virtual bool OnValueBuilt(base::Value* value) OVERRIDE {
+    scoped_ptr<base::Value> owned_value(value);
+    return converter_->Convert(*value, field_);
+  }
+
+ private:
+  const ValueConverter<FieldType>* converter_;
+  FieldType* field_;
+  DISALLOW_COPY_AND_ASSIGN(ValueConvertingSink);
+};
+
+template <typename FieldType>
+ValueSink* ValueConverter<FieldType>::CreateSink(FieldType* field) const {
+  return new ValueConvertingSink<FieldType>(this, field);
+}
+
 template <typename StructType, typename FieldType>
 class FieldConverter : public FieldConverterBase<StructType> {
  public:
@@ -127,12 +235,100 @@ class FieldConverter : public FieldConverterBase<StructType> {
     return value_converter_->Convert(value, &(dst->*field_pointer_));
   }
 
+  virtual ValueSink* CreateFieldSink(StructType* dst) const OVERRIDE {
+    return value_converter_->CreateSink(&(dst->*field_pointer_));
+  }
+
  private:
   FieldType StructType::* field_pointer_;
   scoped_ptr<ValueConverter<FieldType> > value_converter_;
   DISALLOW_COPY_AND_ASSIGN(FieldConverter);
 };
 
+template <typename FieldType>
+class BasicValueSink;
+
+template <>
+class BasicValueSink<int> : public ValueSink {
+ public:
+  explicit BasicValueSink(int* field) : field_(field) {}
+
+  virtual bool OnInteger(int value) OVERRIDE {
+    *field_ = value;
+    return true;
+  }
+
+ private:
+  int* field_;
+  DISALLOW_COPY_AND_ASSIGN(BasicValueSink);
+};
+
+template <>
+class BasicValueSink<std::string> : public ValueSink {
+ public:
+  explicit BasicValueSink(std::string* field) : field_(field) {}
+
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    value.CopyToString(field_);
+    return true;
+  }
+
+ private:
+  std::string* field_;
+  DISALLOW_COPY_AND_ASSIGN(BasicValueSink);
+};
+
+template <>
+class BasicValueSink<string16> : public ValueSink {
+ public:
+  explicit BasicValueSink(string16* field) : field_(field) {}
+
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    *field_ = UTF8ToUTF16(value);
+    return true;
+  }
+
+ private:
+  string16* field_;
+  DISALLOW_COPY_AND_ASSIGN(BasicValueSink);
+};
+
+template <>
+class BasicValueSink<double> : public ValueSink {
+ public:
+  explicit BasicValueSink(double* field) : field_(field) {}
+
+  // Like Value::GetAsDouble(), integers are accepted as well.
+  virtual bool OnInteger(int value) OVERRIDE {
+    *field_ = value;
+    return true;
+  }
+
+  virtual bool OnDouble(double value) OVERRIDE {
+    *field_ = value;
+    return true;
+  }
+
+ private:
+  double* field_;
+  DISALLOW_COPY_AND_ASSIGN(BasicValueSink);
+};
+
+template <>
+class BasicValueSink<bool> : public ValueSink {
+ public:
+  explicit BasicValueSink(bool* field) : field_(field) {}
+
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    *field_ = value;
+    return true;
+  }
+
+ private:
+  bool* field_;
+  DISALLOW_COPY_AND_ASSIGN(BasicValueSink);
+};
+
 template <typename FieldType>
 class BasicValueConverter;
 
@@ -145,6 +341,10 @@ class BasicValueConverter<int> : public ValueConverter<int> {
     return value.GetAsInteger(field);
   }
 
+  virtual ValueSink* CreateSink(int* field) const OVERRIDE {
+    return new BasicValueSink<int>(field);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(BasicValueConverter);
 };
@@ -159,6 +359,10 @@ class BasicValueConverter<std::string> : public ValueConverter<std::string> {
     return value.GetAsString(field);
   }
 
+  virtual ValueSink* CreateSink(std::string* field) const OVERRIDE {
+    return new BasicValueSink<std::string>(field);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(BasicValueConverter);
 };
@@ -173,6 +377,10 @@ class BasicValueConverter<string16> : public ValueConverter<string16> {
     return value.GetAsString(field);
   }
 
+  virtual ValueSink* CreateSink(string16* field) const OVERRIDE {
+    return new BasicValueSink<string16>(field);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(BasicValueConverter);
 };
@@ -186,6 +394,10 @@ class BasicValueConverter<double> : public ValueConverter<double> {
     return value.GetAsDouble(field);
   }
 
+  virtual ValueSink* CreateSink(double* field) const OVERRIDE {
+    return new BasicValueSink<double>(field);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(BasicValueConverter);
 };
@@ -199,6 +411,10 @@ class BasicValueConverter<bool> : public ValueConverter<bool> {
     return value.GetAsBoolean(field);
   }
 
+  virtual ValueSink* CreateSink(bool* field) const OVERRIDE {
+    return new BasicValueSink<bool>(field);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(BasicValueConverter);
 };
@@ -237,7 +453,28 @@ class CustomFieldConverter : public ValueConverter<FieldType> {
         convert_func_(string_value, field);
   }
 
+  virtual ValueSink* CreateSink(FieldType* field) const OVERRIDE {
+    return new Sink(convert_func_, field);
+  }
+
  private:
+  class Sink : public ValueSink {
+   public:
+    Sink(ConvertFunc convert_func, FieldType* field)
+        : convert_func_(convert_func),
+          field_(field) {
+    }
+
+    virtual bool OnString(const StringPiece& value) OVERRIDE {
+      return convert_func_(value, field_);
+    }
+
+   private:
+    ConvertFunc convert_func_;
+    FieldType* field_;
+    DISALLOW_COPY_AND_ASSIGN(Sink);
+  };
+
   ConvertFunc convert_func_;
 
   DISALLOW_COPY_AND_ASSIGN(CustomFieldConverter);
@@ -253,11 +490,41 @@ class NestedValueConverter : public ValueConverter<NestedType> {
     return converter_.Convert(value, field);
   }
 
+  virtual ValueSink* CreateSink(NestedType* field) const OVERRIDE {
+    return converter_.CreateSink(field);
+  }
+
  private:
   JSONValueConverter<NestedType> converter_;
   DISALLOW_COPY_AND_ASSIGN(NestedValueConverter);
 };
 
+// Appends each streamed list element to |field|, filling it through the sink
+// that |element_converter| creates for it.
+template <typename Element, typename ElementConverter>
+class RepeatedSink : public ValueSink {
+ public:
+  RepeatedSink(const ElementConverter* element_converter,
+               ScopedVector<Element>* field)
+      : element_converter_(element_converter),
+        field_(field) {
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    return true;
+  }
+
+  virtual ValueSink* CreateSinkForElement() OVERRIDE {
+    field_->push_back(new Element);
+    return element_converter_->CreateSink(field_->back());
+  }
+
+ private:
+  const ElementConverter* element_converter_;
+  ScopedVector<Element>* field_;
+  DISALLOW_COPY_AND_ASSIGN(RepeatedSink);
+};
+
 template <typename Element>
 class RepeatedValueConverter : public ValueConverter<ScopedVector<Element> > {
  public:
@@ -288,6 +555,12 @@ class RepeatedValueConverter : public ValueConverter<ScopedVector<Element> > {
     return true;
   }
 
+  virtual ValueSink* CreateSink(
+      ScopedVector<Element>* field) const OVERRIDE {
+    return new RepeatedSink<Element, BasicValueConverter<Element> >(
+        &basic_converter_, field);
+  }
+
  private:
   BasicValueConverter<Element> basic_converter_;
   DISALLOW_COPY_AND_ASSIGN(RepeatedValueConverter);
@@ -322,6 +595,12 @@ class RepeatedMessageConverter
     return true;
   }
 
+  virtual ValueSink* CreateSink(
+      ScopedVector<NestedType>* field) const OVERRIDE {
+    return new RepeatedSink<NestedType, JSONValueConverter<NestedType> >(
+        &converter_, field);
+  }
+
  private:
   JSONValueConverter<NestedType> converter_;
   DISALLOW_COPY_AND_ASSIGN(RepeatedMessageConverter);
@@ -364,6 +643,87 @@ class RepeatedCustomValueConverter
   DISALLOW_COPY_AND_ASSIGN(RepeatedCustomValueConverter);
 };
 
+// Handles a key whose value feeds fields registered with a dotted path (or
+// several fields at once) by building the value and looking the fields up in
+// it the way Convert() does.
+template <typename StructType>
+class FieldPathSink : public ValueBuilderSink {
+ public:
+  FieldPathSink(const StringPiece& key,
+                const std::vector<const FieldConverterBase<StructType>*>&
+                    fields,
+                StructType* obj)
+      : key_(key.as_string()),
+        fields_(fields),
+        obj_(obj) {
+  }
+
+ protected:
+  virtual bool OnValueBuilt(base::Value* value) OVERRIDE {
+    base::DictionaryValue root;
+    root.SetWithoutPathExpansion(key_, value);
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      const base::Value* field = NULL;
+      if (root.Get(fields_[i]->field_path(), &field) &&
+          !fields_[i]->ConvertField(*field, obj_)) {
+        DVLOG(1) << "failure at field " << fields_[i]->field_path();
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::string key_;
+  std::vector<const FieldConverterBase<StructType>*> fields_;
+  StructType* obj_;
+  DISALLOW_COPY_AND_ASSIGN(FieldPathSink);
+};
+
+// Streams a dictionary into the registered fields of |obj|. Keys without a
+// field are skipped.
+template <typename StructType>
+class StructSink : public ValueSink {
+ public:
+  typedef ScopedVector<FieldConverterBase<StructType> > Fields;
+
+  StructSink(const Fields* fields, StructType* obj)
+      : fields_(fields),
+        obj_(obj) {
+  }
+
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    return true;
+  }
+
+  virtual ValueSink* CreateSinkForKey(const StringPiece& key) OVERRIDE {
+    // Find the fields whose path starts with |key|.
+    std::vector<const FieldConverterBase<StructType>*> matches;
+    bool has_nested_path = false;
+    for (size_t i = 0; i < fields_->size(); ++i) {
+      const std::string& path = (*fields_)[i]->field_path();
+      size_t length = path.find('.');
+      if (length == std::string::npos)
+        length = path.size();
+      if (length != key.size() || path.compare(0, length, key.data(), length))
+        continue;
+      matches.push_back((*fields_)[i]);
+      has_nested_path |= length != path.size();
+    }
+
+    if (matches.empty())
+      return NULL;
+    if (matches.size() == 1 && !has_nested_path)
+      return matches[0]->CreateFieldSink(obj_);
+    return new FieldPathSink<StructType>(key, matches, obj_);
+  }
+
+ private:
+  const Fields* fields_;
+  StructType* obj_;
+  DISALLOW_COPY_AND_ASSIGN(StructSink);
+};
+
 
 }  // namespace internal
 
@@ -516,6 +876,19 @@ class JSONValueConverter {
     return true;
   }
 
+  // Parses |json| and fills |output| from the parse events directly, without
+  // building a Value tree. Returns false if |json| is malformed or if
+  // Convert() would fail on the parsed value.
+  bool ConvertFromJSON(const StringPiece& json, StructType* output) const {
+    return internal::ConvertJSONToSink(json, CreateSink(output));
+  }
+
+  // Returns a sink that streams a dictionary into |output|. The caller takes
+  // ownership.
+  internal::ValueSink* CreateSink(StructType* output) const {
+    return new internal::StructSink<StructType>(&fields_, output);
+  }
+
  private:
   ScopedVector<internal::FieldConverterBase<StructType> > fields_;
 
@@ -92,6 +92,20 @@ struct NestedMessage {
   }
 };
 
+// For fields registered with a dotted path.
+struct PathMessage {
+  int inner;
+  int outer;
+
+  PathMessage() : inner(0), outer(0) {}
+
+  static void RegisterJSONConverter(
+      base::JSONValueConverter<PathMessage>* converter) {
+    converter->RegisterIntField("a.b", &PathMessage::inner);
+    converter->RegisterIntField("c", &PathMessage::outer);
+  }
+};
+
 }  // namespace
 
 TEST(JSONValueConverterTest, ParseSimpleMessage) {
@@ -253,4 +267,112 @@ TEST(JSONValueConverterTest, RepeatedValueErrorInTheMiddle) {
   // No check the values as mentioned above.
 }
 
+TEST(JSONValueConverterTest, ConvertFromJSONNestedMessage) {
+  const char normal_data[] =
+      "{\n"
+      "  \"foo\": 1,\n"
+      "  \"unknown\": {\"foo\": [1, {\"bar\": null}], \"baz\": \"x\"},\n"
+      "  \"child\": {\n"
+      "    \"foo\": 1,\n"
+      "    \"bar\": \"b\\u00e4r\",\n"
+      "    \"bstruct\": {\"nested\": [true]},\n"
+      "    \"string_values\": [{\"val\": \"value_1\"}, {\"val\": \"value_2\"}],"
+      "    \"simple_enum\": \"bar\",\n"
+      "    \"ints\": [1, 2, 3],\n"
+      "    \"baz\": true\n"
+      "  },\n"
+      "  \"children\": [{\n"
+      "    \"foo\": 2,\n"
+      "    \"bar\": \"foobar\",\n"
+      "    \"baz\": true\n"
+      "  },\n"
+      "  {\n"
+      "    \"foo\": 3,\n"
+      "    \"unknown\": [[]],\n"
+      "    \"baz\": false\n"
+      "  }]\n"
+      "}\n";
+
+  NestedMessage message;
+  base::JSONValueConverter<NestedMessage> converter;
+  EXPECT_TRUE(converter.ConvertFromJSON(normal_data, &message));
+
+  EXPECT_EQ(1.0, message.foo);
+  EXPECT_EQ(1, message.child.foo);
+  EXPECT_EQ("b\xC3\xA4r", message.child.bar);
+  EXPECT_TRUE(message.child.baz);
+  EXPECT_TRUE(message.child.bstruct);
+  EXPECT_EQ(SimpleMessage::BAR, message.child.simple_enum);
+  ASSERT_EQ(3U, message.child.ints.size());
+  EXPECT_EQ(3, *message.child.ints[2]);
+  ASSERT_EQ(2U, message.child.string_values.size());
+  EXPECT_EQ("value_1", *message.child.string_values[0]);
+  EXPECT_EQ("value_2", *message.child.string_values[1]);
+
+  ASSERT_EQ(2U, message.children.size());
+  EXPECT_EQ(2, message.children[0]->foo);
+  EXPECT_EQ("foobar", message.children[0]->bar);
+  EXPECT_TRUE(message.children[0]->baz);
+  EXPECT_EQ(3, message.children[1]->foo);
+  EXPECT_FALSE(message.children[1]->baz);
+  EXPECT_FALSE(message.children[1]->bstruct);
+}
+
+TEST(JSONValueConverterTest, ConvertFromJSONFailures) {
+  base::JSONValueConverter<SimpleMessage> converter;
+  {
+    SimpleMessage message;
+    // "bar" is an integer here.
+    EXPECT_FALSE(converter.ConvertFromJSON("{\"bar\": 2}", &message));
+  }
+  {
+    SimpleMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON("{\"foo\": 1.5}", &message));
+  }
+  {
+    SimpleMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON("{\"foo\": null}", &message));
+  }
+  {
+    SimpleMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON("{\"simple_enum\": \"baz\"}",
+                                           &message));
+  }
+  {
+    SimpleMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON("{\"ints\": [1, false]}",
+                                           &message));
+  }
+  {
+    SimpleMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON("{\"ints\": 1}", &message));
+  }
+  {
+    SimpleMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON("[]", &message));
+  }
+  {
+    // Malformed input fails even if every field converted.
+    SimpleMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON("{\"foo\": 1", &message));
+  }
+}
+
+TEST(JSONValueConverterTest, ConvertFromJSONFieldPath) {
+  const char normal_data[] =
+      "{\"a\": {\"x\": 1, \"b\": 2}, \"a.b\": 3, \"c\": 4}";
+
+  scoped_ptr<Value> value(base::JSONReader::Read(normal_data));
+  base::JSONValueConverter<PathMessage> converter;
+  PathMessage expected;
+  EXPECT_TRUE(converter.Convert(*value.get(), &expected));
+  EXPECT_EQ(2, expected.inner);
+  EXPECT_EQ(4, expected.outer);
+
+  PathMessage message;
+  EXPECT_TRUE(converter.ConvertFromJSON(normal_data, &message));
+  EXPECT_EQ(expected.inner, message.inner);
+  EXPECT_EQ(expected.outer, message.outer);
+}
+
 }  // namespace base
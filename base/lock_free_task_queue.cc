@@ -0,0 +1,81 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/lock_free_task_queue.h"
+
+#include "base/logging.h"
+
+namespace base {
+
+struct LockFreeTaskQueue::Node {
+  explicit Node(const PendingTask& pending_task)
+      : pending_task(pending_task),
+        next(NULL) {
+  }
+
+  PendingTask pending_task;
+  Node* next;
+};
+
+LockFreeTaskQueue::LockFreeTaskQueue() : head_(0) {
+}
+
+LockFreeTaskQueue::~LockFreeTaskQueue() {
+  Node* node = reinterpret_cast<Node*>(subtle::Acquire_Load(&head_));
+  while (node) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+bool LockFreeTaskQueue::Push(const PendingTask& pending_task) {
+  Node* node = new Node(pending_task);
+  subtle::AtomicWord new_head = reinterpret_cast<subtle::AtomicWord>(node);
+  subtle::AtomicWord old_head = subtle::NoBarrier_Load(&head_);
+  for (;;) {
+    node->next = reinterpret_cast<Node*>(old_head);
+    // The release barrier publishes |node|'s contents before it becomes
+    // reachable from |head_|.
+    subtle::AtomicWord observed =
+        subtle::Release_CompareAndSwap(&head_, old_head, new_head);
+    if (observed == old_head)
+      return old_head == 0;
+    old_head = observed;
+  }
+}
+
+bool LockFreeTaskQueue::TakeAll(TaskQueue* queue) {
+  DCHECK(queue);
+  if (!subtle::NoBarrier_Load(&head_))
+    return false;
+
+  subtle::AtomicWord taken = subtle::NoBarrier_AtomicExchange(&head_, 0);
+  // Pairs with the release in Push() so the nodes' contents are visible.
+  subtle::MemoryBarrier();
+
+  // The detached stack is newest first; reverse it to restore FIFO order.
+  Node* reversed = NULL;
+  Node* node = reinterpret_cast<Node*>(taken);
+  while (node) {
+    Node* next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+
+  while (reversed) {
+    Node* next = reversed->next;
+    queue->push(reversed->pending_task);
+    delete reversed;
+    reversed = next;
+  }
+  return taken != 0;
+}
+
+bool LockFreeTaskQueue::IsEmpty() const {
+  return subtle::Acquire_Load(&head_) == 0;
+}
+
+}  // namespace base
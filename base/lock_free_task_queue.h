@@ -0,0 +1,58 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_LOCK_FREE_TASK_QUEUE_H_
+#define BASE_LOCK_FREE_TASK_QUEUE_H_
+
+#include "base/atomicops.h"
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/pending_task.h"
+
+namespace base {
+
+// A multi-producer, single-consumer queue of PendingTasks that never takes a
+// lock.  Any number of threads may call Push() concurrently; only one thread
+// (the owning MessageLoop's thread) may call TakeAll().
+//
+// Producers push onto an intrusive singly linked stack with a compare and
+// swap.  The consumer detaches the whole stack with a single atomic exchange
+// and reverses it, so tasks come out in the order in which they were pushed.
+// Since the consumer never removes individual nodes, the push side is immune
+// to the ABA problem.
+class BASE_EXPORT LockFreeTaskQueue {
+ public:
+  LockFreeTaskQueue();
+
+  // Deletes any tasks that were never taken.
+  ~LockFreeTaskQueue();
+
+  // Appends a copy of |pending_task|.  Returns true if the queue was empty
+  // before the push, which tells the caller that it is responsible for
+  // waking up the consumer.  All other producers in the same burst get false,
+  // so a burst of N pushes results in a single wakeup.  May be called on any
+  // thread.
+  bool Push(const PendingTask& pending_task);
+
+  // Moves every queued task to the back of |queue|, oldest first.  Returns
+  // false if there was nothing to take.  Must only be called on the consumer
+  // thread.
+  bool TakeAll(TaskQueue* queue);
+
+  // Returns true if no task is queued.  The result is only a snapshot when
+  // other threads may be pushing.
+  bool IsEmpty() const;
+
+ private:
+  struct Node;
+
+  // Points at the most recently pushed Node, or is 0 when empty.
+  subtle::AtomicWord head_;
+
+  DISALLOW_COPY_AND_ASSIGN(LockFreeTaskQueue);
+};
+
+}  // namespace base
+
+#endif  // BASE_LOCK_FREE_TASK_QUEUE_H_
@@ -0,0 +1,114 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/lock_free_task_queue.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_vector.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+void Nop() {
+}
+
+PendingTask MakeTask(int sequence_num) {
+  PendingTask pending_task(FROM_HERE, Bind(&Nop));
+  pending_task.sequence_num = sequence_num;
+  return pending_task;
+}
+
+// Pushes |count| tasks tagged with |producer| * |count| + i.
+class PushRunner : public DelegateSimpleThread::Delegate {
+ public:
+  PushRunner(LockFreeTaskQueue* queue, int producer, int count)
+      : queue_(queue), producer_(producer), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < count_; ++i)
+      queue_->Push(MakeTask(producer_ * count_ + i));
+  }
+
+ private:
+  LockFreeTaskQueue* queue_;
+  int producer_;
+  int count_;
+};
+
+}  // namespace
+
+TEST(LockFreeTaskQueueTest, FifoOrder) {
+  LockFreeTaskQueue queue;
+  EXPECT_TRUE(queue.IsEmpty());
+
+  EXPECT_TRUE(queue.Push(MakeTask(0)));
+  EXPECT_FALSE(queue.Push(MakeTask(1)));
+  EXPECT_FALSE(queue.Push(MakeTask(2)));
+  EXPECT_FALSE(queue.IsEmpty());
+
+  TaskQueue work_queue;
+  EXPECT_TRUE(queue.TakeAll(&work_queue));
+  EXPECT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(3u, work_queue.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i, work_queue.front().sequence_num);
+    work_queue.pop();
+  }
+
+  EXPECT_FALSE(queue.TakeAll(&work_queue));
+  EXPECT_TRUE(work_queue.empty());
+
+  // The queue reports empty again after being drained.
+  EXPECT_TRUE(queue.Push(MakeTask(3)));
+}
+
+TEST(LockFreeTaskQueueTest, DeletesUntakenTasks) {
+  LockFreeTaskQueue* queue = new LockFreeTaskQueue;
+  queue->Push(MakeTask(0));
+  queue->Push(MakeTask(1));
+  delete queue;
+}
+
+TEST(LockFreeTaskQueueTest, ConcurrentProducers) {
+  const int kProducers = 8;
+  const int kTasksPerProducer = 1000;
+
+  LockFreeTaskQueue queue;
+  ScopedVector<PushRunner> runners;
+  ScopedVector<DelegateSimpleThread> threads;
+  for (int i = 0; i < kProducers; ++i) {
+    runners.push_back(new PushRunner(&queue, i, kTasksPerProducer));
+    threads.push_back(new DelegateSimpleThread(runners[i], "producer"));
+  }
+  for (int i = 0; i < kProducers; ++i)
+    threads[i]->Start();
+
+  // Drain while the producers are still running.
+  TaskQueue work_queue;
+  std::vector<int> next_expected(kProducers, 0);
+  int taken = 0;
+  while (taken < kProducers * kTasksPerProducer) {
+    queue.TakeAll(&work_queue);
+    while (!work_queue.empty()) {
+      int sequence_num = work_queue.front().sequence_num;
+      work_queue.pop();
+      int producer = sequence_num / kTasksPerProducer;
+      // Tasks from any single producer must come out in push order.
+      EXPECT_EQ(next_expected[producer], sequence_num % kTasksPerProducer);
+      ++next_expected[producer];
+      ++taken;
+    }
+  }
+
+  for (int i = 0; i < kProducers; ++i)
+    threads[i]->Join();
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+}  // namespace base
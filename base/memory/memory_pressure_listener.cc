@@ -0,0 +1,61 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_pressure_listener.h"
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/observer_list_threadsafe.h"
+
+namespace {
+
+// Holds the process-wide list of listeners. ObserverListThreadSafe is
+// reference counted, so it cannot be the lazy instance itself.
+class MemoryPressureObserverList {
+ public:
+  MemoryPressureObserverList()
+      : observers_(
+            new ObserverListThreadSafe<base::MemoryPressureListener>()) {
+  }
+
+  ObserverListThreadSafe<base::MemoryPressureListener>* observers() {
+    return observers_.get();
+  }
+
+ private:
+  scoped_refptr<ObserverListThreadSafe<base::MemoryPressureListener> >
+      observers_;
+};
+
+base::LazyInstance<MemoryPressureObserverList>::Leaky g_observer_list =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+namespace base {
+
+MemoryPressureListener::MemoryPressureListener(
+    const MemoryPressureListener::MemoryPressureCallback& callback)
+    : callback_(callback) {
+  g_observer_list.Get().observers()->AddObserver(this);
+}
+
+MemoryPressureListener::~MemoryPressureListener() {
+  g_observer_list.Get().observers()->RemoveObserver(this);
+}
+
+void MemoryPressureListener::Notify(MemoryPressureLevel level) {
+  callback_.Run(level);
+}
+
+// static
+void MemoryPressureListener::NotifyMemoryPressure(
+    MemoryPressureLevel level) {
+  DCHECK_GE(level, MEMORY_PRESSURE_MODERATE);
+  DCHECK_LT(level, MEMORY_PRESSURE_LEVEL_COUNT);
+  g_observer_list.Get().observers()->Notify(&MemoryPressureListener::Notify,
+                                            level);
+}
+
+}  // namespace base
@@ -0,0 +1,70 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// MemoryPressureListener provides static APIs for handling memory pressure
+// signals. Subsystems that hold caches which can be rebuilt create a
+// MemoryPressureListener and drop what they can when it is notified, in
+// proportion to the level of pressure.
+//
+// The callback of a listener runs on the thread it was created on, so it can
+// safely touch the caches owned by that thread:
+//
+//   void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level) {
+//     if (level == MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+//       cache_.clear();
+//     else
+//       cache_.ShrinkTo(cache_.size() / 2);
+//   }
+//
+//   memory_pressure_listener_.reset(new MemoryPressureListener(
+//       base::Bind(&MyClass::OnMemoryPressure, base::Unretained(this))));
+//
+// A listener must be destroyed on the thread it was created on, after which
+// its callback is never run.
+
+#ifndef BASE_MEMORY_MEMORY_PRESSURE_LISTENER_H_
+#define BASE_MEMORY_MEMORY_PRESSURE_LISTENER_H_
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/callback.h"
+
+namespace base {
+
+class BASE_EXPORT MemoryPressureListener {
+ public:
+  // Levels are ordered by severity and are recorded in histograms, so new
+  // levels must be appended.
+  enum MemoryPressureLevel {
+    // Memory is getting low. Drop caches that are cheap to rebuild and
+    // trim the others.
+    MEMORY_PRESSURE_MODERATE = 0,
+
+    // The system is about to start killing processes. Release everything
+    // that is not needed to keep working.
+    MEMORY_PRESSURE_CRITICAL,
+
+    MEMORY_PRESSURE_LEVEL_COUNT
+  };
+
+  typedef base::Callback<void(MemoryPressureLevel)> MemoryPressureCallback;
+
+  explicit MemoryPressureListener(const MemoryPressureCallback& callback);
+  ~MemoryPressureListener();
+
+  // Notifies all the listeners in this process, on their own threads, that
+  // memory is under pressure. May be called from any thread.
+  static void NotifyMemoryPressure(MemoryPressureLevel level);
+
+ private:
+  void Notify(MemoryPressureLevel level);
+
+  MemoryPressureCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPressureListener);
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_MEMORY_PRESSURE_LISTENER_H_
@@ -0,0 +1,81 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_pressure_listener.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class PressureRecorder {
+ public:
+  PressureRecorder()
+      : listener_(base::Bind(&PressureRecorder::OnMemoryPressure,
+                             base::Unretained(this))) {
+  }
+
+  const std::vector<MemoryPressureListener::MemoryPressureLevel>& levels()
+      const {
+    return levels_;
+  }
+
+ private:
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level) {
+    levels_.push_back(level);
+  }
+
+  MemoryPressureListener listener_;
+  std::vector<MemoryPressureListener::MemoryPressureLevel> levels_;
+
+  DISALLOW_COPY_AND_ASSIGN(PressureRecorder);
+};
+
+}  // namespace
+
+TEST(MemoryPressureListenerTest, NotifiesAllListeners) {
+  MessageLoop message_loop;
+  PressureRecorder first;
+  PressureRecorder second;
+
+  MemoryPressureListener::NotifyMemoryPressure(
+      MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+  // Listeners are notified asynchronously, on their own thread.
+  EXPECT_TRUE(first.levels().empty());
+  message_loop.RunUntilIdle();
+
+  ASSERT_EQ(1U, first.levels().size());
+  EXPECT_EQ(MemoryPressureListener::MEMORY_PRESSURE_MODERATE,
+            first.levels()[0]);
+  ASSERT_EQ(1U, second.levels().size());
+
+  MemoryPressureListener::NotifyMemoryPressure(
+      MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  message_loop.RunUntilIdle();
+  ASSERT_EQ(2U, first.levels().size());
+  EXPECT_EQ(MemoryPressureListener::MEMORY_PRESSURE_CRITICAL,
+            first.levels()[1]);
+}
+
+TEST(MemoryPressureListenerTest, DestroyedListenerIsNotNotified) {
+  MessageLoop message_loop;
+  PressureRecorder kept;
+  scoped_ptr<PressureRecorder> destroyed(new PressureRecorder);
+
+  MemoryPressureListener::NotifyMemoryPressure(
+      MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  // The notification is already posted when the listener goes away.
+  destroyed.reset();
+  message_loop.RunUntilIdle();
+
+  EXPECT_EQ(1U, kept.levels().size());
+}
+
+}  // namespace base
@@ -99,6 +99,22 @@ uint64 GetTaskTraceID(const PendingTask& task, MessageLoop* loop) {
          static_cast<uint64>(reinterpret_cast<intptr_t>(loop));
 }
 
+// Rounds |run_time| up to the next multiple of the largest power of two
+// milliseconds that is no more than |leeway|, so that every task due within
+// the same window gets the same run time and they run after one wakeup.
+TimeTicks AlignToWakeupWindow(TimeTicks run_time, TimeDelta leeway) {
+  int64 window = base::Time::kMicrosecondsPerMillisecond;
+  if (leeway.InMicroseconds() < window)
+    return run_time;
+  while (window * 2 <= leeway.InMicroseconds())
+    window *= 2;
+  int64 ticks = (run_time - TimeTicks()).InMicroseconds();
+  int64 remainder = ticks % window;
+  if (!remainder)
+    return run_time;
+  return run_time + TimeDelta::FromMicroseconds(window - remainder);
+}
+
 }  // namespace
 
 //------------------------------------------------------------------------------
@@ -136,11 +152,14 @@ MessageLoop::DestructionObserver::~DestructionObserver() {
 
 //------------------------------------------------------------------------------
 
-MessageLoop::MessageLoop(Type type)
+MessageLoop::MessageLoop(Type type, IncomingQueueType incoming_queue_type)
     : type_(type),
+      delayed_wakeup_count_(0),
+      delayed_wakeups_since_rate_start_(0),
       nestable_tasks_allowed_(true),
       exception_restoration_(false),
       message_histogram_(NULL),
+      incoming_queue_type_(incoming_queue_type),
       run_loop_(NULL),
 #ifdef OS_WIN
       os_modal_loop_(false),
@@ -283,6 +302,19 @@ void MessageLoop::PostDelayedTask(
   AddToIncomingQueue(&pending_task);
 }
 
+void MessageLoop::PostDelayedTaskWithLeeway(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task,
+    TimeDelta delay,
+    TimeDelta leeway) {
+  DCHECK(!task.is_null()) << from_here.ToString();
+  TimeTicks delayed_run_time = CalculateDelayedRuntime(delay);
+  if (!delayed_run_time.is_null())
+    delayed_run_time = AlignToWakeupWindow(delayed_run_time, leeway);
+  PendingTask pending_task(from_here, task, delayed_run_time, true);
+  AddToIncomingQueue(&pending_task);
+}
+
 void MessageLoop::PostNonNestableTask(
     const tracked_objects::Location& from_here,
     const base::Closure& task) {
@@ -373,6 +405,10 @@ void MessageLoop::RemoveTaskObserver(TaskObserver* task_observer) {
 
 void MessageLoop::AssertIdle() const {
   // We only check |incoming_queue_|, since we don't want to lock |work_queue_|.
+  if (incoming_queue_type_ == INCOMING_QUEUE_LOCK_FREE) {
+    DCHECK(lock_free_incoming_queue_.IsEmpty());
+    return;
+  }
   base::AutoLock lock(incoming_queue_lock_);
   DCHECK(incoming_queue_.empty());
 }
@@ -472,7 +508,8 @@ void MessageLoop::RunTask(const PendingTask& pending_task) {
                     DidProcessTask(pending_task.time_posted));
 
   tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
-      start_time, tracked_objects::ThreadData::NowForEndOfRun());
+      start_time,
+      tracked_objects::ThreadData::NowForEndOfRun(pending_task.birth_tally));
 
   nestable_tasks_allowed_ = true;
 }
@@ -504,6 +541,12 @@ void MessageLoop::ReloadWorkQueue() {
   if (!work_queue_.empty())
     return;  // Wait till we *really* need to lock and load.
 
+  if (incoming_queue_type_ == INCOMING_QUEUE_LOCK_FREE) {
+    // Detaches everything posted so far with a single atomic exchange.
+    lock_free_incoming_queue_.TakeAll(&work_queue_);
+    return;
+  }
+
   // Acquire all we can from the inter-thread queue with one lock acquisition.
   {
     base::AutoLock lock(incoming_queue_lock_);
@@ -581,12 +624,37 @@ TimeTicks MessageLoop::CalculateDelayedRuntime(TimeDelta delay) {
   return delayed_run_time;
 }
 
+void MessageLoop::RecordDelayedWakeup() {
+  ++delayed_wakeup_count_;
+  ++delayed_wakeups_since_rate_start_;
+  HistogramEvent(kTimerEvent);
+
+  if (delayed_wakeup_rate_start_.is_null()) {
+    delayed_wakeup_rate_start_ = recent_time_;
+    return;
+  }
+  TimeDelta elapsed = recent_time_ - delayed_wakeup_rate_start_;
+  if (elapsed < TimeDelta::FromSeconds(1))
+    return;
+  TRACE_COUNTER_ID1("task", "MessageLoop::DelayedWakeupsPerSecond", this,
+                    static_cast<int>(delayed_wakeups_since_rate_start_ *
+                                     TimeDelta::FromSeconds(1).InSecondsF() /
+                                     elapsed.InSecondsF()));
+  delayed_wakeup_rate_start_ = recent_time_;
+  delayed_wakeups_since_rate_start_ = 0;
+}
+
 // Possibly called on a background thread!
 void MessageLoop::AddToIncomingQueue(PendingTask* pending_task) {
   // Warning: Don't try to short-circuit, and handle this thread's tasks more
   // directly, as it could starve handling of foreign threads.  Put every task
   // into this queue.
 
+  if (incoming_queue_type_ == INCOMING_QUEUE_LOCK_FREE) {
+    AddToLockFreeIncomingQueue(pending_task);
+    return;
+  }
+
   scoped_refptr<base::MessagePump> pump;
   {
     base::AutoLock locked(incoming_queue_lock_);
@@ -615,6 +683,28 @@ void MessageLoop::AddToIncomingQueue(PendingTask* pending_task) {
   pump->ScheduleWork();
 }
 
+// Possibly called on a background thread!
+void MessageLoop::AddToLockFreeIncomingQueue(PendingTask* pending_task) {
+  // As soon as the task is pushed the loop may run it, and that task may
+  // destroy this message loop.  Take a reference to the pump up front so that
+  // ScheduleWork can be called without touching |this| afterwards.
+  scoped_refptr<base::MessagePump> pump = pump_;
+
+  pending_task->sequence_num = static_cast<int>(
+      base::subtle::NoBarrier_AtomicIncrement(&next_sequence_num_, 1) - 1);
+
+  TRACE_EVENT_FLOW_BEGIN0("task", "MessageLoop::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(*pending_task, this)));
+
+  bool was_empty = lock_free_incoming_queue_.Push(*pending_task);
+  pending_task->task.Reset();
+
+  // Only the post that found the queue empty wakes up the pump, so a burst of
+  // posts from any number of threads results in a single ScheduleWork.
+  if (was_empty)
+    pump->ScheduleWork();
+}
+
 //------------------------------------------------------------------------------
 // Method and data for histogramming events and actions taken by each instance
 // on each thread.
@@ -688,6 +778,7 @@ bool MessageLoop::DoDelayedWork(TimeTicks* next_delayed_work_time) {
       *next_delayed_work_time = next_run_time;
       return false;
     }
+    RecordDelayedWakeup();
   }
 
   PendingTask pending_task = delayed_work_queue_.top();
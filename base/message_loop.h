@@ -12,6 +12,7 @@
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
 #include "base/location.h"
+#include "base/lock_free_task_queue.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop_proxy.h"
 #include "base/message_pump.h"
@@ -107,9 +108,26 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
     TYPE_IO
   };
 
+  // Selects how tasks posted from other threads are handed to this loop.
+  //
+  // INCOMING_QUEUE_LOCKED
+  //   Every post takes a lock shared by all posting threads.  This is the
+  //   default.
+  //
+  // INCOMING_QUEUE_LOCK_FREE
+  //   Posts go through a LockFreeTaskQueue.  This is intended for loops that
+  //   receive heavy traffic from many threads, such as the IO thread.
+  //
+  enum IncomingQueueType {
+    INCOMING_QUEUE_LOCKED,
+    INCOMING_QUEUE_LOCK_FREE
+  };
+
   // Normally, it is not necessary to instantiate a MessageLoop.  Instead, it
   // is typical to make use of the current thread's MessageLoop instance.
-  explicit MessageLoop(Type type = TYPE_DEFAULT);
+  explicit MessageLoop(
+      Type type = TYPE_DEFAULT,
+      IncomingQueueType incoming_queue_type = INCOMING_QUEUE_LOCKED);
   virtual ~MessageLoop();
 
   // Returns the MessageLoop object for the current thread, or null if none.
@@ -171,6 +189,16 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
       const base::Closure& task,
       base::TimeDelta delay);
 
+  // Like PostDelayedTask, but lets the task run up to |leeway| after its
+  // delay has elapsed.  The run time is rounded up to a boundary of a window
+  // of time that fits within |leeway|, so that tasks that are due around the
+  // same time run together after a single wakeup of the thread.
+  void PostDelayedTaskWithLeeway(
+      const tracked_objects::Location& from_here,
+      const base::Closure& task,
+      base::TimeDelta delay,
+      base::TimeDelta leeway);
+
   void PostNonNestableTask(
       const tracked_objects::Location& from_here,
       const base::Closure& task);
@@ -265,6 +293,11 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // Returns the type passed to the constructor.
   Type type() const { return type_; }
 
+  // Returns the incoming queue type passed to the constructor.
+  IncomingQueueType incoming_queue_type() const {
+    return incoming_queue_type_;
+  }
+
   // Optional call to connect the thread name with this loop.
   void set_thread_name(const std::string& thread_name) {
     DCHECK(thread_name_.empty()) << "Should not rename this thread!";
@@ -350,6 +383,12 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   void AddTaskObserver(TaskObserver* task_observer);
   void RemoveTaskObserver(TaskObserver* task_observer);
 
+  // Returns the number of times this loop has woken up to run delayed tasks
+  // whose time had come.  Delayed tasks that become due together (such as
+  // tasks posted with enough leeway) account for a single wakeup.  The rate
+  // is also reported once a second as an about:tracing counter.
+  int delayed_wakeup_count() const { return delayed_wakeup_count_; }
+
   // Returns true if the message loop has high resolution timers enabled.
   // Provided for testing.
   bool high_resolution_timers_enabled() {
@@ -430,9 +469,14 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // beyond this function call.
   void AddToIncomingQueue(base::PendingTask* pending_task);
 
+  // The INCOMING_QUEUE_LOCK_FREE flavor of AddToIncomingQueue.  Same
+  // ownership rules apply.
+  void AddToLockFreeIncomingQueue(base::PendingTask* pending_task);
+
   // Load tasks from the incoming_queue_ into work_queue_ if the latter is
   // empty.  The former requires a lock to access, while the latter is directly
-  // accessible on this thread.
+  // accessible on this thread.  With INCOMING_QUEUE_LOCK_FREE tasks are taken
+  // from lock_free_incoming_queue_ instead.
   void ReloadWorkQueue();
 
   // Delete tasks that haven't run yet without running them.  Used in the
@@ -443,6 +487,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // Calculates the time at which a PendingTask should run.
   base::TimeTicks CalculateDelayedRuntime(base::TimeDelta delay);
 
+  // Counts a wakeup that found delayed work to run, with recent_time_ just
+  // updated.
+  void RecordDelayedWakeup();
+
   // Start recording histogram info about events and action IF it was enabled
   // and IF the statistics recorder can accept a registration of our histogram.
   void StartHistogrammer();
@@ -469,6 +517,12 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // A recent snapshot of Time::Now(), used to check delayed_work_queue_.
   base::TimeTicks recent_time_;
 
+  // See delayed_wakeup_count().  The wakeups since delayed_wakeup_rate_start_
+  // are reported as a rate once a second.
+  int delayed_wakeup_count_;
+  int delayed_wakeups_since_rate_start_;
+  base::TimeTicks delayed_wakeup_rate_start_;
+
   // A queue of non-nestable tasks that we had to defer because when it came
   // time to execute them we were in a nested message loop.  They will execute
   // once we're out of nested message loops.
@@ -496,6 +550,11 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // Protect access to incoming_queue_.
   mutable base::Lock incoming_queue_lock_;
 
+  // Replaces incoming_queue_ if this loop was created with
+  // INCOMING_QUEUE_LOCK_FREE.  Accessed without holding incoming_queue_lock_.
+  const IncomingQueueType incoming_queue_type_;
+  base::LockFreeTaskQueue lock_free_incoming_queue_;
+
   base::RunLoop* run_loop_;
 
 #if defined(OS_WIN)
@@ -506,8 +565,9 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
 #endif
 
   // The next sequence number to use for delayed tasks. Updating this counter is
-  // protected by incoming_queue_lock_.
-  int next_sequence_num_;
+  // protected by incoming_queue_lock_, or done atomically when the incoming
+  // queue is lock free.
+  base::subtle::Atomic32 next_sequence_num_;
 
   ObserverList<TaskObserver> task_observers_;
 
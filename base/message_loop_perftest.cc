@@ -0,0 +1,84 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const int kTasksPerThread = 20000;
+
+// Counts completed tasks on the target loop and quits it once all of them
+// have run.
+class TaskCounter {
+ public:
+  explicit TaskCounter(int expected) : expected_(expected), count_(0) {}
+
+  void Increment() {
+    if (++count_ == expected_)
+      MessageLoop::current()->Quit();
+  }
+
+ private:
+  const int expected_;
+  int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskCounter);
+};
+
+void PostBurst(base::WaitableEvent* start,
+               MessageLoop* target,
+               TaskCounter* counter) {
+  start->Wait();
+  for (int i = 0; i < kTasksPerThread; ++i) {
+    target->PostTask(FROM_HERE, base::Bind(&TaskCounter::Increment,
+                                           base::Unretained(counter)));
+  }
+}
+
+void RunPostTaskBenchmark(MessageLoop::IncomingQueueType incoming_queue_type,
+                          int num_threads) {
+  MessageLoop loop(MessageLoop::TYPE_DEFAULT, incoming_queue_type);
+  TaskCounter counter(num_threads * kTasksPerThread);
+  base::WaitableEvent start(true, false);
+
+  ScopedVector<base::Thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new base::Thread("PostTaskPerf"));
+    ASSERT_TRUE(threads[i]->Start());
+    threads[i]->message_loop()->PostTask(
+        FROM_HERE, base::Bind(&PostBurst, &start, &loop, &counter));
+  }
+
+  std::string name = base::StringPrintf(
+      "PostTask_%s_%dthreads",
+      incoming_queue_type == MessageLoop::INCOMING_QUEUE_LOCK_FREE ?
+          "lockfree" : "locked",
+      num_threads);
+  PerfTimeLogger timer(name.c_str());
+  start.Signal();
+  loop.Run();
+  timer.Done();
+
+  for (int i = 0; i < num_threads; ++i)
+    threads[i]->Stop();
+}
+
+}  // namespace
+
+TEST(MessageLoopPerfTest, PostTaskLocked) {
+  for (int num_threads = 1; num_threads <= 32; num_threads *= 2)
+    RunPostTaskBenchmark(MessageLoop::INCOMING_QUEUE_LOCKED, num_threads);
+}
+
+TEST(MessageLoopPerfTest, PostTaskLockFree) {
+  for (int num_threads = 1; num_threads <= 32; num_threads *= 2)
+    RunPostTaskBenchmark(MessageLoop::INCOMING_QUEUE_LOCK_FREE, num_threads);
+}
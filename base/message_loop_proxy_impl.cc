@@ -19,6 +19,19 @@ bool MessageLoopProxyImpl::PostDelayedTask(
   return PostTaskHelper(from_here, task, delay, true);
 }
 
+bool MessageLoopProxyImpl::PostDelayedTaskWithLeeway(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task,
+    base::TimeDelta delay,
+    base::TimeDelta leeway) {
+  AutoLock lock(message_loop_lock_);
+  if (!target_message_loop_)
+    return false;
+  target_message_loop_->PostDelayedTaskWithLeeway(from_here, task, delay,
+                                                  leeway);
+  return true;
+}
+
 bool MessageLoopProxyImpl::PostNonNestableDelayedTask(
     const tracked_objects::Location& from_here,
     const base::Closure& task,
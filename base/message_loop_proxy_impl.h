@@ -21,6 +21,11 @@ class BASE_EXPORT MessageLoopProxyImpl : public MessageLoopProxy {
   virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
                                const base::Closure& task,
                                base::TimeDelta delay) OVERRIDE;
+  virtual bool PostDelayedTaskWithLeeway(
+      const tracked_objects::Location& from_here,
+      const base::Closure& task,
+      base::TimeDelta delay,
+      base::TimeDelta leeway) OVERRIDE;
   virtual bool PostNonNestableDelayedTask(
       const tracked_objects::Location& from_here,
       const base::Closure& task,
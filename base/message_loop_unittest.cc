@@ -10,6 +10,7 @@
 #include "base/eintr_wrapper.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop.h"
 #include "base/run_loop.h"
 #include "base/thread_task_runner_handle.h"
@@ -294,6 +295,72 @@ void RunTest_PostDelayedTask_InPostOrder_3(
   EXPECT_TRUE(run_time2 > run_time1);
 }
 
+void RecordWakeupCountFunc(int* wakeup_count, int* quit_counter) {
+  *wakeup_count = MessageLoop::current()->delayed_wakeup_count();
+  if (--(*quit_counter) == 0)
+    MessageLoop::current()->Quit();
+}
+
+void RecordRunOrderFunc(std::vector<int>* run_order, int id,
+                        int* quit_counter) {
+  run_order->push_back(id);
+  if (--(*quit_counter) == 0)
+    MessageLoop::current()->Quit();
+}
+
+void RunTest_PostDelayedTaskWithLeeway(MessageLoop::Type message_loop_type) {
+  MessageLoop loop(message_loop_type);
+
+  // Test that delayed tasks with enough leeway share a wakeup, still run in
+  // delay order, and never run early.  The tasks may straddle the boundary
+  // of an alignment window, so they take at most two wakeups.
+  const int kNumTasks = 4;
+  const TimeDelta kLeeway = TimeDelta::FromMilliseconds(500);
+
+  int num_tasks = kNumTasks;
+  int wakeup_counts[kNumTasks] = { 0 };
+  for (int i = 0; i < kNumTasks; ++i) {
+    loop.PostDelayedTaskWithLeeway(
+        FROM_HERE,
+        base::Bind(&RecordWakeupCountFunc, &wakeup_counts[i], &num_tasks),
+        TimeDelta::FromMilliseconds(10 + i), kLeeway);
+  }
+
+  TimeTicks time_before_run = TimeTicks::Now();
+  loop.Run();
+  TimeTicks time_after_run = TimeTicks::Now();
+
+  EXPECT_EQ(0, num_tasks);
+  EXPECT_LE(TimeDelta::FromMilliseconds(10 + kNumTasks - 1),
+            time_after_run - time_before_run);
+  EXPECT_LE(1, loop.delayed_wakeup_count());
+  EXPECT_GE(2, loop.delayed_wakeup_count());
+  for (int i = 1; i < kNumTasks; ++i)
+    EXPECT_LE(wakeup_counts[i - 1], wakeup_counts[i]);
+
+  // Without leeway, each task due at a distinct time gets its own wakeup,
+  // unless the loop is busy long enough for both to be due at once.  Either
+  // way the task due first runs first.
+  num_tasks = 2;
+  std::vector<int> run_order;
+  int before = loop.delayed_wakeup_count();
+  loop.PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordRunOrderFunc, &run_order, 2, &num_tasks),
+      TimeDelta::FromMilliseconds(30));
+  loop.PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordRunOrderFunc, &run_order, 1, &num_tasks),
+      TimeDelta::FromMilliseconds(10));
+  loop.Run();
+  EXPECT_EQ(0, num_tasks);
+  EXPECT_LT(before, loop.delayed_wakeup_count());
+  EXPECT_GE(before + 2, loop.delayed_wakeup_count());
+  ASSERT_EQ(2U, run_order.size());
+  EXPECT_EQ(1, run_order[0]);
+  EXPECT_EQ(2, run_order[1]);
+}
+
 void RunTest_PostDelayedTask_SharedTimer(
     MessageLoop::Type message_loop_type) {
   MessageLoop loop(message_loop_type);
@@ -1628,6 +1695,12 @@ TEST(MessageLoopTest, PostDelayedTask_InPostOrder_3) {
   RunTest_PostDelayedTask_InPostOrder_3(MessageLoop::TYPE_IO);
 }
 
+TEST(MessageLoopTest, PostDelayedTaskWithLeeway) {
+  RunTest_PostDelayedTaskWithLeeway(MessageLoop::TYPE_DEFAULT);
+  RunTest_PostDelayedTaskWithLeeway(MessageLoop::TYPE_UI);
+  RunTest_PostDelayedTaskWithLeeway(MessageLoop::TYPE_IO);
+}
+
 TEST(MessageLoopTest, PostDelayedTask_SharedTimer) {
   RunTest_PostDelayedTask_SharedTimer(MessageLoop::TYPE_DEFAULT);
   RunTest_PostDelayedTask_SharedTimer(MessageLoop::TYPE_UI);
@@ -2061,3 +2134,60 @@ TEST(MessageLoopTest, IsType) {
   EXPECT_FALSE(loop.IsType(MessageLoop::TYPE_IO));
   EXPECT_FALSE(loop.IsType(MessageLoop::TYPE_DEFAULT));
 }
+
+namespace {
+
+void PostQuitAfterCount(int* count, int quit_at) {
+  if (++(*count) == quit_at)
+    MessageLoop::current()->Quit();
+}
+
+void PostCountingTasks(MessageLoop* target, int* count, int quit_at,
+                       int tasks) {
+  for (int i = 0; i < tasks; ++i) {
+    target->PostTask(FROM_HERE,
+                     base::Bind(&PostQuitAfterCount, count, quit_at));
+  }
+}
+
+}  // namespace
+
+TEST(MessageLoopTest, LockFreeIncomingQueue) {
+  MessageLoop loop(MessageLoop::TYPE_DEFAULT,
+                   MessageLoop::INCOMING_QUEUE_LOCK_FREE);
+  EXPECT_EQ(MessageLoop::INCOMING_QUEUE_LOCK_FREE, loop.incoming_queue_type());
+
+  scoped_refptr<Foo> foo(new Foo());
+  std::string a("a"), b("b");
+  loop.PostTask(FROM_HERE, base::Bind(&Foo::Test1ConstRef, foo.get(), a));
+  loop.PostTask(FROM_HERE, base::Bind(&Foo::Test1ConstRef, foo.get(), b));
+  loop.PostTask(FROM_HERE, base::Bind(&MessageLoop::Quit,
+                                      base::Unretained(&loop)));
+  loop.Run();
+
+  EXPECT_EQ(2, foo->test_count());
+  EXPECT_EQ("ab", foo->result());
+}
+
+TEST(MessageLoopTest, LockFreeIncomingQueueManyThreads) {
+  const int kThreads = 8;
+  const int kTasksPerThread = 500;
+
+  MessageLoop loop(MessageLoop::TYPE_DEFAULT,
+                   MessageLoop::INCOMING_QUEUE_LOCK_FREE);
+  int count = 0;
+  ScopedVector<Thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.push_back(new Thread("LockFreePoster"));
+    ASSERT_TRUE(threads[i]->Start());
+    threads[i]->message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&PostCountingTasks, &loop, &count,
+                   kThreads * kTasksPerThread, kTasksPerThread));
+  }
+  loop.Run();
+  EXPECT_EQ(kThreads * kTasksPerThread, count);
+
+  for (int i = 0; i < kThreads; ++i)
+    threads[i]->Stop();
+}
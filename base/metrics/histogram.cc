@@ -188,20 +188,26 @@ void Histogram::WriteAscii(string* output) const {
 
 // static
 string Histogram::SerializeHistogramInfo(const Histogram& histogram,
-                                         const HistogramSamples& snapshot) {
+                                         const HistogramSamples& snapshot,
+                                         bool include_metadata) {
   DCHECK_NE(NOT_VALID_IN_RENDERER, histogram.histogram_type());
   DCHECK(histogram.bucket_ranges()->HasValidChecksum());
 
   Pickle pickle;
   pickle.WriteString(histogram.histogram_name());
-  pickle.WriteInt(histogram.declared_min());
-  pickle.WriteInt(histogram.declared_max());
-  pickle.WriteUInt64(histogram.bucket_count());
-  pickle.WriteUInt32(histogram.bucket_ranges()->checksum());
-  pickle.WriteInt(histogram.histogram_type());
-  pickle.WriteInt(histogram.flags());
-
-  histogram.SerializeRanges(&pickle);
+  pickle.WriteBool(include_metadata);
+  if (include_metadata) {
+    pickle.WriteInt(histogram.declared_min());
+    pickle.WriteInt(histogram.declared_max());
+    pickle.WriteUInt64(histogram.bucket_count());
+    pickle.WriteUInt32(histogram.bucket_ranges()->checksum());
+    pickle.WriteInt(histogram.histogram_type());
+    pickle.WriteInt(histogram.flags());
+
+    histogram.SerializeRanges(&pickle);
+  } else {
+    pickle.WriteUInt32(histogram.bucket_ranges()->checksum());
+  }
 
   snapshot.Serialize(&pickle);
 
@@ -217,16 +223,39 @@ bool Histogram::DeserializeHistogramInfo(const string& histogram_info) {
   Pickle pickle(histogram_info.data(),
                 static_cast<int>(histogram_info.size()));
   string histogram_name;
+  bool include_metadata;
+  uint32 range_checksum;
+  PickleIterator iter(pickle);
+  if (!iter.ReadString(&histogram_name) ||
+      !iter.ReadBool(&include_metadata)) {
+    DLOG(ERROR) << "Pickle error decoding Histogram: " << histogram_name;
+    return false;
+  }
+
+  if (!include_metadata) {
+    // The sender included the metadata the first time it sent this
+    // histogram, so it has been created here already.
+    if (!iter.ReadUInt32(&range_checksum)) {
+      DLOG(ERROR) << "Pickle error decoding Histogram: " << histogram_name;
+      return false;
+    }
+    Histogram* render_histogram =
+        StatisticsRecorder::FindHistogram(histogram_name);
+    if (!render_histogram) {
+      DLOG(ERROR) << "Delta for unknown Histogram: " << histogram_name;
+      return false;
+    }
+    return AddSamplesFromPickleIfConsistent(render_histogram, range_checksum,
+                                            &iter);
+  }
+
   int declared_min;
   int declared_max;
   uint64 bucket_count;
-  uint32 range_checksum;
   int histogram_type;
   int pickle_flags;
 
-  PickleIterator iter(pickle);
-  if (!iter.ReadString(&histogram_name) ||
-      !iter.ReadInt(&declared_min) ||
+  if (!iter.ReadInt(&declared_min) ||
       !iter.ReadInt(&declared_max) ||
       !iter.ReadUInt64(&bucket_count) ||
       !iter.ReadUInt32(&range_checksum) ||
@@ -277,19 +306,27 @@ bool Histogram::DeserializeHistogramInfo(const string& histogram_info) {
   DCHECK_EQ(render_histogram->declared_max(), declared_max);
   DCHECK_EQ(render_histogram->bucket_count(), bucket_count);
   DCHECK_EQ(render_histogram->histogram_type(), histogram_type);
+  DCHECK_EQ(flags & render_histogram->flags(), flags);
+
+  return AddSamplesFromPickleIfConsistent(render_histogram, range_checksum,
+                                          &iter);
+}
 
+// static
+bool Histogram::AddSamplesFromPickleIfConsistent(Histogram* render_histogram,
+                                                 uint32 range_checksum,
+                                                 PickleIterator* iter) {
   if (render_histogram->bucket_ranges()->checksum() != range_checksum) {
     return false;
   }
 
   if (render_histogram->flags() & kIPCSerializationSourceFlag) {
     DVLOG(1) << "Single process mode, histogram observed and not copied: "
-             << histogram_name;
+             << render_histogram->histogram_name();
     return true;
   }
 
-  DCHECK_EQ(flags & render_histogram->flags(), flags);
-  return render_histogram->AddSamplesFromPickle(&iter);
+  return render_histogram->AddSamplesFromPickle(iter);
 }
 
 // static
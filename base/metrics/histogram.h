@@ -444,9 +444,12 @@ class BASE_EXPORT Histogram : public HistogramBase {
   // histograms created in the renderer).
 
   // Serialize the given snapshot of a Histogram into a String. Uses
-  // Pickle class to flatten the object.
+  // Pickle class to flatten the object. Without |include_metadata| only the
+  // name and the ranges checksum identify the histogram, so the receiver must
+  // already have it, e.g. from an earlier message that included the metadata.
   static std::string SerializeHistogramInfo(const Histogram& histogram,
-                                            const HistogramSamples& snapshot);
+                                            const HistogramSamples& snapshot,
+                                            bool include_metadata);
 
   // The following method accepts a list of pickled histograms and
   // builds a histogram and updates shadow copy of histogram data in the
@@ -535,6 +538,12 @@ class BASE_EXPORT Histogram : public HistogramBase {
   friend class StatisticsRecorder;  // To allow it to delete duplicates.
   friend class StatisticsRecorderTest;
 
+  // Merges the samples remaining in |iter| into |render_histogram| after
+  // checking that the sender's bucket layout matches |range_checksum|.
+  static bool AddSamplesFromPickleIfConsistent(Histogram* render_histogram,
+                                               uint32 range_checksum,
+                                               PickleIterator* iter);
+
   //----------------------------------------------------------------------------
   // Helpers for emitting Ascii graphic.  Each method appends data to output.
 
@@ -4,6 +4,7 @@
 
 #include "base/metrics/histogram_samples.h"
 
+#include "base/atomicops.h"
 #include "base/compiler_specific.h"
 #include "base/pickle.h"
 
@@ -109,11 +110,18 @@ bool HistogramSamples::Serialize(Pickle* pickle) const {
 }
 
 void HistogramSamples::IncreaseSum(int64 diff) {
+#if defined(ARCH_CPU_64_BITS)
+  subtle::NoBarrier_AtomicIncrement(
+      reinterpret_cast<subtle::Atomic64*>(&sum_), diff);
+#else
+  // There are no 64-bit atomics on 32-bit platforms; a lost update only
+  // skews the mean.
   sum_ += diff;
+#endif
 }
 
 void HistogramSamples::IncreaseRedundantCount(HistogramBase::Count diff) {
-  redundant_count_ += diff;
+  subtle::NoBarrier_AtomicIncrement(&redundant_count_, diff);
 }
 
 SampleCountIterator::~SampleCountIterator() {}
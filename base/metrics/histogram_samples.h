@@ -48,6 +48,8 @@ class BASE_EXPORT HistogramSamples {
   virtual bool AddSubtractImpl(SampleCountIterator* iter,
                                Instruction instruction) = 0;
 
+  // Both are safe to call from several threads at once, so subclasses can
+  // accumulate samples without a lock.
   void IncreaseSum(int64 diff);
   void IncreaseRedundantCount(HistogramBase::Count diff);
 
@@ -4,6 +4,7 @@
 
 #include "base/metrics/sample_vector.h"
 
+#include "base/atomicops.h"
 #include "base/logging.h"
 #include "base/metrics/bucket_ranges.h"
 
@@ -24,7 +25,7 @@ SampleVector::~SampleVector() {}
 
 void SampleVector::Accumulate(Sample value, Count count) {
   size_t bucket_index = GetBucketIndex(value);
-  counts_[bucket_index] += count;
+  subtle::NoBarrier_AtomicIncrement(&counts_[bucket_index], count);
   IncreaseSum(count * value);
   IncreaseRedundantCount(count);
 }
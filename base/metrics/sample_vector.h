@@ -26,6 +26,7 @@ class BASE_EXPORT_PRIVATE SampleVector : public HistogramSamples {
   virtual ~SampleVector();
 
   // HistogramSamples implementation:
+  // Accumulate() takes no lock and may be called on several threads at once.
   virtual void Accumulate(HistogramBase::Sample value,
                           HistogramBase::Count count) OVERRIDE;
   virtual HistogramBase::Count GetCount(
@@ -46,6 +47,8 @@ class BASE_EXPORT_PRIVATE SampleVector : public HistogramSamples {
  private:
   FRIEND_TEST_ALL_PREFIXES(HistogramTest, CorruptSampleCounts);
 
+  // Updated with atomic increments, so a HistogramBase::Count must be usable
+  // as a subtle::Atomic32.
   std::vector<HistogramBase::Count> counts_;
 
   // Shares the same BucketRanges with Histogram object.
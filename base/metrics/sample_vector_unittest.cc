@@ -8,6 +8,7 @@
 #include "base/metrics/bucket_ranges.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sample_vector.h"
+#include "base/threading/simple_thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using std::vector;
@@ -15,6 +16,25 @@ using std::vector;
 namespace base {
 namespace {
 
+// Accumulates |count| samples of every value in [0, |max_value|).
+class AccumulateRunner : public DelegateSimpleThread::Delegate {
+ public:
+  AccumulateRunner(SampleVector* samples, int max_value, int count)
+      : samples_(samples), max_value_(max_value), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < count_; ++i) {
+      for (int value = 0; value < max_value_; ++value)
+        samples_->Accumulate(value, 1);
+    }
+  }
+
+ private:
+  SampleVector* samples_;
+  int max_value_;
+  int count_;
+};
+
 TEST(SampleVectorTest, AccumulateTest) {
   // Custom buckets: [1, 5) [5, 10)
   BucketRanges ranges(3);
@@ -171,6 +191,28 @@ TEST(SampleVectorDeathTest, AddSubtractBucketNotMatchTest) {
 // (!defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)) && GTEST_HAS_DEATH_TEST
 #endif
 
+TEST(SampleVectorTest, ConcurrentAccumulate) {
+  // Custom buckets: [0, 1) [1, 2) [2, 3) [3, 4)
+  BucketRanges ranges(5);
+  for (int i = 0; i < 5; ++i)
+    ranges.set_range(i, i);
+  SampleVector samples(&ranges);
+
+  const int kNumThreads = 8;
+  const int kCount = 10000;
+  AccumulateRunner runner(&samples, 4, kCount);
+  DelegateSimpleThreadPool pool("accumulate", kNumThreads);
+  pool.AddWork(&runner, kNumThreads);
+  pool.Start();
+  pool.JoinAll();
+
+  // No increment may be lost.
+  for (size_t i = 0; i < 4; ++i)
+    EXPECT_EQ(kNumThreads * kCount, samples.GetCountAtIndex(i));
+  EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
+  EXPECT_EQ(kNumThreads * kCount * (0 + 1 + 2 + 3), samples.sum());
+}
+
 TEST(SampleVectorIteratorTest, IterateTest) {
   BucketRanges ranges(5);
   ranges.set_range(0, 0);
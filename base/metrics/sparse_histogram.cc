@@ -22,13 +22,17 @@ HistogramBase* SparseHistogram::FactoryGet(const string& name,
 SparseHistogram::~SparseHistogram() {}
 
 void SparseHistogram::Add(Sample value) {
-  base::AutoLock auto_lock(lock_);
-  samples_[value]++;
+  Stripe& stripe = GetStripe(value);
+  base::AutoLock auto_lock(stripe.lock);
+  stripe.samples[value]++;
 }
 
 void SparseHistogram::SnapshotSample(std::map<Sample, Count>* samples) const {
-  base::AutoLock auto_lock(lock_);
-  *samples = samples_;
+  samples->clear();
+  for (size_t i = 0; i < kNumStripes; ++i) {
+    base::AutoLock auto_lock(stripes_[i].lock);
+    samples->insert(stripes_[i].samples.begin(), stripes_[i].samples.end());
+  }
 }
 
 void SparseHistogram::WriteHTMLGraph(string* output) const {
@@ -42,4 +46,10 @@ void SparseHistogram::WriteAscii(string* output) const {
 SparseHistogram::SparseHistogram(const string& name)
     : HistogramBase(name) {}
 
+SparseHistogram::Stripe& SparseHistogram::GetStripe(Sample value) {
+  // Sparse samples are often small enums, so consecutive values should land
+  // in different stripes.
+  return stripes_[static_cast<unsigned int>(value) % kNumStripes];
+}
+
 }  // namespace base
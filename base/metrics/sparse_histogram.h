@@ -24,6 +24,8 @@ class BASE_EXPORT_PRIVATE SparseHistogram : public HistogramBase {
 
   virtual ~SparseHistogram();
 
+  // Only locks the stripe that |value| maps to, so concurrent Add() calls for
+  // different values rarely contend.
   virtual void Add(Sample value) OVERRIDE;
 
   virtual void SnapshotSample(std::map<Sample, Count>* sample) const;
@@ -37,10 +39,19 @@ class BASE_EXPORT_PRIVATE SparseHistogram : public HistogramBase {
  private:
   friend class SparseHistogramTest;  // For constuctor calling.
 
-  std::map<Sample, Count> samples_;
+  // Samples are spread over this many maps by value, each with its own lock.
+  static const size_t kNumStripes = 8;
 
-  // Protects access to above map.
-  mutable base::Lock lock_;
+  struct Stripe {
+    std::map<Sample, Count> samples;
+
+    // Protects access to above map.
+    mutable base::Lock lock;
+  };
+
+  Stripe& GetStripe(Sample value);
+
+  Stripe stripes_[kNumStripes];
 
   DISALLOW_COPY_AND_ASSIGN(SparseHistogram);
 };
@@ -37,4 +37,23 @@ TEST_F(SparseHistogramTest, BasicTest) {
   EXPECT_EQ(1, sample[101]);
 }
 
+TEST_F(SparseHistogramTest, SnapshotMergesAllValues) {
+  scoped_ptr<SparseHistogram> histogram(NewSparseHistogram("Sparse2"));
+  // Spans every stripe, including negative values.
+  for (int value = -50; value < 50; ++value) {
+    for (int i = 0; i <= value + 50; ++i)
+      histogram->Add(value);
+  }
+
+  std::map<HistogramBase::Sample, HistogramBase::Count> sample;
+  histogram->SnapshotSample(&sample);
+  ASSERT_EQ(100u, sample.size());
+  for (int value = -50; value < 50; ++value)
+    EXPECT_EQ(value + 51, sample[value]);
+
+  // Taking a second snapshot into the same map replaces the first.
+  histogram->SnapshotSample(&sample);
+  EXPECT_EQ(100u, sample.size());
+}
+
 }  // namespace base
@@ -4,7 +4,11 @@
 
 #include "base/metrics/statistics_recorder.h"
 
+#include <algorithm>
+
+#include "base/atomicops.h"
 #include "base/debug/leak_annotations.h"
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
@@ -18,12 +22,25 @@ namespace {
 // Initialize histogram statistics gathering system.
 base::LazyInstance<base::StatisticsRecorder>::Leaky g_statistics_recorder_ =
     LAZY_INSTANCE_INITIALIZER;
+
+bool HistogramNameLess(const base::Histogram* a, const base::Histogram* b) {
+  return a->histogram_name() < b->histogram_name();
+}
 }  // namespace
 
 namespace base {
 
-// Collect the number of histograms created.
-static uint32 number_of_histograms_ = 0;
+struct StatisticsRecorder::HistogramShard {
+  HistogramShard() : histograms(NULL) {}
+
+  base::Lock lock;
+  // NULL while no StatisticsRecorder is alive.
+  HistogramMap* histograms;
+};
+
+// Collect the number of histograms created. Incremented under the lock of
+// whichever shard the histogram went into.
+static subtle::Atomic32 number_of_histograms_ = 0;
 // Collect the number of vectors saved because of caching ranges.
 static uint32 number_of_vectors_saved_ = 0;
 // Collect the number of ranges_ elements saved because of caching ranges.
@@ -41,7 +58,7 @@ bool StatisticsRecorder::IsActive() {
   if (lock_ == NULL)
     return false;
   base::AutoLock auto_lock(*lock_);
-  return NULL != histograms_;
+  return NULL != ranges_;
 }
 
 // static
@@ -50,7 +67,7 @@ Histogram* StatisticsRecorder::RegisterOrDeleteDuplicate(Histogram* histogram) {
   // to annotate them. Because ANNOTATE_LEAKING_OBJECT_PTR may be used only once
   // for an object, the duplicates should not be annotated.
   // Callers are responsible for not calling RegisterOrDeleteDuplicate(ptr)
-  // twice if (lock_ == NULL) || (!histograms_).
+  // twice while the recorder is inactive.
   if (lock_ == NULL) {
     ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
     return histogram;
@@ -58,18 +75,20 @@ Histogram* StatisticsRecorder::RegisterOrDeleteDuplicate(Histogram* histogram) {
 
   Histogram* histogram_to_delete = NULL;
   Histogram* histogram_to_return = NULL;
+  const string& name = histogram->histogram_name();
+  HistogramShard* shard = GetShard(name);
   {
-    base::AutoLock auto_lock(*lock_);
-    if (histograms_ == NULL) {
+    base::AutoLock auto_lock(shard->lock);
+    HistogramMap* histograms = shard->histograms;
+    if (histograms == NULL) {
       ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
       histogram_to_return = histogram;
     } else {
-      const string& name = histogram->histogram_name();
-      HistogramMap::iterator it = histograms_->find(name);
-      if (histograms_->end() == it) {
-        (*histograms_)[name] = histogram;
+      HistogramMap::iterator it = histograms->find(name);
+      if (histograms->end() == it) {
+        (*histograms)[name] = histogram;
         ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
-        ++number_of_histograms_;
+        subtle::NoBarrier_AtomicIncrement(&number_of_histograms_, 1);
         histogram_to_return = histogram;
       } else if (histogram == it->second) {
         // The histogram was registered before.
@@ -142,14 +161,14 @@ void StatisticsRecorder::CollectHistogramStats(const std::string& suffix) {
   if (uma_upload_attempt == 1) {
     UMA_HISTOGRAM_COUNTS_10000(
         "Histogram.SharedRange.Count.FirstUpload." + suffix,
-        number_of_histograms_);
+        subtle::NoBarrier_Load(&number_of_histograms_));
     UMA_HISTOGRAM_COUNTS_10000(
         "Histogram.SharedRange.RangesSaved.FirstUpload." + suffix,
         number_of_vectors_saved_);
     UMA_HISTOGRAM_COUNTS(
         "Histogram.SharedRange.ElementsSaved.FirstUpload." + suffix,
         static_cast<int>(saved_ranges_size_));
-    number_of_histograms_ = 0;
+    subtle::NoBarrier_Store(&number_of_histograms_, 0);
     number_of_vectors_saved_ = 0;
     saved_ranges_size_ = 0;
     return;
@@ -157,21 +176,21 @@ void StatisticsRecorder::CollectHistogramStats(const std::string& suffix) {
   if (uma_upload_attempt == 2) {
     UMA_HISTOGRAM_COUNTS_10000(
         "Histogram.SharedRange.Count.SecondUpload." + suffix,
-        number_of_histograms_);
+        subtle::NoBarrier_Load(&number_of_histograms_));
     UMA_HISTOGRAM_COUNTS_10000(
         "Histogram.SharedRange.RangesSaved.SecondUpload." + suffix,
         number_of_vectors_saved_);
     UMA_HISTOGRAM_COUNTS(
         "Histogram.SharedRange.ElementsSaved.SecondUpload." + suffix,
         static_cast<int>(saved_ranges_size_));
-    number_of_histograms_ = 0;
+    subtle::NoBarrier_Store(&number_of_histograms_, 0);
     number_of_vectors_saved_ = 0;
     saved_ranges_size_ = 0;
     return;
   }
   UMA_HISTOGRAM_COUNTS_10000(
       "Histogram.SharedRange.Count.RestOfUploads." + suffix,
-      number_of_histograms_);
+      subtle::NoBarrier_Load(&number_of_histograms_));
   UMA_HISTOGRAM_COUNTS_10000(
       "Histogram.SharedRange.RangesSaved.RestOfUploads." + suffix,
       number_of_vectors_saved_);
@@ -218,18 +237,7 @@ void StatisticsRecorder::WriteGraph(const std::string& query,
 
 // static
 void StatisticsRecorder::GetHistograms(Histograms* output) {
-  if (lock_ == NULL)
-    return;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
-    return;
-
-  for (HistogramMap::iterator it = histograms_->begin();
-       histograms_->end() != it;
-       ++it) {
-    DCHECK_EQ(it->first, it->second->histogram_name());
-    output->push_back(it->second);
-  }
+  GetSnapshot(std::string(), output);
 }
 
 // static
@@ -258,12 +266,13 @@ void StatisticsRecorder::GetBucketRanges(
 Histogram* StatisticsRecorder::FindHistogram(const std::string& name) {
   if (lock_ == NULL)
     return NULL;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
+  HistogramShard* shard = GetShard(name);
+  base::AutoLock auto_lock(shard->lock);
+  if (shard->histograms == NULL)
     return NULL;
 
-  HistogramMap::iterator it = histograms_->find(name);
-  if (histograms_->end() == it)
+  HistogramMap::iterator it = shard->histograms->find(name);
+  if (shard->histograms->end() == it)
     return NULL;
   return it->second;
 }
@@ -273,23 +282,38 @@ void StatisticsRecorder::GetSnapshot(const std::string& query,
                                      Histograms* snapshot) {
   if (lock_ == NULL)
     return;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
-    return;
 
-  for (HistogramMap::iterator it = histograms_->begin();
-       histograms_->end() != it;
-       ++it) {
-    if (it->first.find(query) != std::string::npos)
-      snapshot->push_back(it->second);
+  size_t first_new = snapshot->size();
+  for (size_t i = 0; i < kNumHistogramShards; ++i) {
+    HistogramShard* shard = &histogram_shards_[i];
+    base::AutoLock auto_lock(shard->lock);
+    if (shard->histograms == NULL)
+      continue;
+
+    for (HistogramMap::iterator it = shard->histograms->begin();
+         shard->histograms->end() != it;
+         ++it) {
+      DCHECK_EQ(it->first, it->second->histogram_name());
+      if (it->first.find(query) != std::string::npos)
+        snapshot->push_back(it->second);
+    }
   }
+  // Each shard is sorted, but callers expect one sorted list.
+  std::sort(snapshot->begin() + first_new, snapshot->end(), HistogramNameLess);
+}
+
+// private static
+StatisticsRecorder::HistogramShard* StatisticsRecorder::GetShard(
+    const std::string& name) {
+  DCHECK(histogram_shards_);
+  return &histogram_shards_[Hash(name) % kNumHistogramShards];
 }
 
 // This singleton instance should be started during the single threaded portion
 // of main(), and hence it is not thread safe.  It initializes globals to
 // provide support for all future calls.
 StatisticsRecorder::StatisticsRecorder() {
-  DCHECK(!histograms_);
+  DCHECK(!ranges_);
   if (lock_ == NULL) {
     // This will leak on purpose. It's the only way to make sure we won't race
     // against the static uninitialization of the module while one of our
@@ -298,14 +322,18 @@ StatisticsRecorder::StatisticsRecorder() {
     // leak one per process, which would be similar to the instance allocated
     // during static initialization and released only on  process termination.
     lock_ = new base::Lock;
+    histogram_shards_ = new HistogramShard[kNumHistogramShards];
+  }
+  for (size_t i = 0; i < kNumHistogramShards; ++i) {
+    base::AutoLock auto_lock(histogram_shards_[i].lock);
+    histogram_shards_[i].histograms = new HistogramMap;
   }
   base::AutoLock auto_lock(*lock_);
-  histograms_ = new HistogramMap;
   ranges_ = new RangesMap;
 }
 
 StatisticsRecorder::~StatisticsRecorder() {
-  DCHECK(histograms_ && ranges_ && lock_);
+  DCHECK(histogram_shards_ && ranges_ && lock_);
   if (dump_on_exit_) {
     string output;
     WriteGraph("", &output);
@@ -313,15 +341,19 @@ StatisticsRecorder::~StatisticsRecorder() {
   }
 
   // Clean up.
-  scoped_ptr<HistogramMap> histograms_deleter;
+  // We don't delete lock_ or the shards on purpose to avoid having to properly
+  // protect against them going away after we checked for NULL in the static
+  // methods.
+  for (size_t i = 0; i < kNumHistogramShards; ++i) {
+    scoped_ptr<HistogramMap> histograms_deleter;
+    base::AutoLock auto_lock(histogram_shards_[i].lock);
+    histograms_deleter.reset(histogram_shards_[i].histograms);
+    histogram_shards_[i].histograms = NULL;
+  }
   scoped_ptr<RangesMap> ranges_deleter;
-  // We don't delete lock_ on purpose to avoid having to properly protect
-  // against it going away after we checked for NULL in the static methods.
   {
     base::AutoLock auto_lock(*lock_);
-    histograms_deleter.reset(histograms_);
     ranges_deleter.reset(ranges_);
-    histograms_ = NULL;
     ranges_ = NULL;
   }
   // We are going to leak the histograms and the ranges.
@@ -329,7 +361,8 @@ StatisticsRecorder::~StatisticsRecorder() {
 
 
 // static
-StatisticsRecorder::HistogramMap* StatisticsRecorder::histograms_ = NULL;
+StatisticsRecorder::HistogramShard* StatisticsRecorder::histogram_shards_ =
+    NULL;
 // static
 StatisticsRecorder::RangesMap* StatisticsRecorder::ranges_ = NULL;
 // static
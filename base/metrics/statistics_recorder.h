@@ -68,6 +68,7 @@ class BASE_EXPORT StatisticsRecorder {
 
   // Find a histogram by name. It matches the exact name. This method is thread
   // safe.  It returns NULL if a matching histogram is not found.
+  // Only the lock of the shard holding |name| is taken.
   static Histogram* FindHistogram(const std::string& name);
 
   static bool dump_on_exit() { return dump_on_exit_; }
@@ -77,7 +78,7 @@ class BASE_EXPORT StatisticsRecorder {
   // GetSnapshot copies some of the pointers to registered histograms into the
   // caller supplied vector (Histograms).  Only histograms with names matching
   // query are returned. The query must be a substring of histogram name for its
-  // pointer to be copied.
+  // pointer to be copied. The histograms are sorted by name.
   static void GetSnapshot(const std::string& query, Histograms* snapshot);
 
  private:
@@ -89,6 +90,14 @@ class BASE_EXPORT StatisticsRecorder {
   // |bucket_ranges_|.
   typedef std::map<uint32, std::list<const BucketRanges*>*> RangesMap;
 
+  // Histograms are spread over this many maps by a hash of their name. Each
+  // map has its own lock, so registering and looking up histograms on
+  // different threads rarely contends.
+  static const size_t kNumHistogramShards = 16;
+  struct HistogramShard;
+
+  static HistogramShard* GetShard(const std::string& name);
+
   friend struct DefaultLazyInstanceTraits<StatisticsRecorder>;
   friend class StatisticsRecorderTest;
 
@@ -98,10 +107,12 @@ class BASE_EXPORT StatisticsRecorder {
   StatisticsRecorder();
   ~StatisticsRecorder();
 
-  static HistogramMap* histograms_;
+  // An array of kNumHistogramShards shards. Like |lock_|, it is allocated
+  // by the first StatisticsRecorder and never freed.
+  static HistogramShard* histogram_shards_;
   static RangesMap* ranges_;
 
-  // Lock protects access to above maps.
+  // Lock protects access to |ranges_|.
   static base::Lock* lock_;
 
   // Dump all known histograms to log.
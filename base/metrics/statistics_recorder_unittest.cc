@@ -2,11 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
 #include <vector>
 
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
+#include "base/metrics/sample_vector.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/stringprintf.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
@@ -160,6 +163,23 @@ TEST_F(StatisticsRecorderTest, GetSnapshot) {
   EXPECT_EQ(0u, snapshot.size());
 }
 
+TEST_F(StatisticsRecorderTest, GetSnapshotIsSortedByName) {
+  // Enough histograms to cover every shard.
+  const int kNumHistograms = 100;
+  for (int i = kNumHistograms - 1; i >= 0; --i) {
+    Histogram::FactoryGet(StringPrintf("TestHistogram%03d", i),
+                          1, 1000, 10, Histogram::kNoFlags);
+  }
+
+  StatisticsRecorder::Histograms snapshot;
+  StatisticsRecorder::GetSnapshot("Test", &snapshot);
+  ASSERT_EQ(static_cast<size_t>(kNumHistograms), snapshot.size());
+  for (int i = 0; i < kNumHistograms; ++i) {
+    EXPECT_EQ(StringPrintf("TestHistogram%03d", i),
+              snapshot[i]->histogram_name());
+  }
+}
+
 TEST_F(StatisticsRecorderTest, RegisterHistogramWithFactoryGet) {
   StatisticsRecorder::Histograms registered_histograms;
 
@@ -253,4 +273,39 @@ TEST_F(StatisticsRecorderTest, BucketRangesSharing) {
   EXPECT_FALSE(bucket_ranges1->Equals(bucket_ranges3));
 }
 
+TEST_F(StatisticsRecorderTest, DeserializeWithoutMetadata) {
+  std::vector<int> custom_ranges;
+  for (int i = 1; i <= 100; ++i)
+    custom_ranges.push_back(i * 10);
+  Histogram* histogram(CustomHistogram::FactoryGet(
+      "TestCustomHistogram", custom_ranges,
+      Histogram::kIPCSerializationSourceFlag));
+  histogram->Add(15);
+  histogram->Add(500);
+  scoped_ptr<SampleVector> snapshot = histogram->SnapshotSamples();
+
+  std::string full_info =
+      Histogram::SerializeHistogramInfo(*histogram, *snapshot, true);
+  std::string delta_info =
+      Histogram::SerializeHistogramInfo(*histogram, *snapshot, false);
+  EXPECT_LT(delta_info.size(), full_info.size());
+
+  // The histogram is registered, so a delta without metadata is accepted.
+  EXPECT_TRUE(Histogram::DeserializeHistogramInfo(delta_info));
+
+  // A fresh recorder knows nothing about the histogram until it has seen the
+  // metadata once.
+  UninitializeStatisticsRecorder();
+  InitializeStatisticsRecorder();
+  EXPECT_FALSE(Histogram::DeserializeHistogramInfo(delta_info));
+  EXPECT_TRUE(Histogram::DeserializeHistogramInfo(full_info));
+  EXPECT_TRUE(Histogram::DeserializeHistogramInfo(delta_info));
+
+  Histogram* received =
+      StatisticsRecorder::FindHistogram("TestCustomHistogram");
+  ASSERT_TRUE(received != NULL);
+  scoped_ptr<SampleVector> received_samples = received->SnapshotSamples();
+  EXPECT_EQ(4, received_samples->TotalCount());
+}
+
 }  // namespace base
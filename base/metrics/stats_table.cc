@@ -4,6 +4,9 @@
 
 #include "base/metrics/stats_table.h"
 
+#include <algorithm>
+
+#include "base/atomicops.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/process_util.h"
@@ -22,9 +25,9 @@ namespace base {
 
 // The StatsTable uses a shared memory segment that is laid out as follows
 //
-// +-------------------------------------------+
-// | Version | Size | MaxCounters | MaxThreads |
-// +-------------------------------------------+
+// +----------------------------------------------------------+
+// | Version | Size | MaxCounters | MaxThreads | CounterCount  |
+// +----------------------------------------------------------+
 // | Thread names table                        |
 // +-------------------------------------------+
 // | Thread TID table                          |
@@ -36,12 +39,14 @@ namespace base {
 // | Data                                      |
 // +-------------------------------------------+
 //
-// The data layout is a grid, where the columns are the thread_ids and the
-// rows are the counter_ids.
+// The data layout is a grid, where the rows are the thread_ids and the
+// columns are the counter_ids.  The data starts on a cache line, and each
+// row is padded to a whole number of cache lines, so that threads updating
+// their counters never write to the same cache line.
 //
-// If the first character of the thread_name is '\0', then that column is
+// If the first character of the thread_name is '\0', then that row is
 // empty.
-// If the first character of the counter_name is '\0', then that row is
+// If the first character of the counter_name is '\0', then that column is
 // empty.
 //
 // About Locking:
@@ -53,9 +58,12 @@ namespace base {
 //
 // At the shared-memory level, we have a lock.  This lock protects the
 // shared-memory table only, and is used when we create new counters (e.g.
-// use rows) or when we register new threads (e.g. use columns).  Reading
+// use columns) or when we register new threads (e.g. use rows).  Reading
 // data from the table does not require any locking at the shared memory
-// level.
+// level.  Since counters are never removed, the columns are used in order,
+// and CounterCount is published after the name of each new counter is
+// written, so that a StatsTableReader in another process can read the names
+// and values of the first CounterCount counters without the lock.
 //
 // Each process which accesses the table will create a StatsTable object.
 // The StatsTable maintains a hash table of the existing counters in the
@@ -72,7 +80,11 @@ namespace {
 
 // An internal version in case we ever change the format of this
 // file, and so that we can identify our table.
-const int kTableVersion = 0x13131313;
+const int kTableVersion = 0x13131314;
+
+// The rows of the data grid are padded to this size.  It is the size of a
+// cache line on the x86 and ARM processors we run on.
+const int kCacheLineSize = 64;
 
 // The name for un-named counters and threads in the table.
 const char kUnknownName[] = "<unknown>";
@@ -82,8 +94,9 @@ inline int AlignOffset(int offset) {
   return (sizeof(int) - (offset % sizeof(int))) % sizeof(int);
 }
 
-inline int AlignedSize(int size) {
-  return size + AlignOffset(size);
+// Calculates delta to align an offset to a cache line.
+inline int CacheLineAlignOffset(int offset) {
+  return (kCacheLineSize - (offset % kCacheLineSize)) % kCacheLineSize;
 }
 
 }  // namespace
@@ -99,13 +112,24 @@ class StatsTable::Private {
     int size;
     int max_counters;
     int max_threads;
+    // The number of counter names in use.  Written with release semantics
+    // once the name of a new counter is in place.
+    subtle::Atomic32 counter_count;
   };
 
+  // Returns the size of a table that holds |max_threads| threads and
+  // |max_counters| counters.
+  static int TableSize(int max_threads, int max_counters);
+
   // Construct a new Private based on expected size parameters, or
   // return NULL on failure.
   static Private* New(const std::string& name, int size,
                                 int max_threads, int max_counters);
 
+  // Opens the existing table |name| for reading only, or returns NULL on
+  // failure.
+  static Private* OpenReadOnly(const std::string& name);
+
   SharedMemory* shared_memory() { return &shared_memory_; }
 
   // Accessors for our header pointers
@@ -114,6 +138,9 @@ class StatsTable::Private {
   int size() const { return table_header_->size; }
   int max_counters() const { return table_header_->max_counters; }
   int max_threads() const { return table_header_->max_threads; }
+  int counter_count() const {
+    return subtle::Acquire_Load(&table_header_->counter_count);
+  }
 
   // Accessors for our tables
   char* thread_name(int slot_id) const {
@@ -130,8 +157,15 @@ class StatsTable::Private {
     return &counter_names_table_[
       (counter_id-1) * (StatsTable::kMaxCounterNameLength)];
   }
-  int* row(int counter_id) const {
-    return &data_table_[(counter_id-1) * max_threads()];
+  int* location(int counter_id, int slot_id) const {
+    return &data_table_[(slot_id-1) * row_stride_ + (counter_id-1)];
+  }
+
+  // Publishes |counter_id| to readers once its name is written.  The caller
+  // must hold the shared memory lock.
+  void PublishCounter(int counter_id) {
+    if (counter_id > table_header_->counter_count)
+      subtle::Release_Store(&table_header_->counter_count, counter_id);
   }
 
  private:
@@ -142,7 +176,8 @@ class StatsTable::Private {
         thread_tid_table_(NULL),
         thread_pid_table_(NULL),
         counter_names_table_(NULL),
-        data_table_(NULL) {
+        data_table_(NULL),
+        row_stride_(0) {
   }
 
   // Initializes the table on first access.  Sets header values
@@ -160,8 +195,29 @@ class StatsTable::Private {
   int* thread_pid_table_;
   char* counter_names_table_;
   int* data_table_;
+
+  // The number of ints in a row of the data grid, padding included.
+  int row_stride_;
 };
 
+// static
+int StatsTable::Private::TableSize(int max_threads, int max_counters) {
+  // This follows the layout computed by ComputeMappedPointers().
+  int offset = sizeof(TableHeader);
+  offset += AlignOffset(offset);
+  offset += max_threads * StatsTable::kMaxThreadNameLength;
+  offset += AlignOffset(offset);
+  offset += sizeof(int) * max_threads;
+  offset += AlignOffset(offset);
+  offset += sizeof(int) * max_threads;
+  offset += AlignOffset(offset);
+  offset += max_counters * StatsTable::kMaxCounterNameLength;
+  offset += CacheLineAlignOffset(offset);
+  int row_size = sizeof(int) * max_counters;
+  row_size += CacheLineAlignOffset(row_size);
+  return offset + row_size * max_threads;
+}
+
 // static
 StatsTable::Private* StatsTable::Private::New(const std::string& name,
                                               int size,
@@ -187,6 +243,31 @@ StatsTable::Private* StatsTable::Private::New(const std::string& name,
   return priv.release();
 }
 
+// static
+StatsTable::Private* StatsTable::Private::OpenReadOnly(
+    const std::string& name) {
+  scoped_ptr<Private> priv(new Private());
+  if (!priv->shared_memory_.Open(name, true))
+    return NULL;
+
+  // Map the header first, to learn the size of the table.
+  if (!priv->shared_memory_.Map(sizeof(TableHeader)))
+    return NULL;
+  const TableHeader* header =
+      static_cast<const TableHeader*>(priv->shared_memory_.memory());
+  if (header->version != kTableVersion ||
+      header->size != TableSize(header->max_threads, header->max_counters)) {
+    return NULL;
+  }
+  int size = header->size;
+  priv->shared_memory_.Unmap();
+  if (!priv->shared_memory_.Map(size))
+    return NULL;
+
+  priv->ComputeMappedPointers(priv->shared_memory_.memory());
+  return priv.release();
+}
+
 void StatsTable::Private::InitializeTable(void* memory, int size,
                                           int max_counters,
                                           int max_threads) {
@@ -228,10 +309,15 @@ void StatsTable::Private::ComputeMappedPointers(void* memory) {
   counter_names_table_ = reinterpret_cast<char*>(data + offset);
   offset += sizeof(char) *
             max_counters() * StatsTable::kMaxCounterNameLength;
-  offset += AlignOffset(offset);
+  offset += CacheLineAlignOffset(offset);
 
+  // Shared memory is mapped at a page boundary, so the data table starts on
+  // a cache line.
   data_table_ = reinterpret_cast<int*>(data + offset);
-  offset += sizeof(int) * max_threads() * max_counters();
+  int row_size = sizeof(int) * max_counters();
+  row_size += CacheLineAlignOffset(row_size);
+  row_stride_ = row_size / sizeof(int);
+  offset += row_size * max_threads();
 
   DCHECK_EQ(offset, size());
 }
@@ -254,13 +340,7 @@ StatsTable::StatsTable(const std::string& name, int max_threads,
                        int max_counters)
     : impl_(NULL),
       tls_index_(SlotReturnFunction) {
-  int table_size =
-    AlignedSize(sizeof(Private::TableHeader)) +
-    AlignedSize((max_counters * sizeof(char) * kMaxCounterNameLength)) +
-    AlignedSize((max_threads * sizeof(char) * kMaxThreadNameLength)) +
-    AlignedSize(max_threads * sizeof(int)) +
-    AlignedSize(max_threads * sizeof(int)) +
-    AlignedSize((sizeof(int) * (max_counters * max_threads)));
+  int table_size = Private::TableSize(max_threads, max_counters);
 
   impl_ = Private::New(name, table_size, max_threads, max_counters);
 
@@ -368,8 +448,7 @@ int* StatsTable::GetLocation(int counter_id, int slot_id) const {
   if (slot_id > impl_->max_threads())
     return NULL;
 
-  int* row = impl_->row(counter_id);
-  return &(row[slot_id-1]);
+  return impl_->location(counter_id, slot_id);
 }
 
 const char* StatsTable::GetRowName(int index) const {
@@ -388,10 +467,9 @@ int StatsTable::GetRowValue(int index, int pid) const {
     return 0;
 
   int rv = 0;
-  int* row = impl_->row(index);
-  for (int slot_id = 0; slot_id < impl_->max_threads(); slot_id++) {
+  for (int slot_id = 1; slot_id <= impl_->max_threads(); slot_id++) {
     if (pid == 0 || *impl_->thread_pid(slot_id) == pid)
-      rv += row[slot_id];
+      rv += *impl_->location(index, slot_id);
   }
   return rv;
 }
@@ -536,6 +614,7 @@ int StatsTable::AddCounter(const std::string& name) {
       counter_name = kUnknownName;
     strlcpy(impl_->counter_name(counter_id), counter_name.c_str(),
             kMaxCounterNameLength);
+    impl_->PublishCounter(counter_id);
   }
 
   // now add to our in-memory cache
@@ -557,4 +636,43 @@ StatsTable::TLSData* StatsTable::GetTLSData() const {
   return data;
 }
 
+StatsTableReader::StatsTableReader() : impl_(NULL) {
+}
+
+StatsTableReader::~StatsTableReader() {
+  delete impl_;
+}
+
+bool StatsTableReader::Open(const std::string& name) {
+  delete impl_;
+  impl_ = StatsTable::Private::OpenReadOnly(name);
+  return impl_ != NULL;
+}
+
+int StatsTableReader::GetCounterCount() const {
+  if (!impl_)
+    return 0;
+  return std::min(impl_->counter_count(), impl_->max_counters());
+}
+
+const char* StatsTableReader::GetCounterName(int counter_id) const {
+  if (counter_id < 1 || counter_id > GetCounterCount())
+    return NULL;
+  return impl_->counter_name(counter_id);
+}
+
+int StatsTableReader::GetCounterValue(int counter_id) const {
+  if (counter_id < 1 || counter_id > GetCounterCount())
+    return 0;
+
+  // Each value is written by its thread alone and read here without
+  // synchronization: it may be stale, but it is never torn.
+  int rv = 0;
+  for (int slot_id = 1; slot_id <= impl_->max_threads(); slot_id++) {
+    rv += subtle::NoBarrier_Load(reinterpret_cast<subtle::Atomic32*>(
+        impl_->location(counter_id, slot_id)));
+  }
+  return rv;
+}
+
 }  // namespace base
@@ -14,7 +14,11 @@
 // To achieve this, StatsTable creates a shared memory segment to store
 // the data for the counters.  Upon creation, it has a specific size
 // which governs the maximum number of counters and concurrent
-// threads/processes which can use it.
+// threads/processes which can use it.  Each thread writes its counters in
+// a row of its own, padded to whole cache lines.
+//
+// Other processes, such as a monitoring tool, read the table with a
+// StatsTableReader.
 //
 
 #ifndef BASE_METRICS_STATS_TABLE_H_
@@ -130,6 +134,8 @@ class BASE_EXPORT StatsTable {
   static int* FindLocation(const char *name);
 
  private:
+  friend class StatsTableReader;
+
   class Private;
   struct TLSData;
   typedef hash_map<std::string, int> CountersMap;
@@ -190,6 +196,36 @@ class BASE_EXPORT StatsTable {
   DISALLOW_COPY_AND_ASSIGN(StatsTable);
 };
 
+// Reads the counters of a StatsTable that another process created.  A reader
+// maps the table read-only and never takes its lock, so sampling it does not
+// disturb the processes that update the counters.
+class BASE_EXPORT StatsTableReader {
+ public:
+  StatsTableReader();
+  ~StatsTableReader();
+
+  // Opens the existing table |name|.  Returns false if there is no such
+  // table, or if it was created by an incompatible version.
+  bool Open(const std::string& name);
+
+  // Returns the number of counters in the table.  Their ids are 1 to the
+  // number returned; counters are never removed.
+  int GetCounterCount() const;
+
+  // Returns the name of the counter |counter_id|, or NULL if there is no
+  // such counter.
+  const char* GetCounterName(int counter_id) const;
+
+  // Returns the sum of the values of the counter |counter_id| over all
+  // threads.
+  int GetCounterValue(int counter_id) const;
+
+ private:
+  StatsTable::Private* impl_;
+
+  DISALLOW_COPY_AND_ASSIGN(StatsTableReader);
+};
+
 }  // namespace base
 
 #endif  // BASE_METRICS_STATS_TABLE_H_
@@ -58,6 +58,70 @@ TEST_F(StatsTableTest, VerifySlots) {
   DeleteShmem(kTableName);
 }
 
+// Verify that the counters of different threads are on different cache
+// lines.
+TEST_F(StatsTableTest, ThreadRowsArePadded) {
+  const std::string kTableName = "ThreadRowsArePaddedStatTable";
+  const int kMaxThreads = 3;
+  const int kMaxCounter = 5;
+  const int kCacheLineSize = 64;
+  DeleteShmem(kTableName);
+  StatsTable table(kTableName, kMaxThreads, kMaxCounter);
+
+  int counter_id = table.FindCounter("counter");
+  ASSERT_GT(counter_id, 0);
+  for (int slot_id = 1; slot_id <= kMaxThreads; slot_id++) {
+    char* location =
+        reinterpret_cast<char*>(table.GetLocation(1, slot_id));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(location) % kCacheLineSize);
+    // The counters of a thread are together.
+    EXPECT_EQ(location + (kMaxCounter - 1) * sizeof(int),
+              reinterpret_cast<char*>(table.GetLocation(kMaxCounter,
+                                                        slot_id)));
+  }
+
+  DeleteShmem(kTableName);
+}
+
+// Verify that a StatsTableReader sees the counters of a table, as they are
+// added and updated.
+TEST_F(StatsTableTest, Reader) {
+  const std::string kTableName = "ReaderStatTable";
+  const int kMaxThreads = 2;
+  const int kMaxCounter = 3;
+  DeleteShmem(kTableName);
+
+  StatsTableReader reader;
+  EXPECT_FALSE(reader.Open(kTableName));
+  EXPECT_EQ(0, reader.GetCounterCount());
+
+  StatsTable table(kTableName, kMaxThreads, kMaxCounter);
+  ASSERT_TRUE(reader.Open(kTableName));
+  EXPECT_EQ(0, reader.GetCounterCount());
+  EXPECT_EQ(NULL, reader.GetCounterName(1));
+
+  int slot_id = table.RegisterThread("mainThread");
+  ASSERT_NE(0, slot_id);
+  int counter_id = table.FindCounter("first");
+  ASSERT_EQ(1, counter_id);
+  *table.GetLocation(counter_id, slot_id) = 7;
+  ASSERT_EQ(1, reader.GetCounterCount());
+  EXPECT_STREQ("first", reader.GetCounterName(1));
+  EXPECT_EQ(7, reader.GetCounterValue(1));
+
+  // The values of all threads are summed.
+  *table.GetLocation(counter_id, kMaxThreads) = 5;
+  EXPECT_EQ(12, reader.GetCounterValue(1));
+
+  EXPECT_EQ(2, table.FindCounter("second"));
+  ASSERT_EQ(2, reader.GetCounterCount());
+  EXPECT_STREQ("second", reader.GetCounterName(2));
+  EXPECT_EQ(0, reader.GetCounterValue(2));
+  EXPECT_EQ(NULL, reader.GetCounterName(3));
+
+  DeleteShmem(kTableName);
+}
+
 // CounterZero will continually be set to 0.
 const std::string kCounterZero = "CounterZero";
 // Counter1313 will continually be set to 1313.
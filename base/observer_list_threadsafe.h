@@ -6,10 +6,12 @@
 #define BASE_OBSERVER_LIST_THREADSAFE_H_
 
 #include <algorithm>
+#include <deque>
 #include <map>
 
 #include "base/basictypes.h"
 #include "base/bind.h"
+#include "base/compiler_specific.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
@@ -43,11 +45,20 @@
 //   whereas with the non-thread-safe observer_list, notifications happen
 //   synchronously and immediately.
 //
+//   A list created with DISPATCH_COALESCED collapses a notification into
+//   the previous one when that one is still waiting to be delivered to a
+//   thread and calls the same method; the observers on that thread then see
+//   a single call with the latest arguments.  Use it for "something changed"
+//   notifications that may fire in bursts, where only the last state
+//   matters.  Notifications of different methods are never reordered.
+//
 //   IMPLEMENTATION NOTES
 //   The ObserverListThreadSafe maintains an ObserverList for each thread
 //   which uses the ThreadSafeObserver.  When Notifying the observers,
 //   we simply call PostTask to each registered thread, and then each thread
-//   will notify its regular ObserverList.
+//   will notify its regular ObserverList.  The arguments of a notification
+//   are stored once, in a refcounted bundle that the tasks of all threads
+//   share.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -68,6 +79,7 @@ class UnboundMethod {
   void Run(T* obj) const {
     DispatchToMethod(obj, m_, p_);
   }
+  Method method() const { return m_; }
  private:
   Method m_;
   Params p_;
@@ -98,9 +110,24 @@ class ObserverListThreadSafe
   typedef typename ObserverList<ObserverType>::NotificationType
       NotificationType;
 
+  enum DispatchPolicy {
+    // Every notification is delivered.
+    DISPATCH_ALL,
+    // Back-to-back notifications of the same method that are waiting to be
+    // delivered to a thread are collapsed into one with the latest
+    // arguments.
+    DISPATCH_COALESCED
+  };
+
   ObserverListThreadSafe()
-      : type_(ObserverListBase<ObserverType>::NOTIFY_ALL) {}
-  explicit ObserverListThreadSafe(NotificationType type) : type_(type) {}
+      : type_(ObserverListBase<ObserverType>::NOTIFY_ALL),
+        dispatch_(DISPATCH_ALL) {}
+  explicit ObserverListThreadSafe(NotificationType type)
+      : type_(type),
+        dispatch_(DISPATCH_ALL) {}
+  ObserverListThreadSafe(NotificationType type, DispatchPolicy dispatch)
+      : type_(type),
+        dispatch_(dispatch) {}
 
   // Add an observer to the list.  An observer should not be added to
   // the same list more than once.
@@ -205,6 +232,51 @@ class ObserverListThreadSafe
   // See comment above ObserverListThreadSafeTraits' definition.
   friend struct ObserverListThreadSafeTraits<ObserverType>;
 
+  // A notification with its arguments, shared by the tasks that deliver it
+  // to each thread.
+  class Notification : public base::RefCountedThreadSafe<Notification> {
+   public:
+    virtual void Run(ObserverType* obs) const = 0;
+    virtual bool HasSameMethodAs(const Notification& other) const = 0;
+
+    // Identifies the concrete type of the notification.
+    virtual const void* type_tag() const = 0;
+
+   protected:
+    friend class base::RefCountedThreadSafe<Notification>;
+    virtual ~Notification() {}
+  };
+
+  template <class Method, class Params>
+  class NotificationImpl : public Notification {
+   public:
+    explicit NotificationImpl(
+        const UnboundMethod<ObserverType, Method, Params>& method)
+        : method_(method) {
+    }
+
+    virtual void Run(ObserverType* obs) const OVERRIDE {
+      method_.Run(obs);
+    }
+
+    virtual bool HasSameMethodAs(const Notification& other) const OVERRIDE {
+      // The type tags tell apart instantiations for different Method and
+      // Params types, after which the method pointers can be compared.
+      return other.type_tag() == type_tag() &&
+          static_cast<const NotificationImpl&>(other).method_.method() ==
+              method_.method();
+    }
+
+    virtual const void* type_tag() const OVERRIDE { return &type_tag_; }
+
+   private:
+    virtual ~NotificationImpl() {}
+
+    static char type_tag_;
+
+    UnboundMethod<ObserverType, Method, Params> method_;
+  };
+
   struct ObserverListContext {
     explicit ObserverListContext(NotificationType type)
         : loop(base::MessageLoopProxy::current()),
@@ -214,6 +286,10 @@ class ObserverListThreadSafe
     scoped_refptr<base::MessageLoopProxy> loop;
     ObserverList<ObserverType> list;
 
+    // For DISPATCH_COALESCED lists, the notifications posted to |loop| that
+    // have not run yet, oldest first.  Protected by |list_lock_|.
+    std::deque<scoped_refptr<Notification> > pending;
+
     DISALLOW_COPY_AND_ASSIGN(ObserverListContext);
   };
 
@@ -226,35 +302,69 @@ class ObserverListThreadSafe
 
   template <class Method, class Params>
   void Notify(const UnboundMethod<ObserverType, Method, Params>& method) {
+    scoped_refptr<Notification> notification(
+        new NotificationImpl<Method, Params>(method));
     base::AutoLock lock(list_lock_);
     typename ObserversListMap::iterator it;
     for (it = observer_lists_.begin(); it != observer_lists_.end(); ++it) {
       ObserverListContext* context = (*it).second;
+      if (dispatch_ == DISPATCH_COALESCED) {
+        if (!context->pending.empty() &&
+            context->pending.back()->HasSameMethodAs(*notification)) {
+          context->pending.back() = notification;
+          continue;
+        }
+        context->pending.push_back(notification);
+        context->loop->PostTask(
+            FROM_HERE,
+            base::Bind(&ObserverListThreadSafe<ObserverType>::NotifyPending,
+                       this, context));
+        continue;
+      }
       context->loop->PostTask(
           FROM_HERE,
-          base::Bind(&ObserverListThreadSafe<ObserverType>::
-              template NotifyWrapper<Method, Params>, this, context, method));
+          base::Bind(&ObserverListThreadSafe<ObserverType>::NotifyWrapper,
+                     this, context, notification));
+    }
+  }
+
+  // Delivers the oldest notification pending for |context|, for
+  // DISPATCH_COALESCED lists.  This function MUST be called on the thread
+  // which owns the unsafe ObserverList.
+  void NotifyPending(ObserverListContext* context) {
+    scoped_refptr<Notification> notification;
+    {
+      base::AutoLock lock(list_lock_);
+      if (!IsCurrentContext(context))
+        return;
+      DCHECK(!context->pending.empty());
+      notification = context->pending.front();
+      context->pending.pop_front();
     }
+    NotifyWrapper(context, notification);
+  }
+
+  // Returns true if |context| is the one registered for the current thread.
+  // The ObserverList could have been removed already.  In fact, it could
+  // have been removed and then re-added!  If the master list's loop does not
+  // match this one, then we do not need to finish a notification.
+  // |list_lock_| must be held.
+  bool IsCurrentContext(ObserverListContext* context) const {
+    list_lock_.AssertAcquired();
+    typename ObserversListMap::const_iterator it =
+        observer_lists_.find(base::PlatformThread::CurrentId());
+    return it != observer_lists_.end() && it->second == context;
   }
 
   // Wrapper which is called to fire the notifications for each thread's
   // ObserverList.  This function MUST be called on the thread which owns
   // the unsafe ObserverList.
-  template <class Method, class Params>
   void NotifyWrapper(ObserverListContext* context,
-      const UnboundMethod<ObserverType, Method, Params>& method) {
-
+                     const scoped_refptr<Notification>& notification) {
     // Check that this list still needs notifications.
     {
       base::AutoLock lock(list_lock_);
-      typename ObserversListMap::iterator it =
-          observer_lists_.find(base::PlatformThread::CurrentId());
-
-      // The ObserverList could have been removed already.  In fact, it could
-      // have been removed and then re-added!  If the master list's loop
-      // does not match this one, then we do not need to finish this
-      // notification.
-      if (it == observer_lists_.end() || it->second != context)
+      if (!IsCurrentContext(context))
         return;
     }
 
@@ -262,7 +372,7 @@ class ObserverListThreadSafe
       typename ObserverList<ObserverType>::Iterator it(context->list);
       ObserverType* obs;
       while ((obs = it.GetNext()) != NULL)
-        method.Run(obs);
+        notification->Run(obs);
     }
 
     // If there are no more observers on the list, we can now delete it.
@@ -290,8 +400,14 @@ class ObserverListThreadSafe
   mutable base::Lock list_lock_;  // Protects the observer_lists_.
   ObserversListMap observer_lists_;
   const NotificationType type_;
+  const DispatchPolicy dispatch_;
 
   DISALLOW_COPY_AND_ASSIGN(ObserverListThreadSafe);
 };
 
+template <class ObserverType>
+template <class Method, class Params>
+char ObserverListThreadSafe<ObserverType>::
+    NotificationImpl<Method, Params>::type_tag_ = 0;
+
 #endif  // BASE_OBSERVER_LIST_THREADSAFE_H_
@@ -238,6 +238,72 @@ TEST(ObserverListThreadSafeTest, BasicTest) {
   EXPECT_EQ(-10, d.total);
 }
 
+// Records the notifications it gets, telling apart the two methods by sign.
+class OrderRecorder {
+ public:
+  void First(int x) { log.push_back(x); }
+  void Second(int x) { log.push_back(-x); }
+
+  std::vector<int> log;
+};
+
+TEST(ObserverListThreadSafeTest, CoalescedNotifications) {
+  MessageLoop loop;
+
+  scoped_refptr<ObserverListThreadSafe<Foo> > all_list(
+      new ObserverListThreadSafe<Foo>);
+  scoped_refptr<ObserverListThreadSafe<Foo> > coalesced_list(
+      new ObserverListThreadSafe<Foo>(
+          ObserverListBase<Foo>::NOTIFY_ALL,
+          ObserverListThreadSafe<Foo>::DISPATCH_COALESCED));
+  Adder a(1);
+  Adder b(1);
+  all_list->AddObserver(&a);
+  coalesced_list->AddObserver(&b);
+
+  for (int i = 1; i <= 3; ++i) {
+    all_list->Notify(&Foo::Observe, i);
+    coalesced_list->Notify(&Foo::Observe, i);
+  }
+  loop.RunAllPending();
+  EXPECT_EQ(6, a.total);
+  // Only the latest of the pending notifications is delivered.
+  EXPECT_EQ(3, b.total);
+
+  // Notifications are collapsed only while they are pending.
+  coalesced_list->Notify(&Foo::Observe, 10);
+  loop.RunAllPending();
+  EXPECT_EQ(13, b.total);
+
+  coalesced_list->RemoveObserver(&b);
+  all_list->RemoveObserver(&a);
+}
+
+TEST(ObserverListThreadSafeTest, CoalescedNotificationsKeepOrder) {
+  MessageLoop loop;
+
+  scoped_refptr<ObserverListThreadSafe<OrderRecorder> > observer_list(
+      new ObserverListThreadSafe<OrderRecorder>(
+          ObserverListBase<OrderRecorder>::NOTIFY_ALL,
+          ObserverListThreadSafe<OrderRecorder>::DISPATCH_COALESCED));
+  OrderRecorder recorder;
+  observer_list->AddObserver(&recorder);
+
+  observer_list->Notify(&OrderRecorder::First, 1);
+  observer_list->Notify(&OrderRecorder::First, 2);
+  observer_list->Notify(&OrderRecorder::Second, 3);
+  observer_list->Notify(&OrderRecorder::First, 4);
+  observer_list->Notify(&OrderRecorder::First, 5);
+  loop.RunAllPending();
+
+  ASSERT_EQ(3u, recorder.log.size());
+  EXPECT_EQ(2, recorder.log[0]);
+  EXPECT_EQ(-3, recorder.log[1]);
+  EXPECT_EQ(5, recorder.log[2]);
+
+  observer_list->RemoveObserver(&recorder);
+}
+
 TEST(ObserverListThreadSafeTest, RemoveObserver) {
   MessageLoop loop;
 
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 
 #include <algorithm>  // for max()
+#include <limits>
 
 //------------------------------------------------------------------------------
 
@@ -126,6 +127,30 @@ bool PickleIterator::ReadString16(string16* result) {
   return true;
 }
 
+bool PickleIterator::ReadStringPiece(base::StringPiece* result) {
+  int len;
+  if (!ReadInt(&len))
+    return false;
+  const char* read_from = GetReadPointerAndAdvance(len);
+  if (!read_from)
+    return false;
+
+  result->set(read_from, len);
+  return true;
+}
+
+bool PickleIterator::ReadStringPiece16(base::StringPiece16* result) {
+  int len;
+  if (!ReadInt(&len))
+    return false;
+  const char* read_from = GetReadPointerAndAdvance(len, sizeof(char16));
+  if (!read_from)
+    return false;
+
+  result->set(reinterpret_cast<const char16*>(read_from), len);
+  return true;
+}
+
 bool PickleIterator::ReadData(const char** data, int* length) {
   *length = 0;
   *data = 0;
@@ -223,31 +248,48 @@ Pickle& Pickle::operator=(const Pickle& other) {
   return *this;
 }
 
-bool Pickle::WriteString(const std::string& value) {
-  if (!WriteInt(static_cast<int>(value.size())))
-    return false;
-
-  return WriteBytes(value.data(), static_cast<int>(value.size()));
+bool Pickle::WriteString(const base::StringPiece& value) {
+  return WriteLengthAndBytes(static_cast<int>(value.size()), value.data(),
+                             static_cast<int>(value.size()));
 }
 
 bool Pickle::WriteWString(const std::wstring& value) {
-  if (!WriteInt(static_cast<int>(value.size())))
-    return false;
+  return WriteLengthAndBytes(
+      static_cast<int>(value.size()), value.data(),
+      static_cast<int>(value.size() * sizeof(wchar_t)));
+}
 
-  return WriteBytes(value.data(),
-                    static_cast<int>(value.size() * sizeof(wchar_t)));
+bool Pickle::WriteString16(const base::StringPiece16& value) {
+  return WriteLengthAndBytes(
+      static_cast<int>(value.size()), value.data(),
+      static_cast<int>(value.size()) * sizeof(char16));
 }
 
-bool Pickle::WriteString16(const string16& value) {
-  if (!WriteInt(static_cast<int>(value.size())))
+bool Pickle::WriteData(const char* data, int length) {
+  return length >= 0 && WriteLengthAndBytes(length, data, length);
+}
+
+bool Pickle::WriteData(const std::vector<base::StringPiece>& pieces) {
+  size_t total = 0;
+  for (size_t i = 0; i < pieces.size(); ++i)
+    total += pieces[i].size();
+  int length = static_cast<int>(total);
+  if (length < 0 || static_cast<size_t>(length) != total)
     return false;
 
-  return WriteBytes(value.data(),
-                    static_cast<int>(value.size()) * sizeof(char16));
-}
+  char* dest = BeginWrite(sizeof(length) + length);
+  if (!dest)
+    return false;
 
-bool Pickle::WriteData(const char* data, int length) {
-  return length >= 0 && WriteInt(length) && WriteBytes(data, length);
+  memcpy(dest, &length, sizeof(length));
+  char* piece_dest = dest + sizeof(length);
+  for (size_t i = 0; i < pieces.size(); ++i) {
+    memcpy(piece_dest, pieces[i].data(), pieces[i].size());
+    piece_dest += pieces[i].size();
+  }
+
+  EndWrite(piece_dest - length, length);
+  return true;
 }
 
 bool Pickle::WriteBytes(const void* data, int data_len) {
@@ -300,6 +342,29 @@ void Pickle::TrimWriteData(int new_length) {
   *cur_length = new_length;
 }
 
+bool Pickle::Reserve(size_t length) {
+  size_t needed_size = header_size_ +
+      AlignInt(header_->payload_size, sizeof(uint32)) + length;
+  return needed_size <= capacity_ || Resize(needed_size);
+}
+
+bool Pickle::WriteLengthAndBytes(int length, const void* data, int data_len) {
+  DCHECK_NE(kCapacityReadOnly, capacity_) << "oops: pickle is readonly";
+  if (data_len < 0)
+    return false;
+
+  char* dest = BeginWrite(sizeof(length) + data_len);
+  if (!dest)
+    return false;
+
+  memcpy(dest, &length, sizeof(length));
+  memcpy(dest + sizeof(length), data, data_len);
+
+  // |length| keeps the data uint32-aligned, so only the data needs padding.
+  EndWrite(dest + sizeof(length), data_len);
+  return true;
+}
+
 char* Pickle::BeginWrite(size_t length) {
   // write at a uint32-aligned offset from the beginning of the header
   size_t offset = AlignInt(header_->payload_size, sizeof(uint32));
@@ -355,3 +420,26 @@ const char* Pickle::FindNext(size_t header_size,
 
   return (payload_end > end) ? NULL : payload_end;
 }
+
+// static
+size_t Pickle::PeekSize(size_t header_size,
+                        const char* start,
+                        const char* end) {
+  DCHECK_EQ(header_size, AlignInt(header_size, sizeof(uint32)));
+  DCHECK_LE(header_size, static_cast<size_t>(kPayloadUnit));
+
+  if (static_cast<size_t>(end - start) < sizeof(Header))
+    return 0;
+
+  const Header* hdr = reinterpret_cast<const Header*>(start);
+  if (hdr->payload_size > std::numeric_limits<size_t>::max() - header_size)
+    return 0;
+  return header_size + hdr->payload_size;
+}
+
+void PickleSizer::AddBytes(size_t length) {
+  // Every write starts at a uint32-aligned offset, as in Pickle::BeginWrite.
+  payload_size_ += (sizeof(uint32) - payload_size_ % sizeof(uint32)) %
+      sizeof(uint32);
+  payload_size_ += length;
+}
@@ -6,6 +6,7 @@
 #define BASE_PICKLE_H__
 
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
@@ -13,6 +14,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 class Pickle;
 
@@ -40,6 +42,12 @@ class BASE_EXPORT PickleIterator {
   bool ReadData(const char** data, int* length) WARN_UNUSED_RESULT;
   bool ReadBytes(const char** data, int length) WARN_UNUSED_RESULT;
 
+  // Like ReadString() and ReadString16(), but point |result| into the
+  // Pickle's buffer instead of copying the string out. The result is only
+  // valid as long as the Pickle's data is.
+  bool ReadStringPiece(base::StringPiece* result) WARN_UNUSED_RESULT;
+  bool ReadStringPiece16(base::StringPiece16* result) WARN_UNUSED_RESULT;
+
   // Safer version of ReadInt() checks for the result not being negative.
   // Use it for reading the object sizes.
   bool ReadLength(int* result) WARN_UNUSED_RESULT {
@@ -167,6 +175,15 @@ class BASE_EXPORT Pickle {
   bool ReadString16(PickleIterator* iter, string16* result) const {
     return iter->ReadString16(result);
   }
+  // The string pieces point into the message's buffer, so they are scoped to
+  // the lifetime of the message (or until the message data is mutated).
+  bool ReadStringPiece(PickleIterator* iter, base::StringPiece* result) const {
+    return iter->ReadStringPiece(result);
+  }
+  bool ReadStringPiece16(PickleIterator* iter,
+                         base::StringPiece16* result) const {
+    return iter->ReadStringPiece16(result);
+  }
   // A pointer to the data will be placed in *data, and the length will be
   // placed in *length. This buffer will be into the message's buffer so will
   // be scoped to the lifetime of the message (or until the message data is
@@ -218,12 +235,17 @@ class BASE_EXPORT Pickle {
   bool WriteUInt64(uint64 value) {
     return WriteBytes(&value, sizeof(value));
   }
-  bool WriteString(const std::string& value);
+  bool WriteString(const base::StringPiece& value);
   bool WriteWString(const std::wstring& value);
-  bool WriteString16(const string16& value);
+  bool WriteString16(const base::StringPiece16& value);
   // "Data" is a blob with a length. When you read it out you will be given the
   // length. See also WriteBytes.
   bool WriteData(const char* data, int length);
+  // Writes the concatenation of |pieces| as a single "data" blob, to be read
+  // back with ReadData. Each piece is copied once, straight from its own
+  // buffer, so a payload spread over several buffers (e.g. a header and a
+  // large body) need not be joined before it is written.
+  bool WriteData(const std::vector<base::StringPiece>& pieces);
   // "Bytes" is a blob with no length. The caller must specify the lenght both
   // when reading and writing. It is normally used to serialize PoD types of a
   // known size. See also WriteData.
@@ -250,6 +272,11 @@ class BASE_EXPORT Pickle {
   // not been changed.
   void TrimWriteData(int length);
 
+  // Reserves space for |length| more bytes of payload, so that writes whose
+  // total size is known in advance (see PickleSizer) reallocate at most once.
+  // Returns false if the allocation fails.
+  bool Reserve(size_t length);
+
   // Payload follows after allocation of Header (header size is customizable).
   struct Header {
     uint32 payload_size;  // Specifies the size of the payload.
@@ -301,6 +328,10 @@ class BASE_EXPORT Pickle {
   // to pad out for the next write.
   char* BeginWrite(size_t length);
 
+  // Writes |length| followed by |data_len| bytes of |data| with a single
+  // BeginWrite, which is how strings and data are laid out.
+  bool WriteLengthAndBytes(int length, const void* data, int data_len);
+
   // Completes the write operation by padding the data with NULL bytes until it
   // is padded. Should be paired with BeginWrite, but it does not necessarily
   // have to be called after the data is written.
@@ -323,6 +354,13 @@ class BASE_EXPORT Pickle {
                               const char* range_start,
                               const char* range_end);
 
+  // Returns the total size of the pickled data that starts at range_start,
+  // header included, or 0 if its header is not entirely in the given data
+  // range.
+  static size_t PeekSize(size_t header_size,
+                         const char* range_start,
+                         const char* range_end);
+
   // The allocation granularity of the payload.
   static const int kPayloadUnit;
 
@@ -338,6 +376,41 @@ class BASE_EXPORT Pickle {
   FRIEND_TEST_ALL_PREFIXES(PickleTest, Resize);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, PeekSize);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, Reserve);
+};
+
+// PickleSizer computes the payload size that a sequence of Pickle writes will
+// produce without writing anything. Mirror the writes on a PickleSizer first,
+// then pass payload_size() to Pickle::Reserve() to allocate exactly once.
+class BASE_EXPORT PickleSizer {
+ public:
+  PickleSizer() : payload_size_(0) {}
+
+  void AddBool() { AddInt(); }
+  void AddInt() { AddBytes(sizeof(int)); }
+  void AddLongUsingDangerousNonPortableLessPersistableForm() {
+    AddBytes(sizeof(long));
+  }
+  void AddUInt16() { AddBytes(sizeof(uint16)); }
+  void AddUInt32() { AddBytes(sizeof(uint32)); }
+  void AddInt64() { AddBytes(sizeof(int64)); }
+  void AddUInt64() { AddBytes(sizeof(uint64)); }
+  void AddString(const base::StringPiece& value) { AddData(value.size()); }
+  void AddWString(const std::wstring& value) {
+    AddData(value.size() * sizeof(wchar_t));
+  }
+  void AddString16(const base::StringPiece16& value) {
+    AddData(value.size() * sizeof(char16));
+  }
+  void AddData(size_t length) { AddBytes(sizeof(int) + length); }
+  void AddBytes(size_t length);
+
+  // The size of the payload the mirrored writes would produce.
+  size_t payload_size() const { return payload_size_; }
+
+ private:
+  size_t payload_size_;
 };
 
 #endif  // BASE_PICKLE_H__
@@ -8,6 +8,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "base/string16.h"
+#include "base/utf_string_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace {
@@ -188,6 +189,22 @@ TEST(PickleTest, FindNextWithIncompleteHeader) {
   EXPECT_TRUE(NULL == Pickle::FindNext(header_size, start, end));
 }
 
+TEST(PickleTest, PeekSize) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(1));
+  EXPECT_TRUE(pickle.WriteString("Domo"));
+
+  const char* start = reinterpret_cast<const char*>(pickle.data());
+  const char* end = start + pickle.size();
+
+  // Only the header needs to be in range.
+  EXPECT_EQ(pickle.size(), Pickle::PeekSize(pickle.header_size_, start, end));
+  EXPECT_EQ(pickle.size(), Pickle::PeekSize(
+      pickle.header_size_, start, start + sizeof(Pickle::Header)));
+  EXPECT_EQ(0u, Pickle::PeekSize(
+      pickle.header_size_, start, start + sizeof(Pickle::Header) - 1));
+}
+
 TEST(PickleTest, GetReadPointerAndAdvance) {
   Pickle pickle;
 
@@ -334,3 +351,108 @@ TEST(PickleTest, ReadBytes) {
   memcpy(&outdata, outdata_char, sizeof(outdata));
   EXPECT_EQ(data, outdata);
 }
+
+TEST(PickleTest, ReadStringPiece) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteString(teststr));
+  string16 teststr16(ASCIIToUTF16("Hello, string16"));
+  EXPECT_TRUE(pickle.WriteString16(teststr16));
+  EXPECT_TRUE(pickle.WriteString(std::string()));
+
+  PickleIterator iter(pickle);
+  base::StringPiece piece;
+  EXPECT_TRUE(pickle.ReadStringPiece(&iter, &piece));
+  EXPECT_EQ(teststr, piece.as_string());
+  // The piece refers to the pickle's own buffer.
+  const char* data = static_cast<const char*>(pickle.data());
+  EXPECT_GT(piece.data(), data);
+  EXPECT_LT(piece.data(), data + pickle.size());
+
+  base::StringPiece16 piece16;
+  EXPECT_TRUE(pickle.ReadStringPiece16(&iter, &piece16));
+  EXPECT_EQ(teststr16, piece16.as_string());
+
+  EXPECT_TRUE(pickle.ReadStringPiece(&iter, &piece));
+  EXPECT_TRUE(piece.empty());
+  EXPECT_FALSE(pickle.ReadStringPiece(&iter, &piece));
+
+  // Lengths are validated as for ReadString().
+  Pickle bad_len;
+  EXPECT_TRUE(bad_len.WriteInt(1 << 31));
+  iter = PickleIterator(bad_len);
+  EXPECT_FALSE(bad_len.ReadStringPiece16(&iter, &piece16));
+}
+
+TEST(PickleTest, PickleSizerMatchesWrites) {
+  PickleSizer sizer;
+  Pickle pickle;
+
+  sizer.AddBool();
+  EXPECT_TRUE(pickle.WriteBool(true));
+  sizer.AddUInt16();
+  EXPECT_TRUE(pickle.WriteUInt16(testuint16));
+  sizer.AddString(teststr);
+  EXPECT_TRUE(pickle.WriteString(teststr));
+  sizer.AddWString(testwstr);
+  EXPECT_TRUE(pickle.WriteWString(testwstr));
+  sizer.AddInt64();
+  EXPECT_TRUE(pickle.WriteInt64(1));
+  sizer.AddData(testdatalen);
+  EXPECT_TRUE(pickle.WriteData(testdata, testdatalen));
+  sizer.AddBytes(3);
+  EXPECT_TRUE(pickle.WriteBytes(testdata, 3));
+  sizer.AddString16(ASCIIToUTF16("abc"));
+  EXPECT_TRUE(pickle.WriteString16(ASCIIToUTF16("abc")));
+
+  EXPECT_EQ(pickle.payload_size(), sizer.payload_size());
+}
+
+TEST(PickleTest, Reserve) {
+  std::string big(10000, 'x');
+  PickleSizer sizer;
+  sizer.AddInt();
+  sizer.AddString(big);
+  sizer.AddString(teststr);
+
+  Pickle pickle;
+  EXPECT_TRUE(pickle.Reserve(sizer.payload_size()));
+  size_t capacity = pickle.capacity();
+  EXPECT_GE(capacity, sizeof(Pickle::Header) + sizer.payload_size());
+  // Reserving no more than what is available does not reallocate.
+  EXPECT_TRUE(pickle.Reserve(sizer.payload_size()));
+  EXPECT_EQ(capacity, pickle.capacity());
+
+  EXPECT_TRUE(pickle.WriteInt(testint));
+  EXPECT_TRUE(pickle.WriteString(big));
+  EXPECT_TRUE(pickle.WriteString(teststr));
+  EXPECT_EQ(capacity, pickle.capacity());
+  EXPECT_EQ(sizer.payload_size(), pickle.payload_size());
+}
+
+TEST(PickleTest, WriteDataFromPieces) {
+  std::vector<base::StringPiece> pieces;
+  pieces.push_back(base::StringPiece("abc"));
+  pieces.push_back(base::StringPiece());
+  pieces.push_back(base::StringPiece(testdata, testdatalen));
+
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteData(pieces));
+  EXPECT_TRUE(pickle.WriteInt(testint));
+
+  PickleIterator iter(pickle);
+  const char* outdata;
+  int outdatalen;
+  EXPECT_TRUE(pickle.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(std::string("abc") + std::string(testdata, testdatalen),
+            std::string(outdata, outdatalen));
+  int outint;
+  EXPECT_TRUE(pickle.ReadInt(&iter, &outint));
+  EXPECT_EQ(testint, outint);
+
+  // No pieces writes an empty blob.
+  Pickle empty;
+  EXPECT_TRUE(empty.WriteData(std::vector<base::StringPiece>()));
+  iter = PickleIterator(empty);
+  EXPECT_TRUE(empty.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(0, outdatalen);
+}
@@ -77,7 +77,7 @@ TEST(TrackedTimeTest, TrackedTimerDisabled) {
   EXPECT_TRUE(track_now.is_null());
   track_now = ThreadData::NowForStartOfRun(NULL);
   EXPECT_TRUE(track_now.is_null());
-  track_now = ThreadData::NowForEndOfRun();
+  track_now = ThreadData::NowForEndOfRun(NULL);
   EXPECT_TRUE(track_now.is_null());
 }
 
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/base_export.h"
+#include "base/basictypes.h"
 
 namespace base {
 
@@ -24,6 +25,45 @@ BASE_EXPORT std::string SHA1HashString(const std::string& str);
 BASE_EXPORT void SHA1HashBytes(const unsigned char* data, size_t len,
                                unsigned char* hash);
 
+// Computes the SHA-1 hash of data that arrives in pieces. Usage:
+//
+//   base::SHA1Context sha1;
+//   while (there is more data)
+//     sha1.Update(data, data_len);
+//   unsigned char hash[base::kSHA1Length];
+//   sha1.Finish(hash);
+//
+// The blocks are hashed with the SHA extensions or ARMv8 crypto instructions
+// when the CPU has them.
+class BASE_EXPORT SHA1Context {
+ public:
+  SHA1Context();
+
+  // Discards all the data hashed so far.
+  void Reset();
+
+  // Adds |len| bytes at |data| to the hashed data.
+  void Update(const void* data, size_t len);
+
+  // Puts the hash of all the data passed to Update() in |hash|, which must be
+  // kSHA1Length bytes long, and resets the context for reuse.
+  void Finish(unsigned char* hash);
+
+ private:
+  static const size_t kBlockSize = 64;
+
+  uint32 state_[5];
+
+  // The start of a block that is not complete yet.
+  uint8 buffer_[kBlockSize];
+  size_t buffer_len_;
+
+  // The total number of bytes hashed.
+  uint64 length_;
+
+  DISALLOW_COPY_AND_ASSIGN(SHA1Context);
+};
+
 }  // namespace base
 
 #endif  // BASE_SHA1_H_
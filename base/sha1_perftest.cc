@@ -0,0 +1,79 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+
+#include "base/base64.h"
+#include "base/perftimer.h"
+#include "base/sha1.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// About the size of a large extension CRX or sync blob.
+const size_t kDataSize = 8 * 1024 * 1024;
+const int kNumIterations = 10;
+
+std::string MakeData() {
+  std::string data(kDataSize, 0);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i * 7 + (i >> 8));
+  return data;
+}
+
+}  // namespace
+
+TEST(SHA1PerfTest, HashBytes) {
+  std::string data = MakeData();
+  unsigned char hash[base::kSHA1Length];
+  PerfTimeLogger timer("SHA1_HashBytes");
+  for (int i = 0; i < kNumIterations; ++i) {
+    base::SHA1HashBytes(reinterpret_cast<const unsigned char*>(data.data()),
+                        data.size(), hash);
+  }
+  timer.Done();
+}
+
+TEST(SHA1PerfTest, ContextSmallUpdates) {
+  // Data that arrives in network-sized pieces, not aligned to blocks.
+  const size_t kPieceSize = 1500;
+  std::string data = MakeData();
+  unsigned char hash[base::kSHA1Length];
+  PerfTimeLogger timer("SHA1_ContextSmallUpdates");
+  for (int i = 0; i < kNumIterations; ++i) {
+    base::SHA1Context sha1;
+    for (size_t offset = 0; offset < data.size(); offset += kPieceSize) {
+      sha1.Update(data.data() + offset,
+                  std::min(kPieceSize, data.size() - offset));
+    }
+    sha1.Finish(hash);
+  }
+  timer.Done();
+}
+
+TEST(SHA1PerfTest, Base64EncodeHashes) {
+  // Hashes are usually base64-encoded for storage or transmission.
+  const int kNumHashes = 1000000;
+  char hash[base::kSHA1Length] = { 0 };
+  char encoded[32];
+  size_t total = 0;
+  PerfTimeLogger timer("Base64_EncodeToBuffer");
+  for (int i = 0; i < kNumHashes; ++i) {
+    hash[0] = static_cast<char>(i);
+    total += base::Base64EncodeToBuffer(
+        base::StringPiece(hash, sizeof(hash)), encoded);
+  }
+  timer.Done();
+
+  std::string output;
+  PerfTimeLogger string_timer("Base64_Encode");
+  for (int i = 0; i < kNumHashes; ++i) {
+    hash[0] = static_cast<char>(i);
+    base::Base64Encode(base::StringPiece(hash, sizeof(hash)), &output);
+    total -= output.size();
+  }
+  string_timer.Done();
+  EXPECT_EQ(0u, total);
+}
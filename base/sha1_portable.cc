@@ -6,210 +6,547 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "base/basictypes.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && defined(COMPILER_GCC) && \
+    !defined(OS_NACL) && \
+    ((defined(__clang__) && __clang_major__ >= 4) || __GNUC__ >= 5)
+// The compiler can target the SHA extensions for individual functions, so
+// they are used when base::CPU reports them at runtime.
+#define SHA1_USE_SHA_NI 1
+#include <immintrin.h>
+#include "base/cpu.h"
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_FEATURE_CRYPTO)
+// base::CPU has no ARM feature detection, so the ARMv8 crypto instructions
+// are only used when the whole build targets them.
+#define SHA1_USE_ARM_CRYPTO 1
+#include <arm_neon.h>
+#endif
 
 namespace base {
 
-// Implementation of SHA-1. Only handles data in byte-sized blocks,
-// which simplifies the code a fair bit.
-
-// Identifier names follow notation in FIPS PUB 180-3, where you'll
-// also find a description of the algorithm:
+// Implementation of SHA-1. Identifier names follow notation in FIPS PUB
+// 180-3, where you'll also find a description of the algorithm:
 // http://csrc.nist.gov/publications/fips/fips180-3/fips180-3_final.pdf
 
-// Usage example:
-//
-// SecureHashAlgorithm sha;
-// while(there is data to hash)
-//   sha.Update(moredata, size of data);
-// sha.Final();
-// memcpy(somewhere, sha.Digest(), 20);
-//
-// to reuse the instance of sha, call sha.Init();
-
-// TODO(jhawkins): Replace this implementation with a per-platform
-// implementation using each platform's crypto library.  See
-// http://crbug.com/47218
-
-class SecureHashAlgorithm {
- public:
-  SecureHashAlgorithm() { Init(); }
-
-  static const int kDigestSizeBytes;
-
-  void Init();
-  void Update(const void* data, size_t nbytes);
-  void Final();
-
-  // 20 bytes of message digest.
-  const unsigned char* Digest() const {
-    return reinterpret_cast<const unsigned char*>(H);
-  }
-
- private:
-  void Pad();
-  void Process();
+namespace {
 
-  uint32 A, B, C, D, E;
+const uint32 kH0[5] = {
+  0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
 
-  uint32 H[5];
+const uint32 kK[4] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
 
-  union {
-    uint32 W[80];
-    uint8 M[64];
-  };
+// Processes |num_blocks| consecutive 64-byte blocks at |data|, updating the
+// intermediate hash value in |H|.
+typedef void (*ProcessBlocksFunction)(uint32* H, const uint8* data,
+                                      size_t num_blocks);
 
-  uint32 cursor;
-  uint32 l;
-};
+inline uint32 S(uint32 n, uint32 X) {
+  return (X << n) | (X >> (32 - n));
+}
 
-static inline uint32 f(uint32 t, uint32 B, uint32 C, uint32 D) {
-  if (t < 20) {
-    return (B & C) | ((~B) & D);
-  } else if (t < 40) {
-    return B ^ C ^ D;
-  } else if (t < 60) {
-    return (B & C) | (B & D) | (C & D);
-  } else {
-    return B ^ C ^ D;
-  }
+inline uint32 LoadBigEndian(const uint8* p) {
+  return (static_cast<uint32>(p[0]) << 24) |
+         (static_cast<uint32>(p[1]) << 16) |
+         (static_cast<uint32>(p[2]) << 8) |
+         static_cast<uint32>(p[3]);
 }
 
-static inline uint32 S(uint32 n, uint32 X) {
-  return (X << n) | (X >> (32-n));
+inline void StoreBigEndian(uint32 x, uint8* p) {
+  p[0] = static_cast<uint8>(x >> 24);
+  p[1] = static_cast<uint8>(x >> 16);
+  p[2] = static_cast<uint8>(x >> 8);
+  p[3] = static_cast<uint8>(x);
 }
 
-static inline uint32 K(uint32 t) {
-  if (t < 20) {
-    return 0x5a827999;
-  } else if (t < 40) {
-    return 0x6ed9eba1;
-  } else if (t < 60) {
-    return 0x8f1bbcdc;
-  } else {
-    return 0xca62c1d6;
+// Steps of section 6.1.2 d. for the four ranges of t. The message schedule
+// only keeps the last 16 words of W.
+#define SHA1_W(t) \
+    (W[(t) & 15] = S(1, W[((t) + 13) & 15] ^ W[((t) + 8) & 15] ^ \
+                        W[((t) + 2) & 15] ^ W[(t) & 15]))
+#define SHA1_STEP(f, k, w) \
+    do { \
+      uint32 TEMP = S(5, A) + (f) + E + (w) + (k); \
+      E = D; \
+      D = C; \
+      C = S(30, B); \
+      B = A; \
+      A = TEMP; \
+    } while (0)
+
+void ProcessBlocksPortable(uint32* H, const uint8* data, size_t num_blocks) {
+  for (; num_blocks; --num_blocks, data += 64) {
+    uint32 W[16];
+    int t;
+    for (t = 0; t < 16; ++t)
+      W[t] = LoadBigEndian(data + 4 * t);
+
+    uint32 A = H[0];
+    uint32 B = H[1];
+    uint32 C = H[2];
+    uint32 D = H[3];
+    uint32 E = H[4];
+
+    for (t = 0; t < 16; ++t)
+      SHA1_STEP((B & C) | (~B & D), kK[0], W[t]);
+    for (; t < 20; ++t)
+      SHA1_STEP((B & C) | (~B & D), kK[0], SHA1_W(t));
+    for (; t < 40; ++t)
+      SHA1_STEP(B ^ C ^ D, kK[1], SHA1_W(t));
+    for (; t < 60; ++t)
+      SHA1_STEP((B & C) | (B & D) | (C & D), kK[2], SHA1_W(t));
+    for (; t < 80; ++t)
+      SHA1_STEP(B ^ C ^ D, kK[3], SHA1_W(t));
+
+    H[0] += A;
+    H[1] += B;
+    H[2] += C;
+    H[3] += D;
+    H[4] += E;
   }
 }
 
-static inline void swapends(uint32* t) {
-  *t = ((*t & 0xff000000) >> 24) |
-       ((*t & 0xff0000) >> 8) |
-       ((*t & 0xff00) << 8) |
-       ((*t & 0xff) << 24);
+#undef SHA1_STEP
+#undef SHA1_W
+
+#if defined(SHA1_USE_SHA_NI)
+
+// Each sha1rnds4 performs four steps. The arrangement of the message schedule
+// instructions follows Intel's "New Instructions Supporting the Secure Hash
+// Algorithm on Intel Architecture Processors".
+__attribute__((target("sha,ssse3,sse4.1")))
+void ProcessBlocksSHANI(uint32* H, const uint8* data, size_t num_blocks) {
+  const __m128i kByteSwap =
+      _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+  // The instructions keep A in the most significant lane.
+  __m128i abcd = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(H)), 0x1b);
+  __m128i e0 = _mm_set_epi32(H[4], 0, 0, 0);
+  __m128i e1;
+  __m128i msg0, msg1, msg2, msg3;
+
+  for (; num_blocks; --num_blocks, data += 64) {
+    __m128i abcd_save = abcd;
+    __m128i e_save = e0;
+
+    // Rounds 0-3.
+    msg0 = _mm_shuffle_epi8(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + 0)), kByteSwap);
+    e0 = _mm_add_epi32(e0, msg0);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    // Rounds 4-7.
+    msg1 = _mm_shuffle_epi8(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + 16)), kByteSwap);
+    e1 = _mm_sha1nexte_epu32(e1, msg1);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+    // Rounds 8-11.
+    msg2 = _mm_shuffle_epi8(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + 32)), kByteSwap);
+    e0 = _mm_sha1nexte_epu32(e0, msg2);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+    msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+    msg0 = _mm_xor_si128(msg0, msg2);
+
+    // Rounds 12-15.
+    msg3 = _mm_shuffle_epi8(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + 48)), kByteSwap);
+    e1 = _mm_sha1nexte_epu32(e1, msg3);
+    e0 = abcd;
+    msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+    msg1 = _mm_xor_si128(msg1, msg3);
+
+    // Rounds 16-19.
+    e0 = _mm_sha1nexte_epu32(e0, msg0);
+    e1 = abcd;
+    msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+    msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+    msg2 = _mm_xor_si128(msg2, msg0);
+
+    // Rounds 20-23.
+    e1 = _mm_sha1nexte_epu32(e1, msg1);
+    e0 = abcd;
+    msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+    msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+    msg3 = _mm_xor_si128(msg3, msg1);
+
+    // Rounds 24-27.
+    e0 = _mm_sha1nexte_epu32(e0, msg2);
+    e1 = abcd;
+    msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+    msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+    msg0 = _mm_xor_si128(msg0, msg2);
+
+    // Rounds 28-31.
+    e1 = _mm_sha1nexte_epu32(e1, msg3);
+    e0 = abcd;
+    msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+    msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+    msg1 = _mm_xor_si128(msg1, msg3);
+
+    // Rounds 32-35.
+    e0 = _mm_sha1nexte_epu32(e0, msg0);
+    e1 = abcd;
+    msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+    msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+    msg2 = _mm_xor_si128(msg2, msg0);
+
+    // Rounds 36-39.
+    e1 = _mm_sha1nexte_epu32(e1, msg1);
+    e0 = abcd;
+    msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+    msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+    msg3 = _mm_xor_si128(msg3, msg1);
+
+    // Rounds 40-43.
+    e0 = _mm_sha1nexte_epu32(e0, msg2);
+    e1 = abcd;
+    msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+    msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+    msg0 = _mm_xor_si128(msg0, msg2);
+
+    // Rounds 44-47.
+    e1 = _mm_sha1nexte_epu32(e1, msg3);
+    e0 = abcd;
+    msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+    msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+    msg1 = _mm_xor_si128(msg1, msg3);
+
+    // Rounds 48-51.
+    e0 = _mm_sha1nexte_epu32(e0, msg0);
+    e1 = abcd;
+    msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+    msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+    msg2 = _mm_xor_si128(msg2, msg0);
+
+    // Rounds 52-55.
+    e1 = _mm_sha1nexte_epu32(e1, msg1);
+    e0 = abcd;
+    msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+    msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+    msg3 = _mm_xor_si128(msg3, msg1);
+
+    // Rounds 56-59.
+    e0 = _mm_sha1nexte_epu32(e0, msg2);
+    e1 = abcd;
+    msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+    msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+    msg0 = _mm_xor_si128(msg0, msg2);
+
+    // Rounds 60-63.
+    e1 = _mm_sha1nexte_epu32(e1, msg3);
+    e0 = abcd;
+    msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+    msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+    msg1 = _mm_xor_si128(msg1, msg3);
+
+    // Rounds 64-67.
+    e0 = _mm_sha1nexte_epu32(e0, msg0);
+    e1 = abcd;
+    msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+    msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+    msg2 = _mm_xor_si128(msg2, msg0);
+
+    // Rounds 68-71.
+    e1 = _mm_sha1nexte_epu32(e1, msg1);
+    e0 = abcd;
+    msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+    msg3 = _mm_xor_si128(msg3, msg1);
+
+    // Rounds 72-75.
+    e0 = _mm_sha1nexte_epu32(e0, msg2);
+    e1 = abcd;
+    msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+    // Rounds 76-79.
+    e1 = _mm_sha1nexte_epu32(e1, msg3);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+    e0 = _mm_sha1nexte_epu32(e0, e_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(H),
+                   _mm_shuffle_epi32(abcd, 0x1b));
+  H[4] = _mm_extract_epi32(e0, 3);
 }
 
-const int SecureHashAlgorithm::kDigestSizeBytes = 20;
-
-void SecureHashAlgorithm::Init() {
-  A = 0;
-  B = 0;
-  C = 0;
-  D = 0;
-  E = 0;
-  cursor = 0;
-  l = 0;
-  H[0] = 0x67452301;
-  H[1] = 0xefcdab89;
-  H[2] = 0x98badcfe;
-  H[3] = 0x10325476;
-  H[4] = 0xc3d2e1f0;
+bool CPUHasSHANI() {
+  CPU cpu;
+  return cpu.has_sha() && cpu.has_ssse3() && cpu.has_sse41();
 }
 
-void SecureHashAlgorithm::Final() {
-  Pad();
-  Process();
+#elif defined(SHA1_USE_ARM_CRYPTO)
+
+// Each vsha1{c,p,m}q performs four steps.
+void ProcessBlocksARMCrypto(uint32* H, const uint8* data, size_t num_blocks) {
+  uint32x4_t abcd = vld1q_u32(H);
+  uint32_t e0 = H[4];
+  uint32_t e1;
+  uint32x4_t msg0, msg1, msg2, msg3, tmp0, tmp1;
+
+  for (; num_blocks; --num_blocks, data += 64) {
+    uint32x4_t abcd_save = abcd;
+    uint32_t e_save = e0;
+
+    msg0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data)));
+    msg1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+    msg2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+    msg3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+    tmp0 = vaddq_u32(msg0, vdupq_n_u32(kK[0]));
+    tmp1 = vaddq_u32(msg1, vdupq_n_u32(kK[0]));
+
+    // Rounds 0-3.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1cq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg2, vdupq_n_u32(kK[0]));
+    msg0 = vsha1su0q_u32(msg0, msg1, msg2);
+
+    // Rounds 4-7.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1cq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg3, vdupq_n_u32(kK[0]));
+    msg0 = vsha1su1q_u32(msg0, msg3);
+    msg1 = vsha1su0q_u32(msg1, msg2, msg3);
+
+    // Rounds 8-11.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1cq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg0, vdupq_n_u32(kK[0]));
+    msg1 = vsha1su1q_u32(msg1, msg0);
+    msg2 = vsha1su0q_u32(msg2, msg3, msg0);
+
+    // Rounds 12-15.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1cq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg1, vdupq_n_u32(kK[1]));
+    msg2 = vsha1su1q_u32(msg2, msg1);
+    msg3 = vsha1su0q_u32(msg3, msg0, msg1);
+
+    // Rounds 16-19.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1cq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg2, vdupq_n_u32(kK[1]));
+    msg3 = vsha1su1q_u32(msg3, msg2);
+    msg0 = vsha1su0q_u32(msg0, msg1, msg2);
+
+    // Rounds 20-23.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg3, vdupq_n_u32(kK[1]));
+    msg0 = vsha1su1q_u32(msg0, msg3);
+    msg1 = vsha1su0q_u32(msg1, msg2, msg3);
+
+    // Rounds 24-27.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg0, vdupq_n_u32(kK[1]));
+    msg1 = vsha1su1q_u32(msg1, msg0);
+    msg2 = vsha1su0q_u32(msg2, msg3, msg0);
+
+    // Rounds 28-31.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg1, vdupq_n_u32(kK[1]));
+    msg2 = vsha1su1q_u32(msg2, msg1);
+    msg3 = vsha1su0q_u32(msg3, msg0, msg1);
+
+    // Rounds 32-35.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg2, vdupq_n_u32(kK[2]));
+    msg3 = vsha1su1q_u32(msg3, msg2);
+    msg0 = vsha1su0q_u32(msg0, msg1, msg2);
+
+    // Rounds 36-39.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg3, vdupq_n_u32(kK[2]));
+    msg0 = vsha1su1q_u32(msg0, msg3);
+    msg1 = vsha1su0q_u32(msg1, msg2, msg3);
+
+    // Rounds 40-43.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1mq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg0, vdupq_n_u32(kK[2]));
+    msg1 = vsha1su1q_u32(msg1, msg0);
+    msg2 = vsha1su0q_u32(msg2, msg3, msg0);
+
+    // Rounds 44-47.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1mq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg1, vdupq_n_u32(kK[2]));
+    msg2 = vsha1su1q_u32(msg2, msg1);
+    msg3 = vsha1su0q_u32(msg3, msg0, msg1);
+
+    // Rounds 48-51.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1mq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg2, vdupq_n_u32(kK[2]));
+    msg3 = vsha1su1q_u32(msg3, msg2);
+    msg0 = vsha1su0q_u32(msg0, msg1, msg2);
+
+    // Rounds 52-55.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1mq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg3, vdupq_n_u32(kK[3]));
+    msg0 = vsha1su1q_u32(msg0, msg3);
+    msg1 = vsha1su0q_u32(msg1, msg2, msg3);
+
+    // Rounds 56-59.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1mq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg0, vdupq_n_u32(kK[3]));
+    msg1 = vsha1su1q_u32(msg1, msg0);
+    msg2 = vsha1su0q_u32(msg2, msg3, msg0);
+
+    // Rounds 60-63.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg1, vdupq_n_u32(kK[3]));
+    msg2 = vsha1su1q_u32(msg2, msg1);
+    msg3 = vsha1su0q_u32(msg3, msg0, msg1);
+
+    // Rounds 64-67.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e0, tmp0);
+    tmp0 = vaddq_u32(msg2, vdupq_n_u32(kK[3]));
+    msg3 = vsha1su1q_u32(msg3, msg2);
+
+    // Rounds 68-71.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e1, tmp1);
+    tmp1 = vaddq_u32(msg3, vdupq_n_u32(kK[3]));
+
+    // Rounds 72-75.
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e0, tmp0);
+
+    // Rounds 76-79.
+    e0 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    abcd = vsha1pq_u32(abcd, e1, tmp1);
+    e0 += e_save;
+    abcd = vaddq_u32(abcd, abcd_save);
+  }
 
-  for (int t = 0; t < 5; ++t)
-    swapends(&H[t]);
+  vst1q_u32(H, abcd);
+  H[4] = e0;
 }
 
-void SecureHashAlgorithm::Update(const void* data, size_t nbytes) {
-  const uint8* d = reinterpret_cast<const uint8*>(data);
-  while (nbytes--) {
-    M[cursor++] = *d++;
-    if (cursor >= 64)
-      Process();
-    l += 8;
-  }
+#endif
+
+void ProcessBlocks(uint32* H, const uint8* data, size_t num_blocks) {
+#if defined(SHA1_USE_SHA_NI)
+  static const ProcessBlocksFunction kProcessBlocks =
+      CPUHasSHANI() ? ProcessBlocksSHANI : ProcessBlocksPortable;
+  kProcessBlocks(H, data, num_blocks);
+#elif defined(SHA1_USE_ARM_CRYPTO)
+  ProcessBlocksARMCrypto(H, data, num_blocks);
+#else
+  ProcessBlocksPortable(H, data, num_blocks);
+#endif
 }
 
-void SecureHashAlgorithm::Pad() {
-  M[cursor++] = 0x80;
+}  // namespace
 
-  if (cursor > 64-8) {
-    // pad out to next block
-    while (cursor < 64)
-      M[cursor++] = 0;
+SHA1Context::SHA1Context() {
+  Reset();
+}
+
+void SHA1Context::Reset() {
+  memcpy(state_, kH0, sizeof(state_));
+  buffer_len_ = 0;
+  length_ = 0;
+}
 
-    Process();
+void SHA1Context::Update(const void* data, size_t len) {
+  const uint8* d = reinterpret_cast<const uint8*>(data);
+  length_ += len;
+
+  // Complete the block left over from the previous call first.
+  if (buffer_len_) {
+    size_t copy_len = std::min(len, kBlockSize - buffer_len_);
+    memcpy(buffer_ + buffer_len_, d, copy_len);
+    buffer_len_ += copy_len;
+    d += copy_len;
+    len -= copy_len;
+    if (buffer_len_ < kBlockSize)
+      return;
+    ProcessBlocks(state_, buffer_, 1);
+    buffer_len_ = 0;
   }
 
-  while (cursor < 64-4)
-    M[cursor++] = 0;
+  // Whole blocks are hashed straight from |data|.
+  size_t num_blocks = len / kBlockSize;
+  if (num_blocks) {
+    ProcessBlocks(state_, d, num_blocks);
+    d += num_blocks * kBlockSize;
+    len -= num_blocks * kBlockSize;
+  }
 
-  M[64-4] = (l & 0xff000000) >> 24;
-  M[64-3] = (l & 0xff0000) >> 16;
-  M[64-2] = (l & 0xff00) >> 8;
-  M[64-1] = (l & 0xff);
+  memcpy(buffer_, d, len);
+  buffer_len_ = len;
 }
 
-void SecureHashAlgorithm::Process() {
-  uint32 t;
-
-  // Each a...e corresponds to a section in the FIPS 180-3 algorithm.
-
-  // a.
-  //
-  // W and M are in a union, so no need to memcpy.
-  // memcpy(W, M, sizeof(M));
-  for (t = 0; t < 16; ++t)
-    swapends(&W[t]);
-
-  // b.
-  for (t = 16; t < 80; ++t)
-    W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-
-  // c.
-  A = H[0];
-  B = H[1];
-  C = H[2];
-  D = H[3];
-  E = H[4];
-
-  // d.
-  for (t = 0; t < 80; ++t) {
-    uint32 TEMP = S(5, A) + f(t, B, C, D) + E + W[t] + K(t);
-    E = D;
-    D = C;
-    C = S(30, B);
-    B = A;
-    A = TEMP;
+void SHA1Context::Finish(unsigned char* hash) {
+  // Section 5.1.1: append a 1 bit, zeros, and the message length in bits.
+  uint64 bit_length = length_ * 8;
+  buffer_[buffer_len_++] = 0x80;
+  if (buffer_len_ > kBlockSize - 8) {
+    memset(buffer_ + buffer_len_, 0, kBlockSize - buffer_len_);
+    ProcessBlocks(state_, buffer_, 1);
+    buffer_len_ = 0;
   }
+  memset(buffer_ + buffer_len_, 0, kBlockSize - 8 - buffer_len_);
+  StoreBigEndian(static_cast<uint32>(bit_length >> 32),
+                 buffer_ + kBlockSize - 8);
+  StoreBigEndian(static_cast<uint32>(bit_length), buffer_ + kBlockSize - 4);
+  ProcessBlocks(state_, buffer_, 1);
 
-  // e.
-  H[0] += A;
-  H[1] += B;
-  H[2] += C;
-  H[3] += D;
-  H[4] += E;
-
-  cursor = 0;
+  for (int t = 0; t < 5; ++t)
+    StoreBigEndian(state_[t], hash + 4 * t);
+  Reset();
 }
 
 std::string SHA1HashString(const std::string& str) {
-  char hash[SecureHashAlgorithm::kDigestSizeBytes];
+  char hash[kSHA1Length];
   SHA1HashBytes(reinterpret_cast<const unsigned char*>(str.c_str()),
                 str.length(), reinterpret_cast<unsigned char*>(hash));
-  return std::string(hash, SecureHashAlgorithm::kDigestSizeBytes);
+  return std::string(hash, kSHA1Length);
 }
 
 void SHA1HashBytes(const unsigned char* data, size_t len,
                    unsigned char* hash) {
-  SecureHashAlgorithm sha;
-  sha.Update(data, len);
-  sha.Final();
-
-  memcpy(hash, sha.Digest(), SecureHashAlgorithm::kDigestSizeBytes);
+  SHA1Context sha1;
+  sha1.Update(data, len);
+  sha1.Finish(hash);
 }
 
 }  // namespace base
@@ -4,6 +4,9 @@
 
 #include "base/sha1.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <string>
 
 #include "base/basictypes.h"
@@ -106,3 +109,55 @@ TEST(SHA1Test, Test3Bytes) {
   for (size_t i = 0; i < base::kSHA1Length; i++)
     EXPECT_EQ(expected[i], output[i]);
 }
+
+TEST(SHA1Test, Context) {
+  // Feed the long message of Example A.3 in pieces of varying size, so that
+  // blocks are completed from both the buffer and the input.
+  std::string input(1000000, 'a');
+  unsigned char expected[base::kSHA1Length];
+  base::SHA1HashBytes(reinterpret_cast<const unsigned char*>(input.data()),
+                      input.size(), expected);
+
+  for (size_t piece_size = 1; piece_size <= 130; piece_size += 7) {
+    base::SHA1Context sha1;
+    for (size_t offset = 0; offset < input.size(); offset += piece_size) {
+      sha1.Update(input.data() + offset,
+                  std::min(piece_size, input.size() - offset));
+    }
+    unsigned char output[base::kSHA1Length];
+    sha1.Finish(output);
+    EXPECT_EQ(0, memcmp(expected, output, base::kSHA1Length)) << piece_size;
+  }
+}
+
+TEST(SHA1Test, ContextReuse) {
+  // Finish() resets the context. Example A.1 from FIPS 180-2.
+  int expected[] = { 0xa9, 0x99, 0x3e, 0x36,
+                     0x47, 0x06, 0x81, 0x6a,
+                     0xba, 0x3e, 0x25, 0x71,
+                     0x78, 0x50, 0xc2, 0x6c,
+                     0x9c, 0xd0, 0xd8, 0x9d };
+
+  base::SHA1Context sha1;
+  unsigned char output[base::kSHA1Length];
+  sha1.Update("xyz", 3);
+  sha1.Finish(output);
+  sha1.Update("a", 1);
+  sha1.Update("bc", 2);
+  sha1.Finish(output);
+  for (size_t i = 0; i < base::kSHA1Length; i++)
+    EXPECT_EQ(expected[i], output[i]);
+
+  // Padding that spills into a second block, and the empty message.
+  std::string input(56, 'a');
+  sha1.Update(input.data(), input.size());
+  sha1.Finish(output);
+  EXPECT_EQ(base::SHA1HashString(input),
+            std::string(reinterpret_cast<char*>(output), base::kSHA1Length));
+  sha1.Finish(output);
+  EXPECT_EQ(base::SHA1HashString(std::string()),
+            std::string(reinterpret_cast<char*>(output), base::kSHA1Length));
+  EXPECT_EQ("\xda\x39\xa3\xee\x5e\x6b\x4b\x0d\x32\x55"
+            "\xbf\xef\x95\x60\x18\x90\xaf\xd8\x07\x09",
+            base::SHA1HashString(std::string()));
+}
@@ -455,12 +455,12 @@ bool IsStringASCII(const std::wstring& str) {
 
 #if !defined(WCHAR_T_IS_UTF16)
 bool IsStringASCII(const string16& str) {
-  return DoIsStringASCII(str);
+  return base::CountLeadingASCII(str.data(), str.length()) == str.length();
 }
 #endif
 
 bool IsStringASCII(const base::StringPiece& str) {
-  return DoIsStringASCII(str);
+  return base::CountLeadingASCII(str.data(), str.length()) == str.length();
 }
 
 bool IsStringUTF8(const std::string& str) {
@@ -469,6 +469,12 @@ bool IsStringUTF8(const std::string& str) {
   int32 char_index = 0;
 
   while (char_index < src_len) {
+    // ASCII is always valid, so skip over runs of it in bulk.
+    char_index += static_cast<int32>(
+        base::CountLeadingASCII(src + char_index, src_len - char_index));
+    if (char_index == src_len)
+      break;
+
     int32 code_point;
     CBU8_NEXT(src, char_index, src_len, code_point);
     if (!base::IsValidCharacter(code_point))
@@ -45,6 +45,14 @@ bool TaskRunner::PostTask(const tracked_objects::Location& from_here,
   return PostDelayedTask(from_here, task, base::TimeDelta());
 }
 
+bool TaskRunner::PostDelayedTaskWithLeeway(
+    const tracked_objects::Location& from_here,
+    const Closure& task,
+    base::TimeDelta delay,
+    base::TimeDelta leeway) {
+  return PostDelayedTask(from_here, task, delay);
+}
+
 bool TaskRunner::PostTaskAndReply(
     const tracked_objects::Location& from_here,
     const Closure& task,
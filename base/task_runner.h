@@ -75,6 +75,16 @@ class BASE_EXPORT TaskRunner
                                const Closure& task,
                                base::TimeDelta delay) = 0;
 
+  // Like PostDelayedTask, but tells the implementation that the task may run
+  // up to |leeway| later than |delay|, so that it can be run together with
+  // other tasks and save a wakeup.  The default implementation ignores
+  // |leeway| and calls PostDelayedTask().
+  virtual bool PostDelayedTaskWithLeeway(
+      const tracked_objects::Location& from_here,
+      const Closure& task,
+      base::TimeDelta delay,
+      base::TimeDelta leeway);
+
   // Returns true if the current thread is a thread on which a task
   // may be run, and false if no task will be run on the current
   // thread.
@@ -4,6 +4,7 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -245,9 +246,16 @@ class SequencedWorkerPool::Worker : public SimpleThread {
     return running_sequence_;
   }
 
+  // Zero-based index of this worker, used to find its own queue in
+  // WORK_STEALING mode.
+  int worker_index() const {
+    return worker_index_;
+  }
+
  private:
   scoped_refptr<SequencedWorkerPool> worker_pool_;
   SequenceToken running_sequence_;
+  const int worker_index_;
 
   DISALLOW_COPY_AND_ASSIGN(Worker);
 };
@@ -260,6 +268,7 @@ class SequencedWorkerPool::Inner {
   // by it).
   Inner(SequencedWorkerPool* worker_pool, size_t max_threads,
         const std::string& thread_name_prefix,
+        SchedulingMode scheduling_mode,
         TestingObserver* observer);
 
   ~Inner();
@@ -293,6 +302,40 @@ class SequencedWorkerPool::Inner {
   void ThreadLoop(Worker* this_worker);
 
  private:
+  // A per-worker queue of unsequenced tasks used in WORK_STEALING mode. The
+  // owning worker takes from the front and thieves take from the back.
+  struct StealingQueue {
+    Lock lock;
+    std::deque<SequencedTask> tasks;
+  };
+
+  // Adds |this_worker| to |threads_|. Must be called under lock.
+  void RegisterWorker(Worker* this_worker);
+
+  // The WORK_STEALING flavor of ThreadLoop.
+  void WorkStealingThreadLoop(Worker* this_worker);
+
+  // Runs |task| on the current worker thread. Must be called outside the
+  // lock. Clears |task->task| before returning.
+  void RunTaskOnWorker(Worker* this_worker, SequencedTask* task);
+
+  // Queues an unsequenced task on one of |stealing_queues_| without taking
+  // |lock_| in the common case. Returns false if shutdown already started.
+  bool PostStealableTask(const SequencedTask& task);
+
+  // Takes a task from the worker's own queue, or steals one from another
+  // worker's queue. Does not take |lock_|.
+  bool TakeStealableTask(int worker_index, SequencedTask* task);
+
+  // Does the shutdown accounting around running a task returned by
+  // TakeStealableTask, then runs it unless shutdown says it should be
+  // dropped.
+  void RunStolenTask(Worker* this_worker, SequencedTask* task);
+
+  // Wakes up an idle worker, or starts a new one, to pick up stealable work.
+  // Must be called outside the lock.
+  void WakeUpWorkerForStealableTask();
+
   // Returns whether there are no more pending tasks and all threads
   // are idle.  Must be called under lock.
   bool IsIdle() const;
@@ -304,7 +347,12 @@ class SequencedWorkerPool::Inner {
   // The calling code should clear the given delete_these_oustide_lock
   // vector the next time the lock is released. See the implementation for
   // a more detailed description.
+  //
+  // If |preferred_sequence_token_id| is nonzero and that sequence has a
+  // pending task, that task is returned ahead of older tasks. This keeps a
+  // sequence on the worker that just ran its previous task.
   bool GetWork(SequencedTask* task,
+               int preferred_sequence_token_id,
                std::vector<Closure>* delete_these_outside_lock);
 
   // Peforms init and cleanup around running the given task. WillRun...
@@ -410,12 +458,45 @@ class SequencedWorkerPool::Inner {
   std::set<int> current_sequences_;
 
   // An ID for each posted task to distinguish the task from others in traces.
-  int trace_id_;
+  // Incremented atomically since stealable tasks are posted without the lock.
+  volatile subtle::Atomic32 trace_id_;
 
   // Set when Shutdown is called and no further tasks should be
   // allowed, though we may still be running existing tasks.
   bool shutdown_called_;
 
+  const SchedulingMode scheduling_mode_;
+
+  // The fields below are only used in WORK_STEALING mode. They are read and
+  // written without holding |lock_|; the counters are ordered against
+  // |shutdown_flag_| and |idle_worker_count_| with full barriers so that a
+  // racing post, shutdown or idle worker always sees the other side.
+
+  // One queue per potential worker, created up front.
+  std::vector<linked_ptr<StealingQueue> > stealing_queues_;
+
+  // Round-robin cursor for picking the queue of a newly posted task.
+  volatile subtle::Atomic32 next_stealing_queue_;
+
+  // Number of tasks in |stealing_queues_|, plus posts that are in flight.
+  volatile subtle::Atomic32 stealable_task_count_;
+
+  // Number of BLOCK_SHUTDOWN tasks in |stealing_queues_| that have not
+  // started.
+  volatile subtle::Atomic32 blocking_shutdown_stealable_count_;
+
+  // Number of stolen SKIP_ON_SHUTDOWN or BLOCK_SHUTDOWN tasks running now.
+  volatile subtle::Atomic32 blocking_shutdown_stolen_running_count_;
+
+  // Mirrors |shutdown_called_| for readers that don't hold the lock.
+  volatile subtle::Atomic32 shutdown_flag_;
+
+  // Number of workers that are about to wait, or are waiting, for work.
+  volatile subtle::Atomic32 idle_worker_count_;
+
+  // Set once |max_threads_| workers have been registered.
+  volatile subtle::Atomic32 all_workers_created_;
+
   TestingObserver* const testing_observer_;
 
   DISALLOW_COPY_AND_ASSIGN(Inner);
@@ -429,7 +510,8 @@ SequencedWorkerPool::Worker::Worker(
     const std::string& prefix)
     : SimpleThread(
           prefix + StringPrintf("Worker%d", thread_number).c_str()),
-      worker_pool_(worker_pool) {
+      worker_pool_(worker_pool),
+      worker_index_(thread_number - 1) {
   Start();
 }
 
@@ -453,6 +535,7 @@ SequencedWorkerPool::Inner::Inner(
     SequencedWorkerPool* worker_pool,
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode scheduling_mode,
     TestingObserver* observer)
     : worker_pool_(worker_pool),
       last_sequence_number_(0),
@@ -469,7 +552,20 @@ SequencedWorkerPool::Inner::Inner(
       blocking_shutdown_pending_task_count_(0),
       trace_id_(0),
       shutdown_called_(false),
-      testing_observer_(observer) {}
+      scheduling_mode_(scheduling_mode),
+      next_stealing_queue_(0),
+      stealable_task_count_(0),
+      blocking_shutdown_stealable_count_(0),
+      blocking_shutdown_stolen_running_count_(0),
+      shutdown_flag_(0),
+      idle_worker_count_(0),
+      all_workers_created_(0),
+      testing_observer_(observer) {
+  if (scheduling_mode_ == WORK_STEALING) {
+    for (size_t i = 0; i < max_threads_; ++i)
+      stealing_queues_.push_back(make_linked_ptr(new StealingQueue));
+  }
+}
 
 SequencedWorkerPool::Inner::~Inner() {
   // You must call Shutdown() before destroying the pool.
@@ -512,6 +608,12 @@ bool SequencedWorkerPool::Inner::PostTask(
       shutdown_behavior == BLOCK_SHUTDOWN ?
       base::MakeCriticalClosure(task) : task;
 
+  // Unsequenced tasks bypass the central list in WORK_STEALING mode.
+  if (scheduling_mode_ == WORK_STEALING && !optional_token_name &&
+      !sequenced.sequence_token_id) {
+    return PostStealableTask(sequenced);
+  }
+
   int create_thread_id = 0;
   {
     AutoLock lock(lock_);
@@ -519,7 +621,7 @@ bool SequencedWorkerPool::Inner::PostTask(
       return false;
 
     // The trace_id is used for identifying the task in about:tracing.
-    sequenced.trace_id = trace_id_++;
+    sequenced.trace_id = subtle::NoBarrier_AtomicIncrement(&trace_id_, 1) - 1;
 
     TRACE_EVENT_FLOW_BEGIN0("task", "SequencedWorkerPool::PostTask",
         TRACE_ID_MANGLE(GetTaskTraceID(sequenced, static_cast<void*>(this))));
@@ -581,6 +683,10 @@ void SequencedWorkerPool::Inner::Shutdown() {
     if (shutdown_called_)
       return;
     shutdown_called_ = true;
+    subtle::NoBarrier_Store(&shutdown_flag_, 1);
+    // Pairs with the barriers in PostStealableTask and RunStolenTask so that
+    // either they see the flag or CanShutdown() sees their counts.
+    subtle::MemoryBarrier();
 
     // Tickle the threads. This will wake up a waiting one so it will know that
     // it can exit, which in turn will wake up any other waiting ones.
@@ -610,14 +716,14 @@ void SequencedWorkerPool::Inner::Shutdown() {
 }
 
 void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
+  if (scheduling_mode_ == WORK_STEALING) {
+    WorkStealingThreadLoop(this_worker);
+    return;
+  }
+
   {
     AutoLock lock(lock_);
-    DCHECK(thread_being_created_);
-    thread_being_created_ = false;
-    std::pair<ThreadMap::iterator, bool> result =
-        threads_.insert(
-            std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
-    DCHECK(result.second);
+    RegisterWorker(this_worker);
 
     while (true) {
 #if defined(OS_MACOSX)
@@ -627,7 +733,7 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
       // See GetWork for what delete_these_outside_lock is doing.
       SequencedTask task;
       std::vector<Closure> delete_these_outside_lock;
-      if (GetWork(&task, &delete_these_outside_lock)) {
+      if (GetWork(&task, 0, &delete_these_outside_lock)) {
         TRACE_EVENT_FLOW_END0("task", "SequencedWorkerPool::PostTask",
             TRACE_ID_MANGLE(GetTaskTraceID(task, static_cast<void*>(this))));
         TRACE_EVENT2("task", "SequencedWorkerPool::ThreadLoop",
@@ -647,22 +753,7 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
           if (new_thread_id)
             FinishStartingAdditionalThread(new_thread_id);
 
-          this_worker->set_running_sequence(
-              SequenceToken(task.sequence_token_id));
-
-          tracked_objects::TrackedTime start_time =
-              tracked_objects::ThreadData::NowForStartOfRun(task.birth_tally);
-
-          task.task.Run();
-
-          tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(task,
-              start_time, tracked_objects::ThreadData::NowForEndOfRun());
-
-          this_worker->set_running_sequence(SequenceToken());
-
-          // Make sure our task is erased outside the lock for the same reason
-          // we do this with delete_these_oustide_lock.
-          task.task = Closure();
+          RunTaskOnWorker(this_worker, &task);
         }
         DidRunWorkerTask(task);  // Must be done inside the lock.
       } else {
@@ -691,9 +782,238 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
   can_shutdown_cv_.Signal();
 }
 
+void SequencedWorkerPool::Inner::RegisterWorker(Worker* this_worker) {
+  lock_.AssertAcquired();
+  DCHECK(thread_being_created_);
+  thread_being_created_ = false;
+  std::pair<ThreadMap::iterator, bool> result =
+      threads_.insert(
+          std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
+  DCHECK(result.second);
+  if (threads_.size() == max_threads_)
+    subtle::Release_Store(&all_workers_created_, 1);
+}
+
+void SequencedWorkerPool::Inner::WorkStealingThreadLoop(Worker* this_worker) {
+  {
+    AutoLock lock(lock_);
+    RegisterWorker(this_worker);
+  }
+
+  // The sequence of the last task this worker ran from the central list. Its
+  // next task, if any, is picked up by this worker before anything else.
+  int preferred_sequence_token_id = 0;
+  while (true) {
+#if defined(OS_MACOSX)
+    base::mac::ScopedNSAutoreleasePool autorelease_pool;
+#endif
+
+    SequencedTask task;
+    if (!preferred_sequence_token_id &&
+        TakeStealableTask(this_worker->worker_index(), &task)) {
+      RunStolenTask(this_worker, &task);
+      continue;
+    }
+
+    // See GetWork for what delete_these_outside_lock is doing. It is declared
+    // outside the lock's scope so that it is always cleared outside the lock.
+    std::vector<Closure> delete_these_outside_lock;
+    AutoLock lock(lock_);
+    if (GetWork(&task, preferred_sequence_token_id,
+                &delete_these_outside_lock)) {
+      TRACE_EVENT_FLOW_END0("task", "SequencedWorkerPool::PostTask",
+          TRACE_ID_MANGLE(GetTaskTraceID(task, static_cast<void*>(this))));
+      TRACE_EVENT2("task", "SequencedWorkerPool::ThreadLoop",
+                   "src_file", task.posted_from.file_name(),
+                   "src_func", task.posted_from.function_name());
+      int new_thread_id = WillRunWorkerTask(task);
+      {
+        AutoUnlock unlock(lock_);
+        SignalHasWork();
+        delete_these_outside_lock.clear();
+        if (new_thread_id)
+          FinishStartingAdditionalThread(new_thread_id);
+        RunTaskOnWorker(this_worker, &task);
+      }
+      DidRunWorkerTask(task);  // Must be done inside the lock.
+      preferred_sequence_token_id = task.sequence_token_id;
+      continue;
+    }
+    preferred_sequence_token_id = 0;
+
+    // Announce that we're about to wait before checking for stealable work
+    // one last time. PostStealableTask increments the count before reading
+    // |idle_worker_count_|, so either we see its task here or it sees us and
+    // signals |has_work_cv_| under the lock.
+    subtle::Barrier_AtomicIncrement(&idle_worker_count_, 1);
+    if (subtle::NoBarrier_Load(&stealable_task_count_) > 0) {
+      subtle::NoBarrier_AtomicIncrement(&idle_worker_count_, -1);
+      continue;
+    }
+    if (shutdown_called_) {
+      subtle::NoBarrier_AtomicIncrement(&idle_worker_count_, -1);
+      break;
+    }
+    waiting_thread_count_++;
+    if (IsIdle())
+      is_idle_cv_.Signal();
+    has_work_cv_.Wait();
+    waiting_thread_count_--;
+    subtle::NoBarrier_AtomicIncrement(&idle_worker_count_, -1);
+  }
+
+  // Wake up the next worker so it knows it should exit as well.
+  SignalHasWork();
+
+  // Possibly unblock shutdown.
+  can_shutdown_cv_.Signal();
+}
+
+void SequencedWorkerPool::Inner::RunTaskOnWorker(Worker* this_worker,
+                                                 SequencedTask* task) {
+  this_worker->set_running_sequence(SequenceToken(task->sequence_token_id));
+
+  tracked_objects::TrackedTime start_time =
+      tracked_objects::ThreadData::NowForStartOfRun(task->birth_tally);
+
+  task->task.Run();
+
+  tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(*task,
+      start_time,
+      tracked_objects::ThreadData::NowForEndOfRun(task->birth_tally));
+
+  this_worker->set_running_sequence(SequenceToken());
+
+  // Make sure our task is erased outside the lock for the same reason
+  // we do this with delete_these_oustide_lock.
+  task->task = Closure();
+}
+
+bool SequencedWorkerPool::Inner::PostStealableTask(const SequencedTask& task) {
+  // Count the task before checking for shutdown. Shutdown() sets the flag
+  // before checking the counts, so either we see the flag and back out, or
+  // Shutdown() waits for this task.
+  if (task.shutdown_behavior == BLOCK_SHUTDOWN)
+    subtle::Barrier_AtomicIncrement(&blocking_shutdown_stealable_count_, 1);
+  subtle::Barrier_AtomicIncrement(&stealable_task_count_, 1);
+  if (subtle::Acquire_Load(&shutdown_flag_)) {
+    subtle::Barrier_AtomicIncrement(&stealable_task_count_, -1);
+    if (task.shutdown_behavior == BLOCK_SHUTDOWN) {
+      subtle::Barrier_AtomicIncrement(&blocking_shutdown_stealable_count_, -1);
+      AutoLock lock(lock_);
+      can_shutdown_cv_.Signal();
+    }
+    return false;
+  }
+
+  SequencedTask queued(task);
+  queued.trace_id = subtle::NoBarrier_AtomicIncrement(&trace_id_, 1) - 1;
+  TRACE_EVENT_FLOW_BEGIN0("task", "SequencedWorkerPool::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(queued, static_cast<void*>(this))));
+
+  subtle::Atomic32 index =
+      subtle::NoBarrier_AtomicIncrement(&next_stealing_queue_, 1);
+  StealingQueue* queue = stealing_queues_[
+      static_cast<uint32>(index) % stealing_queues_.size()].get();
+  {
+    AutoLock lock(queue->lock);
+    queue->tasks.push_back(queued);
+  }
+
+  WakeUpWorkerForStealableTask();
+  return true;
+}
+
+bool SequencedWorkerPool::Inner::TakeStealableTask(int worker_index,
+                                                   SequencedTask* task) {
+  if (!subtle::NoBarrier_Load(&stealable_task_count_))
+    return false;
+
+  const size_t queue_count = stealing_queues_.size();
+  for (size_t i = 0; i < queue_count; ++i) {
+    bool own_queue = i == 0;
+    StealingQueue* queue =
+        stealing_queues_[(worker_index + i) % queue_count].get();
+    AutoLock lock(queue->lock);
+    if (queue->tasks.empty())
+      continue;
+    if (own_queue) {
+      *task = queue->tasks.front();
+      queue->tasks.pop_front();
+    } else {
+      *task = queue->tasks.back();
+      queue->tasks.pop_back();
+    }
+    subtle::NoBarrier_AtomicIncrement(&stealable_task_count_, -1);
+    return true;
+  }
+  return false;
+}
+
+void SequencedWorkerPool::Inner::RunStolenTask(Worker* this_worker,
+                                               SequencedTask* task) {
+  // Move the task from "pending" to "running" before checking for shutdown,
+  // so that there is no window in which Shutdown() can see neither.
+  bool blocks_shutdown_while_running =
+      task->shutdown_behavior != CONTINUE_ON_SHUTDOWN;
+  if (blocks_shutdown_while_running) {
+    subtle::Barrier_AtomicIncrement(
+        &blocking_shutdown_stolen_running_count_, 1);
+  }
+  if (task->shutdown_behavior == BLOCK_SHUTDOWN)
+    subtle::Barrier_AtomicIncrement(&blocking_shutdown_stealable_count_, -1);
+
+  // Same rules as GetWork: once shutdown has started, only BLOCK_SHUTDOWN
+  // tasks still run.
+  if (task->shutdown_behavior == BLOCK_SHUTDOWN ||
+      !subtle::Acquire_Load(&shutdown_flag_)) {
+    TRACE_EVENT_FLOW_END0("task", "SequencedWorkerPool::PostTask",
+        TRACE_ID_MANGLE(GetTaskTraceID(*task, static_cast<void*>(this))));
+    TRACE_EVENT2("task", "SequencedWorkerPool::ThreadLoop",
+                 "src_file", task->posted_from.file_name(),
+                 "src_func", task->posted_from.function_name());
+    // There may be more work available, so get another worker going.
+    if (subtle::NoBarrier_Load(&stealable_task_count_) > 0)
+      WakeUpWorkerForStealableTask();
+    RunTaskOnWorker(this_worker, task);
+  }
+  task->task = Closure();
+
+  if (blocks_shutdown_while_running) {
+    subtle::Barrier_AtomicIncrement(
+        &blocking_shutdown_stolen_running_count_, -1);
+    if (subtle::Acquire_Load(&shutdown_flag_)) {
+      AutoLock lock(lock_);
+      can_shutdown_cv_.Signal();
+    }
+  }
+}
+
+void SequencedWorkerPool::Inner::WakeUpWorkerForStealableTask() {
+  if (subtle::Acquire_Load(&idle_worker_count_) > 0) {
+    // Signal under the lock so that the waiter can't miss it; see
+    // WorkStealingThreadLoop.
+    AutoLock lock(lock_);
+    SignalHasWork();
+    return;
+  }
+  if (subtle::Acquire_Load(&all_workers_created_))
+    return;
+
+  int create_thread_id = 0;
+  {
+    AutoLock lock(lock_);
+    create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+  }
+  if (create_thread_id)
+    FinishStartingAdditionalThread(create_thread_id);
+}
+
 bool SequencedWorkerPool::Inner::IsIdle() const {
   lock_.AssertAcquired();
-  return pending_task_count_ == 0 && waiting_thread_count_ == threads_.size();
+  return pending_task_count_ == 0 &&
+      subtle::NoBarrier_Load(&stealable_task_count_) == 0 &&
+      waiting_thread_count_ == threads_.size();
 }
 
 int SequencedWorkerPool::Inner::LockedGetNamedTokenID(
@@ -714,6 +1034,7 @@ int SequencedWorkerPool::Inner::LockedGetNamedTokenID(
 
 bool SequencedWorkerPool::Inner::GetWork(
     SequencedTask* task,
+    int preferred_sequence_token_id,
     std::vector<Closure>* delete_these_outside_lock) {
   lock_.AssertAcquired();
 
@@ -721,6 +1042,24 @@ bool SequencedWorkerPool::Inner::GetWork(
   UMA_HISTOGRAM_COUNTS_100("SequencedWorkerPool.TaskCount",
                            static_cast<int>(pending_task_count_));
 
+  // Keep the preferred sequence on this worker unless another worker picked
+  // it up while the lock was released. During shutdown, fall through to the
+  // scan below so that the usual deletion rules apply.
+  if (preferred_sequence_token_id && !shutdown_called_ &&
+      IsSequenceTokenRunnable(preferred_sequence_token_id)) {
+    for (std::list<SequencedTask>::iterator i = pending_tasks_.begin();
+         i != pending_tasks_.end(); ++i) {
+      if (i->sequence_token_id != preferred_sequence_token_id)
+        continue;
+      *task = *i;
+      pending_tasks_.erase(i);
+      pending_task_count_--;
+      if (task->shutdown_behavior == BLOCK_SHUTDOWN)
+        blocking_shutdown_pending_task_count_--;
+      return true;
+    }
+  }
+
   // Find the next task with a sequence token that's not currently in use.
   // If the token is in use, that means another thread is running something
   // in that sequence, and we can't run it without going out-of-order.
@@ -880,6 +1219,11 @@ int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
       !thread_being_created_ &&
       threads_.size() < max_threads_ &&
       waiting_thread_count_ == 0) {
+    // Stealable tasks are always runnable.
+    if (subtle::NoBarrier_Load(&stealable_task_count_) > 0) {
+      thread_being_created_ = true;
+      return static_cast<int>(threads_.size() + 1);
+    }
     // We could use an additional thread if there's work to be done.
     for (std::list<SequencedTask>::iterator i = pending_tasks_.begin();
          i != pending_tasks_.end(); ++i) {
@@ -915,7 +1259,9 @@ bool SequencedWorkerPool::Inner::CanShutdown() const {
   // See PrepareToStartAdditionalThreadIfHelpful for how thread creation works.
   return !thread_being_created_ &&
          blocking_shutdown_thread_count_ == 0 &&
-         blocking_shutdown_pending_task_count_ == 0;
+         blocking_shutdown_pending_task_count_ == 0 &&
+         subtle::Acquire_Load(&blocking_shutdown_stealable_count_) == 0 &&
+         subtle::Acquire_Load(&blocking_shutdown_stolen_running_count_) == 0;
 }
 
 // SequencedWorkerPool --------------------------------------------------------
@@ -925,16 +1271,29 @@ SequencedWorkerPool::SequencedWorkerPool(
     const std::string& thread_name_prefix)
     : constructor_message_loop_(MessageLoopProxy::current()),
       inner_(new Inner(ALLOW_THIS_IN_INITIALIZER_LIST(this),
-                       max_threads, thread_name_prefix, NULL)) {
+                       max_threads, thread_name_prefix, CENTRAL_QUEUE,
+                       NULL)) {
+}
+
+SequencedWorkerPool::SequencedWorkerPool(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    TestingObserver* observer)
+    : constructor_message_loop_(MessageLoopProxy::current()),
+      inner_(new Inner(ALLOW_THIS_IN_INITIALIZER_LIST(this),
+                       max_threads, thread_name_prefix, CENTRAL_QUEUE,
+                       observer)) {
 }
 
 SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode scheduling_mode,
     TestingObserver* observer)
     : constructor_message_loop_(MessageLoopProxy::current()),
       inner_(new Inner(ALLOW_THIS_IN_INITIALIZER_LIST(this),
-                       max_threads, thread_name_prefix, observer)) {
+                       max_threads, thread_name_prefix, scheduling_mode,
+                       observer)) {
 }
 
 SequencedWorkerPool::~SequencedWorkerPool() {}
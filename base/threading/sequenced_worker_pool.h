@@ -106,6 +106,21 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
     BLOCK_SHUTDOWN,
   };
 
+  // Defines how worker threads find the next task to run.
+  enum SchedulingMode {
+    // Every task waits in a single list guarded by the pool's lock. Workers
+    // scan the list for the first task whose sequence is not already
+    // running.
+    CENTRAL_QUEUE,
+    // Unsequenced tasks are spread over per-worker queues, each with its own
+    // lock, and idle workers steal from the queues of busy ones. Sequenced
+    // tasks still go through the central list, but a worker that finishes a
+    // task keeps running that sequence while it has pending tasks rather than
+    // handing it to another thread. This avoids serializing on the pool's
+    // lock when many threads run short, unsequenced tasks.
+    WORK_STEALING,
+  };
+
   // Opaque identifier that defines sequencing of tasks posted to the worker
   // pool.
   class SequenceToken {
@@ -149,6 +164,13 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
                       const std::string& thread_name_prefix,
                       TestingObserver* observer);
 
+  // Like above, but with an explicit |scheduling_mode|. |observer| may be
+  // NULL.
+  SequencedWorkerPool(size_t max_threads,
+                      const std::string& thread_name_prefix,
+                      SchedulingMode scheduling_mode,
+                      TestingObserver* observer);
+
   // Returns a unique token that can be used to sequence tasks posted to
   // PostSequencedWorkerTask(). Valid tokens are alwys nonzero.
   SequenceToken GetSequenceToken();
@@ -0,0 +1,61 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kNumTasks = 20000;
+const size_t kNumWorkerThreads = 32;
+
+// Simulates a short blocking file operation.
+void ShortTask() {
+  PlatformThread::YieldCurrentThread();
+}
+
+void RunThroughputBenchmark(SequencedWorkerPool::SchedulingMode mode,
+                            int sequenced_percent) {
+  MessageLoop message_loop;
+  scoped_refptr<SequencedWorkerPool> pool(new SequencedWorkerPool(
+      kNumWorkerThreads, "Perf", mode, NULL));
+  SequencedWorkerPool::SequenceToken token = pool->GetSequenceToken();
+
+  std::string name = StringPrintf(
+      "SequencedWorkerPool_%s_%dpct_sequenced",
+      mode == SequencedWorkerPool::WORK_STEALING ? "stealing" : "central",
+      sequenced_percent);
+  PerfTimeLogger timer(name.c_str());
+  for (int i = 0; i < kNumTasks; ++i) {
+    if (i % 100 < sequenced_percent)
+      pool->PostSequencedWorkerTask(token, FROM_HERE, Bind(&ShortTask));
+    else
+      pool->PostWorkerTask(FROM_HERE, Bind(&ShortTask));
+  }
+  pool->FlushForTesting();
+  timer.Done();
+
+  pool->Shutdown();
+}
+
+}  // namespace
+
+TEST(SequencedWorkerPoolPerfTest, CentralQueue) {
+  RunThroughputBenchmark(SequencedWorkerPool::CENTRAL_QUEUE, 0);
+  RunThroughputBenchmark(SequencedWorkerPool::CENTRAL_QUEUE, 10);
+}
+
+TEST(SequencedWorkerPoolPerfTest, WorkStealing) {
+  RunThroughputBenchmark(SequencedWorkerPool::WORK_STEALING, 0);
+  RunThroughputBenchmark(SequencedWorkerPool::WORK_STEALING, 10);
+}
+
+}  // namespace base
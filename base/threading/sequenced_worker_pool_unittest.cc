@@ -160,6 +160,14 @@ class SequencedWorkerPoolTest : public testing::Test {
 
   virtual ~SequencedWorkerPoolTest() {}
 
+ protected:
+  explicit SequencedWorkerPoolTest(
+      SequencedWorkerPool::SchedulingMode scheduling_mode)
+      : pool_owner_(kNumWorkerThreads, "test", scheduling_mode),
+        tracker_(new TestTracker) {
+  }
+
+ public:
   virtual void SetUp() OVERRIDE {}
 
   virtual void TearDown() OVERRIDE {
@@ -624,6 +632,128 @@ TEST_F(SequencedWorkerPoolTest, IsRunningOnCurrentThread) {
   unused_pool->Shutdown();
 }
 
+// Runs the tests below against a pool in WORK_STEALING mode.
+class SequencedWorkerPoolWorkStealingTest : public SequencedWorkerPoolTest {
+ public:
+  SequencedWorkerPoolWorkStealingTest()
+      : SequencedWorkerPoolTest(SequencedWorkerPool::WORK_STEALING) {}
+};
+
+// Tests that posting many more unsequenced tasks than there are workers runs
+// them all when workers steal from each other.
+TEST_F(SequencedWorkerPoolWorkStealingTest, LotsOfTasks) {
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::SlowTask, tracker(), 0));
+
+  const size_t kNumTasks = 100;
+  for (size_t i = 1; i < kNumTasks; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(), i));
+  }
+
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(kNumTasks);
+  EXPECT_EQ(kNumTasks, result.size());
+}
+
+// Tests that sequenced tasks still run in order while unsequenced tasks are
+// being stolen around them.
+TEST_F(SequencedWorkerPoolWorkStealingTest, SequenceOrder) {
+  EnsureAllWorkersCreated();
+
+  SequencedWorkerPool::SequenceToken token = pool()->GetSequenceToken();
+  const int kNumSequenced = 50;
+  const int kNumUnsequenced = 50;
+  for (int i = 0; i < kNumSequenced; i++) {
+    pool()->PostSequencedWorkerTask(
+        token, FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), i));
+    pool()->PostWorkerTask(
+        FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), -1));
+  }
+
+  std::vector<int> result =
+      tracker()->WaitUntilTasksComplete(kNumSequenced + kNumUnsequenced);
+  ASSERT_EQ(static_cast<size_t>(kNumSequenced + kNumUnsequenced),
+            result.size());
+  int expected = 0;
+  for (size_t i = 0; i < result.size(); i++) {
+    if (result[i] == -1)
+      continue;
+    EXPECT_EQ(expected, result[i]);
+    expected++;
+  }
+  EXPECT_EQ(kNumSequenced, expected);
+}
+
+// Tests that stolen tasks obey the same shutdown rules as the central queue.
+TEST_F(SequencedWorkerPoolWorkStealingTest, DiscardOnShutdown) {
+  EnsureAllWorkersCreated();
+  ThreadBlocker blocker;
+  for (size_t i = 0; i < kNumWorkerThreads; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::BlockTask,
+                                      tracker(), i, &blocker));
+  }
+  tracker()->WaitUntilTasksBlocked(kNumWorkerThreads);
+
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 100),
+      SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 101),
+      SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 102),
+      SequencedWorkerPool::BLOCK_SHUTDOWN);
+
+  SetWillWaitForShutdownCallback(
+      base::Bind(&EnsureTasksToCompleteCountAndUnblock,
+                 scoped_refptr<TestTracker>(tracker()), 0,
+                 &blocker, kNumWorkerThreads));
+  pool()->Shutdown();
+
+  std::vector<int> result =
+      tracker()->WaitUntilTasksComplete(kNumWorkerThreads + 1);
+  ASSERT_EQ(kNumWorkerThreads + 1, result.size());
+  for (size_t i = 0; i < kNumWorkerThreads; i++) {
+    EXPECT_TRUE(std::find(result.begin(), result.end(), static_cast<int>(i)) !=
+                result.end());
+  }
+  EXPECT_TRUE(std::find(result.begin(), result.end(), 102) != result.end());
+
+  // No further tasks should be allowed.
+  EXPECT_FALSE(pool()->PostWorkerTask(
+      FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), 103)));
+}
+
+// Verify IsRunningSequenceOnCurrentThread with stolen and pinned tasks.
+TEST_F(SequencedWorkerPoolWorkStealingTest, IsRunningOnCurrentThread) {
+  SequencedWorkerPool::SequenceToken token1 = pool()->GetSequenceToken();
+  SequencedWorkerPool::SequenceToken token2 = pool()->GetSequenceToken();
+  SequencedWorkerPool::SequenceToken unsequenced_token;
+
+  scoped_refptr<SequencedWorkerPool> unused_pool =
+      new SequencedWorkerPool(2, "unused_pool",
+                              SequencedWorkerPool::WORK_STEALING, NULL);
+
+  pool()->PostSequencedWorkerTask(
+      token1, FROM_HERE,
+      base::Bind(&IsRunningOnCurrentThreadTask,
+                 token1, token2, pool(), unused_pool));
+  pool()->PostSequencedWorkerTask(
+      token1, FROM_HERE,
+      base::Bind(&IsRunningOnCurrentThreadTask,
+                 token1, token2, pool(), unused_pool));
+  pool()->PostWorkerTask(
+      FROM_HERE,
+      base::Bind(&IsRunningOnCurrentThreadTask,
+                 unsequenced_token, token1, pool(), unused_pool));
+  pool()->Shutdown();
+  unused_pool->Shutdown();
+}
+
 class SequencedWorkerPoolTaskRunnerTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerTestDelegate() {}
@@ -660,6 +790,42 @@ INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPool, TaskRunnerTest,
     SequencedWorkerPoolTaskRunnerTestDelegate);
 
+class SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate {
+ public:
+  SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate() {}
+
+  ~SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate() {}
+
+  void StartTaskRunner() {
+    pool_owner_.reset(new SequencedWorkerPoolOwner(
+        10, "SequencedWorkerPoolWorkStealingTaskRunnerTest",
+        SequencedWorkerPool::WORK_STEALING));
+  }
+
+  scoped_refptr<SequencedWorkerPool> GetTaskRunner() {
+    return pool_owner_->pool();
+  }
+
+  void StopTaskRunner() {
+    pool_owner_->pool()->FlushForTesting();
+    pool_owner_->pool()->Shutdown();
+    // Don't reset |pool_owner_| here, as the test may still hold a
+    // reference to the pool.
+  }
+
+  bool TaskRunnerHandlesNonZeroDelays() const {
+    return false;
+  }
+
+ private:
+  MessageLoop message_loop_;
+  scoped_ptr<SequencedWorkerPoolOwner> pool_owner_;
+};
+
+INSTANTIATE_TYPED_TEST_CASE_P(
+    SequencedWorkerPoolWorkStealing, TaskRunnerTest,
+    SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate);
+
 class SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate() {}
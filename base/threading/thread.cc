@@ -148,7 +148,8 @@ bool Thread::GetThreadWasQuitProperly() {
 void Thread::ThreadMain() {
   {
     // The message loop for this thread.
-    MessageLoop message_loop(startup_data_->options.message_loop_type);
+    MessageLoop message_loop(startup_data_->options.message_loop_type,
+                             startup_data_->options.incoming_queue_type);
 
     // Complete the initialization of our Thread object.
     thread_id_ = PlatformThread::CurrentId();
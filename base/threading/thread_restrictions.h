@@ -51,6 +51,9 @@ namespace disk_cache {
 class BackendImpl;
 class InFlightIO;
 }
+namespace extensions {
+class InstalledLoader;
+}
 namespace media {
 class AudioOutputController;
 }
@@ -182,6 +185,7 @@ class BASE_EXPORT ThreadRestrictions {
   friend class dbus::Bus;                         // http://crbug.com/125222
   friend class disk_cache::BackendImpl;           // http://crbug.com/74623
   friend class disk_cache::InFlightIO;            // http://crbug.com/74623
+  friend class extensions::InstalledLoader;       // http://crbug.com/37548
   friend class media::AudioOutputController;      // http://crbug.com/120973
   friend class net::FileStreamPosix;              // http://crbug.com/115067
   friend class net::FileStreamWin;                // http://crbug.com/115067
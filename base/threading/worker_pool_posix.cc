@@ -102,7 +102,8 @@ void WorkerThread::ThreadMain() {
 
     tracked_objects::ThreadData::TallyRunOnWorkerThreadIfTracking(
         pending_task.birth_tally, TrackedTime(pending_task.time_posted),
-        start_time, tracked_objects::ThreadData::NowForEndOfRun());
+        start_time,
+        tracked_objects::ThreadData::NowForEndOfRun(pending_task.birth_tally));
   }
 
   // The WorkerThread is non-joinable, so it deletes itself.
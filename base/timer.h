@@ -106,6 +106,13 @@ class BASE_EXPORT Timer {
   // the timer is not running, this will start it by posting a task.
   void Reset();
 
+  // Allows the task to run up to |leeway| after its delay has elapsed, so the
+  // MessageLoop can run it together with other timers instead of waking up
+  // just for it.  Takes effect the next time the task is posted.  Zero, the
+  // default, runs the task as close to its delay as the MessageLoop can.
+  void set_leeway(TimeDelta leeway) { leeway_ = leeway; }
+  TimeDelta leeway() const { return leeway_; }
+
   const base::Closure& user_task() const { return user_task_; }
   const TimeTicks& desired_run_time() const { return desired_run_time_; }
 
@@ -145,6 +152,8 @@ class BASE_EXPORT Timer {
   tracked_objects::Location posted_from_;
   // Delay requested by user.
   TimeDelta delay_;
+  // How late the user allows the task to run. See set_leeway().
+  TimeDelta leeway_;
   // user_task_ is what the user wants to be run at desired_run_time_.
   base::Closure user_task_;
 
@@ -8,6 +8,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 
 using base::TimeDelta;
+using base::TimeTicks;
 
 namespace {
 
@@ -470,6 +471,35 @@ TEST(TimerTest, ContinuationStopStart) {
   }
 }
 
+void CountCallbacks(int* count) {
+  if (++(*count) == 2)
+    MessageLoop::current()->Quit();
+}
+
+TEST(TimerTest, Leeway) {
+  MessageLoop loop(MessageLoop::TYPE_DEFAULT);
+  const TimeDelta kLeeway = TimeDelta::FromMilliseconds(500);
+  base::Timer timer1(false, false);
+  base::Timer timer2(false, false);
+  EXPECT_EQ(TimeDelta(), timer1.leeway());
+  timer1.set_leeway(kLeeway);
+  timer2.set_leeway(kLeeway);
+  EXPECT_EQ(kLeeway, timer1.leeway());
+
+  int count = 0;
+  TimeTicks start = TimeTicks::Now();
+  timer1.Start(FROM_HERE, TimeDelta::FromMilliseconds(10),
+               base::Bind(&CountCallbacks, &count));
+  timer2.Start(FROM_HERE, TimeDelta::FromMilliseconds(12),
+               base::Bind(&CountCallbacks, &count));
+  MessageLoop::current()->Run();
+
+  EXPECT_EQ(2, count);
+  EXPECT_LE(TimeDelta::FromMilliseconds(12), TimeTicks::Now() - start);
+  // The two timers share a wakeup unless they straddle an alignment window.
+  EXPECT_GE(2, loop.delayed_wakeup_count());
+}
+
 TEST(TimerTest, ContinuationReset) {
   {
     ClearAllCallbackHappened();
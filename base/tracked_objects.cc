@@ -7,6 +7,8 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "base/format_macros.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/process_util.h"
@@ -74,9 +76,17 @@ DeathData::DeathData(int count) {
 void DeathData::RecordDeath(const int32 queue_duration,
                             const int32 run_duration,
                             int32 random_number) {
-  ++count_;
-  queue_duration_sum_ += queue_duration;
-  run_duration_sum_ += run_duration;
+  RecordDeaths(1, queue_duration, run_duration, random_number);
+}
+
+void DeathData::RecordDeaths(int count,
+                             const int32 queue_duration,
+                             const int32 run_duration,
+                             int32 random_number) {
+  DCHECK_GT(count, 0);
+  count_ += count;
+  queue_duration_sum_ += queue_duration * count;
+  run_duration_sum_ += run_duration * count;
 
   if (queue_duration_max_ < queue_duration)
     queue_duration_max_ = queue_duration;
@@ -84,17 +94,19 @@ void DeathData::RecordDeath(const int32 queue_duration,
     run_duration_max_ = run_duration;
 
   // Take a uniformly distributed sample over all durations ever supplied.
-  // The probability that we (instead) use this new sample is 1/count_.  This
-  // results in a completely uniform selection of the sample (at least when we
-  // don't clamp count_... but that should be inconsequentially likely).
+  // The probability that we (instead) use this new sample is count/count_.
+  // This results in a completely uniform selection of the sample (at least
+  // when we don't clamp count_... but that should be inconsequentially likely).
   // We ignore the fact that we correlated our selection of a sample to the run
   // and queue times (i.e., we used them to generate random_number).
   if (count_ <= 0) {  // Handle wrapping of count_, such as in bug 138961.
-    CHECK_GE(count_ - 1, 0);  // Detect memory corruption.
+    CHECK_GE(count_ - count, 0);  // Detect memory corruption.
     // We'll just clamp at INT_MAX, but we should note this in the UI as such.
     count_ = INT_MAX;
   }
-  if (0 == (random_number % count_)) {
+  if (count == 1 ? 0 == (random_number % count_) :
+      static_cast<uint32>(random_number) % count_ <
+          static_cast<uint32>(count)) {
     queue_duration_sample_ = queue_duration;
     run_duration_sample_ = run_duration;
   }
@@ -191,6 +203,8 @@ int Births::birth_count() const { return birth_count_; }
 
 void Births::RecordBirth() { ++birth_count_; }
 
+void Births::RecordBirths(int count) { birth_count_ += count; }
+
 void Births::ForgetBirth() { --birth_count_; }
 
 void Births::Clear() { birth_count_ = 0; }
@@ -234,10 +248,14 @@ base::LazyInstance<base::Lock>::Leaky
 // static
 ThreadData::Status ThreadData::status_ = ThreadData::UNINITIALIZED;
 
+// static
+int ThreadData::sampling_interval_ = 1;
+
 ThreadData::ThreadData(const std::string& suggested_name)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(0),
+      births_until_sample_(0),
       incarnation_count_for_pool_(-1) {
   DCHECK_GE(suggested_name.size(), 0u);
   thread_name_ = suggested_name;
@@ -248,6 +266,7 @@ ThreadData::ThreadData(int thread_number)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(thread_number),
+      births_until_sample_(0),
       incarnation_count_for_pool_(-1)  {
   CHECK_GT(thread_number, 0);
   base::StringAppendF(&thread_name_, "WorkerThread-%d", thread_number);
@@ -371,14 +390,31 @@ void ThreadData::Snapshot(bool reset_max, ProcessDataSnapshot* process_data) {
   }
 }
 
+bool ThreadData::ShouldSampleBirth() {
+  if (--births_until_sample_ > 0)
+    return false;
+  // Space the tallied births a random distance apart, uniformly distributed
+  // over [1, 2 * interval - 1], so that tasks that are posted in a repeating
+  // pattern can't stay in step with the sampling.
+  uint32 random = static_cast<uint32>(random_number_) * 1103515245u + 12345u;
+  random_number_ = static_cast<int32>(random);
+  int interval = sampling_interval_;
+  births_until_sample_ = 1 + static_cast<int>(
+      (random >> 8) % static_cast<uint32>(2 * interval - 1));
+  return true;
+}
+
 Births* ThreadData::TallyABirth(const Location& location) {
+  // Read the interval once, as it may change on another thread.
+  int count = sampling_interval_;
   BirthMap::iterator it = birth_map_.find(location);
   Births* child;
   if (it != birth_map_.end()) {
     child =  it->second;
-    child->RecordBirth();
+    child->RecordBirths(count);
   } else {
     child = new Births(location, *this);  // Leak this.
+    child->RecordBirths(count - 1);  // The constructor counted one birth.
     // Lock since the map may get relocated now, and other threads sometimes
     // snapshot it (but they lock before copying it).
     base::AutoLock lock(map_lock_);
@@ -423,7 +459,8 @@ void ThreadData::TallyADeath(const Births& birth,
     base::AutoLock lock(map_lock_);  // Lock as the map may get relocated now.
     death_data = &death_map_[&birth];
   }  // Release lock ASAP.
-  death_data->RecordDeath(queue_duration, run_duration, random_number_);
+  death_data->RecordDeaths(sampling_interval_, queue_duration, run_duration,
+                           random_number_);
 
   if (!kTrackParentChildLinks)
     return;
@@ -443,6 +480,8 @@ Births* ThreadData::TallyABirthIfActive(const Location& location) {
   ThreadData* current_thread_data = Get();
   if (!current_thread_data)
     return NULL;
+  if (sampling_interval_ > 1 && !current_thread_data->ShouldSampleBirth())
+    return NULL;
   return current_thread_data->TallyABirth(location);
 }
 
@@ -736,9 +775,22 @@ bool ThreadData::TrackingParentChildStatus() {
   return status_ >= PROFILING_CHILDREN_ACTIVE;
 }
 
+// static
+void ThreadData::SetSamplingInterval(int interval) {
+  DCHECK_GE(interval, 1);
+  sampling_interval_ = std::max(interval, 1);
+}
+
+// static
+int ThreadData::sampling_interval() {
+  return sampling_interval_;
+}
+
 // static
 TrackedTime ThreadData::NowForStartOfRun(const Births* parent) {
-  if (kTrackParentChildLinks && parent && status_ > PROFILING_ACTIVE) {
+  if (!parent)
+    return TrackedTime();  // The run won't be tallied.
+  if (kTrackParentChildLinks && status_ > PROFILING_ACTIVE) {
     ThreadData* current_thread_data = Get();
     if (current_thread_data)
       current_thread_data->parent_stack_.push(parent);
@@ -747,7 +799,9 @@ TrackedTime ThreadData::NowForStartOfRun(const Births* parent) {
 }
 
 // static
-TrackedTime ThreadData::NowForEndOfRun() {
+TrackedTime ThreadData::NowForEndOfRun(const Births* birth) {
+  if (!birth)
+    return TrackedTime();  // The run won't be tallied.
   return Now();
 }
 
@@ -804,6 +858,7 @@ void ThreadData::ShutdownSingleThreadedCleanup(bool leak) {
   // Put most global static back in pristine shape.
   worker_thread_data_creation_count_ = 0;
   cleanup_count_ = 0;
+  sampling_interval_ = 1;
   tls_index_.Set(NULL);
   status_ = DORMANT_DURING_TESTS;  // Almost UNINITIALIZED.
 
@@ -237,6 +237,10 @@ class BASE_EXPORT Births: public BirthOnThread {
   // When we have a birth we update the count for this birthplace.
   void RecordBirth();
 
+  // When a sampled birth stands for |count| births (see
+  // ThreadData::SetSamplingInterval()), we add all of them.
+  void RecordBirths(int count);
+
   // When a birthplace is changed (updated), we need to decrement the counter
   // for the old instance.
   void ForgetBirth();
@@ -272,6 +276,14 @@ class BASE_EXPORT DeathData {
                    const int32 run_duration,
                    int random_number);
 
+  // Update stats for |count| task destructions, when one task that had the
+  // given durations was sampled to stand for all of them (see
+  // ThreadData::SetSamplingInterval()).
+  void RecordDeaths(int count,
+                    const int32 queue_duration,
+                    const int32 run_duration,
+                    int random_number);
+
   // Metrics accessors, used only for serialization and in tests.
   int count() const;
   int32 run_duration_sum() const;
@@ -456,14 +468,28 @@ class BASE_EXPORT ThreadData {
   // on.  This is currently a compiled option, atop TrackingStatus().
   static bool TrackingParentChildStatus();
 
+  // Tallies only about one in |interval| births on each thread (and the deaths
+  // of those tasks), which takes nearly all the cost of profiling off of the
+  // tasks that are skipped.  Each tallied birth and death is counted
+  // |interval| times, so that snapshotted counts and duration sums estimate
+  // the totals for all tasks.  Max values and samples come from the tallied
+  // tasks alone.  An |interval| of 1 (the default) tallies every task.
+  // Tasks that are in flight while the interval changes are counted with the
+  // interval that is current at their birth and at their death, so their
+  // Still_Alive counts may be off until the data is reset.
+  static void SetSamplingInterval(int interval);
+  static int sampling_interval();
+
   // Special versions of Now() for getting times at start and end of a tracked
   // run.  They are super fast when tracking is disabled, and have some internal
   // side effects when we are tracking, so that we can deduce the amount of time
   // accumulated outside of execution of tracked runs.
-  // The task that will be tracked is passed in as |parent| so that parent-child
-  // relationships can be (optionally) calculated.
+  // The task that will be tracked is passed in as |parent| (or |birth|) so
+  // that parent-child relationships can be (optionally) calculated.  When it
+  // is NULL, because its birth was not tallied, no time is taken and the null
+  // time is returned.
   static TrackedTime NowForStartOfRun(const Births* parent);
-  static TrackedTime NowForEndOfRun();
+  static TrackedTime NowForEndOfRun(const Births* birth);
 
   // Provide a time function that does nothing (runs fast) when we don't have
   // the profiler enabled.  It will generally be optimized away when it is
@@ -515,6 +541,10 @@ class BASE_EXPORT ThreadData {
   ThreadData* next() const;
 
 
+  // Returns true if the next birth on this thread is to be tallied, when only
+  // one in sampling_interval_ births is.
+  bool ShouldSampleBirth();
+
   // In this thread's data, record a new birth.
   Births* TallyABirth(const Location& location);
 
@@ -615,6 +645,10 @@ class BASE_EXPORT ThreadData {
   // We set status_ to SHUTDOWN when we shut down the tracking service.
   static Status status_;
 
+  // One in this many births (on average) is tallied.  See
+  // SetSamplingInterval().
+  static int sampling_interval_;
+
   // Link to next instance (null terminated list). Used to globally track all
   // registered instances (corresponds to all registered threads where we keep
   // data).
@@ -676,6 +710,11 @@ class BASE_EXPORT ThreadData {
   // we stir in more and more as we go.
   int32 random_number_;
 
+  // The number of births to skip, including the next one, before a birth on
+  // this thread is tallied again.  Only used when sampling_interval_ is more
+  // than 1.
+  int births_until_sample_;
+
   // Record of what the incarnation_counter_ was when this instance was created.
   // If the incarnation_counter_ has changed, then we avoid pushing into the
   // pool (this is only critical in tests which go through multiple
@@ -0,0 +1,49 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/tracked_objects.h"
+#include "base/tracking_info.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace tracked_objects {
+
+namespace {
+
+const int kNumTasks = 1000000;
+
+// Goes through the profiler bookkeeping of posting and running a task, the
+// way MessageLoop does, for |kNumTasks| tasks.
+void RunTasks(const char* name) {
+  Location location("RunTasks", "FixedPerfTestFileName", 1, NULL);
+  PerfTimeLogger timer(name);
+  for (int i = 0; i < kNumTasks; ++i) {
+    base::TrackingInfo pending_task(location, base::TimeTicks());
+    TrackedTime start_time =
+        ThreadData::NowForStartOfRun(pending_task.birth_tally);
+    ThreadData::TallyRunOnNamedThreadIfTracking(pending_task, start_time,
+        ThreadData::NowForEndOfRun(pending_task.birth_tally));
+  }
+  timer.Done();
+}
+
+}  // namespace
+
+TEST(TrackedObjectsPerfTest, RunTasks) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(ThreadData::DEACTIVATED))
+    return;
+  RunTasks("Profiler_Deactivated");
+
+  ThreadData::InitializeAndSetTrackingStatus(ThreadData::PROFILING_ACTIVE);
+  const int kSamplingIntervals[] = { 1, 10, 100 };
+  for (size_t i = 0; i < arraysize(kSamplingIntervals); ++i) {
+    ThreadData::SetSamplingInterval(kSamplingIntervals[i]);
+    RunTasks(base::StringPrintf("Profiler_SamplingInterval_%d",
+                                kSamplingIntervals[i]).c_str());
+  }
+  ThreadData::SetSamplingInterval(1);
+}
+
+}  // namespace tracked_objects
@@ -164,7 +164,7 @@ TEST_F(TrackedObjectsTest, TinyStartupShutdown) {
   base::TrackingInfo pending_task(location, kBogusBirthTime);
   TrackedTime start_time(pending_task.time_posted);
   // Finally conclude the outer run.
-  TrackedTime end_time = ThreadData::NowForEndOfRun();
+  TrackedTime end_time = ThreadData::NowForEndOfRun(first_birth);
   ThreadData::TallyRunOnNamedThreadIfTracking(pending_task, start_time,
                                               end_time);
 
@@ -578,4 +578,66 @@ TEST_F(TrackedObjectsTest, DifferentLives) {
   EXPECT_EQ(base::GetCurrentProcId(), process_data.process_id);
 }
 
+TEST_F(TrackedObjectsTest, SampledLifeCycles) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(
+          ThreadData::PROFILING_CHILDREN_ACTIVE))
+    return;
+
+  const int kSamplingInterval = 4;
+  ThreadData::SetSamplingInterval(kSamplingInterval);
+  EXPECT_EQ(kSamplingInterval, ThreadData::sampling_interval());
+
+  const char kFunction[] = "SampledLifeCycles";
+  Location location(kFunction, kFile, kLineNumber, NULL);
+  ThreadData::InitializeThreadContext(kMainThreadName);
+
+  const base::TimeTicks kTimePosted = base::TimeTicks() +
+      base::TimeDelta::FromMilliseconds(1);
+  const TrackedTime kStartOfRun = TrackedTime() +
+      Duration::FromMilliseconds(5);
+  const TrackedTime kEndOfRun = TrackedTime() + Duration::FromMilliseconds(7);
+
+  const int kNumTasks = 4000;
+  int num_tallied = 0;
+  for (int i = 0; i < kNumTasks; ++i) {
+    base::TrackingInfo pending_task(location, base::TimeTicks());
+    pending_task.time_posted = kTimePosted;
+    if (!pending_task.birth_tally) {
+      // Skipped tasks take no time.
+      EXPECT_TRUE(ThreadData::NowForStartOfRun(NULL).is_null());
+      EXPECT_TRUE(ThreadData::NowForEndOfRun(NULL).is_null());
+      continue;
+    }
+    ++num_tallied;
+    ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
+        kStartOfRun, kEndOfRun);
+  }
+
+  // Roughly one in four tasks is tallied.
+  EXPECT_GT(num_tallied, kNumTasks / kSamplingInterval * 3 / 4);
+  EXPECT_LT(num_tallied, kNumTasks / kSamplingInterval * 5 / 4);
+
+  // Each tallied task stands for kSamplingInterval tasks, and all of the
+  // births are matched by deaths.
+  ProcessDataSnapshot process_data;
+  ThreadData::Snapshot(false, &process_data);
+  ASSERT_EQ(1u, process_data.tasks.size());
+  const DeathDataSnapshot& death_data = process_data.tasks[0].death_data;
+  EXPECT_EQ(num_tallied * kSamplingInterval, death_data.count);
+  EXPECT_EQ(death_data.count * 2, death_data.run_duration_sum);
+  EXPECT_EQ(2, death_data.run_duration_max);
+  EXPECT_EQ(2, death_data.run_duration_sample);
+  EXPECT_EQ(death_data.count * 4, death_data.queue_duration_sum);
+  EXPECT_EQ(4, death_data.queue_duration_max);
+  EXPECT_EQ(4, death_data.queue_duration_sample);
+  EXPECT_EQ(kMainThreadName, process_data.tasks[0].death_thread_name);
+
+  // Going back to an interval of 1 tallies every task.
+  ThreadData::SetSamplingInterval(1);
+  for (int i = 0; i < 10; ++i) {
+    base::TrackingInfo pending_task(location, base::TimeTicks());
+    EXPECT_TRUE(pending_task.birth_tally);
+  }
+}
+
 }  // namespace tracked_objects
@@ -4,10 +4,31 @@
 
 #include "base/utf_string_conversion_utils.h"
 
+#include "base/cpu.h"
 #include "base/third_party/icu/icu_utf.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 namespace base {
 
+namespace {
+
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+// Rely on function level static initialization to keep the CPU check thread
+// safe.
+bool UseSSE2() {
+  static const bool kUseSSE2 = base::CPU().has_sse2();
+  return kUseSSE2;
+}
+#endif
+
+}  // namespace
+
 // ReadUnicodeCharacter --------------------------------------------------------
 
 bool ReadUnicodeCharacter(const char* src,
@@ -102,6 +123,114 @@ size_t WriteUnicodeCharacter(uint32 code_point, string16* output) {
   return CBU16_MAX_LENGTH;
 }
 
+// ASCII runs ------------------------------------------------------------------
+
+// The vector loops below stop at the first block that holds a non-ASCII
+// character and leave the rest of it to the scalar loop, which finds the
+// exact position.
+
+size_t CountLeadingASCII(const char* src, size_t src_len) {
+  size_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+  if (UseSSE2()) {
+    for (; i + 16 <= src_len; i += 16) {
+      __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      if (_mm_movemask_epi8(chunk))
+        break;
+    }
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  for (; i + 16 <= src_len; i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8*>(src + i));
+    uint8x8_t folded = vorr_u8(vget_low_u8(chunk), vget_high_u8(chunk));
+    if (vget_lane_u64(vreinterpret_u64_u8(folded), 0) &
+        GG_UINT64_C(0x8080808080808080))
+      break;
+  }
+#endif
+  while (i < src_len && static_cast<unsigned char>(src[i]) < 0x80)
+    ++i;
+  return i;
+}
+
+size_t CountLeadingASCII(const char16* src, size_t src_len) {
+  size_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+  if (UseSSE2()) {
+    const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= src_len; i += 16) {
+      __m128i chunk = _mm_or_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8)));
+      __m128i non_ascii = _mm_and_si128(chunk, non_ascii_bits);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) != 0xFFFF)
+        break;
+    }
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  for (; i + 16 <= src_len; i += 16) {
+    uint16x8_t chunk = vorrq_u16(vld1q_u16(src + i), vld1q_u16(src + i + 8));
+    uint16x4_t folded = vorr_u16(vget_low_u16(chunk), vget_high_u16(chunk));
+    if (vget_lane_u64(vreinterpret_u64_u16(folded), 0) &
+        GG_UINT64_C(0xFF80FF80FF80FF80))
+      break;
+  }
+#endif
+  while (i < src_len && src[i] < 0x80)
+    ++i;
+  return i;
+}
+
+void WidenASCII(const char* src, size_t src_len, char16* dest) {
+  size_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+  if (UseSSE2()) {
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= src_len; i += 16) {
+      __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                       _mm_unpacklo_epi8(chunk, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 8),
+                       _mm_unpackhi_epi8(chunk, zero));
+    }
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  for (; i + 16 <= src_len; i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8*>(src + i));
+    vst1q_u16(dest + i, vmovl_u8(vget_low_u8(chunk)));
+    vst1q_u16(dest + i + 8, vmovl_u8(vget_high_u8(chunk)));
+  }
+#endif
+  for (; i < src_len; ++i)
+    dest[i] = src[i];
+}
+
+void NarrowASCII(const char16* src, size_t src_len, char* dest) {
+  size_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+  if (UseSSE2()) {
+    for (; i + 16 <= src_len; i += 16) {
+      __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      __m128i high =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                       _mm_packus_epi16(low, high));
+    }
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  for (; i + 16 <= src_len; i += 16) {
+    uint8x16_t chunk = vcombine_u8(vmovn_u16(vld1q_u16(src + i)),
+                                   vmovn_u16(vld1q_u16(src + i + 8)));
+    vst1q_u8(reinterpret_cast<uint8*>(dest + i), chunk);
+  }
+#endif
+  for (; i < src_len; ++i)
+    dest[i] = static_cast<char>(src[i]);
+}
+
 // Generalized Unicode converter -----------------------------------------------
 
 template<typename CHAR>
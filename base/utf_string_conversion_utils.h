@@ -78,6 +78,19 @@ inline size_t WriteUnicodeCharacter(uint32 code_point, std::wstring* output) {
 }
 #endif  // defined(WCHAR_T_IS_UTF32)
 
+// ASCII runs ------------------------------------------------------------------
+
+// Returns the number of characters at the start of |src| that are ASCII.
+// These examine 16 characters at a time on CPUs with SSE2 or NEON.
+BASE_EXPORT size_t CountLeadingASCII(const char* src, size_t src_len);
+BASE_EXPORT size_t CountLeadingASCII(const char16* src, size_t src_len);
+
+// Copies |src_len| ASCII characters from |src| to |dest|, widening or
+// narrowing each of them. All of |src| must be ASCII (see
+// CountLeadingASCII()).
+BASE_EXPORT void WidenASCII(const char* src, size_t src_len, char16* dest);
+BASE_EXPORT void NarrowASCII(const char16* src, size_t src_len, char* dest);
+
 // Generalized Unicode converter -----------------------------------------------
 
 // Guesses the length of the output in UTF-8 in bytes, clears that output
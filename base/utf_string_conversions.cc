@@ -8,13 +8,50 @@
 #include "base/string_util.h"
 #include "base/utf_string_conversion_utils.h"
 
+using base::CountLeadingASCII;
+using base::NarrowASCII;
 using base::PrepareForUTF8Output;
 using base::PrepareForUTF16Or32Output;
 using base::ReadUnicodeCharacter;
+using base::WidenASCII;
 using base::WriteUnicodeCharacter;
 
 namespace {
 
+// ASCII runs ------------------------------------------------------------------
+
+// Appends the run of ASCII characters at the start of |src| to |output| in
+// bulk and returns its length. Only UTF-8 <-> UTF-16 conversions have a fast
+// path; the others return 0 and are converted a character at a time.
+template<typename SRC_CHAR, typename DEST_STRING>
+size_t AppendLeadingASCII(const SRC_CHAR* src,
+                          size_t src_len,
+                          DEST_STRING* output) {
+  return 0;
+}
+
+size_t AppendLeadingASCII(const char* src, size_t src_len, string16* output) {
+  size_t ascii_len = CountLeadingASCII(src, src_len);
+  if (ascii_len) {
+    size_t offset = output->size();
+    output->resize(offset + ascii_len);
+    WidenASCII(src, ascii_len, &(*output)[offset]);
+  }
+  return ascii_len;
+}
+
+size_t AppendLeadingASCII(const char16* src,
+                          size_t src_len,
+                          std::string* output) {
+  size_t ascii_len = CountLeadingASCII(src, src_len);
+  if (ascii_len) {
+    size_t offset = output->size();
+    output->resize(offset + ascii_len);
+    NarrowASCII(src, ascii_len, &(*output)[offset]);
+  }
+  return ascii_len;
+}
+
 // Generalized Unicode converter -----------------------------------------------
 
 // Converts the given source Unicode character type to the given destination
@@ -29,6 +66,16 @@ bool ConvertUnicode(const SRC_CHAR* src,
   bool success = true;
   int32 src_len32 = static_cast<int32>(src_len);
   for (int32 i = 0; i < src_len32; i++) {
+    // Copy runs of ASCII without decoding them.
+    if (static_cast<uint32>(src[i]) < 0x80) {
+      int32 ascii_len = static_cast<int32>(AppendLeadingASCII(
+          src + i, static_cast<size_t>(src_len32 - i), output));
+      if (ascii_len) {
+        i += ascii_len - 1;
+        continue;
+      }
+    }
+
     uint32 code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
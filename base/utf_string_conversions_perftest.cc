@@ -0,0 +1,108 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/perftimer.h"
+#include "base/string16.h"
+#include "base/string_util.h"
+#include "base/stringprintf.h"
+#include "base/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const int kNumStrings = 20000;
+const int kNumIterations = 20;
+
+// Builds a corpus shaped like the page titles and URLs that history, the
+// omnibox and session restore convert: mostly ASCII URLs, and titles that
+// are ASCII, ASCII with a few accented letters, or mostly CJK.
+std::vector<std::string> MakeCorpus() {
+  std::vector<std::string> corpus;
+  for (int i = 0; i < kNumStrings; ++i) {
+    switch (i % 4) {
+      case 0:
+        corpus.push_back(base::StringPrintf(
+            "http://www.example.com/news/2012/%d/article-%d.html?ref=home",
+            i % 12, i));
+        break;
+      case 1:
+        corpus.push_back(base::StringPrintf(
+            "Breaking news: story number %d - Example News Network", i));
+        break;
+      case 2:
+        // "Café crème à la française" with a counter.
+        corpus.push_back(base::StringPrintf(
+            "Caf\xc3\xa9 cr\xc3\xa8me \xc3\xa0 la fran\xc3\xa7" "aise %d", i));
+        break;
+      case 3:
+        // "网页 图片 资讯更多" with a counter.
+        corpus.push_back(base::StringPrintf(
+            "\xe7\xbd\x91\xe9\xa1\xb5 \xe5\x9b\xbe\xe7\x89\x87 "
+            "\xe8\xb5\x84\xe8\xae\xaf\xe6\x9b\xb4\xe5\xa4\x9a %d", i));
+        break;
+    }
+  }
+  return corpus;
+}
+
+class UTFStringConversionsPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    utf8_corpus_ = MakeCorpus();
+    for (size_t i = 0; i < utf8_corpus_.size(); ++i)
+      utf16_corpus_.push_back(UTF8ToUTF16(utf8_corpus_[i]));
+  }
+
+  std::vector<std::string> utf8_corpus_;
+  std::vector<string16> utf16_corpus_;
+};
+
+}  // namespace
+
+TEST_F(UTFStringConversionsPerfTest, UTF8ToUTF16) {
+  size_t total = 0;
+  PerfTimeLogger timer("UTF8ToUTF16");
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < utf8_corpus_.size(); ++j)
+      total += UTF8ToUTF16(utf8_corpus_[j]).length();
+  }
+  timer.Done();
+  EXPECT_GT(total, 0u);
+}
+
+TEST_F(UTFStringConversionsPerfTest, UTF16ToUTF8) {
+  size_t total = 0;
+  PerfTimeLogger timer("UTF16ToUTF8");
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < utf16_corpus_.size(); ++j)
+      total += UTF16ToUTF8(utf16_corpus_[j]).length();
+  }
+  timer.Done();
+  EXPECT_GT(total, 0u);
+}
+
+TEST_F(UTFStringConversionsPerfTest, IsStringUTF8) {
+  int valid = 0;
+  PerfTimeLogger timer("IsStringUTF8");
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < utf8_corpus_.size(); ++j)
+      valid += IsStringUTF8(utf8_corpus_[j]);
+  }
+  timer.Done();
+  EXPECT_EQ(kNumIterations * kNumStrings, valid);
+}
+
+TEST_F(UTFStringConversionsPerfTest, IsStringASCII) {
+  int ascii = 0;
+  PerfTimeLogger timer("IsStringASCII");
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < utf16_corpus_.size(); ++j)
+      ascii += IsStringASCII(utf16_corpus_[j]);
+  }
+  timer.Done();
+  EXPECT_EQ(kNumIterations * kNumStrings / 2, ascii);
+}
@@ -208,4 +208,50 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+// Places a non-ASCII character at every offset around the 16-character
+// blocks that the ASCII fast paths consume at a time.
+TEST(UTFStringConversionsTest, ConvertLongMixedStrings) {
+  for (size_t length = 1; length < 50; ++length) {
+    for (size_t offset = 0; offset <= length; ++offset) {
+      string16 utf16(length, 'a');
+      std::string utf8(length, 'a');
+      if (offset < length) {
+        // U+00E9 LATIN SMALL LETTER E WITH ACUTE.
+        utf16[offset] = 0xe9;
+        utf8.replace(offset, 1, "\xc3\xa9");
+      }
+      EXPECT_EQ(utf8, UTF16ToUTF8(utf16));
+      EXPECT_EQ(utf16, UTF8ToUTF16(utf8));
+      EXPECT_EQ(offset == length, IsStringASCII(utf8));
+      EXPECT_EQ(offset == length, IsStringASCII(utf16));
+      EXPECT_TRUE(IsStringUTF8(utf8));
+    }
+  }
+}
+
+TEST(UTFStringConversionsTest, ConvertLongInvalidStrings) {
+  const std::string prefix(37, 'x');
+  string16 expected = ASCIIToUTF16(prefix);
+  expected.push_back(0xfffd);
+  expected += ASCIIToUTF16(prefix);
+
+  // A lone continuation byte and a truncated sequence inside ASCII runs.
+  string16 converted;
+  EXPECT_FALSE(UTF8ToUTF16((prefix + "\x80" + prefix).data(),
+                           prefix.length() * 2 + 1, &converted));
+  EXPECT_EQ(expected, converted);
+  EXPECT_FALSE(UTF8ToUTF16((prefix + "\xe4\xbd" + prefix).data(),
+                           prefix.length() * 2 + 2, &converted));
+  EXPECT_EQ(expected, converted);
+  EXPECT_FALSE(IsStringUTF8(prefix + "\xe4\xbd" + prefix));
+
+  // An unpaired surrogate inside ASCII runs.
+  string16 utf16 = ASCIIToUTF16(prefix);
+  utf16.push_back(0xd800);
+  utf16 += ASCIIToUTF16(prefix);
+  std::string utf8;
+  EXPECT_FALSE(UTF16ToUTF8(utf16.data(), utf16.length(), &utf8));
+  EXPECT_EQ(prefix + "\xef\xbf\xbd" + prefix, utf8);
+}
+
 }  // base
@@ -43,6 +43,7 @@ public:
     void updateTextureRect(CCResourceProvider*, CCPrioritizedTexture*, const IntRect& sourceRect, const IntSize& destOffset);
 
     virtual void setOpaque(bool) OVERRIDE;
+    virtual bool canUseAtlas() const OVERRIDE { return true; }
 
 private:
     explicit BitmapCanvasLayerTextureUpdater(PassOwnPtr<LayerPainterChromium>);
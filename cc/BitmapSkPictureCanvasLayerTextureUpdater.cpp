@@ -9,15 +9,44 @@
 
 #include "BitmapSkPictureCanvasLayerTextureUpdater.h"
 
+#include "CCRasterWorkerPool.h"
 #include "CCRenderingStats.h"
+#include "CCResourceProvider.h"
 #include "LayerPainterChromium.h"
 #include "PlatformColor.h"
 #include "SkCanvas.h"
 #include "SkDevice.h"
+#include "TraceEvent.h"
 #include <wtf/CurrentTime.h>
 
 namespace cc {
 
+class BitmapSkPictureCanvasLayerTextureUpdater::RasterTask : public CCRasterWorkerPool::Task {
+public:
+    RasterTask(BitmapSkPictureCanvasLayerTextureUpdater* textureUpdater, const SkBitmap& bitmap, const IntRect& sourceRect)
+        : m_textureUpdater(textureUpdater)
+        , m_bitmap(bitmap)
+        , m_sourceRect(sourceRect)
+    {
+    }
+
+    virtual void run(int threadIndex) OVERRIDE
+    {
+        TRACE_EVENT0("cc", "BitmapSkPictureCanvasLayerTextureUpdater::RasterTask::run");
+        SkDevice device(m_bitmap);
+        SkCanvas canvas(&device);
+        const IntRect& contentRect = m_textureUpdater->contentRect();
+        canvas.translate(contentRect.x() - m_sourceRect.x(), contentRect.y() - m_sourceRect.y());
+        canvas.drawPicture(m_textureUpdater->m_threadPictures[threadIndex]);
+    }
+
+private:
+    BitmapSkPictureCanvasLayerTextureUpdater* m_textureUpdater;
+    // Shares the pixels of the texture's bitmap.
+    SkBitmap m_bitmap;
+    IntRect m_sourceRect;
+};
+
 BitmapSkPictureCanvasLayerTextureUpdater::Texture::Texture(BitmapSkPictureCanvasLayerTextureUpdater* textureUpdater, PassOwnPtr<CCPrioritizedTexture> texture)
     : CanvasLayerTextureUpdater::Texture(texture)
     , m_textureUpdater(textureUpdater)
@@ -26,9 +55,18 @@ BitmapSkPictureCanvasLayerTextureUpdater::Texture::Texture(BitmapSkPictureCanvas
 
 void BitmapSkPictureCanvasLayerTextureUpdater::Texture::prepareRect(const IntRect& sourceRect, CCRenderingStats& stats)
 {
+    // updateRect() rasterizes straight into the pixel buffer.
+    if (textureUpdater()->m_usePixelBuffers && !textureUpdater()->m_rasterWorkerPool)
+        return;
+
     m_bitmap.setConfig(SkBitmap::kARGB_8888_Config, sourceRect.width(), sourceRect.height());
     m_bitmap.allocPixels();
     m_bitmap.setIsOpaque(m_textureUpdater->layerIsOpaque());
+    if (textureUpdater()->m_rasterWorkerPool) {
+        textureUpdater()->postRasterTask(m_bitmap, sourceRect);
+        stats.numTilesRasterizedInParallel++;
+        return;
+    }
     SkDevice device(m_bitmap);
     SkCanvas canvas(&device);
     double paintBeginTime = monotonicallyIncreasingTime();
@@ -38,12 +76,50 @@ void BitmapSkPictureCanvasLayerTextureUpdater::Texture::prepareRect(const IntRec
 
 void BitmapSkPictureCanvasLayerTextureUpdater::Texture::updateRect(CCResourceProvider* resourceProvider, const IntRect& sourceRect, const IntSize& destOffset)
 {
+    if (m_bitmap.isNull()) {
+        // The main thread is blocked during uploads, so the picture can be played back here.
+        if (rasterizeIntoPixelBuffer(resourceProvider, sourceRect, destOffset))
+            return;
+        CCRenderingStats stats;
+        m_bitmap.setConfig(SkBitmap::kARGB_8888_Config, sourceRect.width(), sourceRect.height());
+        m_bitmap.allocPixels();
+        m_bitmap.setIsOpaque(m_textureUpdater->layerIsOpaque());
+        SkDevice device(m_bitmap);
+        SkCanvas canvas(&device);
+        textureUpdater()->paintContentsRect(&canvas, sourceRect, stats);
+    }
+
     m_bitmap.lockPixels();
     texture()->upload(resourceProvider, static_cast<uint8_t*>(m_bitmap.getPixels()), sourceRect, sourceRect, destOffset);
     m_bitmap.unlockPixels();
     m_bitmap.reset();
 }
 
+bool BitmapSkPictureCanvasLayerTextureUpdater::Texture::rasterizeIntoPixelBuffer(CCResourceProvider* resourceProvider, const IntRect& sourceRect, const IntSize& destOffset)
+{
+    if (!resourceProvider->canUsePixelBuffers())
+        return false;
+    texture()->acquireBackingTexture(resourceProvider);
+    CCResourceProvider::ResourceId resourceId = texture()->resourceId();
+    if (!resourceId)
+        return false;
+    uint8_t* pixels = resourceProvider->mapPixelBuffer(resourceId, sourceRect.size());
+    if (!pixels)
+        return false;
+
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, sourceRect.width(), sourceRect.height());
+    bitmap.setPixels(pixels);
+    bitmap.setIsOpaque(m_textureUpdater->layerIsOpaque());
+    SkDevice device(bitmap);
+    SkCanvas canvas(&device);
+    CCRenderingStats stats;
+    textureUpdater()->paintContentsRect(&canvas, sourceRect, stats);
+
+    resourceProvider->unmapPixelBufferAndUpload(resourceId, sourceRect.size(), destOffset);
+    return true;
+}
+
 PassRefPtr<BitmapSkPictureCanvasLayerTextureUpdater> BitmapSkPictureCanvasLayerTextureUpdater::create(PassOwnPtr<LayerPainterChromium> painter)
 {
     return adoptRef(new BitmapSkPictureCanvasLayerTextureUpdater(painter));
@@ -51,11 +127,15 @@ PassRefPtr<BitmapSkPictureCanvasLayerTextureUpdater> BitmapSkPictureCanvasLayerT
 
 BitmapSkPictureCanvasLayerTextureUpdater::BitmapSkPictureCanvasLayerTextureUpdater(PassOwnPtr<LayerPainterChromium> painter)
     : SkPictureCanvasLayerTextureUpdater(painter)
+    , m_rasterWorkerPool(0)
+    , m_hasPendingRasterTasks(false)
+    , m_usePixelBuffers(false)
 {
 }
 
 BitmapSkPictureCanvasLayerTextureUpdater::~BitmapSkPictureCanvasLayerTextureUpdater()
 {
+    ASSERT(!m_hasPendingRasterTasks);
 }
 
 PassOwnPtr<LayerTextureUpdater::Texture> BitmapSkPictureCanvasLayerTextureUpdater::createTexture(CCPrioritizedTextureManager* manager)
@@ -70,6 +150,38 @@ LayerTextureUpdater::SampledTexelFormat BitmapSkPictureCanvasLayerTextureUpdater
             LayerTextureUpdater::SampledTexelFormatRGBA : LayerTextureUpdater::SampledTexelFormatBGRA;
 }
 
+void BitmapSkPictureCanvasLayerTextureUpdater::prepareToUpdate(const IntRect& contentRect, const IntSize& tileSize, float contentsWidthScale, float contentsHeightScale, IntRect& resultingOpaqueRect, CCRenderingStats& stats)
+{
+    ASSERT(!m_hasPendingRasterTasks);
+    SkPictureCanvasLayerTextureUpdater::prepareToUpdate(contentRect, tileSize, contentsWidthScale, contentsHeightScale, resultingOpaqueRect, stats);
+
+    if (!m_rasterWorkerPool) {
+        m_threadPictures.clear();
+        return;
+    }
+    m_threadPictures.resize(m_rasterWorkerPool->numThreads());
+    picture().clone(m_threadPictures.data(), m_threadPictures.size());
+}
+
+void BitmapSkPictureCanvasLayerTextureUpdater::finishPreparingRects(CCRenderingStats& stats)
+{
+    if (!m_hasPendingRasterTasks)
+        return;
+
+    TRACE_EVENT0("cc", "BitmapSkPictureCanvasLayerTextureUpdater::finishPreparingRects");
+    double waitBeginTime = monotonicallyIncreasingTime();
+    m_rasterWorkerPool->waitForTasks();
+    stats.totalRasterWaitTimeInSeconds += monotonicallyIncreasingTime() - waitBeginTime;
+    m_hasPendingRasterTasks = false;
+}
+
+void BitmapSkPictureCanvasLayerTextureUpdater::postRasterTask(const SkBitmap& bitmap, const IntRect& sourceRect)
+{
+    ASSERT(m_threadPictures.size() == static_cast<size_t>(m_rasterWorkerPool->numThreads()));
+    m_rasterWorkerPool->postTask(adoptPtr(new RasterTask(this, bitmap, sourceRect)));
+    m_hasPendingRasterTasks = true;
+}
+
 void BitmapSkPictureCanvasLayerTextureUpdater::paintContentsRect(SkCanvas* canvas, const IntRect& sourceRect, CCRenderingStats& stats)
 {
     // Translate the origin of contentRect to that of sourceRect.
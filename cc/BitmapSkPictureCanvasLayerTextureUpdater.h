@@ -9,11 +9,15 @@
 #if USE(ACCELERATED_COMPOSITING)
 #include "SkBitmap.h"
 #include "SkPictureCanvasLayerTextureUpdater.h"
+#include <wtf/Vector.h>
 
 namespace cc {
 
 // This class records the contentRect into an SkPicture, then software rasterizes
 // the SkPicture into bitmaps for each tile. This implements CCSettings::perTilePainting.
+// With a raster worker pool, the tiles are rasterized on the worker threads, each one
+// playing back its own copy of the picture. Otherwise, when the renderer supports pixel
+// buffers, the tiles are rasterized when they are uploaded, straight into transfer memory.
 class BitmapSkPictureCanvasLayerTextureUpdater : public SkPictureCanvasLayerTextureUpdater {
 public:
     class Texture : public CanvasLayerTextureUpdater::Texture {
@@ -25,6 +29,7 @@ public:
 
     private:
         BitmapSkPictureCanvasLayerTextureUpdater* textureUpdater() { return m_textureUpdater; }
+        bool rasterizeIntoPixelBuffer(CCResourceProvider*, const IntRect& sourceRect, const IntSize& destOffset);
 
         SkBitmap m_bitmap;
         BitmapSkPictureCanvasLayerTextureUpdater* m_textureUpdater;
@@ -35,10 +40,26 @@ public:
 
     virtual PassOwnPtr<LayerTextureUpdater::Texture> createTexture(CCPrioritizedTextureManager*) OVERRIDE;
     virtual SampledTexelFormat sampledTexelFormat(GC3Denum textureFormat) OVERRIDE;
+    virtual void prepareToUpdate(const IntRect& contentRect, const IntSize& tileSize, float contentsWidthScale, float contentsHeightScale, IntRect& resultingOpaqueRect, CCRenderingStats&) OVERRIDE;
+    virtual void finishPreparingRects(CCRenderingStats&) OVERRIDE;
+    virtual void setRasterWorkerPool(CCRasterWorkerPool* pool) OVERRIDE { m_rasterWorkerPool = pool; }
+    virtual bool canUseAtlas() const OVERRIDE { return true; }
+    void setUsePixelBuffers(bool usePixelBuffers) { m_usePixelBuffers = usePixelBuffers; }
     void paintContentsRect(SkCanvas*, const IntRect& sourceRect, CCRenderingStats&);
 
 private:
+    class RasterTask;
+
     explicit BitmapSkPictureCanvasLayerTextureUpdater(PassOwnPtr<LayerPainterChromium>);
+
+    // Rasterizes sourceRect into the pixels of bitmap on a raster worker thread.
+    void postRasterTask(const SkBitmap&, const IntRect& sourceRect);
+
+    CCRasterWorkerPool* m_rasterWorkerPool;
+    // Playing back an SkPicture is not thread safe, so each raster thread gets its own copy.
+    Vector<SkPicture> m_threadPictures;
+    bool m_hasPendingRasterTasks;
+    bool m_usePixelBuffers;
 };
 } // namespace cc
 #endif // USE(ACCELERATED_COMPOSITING)
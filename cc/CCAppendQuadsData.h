@@ -13,6 +13,7 @@ struct CCAppendQuadsData {
     CCAppendQuadsData()
         : hadOcclusionFromOutsideTargetSurface(false)
         , hadMissingTiles(false)
+        , numMissingTiles(0)
         , renderPassId(0, 0)
     {
     }
@@ -20,6 +21,7 @@ struct CCAppendQuadsData {
     explicit CCAppendQuadsData(CCRenderPass::Id renderPassId)
         : hadOcclusionFromOutsideTargetSurface(false)
         , hadMissingTiles(false)
+        , numMissingTiles(0)
         , renderPassId(renderPassId)
     {
     }
@@ -28,6 +30,9 @@ struct CCAppendQuadsData {
     bool hadOcclusionFromOutsideTargetSurface;
     // Set by the layer appending quads.
     bool hadMissingTiles;
+    // The number of tiles drawn as checkerboards or solid colors because they
+    // were not painted yet.
+    int numMissingTiles;
     // Given to the layer appending quads.
     const CCRenderPass::Id renderPassId;
 };
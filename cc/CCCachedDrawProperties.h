@@ -0,0 +1,68 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CCCachedDrawProperties_h
+#define CCCachedDrawProperties_h
+
+#include "FloatPoint.h"
+#include "IntRect.h"
+#include "IntSize.h"
+#include <public/WebTransformationMatrix.h>
+
+namespace cc {
+
+// The inputs and results of the last draw property computation for a layer.
+// CCLayerTreeHostCommon reuses the results when none of the inputs changed,
+// which is the case for most of the layers of a tree when only a scroll
+// offset changed. The inputs are compared rather than tracked with dirty bits,
+// so the results are always the same as those of a full computation.
+struct CCCachedDrawProperties {
+    CCCachedDrawProperties()
+        : hasTransforms(false)
+        , anchorPointZ(0)
+        , pageScaleDelta(1)
+        , preserves3D(false)
+        , fixedToContainerLayer(false)
+        , hasVisibleContentRect(false)
+    {
+    }
+
+    void clear()
+    {
+        hasTransforms = false;
+        hasVisibleContentRect = false;
+    }
+
+    // Inputs of the layer transforms.
+    bool hasTransforms;
+    WebKit::WebTransformationMatrix parentMatrix;
+    WebKit::WebTransformationMatrix fullHierarchyMatrix;
+    WebKit::WebTransformationMatrix scrollCompensationMatrix;
+    WebKit::WebTransformationMatrix transform;
+    FloatPoint position;
+    FloatPoint anchorPoint;
+    float anchorPointZ;
+    IntSize bounds;
+    IntSize contentBounds;
+    float pageScaleDelta;
+    bool preserves3D;
+    bool fixedToContainerLayer;
+
+    // The layer transforms.
+    WebKit::WebTransformationMatrix combinedTransform;
+    WebKit::WebTransformationMatrix drawTransform;
+    WebKit::WebTransformationMatrix screenSpaceTransform;
+
+    // Inputs of the visible content rect.
+    bool hasVisibleContentRect;
+    IntRect visibleTargetRect;
+    IntSize visibleContentBounds;
+    WebKit::WebTransformationMatrix visibleDrawTransform;
+
+    IntRect visibleContentRect;
+};
+
+}
+
+#endif
@@ -7,6 +7,8 @@
 #include "CCDirectRenderer.h"
 
 #include "CCMathUtil.h"
+#include "CCPrioritizedTextureManager.h"
+#include "base/hash_tables.h"
 #include <public/WebTransformationMatrix.h>
 #include <vector>
 
@@ -106,6 +108,7 @@ IntRect CCDirectRenderer::moveScissorToWindowSpace(const DrawingFrame& frame, Fl
 CCDirectRenderer::CCDirectRenderer(CCRendererClient* client, CCResourceProvider* resourceProvider)
     : CCRenderer(client)
     , m_resourceProvider(resourceProvider)
+    , m_renderPassCacheLimitBytes(renderPassCacheLimitForAllocation(CCPrioritizedTextureManager::defaultMemoryAllocationLimit()))
 {
 }
 
@@ -161,18 +164,29 @@ void CCDirectRenderer::drawFrame(const CCRenderPassList& renderPassesInDrawOrder
     frame.rootDamageRect = capabilities().usingPartialSwap ? rootRenderPass->damageRect() : rootRenderPass->outputRect();
     frame.rootDamageRect.intersect(IntRect(IntPoint::zero(), viewportSize()));
 
+    m_frameQuadCount = 0;
+    m_frameDrawCallCount = 0;
     beginDrawingFrame(frame);
     for (size_t i = 0; i < renderPassesInDrawOrder.size(); ++i)
         drawRenderPass(frame, renderPassesInDrawOrder[i]);
     finishDrawingFrame(frame);
+    enforceRenderPassCacheLimit(renderPassesInDrawOrder);
+    m_lastFrameQuadCount = m_frameQuadCount;
+    m_lastFrameDrawCallCount = m_frameDrawCallCount;
 }
 
 void CCDirectRenderer::drawRenderPass(DrawingFrame& frame, const CCRenderPass* renderPass)
 {
+    // A complete texture from the previous frame only needs its damaged part
+    // to be drawn again.
+    bool onlyDrawDamage = renderPass != frame.rootRenderPass && haveCachedResourcesForRenderPassId(renderPass->id());
+
     if (!useRenderPass(frame, renderPass))
         return;
 
     frame.scissorRectInRenderPassSpace = frame.currentRenderPass->outputRect();
+    if (onlyDrawDamage)
+        frame.scissorRectInRenderPassSpace.intersect(renderPass->damageRect());
     if (frame.rootDamageRect != frame.rootRenderPass->outputRect()) {
         WebTransformationMatrix inverseTransformToRoot = frame.currentRenderPass->transformToRootTarget().inverse();
         frame.scissorRectInRenderPassSpace.intersect(CCMathUtil::projectClippedRect(inverseTransformToRoot, frame.rootDamageRect));
@@ -188,6 +202,7 @@ void CCDirectRenderer::drawRenderPass(DrawingFrame& frame, const CCRenderPass* r
         if (!quadScissorRect.isEmpty()) {
             enableScissorTestRect(moveScissorToWindowSpace(frame, quadScissorRect));
             drawQuad(frame, *it);
+            ++m_frameQuadCount;
         }
     }
 
@@ -196,6 +211,37 @@ void CCDirectRenderer::drawRenderPass(DrawingFrame& frame, const CCRenderPass* r
         texture->setIsComplete(!renderPass->hasOcclusionFromOutsideTargetSurface());
 }
 
+void CCDirectRenderer::enforceRenderPassCacheLimit(const CCRenderPassList& renderPassesInDrawOrder)
+{
+    // The textures that were used without being drawn this frame saved the
+    // most work, so they are kept first. The textures drawn this frame come
+    // next, starting with the ones drawn last.
+    base::hash_set<CCRenderPass::Id> drawnPasses;
+    for (size_t i = 0; i < renderPassesInDrawOrder.size(); ++i)
+        drawnPasses.insert(renderPassesInDrawOrder[i]->id());
+
+    std::vector<CCRenderPass::Id> passesByPriority;
+    ScopedPtrHashMap<CCRenderPass::Id, CachedTexture>::const_iterator passIterator;
+    for (passIterator = m_renderPassTextures.begin(); passIterator != m_renderPassTextures.end(); ++passIterator) {
+        if (!drawnPasses.count(passIterator->first))
+            passesByPriority.push_back(passIterator->first);
+    }
+    for (size_t i = renderPassesInDrawOrder.size(); i > 0; --i)
+        passesByPriority.push_back(renderPassesInDrawOrder[i - 1]->id());
+
+    size_t keptBytes = 0;
+    for (size_t i = 0; i < passesByPriority.size(); ++i) {
+        CachedTexture* texture = m_renderPassTextures.get(passesByPriority[i]);
+        if (!texture || !texture->id())
+            continue;
+        if (keptBytes + texture->bytes() > m_renderPassCacheLimitBytes) {
+            texture->free();
+            continue;
+        }
+        keptBytes += texture->bytes();
+    }
+}
+
 bool CCDirectRenderer::useRenderPass(DrawingFrame& frame, const CCRenderPass* renderPass)
 {
     frame.currentRenderPass = renderPass;
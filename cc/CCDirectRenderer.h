@@ -27,6 +27,12 @@ public:
     virtual bool haveCachedResourcesForRenderPassId(CCRenderPass::Id) const OVERRIDE;
     virtual void drawFrame(const CCRenderPassList& renderPassesInDrawOrder, const CCRenderPassIdHashMap& renderPassesById) OVERRIDE;
 
+    // Render pass textures are kept between frames so that surfaces whose
+    // contents did not change do not need to be drawn again. This limits the
+    // memory the kept textures can use once a frame has been drawn.
+    void setRenderPassCacheLimitBytes(size_t bytes) { m_renderPassCacheLimitBytes = bytes; }
+    size_t renderPassCacheLimitBytes() const { return m_renderPassCacheLimitBytes; }
+
 protected:
     CCDirectRenderer(CCRendererClient* client, CCResourceProvider* resourceProvider);
 
@@ -75,6 +81,10 @@ protected:
     bool haveCachedResources(CCRenderPass::Id) const;
     static IntSize renderPassTextureSize(const CCRenderPass*);
     static GC3Denum renderPassTextureFormat(const CCRenderPass*);
+    // The part of the memory allocation given to the contents textures that
+    // the kept render pass textures may use.
+    static size_t renderPassCacheLimitForAllocation(size_t allocationBytes) { return allocationBytes / 4; }
+    void enforceRenderPassCacheLimit(const CCRenderPassList& renderPassesInDrawOrder);
 
     void drawRenderPass(DrawingFrame&, const CCRenderPass*);
     bool useRenderPass(DrawingFrame&, const CCRenderPass*);
@@ -92,6 +102,7 @@ protected:
 
     ScopedPtrHashMap<CCRenderPass::Id, CachedTexture> m_renderPassTextures;
     CCResourceProvider* m_resourceProvider;
+    size_t m_renderPassCacheLimitBytes;
 };
 
 }
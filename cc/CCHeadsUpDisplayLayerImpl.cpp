@@ -231,6 +231,11 @@ void CCHeadsUpDisplayLayerImpl::drawFPSCounterText(SkCanvas* canvas, CCFrameRate
     // Draw FPS text.
     if (m_fontAtlas)
         m_fontAtlas->drawText(canvas, createPaint(), base::StringPrintf("FPS: %4.1f +/- %3.1f", averageFPS, stdDeviation), IntPoint(10, height / 3), IntSize(width, height));
+
+    // Draw the draw call count of the last frame under it.
+    CCRenderer* renderer = layerTreeHostImpl()->renderer();
+    if (m_fontAtlas && renderer)
+        m_fontAtlas->drawText(canvas, createPaint(), base::StringPrintf("Draws: %d Quads: %d", renderer->lastFrameDrawCallCount(), renderer->lastFrameQuadCount()), IntPoint(10, 2 * height / 3), IntSize(width, height));
 }
 
 void CCHeadsUpDisplayLayerImpl::drawDebugRects(SkCanvas* canvas, CCDebugRectHistory* debugRectHistory)
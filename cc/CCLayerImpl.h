@@ -5,6 +5,7 @@
 #ifndef CCLayerImpl_h
 #define CCLayerImpl_h
 
+#include "CCCachedDrawProperties.h"
 #include "CCInputHandler.h"
 #include "CCLayerAnimationController.h"
 #include "CCRenderPass.h"
@@ -219,6 +220,9 @@ public:
     const WebKit::WebTransformationMatrix& screenSpaceTransform() const { return m_screenSpaceTransform; }
     void setScreenSpaceTransform(const WebKit::WebTransformationMatrix& matrix) { m_screenSpaceTransform = matrix; }
 
+    // Used by CCLayerTreeHostCommon to skip recomputing the draw properties.
+    CCCachedDrawProperties& cachedDrawProperties() { return m_cachedDrawProperties; }
+
     bool drawTransformIsAnimating() const { return m_drawTransformIsAnimating; }
     void setDrawTransformIsAnimating(bool animating) { m_drawTransformIsAnimating = animating; }
     bool screenSpaceTransformIsAnimating() const { return m_screenSpaceTransformIsAnimating; }
@@ -367,6 +371,7 @@ private:
     WebKit::WebTransformationMatrix m_screenSpaceTransform;
     bool m_drawTransformIsAnimating;
     bool m_screenSpaceTransformIsAnimating;
+    CCCachedDrawProperties m_cachedDrawProperties;
 
 #ifndef NDEBUG
     bool m_betweenWillDrawAndDidDraw;
@@ -8,6 +8,7 @@
 
 #include "CCMathUtil.h"
 #include "CCRenderSurface.h"
+#include <algorithm>
 #include <limits.h>
 #include <public/WebTransformationMatrix.h>
 #include <wtf/Deque.h>
@@ -62,6 +63,15 @@ static bool edgeEdgeTest(const FloatPoint& a, const FloatPoint& b, const FloatPo
     return true;
 }
 
+// Returns the column or row of a grid of |gridSize| cells of |cellSize| that
+// holds the given offset from the origin of the grid.
+static int gridCell(float offset, float cellSize, int gridSize)
+{
+    if (cellSize <= 0)
+        return 0;
+    return max(0, min(gridSize - 1, static_cast<int>(offset / cellSize)));
+}
+
 CCLayerSorter::GraphNode::GraphNode(CCLayerImpl* cclayer)
     : layer(cclayer)
     , incomingEdgeWeight(0)
@@ -260,6 +270,78 @@ void CCLayerSorter::createGraphNodes(LayerList::iterator first, LayerList::itera
     m_zRange = fabsf(maxZ - minZ);
 }
 
+// Layers whose projected bounds do not intersect cannot need an edge, so only
+// the pairs of layers that share a cell of a grid laid over the projected
+// bounds are compared. A pair is compared in the cell holding the top left
+// corner of the intersection of their bounds, so it is compared only once.
+void CCLayerSorter::findOverlapCandidates(Vector<std::pair<unsigned, unsigned> >& candidates) const
+{
+    Vector<unsigned> drawnNodes;
+    FloatRect gridBounds;
+    for (unsigned i = 0; i < m_nodes.size(); i++) {
+        const GraphNode& node = m_nodes[i];
+        if (!node.layer->drawsContent() && !node.layer->renderSurface())
+            continue;
+        if (node.shape.projectedBounds.isEmpty())
+            continue;
+        drawnNodes.append(i);
+        gridBounds.unite(node.shape.projectedBounds);
+    }
+
+    int gridSize = static_cast<int>(ceilf(sqrtf(drawnNodes.size())));
+    float cellWidth = gridBounds.width() / gridSize;
+    float cellHeight = gridBounds.height() / gridSize;
+
+    // With few layers, comparing all the pairs is cheaper than the grid. The
+    // grid also can't hold bounds projected to infinity.
+    const unsigned minLayersForGrid = 16;
+    if (drawnNodes.size() < minLayersForGrid || !(cellWidth < FLT_MAX) || !(cellHeight < FLT_MAX)) {
+        for (unsigned a = 0; a < drawnNodes.size(); a++) {
+            for (unsigned b = a + 1; b < drawnNodes.size(); b++)
+                candidates.append(std::make_pair(drawnNodes[a], drawnNodes[b]));
+        }
+        return;
+    }
+
+    Vector<Vector<unsigned> > cells(gridSize * gridSize);
+
+    for (unsigned i = 0; i < drawnNodes.size(); i++) {
+        const FloatRect& bounds = m_nodes[drawnNodes[i]].shape.projectedBounds;
+        int left = gridCell(bounds.x() - gridBounds.x(), cellWidth, gridSize);
+        int right = gridCell(bounds.maxX() - gridBounds.x(), cellWidth, gridSize);
+        int top = gridCell(bounds.y() - gridBounds.y(), cellHeight, gridSize);
+        int bottom = gridCell(bounds.maxY() - gridBounds.y(), cellHeight, gridSize);
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++)
+                cells[y * gridSize + x].append(drawnNodes[i]);
+        }
+    }
+
+    for (int y = 0; y < gridSize; y++) {
+        for (int x = 0; x < gridSize; x++) {
+            const Vector<unsigned>& cell = cells[y * gridSize + x];
+            for (unsigned a = 0; a < cell.size(); a++) {
+                const FloatRect& boundsA = m_nodes[cell[a]].shape.projectedBounds;
+                for (unsigned b = a + 1; b < cell.size(); b++) {
+                    FloatRect intersection = boundsA;
+                    intersection.intersect(m_nodes[cell[b]].shape.projectedBounds);
+                    if (intersection.isEmpty())
+                        continue;
+                    if (gridCell(intersection.x() - gridBounds.x(), cellWidth, gridSize) != x
+                        || gridCell(intersection.y() - gridBounds.y(), cellHeight, gridSize) != y)
+                        continue;
+                    candidates.append(std::make_pair(cell[a], cell[b]));
+                }
+            }
+        }
+    }
+
+    // Cells hold the nodes in list order, so each pair is already ordered.
+    // Comparing the pairs in list order creates the same edges, in the same
+    // order, as comparing all the pairs would.
+    std::sort(candidates.begin(), candidates.end());
+}
+
 void CCLayerSorter::createGraphEdges()
 {
 #if !defined( NDEBUG )
@@ -270,32 +352,29 @@ void CCLayerSorter::createGraphEdges()
     const float zThresholdFactor = 0.01f;
     float zThreshold = m_zRange * zThresholdFactor;
 
-    for (unsigned na = 0; na < m_nodes.size(); na++) {
-        GraphNode& nodeA = m_nodes[na];
-        if (!nodeA.layer->drawsContent() && !nodeA.layer->renderSurface())
-            continue;
-        for (unsigned nb = na + 1; nb < m_nodes.size(); nb++) {
-            GraphNode& nodeB = m_nodes[nb];
-            if (!nodeB.layer->drawsContent() && !nodeB.layer->renderSurface())
-                continue;
-            float weight = 0;
-            ABCompareResult overlapResult = checkOverlap(&nodeA.shape, &nodeB.shape, zThreshold, weight);
-            GraphNode* startNode = 0;
-            GraphNode* endNode = 0;
-            if (overlapResult == ABeforeB) {
-                startNode = &nodeA;
-                endNode = &nodeB;
-            } else if (overlapResult == BBeforeA) {
-                startNode = &nodeB;
-                endNode = &nodeA;
-            }
+    Vector<std::pair<unsigned, unsigned> > candidates;
+    findOverlapCandidates(candidates);
+
+    for (unsigned i = 0; i < candidates.size(); i++) {
+        GraphNode& nodeA = m_nodes[candidates[i].first];
+        GraphNode& nodeB = m_nodes[candidates[i].second];
+        float weight = 0;
+        ABCompareResult overlapResult = checkOverlap(&nodeA.shape, &nodeB.shape, zThreshold, weight);
+        GraphNode* startNode = 0;
+        GraphNode* endNode = 0;
+        if (overlapResult == ABeforeB) {
+            startNode = &nodeA;
+            endNode = &nodeB;
+        } else if (overlapResult == BBeforeA) {
+            startNode = &nodeB;
+            endNode = &nodeA;
+        }
 
-            if (startNode) {
+        if (startNode) {
 #if !defined( NDEBUG )
-                LOG(CCLayerSorter, "%d -> %d\n", startNode->layer->id(), endNode->layer->id());
+            LOG(CCLayerSorter, "%d -> %d\n", startNode->layer->id(), endNode->layer->id());
 #endif
-                m_edges.append(GraphEdge(startNode, endNode, weight));
-            }
+            m_edges.append(GraphEdge(startNode, endNode, weight));
         }
     }
 
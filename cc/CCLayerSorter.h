@@ -82,6 +82,7 @@ private:
     EdgeMap m_activeEdges;
 
     void createGraphNodes(LayerList::iterator first, LayerList::iterator last);
+    void findOverlapCandidates(Vector<std::pair<unsigned, unsigned> >&) const;
     void createGraphEdges();
     void removeEdgeFromList(GraphEdge*, Vector<GraphEdge*>&);
 };
@@ -264,4 +264,50 @@ TEST(CCLayerSorterTest, verifyExistingOrderingPreservedWhenNoZDiff)
     EXPECT_EQ(5, layerList[4]->id());
 }
 
+TEST(CCLayerSorterTest, sortManyLayers)
+{
+    DebugScopedSetImplThread thisScopeIsOnImplThread;
+
+    // A grid of 200 pairs of overlapping cards, with the front card of each
+    // pair listed first. Only the cards of a pair overlap each other, so each
+    // back card must move before its front card, and the order of the cards
+    // is otherwise kept. This is large enough for the sorter to only compare
+    // the cards whose bounds share a cell of its grid.
+    const int columns = 20;
+    const int rows = 10;
+    Vector<OwnPtr<CCLayerImpl> > layers;
+    Vector<CCLayerImpl*> layerList;
+    for (int i = 0; i < columns * rows; ++i) {
+        WebTransformationMatrix frontMatrix;
+        frontMatrix.translate3d((i % columns) * 30 + 5, (i / columns) * 30 + 5, -1);
+        WebTransformationMatrix backMatrix;
+        backMatrix.translate3d((i % columns) * 30, (i / columns) * 30, -2);
+
+        OwnPtr<CCLayerImpl> front = CCLayerImpl::create(2 * i + 1);
+        front->setBounds(IntSize(20, 20));
+        front->setContentBounds(IntSize(20, 20));
+        front->setDrawTransform(frontMatrix);
+        front->setDrawsContent(true);
+        layerList.append(front.get());
+        layers.append(front.release());
+
+        OwnPtr<CCLayerImpl> back = CCLayerImpl::create(2 * i + 2);
+        back->setBounds(IntSize(20, 20));
+        back->setContentBounds(IntSize(20, 20));
+        back->setDrawTransform(backMatrix);
+        back->setDrawsContent(true);
+        layerList.append(back.get());
+        layers.append(back.release());
+    }
+
+    CCLayerSorter layerSorter;
+    layerSorter.sort(layerList.begin(), layerList.end());
+
+    ASSERT_EQ(static_cast<size_t>(2 * columns * rows), layerList.size());
+    for (int i = 0; i < columns * rows; ++i) {
+        EXPECT_EQ(2 * i + 2, layerList[i]->id());
+        EXPECT_EQ(2 * i + 1, layerList[columns * rows + i]->id());
+    }
+}
+
 } // namespace
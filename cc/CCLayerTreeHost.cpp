@@ -16,6 +16,7 @@
 #include "CCLayerTreeHostImpl.h"
 #include "CCOcclusionTracker.h"
 #include "CCOverdrawMetrics.h"
+#include "CCRasterWorkerPool.h"
 #include "CCSettings.h"
 #include "CCSingleThreadProxy.h"
 #include "CCThreadProxy.h"
@@ -52,6 +53,7 @@ CCLayerTreeSettings::CCLayerTreeSettings()
     , defaultTileSize(IntSize(256, 256))
     , maxUntiledLayerSize(IntSize(512, 512))
     , minimumOcclusionTrackingSize(IntSize(160, 160))
+    , numRasterThreads(0)
 {
 }
 
@@ -69,6 +71,7 @@ RendererCapabilities::RendererCapabilities()
     , usingGpuMemoryManager(false)
     , usingDiscardFramebuffer(false)
     , usingEglImage(false)
+    , usingPixelBuffers(false)
     , maxTextureSize(0)
 {
 }
@@ -119,6 +122,9 @@ bool CCLayerTreeHost::initialize()
 {
     TRACE_EVENT0("cc", "CCLayerTreeHost::initialize");
 
+    if (m_settings.numRasterThreads > 0)
+        m_rasterWorkerPool = CCRasterWorkerPool::create(m_settings.numRasterThreads);
+
     if (CCProxy::hasImplThread())
         m_proxy = CCThreadProxy::create(this);
     else
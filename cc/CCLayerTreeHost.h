@@ -30,6 +30,7 @@ class CCLayerChromium;
 class CCLayerTreeHostImpl;
 class CCLayerTreeHostImplClient;
 class CCPrioritizedTextureManager;
+class CCRasterWorkerPool;
 class CCTextureUpdateQueue;
 class HeadsUpDisplayLayerChromium;
 class Region;
@@ -54,6 +55,9 @@ struct CCLayerTreeSettings {
     IntSize defaultTileSize;
     IntSize maxUntiledLayerSize;
     IntSize minimumOcclusionTrackingSize;
+    // Number of threads that rasterize tiles with per-tile painting. When 0, tiles are
+    // rasterized on the main thread.
+    int numRasterThreads;
 
     bool showDebugInfo() const { return showPlatformLayerTree || showFPSCounter || showDebugRects(); }
     bool showDebugRects() const { return showPaintRects || showPropertyChangedRects || showSurfaceDamageRects || showScreenSpaceRects || showReplicaScreenSpaceRects || showOccludingRects; }
@@ -73,6 +77,7 @@ struct RendererCapabilities {
     bool usingGpuMemoryManager;
     bool usingDiscardFramebuffer;
     bool usingEglImage;
+    bool usingPixelBuffers;
     int maxTextureSize;
 };
 
@@ -168,6 +173,9 @@ public:
 
     CCPrioritizedTextureManager* contentsTextureManager() const;
 
+    // Null unless settings().numRasterThreads is positive.
+    CCRasterWorkerPool* rasterWorkerPool() const { return m_rasterWorkerPool.get(); }
+
     // Delete contents textures' backing resources until they use only bytesLimit bytes. This may
     // be called on the impl thread while the main thread is running.
     void reduceContentsTexturesMemoryOnImplThread(size_t bytesLimit, CCResourceProvider*);
@@ -253,6 +261,8 @@ private:
     OwnPtr<CCPrioritizedTextureManager> m_contentsTextureManager;
     OwnPtr<CCPrioritizedTexture> m_surfaceMemoryPlaceholder;
 
+    OwnPtr<CCRasterWorkerPool> m_rasterWorkerPool;
+
     CCLayerTreeSettings m_settings;
 
     IntSize m_layoutViewportSize;
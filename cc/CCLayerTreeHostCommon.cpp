@@ -121,8 +121,23 @@ static IntRect calculateVisibleContentRect(LayerType* layer)
     if (targetSurfaceRect.isEmpty() || layer->contentBounds().isEmpty())
         return IntRect();
 
+    // The projection done by calculateVisibleRect() is expensive, so it is
+    // skipped when the layer did not move with respect to its target.
+    CCCachedDrawProperties& cache = layer->cachedDrawProperties();
+    if (cache.hasVisibleContentRect
+        && cache.visibleTargetRect == targetSurfaceRect
+        && cache.visibleContentBounds == layer->contentBounds()
+        && cache.visibleDrawTransform == layer->drawTransform())
+        return cache.visibleContentRect;
+
     const IntRect contentRect = IntRect(IntPoint(), layer->contentBounds());
     IntRect visibleContentRect = CCLayerTreeHostCommon::calculateVisibleRect(targetSurfaceRect, contentRect, layer->drawTransform());
+
+    cache.hasVisibleContentRect = true;
+    cache.visibleTargetRect = targetSurfaceRect;
+    cache.visibleContentBounds = layer->contentBounds();
+    cache.visibleDrawTransform = layer->drawTransform();
+    cache.visibleContentRect = visibleContentRect;
     return visibleContentRect;
 }
 
@@ -333,6 +348,97 @@ WebTransformationMatrix computeScrollCompensationMatrixForChildren(CCLayerImpl*
     return nextScrollCompensationMatrix;
 }
 
+// Computes the transforms of a layer (see calculateDrawTransformsInternal for
+// their definitions), or reuses the ones of the last computation if none of
+// their inputs changed since then.
+template<typename LayerType>
+static void calculateLayerTransforms(LayerType* layer, const WebTransformationMatrix& parentMatrix, const WebTransformationMatrix& fullHierarchyMatrix,
+    const WebTransformationMatrix& currentScrollCompensationMatrix, WebTransformationMatrix& combinedTransform,
+    WebTransformationMatrix& drawTransform, WebTransformationMatrix& screenSpaceTransform)
+{
+    IntSize bounds = layer->bounds();
+    FloatPoint anchorPoint = layer->anchorPoint();
+    FloatPoint position = layer->position() - layer->scrollDelta();
+
+    CCCachedDrawProperties& cache = layer->cachedDrawProperties();
+    if (cache.hasTransforms
+        && cache.position == position
+        && cache.anchorPoint == anchorPoint
+        && cache.anchorPointZ == layer->anchorPointZ()
+        && cache.bounds == bounds
+        && cache.contentBounds == layer->contentBounds()
+        && cache.pageScaleDelta == layer->pageScaleDelta()
+        && cache.preserves3D == layer->preserves3D()
+        && cache.fixedToContainerLayer == layer->fixedToContainerLayer()
+        && cache.transform == layer->transform()
+        && cache.parentMatrix == parentMatrix
+        && cache.fullHierarchyMatrix == fullHierarchyMatrix
+        && (!layer->fixedToContainerLayer() || cache.scrollCompensationMatrix == currentScrollCompensationMatrix)) {
+        combinedTransform = cache.combinedTransform;
+        drawTransform = cache.drawTransform;
+        screenSpaceTransform = cache.screenSpaceTransform;
+        return;
+    }
+
+    // Offset between anchor point and the center of the quad.
+    float centerOffsetX = (0.5 - anchorPoint.x()) * bounds.width();
+    float centerOffsetY = (0.5 - anchorPoint.y()) * bounds.height();
+
+    WebTransformationMatrix layerLocalTransform;
+    // LT = S[pageScaleDelta]
+    layerLocalTransform.scale(layer->pageScaleDelta());
+    // LT = S[pageScaleDelta] * Tr[origin] * Tr[origin2anchor]
+    layerLocalTransform.translate3d(position.x() + anchorPoint.x() * bounds.width(), position.y() + anchorPoint.y() * bounds.height(), layer->anchorPointZ());
+    // LT = S[pageScaleDelta] * Tr[origin] * Tr[origin2anchor] * M[layer]
+    layerLocalTransform.multiply(layer->transform());
+    // LT = S[pageScaleDelta] * Tr[origin] * Tr[origin2anchor] * M[layer] * Tr[anchor2center]
+    layerLocalTransform.translate3d(centerOffsetX, centerOffsetY, -layer->anchorPointZ());
+
+    combinedTransform = parentMatrix;
+    combinedTransform.multiply(layerLocalTransform);
+
+    if (layer->fixedToContainerLayer()) {
+        // Special case: this layer is a composited fixed-position layer; we need to
+        // explicitly compensate for all ancestors' nonzero scrollDeltas to keep this layer
+        // fixed correctly.
+        combinedTransform = currentScrollCompensationMatrix * combinedTransform;
+    }
+
+    // The drawTransform that gets computed below is effectively the layer's drawTransform, unless
+    // the layer itself creates a renderSurface. In that case, the renderSurface re-parents the transforms.
+    drawTransform = combinedTransform;
+    // M[draw] = M[parent] * LT * Tr[anchor2center] * Tr[center2origin]
+    drawTransform.translate(-layer->bounds().width() / 2.0, -layer->bounds().height() / 2.0);
+    if (!layer->contentBounds().isEmpty() && !layer->bounds().isEmpty()) {
+        // M[draw] = M[parent] * LT * Tr[anchor2origin] * S[layer2content]
+        drawTransform.scaleNonUniform(layer->bounds().width() / static_cast<double>(layer->contentBounds().width()),
+                                      layer->bounds().height() / static_cast<double>(layer->contentBounds().height()));
+    }
+
+    // screenSpaceTransform represents the transform between root layer's "screen space" and local content space.
+    screenSpaceTransform = fullHierarchyMatrix;
+    if (!layer->preserves3D())
+        CCMathUtil::flattenTransformTo2d(screenSpaceTransform);
+    screenSpaceTransform.multiply(drawTransform);
+
+    cache.hasTransforms = true;
+    cache.position = position;
+    cache.anchorPoint = anchorPoint;
+    cache.anchorPointZ = layer->anchorPointZ();
+    cache.bounds = bounds;
+    cache.contentBounds = layer->contentBounds();
+    cache.pageScaleDelta = layer->pageScaleDelta();
+    cache.preserves3D = layer->preserves3D();
+    cache.fixedToContainerLayer = layer->fixedToContainerLayer();
+    cache.transform = layer->transform();
+    cache.parentMatrix = parentMatrix;
+    cache.fullHierarchyMatrix = fullHierarchyMatrix;
+    cache.scrollCompensationMatrix = currentScrollCompensationMatrix;
+    cache.combinedTransform = combinedTransform;
+    cache.drawTransform = drawTransform;
+    cache.screenSpaceTransform = screenSpaceTransform;
+}
+
 // Should be called just before the recursive calculateDrawTransformsInternal().
 template<typename LayerType, typename LayerList>
 void setupRootLayerAndSurfaceForRecursion(LayerType* rootLayer, LayerList& renderSurfaceLayerList, const IntSize& deviceViewportSize)
@@ -460,49 +566,11 @@ static void calculateDrawTransformsInternal(LayerType* layer, LayerType* rootLay
     }
 
     IntSize bounds = layer->bounds();
-    FloatPoint anchorPoint = layer->anchorPoint();
-    FloatPoint position = layer->position() - layer->scrollDelta();
-
-    // Offset between anchor point and the center of the quad.
-    float centerOffsetX = (0.5 - anchorPoint.x()) * bounds.width();
-    float centerOffsetY = (0.5 - anchorPoint.y()) * bounds.height();
-
-    WebTransformationMatrix layerLocalTransform;
-    // LT = S[pageScaleDelta]
-    layerLocalTransform.scale(layer->pageScaleDelta());
-    // LT = S[pageScaleDelta] * Tr[origin] * Tr[origin2anchor]
-    layerLocalTransform.translate3d(position.x() + anchorPoint.x() * bounds.width(), position.y() + anchorPoint.y() * bounds.height(), layer->anchorPointZ());
-    // LT = S[pageScaleDelta] * Tr[origin] * Tr[origin2anchor] * M[layer]
-    layerLocalTransform.multiply(layer->transform());
-    // LT = S[pageScaleDelta] * Tr[origin] * Tr[origin2anchor] * M[layer] * Tr[anchor2center]
-    layerLocalTransform.translate3d(centerOffsetX, centerOffsetY, -layer->anchorPointZ());
 
-    WebTransformationMatrix combinedTransform = parentMatrix;
-    combinedTransform.multiply(layerLocalTransform);
-
-    if (layer->fixedToContainerLayer()) {
-        // Special case: this layer is a composited fixed-position layer; we need to
-        // explicitly compensate for all ancestors' nonzero scrollDeltas to keep this layer
-        // fixed correctly.
-        combinedTransform = currentScrollCompensationMatrix * combinedTransform;
-    }
-
-    // The drawTransform that gets computed below is effectively the layer's drawTransform, unless
-    // the layer itself creates a renderSurface. In that case, the renderSurface re-parents the transforms.
-    WebTransformationMatrix drawTransform = combinedTransform;
-    // M[draw] = M[parent] * LT * Tr[anchor2center] * Tr[center2origin]
-    drawTransform.translate(-layer->bounds().width() / 2.0, -layer->bounds().height() / 2.0);
-    if (!layer->contentBounds().isEmpty() && !layer->bounds().isEmpty()) {
-        // M[draw] = M[parent] * LT * Tr[anchor2origin] * S[layer2content]
-        drawTransform.scaleNonUniform(layer->bounds().width() / static_cast<double>(layer->contentBounds().width()),
-                                      layer->bounds().height() / static_cast<double>(layer->contentBounds().height()));
-    }
-
-    // layerScreenSpaceTransform represents the transform between root layer's "screen space" and local content space.
-    WebTransformationMatrix layerScreenSpaceTransform = fullHierarchyMatrix;
-    if (!layer->preserves3D())
-        CCMathUtil::flattenTransformTo2d(layerScreenSpaceTransform);
-    layerScreenSpaceTransform.multiply(drawTransform);
+    WebTransformationMatrix combinedTransform;
+    WebTransformationMatrix drawTransform;
+    WebTransformationMatrix layerScreenSpaceTransform;
+    calculateLayerTransforms(layer, parentMatrix, fullHierarchyMatrix, currentScrollCompensationMatrix, combinedTransform, drawTransform, layerScreenSpaceTransform);
     layer->setScreenSpaceTransform(layerScreenSpaceTransform);
 
     bool animatingTransformToTarget = layer->transformIsAnimating();
@@ -3598,4 +3598,71 @@ TEST(CCLayerTreeHostCommonTest, verifySubtreeSearch)
     EXPECT_EQ(0, CCLayerTreeHostCommon::findLayerInSubtree(root.get(), nonexistentId));
 }
 
+PassOwnPtr<CCLayerImpl> createLargeTreeForCachingTests()
+{
+    WebTransformationMatrix identityMatrix;
+    WebTransformationMatrix rotation;
+    rotation.rotate(30);
+    OwnPtr<CCLayerImpl> root = CCLayerImpl::create(1);
+    setLayerPropertiesForTesting(root.get(), identityMatrix, identityMatrix, FloatPoint(0, 0), FloatPoint(0, 0), IntSize(500, 500), false);
+
+    int nextId = 2;
+    for (int i = 0; i < 10; ++i) {
+        OwnPtr<CCLayerImpl> child = CCLayerImpl::create(nextId++);
+        setLayerPropertiesForTesting(child.get(), i % 3 ? identityMatrix : rotation, identityMatrix, FloatPoint(0.5, 0.5), FloatPoint(i * 40, i * 10), IntSize(200, 300), false);
+        child->setMasksToBounds(i % 2);
+        child->setDrawsContent(true);
+        for (int j = 0; j < 10; ++j) {
+            OwnPtr<CCLayerImpl> grandChild = CCLayerImpl::create(nextId++);
+            setLayerPropertiesForTesting(grandChild.get(), j % 4 ? identityMatrix : rotation, identityMatrix, FloatPoint(0, 0), FloatPoint(j * 20, j * 30), IntSize(100, 100), false);
+            grandChild->setDrawsContent(true);
+            grandChild->setFixedToContainerLayer(!j);
+            child->addChild(grandChild.release());
+        }
+        child->setIsContainerForFixedPositionLayers(true);
+        root->addChild(child.release());
+    }
+    return root.release();
+}
+
+void expectSameDrawProperties(CCLayerImpl* expected, CCLayerImpl* actual)
+{
+    EXPECT_TRANSFORMATION_MATRIX_EQ(expected->drawTransform(), actual->drawTransform());
+    EXPECT_TRANSFORMATION_MATRIX_EQ(expected->screenSpaceTransform(), actual->screenSpaceTransform());
+    EXPECT_RECT_EQ(expected->drawableContentRect(), actual->drawableContentRect());
+    EXPECT_RECT_EQ(expected->visibleContentRect(), actual->visibleContentRect());
+    EXPECT_FLOAT_EQ(expected->drawOpacity(), actual->drawOpacity());
+    EXPECT_EQ(!!expected->renderSurface(), !!actual->renderSurface());
+    ASSERT_EQ(expected->children().size(), actual->children().size());
+    for (size_t i = 0; i < expected->children().size(); ++i)
+        expectSameDrawProperties(expected->children()[i], actual->children()[i]);
+}
+
+TEST(CCLayerTreeHostCommonTest, verifyCachedDrawPropertiesMatchFullComputation)
+{
+    DebugScopedSetImplThread implThread;
+    OwnPtr<CCLayerImpl> cachedRoot = createLargeTreeForCachingTests();
+    OwnPtr<CCLayerImpl> freshRoot = createLargeTreeForCachingTests();
+
+    // Fill the caches of one of the trees.
+    executeCalculateDrawTransformsAndVisibility(cachedRoot.get());
+
+    // Scroll one subtree, and move a layer of another one, as a frame would.
+    CCLayerImpl* roots[] = { cachedRoot.get(), freshRoot.get() };
+    for (size_t i = 0; i < 2; ++i) {
+        roots[i]->children()[3]->setScrollDelta(FloatSize(0, 25));
+        roots[i]->children()[6]->children()[2]->setPosition(FloatPoint(70, 15));
+    }
+
+    // The tree that reuses its cached properties must end up with the same
+    // properties as the tree that computes them all.
+    executeCalculateDrawTransformsAndVisibility(cachedRoot.get());
+    executeCalculateDrawTransformsAndVisibility(freshRoot.get());
+    expectSameDrawProperties(freshRoot.get(), cachedRoot.get());
+
+    // Nothing changed since the last computation.
+    executeCalculateDrawTransformsAndVisibility(cachedRoot.get());
+    expectSameDrawProperties(freshRoot.get(), cachedRoot.get());
+}
+
 } // namespace
@@ -125,6 +125,8 @@ CCLayerTreeHostImpl::CCLayerTreeHostImpl(const CCLayerTreeSettings& settings, CC
     , m_hasTransparentBackground(false)
     , m_needsAnimateLayers(false)
     , m_pinchGestureActive(false)
+    , m_checkerboardedFrameCount(0)
+    , m_checkerboardedTileCount(0)
     , m_fpsCounter(CCFrameRateCounter::create())
     , m_debugRectHistory(CCDebugRectHistory::create())
 {
@@ -274,6 +276,9 @@ bool CCLayerTreeHostImpl::calculateRenderPasses(FrameData& frame)
     CCOcclusionTrackerImpl occlusionTracker(m_rootLayerImpl->renderSurface()->contentRect(), recordMetricsForFrame);
     occlusionTracker.setMinimumTrackingSize(m_settings.minimumOcclusionTrackingSize);
 
+    bool hadMissingTiles = false;
+    int numMissingTiles = 0;
+
     if (settings().showOccludingRects)
         occlusionTracker.setOccludingScreenSpaceRectsContainer(&frame.occludingScreenSpaceRects);
 
@@ -326,6 +331,8 @@ bool CCLayerTreeHostImpl::calculateRenderPasses(FrameData& frame)
             targetRenderPass->setHasOcclusionFromOutsideTargetSurface(true);
 
         if (appendQuadsData.hadMissingTiles) {
+            hadMissingTiles = true;
+            numMissingTiles += appendQuadsData.numMissingTiles;
             bool layerHasAnimatingTransform = it->screenSpaceTransformIsAnimating() || it->drawTransformIsAnimating();
             if (layerHasAnimatingTransform)
                 drawFrame = false;
@@ -350,6 +357,12 @@ bool CCLayerTreeHostImpl::calculateRenderPasses(FrameData& frame)
     if (drawFrame)
         occlusionTracker.overdrawMetrics().recordMetrics(this);
 
+    // Frames drawn with missing tiles show checkerboards where the tiles were not rasterized in time.
+    if (drawFrame && hadMissingTiles) {
+        ++m_checkerboardedFrameCount;
+        m_checkerboardedTileCount += numMissingTiles;
+    }
+
     removeRenderPasses(CullRenderPassesWithNoQuads(), frame);
     m_renderer->decideRenderPassAllocationsForFrame(frame.renderPasses);
     removeRenderPasses(CullRenderPassesWithCachedTextures(*m_renderer), frame);
@@ -1288,6 +1301,8 @@ void CCLayerTreeHostImpl::renderingStats(CCRenderingStats& stats) const
 {
     stats.numFramesSentToScreen = fpsCounter()->currentFrameNumber();
     stats.droppedFrameCount = fpsCounter()->droppedFrameCount();
+    stats.checkerboardedFrameCount = m_checkerboardedFrameCount;
+    stats.checkerboardedTileCount = m_checkerboardedTileCount;
 }
 
 void CCLayerTreeHostImpl::animateScrollbars(double monotonicTime)
@@ -280,6 +280,9 @@ private:
     bool m_pinchGestureActive;
     IntPoint m_previousPinchAnchor;
 
+    int m_checkerboardedFrameCount;
+    int m_checkerboardedTileCount;
+
     OwnPtr<CCPageScaleAnimation> m_pageScaleAnimation;
 
     // This is used for ticking animations slowly when hidden.
@@ -0,0 +1,305 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "CCLayerTreeHostImpl.h"
+
+#include "CCLayerImpl.h"
+#include "CCLayerTilingData.h"
+#include "CCRenderingStats.h"
+#include "CCSingleThreadProxy.h"
+#include "CCTestCommon.h"
+#include "CCTiledLayerImpl.h"
+#include "FakeWebCompositorOutputSurface.h"
+#include "FakeWebGraphicsContext3D.h"
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/values.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+
+using namespace cc;
+using namespace WebKit;
+using namespace WebKitTests;
+
+// Replays layer trees through CCLayerTreeHostImpl while scrolling them with a
+// script, and logs the distribution of the frame times, the dropped frames and
+// the texture upload volume. A scenario is a JSON dictionary:
+//
+//   { "viewport": [w, h],
+//     "root": { "bounds": [w, h], "position": [x, y], "drawsContent": bool,
+//               "opaque": bool, "scrollable": bool, "maxScroll": [x, y],
+//               "children": [ ... ] },
+//     "scroll": [ { "frames": n, "delta": [dx, dy] }, ... ] }
+//
+// Layers that draw content are tiled. The tiles that become visible in a frame
+// are uploaded before the next one, as a commit would, so scrolling into new
+// content checkerboards for one frame. Other scenarios can be replayed with
+// --cc-replay-scenario=<file>. The output surface is a fake context, so the
+// frame times are those of the compositor alone, without the GPU.
+
+namespace {
+
+const char replayScenarioSwitch[] = "cc-replay-scenario";
+
+const double frameBudgetInMilliseconds = 1000.0 / 60;
+const int tileSize = 256;
+
+// A long page scrolled down and back up.
+const char scrollingPageScenario[] =
+    "{ \"viewport\": [1280, 800],"
+    "  \"root\": { \"bounds\": [1280, 800], \"scrollable\": true, \"maxScroll\": [0, 9200],"
+    "    \"children\": [ { \"bounds\": [1280, 10000], \"drawsContent\": true, \"opaque\": true } ] },"
+    "  \"scroll\": [ { \"frames\": 300, \"delta\": [0, 40] }, { \"frames\": 300, \"delta\": [0, -40] } ] }";
+
+class CCLayerTreeHostImplPerfTest : public testing::Test, public CCLayerTreeHostImplClient {
+public:
+    CCLayerTreeHostImplPerfTest()
+        : m_nextLayerId(1)
+        , m_uploadedBytes(0)
+    {
+        CCLayerTreeSettings settings;
+        m_hostImpl = CCLayerTreeHostImpl::create(settings, this);
+        m_hostImpl->initializeRenderer(FakeWebCompositorOutputSurface::create(adoptPtr(new FakeWebGraphicsContext3D)));
+        m_tilePixels.fill(0, tileSize * tileSize * 4);
+    }
+
+    virtual void didLoseContextOnImplThread() OVERRIDE { }
+    virtual void onSwapBuffersCompleteOnImplThread() OVERRIDE { }
+    virtual void onVSyncParametersChanged(double, double) OVERRIDE { }
+    virtual void onCanDrawStateChanged(bool) OVERRIDE { }
+    virtual void setNeedsRedrawOnImplThread() OVERRIDE { }
+    virtual void setNeedsCommitOnImplThread() OVERRIDE { }
+    virtual void postAnimationEventsToMainThreadOnImplThread(PassOwnPtr<CCAnimationEventsVector>, double) OVERRIDE { }
+    virtual void releaseContentsTexturesOnImplThread() OVERRIDE { }
+
+protected:
+    void replay(const std::string& name, const std::string& json)
+    {
+        scoped_ptr<base::Value> value(base::JSONReader::Read(json));
+        base::DictionaryValue* scenario = 0;
+        ASSERT_TRUE(value.get() && value->GetAsDictionary(&scenario)) << name;
+        base::DictionaryValue* root = 0;
+        ASSERT_TRUE(scenario->GetDictionary("root", &root)) << name;
+
+        IntSize viewportSize = sizeFromList(*scenario, "viewport");
+        m_hostImpl->setViewportSize(viewportSize, viewportSize);
+        m_hostImpl->setRootLayer(createLayer(*root));
+
+        // The first frame has nothing to show; it only decides which tiles to
+        // upload.
+        drawFrame();
+        uploadVisibleTiles();
+        m_uploadedBytes = 0;
+
+        CCRenderingStats statsBefore;
+        m_hostImpl->renderingStats(statsBefore);
+
+        Vector<double> frameTimes;
+        int droppedFrames = 0;
+        base::ListValue* segments = 0;
+        if (scenario->GetList("scroll", &segments)) {
+            for (size_t i = 0; i < segments->GetSize(); ++i) {
+                base::DictionaryValue* segment = 0;
+                int frames = 0;
+                if (!segments->GetDictionary(i, &segment) || !segment->GetInteger("frames", &frames))
+                    continue;
+                IntSize delta = sizeFromList(*segment, "delta");
+                for (int frame = 0; frame < frames; ++frame) {
+                    PerfTimer timer;
+                    if (m_hostImpl->scrollBegin(IntPoint(), CCInputHandlerClient::Gesture) == CCInputHandlerClient::ScrollStarted) {
+                        m_hostImpl->scrollBy(IntPoint(), delta);
+                        m_hostImpl->scrollEnd();
+                    }
+                    bool drawn = drawFrame();
+                    double frameTime = timer.Elapsed().InMillisecondsF();
+                    frameTimes.append(frameTime);
+                    if (!drawn || frameTime > frameBudgetInMilliseconds)
+                        ++droppedFrames;
+                    uploadVisibleTiles();
+                }
+            }
+        }
+        ASSERT_FALSE(frameTimes.isEmpty()) << name;
+
+        CCRenderingStats statsAfter;
+        m_hostImpl->renderingStats(statsAfter);
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+        logResult(name, "frame_time_50th", percentile(frameTimes, 50), "ms");
+        logResult(name, "frame_time_90th", percentile(frameTimes, 90), "ms");
+        logResult(name, "frame_time_99th", percentile(frameTimes, 99), "ms");
+        logResult(name, "frame_time_max", frameTimes.last(), "ms");
+        logResult(name, "frames", frameTimes.size(), "frames");
+        logResult(name, "dropped_frames", droppedFrames, "frames");
+        logResult(name, "checkerboarded_frames", statsAfter.checkerboardedFrameCount - statsBefore.checkerboardedFrameCount, "frames");
+        logResult(name, "uploaded_bytes", m_uploadedBytes, "bytes");
+    }
+
+private:
+    struct ReplayedLayer {
+        CCTiledLayerImpl* layer;
+        OwnPtr<CCLayerTilingData> tiler;
+    };
+
+    static IntSize sizeFromList(const base::DictionaryValue& dictionary, const char* key)
+    {
+        const base::ListValue* list = 0;
+        int width = 0;
+        int height = 0;
+        if (dictionary.GetList(key, &list)) {
+            list->GetInteger(0, &width);
+            list->GetInteger(1, &height);
+        }
+        return IntSize(width, height);
+    }
+
+    static double percentile(const Vector<double>& sortedValues, size_t percent)
+    {
+        size_t index = std::min(sortedValues.size() - 1, sortedValues.size() * percent / 100);
+        return sortedValues[index];
+    }
+
+    static void logResult(const std::string& scenario, const char* metric, double value, const char* units)
+    {
+        LogPerfResult(base::StringPrintf("CCLayerTreeHostImplPerfTest_%s_%s", scenario.c_str(), metric).c_str(), value, units);
+    }
+
+    PassOwnPtr<CCLayerImpl> createLayer(const base::DictionaryValue& description)
+    {
+        int id = m_nextLayerId++;
+        IntSize bounds = sizeFromList(description, "bounds");
+        IntSize position = sizeFromList(description, "position");
+
+        bool drawsContent = false;
+        description.GetBoolean("drawsContent", &drawsContent);
+        OwnPtr<CCLayerImpl> layer;
+        if (drawsContent) {
+            OwnPtr<CCTiledLayerImpl> tiledLayer = CCTiledLayerImpl::create(id);
+            OwnPtr<ReplayedLayer> replayed = adoptPtr(new ReplayedLayer);
+            replayed->layer = tiledLayer.get();
+            replayed->tiler = CCLayerTilingData::create(IntSize(tileSize, tileSize), CCLayerTilingData::HasBorderTexels);
+            replayed->tiler->setBounds(bounds);
+            tiledLayer->setTilingData(*replayed->tiler);
+            tiledLayer->setSkipsDraw(false);
+            m_tiledLayers.append(replayed.release());
+            layer = tiledLayer.release();
+        } else
+            layer = CCLayerImpl::create(id);
+
+        layer->setAnchorPoint(FloatPoint());
+        layer->setPosition(FloatPoint(position.width(), position.height()));
+        layer->setBounds(bounds);
+        layer->setContentBounds(bounds);
+        layer->setDrawsContent(drawsContent);
+
+        bool opaque = false;
+        if (description.GetBoolean("opaque", &opaque))
+            layer->setOpaque(opaque);
+        bool scrollable = false;
+        if (description.GetBoolean("scrollable", &scrollable) && scrollable) {
+            layer->setScrollable(true);
+            layer->setMaxScrollPosition(sizeFromList(description, "maxScroll"));
+        }
+
+        const base::ListValue* children = 0;
+        if (description.GetList("children", &children)) {
+            for (size_t i = 0; i < children->GetSize(); ++i) {
+                const base::DictionaryValue* child = 0;
+                if (children->GetDictionary(i, &child))
+                    layer->addChild(createLayer(*child));
+            }
+        }
+        return layer.release();
+    }
+
+    bool drawFrame()
+    {
+        CCLayerTreeHostImpl::FrameData frame;
+        bool drawn = m_hostImpl->prepareToDraw(frame);
+        if (drawn) {
+            m_hostImpl->drawLayers(frame);
+            m_hostImpl->swapBuffers();
+        }
+        m_hostImpl->didDrawAllLayers(frame);
+        return drawn;
+    }
+
+    void uploadVisibleTiles()
+    {
+        CCResourceProvider* resourceProvider = m_hostImpl->resourceProvider();
+        for (size_t index = 0; index < m_tiledLayers.size(); ++index) {
+            ReplayedLayer* replayed = m_tiledLayers[index].get();
+            IntRect visibleRect = replayed->layer->visibleContentRect();
+            if (visibleRect.isEmpty())
+                continue;
+
+            int left, top, right, bottom;
+            replayed->tiler->contentRectToTileIndices(visibleRect, left, top, right, bottom);
+            for (int j = top; j <= bottom; ++j) {
+                for (int i = left; i <= right; ++i) {
+                    if (replayed->layer->hasTextureIdForTileAt(i, j))
+                        continue;
+                    IntRect tileRect(IntPoint(), IntSize(tileSize, tileSize));
+                    CCResourceProvider::ResourceId resourceId = resourceProvider->createResource(CCRenderer::ContentPool, tileRect.size(), GraphicsContext3D::RGBA, CCResourceProvider::TextureUsageAny);
+                    resourceProvider->upload(resourceId, m_tilePixels.data(), tileRect, tileRect, IntSize());
+                    m_uploadedBytes += tileRect.width() * tileRect.height() * 4;
+                    replayed->layer->pushTileProperties(i, j, resourceId, replayed->layer->opaque() ? replayed->tiler->tileBounds(i, j) : IntRect());
+                }
+            }
+        }
+    }
+
+    DebugScopedSetImplThread m_alwaysImplThread;
+    DebugScopedSetMainThreadBlocked m_alwaysMainThreadBlocked;
+    CCScopedSettings m_scopedSettings;
+
+    OwnPtr<CCLayerTreeHostImpl> m_hostImpl;
+    Vector<OwnPtr<ReplayedLayer> > m_tiledLayers;
+    Vector<uint8_t> m_tilePixels;
+    int m_nextLayerId;
+    double m_uploadedBytes;
+};
+
+TEST_F(CCLayerTreeHostImplPerfTest, scrollingPage)
+{
+    replay("scrollingPage", scrollingPageScenario);
+}
+
+// A page of composited cards, each with its own tiles, scrolled down.
+TEST_F(CCLayerTreeHostImplPerfTest, compositedCards)
+{
+    std::string cards;
+    for (int i = 0; i < 120; ++i) {
+        if (i)
+            cards += ",";
+        base::StringAppendF(&cards, "{ \"bounds\": [600, 300], \"position\": [%d, %d], \"drawsContent\": true, \"opaque\": %s }",
+                            20 + (i % 2) * 640, 20 + (i / 2) * 320, i % 3 ? "true" : "false");
+    }
+    std::string scenario = base::StringPrintf(
+        "{ \"viewport\": [1280, 800],"
+        "  \"root\": { \"bounds\": [1280, 800], \"scrollable\": true, \"maxScroll\": [0, 18400],"
+        "    \"children\": [ { \"bounds\": [1280, 19200], \"drawsContent\": true, \"opaque\": true,"
+        "      \"children\": [ %s ] } ] },"
+        "  \"scroll\": [ { \"frames\": 460, \"delta\": [0, 40] } ] }", cards.c_str());
+    replay("compositedCards", scenario);
+}
+
+TEST_F(CCLayerTreeHostImplPerfTest, scenarioFromCommandLine)
+{
+    FilePath path = CommandLine::ForCurrentProcess()->GetSwitchValuePath(replayScenarioSwitch);
+    if (path.empty())
+        return;
+    std::string json;
+    ASSERT_TRUE(file_util::ReadFileToString(path, &json)) << path.value();
+    replay(path.BaseName().MaybeAsASCII(), json);
+}
+
+} // namespace
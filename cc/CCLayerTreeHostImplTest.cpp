@@ -3917,6 +3917,62 @@ TEST_F(CCLayerTreeHostImplTest, surfaceTextureCachingNoPartialSwap)
     }
 }
 
+TEST_F(CCLayerTreeHostImplTest, surfaceTextureCachingRespectsLimit)
+{
+    CCSettings::setPartialSwapEnabled(true);
+
+    CCLayerTreeSettings settings;
+    settings.minimumOcclusionTrackingSize = IntSize();
+    OwnPtr<CCLayerTreeHostImpl> myHostImpl = CCLayerTreeHostImpl::create(settings, this);
+
+    CCLayerImpl* rootPtr;
+    CCLayerImpl* intermediateLayerPtr;
+    CCLayerImpl* surfaceLayerPtr;
+    CCLayerImpl* childPtr;
+
+    setupLayersForTextureCaching(myHostImpl.get(), rootPtr, intermediateLayerPtr, surfaceLayerPtr, childPtr, IntSize(100, 100));
+
+    // The surface texture does not fit in the cache, so it is released once
+    // the frame is drawn.
+    CCRendererGL* renderer = static_cast<CCRendererGL*>(myHostImpl->renderer());
+    renderer->setRenderPassCacheLimitBytes(1024);
+
+    CCRenderPass::Id surfacePassId(0, 0);
+    {
+        CCLayerTreeHostImpl::FrameData frame;
+        EXPECT_TRUE(myHostImpl->prepareToDraw(frame));
+        ASSERT_EQ(2U, frame.renderPasses.size());
+        surfacePassId = frame.renderPasses[0]->id();
+
+        myHostImpl->drawLayers(frame);
+        myHostImpl->didDrawAllLayers(frame);
+    }
+    EXPECT_FALSE(myHostImpl->renderer()->haveCachedResourcesForRenderPassId(surfacePassId));
+
+    // Without a cached texture, the surface must be drawn again.
+    renderer->setRenderPassCacheLimitBytes(1024 * 1024);
+    {
+        CCLayerTreeHostImpl::FrameData frame;
+        EXPECT_TRUE(myHostImpl->prepareToDraw(frame));
+        ASSERT_EQ(2U, frame.renderPasses.size());
+
+        myHostImpl->drawLayers(frame);
+        myHostImpl->didDrawAllLayers(frame);
+    }
+    EXPECT_TRUE(myHostImpl->renderer()->haveCachedResourcesForRenderPassId(surfacePassId));
+
+    // Now that it fits, the surface is drawn from its cached texture.
+    {
+        CCLayerTreeHostImpl::FrameData frame;
+        EXPECT_TRUE(myHostImpl->prepareToDraw(frame));
+        ASSERT_EQ(1U, frame.renderPasses.size());
+
+        myHostImpl->drawLayers(frame);
+        myHostImpl->didDrawAllLayers(frame);
+    }
+    EXPECT_TRUE(myHostImpl->renderer()->haveCachedResourcesForRenderPassId(surfacePassId));
+}
+
 TEST_F(CCLayerTreeHostImplTest, releaseContentsTextureShouldTriggerCommit)
 {
     m_hostImpl->releaseContentsTextures();
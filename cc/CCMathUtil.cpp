@@ -120,6 +120,12 @@ FloatRect CCMathUtil::mapClippedRect(const WebTransformationMatrix& transform, c
 
 FloatRect CCMathUtil::projectClippedRect(const WebTransformationMatrix& transform, const FloatRect& srcRect)
 {
+    if (transform.isIdentityOrTranslation()) {
+        FloatRect projectedRect(srcRect);
+        projectedRect.move(static_cast<float>(transform.m41()), static_cast<float>(transform.m42()));
+        return projectedRect;
+    }
+
     // Perform the projection, but retain the result in homogeneous coordinates.
     FloatQuad q = FloatQuad(FloatRect(srcRect));
     HomogeneousCoordinate h1 = projectHomogeneousPoint(transform, q.p1());
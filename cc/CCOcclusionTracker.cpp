@@ -19,14 +19,39 @@ using WebKit::WebTransformationMatrix;
 
 namespace cc {
 
+static const size_t defaultMaximumOcclusionRects = 32;
+
 template<typename LayerType, typename RenderSurfaceType>
 CCOcclusionTrackerBase<LayerType, RenderSurfaceType>::CCOcclusionTrackerBase(IntRect rootTargetRect, bool recordMetricsForFrame)
     : m_rootTargetRect(rootTargetRect)
     , m_overdrawMetrics(CCOverdrawMetrics::create(recordMetricsForFrame))
+    , m_maximumOcclusionRects(defaultMaximumOcclusionRects)
     , m_occludingScreenSpaceRects(0)
 {
 }
 
+static inline bool rectHasLargerArea(const WebCore::IntRect& a, const WebCore::IntRect& b)
+{
+    return static_cast<int64_t>(a.width()) * a.height() > static_cast<int64_t>(b.width()) * b.height();
+}
+
+// Replaces |occlusion| with its |maximumRects| largest rects when it holds
+// more. This only removes occlusion, so the result is always safe to use.
+static inline void simplifyOcclusion(Region& occlusion, size_t maximumRects)
+{
+    if (occlusion.isRect())
+        return;
+
+    Vector<WebCore::IntRect> rects = occlusion.rects();
+    if (rects.size() <= maximumRects)
+        return;
+
+    std::partial_sort(rects.begin(), rects.begin() + maximumRects, rects.end(), rectHasLargerArea);
+    occlusion = Region();
+    for (size_t i = 0; i < maximumRects; ++i)
+        occlusion.unite(rects[i]);
+}
+
 template<typename LayerType, typename RenderSurfaceType>
 void CCOcclusionTrackerBase<LayerType, RenderSurfaceType>::enterLayer(const CCLayerIteratorPosition<LayerType>& layerIterator)
 {
@@ -230,6 +255,8 @@ void CCOcclusionTrackerBase<LayerType, RenderSurfaceType>::leaveToRenderTarget(c
         m_stack[lastIndex - 1].occlusionInScreen.unite(m_stack[lastIndex].occlusionInScreen);
         m_stack[lastIndex - 1].occlusionInTarget.unite(oldTargetOcclusionInNewTarget);
         m_stack.removeLast();
+        simplifyOcclusion(m_stack.last().occlusionInScreen, m_maximumOcclusionRects);
+        simplifyOcclusion(m_stack.last().occlusionInTarget, m_maximumOcclusionRects);
     } else {
         // Replace the top of the stack with the new pushed surface. Copy the occluded screen region to the top.
         m_stack.last().target = newTarget;
@@ -287,8 +314,10 @@ void CCOcclusionTrackerBase<LayerType, RenderSurfaceType>::markOccludedBehindLay
         return;
 
     IntRect clipRectInTarget = layerClipRectInTarget(layer);
-    if (layerTransformsToTargetKnown(layer))
+    if (layerTransformsToTargetKnown(layer)) {
         addOcclusionBehindLayer<LayerType>(m_stack.last().occlusionInTarget, layer, layer->drawTransform(), opaqueContents, clipRectInTarget, m_minimumTrackingSize, 0);
+        simplifyOcclusion(m_stack.last().occlusionInTarget, m_maximumOcclusionRects);
+    }
 
     // We must clip the occlusion within the layer's clipRectInTarget within screen space as well. If the clip rect can't be moved to screen space and
     // remain rectilinear, then we don't add any occlusion in screen space.
@@ -302,6 +331,7 @@ void CCOcclusionTrackerBase<LayerType, RenderSurfaceType>::markOccludedBehindLay
             return;
         IntRect clipRectInScreen = intersection(m_rootTargetRect, enclosedIntRect(clipQuadInScreen.boundingBox()));
         addOcclusionBehindLayer<LayerType>(m_stack.last().occlusionInScreen, layer, layer->screenSpaceTransform(), opaqueContents, clipRectInScreen, m_minimumTrackingSize, m_occludingScreenSpaceRects);
+        simplifyOcclusion(m_stack.last().occlusionInScreen, m_maximumOcclusionRects);
     }
 }
 
@@ -343,6 +373,14 @@ bool CCOcclusionTrackerBase<LayerType, RenderSurfaceType>::occluded(const LayerT
 // the resulting unoccluded region is not rectangular, we return a rect containing it.
 static inline IntRect rectSubtractRegion(const IntRect& rect, const Region& region)
 {
+    // Most rects are either not occluded at all, or fully occluded.
+    if (rect.isEmpty())
+        return IntRect();
+    if (!region.bounds().intersects(rect))
+        return rect;
+    if (region.contains(rect))
+        return IntRect();
+
     Region rectRegion(rect);
     rectRegion.subtract(region);
     return rectRegion.bounds();
@@ -49,6 +49,11 @@ public:
 
     void setMinimumTrackingSize(const IntSize& size) { m_minimumTrackingSize = size; }
 
+    // Limits how many rects the tracked occlusion regions may hold. Past the
+    // limit, only the largest rects are kept, so testing for occlusion stays
+    // cheap on pages with many small opaque layers.
+    void setMaximumOcclusionRects(size_t count) { m_maximumOcclusionRects = count; }
+
     // The following is used for visualization purposes.
     void setOccludingScreenSpaceRectsContainer(Vector<IntRect>* rects) { m_occludingScreenSpaceRects = rects; }
 
@@ -91,6 +96,7 @@ private:
     IntRect m_rootTargetRect;
     OwnPtr<CCOverdrawMetrics> m_overdrawMetrics;
     IntSize m_minimumTrackingSize;
+    size_t m_maximumOcclusionRects;
 
     // This is used for visualizing the occlusion tracking process.
     Vector<IntRect>* m_occludingScreenSpaceRects;
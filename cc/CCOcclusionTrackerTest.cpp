@@ -3012,4 +3012,41 @@ protected:
 
 ALL_CCOCCLUSIONTRACKER_TEST(CCOcclusionTrackerTestMinimumTrackingSize);
 
+template<class Types, bool opaqueLayers>
+class CCOcclusionTrackerTestMaximumOcclusionRects : public CCOcclusionTrackerTest<Types, opaqueLayers> {
+protected:
+    void runMyTest()
+    {
+        typename Types::ContentLayerType* parent = this->createRoot(this->identityMatrix, FloatPoint(0, 0), IntSize(400, 400));
+        // A diagonal of small layers, and a large layer that they do not touch.
+        typename Types::LayerType* large = this->createDrawingLayer(parent, this->identityMatrix, FloatPoint(200, 0), IntSize(200, 100), true);
+        typename Types::LayerType* small[4];
+        for (int i = 0; i < 4; ++i)
+            small[i] = this->createDrawingLayer(parent, this->identityMatrix, FloatPoint(i * 20, 100 + i * 20), IntSize(10, 10), true);
+        this->calcDrawEtc(parent);
+
+        TestCCOcclusionTrackerWithClip<typename Types::LayerType, typename Types::RenderSurfaceType> occlusion(IntRect(0, 0, 1000, 1000));
+        occlusion.setLayerClipRect(IntRect(0, 0, 1000, 1000));
+        occlusion.setMaximumOcclusionRects(3);
+
+        this->visitLayer(small[3], occlusion);
+        this->visitLayer(small[2], occlusion);
+        this->visitLayer(large, occlusion);
+
+        EXPECT_EQ(3u, occlusion.occlusionInScreenSpace().rects().size());
+        EXPECT_EQ(3u, occlusion.occlusionInTargetSurface().rects().size());
+
+        // Past the limit, the smallest rects are dropped and the large one is kept.
+        this->visitLayer(small[1], occlusion);
+        this->visitLayer(small[0], occlusion);
+
+        EXPECT_EQ(3u, occlusion.occlusionInScreenSpace().rects().size());
+        EXPECT_EQ(3u, occlusion.occlusionInTargetSurface().rects().size());
+        EXPECT_TRUE(occlusion.occlusionInScreenSpace().contains(IntRect(200, 0, 200, 100)));
+        EXPECT_TRUE(occlusion.occlusionInTargetSurface().contains(IntRect(200, 0, 200, 100)));
+    }
+};
+
+ALL_CCOCCLUSIONTRACKER_TEST(CCOcclusionTrackerTestMaximumOcclusionRects);
+
 } // namespace
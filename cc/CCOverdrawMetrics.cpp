@@ -153,11 +153,16 @@ void CCOverdrawMetrics::recordMetricsInternal(MetricsType metricsType, const Lay
         WebKit::Platform::current()->histogramCustomCounts("Renderer4.pixelCountOpaque_Draw", static_cast<int>(normalization * m_pixelsDrawnOpaque), 100, 1000000, 50);
         WebKit::Platform::current()->histogramCustomCounts("Renderer4.pixelCountTranslucent_Draw", static_cast<int>(normalization * m_pixelsDrawnTranslucent), 100, 1000000, 50);
         WebKit::Platform::current()->histogramCustomCounts("Renderer4.pixelCountCulled_Draw", static_cast<int>(normalization * m_pixelsCulledForDrawing), 100, 1000000, 50);
+        WebKit::Platform::current()->histogramCustomCounts("Renderer4.pixelCountBeforeCulling_Draw", static_cast<int>(normalization * pixelsDrawnBeforeCulling()), 100, 1000000, 50);
 
         {
             TRACE_COUNTER_ID1("cc", "DrawPixelsCulled", layerTreeHost, m_pixelsCulledForDrawing);
             TRACE_EVENT2("cc", "CCOverdrawMetrics", "PixelsDrawnOpaque", m_pixelsDrawnOpaque, "PixelsDrawnTranslucent", m_pixelsDrawnTranslucent);
         }
+        {
+            // This must be in a different scope than the TRACE_EVENT2 above.
+            TRACE_EVENT2("cc", "CCOverdrawCullingMetrics", "PixelsBeforeCulling", pixelsDrawnBeforeCulling(), "PixelsAfterCulling", m_pixelsDrawnOpaque + m_pixelsDrawnTranslucent);
+        }
         break;
     case UpdateAndCommit:
         WebKit::Platform::current()->histogramCustomCounts("Renderer4.pixelCountPainted", static_cast<int>(normalization * m_pixelsPainted), 100, 1000000, 50);
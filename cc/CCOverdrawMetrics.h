@@ -48,6 +48,8 @@ public:
     float pixelsDrawnOpaque() const { return m_pixelsDrawnOpaque; }
     float pixelsDrawnTranslucent() const { return m_pixelsDrawnTranslucent; }
     float pixelsCulledForDrawing() const { return m_pixelsCulledForDrawing; }
+    // The pixels that would have been drawn without occlusion culling.
+    float pixelsDrawnBeforeCulling() const { return m_pixelsDrawnOpaque + m_pixelsDrawnTranslucent + m_pixelsCulledForDrawing; }
     float pixelsPainted() const { return m_pixelsPainted; }
     float pixelsUploadedOpaque() const { return m_pixelsUploadedOpaque; }
     float pixelsUploadedTranslucent() const { return m_pixelsUploadedTranslucent; }
@@ -22,6 +22,7 @@ CCPrioritizedTexture::CCPrioritizedTexture(CCPrioritizedTextureManager* manager,
     , m_priority(CCPriorityCalculator::lowestPriority())
     , m_isAbovePriorityCutoff(false)
     , m_isSelfManaged(false)
+    , m_useAtlas(false)
     , m_backing(0)
     , m_manager(0)
 {
@@ -62,6 +63,16 @@ void CCPrioritizedTexture::setDimensions(IntSize size, GC3Denum format)
     }
 }
 
+void CCPrioritizedTexture::setUseAtlas(bool useAtlas)
+{
+    if (m_useAtlas == useAtlas)
+        return;
+    m_useAtlas = useAtlas;
+    ASSERT(m_manager || !m_backing);
+    if (m_manager)
+        m_manager->returnBackingTexture(this);
+}
+
 bool CCPrioritizedTexture::requestLate()
 {
     if (!m_manager)
@@ -125,13 +136,14 @@ void CCPrioritizedTexture::setToSelfManagedMemoryPlaceholder(size_t bytes)
     m_bytes = bytes;
 }
 
-CCPrioritizedTexture::Backing::Backing(unsigned id, CCResourceProvider* resourceProvider, IntSize size, GC3Denum format)
+CCPrioritizedTexture::Backing::Backing(unsigned id, CCResourceProvider* resourceProvider, IntSize size, GC3Denum format, bool useAtlas)
     : CCTexture(id, size, format)
     , m_owner(0)
     , m_priorityAtLastPriorityUpdate(CCPriorityCalculator::lowestPriority())
     , m_ownerExistedAtLastPriorityUpdate(false)
     , m_wasAbovePriorityCutoffAtLastPriorityUpdate(false)
     , m_resourceHasBeenDeleted(false)
+    , m_useAtlas(useAtlas)
 #ifndef NDEBUG
     , m_resourceProvider(resourceProvider)
 #endif
@@ -38,6 +38,11 @@ public:
     IntSize size() const { return m_size; }
     size_t bytes() const { return m_bytes; }
 
+    // Small textures that are only uploaded to (not rendered to) can share an
+    // atlas texture with others. See CCResourceProvider::createAtlasedResource().
+    void setUseAtlas(bool);
+    bool useAtlas() const { return m_useAtlas; }
+
     // Set priority for the requested texture. 
     void setRequestPriority(int priority) { m_priority = priority; }
     int requestPriority() const { return m_priority; }
@@ -87,10 +92,12 @@ private:
     class Backing : public CCTexture {
         WTF_MAKE_NONCOPYABLE(Backing);
     public:
-        Backing(unsigned id, CCResourceProvider*, IntSize, GC3Denum format);
+        Backing(unsigned id, CCResourceProvider*, IntSize, GC3Denum format, bool useAtlas);
         ~Backing();
         void updatePriority();
 
+        bool useAtlas() const { return m_useAtlas; }
+
         CCPrioritizedTexture* owner() { return m_owner; }
         bool hadOwnerAtLastPriorityUpdate() const { return m_ownerExistedAtLastPriorityUpdate; }
         int requestPriorityAtLastPriorityUpdate() const { return m_priorityAtLastPriorityUpdate; }
@@ -106,6 +113,7 @@ private:
         bool m_ownerExistedAtLastPriorityUpdate;
         bool m_wasAbovePriorityCutoffAtLastPriorityUpdate;
         bool m_resourceHasBeenDeleted;
+        bool m_useAtlas;
 #ifndef NDEBUG
         CCResourceProvider* m_resourceProvider;
 #endif
@@ -128,6 +136,7 @@ private:
     int m_priority;
     bool m_isAbovePriorityCutoff;
     bool m_isSelfManaged;
+    bool m_useAtlas;
 
     Backing* m_backing;
     CCPrioritizedTextureManager* m_manager;
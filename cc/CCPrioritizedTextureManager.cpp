@@ -183,7 +183,7 @@ void CCPrioritizedTextureManager::acquireBackingTextureIfNeeded(CCPrioritizedTex
     for (BackingSet::iterator it = m_backings.begin(); it != m_backings.end(); ++it) {
         if ((*it)->hadOwnerAtLastPriorityUpdate() && (*it)->wasAbovePriorityCutoffAtLastPriorityUpdate())
             break;
-        if ((*it)->size() == texture->size() && (*it)->format() == texture->format()) {
+        if ((*it)->size() == texture->size() && (*it)->format() == texture->format() && (*it)->useAtlas() == texture->useAtlas()) {
             backing = (*it);
             break;
         }
@@ -192,7 +192,7 @@ void CCPrioritizedTextureManager::acquireBackingTextureIfNeeded(CCPrioritizedTex
     // Otherwise reduce memory and just allocate a new backing texures.
     if (!backing) {
         evictBackingsToReduceMemory(m_memoryAvailableBytes - texture->bytes(), RespectManagerPriorityCutoff, resourceProvider);
-        backing = createBacking(texture->size(), texture->format(), resourceProvider);
+        backing = createBacking(texture->size(), texture->format(), texture->useAtlas(), resourceProvider);
     }
 
     // Move the used backing texture to the end of the eviction list.
@@ -334,12 +334,16 @@ void CCPrioritizedTextureManager::returnBackingTexture(CCPrioritizedTexture* tex
     }
 }
 
-CCPrioritizedTexture::Backing* CCPrioritizedTextureManager::createBacking(IntSize size, GC3Denum format, CCResourceProvider* resourceProvider)
+CCPrioritizedTexture::Backing* CCPrioritizedTextureManager::createBacking(IntSize size, GC3Denum format, bool useAtlas, CCResourceProvider* resourceProvider)
 {
     ASSERT(CCProxy::isImplThread() && CCProxy::isMainThreadBlocked());
     ASSERT(resourceProvider);
-    CCResourceProvider::ResourceId resourceId = resourceProvider->createResource(m_pool, size, format, CCResourceProvider::TextureUsageAny);
-    CCPrioritizedTexture::Backing* backing = new CCPrioritizedTexture::Backing(resourceId, resourceProvider, size, format);
+    CCResourceProvider::ResourceId resourceId;
+    if (useAtlas)
+        resourceId = resourceProvider->createAtlasedResource(m_pool, size, format);
+    else
+        resourceId = resourceProvider->createResource(m_pool, size, format, CCResourceProvider::TextureUsageAny);
+    CCPrioritizedTexture::Backing* backing = new CCPrioritizedTexture::Backing(resourceId, resourceProvider, size, format, useAtlas);
     m_memoryUseBytes += backing->bytes();
     // Put backing texture at the front for eviction, since it isn't in use yet.
     m_backings.insertBefore(m_backings.begin(), backing);
@@ -111,7 +111,7 @@ private:
 
     void updateBackingsPriorities();
     void evictBackingsToReduceMemory(size_t limitBytes, EvictionPriorityPolicy, CCResourceProvider*);
-    CCPrioritizedTexture::Backing* createBacking(IntSize, GC3Denum format, CCResourceProvider*);
+    CCPrioritizedTexture::Backing* createBacking(IntSize, GC3Denum format, bool useAtlas, CCResourceProvider*);
     void evictBackingResource(CCPrioritizedTexture::Backing*, CCResourceProvider*);
 
 #if !ASSERT_DISABLED
@@ -75,6 +75,18 @@ int CCPriorityCalculator::priorityFromDistance(const IntRect& visibleRect, const
     return min(notVisibleLimitPriority, notVisibleBasePriority + distance);
 }
 
+// static
+int CCPriorityCalculator::priorityFromDistance(const IntRect& visibleRect, const IntRect& predictedVisibleRect, const IntRect& textureRect, bool drawsToRootSurface)
+{
+    int distance = manhattanDistance(visibleRect, textureRect);
+    if (!distance)
+        return visiblePriority(drawsToRootSurface);
+    // Textures that are predicted to be visible still come after the visible ones.
+    if (!predictedVisibleRect.isEmpty())
+        distance = min(distance, manhattanDistance(predictedVisibleRect, textureRect) + 1);
+    return min(notVisibleLimitPriority, notVisibleBasePriority + distance);
+}
+
 // static
 int CCPriorityCalculator::smallAnimatedLayerMinPriority()
 {
@@ -18,6 +18,10 @@ public:
     static int renderSurfacePriority();
     static int lingeringPriority(int previousPriority);
     static int priorityFromDistance(const IntRect& visibleRect, const IntRect& textureRect, bool drawsToRootSurface);
+    // Like priorityFromDistance, but textures close to where the visible rect
+    // is predicted to be soon are prioritized as though they were that close
+    // to being visible.
+    static int priorityFromDistance(const IntRect& visibleRect, const IntRect& predictedVisibleRect, const IntRect& textureRect, bool drawsToRootSurface);
     static int smallAnimatedLayerMinPriority();
 
     static inline int highestPriority() { return std::numeric_limits<int>::min(); }
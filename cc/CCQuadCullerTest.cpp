@@ -130,6 +130,7 @@ TEST(CCQuadCullerTest, verifyCullChildLinesUpTopLeft)
     EXPECT_NEAR(occlusionTracker.overdrawMetrics().pixelsDrawnOpaque(), 90000, 1);
     EXPECT_NEAR(occlusionTracker.overdrawMetrics().pixelsDrawnTranslucent(), 0, 1);
     EXPECT_NEAR(occlusionTracker.overdrawMetrics().pixelsCulledForDrawing(), 40000, 1);
+    EXPECT_NEAR(occlusionTracker.overdrawMetrics().pixelsDrawnBeforeCulling(), 130000, 1);
 }
 
 TEST(CCQuadCullerTest, verifyCullWhenChildOpacityNotOne)
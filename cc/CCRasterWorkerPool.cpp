@@ -0,0 +1,102 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "CCRasterWorkerPool.h"
+
+#include "base/stringprintf.h"
+#include "base/threading/simple_thread.h"
+
+namespace cc {
+
+class CCRasterWorkerPool::Worker : public base::SimpleThread {
+public:
+    Worker(CCRasterWorkerPool* pool, int threadIndex)
+        : base::SimpleThread(base::StringPrintf("CompositorRasterWorker%d", threadIndex + 1))
+        , m_pool(pool)
+        , m_threadIndex(threadIndex)
+    {
+    }
+
+    virtual void Run() OVERRIDE
+    {
+        m_pool->runTasks(m_threadIndex);
+    }
+
+private:
+    CCRasterWorkerPool* m_pool;
+    int m_threadIndex;
+};
+
+PassOwnPtr<CCRasterWorkerPool> CCRasterWorkerPool::create(int numThreads)
+{
+    return adoptPtr(new CCRasterWorkerPool(numThreads));
+}
+
+CCRasterWorkerPool::CCRasterWorkerPool(int numThreads)
+    : m_hasTasksCondition(&m_lock)
+    , m_tasksDoneCondition(&m_lock)
+    , m_runningTaskCount(0)
+    , m_shutdown(false)
+{
+    ASSERT(numThreads > 0);
+    for (int i = 0; i < numThreads; ++i) {
+        m_workers.append(adoptPtr(new Worker(this, i)));
+        m_workers.last()->Start();
+    }
+}
+
+CCRasterWorkerPool::~CCRasterWorkerPool()
+{
+    waitForTasks();
+
+    {
+        base::AutoLock lock(m_lock);
+        m_shutdown = true;
+        m_hasTasksCondition.Broadcast();
+    }
+    for (size_t i = 0; i < m_workers.size(); ++i)
+        m_workers[i]->Join();
+}
+
+void CCRasterWorkerPool::postTask(PassOwnPtr<Task> task)
+{
+    base::AutoLock lock(m_lock);
+    m_pendingTasks.append(task.leakPtr());
+    m_hasTasksCondition.Signal();
+}
+
+void CCRasterWorkerPool::waitForTasks()
+{
+    base::AutoLock lock(m_lock);
+    while (!m_pendingTasks.isEmpty() || m_runningTaskCount)
+        m_tasksDoneCondition.Wait();
+}
+
+void CCRasterWorkerPool::runTasks(int threadIndex)
+{
+    base::AutoLock lock(m_lock);
+    while (true) {
+        if (m_pendingTasks.isEmpty()) {
+            if (m_shutdown)
+                return;
+            m_hasTasksCondition.Wait();
+            continue;
+        }
+
+        OwnPtr<Task> task = adoptPtr(m_pendingTasks.takeFirst());
+        ++m_runningTaskCount;
+        {
+            base::AutoUnlock unlock(m_lock);
+            task->run(threadIndex);
+            task.clear();
+        }
+        --m_runningTaskCount;
+        if (m_pendingTasks.isEmpty() && !m_runningTaskCount)
+            m_tasksDoneCondition.Broadcast();
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,63 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CCRasterWorkerPool_h
+#define CCRasterWorkerPool_h
+
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include <wtf/Deque.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+
+namespace cc {
+
+// A fixed set of threads that rasterize tiles for the main thread. Tasks are
+// run in the order they were posted, and the main thread waits for them with
+// waitForTasks() before the rasterized tiles are uploaded.
+class CCRasterWorkerPool {
+    WTF_MAKE_NONCOPYABLE(CCRasterWorkerPool);
+public:
+    class Task {
+    public:
+        virtual ~Task() { }
+
+        // Called on a worker thread. threadIndex is in [0, numThreads()), and
+        // no other task runs with the same index at the same time.
+        virtual void run(int threadIndex) = 0;
+    };
+
+    static PassOwnPtr<CCRasterWorkerPool> create(int numThreads);
+    ~CCRasterWorkerPool();
+
+    int numThreads() const { return m_workers.size(); }
+
+    void postTask(PassOwnPtr<Task>);
+
+    // Blocks until all the posted tasks have run.
+    void waitForTasks();
+
+private:
+    class Worker;
+
+    explicit CCRasterWorkerPool(int numThreads);
+
+    // Runs tasks on the worker thread until the pool shuts down.
+    void runTasks(int threadIndex);
+
+    base::Lock m_lock;
+    base::ConditionVariable m_hasTasksCondition;
+    base::ConditionVariable m_tasksDoneCondition;
+    Deque<Task*> m_pendingTasks;
+    int m_runningTaskCount;
+    bool m_shutdown;
+
+    Vector<OwnPtr<Worker> > m_workers;
+};
+
+} // namespace cc
+
+#endif // CCRasterWorkerPool_h
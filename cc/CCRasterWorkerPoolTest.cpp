@@ -0,0 +1,78 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "CCRasterWorkerPool.h"
+
+#include "base/synchronization/lock.h"
+#include <gtest/gtest.h>
+
+using namespace cc;
+
+namespace {
+
+class CountingTask : public CCRasterWorkerPool::Task {
+public:
+    CountingTask(base::Lock* lock, Vector<int>* runsPerThread)
+        : m_lock(lock)
+        , m_runsPerThread(runsPerThread)
+    {
+    }
+
+    virtual void run(int threadIndex) OVERRIDE
+    {
+        base::AutoLock lock(*m_lock);
+        ASSERT_GE(threadIndex, 0);
+        ASSERT_LT(threadIndex, static_cast<int>(m_runsPerThread->size()));
+        (*m_runsPerThread)[threadIndex]++;
+    }
+
+private:
+    base::Lock* m_lock;
+    Vector<int>* m_runsPerThread;
+};
+
+TEST(CCRasterWorkerPoolTest, waitForTasksRunsAllTasks)
+{
+    const int numThreads = 3;
+    const int numTasks = 50;
+    OwnPtr<CCRasterWorkerPool> pool = CCRasterWorkerPool::create(numThreads);
+    EXPECT_EQ(numThreads, pool->numThreads());
+
+    base::Lock lock;
+    Vector<int> runsPerThread(numThreads);
+    runsPerThread.fill(0);
+    for (int i = 0; i < numTasks; ++i)
+        pool->postTask(adoptPtr(new CountingTask(&lock, &runsPerThread)));
+    pool->waitForTasks();
+
+    int runs = 0;
+    for (int i = 0; i < numThreads; ++i)
+        runs += runsPerThread[i];
+    EXPECT_EQ(numTasks, runs);
+
+    // The pool can be reused after waiting.
+    pool->postTask(adoptPtr(new CountingTask(&lock, &runsPerThread)));
+    pool->waitForTasks();
+    runs = 0;
+    for (int i = 0; i < numThreads; ++i)
+        runs += runsPerThread[i];
+    EXPECT_EQ(numTasks + 1, runs);
+}
+
+TEST(CCRasterWorkerPoolTest, destructionRunsPendingTasks)
+{
+    base::Lock lock;
+    Vector<int> runsPerThread(1);
+    runsPerThread.fill(0);
+    {
+        OwnPtr<CCRasterWorkerPool> pool = CCRasterWorkerPool::create(1);
+        for (int i = 0; i < 10; ++i)
+            pool->postTask(adoptPtr(new CountingTask(&lock, &runsPerThread)));
+    }
+    EXPECT_EQ(10, runsPerThread[0]);
+}
+
+} // namespace
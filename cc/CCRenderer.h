@@ -69,13 +69,28 @@ public:
 
     virtual void setVisible(bool) = 0;
 
+    // The number of quads drawn in the last frame, and the number of draw
+    // calls that were used to draw them.
+    int lastFrameQuadCount() const { return m_lastFrameQuadCount; }
+    int lastFrameDrawCallCount() const { return m_lastFrameDrawCallCount; }
+
 protected:
     explicit CCRenderer(CCRendererClient* client)
         : m_client(client)
+        , m_frameQuadCount(0)
+        , m_frameDrawCallCount(0)
+        , m_lastFrameQuadCount(0)
+        , m_lastFrameDrawCallCount(0)
     {
     }
 
     CCRendererClient* m_client;
+
+    // The counts for the frame being drawn.
+    int m_frameQuadCount;
+    int m_frameDrawCallCount;
+    int m_lastFrameQuadCount;
+    int m_lastFrameDrawCallCount;
 };
 
 }
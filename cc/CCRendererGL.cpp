@@ -81,6 +81,12 @@ CCRendererGL::CCRendererGL(CCRendererClient* client,
     , m_isFramebufferDiscarded(false)
     , m_isUsingBindUniform(false)
     , m_visible(true)
+    , m_textureQuadProgramId(0)
+    , m_textureQuadTextureId(0)
+    , m_textureQuadBatchTextureId(0)
+    , m_textureQuadBatchBlending(false)
+    , m_blendEnabled(false)
+    , m_scissorEnabled(false)
 {
     ASSERT(m_context);
 }
@@ -128,6 +134,8 @@ bool CCRendererGL::initialize()
 
     m_capabilities.usingEglImage = extensions.count("GL_OES_EGL_image_external");
 
+    m_capabilities.usingPixelBuffers = extensions.count("GL_CHROMIUM_pixel_transfer_buffer_object");
+
     GLC(m_context, m_context->getIntegerv(GraphicsContext3D::MAX_TEXTURE_SIZE, &m_capabilities.maxTextureSize));
     m_capabilities.bestTextureFormat = PlatformColor::bestTextureFormat(m_context, extensions.count("GL_EXT_texture_format_BGRA8888"));
 
@@ -229,6 +237,10 @@ void CCRendererGL::beginDrawingFrame(DrawingFrame& frame)
     GLC(m_context, m_context->colorMask(true, true, true, true));
     GLC(m_context, m_context->enable(GraphicsContext3D::BLEND));
     GLC(m_context, m_context->blendFunc(GraphicsContext3D::ONE, GraphicsContext3D::ONE_MINUS_SRC_ALPHA));
+    m_blendEnabled = true;
+    m_scissorEnabled = false;
+    m_textureQuadProgramId = 0;
+    m_textureQuadTextureId = 0;
 }
 
 void CCRendererGL::doNoOp()
@@ -239,10 +251,18 @@ void CCRendererGL::doNoOp()
 
 void CCRendererGL::drawQuad(DrawingFrame& frame, const CCDrawQuad* quad)
 {
-    if (quad->needsBlending())
-        GLC(m_context, m_context->enable(GraphicsContext3D::BLEND));
-    else
-        GLC(m_context, m_context->disable(GraphicsContext3D::BLEND));
+    if (quad->material() == CCDrawQuad::TextureContent && CCTextureDrawQuad::materialCast(quad)->premultipliedAlpha()) {
+        batchTextureQuad(frame, CCTextureDrawQuad::materialCast(quad));
+        return;
+    }
+    flushTextureQuadBatch();
+
+    setBlendEnabled(quad->needsBlending());
+
+    if (quad->material() != CCDrawQuad::TextureContent) {
+        m_textureQuadProgramId = 0;
+        m_textureQuadTextureId = 0;
+    }
 
     switch (quad->material()) {
     case CCDrawQuad::Invalid:
@@ -324,6 +344,7 @@ void CCRendererGL::drawDebugBorderQuad(const DrawingFrame& frame, const CCDebugB
 
     // The indices for the line are stored in the same array as the triangle indices.
     GLC(context(), context()->drawElements(GraphicsContext3D::LINE_LOOP, 4, GraphicsContext3D::UNSIGNED_SHORT, 6 * sizeof(unsigned short)));
+    ++m_frameDrawCallCount;
 }
 
 static inline SkBitmap applyFilters(CCRendererGL* renderer, const WebKit::WebFilterOperations& filters, CCScopedTexture* sourceTexture)
@@ -623,8 +644,14 @@ void CCRendererGL::drawTileQuad(const DrawingFrame& frame, const CCTileDrawQuad*
     float vertexTexScaleX = tileRect.width() / clampRect.width();
     float vertexTexScaleY = tileRect.height() / clampRect.height();
 
-    // Map to normalized texture coordinates.
-    const IntSize& textureSize = quad->textureSize();
+    // Map to normalized texture coordinates. The clamping above happens before
+    // this, so it also keeps sampling inside the tile when it is in an atlas.
+    CCResourceProvider::ScopedReadLockGL quadResourceLock(m_resourceProvider, quad->resourceId());
+    IntSize textureSize = quad->textureSize();
+    if (quadResourceLock.inAtlas()) {
+        textureOffset.move(quadResourceLock.atlasRect().x(), quadResourceLock.atlasRect().y());
+        textureSize = quadResourceLock.atlasSize();
+    }
     float fragmentTexTranslateX = textureOffset.x() / textureSize.width();
     float fragmentTexTranslateY = textureOffset.y() / textureSize.height();
     float fragmentTexScaleX = clampRect.width() / textureSize.width();
@@ -665,7 +692,6 @@ void CCRendererGL::drawTileQuad(const DrawingFrame& frame, const CCTileDrawQuad*
     GLC(context(), context()->useProgram(uniforms.program));
     GLC(context(), context()->uniform1i(uniforms.samplerLocation, 0));
     GLC(context(), context()->activeTexture(GraphicsContext3D::TEXTURE0));
-    CCResourceProvider::ScopedReadLockGL quadResourceLock(m_resourceProvider, quad->resourceId());
     GLC(context(), context()->bindTexture(GraphicsContext3D::TEXTURE_2D, quadResourceLock.textureId()));
     GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MIN_FILTER, quad->textureFilter()));
     GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MAG_FILTER, quad->textureFilter()));
@@ -877,21 +903,17 @@ void CCRendererGL::drawTextureQuad(const DrawingFrame& frame, const CCTextureDra
         binding.set(textureProgramFlip());
     else
         binding.set(textureProgram());
-    GLC(context(), context()->useProgram(binding.programId));
-    GLC(context(), context()->uniform1i(binding.samplerLocation, 0));
-    const FloatRect& uvRect = quad->uvRect();
-    GLC(context(), context()->uniform4f(binding.texTransformLocation, uvRect.x(), uvRect.y(), uvRect.width(), uvRect.height()));
+    if (m_textureQuadProgramId != static_cast<unsigned>(binding.programId)) {
+        GLC(context(), context()->useProgram(binding.programId));
+        GLC(context(), context()->uniform1i(binding.samplerLocation, 0));
+        m_textureQuadProgramId = binding.programId;
+    }
 
-    GLC(context(), context()->activeTexture(GraphicsContext3D::TEXTURE0));
     CCResourceProvider::ScopedReadLockGL quadResourceLock(m_resourceProvider, quad->resourceId());
-    GLC(context(), context()->bindTexture(GraphicsContext3D::TEXTURE_2D, quadResourceLock.textureId()));
+    FloatRect uvRect = textureQuadUVRect(quad, quadResourceLock);
+    GLC(context(), context()->uniform4f(binding.texTransformLocation, uvRect.x(), uvRect.y(), uvRect.width(), uvRect.height()));
 
-    // FIXME: setting the texture parameters every time is redundant. Move this code somewhere
-    // where it will only happen once per texture.
-    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MIN_FILTER, GraphicsContext3D::LINEAR));
-    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MAG_FILTER, GraphicsContext3D::LINEAR));
-    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_S, GraphicsContext3D::CLAMP_TO_EDGE));
-    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_T, GraphicsContext3D::CLAMP_TO_EDGE));
+    bindTextureQuadTexture(quadResourceLock.textureId());
 
     if (!quad->premultipliedAlpha()) {
         // As it turns out, the premultiplied alpha blending function (ONE, ONE_MINUS_SRC_ALPHA)
@@ -912,6 +934,116 @@ void CCRendererGL::drawTextureQuad(const DrawingFrame& frame, const CCTextureDra
         GLC(m_context, m_context->blendFunc(GraphicsContext3D::ONE, GraphicsContext3D::ONE_MINUS_SRC_ALPHA));
 }
 
+FloatRect CCRendererGL::textureQuadUVRect(const CCTextureDrawQuad* quad, const CCResourceProvider::ScopedReadLockGL& lock)
+{
+    FloatRect uvRect = quad->uvRect();
+    if (!lock.inAtlas())
+        return uvRect;
+
+    // Map the coordinates to the part of the atlas that holds the resource.
+    // The flip shader flips the atlas coordinates, so flip the part too.
+    FloatRect atlasRect = lock.atlasRect();
+    const IntSize& atlasSize = lock.atlasSize();
+    if (quad->flipped())
+        atlasRect.setY(atlasSize.height() - atlasRect.maxY());
+    return FloatRect((atlasRect.x() + uvRect.x() * atlasRect.width()) / atlasSize.width(),
+                     (atlasRect.y() + uvRect.y() * atlasRect.height()) / atlasSize.height(),
+                     uvRect.width() * atlasRect.width() / atlasSize.width(),
+                     uvRect.height() * atlasRect.height() / atlasSize.height());
+}
+
+void CCRendererGL::bindTextureQuadTexture(unsigned textureId)
+{
+    if (m_textureQuadTextureId == textureId)
+        return;
+
+    GLC(context(), context()->activeTexture(GraphicsContext3D::TEXTURE0));
+    GLC(context(), context()->bindTexture(GraphicsContext3D::TEXTURE_2D, textureId));
+
+    // The parameters are only set when a different texture gets bound, so consecutive quads
+    // drawn from the same texture do not set them again.
+    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MIN_FILTER, GraphicsContext3D::LINEAR));
+    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MAG_FILTER, GraphicsContext3D::LINEAR));
+    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_S, GraphicsContext3D::CLAMP_TO_EDGE));
+    GLC(context(), context()->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_T, GraphicsContext3D::CLAMP_TO_EDGE));
+    m_textureQuadTextureId = textureId;
+}
+
+void CCRendererGL::batchTextureQuad(const DrawingFrame& frame, const CCTextureDrawQuad* quad)
+{
+    ASSERT(quad->premultipliedAlpha());
+
+    CCResourceProvider::ScopedReadLockGL quadResourceLock(m_resourceProvider, quad->resourceId());
+    bool blending = quad->needsBlending();
+    int vertexSize = GeometryBinding::batchedVertexSize();
+    int batchedQuads = m_textureQuadBatch.size() / (4 * vertexSize);
+    if (batchedQuads && (quadResourceLock.textureId() != m_textureQuadBatchTextureId || blending != m_textureQuadBatchBlending || batchedQuads == GeometryBinding::maxBatchedQuads()))
+        flushTextureQuadBatch();
+    m_textureQuadBatchTextureId = quadResourceLock.textureId();
+    m_textureQuadBatchBlending = blending;
+
+    // Transform the corners of the shared quad to clip space here, so that
+    // quads with different transforms can be drawn together. The flip is done
+    // here too, rather than by a separate program.
+    WebTransformationMatrix quadRectMatrix;
+    quadRectTransform(&quadRectMatrix, quad->quadTransform(), quad->quadRect());
+    WebTransformationMatrix matrix = frame.projectionMatrix * quadRectMatrix;
+    FloatRect uvRect = textureQuadUVRect(quad, quadResourceLock);
+    const FloatRect& vertexRect = quadVertexRect();
+    const float corners[4][4] = { { vertexRect.x(), vertexRect.maxY(), 0, 1 },
+                                  { vertexRect.x(), vertexRect.y(), 0, 0 },
+                                  { vertexRect.maxX(), vertexRect.y(), 1, 0 },
+                                  { vertexRect.maxX(), vertexRect.maxY(), 1, 1 } };
+    for (int i = 0; i < 4; ++i) {
+        float x = corners[i][0];
+        float y = corners[i][1];
+        float v = uvRect.y() + corners[i][3] * uvRect.height();
+        m_textureQuadBatch.append(matrix.m11() * x + matrix.m21() * y + matrix.m41());
+        m_textureQuadBatch.append(matrix.m12() * x + matrix.m22() * y + matrix.m42());
+        m_textureQuadBatch.append(matrix.m13() * x + matrix.m23() * y + matrix.m43());
+        m_textureQuadBatch.append(matrix.m14() * x + matrix.m24() * y + matrix.m44());
+        m_textureQuadBatch.append(uvRect.x() + corners[i][2] * uvRect.width());
+        m_textureQuadBatch.append(quad->flipped() ? 1 - v : v);
+        m_textureQuadBatch.append(quad->opacity());
+    }
+}
+
+void CCRendererGL::flushTextureQuadBatch()
+{
+    if (m_textureQuadBatch.isEmpty())
+        return;
+
+    TRACE_EVENT0("cc", "CCRendererGL::flushTextureQuadBatch");
+    setBlendEnabled(m_textureQuadBatchBlending);
+
+    const TextureBatchProgram* program = textureBatchProgram();
+    if (m_textureQuadProgramId != program->program()) {
+        GLC(context(), context()->useProgram(program->program()));
+        GLC(context(), context()->uniform1i(program->fragmentShader().samplerLocation(), 0));
+        m_textureQuadProgramId = program->program();
+    }
+    bindTextureQuadTexture(m_textureQuadBatchTextureId);
+
+    int quadCount = m_textureQuadBatch.size() / (4 * GeometryBinding::batchedVertexSize());
+    m_sharedGeometry->prepareForBatchedDraw(m_textureQuadBatch.data(), quadCount);
+    GLC(m_context, m_context->drawElements(GraphicsContext3D::TRIANGLES, quadCount * 6, GraphicsContext3D::UNSIGNED_SHORT, 0));
+    ++m_frameDrawCallCount;
+    m_sharedGeometry->prepareForDraw();
+
+    m_textureQuadBatch.shrink(0);
+}
+
+void CCRendererGL::setBlendEnabled(bool enabled)
+{
+    if (enabled == m_blendEnabled)
+        return;
+    if (enabled)
+        GLC(m_context, m_context->enable(GraphicsContext3D::BLEND));
+    else
+        GLC(m_context, m_context->disable(GraphicsContext3D::BLEND));
+    m_blendEnabled = enabled;
+}
+
 void CCRendererGL::drawIOSurfaceQuad(const DrawingFrame& frame, const CCIOSurfaceDrawQuad* quad)
 {
     ASSERT(CCProxy::isImplThread());
@@ -936,11 +1068,14 @@ void CCRendererGL::drawIOSurfaceQuad(const DrawingFrame& frame, const CCIOSurfac
 
 void CCRendererGL::finishDrawingFrame(DrawingFrame& frame)
 {
+    flushTextureQuadBatch();
     m_currentFramebufferLock.clear();
     m_swapBufferRect.unite(enclosingIntRect(frame.rootDamageRect));
 
     GLC(m_context, m_context->disable(GraphicsContext3D::SCISSOR_TEST));
     GLC(m_context, m_context->disable(GraphicsContext3D::BLEND));
+    m_scissorEnabled = false;
+    m_blendEnabled = false;
 }
 
 bool CCRendererGL::flippedFramebuffer() const
@@ -1000,6 +1135,7 @@ void CCRendererGL::drawQuadGeometry(const DrawingFrame& frame, const WebKit::Web
     GLC(m_context, m_context->uniformMatrix4fv(matrixLocation, 1, false, &glMatrix[0]));
 
     GLC(m_context, m_context->drawElements(GraphicsContext3D::TRIANGLES, 6, GraphicsContext3D::UNSIGNED_SHORT, 0));
+    ++m_frameDrawCallCount;
 }
 
 void CCRendererGL::copyTextureToFramebuffer(const DrawingFrame& frame, int textureId, const IntRect& rect, const WebTransformationMatrix& drawMatrix)
@@ -1079,8 +1215,10 @@ void CCRendererGL::onMemoryAllocationChangedOnImplThread(WebKit::WebGraphicsMemo
         releaseRenderPassTextures();
         m_client->releaseContentsTextures();
         GLC(m_context, m_context->flush());
-    } else
+    } else {
+        setRenderPassCacheLimitBytes(renderPassCacheLimitForAllocation(allocation.gpuResourceSizeInBytes));
         m_client->setMemoryAllocationLimitBytes(allocation.gpuResourceSizeInBytes);
+    }
 }
 
 void CCRendererGL::discardFramebuffer()
@@ -1215,7 +1353,10 @@ bool CCRendererGL::useScopedTexture(DrawingFrame& frame, const CCScopedTexture*
 
 void CCRendererGL::bindFramebufferToOutputSurface(DrawingFrame& frame)
 {
+    flushTextureQuadBatch();
     m_currentFramebufferLock.clear();
+    m_textureQuadProgramId = 0;
+    m_textureQuadTextureId = 0;
     GLC(m_context, m_context->bindFramebuffer(GraphicsContext3D::FRAMEBUFFER, 0));
 }
 
@@ -1223,7 +1364,10 @@ bool CCRendererGL::bindFramebufferToTexture(DrawingFrame& frame, const CCScopedT
 {
     ASSERT(texture->id());
 
+    flushTextureQuadBatch();
     GLC(m_context, m_context->bindFramebuffer(GraphicsContext3D::FRAMEBUFFER, m_offscreenFramebufferId));
+    m_textureQuadProgramId = 0;
+    m_textureQuadTextureId = 0;
     m_currentFramebufferLock = adoptPtr(new CCResourceProvider::ScopedWriteLockGL(m_resourceProvider, texture->id()));
     unsigned textureId = m_currentFramebufferLock->textureId();
     GLC(m_context, m_context->framebufferTexture2D(GraphicsContext3D::FRAMEBUFFER, GraphicsContext3D::COLOR_ATTACHMENT0, GraphicsContext3D::TEXTURE_2D, textureId, 0));
@@ -1243,13 +1387,24 @@ bool CCRendererGL::bindFramebufferToTexture(DrawingFrame& frame, const CCScopedT
 
 void CCRendererGL::enableScissorTestRect(const IntRect& scissorRect)
 {
-    GLC(m_context, m_context->enable(GraphicsContext3D::SCISSOR_TEST));
+    // The scissor is set before every quad, but it is usually the same as for
+    // the previous quad.
+    if (m_scissorEnabled && scissorRect == m_scissorRect)
+        return;
+
+    flushTextureQuadBatch();
+    if (!m_scissorEnabled)
+        GLC(m_context, m_context->enable(GraphicsContext3D::SCISSOR_TEST));
     GLC(m_context, m_context->scissor(scissorRect.x(), scissorRect.y(), scissorRect.width(), scissorRect.height()));
+    m_scissorEnabled = true;
+    m_scissorRect = scissorRect;
 }
 
 void CCRendererGL::disableScissorTest()
 {
+    flushTextureQuadBatch();
     GLC(m_context, m_context->disable(GraphicsContext3D::SCISSOR_TEST));
+    m_scissorEnabled = false;
 }
 
 void CCRendererGL::setDrawViewportSize(const IntSize& viewportSize)
@@ -1422,6 +1577,17 @@ const CCRendererGL::TextureProgram* CCRendererGL::textureProgram()
     return m_textureProgram.get();
 }
 
+const CCRendererGL::TextureBatchProgram* CCRendererGL::textureBatchProgram()
+{
+    if (!m_textureBatchProgram)
+        m_textureBatchProgram = adoptPtr(new TextureBatchProgram(m_context));
+    if (!m_textureBatchProgram->initialized()) {
+        TRACE_EVENT0("cc", "CCRendererGL::textureBatchProgram::initialize");
+        m_textureBatchProgram->initialize(m_context, m_isUsingBindUniform);
+    }
+    return m_textureBatchProgram.get();
+}
+
 const CCRendererGL::TextureProgramFlip* CCRendererGL::textureProgramFlip()
 {
     if (!m_textureProgramFlip)
@@ -1500,6 +1666,8 @@ void CCRendererGL::cleanupSharedObjects()
         m_textureProgram->cleanup(m_context);
     if (m_textureProgramFlip)
         m_textureProgramFlip->cleanup(m_context);
+    if (m_textureBatchProgram)
+        m_textureBatchProgram->cleanup(m_context);
     if (m_textureIOSurfaceProgram)
         m_textureIOSurfaceProgram->cleanup(m_context);
 
@@ -21,6 +21,7 @@
 #include "CCYUVVideoDrawQuad.h"
 #include "Extensions3DChromium.h"
 #include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
 
 namespace WebKit {
 class WebGraphicsContext3D;
@@ -98,10 +99,15 @@ private:
     void drawSolidColorQuad(const DrawingFrame&, const CCSolidColorDrawQuad*);
     void drawStreamVideoQuad(const DrawingFrame&, const CCStreamVideoDrawQuad*);
     void drawTextureQuad(const DrawingFrame&, const CCTextureDrawQuad*);
+    FloatRect textureQuadUVRect(const CCTextureDrawQuad*, const CCResourceProvider::ScopedReadLockGL&);
+    void bindTextureQuadTexture(unsigned textureId);
+    void batchTextureQuad(const DrawingFrame&, const CCTextureDrawQuad*);
+    void flushTextureQuadBatch();
     void drawIOSurfaceQuad(const DrawingFrame&, const CCIOSurfaceDrawQuad*);
     void drawTileQuad(const DrawingFrame&, const CCTileDrawQuad*);
     void drawYUVVideoQuad(const DrawingFrame&, const CCYUVVideoDrawQuad*);
 
+    void setBlendEnabled(bool);
     void setShaderOpacity(float opacity, int alphaLocation);
     void setShaderFloatQuad(const FloatQuad&, int quadLocation);
     void drawQuadGeometry(const DrawingFrame&, const WebKit::WebTransformationMatrix& drawTransform, const FloatRect& quadRect, int matrixLocation);
@@ -155,6 +161,7 @@ private:
     typedef ProgramBinding<VertexShaderPosTexTransform, FragmentShaderRGBATexAlpha> TextureProgram;
     typedef ProgramBinding<VertexShaderPosTexTransform, FragmentShaderRGBATexFlipAlpha> TextureProgramFlip;
     typedef ProgramBinding<VertexShaderPosTexTransform, FragmentShaderRGBATexRectAlpha> TextureIOSurfaceProgram;
+    typedef ProgramBinding<VertexShaderPosTexAlpha, FragmentShaderRGBATexVaryingAlpha> TextureBatchProgram;
 
     // Video shaders.
     typedef ProgramBinding<VertexShaderVideoTransform, FragmentShaderOESImageExternal> VideoStreamTextureProgram;
@@ -179,6 +186,7 @@ private:
     const TextureProgram* textureProgram();
     const TextureProgramFlip* textureProgramFlip();
     const TextureIOSurfaceProgram* textureIOSurfaceProgram();
+    const TextureBatchProgram* textureBatchProgram();
 
     const VideoYUVProgram* videoYUVProgram();
     const VideoStreamTextureProgram* videoStreamTextureProgram();
@@ -201,6 +209,7 @@ private:
     OwnPtr<TextureProgram> m_textureProgram;
     OwnPtr<TextureProgramFlip> m_textureProgramFlip;
     OwnPtr<TextureIOSurfaceProgram> m_textureIOSurfaceProgram;
+    OwnPtr<TextureBatchProgram> m_textureBatchProgram;
 
     OwnPtr<VideoYUVProgram> m_videoYUVProgram;
     OwnPtr<VideoStreamTextureProgram> m_videoStreamTextureProgram;
@@ -215,6 +224,25 @@ private:
     bool m_isUsingBindUniform;
     bool m_visible;
 
+    // The program and texture used by the last quad, if it was a texture quad.
+    // Consecutive texture quads from the same atlas texture don't need to set
+    // them again.
+    unsigned m_textureQuadProgramId;
+    unsigned m_textureQuadTextureId;
+
+    // Consecutive premultiplied texture quads that use the same texture (such
+    // as an atlas) and blending are drawn together with one draw call. These
+    // are the vertices of the quads that have not been drawn yet.
+    Vector<float> m_textureQuadBatch;
+    unsigned m_textureQuadBatchTextureId;
+    bool m_textureQuadBatchBlending;
+
+    // The blending and scissor state, to skip setting them again when they
+    // don't change.
+    bool m_blendEnabled;
+    bool m_scissorEnabled;
+    IntRect m_scissorRect;
+
     OwnPtr<CCResourceProvider::ScopedWriteLockGL> m_currentFramebufferLock;
 };
 
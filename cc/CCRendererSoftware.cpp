@@ -7,11 +7,14 @@
 #include "CCRendererSoftware.h"
 
 #include "CCDebugBorderDrawQuad.h"
+#include "CCSettings.h"
 #include "CCSolidColorDrawQuad.h"
 #include "CCTextureDrawQuad.h"
 #include "CCTileDrawQuad.h"
+#include "SkBlitRow.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkDevice.h"
 #include "SkMatrix.h"
 #include "SkPixelRef.h"
 #include <GLES2/gl2.h>
@@ -52,6 +55,11 @@ void toSkMatrix(SkMatrix* flattened, const WebTransformationMatrix& m)
     flattened->set(8, m.m44());
 }
 
+bool isNearlyInteger(SkScalar value)
+{
+    return SkScalarNearlyEqual(value, SkScalarRoundToScalar(value));
+}
+
 } // anonymous namespace
 
 PassOwnPtr<CCRendererSoftware> CCRendererSoftware::create(CCRendererClient* client, CCResourceProvider* resourceProvider, WebCompositorSoftwareOutputDevice* outputDevice)
@@ -72,6 +80,9 @@ CCRendererSoftware::CCRendererSoftware(CCRendererClient* client, CCResourceProvi
     m_capabilities.bestTextureFormat = GraphicsContext3D::RGBA;
     m_capabilities.contextHasCachedFrontBuffer = true;
     m_capabilities.usingSetVisibility = true;
+    // The output device keeps its pixels between frames, so only the damaged
+    // part of the root render pass needs to be drawn again.
+    m_capabilities.usingPartialSwap = CCSettings::partialSwapEnabled();
 
     viewportChanged();
 }
@@ -131,12 +142,14 @@ bool CCRendererSoftware::bindFramebufferToTexture(DrawingFrame& frame, const CCS
 void CCRendererSoftware::enableScissorTestRect(const IntRect& scissorRect)
 {
     m_skCurrentCanvas->clipRect(toSkRect(scissorRect), SkRegion::kReplace_Op);
+    m_scissorRect = scissorRect;
 }
 
 void CCRendererSoftware::disableScissorTest()
 {
     IntRect canvasRect(IntPoint(), viewportSize());
     m_skCurrentCanvas->clipRect(toSkRect(canvasRect), SkRegion::kReplace_Op);
+    m_scissorRect = canvasRect;
 }
 
 void CCRendererSoftware::clearFramebuffer(DrawingFrame& frame)
@@ -193,6 +206,7 @@ void CCRendererSoftware::drawQuad(DrawingFrame& frame, const CCDrawQuad* quad)
         drawUnsupportedQuad(frame, quad);
         break;
     }
+    ++m_frameDrawCallCount;
 
     m_skCurrentCanvas->resetMatrix();
 }
@@ -232,6 +246,9 @@ void CCRendererSoftware::drawTextureQuad(const DrawingFrame& frame, const CCText
     FloatRect uvRect = quad->uvRect();
     uvRect.scale(quad->quadRect().width(), quad->quadRect().height());
     SkIRect skUvRect = toSkIRect(enclosingIntRect(uvRect));
+    if (!quad->flipped() && uvRect == FloatRect(FloatPoint(), quad->quadRect().size())
+        && blitBitmapRect(quad, *quadResourceLock.skBitmap(), IntPoint()))
+        return;
     if (quad->flipped())
         m_skCurrentCanvas->scale(1, -1);
     m_skCurrentCanvas->drawBitmapRect(*quadResourceLock.skBitmap(), &skUvRect, toSkRect(quadVertexRect()), &m_skCurrentPaint);
@@ -241,11 +258,61 @@ void CCRendererSoftware::drawTileQuad(const DrawingFrame& frame, const CCTileDra
 {
     ASSERT(isSoftwareResource(quad->resourceId()));
     CCResourceProvider::ScopedReadLockSoftware quadResourceLock(m_resourceProvider, quad->resourceId());
+    if (blitBitmapRect(quad, *quadResourceLock.skBitmap(), quad->textureOffset()))
+        return;
 
     SkIRect uvRect = toSkIRect(IntRect(quad->textureOffset(), quad->quadRect().size()));
     m_skCurrentCanvas->drawBitmapRect(*quadResourceLock.skBitmap(), &uvRect, toSkRect(quadVertexRect()), &m_skCurrentPaint);
 }
 
+bool CCRendererSoftware::blitBitmapRect(const CCDrawQuad* quad, const SkBitmap& source, const IntPoint& sourceOffset)
+{
+    // Only quads that are drawn unscaled at whole pixel positions can bypass
+    // the canvas. This is the common case for tiles of unscaled layers.
+    const SkMatrix& matrix = m_skCurrentCanvas->getTotalMatrix();
+    if (matrix.getType() & ~(SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask))
+        return false;
+    const IntSize& size = quad->quadRect().size();
+    if (!SkScalarNearlyEqual(matrix.getScaleX(), size.width()) || !SkScalarNearlyEqual(matrix.getScaleY(), size.height()))
+        return false;
+    SkRect mappedRect;
+    matrix.mapRect(&mappedRect, toSkRect(quadVertexRect()));
+    if (!isNearlyInteger(mappedRect.x()) || !isNearlyInteger(mappedRect.y()))
+        return false;
+
+    SkBitmap& target = const_cast<SkBitmap&>(m_skCurrentCanvas->getDevice()->accessBitmap(true));
+    if (source.config() != SkBitmap::kARGB_8888_Config || target.config() != SkBitmap::kARGB_8888_Config)
+        return false;
+
+    IntRect destRect(SkScalarRoundToInt(mappedRect.x()), SkScalarRoundToInt(mappedRect.y()), size.width(), size.height());
+    IntRect clippedRect = destRect;
+    clippedRect.intersect(m_scissorRect);
+    clippedRect.intersect(IntRect(0, 0, target.width(), target.height()));
+    IntSize toSource(sourceOffset.x() - destRect.x(), sourceOffset.y() - destRect.y());
+    clippedRect.intersect(IntRect(-toSource.width(), -toSource.height(), source.width(), source.height()));
+    if (clippedRect.isEmpty())
+        return true;
+
+    SkAutoLockPixels sourceLock(source);
+    SkAutoLockPixels targetLock(target);
+    if (!quad->needsBlending()) {
+        for (int y = clippedRect.y(); y < clippedRect.maxY(); ++y)
+            memcpy(target.getAddr32(clippedRect.x(), y), source.getAddr32(clippedRect.x() + toSource.width(), y + toSource.height()), clippedRect.width() * 4);
+        return true;
+    }
+
+    // Skia picks the row blending function for the CPU, using SSE2 or NEON
+    // when they are available.
+    U8CPU alpha = static_cast<U8CPU>(quad->opacity() * 255);
+    unsigned flags = SkBlitRow::kSrcPixelAlpha_Flag32;
+    if (alpha < 255)
+        flags |= SkBlitRow::kGlobalAlpha_Flag32;
+    SkBlitRow::Proc32 blitRow = SkBlitRow::Factory32(flags);
+    for (int y = clippedRect.y(); y < clippedRect.maxY(); ++y)
+        blitRow(target.getAddr32(clippedRect.x(), y), source.getAddr32(clippedRect.x() + toSource.width(), y + toSource.height()), clippedRect.width(), alpha);
+    return true;
+}
+
 void CCRendererSoftware::drawUnsupportedQuad(const DrawingFrame& frame, const CCDrawQuad* quad)
 {
     m_skCurrentPaint.setColor(SK_ColorMAGENTA);
@@ -59,6 +59,11 @@ private:
     void drawTileQuad(const DrawingFrame&, const CCTileDrawQuad*);
     void drawUnsupportedQuad(const DrawingFrame&, const CCDrawQuad*);
 
+    // Copies or blends the pixels of an axis-aligned quad straight into the
+    // current canvas. Returns false if the quad needs to go through the
+    // canvas instead.
+    bool blitBitmapRect(const CCDrawQuad*, const SkBitmap& source, const IntPoint& sourceOffset);
+
     RendererCapabilities m_capabilities;
     bool m_visible;
 
@@ -66,6 +71,7 @@ private:
     SkCanvas m_skRootCanvas;
     SkCanvas* m_skCurrentCanvas;
     SkPaint m_skCurrentPaint;
+    IntRect m_scissorRect;
     OwnPtr<CCResourceProvider::ScopedWriteLockSoftware> m_currentFramebufferLock;
 };
 
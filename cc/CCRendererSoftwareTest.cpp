@@ -149,4 +149,59 @@ TEST_F(CCRendererSoftwareTest, tileQuad)
     EXPECT_EQ(SK_ColorCYAN, pixels[outerPixels - outerSize.width() - 2]);
 }
 
+TEST_F(CCRendererSoftwareTest, translucentTileQuad)
+{
+    IntSize outerSize(100, 100);
+    int outerPixels = outerSize.width() * outerSize.height();
+    IntSize innerSize(98, 98);
+    int innerPixels = innerSize.width() * innerSize.height();
+    IntRect outerRect(IntPoint(), outerSize);
+    IntRect innerRect(IntPoint(1, 1), innerSize);
+    setViewportSize(outerSize);
+    initializeRenderer();
+
+    CCResourceProvider::ResourceId resourceYellow = resourceProvider()->createResource(1, outerSize, GraphicsContext3D::RGBA, CCResourceProvider::TextureUsageAny);
+    CCResourceProvider::ResourceId resourceCyan = resourceProvider()->createResource(1, innerSize, GraphicsContext3D::RGBA, CCResourceProvider::TextureUsageAny);
+
+    OwnArrayPtr<SkColor> yellowPixels = adoptArrayPtr(new SkColor[outerPixels]);
+    OwnArrayPtr<SkColor> cyanPixels = adoptArrayPtr(new SkColor[innerPixels]);
+    for (int i = 0; i < outerPixels; i++)
+      yellowPixels[i] = SK_ColorYELLOW;
+    for (int i = 0; i < innerPixels; i++)
+      cyanPixels[i] = SK_ColorCYAN;
+
+    resourceProvider()->upload(resourceYellow, reinterpret_cast<uint8_t*>(yellowPixels.get()), IntRect(IntPoint(), outerSize), IntRect(IntPoint(), outerSize), IntSize());
+    resourceProvider()->upload(resourceCyan, reinterpret_cast<uint8_t*>(cyanPixels.get()), IntRect(IntPoint(), innerSize), IntRect(IntPoint(), innerSize), IntSize());
+
+    OwnPtr<CCSharedQuadState> opaqueQuadState = CCSharedQuadState::create(WebTransformationMatrix(), outerRect, outerRect, 1.0, true);
+    OwnPtr<CCSharedQuadState> translucentQuadState = CCSharedQuadState::create(WebTransformationMatrix(), outerRect, outerRect, 0.5, true);
+    CCRenderPass::Id rootRenderPassId = CCRenderPass::Id(1, 1);
+    scoped_ptr<CCRenderPass> rootRenderPass = CCTestRenderPass::create(rootRenderPassId, IntRect(IntPoint(), deviceViewportSize()), WebTransformationMatrix());
+    CCTestRenderPass* testRenderPass = static_cast<CCTestRenderPass*>(rootRenderPass.get());
+    OwnPtr<CCDrawQuad> outerQuad = CCTileDrawQuad::create(opaqueQuadState.get(), outerRect, outerRect, resourceYellow, IntPoint(), outerSize, 0, false, false, false, false, false);
+    OwnPtr<CCDrawQuad> innerQuad = CCTileDrawQuad::create(translucentQuadState.get(), innerRect, innerRect, resourceCyan, IntPoint(), innerSize, 0, false, false, false, false, false);
+    testRenderPass->appendQuad(innerQuad.release());
+    testRenderPass->appendQuad(outerQuad.release());
+
+    CCRenderPassList list;
+    CCRenderPassIdHashMap hashmap;
+    list.append(rootRenderPass.get());
+    hashmap.add(rootRenderPassId, rootRenderPass.Pass());
+    renderer()->drawFrame(list, hashmap);
+
+    OwnArrayPtr<SkColor> pixels = adoptArrayPtr(new SkColor[deviceViewportSize().width() * deviceViewportSize().height()]);
+    renderer()->getFramebufferPixels(pixels.get(), outerRect);
+
+    EXPECT_EQ(SK_ColorYELLOW, pixels[0]);
+    EXPECT_EQ(SK_ColorYELLOW, pixels[outerPixels - 1]);
+
+    // Half of the cyan tile is blended over the yellow one.
+    SkColor blended = pixels[outerSize.width() + 1];
+    EXPECT_EQ(255u, SkColorGetA(blended));
+    EXPECT_NEAR(128, static_cast<int>(SkColorGetR(blended)), 2);
+    EXPECT_EQ(255u, SkColorGetG(blended));
+    EXPECT_NEAR(128, static_cast<int>(SkColorGetB(blended)), 2);
+    EXPECT_EQ(blended, pixels[outerPixels - outerSize.width() - 2]);
+}
+
 } // namespace
@@ -14,6 +14,14 @@ struct CCRenderingStats {
     int droppedFrameCount;
     double totalPaintTimeInSeconds;
     double totalRasterizeTimeInSeconds;
+    // Time the main thread spent waiting for tiles rasterized on the raster worker threads.
+    double totalRasterWaitTimeInSeconds;
+    int numTilesRasterizedInParallel;
+    int checkerboardedFrameCount;
+    // Missing tiles drawn in the checkerboarded frames.
+    int checkerboardedTileCount;
+    // Frames the impl thread could not draw while waiting for the main thread.
+    int numFramesBlockedByMainThread;
 
     CCRenderingStats()
         : numAnimationFrames(0)
@@ -21,6 +29,11 @@ struct CCRenderingStats {
         , droppedFrameCount(0)
         , totalPaintTimeInSeconds(0)
         , totalRasterizeTimeInSeconds(0)
+        , totalRasterWaitTimeInSeconds(0)
+        , numTilesRasterizedInParallel(0)
+        , checkerboardedFrameCount(0)
+        , checkerboardedTileCount(0)
+        , numFramesBlockedByMainThread(0)
     {
     }
 };
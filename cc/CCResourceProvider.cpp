@@ -15,6 +15,7 @@
 #include "base/string_util.h"
 #include "CCProxy.h"
 #include "CCRendererGL.h" // For the GLC() macro.
+#include "CCTextureAtlas.h"
 #include "Extensions3DChromium.h"
 #include "IntRect.h"
 #include "LayerTextureSubImage.h"
@@ -27,6 +28,12 @@ using WebKit::WebGraphicsContext3D;
 
 namespace cc {
 
+// Resources up to this size are packed into atlas textures of kAtlasSize, so
+// that a page with many small layers does not need a texture for each one.
+static const int kMaxAtlasedResourceDimension = 256;
+static const int kMaxAtlasedResourceArea = 128 * 128;
+static const int kAtlasSize = 512;
+
 static GC3Denum textureToStorageFormat(GC3Denum textureFormat)
 {
     GC3Denum storageFormat = Extensions3D::RGBA8_OES;
@@ -59,6 +66,9 @@ CCResourceProvider::TransferableResourceList::~TransferableResourceList()
 
 CCResourceProvider::Resource::Resource()
     : glId(0)
+    , glPixelBufferId(0)
+    , pixelBufferSize(0)
+    , mappedPixelBuffer(0)
     , pixels(0)
     , pool(0)
     , lockForReadCount(0)
@@ -73,6 +83,9 @@ CCResourceProvider::Resource::Resource()
 
 CCResourceProvider::Resource::Resource(unsigned textureId, int pool, const IntSize& size, GC3Denum format)
     : glId(textureId)
+    , glPixelBufferId(0)
+    , pixelBufferSize(0)
+    , mappedPixelBuffer(0)
     , pixels(0)
     , pool(pool)
     , lockForReadCount(0)
@@ -87,6 +100,9 @@ CCResourceProvider::Resource::Resource(unsigned textureId, int pool, const IntSi
 
 CCResourceProvider::Resource::Resource(uint8_t* pixels, int pool, const IntSize& size, GC3Denum format)
     : glId(0)
+    , glPixelBufferId(0)
+    , pixelBufferSize(0)
+    , mappedPixelBuffer(0)
     , pixels(pixels)
     , pool(pool)
     , lockForReadCount(0)
@@ -99,6 +115,17 @@ CCResourceProvider::Resource::Resource(uint8_t* pixels, int pool, const IntSize&
 {
 }
 
+CCResourceProvider::Atlas::Atlas(unsigned glId, GC3Denum format, PassOwnPtr<CCTextureAtlas> allocator)
+    : glId(glId)
+    , format(format)
+    , allocator(allocator)
+{
+}
+
+CCResourceProvider::Atlas::~Atlas()
+{
+}
+
 CCResourceProvider::Child::Child()
 {
 }
@@ -160,29 +187,45 @@ CCResourceProvider::ResourceId CCResourceProvider::createResource(int pool, cons
 CCResourceProvider::ResourceId CCResourceProvider::createGLTexture(int pool, const IntSize& size, GC3Denum format, TextureUsageHint hint)
 {
     ASSERT(CCProxy::isImplThread());
-    unsigned textureId = 0;
-    WebGraphicsContext3D* context3d = m_context->context3D();
-    ASSERT(context3d);
-    GLC(context3d, textureId = context3d->createTexture());
-    GLC(context3d, context3d->bindTexture(GraphicsContext3D::TEXTURE_2D, textureId));
-    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MIN_FILTER, GraphicsContext3D::LINEAR));
-    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MAG_FILTER, GraphicsContext3D::LINEAR));
-    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_S, GraphicsContext3D::CLAMP_TO_EDGE));
-    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_T, GraphicsContext3D::CLAMP_TO_EDGE));
-
-    if (m_useTextureUsageHint && hint == TextureUsageFramebuffer)
-        GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, Extensions3DChromium::GL_TEXTURE_USAGE_ANGLE, Extensions3DChromium::GL_FRAMEBUFFER_ATTACHMENT_ANGLE));
-    if (m_useTextureStorageExt && isTextureFormatSupportedForStorage(format)) {
-        GC3Denum storageFormat = textureToStorageFormat(format);
-        GLC(context3d, context3d->texStorage2DEXT(GraphicsContext3D::TEXTURE_2D, 1, storageFormat, size.width(), size.height()));
-    } else
-        GLC(context3d, context3d->texImage2D(GraphicsContext3D::TEXTURE_2D, 0, format, size.width(), size.height(), 0, format, GraphicsContext3D::UNSIGNED_BYTE, 0));
+    unsigned textureId = createTexture(size, format, hint);
     ResourceId id = m_nextId++;
     Resource resource(textureId, pool, size, format);
     m_resources.add(id, resource);
     return id;
 }
 
+CCResourceProvider::ResourceId CCResourceProvider::createAtlasedResource(int pool, const IntSize& size, GC3Denum format)
+{
+    ASSERT(CCProxy::isImplThread());
+    if (m_defaultResourceType != GLTexture || size.isEmpty()
+        || size.width() > kMaxAtlasedResourceDimension || size.height() > kMaxAtlasedResourceDimension
+        || size.width() * size.height() > kMaxAtlasedResourceArea
+        || size.width() >= m_atlasSize.width() || size.height() >= m_atlasSize.height())
+        return createResource(pool, size, format, TextureUsageAny);
+
+    IntRect atlasRect;
+    Atlas* atlas = 0;
+    for (size_t i = 0; i < m_atlases.size(); ++i) {
+        if (m_atlases[i]->format == format && m_atlases[i]->allocator->allocate(size, &atlasRect)) {
+            atlas = m_atlases[i].get();
+            break;
+        }
+    }
+    if (!atlas) {
+        unsigned textureId = createTexture(m_atlasSize, format, TextureUsageAny);
+        m_atlases.append(adoptPtr(new Atlas(textureId, format, CCTextureAtlas::create(m_atlasSize))));
+        atlas = m_atlases.last().get();
+        bool allocated = atlas->allocator->allocate(size, &atlasRect);
+        ASSERT_UNUSED(allocated, allocated);
+    }
+
+    ResourceId id = m_nextId++;
+    Resource resource(atlas->glId, pool, size, format);
+    resource.atlasRect = atlasRect;
+    m_resources.add(id, resource);
+    return id;
+}
+
 CCResourceProvider::ResourceId CCResourceProvider::createBitmap(int pool, const IntSize& size)
 {
     ASSERT(CCProxy::isImplThread());
@@ -219,11 +262,19 @@ void CCResourceProvider::deleteResource(ResourceId id)
     ASSERT(!resource->lockedForWrite);
     ASSERT(!resource->lockForReadCount);
 
-    if (resource->glId && !resource->external) {
+    if (!resource->atlasRect.isEmpty())
+        freeAtlasRect(resource);
+    else if (resource->glId && !resource->external) {
         WebGraphicsContext3D* context3d = m_context->context3D();
         ASSERT(context3d);
         GLC(context3d, context3d->deleteTexture(resource->glId));
     }
+    if (resource->glPixelBufferId) {
+        ASSERT(!resource->mappedPixelBuffer);
+        WebGraphicsContext3D* context3d = m_context->context3D();
+        ASSERT(context3d);
+        GLC(context3d, context3d->deleteBuffer(resource->glPixelBufferId));
+    }
     if (resource->pixels)
         delete resource->pixels;
 
@@ -278,7 +329,8 @@ void CCResourceProvider::upload(ResourceId id, const uint8_t* image, const IntRe
         ASSERT(context3d);
         ASSERT(m_texSubImage.get());
         context3d->bindTexture(GraphicsContext3D::TEXTURE_2D, resource->glId);
-        m_texSubImage->upload(image, imageRect, sourceRect, destOffset, resource->format, context3d);
+        IntSize atlasOffset(resource->atlasRect.x(), resource->atlasRect.y());
+        m_texSubImage->upload(image, imageRect, sourceRect, destOffset + atlasOffset, resource->format, context3d);
     }
 
     if (resource->pixels) {
@@ -296,6 +348,67 @@ void CCResourceProvider::upload(ResourceId id, const uint8_t* image, const IntRe
     }
 }
 
+uint8_t* CCResourceProvider::mapPixelBuffer(ResourceId id, const IntSize& size)
+{
+    ASSERT(CCProxy::isImplThread());
+    ASSERT(m_usePixelBuffers);
+    ResourceMap::iterator it = m_resources.find(id);
+    CHECK(it != m_resources.end());
+#if WTF_NEW_HASHMAP_ITERATORS_INTERFACE
+    Resource* resource = &it->value;
+#else
+    Resource* resource = &it->second;
+#endif
+    ASSERT(resource->glId);
+    ASSERT(!resource->external);
+    ASSERT(!resource->mappedPixelBuffer);
+
+    WebGraphicsContext3D* context3d = m_context->context3D();
+    ASSERT(context3d);
+    if (!resource->glPixelBufferId)
+        resource->glPixelBufferId = context3d->createBuffer();
+
+    size_t bytes = 4 * size.width() * size.height();
+    context3d->bindBuffer(Extensions3DChromium::PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, resource->glPixelBufferId);
+    // The buffer keeps the size of the largest update, usually a full tile.
+    if (bytes > resource->pixelBufferSize) {
+        context3d->bufferData(Extensions3DChromium::PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, bytes, 0, GraphicsContext3D::STREAM_DRAW);
+        resource->pixelBufferSize = bytes;
+    }
+    resource->mappedPixelBuffer = static_cast<uint8_t*>(context3d->mapBufferSubDataCHROMIUM(Extensions3DChromium::PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, 0, bytes, Extensions3DChromium::WRITE_ONLY));
+    context3d->bindBuffer(Extensions3DChromium::PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, 0);
+    if (!resource->mappedPixelBuffer)
+        resource->pixelBufferSize = 0;
+    return resource->mappedPixelBuffer;
+}
+
+void CCResourceProvider::unmapPixelBufferAndUpload(ResourceId id, const IntSize& size, const IntSize& destOffset)
+{
+    ASSERT(CCProxy::isImplThread());
+    ResourceMap::iterator it = m_resources.find(id);
+    CHECK(it != m_resources.end());
+#if WTF_NEW_HASHMAP_ITERATORS_INTERFACE
+    Resource* resource = &it->value;
+#else
+    Resource* resource = &it->second;
+#endif
+    ASSERT(resource->mappedPixelBuffer);
+    ASSERT(!resource->lockedForWrite);
+    ASSERT(!resource->lockForReadCount);
+
+    WebGraphicsContext3D* context3d = m_context->context3D();
+    ASSERT(context3d);
+    context3d->unmapBufferSubDataCHROMIUM(resource->mappedPixelBuffer);
+    resource->mappedPixelBuffer = 0;
+
+    // With the pixel buffer bound, the pixels argument is an offset in the buffer.
+    context3d->bindBuffer(Extensions3DChromium::PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, resource->glPixelBufferId);
+    context3d->bindTexture(GraphicsContext3D::TEXTURE_2D, resource->glId);
+    IntSize offset = destOffset + IntSize(resource->atlasRect.x(), resource->atlasRect.y());
+    context3d->texSubImage2D(GraphicsContext3D::TEXTURE_2D, 0, offset.width(), offset.height(), size.width(), size.height(), resource->format, GraphicsContext3D::UNSIGNED_BYTE, 0);
+    context3d->bindBuffer(Extensions3DChromium::PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, 0);
+}
+
 void CCResourceProvider::flush()
 {
     ASSERT(CCProxy::isImplThread());
@@ -357,6 +470,8 @@ const CCResourceProvider::Resource* CCResourceProvider::lockForWrite(ResourceId
     ASSERT(!resource->lockedForWrite);
     ASSERT(!resource->lockForReadCount);
     ASSERT(!resource->external);
+    // Rendering to a resource would overwrite its neighbours in the atlas.
+    ASSERT(resource->atlasRect.isEmpty());
     resource->lockedForWrite = true;
     return resource;
 }
@@ -379,9 +494,13 @@ void CCResourceProvider::unlockForWrite(ResourceId id)
 CCResourceProvider::ScopedReadLockGL::ScopedReadLockGL(CCResourceProvider* resourceProvider, CCResourceProvider::ResourceId resourceId)
     : m_resourceProvider(resourceProvider)
     , m_resourceId(resourceId)
-    , m_textureId(resourceProvider->lockForRead(resourceId)->glId)
 {
+    const Resource* resource = resourceProvider->lockForRead(resourceId);
+    m_textureId = resource->glId;
     ASSERT(m_textureId);
+    m_atlasRect = resource->atlasRect;
+    if (!m_atlasRect.isEmpty())
+        m_atlasSize = resourceProvider->m_atlasSize;
 }
 
 CCResourceProvider::ScopedReadLockGL::~ScopedReadLockGL()
@@ -410,6 +529,45 @@ void CCResourceProvider::populateSkBitmapWithResource(SkBitmap* skBitmap, const
     skBitmap->setPixels(resource->pixels);
 }
 
+unsigned CCResourceProvider::createTexture(const IntSize& size, GC3Denum format, TextureUsageHint hint)
+{
+    unsigned textureId = 0;
+    WebGraphicsContext3D* context3d = m_context->context3D();
+    ASSERT(context3d);
+    GLC(context3d, textureId = context3d->createTexture());
+    GLC(context3d, context3d->bindTexture(GraphicsContext3D::TEXTURE_2D, textureId));
+    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MIN_FILTER, GraphicsContext3D::LINEAR));
+    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_MAG_FILTER, GraphicsContext3D::LINEAR));
+    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_S, GraphicsContext3D::CLAMP_TO_EDGE));
+    GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, GraphicsContext3D::TEXTURE_WRAP_T, GraphicsContext3D::CLAMP_TO_EDGE));
+
+    if (m_useTextureUsageHint && hint == TextureUsageFramebuffer)
+        GLC(context3d, context3d->texParameteri(GraphicsContext3D::TEXTURE_2D, Extensions3DChromium::GL_TEXTURE_USAGE_ANGLE, Extensions3DChromium::GL_FRAMEBUFFER_ATTACHMENT_ANGLE));
+    if (m_useTextureStorageExt && isTextureFormatSupportedForStorage(format)) {
+        GC3Denum storageFormat = textureToStorageFormat(format);
+        GLC(context3d, context3d->texStorage2DEXT(GraphicsContext3D::TEXTURE_2D, 1, storageFormat, size.width(), size.height()));
+    } else
+        GLC(context3d, context3d->texImage2D(GraphicsContext3D::TEXTURE_2D, 0, format, size.width(), size.height(), 0, format, GraphicsContext3D::UNSIGNED_BYTE, 0));
+    return textureId;
+}
+
+void CCResourceProvider::freeAtlasRect(const Resource* resource)
+{
+    for (size_t i = 0; i < m_atlases.size(); ++i) {
+        if (m_atlases[i]->glId != resource->glId)
+            continue;
+        m_atlases[i]->allocator->free(resource->atlasRect);
+        if (m_atlases[i]->allocator->isEmpty()) {
+            WebGraphicsContext3D* context3d = m_context->context3D();
+            ASSERT(context3d);
+            GLC(context3d, context3d->deleteTexture(m_atlases[i]->glId));
+            m_atlases.remove(i);
+        }
+        return;
+    }
+    ASSERT_NOT_REACHED();
+}
+
 CCResourceProvider::ScopedReadLockSoftware::ScopedReadLockSoftware(CCResourceProvider* resourceProvider, CCResourceProvider::ResourceId resourceId)
     : m_resourceProvider(resourceProvider)
     , m_resourceId(resourceId)
@@ -443,6 +601,7 @@ CCResourceProvider::CCResourceProvider(CCGraphicsContext* context)
     , m_useTextureStorageExt(false)
     , m_useTextureUsageHint(false)
     , m_useShallowFlush(false)
+    , m_usePixelBuffers(false)
     , m_maxTextureSize(0)
 {
 }
@@ -475,6 +634,8 @@ bool CCResourceProvider::initialize()
             m_useShallowFlush = true;
         else if (extensions[i] == "GL_CHROMIUM_bind_uniform_location")
             useBindUniform = true;
+        else if (extensions[i] == "GL_CHROMIUM_pixel_transfer_buffer_object")
+            m_usePixelBuffers = true;
     }
 
     m_texSubImage = adoptPtr(new LayerTextureSubImage(useMapSub));
@@ -482,6 +643,7 @@ bool CCResourceProvider::initialize()
 
     m_textureUploader = ThrottledTextureUploader::create(context3d);
     GLC(context3d, context3d->getIntegerv(GraphicsContext3D::MAX_TEXTURE_SIZE, &m_maxTextureSize));
+    m_atlasSize = IntSize(kAtlasSize, kAtlasSize).shrunkTo(IntSize(m_maxTextureSize, m_maxTextureSize));
     return true;
 }
 
@@ -650,7 +812,8 @@ bool CCResourceProvider::transferResource(WebGraphicsContext3D* context, Resourc
     ASSERT(!source->lockedForWrite);
     ASSERT(!source->lockForReadCount);
     ASSERT(!source->external);
-    if (source->exported)
+    // A mailbox holds a whole texture, so resources in an atlas can't be sent.
+    if (source->exported || !source->atlasRect.isEmpty())
         return false;
     resource->id = id;
     resource->format = source->format;
@@ -8,6 +8,7 @@
 
 #include "CCGraphicsContext.h"
 #include "GraphicsContext3D.h"
+#include "IntRect.h"
 #include "IntSize.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
@@ -26,7 +27,7 @@ class WebGraphicsContext3D;
 
 namespace cc {
 
-class IntRect;
+class CCTextureAtlas;
 class LayerTextureSubImage;
 class TextureCopier;
 class TextureUploader;
@@ -88,6 +89,12 @@ public:
     // You can also explicitly create a specific resource type.
     ResourceId createGLTexture(int pool, const IntSize&, GC3Denum format, TextureUsageHint);
     ResourceId createBitmap(int pool, const IntSize&);
+    // Creates a resource in a texture shared with other small resources of the
+    // same format, if it is small enough. Otherwise, or if the default
+    // resource type is not GLTexture, this is the same as createResource().
+    // Resources in an atlas can be uploaded to and drawn (the read lock gives
+    // their place in the texture), but not rendered to or sent to the parent.
+    ResourceId createAtlasedResource(int pool, const IntSize&, GC3Denum format);
     // Wraps an external texture into a GL resource.
     ResourceId createResourceFromExternalTexture(unsigned textureId);
 
@@ -99,6 +106,16 @@ public:
     // Upload data from image, copying sourceRect (in image) into destRect (in the resource).
     void upload(ResourceId, const uint8_t* image, const IntRect& imageRect, const IntRect& sourceRect, const IntSize& destOffset);
 
+    // Pixel buffers (GL_CHROMIUM_pixel_transfer_buffer_object) live in memory
+    // shared with the GPU process, so contents written to them are uploaded
+    // without another copy and without waiting for the upload.
+    bool canUsePixelBuffers() const { return m_usePixelBuffers; }
+    // Maps the pixel buffer of a GL resource for writing size.width() x size.height()
+    // pixels, 4 bytes each, without row padding. Returns 0 on failure.
+    uint8_t* mapPixelBuffer(ResourceId, const IntSize&);
+    // Unmaps the pixel buffer and uploads the pixels written to it at destOffset.
+    void unmapPixelBufferAndUpload(ResourceId, const IntSize&, const IntSize& destOffset);
+
     // Flush all context operations, kicking uploads and ensuring ordering with
     // respect to other contexts.
     void flush();
@@ -158,10 +175,18 @@ public:
 
         unsigned textureId() const { return m_textureId; }
 
+        // For resources in an atlas, the part of the texture that holds the
+        // resource and the size of the whole texture.
+        bool inAtlas() const { return !m_atlasRect.isEmpty(); }
+        const IntRect& atlasRect() const { return m_atlasRect; }
+        const IntSize& atlasSize() const { return m_atlasSize; }
+
     private:
         CCResourceProvider* m_resourceProvider;
         CCResourceProvider::ResourceId m_resourceId;
         unsigned m_textureId;
+        IntRect m_atlasRect;
+        IntSize m_atlasSize;
     };
 
     class ScopedWriteLockGL {
@@ -214,6 +239,9 @@ private:
         Resource(uint8_t* pixels, int pool, const IntSize& size, GC3Denum format);
 
         unsigned glId;
+        unsigned glPixelBufferId;
+        size_t pixelBufferSize;
+        uint8_t* mappedPixelBuffer;
         uint8_t* pixels;
         int pool;
         int lockForReadCount;
@@ -223,6 +251,8 @@ private:
         IntSize size;
         GC3Denum format;
         ResourceType type;
+        // Empty unless the resource is in an atlas texture.
+        IntRect atlasRect;
     };
     typedef HashMap<ResourceId, Resource> ResourceMap;
     struct Child {
@@ -234,6 +264,14 @@ private:
         ResourceIdMap parentToChildMap;
     };
     typedef HashMap<int, Child> ChildMap;
+    struct Atlas {
+        Atlas(unsigned glId, GC3Denum format, PassOwnPtr<CCTextureAtlas>);
+        ~Atlas();
+
+        unsigned glId;
+        GC3Denum format;
+        OwnPtr<CCTextureAtlas> allocator;
+    };
 
     explicit CCResourceProvider(CCGraphicsContext*);
     bool initialize();
@@ -243,6 +281,8 @@ private:
     const Resource* lockForWrite(ResourceId);
     void unlockForWrite(ResourceId);
     static void populateSkBitmapWithResource(SkBitmap*, const Resource*);
+    unsigned createTexture(const IntSize&, GC3Denum format, TextureUsageHint);
+    void freeAtlasRect(const Resource*);
 
     bool transferResource(WebKit::WebGraphicsContext3D*, ResourceId, TransferableResource*);
     void trimMailboxDeque();
@@ -255,10 +295,14 @@ private:
 
     Deque<Mailbox> m_mailboxes;
 
+    Vector<OwnPtr<Atlas> > m_atlases;
+    IntSize m_atlasSize;
+
     ResourceType m_defaultResourceType;
     bool m_useTextureStorageExt;
     bool m_useTextureUsageHint;
     bool m_useShallowFlush;
+    bool m_usePixelBuffers;
     OwnPtr<LayerTextureSubImage> m_texSubImage;
     OwnPtr<TextureUploader> m_textureUploader;
     OwnPtr<AcceleratedTextureCopier> m_textureCopier;
@@ -16,6 +16,7 @@
 #include <wtf/HashMap.h>
 #include <wtf/OwnArrayPtr.h>
 #include <wtf/OwnPtr.h>
+#include <wtf/Vector.h>
 
 using namespace cc;
 using namespace WebKit;
@@ -410,6 +411,63 @@ TEST_P(CCResourceProviderTest, Upload)
     m_resourceProvider->deleteResource(id);
 }
 
+TEST_P(CCResourceProviderTest, AtlasedResources)
+{
+    WGC3Denum format = GraphicsContext3D::RGBA;
+    int pool = 1;
+
+    IntSize smallSize(2, 2);
+    CCResourceProvider::ResourceId id1 = m_resourceProvider->createAtlasedResource(pool, smallSize, format);
+    CCResourceProvider::ResourceId id2 = m_resourceProvider->createAtlasedResource(pool, smallSize, format);
+    // Large resources get a texture of their own.
+    CCResourceProvider::ResourceId id3 = m_resourceProvider->createAtlasedResource(pool, IntSize(300, 300), format);
+    EXPECT_EQ(3u, m_resourceProvider->numResources());
+    if (GetParam() != CCResourceProvider::GLTexture)
+        return;
+    EXPECT_EQ(2, context()->textureCount());
+
+    uint8_t image[16];
+    for (uint8_t i = 0; i < 16; ++i)
+        image[i] = i + 1;
+    IntRect imageRect(IntPoint(), smallSize);
+    m_resourceProvider->upload(id2, image, imageRect, IntRect(1, 0, 1, 1), IntSize(1, 1));
+
+    IntRect atlasRect1;
+    IntRect atlasRect2;
+    {
+        CCResourceProvider::ScopedReadLockGL lock1(m_resourceProvider.get(), id1);
+        CCResourceProvider::ScopedReadLockGL lock2(m_resourceProvider.get(), id2);
+        CCResourceProvider::ScopedReadLockGL lock3(m_resourceProvider.get(), id3);
+        EXPECT_EQ(lock1.textureId(), lock2.textureId());
+        EXPECT_NE(lock1.textureId(), lock3.textureId());
+        EXPECT_TRUE(lock1.inAtlas());
+        EXPECT_TRUE(lock2.inAtlas());
+        EXPECT_FALSE(lock3.inAtlas());
+        atlasRect1 = lock1.atlasRect();
+        atlasRect2 = lock2.atlasRect();
+        EXPECT_EQ(smallSize, atlasRect1.size());
+        EXPECT_EQ(smallSize, atlasRect2.size());
+        EXPECT_FALSE(atlasRect1.intersects(atlasRect2));
+
+        // The upload went to the part of the atlas that holds the resource.
+        IntSize atlasSize = lock2.atlasSize();
+        OwnArrayPtr<uint8_t> pixels = adoptArrayPtr(new uint8_t[textureSize(atlasSize, format)]);
+        context()->bindTexture(GraphicsContext3D::TEXTURE_2D, lock2.textureId());
+        context()->getPixels(atlasSize, format, pixels.get());
+        const uint8_t* pixel = pixels.get() + textureSize(IntSize(atlasSize.width() * (atlasRect2.y() + 1) + atlasRect2.x() + 1, 1), format);
+        uint8_t expected[4] = {5, 6, 7, 8};
+        EXPECT_EQ(0, memcmp(expected, pixel, 4));
+    }
+
+    // The atlas texture goes away with its last resource.
+    m_resourceProvider->deleteResource(id1);
+    EXPECT_EQ(2, context()->textureCount());
+    m_resourceProvider->deleteResource(id2);
+    EXPECT_EQ(1, context()->textureCount());
+    m_resourceProvider->deleteResource(id3);
+    EXPECT_EQ(0, context()->textureCount());
+}
+
 TEST_P(CCResourceProviderTest, TransferResources)
 {
     // Resource transfer is only supported with GL textures for now.
@@ -527,6 +585,123 @@ TEST_P(CCResourceProviderTest, TransferResources)
     EXPECT_EQ(0u, m_resourceProvider->mailboxCount());
 }
 
+// Emulates GL_CHROMIUM_pixel_transfer_buffer_object.
+class PixelBufferContext : public ResourceProviderContext {
+public:
+    static PassOwnPtr<PixelBufferContext> create(ContextSharedData* sharedData) { return adoptPtr(new PixelBufferContext(Attributes(), sharedData)); }
+
+    virtual WebString getString(WGC3Denum name)
+    {
+        return WebString("GL_CHROMIUM_pixel_transfer_buffer_object");
+    }
+
+    virtual WebGLId createBuffer()
+    {
+        WebGLId id = ++m_nextBufferId;
+        m_buffers.set(id, adoptPtr(new Vector<uint8_t>));
+        return id;
+    }
+
+    virtual void deleteBuffer(WebGLId id)
+    {
+        ASSERT(m_buffers.contains(id));
+        m_buffers.remove(id);
+    }
+
+    virtual void bindBuffer(WGC3Denum target, WebGLId buffer)
+    {
+        ASSERT(target == Extensions3DChromium::PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM);
+        ASSERT(!buffer || m_buffers.contains(buffer));
+        m_boundPixelBuffer = buffer;
+    }
+
+    virtual void bufferData(WGC3Denum target, WGC3Dsizeiptr size, const void* data, WGC3Denum usage)
+    {
+        ASSERT(m_boundPixelBuffer);
+        ASSERT(!data);
+        m_buffers.get(m_boundPixelBuffer)->resize(size);
+    }
+
+    virtual void* mapBufferSubDataCHROMIUM(WGC3Denum target, WGC3Dintptr offset, WGC3Dsizeiptr size, WGC3Denum access)
+    {
+        ASSERT(m_boundPixelBuffer);
+        Vector<uint8_t>* buffer = m_buffers.get(m_boundPixelBuffer);
+        ASSERT(offset + size <= static_cast<WGC3Dsizeiptr>(buffer->size()));
+        return buffer->data() + offset;
+    }
+
+    virtual void unmapBufferSubDataCHROMIUM(const void*) { }
+
+    virtual void texSubImage2D(WGC3Denum target, WGC3Dint level, WGC3Dint xoffset, WGC3Dint yoffset, WGC3Dsizei width, WGC3Dsizei height, WGC3Denum format, WGC3Denum type, const void* pixels)
+    {
+        // With a bound pixel buffer, pixels is an offset in the buffer.
+        if (m_boundPixelBuffer) {
+            ++m_pixelBufferUploadCount;
+            pixels = m_buffers.get(m_boundPixelBuffer)->data() + reinterpret_cast<intptr_t>(pixels);
+        }
+        ResourceProviderContext::texSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    }
+
+    int pixelBufferUploadCount() const { return m_pixelBufferUploadCount; }
+    int bufferCount() const { return m_buffers.size(); }
+
+private:
+    PixelBufferContext(const Attributes& attrs, ContextSharedData* sharedData)
+        : ResourceProviderContext(attrs, sharedData)
+        , m_nextBufferId(0)
+        , m_boundPixelBuffer(0)
+        , m_pixelBufferUploadCount(0)
+    { }
+
+    WebGLId m_nextBufferId;
+    WebGLId m_boundPixelBuffer;
+    HashMap<WebGLId, OwnPtr<Vector<uint8_t> > > m_buffers;
+    int m_pixelBufferUploadCount;
+};
+
+TEST(CCResourceProviderPixelBufferTest, UploadFromPixelBuffer)
+{
+    DebugScopedSetImplThread implThread;
+    OwnPtr<ContextSharedData> sharedData(ContextSharedData::create());
+    OwnPtr<CCGraphicsContext> outputSurface(FakeWebCompositorOutputSurface::create(PixelBufferContext::create(sharedData.get())));
+    PixelBufferContext* context = static_cast<PixelBufferContext*>(outputSurface->context3D());
+    OwnPtr<CCResourceProvider> resourceProvider(CCResourceProvider::create(outputSurface.get()));
+    ASSERT_TRUE(resourceProvider->canUsePixelBuffers());
+
+    IntSize size(2, 2);
+    WGC3Denum format = GraphicsContext3D::RGBA;
+    size_t pixelSize = textureSize(size, format);
+    CCResourceProvider::ResourceId id = resourceProvider->createResource(1, size, format, CCResourceProvider::TextureUsageAny);
+
+    uint8_t zeros[16] = {0};
+    IntRect imageRect(IntPoint(), size);
+    resourceProvider->upload(id, zeros, imageRect, imageRect, IntSize());
+    EXPECT_EQ(0, context->pixelBufferUploadCount());
+
+    // Write one pixel into the pixel buffer, and upload it at (1, 1).
+    uint8_t* pixels = resourceProvider->mapPixelBuffer(id, IntSize(1, 1));
+    ASSERT_TRUE(pixels);
+    for (uint8_t i = 0; i < 4; ++i)
+        pixels[i] = i + 1;
+    resourceProvider->unmapPixelBufferAndUpload(id, IntSize(1, 1), IntSize(1, 1));
+    EXPECT_EQ(1, context->pixelBufferUploadCount());
+    EXPECT_EQ(1, context->bufferCount());
+
+    uint8_t expected[16] = {0, 0, 0, 0,   0, 0, 0, 0,
+                            0, 0, 0, 0,   1, 2, 3, 4};
+    uint8_t result[16] = {0};
+    {
+        CCResourceProvider::ScopedReadLockGL lockGL(resourceProvider.get(), id);
+        context->bindTexture(GraphicsContext3D::TEXTURE_2D, lockGL.textureId());
+        context->getPixels(size, format, result);
+    }
+    EXPECT_EQ(0, memcmp(expected, result, pixelSize));
+
+    // The pixel buffer goes away with the resource.
+    resourceProvider->deleteResource(id);
+    EXPECT_EQ(0, context->bufferCount());
+}
+
 INSTANTIATE_TEST_CASE_P(CCResourceProviderTests,
                         CCResourceProviderTest,
                         ::testing::Values(CCResourceProvider::GLTexture,
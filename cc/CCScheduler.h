@@ -83,6 +83,7 @@ public:
 
     bool commitPending() const { return m_stateMachine.commitPending(); }
     bool redrawPending() const { return m_stateMachine.redrawPending(); }
+    int framesBlockedByMainThread() const { return m_stateMachine.framesBlockedByMainThread(); }
 
     void setTimebaseAndInterval(base::TimeTicks timebase, base::TimeDelta interval);
 
@@ -16,6 +16,8 @@ CCSchedulerStateMachine::CCSchedulerStateMachine()
     , m_lastFrameNumberWhereDrawWasCalled(-1)
     , m_consecutiveFailedDraws(0)
     , m_maximumNumberOfFailedDrawsBeforeDrawIsForced(3)
+    , m_failedDrawsDuringMainThreadFrame(0)
+    , m_framesBlockedByMainThread(0)
     , m_needsRedraw(false)
     , m_needsForcedRedraw(false)
     , m_needsForcedRedrawAfterNextCommit(false)
@@ -41,6 +43,8 @@ std::string CCSchedulerStateMachine::toString()
     base::StringAppendF(&str, "m_lastFrameNumberWhereDrawWasCalled = %d; ", m_lastFrameNumberWhereDrawWasCalled);
     base::StringAppendF(&str, "m_consecutiveFailedDraws = %d; ", m_consecutiveFailedDraws);
     base::StringAppendF(&str, "m_maximumNumberOfFailedDrawsBeforeDrawIsForced = %d; ", m_maximumNumberOfFailedDrawsBeforeDrawIsForced);
+    base::StringAppendF(&str, "m_failedDrawsDuringMainThreadFrame = %d; ", m_failedDrawsDuringMainThreadFrame);
+    base::StringAppendF(&str, "m_framesBlockedByMainThread = %d; ", m_framesBlockedByMainThread);
     base::StringAppendF(&str, "m_needsRedraw = %d; ", m_needsRedraw);
     base::StringAppendF(&str, "m_needsForcedRedraw = %d; ", m_needsForcedRedraw);
     base::StringAppendF(&str, "m_needsForcedRedrawAfterNextCommit = %d; ", m_needsForcedRedrawAfterNextCommit);
@@ -175,6 +179,7 @@ void CCSchedulerStateMachine::updateState(Action action)
         m_commitState = COMMIT_STATE_FRAME_IN_PROGRESS;
         m_needsCommit = false;
         m_needsForcedCommit = false;
+        m_failedDrawsDuringMainThreadFrame = 0;
         return;
 
     case ACTION_BEGIN_UPDATE_RESOURCES:
@@ -254,6 +259,9 @@ void CCSchedulerStateMachine::didEnterVSync()
 
 void CCSchedulerStateMachine::didLeaveVSync()
 {
+    // A redraw was wanted in this vsync, but the main thread held the layer textures.
+    if (m_needsRedraw && m_visible && m_canDraw && m_textureState == LAYER_TEXTURE_STATE_ACQUIRED_BY_MAIN_THREAD)
+        m_framesBlockedByMainThread++;
     m_currentFrameNumber++;
     m_insideVSync = false;
 }
@@ -286,6 +294,15 @@ void CCSchedulerStateMachine::didDrawIfPossibleCompleted(bool success)
             // we've committed and have new textures.
             m_needsForcedRedrawAfterNextCommit = true;
         }
+        if (m_commitState == COMMIT_STATE_FRAME_IN_PROGRESS) {
+            m_framesBlockedByMainThread++;
+            // The main thread can be busy for a long time, e.g. running script,
+            // before the commit with the missing textures arrives. Rather than
+            // stopping impl-side scrolling and animations until then, keep
+            // drawing them with checkerboards.
+            if (++m_failedDrawsDuringMainThreadFrame > m_maximumNumberOfFailedDrawsBeforeDrawIsForced)
+                m_needsForcedRedraw = true;
+        }
     } else
       m_consecutiveFailedDraws = 0;
 }
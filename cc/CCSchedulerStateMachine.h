@@ -129,6 +129,11 @@ public:
     // Exposed for testing purposes.
     void setMaximumNumberOfFailedDrawsBeforeDrawIsForced(int);
 
+    // The number of frames that could not be drawn because the impl thread
+    // was waiting for the main thread, either for a commit with the missing
+    // textures or for the layer textures the main thread holds.
+    int framesBlockedByMainThread() const { return m_framesBlockedByMainThread; }
+
     std::string toString();
 
 protected:
@@ -145,6 +150,8 @@ protected:
     int m_lastFrameNumberWhereDrawWasCalled;
     int m_consecutiveFailedDraws;
     int m_maximumNumberOfFailedDrawsBeforeDrawIsForced;
+    int m_failedDrawsDuringMainThreadFrame;
+    int m_framesBlockedByMainThread;
     bool m_needsRedraw;
     bool m_needsForcedRedraw;
     bool m_needsForcedRedrawAfterNextCommit;
@@ -311,6 +311,50 @@ TEST(CCSchedulerStateMachineTest, TestFailedDrawsWillEventuallyForceADrawAfterTh
     EXPECT_EQ(CCSchedulerStateMachine::ACTION_DRAW_FORCED, state.nextAction());
 }
 
+TEST(CCSchedulerStateMachineTest, TestFailedDrawsWhileMainThreadIsBusyForceADrawBeforeTheCommit)
+{
+    CCSchedulerStateMachine state;
+    state.setCanBeginFrame(true);
+    state.setVisible(true);
+    state.setCanDraw(true);
+    state.setMaximumNumberOfFailedDrawsBeforeDrawIsForced(2);
+
+    // Start a commit that the main thread does not finish.
+    state.setNeedsCommit();
+    EXPECT_EQ(CCSchedulerStateMachine::ACTION_BEGIN_FRAME, state.nextAction());
+    state.updateState(CCSchedulerStateMachine::ACTION_BEGIN_FRAME);
+    EXPECT_TRUE(state.commitPending());
+
+    // Fail as many draws as allowed.
+    for (int i = 0; i < 2; ++i) {
+        state.setNeedsRedraw();
+        state.didEnterVSync();
+        EXPECT_EQ(CCSchedulerStateMachine::ACTION_DRAW_IF_POSSIBLE, state.nextAction());
+        state.updateState(CCSchedulerStateMachine::ACTION_DRAW_IF_POSSIBLE);
+        state.didDrawIfPossibleCompleted(false);
+        EXPECT_EQ(CCSchedulerStateMachine::ACTION_NONE, state.nextAction());
+        state.didLeaveVSync();
+    }
+    EXPECT_EQ(2, state.framesBlockedByMainThread());
+
+    // The next failed draw is forced, without waiting for the commit.
+    state.didEnterVSync();
+    EXPECT_EQ(CCSchedulerStateMachine::ACTION_DRAW_IF_POSSIBLE, state.nextAction());
+    state.updateState(CCSchedulerStateMachine::ACTION_DRAW_IF_POSSIBLE);
+    state.didDrawIfPossibleCompleted(false);
+    EXPECT_EQ(CCSchedulerStateMachine::ACTION_DRAW_FORCED, state.nextAction());
+    state.updateState(CCSchedulerStateMachine::ACTION_DRAW_FORCED);
+    EXPECT_EQ(3, state.framesBlockedByMainThread());
+    EXPECT_TRUE(state.commitPending());
+    state.didLeaveVSync();
+
+    // Once the main thread finishes its frame, draws wait for the commit again.
+    state.beginFrameComplete(false);
+    state.setNeedsRedraw();
+    state.didEnterVSync();
+    EXPECT_EQ(CCSchedulerStateMachine::ACTION_COMMIT, state.nextAction());
+}
+
 TEST(CCSchedulerStateMachineTest, TestFailedDrawIsRetriedNextVSync)
 {
     CCSchedulerStateMachine state;
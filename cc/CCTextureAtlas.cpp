@@ -0,0 +1,90 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "CCTextureAtlas.h"
+
+namespace cc {
+
+CCTextureAtlas::CCTextureAtlas(const IntSize& size)
+    : m_size(size)
+    , m_numAllocations(0)
+{
+}
+
+bool CCTextureAtlas::allocate(const IntSize& size, IntRect* result)
+{
+    ASSERT(!size.isEmpty());
+    IntSize paddedSize(size.width() + 1, size.height() + 1);
+    if (paddedSize.width() > m_size.width() || paddedSize.height() > m_size.height())
+        return false;
+
+    // Prefer the shelves that are not much taller than the rectangle, to keep
+    // the space wasted above it small.
+    for (size_t i = 0; i < m_shelves.size(); ++i) {
+        Shelf& shelf = m_shelves[i];
+        if (shelf.height >= paddedSize.height() && shelf.height <= 2 * paddedSize.height() && allocateOnShelf(shelf, paddedSize, result))
+            return true;
+    }
+
+    // Start a new shelf below the last one.
+    int y = m_shelves.isEmpty() ? 0 : m_shelves.last().y + m_shelves.last().height;
+    if (y + paddedSize.height() > m_size.height()) {
+        for (size_t i = 0; i < m_shelves.size(); ++i) {
+            Shelf& shelf = m_shelves[i];
+            if (shelf.height > 2 * paddedSize.height() && allocateOnShelf(shelf, paddedSize, result))
+                return true;
+        }
+        return false;
+    }
+    m_shelves.append(Shelf(y, paddedSize.height()));
+    bool allocated = allocateOnShelf(m_shelves.last(), paddedSize, result);
+    ASSERT_UNUSED(allocated, allocated);
+    return true;
+}
+
+bool CCTextureAtlas::allocateOnShelf(Shelf& shelf, const IntSize& paddedSize, IntRect* result)
+{
+    // First fit in the gaps between the spans.
+    int x = 0;
+    size_t index = 0;
+    for (; index < shelf.spans.size(); ++index) {
+        if (shelf.spans[index].x - x >= paddedSize.width())
+            break;
+        x = shelf.spans[index].x + shelf.spans[index].width;
+    }
+    if (index == shelf.spans.size() && m_size.width() - x < paddedSize.width())
+        return false;
+
+    shelf.spans.insert(index, Span(x, paddedSize.width()));
+    *result = IntRect(x, shelf.y, paddedSize.width() - 1, paddedSize.height() - 1);
+    ++m_numAllocations;
+    return true;
+}
+
+void CCTextureAtlas::free(const IntRect& rect)
+{
+    for (size_t i = 0; i < m_shelves.size(); ++i) {
+        Shelf& shelf = m_shelves[i];
+        if (shelf.y != rect.y())
+            continue;
+        for (size_t j = 0; j < shelf.spans.size(); ++j) {
+            if (shelf.spans[j].x != rect.x())
+                continue;
+            ASSERT(shelf.spans[j].width == rect.width() + 1);
+            shelf.spans.remove(j);
+            --m_numAllocations;
+
+            // Give the space of the empty shelves at the bottom back, so that
+            // it can be used by shelves of a different height.
+            while (!m_shelves.isEmpty() && m_shelves.last().spans.isEmpty())
+                m_shelves.removeLast();
+            return;
+        }
+    }
+    ASSERT_NOT_REACHED();
+}
+
+}
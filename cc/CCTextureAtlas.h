@@ -0,0 +1,68 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CCTextureAtlas_h
+#define CCTextureAtlas_h
+
+#include "IntRect.h"
+#include "IntSize.h"
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+
+namespace cc {
+
+// Packs small rectangles into a texture of a fixed size. Rectangles are placed
+// on horizontal shelves, each as tall as the first rectangle placed on it, and
+// are separated by a one texel gutter so that linear filtering at the edge of
+// a rectangle does not pick up its neighbours. This only does the bookkeeping;
+// the texture itself is owned by the caller.
+class CCTextureAtlas {
+    WTF_MAKE_NONCOPYABLE(CCTextureAtlas);
+public:
+    static PassOwnPtr<CCTextureAtlas> create(const IntSize& size)
+    {
+        return adoptPtr(new CCTextureAtlas(size));
+    }
+
+    const IntSize& size() const { return m_size; }
+    bool isEmpty() const { return !m_numAllocations; }
+
+    // Returns false if there is no room for a rectangle of the given size.
+    bool allocate(const IntSize&, IntRect* result);
+    // Releases a rectangle returned by allocate().
+    void free(const IntRect&);
+
+private:
+    explicit CCTextureAtlas(const IntSize&);
+
+    struct Span {
+        Span() : x(0), width(0) { }
+        Span(int x, int width) : x(x), width(width) { }
+
+        int x;
+        int width;
+    };
+
+    struct Shelf {
+        Shelf() : y(0), height(0) { }
+        Shelf(int y, int height) : y(y), height(height) { }
+
+        int y;
+        int height;
+        // The allocations on this shelf, sorted by x. Each span includes the
+        // gutter on its right.
+        Vector<Span> spans;
+    };
+
+    bool allocateOnShelf(Shelf&, const IntSize& paddedSize, IntRect* result);
+
+    IntSize m_size;
+    Vector<Shelf> m_shelves;
+    int m_numAllocations;
+};
+
+}
+
+#endif
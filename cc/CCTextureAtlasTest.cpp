@@ -0,0 +1,74 @@
+// Copyright 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "CCTextureAtlas.h"
+
+#include <gtest/gtest.h>
+#include <wtf/OwnPtr.h>
+
+using namespace cc;
+
+namespace {
+
+TEST(CCTextureAtlasTest, allocationsDoNotOverlap)
+{
+    OwnPtr<CCTextureAtlas> atlas = CCTextureAtlas::create(IntSize(64, 64));
+    EXPECT_TRUE(atlas->isEmpty());
+
+    Vector<IntRect> rects;
+    IntRect rect;
+    while (atlas->allocate(IntSize(10, 7), &rect)) {
+        EXPECT_EQ(IntSize(10, 7), rect.size());
+        EXPECT_TRUE(IntRect(IntPoint(), atlas->size()).contains(rect));
+        rects.append(rect);
+    }
+    // 5 columns of 11 texels and 8 rows of 8 texels, with the gutters.
+    EXPECT_EQ(40u, rects.size());
+
+    for (size_t i = 0; i < rects.size(); ++i) {
+        IntRect padded(rects[i].location(), rects[i].size() + IntSize(1, 1));
+        for (size_t j = 0; j < i; ++j)
+            EXPECT_FALSE(padded.intersects(rects[j]));
+    }
+    EXPECT_FALSE(atlas->isEmpty());
+}
+
+TEST(CCTextureAtlasTest, freedSpaceIsReused)
+{
+    OwnPtr<CCTextureAtlas> atlas = CCTextureAtlas::create(IntSize(32, 32));
+
+    IntRect first;
+    IntRect second;
+    EXPECT_TRUE(atlas->allocate(IntSize(15, 31), &first));
+    EXPECT_TRUE(atlas->allocate(IntSize(15, 31), &second));
+    IntRect third;
+    EXPECT_FALSE(atlas->allocate(IntSize(15, 31), &third));
+
+    atlas->free(first);
+    EXPECT_TRUE(atlas->allocate(IntSize(15, 31), &third));
+    EXPECT_EQ(first, third);
+
+    atlas->free(second);
+    atlas->free(third);
+    EXPECT_TRUE(atlas->isEmpty());
+
+    // Once empty, the shelves can be reused for a different height.
+    EXPECT_TRUE(atlas->allocate(IntSize(31, 15), &first));
+    EXPECT_TRUE(atlas->allocate(IntSize(31, 15), &second));
+    EXPECT_EQ(IntPoint(0, 16), second.location());
+}
+
+TEST(CCTextureAtlasTest, tooLargeFails)
+{
+    OwnPtr<CCTextureAtlas> atlas = CCTextureAtlas::create(IntSize(32, 32));
+
+    IntRect rect;
+    EXPECT_FALSE(atlas->allocate(IntSize(32, 8), &rect));
+    EXPECT_FALSE(atlas->allocate(IntSize(8, 32), &rect));
+    EXPECT_TRUE(atlas->isEmpty());
+}
+
+} // namespace
@@ -926,6 +926,7 @@ void CCThreadProxy::implSideRenderingStatsOnImplThread(CCCompletionEvent* comple
 {
     ASSERT(isImplThread());
     m_layerTreeHostImpl->renderingStats(*stats);
+    stats->numFramesBlockedByMainThread = m_schedulerOnImplThread->framesBlockedByMainThread();
     completion->signal();
 }
 
@@ -146,10 +146,15 @@ void CCTiledLayerImpl::appendQuads(CCQuadSink& quadSink, CCAppendQuadsData& appe
                 continue;
 
             if (!tile || !tile->resourceId()) {
+                bool appended;
                 if (drawCheckerboardForMissingTiles())
-                    appendQuadsData.hadMissingTiles |= quadSink.append(CCCheckerboardDrawQuad::create(sharedQuadState, tileRect), appendQuadsData);
+                    appended = quadSink.append(CCCheckerboardDrawQuad::create(sharedQuadState, tileRect), appendQuadsData);
                 else
-                    appendQuadsData.hadMissingTiles |= quadSink.append(CCSolidColorDrawQuad::create(sharedQuadState, tileRect, backgroundColor()), appendQuadsData);
+                    appended = quadSink.append(CCSolidColorDrawQuad::create(sharedQuadState, tileRect, backgroundColor()), appendQuadsData);
+                if (appended) {
+                    appendQuadsData.hadMissingTiles = true;
+                    ++appendQuadsData.numMissingTiles;
+                }
                 continue;
             }
 
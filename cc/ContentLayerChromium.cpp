@@ -71,6 +71,7 @@ void ContentLayerChromium::setTexturePriorities(const CCPriorityCalculator& prio
 void ContentLayerChromium::update(CCTextureUpdateQueue& queue, const CCOcclusionTracker* occlusion, CCRenderingStats& stats)
 {
     createTextureUpdaterIfNeeded();
+    m_textureUpdater->setRasterWorkerPool(layerTreeHost()->rasterWorkerPool());
     TiledLayerChromium::update(queue, occlusion, stats);
     m_needsDisplay = false;
 }
@@ -89,12 +90,15 @@ void ContentLayerChromium::createTextureUpdaterIfNeeded()
 {
     if (m_textureUpdater)
         return;
-    if (layerTreeHost()->settings().acceleratePainting)
+    if (layerTreeHost()->settings().acceleratePainting) {
         m_textureUpdater = FrameBufferSkPictureCanvasLayerTextureUpdater::create(ContentLayerPainter::create(m_client));
-    else if (CCSettings::perTilePaintingEnabled())
-        m_textureUpdater = BitmapSkPictureCanvasLayerTextureUpdater::create(ContentLayerPainter::create(m_client));
-    else
+    } else if (CCSettings::perTilePaintingEnabled()) {
+        RefPtr<BitmapSkPictureCanvasLayerTextureUpdater> textureUpdater = BitmapSkPictureCanvasLayerTextureUpdater::create(ContentLayerPainter::create(m_client));
+        textureUpdater->setUsePixelBuffers(layerTreeHost()->rendererCapabilities().usingPixelBuffers);
+        m_textureUpdater = textureUpdater.release();
+    } else {
         m_textureUpdater = BitmapCanvasLayerTextureUpdater::create(ContentLayerPainter::create(m_client));
+    }
     m_textureUpdater->setOpaque(opaque());
 
     GC3Denum textureFormat = layerTreeHost()->rendererCapabilities().bestTextureFormat;
@@ -11,6 +11,7 @@
 #include "CCRendererGL.h" // For the GLC() macro.
 #include "GraphicsContext3D.h"
 #include <public/WebGraphicsContext3D.h>
+#include <wtf/Vector.h>
 
 namespace cc {
 
@@ -18,6 +19,8 @@ GeometryBinding::GeometryBinding(WebKit::WebGraphicsContext3D* context, const Fl
     : m_context(context)
     , m_quadVerticesVbo(0)
     , m_quadElementsVbo(0)
+    , m_batchVerticesVbo(0)
+    , m_batchElementsVbo(0)
     , m_initialized(false)
 {
     // Vertex positions and texture coordinates for the 4 corners of a 1x1 quad.
@@ -42,6 +45,10 @@ GeometryBinding::~GeometryBinding()
 {
     GLC(m_context, m_context->deleteBuffer(m_quadVerticesVbo));
     GLC(m_context, m_context->deleteBuffer(m_quadElementsVbo));
+    if (m_batchVerticesVbo)
+        GLC(m_context, m_context->deleteBuffer(m_batchVerticesVbo));
+    if (m_batchElementsVbo)
+        GLC(m_context, m_context->deleteBuffer(m_batchElementsVbo));
 }
 
 void GeometryBinding::prepareForDraw()
@@ -54,6 +61,42 @@ void GeometryBinding::prepareForDraw()
     GLC(m_context, m_context->vertexAttribPointer(texCoordAttribLocation(), 2, GraphicsContext3D::FLOAT, false, 5 * sizeof(float), offset));
     GLC(m_context, m_context->enableVertexAttribArray(positionAttribLocation()));
     GLC(m_context, m_context->enableVertexAttribArray(texCoordAttribLocation()));
+    GLC(m_context, m_context->disableVertexAttribArray(alphaAttribLocation()));
+}
+
+void GeometryBinding::prepareForBatchedDraw(const float* vertices, int quadCount)
+{
+    ASSERT(quadCount > 0 && quadCount <= maxBatchedQuads());
+
+    if (!m_batchElementsVbo) {
+        // The indices never change, so they are only uploaded once.
+        Vector<uint16_t> indices(maxBatchedQuads() * 6);
+        for (int i = 0; i < maxBatchedQuads(); ++i) {
+            uint16_t first = static_cast<uint16_t>(i * 4);
+            indices[i * 6] = first;
+            indices[i * 6 + 1] = first + 1;
+            indices[i * 6 + 2] = first + 2;
+            indices[i * 6 + 3] = first;
+            indices[i * 6 + 4] = first + 2;
+            indices[i * 6 + 5] = first + 3;
+        }
+        GLC(m_context, m_batchVerticesVbo = m_context->createBuffer());
+        GLC(m_context, m_batchElementsVbo = m_context->createBuffer());
+        GLC(m_context, m_context->bindBuffer(GraphicsContext3D::ELEMENT_ARRAY_BUFFER, m_batchElementsVbo));
+        GLC(m_context, m_context->bufferData(GraphicsContext3D::ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GraphicsContext3D::STATIC_DRAW));
+    }
+
+    int stride = batchedVertexSize() * sizeof(float);
+    GLC(m_context, m_context->bindBuffer(GraphicsContext3D::ARRAY_BUFFER, m_batchVerticesVbo));
+    GLC(m_context, m_context->bufferData(GraphicsContext3D::ARRAY_BUFFER, quadCount * 4 * stride, vertices, GraphicsContext3D::STREAM_DRAW));
+    GLC(m_context, m_context->bindBuffer(GraphicsContext3D::ELEMENT_ARRAY_BUFFER, m_batchElementsVbo));
+    unsigned offset = 0;
+    GLC(m_context, m_context->vertexAttribPointer(positionAttribLocation(), 4, GraphicsContext3D::FLOAT, false, stride, offset));
+    offset += 4 * sizeof(float);
+    GLC(m_context, m_context->vertexAttribPointer(texCoordAttribLocation(), 2, GraphicsContext3D::FLOAT, false, stride, offset));
+    offset += 2 * sizeof(float);
+    GLC(m_context, m_context->vertexAttribPointer(alphaAttribLocation(), 1, GraphicsContext3D::FLOAT, false, stride, offset));
+    GLC(m_context, m_context->enableVertexAttribArray(alphaAttribLocation()));
 }
 
 } // namespace cc
@@ -28,16 +28,31 @@ public:
 
     void prepareForDraw();
 
+    // Uploads the vertices of up to maxBatchedQuads() quads and binds them
+    // for drawing with a single drawElements() call. Each vertex is a clip
+    // space position (4 floats), a texture coordinate (2 floats) and an alpha
+    // (1 float), and each quad is made of 4 vertices in the same order as the
+    // shared quad. prepareForDraw() must be called to draw with the shared
+    // quad again.
+    void prepareForBatchedDraw(const float* vertices, int quadCount);
+
+    static int maxBatchedQuads() { return 256; }
+    static int batchedVertexSize() { return 7; }
+
     // All layer shaders share the same attribute locations for the vertex
     // positions and texture coordinates. This allows switching shaders without
     // rebinding attribute arrays.
     static int positionAttribLocation() { return 0; }
     static int texCoordAttribLocation() { return 1; }
+    // Only used by the batched shaders, which take the alpha per vertex.
+    static int alphaAttribLocation() { return 2; }
 
 private:
     WebKit::WebGraphicsContext3D* m_context;
     unsigned m_quadVerticesVbo;
     unsigned m_quadElementsVbo;
+    unsigned m_batchVerticesVbo;
+    unsigned m_batchElementsVbo;
     bool m_initialized;
 };
 
@@ -53,6 +53,8 @@ public:
                 LayerTextureUpdater::SampledTexelFormatRGBA : LayerTextureUpdater::SampledTexelFormatBGRA;
     }
 
+    virtual bool canUseAtlas() const OVERRIDE { return true; }
+
     void updateTextureRect(CCResourceProvider* resourceProvider, CCPrioritizedTexture* texture, const IntRect& sourceRect, const IntSize& destOffset)
     {
         // Source rect should never go outside the image pixels, even if this
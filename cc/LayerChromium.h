@@ -8,6 +8,7 @@
 
 #if USE(ACCELERATED_COMPOSITING)
 
+#include "CCCachedDrawProperties.h"
 #include "CCLayerAnimationController.h"
 #include "CCOcclusionTracker.h"
 #include "CCPrioritizedTexture.h"
@@ -224,6 +225,10 @@ public:
     // It converts logical, non-page-scaled pixels to physical pixels.
     const WebKit::WebTransformationMatrix& screenSpaceTransform() const { return m_screenSpaceTransform; }
     void setScreenSpaceTransform(const WebKit::WebTransformationMatrix& matrix) { m_screenSpaceTransform = matrix; }
+
+    // Used by CCLayerTreeHostCommon to skip recomputing the draw properties.
+    CCCachedDrawProperties& cachedDrawProperties() { return m_cachedDrawProperties; }
+
     const IntRect& drawableContentRect() const { return m_drawableContentRect; }
     void setDrawableContentRect(const IntRect& rect) { m_drawableContentRect = rect; }
     // The contentsScale converts from logical, non-page-scaled pixels to target pixels.
@@ -369,6 +374,7 @@ private:
     WebKit::WebTransformationMatrix m_screenSpaceTransform;
     bool m_drawTransformIsAnimating;
     bool m_screenSpaceTransformIsAnimating;
+    CCCachedDrawProperties m_cachedDrawProperties;
 
     // Uses target surface space.
     IntRect m_drawableContentRect;
@@ -17,6 +17,7 @@ namespace cc {
 class IntRect;
 class IntSize;
 class TextureManager;
+class CCRasterWorkerPool;
 struct CCRenderingStats;
 
 class LayerTextureUpdater : public RefCounted<LayerTextureUpdater> {
@@ -59,9 +60,19 @@ public:
     // The |resultingOpaqueRect| gives back a region of the layer that was painted opaque. If the layer is marked opaque in the updater,
     // then this region should be ignored in preference for the entire layer's area.
     virtual void prepareToUpdate(const IntRect& contentRect, const IntSize& tileSize, float contentsWidthScale, float contentsHeightScale, IntRect& resultingOpaqueRect, CCRenderingStats&) { }
+    // Called after prepareRect() was called for all the textures of an update. Textures
+    // prepared asynchronously must be ready for updateRect() when this returns.
+    virtual void finishPreparingRects(CCRenderingStats&) { }
+
+    // Updaters that rasterize tiles on worker threads use this pool when it is not null.
+    virtual void setRasterWorkerPool(CCRasterWorkerPool*) { }
 
     // Set true by the layer when it is known that the entire output is going to be opaque.
     virtual void setOpaque(bool) { }
+
+    // True if the textures are only written to with CCResourceProvider uploads,
+    // so that small ones can be packed into an atlas texture.
+    virtual bool canUseAtlas() const { return false; }
 };
 
 } // namespace cc
@@ -126,6 +126,7 @@ unsigned ProgramBindingBase::createShaderProgram(WebGraphicsContext3D* context,
     // Bind the common attrib locations.
     GLC(context, context->bindAttribLocation(programObject, GeometryBinding::positionAttribLocation(), "a_position"));
     GLC(context, context->bindAttribLocation(programObject, GeometryBinding::texCoordAttribLocation(), "a_texCoord"));
+    GLC(context, context->bindAttribLocation(programObject, GeometryBinding::alphaAttribLocation(), "a_alpha"));
 
     return programObject;
 }
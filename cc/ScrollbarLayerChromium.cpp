@@ -244,15 +244,18 @@ void ScrollbarLayerChromium::setTexturePriorities(const CCPriorityCalculator&)
 
     bool drawsToRoot = !renderTarget()->parent();
     if (m_backTrack) {
+        m_backTrack->texture()->setUseAtlas(true);
         m_backTrack->texture()->setDimensions(contentBounds(), m_textureFormat);
         m_backTrack->texture()->setRequestPriority(CCPriorityCalculator::uiPriority(drawsToRoot));
     }
     if (m_foreTrack) {
+        m_foreTrack->texture()->setUseAtlas(true);
         m_foreTrack->texture()->setDimensions(contentBounds(), m_textureFormat);
         m_foreTrack->texture()->setRequestPriority(CCPriorityCalculator::uiPriority(drawsToRoot));
     }
     if (m_thumb) {
         IntSize thumbSize = layerRectToContentRect(m_geometry->thumbRect(m_scrollbar.get())).size();
+        m_thumb->texture()->setUseAtlas(true);
         m_thumb->texture()->setDimensions(thumbSize, m_textureFormat);
         m_thumb->texture()->setRequestPriority(CCPriorityCalculator::uiPriority(drawsToRoot));
     }
@@ -198,6 +198,23 @@ std::string VertexShaderPosTexIdentity::getShaderString() const
     );
 }
 
+std::string VertexShaderPosTexAlpha::getShaderString() const
+{
+    return SHADER(
+        attribute vec4 a_position;
+        attribute vec2 a_texCoord;
+        attribute float a_alpha;
+        varying vec2 v_texCoord;
+        varying float v_alpha;
+        void main()
+        {
+            gl_Position = a_position;
+            v_texCoord = a_texCoord;
+            v_alpha = a_alpha;
+        }
+    );
+}
+
 void VertexShaderQuad::init(WebGraphicsContext3D* context, unsigned program, bool usingBindUniform, int* baseUniformIndex)
 {
     static const char* shaderUniforms[] = {
@@ -460,6 +477,20 @@ std::string FragmentShaderRGBATexOpaque::getShaderString() const
     );
 }
 
+std::string FragmentShaderRGBATexVaryingAlpha::getShaderString() const
+{
+    return SHADER(
+        precision mediump float;
+        varying vec2 v_texCoord;
+        varying float v_alpha;
+        uniform sampler2D s_texture;
+        void main()
+        {
+            gl_FragColor = texture2D(s_texture, v_texCoord) * v_alpha;
+        }
+    );
+}
+
 std::string FragmentShaderRGBATex::getShaderString() const
 {
     return SHADER(
@@ -65,6 +65,13 @@ public:
     std::string getShaderString() const;
 };
 
+// Used for batched quads, whose vertices are already in clip space.
+class VertexShaderPosTexAlpha {
+public:
+    void init(WebKit::WebGraphicsContext3D*, unsigned program, bool usingBindUniform, int* baseUniformIndex) { }
+    std::string getShaderString() const;
+};
+
 class VertexShaderPosTexTransform {
 public:
     VertexShaderPosTexTransform();
@@ -181,6 +188,12 @@ public:
     std::string getShaderString() const;
 };
 
+// Takes the alpha from the vertices rather than from a uniform.
+class FragmentShaderRGBATexVaryingAlpha : public FragmentTexOpaqueBinding {
+public:
+    std::string getShaderString() const;
+};
+
 class FragmentShaderRGBATex : public FragmentTexOpaqueBinding {
 public:
     std::string getShaderString() const;
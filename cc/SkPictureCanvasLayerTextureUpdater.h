@@ -33,6 +33,7 @@ protected:
 
     virtual void prepareToUpdate(const IntRect& contentRect, const IntSize& tileSize, float contentsWidthScale, float contentsHeightScale, IntRect& resultingOpaqueRect, CCRenderingStats&) OVERRIDE;
     void drawPicture(SkCanvas*);
+    const SkPicture& picture() const { return m_picture; }
 
     bool layerIsOpaque() const { return m_layerIsOpaque; }
 
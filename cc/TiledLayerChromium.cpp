@@ -266,6 +266,7 @@ UpdatableTile* TiledLayerChromium::createTile(int i, int j)
 
     OwnPtr<UpdatableTile> tile(UpdatableTile::create(textureUpdater()->createTexture(textureManager())));
     tile->managedTexture()->setDimensions(m_tiler->tileSize(), m_textureFormat);
+    tile->managedTexture()->setUseAtlas(textureUpdater()->canUseAtlas());
 
     UpdatableTile* addedTile = tile.get();
     m_tiler->addTile(tile.release(), i, j);
@@ -543,6 +544,9 @@ void TiledLayerChromium::updateTileTextures(const IntRect& paintRect, int left,
                 queue.appendFullUpload(upload);
         }
     }
+
+    // The uploads are queued, but tiles may still be rasterizing in the background.
+    textureUpdater()->finishPreparingRects(stats);
 }
 
 namespace {
@@ -563,6 +567,7 @@ bool isSmallAnimatedLayer(TiledLayerChromium* layer)
 // for offscreen layers. For now, prioritize all small animated layers after 512
 // pixels of pre-painting.
 void setPriorityForTexture(const IntRect& visibleRect,
+                           const IntRect& predictedVisibleRect,
                            const IntRect& tileRect,
                            bool drawsToRoot,
                            bool isSmallAnimatedLayer,
@@ -570,7 +575,7 @@ void setPriorityForTexture(const IntRect& visibleRect,
 {
     int priority = CCPriorityCalculator::lowestPriority();
     if (!visibleRect.isEmpty())
-        priority = CCPriorityCalculator::priorityFromDistance(visibleRect, tileRect, drawsToRoot);
+        priority = CCPriorityCalculator::priorityFromDistance(visibleRect, predictedVisibleRect, tileRect, drawsToRoot);
     if (isSmallAnimatedLayer)
         priority = CCPriorityCalculator::maxPriority(priority, CCPriorityCalculator::smallAnimatedLayerMinPriority());
     if (priority != CCPriorityCalculator::lowestPriority())
@@ -582,12 +587,14 @@ void TiledLayerChromium::setTexturePriorities(const CCPriorityCalculator& priori
 {
     updateBounds();
     resetUpdateState();
+    updateVisibleContentScrollDelta();
 
     if (m_tiler->hasEmptyBounds())
         return;
 
     bool drawsToRoot = !renderTarget()->parent();
     bool smallAnimatedLayer = isSmallAnimatedLayer(this);
+    IntRect predictedVisibleRect = predictedVisibleContentRect();
 
     // Minimally create the tiles in the desired pre-paint rect.
     IntRect createTilesRect = idlePaintRect();
@@ -633,7 +640,7 @@ void TiledLayerChromium::setTexturePriorities(const CCPriorityCalculator& priori
                 IntRect tileRect = m_tiler->tileRect(tile);
                 tile->dirtyRect = tileRect;
                 LayerTextureUpdater::Texture* backBuffer = tile->texture();
-                setPriorityForTexture(visibleContentRect(), tile->dirtyRect, drawsToRoot, smallAnimatedLayer, backBuffer->texture());
+                setPriorityForTexture(visibleContentRect(), predictedVisibleRect, tile->dirtyRect, drawsToRoot, smallAnimatedLayer, backBuffer->texture());
                 OwnPtr<CCPrioritizedTexture> frontBuffer = CCPrioritizedTexture::create(backBuffer->texture()->textureManager(),
                                                                                         backBuffer->texture()->size(),
                                                                                         backBuffer->texture()->format());
@@ -655,7 +662,7 @@ void TiledLayerChromium::setTexturePriorities(const CCPriorityCalculator& priori
         if (!tile)
             continue;
         IntRect tileRect = m_tiler->tileRect(tile);
-        setPriorityForTexture(visibleContentRect(), tileRect, drawsToRoot, smallAnimatedLayer, tile->managedTexture());
+        setPriorityForTexture(visibleContentRect(), predictedVisibleRect, tileRect, drawsToRoot, smallAnimatedLayer, tile->managedTexture());
     }
 }
 
@@ -801,11 +808,47 @@ IntRect TiledLayerChromium::idlePaintRect()
     IntRect prepaintRect = visibleContentRect();
     prepaintRect.inflateX(m_tiler->tileSize().width());
     prepaintRect.inflateY(m_tiler->tileSize().height() * 2);
+    // Also prepaint where the layer is scrolling to.
+    prepaintRect.unite(predictedVisibleContentRect());
     IntRect contentRect(IntPoint::zero(), contentBounds());
     prepaintRect.intersect(contentRect);
 
     return prepaintRect;
 }
 
+// How many commits ahead the visible content rect is predicted, and how far
+// it may be predicted to move, in multiples of its size.
+static const int scrollPredictionCommits = 4;
+static const int maxScrollPredictionSizes = 2;
+
+void TiledLayerChromium::updateVisibleContentScrollDelta()
+{
+    IntRect visibleRect = visibleContentRect();
+    if (visibleRect.isEmpty() || m_previousVisibleContentRect.isEmpty() || contentBounds() != m_previousContentBounds)
+        m_visibleContentScrollDelta = IntSize();
+    else
+        m_visibleContentScrollDelta = visibleRect.location() - m_previousVisibleContentRect.location();
+
+    m_previousVisibleContentRect = visibleRect;
+    m_previousContentBounds = contentBounds();
+}
+
+IntRect TiledLayerChromium::predictedVisibleContentRect() const
+{
+    IntRect visibleRect = visibleContentRect();
+    if (visibleRect.isEmpty() || m_visibleContentScrollDelta.isZero())
+        return IntRect();
+
+    int maxDeltaX = visibleRect.width() * maxScrollPredictionSizes;
+    int maxDeltaY = visibleRect.height() * maxScrollPredictionSizes;
+    int deltaX = max(-maxDeltaX, min(maxDeltaX, m_visibleContentScrollDelta.width() * scrollPredictionCommits));
+    int deltaY = max(-maxDeltaY, min(maxDeltaY, m_visibleContentScrollDelta.height() * scrollPredictionCommits));
+
+    IntRect predictedRect = visibleRect;
+    predictedRect.move(deltaX, deltaY);
+    predictedRect.intersect(IntRect(IntPoint::zero(), contentBounds()));
+    return predictedRect;
+}
+
 }
 #endif // USE(ACCELERATED_COMPOSITING)
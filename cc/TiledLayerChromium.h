@@ -67,6 +67,11 @@ protected:
     bool needsIdlePaint();
     IntRect idlePaintRect();
 
+    // Where the visible content rect is expected to be in a few commits,
+    // based on how far it moved since the last commit. Empty when the layer
+    // is not scrolling.
+    IntRect predictedVisibleContentRect() const;
+
     bool skipsDraw() const { return m_skipsDraw; }
 
     // Virtual for testing
@@ -91,6 +96,8 @@ private:
     UpdatableTile* tileAt(int, int) const;
     UpdatableTile* createTile(int, int);
 
+    void updateVisibleContentScrollDelta();
+
     GC3Denum m_textureFormat;
     bool m_skipsDraw;
     bool m_failedUpdate;
@@ -98,6 +105,10 @@ private:
 
     TilingOption m_tilingOption;
     OwnPtr<CCLayerTilingData> m_tiler;
+
+    IntRect m_previousVisibleContentRect;
+    IntSize m_previousContentBounds;
+    IntSize m_visibleContentScrollDelta;
 };
 
 }
@@ -581,6 +581,34 @@ TEST_F(TiledLayerChromiumTest, idlePaintNonVisibleLayers)
     }
 }
 
+TEST_F(TiledLayerChromiumTest, idlePaintInScrollDirection)
+{
+    RefPtr<FakeTiledLayerChromium> layer = adoptRef(new FakeTiledLayerChromium(m_textureManager.get()));
+    ScopedFakeCCTiledLayerImpl layerImpl(1);
+
+    // The tile size is 100x100. Without scrolling, one column of tiles is
+    // prepainted on each side of the visible tile.
+    layer->setBounds(IntSize(1000, 100));
+    layer->setVisibleContentRect(IntRect(200, 0, 100, 100));
+    layer->invalidateContentRect(IntRect(0, 0, 1000, 100));
+    updateAndPush(layer.get(), layerImpl.get());
+    EXPECT_RECT_EQ(IntRect(100, 0, 300, 100), layer->idlePaintRect());
+
+    // Scrolling right also prepaints the tiles the layer is scrolling to.
+    layer->setVisibleContentRect(IntRect(300, 0, 100, 100));
+    updateAndPush(layer.get(), layerImpl.get());
+    EXPECT_RECT_EQ(IntRect(200, 0, 400, 100), layer->idlePaintRect());
+
+    // And the same when scrolling back left.
+    layer->setVisibleContentRect(IntRect(200, 0, 100, 100));
+    updateAndPush(layer.get(), layerImpl.get());
+    EXPECT_RECT_EQ(IntRect(0, 0, 400, 100), layer->idlePaintRect());
+
+    // Once the scroll stops, the prepainted area is symmetric again.
+    updateAndPush(layer.get(), layerImpl.get());
+    EXPECT_RECT_EQ(IntRect(100, 0, 300, 100), layer->idlePaintRect());
+}
+
 TEST_F(TiledLayerChromiumTest, invalidateFromPrepare)
 {
     RefPtr<FakeTiledLayerChromium> layer = adoptRef(new FakeTiledLayerChromium(m_textureManager.get()));
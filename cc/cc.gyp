@@ -21,6 +21,7 @@
       'CCAnimationCurve.cpp',
       'CCAnimationCurve.h',
       'CCAnimationEvents.h',
+      'CCCachedDrawProperties.h',
       'CCCheckerboardDrawQuad.cpp',
       'CCCheckerboardDrawQuad.h',
       'CCCompletionEvent.h',
@@ -92,6 +93,8 @@
       'CCQuadCuller.cpp',
       'CCQuadCuller.h',
       'CCQuadSink.h',
+      'CCRasterWorkerPool.cpp',
+      'CCRasterWorkerPool.h',
       'CCRenderPass.cpp',
       'CCRenderPass.h',
       'CCRenderPassDrawQuad.cpp',
@@ -142,6 +145,8 @@
       'CCStreamVideoDrawQuad.h',
       'CCTexture.cpp',
       'CCTexture.h',
+      'CCTextureAtlas.cpp',
+      'CCTextureAtlas.h',
       'CCTextureDrawQuad.cpp',
       'CCTextureDrawQuad.h',
       'CCTextureLayerImpl.cpp',
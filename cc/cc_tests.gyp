@@ -28,6 +28,7 @@
       'CCOcclusionTrackerTest.cpp',
       'CCPrioritizedTextureTest.cpp',
       'CCQuadCullerTest.cpp',
+      'CCRasterWorkerPoolTest.cpp',
       'CCRendererSoftwareTest.cpp',
       'CCRenderPassTest.cpp',
       'CCRenderSurfaceFiltersTest.cpp',
@@ -39,6 +40,7 @@
       'CCScopedTextureTest.cpp',
       'CCScrollbarAnimationControllerLinearFadeTest.cpp',
       'CCSolidColorLayerImplTest.cpp',
+      'CCTextureAtlasTest.cpp',
       'CCTextureUpdateControllerTest.cpp',
       'CCThreadTaskTest.cpp',
       'CCThreadedTest.cpp',
@@ -123,6 +125,35 @@
   'conditions': [
     ['use_libcc_for_compositor==1', {
       'targets': [
+        {
+          'target_name': 'cc_perftests',
+          'type': 'executable',
+          'dependencies': [
+            '../base/base.gyp:base',
+            '../base/base.gyp:test_support_base',
+            '../testing/gtest.gyp:gtest',
+            '../third_party/WebKit/Source/WTF/WTF.gyp/WTF.gyp:wtf',
+            '../skia/skia.gyp:skia',
+            'cc.gyp:cc',
+            'cc_test_support',
+          ],
+          'defines': [
+            'PERF_TEST',
+            'USE_LIBCC_FOR_COMPOSITOR',
+            'WTF_USE_ACCELERATED_COMPOSITING=1',
+          ],
+          'include_dirs': [
+            'stubs',
+            'test',
+            '.',
+            '../third_party/WebKit/Source/Platform/chromium',
+          ],
+          'sources': [
+            '../base/perftimer.cc',
+            'CCLayerTreeHostImplPerfTest.cpp',
+            'test/run_all_perftests.cc',
+          ],
+        },
         {
           'target_name': 'cc_test_support',
           'type': 'static_library',
@@ -45,7 +45,10 @@ public:
         QUERY_RESULT_AVAILABLE_EXT = 0x8867,
 
         // GL_CHROMIUM_command_buffer_query
-        COMMANDS_ISSUED_CHROMIUM = 0x84F2
+        COMMANDS_ISSUED_CHROMIUM = 0x84F2,
+
+        // GL_CHROMIUM_pixel_transfer_buffer_object
+        PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM = 0x78EC
     };
 };
 
@@ -11,7 +11,9 @@
 #include "base/metrics/stats_counters.h"
 #include "base/path_service.h"
 #include "base/process_util.h"
+#include "base/string_number_conversions.h"
 #include "base/stringprintf.h"
+#include "base/tracked_objects.h"
 #include "base/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "chrome/browser/chrome_content_browser_client.h"
@@ -255,6 +257,21 @@ void EnableHeapProfiler(const CommandLine& command_line) {
 #endif
 }
 
+// Makes the task profiler sample tasks if the appropriate command-line switch
+// is present.
+void SetUpTaskProfilerSampling(const CommandLine& command_line) {
+  if (!command_line.HasSwitch(switches::kProfilingSamplingInterval))
+    return;
+  int interval = 0;
+  if (!base::StringToInt(command_line.GetSwitchValueASCII(
+          switches::kProfilingSamplingInterval), &interval) ||
+      interval < 1) {
+    LOG(WARNING) << "Invalid --" << switches::kProfilingSamplingInterval;
+    return;
+  }
+  tracked_objects::ThreadData::SetSamplingInterval(interval);
+}
+
 // Returns true if this subprocess type needs the ResourceBundle initialized
 // and resources loaded.
 bool SubprocessNeedsResourceBundle(const std::string& process_type) {
@@ -560,6 +577,7 @@ void ChromeMainDelegate::PreSandboxStartup() {
   // Enable Message Loop related state asap.
   if (command_line.HasSwitch(switches::kMessageLoopHistogrammer))
     MessageLoop::EnableHistogrammer(true);
+  SetUpTaskProfilerSampling(command_line);
 
   logging::OldFileDeletionState file_state =
       logging::APPEND_TO_OLD_LOG_FILE;
@@ -190,9 +190,19 @@ void AutocompleteController::Start(
   base::TimeTicks start_time = base::TimeTicks::Now();
   for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
        ++i) {
+    const base::TimeTicks provider_start_time = base::TimeTicks::Now();
     (*i)->Start(input_, minimal_changes);
-    if (matches_requested != AutocompleteInput::ALL_MATCHES)
+    if (matches_requested != AutocompleteInput::ALL_MATCHES) {
       DCHECK((*i)->done());
+      continue;
+    }
+    // Break the synchronous pass down by provider, so that the providers
+    // which hold up the first result can be identified.
+    std::string name = std::string("Omnibox.ProviderTime.") + (*i)->GetName();
+    base::Histogram* counter = base::Histogram::FactoryGet(
+        name, 1, 1000, 50, base::Histogram::kUmaTargetedHistogramFlag);
+    counter->Add(static_cast<int>(
+        (base::TimeTicks::Now() - provider_start_time).InMilliseconds()));
   }
   if (matches_requested == AutocompleteInput::ALL_MATCHES &&
       (text.length() < 6)) {
@@ -0,0 +1,84 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/time.h"
+#include "base/utf_string_conversions.h"
+#include "chrome/browser/autocomplete/autocomplete_controller.h"
+#include "chrome/browser/autocomplete/autocomplete_input.h"
+#include "chrome/browser/autocomplete/autocomplete_provider.h"
+#include "chrome/browser/history/history.h"
+#include "chrome/browser/history/history_service_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "content/public/test/test_browser_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using content::BrowserThread;
+
+namespace {
+
+// Number of typed URLs in history, roughly that of a heavily used profile.
+const int kTypedURLCount = 20000;
+
+// Words from which the synthetic URLs and page titles are composed.
+const char* const kWords[] = {
+  "google", "blog", "translate", "news", "mail", "search", "video", "maps",
+  "chromium", "issues", "review", "docs", "calendar", "photos", "weather",
+};
+
+// What the user types, one keystroke at a time.
+const char kTypedString[] = "www.google.com/blog";
+
+}  // namespace
+
+// Measures how long the synchronous pass of the providers takes for each
+// keystroke, which is the time until the first result can be shown.
+TEST(AutocompleteControllerPerfTest, TimeToFirstResult) {
+  MessageLoopForUI message_loop;
+  content::TestBrowserThread ui_thread(BrowserThread::UI, &message_loop);
+  content::TestBrowserThread file_thread(BrowserThread::FILE, &message_loop);
+
+  TestingProfile profile;
+  profile.CreateHistoryService(true, false);
+  HistoryService* history_service =
+      HistoryServiceFactory::GetForProfile(&profile,
+                                           Profile::EXPLICIT_ACCESS);
+  const base::Time visit_time =
+      base::Time::Now() - base::TimeDelta::FromDays(1);
+  const size_t word_count = arraysize(kWords);
+  for (int i = 0; i < kTypedURLCount; ++i) {
+    const GURL url(base::StringPrintf("http://www.%s.com/%s/%d",
+                                      kWords[i % word_count],
+                                      kWords[(i / 7) % word_count], i));
+    history_service->AddPageWithDetails(
+        url, UTF8ToUTF16(kWords[(i / 3) % word_count]), 1 + i % 10, 1,
+        visit_time, false, history::SOURCE_BROWSED);
+  }
+  profile.BlockUntilHistoryProcessesPendingRequests();
+
+  AutocompleteController controller(
+      &profile, NULL,
+      AutocompleteProvider::TYPE_BUILTIN |
+      AutocompleteProvider::TYPE_HISTORY_URL);
+
+  const std::string typed(kTypedString);
+  base::TimeDelta slowest;
+  PerfTimeLogger timer("AutocompleteController_time_to_first_result");
+  for (size_t length = 1; length <= typed.length(); ++length) {
+    PerfTimer keystroke_timer;
+    controller.Start(UTF8ToUTF16(typed.substr(0, length)), string16(), false,
+                     false, true, AutocompleteInput::ALL_MATCHES);
+    slowest = std::max(slowest, keystroke_timer.Elapsed());
+    // Only the synchronous pass is being measured.
+    controller.Stop(false);
+  }
+  timer.Done();
+  LogPerfResult("AutocompleteController_slowest_keystroke",
+                slowest.InMillisecondsF(), "ms");
+}
@@ -118,8 +118,13 @@ void BookmarkIndex::SortMatches(const Matches& matches,
   history::URLDatabase* url_db = history_service ?
       history_service->InMemoryDatabase() : NULL;
 
+  // A node is in more than one match when several words of its title
+  // start with the query, so gather the distinct nodes before looking
+  // up typed counts.
+  NodeSet nodes;
   for (Matches::const_iterator i = matches.begin(); i != matches.end(); ++i)
-    ExtractBookmarkNodePairs(url_db, *i, node_typed_counts);
+    nodes.insert(i->nodes_begin(), i->nodes_end());
+  ExtractBookmarkNodePairs(url_db, nodes, node_typed_counts);
 
   std::sort(node_typed_counts->begin(), node_typed_counts->end(),
             &NodeTypedCountPairSortFunc);
@@ -127,11 +132,10 @@ void BookmarkIndex::SortMatches(const Matches& matches,
 
 void BookmarkIndex::ExtractBookmarkNodePairs(
     history::URLDatabase* url_db,
-    const Match& match,
+    const NodeSet& nodes,
     NodeTypedCountPairs* node_typed_counts) const {
-
-  for (NodeSet::const_iterator i = match.nodes_begin();
-       i != match.nodes_end(); ++i) {
+  node_typed_counts->reserve(node_typed_counts->size() + nodes.size());
+  for (NodeSet::const_iterator i = nodes.begin(); i != nodes.end(); ++i) {
     history::URLRow url;
     if (url_db)
       url_db->GetRowForURL((*i)->url(), &url);
@@ -253,11 +257,7 @@ std::vector<string16> BookmarkIndex::ExtractQueryWords(const string16& query) {
 
 void BookmarkIndex::RegisterNode(const string16& term,
                                  const BookmarkNode* node) {
-  if (std::find(index_[term].begin(), index_[term].end(), node) !=
-      index_[term].end()) {
-    // We've already added node for term.
-    return;
-  }
+  // Inserting is a no-op if node was already added for term.
   index_[term].insert(node);
 }
 
@@ -133,6 +133,9 @@ TEST_F(BookmarkIndexTest, Tests) {
     // Title with term multiple times.
     { "ab ab",                      "ab",       "ab ab"},
 
+    // Title with several words matching the same prefix is returned once.
+    { "abc abcd abcde;bcd",         "abc",      "abc abcd abcde"},
+
     // Make sure quotes don't do a prefix match.
     { "think",                      "\"thi\"",  ""},
   };
@@ -26,6 +26,7 @@
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/chrome_version_info.h"
 #include "chrome/common/metrics/variations/variations_util.h"
+#include "content/public/common/content_constants.h"
 #include "net/http/http_stream_factory.h"
 #include "net/socket/client_socket_pool_base.h"
 #include "net/socket/client_socket_pool_manager.h"
@@ -130,6 +131,7 @@ void ChromeBrowserFieldTrials::SetupFieldTrials(bool proxy_policy_is_set) {
   DisableNewTabFieldTrialIfNecesssary();
   SetUpSafeBrowsingInterstitialFieldTrial();
   SetUpInfiniteCacheFieldTrial();
+  SetUpResourceSchedulerFieldTrial();
 #if defined(ENABLE_ONE_CLICK_SIGNIN)
   OneClickSigninHelper::InitializeFieldTrial();
 #endif
@@ -565,3 +567,14 @@ void ChromeBrowserFieldTrials::SetUpInfiniteCacheFieldTrial() {
   trial->AppendGroup("Yes", infinite_cache_probability);
   trial->AppendGroup("Control", infinite_cache_probability);
 }
+
+void ChromeBrowserFieldTrials::SetUpResourceSchedulerFieldTrial() {
+  const base::FieldTrial::Probability kDivisor = 100;
+  const base::FieldTrial::Probability kControlProbability = 10;  // 10% prob.
+  scoped_refptr<base::FieldTrial> trial(
+      base::FieldTrialList::FactoryGetFieldTrial(
+          content::kResourceSchedulerFieldTrialName, kDivisor, "enabled",
+          2013, 6, 30, NULL));
+  trial->AppendGroup(content::kResourceSchedulerFieldTrialControlName,
+                     kControlProbability);
+}
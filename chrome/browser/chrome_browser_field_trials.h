@@ -68,6 +68,10 @@ class ChromeBrowserFieldTrials {
   // Sets up the InfiniteCache field trial.
   void SetUpInfiniteCacheFieldTrial();
 
+  // Sets up the field trial that measures how the resource scheduler changes
+  // page load times.
+  void SetUpResourceSchedulerFieldTrial();
+
   const CommandLine& parsed_command_line_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeBrowserFieldTrials);
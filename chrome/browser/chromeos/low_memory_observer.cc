@@ -15,6 +15,7 @@
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/chromeos/oom_priority_manager.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_widget_host.h"
 #include "content/public/browser/zygote_host_linux.h"
 
 using content::BrowserThread;
@@ -93,6 +94,9 @@ class LowMemoryObserverImpl
     // the UI thread.
     static void DiscardTab() {
       CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+      // Backing stores of background tabs are the cheapest memory to give
+      // back, as they are kept compressed and repainted on demand.
+      content::RenderWidgetHost::ReduceBackingStoreMemory();
       if (g_browser_process && g_browser_process->oom_priority_manager())
         g_browser_process->oom_priority_manager()->LogMemoryAndDiscardTab();
     }
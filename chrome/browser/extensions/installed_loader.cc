@@ -4,9 +4,13 @@
 
 #include "chrome/browser/extensions/installed_loader.h"
 
+#include "base/atomic_ref_count.h"
+#include "base/bind.h"
 #include "base/file_path.h"
 #include "base/metrics/histogram.h"
 #include "base/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
@@ -55,6 +59,29 @@ ManifestReloadReason ShouldReloadExtensionManifest(const ExtensionInfo& info) {
   return NOT_NEEDED;
 }
 
+// The inputs and outputs of reloading one extension's manifest from disk.
+struct ManifestReload {
+  FilePath extension_path;
+  Extension::Location extension_location;
+  int creation_flags;
+  scoped_refptr<const Extension> extension;
+  std::string error;
+};
+
+// Reloads |reload| from disk. Signals |done| once |pending| drops to zero, if
+// given.
+void ReloadManifest(ManifestReload* reload,
+                    base::AtomicRefCount* pending,
+                    base::WaitableEvent* done) {
+  reload->extension = extension_file_util::LoadExtension(
+      reload->extension_path,
+      reload->extension_location,
+      reload->creation_flags,
+      &reload->error);
+  if (pending && !base::AtomicRefCountDec(pending))
+    done->Signal();
+}
+
 }  // namespace
 
 namespace extensions {
@@ -126,6 +153,7 @@ void InstalledLoader::LoadAllExtensions() {
 
   std::vector<int> reload_reason_counts(NUM_MANIFEST_RELOAD_REASONS, 0);
   bool should_write_prefs = false;
+  std::vector<ExtensionInfo*> reload_infos;
 
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     ExtensionInfo* info = extensions_info->at(i).get();
@@ -135,36 +163,13 @@ void InstalledLoader::LoadAllExtensions() {
     UMA_HISTOGRAM_ENUMERATION("Extensions.ManifestReloadEnumValue",
                               reload_reason, 100);
 
-    if (reload_reason != NOT_NEEDED) {
-      // Reloading an extension reads files from disk.  We do this on the
-      // UI thread because reloads should be very rare, and the complexity
-      // added by delaying the time when the extensions service knows about
-      // all extensions is significant.  See crbug.com/37548 for details.
-      // |allow_io| disables tests that file operations run on the file
-      // thread.
-      base::ThreadRestrictions::ScopedAllowIO allow_io;
-
-      std::string error;
-      scoped_refptr<const Extension> extension(
-          extension_file_util::LoadExtension(
-              info->extension_path,
-              info->extension_location,
-              GetCreationFlags(info),
-              &error));
-
-      if (!extension.get()) {
-        extension_service_->
-            ReportExtensionLoadError(info->extension_path, error, false);
-        continue;
-      }
-
-      extensions_info->at(i)->extension_manifest.reset(
-          static_cast<DictionaryValue*>(
-              extension->manifest()->value()->DeepCopy()));
-      should_write_prefs = true;
-    }
+    if (reload_reason != NOT_NEEDED)
+      reload_infos.push_back(info);
   }
 
+  if (!reload_infos.empty())
+    should_write_prefs = ReloadManifests(reload_infos);
+
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     Load(*extensions_info->at(i), should_write_prefs);
   }
@@ -301,6 +306,59 @@ void InstalledLoader::LoadAllExtensions() {
                            disabled_for_permissions_count);
 }
 
+bool InstalledLoader::ReloadManifests(
+    const std::vector<ExtensionInfo*>& infos) {
+  base::TimeTicks start_time = base::TimeTicks::Now();
+
+  std::vector<ManifestReload> reloads(infos.size());
+  for (size_t i = 0; i < infos.size(); ++i) {
+    reloads[i].extension_path = infos[i]->extension_path;
+    reloads[i].extension_location = infos[i]->extension_location;
+    reloads[i].creation_flags = GetCreationFlags(infos[i]);
+  }
+
+  // Reloading an extension reads files from disk.  This blocks the UI thread
+  // because reloads should be very rare, and the complexity added by delaying
+  // the time when the extensions service knows about all extensions is
+  // significant.  See crbug.com/37548 for details.  When the locale changes
+  // every extension is reloaded though, so those reloads are spread over the
+  // blocking pool.
+  // |allow_io| disables tests that file operations run on the file thread.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (reloads.size() == 1) {
+    ReloadManifest(&reloads[0], NULL, NULL);
+  } else {
+    base::AtomicRefCount pending = static_cast<int>(reloads.size());
+    base::WaitableEvent done(false, false);
+    base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+    for (size_t i = 0; i < reloads.size(); ++i) {
+      if (!pool->PostWorkerTask(FROM_HERE,
+                                base::Bind(&ReloadManifest, &reloads[i],
+                                           &pending, &done))) {
+        ReloadManifest(&reloads[i], &pending, &done);
+      }
+    }
+    base::ThreadRestrictions::ScopedAllowWait allow_wait;
+    done.Wait();
+  }
+
+  bool reloaded = false;
+  for (size_t i = 0; i < reloads.size(); ++i) {
+    if (!reloads[i].extension.get()) {
+      extension_service_->ReportExtensionLoadError(
+          reloads[i].extension_path, reloads[i].error, false);
+      continue;
+    }
+    infos[i]->extension_manifest.reset(static_cast<DictionaryValue*>(
+        reloads[i].extension->manifest()->value()->DeepCopy()));
+    reloaded = true;
+  }
+
+  UMA_HISTOGRAM_TIMES("Extensions.ManifestReloadTime",
+                      base::TimeTicks::Now() - start_time);
+  return reloaded;
+}
+
 int InstalledLoader::GetCreationFlags(const ExtensionInfo* info) {
   int flags = Extension::NO_FLAGS;
   if (info->extension_location != Extension::LOAD)
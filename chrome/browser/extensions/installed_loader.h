@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_EXTENSIONS_INSTALLED_LOADER_H_
 #define CHROME_BROWSER_EXTENSIONS_INSTALLED_LOADER_H_
 
+#include <vector>
+
 class ExtensionService;
 
 namespace extensions {
@@ -29,6 +31,12 @@ class InstalledLoader {
   // extension that is already installed.
   int GetCreationFlags(const ExtensionInfo* info);
 
+  // Reloads the manifests of |infos| from disk, replacing the ones read from
+  // the prefs and reporting any load errors. Returns true if any manifest was
+  // reloaded. Several reloads (e.g. after the locale changed) run in parallel
+  // on the blocking pool rather than one after another.
+  bool ReloadManifests(const std::vector<ExtensionInfo*>& infos);
+
   ExtensionService* extension_service_;
 
   ExtensionPrefs* extension_prefs_;
@@ -24,10 +24,12 @@
 
 #include "chrome/browser/history/history.h"
 
+#include "base/bind.h"
 #include "base/callback.h"
 #include "base/command_line.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/path_service.h"
 #include "base/string_util.h"
 #include "base/threading/thread.h"
@@ -68,6 +70,17 @@ namespace {
 
 static const char* kHistoryThreadName = "Chrome_HistoryThread";
 
+// Runs |task| on the history thread, recording how long it waited behind the
+// tasks queued before it.
+void RunHistoryTask(base::subtle::Atomic32* pending_task_count,
+                    base::TimeTicks queued_time,
+                    const base::Closure& task) {
+  base::subtle::NoBarrier_AtomicIncrement(pending_task_count, -1);
+  UMA_HISTOGRAM_TIMES("History.TaskQueueTime",
+                      base::TimeTicks::Now() - queued_time);
+  task.Run();
+}
+
 }  // namespace
 
 // Sends messages from the backend to us on the main thread. This must be a
@@ -148,6 +161,7 @@ class HistoryService::BackendDelegate : public HistoryBackend::Delegate {
 // history thread.
 HistoryService::HistoryService()
     : thread_(new base::Thread(kHistoryThreadName)),
+      pending_task_count_(0),
       profile_(NULL),
       backend_loaded_(false),
       current_backend_id_(-1),
@@ -160,6 +174,7 @@ HistoryService::HistoryService()
 
 HistoryService::HistoryService(Profile* profile)
     : thread_(new base::Thread(kHistoryThreadName)),
+      pending_task_count_(0),
       profile_(profile),
       backend_loaded_(false),
       current_backend_id_(-1),
@@ -785,7 +800,15 @@ void HistoryService::ScheduleAutocomplete(HistoryURLProvider* provider,
 void HistoryService::ScheduleTask(SchedulePriority priority,
                                   const base::Closure& task) {
   // TODO(brettw): Do prioritization.
-  thread_->message_loop()->PostTask(FROM_HERE, task);
+  // |pending_task_count_| outlives the tasks because Cleanup() joins the
+  // thread before |this| goes away.
+  int queue_depth =
+      base::subtle::NoBarrier_AtomicIncrement(&pending_task_count_, 1);
+  UMA_HISTOGRAM_COUNTS_10000("History.TaskQueueDepth", queue_depth);
+  thread_->message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&RunHistoryTask, &pending_task_count_,
+                 base::TimeTicks::Now(), task));
 }
 
 // static
@@ -8,6 +8,7 @@
 #include <set>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/file_path.h"
@@ -1033,6 +1034,10 @@ class HistoryService : public CancelableRequestProvider,
   // |thread_| is NULL once |Cleanup| is NULL.
   base::Thread* thread_;
 
+  // Number of tasks posted to |thread_| that have not started running yet.
+  // Incremented on the main thread and decremented on |thread_|.
+  base::subtle::Atomic32 pending_task_count_;
+
   // This class has most of the implementation and runs on the 'thread_'.
   // You MUST communicate with this class ONLY through the thread_'s
   // message_loop().
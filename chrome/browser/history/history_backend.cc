@@ -416,6 +416,8 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
   if (!db_.get())
     return;
 
+  TimeTicks beginning_time = TimeTicks::Now();
+
   // Will be filled with the URL ID and the visit ID of the last addition.
   std::pair<URLID, VisitID> last_ids(0, tracker_.GetLastVisit(
       request.id_scope, request.page_id, request.referrer));
@@ -598,6 +600,8 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
   }
 
   ScheduleCommit();
+
+  UMA_HISTOGRAM_TIMES("History.AddPageTime", TimeTicks::Now() - beginning_time);
 }
 
 void HistoryBackend::InitImpl(const std::string& languages) {
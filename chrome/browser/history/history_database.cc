@@ -70,6 +70,7 @@ HistoryDatabase::~HistoryDatabase() {
 sql::InitStatus HistoryDatabase::Init(const FilePath& history_name) {
   // Set the exceptional sqlite error handler.
   db_.set_error_delegate(GetErrorHandlerForHistoryDb());
+  db_.set_histogram_tag("History");
 
   // Set the database page size to something a little larger to give us
   // better performance (we're typically seek rather than bandwidth limited).
@@ -83,6 +84,10 @@ sql::InitStatus HistoryDatabase::Init(const FilePath& history_name) {
   // TODO(brettw) scale this value to the amount of available memory.
   db_.set_cache_size(6000);
 
+  // History is read far more than it is written, so let sqlite map the file
+  // where it can rather than copying pages through read().
+  db_.set_mmap_size(256 * 1024 * 1024);
+
   // Note that we don't set exclusive locking here. That's done by
   // BeginExclusiveMode below which is called later (we have to be in shared
   // mode to start out for the in-memory backend to read the data).
@@ -25,11 +25,18 @@ using in_memory_url_index::InMemoryURLIndexCacheItem;
 
 namespace history {
 
-// Called by DoSaveToCacheFile to delete any old cache file at |path| when
-// there is no private data to save. Runs on the FILE thread.
-void DeleteCacheFile(const FilePath& path) {
-  DCHECK(!content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+// The number of changes which may be appended to the cache journal before the
+// journal is compacted by rewriting the whole cache file.
+const int kMaxJournalEntries = 1000;
+
+// Deletes any old cache file at |path| together with its journal at
+// |journal_path| when there is no private data to save or the cache could not
+// be restored. Runs on the FILE thread so that it is ordered with respect to
+// journal appends.
+void DeleteCacheAndJournalFiles(const FilePath& path,
+                                const FilePath& journal_path) {
   file_util::Delete(path, false);
+  file_util::Delete(journal_path, false);
 }
 
 // Initializes a whitelist of URL schemes.
@@ -102,7 +109,9 @@ InMemoryURLIndex::InMemoryURLIndex(Profile* profile,
       save_cache_observer_(NULL),
       shutdown_(false),
       restored_(false),
-      needs_to_be_cached_(false) {
+      needs_to_be_cached_(false),
+      journaling_(false),
+      journal_entry_count_(0) {
   InitializeSchemeWhitelist(&scheme_whitelist_);
   if (profile) {
     // TODO(mrossetti): Register for language change notifications.
@@ -122,7 +131,9 @@ InMemoryURLIndex::InMemoryURLIndex()
       save_cache_observer_(NULL),
       shutdown_(false),
       restored_(false),
-      needs_to_be_cached_(false) {
+      needs_to_be_cached_(false),
+      journaling_(false),
+      journal_entry_count_(0) {
   InitializeSchemeWhitelist(&scheme_whitelist_);
 }
 
@@ -141,11 +152,17 @@ void InMemoryURLIndex::ShutDown() {
   cache_reader_consumer_.CancelAllRequests();
   shutdown_ = true;
   FilePath path;
-  if (!GetCacheFilePath(&path))
+  FilePath journal_path;
+  if (!GetCacheFilePath(&path) || !GetJournalFilePath(&journal_path))
     return;
-  scoped_refptr<RefCountedBool> succeeded(new RefCountedBool(false));
-  URLIndexPrivateData::WritePrivateDataToCacheFileTask(
-      private_data_, path, succeeded);
+  // When the cache file is current but for the changes recorded in its
+  // journal there is nothing more to write; the journal will be replayed on
+  // the next restore. Otherwise compact the journal into a new cache file.
+  if (!journaling_ || journal_entry_count_ >= kMaxJournalEntries) {
+    scoped_refptr<RefCountedBool> succeeded(new RefCountedBool(false));
+    URLIndexPrivateData::WritePrivateDataToCacheFileTask(
+        private_data_, path, journal_path, succeeded);
+  }
   needs_to_be_cached_ = false;
 }
 
@@ -160,6 +177,14 @@ bool InMemoryURLIndex::GetCacheFilePath(FilePath* file_path) {
   return true;
 }
 
+bool InMemoryURLIndex::GetJournalFilePath(FilePath* file_path) {
+  if (history_dir_.empty())
+    return false;
+  *file_path = history_dir_.Append(
+      FILE_PATH_LITERAL("History Provider Cache Journal"));
+  return true;
+}
+
 // Querying --------------------------------------------------------------------
 
 ScoredHistoryMatches InMemoryURLIndex::HistoryItemsForTerms(
@@ -198,35 +223,64 @@ void InMemoryURLIndex::Observe(int notification_type,
 }
 
 void InMemoryURLIndex::OnURLVisited(const URLVisitedDetails* details) {
-  needs_to_be_cached_ |=
-      private_data_->UpdateURL(details->row, languages_, scheme_whitelist_);
+  if (private_data_->UpdateURL(details->row, languages_, scheme_whitelist_)) {
+    needs_to_be_cached_ = true;
+    AppendToJournal(URLIndexPrivateData::JournalUpdatedRow(details->row));
+  }
 }
 
 void InMemoryURLIndex::OnURLsModified(const URLsModifiedDetails* details) {
   for (URLRows::const_iterator row = details->changed_urls.begin();
-       row != details->changed_urls.end(); ++row)
-    needs_to_be_cached_ |=
-        private_data_->UpdateURL(*row, languages_, scheme_whitelist_);
+       row != details->changed_urls.end(); ++row) {
+    if (private_data_->UpdateURL(*row, languages_, scheme_whitelist_)) {
+      needs_to_be_cached_ = true;
+      AppendToJournal(URLIndexPrivateData::JournalUpdatedRow(*row));
+    }
+  }
 }
 
 void InMemoryURLIndex::OnURLsDeleted(const URLsDeletedDetails* details) {
   if (details->all_history) {
     ClearPrivateData();
     needs_to_be_cached_ = true;
+    // Saving the now empty index deletes the cache file and its journal.
+    PostSaveToCacheFileTask();
   } else {
     for (URLRows::const_iterator row = details->rows.begin();
-         row != details->rows.end(); ++row)
-      needs_to_be_cached_ |= private_data_->DeleteURL(row->url());
+         row != details->rows.end(); ++row) {
+      if (private_data_->DeleteURL(row->url())) {
+        needs_to_be_cached_ = true;
+        AppendToJournal(URLIndexPrivateData::JournalDeletedURL(row->url()));
+      }
+    }
   }
 }
 
+void InMemoryURLIndex::AppendToJournal(const std::string& record) {
+  if (!journaling_ || shutdown_)
+    return;
+  FilePath journal_path;
+  if (!GetJournalFilePath(&journal_path))
+    return;
+  content::BrowserThread::PostTask(
+      content::BrowserThread::FILE, FROM_HERE,
+      base::Bind(&URLIndexPrivateData::AppendToJournalFileTask, journal_path,
+                 record));
+  // Replaying a long journal would make restoring slower than reading a
+  // freshly written cache file, so periodically fold it into the cache.
+  if (++journal_entry_count_ >= kMaxJournalEntries)
+    PostSaveToCacheFileTask();
+}
+
 // Restoring from Cache --------------------------------------------------------
 
 void InMemoryURLIndex::PostRestoreFromCacheFileTask() {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
 
   FilePath path;
-  if (!GetCacheFilePath(&path) || shutdown_) {
+  FilePath journal_path;
+  if (!GetCacheFilePath(&path) || !GetJournalFilePath(&journal_path) ||
+      shutdown_) {
     restored_ = true;
     if (restore_cache_observer_)
       restore_cache_observer_->OnCacheRestoreFinished(false);
@@ -238,7 +292,7 @@ void InMemoryURLIndex::PostRestoreFromCacheFileTask() {
   content::BrowserThread::PostTaskAndReply(
       content::BrowserThread::FILE, FROM_HERE,
       base::Bind(&URLIndexPrivateData::RestoreFromFileTask, path,
-          restored_private_data, languages_),
+          journal_path, restored_private_data, languages_, scheme_whitelist_),
       base::Bind(&InMemoryURLIndex::OnCacheLoadDone, AsWeakPtr(),
           restored_private_data));
 }
@@ -248,6 +302,9 @@ void InMemoryURLIndex::OnCacheLoadDone(
   if (private_data.get() && !private_data->Empty()) {
     private_data_ = private_data;
     restored_ = true;
+    // Further changes are journaled on top of the restored cache file.
+    journaling_ = true;
+    journal_entry_count_ = 0;
     if (restore_cache_observer_)
       restore_cache_observer_->OnCacheRestoreFinished(true);
   } else if (profile_) {
@@ -255,10 +312,13 @@ void InMemoryURLIndex::OnCacheLoadDone(
     // it exists, and then rebuild from the history database if it's available,
     // otherwise wait until the history database loaded and then rebuild.
     FilePath path;
-    if (!GetCacheFilePath(&path) || shutdown_)
+    FilePath journal_path;
+    if (!GetCacheFilePath(&path) || !GetJournalFilePath(&journal_path) ||
+        shutdown_)
       return;
-    content::BrowserThread::PostBlockingPoolTask(
-        FROM_HERE, base::Bind(DeleteCacheFile, path));
+    content::BrowserThread::PostTask(
+        content::BrowserThread::FILE, FROM_HERE,
+        base::Bind(DeleteCacheAndJournalFiles, path, journal_path));
     HistoryService* service =
         HistoryServiceFactory::GetForProfileWithoutCreating(profile_);
     if (service && service->backend_loaded()) {
@@ -309,7 +369,8 @@ void InMemoryURLIndex::RebuildFromHistory(HistoryDatabase* history_db) {
 
 void InMemoryURLIndex::PostSaveToCacheFileTask() {
   FilePath path;
-  if (!GetCacheFilePath(&path))
+  FilePath journal_path;
+  if (!GetCacheFilePath(&path) || !GetJournalFilePath(&journal_path))
     return;
   // If there is anything in our private data then make a copy of it and tell
   // it to save itself to a file.
@@ -322,14 +383,21 @@ void InMemoryURLIndex::PostSaveToCacheFileTask() {
     content::BrowserThread::PostTaskAndReply(
         content::BrowserThread::FILE, FROM_HERE,
         base::Bind(&URLIndexPrivateData::WritePrivateDataToCacheFileTask,
-                   private_data_copy, path, succeeded),
+                   private_data_copy, path, journal_path, succeeded),
         base::Bind(&InMemoryURLIndex::OnCacheSaveDone, AsWeakPtr(), succeeded));
+    // The journal is deleted once the new cache file has been written. Since
+    // both happen in order on the FILE thread, changes made from here on are
+    // journaled on top of the new cache file.
+    journaling_ = true;
   } else {
-    // If there is no data in our index then delete any existing cache file.
-    content::BrowserThread::PostBlockingPoolTask(
-        FROM_HERE,
-        base::Bind(DeleteCacheFile, path));
+    // If there is no data in our index then delete any existing cache file
+    // and journal. There is nothing left to journal against.
+    content::BrowserThread::PostTask(
+        content::BrowserThread::FILE, FROM_HERE,
+        base::Bind(DeleteCacheAndJournalFiles, path, journal_path));
+    journaling_ = false;
   }
+  journal_entry_count_ = 0;
 }
 
 void InMemoryURLIndex::OnCacheSaveDone(
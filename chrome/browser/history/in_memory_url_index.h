@@ -140,6 +140,7 @@ class InMemoryURLIndex : public content::NotificationObserver,
   friend class InMemoryURLIndexTest;
   friend class InMemoryURLIndexCacheTest;
   FRIEND_TEST_ALL_PREFIXES(LimitedInMemoryURLIndexTest, Initialization);
+  FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, CacheJournalReplay);
 
   // Creating one of me without a history path is not allowed (tests excepted).
   InMemoryURLIndex();
@@ -178,6 +179,11 @@ class InMemoryURLIndex : public content::NotificationObserver,
   // provided as a hook for unit testing.)
   bool GetCacheFilePath(FilePath* file_path);
 
+  // Constructs a file path for the journal of changes made since the cache
+  // file was last written and saves that path to |file_path|. Returns true if
+  // |file_path| can be successfully constructed.
+  bool GetJournalFilePath(FilePath* file_path);
+
   // Restores the index's private data from the cache file stored in the
   // profile directory.
   void PostRestoreFromCacheFileTask();
@@ -234,6 +240,11 @@ class InMemoryURLIndex : public content::NotificationObserver,
   void OnURLsModified(const URLsModifiedDetails* details);
   void OnURLsDeleted(const URLsDeletedDetails* details);
 
+  // Posts a task appending the journal |record| to the journal file if the
+  // cache file is being journaled. Compacts the journal into a new cache file
+  // once it has grown too long.
+  void AppendToJournal(const std::string& record);
+
   // Sets the directory wherein the cache file will be maintained.
   // For unit test usage only.
   void set_history_dir(const FilePath& dir_path) { history_dir_ = dir_path; }
@@ -282,6 +293,15 @@ class InMemoryURLIndex : public content::NotificationObserver,
   // http://crbug.com/83659
   bool needs_to_be_cached_;
 
+  // Set to true once a cache file has been restored or scheduled to be written
+  // so that further changes can be appended to its journal instead of
+  // rewriting the whole cache file.
+  bool journaling_;
+
+  // The number of changes appended to the journal since the cache file was
+  // last written.
+  int journal_entry_count_;
+
   DISALLOW_COPY_AND_ASSIGN(InMemoryURLIndex);
 };
 
@@ -0,0 +1,79 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <set>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/time.h"
+#include "base/utf_string_conversions.h"
+#include "chrome/browser/history/url_index_private_data.h"
+#include "chrome/common/url_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace history {
+
+namespace {
+
+// Number of history items indexed, roughly that of a heavily used profile.
+const int kHistoryItemCount = 100000;
+
+// Words from which the synthetic URLs and page titles are composed. Sharing
+// a small vocabulary gives the long posting lists seen in real profiles.
+const char* const kWords[] = {
+  "google", "blog", "translate", "news", "mail", "search", "video", "maps",
+  "chromium", "issues", "review", "docs", "calendar", "photos", "weather",
+  "sports", "finance", "shopping", "travel", "recipes", "music", "books",
+};
+
+// What the user types, one keystroke at a time.
+const char kTypedString[] = "google blog trans";
+
+URLRow MakeRow(int i) {
+  const size_t word_count = arraysize(kWords);
+  GURL url(base::StringPrintf("http://www.site%d.com/%s/%s?id=%d",
+                              i % 5000, kWords[i % word_count],
+                              kWords[(i / 7) % word_count], i));
+  URLRow row(url, i + 1);
+  row.set_title(UTF8ToUTF16(base::StringPrintf(
+      "%s %s page %d", kWords[(i / 3) % word_count],
+      kWords[(i / 11) % word_count], i)));
+  row.set_typed_count(1);
+  row.set_visit_count(1 + i % 10);
+  row.set_last_visit(base::Time::Now() - base::TimeDelta::FromHours(i % 500));
+  return row;
+}
+
+}  // namespace
+
+// Measures how long the index takes to produce matches for each keystroke as
+// a query is typed into the omnibox.
+TEST(InMemoryURLIndexPerfTest, PerKeystrokeLatency) {
+  scoped_refptr<URLIndexPrivateData> private_data(new URLIndexPrivateData);
+  std::set<std::string> scheme_whitelist;
+  scheme_whitelist.insert(chrome::kHttpScheme);
+  {
+    PerfTimeLogger timer("InMemoryURLIndex_build");
+    for (int i = 0; i < kHistoryItemCount; ++i)
+      private_data->UpdateURL(MakeRow(i), "en", scheme_whitelist);
+  }
+
+  const std::string typed(kTypedString);
+  base::TimeDelta slowest;
+  PerfTimeLogger timer("InMemoryURLIndex_type_query");
+  for (size_t length = 1; length <= typed.length(); ++length) {
+    PerfTimer keystroke_timer;
+    private_data->HistoryItemsForTerms(UTF8ToUTF16(typed.substr(0, length)),
+                                       NULL);
+    slowest = std::max(slowest, keystroke_timer.Elapsed());
+  }
+  timer.Done();
+  LogPerfResult("InMemoryURLIndex_slowest_keystroke",
+                slowest.InMillisecondsF(), "ms");
+}
+
+}  // namespace history
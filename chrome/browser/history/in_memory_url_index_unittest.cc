@@ -906,6 +906,69 @@ TEST_F(InMemoryURLIndexTest, CacheSaveRestore) {
   ExpectPrivateDataEqual(*old_data, new_data);
 }
 
+TEST_F(InMemoryURLIndexTest, CacheJournalReplay) {
+  ScopedTempDir temp_directory;
+  ASSERT_TRUE(temp_directory.CreateUniqueTempDir());
+  set_history_dir(temp_directory.path());
+
+  // Write the cache file which subsequent changes will be journaled against.
+  CacheFileSaverObserver save_observer(&message_loop_);
+  url_index_->set_save_cache_observer(&save_observer);
+  PostSaveToCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(save_observer.succeeded_);
+  FilePath journal_path;
+  ASSERT_TRUE(url_index_->GetJournalFilePath(&journal_path));
+  EXPECT_FALSE(file_util::PathExists(journal_path));
+
+  // Delete one row and add another via history notifications.
+  ScoredHistoryMatches matches =
+      url_index_->HistoryItemsForTerms(ASCIIToUTF16("DrudgeReport"));
+  ASSERT_EQ(1U, matches.size());
+  URLsDeletedDetails deleted_details;
+  deleted_details.all_history = false;
+  deleted_details.rows.push_back(matches[0].url_info);
+  Observe(chrome::NOTIFICATION_HISTORY_URLS_DELETED,
+          content::Source<InMemoryURLIndexTest>(this),
+          content::Details<history::HistoryDetails>(&deleted_details));
+  URLVisitedDetails visited_details;
+  visited_details.row = URLRow(GURL("http://www.brokeandaloneinmanitoba.com/"),
+                               5000);
+  visited_details.row.set_last_visit(base::Time::Now());
+  visited_details.row.set_typed_count(1);
+  Observe(chrome::NOTIFICATION_HISTORY_URL_VISITED,
+          content::Source<InMemoryURLIndexTest>(this),
+          content::Details<history::HistoryDetails>(&visited_details));
+  message_loop_.RunAllPending();
+  EXPECT_TRUE(file_util::PathExists(journal_path));
+  EXPECT_EQ(2, url_index_->journal_entry_count_);
+
+  // Capture the current private data for later comparison to restored data.
+  scoped_refptr<URLIndexPrivateData> old_data(GetPrivateData()->Duplicate());
+
+  // Restoring must replay the journal on top of the unchanged cache file.
+  ClearPrivateData();
+  HistoryIndexRestoreObserver restore_observer(
+      base::Bind(&MessageLoop::Quit, base::Unretained(&message_loop_)));
+  url_index_->set_restore_cache_observer(&restore_observer);
+  PostRestoreFromCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(restore_observer.succeeded());
+  ExpectPrivateDataEqual(*old_data, *GetPrivateData());
+  EXPECT_TRUE(url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("DrudgeReport")).empty());
+  EXPECT_EQ(1U, url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("brokeandalone")).size());
+
+  // Compacting writes a new cache file and discards the journal.
+  PostSaveToCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(save_observer.succeeded_);
+  EXPECT_FALSE(file_util::PathExists(journal_path));
+  EXPECT_EQ(0, url_index_->journal_entry_count_);
+  url_index_->ShutDown();
+}
+
 class InMemoryURLIndexCacheTest : public testing::Test {
  public:
   InMemoryURLIndexCacheTest() {}
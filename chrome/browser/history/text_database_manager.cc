@@ -35,6 +35,11 @@ std::string ConvertStringForIndexer(const string16& input) {
 // haven't gotten a title and/or body.
 const int kExpirationSeconds = 20;
 
+// Databases which have had pages added are optimized once nothing has been
+// indexed for this long, so that merging the full text index segments does
+// not compete with the user's browsing.
+const int kOptimizeIdleSeconds = 5 * 60;
+
 }  // namespace
 
 // TextDatabaseManager::ChangeSet ----------------------------------------------
@@ -315,8 +320,10 @@ bool TextDatabaseManager::AddPageData(const GURL& url,
                                  ConvertStringForIndexer(title),
                                  ConvertStringForIndexer(body));
 
-  UMA_HISTOGRAM_TIMES("History.AddFTSData",
-                      TimeTicks::Now() - beginning_time);
+  last_index_time_ = TimeTicks::Now();
+  UMA_HISTOGRAM_TIMES("History.AddFTSData", last_index_time_ - beginning_time);
+  if (success)
+    unoptimized_databases_.Add(TimeToID(visit_time));
 
   if (history_publisher_)
     history_publisher_->PublishPageContent(visit_time, url, title, body);
@@ -379,6 +386,7 @@ void TextDatabaseManager::DeleteAll() {
 
   // Delete uncommitted entries.
   recent_changes_.Clear();
+  unoptimized_databases_.changed_databases_.clear();
 
   // Close all open databases.
   db_cache_.Clear();
@@ -415,6 +423,7 @@ void TextDatabaseManager::GetTextMatches(
     const QueryOptions& options,
     std::vector<TextDatabase::Match>* results,
     Time* first_time_searched) {
+  TimeTicks beginning_time = TimeTicks::Now();
   results->clear();
 
   InitDBList();
@@ -444,6 +453,7 @@ void TextDatabaseManager::GetTextMatches(
 
   // Iterate over the databases from the most recent backwards.
   bool checked_one = false;
+  int databases_searched = 0;
   TextDatabase::URLSet found_urls;
   for (DBIdentSet::reverse_iterator i = present_databases_.rbegin();
        i != present_databases_.rend();
@@ -476,6 +486,7 @@ void TextDatabaseManager::GetTextMatches(
     cur_db->GetTextMatches(fts_query, cur_options,
                            results, &found_urls, first_time_searched);
     checked_one = true;
+    databases_searched++;
 
     DCHECK(options.max_count == 0 ||
            static_cast<int>(results->size()) <= options.max_count);
@@ -487,6 +498,11 @@ void TextDatabaseManager::GetTextMatches(
   // When there were no databases in the range, we need to fix up the min time.
   if (!checked_one)
     *first_time_searched = options.begin_time;
+
+  UMA_HISTOGRAM_TIMES("History.QueryFTSData",
+                      TimeTicks::Now() - beginning_time);
+  UMA_HISTOGRAM_COUNTS_100("History.QueryFTSDatabaseCount",
+                           databases_searched);
 }
 
 TextDatabase* TextDatabaseManager::GetDB(TextDatabase::DBIdent id,
@@ -555,7 +571,20 @@ void TextDatabaseManager::FlushOldChangesForTime(TimeTicks now) {
     i = recent_changes_.Erase(i);
   }
 
+  OptimizeIdleDatabases(now);
   ScheduleFlushOldChanges();
 }
 
+void TextDatabaseManager::OptimizeIdleDatabases(TimeTicks now) {
+  if (unoptimized_databases_.changed_databases_.empty() ||
+      now - last_index_time_ < TimeDelta::FromSeconds(kOptimizeIdleSeconds))
+    return;
+
+  TimeTicks beginning_time = TimeTicks::Now();
+  OptimizeChangedDatabases(unoptimized_databases_);
+  unoptimized_databases_.changed_databases_.clear();
+  UMA_HISTOGRAM_TIMES("History.OptimizeFTSData",
+                      TimeTicks::Now() - beginning_time);
+}
+
 }  // namespace history
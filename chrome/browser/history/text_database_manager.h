@@ -41,15 +41,16 @@ class VisitDatabase;
 // after the clear.
 class TextDatabaseManager {
  public:
-  // Tracks a set of changes (only deletes need to be supported now) to the
-  // databases. This is opaque to the caller, but allows it to pass back a list
-  // of all database that it has caused a change to.
+  // Tracks a set of changes to the databases. This is opaque to the caller,
+  // but allows it to pass back a list of all database that it has caused a
+  // change to.
   //
   // This is necessary for the feature where we optimize full text databases
   // which have changed as a result of the user deleting history via
   // OptimizeChangedDatabases. We want to do each affected database only once at
   // the end of the delete, but we don't want the caller to have to worry about
-  // our internals.
+  // our internals. The manager also uses one internally to remember which
+  // databases pages have been added to so they can be optimized when idle.
   class ChangeSet {
    public:
     ChangeSet();
@@ -57,6 +58,7 @@ class TextDatabaseManager {
 
    private:
     friend class TextDatabaseManager;
+    FRIEND_TEST_ALL_PREFIXES(TextDatabaseManagerTest, OptimizeWhenIdle);
 
     typedef std::set<TextDatabase::DBIdent> DBSet;
 
@@ -161,6 +163,7 @@ class TextDatabaseManager {
   // These tests call ExpireRecentChangesForTime to force expiration.
   FRIEND_TEST_ALL_PREFIXES(TextDatabaseManagerTest, InsertPartial);
   FRIEND_TEST_ALL_PREFIXES(TextDatabaseManagerTest, PartialComplete);
+  FRIEND_TEST_ALL_PREFIXES(TextDatabaseManagerTest, OptimizeWhenIdle);
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, DeleteURLAndFavicon);
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, FlushRecentURLsUnstarred);
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest,
@@ -246,6 +249,10 @@ class TextDatabaseManager {
   // by the unit tests with fake times.
   void FlushOldChangesForTime(base::TimeTicks now);
 
+  // Optimizes the databases that pages have been added to once nothing has
+  // been indexed for a while as of |now|. Called from FlushOldChangesForTime.
+  void OptimizeIdleDatabases(base::TimeTicks now);
+
   // Directory holding our index files.
   const FilePath dir_;
 
@@ -292,6 +299,11 @@ class TextDatabaseManager {
   // when the transaction is committed.
   DBIdentSet open_transactions_;
 
+  // Databases that pages have been added to since they were last optimized,
+  // and when a page was last added to any database.
+  ChangeSet unoptimized_databases_;
+  base::TimeTicks last_index_time_;
+
   QueryParser query_parser_;
 
   // Generates tasks for our periodic checking of expired "recent changes".
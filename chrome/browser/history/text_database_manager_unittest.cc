@@ -315,6 +315,38 @@ TEST_F(TextDatabaseManagerTest, InsertPartial) {
   EXPECT_TRUE(ResultsHaveURL(results, kURL3));
 }
 
+// Tests that databases which had pages added are optimized once indexing has
+// been idle for a while.
+TEST_F(TextDatabaseManagerTest, OptimizeWhenIdle) {
+  ASSERT_TRUE(Init());
+  InMemDB visit_db;
+  TextDatabaseManager manager(dir_, &visit_db, &visit_db);
+  ASSERT_TRUE(manager.Init(NULL));
+
+  GURL url1(kURL1);
+  Time visit_time = Time::Now();
+  ASSERT_TRUE(manager.AddPageData(url1, 0, 0, visit_time,
+                                  UTF8ToUTF16(kTitle1), UTF8ToUTF16(kBody1)));
+  EXPECT_EQ(1U, manager.unoptimized_databases_.changed_databases_.size());
+
+  // Flushing shortly afterwards leaves the database alone.
+  TimeTicks added_time = TimeTicks::Now();
+  manager.FlushOldChangesForTime(added_time + TimeDelta::FromSeconds(5));
+  EXPECT_EQ(1U, manager.unoptimized_databases_.changed_databases_.size());
+
+  // Once idle the database gets optimized, and its contents remain queryable.
+  manager.FlushOldChangesForTime(added_time + TimeDelta::FromDays(1));
+  EXPECT_TRUE(manager.unoptimized_databases_.changed_databases_.empty());
+
+  QueryOptions options;
+  std::vector<TextDatabase::Match> results;
+  Time first_time_searched;
+  manager.GetTextMatches(UTF8ToUTF16("FOO"), options,
+                         &results, &first_time_searched);
+  ASSERT_EQ(1U, results.size());
+  EXPECT_TRUE(ResultsHaveURL(results, kURL1));
+}
+
 // Tests that partial inserts (due to timeouts) will still get updated if the
 // data comes in later.
 TEST_F(TextDatabaseManagerTest, PartialComplete) {
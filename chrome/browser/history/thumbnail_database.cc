@@ -204,12 +204,17 @@ sql::InitStatus ThumbnailDatabase::OpenDatabase(sql::Connection* db,
                                                 const FilePath& db_name) {
   // Set the exceptional sqlite error handler.
   db->set_error_delegate(GetErrorHandlerForThumbnailDb());
+  db->set_histogram_tag("Thumbnail");
 
   // Thumbnails db now only stores favicons, so we don't need that big a page
   // size or cache.
   db->set_page_size(2048);
   db->set_cache_size(32);
 
+  // Favicons are read on nearly every page load, so let sqlite map the file
+  // where it can rather than copying pages through read().
+  db->set_mmap_size(256 * 1024 * 1024);
+
   // Run the database in exclusive mode. Nobody else should be accessing the
   // database while we're running, and this will give somewhat improved perf.
   db->set_exclusive_locking();
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string.h>
+
 #include "base/file_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/string_split.h"
@@ -193,6 +195,28 @@ void TopSitesDatabase::SetPageThumbnail(const MostVisitedURL& url,
 
 bool TopSitesDatabase::UpdatePageThumbnail(
     const MostVisitedURL& url, const Images& thumbnail) {
+  // Rewriting an unchanged JPEG rewrites (and, with secure_delete, zeroes)
+  // every page it spans, so leave the blob alone when it is the same.
+  if (IsThumbnailUnchanged(url.url, thumbnail)) {
+    sql::Statement statement(db_->GetCachedStatement(
+        SQL_FROM_HERE,
+        "UPDATE thumbnails SET "
+        "title = ?, redirects = ?, "
+        "boring_score = ?, good_clipping = ?, at_top = ?, last_updated = ?, "
+        "load_completed = ? "
+        "WHERE url = ? "));
+    statement.BindString16(0, url.title);
+    statement.BindString(1, GetRedirects(url));
+    const ThumbnailScore& score = thumbnail.thumbnail_score;
+    statement.BindDouble(2, score.boring_score);
+    statement.BindBool(3, score.good_clipping);
+    statement.BindBool(4, score.at_top);
+    statement.BindInt64(5, score.time_at_snapshot.ToInternalValue());
+    statement.BindBool(6, score.load_completed);
+    statement.BindString(7, url.url.spec());
+    return statement.Run();
+  }
+
   sql::Statement statement(db_->GetCachedStatement(
       SQL_FROM_HERE,
       "UPDATE thumbnails SET "
@@ -217,6 +241,25 @@ bool TopSitesDatabase::UpdatePageThumbnail(
   return statement.Run();
 }
 
+bool TopSitesDatabase::IsThumbnailUnchanged(const GURL& url,
+                                            const Images& thumbnail) {
+  sql::Statement statement(db_->GetCachedStatement(
+      SQL_FROM_HERE,
+      "SELECT thumbnail FROM thumbnails WHERE url=?"));
+  statement.BindString(0, url.spec());
+  if (!statement.Step())
+    return false;
+
+  const size_t new_size = (thumbnail.thumbnail.get() &&
+                           thumbnail.thumbnail->front()) ?
+      thumbnail.thumbnail->size() : 0;
+  const size_t old_size = statement.ColumnByteLength(0);
+  if (old_size != new_size)
+    return false;
+  return !new_size || memcmp(statement.ColumnBlob(0),
+                             thumbnail.thumbnail->front(), new_size) == 0;
+}
+
 void TopSitesDatabase::AddPageThumbnail(const MostVisitedURL& url,
                                             int new_rank,
                                             const Images& thumbnail) {
@@ -63,6 +63,7 @@ class TopSitesDatabase {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(TopSitesDatabaseTest, UpgradeToVersion2);
+  FRIEND_TEST_ALL_PREFIXES(TopSitesDatabaseTest, UpdateKeepsUnchangedThumbnail);
 
   // Creates the thumbnail table, returning true if the table already exists
   // or was successfully created.
@@ -85,6 +86,10 @@ class TopSitesDatabase {
   bool UpdatePageThumbnail(const MostVisitedURL& url,
                            const Images& thumbnail);
 
+  // Returns true if |url| is present and its stored thumbnail has the same
+  // bytes as |thumbnail|.
+  bool IsThumbnailUnchanged(const GURL& url, const Images& thumbnail);
+
   // Returns the URL's current rank or -1 if it is not present.
   int GetURLRank(const MostVisitedURL& url);
 
@@ -2,9 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string.h>
+
 #include "base/file_path.h"
 #include "base/file_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/scoped_temp_dir.h"
+#include "base/utf_string_conversions.h"
 #include "chrome/browser/history/top_sites_database.h"
 #include "sql/connection.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -54,4 +58,38 @@ TEST_F(TopSitesDatabaseTest, UpgradeToVersion2) {
   ASSERT_TRUE(db.db_->DoesColumnExist("thumbnails", "load_completed"));
 }
 
+TEST_F(TopSitesDatabaseTest, UpdateKeepsUnchangedThumbnail) {
+  TopSitesDatabase db;
+  ASSERT_TRUE(db.Init(file_name_));
+
+  MostVisitedURL url(GURL("http://www.google.com/"), ASCIIToUTF16("Google"));
+  const unsigned char kJpeg[] = { 0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10 };
+  Images images;
+  images.thumbnail = new base::RefCountedBytes(
+      std::vector<unsigned char>(kJpeg, kJpeg + arraysize(kJpeg)));
+  db.SetPageThumbnail(url, 0, images);
+  EXPECT_TRUE(db.IsThumbnailUnchanged(url.url, images));
+
+  // Only the score changes; the stored bytes must stay the same.
+  url.title = ASCIIToUTF16("Google Search");
+  images.thumbnail_score.boring_score = 0.5;
+  db.SetPageThumbnail(url, 0, images);
+
+  Images stored;
+  ASSERT_TRUE(db.GetPageThumbnail(url.url, &stored));
+  ASSERT_EQ(arraysize(kJpeg), stored.thumbnail->size());
+  EXPECT_EQ(0, memcmp(kJpeg, stored.thumbnail->front(), arraysize(kJpeg)));
+  EXPECT_EQ(0.5, stored.thumbnail_score.boring_score);
+
+  // A different image is written.
+  const unsigned char kOtherJpeg[] = { 0xff, 0xd8, 0xff, 0xe1 };
+  Images other;
+  other.thumbnail = new base::RefCountedBytes(
+      std::vector<unsigned char>(kOtherJpeg,
+                                 kOtherJpeg + arraysize(kOtherJpeg)));
+  EXPECT_FALSE(db.IsThumbnailUnchanged(url.url, other));
+  db.SetPageThumbnail(url, 0, other);
+  EXPECT_TRUE(db.IsThumbnailUnchanged(url.url, other));
+}
+
 }  // namespace history
@@ -33,6 +33,7 @@
 using google::protobuf::RepeatedField;
 using google::protobuf::RepeatedPtrField;
 using in_memory_url_index::InMemoryURLIndexCacheItem;
+using in_memory_url_index::InMemoryURLIndexJournal;
 
 namespace history {
 
@@ -53,6 +54,7 @@ typedef imui::InMemoryURLIndexCacheItem_HistoryInfoMapItem_HistoryInfoMapEntry
 typedef imui::InMemoryURLIndexCacheItem_WordStartsMapItem WordStartsMapItem;
 typedef imui::InMemoryURLIndexCacheItem_WordStartsMapItem_WordStartsMapEntry
     WordStartsMapEntry;
+typedef imui::InMemoryURLIndexJournal_JournalEntry JournalEntry;
 
 // Algorithm Functions ---------------------------------------------------------
 
@@ -103,22 +105,19 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
   // approach.
   ResetSearchTermCache();
 
-  HistoryIDSet history_id_set = HistoryIDSetFromWords(lower_words);
+  HistoryIDVector history_ids = HistoryIDsFromWords(lower_words);
 
   // Trim the candidate pool if it is large. Note that we do not filter out
   // items that do not contain the search terms as proper substrings -- doing
   // so is the performance-costly operation we are trying to avoid in order
   // to maintain omnibox responsiveness.
   const size_t kItemsToScoreLimit = 500;
-  pre_filter_item_count_ = history_id_set.size();
+  pre_filter_item_count_ = history_ids.size();
   // If we trim the results set we do not want to cache the results for next
   // time as the user's ultimately desired result could easily be eliminated
   // in this early rough filter.
   bool was_trimmed = (pre_filter_item_count_ > kItemsToScoreLimit);
   if (was_trimmed) {
-    HistoryIDVector history_ids;
-    std::copy(history_id_set.begin(), history_id_set.end(),
-              std::back_inserter(history_ids));
     // Trim down the set by sorting by typed-count, visit-count, and last
     // visit.
     HistoryItemFactorGreater
@@ -127,10 +126,10 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
                       history_ids.begin() + kItemsToScoreLimit,
                       history_ids.end(),
                       item_factor_functor);
-    history_id_set.clear();
-    std::copy(history_ids.begin(), history_ids.begin() + kItemsToScoreLimit,
-              std::inserter(history_id_set, history_id_set.end()));
-    post_filter_item_count_ = history_id_set.size();
+    history_ids.resize(kItemsToScoreLimit);
+    // Score the survivors in history ID order, as when nothing is trimmed.
+    std::sort(history_ids.begin(), history_ids.end());
+    post_filter_item_count_ = history_ids.size();
   }
 
   // Pass over all of the candidates filtering out any without a proper
@@ -146,7 +145,7 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
   // get two 'terms': "colspec=id%20mstone" and "release".
   history::String16Vector lower_raw_terms;
   Tokenize(lower_raw_string, kWhitespaceUTF16, &lower_raw_terms);
-  scored_items = std::for_each(history_id_set.begin(), history_id_set.end(),
+  scored_items = std::for_each(history_ids.begin(), history_ids.end(),
       AddHistoryMatch(*this, bookmark_service, lower_raw_string,
                       lower_raw_terms, base::Time::Now())).ScoredMatches();
 
@@ -262,9 +261,13 @@ bool URLIndexPrivateData::DeleteURL(const GURL& url) {
 // static
 void URLIndexPrivateData::RestoreFromFileTask(
     const FilePath& file_path,
+    const FilePath& journal_path,
     scoped_refptr<URLIndexPrivateData> private_data,
-    const std::string& languages) {
-  private_data = URLIndexPrivateData::RestoreFromFile(file_path, languages);
+    const std::string& languages,
+    const std::set<std::string>& scheme_whitelist) {
+  if (!private_data->RestoreFromFile(file_path, journal_path, languages,
+                                     scheme_whitelist))
+    private_data->Clear();
 }
 
 // static
@@ -300,10 +303,46 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RebuildFromHistory(
 void URLIndexPrivateData::WritePrivateDataToCacheFileTask(
     scoped_refptr<URLIndexPrivateData> private_data,
     const FilePath& file_path,
+    const FilePath& journal_path,
     scoped_refptr<RefCountedBool> succeeded) {
   DCHECK(private_data.get());
   DCHECK(!file_path.empty());
   succeeded->set_value(private_data->SaveToFile(file_path));
+  if (succeeded->value())
+    file_util::Delete(journal_path, false);
+}
+
+// static
+std::string URLIndexPrivateData::JournalUpdatedRow(const URLRow& row) {
+  InMemoryURLIndexJournal journal;
+  HistoryInfoMapEntry* updated_row = journal.add_entry()->mutable_updated_row();
+  updated_row->set_history_id(row.id());
+  updated_row->set_visit_count(row.visit_count());
+  updated_row->set_typed_count(row.typed_count());
+  updated_row->set_last_visit(row.last_visit().ToInternalValue());
+  updated_row->set_url(row.url().spec());
+  updated_row->set_title(UTF16ToUTF8(row.title()));
+  return journal.SerializeAsString();
+}
+
+// static
+std::string URLIndexPrivateData::JournalDeletedURL(const GURL& url) {
+  InMemoryURLIndexJournal journal;
+  journal.add_entry()->set_deleted_url(url.spec());
+  return journal.SerializeAsString();
+}
+
+// static
+void URLIndexPrivateData::AppendToJournalFileTask(
+    const FilePath& journal_path,
+    const std::string& record) {
+  DCHECK(!journal_path.empty());
+  int size = record.size();
+  int written = file_util::PathExists(journal_path) ?
+      file_util::AppendToFile(journal_path, record.data(), size) :
+      file_util::WriteFile(journal_path, record.data(), size);
+  if (written != size)
+    LOG(WARNING) << "Failed to append to " << journal_path.value();
 }
 
 scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::Duplicate() const {
@@ -347,9 +386,9 @@ URLIndexPrivateData::~URLIndexPrivateData() {}
 
 URLIndexPrivateData::SearchTermCacheItem::SearchTermCacheItem(
     const WordIDSet& word_id_set,
-    const HistoryIDSet& history_id_set)
+    const HistoryIDVector& history_ids)
     : word_id_set_(word_id_set),
-      history_id_set_(history_id_set),
+      history_ids_(history_ids),
       used_(true) {}
 
 URLIndexPrivateData::SearchTermCacheItem::SearchTermCacheItem()
@@ -422,14 +461,14 @@ bool URLIndexPrivateData::HistoryItemFactorGreater::operator()(
 
 // Index Searching -------------------------------------------------------------
 
-HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
+HistoryIDVector URLIndexPrivateData::HistoryIDsFromWords(
     const String16Vector& unsorted_words) {
   // Break the terms down into individual terms (words), get the candidate
   // set for each term, and intersect each to get a final candidate list.
   // Note that a single 'term' from the user's perspective might be
   // a string like "http://www.somewebsite.com" which, from our perspective,
   // is four words: 'http', 'www', 'somewebsite', and 'com'.
-  HistoryIDSet history_id_set;
+  HistoryIDVector history_ids;
   String16Vector words(unsorted_words);
   // Sort the words into the longest first as such are likely to narrow down
   // the results quicker. Also, single character words are the most expensive
@@ -438,29 +477,32 @@ HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
   for (String16Vector::iterator iter = words.begin(); iter != words.end();
        ++iter) {
     string16 uni_word = *iter;
-    HistoryIDSet term_history_set = HistoryIDsForTerm(uni_word);
-    if (term_history_set.empty()) {
-      history_id_set.clear();
+    HistoryIDVector term_history_ids = HistoryIDsForTerm(uni_word);
+    if (term_history_ids.empty()) {
+      history_ids.clear();
       break;
     }
     if (iter == words.begin()) {
-      history_id_set.swap(term_history_set);
+      history_ids.swap(term_history_ids);
     } else {
-      HistoryIDSet new_history_id_set;
-      std::set_intersection(history_id_set.begin(), history_id_set.end(),
-                            term_history_set.begin(), term_history_set.end(),
-                            std::inserter(new_history_id_set,
-                                          new_history_id_set.begin()));
-      history_id_set.swap(new_history_id_set);
+      HistoryIDVector new_history_ids;
+      new_history_ids.reserve(std::min(history_ids.size(),
+                                       term_history_ids.size()));
+      std::set_intersection(history_ids.begin(), history_ids.end(),
+                            term_history_ids.begin(), term_history_ids.end(),
+                            std::back_inserter(new_history_ids));
+      history_ids.swap(new_history_ids);
+      if (history_ids.empty())
+        break;
     }
   }
-  return history_id_set;
+  return history_ids;
 }
 
-HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
+HistoryIDVector URLIndexPrivateData::HistoryIDsForTerm(
     const string16& term) {
   if (term.empty())
-    return HistoryIDSet();
+    return HistoryIDVector();
 
   // TODO(mrossetti): Consider optimizing for very common terms such as
   // 'http[s]', 'www', 'com', etc. Or collect the top 100 more frequently
@@ -489,15 +531,15 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       size_t prefix_length = best_prefix->first.length();
       if (prefix_length == term_length) {
         best_prefix->second.used_ = true;
-        return best_prefix->second.history_id_set_;
+        return best_prefix->second.history_ids_;
       }
 
       // Otherwise we have a handy starting point.
       // If there are no history results for this prefix then we can bail early
       // as there will be no history results for the full term.
-      if (best_prefix->second.history_id_set_.empty()) {
+      if (best_prefix->second.history_ids_.empty()) {
         search_term_cache_[term] = SearchTermCacheItem();
-        return HistoryIDSet();
+        return HistoryIDVector();
       }
       word_id_set = best_prefix->second.word_id_set_;
       prefix_chars = Char16SetFromString16(best_prefix->first);
@@ -517,7 +559,7 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       // We might come up empty on the leftovers.
       if (leftover_set.empty()) {
         search_term_cache_[term] = SearchTermCacheItem();
-        return HistoryIDSet();
+        return HistoryIDVector();
       }
       // Or there may not have been a prefix from which to start.
       if (prefix_chars.empty()) {
@@ -545,9 +587,11 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
     word_id_set = WordIDSetForTermChars(Char16SetFromString16(term));
   }
 
-  // If any words resulted then we can compose a set of history IDs by unioning
-  // the sets from each word.
-  HistoryIDSet history_id_set;
+  // If any words resulted then we can compose a list of history IDs by
+  // unioning the sets from each word. Appending everything and then sorting
+  // once is much cheaper than inserting each ID into a set, as short terms
+  // can match thousands of words.
+  HistoryIDVector history_ids;
   if (!word_id_set.empty()) {
     for (WordIDSet::iterator word_id_iter = word_id_set.begin();
          word_id_iter != word_id_set.end(); ++word_id_iter) {
@@ -555,18 +599,21 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       WordIDHistoryMap::iterator word_iter = word_id_history_map_.find(word_id);
       if (word_iter != word_id_history_map_.end()) {
         HistoryIDSet& word_history_id_set(word_iter->second);
-        history_id_set.insert(word_history_id_set.begin(),
-                              word_history_id_set.end());
+        history_ids.insert(history_ids.end(), word_history_id_set.begin(),
+                           word_history_id_set.end());
       }
     }
+    std::sort(history_ids.begin(), history_ids.end());
+    history_ids.erase(std::unique(history_ids.begin(), history_ids.end()),
+                      history_ids.end());
   }
 
   // Record a new cache entry for this word if the term is longer than
   // a single character.
   if (term_length > 1)
-    search_term_cache_[term] = SearchTermCacheItem(word_id_set, history_id_set);
+    search_term_cache_[term] = SearchTermCacheItem(word_id_set, history_ids);
 
-  return history_id_set;
+  return history_ids;
 }
 
 WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
@@ -932,41 +979,84 @@ void URLIndexPrivateData::SaveWordStartsMap(
 // Cache Restoring -------------------------------------------------------------
 
 // static
-scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
+bool URLIndexPrivateData::RestoreFromFile(
     const FilePath& file_path,
-    const std::string& languages) {
+    const FilePath& journal_path,
+    const std::string& languages,
+    const std::set<std::string>& scheme_whitelist) {
   base::TimeTicks beginning_time = base::TimeTicks::Now();
   if (!file_util::PathExists(file_path))
-    return NULL;
+    return false;
   std::string data;
   // If there is no cache file then simply give up. This will cause us to
   // attempt to rebuild from the history database.
   if (!file_util::ReadFileToString(file_path, &data))
-    return NULL;
+    return false;
 
-  scoped_refptr<URLIndexPrivateData> restored_data(new URLIndexPrivateData);
   InMemoryURLIndexCacheItem index_cache;
   if (!index_cache.ParseFromArray(data.c_str(), data.size())) {
     LOG(WARNING) << "Failed to parse URLIndexPrivateData cache data read from "
                  << file_path.value();
-    return restored_data;
+    return false;
   }
 
-  if (!restored_data->RestorePrivateData(index_cache, languages))
-    return NULL;
+  if (!RestorePrivateData(index_cache, languages))
+    return false;
+
+  // The cache file is only rewritten occasionally; everything which has
+  // changed since then is in the journal.
+  if (!ReplayJournal(journal_path, languages, scheme_whitelist))
+    return false;
 
   UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexRestoreCacheTime",
                       base::TimeTicks::Now() - beginning_time);
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLHistoryItems",
-                       restored_data->history_id_word_map_.size());
+                       history_id_word_map_.size());
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", data.size());
-  UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords",
-                             restored_data->word_map_.size());
+  UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords", word_map_.size());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLChars",
-                             restored_data->char_word_map_.size());
-  if (restored_data->Empty())
-    return NULL;  // 'No data' is the same as a failed reload.
-  return restored_data;
+                             char_word_map_.size());
+  return !Empty();  // 'No data' is the same as a failed reload.
+}
+
+bool URLIndexPrivateData::ReplayJournal(
+    const FilePath& journal_path,
+    const std::string& languages,
+    const std::set<std::string>& scheme_whitelist) {
+  if (journal_path.empty() || !file_util::PathExists(journal_path))
+    return true;
+  std::string data;
+  if (!file_util::ReadFileToString(journal_path, &data))
+    return false;
+
+  // A journal which does not parse, e.g. because the browser exited while
+  // appending to it, cannot be trusted so the whole index must be rebuilt.
+  InMemoryURLIndexJournal journal;
+  if (!journal.ParseFromString(data)) {
+    LOG(WARNING) << "Failed to parse URLIndexPrivateData journal read from "
+                 << journal_path.value();
+    return false;
+  }
+
+  const RepeatedPtrField<JournalEntry>& entries(journal.entry());
+  for (RepeatedPtrField<JournalEntry>::const_iterator iter = entries.begin();
+       iter != entries.end(); ++iter) {
+    if (iter->has_updated_row()) {
+      const HistoryInfoMapEntry& entry(iter->updated_row());
+      URLRow url_row(GURL(entry.url()), entry.history_id());
+      url_row.set_visit_count(entry.visit_count());
+      url_row.set_typed_count(entry.typed_count());
+      url_row.set_last_visit(base::Time::FromInternalValue(entry.last_visit()));
+      if (entry.has_title())
+        url_row.set_title(UTF8ToUTF16(entry.title()));
+      UpdateURL(url_row, languages, scheme_whitelist);
+    } else if (iter->has_deleted_url()) {
+      DeleteURL(GURL(iter->deleted_url()));
+    }
+  }
+  UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLJournalEntries",
+                             journal.entry_size());
+  return true;
 }
 
 bool URLIndexPrivateData::RestorePrivateData(
@@ -82,13 +82,17 @@ class URLIndexPrivateData
   // was actually updated.
   bool DeleteURL(const GURL& url);
 
-  // Creates a new URLIndexPrivateData object, populates it from the contents
-  // of the cache file stored in |file_path|, and assigns it to |private_data|.
-  // |languages| will be used to break URLs and page titles into words.
+  // Populates |private_data| from the contents of the cache file stored in
+  // |file_path| and then replays any changes recorded in the journal file
+  // stored in |journal_path|. |private_data| is left empty on failure.
+  // |languages| will be used to break URLs and page titles into words and
+  // |scheme_whitelist| is used to filter non-qualifying schemes.
   static void RestoreFromFileTask(
       const FilePath& file_path,
+      const FilePath& journal_path,
       scoped_refptr<URLIndexPrivateData> private_data,
-      const std::string& languages);
+      const std::string& languages,
+      const std::set<std::string>& scheme_whitelist);
 
   // Constructs a new object by rebuilding its contents from the history
   // database in |history_db|. Returns the new URLIndexPrivateData which on
@@ -101,12 +105,27 @@ class URLIndexPrivateData
       const std::set<std::string>& scheme_whitelist);
 
   // Writes |private_data| as a cache file to |file_path| and returns success
-  // via |succeeded|.
+  // via |succeeded|. On success the journal file at |journal_path| is deleted
+  // since its changes are now part of the cache file.
   static void WritePrivateDataToCacheFileTask(
       scoped_refptr<URLIndexPrivateData> private_data,
       const FilePath& file_path,
+      const FilePath& journal_path,
       scoped_refptr<RefCountedBool> succeeded);
 
+  // Returns a journal record noting that |row| was added to or updated in the
+  // index, suitable for passing to AppendToJournalFileTask.
+  static std::string JournalUpdatedRow(const URLRow& row);
+
+  // Returns a journal record noting that the history item for |url| was
+  // removed from the index.
+  static std::string JournalDeletedURL(const GURL& url);
+
+  // Appends the journal |record| to the journal file at |journal_path|,
+  // creating the file if necessary.
+  static void AppendToJournalFileTask(const FilePath& journal_path,
+                                      const std::string& record);
+
   // Creates a copy of ourself.
   scoped_refptr<URLIndexPrivateData> Duplicate() const;
 
@@ -125,6 +144,7 @@ class URLIndexPrivateData
   friend class ::HistoryQuickProviderTest;
   friend class InMemoryURLIndexTest;
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, CacheSaveRestore);
+  FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, CacheJournalReplay);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, HugeResultSet);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, Scoring);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, TitleSearch);
@@ -143,7 +163,7 @@ class URLIndexPrivateData
   // no longer needed.
   //
   // Items stored in the search term cache. If a search term exactly matches one
-  // in the cache then we can quickly supply the proper |history_id_set_| (and
+  // in the cache then we can quickly supply the proper |history_ids_| (and
   // marking the cache item as being |used_|. If we find a prefix for a search
   // term in the cache (which is very likely to occur as the user types each
   // term into the omnibox) then we can short-circuit the index search for those
@@ -151,14 +171,14 @@ class URLIndexPrivateData
   // not mark the item as being |used_|.
   struct SearchTermCacheItem {
     SearchTermCacheItem(const WordIDSet& word_id_set,
-                        const HistoryIDSet& history_id_set);
+                        const HistoryIDVector& history_ids);
     // Creates a cache item for a term which has no results.
     SearchTermCacheItem();
 
     ~SearchTermCacheItem();
 
     WordIDSet word_id_set_;
-    HistoryIDSet history_id_set_;
+    HistoryIDVector history_ids_;  // Sorted in ascending order.
     bool used_;  // True if this item has been used for the current term search.
   };
   typedef std::map<string16, SearchTermCacheItem> SearchTermCacheMap;
@@ -203,13 +223,16 @@ class URLIndexPrivateData
 
   // URL History indexing support functions.
 
-  // Composes a set of history item IDs by intersecting the set for each word
-  // in |unsorted_words|.
-  HistoryIDSet HistoryIDSetFromWords(const String16Vector& unsorted_words);
+  // Composes a sorted vector of history item IDs by intersecting the history
+  // item IDs for each word in |unsorted_words|. Candidate lists are kept in
+  // sorted vectors rather than sets since intersecting and merging them is
+  // then a linear scan over contiguous memory, which matters on every
+  // keystroke for profiles with many URLs.
+  HistoryIDVector HistoryIDsFromWords(const String16Vector& unsorted_words);
 
-  // Helper function to HistoryIDSetFromWords which composes a set of history
-  // ids for the given term given in |term|.
-  HistoryIDSet HistoryIDsForTerm(const string16& term);
+  // Helper function to HistoryIDsFromWords which composes a sorted vector of
+  // history ids for the given term given in |term|.
+  HistoryIDVector HistoryIDsForTerm(const string16& term);
 
   // Given a set of Char16s, finds words containing those characters.
   WordIDSet WordIDSetForTermChars(const Char16Set& term_chars);
@@ -268,13 +291,21 @@ class URLIndexPrivateData
   void SaveHistoryInfoMap(imui::InMemoryURLIndexCacheItem* cache) const;
   void SaveWordStartsMap(imui::InMemoryURLIndexCacheItem* cache) const;
 
-  // Constructs a new object by restoring its contents from the file at |path|.
-  // Returns the new URLIndexPrivateData which on success will contain the
-  // restored data but upon failure will be empty.  |languages| will be used to
-  // break URLs and page titles into words
-  static scoped_refptr<URLIndexPrivateData> RestoreFromFile(
-      const FilePath& path,
-      const std::string& languages);
+  // Restores our contents from the cache file at |path| and then applies the
+  // changes recorded in the journal file at |journal_path|, if there is one.
+  // Returns false if either file could not be read or the result is empty.
+  // |languages| will be used to break URLs and page titles into words and
+  // |scheme_whitelist| is used to filter non-qualifying schemes.
+  bool RestoreFromFile(const FilePath& path,
+                       const FilePath& journal_path,
+                       const std::string& languages,
+                       const std::set<std::string>& scheme_whitelist);
+
+  // Applies the changes recorded in the journal file at |journal_path|, in
+  // the order they were made. A missing journal is not an error.
+  bool ReplayJournal(const FilePath& journal_path,
+                     const std::string& languages,
+                     const std::set<std::string>& scheme_whitelist);
 
   // Decode a data structure from the protobuf |cache|. Return false if there
   // is any kind of failure. |languages| will be used to break URLs and page
@@ -9,6 +9,7 @@
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/debug/trace_event.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop.h"
 #include "base/metrics/histogram.h"
@@ -43,6 +44,10 @@ const int kMaxUIMessageDelayMs = 500;
 const int kMaxIOMessageDelayMs = 400;
 #endif
 
+// The FILE and DB threads do blocking disk work, so much longer delays are
+// normal there. Delays beyond this still hold up whatever waits on them.
+const int kMaxBlockingMessageDelayMs = 2000;
+
 // Maximum processing time (excluding queueing delay) for a message before
 // considering it delayed.
 const int kMaxMessageProcessingMs = 100;
@@ -114,6 +119,9 @@ class JankObserverHelper {
   // construction time and message processing time.
   TimeDelta queueing_time_;
 
+  // Name of the watched thread, for the trace events.
+  const std::string thread_name_;
+
   // Counters for the two types of jank we measure.
   base::StatsCounter slow_processing_counter_;  // Msgs w/ long proc time.
   base::StatsCounter queueing_delay_counter_;   // Msgs w/ long queueing delay.
@@ -131,6 +139,7 @@ JankObserverHelper::JankObserverHelper(
     : max_message_delay_(excessive_duration),
       measure_current_message_(true),
       events_till_measurement_(0),
+      thread_name_(thread_name),
       slow_processing_counter_(std::string("Chrome.SlowMsg") + thread_name),
       queueing_delay_counter_(std::string("Chrome.DelayMsg") + thread_name),
       process_times_(base::Histogram::FactoryGet(
@@ -161,6 +170,9 @@ void JankObserverHelper::StartProcessingTimers(const TimeDelta& queueing_time) {
   if (queueing_time_ > max_message_delay_) {
     // Message is too delayed.
     queueing_delay_counter_.Increment();
+    TRACE_EVENT_INSTANT2("browser", "Jankometer::DelayedMessage",
+                         "thread", thread_name_.c_str(),
+                         "queueing_ms", queueing_time_.InMilliseconds());
 #if defined(OS_WIN)
     if (kPlaySounds)
       MessageBeep(MB_ICONASTERISK);
@@ -182,8 +194,13 @@ void JankObserverHelper::EndProcessingTimers() {
   }
   if (now - begin_process_message_ >
       TimeDelta::FromMilliseconds(kMaxMessageProcessingMs)) {
-    // Message took too long to process.
+    // Message took too long to process. The trace event follows the slow
+    // MessageLoop::RunTask event, which names where the task was posted from.
     slow_processing_counter_.Increment();
+    TRACE_EVENT_INSTANT2("browser", "Jankometer::SlowMessage",
+                         "thread", thread_name_.c_str(),
+                         "processing_ms",
+                         (now - begin_process_message_).InMilliseconds());
 #if defined(OS_WIN)
     if (kPlaySounds)
       MessageBeep(MB_ICONHAND);
@@ -263,6 +280,42 @@ class IOJankObserver : public base::RefCountedThreadSafe<IOJankObserver>,
   DISALLOW_COPY_AND_ASSIGN(IOJankObserver);
 };
 
+//------------------------------------------------------------------------------
+// Watches the tasks of a thread that has no native events to watch, such as
+// the FILE and DB threads.
+class TaskJankObserver : public base::RefCountedThreadSafe<TaskJankObserver>,
+                         public MessageLoop::TaskObserver {
+ public:
+  TaskJankObserver(const char* thread_name, TimeDelta excessive_duration)
+      : helper_(thread_name, excessive_duration, false) {}
+
+  // Attaches the observer to the current thread's message loop. You can only
+  // attach to the current thread, so this function can be invoked on another
+  // thread to attach it.
+  void AttachToCurrentThread() {
+    MessageLoop::current()->AddTaskObserver(this);
+  }
+
+  virtual void WillProcessTask(base::TimeTicks time_posted) OVERRIDE {
+    if (!helper_.MessageWillBeMeasured())
+      return;
+    helper_.StartProcessingTimers(base::TimeTicks::Now() - time_posted);
+  }
+
+  virtual void DidProcessTask(base::TimeTicks time_posted) OVERRIDE {
+    helper_.EndProcessingTimers();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<TaskJankObserver>;
+
+  ~TaskJankObserver() {}
+
+  JankObserverHelper helper_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskJankObserver);
+};
+
 //------------------------------------------------------------------------------
 class UIJankObserver : public base::RefCountedThreadSafe<UIJankObserver>,
                        public MessageLoop::TaskObserver,
@@ -365,6 +418,8 @@ class UIJankObserver : public base::RefCountedThreadSafe<UIJankObserver>,
 // These objects are created by InstallJankometer and leaked.
 const scoped_refptr<UIJankObserver>* ui_observer = NULL;
 const scoped_refptr<IOJankObserver>* io_observer = NULL;
+const scoped_refptr<TaskJankObserver>* file_observer = NULL;
+const scoped_refptr<TaskJankObserver>* db_observer = NULL;
 
 }  // namespace
 
@@ -407,6 +462,23 @@ void InstallJankometer(const CommandLine& parsed_command_line) {
   BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
       base::Bind(&IOJankObserver::AttachToCurrentThread, io_observer->get()));
+
+  // The FILE and DB threads only get histograms and trace events; UI work
+  // that waits on them shows up in the UI thread's numbers.
+  file_observer = new scoped_refptr<TaskJankObserver>(
+      new TaskJankObserver(
+          "FILE", TimeDelta::FromMilliseconds(kMaxBlockingMessageDelayMs)));
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&TaskJankObserver::AttachToCurrentThread,
+                 file_observer->get()));
+  db_observer = new scoped_refptr<TaskJankObserver>(
+      new TaskJankObserver(
+          "DB", TimeDelta::FromMilliseconds(kMaxBlockingMessageDelayMs)));
+  BrowserThread::PostTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&TaskJankObserver::AttachToCurrentThread,
+                 db_observer->get()));
 }
 
 void UninstallJankometer() {
@@ -421,4 +493,13 @@ void UninstallJankometer() {
     delete io_observer;
     io_observer = NULL;
   }
+  // Like the IO thread, the FILE and DB threads are gone by now.
+  if (file_observer) {
+    delete file_observer;
+    file_observer = NULL;
+  }
+  if (db_observer) {
+    delete db_observer;
+    db_observer = NULL;
+  }
 }
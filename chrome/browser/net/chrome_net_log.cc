@@ -4,10 +4,13 @@
 
 #include "chrome/browser/net/chrome_net_log.h"
 
+#include <algorithm>
+
 #include "base/command_line.h"
 #include "base/logging.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
+#include "base/threading/platform_thread.h"
 #include "base/values.h"
 #include "chrome/browser/net/load_timing_observer.h"
 #include "chrome/browser/net/net_log_logger.h"
@@ -17,7 +20,13 @@ ChromeNetLog::ChromeNetLog()
     : last_id_(0),
       base_log_level_(LOG_BASIC),
       effective_log_level_(LOG_BASIC),
-      load_timing_observer_(new LoadTimingObserver()) {
+      load_timing_observer_(new LoadTimingObserver()),
+      observers_(reinterpret_cast<base::subtle::AtomicWord>(
+          new ObserverVector())),
+      epoch_(0) {
+  dispatch_count_[0] = 0;
+  dispatch_count_[1] = 0;
+
   const CommandLine* command_line = CommandLine::ForCurrentProcess();
   // Adjust base log level based on command line switch, if present.
   // This is done before adding any observers so the call to UpdateLogLevel when
@@ -36,8 +45,16 @@ ChromeNetLog::ChromeNetLog()
   load_timing_observer_->StartObserving(this);
 
   if (command_line->HasSwitch(switches::kLogNetLog)) {
+    int max_file_size_mb = 0;
+    std::string max_file_size_string =
+        command_line->GetSwitchValueASCII(switches::kNetLogMaxFileSize);
+    if (!base::StringToInt(max_file_size_string, &max_file_size_mb) ||
+        max_file_size_mb < 0) {
+      max_file_size_mb = 0;
+    }
     net_log_logger_.reset(new NetLogLogger(
-        command_line->GetSwitchValuePath(switches::kLogNetLog)));
+        command_line->GetSwitchValuePath(switches::kLogNetLog),
+        static_cast<int64>(max_file_size_mb) * 1024 * 1024));
     net_log_logger_->StartObserving(this);
   }
 }
@@ -47,13 +64,33 @@ ChromeNetLog::~ChromeNetLog() {
   RemoveThreadSafeObserver(load_timing_observer_.get());
   if (net_log_logger_.get())
     RemoveThreadSafeObserver(net_log_logger_.get());
+
+  // Entries may no longer be added, so nothing else uses the list.
+  delete &observers();
 }
 
 void ChromeNetLog::OnAddEntry(const net::NetLog::Entry& entry) {
-  base::AutoLock lock(lock_);
+  // Register in the current epoch before looking at the observer list, so
+  // that the list is not deleted while in use.  If the epoch changed in the
+  // meantime, the list may already be gone; register in the new one instead.
+  base::subtle::Atomic32 epoch;
+  while (true) {
+    epoch = base::subtle::Acquire_Load(&epoch_);
+    base::subtle::Barrier_AtomicIncrement(&dispatch_count_[epoch], 1);
+    if (base::subtle::Acquire_Load(&epoch_) == epoch)
+      break;
+    base::subtle::Barrier_AtomicIncrement(&dispatch_count_[epoch], -1);
+  }
 
   // Notify all of the log observers.
-  FOR_EACH_OBSERVER(ThreadSafeObserver, observers_, OnAddEntry(entry));
+  const ObserverVector* observers = reinterpret_cast<const ObserverVector*>(
+      base::subtle::Acquire_Load(&observers_));
+  for (ObserverVector::const_iterator it = observers->begin();
+       it != observers->end(); ++it) {
+    (*it)->OnAddEntry(entry);
+  }
+
+  base::subtle::Barrier_AtomicIncrement(&dispatch_count_[epoch], -1);
 }
 
 uint32 ChromeNetLog::NextID() {
@@ -71,8 +108,12 @@ void ChromeNetLog::AddThreadSafeObserver(
     LogLevel log_level) {
   base::AutoLock lock(lock_);
 
-  observers_.AddObserver(observer);
+  DCHECK(std::find(observers().begin(), observers().end(), observer) ==
+         observers().end());
+  ObserverVector* new_observers = new ObserverVector(observers());
+  new_observers->push_back(observer);
   OnAddObserver(observer, log_level);
+  ReplaceObservers(new_observers);
   UpdateLogLevel();
 }
 
@@ -81,7 +122,8 @@ void ChromeNetLog::SetObserverLogLevel(
     LogLevel log_level) {
   base::AutoLock lock(lock_);
 
-  DCHECK(observers_.HasObserver(observer));
+  DCHECK(std::find(observers().begin(), observers().end(), observer) !=
+         observers().end());
   OnSetObserverLogLevel(observer, log_level);
   UpdateLogLevel();
 }
@@ -90,23 +132,50 @@ void ChromeNetLog::RemoveThreadSafeObserver(
     net::NetLog::ThreadSafeObserver* observer) {
   base::AutoLock lock(lock_);
 
-  DCHECK(observers_.HasObserver(observer));
-  observers_.RemoveObserver(observer);
+  ObserverVector* new_observers = new ObserverVector(observers());
+  ObserverVector::iterator it =
+      std::find(new_observers->begin(), new_observers->end(), observer);
+  DCHECK(it != new_observers->end());
+  new_observers->erase(it);
+  // Once this returns, |observer| is no longer being called.
+  ReplaceObservers(new_observers);
   OnRemoveObserver(observer);
   UpdateLogLevel();
 }
 
+const ChromeNetLog::ObserverVector& ChromeNetLog::observers() const {
+  return *reinterpret_cast<const ObserverVector*>(
+      base::subtle::NoBarrier_Load(&observers_));
+}
+
+void ChromeNetLog::ReplaceObservers(ObserverVector* observers) {
+  lock_.AssertAcquired();
+
+  const ObserverVector* old_observers = &this->observers();
+  base::subtle::Release_Store(
+      &observers_, reinterpret_cast<base::subtle::AtomicWord>(observers));
+
+  // Start a new epoch.  Calls registered in the old one may still be using
+  // |old_observers|; later calls can only see |observers|.
+  base::subtle::Atomic32 old_epoch = base::subtle::NoBarrier_Load(&epoch_);
+  base::subtle::NoBarrier_Store(&epoch_, 1 - old_epoch);
+  base::subtle::MemoryBarrier();
+  while (base::subtle::Acquire_Load(&dispatch_count_[old_epoch]) != 0)
+    base::PlatformThread::YieldCurrentThread();
+
+  delete old_observers;
+}
+
 void ChromeNetLog::UpdateLogLevel() {
   lock_.AssertAcquired();
 
   // Look through all the observers and find the finest granularity
   // log level (higher values of the enum imply *lower* log levels).
   LogLevel new_effective_log_level = base_log_level_;
-  ObserverListBase<ThreadSafeObserver>::Iterator it(observers_);
-  ThreadSafeObserver* observer;
-  while ((observer = it.GetNext()) != NULL) {
+  for (ObserverVector::const_iterator it = observers().begin();
+       it != observers().end(); ++it) {
     new_effective_log_level =
-        std::min(new_effective_log_level, observer->log_level());
+        std::min(new_effective_log_level, (*it)->log_level());
   }
   base::subtle::NoBarrier_Store(&effective_log_level_,
                                 new_effective_log_level);
@@ -5,9 +5,10 @@
 #ifndef CHROME_BROWSER_NET_CHROME_NET_LOG_H_
 #define CHROME_BROWSER_NET_CHROME_NET_LOG_H_
 
+#include <vector>
+
 #include "base/atomicops.h"
 #include "base/memory/scoped_ptr.h"
-#include "base/observer_list.h"
 #include "base/synchronization/lock.h"
 #include "base/time.h"
 #include "net/base/net_log.h"
@@ -21,6 +22,11 @@ class NetLogLogger;
 // All methods are thread safe, with the exception that no NetLog or
 // NetLog::ThreadSafeObserver functions may be called by an observer's
 // OnAddEntry() method.  Doing so will result in a deadlock.
+//
+// Adding an entry takes no lock: the observers are kept in an immutable list
+// that is replaced, not modified, when observers are added or removed, so
+// observers may be called on several threads at once.  Removing an observer
+// waits until no thread can still be calling it.
 class ChromeNetLog : public net::NetLog {
  public:
   ChromeNetLog();
@@ -40,14 +46,26 @@ class ChromeNetLog : public net::NetLog {
   }
 
  private:
+  typedef std::vector<ThreadSafeObserver*> ObserverVector;
+
   // NetLog implementation:
   virtual void OnAddEntry(const net::NetLog::Entry& entry) OVERRIDE;
 
+  // Returns the list OnAddEntry() dispatches to.  Must have acquired |lock_|
+  // prior to calling.
+  const ObserverVector& observers() const;
+
+  // Makes |observers| the list OnAddEntry() dispatches to, taking ownership
+  // of it, then waits until no thread is dispatching to the previous list and
+  // deletes that.  Must have acquired |lock_| prior to calling.
+  void ReplaceObservers(ObserverVector* observers);
+
   // Called whenever an observer is added or removed, or has its log level
   // changed.  Must have acquired |lock_| prior to calling.
   void UpdateLogLevel();
 
-  // |lock_| protects access to |observers_|.
+  // |lock_| serializes changes to the observer list.  Adding entries does not
+  // acquire it.
   base::Lock lock_;
 
   // Last assigned source ID.  Incremented to get the next one.
@@ -63,8 +81,16 @@ class ChromeNetLog : public net::NetLog {
   scoped_ptr<LoadTimingObserver> load_timing_observer_;
   scoped_ptr<NetLogLogger> net_log_logger_;
 
-  // |lock_| must be acquired whenever reading or writing to this.
-  ObserverList<ThreadSafeObserver, true> observers_;
+  // The current ObserverVector.  Read without locking; only replaced while
+  // holding |lock_|.
+  base::subtle::AtomicWord observers_;
+
+  // The number of OnAddEntry() calls that may be using the observer list, for
+  // each of two alternating epochs.  Replacing the list starts a new epoch
+  // and waits for the calls of the previous one to finish, so that calls
+  // arriving at a steady rate cannot keep it waiting.
+  base::subtle::Atomic32 epoch_;
+  base::subtle::Atomic32 dispatch_count_[2];
 
   DISALLOW_COPY_AND_ASSIGN(ChromeNetLog);
 };
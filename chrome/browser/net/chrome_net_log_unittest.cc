@@ -4,6 +4,7 @@
 
 #include "chrome/browser/net/chrome_net_log.h"
 
+#include "base/atomicops.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/simple_thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -13,6 +14,8 @@ namespace {
 const int kThreads = 10;
 const int kEvents = 100;
 
+// Observers may be called on several threads at once, so the count is
+// atomic.
 class CountingObserver : public net::NetLog::ThreadSafeObserver {
  public:
   CountingObserver() : count_(0) {}
@@ -23,13 +26,13 @@ class CountingObserver : public net::NetLog::ThreadSafeObserver {
   }
 
   virtual void OnAddEntry(const net::NetLog::Entry& entry) OVERRIDE {
-    ++count_;
+    base::subtle::NoBarrier_AtomicIncrement(&count_, 1);
   }
 
-  int count() const { return count_; }
+  int count() const { return base::subtle::NoBarrier_Load(&count_); }
 
  private:
-  int count_;
+  base::subtle::Atomic32 count_;
 };
 
 void AddEvent(ChromeNetLog* net_log) {
@@ -268,4 +271,36 @@ TEST(ChromeNetLogTest, NetLogAddRemoveObserverThreads) {
   RunTestThreads<AddRemoveObserverTestThread>(&net_log);
 }
 
+// Makes sure that observers can be added and removed while events are being
+// added on other threads, and that a removed observer is no longer called.
+TEST(ChromeNetLogTest, NetLogAddRemoveObserverWhileAddingEvents) {
+  ChromeNetLog net_log;
+  CountingObserver observer;
+  net_log.AddThreadSafeObserver(&observer, net::NetLog::LOG_BASIC);
+
+  AddEventsTestThread event_threads[kThreads];
+  AddRemoveObserverTestThread observer_threads[kThreads];
+  base::WaitableEvent start_event(true, false);
+  for (size_t i = 0; i < arraysize(event_threads); ++i) {
+    event_threads[i].Init(&net_log, &start_event);
+    event_threads[i].Start();
+    observer_threads[i].Init(&net_log, &start_event);
+    observer_threads[i].Start();
+  }
+
+  start_event.Signal();
+
+  for (size_t i = 0; i < arraysize(event_threads); ++i) {
+    event_threads[i].Join();
+    observer_threads[i].Join();
+  }
+
+  // |observer| was attached throughout.
+  EXPECT_EQ(kThreads * kEvents, observer.count());
+
+  net_log.RemoveThreadSafeObserver(&observer);
+  AddEvent(&net_log);
+  EXPECT_EQ(kThreads * kEvents, observer.count());
+}
+
 }  // namespace
@@ -14,19 +14,13 @@
 #include "base/values.h"
 #include "chrome/browser/ui/webui/net_internals/net_internals_ui.h"
 
-NetLogLogger::NetLogLogger(const FilePath &log_path) {
-  if (!log_path.empty()) {
+NetLogLogger::NetLogLogger(const FilePath& log_path, int64 max_file_size)
+    : log_path_(log_path),
+      max_file_size_(max_file_size),
+      file_size_(0) {
+  if (!log_path_.empty()) {
     base::ThreadRestrictions::ScopedAllowIO allow_io;
-    file_.Set(file_util::OpenFile(log_path, "w"));
-
-    // Write constants to the output file.  This allows loading files that have
-    // different source and event types, as they may be added and removed
-    // between Chrome versions.
-    scoped_ptr<Value> value(NetInternalsUI::GetConstants());
-    std::string json;
-    base::JSONWriter::Write(value.get(), &json);
-    fprintf(file_.get(), "{\"constants\": %s,\n", json.c_str());
-    fprintf(file_.get(), "\"events\": [\n");
+    OpenLogFile();
   }
 }
 
@@ -45,9 +39,45 @@ void NetLogLogger::OnAddEntry(const net::NetLog::Entry& entry) {
   // loaded, though a little extra parsing has to be done when loading a log.
   std::string json;
   base::JSONWriter::Write(value.get(), &json);
+
+  // The size check and rotation must happen under the same lock as the
+  // write, or another thread could write to |file_| while it is closed.
+  base::AutoLock lock(lock_);
   if (!file_.get()) {
     VLOG(1) << json;
-  } else {
-    fprintf(file_.get(), "%s,\n", json.c_str());
+    return;
+  }
+
+  int written = fprintf(file_.get(), "%s,\n", json.c_str());
+  if (written > 0)
+    file_size_ += written;
+  if (max_file_size_ > 0 && file_size_ >= max_file_size_) {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    RotateLogFile();
   }
 }
+
+void NetLogLogger::OpenLogFile() {
+  file_.Set(file_util::OpenFile(log_path_, "w"));
+  file_size_ = 0;
+  if (!file_.get())
+    return;
+
+  // Write constants to the output file.  This allows loading files that have
+  // different source and event types, as they may be added and removed
+  // between Chrome versions.
+  scoped_ptr<Value> value(NetInternalsUI::GetConstants());
+  std::string json;
+  base::JSONWriter::Write(value.get(), &json);
+  int written = fprintf(file_.get(), "{\"constants\": %s,\n\"events\": [\n",
+                        json.c_str());
+  if (written > 0)
+    file_size_ += written;
+}
+
+void NetLogLogger::RotateLogFile() {
+  lock_.AssertAcquired();
+  file_.Close();
+  file_util::Move(log_path_, log_path_.AddExtension(FILE_PATH_LITERAL("1")));
+  OpenLogFile();
+}
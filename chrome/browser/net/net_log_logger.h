@@ -5,11 +5,12 @@
 #ifndef CHROME_BROWSER_NET_NET_LOG_LOGGER_H_
 #define CHROME_BROWSER_NET_NET_LOG_LOGGER_H_
 
+#include "base/basictypes.h"
+#include "base/file_path.h"
 #include "base/memory/scoped_handle.h"
+#include "base/synchronization/lock.h"
 #include "net/base/net_log.h"
 
-class FilePath;
-
 // NetLogLogger watches the NetLog event stream, and sends all entries to
 // VLOG(1) or a path specified on creation.  This is to debug errors that
 // prevent getting to the about:net-internals page.
@@ -18,14 +19,19 @@ class FilePath;
 // contain a single JSON object, with an extra comma on the end and missing
 // a terminal "]}".
 //
-// Relies on ChromeNetLog only calling an Observer once at a time for
-// thread-safety.
+// When a maximum file size is given, a file that reaches it is moved aside
+// to the same path with ".1" appended, replacing the previous one, and a new
+// file is started.  Each file is a loadable log on its own, and a long
+// capture takes at most about twice the maximum on disk.
+//
+// ChromeNetLog may call OnAddEntry() from several threads at once, so writes
+// to the file are serialized with a lock.
 class NetLogLogger : public net::NetLog::ThreadSafeObserver {
  public:
   // If |log_path| is empty or file creation fails, writes to VLOG(1).
   // Otherwise, writes to |log_path|.  Uses one line per entry, for
-  // easy parsing.
-  explicit NetLogLogger(const FilePath &log_path);
+  // easy parsing.  |max_file_size| is in bytes, 0 for no limit.
+  NetLogLogger(const FilePath& log_path, int64 max_file_size);
   virtual ~NetLogLogger();
 
   // Starts observing specified NetLog.  Must not already be watching a NetLog.
@@ -36,7 +42,21 @@ class NetLogLogger : public net::NetLog::ThreadSafeObserver {
   virtual void OnAddEntry(const net::NetLog::Entry& entry) OVERRIDE;
 
  private:
+  // Opens |log_path_| for writing and writes the constants to it.
+  void OpenLogFile();
+
+  // Moves the current file aside and starts a new one. Must be called with
+  // |lock_| held.
+  void RotateLogFile();
+
+  const FilePath log_path_;
+  const int64 max_file_size_;
+
+  // Protects |file_| and |file_size_|, including across rotation.
+  base::Lock lock_;
+
   ScopedStdioHandle file_;
+  int64 file_size_;
 
   DISALLOW_COPY_AND_ASSIGN(NetLogLogger);
 };
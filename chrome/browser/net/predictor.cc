@@ -43,6 +43,18 @@ using content::BrowserThread;
 
 namespace chrome_browser_net {
 
+namespace {
+
+// For reporting whether a preconnection to a subresource host was needed
+// before its referrer was navigated to again.
+enum PreconnectUtilization {
+  PRECONNECT_USED,
+  PRECONNECT_WASTED,
+  PRECONNECT_UTILIZATION_MAX
+};
+
+}  // namespace
+
 // static
 const int Predictor::kPredictorReferrerVersion = 2;
 const double Predictor::kPreconnectWorthyExpectedValue = 0.8;
@@ -438,7 +450,13 @@ void Predictor::LearnFromNavigation(const GURL& referring_url,
   DCHECK_EQ(target_url, Predictor::CanonicalizeUrl(target_url));
   DCHECK_NE(target_url, GURL::EmptyGURL());
 
-  referrers_[referring_url].SuggestHost(target_url);
+  Referrer* referrer = &referrers_[referring_url];
+  Referrer::iterator it = referrer->find(target_url);
+  if (it != referrer->end() && it->second.MarkPreconnectionUsed()) {
+    UMA_HISTOGRAM_ENUMERATION("Net.PreconnectUtilization", PRECONNECT_USED,
+                              PRECONNECT_UTILIZATION_MAX);
+  }
+  referrer->SuggestHost(target_url);
   // Possibly do some referrer trimming.
   TrimReferrers();
 }
@@ -864,16 +882,27 @@ void Predictor::PrepareFrameSubresources(const GURL& url) {
   for (Referrer::iterator future_url = referrer->begin();
        future_url != referrer->end(); ++future_url) {
     SubresourceValue evalution(TOO_NEW);
+    // A preconnection made the last time this referrer was navigated to, and
+    // not needed since, was wasted.
+    if (future_url->second.ClearUnusedPreconnection()) {
+      UMA_HISTOGRAM_ENUMERATION("Net.PreconnectUtilization", PRECONNECT_WASTED,
+                                PRECONNECT_UTILIZATION_MAX);
+    }
     double connection_expectation = future_url->second.subresource_use_rate();
     UMA_HISTOGRAM_CUSTOM_COUNTS("Net.PreconnectSubresourceExpectation",
                                 static_cast<int>(connection_expectation * 100),
                                 10, 5000, 50);
+    // Weight the expectation by how often our preconnections to this host were
+    // actually used, so that hosts we keep preconnecting to in vain fall back
+    // to preresolution.
+    const double preconnect_expectation =
+        connection_expectation * future_url->second.preconnection_accuracy();
     future_url->second.ReferrerWasObserved();
     if (preconnect_enabled_ &&
-        connection_expectation > kPreconnectWorthyExpectedValue) {
+        preconnect_expectation > kPreconnectWorthyExpectedValue) {
       evalution = PRECONNECTION;
       future_url->second.IncrementPreconnectionCount();
-      int count = static_cast<int>(std::ceil(connection_expectation));
+      int count = static_cast<int>(std::ceil(preconnect_expectation));
       if (url.host() == future_url->first.host())
         ++count;
       PreconnectOnIOThread(future_url->first, motivation, count,
@@ -681,4 +681,24 @@ TEST_F(PredictorTest, DiscardPredictorResults) {
   predictor.Shutdown();
 }
 
+TEST_F(PredictorTest, PreconnectionAccuracy) {
+  ReferrerValue value;
+  EXPECT_DOUBLE_EQ(1.0, value.preconnection_accuracy());
+  EXPECT_FALSE(value.MarkPreconnectionUsed());
+  EXPECT_FALSE(value.ClearUnusedPreconnection());
+
+  // A preconnection is used once at most.
+  value.IncrementPreconnectionCount();
+  EXPECT_TRUE(value.MarkPreconnectionUsed());
+  EXPECT_FALSE(value.MarkPreconnectionUsed());
+  EXPECT_FALSE(value.ClearUnusedPreconnection());
+  EXPECT_DOUBLE_EQ(1.0, value.preconnection_accuracy());
+
+  // Wasted preconnections lower the accuracy.
+  value.IncrementPreconnectionCount();
+  EXPECT_TRUE(value.ClearUnusedPreconnection());
+  EXPECT_FALSE(value.MarkPreconnectionUsed());
+  EXPECT_DOUBLE_EQ(2.0 / 3.0, value.preconnection_accuracy());
+}
+
 }  // namespace chrome_browser_net
@@ -163,6 +163,8 @@ ReferrerValue::ReferrerValue()
     : birth_time_(base::Time::Now()),
       navigation_count_(0),
       preconnection_count_(0),
+      preconnection_used_count_(0),
+      preconnection_pending_(false),
       preresolution_count_(0),
       subresource_use_rate_(kInitialConnectsExpectedValue) {
 }
@@ -174,6 +176,26 @@ void ReferrerValue::SubresourceIsNeeded() {
   subresource_use_rate_ += 1 - kWeightingForOldConnectsExpectedValue;
 }
 
+void ReferrerValue::IncrementPreconnectionCount() {
+  ++preconnection_count_;
+  preconnection_pending_ = true;
+}
+
+bool ReferrerValue::MarkPreconnectionUsed() {
+  if (!preconnection_pending_)
+    return false;
+  preconnection_pending_ = false;
+  ++preconnection_used_count_;
+  return true;
+}
+
+bool ReferrerValue::ClearUnusedPreconnection() {
+  if (!preconnection_pending_)
+    return false;
+  preconnection_pending_ = false;
+  return true;
+}
+
 void ReferrerValue::ReferrerWasObserved() {
   subresource_use_rate_ *= kWeightingForOldConnectsExpectedValue;
   // Note: the use rate is temporarilly possibly incorect, as we need to find
@@ -55,7 +55,20 @@ class ReferrerValue {
   double subresource_use_rate() const { return subresource_use_rate_; }
 
   int64 preconnection_count() const { return preconnection_count_; }
-  void IncrementPreconnectionCount() { ++preconnection_count_; }
+  void IncrementPreconnectionCount();
+
+  // Returns true if the last preconnection has not been used yet, and marks it
+  // as used.
+  bool MarkPreconnectionUsed();
+
+  // Returns true if the last preconnection was never used, and forgets it.
+  bool ClearUnusedPreconnection();
+
+  // The fraction of preconnections that were used, optimistically assuming a
+  // first one would be.
+  double preconnection_accuracy() const {
+    return (preconnection_used_count_ + 1.0) / (preconnection_count_ + 1.0);
+  }
 
   int64 preresolution_count() const { return preresolution_count_; }
   void preresolution_increment() { ++preresolution_count_; }
@@ -74,6 +87,13 @@ class ReferrerValue {
   // referrer.
   int64 preconnection_count_;
 
+  // The number of those preconnections that were needed before the referrer
+  // was next navigated to.
+  int64 preconnection_used_count_;
+
+  // Whether the last preconnection has yet to be used.
+  bool preconnection_pending_;
+
   // The number of times this item was pre-resolved (via DNS) as a consequence
   // of its referrer.
   int64 preresolution_count_;
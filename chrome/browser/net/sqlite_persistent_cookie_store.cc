@@ -628,6 +628,7 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
 
   db_.reset(new sql::Connection);
   db_->set_error_delegate(error_delegate_.get());
+  db_->set_histogram_tag("Cookie");
 
   if (!db_->Open(path_)) {
     NOTREACHED() << "Unable to open cookie DB.";
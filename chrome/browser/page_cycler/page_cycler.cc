@@ -4,7 +4,10 @@
 
 #include "chrome/browser/page_cycler/page_cycler.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
 #include "base/message_loop.h"
@@ -31,12 +34,47 @@ using content::OpenURLParams;
 using content::Referrer;
 using content::WebContents;
 
+namespace {
+
+// Formats |times| as a perf result list, e.g. "*RESULT name: t_ref= [1, 2] ms".
+std::string TimesToResultString(const std::string& name,
+                                const std::vector<int64>& times) {
+  std::string list;
+  for (size_t i = 0; i < times.size(); ++i) {
+    if (i)
+      list.append(", ");
+    list.append(base::Int64ToString(times[i]));
+  }
+  return "*RESULT " + name + ": t_ref= [" + list + "] ms\n";
+}
+
+// Formats the median and 90th percentile of |times|, which are comparable
+// across runs with different numbers of pages.
+std::string PercentilesToResultString(const std::string& name,
+                                      std::vector<int64> times) {
+  if (times.empty())
+    return std::string();
+  std::sort(times.begin(), times.end());
+  std::string output;
+  const int kPercentiles[] = { 50, 90 };
+  for (size_t i = 0; i < arraysize(kPercentiles); ++i) {
+    size_t index = (times.size() - 1) * kPercentiles[i] / 100;
+    output.append("RESULT " + name + ": p" +
+                  base::IntToString(kPercentiles[i]) + "= " +
+                  base::Int64ToString(times[index]) + " ms\n");
+  }
+  return output;
+}
+
+}  // namespace
+
 PageCycler::PageCycler(Browser* browser,
                        const FilePath& urls_file)
     : content::WebContentsObserver(chrome::GetActiveWebContents(browser)),
       browser_(browser),
       urls_file_(urls_file),
       url_index_(0),
+      main_frame_id_(-1),
       aborted_(false) {
   BrowserList::AddObserver(this);
   AddRef();  // Balanced in Finish()/Abort() (only one should be called).
@@ -59,6 +97,29 @@ bool PageCycler::IsLoadCallbackValid(const GURL& validated_url,
           validated_url.spec() != content::kUnreachableWebDataURL);
 }
 
+void PageCycler::DidCommitProvisionalLoadForFrame(
+    int64 frame_id,
+    bool is_main_frame,
+    const GURL& url,
+    content::PageTransition transition_type,
+    content::RenderViewHost* render_view_host) {
+  if (!url_index_ || !is_main_frame || !commit_time_.is_null())
+    return;
+  main_frame_id_ = frame_id;
+  commit_time_ = base::TimeTicks::HighResNow();
+  TRACE_EVENT_ASYNC_STEP0("browser", "PageCycler::Load", this, "Committed");
+}
+
+void PageCycler::DocumentLoadedInFrame(
+    int64 frame_id,
+    content::RenderViewHost* render_view_host) {
+  if (frame_id != main_frame_id_ || !document_loaded_time_.is_null())
+    return;
+  document_loaded_time_ = base::TimeTicks::HighResNow();
+  TRACE_EVENT_ASYNC_STEP0("browser", "PageCycler::Load", this,
+                          "DocumentLoaded");
+}
+
 void PageCycler::DidFinishLoad(int64 frame_id,
                                const GURL& validated_url,
                                bool is_main_frame,
@@ -152,6 +213,13 @@ void PageCycler::LoadNextURL() {
     urls_string_.append(", ");
   }
   urls_string_.append(urls_[url_index_].spec());
+  main_frame_id_ = -1;
+  commit_time_ = base::TimeTicks();
+  document_loaded_time_ = base::TimeTicks();
+  // Brackets the load in traces, so that a trace of the whole run can be
+  // split up by page.
+  TRACE_EVENT_ASYNC_BEGIN1("browser", "PageCycler::Load", this,
+                           "url", urls_[url_index_].spec());
   initial_time_ = base::TimeTicks::HighResNow();
   OpenURLParams params(urls_[url_index_],
                        Referrer(),
@@ -163,9 +231,18 @@ void PageCycler::LoadNextURL() {
 }
 
 void PageCycler::LoadSucceeded() {
-  base::TimeDelta time_elapsed =
-      (base::TimeTicks::HighResNow() - initial_time_) / 1000.0;
+  base::TimeTicks now = base::TimeTicks::HighResNow();
+  TRACE_EVENT_ASYNC_END0("browser", "PageCycler::Load", this);
+  base::TimeDelta time_elapsed = (now - initial_time_) / 1000.0;
   timings_string_.append(base::Int64ToString(time_elapsed.ToInternalValue()));
+
+  load_times_.push_back((now - initial_time_).InMilliseconds());
+  if (!commit_time_.is_null())
+    commit_times_.push_back((commit_time_ - initial_time_).InMilliseconds());
+  if (!document_loaded_time_.is_null()) {
+    document_loaded_times_.push_back(
+        (document_loaded_time_ - initial_time_).InMilliseconds());
+  }
   LoadNextURL();
 }
 
@@ -174,6 +251,7 @@ void PageCycler::LoadFailed(const GURL& url,
   error_.append(ASCIIToUTF16("Failed to load the page at: " +
       url.spec() + ": ")).append(error_description).
       append(ASCIIToUTF16("\n"));
+  TRACE_EVENT_ASYNC_END0("browser", "PageCycler::Load", this);
   base::TimeDelta time_elapsed =
       (base::TimeTicks::HighResNow() - initial_time_) / 1000.0;
   timings_string_.append(base::Int64ToString(time_elapsed.ToInternalValue()) +
@@ -197,6 +275,14 @@ void PageCycler::PrepareResultsOnBackgroundThread() {
               base::GetSystemCommitCharge(), false);
     output.append("Pages: [" + urls_string_ + "]\n");
     output.append("*RESULT times: t_ref= [" + timings_string_ + "] ms\n");
+    // Breakdown of the successful loads.
+    output.append(TimesToResultString("commit_times", commit_times_));
+    output.append(TimesToResultString("document_loaded_times",
+                                      document_loaded_times_));
+    output.append(PercentilesToResultString("times", load_times_));
+    output.append(PercentilesToResultString("commit_times", commit_times_));
+    output.append(PercentilesToResultString("document_loaded_times",
+                                            document_loaded_times_));
   }
   WriteResultsOnBackgroundThread(output);
 }
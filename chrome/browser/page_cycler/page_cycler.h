@@ -5,6 +5,9 @@
 #ifndef CHROME_BROWSER_PAGE_CYCLER_PAGE_CYCLER_H_
 #define CHROME_BROWSER_PAGE_CYCLER_PAGE_CYCLER_H_
 
+#include <string>
+#include <vector>
+
 #include "base/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "chrome/browser/ui/browser_list_observer.h"
@@ -35,6 +38,15 @@ class PageCycler : public base::RefCountedThreadSafe<PageCycler>,
   void Run();
 
   // content::WebContentsObserver
+  virtual void DidCommitProvisionalLoadForFrame(
+      int64 frame_id,
+      bool is_main_frame,
+      const GURL& url,
+      content::PageTransition transition_type,
+      content::RenderViewHost* render_view_host) OVERRIDE;
+  virtual void DocumentLoadedInFrame(
+      int64 frame_id,
+      content::RenderViewHost* render_view_host) OVERRIDE;
   virtual void DidFinishLoad(
       int64 frame_id,
       const GURL& validated_url,
@@ -141,6 +153,21 @@ class PageCycler : public base::RefCountedThreadSafe<PageCycler>,
   // used to calculate the time taken for each url load.
   base::TimeTicks initial_time_;
 
+  // The main frame of the page being loaded, once it has committed, or -1.
+  int64 main_frame_id_;
+
+  // When the page being loaded committed and when its document was parsed
+  // (DOMContentLoaded); null until then.
+  base::TimeTicks commit_time_;
+  base::TimeTicks document_loaded_time_;
+
+  // The time in milliseconds from the start of each successful load until
+  // the page committed, was parsed and finished loading. Pages for which a
+  // phase was not seen are missing from its vector.
+  std::vector<int64> commit_times_;
+  std::vector<int64> document_loaded_times_;
+  std::vector<int64> load_times_;
+
   // Indicates the abort status of the page cycler; true means aborted.
   bool aborted_;
 
@@ -286,6 +286,11 @@ TEST_F(PageCyclerTest, StatsFile) {
   PumpLoop();
   EXPECT_FALSE(PathExists(errors_file()));
   ASSERT_TRUE(PathExists(stats_file()));
+
+  std::string stats_output;
+  ASSERT_TRUE(file_util::ReadFileToString(stats_file(), &stats_output));
+  EXPECT_NE(std::string::npos, stats_output.find("RESULT times: p50= "));
+  EXPECT_NE(std::string::npos, stats_output.find("RESULT times: p90= "));
 }
 
 TEST_F(PageCyclerTest, KillBrowserAndAbort) {
@@ -107,6 +107,19 @@ AutocompleteActionPredictor::~AutocompleteActionPredictor() {
 void AutocompleteActionPredictor::RegisterTransitionalMatches(
     const string16& user_text,
     const AutocompleteResult& result) {
+  // If the user starts typing before the first page load has completed, build
+  // the caches now rather than miss the predictions for this input.
+  if (!main_profile_predictor_ &&
+      notification_registrar_.IsRegistered(
+          this, content::NOTIFICATION_LOAD_COMPLETED_MAIN_FRAME,
+          content::NotificationService::AllSources())) {
+    notification_registrar_.Remove(
+        this,
+        content::NOTIFICATION_LOAD_COMPLETED_MAIN_FRAME,
+        content::NotificationService::AllSources());
+    CreateLocalCachesFromDatabase();
+  }
+
   if (user_text.length() < kMinimumUserTextLength)
     return;
   const string16 lower_user_text(base::i18n::ToLower(user_text));
@@ -101,7 +101,10 @@ ResourcePrefetchPredictor::Config::Config()
       max_urls_to_track(500),
       min_url_visit_count(3),
       max_resources_per_entry(50),
-      max_consecutive_misses(3) {
+      max_consecutive_misses(3),
+      max_prefetches_per_navigation(25),
+      max_prefetches_in_flight(5),
+      min_resource_hit_ratio(0.8f) {
 }
 
 ResourcePrefetchPredictor::URLRequestSummary::URLRequestSummary()
@@ -138,6 +141,11 @@ ResourcePrefetchPredictor::ResourcePrefetchPredictor(
           profile)->resource_prefetch_tables()) {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
+  if (prerender::IsSpeculativeResourcePrefetchingEnabled(profile)) {
+    prefetch_manager_ = new ResourcePrefetcherManager(
+        config_.max_prefetches_in_flight, profile->GetRequestContext());
+  }
+
   notification_registrar_.Add(this,
                               content::NOTIFICATION_LOAD_COMPLETED_MAIN_FRAME,
                               content::NotificationService::AllSources());
@@ -146,6 +154,13 @@ ResourcePrefetchPredictor::ResourcePrefetchPredictor(
 ResourcePrefetchPredictor::~ResourcePrefetchPredictor() {
 }
 
+void ResourcePrefetchPredictor::Shutdown() {
+  if (prefetch_manager_) {
+    prefetch_manager_->ShutdownOnUIThread();
+    prefetch_manager_ = NULL;
+  }
+}
+
 // static
 bool ResourcePrefetchPredictor::IsEnabled(Profile* profile) {
   return prerender::IsSpeculativeResourcePrefetchingLearningEnabled(profile);
@@ -365,6 +380,8 @@ void ResourcePrefetchPredictor::OnMainFrameRequest(
   // New empty navigation entry.
   inflight_navigations_.insert(std::make_pair(
       request.navigation_id, std::vector<URLRequestSummary>()));
+
+  MaybeStartPrefetching(request.navigation_id);
 }
 
 void ResourcePrefetchPredictor::OnMainFrameResponse(
@@ -373,7 +390,8 @@ void ResourcePrefetchPredictor::OnMainFrameResponse(
 
   RecordNavigationEvent(NAVIGATION_EVENT_RESPONSE_STARTED);
 
-  // TODO(shishir): The prefreshing will be stopped here.
+  // Prefetching continues while the page loads, since the prefetched
+  // resources are the ones the page is about to ask for.
 }
 
 void ResourcePrefetchPredictor::OnMainFrameRedirect(
@@ -384,6 +402,7 @@ void ResourcePrefetchPredictor::OnMainFrameRedirect(
 
   // Remove the older navigation.
   inflight_navigations_.erase(response.navigation_id);
+  MaybeStopPrefetching(response.navigation_id);
 
   // A redirect will not lead to another OnMainFrameRequest call, so record the
   // redirect url as a new navigation.
@@ -398,6 +417,7 @@ void ResourcePrefetchPredictor::OnMainFrameRedirect(
   navigation_id.main_frame_url = response.redirect_url;
   inflight_navigations_.insert(std::make_pair(
       navigation_id, std::vector<URLRequestSummary>()));
+  MaybeStartPrefetching(navigation_id);
 }
 
 void ResourcePrefetchPredictor::OnSubresourceResponse(
@@ -439,6 +459,7 @@ void ResourcePrefetchPredictor::CleanupAbandonedNavigations(
        it != inflight_navigations_.end();) {
     if (it->first.IsSameRenderer(navigation_id) ||
         (time_now - it->first.creation_time > max_navigation_age)) {
+      MaybeStopPrefetching(it->first);
       inflight_navigations_.erase(it++);
       RecordNavigationEvent(NAVIGATION_EVENT_REQUEST_EXPIRED);
     } else {
@@ -615,8 +636,12 @@ void ResourcePrefetchPredictor::OnNavigationComplete(
 
   RecordNavigationEvent(NAVIGATION_EVENT_ONLOAD_TRACKED_URL);
 
+  // Whatever is still being prefetched is no longer needed.
+  MaybeStopPrefetching(navigation_id);
+
   // Report any stats.
   MaybeReportAccuracyStats(navigation_id);
+  ReportPageLoadTime(navigation_id);
 
   // Update the URL table.
   const GURL& main_frame_url = navigation_id.main_frame_url;
@@ -631,6 +656,74 @@ void ResourcePrefetchPredictor::OnNavigationComplete(
   inflight_navigations_.erase(navigation_id);
 }
 
+void ResourcePrefetchPredictor::MaybeStartPrefetching(
+    const NavigationID& navigation_id) {
+  if (!prefetch_manager_)
+    return;
+
+  const std::vector<GURL> urls = GetPrefetchUrls(navigation_id.main_frame_url);
+  if (urls.empty())
+    return;
+
+  UMA_HISTOGRAM_COUNTS_100("ResourcePrefetchPredictor.PrefetchCount",
+                           urls.size());
+  prefetch_manager_->MaybeAddPrefetch(navigation_id, urls);
+}
+
+void ResourcePrefetchPredictor::MaybeStopPrefetching(
+    const NavigationID& navigation_id) {
+  if (prefetch_manager_)
+    prefetch_manager_->MaybeRemovePrefetch(navigation_id);
+}
+
+std::vector<GURL> ResourcePrefetchPredictor::GetPrefetchUrls(
+    const GURL& main_frame_url) const {
+  std::vector<GURL> urls;
+  UrlTableCacheMap::const_iterator it = url_table_cache_.find(main_frame_url);
+  if (it == url_table_cache_.end())
+    return urls;
+
+  // The rows are sorted by score, so the likeliest resources come first.
+  const UrlTableRowVector& rows = it->second.rows;
+  for (UrlTableRowVector::const_iterator row = rows.begin();
+       row != rows.end() &&
+       static_cast<int>(urls.size()) < config_.max_prefetches_per_navigation;
+       ++row) {
+    const int loads = row->number_of_hits + row->number_of_misses;
+    if (loads <= 0 ||
+        row->number_of_hits < config_.min_resource_hit_ratio * loads) {
+      continue;
+    }
+    urls.push_back(row->resource_url);
+  }
+  return urls;
+}
+
+void ResourcePrefetchPredictor::ReportPageLoadTime(
+    const NavigationID& navigation_id) const {
+  // Only pages that could have been prefetched for are compared, so that the
+  // two histograms cover the same kind of page.
+  if (url_table_cache_.find(navigation_id.main_frame_url) ==
+      url_table_cache_.end()) {
+    return;
+  }
+
+  // The key holds the creation time, which |navigation_id| does not.
+  NavigationMap::const_iterator it = inflight_navigations_.find(navigation_id);
+  DCHECK(it != inflight_navigations_.end());
+  if (it->first.creation_time.is_null())
+    return;
+
+  const base::TimeDelta plt = base::TimeTicks::Now() - it->first.creation_time;
+  if (prefetch_manager_) {
+    UMA_HISTOGRAM_MEDIUM_TIMES("ResourcePrefetchPredictor.PLT_Prefetching",
+                               plt);
+  } else {
+    UMA_HISTOGRAM_MEDIUM_TIMES("ResourcePrefetchPredictor.PLT_NotPrefetching",
+                               plt);
+  }
+}
+
 void ResourcePrefetchPredictor::LearnUrlNavigation(
     const GURL& main_frame_url,
     const std::vector<URLRequestSummary>& new_resources) {
@@ -16,6 +16,7 @@
 #include "chrome/browser/history/history_types.h"
 #include "chrome/browser/predictors/resource_prefetch_common.h"
 #include "chrome/browser/predictors/resource_prefetch_predictor_tables.h"
+#include "chrome/browser/predictors/resource_prefetcher.h"
 #include "chrome/browser/profiles/profile_keyed_service.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
@@ -55,7 +56,11 @@ namespace predictors {
 //   it to disk in the DB thread through the ResourcePrefetchPredictorTables.
 //   Owned by profile.
 //
-// TODO(shishir): Implement the prefetching of resources.
+// * ResourcePrefetcherManager - Prefetches the resources predicted for a
+//   navigation into the HTTP cache on the IO thread while the main frame loads.
+//   Owned by the ResourcePrefetchPredictor, and only created if prefetching is
+//   enabled.
+//
 // TODO(shishir): Do speculative prefetching for https resources and/or https
 // main_frame urls.
 class ResourcePrefetchPredictor
@@ -82,6 +87,13 @@ class ResourcePrefetchPredictor
     int max_resources_per_entry;  // Default 50
     // The number of consecutive misses after we stop tracking a resource Url.
     int max_consecutive_misses;  // Default 3
+    // The most resources to prefetch for a navigation.
+    int max_prefetches_per_navigation;  // Default 25
+    // The most prefetches in flight for a navigation at a time.
+    size_t max_prefetches_in_flight;  // Default 5
+    // A resource is only prefetched if it was needed at least this fraction of
+    // the times the main frame Url was loaded.
+    float min_resource_hit_ratio;  // Default 0.8
   };
 
   // Stores the data that we need to get from the URLRequest.
@@ -103,6 +115,9 @@ class ResourcePrefetchPredictor
   ResourcePrefetchPredictor(const Config& config, Profile* profile);
   virtual ~ResourcePrefetchPredictor();
 
+  // ProfileKeyedService methods OVERRIDE.
+  virtual void Shutdown() OVERRIDE;
+
   // Thread safe.
   static bool IsEnabled(Profile* profile);
   static bool ShouldRecordRequest(net::URLRequest* request,
@@ -137,6 +152,7 @@ class ResourcePrefetchPredictor
   FRIEND_TEST_ALL_PREFIXES(ResourcePrefetchPredictorTest, OnMainFrameRedirect);
   FRIEND_TEST_ALL_PREFIXES(ResourcePrefetchPredictorTest,
                            OnSubresourceResponse);
+  FRIEND_TEST_ALL_PREFIXES(ResourcePrefetchPredictorTest, GetPrefetchUrls);
 
   // TODO(shishir): Maybe use pointers to make the sort cheaper.
   typedef ResourcePrefetchPredictorTables::UrlTableRow UrlTableRow;
@@ -191,6 +207,14 @@ class ResourcePrefetchPredictor
   bool ShouldTrackUrl(const GURL& url);
   void CleanupAbandonedNavigations(const NavigationID& navigation_id);
   void OnNavigationComplete(const NavigationID& navigation_id);
+
+  // Prefetching code.
+  void MaybeStartPrefetching(const NavigationID& navigation_id);
+  void MaybeStopPrefetching(const NavigationID& navigation_id);
+  // Returns the resources worth prefetching for |main_frame_url|, most likely
+  // first, leaving out those that are often not needed.
+  std::vector<GURL> GetPrefetchUrls(const GURL& main_frame_url) const;
+  void ReportPageLoadTime(const NavigationID& navigation_id) const;
   void LearnUrlNavigation(const GURL& main_frame_url,
                           const std::vector<URLRequestSummary>& new_value);
   void MaybeReportAccuracyStats(const NavigationID& navigation_id) const;
@@ -206,6 +230,7 @@ class ResourcePrefetchPredictor
   Config config_;
   InitializationState initialization_state_;
   scoped_refptr<ResourcePrefetchPredictorTables> tables_;
+  scoped_refptr<ResourcePrefetcherManager> prefetch_manager_;
   content::NotificationRegistrar notification_registrar_;
 
   NavigationMap inflight_navigations_;
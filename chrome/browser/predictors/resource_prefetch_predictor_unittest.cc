@@ -599,4 +599,37 @@ TEST_F(ResourcePrefetchPredictorTest, OnSubresourceResponse) {
       predictor_->inflight_navigations_[main_frame1.navigation_id][2]));
 }
 
+TEST_F(ResourcePrefetchPredictorTest, GetPrefetchUrls) {
+  const GURL main_frame_url("http://www.google.com");
+  EXPECT_TRUE(predictor_->GetPrefetchUrls(main_frame_url).empty());
+
+  UrlTableRows rows;
+  rows.push_back(UrlTableRow("http://www.google.com",
+                             "http://google.com/style1.css",
+                             ResourceType::STYLESHEET, 10, 0, 0, 1.0));
+  rows.push_back(UrlTableRow("http://www.google.com",
+                             "http://google.com/ad.js",
+                             ResourceType::SCRIPT, 2, 8, 1, 2.0));
+  rows.push_back(UrlTableRow("http://www.google.com",
+                             "http://google.com/image1.png",
+                             ResourceType::IMAGE, 8, 2, 0, 3.0));
+  rows.push_back(UrlTableRow("http://www.google.com",
+                             "http://google.com/image2.png",
+                             ResourceType::IMAGE, 9, 1, 0, 4.0));
+  predictor_->url_table_cache_[main_frame_url].rows = rows;
+
+  // Resources that are often not needed are left out.
+  std::vector<GURL> urls = predictor_->GetPrefetchUrls(main_frame_url);
+  ASSERT_EQ(3U, urls.size());
+  EXPECT_EQ(GURL("http://google.com/style1.css"), urls[0]);
+  EXPECT_EQ(GURL("http://google.com/image1.png"), urls[1]);
+  EXPECT_EQ(GURL("http://google.com/image2.png"), urls[2]);
+
+  // At most |max_prefetches_per_navigation| are prefetched.
+  predictor_->config_.max_prefetches_per_navigation = 2;
+  urls = predictor_->GetPrefetchUrls(main_frame_url);
+  ASSERT_EQ(2U, urls.size());
+  EXPECT_EQ(GURL("http://google.com/image1.png"), urls[1]);
+}
+
 }  // namespace predictors
@@ -0,0 +1,221 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/predictors/resource_prefetcher.h"
+
+#include "base/bind.h"
+#include "base/stl_util.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
+#include "net/base/request_priority.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+
+using content::BrowserThread;
+
+namespace {
+
+// The size of the buffer the discarded response bodies are read into.
+const int kReadBufferSize = 4096;
+
+}  // namespace
+
+namespace predictors {
+
+ResourcePrefetcher::ResourcePrefetcher(Delegate* delegate,
+                                       net::URLRequestContext* context,
+                                       size_t max_prefetches_in_flight,
+                                       const NavigationID& navigation_id,
+                                       const std::vector<GURL>& urls)
+    : delegate_(delegate),
+      context_(context),
+      max_prefetches_in_flight_(max_prefetches_in_flight),
+      navigation_id_(navigation_id),
+      pending_urls_(urls.begin(), urls.end()),
+      succeeded_count_(0) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  DCHECK_GT(max_prefetches_in_flight_, 0U);
+}
+
+ResourcePrefetcher::~ResourcePrefetcher() {
+  DCHECK(CalledOnValidThread());
+  // Deleting the requests cancels them.
+  STLDeleteElements(&inflight_requests_);
+}
+
+void ResourcePrefetcher::Start() {
+  DCHECK(CalledOnValidThread());
+  TryToLaunchPrefetchRequests();
+}
+
+void ResourcePrefetcher::TryToLaunchPrefetchRequests() {
+  while (!pending_urls_.empty() &&
+         inflight_requests_.size() < max_prefetches_in_flight_) {
+    const GURL url = pending_urls_.front();
+    pending_urls_.pop_front();
+
+    // The earliest prefetches are the most likely to be needed, so they get
+    // the higher priority, but always below the page's own requests.
+    net::URLRequest* request = new net::URLRequest(url, this, context_);
+    request->set_priority(inflight_requests_.empty() ? net::LOW :
+                                                       net::LOWEST);
+    request->set_referrer(navigation_id_.main_frame_url.spec());
+    request->set_load_flags(net::LOAD_DO_NOT_SEND_COOKIES |
+                            net::LOAD_DO_NOT_SAVE_COOKIES |
+                            net::LOAD_DO_NOT_PROMPT_FOR_LOGIN);
+    inflight_requests_.insert(request);
+    request->Start();
+  }
+
+  if (pending_urls_.empty() && inflight_requests_.empty())
+    delegate_->ResourcePrefetcherFinished(this);
+}
+
+void ResourcePrefetcher::ReadFullResponse(net::URLRequest* request) {
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kReadBufferSize));
+  int bytes_read = 0;
+  while (request->Read(buffer, kReadBufferSize, &bytes_read)) {
+    if (bytes_read == 0) {
+      FinishRequest(request, true);
+      return;
+    }
+  }
+
+  // Either the read is pending and OnReadCompleted() will be called, or it
+  // failed.
+  if (!request->status().is_io_pending())
+    FinishRequest(request, false);
+}
+
+void ResourcePrefetcher::FinishRequest(net::URLRequest* request,
+                                       bool succeeded) {
+  if (succeeded)
+    ++succeeded_count_;
+  inflight_requests_.erase(request);
+  delete request;
+
+  // May delete |this|.
+  TryToLaunchPrefetchRequests();
+}
+
+void ResourcePrefetcher::OnReceivedRedirect(net::URLRequest* request,
+                                            const GURL& new_url,
+                                            bool* defer_redirect) {
+  // Redirected resources are fetched from the new location.
+}
+
+void ResourcePrefetcher::OnAuthRequired(net::URLRequest* request,
+                                        net::AuthChallengeInfo* auth_info) {
+  FinishRequest(request, false);
+}
+
+void ResourcePrefetcher::OnCertificateRequested(
+    net::URLRequest* request,
+    net::SSLCertRequestInfo* cert_request_info) {
+  FinishRequest(request, false);
+}
+
+void ResourcePrefetcher::OnSSLCertificateError(net::URLRequest* request,
+                                               const net::SSLInfo& ssl_info,
+                                               bool fatal) {
+  FinishRequest(request, false);
+}
+
+void ResourcePrefetcher::OnResponseStarted(net::URLRequest* request) {
+  if (!request->status().is_success()) {
+    FinishRequest(request, false);
+    return;
+  }
+
+  ReadFullResponse(request);
+}
+
+void ResourcePrefetcher::OnReadCompleted(net::URLRequest* request,
+                                         int bytes_read) {
+  if (bytes_read <= 0) {
+    FinishRequest(request, bytes_read == 0);
+    return;
+  }
+
+  ReadFullResponse(request);
+}
+
+ResourcePrefetcherManager::ResourcePrefetcherManager(
+    size_t max_prefetches_in_flight,
+    net::URLRequestContextGetter* context_getter)
+    : max_prefetches_in_flight_(max_prefetches_in_flight),
+      context_getter_(context_getter) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  CHECK(context_getter_);
+}
+
+ResourcePrefetcherManager::~ResourcePrefetcherManager() {
+  DCHECK(prefetcher_map_.empty());
+}
+
+void ResourcePrefetcherManager::ShutdownOnUIThread() {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ResourcePrefetcherManager::ShutdownOnIOThread, this));
+}
+
+void ResourcePrefetcherManager::ShutdownOnIOThread() {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  STLDeleteValues(&prefetcher_map_);
+}
+
+void ResourcePrefetcherManager::MaybeAddPrefetch(
+    const NavigationID& navigation_id,
+    const std::vector<GURL>& urls) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ResourcePrefetcherManager::MaybeAddPrefetchOnIOThread,
+                 this, navigation_id, urls));
+}
+
+void ResourcePrefetcherManager::MaybeAddPrefetchOnIOThread(
+    const NavigationID& navigation_id,
+    const std::vector<GURL>& urls) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (prefetcher_map_.find(navigation_id) != prefetcher_map_.end())
+    return;
+
+  ResourcePrefetcher* prefetcher = new ResourcePrefetcher(
+      this, context_getter_->GetURLRequestContext(),
+      max_prefetches_in_flight_, navigation_id, urls);
+  prefetcher_map_.insert(std::make_pair(navigation_id, prefetcher));
+  prefetcher->Start();
+}
+
+void ResourcePrefetcherManager::MaybeRemovePrefetch(
+    const NavigationID& navigation_id) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ResourcePrefetcherManager::MaybeRemovePrefetchOnIOThread,
+                 this, navigation_id));
+}
+
+void ResourcePrefetcherManager::MaybeRemovePrefetchOnIOThread(
+    const NavigationID& navigation_id) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  PrefetcherMap::iterator it = prefetcher_map_.find(navigation_id);
+  if (it == prefetcher_map_.end())
+    return;
+
+  delete it->second;
+  prefetcher_map_.erase(it);
+}
+
+void ResourcePrefetcherManager::ResourcePrefetcherFinished(
+    ResourcePrefetcher* prefetcher) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  prefetcher_map_.erase(prefetcher->navigation_id());
+  delete prefetcher;
+}
+
+}  // namespace predictors
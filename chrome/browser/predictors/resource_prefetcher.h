@@ -0,0 +1,147 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_PREDICTORS_RESOURCE_PREFETCHER_H_
+#define CHROME_BROWSER_PREDICTORS_RESOURCE_PREFETCHER_H_
+
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/threading/non_thread_safe.h"
+#include "chrome/browser/predictors/resource_prefetch_common.h"
+#include "googleurl/src/gurl.h"
+#include "net/url_request/url_request.h"
+
+namespace net {
+class URLRequestContext;
+class URLRequestContextGetter;
+}
+
+namespace predictors {
+
+// Fetches the subresources predicted for a single navigation so that they are
+// in the HTTP cache by the time the page asks for them. The responses are read
+// and discarded. Requests are issued in the order given, which should be most
+// likely first, with a bounded number in flight at a time.
+// Lives entirely on the IO thread.
+class ResourcePrefetcher : public base::NonThreadSafe,
+                           public net::URLRequest::Delegate {
+ public:
+  class Delegate {
+   public:
+    // Called when all the prefetches have completed, successfully or not.
+    // The delegate may delete |prefetcher|.
+    virtual void ResourcePrefetcherFinished(ResourcePrefetcher* prefetcher) = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  ResourcePrefetcher(Delegate* delegate,
+                     net::URLRequestContext* context,
+                     size_t max_prefetches_in_flight,
+                     const NavigationID& navigation_id,
+                     const std::vector<GURL>& urls);
+  virtual ~ResourcePrefetcher();
+
+  // Starts the prefetches. Calls the delegate once they have all completed
+  // unless the prefetcher is deleted first, which cancels them.
+  void Start();
+
+  const NavigationID& navigation_id() const { return navigation_id_; }
+
+  // The number of prefetches whose response was read completely.
+  size_t succeeded_count() const { return succeeded_count_; }
+
+ private:
+  // Launches queued prefetches while there is room for them.
+  void TryToLaunchPrefetchRequests();
+
+  // Reads and discards the response body of |request|.
+  void ReadFullResponse(net::URLRequest* request);
+
+  // Deletes |request| and moves on to the next prefetch.
+  void FinishRequest(net::URLRequest* request, bool succeeded);
+
+  // net::URLRequest::Delegate methods.
+  virtual void OnReceivedRedirect(net::URLRequest* request,
+                                  const GURL& new_url,
+                                  bool* defer_redirect) OVERRIDE;
+  virtual void OnAuthRequired(net::URLRequest* request,
+                              net::AuthChallengeInfo* auth_info) OVERRIDE;
+  virtual void OnCertificateRequested(
+      net::URLRequest* request,
+      net::SSLCertRequestInfo* cert_request_info) OVERRIDE;
+  virtual void OnSSLCertificateError(net::URLRequest* request,
+                                     const net::SSLInfo& ssl_info,
+                                     bool fatal) OVERRIDE;
+  virtual void OnResponseStarted(net::URLRequest* request) OVERRIDE;
+  virtual void OnReadCompleted(net::URLRequest* request,
+                               int bytes_read) OVERRIDE;
+
+  Delegate* const delegate_;
+  net::URLRequestContext* const context_;
+  const size_t max_prefetches_in_flight_;
+  const NavigationID navigation_id_;
+
+  std::list<GURL> pending_urls_;
+  std::set<net::URLRequest*> inflight_requests_;
+  size_t succeeded_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourcePrefetcher);
+};
+
+// Starts and stops the ResourcePrefetchers for a profile. Prefetches are
+// requested on the UI thread and run on the IO thread.
+class ResourcePrefetcherManager
+    : public ResourcePrefetcher::Delegate,
+      public base::RefCountedThreadSafe<ResourcePrefetcherManager> {
+ public:
+  ResourcePrefetcherManager(size_t max_prefetches_in_flight,
+                            net::URLRequestContextGetter* context_getter);
+
+  // Cancels all prefetches. Must be called before the last reference is
+  // released. UI thread.
+  void ShutdownOnUIThread();
+
+  // Starts prefetching |urls| for |navigation_id| unless that navigation is
+  // already being prefetched for. UI thread.
+  void MaybeAddPrefetch(const NavigationID& navigation_id,
+                        const std::vector<GURL>& urls);
+
+  // Cancels any prefetches still running for |navigation_id|. UI thread.
+  void MaybeRemovePrefetch(const NavigationID& navigation_id);
+
+  // ResourcePrefetcher::Delegate method.
+  virtual void ResourcePrefetcherFinished(
+      ResourcePrefetcher* prefetcher) OVERRIDE;
+
+ private:
+  friend class base::RefCountedThreadSafe<ResourcePrefetcherManager>;
+
+  typedef std::map<NavigationID, ResourcePrefetcher*> PrefetcherMap;
+
+  virtual ~ResourcePrefetcherManager();
+
+  void ShutdownOnIOThread();
+  void MaybeAddPrefetchOnIOThread(const NavigationID& navigation_id,
+                                  const std::vector<GURL>& urls);
+  void MaybeRemovePrefetchOnIOThread(const NavigationID& navigation_id);
+
+  const size_t max_prefetches_in_flight_;
+  scoped_refptr<net::URLRequestContextGetter> context_getter_;
+
+  // Accessed on the IO thread only.
+  PrefetcherMap prefetcher_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourcePrefetcherManager);
+};
+
+}  // namespace predictors
+
+#endif  // CHROME_BROWSER_PREDICTORS_RESOURCE_PREFETCHER_H_
@@ -12,6 +12,7 @@ Config::Config() : max_bytes(100 * 1024 * 1024),
                    time_to_live(base::TimeDelta::FromMinutes(5)),
                    abandon_time_to_live(base::TimeDelta::FromSeconds(30)),
                    https_allowed(true),
+                   partial_prerender_enabled(true),
                    default_tab_bounds(640, 480),
                    is_overriding_user_agent(false) {
 }
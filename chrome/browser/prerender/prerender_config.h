@@ -40,6 +40,11 @@ struct Config {
   // Is https allowed?
   bool https_allowed;
 
+  // Are omnibox prerenders started as partial prerenders? A partial prerender
+  // only loads the document, scripts and stylesheets; its images, media and
+  // plugin data are held back until it is used or requested again.
+  bool partial_prerender_enabled;
+
   // The default tab bounds used as the prerenderer tab size when the active tab
   // cannot be accessed.
   gfx::Rect default_tab_bounds;
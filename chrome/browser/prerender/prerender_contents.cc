@@ -329,6 +329,13 @@ void PrerenderContents::StartPrerendering(
       route_id_,
       prerender_manager_);
 
+  // Omnibox predictions are the most likely to be wrong, so only their
+  // critical resources are fetched until the prediction is confirmed.
+  if (origin_ == ORIGIN_OMNIBOX &&
+      prerender_manager_->config().partial_prerender_enabled) {
+    prerender_tracker_->SetPartialPrerender(child_id_, route_id_, true);
+  }
+
   // Close ourselves when the application is shutting down.
   notification_registrar_.Add(this, chrome::NOTIFICATION_APP_TERMINATING,
                               content::NotificationService::AllSources());
@@ -285,7 +285,8 @@ bool IsSpeculativeResourcePrefetchingLearningEnabled(Profile* profile) {
         CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
             switches::kSpeculativeResourcePrefetching);
 
-    return switch_value == switches::kSpeculativeResourcePrefetchingLearning;
+    return switch_value == switches::kSpeculativeResourcePrefetchingLearning ||
+        switch_value == switches::kSpeculativeResourcePrefetchingEnabled;
   }
 
   const int group = FieldTrialList::FindValue(
@@ -293,4 +294,15 @@ bool IsSpeculativeResourcePrefetchingLearningEnabled(Profile* profile) {
   return group == g_speculative_prefetching_learning_default_group_number;
 }
 
+bool IsSpeculativeResourcePrefetchingEnabled(Profile* profile) {
+  if (!profile || profile->IsOffTheRecord())
+    return false;
+
+  // Prefetching is only enabled from the command line for now; the field trial
+  // only covers learning.
+  return CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+      switches::kSpeculativeResourcePrefetching) ==
+      switches::kSpeculativeResourcePrefetchingEnabled;
+}
+
 }  // namespace prerender
@@ -946,6 +946,14 @@ PrerenderHandle* PrerenderManager::AddPrerender(
   if (PrerenderData* preexisting_prerender_data =
           FindPrerenderData(url, session_storage_namespace)) {
     RecordFinalStatus(origin, experiment, FINAL_STATUS_DUPLICATE);
+    // A second request for the same page makes it likely enough to be used
+    // that a partial prerender should fetch the rest of its resources.
+    int child_id, route_id;
+    PrerenderContents* contents = preexisting_prerender_data->contents();
+    if (contents && contents->GetChildId(&child_id) &&
+        contents->GetRouteId(&route_id)) {
+      prerender_tracker_->SetPartialPrerender(child_id, route_id, false);
+    }
     return new PrerenderHandle(preexisting_prerender_data);
   }
 
@@ -0,0 +1,42 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/prerender/prerender_resource_throttle.h"
+
+#include "chrome/browser/prerender/prerender_tracker.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/resource_controller.h"
+
+using content::BrowserThread;
+
+namespace prerender {
+
+PrerenderResourceThrottle::PrerenderResourceThrottle(
+    PrerenderTracker* prerender_tracker,
+    int child_id,
+    int route_id)
+    : prerender_tracker_(prerender_tracker),
+      child_id_(child_id),
+      route_id_(route_id) {
+}
+
+PrerenderResourceThrottle::~PrerenderResourceThrottle() {
+}
+
+void PrerenderResourceThrottle::WillStartRequest(bool* defer) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!prerender_tracker_->IsPartialPrerenderOnIOThread(child_id_, route_id_))
+    return;
+
+  *defer = true;
+  prerender_tracker_->AddDeferredThrottleOnIOThread(child_id_, route_id_,
+                                                    AsWeakPtr());
+}
+
+void PrerenderResourceThrottle::Resume() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  controller()->Resume();
+}
+
+}  // namespace prerender
@@ -0,0 +1,46 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_PRERENDER_PRERENDER_RESOURCE_THROTTLE_H_
+#define CHROME_BROWSER_PRERENDER_PRERENDER_RESOURCE_THROTTLE_H_
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/weak_ptr.h"
+#include "content/public/browser/resource_throttle.h"
+
+namespace prerender {
+
+class PrerenderTracker;
+
+// Holds back a heavy subresource (image, media, plugin data) of a partial
+// prerender until the prerender is used or escalated to a full prerender, so
+// that prerenders that are not that likely to be used cost little more than
+// the main document and the resources needed to lay it out.
+class PrerenderResourceThrottle
+    : public content::ResourceThrottle,
+      public base::SupportsWeakPtr<PrerenderResourceThrottle> {
+ public:
+  PrerenderResourceThrottle(PrerenderTracker* prerender_tracker,
+                            int child_id,
+                            int route_id);
+  virtual ~PrerenderResourceThrottle();
+
+  // content::ResourceThrottle implementation:
+  virtual void WillStartRequest(bool* defer) OVERRIDE;
+
+  // Called by the PrerenderTracker when the request may go ahead.
+  void Resume();
+
+ private:
+  PrerenderTracker* prerender_tracker_;
+  const int child_id_;
+  const int route_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrerenderResourceThrottle);
+};
+
+}  // namespace prerender
+
+#endif  // CHROME_BROWSER_PRERENDER_PRERENDER_RESOURCE_THROTTLE_H_
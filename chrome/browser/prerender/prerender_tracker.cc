@@ -8,6 +8,7 @@
 #include "base/logging.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/prerender/prerender_manager.h"
+#include "chrome/browser/prerender/prerender_resource_throttle.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/resource_context.h"
@@ -56,7 +57,12 @@ PrerenderTracker::~PrerenderTracker() {
 bool PrerenderTracker::TryUse(int child_id, int route_id) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
-  return SetFinalStatus(child_id, route_id, FINAL_STATUS_USED, NULL);
+  if (!SetFinalStatus(child_id, route_id, FINAL_STATUS_USED, NULL))
+    return false;
+
+  // The page is being shown, so it needs all of its resources.
+  SetPartialPrerender(child_id, route_id, false);
+  return true;
 }
 
 bool PrerenderTracker::TryCancel(
@@ -182,6 +188,34 @@ bool PrerenderTracker::IsPrerenderingOnIOThread(int child_id,
          possibly_prerendering_io_thread_set_.find(child_route_id_pair);
 }
 
+void PrerenderTracker::SetPartialPrerender(int child_id, int route_id,
+                                           bool partial) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&SetPartialPrerenderOnIOThreadTask,
+                 ChildRouteIdPair(child_id, route_id), partial));
+}
+
+bool PrerenderTracker::IsPartialPrerenderOnIOThread(int child_id,
+                                                    int route_id) const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  ChildRouteIdPair child_route_id_pair(child_id, route_id);
+  return partial_prerender_io_thread_map_.end() !=
+         partial_prerender_io_thread_map_.find(child_route_id_pair);
+}
+
+void PrerenderTracker::AddDeferredThrottleOnIOThread(
+    int child_id, int route_id,
+    const base::WeakPtr<PrerenderResourceThrottle>& throttle) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  DCHECK(IsPartialPrerenderOnIOThread(child_id, route_id));
+
+  partial_prerender_io_thread_map_[ChildRouteIdPair(child_id, route_id)]
+      .push_back(throttle);
+}
+
 void PrerenderTracker::AddPrerenderOnIOThread(
     const ChildRouteIdPair& child_route_id_pair) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -198,6 +232,38 @@ void PrerenderTracker::RemovePrerenderOnIOThread(
                                   child_route_id_pair.second));
 
   possibly_prerendering_io_thread_set_.erase(child_route_id_pair);
+
+  // A prerender that was used has already been escalated, and the requests
+  // of one that was cancelled are cancelled along with its RenderView.
+  partial_prerender_io_thread_map_.erase(child_route_id_pair);
+}
+
+void PrerenderTracker::SetPartialPrerenderOnIOThread(
+    const ChildRouteIdPair& child_route_id_pair, bool partial) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  if (partial) {
+    // The prerender may have finished before this task ran.
+    if (IsPrerenderingOnIOThread(child_route_id_pair.first,
+                                 child_route_id_pair.second)) {
+      partial_prerender_io_thread_map_[child_route_id_pair];
+    }
+    return;
+  }
+
+  PartialPrerenderMap::iterator it =
+      partial_prerender_io_thread_map_.find(child_route_id_pair);
+  if (it == partial_prerender_io_thread_map_.end())
+    return;
+
+  DeferredThrottles throttles;
+  throttles.swap(it->second);
+  partial_prerender_io_thread_map_.erase(it);
+  for (DeferredThrottles::iterator throttle = throttles.begin();
+       throttle != throttles.end(); ++throttle) {
+    if (*throttle)
+      (*throttle)->Resume();
+  }
 }
 
 // static
@@ -217,4 +283,10 @@ void PrerenderTracker::RemovePrerenderOnIOThreadTask(
   GetDefault()->RemovePrerenderOnIOThread(child_route_id_pair);
 }
 
+// static
+void PrerenderTracker::SetPartialPrerenderOnIOThreadTask(
+    const ChildRouteIdPair& child_route_id_pair, bool partial) {
+  GetDefault()->SetPartialPrerenderOnIOThread(child_route_id_pair, partial);
+}
+
 }  // namespace prerender
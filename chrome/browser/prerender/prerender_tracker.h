@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/gtest_prod_util.h"
+#include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/non_thread_safe.h"
 #include "chrome/browser/prerender/prerender_final_status.h"
@@ -18,6 +19,7 @@
 namespace prerender {
 
 class PrerenderManager;
+class PrerenderResourceThrottle;
 struct RenderViewInfo;
 
 // PrerenderTracker is responsible for keeping track of all prerendering
@@ -66,6 +68,22 @@ class PrerenderTracker {
   // been displayed or destroyed is still prerendering.
   bool IsPrerenderingOnIOThread(int child_id, int route_id) const;
 
+  // Marks the specified prerendering RenderView as a partial prerender, which
+  // holds back its heavy subresources (see PrerenderResourceThrottle), or
+  // escalates it to a full prerender, which releases them.  Can only be called
+  // on the UI thread.
+  void SetPartialPrerender(int child_id, int route_id, bool partial);
+
+  // Returns whether the specified RenderView is a partial prerender.  Can only
+  // be called on the IO thread.
+  bool IsPartialPrerenderOnIOThread(int child_id, int route_id) const;
+
+  // Holds back |throttle| until the specified partial prerender is used or
+  // escalated.  Can only be called on the IO thread.
+  void AddDeferredThrottleOnIOThread(
+      int child_id, int route_id,
+      const base::WeakPtr<PrerenderResourceThrottle>& throttle);
+
  private:
   friend class PrerenderContents;
   FRIEND_TEST_ALL_PREFIXES(PrerenderTrackerTest, PrerenderTrackerNull);
@@ -74,12 +92,20 @@ class PrerenderTracker {
   FRIEND_TEST_ALL_PREFIXES(PrerenderTrackerTest, PrerenderTrackerCancelledOnIO);
   FRIEND_TEST_ALL_PREFIXES(PrerenderTrackerTest, PrerenderTrackerCancelledFast);
   FRIEND_TEST_ALL_PREFIXES(PrerenderTrackerTest, PrerenderTrackerMultiple);
+  FRIEND_TEST_ALL_PREFIXES(PrerenderTrackerTest, PrerenderTrackerPartialUsed);
+  FRIEND_TEST_ALL_PREFIXES(PrerenderTrackerTest,
+                           PrerenderTrackerPartialCancelled);
 
   typedef std::pair<int, int> ChildRouteIdPair;
   // Map of child/route id pairs to final statuses.
   typedef std::map<ChildRouteIdPair, RenderViewInfo> FinalStatusMap;
   // Set of child/route id pairs that may be prerendering.
   typedef std::set<ChildRouteIdPair> PossiblyPrerenderingChildRouteIdPairs;
+  // Map of the child/route id pairs of partial prerenders to the throttles
+  // they are holding back.
+  typedef std::vector<base::WeakPtr<PrerenderResourceThrottle> >
+      DeferredThrottles;
+  typedef std::map<ChildRouteIdPair, DeferredThrottles> PartialPrerenderMap;
 
   // Must be called when a RenderView starts prerendering, before the first
   // navigation starts to avoid any races.
@@ -111,12 +137,16 @@ class PrerenderTracker {
   // the IO Thread.
   void AddPrerenderOnIOThread(const ChildRouteIdPair& child_route_id_pair);
   void RemovePrerenderOnIOThread(const ChildRouteIdPair& child_route_id_pair);
+  void SetPartialPrerenderOnIOThread(
+      const ChildRouteIdPair& child_route_id_pair, bool partial);
 
   // Tasks posted to the IO Thread to call the above functions.
   static void AddPrerenderOnIOThreadTask(
       const ChildRouteIdPair& child_route_id_pair);
   static void RemovePrerenderOnIOThreadTask(
       const ChildRouteIdPair& child_route_id_pair);
+  static void SetPartialPrerenderOnIOThreadTask(
+      const ChildRouteIdPair& child_route_id_pair, bool partial);
 
   static PrerenderTracker* GetDefault();
 
@@ -132,6 +162,10 @@ class PrerenderTracker {
   // used to prevent locking when not needed.
   PossiblyPrerenderingChildRouteIdPairs possibly_prerendering_io_thread_set_;
 
+  // Partial prerenders and the requests they hold back.  Can only access on
+  // the IO thread.
+  PartialPrerenderMap partial_prerender_io_thread_map_;
+
   DISALLOW_COPY_AND_ASSIGN(PrerenderTracker);
 };
 
@@ -295,4 +295,36 @@ TEST_F(PrerenderTrackerTest, PrerenderTrackerMultiple) {
   EXPECT_FALSE(prerender_tracker()->IsPrerenderingOnIOThread(1, 2));
 }
 
+// Partial prerenders are escalated to full prerenders when used.
+TEST_F(PrerenderTrackerTest, PrerenderTrackerPartialUsed) {
+  prerender_tracker()->OnPrerenderingStarted(0, 0, prerender_manager());
+  prerender_tracker()->SetPartialPrerender(0, 0, true);
+
+  // This calls AddPrerenderOnIOThreadTask() and
+  // SetPartialPrerenderOnIOThreadTask().
+  RunEvents();
+  EXPECT_TRUE(prerender_tracker()->IsPartialPrerenderOnIOThread(0, 0));
+  EXPECT_FALSE(prerender_tracker()->IsPartialPrerenderOnIOThread(1, 2));
+
+  EXPECT_TRUE(prerender_tracker()->TryUse(0, 0));
+  RunEvents();
+  EXPECT_FALSE(prerender_tracker()->IsPartialPrerenderOnIOThread(0, 0));
+
+  prerender_tracker()->OnPrerenderingFinished(0, 0);
+  RunEvents();
+}
+
+// Partial prerenders that finish are no longer tracked as partial.
+TEST_F(PrerenderTrackerTest, PrerenderTrackerPartialCancelled) {
+  prerender_tracker()->OnPrerenderingStarted(0, 0, prerender_manager());
+  prerender_tracker()->SetPartialPrerender(0, 0, true);
+  RunEvents();
+  EXPECT_TRUE(prerender_tracker()->IsPartialPrerenderOnIOThread(0, 0));
+
+  EXPECT_TRUE(prerender_tracker()->TryCancel(0, 0, FINAL_STATUS_HTTPS));
+  prerender_tracker()->OnPrerenderingFinished(0, 0);
+  RunEvents();
+  EXPECT_FALSE(prerender_tracker()->IsPartialPrerenderOnIOThread(0, 0));
+}
+
 }  // namespace prerender
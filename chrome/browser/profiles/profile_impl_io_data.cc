@@ -33,9 +33,11 @@
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/resource_context.h"
 #include "content/public/browser/storage_partition.h"
+#include "net/base/sdch_manager.h"
 #include "net/base/server_bound_cert_service.h"
 #include "net/ftp/ftp_network_layer.h"
 #include "net/http/http_cache.h"
+#include "net/http/sdch_dictionary_cache.h"
 #include "net/url_request/url_request_job_factory_impl.h"
 #include "webkit/quota/special_storage_policy.h"
 
@@ -433,6 +435,14 @@ void ProfileImplIOData::LazyInitializeInternal(
   main_http_factory_.reset(main_cache);
   main_context->set_http_transaction_factory(main_cache);
 
+  // SDCH dictionaries are shared by all profiles. Keep them in the disk cache
+  // of the first profile, so that they are available after a restart.
+  net::SdchManager* sdch_manager = net::SdchManager::Global();
+  if (sdch_manager && !sdch_manager->has_dictionary_store()) {
+    sdch_manager->set_dictionary_store(
+        new net::SdchDictionaryCache(main_cache));
+  }
+
 #if !defined(DISABLE_FTP_SUPPORT)
   ftp_factory_.reset(
       new net::FtpNetworkLayer(io_thread_globals->host_resolver.get()));
@@ -19,6 +19,7 @@
 #include "chrome/browser/net/load_timing_observer.h"
 #include "chrome/browser/net/resource_prefetch_predictor_observer.h"
 #include "chrome/browser/prerender/prerender_manager.h"
+#include "chrome/browser/prerender/prerender_resource_throttle.h"
 #include "chrome/browser/prerender/prerender_tracker.h"
 #include "chrome/browser/profiles/profile_io_data.h"
 #include "chrome/browser/renderer_host/chrome_url_request_user_data.h"
@@ -153,6 +154,17 @@ void ChromeResourceDispatcherHostDelegate::RequestBeginning(
                                   resource_type,
                                   throttles);
 
+  // Partial prerenders hold back the resources that are not needed to lay out
+  // the page.
+  if (user_data->is_prerender() &&
+      (resource_type == ResourceType::IMAGE ||
+       resource_type == ResourceType::MEDIA ||
+       resource_type == ResourceType::OBJECT ||
+       resource_type == ResourceType::FAVICON)) {
+    throttles->push_back(new prerender::PrerenderResourceThrottle(
+        prerender_tracker_, child_id, route_id));
+  }
+
   ProfileIOData* io_data = ProfileIOData::FromResourceContext(resource_context);
   if (io_data->resource_prefetch_predictor_observer()) {
     io_data->resource_prefetch_predictor_observer()->OnRequestStarted(
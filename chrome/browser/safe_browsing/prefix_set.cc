@@ -39,19 +39,24 @@ bool PrefixLess(const std::pair<SBPrefix,size_t>& a,
 
 namespace safe_browsing {
 
-PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
+PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes)
+    : index_(NULL),
+      index_size_(0),
+      deltas_(NULL),
+      deltas_size_(0) {
   if (sorted_prefixes.size()) {
     // Estimate the resulting vector sizes.  There will be strictly
-    // more than |min_runs| entries in |index_|, but there generally
-    // aren't many forced breaks.
+    // more than |min_runs| entries in |index_storage_|, but there
+    // generally aren't many forced breaks.
     const size_t min_runs = sorted_prefixes.size() / kMaxRun;
-    index_.reserve(min_runs);
-    deltas_.reserve(sorted_prefixes.size() - min_runs);
+    index_storage_.reserve(min_runs);
+    deltas_storage_.reserve(sorted_prefixes.size() - min_runs);
 
     // Lead with the first prefix.
     SBPrefix prev_prefix = sorted_prefixes[0];
     size_t run_length = 0;
-    index_.push_back(std::make_pair(prev_prefix, deltas_.size()));
+    index_storage_.push_back(
+        std::make_pair(prev_prefix, deltas_storage_.size()));
 
     for (size_t i = 1; i < sorted_prefixes.size(); ++i) {
       // Skip duplicates.
@@ -67,23 +72,29 @@ PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
       // New index ref if the delta doesn't fit, or if too many
       // consecutive deltas have been encoded.
       if (delta != static_cast<unsigned>(delta16) || run_length >= kMaxRun) {
-        index_.push_back(std::make_pair(sorted_prefixes[i], deltas_.size()));
+        index_storage_.push_back(
+            std::make_pair(sorted_prefixes[i], deltas_storage_.size()));
         run_length = 0;
       } else {
         // Continue the run of deltas.
-        deltas_.push_back(delta16);
-        DCHECK_EQ(static_cast<unsigned>(deltas_.back()), delta);
+        deltas_storage_.push_back(delta16);
+        DCHECK_EQ(static_cast<unsigned>(deltas_storage_.back()), delta);
         ++run_length;
       }
 
       prev_prefix = sorted_prefixes[i];
     }
 
+    index_ = &index_storage_[0];
+    index_size_ = index_storage_.size();
+    deltas_ = deltas_storage_.empty() ? NULL : &deltas_storage_[0];
+    deltas_size_ = deltas_storage_.size();
+
     // Send up some memory-usage stats.  Bits because fractional bytes
     // are weird.
-    const size_t bits_used = index_.size() * sizeof(index_[0]) * CHAR_BIT +
-        deltas_.size() * sizeof(deltas_[0]) * CHAR_BIT;
-    const size_t unique_prefixes = index_.size() + deltas_.size();
+    const size_t bits_used = index_size_ * sizeof(index_[0]) * CHAR_BIT +
+        deltas_size_ * sizeof(deltas_[0]) * CHAR_BIT;
+    const size_t unique_prefixes = index_size_ + deltas_size_;
     static const size_t kMaxBitsPerPrefix = sizeof(SBPrefix) * CHAR_BIT;
     UMA_HISTOGRAM_ENUMERATION("SB2.PrefixSetBitsPerPrefix",
                               bits_used / unique_prefixes,
@@ -91,31 +102,38 @@ PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
   }
 }
 
-PrefixSet::PrefixSet(std::vector<std::pair<SBPrefix,size_t> > *index,
-                     std::vector<uint16> *deltas) {
-  DCHECK(index && deltas);
-  index_.swap(*index);
-  deltas_.swap(*deltas);
+PrefixSet::PrefixSet(file_util::MemoryMappedFile* mapped_file,
+                     const std::pair<SBPrefix,size_t>* index,
+                     size_t index_size,
+                     const uint16* deltas,
+                     size_t deltas_size)
+    : index_(index),
+      index_size_(index_size),
+      deltas_(deltas),
+      deltas_size_(deltas_size),
+      mapped_file_(mapped_file) {
+  DCHECK(mapped_file);
 }
 
 PrefixSet::~PrefixSet() {}
 
 bool PrefixSet::Exists(SBPrefix prefix) const {
-  if (index_.empty())
+  if (!index_size_)
     return false;
 
   // Find the first position after |prefix| in |index_|.
-  std::vector<std::pair<SBPrefix,size_t> >::const_iterator
-      iter = std::upper_bound(index_.begin(), index_.end(),
-                              std::pair<SBPrefix,size_t>(prefix, 0),
-                              PrefixLess);
+  const std::pair<SBPrefix,size_t>* const index_end = index_ + index_size_;
+  const std::pair<SBPrefix,size_t>* iter =
+      std::upper_bound(index_, index_end,
+                       std::pair<SBPrefix,size_t>(prefix, 0),
+                       PrefixLess);
 
   // |prefix| comes before anything that's in the set.
-  if (iter == index_.begin())
+  if (iter == index_)
     return false;
 
   // Capture the upper bound of our target entry's deltas.
-  const size_t bound = (iter == index_.end() ? deltas_.size() : iter->second);
+  const size_t bound = (iter == index_end ? deltas_size_ : iter->second);
 
   // Back up to the entry our target is in.
   --iter;
@@ -134,13 +152,13 @@ bool PrefixSet::Exists(SBPrefix prefix) const {
 }
 
 void PrefixSet::GetPrefixes(std::vector<SBPrefix>* prefixes) const {
-  prefixes->reserve(index_.size() + deltas_.size());
+  prefixes->reserve(index_size_ + deltas_size_);
 
-  for (size_t ii = 0; ii < index_.size(); ++ii) {
+  for (size_t ii = 0; ii < index_size_; ++ii) {
     // The deltas for this |index_| entry run to the next index entry,
     // or the end of the deltas.
     const size_t deltas_end =
-        (ii + 1 < index_.size()) ? index_[ii + 1].second : deltas_.size();
+        (ii + 1 < index_size_) ? index_[ii + 1].second : deltas_size_;
 
     SBPrefix current = index_[ii].first;
     prefixes->push_back(current);
@@ -153,92 +171,68 @@ void PrefixSet::GetPrefixes(std::vector<SBPrefix>* prefixes) const {
 
 // static
 PrefixSet* PrefixSet::LoadFile(const FilePath& filter_name) {
-  int64 size_64;
-  if (!file_util::GetFileSize(filter_name, &size_64))
-    return NULL;
-  using base::MD5Digest;
-  if (size_64 < static_cast<int64>(sizeof(FileHeader) + sizeof(MD5Digest)))
+  scoped_ptr<file_util::MemoryMappedFile> mapped_file(
+      new file_util::MemoryMappedFile);
+  if (!mapped_file->Initialize(filter_name))
     return NULL;
 
-  file_util::ScopedFILE file(file_util::OpenFile(filter_name, "rb"));
-  if (!file.get())
+  using base::MD5Digest;
+  const uint8* data = mapped_file->data();
+  const size_t size = mapped_file->length();
+  if (size < sizeof(FileHeader) + sizeof(MD5Digest))
     return NULL;
 
   FileHeader header;
-  size_t read = fread(&header, sizeof(header), 1, file.get());
-  if (read != 1)
-    return NULL;
-
+  memcpy(&header, data, sizeof(header));
   if (header.magic != kMagic || header.version != kVersion)
     return NULL;
 
-  std::vector<std::pair<SBPrefix,size_t> > index;
-  const size_t index_bytes = sizeof(index[0]) * header.index_size;
+  const size_t index_bytes =
+      sizeof(std::pair<SBPrefix,size_t>) * header.index_size;
+  const size_t deltas_bytes = sizeof(uint16) * header.deltas_size;
 
-  std::vector<uint16> deltas;
-  const size_t deltas_bytes = sizeof(deltas[0]) * header.deltas_size;
-
-  // Check for bogus sizes before allocating any space.
+  // Check for bogus sizes before touching any of the payload.
   const size_t expected_bytes =
       sizeof(header) + index_bytes + deltas_bytes + sizeof(MD5Digest);
-  if (static_cast<int64>(expected_bytes) != size_64)
+  if (expected_bytes != size)
     return NULL;
 
-  // The file looks valid, start building the digest.
-  base::MD5Context context;
-  base::MD5Init(&context);
-  base::MD5Update(&context, base::StringPiece(reinterpret_cast<char*>(&header),
-                                              sizeof(header)));
-
-  // Read the index vector.  Herb Sutter indicates that vectors are
-  // guaranteed to be contiuguous, so reading to where element 0 lives
-  // is valid.
-  if (header.index_size) {
-    index.resize(header.index_size);
-    read = fread(&(index[0]), sizeof(index[0]), index.size(), file.get());
-    if (read != index.size())
-      return NULL;
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(index[0])),
-                                      index_bytes));
-  }
-
-  // Read vector of deltas.
-  if (header.deltas_size) {
-    deltas.resize(header.deltas_size);
-    read = fread(&(deltas[0]), sizeof(deltas[0]), deltas.size(), file.get());
-    if (read != deltas.size())
-      return NULL;
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(deltas[0])),
-                                      deltas_bytes));
-  }
-
+  // Everything but the trailing digest is covered by the digest.
+  const size_t digested_bytes = size - sizeof(MD5Digest);
   base::MD5Digest calculated_digest;
-  base::MD5Final(&calculated_digest, &context);
-
-  base::MD5Digest file_digest;
-  read = fread(&file_digest, sizeof(file_digest), 1, file.get());
-  if (read != 1)
-    return NULL;
-
-  if (0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest)))
+  base::MD5Sum(data, digested_bytes, &calculated_digest);
+  if (0 != memcmp(data + digested_bytes, &calculated_digest,
+                  sizeof(calculated_digest))) {
     return NULL;
+  }
 
-  // Steals contents of |index| and |deltas| via swap().
-  return new PrefixSet(&index, &deltas);
+  // The mapping is page-aligned and the header is a multiple of the
+  // pair's alignment, so the index can be used in place.  The deltas
+  // follow the index, which keeps them 2-byte aligned.
+  const std::pair<SBPrefix,size_t>* index =
+      reinterpret_cast<const std::pair<SBPrefix,size_t>*>(
+          data + sizeof(header));
+  const uint16* deltas =
+      reinterpret_cast<const uint16*>(data + sizeof(header) + index_bytes);
+  DCHECK_EQ(0u, reinterpret_cast<uintptr_t>(index) %
+            sizeof(index[0].second));
+
+  return new PrefixSet(mapped_file.release(),
+                       header.index_size ? index : NULL, header.index_size,
+                       header.deltas_size ? deltas : NULL,
+                       header.deltas_size);
 }
 
 bool PrefixSet::WriteFile(const FilePath& filter_name) const {
   FileHeader header;
   header.magic = kMagic;
   header.version = kVersion;
-  header.index_size = static_cast<uint32>(index_.size());
-  header.deltas_size = static_cast<uint32>(deltas_.size());
+  header.index_size = static_cast<uint32>(index_size_);
+  header.deltas_size = static_cast<uint32>(deltas_size_);
 
   // Sanity check that the 32-bit values never mess things up.
-  if (static_cast<size_t>(header.index_size) != index_.size() ||
-      static_cast<size_t>(header.deltas_size) != deltas_.size()) {
+  if (static_cast<size_t>(header.index_size) != index_size_ ||
+      static_cast<size_t>(header.deltas_size) != deltas_size_) {
     NOTREACHED();
     return false;
   }
@@ -258,30 +252,24 @@ bool PrefixSet::WriteFile(const FilePath& filter_name) const {
   base::MD5Update(&context, base::StringPiece(reinterpret_cast<char*>(&header),
                                               sizeof(header)));
 
-  // As for reads, the standard guarantees the ability to access the
-  // contents of the vector by a pointer to an element.
-  if (index_.size()) {
-    const size_t index_bytes = sizeof(index_[0]) * index_.size();
-    written = fwrite(&(index_[0]), sizeof(index_[0]), index_.size(),
-                     file.get());
-    if (written != index_.size())
+  if (index_size_) {
+    const size_t index_bytes = sizeof(index_[0]) * index_size_;
+    written = fwrite(index_, sizeof(index_[0]), index_size_, file.get());
+    if (written != index_size_)
       return false;
     base::MD5Update(&context,
-                    base::StringPiece(
-                        reinterpret_cast<const char*>(&(index_[0])),
-                        index_bytes));
+                    base::StringPiece(reinterpret_cast<const char*>(index_),
+                                      index_bytes));
   }
 
-  if (deltas_.size()) {
-    const size_t deltas_bytes = sizeof(deltas_[0]) * deltas_.size();
-    written = fwrite(&(deltas_[0]), sizeof(deltas_[0]), deltas_.size(),
-                     file.get());
-    if (written != deltas_.size())
+  if (deltas_size_) {
+    const size_t deltas_bytes = sizeof(deltas_[0]) * deltas_size_;
+    written = fwrite(deltas_, sizeof(deltas_[0]), deltas_size_, file.get());
+    if (written != deltas_size_)
       return false;
     base::MD5Update(&context,
-                    base::StringPiece(
-                        reinterpret_cast<const char*>(&(deltas_[0])),
-                        deltas_bytes));
+                    base::StringPiece(reinterpret_cast<const char*>(deltas_),
+                                      deltas_bytes));
   }
 
   base::MD5Digest digest;
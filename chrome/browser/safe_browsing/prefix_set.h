@@ -13,7 +13,7 @@
 //  5, 16, 65391 in |deltas_|.
 //  A pair {150000, 3} in |index_|.
 //  10000 in |deltas_|.
-// |index_.size()| will be 2, |deltas_.size()| will be 4.
+// |index_size_| will be 2, |deltas_size_| will be 4.
 //
 // This structure is intended for storage of sparse uniform sets of
 // prefixes of a certain size.  As of this writing, my safe-browsing
@@ -40,21 +40,32 @@
 // The on-disk format looks like:
 //         4 byte magic number
 //         4 byte version number
-//         4 byte |index_.size()|
-//         4 byte |deltas_.size()|
+//         4 byte |index_size_|
+//         4 byte |deltas_size_|
 //     n * 8 byte |&index_[0]..&index_[n]|
 //     m * 2 byte |&deltas_[0]..&deltas_[m]|
 //        16 byte digest
+//
+// |LoadFile()| maps the file into memory and uses the index and deltas
+// in place rather than copying them to the heap.  The pages are backed
+// by the file, so they can be shared and discarded under memory
+// pressure.  Since the file stays mapped for the life of the set, it
+// must not be rewritten or deleted until the set has been destroyed.
 
 #ifndef CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 #define CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "chrome/browser/safe_browsing/safe_browsing_util.h"
 
 class FilePath;
 
+namespace file_util {
+class MemoryMappedFile;
+}
+
 namespace safe_browsing {
 
 class PrefixSet {
@@ -79,21 +90,33 @@ class PrefixSet {
   // for |Exists()| under control.
   static const size_t kMaxRun = 100;
 
-  // Helper for |LoadFile()|.  Steals the contents of |index| and
-  // |deltas| using |swap()|.
-  PrefixSet(std::vector<std::pair<SBPrefix,size_t> > *index,
-            std::vector<uint16> *deltas);
+  // Helper for |LoadFile()|.  Takes ownership of |mapped_file|, which
+  // |index| and |deltas| point into.
+  PrefixSet(file_util::MemoryMappedFile* mapped_file,
+            const std::pair<SBPrefix,size_t>* index, size_t index_size,
+            const uint16* deltas, size_t deltas_size);
 
   // Top-level index of prefix to offset in |deltas_|.  Each pair
   // indicates a base prefix and where the deltas from that prefix
   // begin in |deltas_|.  The deltas for a pair end at the next pair's
-  // index into |deltas_|.
-  std::vector<std::pair<SBPrefix,size_t> > index_;
+  // index into |deltas_|.  Points into |index_storage_| or
+  // |mapped_file_|.
+  const std::pair<SBPrefix,size_t>* index_;
+  size_t index_size_;
 
   // Deltas which are added to the prefix in |index_| to generate
   // prefixes.  Deltas are only valid between consecutive items from
   // |index_|, or the end of |deltas_| for the last |index_| pair.
-  std::vector<uint16> deltas_;
+  // Points into |deltas_storage_| or |mapped_file_|.
+  const uint16* deltas_;
+  size_t deltas_size_;
+
+  // Backing store for sets built by the public constructor.
+  std::vector<std::pair<SBPrefix,size_t> > index_storage_;
+  std::vector<uint16> deltas_storage_;
+
+  // Backing store for sets read by |LoadFile()|.
+  scoped_ptr<file_util::MemoryMappedFile> mapped_file_;
 
   DISALLOW_COPY_AND_ASSIGN(PrefixSet);
 };
@@ -0,0 +1,86 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <limits.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/rand_util.h"
+#include "base/scoped_temp_dir.h"
+#include "chrome/browser/safe_browsing/prefix_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Roughly the number of add prefixes in a current safe-browsing
+// database (see prefix_set.h).
+const size_t kPrefixCount = 650000;
+
+// Number of lookups timed.  Nearly all of them miss, as in practice.
+const size_t kLookupCount = 1000000;
+
+std::vector<SBPrefix> RandomPrefixes(size_t count) {
+  std::vector<SBPrefix> prefixes;
+  prefixes.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    prefixes.push_back(static_cast<SBPrefix>(base::RandUint64()));
+  return prefixes;
+}
+
+size_t CountHits(const safe_browsing::PrefixSet& prefix_set,
+                 const std::vector<SBPrefix>& lookups) {
+  size_t hits = 0;
+  for (size_t i = 0; i < lookups.size(); ++i) {
+    if (prefix_set.Exists(lookups[i]))
+      ++hits;
+  }
+  return hits;
+}
+
+}  // namespace
+
+// Measures building, persisting, loading and querying a full-size set.
+TEST(PrefixSetPerfTest, BuildLoadQuery) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath filename = temp_dir.path().AppendASCII("PrefixSetPerfTest");
+
+  std::vector<SBPrefix> prefixes = RandomPrefixes(kPrefixCount);
+  std::sort(prefixes.begin(), prefixes.end());
+  const std::vector<SBPrefix> lookups = RandomPrefixes(kLookupCount);
+
+  size_t built_hits = 0;
+  {
+    PerfTimeLogger build_timer("PrefixSet_build");
+    safe_browsing::PrefixSet prefix_set(prefixes);
+    build_timer.Done();
+
+    PerfTimeLogger query_timer("PrefixSet_query_built");
+    built_hits = CountHits(prefix_set, lookups);
+    query_timer.Done();
+
+    ASSERT_TRUE(prefix_set.WriteFile(filename));
+  }
+
+  int64 file_size = 0;
+  ASSERT_TRUE(file_util::GetFileSize(filename, &file_size));
+  LogPerfResult("PrefixSet_bits_per_prefix",
+                file_size * CHAR_BIT / static_cast<double>(kPrefixCount),
+                "bits");
+
+  PerfTimeLogger load_timer("PrefixSet_load");
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  load_timer.Done();
+  ASSERT_TRUE(prefix_set.get());
+
+  PerfTimeLogger query_timer("PrefixSet_query_loaded");
+  const size_t loaded_hits = CountHits(*prefix_set, lookups);
+  query_timer.Done();
+  EXPECT_EQ(built_hits, loaded_hits);
+}
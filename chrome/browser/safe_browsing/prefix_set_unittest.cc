@@ -349,6 +349,29 @@ TEST_F(PrefixSetTest, ReadWrite) {
   }
 }
 
+// Test that a set loaded from disk, which uses the file's mapped
+// contents in place, can itself be written out and read back.
+TEST_F(PrefixSetTest, WriteLoaded) {
+  FilePath filename;
+  ASSERT_TRUE(GetPrefixSetFile(&filename));
+
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+
+  const FilePath copy_filename =
+      filename.DirName().AppendASCII("PrefixSetTestCopy");
+  ASSERT_TRUE(prefix_set->WriteFile(copy_filename));
+  prefix_set.reset();
+
+  // The original file is no longer mapped, so it can be removed.
+  ASSERT_TRUE(file_util::Delete(filename, false));
+
+  prefix_set.reset(safe_browsing::PrefixSet::LoadFile(copy_filename));
+  ASSERT_TRUE(prefix_set.get());
+  CheckPrefixes(*prefix_set, shared_prefixes_);
+}
+
 // Check that |CleanChecksum()| makes an acceptable checksum.
 TEST_F(PrefixSetTest, CorruptionHelpers) {
   FilePath filename;
@@ -79,19 +79,27 @@ int EncodeChunkId(const int chunk, const int list_id) {
   return chunk << 1 | list_id % 2;
 }
 
+// Maximum number of entries in |browse_host_hash_cache_|.  The cache
+// is simply cleared when it fills up.
+const size_t kMaxBrowseHostHashCacheSize = 200;
+
 // Generate the set of full hashes to check for |url|.  If
 // |include_whitelist_hashes| is true we will generate additional path-prefixes
 // to match against the csd whitelist.  E.g., if the path-prefix /foo is on the
 // whitelist it should also match /foo/bar which is not the case for all the
 // other lists.  We'll also always add a pattern for the empty path.
+// If |host_hashes| is non-NULL, the hashes of the "host/" patterns are
+// looked up there and added to it, rather than always recomputed.
 // TODO(shess): This function is almost the same as
 // |CompareFullHashes()| in safe_browsing_util.cc, except that code
 // does an early exit on match.  Since match should be the infrequent
 // case (phishing or malware found), consider combining this function
 // with that one.
-void BrowseFullHashesToCheck(const GURL& url,
-                             bool include_whitelist_hashes,
-                             std::vector<SBFullHash>* full_hashes) {
+void BrowseFullHashesToCheck(
+    const GURL& url,
+    bool include_whitelist_hashes,
+    std::map<std::string, SBFullHash>* host_hashes,
+    std::vector<SBFullHash>* full_hashes) {
   std::vector<std::string> hosts;
   if (url.HostIsIPAddress()) {
     hosts.push_back(url.host());
@@ -106,8 +114,22 @@ void BrowseFullHashesToCheck(const GURL& url,
     for (size_t j = 0; j < paths.size(); ++j) {
       const std::string& path = paths[j];
       SBFullHash full_hash;
-      crypto::SHA256HashString(hosts[i] + path, &full_hash,
-                               sizeof(full_hash));
+      if (host_hashes && path == "/") {
+        std::map<std::string, SBFullHash>::const_iterator iter =
+            host_hashes->find(hosts[i]);
+        if (iter != host_hashes->end()) {
+          full_hashes->push_back(iter->second);
+          continue;
+        }
+        if (host_hashes->size() >= kMaxBrowseHostHashCacheSize)
+          host_hashes->clear();
+        crypto::SHA256HashString(hosts[i] + path, &full_hash,
+                                 sizeof(full_hash));
+        (*host_hashes)[hosts[i]] = full_hash;
+      } else {
+        crypto::SHA256HashString(hosts[i] + path, &full_hash,
+                                 sizeof(full_hash));
+      }
       full_hashes->push_back(full_hash);
 
       // We may have /foo as path-prefix in the whitelist which should
@@ -129,7 +151,7 @@ void GetDownloadUrlPrefixes(const std::vector<GURL>& urls,
                             std::vector<SBPrefix>* prefixes) {
   std::vector<SBFullHash> full_hashes;
   for (size_t i = 0; i < urls.size(); ++i)
-    BrowseFullHashesToCheck(urls[i], false, &full_hashes);
+    BrowseFullHashesToCheck(urls[i], false, NULL, &full_hashes);
 
   for (size_t i = 0; i < full_hashes.size(); ++i)
     prefixes->push_back(full_hashes[i].prefix);
@@ -401,6 +423,9 @@ SafeBrowsingDatabaseNew::SafeBrowsingDatabaseNew()
   DCHECK(!download_store_.get());
   DCHECK(!csd_whitelist_store_.get());
   DCHECK(!download_whitelist_store_.get());
+
+  // |ContainsBrowseUrl()| is called on the IO thread.
+  browse_lookup_thread_checker_.DetachFromThread();
 }
 
 SafeBrowsingDatabaseNew::SafeBrowsingDatabaseNew(
@@ -416,6 +441,9 @@ SafeBrowsingDatabaseNew::SafeBrowsingDatabaseNew(
       ALLOW_THIS_IN_INITIALIZER_LIST(reset_factory_(this)),
       corruption_detected_(false) {
   DCHECK(browse_store_.get());
+
+  // |ContainsBrowseUrl()| is called on the IO thread.
+  browse_lookup_thread_checker_.DetachFromThread();
 }
 
 SafeBrowsingDatabaseNew::~SafeBrowsingDatabaseNew() {
@@ -499,6 +527,13 @@ void SafeBrowsingDatabaseNew::Init(const FilePath& filename_base) {
 bool SafeBrowsingDatabaseNew::ResetDatabase() {
   DCHECK_EQ(creation_loop_, MessageLoop::current());
 
+  // The prefix set maps its file, which must be released before the
+  // file can be deleted on Windows.
+  {
+    base::AutoLock locked(lookup_lock_);
+    prefix_set_.reset();
+  }
+
   // Delete files on disk.
   // TODO(shess): Hard to see where one might want to delete without a
   // reset.  Perhaps inline |Delete()|?
@@ -533,8 +568,10 @@ bool SafeBrowsingDatabaseNew::ContainsBrowseUrl(
   prefix_hits->clear();
   full_hits->clear();
 
+  DCHECK(browse_lookup_thread_checker_.CalledOnValidThread());
   std::vector<SBFullHash> full_hashes;
-  BrowseFullHashesToCheck(url, false, &full_hashes);
+  BrowseFullHashesToCheck(url, false, &browse_host_hash_cache_,
+                          &full_hashes);
   if (full_hashes.empty())
     return false;
 
@@ -633,13 +670,13 @@ bool SafeBrowsingDatabaseNew::ContainsCsdWhitelistedUrl(const GURL& url) {
   // originate from the IO thread.
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   std::vector<SBFullHash> full_hashes;
-  BrowseFullHashesToCheck(url, true, &full_hashes);
+  BrowseFullHashesToCheck(url, true, NULL, &full_hashes);
   return ContainsWhitelistedHashes(csd_whitelist_, full_hashes);
 }
 
 bool SafeBrowsingDatabaseNew::ContainsDownloadWhitelistedUrl(const GURL& url) {
   std::vector<SBFullHash> full_hashes;
-  BrowseFullHashesToCheck(url, true, &full_hashes);
+  BrowseFullHashesToCheck(url, true, NULL, &full_hashes);
   return ContainsWhitelistedHashes(download_whitelist_, full_hashes);
 }
 
@@ -1176,6 +1213,10 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
     prefix_set_.swap(prefix_set);
   }
 
+  // The old prefix set may be mapped from the file which is about to
+  // be rewritten.
+  prefix_set.reset();
+
   DVLOG(1) << "SafeBrowsingDatabaseImpl built prefix set in "
            << (base::TimeTicks::Now() - before).InMilliseconds()
            << " ms total.  prefix count: " << add_prefixes.size();
@@ -5,7 +5,9 @@
 #ifndef CHROME_BROWSER_SAFE_BROWSING_SAFE_BROWSING_DATABASE_H_
 #define CHROME_BROWSER_SAFE_BROWSING_SAFE_BROWSING_DATABASE_H_
 
+#include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "base/file_path.h"
@@ -13,6 +15,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/thread_checker.h"
 #include "chrome/browser/safe_browsing/safe_browsing_store.h"
 
 namespace base {
@@ -373,6 +376,16 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   // them every time.  Cleared on next update.
   std::set<SBPrefix> prefix_miss_cache_;
 
+  // Full hashes of the "host/" patterns generated by
+  // |ContainsBrowseUrl()|, keyed by host.  Every URL is checked against
+  // each of its host suffixes with the root path, and a page's
+  // subresources mostly share a handful of hosts, so these hashes
+  // repeat from one check to the next.  Only touched on the thread
+  // calling |ContainsBrowseUrl()|, which |browse_lookup_thread_checker_|
+  // verifies.
+  std::map<std::string, SBFullHash> browse_host_hash_cache_;
+  base::ThreadChecker browse_lookup_thread_checker_;
+
   // Used to schedule resetting the database because of corruption.
   base::WeakPtrFactory<SafeBrowsingDatabaseNew> reset_factory_;
 
@@ -8,6 +8,7 @@
 #include "base/logging.h"
 #include "base/message_loop.h"
 #include "base/scoped_temp_dir.h"
+#include "base/stringprintf.h"
 #include "base/time.h"
 #include "chrome/browser/safe_browsing/bloom_filter.h"
 #include "chrome/browser/safe_browsing/safe_browsing_database.h"
@@ -1525,6 +1526,40 @@ TEST_F(SafeBrowsingDatabaseTest, SameHostEntriesOkay) {
       &listname, &prefixes, &full_hashes, now));
 }
 
+// Test that host-level matches are still found as the cache of host
+// pattern hashes fills and is cleared.
+TEST_F(SafeBrowsingDatabaseTest, HostHashCache) {
+  SBChunk chunk;
+  InsertAddChunkHostPrefixUrl(&chunk, 1, "www.evil.com/", "www.evil.com/");
+  SBChunkList chunks;
+  chunks.push_back(chunk);
+
+  std::vector<SBListChunkRanges> lists;
+  EXPECT_TRUE(database_->UpdateStarted(&lists));
+  database_->InsertChunks(safe_browsing_util::kMalwareList, chunks);
+  database_->UpdateFinished(true);
+
+  std::string listname;
+  std::vector<SBPrefix> prefixes;
+  std::vector<SBFullHashResult> full_hashes;
+  const base::Time now = base::Time::Now();
+
+  // Enough distinct hosts to overflow the cache several times.
+  for (int i = 0; i < 1000; ++i) {
+    const std::string good_url =
+        base::StringPrintf("http://www.good%d.com/page.html", i);
+    EXPECT_FALSE(database_->ContainsBrowseUrl(
+        GURL(good_url), &listname, &prefixes, &full_hashes, now));
+
+    const std::string evil_url =
+        base::StringPrintf("http://www.evil.com/page%d.html", i);
+    EXPECT_TRUE(database_->ContainsBrowseUrl(
+        GURL(evil_url), &listname, &prefixes, &full_hashes, now));
+    ASSERT_EQ(1U, prefixes.size());
+    EXPECT_EQ(Sha256Prefix("www.evil.com/"), prefixes[0]);
+  }
+}
+
 // Test that an empty update doesn't actually update the database.
 // This isn't a functionality requirement, but it is a useful
 // optimization.
@@ -4,8 +4,11 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 
+#include <algorithm>
+
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
+#include "base/time.h"
 
 namespace {
 
@@ -28,6 +31,10 @@ struct ChunkHeader {
   uint32 add_hash_count, sub_hash_count;
 };
 
+// Runs of items are read and written through a buffer of this size,
+// rather than one stdio call and one digest update per item.
+const size_t kItemBufferBytes = 4096;
+
 // Rewind the file.  Using fseek(2) because rewind(3) errors are
 // weird.
 bool FileRewind(FILE* fp) {
@@ -86,17 +93,26 @@ bool WriteItem(const T& item, FILE* fp, base::MD5Context* context) {
 template <typename CT>
 bool ReadToContainer(CT* values, size_t count, FILE* fp,
                      base::MD5Context* context) {
-  if (!count)
-    return true;
+  typedef typename CT::value_type ValueType;
+  ValueType buffer[kItemBufferBytes / sizeof(ValueType)];
 
-  for (size_t i = 0; i < count; ++i) {
-    typename CT::value_type value;
-    if (!ReadItem(&value, fp, context))
+  while (count) {
+    const size_t batch = std::min(count, arraysize(buffer));
+    if (fread(buffer, sizeof(buffer[0]), batch, fp) != batch)
       return false;
 
+    if (context) {
+      base::MD5Update(context,
+                      base::StringPiece(reinterpret_cast<char*>(buffer),
+                                        batch * sizeof(buffer[0])));
+    }
+
     // push_back() is more obvious, but coded this way std::set can
     // also be read.
-    values->insert(values->end(), value);
+    for (size_t i = 0; i < batch; ++i) {
+      values->insert(values->end(), buffer[i]);
+    }
+    count -= batch;
   }
 
   return true;
@@ -107,17 +123,72 @@ bool ReadToContainer(CT* values, size_t count, FILE* fp,
 template <typename CT>
 bool WriteContainer(const CT& values, FILE* fp,
                     base::MD5Context* context) {
-  if (values.empty())
-    return true;
+  typedef typename CT::value_type ValueType;
+  ValueType buffer[kItemBufferBytes / sizeof(ValueType)];
+
+  typename CT::const_iterator iter = values.begin();
+  while (iter != values.end()) {
+    size_t batch = 0;
+    while (batch < arraysize(buffer) && iter != values.end()) {
+      buffer[batch++] = *iter++;
+    }
 
-  for (typename CT::const_iterator iter = values.begin();
-       iter != values.end(); ++iter) {
-    if (!WriteItem(*iter, fp, context))
+    if (fwrite(buffer, sizeof(buffer[0]), batch, fp) != batch)
       return false;
+
+    if (context) {
+      base::MD5Update(context,
+                      base::StringPiece(reinterpret_cast<const char*>(buffer),
+                                        batch * sizeof(buffer[0])));
+    }
   }
   return true;
 }
 
+// Walk the |chunk_count| chunk headers in the chunk-accumulation file
+// |fp|, checking each against the file's |size| and summing their
+// counts into |totals|.  This allows the merge to size its vectors
+// once instead of growing them as chunks are read.  |fp| is left at
+// the start of the file.
+bool SumChunkHeaders(FILE* fp, int64 size, int chunk_count,
+                     ChunkHeader* totals) {
+  memset(totals, 0, sizeof(*totals));
+
+  if (!FileRewind(fp))
+    return false;
+
+  for (int i = 0; i < chunk_count; ++i) {
+    ChunkHeader header;
+
+    int64 ofs = ftell(fp);
+    if (ofs == -1)
+      return false;
+
+    if (!ReadItem(&header, fp, NULL))
+      return false;
+
+    // As a safety measure, make sure that the header describes a sane
+    // chunk, given the remaining file size.
+    int64 payload_size = 0;
+    payload_size += header.add_prefix_count * sizeof(SBAddPrefix);
+    payload_size += header.sub_prefix_count * sizeof(SBSubPrefix);
+    payload_size += header.add_hash_count * sizeof(SBAddFullHash);
+    payload_size += header.sub_hash_count * sizeof(SBSubFullHash);
+    if (ofs + static_cast<int64>(sizeof(ChunkHeader)) + payload_size > size)
+      return false;
+
+    if (!FileSkip(static_cast<size_t>(payload_size), fp))
+      return false;
+
+    totals->add_prefix_count += header.add_prefix_count;
+    totals->sub_prefix_count += header.sub_prefix_count;
+    totals->add_hash_count += header.add_hash_count;
+    totals->sub_hash_count += header.sub_hash_count;
+  }
+
+  return FileRewind(fp);
+}
+
 // Delete the chunks in |deleted| from |chunks|.
 void DeleteChunksFromSet(const base::hash_set<int32>& deleted,
                          std::set<int32>* chunks) {
@@ -514,6 +585,30 @@ bool SafeBrowsingStoreFile::DoUpdate(
   std::vector<SBAddFullHash> add_full_hashes;
   std::vector<SBSubFullHash> sub_full_hashes;
 
+  // Get chunk file's size for validating counts.
+  int64 size = 0;
+  if (!file_util::GetFileSize(TemporaryFileForFilename(filename_), &size))
+    return OnCorruptDatabase();
+
+  // Track update size to answer questions at http://crbug.com/72216 .
+  // Log small updates as 1k so that the 0 (underflow) bucket can be
+  // used for "empty" in SafeBrowsingDatabase.
+  UMA_HISTOGRAM_COUNTS("SB2.DatabaseUpdateKilobytes",
+                       std::max(static_cast<int>(size / 1024), 1));
+
+  // Size the vectors for the accumulated chunks up front, so that they
+  // are not repeatedly regrown (briefly holding two copies) as the
+  // original data and chunks are read.
+  ChunkHeader chunk_totals;
+  if (!SumChunkHeaders(new_file_.get(), size, chunks_written_,
+                       &chunk_totals))
+    return false;
+
+  // Counts in the original file, to detect updates which change
+  // nothing.
+  FileHeader original_header;
+  memset(&original_header, 0, sizeof(original_header));
+
   // Read original data into the vectors.
   if (!empty_) {
     DCHECK(file_.get());
@@ -528,6 +623,15 @@ bool SafeBrowsingStoreFile::DoUpdate(
     FileHeader header;
     if (!ReadAndVerifyHeader(filename_, file_.get(), &header, &context))
       return OnCorruptDatabase();
+    original_header = header;
+
+    sub_prefixes.reserve(header.sub_prefix_count +
+                         chunk_totals.sub_prefix_count);
+    add_full_hashes.reserve(header.add_hash_count +
+                            chunk_totals.add_hash_count +
+                            pending_adds.size());
+    sub_full_hashes.reserve(header.sub_hash_count +
+                            chunk_totals.sub_hash_count);
 
     // Re-read the chunks-seen data to get to the later data in the
     // file and calculate the checksum.  No new elements should be
@@ -564,45 +668,22 @@ bool SafeBrowsingStoreFile::DoUpdate(
 
     // Close the file so we can later rename over it.
     file_.reset();
+  } else {
+    sub_prefixes.reserve(chunk_totals.sub_prefix_count);
+    add_full_hashes.reserve(chunk_totals.add_hash_count +
+                            pending_adds.size());
+    sub_full_hashes.reserve(chunk_totals.sub_hash_count);
   }
   DCHECK(!file_.get());
 
-  // Rewind the temporary storage.
-  if (!FileRewind(new_file_.get()))
-    return false;
-
-  // Get chunk file's size for validating counts.
-  int64 size = 0;
-  if (!file_util::GetFileSize(TemporaryFileForFilename(filename_), &size))
-    return OnCorruptDatabase();
-
-  // Track update size to answer questions at http://crbug.com/72216 .
-  // Log small updates as 1k so that the 0 (underflow) bucket can be
-  // used for "empty" in SafeBrowsingDatabase.
-  UMA_HISTOGRAM_COUNTS("SB2.DatabaseUpdateKilobytes",
-                       std::max(static_cast<int>(size / 1024), 1));
-
   // Append the accumulated chunks onto the vectors read from |file_|.
+  // |SumChunkHeaders()| has already checked the chunk headers against
+  // the file size and rewound the temporary storage.
   for (int i = 0; i < chunks_written_; ++i) {
     ChunkHeader header;
-
-    int64 ofs = ftell(new_file_.get());
-    if (ofs == -1)
-      return false;
-
     if (!ReadItem(&header, new_file_.get(), NULL))
       return false;
 
-    // As a safety measure, make sure that the header describes a sane
-    // chunk, given the remaining file size.
-    int64 expected_size = ofs + sizeof(ChunkHeader);
-    expected_size += header.add_prefix_count * sizeof(SBAddPrefix);
-    expected_size += header.sub_prefix_count * sizeof(SBSubPrefix);
-    expected_size += header.add_hash_count * sizeof(SBAddFullHash);
-    expected_size += header.sub_hash_count * sizeof(SBSubFullHash);
-    if (expected_size > size)
-      return false;
-
     // TODO(shess): If the vectors were kept sorted, then this code
     // could use std::inplace_merge() to merge everything together in
     // sorted order.  That might still be slower than just sorting at
@@ -625,6 +706,16 @@ bool SafeBrowsingStoreFile::DoUpdate(
   add_full_hashes.insert(add_full_hashes.end(),
                          pending_adds.begin(), pending_adds.end());
 
+  // Everything is in memory at this point, so this is the high-water
+  // mark for the update.
+  const size_t working_set_bytes =
+      add_prefixes.size() * sizeof(SBAddPrefix) +
+      sub_prefixes.capacity() * sizeof(SBSubPrefix) +
+      add_full_hashes.capacity() * sizeof(SBAddFullHash) +
+      sub_full_hashes.capacity() * sizeof(SBSubFullHash);
+  UMA_HISTOGRAM_COUNTS("SB2.StoreUpdateWorkingSetKilobytes",
+                       static_cast<int>(working_set_bytes / 1024));
+
   // Check how often a prefix was checked which wasn't in the
   // database.
   SBCheckPrefixMisses(add_prefixes, prefix_misses);
@@ -638,6 +729,27 @@ bool SafeBrowsingStoreFile::DoUpdate(
   DeleteChunksFromSet(add_del_cache_, &add_chunks_cache_);
   DeleteChunksFromSet(sub_del_cache_, &sub_chunks_cache_);
 
+  // Processing only removes items, so if nothing was added and the
+  // counts all match the original file, the file already holds this
+  // data and need not be rewritten.
+  const bool unchanged = !empty_ && !chunks_written_ &&
+      pending_adds.empty() &&
+      original_header.add_chunk_count == add_chunks_cache_.size() &&
+      original_header.sub_chunk_count == sub_chunks_cache_.size() &&
+      original_header.add_prefix_count == add_prefixes.size() &&
+      original_header.sub_prefix_count == sub_prefixes.size() &&
+      original_header.add_hash_count == add_full_hashes.size() &&
+      original_header.sub_hash_count == sub_full_hashes.size();
+  UMA_HISTOGRAM_BOOLEAN("SB2.StoreRewriteSkipped", unchanged);
+  if (unchanged) {
+    new_file_.reset();
+    file_util::Delete(TemporaryFileForFilename(filename_), false);
+
+    add_prefixes_result->swap(add_prefixes);
+    add_full_hashes_result->swap(add_full_hashes);
+    return true;
+  }
+
   // Write the new data to new_file_.
   if (!FileRewind(new_file_.get()))
     return false;
@@ -706,6 +818,7 @@ bool SafeBrowsingStoreFile::FinishUpdate(
   DCHECK(add_prefixes_result);
   DCHECK(add_full_hashes_result);
 
+  const base::TimeTicks before = base::TimeTicks::Now();
   bool ret = DoUpdate(pending_adds, prefix_misses,
                       add_prefixes_result, add_full_hashes_result);
 
@@ -713,6 +826,8 @@ bool SafeBrowsingStoreFile::FinishUpdate(
     CancelUpdate();
     return false;
   }
+  UMA_HISTOGRAM_TIMES("SB2.StoreUpdateTime",
+                      base::TimeTicks::Now() - before);
 
   DCHECK(!new_file_.get());
   DCHECK(!file_.get());
@@ -193,4 +193,56 @@ TEST_F(SafeBrowsingStoreFileTest, CheckValidityChecksum) {
   EXPECT_TRUE(store_->CancelUpdate());
 }
 
+
+// Test that an update which brings no changes leaves the file alone.
+TEST_F(SafeBrowsingStoreFileTest, UnchangedUpdateSkipsRewrite) {
+  SafeBrowsingStoreTestStorePrefix(store_.get());
+  EXPECT_TRUE(file_util::PathExists(filename_));
+
+  // Backdate the store so that a rewrite would be visible.
+  const base::Time old_time =
+      base::Time::Now() - base::TimeDelta::FromDays(1);
+  ASSERT_TRUE(file_util::SetLastModifiedTime(filename_, old_time));
+  base::PlatformFileInfo info;
+  ASSERT_TRUE(file_util::GetFileInfo(filename_, &info));
+  const base::Time stored_time = info.last_modified;
+
+  std::vector<SBAddFullHash> pending_adds;
+  std::set<SBPrefix> prefix_misses;
+  SBAddPrefixes add_prefixes_result;
+  std::vector<SBAddFullHash> add_full_hashes_result;
+
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds,
+                                   prefix_misses,
+                                   &add_prefixes_result,
+                                   &add_full_hashes_result));
+  EXPECT_EQ(2U, add_prefixes_result.size());
+  EXPECT_EQ(1U, add_full_hashes_result.size());
+
+  ASSERT_TRUE(file_util::GetFileInfo(filename_, &info));
+  EXPECT_TRUE(stored_time == info.last_modified);
+  EXPECT_FALSE(file_util::PathExists(
+      SafeBrowsingStoreFile::TemporaryFileForFilename(filename_)));
+
+  // Adding data rewrites the file.
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->BeginChunk());
+  const int kNewAddChunk = 11;
+  const SBPrefix kNewPrefix = 0x12345678;
+  store_->SetAddChunk(kNewAddChunk);
+  EXPECT_TRUE(store_->WriteAddPrefix(kNewAddChunk, kNewPrefix));
+  EXPECT_TRUE(store_->FinishChunk());
+  add_prefixes_result.clear();
+  add_full_hashes_result.clear();
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds,
+                                   prefix_misses,
+                                   &add_prefixes_result,
+                                   &add_full_hashes_result));
+  EXPECT_EQ(3U, add_prefixes_result.size());
+
+  ASSERT_TRUE(file_util::GetFileInfo(filename_, &info));
+  EXPECT_FALSE(stored_time == info.last_modified);
+}
+
 }  // namespace
@@ -697,6 +697,7 @@ void TemplateURLService::Load() {
   }
 
   if (service_.get()) {
+    load_start_time_ = base::TimeTicks::Now();
     load_handle_ = service_->GetKeywords(this);
   } else {
     ChangeToLoadedState();
@@ -710,6 +711,8 @@ void TemplateURLService::OnWebDataServiceRequestDone(
   // Reset the load_handle so that we don't try and cancel the load in
   // the destructor.
   load_handle_ = 0;
+  UMA_HISTOGRAM_TIMES("Search.KeywordsLoadTime",
+                      base::TimeTicks::Now() - load_start_time_);
 
   if (!result) {
     // Results are null if the database went away or (most likely) wasn't
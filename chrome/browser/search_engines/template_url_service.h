@@ -14,6 +14,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
+#include "base/time.h"
 #include "chrome/browser/api/prefs/pref_change_registrar.h"
 #include "chrome/browser/common/url_database/template_url_id.h"
 #include "chrome/browser/profiles/profile_keyed_service.h"
@@ -612,6 +613,10 @@ class TemplateURLService : public WebDataServiceConsumer,
   // If non-zero, we're waiting on a load.
   WebDataService::Handle load_handle_;
 
+  // When the load was requested, for the histogram of how long the omnibox
+  // waited on it.
+  base::TimeTicks load_start_time_;
+
   // Service used to store entries.
   scoped_refptr<WebDataService> service_;
 
@@ -5,6 +5,7 @@
 #include "chrome/browser/sessions/session_backend.h"
 
 #include <limits>
+#include <string>
 
 #include "base/file_util.h"
 #include "base/memory/scoped_vector.h"
@@ -312,36 +313,43 @@ bool SessionBackend::ReadCurrentSessionCommandsImpl(
 
 bool SessionBackend::AppendCommandsToFile(net::FileStream* file,
     const std::vector<SessionCommand*>& commands) {
+  // Serialize the commands into one buffer and write that, rather than
+  // issuing three writes per command. A reset writes out every open tab.
+  size_t data_size = 0;
+  for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
+       i != commands.end(); ++i) {
+    data_size += sizeof(size_type) + sizeof(id_type) + (*i)->size();
+  }
+  std::string data;
+  data.reserve(data_size);
   for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
        i != commands.end(); ++i) {
-    int wrote;
     const size_type content_size = static_cast<size_type>((*i)->size());
     const size_type total_size =  content_size + sizeof(id_type);
     if (type_ == BaseSessionService::TAB_RESTORE)
       UMA_HISTOGRAM_COUNTS("TabRestore.command_size", total_size);
     else
       UMA_HISTOGRAM_COUNTS("SessionRestore.command_size", total_size);
-    wrote = file->WriteSync(reinterpret_cast<const char*>(&total_size),
-                            sizeof(total_size));
-    if (wrote != sizeof(total_size)) {
-      NOTREACHED() << "error writing";
-      return false;
-    }
-    id_type command_id = (*i)->id();
-    wrote = file->WriteSync(reinterpret_cast<char*>(&command_id),
-                            sizeof(command_id));
-    if (wrote != sizeof(command_id)) {
+    data.append(reinterpret_cast<const char*>(&total_size),
+                sizeof(total_size));
+    const id_type command_id = (*i)->id();
+    data.append(reinterpret_cast<const char*>(&command_id),
+                sizeof(command_id));
+    if (content_size > 0)
+      data.append((*i)->contents(), content_size);
+  }
+
+  // WriteSync() may write less than asked for, so keep going until the
+  // whole buffer is out.
+  size_t offset = 0;
+  while (offset < data.size()) {
+    const int wrote = file->WriteSync(data.data() + offset,
+                                      static_cast<int>(data.size() - offset));
+    if (wrote <= 0) {
       NOTREACHED() << "error writing";
       return false;
     }
-    if (content_size > 0) {
-      wrote = file->WriteSync(reinterpret_cast<char*>((*i)->contents()),
-                              content_size);
-      if (wrote != content_size) {
-        NOTREACHED() << "error writing";
-        return false;
-      }
-    }
+    offset += wrote;
   }
   file->Flush();
   return true;
@@ -18,6 +18,7 @@
 #include "base/platform_file.h"
 #include "base/stl_util.h"
 #include "base/stringprintf.h"
+#include "base/sys_info.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/performance_monitor/startup_timer.h"
@@ -34,6 +35,7 @@
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "chrome/browser/ui/webui/ntp/app_launcher_handler.h"
 #include "chrome/common/chrome_notification_types.h"
+#include "chrome/common/chrome_switches.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "content/public/browser/dom_storage_context.h"
 #include "content/public/browser/navigation_controller.h"
@@ -76,6 +78,12 @@ std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 // Initial delay (see class decription for details).
 static const int kInitialDelayTimerMS = 100;
 
+// With --lazy-restore-background-tabs, background tabs may use up to
+// 1/kLazyRestoreMemoryFraction of physical memory, assuming each renderer
+// needs about kLazyRestoreMBPerTab.
+static const int kLazyRestoreMemoryFraction = 4;
+static const int kLazyRestoreMBPerTab = 100;
+
 // TabLoader is responsible for loading tabs after session restore creates
 // tabs. New tabs are loaded after the current tab finishes loading, or a delay
 // is reached (initially kInitialDelayTimerMS). If the delay is reached before
@@ -87,6 +95,11 @@ static const int kInitialDelayTimerMS = 100;
 // TabLoader is loading, it will schedule its tabs to get loaded by the same
 // TabLoader. When doing the scheduling, it holds a reference to the TabLoader.
 //
+// With --lazy-restore-background-tabs, a background tab is only loaded when
+// no other tab is loading, and only up to a budget derived from physical
+// memory. Tabs left over are dropped from the loader and load when they are
+// selected.
+//
 // This is not part of SessionRestoreImpl so that synchronous destruction
 // of SessionRestoreImpl doesn't have timing problems.
 class TabLoader : public content::NotificationObserver,
@@ -153,6 +166,10 @@ class TabLoader : public content::NotificationObserver,
   // Called when a tab goes away or a load completes.
   void HandleTabClosedOrLoaded(NavigationController* controller);
 
+  // Stops tracking the tabs still waiting to be loaded in lazy mode. They
+  // load when selected.
+  void DeferRemainingTabs();
+
   content::NotificationRegistrar registrar_;
 
   // Current delay before a new tab is loaded. See class description for
@@ -189,6 +206,14 @@ class TabLoader : public content::NotificationObserver,
   // Max number of tabs that were loaded in parallel (for metrics).
   size_t max_parallel_tab_loads_;
 
+  // Whether background tabs are loaded lazily, see class description.
+  bool lazy_;
+
+  // In lazy mode, the number of background tabs which may be loaded, and
+  // the number which have been.
+  size_t background_tab_budget_;
+  size_t background_tabs_loaded_;
+
   // For keeping TabLoader alive while it's loading even if no
   // SessionRestoreImpls reference it.
   scoped_refptr<TabLoader> this_retainer_;
@@ -253,7 +278,16 @@ TabLoader::TabLoader(base::TimeTicks restore_started)
       got_first_paint_(false),
       tab_count_(0),
       restore_started_(restore_started),
-      max_parallel_tab_loads_(0) {
+      max_parallel_tab_loads_(0),
+      lazy_(CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kLazyRestoreBackgroundTabs)),
+      background_tab_budget_(0),
+      background_tabs_loaded_(0) {
+  if (lazy_) {
+    background_tab_budget_ = std::max(1,
+        base::SysInfo::AmountOfPhysicalMemoryMB() /
+        kLazyRestoreMemoryFraction / kLazyRestoreMBPerTab);
+  }
 }
 
 TabLoader::~TabLoader() {
@@ -264,6 +298,17 @@ TabLoader::~TabLoader() {
 }
 
 void TabLoader::LoadNextTab() {
+  if (lazy_ && !tabs_to_load_.empty()) {
+    // Wait for the selected tab and any earlier background tab to finish.
+    if (!tabs_loading_.empty())
+      return;
+    if (background_tabs_loaded_ >= background_tab_budget_) {
+      DeferRemainingTabs();
+      return;
+    }
+    ++background_tabs_loaded_;
+  }
+
   if (!tabs_to_load_.empty()) {
     NavigationController* tab = tabs_to_load_.front();
     DCHECK(tab);
@@ -288,7 +333,8 @@ void TabLoader::LoadNextTab() {
     }
   }
 
-  if (!tabs_to_load_.empty()) {
+  // In lazy mode the next tab is only loaded once this one finishes.
+  if (!tabs_to_load_.empty() && !lazy_) {
     force_load_timer_.Stop();
     // Each time we load a tab we also set a timer to force us to start loading
     // the next tab if this one doesn't load quickly enough.
@@ -468,9 +514,23 @@ void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
 
     UMA_HISTOGRAM_COUNTS_100("SessionRestore.ParallelTabLoads",
                              max_parallel_tab_loads_);
+    if (lazy_) {
+      UMA_HISTOGRAM_COUNTS_100("SessionRestore.LazyBackgroundTabsLoaded",
+                               background_tabs_loaded_);
+    }
   }
 }
 
+void TabLoader::DeferRemainingTabs() {
+  DCHECK(lazy_);
+  UMA_HISTOGRAM_COUNTS_100("SessionRestore.LazyBackgroundTabsDeferred",
+                           tabs_to_load_.size());
+  UMA_HISTOGRAM_MEMORY_MB("SessionRestore.LazyPhysicalMemory",
+                          base::SysInfo::AmountOfPhysicalMemoryMB());
+  while (!tabs_to_load_.empty())
+    RemoveTab(tabs_to_load_.front());
+}
+
 // SessionRestoreImpl ---------------------------------------------------------
 
 // SessionRestoreImpl is responsible for fetching the set of tabs to create
@@ -277,6 +277,23 @@ string16 TaskManagerModel::GetResourceVideoMemory(int index) const {
   }
 }
 
+string16 TaskManagerModel::GetResourceGpuTime(int index) const {
+  CHECK_LT(index, ResourceCount());
+
+  base::TimeDelta gpu_time;
+  bool has_duplicates;
+  if (!GetGpuTime(index, &gpu_time, &has_duplicates) ||
+      gpu_time == base::TimeDelta()) {
+    return ASCIIToUTF16("N/A");
+  }
+  string16 text = l10n_util::GetStringFUTF16(
+      IDS_TASK_MANAGER_GPU_TIME_CELL_TEXT,
+      base::FormatDouble(gpu_time.InSecondsF(), 1));
+  if (has_duplicates)
+    return ASCIIToUTF16("(") + text + ASCIIToUTF16(")");
+  return text;
+}
+
 string16 TaskManagerModel::GetResourceFPS(
     int index) const {
   CHECK_LT(index, ResourceCount());
@@ -477,6 +494,16 @@ int TaskManagerModel::CompareValues(int row1, int row2, int col_id) const {
     if (!GetVideoMemory(row1, &value1, &has_duplicates)) value1 = 0;
     if (!GetVideoMemory(row2, &value2, &has_duplicates)) value2 = 0;
     return ValueCompare<size_t>(value1, value2);
+  } else if (col_id == IDS_TASK_MANAGER_GPU_TIME_COLUMN) {
+    base::TimeDelta value1;
+    base::TimeDelta value2;
+    bool has_duplicates;
+    if (!GetGpuTime(row1, &value1, &has_duplicates))
+      value1 = base::TimeDelta();
+    if (!GetGpuTime(row2, &value2, &has_duplicates))
+      value2 = base::TimeDelta();
+    return ValueCompare<int64>(value1.InMicroseconds(),
+                               value2.InMicroseconds());
   } else if (col_id == IDS_TASK_MANAGER_GOATS_TELEPORTED_COLUMN) {
     return ValueCompare<int>(GetGoatsTeleported(row1),
                              GetGoatsTeleported(row2));
@@ -572,6 +599,18 @@ bool TaskManagerModel::GetSharedMemory(int index, size_t* result) const {
 
 bool TaskManagerModel::GetPhysicalMemory(int index, size_t* result) const {
   *result = 0;
+#if defined(OS_LINUX)
+  // The working set is the resident set from /proc/<pid>/statm, so without
+  // the shared pages it is the private memory, which is already cached.
+  return GetPrivateMemory(index, result);
+#else
+  base::ProcessHandle handle = resources_[index]->GetProcess();
+  PhysicalMemoryMap::const_iterator iter = physical_memory_map_.find(handle);
+  if (iter != physical_memory_map_.end()) {
+    *result = iter->second;
+    return true;
+  }
+
   base::ProcessMetrics* process_metrics;
   if (!GetProcessMetricsForRow(index, &process_metrics))
     return false;
@@ -583,8 +622,10 @@ bool TaskManagerModel::GetPhysicalMemory(int index, size_t* result) const {
   // We exclude the shared memory.
   size_t total_bytes = process_metrics->GetWorkingSetSize();
   total_bytes -= ws_usage.shared * 1024;
+  physical_memory_map_[handle] = total_bytes;
   *result = total_bytes;
   return true;
+#endif
 }
 
 bool TaskManagerModel::GetWebCoreCacheStats(
@@ -612,6 +653,22 @@ bool TaskManagerModel::GetVideoMemory(
   return true;
 }
 
+bool TaskManagerModel::GetGpuTime(
+    int index, base::TimeDelta* gpu_time, bool* has_duplicates) const {
+  TaskManager::Resource* resource = resources_[index];
+  base::ProcessId pid = base::GetProcId(resource->GetProcess());
+  content::GPUVideoMemoryUsageStats::ProcessMap::const_iterator i =
+      video_memory_usage_stats_.process_map.find(pid);
+  if (i == video_memory_usage_stats_.process_map.end()) {
+    *gpu_time = base::TimeDelta();
+    *has_duplicates = false;
+    return false;
+  }
+  *gpu_time = (*i).second.gpu_time;
+  *has_duplicates = (*i).second.has_duplicates;
+  return true;
+}
+
 bool TaskManagerModel::GetFPS(int index, float* result) const {
   *result = 0;
   if (!resources_[index]->ReportsFPS())
@@ -1025,6 +1082,7 @@ void TaskManagerModel::Refresh() {
 
   // Clear the memory values so they can be querried lazily.
   memory_usage_map_.clear();
+  physical_memory_map_.clear();
 
   // Send a request to refresh GPU memory consumption values
   RefreshVideoMemoryUsageStats();
@@ -315,6 +315,7 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   string16 GetResourceWebCoreScriptsCacheSize(int index) const;
   string16 GetResourceWebCoreCSSCacheSize(int index) const;
   string16 GetResourceVideoMemory(int index) const;
+  string16 GetResourceGpuTime(int index) const;
   string16 GetResourceFPS(int index) const;
   string16 GetResourceSqliteMemoryUsed(int index) const;
   string16 GetResourceGoatsTeleported(int index) const;
@@ -344,6 +345,12 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
                       size_t* video_memory,
                       bool* has_duplicates) const;
 
+  // Gets the time the GPU process spent processing the commands of the given
+  // page.
+  bool GetGpuTime(int index,
+                  base::TimeDelta* gpu_time,
+                  bool* has_duplicates) const;
+
   // Gets the fps of the given page. Return false if the resource for the given
   // row isn't a renderer.
   bool GetFPS(int index, float* result) const;
@@ -499,6 +506,7 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   // Private memory in bytes, shared memory in bytes.
   typedef std::pair<size_t, size_t> MemoryUsageEntry;
   typedef std::map<base::ProcessHandle, MemoryUsageEntry> MemoryUsageMap;
+  typedef std::map<base::ProcessHandle, size_t> PhysicalMemoryMap;
 
   // Updates the values for all rows.
   void Refresh();
@@ -584,6 +592,12 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   // every Refresh().
   mutable MemoryUsageMap memory_usage_map_;
 
+  // A map that contains the physical memory usage of the process. Sorting by
+  // memory queries it O(n log n) times, and each query makes two system calls
+  // per process. Unused on linux, where it is derived from
+  // |memory_usage_map_|. This cache is cleared on every Refresh().
+  mutable PhysicalMemoryMap physical_memory_map_;
+
   ObserverList<TaskManagerModelObserver> observer_list_;
 
   // How many calls to StartUpdating have been made without matching calls to
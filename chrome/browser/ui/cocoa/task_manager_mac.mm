@@ -56,6 +56,8 @@ const struct ColumnWidth {
       arraysize("100") * kCharWidth, -1 },
   { IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN,
       arraysize("2000.0K") * kCharWidth, -1 },
+  { IDS_TASK_MANAGER_GPU_TIME_COLUMN,
+      arraysize("9999.9s") * kCharWidth, -1 },
   { IDS_TASK_MANAGER_SQLITE_MEMORY_USED_COLUMN,
       arraysize("800 kB") * kCharWidth, -1 },
   { IDS_TASK_MANAGER_JAVASCRIPT_MEMORY_ALLOCATED_COLUMN,
@@ -308,6 +310,7 @@ class SortHelper {
   [self addColumnWithId:IDS_TASK_MANAGER_WEBCORE_CSS_CACHE_COLUMN visible:NO];
   [self addColumnWithId:IDS_TASK_MANAGER_FPS_COLUMN visible:YES];
   [self addColumnWithId:IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN visible:NO];
+  [self addColumnWithId:IDS_TASK_MANAGER_GPU_TIME_COLUMN visible:NO];
   [self addColumnWithId:IDS_TASK_MANAGER_SQLITE_MEMORY_USED_COLUMN visible:NO];
   [self addColumnWithId:IDS_TASK_MANAGER_JAVASCRIPT_MEMORY_ALLOCATED_COLUMN
                 visible:NO];
@@ -494,6 +497,9 @@ class SortHelper {
     case IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN:
       return base::SysUTF16ToNSString(model_->GetResourceVideoMemory(row));
 
+    case IDS_TASK_MANAGER_GPU_TIME_COLUMN:
+      return base::SysUTF16ToNSString(model_->GetResourceGpuTime(row));
+
     case IDS_TASK_MANAGER_SQLITE_MEMORY_USED_COLUMN:
       if (!model_->IsResourceFirstInGroup(row))
         return @"";
@@ -68,6 +68,7 @@ enum TaskManagerColumn {
   kTaskManagerWebCoreScriptsCache,
   kTaskManagerWebCoreCssCache,
   kTaskManagerVideoMemory,
+  kTaskManagerGpuTime,
   kTaskManagerFPS,
   kTaskManagerSqliteMemoryUsed,
   kTaskManagerGoatsTeleported,
@@ -107,6 +108,8 @@ TaskManagerColumn TaskManagerResourceIDToColumnID(int id) {
       return kTaskManagerWebCoreCssCache;
     case IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN:
       return kTaskManagerVideoMemory;
+    case IDS_TASK_MANAGER_GPU_TIME_COLUMN:
+      return kTaskManagerGpuTime;
     case IDS_TASK_MANAGER_FPS_COLUMN:
       return kTaskManagerFPS;
     case IDS_TASK_MANAGER_SQLITE_MEMORY_USED_COLUMN:
@@ -145,6 +148,8 @@ int TaskManagerColumnIDToResourceID(int id) {
       return IDS_TASK_MANAGER_WEBCORE_CSS_CACHE_COLUMN;
     case kTaskManagerVideoMemory:
       return IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN;
+    case kTaskManagerGpuTime:
+      return IDS_TASK_MANAGER_GPU_TIME_COLUMN;
     case kTaskManagerFPS:
       return IDS_TASK_MANAGER_FPS_COLUMN;
     case kTaskManagerSqliteMemoryUsed:
@@ -585,7 +590,7 @@ void TaskManagerGtk::CreateTaskManagerTreeview() {
       GDK_TYPE_PIXBUF, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
       G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
       G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-      G_TYPE_STRING, G_TYPE_STRING, GDK_TYPE_COLOR);
+      G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, GDK_TYPE_COLOR);
 
   // Support sorting on all columns.
   process_list_sort_ = gtk_tree_model_sort_new_with_model(
@@ -626,6 +631,9 @@ void TaskManagerGtk::CreateTaskManagerTreeview() {
   gtk_tree_sortable_set_sort_func(GTK_TREE_SORTABLE(process_list_sort_),
                                   kTaskManagerVideoMemory,
                                   CompareVideoMemory, this, NULL);
+  gtk_tree_sortable_set_sort_func(GTK_TREE_SORTABLE(process_list_sort_),
+                                  kTaskManagerGpuTime,
+                                  CompareGpuTime, this, NULL);
   gtk_tree_sortable_set_sort_func(GTK_TREE_SORTABLE(process_list_sort_),
                                   kTaskManagerFPS,
                                   CompareFPS, this, NULL);
@@ -652,6 +660,7 @@ void TaskManagerGtk::CreateTaskManagerTreeview() {
                        IDS_TASK_MANAGER_WEBCORE_SCRIPTS_CACHE_COLUMN);
   TreeViewInsertColumn(treeview_, IDS_TASK_MANAGER_WEBCORE_CSS_CACHE_COLUMN);
   TreeViewInsertColumn(treeview_, IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN);
+  TreeViewInsertColumn(treeview_, IDS_TASK_MANAGER_GPU_TIME_COLUMN);
   TreeViewInsertColumn(treeview_, IDS_TASK_MANAGER_FPS_COLUMN);
   TreeViewInsertColumn(treeview_, IDS_TASK_MANAGER_SQLITE_MEMORY_USED_COLUMN);
   TreeViewInsertColumn(treeview_, IDS_TASK_MANAGER_GOATS_TELEPORTED_COLUMN);
@@ -665,6 +674,7 @@ void TaskManagerGtk::CreateTaskManagerTreeview() {
   TreeViewColumnSetVisible(treeview_, kTaskManagerWebCoreScriptsCache, false);
   TreeViewColumnSetVisible(treeview_, kTaskManagerWebCoreCssCache, false);
   TreeViewColumnSetVisible(treeview_, kTaskManagerVideoMemory, false);
+  TreeViewColumnSetVisible(treeview_, kTaskManagerGpuTime, false);
   TreeViewColumnSetVisible(treeview_, kTaskManagerSqliteMemoryUsed, false);
   TreeViewColumnSetVisible(treeview_, kTaskManagerGoatsTeleported, false);
 
@@ -729,6 +739,9 @@ std::string TaskManagerGtk::GetModelText(int row, int col_id) {
     case IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN:
       return UTF16ToUTF8(model_->GetResourceVideoMemory(row));
 
+    case IDS_TASK_MANAGER_GPU_TIME_COLUMN:
+      return UTF16ToUTF8(model_->GetResourceGpuTime(row));
+
     case IDS_TASK_MANAGER_FPS_COLUMN:
       return UTF16ToUTF8(model_->GetResourceFPS(row));
 
@@ -794,6 +807,9 @@ void TaskManagerGtk::SetRowDataFromModel(int row, GtkTreeIter* iter) {
   std::string video_memory;
   if (TreeViewColumnIsVisible(treeview_, kTaskManagerVideoMemory))
     video_memory = GetModelText(row, IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN);
+  std::string gpu_time;
+  if (TreeViewColumnIsVisible(treeview_, kTaskManagerGpuTime))
+    gpu_time = GetModelText(row, IDS_TASK_MANAGER_GPU_TIME_COLUMN);
   std::string fps;
   if (TreeViewColumnIsVisible(treeview_, kTaskManagerFPS))
     fps = GetModelText(row, IDS_TASK_MANAGER_FPS_COLUMN);
@@ -822,6 +838,7 @@ void TaskManagerGtk::SetRowDataFromModel(int row, GtkTreeIter* iter) {
                      kTaskManagerWebCoreScriptsCache, wk_scripts_cache.c_str(),
                      kTaskManagerWebCoreCssCache, wk_css_cache.c_str(),
                      kTaskManagerVideoMemory, video_memory.c_str(),
+                     kTaskManagerGpuTime, gpu_time.c_str(),
                      kTaskManagerFPS, fps.c_str(),
                      kTaskManagerSqliteMemoryUsed, sqlite_memory.c_str(),
                      kTaskManagerGoatsTeleported, goats.c_str(),
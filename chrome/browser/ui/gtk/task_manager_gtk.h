@@ -192,6 +192,13 @@ class TaskManagerGtk : public TaskManagerModelObserver {
         CompareImpl(model, a, b, IDS_TASK_MANAGER_VIDEO_MEMORY_COLUMN);
   }
 
+  // GPU time sorting callback.
+  static gint CompareGpuTime(GtkTreeModel* model, GtkTreeIter* a,
+                             GtkTreeIter* b, gpointer task_manager) {
+    return reinterpret_cast<TaskManagerGtk*>(task_manager)->
+        CompareImpl(model, a, b, IDS_TASK_MANAGER_GPU_TIME_COLUMN);
+  }
+
   // FPS sorting callback.
   static gint CompareFPS(GtkTreeModel* model, GtkTreeIter* a,
                          GtkTreeIter* b, gpointer task_manager) {
@@ -1006,6 +1006,7 @@ void NetInternalsMessageHandler::IOThreadImpl::OnGetHostResolverInfo(
         static_cast<int>(key.address_family));
     entry_dict->SetString("expiration",
                           net::NetLog::TickCountToString(it.expiration()));
+    entry_dict->SetInteger("hits", entry.hit_count);
 
     if (entry.error != net::OK) {
       entry_dict->SetInteger("error", entry.error);
@@ -21,7 +21,6 @@
 #include "base/path_service.h"
 #include "base/process_util.h"
 #include "base/rand_util.h"
-#include "base/stack_container.h"
 #include "base/string_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "chrome/browser/history/history.h"
@@ -283,7 +282,8 @@ void VisitedLinkMaster::AddURL(const GURL& url) {
   if (!table_builder_ && index != null_hash_) {
     // Not rebuilding, so we want to keep the file on disk up-to-date.
     WriteUsedItemCountToFile();
-    WriteHashRangeToFile(index, index);
+    // Adding may have moved later fingerprints in the cluster up a slot.
+    WriteHashRangeToFile(index, FindClusterEnd(index));
     ResizeTableIfNecessary();
   }
 }
@@ -367,6 +367,14 @@ void VisitedLinkMaster::DeleteURLs(const history::URLRows& rows) {
 }
 
 // See VisitedLinkCommon::IsVisited which should be in sync with this algorithm
+//
+// The table uses linear probing with Robin Hood ordering: within a cluster,
+// fingerprints are kept in order of their home slot so that no fingerprint is
+// ever further from home than it needs to be. A new fingerprint is placed
+// before the first resident that is closer to its own home, and the rest of
+// the cluster moves up one slot. IsVisited needs no changes for this since a
+// fingerprint is still always reachable from its home without crossing an
+// empty slot.
 VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
     Fingerprint fingerprint,
     bool send_notifications) {
@@ -377,23 +385,26 @@ VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
 
   Hash cur_hash = HashFingerprint(fingerprint);
   Hash first_hash = cur_hash;
+  Hash insert_hash = null_hash_;
+  int32 distance = 0;
   while (true) {
     Fingerprint cur_fingerprint = FingerprintAt(cur_hash);
     if (cur_fingerprint == fingerprint)
       return null_hash_;  // This fingerprint is already in there, do nothing.
 
-    if (cur_fingerprint == null_fingerprint_) {
-      // End of probe sequence found, insert here.
-      hash_table_[cur_hash] = fingerprint;
-      used_items_++;
-      // If allowed, notify listener that a new visited link was added.
-      if (send_notifications)
-        listener_->Add(fingerprint);
-      return cur_hash;
-    }
+    if (cur_fingerprint == null_fingerprint_)
+      break;  // End of probe sequence found.
+
+    // Keep scanning to the end of the cluster even after finding our slot,
+    // since tables written before Robin Hood ordering may hold a duplicate
+    // further along.
+    if (insert_hash == null_hash_ &&
+        ProbeDistance(cur_fingerprint, cur_hash) < distance)
+      insert_hash = cur_hash;
 
     // Advance in the probe sequence.
     cur_hash = IncrementHash(cur_hash);
+    distance++;
     if (cur_hash == first_hash) {
       // This means that we've wrapped around and are about to go into an
       // infinite loop. Something was wrong with the hashtable resizing
@@ -402,6 +413,22 @@ VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
       return null_hash_;
     }
   }
+
+  if (insert_hash == null_hash_) {
+    insert_hash = cur_hash;
+  } else {
+    // Move [insert_hash, cur_hash) up one slot. Copying from the back means
+    // each moved fingerprint is written to its new slot before its old one is
+    // overwritten, so renderers reading the shared table never miss it.
+    for (Hash i = cur_hash; i != insert_hash; i = DecrementHash(i))
+      hash_table_[i] = hash_table_[DecrementHash(i)];
+  }
+  hash_table_[insert_hash] = fingerprint;
+  used_items_++;
+  // If allowed, notify listener that a new visited link was added.
+  if (send_notifications)
+    listener_->Add(fingerprint);
+  return insert_hash;
 }
 
 void VisitedLinkMaster::DeleteFingerprintsFromCurrentTable(
@@ -437,48 +464,29 @@ bool VisitedLinkMaster::DeleteFingerprint(Fingerprint fingerprint,
     WriteUsedItemCountToFile();
 
   Hash deleted_hash = HashFingerprint(fingerprint);
-
-  // Find the range of "stuff" in the hash table that is adjacent to this
-  // fingerprint. These are things that could be affected by the change in
-  // the hash table. Since we use linear probing, anything after the deleted
-  // item up until an empty item could be affected.
-  Hash end_range = deleted_hash;
-  while (true) {
-    Hash next_hash = IncrementHash(end_range);
-    if (next_hash == deleted_hash)
-      break;  // We wrapped around and the whole table is full.
-    if (!hash_table_[next_hash])
-      break;  // Found the last spot.
-    end_range = next_hash;
+  while (hash_table_[deleted_hash] != fingerprint)
+    deleted_hash = IncrementHash(deleted_hash);
+
+  // Close the gap by moving later fingerprints in the cluster back into it,
+  // as long as that does not put them before their home slot. Each one is
+  // copied before its old slot is reused or cleared, so, unlike removing and
+  // re-adding the cluster, no other link is ever missing from the table.
+  Hash hole = deleted_hash;
+  for (Hash i = IncrementHash(hole); hash_table_[i] && i != deleted_hash;
+       i = IncrementHash(i)) {
+    Hash home = HashFingerprint(hash_table_[i]);
+    bool home_in_gap = (hole <= i) ? (hole < home && home <= i) :
+                                     (hole < home || home <= i);
+    if (home_in_gap)
+      continue;  // Moving this one back would make it unreachable.
+    hash_table_[hole] = hash_table_[i];
+    hole = i;
   }
+  hash_table_[hole] = null_fingerprint_;
 
-  // We could get all fancy and move the affected fingerprints around, but
-  // instead we just remove them all and re-add them (minus our deleted one).
-  // This will mean there's a small window of time where the affected links
-  // won't be marked visited.
-  StackVector<Fingerprint, 32> shuffled_fingerprints;
-  Hash stop_loop = IncrementHash(end_range);  // The end range is inclusive.
-  for (Hash i = deleted_hash; i != stop_loop; i = IncrementHash(i)) {
-    if (hash_table_[i] != fingerprint) {
-      // Don't save the one we're deleting!
-      shuffled_fingerprints->push_back(hash_table_[i]);
-
-      // This will balance the increment of this value in AddFingerprint below
-      // so there is no net change.
-      used_items_--;
-    }
-    hash_table_[i] = null_fingerprint_;
-  }
-
-  if (!shuffled_fingerprints->empty()) {
-    // Need to add the new items back.
-    for (size_t i = 0; i < shuffled_fingerprints->size(); i++)
-      AddFingerprint(shuffled_fingerprints[i], false);
-  }
-
-  // Write the affected range to disk [deleted_hash, end_range].
+  // Write the affected range to disk [deleted_hash, hole].
   if (update_file)
-    WriteHashRangeToFile(deleted_hash, end_range);
+    WriteHashRangeToFile(deleted_hash, hole);
 
   return true;
 }
@@ -902,6 +910,16 @@ void VisitedLinkMaster::WriteUsedItemCountToFile() {
   WriteToFile(file_, kFileHeaderUsedOffset, &used_items_, sizeof(used_items_));
 }
 
+VisitedLinkMaster::Hash VisitedLinkMaster::FindClusterEnd(Hash hash) const {
+  Hash end_hash = hash;
+  while (true) {
+    Hash next_hash = IncrementHash(end_hash);
+    if (next_hash == hash || !hash_table_[next_hash])
+      return end_hash;
+    end_hash = next_hash;
+  }
+}
+
 void VisitedLinkMaster::WriteHashRangeToFile(Hash first_hash, Hash last_hash) {
   if (!file_)
     return;  // See comment on the file_ variable for why this might happen.
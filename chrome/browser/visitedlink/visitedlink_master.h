@@ -123,6 +123,7 @@ class VisitedLinkMaster : public VisitedLinkCommon {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, Delete);
+  FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, RobinHoodOrdering);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigDelete);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigImport);
 
@@ -212,7 +213,8 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // Called to add a fingerprint to the table. If |send_notifications| is true
   // and the item is added successfully, Listener::Add will be invoked.
   // Returns the index of the inserted fingerprint or null_hash_ if there was a
-  // duplicate and this item was skippped.
+  // duplicate and this item was skippped. Fingerprints following the returned
+  // index in the same cluster may have been moved up one slot.
   Hash AddFingerprint(Fingerprint fingerprint, bool send_notifications);
 
   // Deletes all fingerprints from the given vector from the current hash table
@@ -291,17 +293,27 @@ class VisitedLinkMaster : public VisitedLinkCommon {
 
   // Increases or decreases the given hash value by one, wrapping around as
   // necessary. Used for probing.
-  inline Hash IncrementHash(Hash hash) {
+  inline Hash IncrementHash(Hash hash) const {
     if (hash >= table_length_ - 1)
       return 0;  // Wrap around.
     return hash + 1;
   }
-  inline Hash DecrementHash(Hash hash) {
+  inline Hash DecrementHash(Hash hash) const {
     if (hash <= 0)
       return table_length_ - 1;  // Wrap around.
     return hash - 1;
   }
 
+  // Returns how many slots |fingerprint|, stored at |hash|, is past the slot
+  // it hashes to.
+  inline int32 ProbeDistance(Fingerprint fingerprint, Hash hash) const {
+    Hash home = HashFingerprint(fingerprint);
+    return hash >= home ? hash - home : hash + table_length_ - home;
+  }
+
+  // Returns the last index of the run of occupied slots starting at |hash|.
+  Hash FindClusterEnd(Hash hash) const;
+
   Listener* listener_;
 
 #ifndef NDEBUG
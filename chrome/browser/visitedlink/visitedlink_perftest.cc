@@ -106,6 +106,31 @@ TEST_F(VisitedLink, TestAddAndQuery) {
   CheckVisited(master, unadded_prefix, 0, add_count);
 }
 
+// Tests lookups when the table is nearly as full as it is allowed to get
+// before growing, which is where probe sequences are longest. Misses are
+// timed separately from hits since they have to walk to the end of a cluster.
+TEST_F(VisitedLink, TestQueryHighLoad) {
+  VisitedLinkMaster master(DummyVisitedLinkEventListener::GetInstance(),
+                           NULL, true, db_path_, 0);
+  ASSERT_TRUE(master.Init());
+
+  // The default table has 16381 slots and grows once it is half full.
+  const int high_load_count = 8000;
+  FillTable(master, added_prefix, 0, high_load_count);
+  ASSERT_EQ(high_load_count, master.GetUsedCount());
+
+  const int query_repeat = 20;
+  PerfTimeLogger hit_timer("Visited_link_query_high_load_hits");
+  for (int i = 0; i < query_repeat; i++)
+    CheckVisited(master, added_prefix, 0, high_load_count);
+  hit_timer.Done();
+
+  PerfTimeLogger miss_timer("Visited_link_query_high_load_misses");
+  for (int i = 0; i < query_repeat; i++)
+    CheckVisited(master, unadded_prefix, 0, high_load_count);
+  miss_timer.Done();
+}
+
 // Tests how long it takes to write and read a large database to and from disk.
 TEST_F(VisitedLink, TestLoad) {
   // create a big DB
@@ -251,6 +251,41 @@ TEST_F(VisitedLinkTest, Delete) {
         "Hash table has values in it.";
 }
 
+// Checks that fingerprints within a cluster are kept in order of their home
+// slot, and that deleting closes the gap without losing anything.
+TEST_F(VisitedLinkTest, RobinHoodOrdering) {
+  static const int32 kInitialSize = 17;
+  ASSERT_TRUE(InitHistory());
+  ASSERT_TRUE(InitVisited(kInitialSize, true));
+
+  const VisitedLinkCommon::Fingerprint kHome14a = kInitialSize * 0 + 14;
+  const VisitedLinkCommon::Fingerprint kHome14b = kInitialSize * 1 + 14;
+  const VisitedLinkCommon::Fingerprint kHome15 = kInitialSize * 1 + 15;
+  const VisitedLinkCommon::Fingerprint kHome14c = kInitialSize * 2 + 14;
+  EXPECT_EQ(14, master_->AddFingerprint(kHome14a, false));
+  EXPECT_EQ(15, master_->AddFingerprint(kHome14b, false));
+  EXPECT_EQ(16, master_->AddFingerprint(kHome15, false));
+
+  // The third fingerprint hashing to 14 goes ahead of the one hashing to 15,
+  // which moves up (wrapping around) to slot 0.
+  EXPECT_EQ(16, master_->AddFingerprint(kHome14c, false));
+  EXPECT_EQ(kHome14c, master_->hash_table_[16]);
+  EXPECT_EQ(kHome15, master_->hash_table_[0]);
+  EXPECT_EQ(4, master_->used_items_);
+
+  // Deleting the head of the cluster moves everything else back one slot.
+  EXPECT_TRUE(master_->DeleteFingerprint(kHome14a, false));
+  EXPECT_EQ(kHome14b, master_->hash_table_[14]);
+  EXPECT_EQ(kHome14c, master_->hash_table_[15]);
+  EXPECT_EQ(kHome15, master_->hash_table_[16]);
+  VisitedLinkCommon::Fingerprint zero_fingerprint = 0;
+  EXPECT_EQ(zero_fingerprint, master_->hash_table_[0]);
+  EXPECT_TRUE(master_->IsVisited(kHome14b));
+  EXPECT_TRUE(master_->IsVisited(kHome14c));
+  EXPECT_TRUE(master_->IsVisited(kHome15));
+  EXPECT_EQ(3, master_->used_items_);
+}
+
 // When we delete more than kBigDeleteThreshold we trigger different behavior
 // where the entire file is rewritten.
 TEST_F(VisitedLinkTest, BigDelete) {
@@ -6,8 +6,10 @@
 
 #include "base/bind.h"
 #include "base/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/threading/thread.h"
+#include "base/time.h"
 #include "chrome/browser/autofill/autofill_country.h"
 #include "chrome/browser/autofill/autofill_profile.h"
 #include "chrome/browser/autofill/credit_card.h"
@@ -666,7 +668,10 @@ void WebDataService::InitializeDatabaseIfNecessary() {
   // we only set db_ to the created database if creation is successful. That
   // way other methods won't do anything as db_ is still NULL.
   WebDatabase* db = new WebDatabase();
+  base::TimeTicks init_start = base::TimeTicks::Now();
   sql::InitStatus init_status = db->Init(path_);
+  UMA_HISTOGRAM_TIMES("WebDatabase.InitTime",
+                      base::TimeTicks::Now() - init_start);
   if (init_status != sql::INIT_OK) {
     LOG(ERROR) << "Cannot initialize the web database: " << init_status;
     failed_init_ = true;
@@ -795,6 +800,7 @@ void WebDataService::UpdateKeywordImpl(
 void WebDataService::GetKeywordsImpl(WebDataRequest* request) {
   InitializeDatabaseIfNecessary();
   if (db_ && !request->IsCancelled(NULL)) {
+    base::TimeTicks read_start = base::TimeTicks::Now();
     WDKeywordsResult result;
     db_->GetKeywordTable()->GetKeywords(&result.keywords);
     result.default_search_provider_id =
@@ -806,6 +812,8 @@ void WebDataService::GetKeywordsImpl(WebDataRequest* request) {
     result.backup_valid = result.did_default_search_provider_change &&
         db_->GetKeywordTable()->GetDefaultSearchProviderBackup(
             &result.default_search_provider_backup);
+    UMA_HISTOGRAM_TIMES("WebDatabase.KeywordsReadTime",
+                        base::TimeTicks::Now() - read_start);
     request->SetResult(
         new WDResult<WDKeywordsResult>(KEYWORDS_RESULT, result));
   }
@@ -98,6 +98,7 @@ sql::InitStatus WebDatabase::Init(const FilePath& db_name) {
 
   // Set the exceptional sqlite error handler.
   db_.set_error_delegate(GetErrorHandlerForWebDb());
+  db_.set_histogram_tag("Web");
 
   // We don't store that much data in the tables so use a small page size.
   // This provides a large benefit for empty tables (which is very likely with
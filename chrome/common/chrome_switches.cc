@@ -804,6 +804,10 @@ const char kKioskMode[]                     = "kiosk";
 // See http://crbug.com/31395.
 const char kKioskModePrinting[]             = "kiosk-printing";
 
+// During session restore, only loads background tabs while nothing else is
+// loading and a memory budget allows, leaving the rest to load when selected.
+const char kLazyRestoreBackgroundTabs[]     = "lazy-restore-background-tabs";
+
 // Comma-separated list of directories with component extensions to load.
 const char kLoadComponentExtension[]        = "load-component-extension";
 
@@ -872,6 +876,11 @@ const char kNaClLoaderCmdPrefix[]           = "nacl-loader-cmd-prefix";
 // Intended primarily for use with --log-net-log.
 const char kNetLogLevel[]                   = "net-log-level";
 
+// Limits each file written by --log-net-log to the given number of megabytes.
+// A full file is moved aside, replacing the one moved before it, so long
+// captures use bounded disk space and keep the most recent events.
+const char kNetLogMaxFileSize[]             = "net-log-max-file-size";
+
 // Disables the default browser check. Useful for UI/browser tests where we
 // want to avoid having the default browser info-bar displayed.
 const char kNoDefaultBrowserCheck[]         = "no-default-browser-check";
@@ -1087,6 +1096,11 @@ const char kProfilingOutputFile[]           = "profiling-output-file";
 // specified.
 const char kProfilingFlush[]                = "profiling-flush";
 
+// Makes the task profiler (about:profiler) tally only about one in the given
+// number of tasks, and scale its counts up to match.  This lowers the cost of
+// profiling enough to leave it on.
+const char kProfilingSamplingInterval[]     = "profiling-sampling-interval";
+
 // Specifies a custom URL for fetching NTP promo data.
 const char kPromoServerURL[]                = "promo-server-url";
 
@@ -1216,6 +1230,9 @@ const char kSpeculativeResourcePrefetching[] =
 // Speculative resource prefetching is disabled.
 const char kSpeculativeResourcePrefetchingDisabled[] = "disabled";
 
+// Speculative resource prefetching is enabled.
+const char kSpeculativeResourcePrefetchingEnabled[] = "enabled";
+
 // Speculative resource prefetching will only learn about resources that need to
 // be prefetched but will not prefetch them.
 const char kSpeculativeResourcePrefetchingLearning[] = "learning";
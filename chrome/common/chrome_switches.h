@@ -217,6 +217,7 @@ extern const char kInstantURL[];
 extern const char kKeepAliveForTest[];
 extern const char kKioskMode[];
 extern const char kKioskModePrinting[];
+extern const char kLazyRestoreBackgroundTabs[];
 extern const char kLoadComponentExtension[];
 extern const char kLoadCloudPolicyOnSignin[];
 extern const char kLoadExtension[];
@@ -234,6 +235,7 @@ extern const char kNaClGdb[];
 extern const char kNaClGdbScript[];
 extern const char kNaClLoaderCmdPrefix[];
 extern const char kNetLogLevel[];
+extern const char kNetLogMaxFileSize[];
 extern const char kNoDefaultBrowserCheck[];
 extern const char kNoDisplayingInsecureContent[];
 extern const char kNoEvents[];
@@ -289,6 +291,7 @@ extern const char kProfilingAtStart[];
 extern const char kProfilingFile[];
 extern const char kProfilingFlush[];
 extern const char kProfilingOutputFile[];
+extern const char kProfilingSamplingInterval[];
 extern const char kPromoServerURL[];
 extern const char kProtector[];
 extern const char kProxyAutoDetect[];
@@ -320,6 +323,7 @@ extern const char kSimulateUpgrade[];
 extern const char kSocketReusePolicy[];
 extern const char kSpeculativeResourcePrefetching[];
 extern const char kSpeculativeResourcePrefetchingDisabled[];
+extern const char kSpeculativeResourcePrefetchingEnabled[];
 extern const char kSpeculativeResourcePrefetchingLearning[];
 extern const char kSSLVersionMax[];
 extern const char kSSLVersionMin[];
@@ -42,6 +42,9 @@ void LogFailure(const FilePath& path, TempFileFailure failure_code,
 }
 
 void WriteToDiskTask(const FilePath& path, const std::string& data) {
+  UMA_HISTOGRAM_COUNTS("ImportantFile.WriteSizeKilobytes",
+                       static_cast<int>(data.length() / 1024));
+
   // Write the data to a temp file then rename to avoid data loss if we crash
   // while writing the file. Ensure that the temp file is on the same volume
   // as target file, so it can be moved in one step, and that the temp file
@@ -86,8 +89,33 @@ void WriteToDiskTask(const FilePath& path, const std::string& data) {
   }
 }
 
+// Runs |snapshot| on the file thread and writes its output.
+void SerializeSnapshotAndWriteTask(
+    const FilePath& path,
+    const ImportantFileWriter::DataSerializer::SnapshotCallback& snapshot) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  std::string data;
+  if (!snapshot.Run(&data)) {
+    DLOG(WARNING) << "failed to serialize data to be saved in "
+                  << path.value();
+    return;
+  }
+  UMA_HISTOGRAM_TIMES("ImportantFile.SnapshotSerializationTime",
+                      base::TimeTicks::Now() - start);
+  if (data.length() > static_cast<size_t>(kint32max)) {
+    NOTREACHED();
+    return;
+  }
+  WriteToDiskTask(path, data);
+}
+
 }  // namespace
 
+ImportantFileWriter::DataSerializer::SnapshotCallback
+ImportantFileWriter::DataSerializer::TakeSnapshot() {
+  return SnapshotCallback();
+}
+
 ImportantFileWriter::ImportantFileWriter(
     const FilePath& path, base::MessageLoopProxy* file_message_loop_proxy)
         : path_(path),
@@ -146,6 +174,20 @@ void ImportantFileWriter::ScheduleWrite(DataSerializer* serializer) {
 
 void ImportantFileWriter::DoScheduledWrite() {
   DCHECK(serializer_);
+  DataSerializer::SnapshotCallback snapshot = serializer_->TakeSnapshot();
+  if (!snapshot.is_null()) {
+    serializer_ = NULL;
+    if (HasPendingWrite())
+      timer_.Stop();
+    if (!file_message_loop_proxy_->PostTask(
+        FROM_HERE,
+        base::Bind(&SerializeSnapshotAndWriteTask, path_, snapshot))) {
+      NOTREACHED();
+      SerializeSnapshotAndWriteTask(path_, snapshot);
+    }
+    return;
+  }
+
   std::string data;
   if (serializer_->SerializeData(&data)) {
     WriteNow(data);
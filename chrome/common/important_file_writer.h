@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
 #include "base/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/threading/non_thread_safe.h"
@@ -41,11 +42,20 @@ class ImportantFileWriter : public base::NonThreadSafe {
   // to also batch data serializations.
   class DataSerializer {
    public:
+    typedef base::Callback<bool(std::string*)> SnapshotCallback;
+
     // Should put serialized string in |data| and return true on successful
     // serialization. Will be called on the same thread on which
     // ImportantFileWriter has been created.
     virtual bool SerializeData(std::string* data) = 0;
 
+    // May return a callback which serializes an immutable snapshot of the
+    // data. If it is non-null, it is run on the file thread in place of
+    // SerializeData(), so that expensive serializations do not block this
+    // thread. The callback must own everything it touches. The default
+    // implementation returns a null callback.
+    virtual SnapshotCallback TakeSnapshot();
+
    protected:
     virtual ~DataSerializer() {}
   };
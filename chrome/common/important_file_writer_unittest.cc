@@ -4,6 +4,7 @@
 
 #include "chrome/common/important_file_writer.h"
 
+#include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
@@ -38,6 +39,33 @@ class DataSerializer : public ImportantFileWriter::DataSerializer {
   const std::string data_;
 };
 
+bool CopySnapshot(const std::string& data, std::string* output) {
+  output->assign(data);
+  return true;
+}
+
+// Hands out a snapshot of |data_| taken when the write is committed, so any
+// later change must not reach the file.
+class SnapshotSerializer : public ImportantFileWriter::DataSerializer {
+ public:
+  explicit SnapshotSerializer(const std::string& data) : data_(data) {
+  }
+
+  void set_data(const std::string& data) { data_ = data; }
+
+  virtual bool SerializeData(std::string* output) OVERRIDE {
+    ADD_FAILURE() << "SerializeData() should not be called";
+    return false;
+  }
+
+  virtual SnapshotCallback TakeSnapshot() OVERRIDE {
+    return base::Bind(&CopySnapshot, data_);
+  }
+
+ private:
+  std::string data_;
+};
+
 }  // namespace
 
 class ImportantFileWriterTest : public testing::Test {
@@ -103,6 +131,20 @@ TEST_F(ImportantFileWriterTest, DoScheduledWrite) {
   EXPECT_EQ("foo", GetFileContent(writer.path()));
 }
 
+TEST_F(ImportantFileWriterTest, DoScheduledWriteWithSnapshot) {
+  ImportantFileWriter writer(file_,
+                             base::MessageLoopProxy::current());
+  SnapshotSerializer serializer("foo");
+  writer.ScheduleWrite(&serializer);
+  EXPECT_TRUE(writer.HasPendingWrite());
+  writer.DoScheduledWrite();
+  EXPECT_FALSE(writer.HasPendingWrite());
+  serializer.set_data("bar");
+  loop_.RunAllPending();
+  ASSERT_TRUE(file_util::PathExists(writer.path()));
+  EXPECT_EQ("foo", GetFileContent(writer.path()));
+}
+
 // Flaky - http://crbug.com/109292
 TEST_F(ImportantFileWriterTest, DISABLED_BatchingWrites) {
   ImportantFileWriter writer(file_,
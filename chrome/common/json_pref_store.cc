@@ -311,11 +311,22 @@ JsonPrefStore::~JsonPrefStore() {
 }
 
 bool JsonPrefStore::SerializeData(std::string* output) {
+  scoped_ptr<DictionaryValue> snapshot(CreateSnapshot());
+  return SerializeSnapshot(snapshot.get(), output);
+}
+
+ImportantFileWriter::DataSerializer::SnapshotCallback
+JsonPrefStore::TakeSnapshot() {
+  // Copying the values is much cheaper than pretty-printing them, so only the
+  // copy is made here and the JSON is produced on the file thread.
+  return base::Bind(&JsonPrefStore::SerializeSnapshot,
+                    base::Owned(CreateSnapshot()));
+}
+
+DictionaryValue* JsonPrefStore::CreateSnapshot() const {
   // TODO(tc): Do we want to prune webkit preferences that match the default
   // value?
-  JSONStringValueSerializer serializer(output);
-  serializer.set_pretty_print(true);
-  scoped_ptr<DictionaryValue> copy(prefs_->DeepCopyWithoutEmptyChildren());
+  DictionaryValue* copy = prefs_->DeepCopyWithoutEmptyChildren();
 
   // Iterates |keys_need_empty_value_| and if the key exists in |prefs_|,
   // ensure its empty ListValue or DictonaryValue is preserved.
@@ -340,5 +351,13 @@ bool JsonPrefStore::SerializeData(std::string* output) {
     }
   }
 
-  return serializer.Serialize(*(copy.get()));
+  return copy;
+}
+
+// static
+bool JsonPrefStore::SerializeSnapshot(const DictionaryValue* snapshot,
+                                      std::string* output) {
+  JSONStringValueSerializer serializer(output);
+  serializer.set_pretty_print(true);
+  return serializer.Serialize(*snapshot);
 }
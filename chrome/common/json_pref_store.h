@@ -67,6 +67,15 @@ class JsonPrefStore : public PersistentPrefStore,
 
   // ImportantFileWriter::DataSerializer overrides:
   virtual bool SerializeData(std::string* output) OVERRIDE;
+  virtual SnapshotCallback TakeSnapshot() OVERRIDE;
+
+  // Returns a copy of |prefs_| as it should be written to disk. The caller
+  // takes ownership.
+  base::DictionaryValue* CreateSnapshot() const;
+
+  // Serializes |snapshot| to JSON. Safe to call on any thread.
+  static bool SerializeSnapshot(const base::DictionaryValue* snapshot,
+                                std::string* output);
 
   FilePath path_;
   scoped_refptr<base::MessageLoopProxy> file_message_loop_proxy_;
@@ -22,8 +22,8 @@ VisitedLinkCommon::VisitedLinkCommon()
 VisitedLinkCommon::~VisitedLinkCommon() {
 }
 
-// FIXME: this uses linear probing, it should be replaced with quadratic
-// probing or something better. See VisitedLinkMaster::AddFingerprint
+// This uses linear probing. The master keeps each cluster in Robin Hood order
+// to bound probe lengths; see VisitedLinkMaster::AddFingerprint.
 bool VisitedLinkCommon::IsVisited(const char* canonical_url,
                                   size_t url_len) const {
   if (url_len == 0)
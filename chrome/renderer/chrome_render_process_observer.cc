@@ -235,6 +235,12 @@ bool ChromeRenderProcessObserver::OnControlMessageReceived(
   return handled;
 }
 
+void ChromeRenderProcessObserver::WebKitInitialized() {
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&ChromeRenderProcessObserver::OnMemoryPressure,
+                 base::Unretained(this))));
+}
+
 void ChromeRenderProcessObserver::OnSetIsIncognitoProcess(
     bool is_incognito_process) {
   is_incognito_process_ = is_incognito_process;
@@ -345,6 +351,17 @@ void ChromeRenderProcessObserver::OnPurgeMemory() {
     client_->OnPurgeMemory();
 }
 
+void ChromeRenderProcessObserver::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL) {
+    OnPurgeMemory();
+    return;
+  }
+
+  WebFontCache::clear();
+  v8::V8::LowMemoryNotification();
+}
+
 void ChromeRenderProcessObserver::ExecutePendingClearCache() {
   if (clear_cache_pending_) {
     clear_cache_pending_ = false;
@@ -9,6 +9,7 @@
 
 #include "base/compiler_specific.h"
 #include "base/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "chrome/common/content_settings.h"
 #include "content/public/renderer/render_process_observer.h"
@@ -47,6 +48,7 @@ class ChromeRenderProcessObserver : public content::RenderProcessObserver {
  private:
   // RenderProcessObserver implementation.
   virtual bool OnControlMessageReceived(const IPC::Message& message) OVERRIDE;
+  virtual void WebKitInitialized() OVERRIDE;
 
   void OnSetIsIncognitoProcess(bool is_incognito_process);
   void OnSetContentSettingsForCurrentURL(
@@ -67,12 +69,19 @@ class ChromeRenderProcessObserver : public content::RenderProcessObserver {
   void OnPurgeMemory();
   void OnToggleWebKitSharedTimer(bool suspend);
 
+  // Frees the caches that are cheap to rebuild under moderate memory
+  // pressure, and everything OnPurgeMemory() frees under critical pressure.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   static bool is_incognito_process_;
   scoped_ptr<content::ResourceDispatcherDelegate> resource_delegate_;
   chrome::ChromeContentRendererClient* client_;
   // If true, the web cache shall be cleared before the next navigation event.
   bool clear_cache_pending_;
   RendererContentSettingRules content_setting_rules_;
+  // Created once WebKit is initialized, since there is nothing to free before.
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeRenderProcessObserver);
 };
@@ -412,6 +412,26 @@ void PageLoadHistograms::Dump(WebFrame* frame) {
         begin_to_finish_all_loads);
   }
 
+  // Histograms to determine if the resource scheduler, which holds back
+  // images while the page parses, gets pages painted sooner.
+  static const bool resource_scheduler_fieldtrial =
+      base::FieldTrialList::TrialExists(
+          content::kResourceSchedulerFieldTrialName);
+  if (resource_scheduler_fieldtrial) {
+    if (!first_paint.is_null() && begin <= first_paint) {
+      PLT_HISTOGRAM(base::FieldTrial::MakeName(
+          "PLT.BeginToFirstPaint",
+          content::kResourceSchedulerFieldTrialName),
+          first_paint - begin);
+    }
+    PLT_HISTOGRAM(base::FieldTrial::MakeName(
+        "PLT.BeginToFinishDoc", content::kResourceSchedulerFieldTrialName),
+        begin_to_finish_doc);
+    PLT_HISTOGRAM(base::FieldTrial::MakeName(
+        "PLT.BeginToFinish", content::kResourceSchedulerFieldTrialName),
+        begin_to_finish_all_loads);
+  }
+
   // Histograms to determine if backup connection jobs have an impact on PLT.
   static const bool connect_backup_jobs_fieldtrial =
       base::FieldTrialList::TrialExists("ConnnectBackupJobs");
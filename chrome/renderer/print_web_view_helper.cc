@@ -1783,6 +1783,12 @@ void PrintWebViewHelper::PrintPreviewContext::RenderedPreviewPage(
   DCHECK_EQ(RENDERING, state_);
   document_render_time_ += page_time;
   UMA_HISTOGRAM_TIMES("PrintPreview.RenderPDFPageTime", page_time);
+  // Pages are sent to the preview as they are rendered, so this is how long
+  // the user waits before seeing anything.
+  if (current_page_index_ == 1) {
+    UMA_HISTOGRAM_MEDIUM_TIMES("PrintPreview.RenderTimeToFirstPage",
+                               base::TimeTicks::Now() - begin_time_);
+  }
 }
 
 void PrintWebViewHelper::PrintPreviewContext::AllPagesRendered() {
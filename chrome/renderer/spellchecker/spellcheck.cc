@@ -25,6 +25,14 @@ using WebKit::WebVector;
 using WebKit::WebTextCheckingResult;
 using WebKit::WebTextCheckingType;
 
+namespace {
+
+// The maximum number of words whose spelling is remembered. This is a few
+// pages of text, at most a few hundred kilobytes.
+const size_t kMaxCachedWords = 5000;
+
+}  // namespace
+
 class SpellCheck::SpellCheckRequestParam
     : public base::RefCountedThreadSafe<SpellCheck::SpellCheckRequestParam> {
  public:
@@ -111,6 +119,7 @@ void SpellCheck::OnWordAdded(const std::string& word) {
     custom_words_.push_back(word);
   } else {
     AddWordToHunspell(word);
+    spelling_cache_.clear();
   }
 }
 
@@ -124,6 +133,7 @@ void SpellCheck::Init(base::PlatformFile file,
   initialized_ = true;
   hunspell_.reset();
   bdict_file_.reset();
+  spelling_cache_.clear();
   file_ = file;
   is_using_platform_spelling_engine_ =
       file == base::kInvalidPlatformFileValue && !language.empty();
@@ -386,6 +396,10 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         word_to_check, tag, &word_correct));
 #endif
   } else {
+    SpellingCache::const_iterator cached = spelling_cache_.find(word_to_check);
+    if (cached != spelling_cache_.end())
+      return cached->second;
+
     std::string word_to_check_utf8(UTF16ToUTF8(word_to_check));
     // Hunspell shouldn't let us exceed its max, but check just in case
     if (word_to_check_utf8.length() < MAXWORDLEN) {
@@ -393,6 +407,9 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         // |hunspell_->spell| returns 0 if the word is spelled correctly and
         // non-zero otherwsie.
         word_correct = (hunspell_->spell(word_to_check_utf8.c_str()) != 0);
+        if (spelling_cache_.size() >= kMaxCachedWords)
+          spelling_cache_.clear();
+        spelling_cache_[word_to_check] = word_correct;
       } else {
         // If |hunspell_| is NULL here, an error has occurred, but it's better
         // to check rather than crash.
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/gtest_prod_util.h"
+#include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -104,9 +105,13 @@ class SpellCheck : public content::RenderProcessObserver,
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, GetAutoCorrectionWord_EN_US);
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest,
       RequestSpellCheckMultipleTimesWithoutInitialization);
+  FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, CachedWordAddedToDictionary);
 
   class SpellCheckRequestParam;
 
+  // Whether each word was spelled correctly, keyed by the word.
+  typedef base::hash_map<string16, bool> SpellingCache;
+
   // RenderProcessObserver implementation:
   virtual bool OnControlMessageReceived(const IPC::Message& message) OVERRIDE;
 
@@ -161,6 +166,12 @@ class SpellCheck : public content::RenderProcessObserver,
   base::PlatformFile file_;
   std::vector<std::string> custom_words_;
 
+  // The results of the recent hunspell lookups. WebKit checks a whole
+  // paragraph again after each edit, so almost all of its words were looked
+  // up moments before. Cleared when the dictionary changes and when it grows
+  // too big.
+  SpellingCache spelling_cache_;
+
   // Represents character attributes used for filtering out characters which
   // are not supported by this SpellCheck object.
   SpellcheckCharAttribute character_attributes_;
@@ -1005,6 +1005,19 @@ TEST_F(SpellCheckTest, RequestSpellCheckWithMultipleRequests) {
   }
 }
 
+// Words are looked up in the cache of earlier results, which must be dropped
+// when a word is added to the dictionary.
+TEST_F(SpellCheckTest, CachedWordAddedToDictionary) {
+  const string16 text = ASCIIToUTF16("zz");
+  std::vector<SpellCheckResult> expected;
+  expected.push_back(SpellCheckResult(SpellCheckResult::SPELLING, 0, 2));
+  TestSpellCheckParagraph(text, expected);
+  TestSpellCheckParagraph(text, expected);
+
+  spell_check()->OnWordAdded("zz");
+  TestSpellCheckParagraph(text, std::vector<SpellCheckResult>());
+}
+
 // A test case that spellchecking is requested before initializing.
 // In this case, we postpone to post a request.
 TEST_F(SpellCheckTest, RequestSpellCheckWithoutInitialization) {
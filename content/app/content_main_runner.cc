@@ -487,6 +487,10 @@ static void GetStatsThunk(char* buffer, int buffer_length) {
 static void ReleaseFreeMemoryThunk() {
   MallocExtension::instance()->ReleaseFreeMemory();
 }
+
+static void GetHeapSampleThunk(std::string* writer) {
+  MallocExtension::instance()->GetHeapSample(writer);
+}
 #endif
 
 
@@ -528,6 +532,7 @@ static void ReleaseFreeMemoryThunk() {
     base::allocator::SetGetPropertyFunction(GetPropertyThunk);
     base::allocator::SetGetStatsFunction(GetStatsThunk);
     base::allocator::SetReleaseFreeMemoryFunction(ReleaseFreeMemoryThunk);
+    base::allocator::SetGetHeapSampleFunction(GetHeapSampleThunk);
 
     // Provide optional hook for monitoring allocation quantities on a
     // per-thread basis.  Only set the hook if the environment indicates this
@@ -38,6 +38,12 @@ void AppCacheDispatcherHost::OnChannelConnected(int32 peer_pid) {
   }
 }
 
+bool AppCacheDispatcherHost::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  supported_message_classes->push_back(AppCacheMsgStart);
+  return true;
+}
+
 bool AppCacheDispatcherHost::OnMessageReceived(const IPC::Message& message,
                                                bool* message_was_ok) {
   bool handled = true;
@@ -29,6 +29,8 @@ class AppCacheDispatcherHost : public content::BrowserMessageFilter {
   virtual void OnChannelConnected(int32 peer_pid) OVERRIDE;
   virtual bool OnMessageReceived(const IPC::Message& message,
                                  bool* message_was_ok) OVERRIDE;
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE;
 
  protected:
   virtual ~AppCacheDispatcherHost();
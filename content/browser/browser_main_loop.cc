@@ -67,6 +67,7 @@
 
 #if defined(OS_LINUX)
 #include "content/browser/device_monitor_linux.h"
+#include "content/browser/memory_pressure_monitor_linux.h"
 #elif defined(OS_MACOSX)
 #include "content/browser/device_monitor_mac.h"
 #endif
@@ -521,6 +522,8 @@ void BrowserMainLoop::ShutdownThreadsAndCleanUp() {
   // goes away.
 #if defined(OS_WIN)
   system_message_window_.reset();
+#elif defined(OS_LINUX)
+  memory_pressure_monitor_linux_.reset();
 #elif defined(OS_MACOSX)
   device_monitor_mac_.reset();
 #endif
@@ -649,6 +652,7 @@ void BrowserMainLoop::BrowserThreadsStarted() {
 
 #if defined(OS_LINUX)
   device_monitor_linux_.reset(new DeviceMonitorLinux());
+  memory_pressure_monitor_linux_.reset(new MemoryPressureMonitorLinux());
 #elif defined(OS_MACOSX)
   device_monitor_mac_.reset(new DeviceMonitorMac());
 #endif
@@ -50,6 +50,7 @@ struct MainFunctionParams;
 
 #if defined(OS_LINUX)
 class DeviceMonitorLinux;
+class MemoryPressureMonitorLinux;
 #elif defined(OS_MACOSX)
 class DeviceMonitorMac;
 #endif
@@ -113,6 +114,7 @@ class BrowserMainLoop {
   scoped_ptr<SystemMessageWindowWin> system_message_window_;
 #elif defined(OS_LINUX)
   scoped_ptr<DeviceMonitorLinux> device_monitor_linux_;
+  scoped_ptr<MemoryPressureMonitorLinux> memory_pressure_monitor_linux_;
 #elif defined(OS_MACOSX) && !defined(OS_IOS)
   scoped_ptr<DeviceMonitorMac> device_monitor_mac_;
 #endif
@@ -70,6 +70,12 @@ base::TaskRunner* DOMStorageMessageFilter::OverrideTaskRunnerForMessage(
   return NULL;
 }
 
+bool DOMStorageMessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  supported_message_classes->push_back(DOMStorageMsgStart);
+  return true;
+}
+
 bool DOMStorageMessageFilter::OnMessageReceived(const IPC::Message& message,
                                                 bool* message_was_ok) {
   if (IPC_MESSAGE_CLASS(message) != DOMStorageMsgStart)
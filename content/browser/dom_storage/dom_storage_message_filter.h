@@ -43,6 +43,8 @@ class DOMStorageMessageFilter
       const IPC::Message& message) OVERRIDE;
   virtual bool OnMessageReceived(const IPC::Message& message,
                                  bool* message_was_ok) OVERRIDE;
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE;
 
   // Message Handlers.
   void OnOpenStorageArea(int connection_id, int64 namespace_id,
@@ -28,6 +28,11 @@
 #elif defined(OS_MACOSX)
 #include "content/browser/download/file_metadata_mac.h"
 #elif defined(OS_LINUX)
+#include <fcntl.h>
+#include <linux/falloc.h>
+#include <unistd.h>
+
+#include "base/eintr_wrapper.h"
 #include "content/browser/download/file_metadata_linux.h"
 #endif
 
@@ -219,6 +224,7 @@ BaseFile::BaseFile(const FilePath& full_path,
       start_tick_(base::TimeTicks::Now()),
       calculate_hash_(calculate_hash),
       detached_(false),
+      preallocated_(false),
       bound_net_log_(bound_net_log) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
   memcpy(sha256_hash_, kEmptySha256Hash, kSha256HashLen);
@@ -324,6 +330,27 @@ net::Error BaseFile::AppendDataToFile(const char* data, size_t data_len) {
   return net::OK;
 }
 
+void BaseFile::Preallocate(int64 total_bytes) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+#if defined(OS_LINUX)
+  if (!file_stream_.get() || total_bytes <= bytes_so_far_)
+    return;
+
+  // FALLOC_FL_KEEP_SIZE leaves the file size alone, which the writes at the
+  // end of the file and the resumption code rely on. Failures, e.g. from file
+  // systems without fallocate() support, are ignored.
+  int fd = HANDLE_EINTR(open(full_path_.value().c_str(), O_WRONLY));
+  if (fd < 0)
+    return;
+  if (fallocate(fd, FALLOC_FL_KEEP_SIZE, bytes_so_far_,
+                total_bytes - bytes_so_far_) == 0) {
+    preallocated_ = true;
+  }
+  if (HANDLE_EINTR(close(fd)) < 0)
+    PLOG(ERROR) << "close";
+#endif
+}
+
 net::Error BaseFile::Rename(const FilePath& new_path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
 
@@ -427,6 +454,11 @@ void BaseFile::Finish() {
   if (calculate_hash_)
     secure_hash_->Finish(sha256_hash_, kSha256HashLen);
 
+  // Truncating to the current size releases any space reserved by
+  // Preallocate() that the download did not use.
+  if (preallocated_ && file_stream_.get())
+    file_stream_->Truncate(bytes_so_far_);
+
   Close();
 }
 
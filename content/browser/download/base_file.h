@@ -51,6 +51,13 @@ class CONTENT_EXPORT BaseFile {
   // or a network error code on failure.
   net::Error AppendDataToFile(const char* data, size_t data_len);
 
+  // Reserves disk space for the file to grow to |total_bytes| without
+  // changing its size, so that large downloads are written to contiguous
+  // blocks without growing the file one write at a time. This is only a hint
+  // and does nothing where the platform or file system does not support it.
+  // The unused part of the reservation is released by Finish().
+  void Preallocate(int64 total_bytes);
+
   // Rename the download file.
   // Returns net::OK on success, or a network error code on failure.
   virtual net::Error Rename(const FilePath& full_path);
@@ -140,6 +147,9 @@ class CONTENT_EXPORT BaseFile {
   // won't delete it on destruction.
   bool detached_;
 
+  // Whether Preallocate() reserved disk space past the end of the file.
+  bool preallocated_;
+
   net::BoundNetLog bound_net_log_;
 
   DISALLOW_COPY_AND_ASSIGN(BaseFile);
@@ -270,6 +270,22 @@ TEST_F(BaseFileTest, WriteAndDetach) {
   expect_file_survives_ = true;
 }
 
+// Reserving space for the download must not change the file's size, either
+// while it is written or once it is finished.
+TEST_F(BaseFileTest, PreallocateKeepsSize) {
+  ASSERT_EQ(net::OK, base_file_->Initialize(temp_dir_.path()));
+  base_file_->Preallocate(1024 * 1024);
+  ASSERT_EQ(net::OK, AppendDataToFile(kTestData1));
+
+  int64 size = 0;
+  EXPECT_TRUE(file_util::GetFileSize(base_file_->full_path(), &size));
+  EXPECT_EQ(static_cast<int64>(kTestDataLength1), size);
+
+  base_file_->Finish();
+  EXPECT_TRUE(file_util::GetFileSize(base_file_->full_path(), &size));
+  EXPECT_EQ(static_cast<int64>(kTestDataLength1), size);
+}
+
 // Write data to the file and detach it, and calculate its sha256 hash.
 TEST_F(BaseFileTest, WriteWithHashAndDetach) {
   // Calculate the final hash.
@@ -87,6 +87,10 @@ struct CONTENT_EXPORT DownloadCreateInfo {
   // For continuing a download, the ETAG of the file.
   std::string etag;
 
+  // The Accept-Ranges header of the response, which tells whether the file
+  // can be fetched in slices.
+  std::string accept_ranges;
+
   // True if we should display the 'save as...' UI and prompt the user
   // for the download location.
   // False if the UI should be suppressed and the download performed to the
@@ -27,6 +27,11 @@ using content::DownloadManager;
 const int kUpdatePeriodMs = 500;
 const int kMaxTimeBlockingFileThreadMs = 1000;
 
+// Consecutive buffers read from the stream are combined into writes of up to
+// this many bytes, so that fast downloads are not limited by the cost of one
+// write per buffer.
+const size_t kMaxWriteSize = 1024 * 1024;
+
 DownloadFileImpl::DownloadFileImpl(
     const DownloadCreateInfo* info,
     scoped_ptr<content::ByteStreamReader> stream,
@@ -46,6 +51,7 @@ DownloadFileImpl::DownloadFileImpl(
           stream_reader_(stream.Pass()),
           id_(info->download_id),
           default_download_directory_(info->default_download_directory),
+          expected_total_bytes_(info->total_bytes),
           request_handle_(request_handle),
           download_manager_(download_manager),
           bytes_seen_(0),
@@ -69,6 +75,9 @@ content::DownloadInterruptReason DownloadFileImpl::Initialize() {
         net_result, content::DOWNLOAD_INTERRUPT_FROM_DISK);
   }
 
+  if (expected_total_bytes_ > 0)
+    file_.Preallocate(expected_total_bytes_);
+
   stream_reader_->RegisterCallback(
       base::Bind(&DownloadFileImpl::StreamActive, weak_factory_.GetWeakPtr()));
 
@@ -219,24 +228,38 @@ void DownloadFileImpl::StreamActive() {
       content::DOWNLOAD_INTERRUPT_REASON_NONE;
   base::TimeDelta delta(
       base::TimeDelta::FromMilliseconds(kMaxTimeBlockingFileThreadMs));
+  // Buffers read from the stream but not written yet.
+  BufferList pending_buffers;
+  size_t pending_size = 0;
 
   // Take care of any file local activity required.
   do {
     state = stream_reader_->Read(&incoming_data, &incoming_data_size);
 
+    // Write the buffers held back so far once no more data follows them
+    // right away or the next buffer would make the write too large.
+    if (!pending_buffers.empty() &&
+        (state != content::ByteStreamReader::STREAM_HAS_DATA ||
+         pending_size + incoming_data_size > kMaxWriteSize)) {
+      reason = WriteBuffers(pending_buffers, pending_size);
+      pending_buffers.clear();
+      pending_size = 0;
+      if (reason != content::DOWNLOAD_INTERRUPT_REASON_NONE) {
+        now = base::TimeTicks::Now();
+        break;
+      }
+    }
+
     switch (state) {
       case content::ByteStreamReader::STREAM_EMPTY:
         break;
       case content::ByteStreamReader::STREAM_HAS_DATA:
-        {
-          ++num_buffers;
-          base::TimeTicks write_start(base::TimeTicks::Now());
-          reason = AppendDataToFile(
-              incoming_data.get()->data(), incoming_data_size);
-          disk_writes_time_ += (base::TimeTicks::Now() - write_start);
-          bytes_seen_ += incoming_data_size;
-          total_incoming_data_size += incoming_data_size;
-        }
+        ++num_buffers;
+        pending_buffers.push_back(
+            std::make_pair(incoming_data, incoming_data_size));
+        pending_size += incoming_data_size;
+        bytes_seen_ += incoming_data_size;
+        total_incoming_data_size += incoming_data_size;
         break;
       case content::ByteStreamReader::STREAM_COMPLETE:
         {
@@ -260,6 +283,13 @@ void DownloadFileImpl::StreamActive() {
            reason == content::DOWNLOAD_INTERRUPT_REASON_NONE &&
            now - start <= delta);
 
+  // Yielding the thread with data still held back.
+  if (!pending_buffers.empty() &&
+      reason == content::DOWNLOAD_INTERRUPT_REASON_NONE) {
+    reason = WriteBuffers(pending_buffers, pending_size);
+    now = base::TimeTicks::Now();
+  }
+
   // If we're stopping to yield the thread, post a task so we come back.
   if (state == content::ByteStreamReader::STREAM_HAS_DATA &&
       now - start > delta) {
@@ -307,6 +337,27 @@ void DownloadFileImpl::StreamActive() {
   }
 }
 
+content::DownloadInterruptReason DownloadFileImpl::WriteBuffers(
+    const BufferList& buffers, size_t total_size) {
+  base::TimeTicks write_start(base::TimeTicks::Now());
+  content::DownloadInterruptReason reason;
+  if (buffers.size() == 1) {
+    reason = AppendDataToFile(buffers[0].first->data(), buffers[0].second);
+  } else {
+    combined_data_.resize(total_size);
+    size_t offset = 0;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      memcpy(&combined_data_[offset], buffers[i].first->data(),
+             buffers[i].second);
+      offset += buffers[i].second;
+    }
+    reason = AppendDataToFile(&combined_data_[0], total_size);
+  }
+  disk_writes_time_ += (base::TimeTicks::Now() - write_start);
+  download_stats::RecordFileThreadBuffersPerWrite(buffers.size());
+  return reason;
+}
+
 void DownloadFileImpl::SendUpdate() {
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
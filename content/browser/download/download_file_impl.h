@@ -7,6 +7,9 @@
 
 #include "content/browser/download/download_file.h"
 
+#include <utility>
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -19,6 +22,10 @@
 
 struct DownloadCreateInfo;
 
+namespace net {
+class IOBuffer;
+}
+
 namespace content {
 class ByteStreamReader;
 class DownloadManager;
@@ -67,10 +74,17 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public content::DownloadFile {
   // Send an update on our progress.
   void SendUpdate();
 
+  typedef std::vector<std::pair<scoped_refptr<net::IOBuffer>, size_t> >
+      BufferList;
+
   // Called when there's some activity on stream_reader_ that needs to be
   // handled.
   void StreamActive();
 
+  // Appends the |total_size| bytes in |buffers| to the file in one write.
+  content::DownloadInterruptReason WriteBuffers(const BufferList& buffers,
+                                                size_t total_size);
+
   // The base file instance.
   BaseFile file_;
 
@@ -87,6 +101,12 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public content::DownloadFile {
   // The default directory for creating the download file.
   FilePath default_download_directory_;
 
+  // The size the server announced for the download, or 0 if unknown.
+  int64 expected_total_bytes_;
+
+  // Holds the data of writes combined from several buffers.
+  std::vector<char> combined_data_;
+
   // Used to trigger progress updates.
   scoped_ptr<base::RepeatingTimer<DownloadFileImpl> > update_timer_;
 
@@ -194,6 +194,7 @@ bool DownloadResourceHandler::OnResponseStarted(
           NULL, "Accept-Ranges", &accept_ranges_)) {
     accept_ranges_ = "";
   }
+  info->accept_ranges = accept_ranges_;
 
   info->prompt_user_for_save_location =
       save_info_.prompt_for_save_location && save_info_.file_path.empty();
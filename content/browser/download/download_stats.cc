@@ -258,6 +258,11 @@ void RecordFileThreadReceiveBuffers(size_t num_buffers) {
       100, 100);
 }
 
+void RecordFileThreadBuffersPerWrite(size_t num_buffers) {
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Download.FileThreadBuffersPerWrite", num_buffers, 1, 100, 100);
+}
+
 void RecordBandwidth(double actual_bandwidth, double potential_bandwidth) {
   UMA_HISTOGRAM_CUSTOM_COUNTS(
       "Download.ActualBandwidth", actual_bandwidth, 1, 1000000000, 50);
@@ -116,6 +116,9 @@ void RecordDownloadWriteLoopCount(int count);
 // before the file thread gets to draining them.
 void RecordFileThreadReceiveBuffers(size_t num_buffers);
 
+// Record the number of received buffers combined into one write to the file.
+void RecordFileThreadBuffersPerWrite(size_t num_buffers);
+
 // Record the bandwidth seen in DownloadResourceHandler
 // |actual_bandwidth| and |potential_bandwidth| are in bytes/second.
 void RecordBandwidth(double actual_bandwidth, double potential_bandwidth);
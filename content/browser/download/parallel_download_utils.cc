@@ -0,0 +1,104 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/download/parallel_download_utils.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/string_util.h"
+
+namespace content {
+
+DownloadSlice::DownloadSlice(int64 offset, int64 length)
+    : offset(offset),
+      length(length) {
+}
+
+bool CanDownloadInParallel(const std::string& accept_ranges,
+                           const std::string& etag,
+                           const std::string& last_modified,
+                           int64 total_bytes) {
+  return LowerCaseEqualsASCII(accept_ranges, "bytes") &&
+      (!etag.empty() || !last_modified.empty()) &&
+      total_bytes >= kMinParallelDownloadBytes;
+}
+
+std::vector<DownloadSlice> FindSlicesToDownload(int64 received_bytes,
+                                                int64 total_bytes,
+                                                int max_slices) {
+  DCHECK_GT(max_slices, 0);
+  std::vector<DownloadSlice> slices;
+  int64 remaining_bytes = total_bytes - received_bytes;
+  if (remaining_bytes <= 0)
+    return slices;
+
+  int64 slice_count = std::max<int64>(
+      1, std::min<int64>(max_slices, remaining_bytes / kMinSliceBytes));
+  int64 slice_bytes = remaining_bytes / slice_count;
+  for (int64 i = 0; i < slice_count - 1; ++i)
+    slices.push_back(DownloadSlice(received_bytes + i * slice_bytes,
+                                   slice_bytes));
+  slices.push_back(DownloadSlice(
+      received_bytes + (slice_count - 1) * slice_bytes, 0));
+  return slices;
+}
+
+std::vector<DownloadSlice> FindRemainingSlices(
+    const std::vector<DownloadSlice>& slices,
+    const std::vector<int64>& received_bytes) {
+  DCHECK_EQ(slices.size(), received_bytes.size());
+  std::vector<DownloadSlice> remaining;
+  for (size_t i = 0; i < slices.size(); ++i) {
+    const DownloadSlice& slice = slices[i];
+    DCHECK(slice.length == 0 || received_bytes[i] <= slice.length);
+    if (slice.length == 0) {
+      // Whether a slice running to the end of the file is finished is only
+      // known from the response, so it is always resumed.
+      remaining.push_back(DownloadSlice(slice.offset + received_bytes[i], 0));
+    } else if (received_bytes[i] < slice.length) {
+      remaining.push_back(DownloadSlice(slice.offset + received_bytes[i],
+                                        slice.length - received_bytes[i]));
+    }
+  }
+  return remaining;
+}
+
+ParallelDownloadConnectionLimiter::ParallelDownloadConnectionLimiter(
+    int max_connections_per_server)
+    : max_connections_per_server_(max_connections_per_server) {
+  DCHECK_GT(max_connections_per_server, 0);
+}
+
+ParallelDownloadConnectionLimiter::~ParallelDownloadConnectionLimiter() {
+}
+
+int ParallelDownloadConnectionLimiter::Acquire(
+    const net::HostPortPair& server, int wanted) {
+  DCHECK_GE(wanted, 0);
+  int& open = open_connections_[server];
+  int granted = std::min(wanted, max_connections_per_server_ - open);
+  open += granted;
+  if (open == 0)
+    open_connections_.erase(server);
+  return granted;
+}
+
+void ParallelDownloadConnectionLimiter::Release(
+    const net::HostPortPair& server, int count) {
+  ConnectionCountMap::iterator it = open_connections_.find(server);
+  DCHECK(it != open_connections_.end());
+  DCHECK_LE(count, it->second);
+  it->second -= count;
+  if (it->second <= 0)
+    open_connections_.erase(it);
+}
+
+int ParallelDownloadConnectionLimiter::GetOpenConnections(
+    const net::HostPortPair& server) const {
+  ConnectionCountMap::const_iterator it = open_connections_.find(server);
+  return it == open_connections_.end() ? 0 : it->second;
+}
+
+}  // namespace content
@@ -0,0 +1,91 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Helpers for fetching a large download over several connections at once,
+// each one fetching a slice of the file with a range request.
+
+#ifndef CONTENT_BROWSER_DOWNLOAD_PARALLEL_DOWNLOAD_UTILS_H_
+#define CONTENT_BROWSER_DOWNLOAD_PARALLEL_DOWNLOAD_UTILS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "content/common/content_export.h"
+#include "net/base/host_port_pair.h"
+
+namespace content {
+
+// Downloads smaller than this are fetched over a single connection.
+const int64 kMinParallelDownloadBytes = 8 * 1024 * 1024;
+
+// No slice is made smaller than this, so that the cost of an extra
+// connection is paid back by the data fetched over it.
+const int64 kMinSliceBytes = 2 * 1024 * 1024;
+
+// A part of a download fetched by its own range request.
+struct CONTENT_EXPORT DownloadSlice {
+  DownloadSlice(int64 offset, int64 length);
+
+  int64 offset;
+
+  // The number of bytes in the slice, or 0 if it runs to the end of the file.
+  int64 length;
+};
+
+// Returns true if a download of |total_bytes| can be split into slices. The
+// server must accept byte ranges, |accept_ranges| being the value of its
+// Accept-Ranges header, and must identify the version of the file with an
+// ETag or a Last-Modified header so that every slice comes from the same
+// version.
+CONTENT_EXPORT bool CanDownloadInParallel(const std::string& accept_ranges,
+                                          const std::string& etag,
+                                          const std::string& last_modified,
+                                          int64 total_bytes);
+
+// Splits the part of a |total_bytes| download after the first
+// |received_bytes| into at most |max_slices| slices of at least
+// kMinSliceBytes each, in file order. The last slice runs to the end of the
+// file.
+CONTENT_EXPORT std::vector<DownloadSlice> FindSlicesToDownload(
+    int64 received_bytes,
+    int64 total_bytes,
+    int max_slices);
+
+// Returns what is left of |slices| when |received_bytes|[i] bytes of
+// |slices|[i] are already on disk, which are the range requests that resume
+// the download. Finished slices are dropped.
+CONTENT_EXPORT std::vector<DownloadSlice> FindRemainingSlices(
+    const std::vector<DownloadSlice>& slices,
+    const std::vector<int64>& received_bytes);
+
+// Caps the number of connections that parallel downloads open to each
+// server, across all downloads. Lives on the IO thread.
+class CONTENT_EXPORT ParallelDownloadConnectionLimiter {
+ public:
+  explicit ParallelDownloadConnectionLimiter(int max_connections_per_server);
+  ~ParallelDownloadConnectionLimiter();
+
+  // Returns how many of the |wanted| additional connections to |server| may
+  // be opened, and counts them as open until they are released.
+  int Acquire(const net::HostPortPair& server, int wanted);
+
+  // Releases |count| connections to |server| returned by Acquire().
+  void Release(const net::HostPortPair& server, int count);
+
+  int GetOpenConnections(const net::HostPortPair& server) const;
+
+ private:
+  typedef std::map<net::HostPortPair, int> ConnectionCountMap;
+
+  const int max_connections_per_server_;
+  ConnectionCountMap open_connections_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelDownloadConnectionLimiter);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_DOWNLOAD_PARALLEL_DOWNLOAD_UTILS_H_
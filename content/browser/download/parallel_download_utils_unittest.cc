@@ -0,0 +1,90 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/download/parallel_download_utils.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+TEST(ParallelDownloadUtilsTest, CanDownloadInParallel) {
+  const int64 kLarge = kMinParallelDownloadBytes;
+  EXPECT_TRUE(CanDownloadInParallel("bytes", "\"abc\"", "", kLarge));
+  EXPECT_TRUE(CanDownloadInParallel("Bytes", "", "Wed, 1 Aug 2012", kLarge));
+  EXPECT_FALSE(CanDownloadInParallel("none", "\"abc\"", "", kLarge));
+  EXPECT_FALSE(CanDownloadInParallel("", "\"abc\"", "", kLarge));
+  EXPECT_FALSE(CanDownloadInParallel("bytes", "", "", kLarge));
+  EXPECT_FALSE(CanDownloadInParallel("bytes", "\"abc\"", "", kLarge - 1));
+}
+
+TEST(ParallelDownloadUtilsTest, FindSlicesToDownload) {
+  // Enough data for four slices.
+  std::vector<DownloadSlice> slices =
+      FindSlicesToDownload(100, 100 + 4 * kMinSliceBytes, 4);
+  ASSERT_EQ(4u, slices.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(100 + i * kMinSliceBytes, slices[i].offset);
+    EXPECT_EQ(kMinSliceBytes, slices[i].length);
+  }
+  EXPECT_EQ(100 + 3 * kMinSliceBytes, slices[3].offset);
+  EXPECT_EQ(0, slices[3].length);
+
+  // Capped by |max_slices|.
+  slices = FindSlicesToDownload(0, 10 * kMinSliceBytes, 2);
+  ASSERT_EQ(2u, slices.size());
+  EXPECT_EQ(0, slices[0].offset);
+  EXPECT_EQ(5 * kMinSliceBytes, slices[0].length);
+  EXPECT_EQ(5 * kMinSliceBytes, slices[1].offset);
+
+  // Too little data left to split.
+  slices = FindSlicesToDownload(10, kMinSliceBytes, 4);
+  ASSERT_EQ(1u, slices.size());
+  EXPECT_EQ(10, slices[0].offset);
+  EXPECT_EQ(0, slices[0].length);
+
+  // Nothing left.
+  EXPECT_TRUE(FindSlicesToDownload(10, 10, 4).empty());
+}
+
+TEST(ParallelDownloadUtilsTest, FindRemainingSlices) {
+  std::vector<DownloadSlice> slices;
+  slices.push_back(DownloadSlice(0, 100));
+  slices.push_back(DownloadSlice(100, 100));
+  slices.push_back(DownloadSlice(200, 0));
+  std::vector<int64> received_bytes;
+  received_bytes.push_back(100);
+  received_bytes.push_back(30);
+  received_bytes.push_back(50);
+
+  std::vector<DownloadSlice> remaining =
+      FindRemainingSlices(slices, received_bytes);
+  ASSERT_EQ(2u, remaining.size());
+  EXPECT_EQ(130, remaining[0].offset);
+  EXPECT_EQ(70, remaining[0].length);
+  EXPECT_EQ(250, remaining[1].offset);
+  EXPECT_EQ(0, remaining[1].length);
+}
+
+TEST(ParallelDownloadUtilsTest, ConnectionLimiter) {
+  ParallelDownloadConnectionLimiter limiter(4);
+  net::HostPortPair server("example.com", 80);
+  net::HostPortPair other_server("example.org", 80);
+
+  EXPECT_EQ(3, limiter.Acquire(server, 3));
+  EXPECT_EQ(1, limiter.Acquire(server, 3));
+  EXPECT_EQ(0, limiter.Acquire(server, 1));
+  EXPECT_EQ(2, limiter.Acquire(other_server, 2));
+  EXPECT_EQ(4, limiter.GetOpenConnections(server));
+
+  limiter.Release(server, 2);
+  EXPECT_EQ(2, limiter.GetOpenConnections(server));
+  EXPECT_EQ(2, limiter.Acquire(server, 3));
+
+  limiter.Release(server, 4);
+  limiter.Release(other_server, 2);
+  EXPECT_EQ(0, limiter.GetOpenConnections(server));
+  EXPECT_EQ(0, limiter.GetOpenConnections(other_server));
+}
+
+}  // namespace content
@@ -15,6 +15,9 @@ using webkit_blob::BlobStorageController;
 
 static const char* kBlobStorageContextKeyName = "content_blob_storage_context";
 
+// Blob bytes held in memory beyond this are written out to temporary files.
+static const int64 kBlobMemoryBudget = 256 * 1024 * 1024;
+
 ChromeBlobStorageContext::ChromeBlobStorageContext() {}
 
 ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
@@ -39,6 +42,9 @@ ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
 void ChromeBlobStorageContext::InitializeOnIOThread() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   controller_.reset(new BlobStorageController());
+  controller_->EnableDiskSpill(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE),
+      kBlobMemoryBudget);
 }
 
 ChromeBlobStorageContext::~ChromeBlobStorageContext() {}
@@ -162,6 +162,7 @@ void BrowserGpuChannelHostFactory::EstablishGpuChannelOnIO(
   host->EstablishGpuChannel(
       gpu_client_id_,
       true,
+      true,
       base::Bind(&BrowserGpuChannelHostFactory::GpuChannelEstablishedOnIO,
                  base::Unretained(this),
                  request));
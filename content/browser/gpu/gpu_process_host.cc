@@ -18,6 +18,7 @@
 #include "content/browser/gpu/gpu_data_manager_impl.h"
 #include "content/browser/gpu/gpu_process_host_ui_shim.h"
 #include "content/browser/gpu/gpu_surface_tracker.h"
+#include "content/browser/gpu/shader_disk_cache.h"
 #include "content/browser/renderer_host/render_widget_helper.h"
 #include "content/browser/renderer_host/render_widget_host_impl.h"
 #include "content/common/child_process_host_impl.h"
@@ -52,6 +53,7 @@ using content::RenderProcessHost;
 using content::RenderWidgetHelper;
 using content::RenderWidgetHost;
 using content::RenderWidgetHostImpl;
+using content::ShaderDiskCache;
 
 bool GpuProcessHost::gpu_enabled_ = true;
 bool GpuProcessHost::hardware_gpu_enabled_ = true;
@@ -444,7 +446,24 @@ bool GpuProcessHost::Init() {
     return false;
   }
 
-  return Send(new GpuMsg_Initialize());
+  if (!Send(new GpuMsg_Initialize()))
+    return false;
+
+  // Give the GPU process the programs it linked in previous runs.
+  ShaderDiskCache* shader_disk_cache = ShaderDiskCache::GetInstance();
+  if (shader_disk_cache) {
+    shader_disk_cache->LoadAll(
+        base::Bind(&GpuProcessHost::SendLoadedProgram, host_id_));
+  }
+  return true;
+}
+
+// static
+void GpuProcessHost::SendLoadedProgram(int host_id,
+                                       const std::string& program) {
+  GpuProcessHost* host = GpuProcessHost::FromID(host_id);
+  if (host)
+    host->Send(new GpuMsg_LoadedProgram(program));
 }
 
 void GpuProcessHost::RouteOnUIThread(const IPC::Message& message) {
@@ -474,6 +493,7 @@ bool GpuProcessHost::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(GpuHostMsg_ChannelEstablished, OnChannelEstablished)
     IPC_MESSAGE_HANDLER(GpuHostMsg_CommandBufferCreated, OnCommandBufferCreated)
     IPC_MESSAGE_HANDLER(GpuHostMsg_DestroyCommandBuffer, OnDestroyCommandBuffer)
+    IPC_MESSAGE_HANDLER(GpuHostMsg_CacheProgram, OnCacheProgram)
 #if defined(OS_MACOSX)
     IPC_MESSAGE_HANDLER(GpuHostMsg_AcceleratedSurfaceBuffersSwapped,
                         OnAcceleratedSurfaceBuffersSwapped)
@@ -506,6 +526,7 @@ void GpuProcessHost::OnChannelConnected(int32 peer_pid) {
 void GpuProcessHost::EstablishGpuChannel(
     int client_id,
     bool share_context,
+    bool preempts_other_channels,
     const EstablishChannelCallback& callback) {
   DCHECK(CalledOnValidThread());
   TRACE_EVENT0("gpu", "GpuProcessHostUIShim::EstablishGpuChannel");
@@ -518,7 +539,8 @@ void GpuProcessHost::EstablishGpuChannel(
     return;
   }
 
-  if (Send(new GpuMsg_EstablishChannel(client_id, share_context))) {
+  if (Send(new GpuMsg_EstablishChannel(
+          client_id, share_context, preempts_other_channels))) {
     channel_requests_.push(callback);
   } else {
     EstablishChannelError(
@@ -593,6 +615,13 @@ void GpuProcessHost::OnChannelEstablished(
                GpuDataManagerImpl::GetInstance()->GetGPUInfo());
 }
 
+void GpuProcessHost::OnCacheProgram(const std::string& key,
+                                    const std::string& program) {
+  ShaderDiskCache* shader_disk_cache = ShaderDiskCache::GetInstance();
+  if (shader_disk_cache)
+    shader_disk_cache->Store(key, program);
+}
+
 void GpuProcessHost::OnCommandBufferCreated(const int32 route_id) {
   TRACE_EVENT0("gpu", "GpuProcessHostUIShim::OnCommandBufferCreated");
 
@@ -76,9 +76,11 @@ class GpuProcessHost : public content::BrowserChildProcessHostDelegate,
 
   // Tells the GPU process to create a new channel for communication with a
   // client. Once the GPU process responds asynchronously with the IPC handle
-  // and GPUInfo, we call the callback.
+  // and GPUInfo, we call the callback. If |preempts_other_channels| is true,
+  // the other channels yield to this one when it has pending work.
   void EstablishGpuChannel(int client_id,
                            bool share_context,
+                           bool preempts_other_channels,
                            const EstablishChannelCallback& callback);
 
   // Tells the GPU process to create a new command buffer that draws into the
@@ -106,6 +108,10 @@ class GpuProcessHost : public content::BrowserChildProcessHostDelegate,
 
   bool Init();
 
+  // Sends a program from the shader disk cache to the GPU process of
+  // |host_id|, if it still exists.
+  static void SendLoadedProgram(int host_id, const std::string& program);
+
   // Post an IPC message to the UI shim's message handler on the UI thread.
   void RouteOnUIThread(const IPC::Message& message);
 
@@ -120,6 +126,7 @@ class GpuProcessHost : public content::BrowserChildProcessHostDelegate,
   void OnChannelEstablished(const IPC::ChannelHandle& channel_handle);
   void OnCommandBufferCreated(const int32 route_id);
   void OnDestroyCommandBuffer(int32 surface_id);
+  void OnCacheProgram(const std::string& key, const std::string& program);
 
 #if defined(OS_MACOSX)
   void OnAcceleratedSurfaceBuffersSwapped(
@@ -0,0 +1,230 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/gpu/shader_disk_cache.h"
+
+#include "base/bind.h"
+#include "base/file_path.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/content_browser_client.h"
+#include "content/public/common/content_client.h"
+#include "net/base/cache_type.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace content {
+
+namespace {
+
+// The GPU process keeps this much in memory, so there is no point in storing
+// more.
+const int kMaxCacheSizeBytes = 6 * 1024 * 1024;
+
+ShaderDiskCache* g_shader_disk_cache = NULL;
+bool g_shader_disk_cache_initialized = false;
+
+}  // namespace
+
+// Reads all the entries of the cache. Deletes itself when done.
+class ShaderDiskCache::ReadOperation {
+ public:
+  ReadOperation(disk_cache::Backend* backend, const ProgramCallback& callback)
+      : backend_(backend),
+        callback_(callback),
+        iter_(NULL),
+        entry_(NULL),
+        buf_len_(0) {
+  }
+
+  void OpenNextEntry() {
+    int rv = backend_->OpenNextEntry(
+        &iter_, &entry_,
+        base::Bind(&ReadOperation::OnEntryOpened, base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnEntryOpened(rv);
+  }
+
+ private:
+  ~ReadOperation() {
+    if (entry_)
+      entry_->Close();
+    if (iter_)
+      backend_->EndEnumeration(&iter_);
+  }
+
+  void OnEntryOpened(int result) {
+    if (result != net::OK) {
+      // There are no more entries.
+      delete this;
+      return;
+    }
+    buf_len_ = entry_->GetDataSize(0);
+    if (buf_len_ <= 0) {
+      OnDataRead(net::ERR_FAILED);
+      return;
+    }
+    buf_ = new net::IOBuffer(buf_len_);
+    int rv = entry_->ReadData(
+        0, 0, buf_, buf_len_,
+        base::Bind(&ReadOperation::OnDataRead, base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnDataRead(rv);
+  }
+
+  void OnDataRead(int result) {
+    if (result == buf_len_)
+      callback_.Run(std::string(buf_->data(), buf_len_));
+    entry_->Close();
+    entry_ = NULL;
+    buf_ = NULL;
+    OpenNextEntry();
+  }
+
+  disk_cache::Backend* backend_;
+  ProgramCallback callback_;
+  void* iter_;
+  disk_cache::Entry* entry_;
+  scoped_refptr<net::IOBuffer> buf_;
+  int buf_len_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadOperation);
+};
+
+// Writes a single entry, creating it if needed. Deletes itself when done.
+class ShaderDiskCache::WriteOperation {
+ public:
+  WriteOperation(disk_cache::Backend* backend,
+                 const std::string& key,
+                 const std::string& program)
+      : backend_(backend),
+        key_(key),
+        buf_(new net::StringIOBuffer(program)),
+        entry_(NULL) {
+  }
+
+  void CreateEntry() {
+    int rv = backend_->CreateEntry(
+        key_, &entry_,
+        base::Bind(&WriteOperation::OnEntryCreated, base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnEntryCreated(rv);
+  }
+
+ private:
+  ~WriteOperation() {
+    if (entry_)
+      entry_->Close();
+  }
+
+  void OnEntryCreated(int result) {
+    if (result == net::OK) {
+      WriteData();
+      return;
+    }
+    // The entry exists already.
+    int rv = backend_->OpenEntry(
+        key_, &entry_,
+        base::Bind(&WriteOperation::OnEntryOpened, base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnEntryOpened(rv);
+  }
+
+  void OnEntryOpened(int result) {
+    if (result != net::OK) {
+      delete this;
+      return;
+    }
+    WriteData();
+  }
+
+  void WriteData() {
+    int rv = entry_->WriteData(
+        0, 0, buf_, buf_->size(),
+        base::Bind(&WriteOperation::OnDataWritten, base::Unretained(this)),
+        true);
+    if (rv != net::ERR_IO_PENDING)
+      OnDataWritten(rv);
+  }
+
+  void OnDataWritten(int result) {
+    delete this;
+  }
+
+  disk_cache::Backend* backend_;
+  std::string key_;
+  scoped_refptr<net::StringIOBuffer> buf_;
+  disk_cache::Entry* entry_;
+
+  DISALLOW_COPY_AND_ASSIGN(WriteOperation);
+};
+
+// static
+ShaderDiskCache* ShaderDiskCache::GetInstance() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!g_shader_disk_cache_initialized) {
+    g_shader_disk_cache_initialized = true;
+    FilePath path =
+        GetContentClient()->browser()->GetShaderDiskCacheDirectory();
+    if (!path.empty())
+      g_shader_disk_cache = new ShaderDiskCache(path);
+  }
+  return g_shader_disk_cache;
+}
+
+ShaderDiskCache::ShaderDiskCache(const FilePath& path)
+    : backend_(NULL),
+      backend_created_(false) {
+  int rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, path, kMaxCacheSizeBytes, false,
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::CACHE),
+      NULL, &backend_,
+      base::Bind(&ShaderDiskCache::OnBackendCreated, base::Unretained(this)));
+  if (rv != net::ERR_IO_PENDING)
+    OnBackendCreated(rv);
+}
+
+ShaderDiskCache::~ShaderDiskCache() {
+  delete backend_;
+}
+
+void ShaderDiskCache::LoadAll(const ProgramCallback& callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!backend_created_) {
+    pending_operations_.push_back(base::Bind(
+        &ShaderDiskCache::LoadAll, base::Unretained(this), callback));
+    return;
+  }
+  if (backend_)
+    (new ReadOperation(backend_, callback))->OpenNextEntry();
+}
+
+void ShaderDiskCache::Store(const std::string& key,
+                            const std::string& program) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!backend_created_) {
+    pending_operations_.push_back(base::Bind(
+        &ShaderDiskCache::Store, base::Unretained(this), key, program));
+    return;
+  }
+  if (backend_)
+    (new WriteOperation(backend_, key, program))->CreateEntry();
+}
+
+void ShaderDiskCache::OnBackendCreated(int result) {
+  backend_created_ = true;
+  if (result != net::OK) {
+    LOG(WARNING) << "Could not create the shader disk cache: " << result;
+    delete backend_;
+    backend_ = NULL;
+  }
+  std::vector<base::Closure> operations;
+  operations.swap(pending_operations_);
+  for (size_t i = 0; i < operations.size(); ++i)
+    operations[i].Run();
+}
+
+}  // namespace content
@@ -0,0 +1,58 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_GPU_SHADER_DISK_CACHE_H_
+#define CONTENT_BROWSER_GPU_SHADER_DISK_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+
+class FilePath;
+
+namespace disk_cache {
+class Backend;
+}
+
+namespace content {
+
+// Stores the programs linked by the GPU process in a disk cache, so that they
+// can be given to the next GPU process instead of being compiled and linked
+// again. The disk cache is bounded, and evicts the least recently used
+// programs first. Must only be used on the IO thread.
+class ShaderDiskCache {
+ public:
+  typedef base::Callback<void(const std::string&)> ProgramCallback;
+
+  // Returns NULL if the embedder does not want the programs stored.
+  static ShaderDiskCache* GetInstance();
+
+  // Passes each stored program to |callback|.
+  void LoadAll(const ProgramCallback& callback);
+
+  // Stores |program| under |key|, replacing the program stored before.
+  void Store(const std::string& key, const std::string& program);
+
+ private:
+  class ReadOperation;
+  class WriteOperation;
+
+  explicit ShaderDiskCache(const FilePath& path);
+  ~ShaderDiskCache();
+
+  void OnBackendCreated(int result);
+
+  disk_cache::Backend* backend_;
+  bool backend_created_;
+  // Operations requested before the backend was created.
+  std::vector<base::Closure> pending_operations_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShaderDiskCache);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_GPU_SHADER_DISK_CACHE_H_
@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/metrics/histogram.h"
 #include "base/utf_string_conversions.h"
 #include "content/browser/in_process_webkit/indexed_db_callbacks.h"
 #include "content/browser/in_process_webkit/indexed_db_context_impl.h"
@@ -114,8 +115,11 @@ void IndexedDBDispatcherHost::ResetDispatcherHosts() {
 void IndexedDBDispatcherHost::OverrideThreadForMessage(
     const IPC::Message& message,
     BrowserThread::ID* thread) {
-  if (IPC_MESSAGE_CLASS(message) == IndexedDBMsgStart)
+  if (IPC_MESSAGE_CLASS(message) == IndexedDBMsgStart) {
     *thread = BrowserThread::WEBKIT_DEPRECATED;
+    base::AutoLock lock(arrival_times_lock_);
+    arrival_times_.push(base::TimeTicks::Now());
+  }
 }
 
 bool IndexedDBDispatcherHost::OnMessageReceived(const IPC::Message& message,
@@ -125,6 +129,16 @@ bool IndexedDBDispatcherHost::OnMessageReceived(const IPC::Message& message,
 
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::WEBKIT_DEPRECATED));
 
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  {
+    base::AutoLock lock(arrival_times_lock_);
+    if (!arrival_times_.empty()) {
+      UMA_HISTOGRAM_TIMES("WebCore.IndexedDB.QueueTime",
+                          start_time - arrival_times_.front());
+      arrival_times_.pop();
+    }
+  }
+
   bool handled =
       database_dispatcher_host_->OnMessageReceived(message, message_was_ok) ||
       index_dispatcher_host_->OnMessageReceived(message, message_was_ok) ||
@@ -145,6 +159,8 @@ bool IndexedDBDispatcherHost::OnMessageReceived(const IPC::Message& message,
     IPC_END_MESSAGE_MAP()
   }
 
+  UMA_HISTOGRAM_TIMES("WebCore.IndexedDB.MessageHandlingTime",
+                      base::TimeTicks::Now() - start_time);
   return handled;
 }
 
@@ -6,10 +6,13 @@
 #define CONTENT_BROWSER_IN_PROCESS_WEBKIT_INDEXED_DB_DISPATCHER_HOST_H_
 
 #include <map>
+#include <queue>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/id_map.h"
+#include "base/synchronization/lock.h"
+#include "base/time.h"
 #include "content/public/browser/browser_message_filter.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebExceptionCode.h"
 
@@ -311,6 +314,12 @@ class IndexedDBDispatcherHost : public content::BrowserMessageFilter {
   // Used to dispatch messages to the correct view host.
   int process_id_;
 
+  // When each IndexedDB message still waiting for the WebKit thread arrived
+  // on the IO thread, oldest first. The WebKit thread is shared by every
+  // origin, so this is how long other work held the message up.
+  base::Lock arrival_times_lock_;
+  std::queue<base::TimeTicks> arrival_times_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(IndexedDBDispatcherHost);
 };
 
@@ -0,0 +1,152 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/memory_pressure_monitor_linux.h"
+
+#include <algorithm>
+
+#include "base/allocator/allocator_extension.h"
+#include "base/bind.h"
+#include "base/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "content/common/child_process_messages.h"
+#include "content/public/browser/browser_child_process_host_iterator.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+
+namespace content {
+
+namespace {
+
+// How often /proc/meminfo is read. Reading it is cheap, but the pressure
+// notifications are only useful if they arrive before the OOM killer does.
+const int kPollIntervalSeconds = 5;
+
+// While the pressure lasts, it is notified again every this many polls, so
+// that caches that have grown back are trimmed again.
+const int kRenotifyPolls = 6;
+
+// The share of the physical memory that must be available to avoid each
+// pressure level.
+const int kModerateAvailablePercent = 15;
+const int kCriticalAvailablePercent = 5;
+
+typedef base::MemoryPressureListener::MemoryPressureLevel MemoryPressureLevel;
+
+void NotifyChildProcessesOnIOThread(MemoryPressureLevel level) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  for (BrowserChildProcessHostIterator iter; !iter.Done(); ++iter)
+    iter.Send(new ChildProcessMsg_MemoryPressure(level));
+}
+
+}  // namespace
+
+MemoryPressureMonitorLinux::MemoryPressureMonitorLinux()
+    : under_pressure_(false),
+      last_level_(base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE),
+      polls_since_notification_(0),
+      available_kb_at_notification_(-1) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  timer_.Start(FROM_HERE,
+               base::TimeDelta::FromSeconds(kPollIntervalSeconds),
+               this, &MemoryPressureMonitorLinux::CheckMemoryPressure);
+}
+
+MemoryPressureMonitorLinux::~MemoryPressureMonitorLinux() {
+}
+
+// static
+bool MemoryPressureMonitorLinux::GetPressureLevel(
+    const base::SystemMemoryInfoKB& meminfo,
+    MemoryPressureLevel* level) {
+  if (meminfo.total <= 0)
+    return false;
+
+  int64 available_percent =
+      static_cast<int64>(GetAvailableKB(meminfo)) * 100 / meminfo.total;
+  if (available_percent < kCriticalAvailablePercent) {
+    *level = base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL;
+    return true;
+  }
+  if (available_percent < kModerateAvailablePercent) {
+    *level = base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE;
+    return true;
+  }
+  return false;
+}
+
+// static
+int MemoryPressureMonitorLinux::GetAvailableKB(
+    const base::SystemMemoryInfoKB& meminfo) {
+  // The page cache is reclaimed before anything is swapped out or killed,
+  // but shared memory is counted in it and cannot be dropped.
+  return meminfo.free + meminfo.buffers + meminfo.cached - meminfo.shmem;
+}
+
+void MemoryPressureMonitorLinux::CheckMemoryPressure() {
+  base::SystemMemoryInfoKB meminfo;
+  if (!base::GetSystemMemoryInfo(&meminfo))
+    return;
+
+  // Record how much the previous notification gave back, now that the
+  // listeners have had a poll interval to run.
+  int available_kb = GetAvailableKB(meminfo);
+  if (available_kb_at_notification_ >= 0) {
+    int reclaimed_kb =
+        std::max(0, available_kb - available_kb_at_notification_);
+    if (last_level_ ==
+        base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL) {
+      UMA_HISTOGRAM_MEMORY_KB("Memory.PressureReclaimed.Critical",
+                              reclaimed_kb);
+    } else {
+      UMA_HISTOGRAM_MEMORY_KB("Memory.PressureReclaimed.Moderate",
+                              reclaimed_kb);
+    }
+    available_kb_at_notification_ = -1;
+  }
+
+  MemoryPressureLevel level;
+  if (!GetPressureLevel(meminfo, &level)) {
+    under_pressure_ = false;
+    return;
+  }
+
+  ++polls_since_notification_;
+  if (under_pressure_ && level <= last_level_ &&
+      polls_since_notification_ < kRenotifyPolls) {
+    // Remember an easing of the pressure, so that it is notified again if it
+    // escalates.
+    last_level_ = level;
+    return;
+  }
+
+  under_pressure_ = true;
+  last_level_ = level;
+  polls_since_notification_ = 0;
+  available_kb_at_notification_ = available_kb;
+  NotifyMemoryPressure(level);
+}
+
+void MemoryPressureMonitorLinux::NotifyMemoryPressure(
+    MemoryPressureLevel level) {
+  UMA_HISTOGRAM_ENUMERATION(
+      "Memory.PressureLevel", level,
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_COUNT);
+
+  base::MemoryPressureListener::NotifyMemoryPressure(level);
+  // The listeners on this thread run first, so the memory they free can be
+  // returned to the system.
+  MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&base::allocator::ReleaseFreeMemory));
+
+  for (RenderProcessHost::iterator it(RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    it.GetCurrentValue()->Send(new ChildProcessMsg_MemoryPressure(level));
+  }
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&NotifyChildProcessesOnIOThread, level));
+}
+
+}  // namespace content
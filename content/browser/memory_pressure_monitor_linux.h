@@ -0,0 +1,62 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This class watches the system-wide free memory on Linux and, when it runs
+// low, notifies base::MemoryPressureListener in the browser and in every
+// child process.
+
+#ifndef CONTENT_BROWSER_MEMORY_PRESSURE_MONITOR_LINUX_H_
+#define CONTENT_BROWSER_MEMORY_PRESSURE_MONITOR_LINUX_H_
+
+#include "base/basictypes.h"
+#include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/process_util.h"
+#include "base/timer.h"
+#include "content/common/content_export.h"
+
+namespace content {
+
+class CONTENT_EXPORT MemoryPressureMonitorLinux {
+ public:
+  // Starts polling /proc/meminfo. Must be created on the UI thread.
+  MemoryPressureMonitorLinux();
+  ~MemoryPressureMonitorLinux();
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(MemoryPressureMonitorLinuxTest, PressureLevel);
+
+  // Computes the pressure level for |meminfo|. Returns false if there is
+  // no pressure.
+  static bool GetPressureLevel(
+      const base::SystemMemoryInfoKB& meminfo,
+      base::MemoryPressureListener::MemoryPressureLevel* level);
+
+  // Returns the memory that could be used without swapping, in KB.
+  static int GetAvailableKB(const base::SystemMemoryInfoKB& meminfo);
+
+  void CheckMemoryPressure();
+
+  // Sends |level| to the listeners in all the processes.
+  void NotifyMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  base::RepeatingTimer<MemoryPressureMonitorLinux> timer_;
+
+  // True if the last check found memory pressure, which is notified again
+  // only if it escalates or after a few more checks.
+  bool under_pressure_;
+  base::MemoryPressureListener::MemoryPressureLevel last_level_;
+  int polls_since_notification_;
+
+  // The available memory when the last notification was sent, in KB, or -1
+  // if the memory it reclaimed has already been recorded.
+  int available_kb_at_notification_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPressureMonitorLinux);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_MEMORY_PRESSURE_MONITOR_LINUX_H_
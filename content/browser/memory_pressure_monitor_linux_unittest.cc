@@ -0,0 +1,36 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/memory_pressure_monitor_linux.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+TEST(MemoryPressureMonitorLinuxTest, PressureLevel) {
+  base::SystemMemoryInfoKB meminfo;
+  meminfo.total = 1000000;
+  meminfo.free = 100000;
+  meminfo.buffers = 50000;
+  meminfo.cached = 150000;
+  meminfo.shmem = 0;
+
+  base::MemoryPressureListener::MemoryPressureLevel level;
+  EXPECT_FALSE(MemoryPressureMonitorLinux::GetPressureLevel(meminfo, &level));
+
+  // Shared memory cannot be dropped from the page cache.
+  meminfo.shmem = 200000;
+  ASSERT_TRUE(MemoryPressureMonitorLinux::GetPressureLevel(meminfo, &level));
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE, level);
+
+  meminfo.free = 10000;
+  ASSERT_TRUE(MemoryPressureMonitorLinux::GetPressureLevel(meminfo, &level));
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL, level);
+
+  // Unreadable values are not pressure.
+  meminfo.total = 0;
+  EXPECT_FALSE(MemoryPressureMonitorLinux::GetPressureLevel(meminfo, &level));
+}
+
+}  // namespace content
@@ -38,9 +38,15 @@ namespace content {
 namespace {
 
 static int kBufferSize = 1024 * 512;
+static int kMaxBufferSize = 1024 * 1024 * 4;
 static int kMinAllocationSize = 1024 * 4;
 static int kMaxAllocationSize = 1024 * 32;
 
+// The buffer only grows while the renderer ACKs data this quickly on
+// average. A renderer that is slower than that is the bottleneck, and giving
+// it more data to hold would only cost memory.
+const int kMaxAverageACKTimeForGrowthMs = 20;
+
 void GetNumericArg(const std::string& name, int* result) {
   const std::string& value =
       CommandLine::ForCurrentProcess()->GetSwitchValueASCII(name);
@@ -55,6 +61,7 @@ void InitializeResourceBufferConstants() {
   did_init = true;
 
   GetNumericArg("resource-buffer-size", &kBufferSize);
+  GetNumericArg("resource-buffer-max-size", &kMaxBufferSize);
   GetNumericArg("resource-buffer-min-allocation-size", &kMinAllocationSize);
   GetNumericArg("resource-buffer-max-allocation-size", &kMaxAllocationSize);
 }
@@ -87,10 +94,13 @@ AsyncResourceHandler::AsyncResourceHandler(
       request_(request),
       rdh_(rdh),
       pending_data_count_(0),
+      pending_data_count_in_old_buffers_(0),
+      ack_count_(0),
+      stall_count_(0),
       allocation_size_(0),
       did_defer_(false),
       sent_received_response_msg_(false),
-      sent_first_data_msg_(false) {
+      sent_data_buffer_msg_(false) {
   // Set a back-pointer from ResourceRequestInfoImpl to |this|, so that the
   // ResourceDispatcherHostImpl can send us IPC messages.
   // TODO(darin): Implement an IPC message filter instead?
@@ -121,9 +131,33 @@ void AsyncResourceHandler::OnFollowRedirect(
 void AsyncResourceHandler::OnDataReceivedACK() {
   --pending_data_count_;
 
+  if (!pending_data_send_times_.empty()) {
+    base::TimeDelta ack_time =
+        TimeTicks::Now() - pending_data_send_times_.front();
+    pending_data_send_times_.pop();
+    total_ack_time_ += ack_time;
+    ++ack_count_;
+    UMA_HISTOGRAM_TIMES("Net.AsyncResourceHandler_DataReceivedACKTime",
+                        ack_time);
+  }
+
+  // The renderer ACKs in order, so the data in the replaced buffers is
+  // ACKed first.
+  if (pending_data_count_in_old_buffers_ > 0) {
+    --pending_data_count_in_old_buffers_;
+    return;
+  }
+
   buffer_->RecycleLeastRecentlyAllocated();
-  if (buffer_->CanAllocate())
+  if (buffer_->CanAllocate()) {
+    if (!stall_start_time_.is_null()) {
+      base::TimeDelta stall_time = TimeTicks::Now() - stall_start_time_;
+      stall_start_time_ = TimeTicks();
+      total_stall_time_ += stall_time;
+      UMA_HISTOGRAM_TIMES("Net.AsyncResourceHandler_StallTime", stall_time);
+    }
     ResumeIfDeferred();
+  }
 }
 
 bool AsyncResourceHandler::OnUploadProgress(int request_id,
@@ -238,14 +272,17 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int bytes_read,
       "Net.AsyncResourceHandler_SharedIOBuffer_UsedPercentage",
       CalcUsedPercentage(bytes_read, allocation_size_));
 
-  if (!sent_first_data_msg_) {
+  // This is sent again when the buffer grows. The renderer handles messages
+  // in order, so it is done with the old buffer by the time it maps the new
+  // one.
+  if (!sent_data_buffer_msg_) {
     base::SharedMemoryHandle handle;
     int size;
     if (!buffer_->ShareToProcess(filter_->peer_handle(), &handle, &size))
       return false;
     filter_->Send(
         new ResourceMsg_SetDataBuffer(routing_id_, request_id, handle, size));
-    sent_first_data_msg_ = true;
+    sent_data_buffer_msg_ = true;
   }
 
   int data_offset = buffer_->GetLastAllocationOffset();
@@ -256,6 +293,7 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int bytes_read,
       new ResourceMsg_DataReceived(routing_id_, request_id, data_offset,
                                    bytes_read, encoded_data_length));
   ++pending_data_count_;
+  pending_data_send_times_.push(TimeTicks::Now());
   UMA_HISTOGRAM_CUSTOM_COUNTS(
       "Net.AsyncResourceHandler_PendingDataCount",
       pending_data_count_, 0, 100, 100);
@@ -264,7 +302,11 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int bytes_read,
     UMA_HISTOGRAM_CUSTOM_COUNTS(
         "Net.AsyncResourceHandler_PendingDataCount_WhenFull",
         pending_data_count_, 0, 100, 100);
-    *defer = did_defer_ = true;
+    if (!GrowResourceBuffer()) {
+      stall_start_time_ = TimeTicks::Now();
+      ++stall_count_;
+      *defer = did_defer_ = true;
+    }
   }
 
   return true;
@@ -306,6 +348,18 @@ bool AsyncResourceHandler::OnResponseCompleted(
   // the ERR_ABORTED error code).
   DCHECK(!was_ignored_by_handler || error_code == net::ERR_ABORTED);
 
+  if (sent_data_buffer_msg_) {
+    UMA_HISTOGRAM_COUNTS_100("Net.AsyncResourceHandler_StallsPerRequest",
+                             stall_count_);
+    if (stall_count_) {
+      UMA_HISTOGRAM_TIMES("Net.AsyncResourceHandler_TotalStallTimePerRequest",
+                          total_stall_time_);
+    }
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Net.AsyncResourceHandler_FinalBufferSize",
+                                buffer_->buffer_size() / 1024,
+                                1, kMaxBufferSize / 1024, 50);
+  }
+
   // TODO(mkosiba): Fix up cases where we create a URLRequestStatus
   // with a status() != SUCCESS and an error_code() == net::OK.
   if (status.status() == net::URLRequestStatus::CANCELED &&
@@ -335,6 +389,30 @@ bool AsyncResourceHandler::EnsureResourceBufferIsInitialized() {
                              kMaxAllocationSize);
 }
 
+bool AsyncResourceHandler::GrowResourceBuffer() {
+  int new_size = buffer_->buffer_size() * 2;
+  if (new_size > kMaxBufferSize)
+    return false;
+  if (!ack_count_ || total_ack_time_ / ack_count_ >
+      base::TimeDelta::FromMilliseconds(kMaxAverageACKTimeForGrowthMs)) {
+    return false;
+  }
+
+  scoped_refptr<ResourceBuffer> new_buffer(new ResourceBuffer());
+  if (!new_buffer->Initialize(new_size,
+                              kMinAllocationSize,
+                              kMaxAllocationSize)) {
+    return false;
+  }
+
+  // Everything that is pending now lives in the old buffer, which stays
+  // mapped in the renderer until it receives the new one.
+  pending_data_count_in_old_buffers_ = pending_data_count_;
+  buffer_ = new_buffer;
+  sent_data_buffer_msg_ = false;
+  return true;
+}
+
 void AsyncResourceHandler::ResumeIfDeferred() {
   if (did_defer_) {
     did_defer_ = false;
@@ -5,8 +5,10 @@
 #ifndef CONTENT_BROWSER_RENDERER_HOST_ASYNC_RESOURCE_HANDLER_H_
 #define CONTENT_BROWSER_RENDERER_HOST_ASYNC_RESOURCE_HANDLER_H_
 
+#include <queue>
 #include <string>
 
+#include "base/time.h"
 #include "content/browser/renderer_host/resource_handler.h"
 #include "googleurl/src/gurl.h"
 
@@ -66,6 +68,12 @@ class AsyncResourceHandler : public ResourceHandler {
   bool EnsureResourceBufferIsInitialized();
   void ResumeIfDeferred();
 
+  // Called when the buffer is full. Replaces it with a larger one if the
+  // renderer is keeping up and the buffer may still grow, so that fast
+  // responses are not held back by the buffer size. Returns false if the
+  // request should wait for the renderer instead.
+  bool GrowResourceBuffer();
+
   scoped_refptr<ResourceBuffer> buffer_;
   scoped_refptr<ResourceMessageFilter> filter_;
   int routing_id_;
@@ -76,12 +84,29 @@ class AsyncResourceHandler : public ResourceHandler {
   // ACK for. This allows us to avoid having too many messages in flight.
   int pending_data_count_;
 
+  // How many of the |pending_data_count_| messages refer to buffers that were
+  // replaced by GrowResourceBuffer. Their ACKs must not recycle |buffer_|.
+  int pending_data_count_in_old_buffers_;
+
+  // When each message counted by |pending_data_count_| was sent, oldest
+  // first, to measure how long the renderer takes to ACK it.
+  std::queue<base::TimeTicks> pending_data_send_times_;
+  base::TimeDelta total_ack_time_;
+  int ack_count_;
+
+  // When the request last stopped to wait for the renderer to free buffer
+  // space, and how often and how long it waited in total.
+  base::TimeTicks stall_start_time_;
+  base::TimeDelta total_stall_time_;
+  int stall_count_;
+
   int allocation_size_;
 
   bool did_defer_;
 
   bool sent_received_response_msg_;
-  bool sent_first_data_msg_;
+  // Whether |buffer_| was shared with the renderer.
+  bool sent_data_buffer_msg_;
 
   DISALLOW_COPY_AND_ASSIGN(AsyncResourceHandler);
 };
@@ -18,4 +18,8 @@ size_t BackingStore::MemorySize() {
   return size_.GetArea() * 4;
 }
 
+bool BackingStore::PaintFromBitmap(const SkBitmap& bitmap) {
+  return false;
+}
+
 }  // namespace content
@@ -14,6 +14,7 @@
 #include "ui/surface/transport_dib.h"
 
 class RenderProcessHost;
+class SkBitmap;
 
 namespace gfx {
 class Rect;
@@ -73,6 +74,14 @@ class CONTENT_EXPORT BackingStore {
   virtual void ScrollBackingStore(int dx, int dy,
                                   const gfx::Rect& clip_rect,
                                   const gfx::Size& view_size) = 0;
+
+  // Draws |bitmap|, a possibly downscaled copy of an earlier backing store of
+  // the same size, stretched over the whole backing store. This is used to
+  // show something while the renderer repaints a tab whose backing store was
+  // evicted. Returns false if the implementation does not support it, which is
+  // the default.
+  virtual bool PaintFromBitmap(const SkBitmap& bitmap);
+
  protected:
   // Can only be constructed via subclasses.
   BackingStore(RenderWidgetHost* widget, const gfx::Size& size);
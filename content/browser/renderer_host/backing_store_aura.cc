@@ -140,6 +140,16 @@ void BackingStoreAura::ScrollBackingStore(int dx, int dy,
   bitmap_.scrollRect(&rect, pixel_dx, pixel_dy);
 }
 
+bool BackingStoreAura::PaintFromBitmap(const SkBitmap& bitmap) {
+  SkRect dst_rect = SkRect::MakeWH(SkIntToScalar(bitmap_.width()),
+                                   SkIntToScalar(bitmap_.height()));
+  SkPaint paint;
+  paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+  paint.setFilterBitmap(true);
+  canvas_->drawBitmapRect(bitmap, NULL, dst_rect, &paint);
+  return true;
+}
+
 bool BackingStoreAura::CopyFromBackingStore(const gfx::Rect& rect,
                                             skia::PlatformCanvas* output) {
   const int width =
@@ -51,6 +51,7 @@ class BackingStoreAura : public BackingStore {
   virtual void ScrollBackingStore(int dx, int dy,
                                   const gfx::Rect& clip_rect,
                                   const gfx::Size& view_size) OVERRIDE;
+  virtual bool PaintFromBitmap(const SkBitmap& bitmap) OVERRIDE;
 
  private:
   SkBitmap bitmap_;
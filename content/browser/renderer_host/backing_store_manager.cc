@@ -4,13 +4,23 @@
 
 #include "content/browser/renderer_host/backing_store_manager.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/mru_cache.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
 #include "base/sys_info.h"
+#include "base/time.h"
 #include "content/browser/renderer_host/backing_store.h"
 #include "content/browser/renderer_host/render_widget_host_impl.h"
 #include "content/public/common/content_switches.h"
+#include "skia/ext/image_operations.h"
+#include "skia/ext/platform_canvas.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/jpeg_codec.h"
 
 namespace content {
 namespace {
@@ -25,6 +35,35 @@ typedef base::OwningMRUCache<RenderWidgetHost*, BackingStore*>
 BackingStoreCache* large_cache = NULL;
 BackingStoreCache* small_cache = NULL;
 
+// Shrinks the caches when the system is low on memory. Like the caches, it is
+// created with them and never deleted.
+base::MemoryPressureListener* memory_pressure_listener = NULL;
+
+// Backing stores evicted from |large_cache| are kept in |compressed_cache| as
+// JPEGs at half their size, so that switching back to a recently used tab can
+// show an approximation of it while the renderer repaints, instead of waiting
+// for or flashing white. The cache is bounded by MaxCompressedMemory().
+struct CompressedBackingStore {
+  // The size of the backing store that was compressed, in DIPs.
+  gfx::Size size;
+  std::vector<unsigned char> data;
+};
+typedef base::MRUCache<RenderWidgetHost*, CompressedBackingStore>
+    CompressedBackingStoreCache;
+CompressedBackingStoreCache* compressed_cache = NULL;
+
+// Only some BackingStore implementations can be repainted from a bitmap, see
+// BackingStore::PaintFromBitmap(). Don't bother compressing elsewhere.
+#if defined(USE_AURA)
+const bool kCompressEvictedBackingStores = true;
+#else
+const bool kCompressEvictedBackingStores = false;
+#endif
+
+// JPEG quality of compressed backing stores. They are only shown until the
+// renderer repaints, so speed and size matter more than fidelity.
+const int kCompressedBackingStoreQuality = 70;
+
 // Threshold is based on a single large-monitor-width toolstrip.
 // (32bpp, 32 pixels high, 1920 pixels wide)
 // TODO(aa): The extension system no longer supports toolstrips, but we think
@@ -71,9 +110,81 @@ static size_t MaxBackingStoreMemory() {
   return MaxNumberOfBackingStores() * kMemoryMultiplier;
 }
 
-// Expires the given |backing_store| from |cache|.
+// The maximum amount of memory to use for compressed backing stores. A
+// half-size JPEG of a page is usually well under a tenth of the full backing
+// store, so this holds several times as many tabs as the uncompressed caches.
+static size_t MaxCompressedMemory() {
+  return MaxBackingStoreMemory() / 8;
+}
+
+size_t CompressedMemorySize() {
+  if (!compressed_cache)
+    return 0;
+
+  size_t mem = 0;
+  CompressedBackingStoreCache::iterator it;
+  for (it = compressed_cache->begin(); it != compressed_cache->end(); ++it)
+    mem += it->second.data.size();
+  return mem;
+}
+
+// Removes the compressed backing store for |host|, if there is one.
+void RemoveCompressedBackingStore(RenderWidgetHost* host) {
+  if (!compressed_cache)
+    return;
+  CompressedBackingStoreCache::iterator it = compressed_cache->Peek(host);
+  if (it != compressed_cache->end())
+    compressed_cache->Erase(it);
+}
+
+// Adds a compressed copy of |backing_store| to |compressed_cache|, evicting
+// the least recently used compressed backing stores to stay within budget.
+void CompressBackingStore(BackingStore* backing_store) {
+  base::TimeTicks start_time = base::TimeTicks::Now();
+
+  skia::PlatformCanvas canvas;
+  if (!backing_store->CopyFromBackingStore(gfx::Rect(backing_store->size()),
+                                           &canvas))
+    return;
+  const SkBitmap& bitmap = skia::GetTopDevice(canvas)->accessBitmap(false);
+  SkBitmap half_size = skia::ImageOperations::Resize(
+      bitmap, skia::ImageOperations::RESIZE_GOOD,
+      std::max(1, bitmap.width() / 2), std::max(1, bitmap.height() / 2));
+
+  CompressedBackingStore compressed;
+  compressed.size = backing_store->size();
+  {
+    SkAutoLockPixels lock(half_size);
+    if (!gfx::JPEGCodec::Encode(
+            reinterpret_cast<unsigned char*>(half_size.getAddr32(0, 0)),
+            gfx::JPEGCodec::FORMAT_SkBitmap, half_size.width(),
+            half_size.height(), static_cast<int>(half_size.rowBytes()),
+            kCompressedBackingStoreQuality, &compressed.data))
+      return;
+  }
+
+  if (!compressed_cache) {
+    compressed_cache = new CompressedBackingStoreCache(
+        CompressedBackingStoreCache::NO_AUTO_EVICT);
+  }
+  compressed_cache->Put(backing_store->render_widget_host(), compressed);
+
+  size_t max_mem = MaxCompressedMemory();
+  while (compressed_cache->size() > 0 && CompressedMemorySize() > max_mem)
+    compressed_cache->Erase(compressed_cache->rbegin());
+
+  UMA_HISTOGRAM_TIMES("MPArch.BackingStore_CompressTime",
+                      base::TimeTicks::Now() - start_time);
+  UMA_HISTOGRAM_MEMORY_KB("MPArch.BackingStore_CompressedSizeKB",
+                          compressed.data.size() / 1024);
+}
+
+// Expires the given |backing_store| from |cache|. Backing stores of tabs are
+// kept compressed where supported.
 void ExpireBackingStoreAt(BackingStoreCache* cache,
                           BackingStoreCache::iterator backing_store) {
+  if (kCompressEvictedBackingStores && cache == large_cache)
+    CompressBackingStore(backing_store->second);
   cache->Erase(backing_store);
 }
 
@@ -107,6 +218,14 @@ void CreateCacheSpace(size_t size) {
   DCHECK(size == 0);
 }
 
+void OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+    BackingStoreManager::RemoveAllBackingStores();
+  else
+    BackingStoreManager::ReduceMemoryUsage();
+}
+
 // Creates the backing store for the host based on the dimensions passed in.
 // Removes the existing backing store if there is one.
 BackingStore* CreateBackingStore(RenderWidgetHost* host,
@@ -117,6 +236,8 @@ BackingStore* CreateBackingStore(RenderWidgetHost* host,
   if (!large_cache) {
     large_cache = new BackingStoreCache(BackingStoreCache::NO_AUTO_EVICT);
     small_cache = new BackingStoreCache(BackingStoreCache::NO_AUTO_EVICT);
+    memory_pressure_listener = new base::MemoryPressureListener(
+        base::Bind(&OnMemoryPressure));
   }
 
   // TODO(erikkay) 32bpp is not always accurate
@@ -224,6 +345,43 @@ void BackingStoreManager::PrepareBackingStore(
                                      scheduled_completion_callback);
 }
 
+// static
+BackingStore* BackingStoreManager::RestoreCompressedBackingStore(
+    RenderWidgetHost* host,
+    const gfx::Size& desired_size) {
+  if (!compressed_cache)
+    return NULL;
+  CompressedBackingStoreCache::iterator it = compressed_cache->Peek(host);
+  if (it == compressed_cache->end())
+    return NULL;
+
+  // The compressed copy is used at most once: the renderer repaints into the
+  // restored backing store, which supersedes it.
+  CompressedBackingStore compressed;
+  compressed.size = it->second.size;
+  compressed.data.swap(it->second.data);
+  compressed_cache->Erase(it);
+  if (compressed.size != desired_size || compressed.data.empty())
+    return NULL;
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  scoped_ptr<SkBitmap> bitmap(gfx::JPEGCodec::Decode(&compressed.data[0],
+                                                     compressed.data.size()));
+  if (!bitmap.get())
+    return NULL;
+
+  BackingStore* backing_store = CreateBackingStore(host, desired_size);
+  if (!backing_store)
+    return NULL;
+  if (!backing_store->PaintFromBitmap(*bitmap)) {
+    RemoveBackingStore(host);
+    return NULL;
+  }
+  UMA_HISTOGRAM_TIMES("MPArch.BackingStore_RestoreTime",
+                      base::TimeTicks::Now() - start_time);
+  return backing_store;
+}
+
 // static
 BackingStore* BackingStoreManager::Lookup(RenderWidgetHost* host) {
   if (large_cache) {
@@ -241,6 +399,7 @@ BackingStore* BackingStoreManager::Lookup(RenderWidgetHost* host) {
 
 // static
 void BackingStoreManager::RemoveBackingStore(RenderWidgetHost* host) {
+  RemoveCompressedBackingStore(host);
   if (!large_cache)
     return;
 
@@ -261,6 +420,18 @@ void BackingStoreManager::RemoveAllBackingStores() {
     large_cache->Clear();
     small_cache->Clear();
   }
+  if (compressed_cache)
+    compressed_cache->Clear();
+}
+
+// static
+void BackingStoreManager::ReduceMemoryUsage() {
+  if (!large_cache)
+    return;
+  // Keep the most recently used large backing store, which is most likely
+  // the visible tab. The others are compressed where supported.
+  while (large_cache->size() > 1)
+    ExpireLastBackingStore(large_cache);
 }
 
 // static
@@ -61,6 +61,15 @@ class BackingStoreManager {
       bool* needs_full_paint,
       bool* scheduled_completion_callback);
 
+  // Recreates the backing store for the host from the compressed copy kept
+  // when it was evicted, if that copy has the desired dimensions. This gives
+  // the view something to show while a fresh paint is requested. The
+  // compressed copy is dropped either way.
+  // Returns NULL if there is no suitable copy or it cannot be restored.
+  static BackingStore* RestoreCompressedBackingStore(
+      RenderWidgetHost* host,
+      const gfx::Size& desired_size);
+
   // Returns a matching backing store for the host.
   // Returns NULL if we fail to find one.
   static BackingStore* Lookup(RenderWidgetHost* host);
@@ -71,6 +80,11 @@ class BackingStoreManager {
   // Removes all backing stores.
   static void RemoveAllBackingStores();
 
+  // Evicts all large backing stores except the most recently used one, which
+  // keeps compressed copies of them where supported. Called when the system
+  // is low on memory.
+  static void ReduceMemoryUsage();
+
   // Current size in bytes of the backing store cache.
   static size_t MemorySize();
 
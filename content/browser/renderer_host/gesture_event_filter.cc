@@ -52,11 +52,11 @@ static int GetTapDownDeferralTimeMs() {
 }
 
 
-// TODO(rjkroege): Coalesce pinch updates.
 // Returns |true| if two gesture events should be coalesced.
 bool ShouldCoalesceGestureEvents(const WebKit::WebGestureEvent& last_event,
                                  const WebKit::WebGestureEvent& new_event) {
-  return new_event.type == WebInputEvent::GestureScrollUpdate &&
+  return (new_event.type == WebInputEvent::GestureScrollUpdate ||
+          new_event.type == WebInputEvent::GesturePinchUpdate) &&
       last_event.type == new_event.type &&
       last_event.modifiers == new_event.modifiers;
 }
@@ -185,6 +185,7 @@ bool GestureEventFilter::ShouldForwardForTapDeferral(
       coalesced_gesture_events_.push_back(gesture_event);
       return ShouldHandleEventNow();
     case WebInputEvent::GestureScrollUpdate:
+    case WebInputEvent::GesturePinchUpdate:
       MergeOrInsertScrollEvent(gesture_event);
       return ShouldHandleEventNow();
     default:
@@ -258,17 +259,25 @@ void GestureEventFilter::MergeOrInsertScrollEvent(
   WebGestureEvent* last_gesture_event = coalesced_gesture_events_.empty() ? 0 :
       &coalesced_gesture_events_.back();
   if (coalesced_gesture_events_.size() > 1 &&
-      last_gesture_event->type == gesture_event.type &&
-      last_gesture_event->modifiers == gesture_event.modifiers) {
-    last_gesture_event->data.scrollUpdate.deltaX +=
-        gesture_event.data.scrollUpdate.deltaX;
-    last_gesture_event->data.scrollUpdate.deltaY +=
-        gesture_event.data.scrollUpdate.deltaY;
+      ShouldCoalesceGestureEvents(*last_gesture_event, gesture_event)) {
+    if (gesture_event.type == WebInputEvent::GestureScrollUpdate) {
+      last_gesture_event->data.scrollUpdate.deltaX +=
+          gesture_event.data.scrollUpdate.deltaX;
+      last_gesture_event->data.scrollUpdate.deltaY +=
+          gesture_event.data.scrollUpdate.deltaY;
+    } else {
+      // Pinch scales compose by multiplication, about the latest anchor.
+      last_gesture_event->data.pinchUpdate.scale *=
+          gesture_event.data.pinchUpdate.scale;
+      last_gesture_event->x = gesture_event.x;
+      last_gesture_event->y = gesture_event.y;
+      last_gesture_event->globalX = gesture_event.globalX;
+      last_gesture_event->globalY = gesture_event.globalY;
+    }
     DLOG_IF(WARNING,
             gesture_event.timeStampSeconds <=
             last_gesture_event->timeStampSeconds)
             << "Event time not monotonic?\n";
-    DCHECK(last_gesture_event->type == WebInputEvent::GestureScrollUpdate);
     last_gesture_event->timeStampSeconds = gesture_event.timeStampSeconds;
   } else {
     coalesced_gesture_events_.push_back(gesture_event);
@@ -75,7 +75,8 @@ class GestureEventFilter {
   // hence that event should be handled now.
   bool ShouldHandleEventNow();
 
-  // Merge or append a GestureScrollUpdate into the coalescing queue.
+  // Merge or append a GestureScrollUpdate or GesturePinchUpdate into the
+  // coalescing queue.
   void MergeOrInsertScrollEvent(
        const WebKit::WebGestureEvent& gesture_event);
 
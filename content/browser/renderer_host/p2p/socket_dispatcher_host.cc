@@ -224,14 +224,14 @@ void P2PSocketDispatcherHost::OnAcceptIncomingTcpConnection(
 }
 
 void P2PSocketDispatcherHost::OnSend(int socket_id,
-                                     const net::IPEndPoint& socket_address,
-                                     const std::vector<char>& data) {
+                                     const std::vector<P2PPacket>& packets) {
   P2PSocketHost* socket = LookupSocket(socket_id);
   if (!socket) {
     LOG(ERROR) << "Received P2PHostMsg_Send for invalid socket_id.";
     return;
   }
-  socket->Send(socket_address, data);
+  for (size_t i = 0; i < packets.size(); ++i)
+    socket->Send(packets[i].address, packets[i].data);
 }
 
 void P2PSocketDispatcherHost::OnDestroySocket(int socket_id) {
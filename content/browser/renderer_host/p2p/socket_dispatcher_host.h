@@ -60,9 +60,7 @@ class P2PSocketDispatcherHost
   void OnAcceptIncomingTcpConnection(int listen_socket_id,
                                      const net::IPEndPoint& remote_address,
                                      int connected_socket_id);
-  void OnSend(int socket_id,
-              const net::IPEndPoint& socket_address,
-              const std::vector<char>& data);
+  void OnSend(int socket_id, const std::vector<P2PPacket>& packets);
   void OnDestroySocket(int socket_id);
 
   void DoGetNetworkList();
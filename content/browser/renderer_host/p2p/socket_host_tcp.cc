@@ -149,7 +149,10 @@ void P2PSocketHostTcp::OnPacket(std::vector<char>& data) {
     }
   }
 
-  message_sender_->Send(new P2PMsg_OnDataReceived(id_, remote_address_, data));
+  std::vector<P2PPacket> packets(1);
+  packets[0].address = remote_address_;
+  packets[0].data = data;
+  message_sender_->Send(new P2PMsg_OnDataReceived(id_, packets));
 }
 
 void P2PSocketHostTcp::DidCompleteRead(int result) {
@@ -280,7 +280,16 @@ MATCHER_P(MatchPacketMessage, packet_content, "") {
     return false;
   P2PMsg_OnDataReceived::Param params;
   P2PMsg_OnDataReceived::Read(arg, &params);
-  return params.c == packet_content;
+  return params.b.size() == 1 && params.b[0].data == packet_content;
+}
+
+MATCHER_P2(MatchPacketsMessage, first_content, second_content, "") {
+  if (arg->type() != P2PMsg_OnDataReceived::ID)
+    return false;
+  P2PMsg_OnDataReceived::Param params;
+  P2PMsg_OnDataReceived::Read(arg, &params);
+  return params.b.size() == 2 && params.b[0].data == first_content &&
+      params.b[1].data == second_content;
 }
 
 MATCHER_P(MatchIncomingSocketMessage, address, "") {
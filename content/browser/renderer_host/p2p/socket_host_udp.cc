@@ -15,6 +15,9 @@ namespace {
 // UDP packets cannot be bigger than 64k.
 const int kReadBufferSize = 65536;
 
+// The most packets passed to the renderer in one P2PMsg_OnDataReceived.
+const size_t kMaxPacketsPerMessage = 64;
+
 }  // namespace
 
 namespace content {
@@ -86,6 +89,9 @@ void P2PSocketHostUdp::OnError() {
 }
 
 void P2PSocketHostUdp::DoRead() {
+  // All the packets already queued on the socket are read before the
+  // renderer is sent them, so that it gets one message per batch instead of
+  // one per packet.
   int result;
   do {
     result = socket_->RecvFrom(recv_buffer_, kReadBufferSize, &recv_address_,
@@ -93,6 +99,14 @@ void P2PSocketHostUdp::DoRead() {
                                           base::Unretained(this)));
     DidCompleteRead(result);
   } while (result > 0);
+  SendReceivedPackets();
+}
+
+void P2PSocketHostUdp::SendReceivedPackets() {
+  if (received_packets_.empty())
+    return;
+  message_sender_->Send(new P2PMsg_OnDataReceived(id_, received_packets_));
+  received_packets_.clear();
 }
 
 void P2PSocketHostUdp::OnRecv(int result) {
@@ -121,9 +135,15 @@ void P2PSocketHostUdp::DidCompleteRead(int result) {
       }
     }
 
-    message_sender_->Send(new P2PMsg_OnDataReceived(id_, recv_address_, data));
+    received_packets_.push_back(P2PPacket());
+    received_packets_.back().address = recv_address_;
+    received_packets_.back().data.swap(data);
+    if (received_packets_.size() >= kMaxPacketsPerMessage)
+      SendReceivedPackets();
   } else if (result < 0 && result != net::ERR_IO_PENDING) {
     LOG(ERROR) << "Error when reading from UDP socket: " << result;
+    // Deliver the packets read before the error ahead of it.
+    SendReceivedPackets();
     OnError();
   }
 }
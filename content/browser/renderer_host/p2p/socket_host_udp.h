@@ -53,6 +53,9 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   void DoSend(const PendingPacket& packet);
   void DidCompleteRead(int result);
 
+  // Sends |received_packets_| to the renderer in one message.
+  void SendReceivedPackets();
+
   // Callbacks for RecvFrom() and SendTo().
   void OnRecv(int result);
   void OnSend(int result);
@@ -61,6 +64,9 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   scoped_refptr<net::IOBuffer> recv_buffer_;
   net::IPEndPoint recv_address_;
 
+  // Packets read but not yet sent to the renderer.
+  std::vector<P2PPacket> received_packets_;
+
   std::deque<PendingPacket> send_queue_;
   int send_queue_bytes_;
   bool send_pending_;
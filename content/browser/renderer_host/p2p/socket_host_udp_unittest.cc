@@ -90,6 +90,12 @@ class FakeDatagramServerSocket : public net::DatagramServerSocket {
     return true;
   }
 
+  // Queues a packet to be returned by a later RecvFrom() without completing
+  // a pending one.
+  void QueuePacket(const net::IPEndPoint& address, std::vector<char> data) {
+    incoming_packets_.push_back(UDPPacket(address, data));
+  }
+
   void ReceivePacket(const net::IPEndPoint& address, std::vector<char> data) {
     if (!recv_callback_.is_null()) {
       int size = std::min(recv_size_, static_cast<int>(data.size()));
@@ -256,4 +262,18 @@ TEST_F(P2PSocketHostUdpTest, SendAfterStunResponseDifferentHost) {
   socket_host_->Send(dest2_, packet);
 }
 
+// Verify that the packets read in one go are passed to the renderer in one
+// message, in order.
+TEST_F(P2PSocketHostUdpTest, ReceiveBatch) {
+  std::vector<char> packet1;
+  CreateStunRequest(&packet1);
+  std::vector<char> packet2;
+  CreateRandomPacket(&packet2);
+
+  EXPECT_CALL(sender_, Send(MatchPacketsMessage(packet1, packet2)))
+      .WillOnce(DoAll(DeleteArg<0>(), Return(true)));
+  socket_->QueuePacket(dest1_, packet2);
+  socket_->ReceivePacket(dest1_, packet1);
+}
+
 }  // namespace content
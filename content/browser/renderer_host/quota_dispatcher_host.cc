@@ -200,6 +200,12 @@ QuotaDispatcherHost::QuotaDispatcherHost(
       permission_context_(permission_context) {
 }
 
+bool QuotaDispatcherHost::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  supported_message_classes->push_back(QuotaMsgStart);
+  return true;
+}
+
 bool QuotaDispatcherHost::OnMessageReceived(
     const IPC::Message& message, bool* message_was_ok) {
   *message_was_ok = true;
@@ -33,6 +33,8 @@ class QuotaDispatcherHost : public content::BrowserMessageFilter {
   // content::BrowserMessageFilter:
   virtual bool OnMessageReceived(const IPC::Message& message,
                                  bool* message_was_ok) OVERRIDE;
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE;
 
  protected:
   virtual ~QuotaDispatcherHost();
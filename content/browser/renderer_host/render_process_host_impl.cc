@@ -503,6 +503,8 @@ bool RenderProcessHostImpl::Init() {
     AppendRendererCommandLine(cmd_line);
     cmd_line->AppendSwitchASCII(switches::kProcessChannelID, channel_id);
 
+    launch_start_time_ = base::TimeTicks::Now();
+
     // Spawn the child process asynchronously to avoid blocking the UI thread.
     // As long as there's no renderer prefix, we can use the zygote process
     // at this stage.
@@ -1531,6 +1533,10 @@ void RenderProcessHostImpl::OnProcessLaunched() {
     }
 
     child_process_launcher_->SetProcessBackgrounded(backgrounded_);
+
+    // The time a new tab waits for its renderer process to be launched.
+    UMA_HISTOGRAM_TIMES("MPArch.RendererLaunchTime",
+                        base::TimeTicks::Now() - launch_start_time_);
   }
 
   // NOTE: This needs to be before sending queued messages because
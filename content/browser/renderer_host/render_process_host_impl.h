@@ -294,6 +294,9 @@ class CONTENT_EXPORT RenderProcessHostImpl
   // Records the last time we regarded the child process active.
   base::TimeTicks child_process_activity_time_;
 
+  // When the launch of the current child process was started.
+  base::TimeTicks launch_start_time_;
+
 #if defined(OS_ANDROID)
   // Android WebView needs to use a SyncChannel to block the browser process
   // for synchronous find-in-page API support. In that case the shutdown event
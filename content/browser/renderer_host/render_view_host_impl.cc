@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/i18n/rtl.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
@@ -29,6 +30,8 @@
 #include "content/browser/renderer_host/dip_util.h"
 #include "content/browser/renderer_host/render_process_host_impl.h"
 #include "content/browser/renderer_host/render_view_host_delegate.h"
+#include "content/browser/renderer_host/resource_dispatcher_host_impl.h"
+#include "content/browser/renderer_host/resource_scheduler.h"
 #include "content/common/accessibility_messages.h"
 #include "content/common/browser_plugin_messages.h"
 #include "content/common/content_constants_internal.h"
@@ -42,6 +45,7 @@
 #include "content/port/browser/render_widget_host_view_port.h"
 #include "content/public/browser/browser_accessibility_state.h"
 #include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/browser_message_filter.h"
 #include "content/public/browser/content_browser_client.h"
 #include "content/public/browser/dom_operation_notification_details.h"
@@ -108,6 +112,14 @@ base::i18n::TextDirection WebTextDirectionToChromeTextDirection(
   }
 }
 
+// Returns the scheduler that orders the requests of the RenderViews, or NULL
+// if there is no ResourceDispatcherHost (in unit tests).
+content::ResourceScheduler* GetResourceScheduler() {
+  content::ResourceDispatcherHostImpl* rdh =
+      content::ResourceDispatcherHostImpl::Get();
+  return rdh ? rdh->scheduler() : NULL;
+}
+
 }  // namespace
 
 namespace content {
@@ -185,6 +197,14 @@ RenderViewHostImpl::RenderViewHostImpl(
 
   content::GetContentClient()->browser()->RenderViewHostCreated(this);
 
+  if (content::ResourceScheduler* scheduler = GetResourceScheduler()) {
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&content::ResourceScheduler::OnClientCreated,
+                   base::Unretained(scheduler),
+                   GetProcess()->GetID(), GetRoutingID()));
+  }
+
   content::NotificationService::current()->Notify(
       content::NOTIFICATION_RENDER_VIEW_HOST_CREATED,
       content::Source<RenderViewHost>(this),
@@ -211,6 +231,14 @@ RenderViewHostImpl::~RenderViewHostImpl() {
   // Be sure to clean up any leftover state from cross-site requests.
   CrossSiteRequestManager::GetInstance()->SetHasPendingCrossSiteRequest(
       GetProcess()->GetID(), GetRoutingID(), false);
+
+  if (content::ResourceScheduler* scheduler = GetResourceScheduler()) {
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&content::ResourceScheduler::OnClientDeleted,
+                   base::Unretained(scheduler),
+                   GetProcess()->GetID(), GetRoutingID()));
+  }
 }
 
 content::RenderViewHostDelegate* RenderViewHostImpl::GetDelegate() const {
@@ -1269,13 +1297,27 @@ void RenderViewHostImpl::OnMsgRequestMove(const gfx::Rect& pos) {
 }
 
 void RenderViewHostImpl::OnMsgDidStartLoading() {
+  NotifyResourceSchedulerOfLoadingState(true);
   delegate_->DidStartLoading(this);
 }
 
 void RenderViewHostImpl::OnMsgDidStopLoading() {
+  NotifyResourceSchedulerOfLoadingState(false);
   delegate_->DidStopLoading(this);
 }
 
+void RenderViewHostImpl::NotifyResourceSchedulerOfLoadingState(
+    bool is_loading) {
+  content::ResourceScheduler* scheduler = GetResourceScheduler();
+  if (!scheduler)
+    return;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&content::ResourceScheduler::OnLoadingStateChanged,
+                 base::Unretained(scheduler),
+                 GetProcess()->GetID(), GetRoutingID(), is_loading));
+}
+
 void RenderViewHostImpl::OnMsgDidChangeLoadProgress(double load_progress) {
   delegate_->DidChangeLoadProgress(load_progress);
 }
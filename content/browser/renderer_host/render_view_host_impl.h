@@ -592,6 +592,10 @@ class CONTENT_EXPORT RenderViewHostImpl
 
   void ClearPowerSaveBlockers();
 
+  // Tells the ResourceScheduler on the IO thread whether this view is
+  // loading, so that it can hold back its images while it parses.
+  void NotifyResourceSchedulerOfLoadingState(bool is_loading);
+
   // Our delegate, which wants to know about changes in the RenderView.
   RenderViewHostDelegate* delegate_;
 
@@ -27,12 +27,15 @@
 #include "content/browser/renderer_host/render_view_host_impl.h"
 #include "content/browser/renderer_host/render_widget_helper.h"
 #include "content/browser/renderer_host/render_widget_host_delegate.h"
+#include "content/browser/renderer_host/resource_dispatcher_host_impl.h"
+#include "content/browser/renderer_host/resource_scheduler.h"
 #include "content/browser/renderer_host/tap_suppression_controller.h"
 #include "content/common/accessibility_messages.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/view_messages.h"
 #include "content/port/browser/render_widget_host_view_port.h"
 #include "content/port/browser/smooth_scroll_gesture.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/native_web_keyboard_event.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/notification_types.h"
@@ -95,6 +98,50 @@ bool ShouldCoalesceMouseWheelEvents(const WebMouseWheelEvent& last_event,
          last_event.momentumPhase == new_event.momentumPhase;
 }
 
+// Returns |true| if |new_event| can be merged into the queued |last_event|:
+// both are TouchMoves with the same modifiers and the same touch points, in
+// the same order.
+bool ShouldCoalesceTouchEvents(const WebKit::WebTouchEvent& last_event,
+                               const WebKit::WebTouchEvent& new_event) {
+  if (last_event.type != WebInputEvent::TouchMove ||
+      new_event.type != WebInputEvent::TouchMove ||
+      last_event.modifiers != new_event.modifiers ||
+      last_event.touchesLength != new_event.touchesLength)
+    return false;
+  for (unsigned i = 0; i < last_event.touchesLength; ++i) {
+    if (last_event.touches[i].id != new_event.touches[i].id)
+      return false;
+  }
+  return true;
+}
+
+// Replaces |last_event| with |new_event|, keeping points that moved in
+// |last_event| marked as moved.
+void CoalesceTouchEvents(WebKit::WebTouchEvent* last_event,
+                         const WebKit::WebTouchEvent& new_event) {
+  WebKit::WebTouchEvent old_event = *last_event;
+  *last_event = new_event;
+  for (unsigned i = 0; i < last_event->touchesLength; ++i) {
+    if (old_event.touches[i].state == WebKit::WebTouchPoint::StateMoved)
+      last_event->touches[i].state = WebKit::WebTouchPoint::StateMoved;
+  }
+}
+
+// Tells the ResourceScheduler whether the widget is visible, so that hidden
+// tabs do not compete with the visible one for the network.
+void NotifyResourceSchedulerOfVisibility(int child_id,
+                                         int route_id,
+                                         bool is_visible) {
+  ResourceDispatcherHostImpl* rdh = ResourceDispatcherHostImpl::Get();
+  if (!rdh)
+    return;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ResourceScheduler::OnVisibilityChanged,
+                 base::Unretained(rdh->scheduler()),
+                 child_id, route_id, is_visible));
+}
+
 }  // namespace
 
 
@@ -103,6 +150,11 @@ void RenderWidgetHost::RemoveAllBackingStores() {
   BackingStoreManager::RemoveAllBackingStores();
 }
 
+// static
+void RenderWidgetHost::ReduceBackingStoreMemory() {
+  BackingStoreManager::ReduceMemoryUsage();
+}
+
 // static
 size_t RenderWidgetHost::BackingStoreMemorySize() {
   return BackingStoreManager::MemorySize();
@@ -365,6 +417,8 @@ void RenderWidgetHostImpl::WasHidden() {
   // Tell the RenderProcessHost we were hidden.
   process_->WidgetHidden();
 
+  NotifyResourceSchedulerOfVisibility(process_->GetID(), routing_id_, false);
+
   bool is_visible = false;
   NotificationService::current()->Notify(
       NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED,
@@ -395,6 +449,8 @@ void RenderWidgetHostImpl::WasShown() {
 
   process_->WidgetRestored();
 
+  NotifyResourceSchedulerOfVisibility(process_->GetID(), routing_id_, true);
+
   bool is_visible = true;
   NotificationService::current()->Notify(
       NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED,
@@ -633,6 +689,13 @@ BackingStore* RenderWidgetHostImpl::GetBackingStore(bool force_create) {
     Send(new ViewMsg_Repaint(routing_id_, view_size));
   }
 
+  // If the backing store was evicted and compressed, show it while the
+  // renderer repaints rather than blocking for the paint.
+  backing_store =
+      BackingStoreManager::RestoreCompressedBackingStore(this, view_size);
+  if (backing_store)
+    return backing_store;
+
   TimeDelta max_delay = TimeDelta::FromMilliseconds(kPaintMsgTimeoutMS);
   TimeTicks end_time = TimeTicks::Now() + max_delay;
   do {
@@ -1048,7 +1111,26 @@ void RenderWidgetHostImpl::ForwardTouchEvent(
   if (ignore_input_events_ || process_->IgnoreInputEvents())
     return;
 
-  // TODO(sad): Do touch-event coalescing when appropriate.
+  // Only one touch event is sent to the renderer at a time. Moves received
+  // while waiting for its ack are merged, so that a renderer that acks slowly
+  // gets the latest finger positions instead of a backlog.
+  if (!touch_event_queue_.empty()) {
+    if (touch_event_queue_.size() > 1 &&
+        ShouldCoalesceTouchEvents(touch_event_queue_.back().event,
+                                  touch_event)) {
+      CoalescedTouchEvent* last = &touch_event_queue_.back();
+      CoalesceTouchEvents(&last->event, touch_event);
+      ++last->count;
+    } else {
+      CoalescedTouchEvent queued = { touch_event, 1 };
+      touch_event_queue_.push_back(queued);
+    }
+    return;
+  }
+
+  CoalescedTouchEvent sent = { touch_event, 1 };
+  touch_event_queue_.push_back(sent);
+  HISTOGRAM_COUNTS_100("MPArch.RWH_TouchQueueSize", touch_event_queue_.size());
   ForwardInputEvent(touch_event, sizeof(WebKit::WebTouchEvent), false);
 }
 
@@ -1103,6 +1185,7 @@ void RenderWidgetHostImpl::RendererExited(base::TerminationStatus status,
   next_mouse_move_.reset();
   mouse_wheel_pending_ = false;
   coalesced_mouse_wheel_events_.clear();
+  touch_event_queue_.clear();
 
   // Must reset these to ensure that SelectRange works with a new renderer.
   select_range_pending_ = false;
@@ -1666,8 +1749,26 @@ void RenderWidgetHostImpl::ProcessGestureAck(bool processed, int type) {
 
 void RenderWidgetHostImpl::ProcessTouchAck(
     WebInputEvent::Type type, bool processed) {
-  if (view_)
-    view_->ProcessTouchAck(type, processed);
+  int count = 1;
+  if (!touch_event_queue_.empty()) {
+    count = touch_event_queue_.front().count;
+    touch_event_queue_.pop_front();
+  }
+
+  // The view queued each of the events that were merged, so ack them all.
+  if (view_) {
+    for (int i = 0; i < count; ++i)
+      view_->ProcessTouchAck(type, processed);
+  }
+
+  // Now send the next touch event, if any.
+  if (!touch_event_queue_.empty() && !ignore_input_events_ &&
+      !process_->IgnoreInputEvents()) {
+    HISTOGRAM_COUNTS_100("MPArch.RWH_TouchQueueSize",
+                         touch_event_queue_.size());
+    ForwardInputEvent(touch_event_queue_.front().event,
+                      sizeof(WebKit::WebTouchEvent), false);
+  }
 }
 
 void RenderWidgetHostImpl::OnMsgFocus() {
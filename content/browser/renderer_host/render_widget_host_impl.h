@@ -717,6 +717,21 @@ class CONTENT_EXPORT RenderWidgetHostImpl : virtual public RenderWidgetHost,
   // would be queued) results in very slow scrolling.
   WheelEventQueue coalesced_mouse_wheel_events_;
 
+  // A touch event waiting to be sent, together with the number of events the
+  // view passed to ForwardTouchEvent() that were merged into it.
+  struct CoalescedTouchEvent {
+    WebKit::WebTouchEvent event;
+    int count;
+  };
+  typedef std::deque<CoalescedTouchEvent> TouchEventQueue;
+
+  // Touch events not yet acked by the renderer. The front event has been sent
+  // and the others wait for its ack. Like mouse wheel events, a TouchMove
+  // received while waiting is merged into the last queued TouchMove if the
+  // same touch points are down. The view still gets one ack for each event it
+  // forwarded, so its own touch queue stays in step.
+  TouchEventQueue touch_event_queue_;
+
   // (Similar to |mouse_move_pending_|.) True while waiting for SelectRange_ACK.
   bool select_range_pending_;
 
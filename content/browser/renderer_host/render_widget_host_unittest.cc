@@ -41,6 +41,7 @@ using content::RenderWidgetHostImpl;
 using WebKit::WebGestureEvent;
 using WebKit::WebInputEvent;
 using WebKit::WebMouseWheelEvent;
+using WebKit::WebTouchEvent;
 
 namespace gfx {
 class Size;
@@ -131,7 +132,8 @@ bool RenderWidgetHostProcess::WaitForBackingStoreMsg(
 class TestView : public content::TestRenderWidgetHostView {
  public:
   explicit TestView(RenderWidgetHostImpl* rwh)
-      : content::TestRenderWidgetHostView(rwh) {
+      : content::TestRenderWidgetHostView(rwh),
+        touch_ack_count_(0) {
   }
 
   // Sets the bounds returned by GetViewBounds.
@@ -139,13 +141,21 @@ class TestView : public content::TestRenderWidgetHostView {
     bounds_ = bounds;
   }
 
+  int touch_ack_count() const { return touch_ack_count_; }
+
   // RenderWidgetHostView override.
   virtual gfx::Rect GetViewBounds() const {
     return bounds_;
   }
 
+  virtual void ProcessTouchAck(WebInputEvent::Type type,
+                               bool processed) OVERRIDE {
+    ++touch_ack_count_;
+  }
+
  protected:
   gfx::Rect bounds_;
+  int touch_ack_count_;
   DISALLOW_COPY_AND_ASSIGN(TestView);
 };
 
@@ -236,6 +246,14 @@ class MockRenderWidgetHost : public RenderWidgetHostImpl {
     hung_renderer_delay_ms_ = delay_ms;
   }
 
+  WebTouchEvent TouchEventLastQueueEvent() {
+    return touch_event_queue_.back().event;
+  }
+
+  unsigned TouchEventQueueSize() {
+    return touch_event_queue_.size();
+  }
+
   WebGestureEvent GestureEventLastQueueEvent() {
     return gesture_event_filter_->coalesced_gesture_events_.back();
   }
@@ -389,6 +407,30 @@ class RenderWidgetHostTest : public testing::Test {
     host_->ForwardGestureEvent(gesture_event);
   }
 
+  void SimulateGesturePinchUpdateEvent(float scale, int x, int y,
+                                       int modifiers) {
+    WebGestureEvent gesture_event;
+    gesture_event.type = WebInputEvent::GesturePinchUpdate;
+    gesture_event.data.pinchUpdate.scale = scale;
+    gesture_event.x = x;
+    gesture_event.y = y;
+    gesture_event.modifiers = modifiers;
+    host_->ForwardGestureEvent(gesture_event);
+  }
+
+  // Inject a touch event with a single touch point |id| at (|x|, |y|).
+  void SimulateTouchEvent(WebInputEvent::Type type, int id, int x, int y) {
+    WebTouchEvent touch_event;
+    touch_event.type = type;
+    touch_event.touchesLength = 1;
+    touch_event.touches[0].id = id;
+    touch_event.touches[0].position.x = x;
+    touch_event.touches[0].position.y = y;
+    touch_event.touches[0].state = type == WebInputEvent::TouchMove ?
+        WebKit::WebTouchPoint::StateMoved : WebKit::WebTouchPoint::StatePressed;
+    host_->ForwardTouchEvent(touch_event);
+  }
+
   // Inject simple synthetic WebGestureEvent instances.
   void SimulateGestureFlingStartEvent(float velocityX, float velocityY) {
     WebGestureEvent gesture_event;
@@ -906,6 +948,93 @@ TEST_F(RenderWidgetHostTest, CoalescesGesturesEvents) {
   EXPECT_EQ(0U, process_->sink().message_count());
 }
 
+TEST_F(RenderWidgetHostTest, CoalescesGesturePinchUpdates) {
+  // Turn off debounce handling for test isolation.
+  host_->set_debounce_interval_time_ms(0);
+  process_->sink().ClearMessages();
+
+  // Sent.
+  SimulateGestureEvent(WebInputEvent::GesturePinchBegin);
+
+  // Enqueued.
+  SimulateGesturePinchUpdateEvent(1.5f, 10, 20, 0);
+  EXPECT_EQ(2U, host_->GestureEventLastQueueEventSize());
+
+  // Coalesced: scales multiply and the anchor follows the latest event.
+  SimulateGesturePinchUpdateEvent(2.0f, 30, 40, 0);
+  EXPECT_EQ(2U, host_->GestureEventLastQueueEventSize());
+  WebGestureEvent merged_event = host_->GestureEventLastQueueEvent();
+  EXPECT_EQ(WebInputEvent::GesturePinchUpdate, merged_event.type);
+  EXPECT_FLOAT_EQ(3.0f, merged_event.data.pinchUpdate.scale);
+  EXPECT_EQ(30, merged_event.x);
+  EXPECT_EQ(40, merged_event.y);
+
+  // Enqueued, different modifiers.
+  SimulateGesturePinchUpdateEvent(2.0f, 30, 40, 1);
+  EXPECT_EQ(3U, host_->GestureEventLastQueueEventSize());
+
+  // Only the first event was sent.
+  EXPECT_EQ(1U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  SendInputEventACK(WebInputEvent::GesturePinchBegin, true);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(1U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  SendInputEventACK(WebInputEvent::GesturePinchUpdate, true);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(1U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  SendInputEventACK(WebInputEvent::GesturePinchUpdate, true);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(0U, process_->sink().message_count());
+  EXPECT_EQ(0U, host_->GestureEventLastQueueEventSize());
+}
+
+TEST_F(RenderWidgetHostTest, CoalescesTouchMoves) {
+  process_->sink().ClearMessages();
+
+  // Sent.
+  SimulateTouchEvent(WebInputEvent::TouchStart, 0, 10, 10);
+  EXPECT_EQ(1U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  // Enqueued.
+  SimulateTouchEvent(WebInputEvent::TouchMove, 0, 20, 20);
+  // Coalesced into the previous move.
+  SimulateTouchEvent(WebInputEvent::TouchMove, 0, 30, 30);
+  SimulateTouchEvent(WebInputEvent::TouchMove, 0, 40, 40);
+  EXPECT_EQ(2U, host_->TouchEventQueueSize());
+  WebTouchEvent merged_event = host_->TouchEventLastQueueEvent();
+  EXPECT_EQ(WebInputEvent::TouchMove, merged_event.type);
+  EXPECT_EQ(40, merged_event.touches[0].position.x);
+  EXPECT_EQ(WebKit::WebTouchPoint::StateMoved, merged_event.touches[0].state);
+
+  // A different touch point is not coalesced.
+  SimulateTouchEvent(WebInputEvent::TouchMove, 1, 50, 50);
+  EXPECT_EQ(3U, host_->TouchEventQueueSize());
+  EXPECT_EQ(0U, process_->sink().message_count());
+
+  // The TouchStart ack sends the merged move.
+  SendInputEventACK(WebInputEvent::TouchStart, true);
+  EXPECT_EQ(1, view_->touch_ack_count());
+  EXPECT_EQ(1U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  // The merged move is acked to the view once per forwarded event.
+  SendInputEventACK(WebInputEvent::TouchMove, true);
+  EXPECT_EQ(4, view_->touch_ack_count());
+  EXPECT_EQ(1U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  SendInputEventACK(WebInputEvent::TouchMove, true);
+  EXPECT_EQ(5, view_->touch_ack_count());
+  EXPECT_EQ(0U, process_->sink().message_count());
+  EXPECT_EQ(0U, host_->TouchEventQueueSize());
+}
+
 TEST_F(RenderWidgetHostTest, GestureFlingCancelsFiltered) {
   // Turn off debounce handling for test isolation.
   host_->set_debounce_interval_time_ms(0);
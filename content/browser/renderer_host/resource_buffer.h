@@ -71,6 +71,9 @@ class CONTENT_EXPORT ResourceBuffer
                   int max_allocation_size);
   bool IsInitialized() const;
 
+  // The size given to Initialize.
+  int buffer_size() const { return buf_size_; }
+
   // Returns a shared memory handle that can be passed to the given process.
   // The shared memory handle is only intended to be interpretted by code
   // running in the specified process.  NOTE: The caller should ensure that
@@ -39,6 +39,7 @@
 #include "content/browser/renderer_host/render_view_host_impl.h"
 #include "content/browser/renderer_host/resource_message_filter.h"
 #include "content/browser/renderer_host/resource_request_info_impl.h"
+#include "content/browser/renderer_host/resource_scheduler.h"
 #include "content/browser/renderer_host/sync_resource_handler.h"
 #include "content/browser/renderer_host/throttling_resource_handler.h"
 #include "content/browser/renderer_host/transfer_navigation_resource_throttle.h"
@@ -349,7 +350,8 @@ ResourceDispatcherHost* ResourceDispatcherHost::Get() {
 }
 
 ResourceDispatcherHostImpl::ResourceDispatcherHostImpl()
-    : download_file_manager_(new DownloadFileManager(NULL)),
+    : scheduler_(new ResourceScheduler()),
+      download_file_manager_(new DownloadFileManager(NULL)),
       save_file_manager_(new SaveFileManager()),
       request_id_(-1),
       is_shutdown_(false),
@@ -1051,6 +1053,11 @@ void ResourceDispatcherHostImpl::BeginRequest(
         new TransferNavigationResourceThrottle(request));
   }
 
+  // The scheduler goes last, so that it only holds back requests that every
+  // other throttle has let start.
+  throttles.push_back(
+      scheduler_->ScheduleRequest(child_id, route_id, request).release());
+
   if (!throttles.empty()) {
     handler.reset(
         new ThrottlingResourceHandler(handler.Pass(), child_id, request_id,
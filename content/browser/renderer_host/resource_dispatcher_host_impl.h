@@ -55,6 +55,7 @@ class ResourceContext;
 class ResourceDispatcherHostDelegate;
 class ResourceMessageFilter;
 class ResourceRequestInfoImpl;
+class ResourceScheduler;
 struct DownloadSaveInfo;
 struct GlobalRequestID;
 struct Referrer;
@@ -152,6 +153,8 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
     return save_file_manager_;
   }
 
+  ResourceScheduler* scheduler() { return scheduler_.get(); }
+
   // Called when the unload handler for a cross-site request has finished.
   void OnSwapOutACK(const ViewMsg_SwapOut_Params& params);
 
@@ -340,6 +343,10 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
   ResourceLoader* GetLoader(const GlobalRequestID& id) const;
   ResourceLoader* GetLoader(int child_id, int request_id) const;
 
+  // Declared before |pending_loaders_| so that it outlives the throttles it
+  // hands out.
+  scoped_ptr<ResourceScheduler> scheduler_;
+
   LoaderMap pending_loaders_;
 
   // Collection of temp files downloaded for child processes via
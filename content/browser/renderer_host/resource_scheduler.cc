@@ -0,0 +1,262 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_scheduler.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <string>
+
+#include "base/logging.h"
+#include "base/metrics/field_trial.h"
+#include "base/metrics/histogram.h"
+#include "base/stl_util.h"
+#include "base/time.h"
+#include "content/public/browser/resource_controller.h"
+#include "content/public/browser/resource_throttle.h"
+#include "content/public/common/content_constants.h"
+#include "googleurl/src/gurl.h"
+#include "net/base/request_priority.h"
+#include "net/url_request/url_request.h"
+
+namespace content {
+
+namespace {
+
+// While a page is loading, at most this many of its delayable requests may be
+// in flight to a single host, and at most this many in total.
+const size_t kMaxNumDelayableRequestsPerHost = 6;
+const size_t kMaxNumDelayableRequestsPerClient = 10;
+
+// While a visible page is loading, hidden pages may only have this many
+// delayable requests in flight.
+const size_t kMaxNumDelayableRequestsPerHiddenClient = 1;
+
+}  // namespace
+
+// Defers the start of a request until the scheduler lets it start.
+class ResourceScheduler::ScheduledResourceRequest : public ResourceThrottle {
+ public:
+  ScheduledResourceRequest(const ClientId& client_id,
+                           net::URLRequest* request,
+                           ResourceScheduler* scheduler)
+      : client_id_(client_id),
+        request_(request),
+        scheduler_(scheduler),
+        ready_(false),
+        deferred_(false),
+        creation_time_(base::TimeTicks::Now()) {
+  }
+
+  virtual ~ScheduledResourceRequest() {
+    scheduler_->RemoveRequest(this);
+  }
+
+  // Lets the request start, resuming it if it was deferred.
+  void Start() {
+    DCHECK(!ready_);
+    ready_ = true;
+    if (deferred_) {
+      UMA_HISTOGRAM_TIMES("ResourceScheduler.DelayedRequestWaitTime",
+                          base::TimeTicks::Now() - creation_time_);
+      deferred_ = false;
+      controller()->Resume();
+    }
+  }
+
+  // ResourceThrottle implementation:
+  virtual void WillStartRequest(bool* defer) OVERRIDE {
+    deferred_ = *defer = !ready_;
+  }
+
+  const ClientId& client_id() const { return client_id_; }
+
+  bool IsDelayable() const {
+    return request_->priority() < net::LOW;
+  }
+
+  std::string host() const {
+    return request_->url().host();
+  }
+
+ private:
+  ClientId client_id_;
+  net::URLRequest* request_;
+  ResourceScheduler* scheduler_;
+  bool ready_;
+  bool deferred_;
+  base::TimeTicks creation_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScheduledResourceRequest);
+};
+
+struct ResourceScheduler::Client {
+  Client() : is_visible(true), is_loading(false) {}
+
+  bool is_visible;
+  bool is_loading;
+  // In the order the requests were made.
+  std::deque<ScheduledResourceRequest*> pending_requests;
+  std::set<ScheduledResourceRequest*> in_flight_requests;
+};
+
+ResourceScheduler::ResourceScheduler()
+    : enabled_(base::FieldTrialList::FindFullName(
+          kResourceSchedulerFieldTrialName) !=
+          kResourceSchedulerFieldTrialControlName) {
+}
+
+ResourceScheduler::~ResourceScheduler() {
+  STLDeleteValues(&client_map_);
+}
+
+scoped_ptr<ResourceThrottle> ResourceScheduler::ScheduleRequest(
+    int child_id,
+    int route_id,
+    net::URLRequest* url_request) {
+  ClientId client_id(child_id, route_id);
+  ScheduledResourceRequest* request =
+      new ScheduledResourceRequest(client_id, url_request, this);
+
+  ClientMap::iterator it = client_map_.find(client_id);
+  if (!enabled_ || it == client_map_.end()) {
+    // Not a RenderView the scheduler knows about; nothing to order it with.
+    request->Start();
+    return scoped_ptr<ResourceThrottle>(request);
+  }
+
+  Client* client = it->second;
+  if (ShouldStartRequest(request, client)) {
+    client->in_flight_requests.insert(request);
+    request->Start();
+  } else {
+    client->pending_requests.push_back(request);
+  }
+  return scoped_ptr<ResourceThrottle>(request);
+}
+
+void ResourceScheduler::OnClientCreated(int child_id, int route_id) {
+  ClientId client_id(child_id, route_id);
+  DCHECK(!ContainsKey(client_map_, client_id));
+  client_map_[client_id] = new Client;
+}
+
+void ResourceScheduler::OnClientDeleted(int child_id, int route_id) {
+  ClientId client_id(child_id, route_id);
+  ClientMap::iterator it = client_map_.find(client_id);
+  if (it == client_map_.end())
+    return;
+
+  // Requests that outlive their RenderView are no longer scheduled.
+  Client* client = it->second;
+  client_map_.erase(it);
+  std::deque<ScheduledResourceRequest*> pending;
+  pending.swap(client->pending_requests);
+  delete client;
+  for (size_t i = 0; i < pending.size(); ++i)
+    pending[i]->Start();
+
+  LoadAnyStartablePendingRequests();
+}
+
+void ResourceScheduler::OnVisibilityChanged(int child_id,
+                                            int route_id,
+                                            bool is_visible) {
+  ClientMap::iterator it = client_map_.find(ClientId(child_id, route_id));
+  if (it == client_map_.end())
+    return;
+  it->second->is_visible = is_visible;
+  LoadAnyStartablePendingRequests();
+}
+
+void ResourceScheduler::OnLoadingStateChanged(int child_id,
+                                              int route_id,
+                                              bool is_loading) {
+  ClientMap::iterator it = client_map_.find(ClientId(child_id, route_id));
+  if (it == client_map_.end())
+    return;
+  it->second->is_loading = is_loading;
+  LoadAnyStartablePendingRequests();
+}
+
+void ResourceScheduler::RemoveRequest(ScheduledResourceRequest* request) {
+  ClientMap::iterator it = client_map_.find(request->client_id());
+  if (it == client_map_.end())
+    return;
+
+  Client* client = it->second;
+  if (client->in_flight_requests.erase(request)) {
+    LoadAnyStartablePendingRequests();
+    return;
+  }
+  std::deque<ScheduledResourceRequest*>::iterator pending_it =
+      std::find(client->pending_requests.begin(),
+                client->pending_requests.end(), request);
+  if (pending_it != client->pending_requests.end())
+    client->pending_requests.erase(pending_it);
+}
+
+void ResourceScheduler::LoadAnyStartablePendingRequests() {
+  for (ClientMap::iterator it = client_map_.begin(); it != client_map_.end();
+       ++it) {
+    Client* client = it->second;
+    // Requests are started in order, so that a page's images load top to
+    // bottom.
+    while (!client->pending_requests.empty()) {
+      ScheduledResourceRequest* request = client->pending_requests.front();
+      if (!ShouldStartRequest(request, client))
+        break;
+      client->pending_requests.pop_front();
+      client->in_flight_requests.insert(request);
+      request->Start();
+    }
+  }
+}
+
+bool ResourceScheduler::ShouldStartRequest(ScheduledResourceRequest* request,
+                                           Client* client) const {
+  if (!request->IsDelayable())
+    return true;
+
+  size_t max_in_flight = kMaxNumDelayableRequestsPerClient;
+  bool limit_per_host = client->is_loading;
+  if (!client->is_visible && AnyVisibleClientIsLoading()) {
+    max_in_flight = kMaxNumDelayableRequestsPerHiddenClient;
+  } else if (!client->is_loading) {
+    return true;
+  }
+
+  size_t num_delayable_in_flight = 0;
+  size_t num_delayable_in_flight_to_host = 0;
+  std::string host = request->host();
+  for (std::set<ScheduledResourceRequest*>::const_iterator it =
+           client->in_flight_requests.begin();
+       it != client->in_flight_requests.end(); ++it) {
+    if (!(*it)->IsDelayable())
+      continue;
+    ++num_delayable_in_flight;
+    if ((*it)->host() == host)
+      ++num_delayable_in_flight_to_host;
+  }
+
+  if (num_delayable_in_flight >= max_in_flight)
+    return false;
+  if (limit_per_host &&
+      num_delayable_in_flight_to_host >= kMaxNumDelayableRequestsPerHost) {
+    return false;
+  }
+  return true;
+}
+
+bool ResourceScheduler::AnyVisibleClientIsLoading() const {
+  for (ClientMap::const_iterator it = client_map_.begin();
+       it != client_map_.end(); ++it) {
+    if (it->second->is_visible && it->second->is_loading)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace content
@@ -0,0 +1,80 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
+#define CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
+
+#include <map>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "content/common/content_export.h"
+
+namespace net {
+class URLRequest;
+}
+
+namespace content {
+class ResourceThrottle;
+
+// Decides when the requests of a RenderView may start. Requests that the
+// page does not need to render (images, favicons and prefetches) are
+// "delayable": while a page is loading, only a few of them may be in flight
+// per host, and the delayable requests of hidden pages are held back while a
+// visible page is loading. Other requests, and requests that do not belong
+// to a known RenderView, are never delayed.
+//
+// Must only be used on the IO thread.
+class CONTENT_EXPORT ResourceScheduler {
+ public:
+  ResourceScheduler();
+  ~ResourceScheduler();
+
+  // Returns a throttle that defers |url_request| until it may start. The
+  // throttle must be added to the request's throttles, and deleted with it.
+  scoped_ptr<ResourceThrottle> ScheduleRequest(int child_id,
+                                               int route_id,
+                                               net::URLRequest* url_request);
+
+  // Called when a RenderView is created and deleted. Clients start visible
+  // and not loading.
+  void OnClientCreated(int child_id, int route_id);
+  void OnClientDeleted(int child_id, int route_id);
+
+  // Called when a RenderView is shown or hidden, and when it starts or stops
+  // loading.
+  void OnVisibilityChanged(int child_id, int route_id, bool is_visible);
+  void OnLoadingStateChanged(int child_id, int route_id, bool is_loading);
+
+ private:
+  class ScheduledResourceRequest;
+  struct Client;
+
+  typedef std::pair<int, int> ClientId;
+  typedef std::map<ClientId, Client*> ClientMap;
+
+  // Called by a ScheduledResourceRequest when its request is destroyed.
+  void RemoveRequest(ScheduledResourceRequest* request);
+
+  // Starts the pending requests of every client that may now start.
+  void LoadAnyStartablePendingRequests();
+
+  // Returns true if |request| of |client| may start now.
+  bool ShouldStartRequest(ScheduledResourceRequest* request,
+                          Client* client) const;
+
+  bool AnyVisibleClientIsLoading() const;
+
+  // False for the control group of the field trial.
+  bool enabled_;
+
+  ClientMap client_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceScheduler);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
@@ -0,0 +1,166 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_scheduler.h"
+
+#include <string>
+
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "content/public/browser/resource_controller.h"
+#include "content/public/browser/resource_throttle.h"
+#include "googleurl/src/gurl.h"
+#include "net/base/request_priority.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const int kChildId = 30;
+const int kRouteId = 75;
+const int kHiddenRouteId = 76;
+
+// Records whether the request it controls was resumed.
+class TestRequest : public ResourceController {
+ public:
+  TestRequest(const std::string& url,
+              net::RequestPriority priority,
+              const net::URLRequestContext* context)
+      : url_request_(GURL(url), NULL, context),
+        started_(false) {
+    url_request_.set_priority(priority);
+  }
+
+  // Hands the request to |scheduler| and lets the throttle decide whether it
+  // starts now.
+  void Schedule(ResourceScheduler* scheduler, int route_id) {
+    throttle_ = scheduler->ScheduleRequest(kChildId, route_id, &url_request_);
+    throttle_->set_controller_for_testing(this);
+    bool deferred = false;
+    throttle_->WillStartRequest(&deferred);
+    started_ = !deferred;
+  }
+
+  // Destroys the throttle, as finishing the request does.
+  void Finish() { throttle_.reset(); }
+
+  bool started() const { return started_; }
+
+  // ResourceController implementation:
+  virtual void Cancel() OVERRIDE {}
+  virtual void CancelAndIgnore() OVERRIDE {}
+  virtual void Resume() OVERRIDE { started_ = true; }
+
+ private:
+  net::URLRequest url_request_;
+  scoped_ptr<ResourceThrottle> throttle_;
+  bool started_;
+};
+
+class ResourceSchedulerTest : public testing::Test {
+ protected:
+  ResourceSchedulerTest() {
+    scheduler_.OnClientCreated(kChildId, kRouteId);
+    scheduler_.OnClientCreated(kChildId, kHiddenRouteId);
+    scheduler_.OnVisibilityChanged(kChildId, kHiddenRouteId, false);
+  }
+
+  virtual ~ResourceSchedulerTest() {
+    requests_.clear();
+    scheduler_.OnClientDeleted(kChildId, kRouteId);
+    scheduler_.OnClientDeleted(kChildId, kHiddenRouteId);
+  }
+
+  TestRequest* NewRequest(const std::string& url,
+                          net::RequestPriority priority,
+                          int route_id) {
+    TestRequest* request = new TestRequest(url, priority, &context_);
+    requests_.push_back(request);
+    request->Schedule(&scheduler_, route_id);
+    return request;
+  }
+
+  MessageLoopForIO message_loop_;
+  TestURLRequestContext context_;
+  ResourceScheduler scheduler_;
+  ScopedVector<TestRequest> requests_;
+};
+
+}  // namespace
+
+TEST_F(ResourceSchedulerTest, ImagesStartWhenNotLoading) {
+  for (int i = 0; i < 20; ++i)
+    EXPECT_TRUE(NewRequest("http://host/img", net::LOWEST, kRouteId)->
+        started());
+}
+
+TEST_F(ResourceSchedulerTest, ImagesPerHostLimitedWhileLoading) {
+  scheduler_.OnLoadingStateChanged(kChildId, kRouteId, true);
+
+  TestRequest* images[7];
+  for (int i = 0; i < 7; ++i)
+    images[i] = NewRequest("http://host/img", net::LOWEST, kRouteId);
+  for (int i = 0; i < 6; ++i)
+    EXPECT_TRUE(images[i]->started());
+  EXPECT_FALSE(images[6]->started());
+
+  // Other hosts and render-blocking requests are not held back.
+  EXPECT_TRUE(NewRequest("http://other/img", net::LOWEST, kRouteId)->
+      started());
+  EXPECT_TRUE(NewRequest("http://host/style", net::MEDIUM, kRouteId)->
+      started());
+
+  images[0]->Finish();
+  EXPECT_TRUE(images[6]->started());
+}
+
+TEST_F(ResourceSchedulerTest, PendingImagesStartWhenLoadingStops) {
+  scheduler_.OnLoadingStateChanged(kChildId, kRouteId, true);
+  TestRequest* last = NULL;
+  for (int i = 0; i < 8; ++i)
+    last = NewRequest("http://host/img", net::LOWEST, kRouteId);
+  EXPECT_FALSE(last->started());
+
+  scheduler_.OnLoadingStateChanged(kChildId, kRouteId, false);
+  EXPECT_TRUE(last->started());
+}
+
+TEST_F(ResourceSchedulerTest, HiddenTabsYieldToLoadingVisibleTab) {
+  scheduler_.OnLoadingStateChanged(kChildId, kRouteId, true);
+
+  TestRequest* first = NewRequest("http://a/img", net::LOWEST, kHiddenRouteId);
+  TestRequest* second = NewRequest("http://b/img", net::LOWEST,
+                                   kHiddenRouteId);
+  EXPECT_TRUE(first->started());
+  EXPECT_FALSE(second->started());
+  EXPECT_TRUE(NewRequest("http://a/script", net::MEDIUM, kHiddenRouteId)->
+      started());
+
+  // Showing the tab lets its images go.
+  scheduler_.OnVisibilityChanged(kChildId, kHiddenRouteId, true);
+  EXPECT_TRUE(second->started());
+}
+
+TEST_F(ResourceSchedulerTest, UnknownClientsAreNotScheduled) {
+  scheduler_.OnLoadingStateChanged(kChildId, kRouteId, true);
+  for (int i = 0; i < 20; ++i)
+    EXPECT_TRUE(NewRequest("http://host/img", net::LOWEST, 1234)->started());
+}
+
+TEST_F(ResourceSchedulerTest, PendingRequestsStartWhenClientDeleted) {
+  scheduler_.OnLoadingStateChanged(kChildId, kRouteId, true);
+  TestRequest* last = NULL;
+  for (int i = 0; i < 7; ++i)
+    last = NewRequest("http://host/img", net::LOWEST, kRouteId);
+  EXPECT_FALSE(last->started());
+
+  scheduler_.OnClientDeleted(kChildId, kRouteId);
+  EXPECT_TRUE(last->started());
+  scheduler_.OnClientCreated(kChildId, kRouteId);
+}
+
+}  // namespace content
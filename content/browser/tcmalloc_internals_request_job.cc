@@ -91,8 +91,10 @@ void AboutTcmalloc(std::string* data) {
   // and send off requests to all the renderer processes.
   char buffer[1024 * 32];
   base::allocator::GetStats(buffer, sizeof(buffer));
+  std::string browser_output(buffer);
+  base::allocator::GetHeapSample(&browser_output);
   std::string browser("Browser");
-  AboutTcmallocOutputs::GetInstance()->SetOutput(browser, buffer);
+  AboutTcmallocOutputs::GetInstance()->SetOutput(browser, browser_output);
 
   for (BrowserChildProcessHostIterator iter; !iter.Done(); ++iter) {
     iter.Send(new ChildProcessMsg_GetTcmallocStats);
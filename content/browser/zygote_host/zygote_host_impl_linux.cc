@@ -103,6 +103,7 @@ void ZygoteHostImpl::Init(const std::string& sandbox_cmd) {
     switches::kDisableSeccompSandbox,
     switches::kDisableSeccompFilterSandbox,
     switches::kEnableSeccompSandbox,
+    switches::kRendererPoolSize,
 
     // Zygote process needs to know what resources to have loaded when it
     // becomes a renderer process.
@@ -242,6 +243,7 @@ pid_t ZygoteHostImpl::ForkRequest(
     const std::vector<content::FileDescriptorInfo>& mapping,
     const std::string& process_type) {
   DCHECK(init_);
+  base::TimeTicks start_time = base::TimeTicks::Now();
   Pickle pickle;
 
   pickle.WriteInt(content::kZygoteCommandFork);
@@ -315,6 +317,13 @@ pid_t ZygoteHostImpl::ForkRequest(
       return base::kNullProcessHandle;
   }
 
+  // Includes the time spent waiting for other requests, since they hold up
+  // this one just the same.
+  if (process_type == switches::kRendererProcess) {
+    UMA_HISTOGRAM_TIMES("Linux.ZygoteRendererForkTime",
+                        base::TimeTicks::Now() - start_time);
+  }
+
 #if !defined(OS_OPENBSD)
   // This is just a starting score for a renderer or extension (the
   // only types of processes that will be started this way).  It will
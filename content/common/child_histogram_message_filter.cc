@@ -73,8 +73,10 @@ void ChildHistogramMessageFilter::RecordDelta(
     const base::Histogram& histogram,
     const base::HistogramSamples& snapshot) {
   DCHECK_NE(0, snapshot.TotalCount());
-  std::string histogram_info =
-      base::Histogram::SerializeHistogramInfo(histogram, snapshot);
+  bool include_metadata = histograms_with_metadata_sent_.insert(
+      histogram.histogram_name()).second;
+  std::string histogram_info = base::Histogram::SerializeHistogramInfo(
+      histogram, snapshot, include_metadata);
 
   pickled_histograms_.push_back(histogram_info);
 }
@@ -5,6 +5,7 @@
 #ifndef CONTENT_COMMOM_CHILD_HISTOGRAM_MESSAGE_FILTER_H_
 #define CONTENT_COMMOM_CHILD_HISTOGRAM_MESSAGE_FILTER_H_
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,7 @@ class ChildHistogramMessageFilter : public base::HistogramFlattener,
 
  private:
   typedef std::vector<std::string> HistogramPickledList;
+  typedef std::set<std::string> HistogramNameSet;
 
   virtual ~ChildHistogramMessageFilter();
 
@@ -60,6 +62,10 @@ class ChildHistogramMessageFilter : public base::HistogramFlattener,
   // Collection of histograms to send to the browser.
   HistogramPickledList pickled_histograms_;
 
+  // Names of histograms whose metadata (ranges, type, flags) the browser has
+  // already been sent. Later deltas for these carry only their samples.
+  HistogramNameSet histograms_with_metadata_sent_;
+
   // |histogram_snapshot_manager_| prepares histogram deltas for transmission.
   base::HistogramSnapshotManager histogram_snapshot_manager_;
 
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/memory_pressure_listener.h"
 #include "base/shared_memory.h"
 #include "base/tracked_objects.h"
 #include "base/values.h"
@@ -15,6 +16,7 @@
 #include "googleurl/src/gurl.h"
 #include "ipc/ipc_message_macros.h"
 
+IPC_ENUM_TRAITS(base::MemoryPressureListener::MemoryPressureLevel)
 IPC_ENUM_TRAITS(tracked_objects::ThreadData::Status)
 
 IPC_STRUCT_TRAITS_BEGIN(tracked_objects::LocationSnapshot)
@@ -107,6 +109,10 @@ IPC_MESSAGE_CONTROL1(ChildProcessMsg_GetChildHistogramData,
 // Sent to child processes to dump their handle table.
 IPC_MESSAGE_CONTROL0(ChildProcessMsg_DumpHandles)
 
+// Sent to all the child processes when the system is running low on memory.
+IPC_MESSAGE_CONTROL1(ChildProcessMsg_MemoryPressure,
+                     base::MemoryPressureListener::MemoryPressureLevel)
+
 #if defined(USE_TCMALLOC)
 // Sent to child process to request tcmalloc stats.
 IPC_MESSAGE_CONTROL0(ChildProcessMsg_GetTcmallocStats)
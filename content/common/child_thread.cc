@@ -5,6 +5,7 @@
 #include "content/common/child_thread.h"
 
 #include "base/allocator/allocator_extension.h"
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/message_loop.h"
 #include "base/process.h"
@@ -260,6 +261,7 @@ bool ChildThread::OnMessageReceived(const IPC::Message& msg) {
     IPC_MESSAGE_HANDLER(ChildProcessMsg_GetChildProfilerData,
                         OnGetChildProfilerData)
     IPC_MESSAGE_HANDLER(ChildProcessMsg_DumpHandles, OnDumpHandles)
+    IPC_MESSAGE_HANDLER(ChildProcessMsg_MemoryPressure, OnMemoryPressure)
 #if defined(USE_TCMALLOC)
     IPC_MESSAGE_HANDLER(ChildProcessMsg_GetTcmallocStats, OnGetTcmallocStats)
 #endif
@@ -318,12 +320,23 @@ void ChildThread::OnDumpHandles() {
   NOTIMPLEMENTED();
 }
 
+void ChildThread::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  base::MemoryPressureListener::NotifyMemoryPressure(level);
+
+  // The listeners on this thread run first, so the memory they free can be
+  // returned to the system.
+  MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&base::allocator::ReleaseFreeMemory));
+}
+
 #if defined(USE_TCMALLOC)
 void ChildThread::OnGetTcmallocStats() {
   std::string result;
   char buffer[1024 * 32];
   base::allocator::GetStats(buffer, sizeof(buffer));
   result.append(buffer);
+  base::allocator::GetHeapSample(&result);
   Send(new ChildProcessHostMsg_TcmallocStats(result));
 }
 #endif
@@ -6,6 +6,7 @@
 #define CONTENT_COMMON_CHILD_THREAD_H_
 
 #include "base/basictypes.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/shared_memory.h"
@@ -119,6 +120,8 @@ class CONTENT_EXPORT ChildThread : public IPC::Listener, public IPC::Sender {
   void OnSetProfilerStatus(tracked_objects::ThreadData::Status status);
   void OnGetChildProfilerData(int sequence_number);
   void OnDumpHandles();
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
 #ifdef IPC_MESSAGE_LOG_ENABLED
   void OnSetIPCLoggingEnabled(bool enable);
 #endif
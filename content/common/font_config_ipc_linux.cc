@@ -10,9 +10,28 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 
+#include "base/metrics/histogram.h"
 #include "base/pickle.h"
 #include "base/posix/unix_domain_socket.h"
 
+namespace {
+
+// The most match results kept. A page uses a few dozen families at most,
+// but character fallback adds an entry per distinct run of characters.
+const size_t kMaxCachedMatches = 1024;
+
+}  // namespace
+
+FontConfigIPC::MatchResult::MatchResult()
+    : found(false),
+      filefaceid(0),
+      is_bold(false),
+      is_italic(false) {
+}
+
+FontConfigIPC::MatchResult::~MatchResult() {
+}
+
 FontConfigIPC::FontConfigIPC(int fd)
     : fd_(fd) {
 }
@@ -37,7 +56,7 @@ bool FontConfigIPC::Match(std::string* result_family,
     request.WriteUInt32(filefaceid);
 
   request.WriteBool(is_bold && *is_bold);
-  request.WriteBool(is_bold && *is_italic);
+  request.WriteBool(is_italic && *is_italic);
 
   request.WriteUInt32(characters_bytes);
   if (characters_bytes)
@@ -45,40 +64,63 @@ bool FontConfigIPC::Match(std::string* result_family,
 
   request.WriteString(family);
 
-  uint8_t reply_buf[512];
-  const ssize_t r = UnixDomainSocket::SendRecvMsg(fd_, reply_buf,
-                                                  sizeof(reply_buf), NULL,
-                                                  request);
-  if (r == -1)
-    return false;
-
-  Pickle reply(reinterpret_cast<char*>(reply_buf), r);
-  PickleIterator iter(reply);
-  bool result;
-  if (!reply.ReadBool(&iter, &result))
-    return false;
-  if (!result)
-    return false;
+  const std::string cache_key(static_cast<const char*>(request.data()),
+                              request.size());
+  MatchResult match;
+  bool cached = false;
+  {
+    base::AutoLock lock(match_cache_lock_);
+    MatchCache::const_iterator it = match_cache_.find(cache_key);
+    if (it != match_cache_.end()) {
+      match = it->second;
+      cached = true;
+    }
+  }
+  UMA_HISTOGRAM_BOOLEAN("Renderer.FontConfigMatchCacheHit", cached);
+
+  if (!cached) {
+    uint8_t reply_buf[512];
+    const ssize_t r = UnixDomainSocket::SendRecvMsg(fd_, reply_buf,
+                                                    sizeof(reply_buf), NULL,
+                                                    request);
+    if (r == -1)
+      return false;
+
+    Pickle reply(reinterpret_cast<char*>(reply_buf), r);
+    PickleIterator iter(reply);
+    if (!reply.ReadBool(&iter, &match.found))
+      return false;
+    if (match.found) {
+      uint32_t reply_filefaceid;
+      if (!reply.ReadUInt32(&iter, &reply_filefaceid) ||
+          !reply.ReadString(&iter, &match.family) ||
+          !reply.ReadBool(&iter, &match.is_bold) ||
+          !reply.ReadBool(&iter, &match.is_italic)) {
+        return false;
+      }
+      match.filefaceid = reply_filefaceid;
+    }
+
+    // Only well-formed answers are kept, including "no match", which is
+    // common for character fallback.
+    base::AutoLock lock(match_cache_lock_);
+    if (match_cache_.size() >= kMaxCachedMatches)
+      match_cache_.clear();
+    match_cache_[cache_key] = match;
+  }
 
-  uint32_t reply_filefaceid;
-  std::string reply_family;
-  bool resulting_bold, resulting_italic;
-  if (!reply.ReadUInt32(&iter, &reply_filefaceid) ||
-      !reply.ReadString(&iter, &reply_family) ||
-      !reply.ReadBool(&iter, &resulting_bold) ||
-      !reply.ReadBool(&iter, &resulting_italic)) {
+  if (!match.found)
     return false;
-  }
 
   if (result_filefaceid)
-    *result_filefaceid = reply_filefaceid;
+    *result_filefaceid = match.filefaceid;
   if (result_family)
-    *result_family = reply_family;
+    *result_family = match.family;
 
   if (is_bold)
-    *is_bold = resulting_bold;
+    *is_bold = match.is_bold;
   if (is_italic)
-    *is_italic = resulting_italic;
+    *is_italic = match.is_italic;
 
   return true;
 }
@@ -5,11 +5,13 @@
 #ifndef CONTENT_COMMON_FONT_CONFIG_IPC_LINUX_H_
 #define CONTENT_COMMON_FONT_CONFIG_IPC_LINUX_H_
 
+#include <map>
+#include <string>
+
 #include "base/compiler_specific.h"
+#include "base/synchronization/lock.h"
 #include "skia/ext/SkFontHost_fontconfig_impl.h"
 
-#include <string>
-
 // FontConfig implementation for Skia that proxies out of process to get out
 // of the sandbox. See http://code.google.com/p/chromium/wiki/LinuxSandboxIPC
 class FontConfigIPC : public FontConfigInterface {
@@ -34,7 +36,28 @@ class FontConfigIPC : public FontConfigInterface {
   };
 
  private:
+  // The browser's answer to a match request.
+  struct MatchResult {
+    MatchResult();
+    ~MatchResult();
+
+    bool found;
+    unsigned filefaceid;
+    std::string family;
+    bool is_bold;
+    bool is_italic;
+  };
+
+  // Keyed by the serialized request, which holds every input of Match().
+  typedef std::map<std::string, MatchResult> MatchCache;
+
   const int fd_;
+
+  // Skia asks for the same families over and over while laying out text, and
+  // each request is a synchronous round trip to the browser. Fonts do not
+  // change during the life of a renderer, so the answers are kept.
+  base::Lock match_cache_lock_;
+  MatchCache match_cache_;
 };
 
 #endif  // CONTENT_COMMON_FONT_CONFIG_IPC_LINUX_H_
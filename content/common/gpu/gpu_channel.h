@@ -14,6 +14,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/process.h"
+#include "base/time.h"
 #include "build/build_config.h"
 #include "content/common/gpu/gpu_command_buffer_stub.h"
 #include "content/common/gpu/gpu_memory_manager.h"
@@ -78,6 +79,13 @@ class GpuChannel : public IPC::Listener,
 
   base::ProcessId renderer_pid() const { return channel_->peer_pid(); }
 
+  // The total time spent processing the commands of the contexts of this
+  // channel, including the contexts that were destroyed.
+  base::TimeDelta processing_time() const { return processing_time_; }
+  void AddProcessingTime(base::TimeDelta processing_time) {
+    processing_time_ += processing_time;
+  }
+
   // IPC::Listener implementation:
   virtual bool OnMessageReceived(const IPC::Message& msg) OVERRIDE;
   virtual void OnChannelError() OVERRIDE;
@@ -182,6 +190,8 @@ class GpuChannel : public IPC::Listener,
   // is non-zero.
   scoped_refptr<gpu::RefCountedCounter> preempt_by_counter_;
 
+  base::TimeDelta processing_time_;
+
   std::deque<IPC::Message*> deferred_messages_;
 
   // The id of the client who is on the other side of the channel.
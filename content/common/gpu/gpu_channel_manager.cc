@@ -11,7 +11,10 @@
 #include "content/common/gpu/gpu_memory_manager.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/gpu/sync_point_manager.h"
+#include "content/public/common/content_switches.h"
+#include "content/public/common/gpu_memory_stats.h"
 #include "gpu/command_buffer/service/feature_info.h"
+#include "gpu/command_buffer/service/gpu_scheduler.h"
 #include "gpu/command_buffer/service/gpu_switches.h"
 #include "gpu/command_buffer/service/mailbox_manager.h"
 #include "gpu/command_buffer/service/memory_program_cache.h"
@@ -26,6 +29,7 @@ GpuChannelManager::GpuChannelManager(ChildThread* gpu_child_thread,
       io_message_loop_(io_message_loop),
       shutdown_event_(shutdown_event),
       gpu_child_thread_(gpu_child_thread),
+      preempting_client_id_(0),
       ALLOW_THIS_IN_INITIALIZER_LIST(gpu_memory_manager_(this,
           GpuMemoryManager::kDefaultMaxSurfacesWithFrontbufferSoftLimit)),
       watchdog_(watchdog),
@@ -50,12 +54,50 @@ gpu::gles2::ProgramCache* GpuChannelManager::program_cache() {
       !CommandLine::ForCurrentProcess()->HasSwitch(
           switches::kDisableGpuProgramCache)) {
     program_cache_.reset(new gpu::gles2::MemoryProgramCache());
+
+    // The binaries depend on the driver, which is identified by the strings
+    // of the context current while the cache is created.
+    std::string driver_identity;
+    const GLenum kDriverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (size_t i = 0; i < arraysize(kDriverStrings); ++i) {
+      const char* string =
+          reinterpret_cast<const char*>(glGetString(kDriverStrings[i]));
+      driver_identity += string ? string : "";
+      driver_identity += "\n";
+    }
+    program_cache_->EnablePersistence(
+        driver_identity,
+        base::Bind(&GpuChannelManager::PersistProgram,
+                   base::Unretained(this)));
+    for (size_t i = 0; i < loaded_programs_.size(); ++i)
+      program_cache_->LoadProgram(loaded_programs_[i]);
+    loaded_programs_.clear();
   }
   return program_cache_.get();
 }
 
+void GpuChannelManager::OnLoadedProgram(const std::string& program) {
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableGpuProgramCache)) {
+    return;
+  }
+  if (program_cache_.get())
+    program_cache_->LoadProgram(program);
+  else
+    loaded_programs_.push_back(program);
+}
+
+void GpuChannelManager::PersistProgram(const std::string& key,
+                                       const std::string& program) {
+  Send(new GpuHostMsg_CacheProgram(key, program));
+}
+
 void GpuChannelManager::RemoveChannel(int client_id) {
   gpu_channels_.erase(client_id);
+  if (client_id == preempting_client_id_) {
+    preempting_client_id_ = 0;
+    UpdatePreemption();
+  }
 }
 
 int GpuChannelManager::GenerateRouteID() {
@@ -95,6 +137,7 @@ bool GpuChannelManager::OnMessageReceived(const IPC::Message& msg) {
     IPC_MESSAGE_HANDLER(GpuMsg_CloseChannel, OnCloseChannel)
     IPC_MESSAGE_HANDLER(GpuMsg_CreateViewCommandBuffer,
                         OnCreateViewCommandBuffer)
+    IPC_MESSAGE_HANDLER(GpuMsg_LoadedProgram, OnLoadedProgram)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP_EX()
   return handled;
@@ -104,7 +147,9 @@ bool GpuChannelManager::Send(IPC::Message* msg) {
   return gpu_child_thread_->Send(msg);
 }
 
-void GpuChannelManager::OnEstablishChannel(int client_id, bool share_context) {
+void GpuChannelManager::OnEstablishChannel(int client_id,
+                                           bool share_context,
+                                           bool preempts_other_channels) {
   IPC::ChannelHandle channel_handle;
 
   gfx::GLShareGroup* share_group = NULL;
@@ -129,6 +174,13 @@ void GpuChannelManager::OnEstablishChannel(int client_id, bool share_context) {
     gpu_channels_[client_id] = channel;
     channel_handle.name = channel->GetChannelName();
 
+    if (preempts_other_channels &&
+        CommandLine::ForCurrentProcess()->HasSwitch(
+            switches::kUIPrioritizeInGpuProcess)) {
+      preempting_client_id_ = client_id;
+    }
+    UpdatePreemption();
+
 #if defined(OS_POSIX)
     // On POSIX, pass the renderer-side FD. Also mark it as auto-close so
     // that it gets closed after it has been sent.
@@ -146,7 +198,12 @@ void GpuChannelManager::OnCloseChannel(
   for (GpuChannelMap::iterator iter = gpu_channels_.begin();
        iter != gpu_channels_.end(); ++iter) {
     if (iter->second->GetChannelName() == channel_handle.name) {
+      int client_id = iter->first;
       gpu_channels_.erase(iter);
+      if (client_id == preempting_client_id_) {
+        preempting_client_id_ = 0;
+        UpdatePreemption();
+      }
       return;
     }
   }
@@ -178,6 +235,36 @@ void GpuChannelManager::LoseAllContexts() {
 
 void GpuChannelManager::OnLoseAllContexts() {
   gpu_channels_.clear();
+  preempting_client_id_ = 0;
+}
+
+void GpuChannelManager::GetProcessingTimes(
+    content::GPUVideoMemoryUsageStats* video_memory_usage_stats) const {
+  base::TimeDelta total_processing_time;
+  for (GpuChannelMap::const_iterator iter = gpu_channels_.begin();
+       iter != gpu_channels_.end(); ++iter) {
+    base::TimeDelta processing_time = iter->second->processing_time();
+    video_memory_usage_stats->process_map[
+        iter->second->renderer_pid()].gpu_time += processing_time;
+    total_processing_time += processing_time;
+  }
+  video_memory_usage_stats->process_map[
+      base::GetCurrentProcId()].gpu_time = total_processing_time;
+}
+
+void GpuChannelManager::UpdatePreemption() {
+  scoped_refptr<gpu::RefCountedCounter> preempt_by_counter;
+  GpuChannel* preempting_channel = LookupChannel(preempting_client_id_);
+  if (preempting_channel)
+    preempt_by_counter = preempting_channel->MessagesPendingCount();
+
+  for (GpuChannelMap::iterator iter = gpu_channels_.begin();
+       iter != gpu_channels_.end(); ++iter) {
+    if (iter->second.get() == preempting_channel)
+      iter->second->SetPreemptByCounter(NULL);
+    else
+      iter->second->SetPreemptByCounter(preempt_by_counter);
+  }
 }
 
 gfx::GLSurface* GpuChannelManager::GetDefaultOffscreenSurface() {
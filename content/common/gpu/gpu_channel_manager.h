@@ -5,6 +5,7 @@
 #ifndef CONTENT_COMMON_GPU_GPU_CHANNEL_MANAGER_H_
 #define CONTENT_COMMON_GPU_GPU_CHANNEL_MANAGER_H_
 
+#include <string>
 #include <vector>
 
 #include "base/hash_tables.h"
@@ -30,6 +31,7 @@ class GLShareGroup;
 namespace gpu {
 namespace gles2 {
 class MailboxManager;
+class MemoryProgramCache;
 class ProgramCache;
 }
 }
@@ -91,13 +93,20 @@ class GpuChannelManager : public IPC::Listener,
 
   GpuChannel* LookupChannel(int32 client_id);
 
+  // Adds the time spent processing the commands of each client process to
+  // |video_memory_usage_stats|.
+  void GetProcessingTimes(
+      content::GPUVideoMemoryUsageStats* video_memory_usage_stats) const;
+
   SyncPointManager* sync_point_manager() { return sync_point_manager_; }
 
   gfx::GLSurface* GetDefaultOffscreenSurface();
 
  private:
   // Message handlers.
-  void OnEstablishChannel(int client_id, bool share_context);
+  void OnEstablishChannel(int client_id,
+                          bool share_context,
+                          bool preempts_other_channels);
   void OnCloseChannel(const IPC::ChannelHandle& channel_handle);
   void OnVisibilityChanged(
       int32 render_view_id, int32 client_id, bool visible);
@@ -107,8 +116,18 @@ class GpuChannelManager : public IPC::Listener,
       int32 client_id,
       const GPUCreateCommandBufferConfig& init_params);
 
+  void OnLoadedProgram(const std::string& program);
+
+  // Sends a program saved to the program cache to the browser, which stores
+  // it in its disk cache.
+  void PersistProgram(const std::string& key, const std::string& program);
+
   void OnLoseAllContexts();
 
+  // Makes the stubs of every channel but the preempting one yield while the
+  // preempting channel has pending messages.
+  void UpdatePreemption();
+
   scoped_refptr<base::MessageLoopProxy> io_message_loop_;
   base::WaitableEvent* shutdown_event_;
 
@@ -120,12 +139,16 @@ class GpuChannelManager : public IPC::Listener,
   // process.
   typedef base::hash_map<int, scoped_refptr<GpuChannel> > GpuChannelMap;
   GpuChannelMap gpu_channels_;
+  // The client whose channel preempts the others, or 0 if there is none.
+  int preempting_client_id_;
   scoped_refptr<gfx::GLShareGroup> share_group_;
   scoped_refptr<gpu::gles2::MailboxManager> mailbox_manager_;
   GpuMemoryManager gpu_memory_manager_;
   GpuWatchdog* watchdog_;
   scoped_refptr<SyncPointManager> sync_point_manager_;
-  scoped_ptr<gpu::gles2::ProgramCache> program_cache_;
+  scoped_ptr<gpu::gles2::MemoryProgramCache> program_cache_;
+  // Programs received from the browser before the program cache was created.
+  std::vector<std::string> loaded_programs_;
   scoped_refptr<gfx::GLSurface> default_offscreen_surface_;
 
   DISALLOW_COPY_AND_ASSIGN(GpuChannelManager);
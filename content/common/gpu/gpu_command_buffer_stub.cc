@@ -679,7 +679,11 @@ void GpuCommandBufferStub::ReportState() {
 
 void GpuCommandBufferStub::PutChanged() {
   FastSetActiveURL(active_url_, active_url_hash_);
+  base::TimeTicks start_time = base::TimeTicks::Now();
   scheduler_->PutChanged();
+  base::TimeDelta processing_time = base::TimeTicks::Now() - start_time;
+  processing_time_ += processing_time;
+  channel_->AddProcessingTime(processing_time);
 }
 
 void GpuCommandBufferStub::OnCreateVideoDecoder(
@@ -12,6 +12,7 @@
 #include "base/id_map.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
+#include "base/time.h"
 #include "content/common/content_export.h"
 #include "content/common/gpu/gpu_memory_allocation.h"
 #include "googleurl/src/gurl.h"
@@ -169,6 +170,9 @@ class GpuCommandBufferStub
 
   void SetPreemptByCounter(scoped_refptr<gpu::RefCountedCounter> counter);
 
+  // The total time spent processing the commands of this context.
+  base::TimeDelta processing_time() const { return processing_time_; }
+
  private:
   bool MakeCurrent();
   void Destroy();
@@ -283,6 +287,8 @@ class GpuCommandBufferStub
 
   scoped_refptr<gpu::RefCountedCounter> preempt_by_counter_;
 
+  base::TimeDelta processing_time_;
+
   GURL active_url_;
   size_t active_url_hash_;
 
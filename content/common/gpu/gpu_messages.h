@@ -167,6 +167,7 @@ IPC_STRUCT_TRAITS_END()
 IPC_STRUCT_TRAITS_BEGIN(content::GPUVideoMemoryUsageStats::ProcessStats)
   IPC_STRUCT_TRAITS_MEMBER(video_memory)
   IPC_STRUCT_TRAITS_MEMBER(has_duplicates)
+  IPC_STRUCT_TRAITS_MEMBER(gpu_time)
 IPC_STRUCT_TRAITS_END()
 
 IPC_STRUCT_TRAITS_BEGIN(content::GPUVideoMemoryUsageStats)
@@ -220,9 +221,13 @@ IPC_MESSAGE_CONTROL0(GpuMsg_Initialize)
 // GpuHostMsg_ChannelEstablished message.  The client ID is passed so that
 // the GPU process reuses an existing channel to that process if it exists.
 // This ID is a unique opaque identifier generated by the browser process.
-IPC_MESSAGE_CONTROL2(GpuMsg_EstablishChannel,
+// The commands of the other channels yield to the messages pending on a
+// channel that preempts them, which the browser requests for the channel of
+// its UI compositor.
+IPC_MESSAGE_CONTROL3(GpuMsg_EstablishChannel,
                      int /* client_id */,
-                     bool /* share_context */)
+                     bool /* share_context */,
+                     bool /* preempts_other_channels */)
 
 // Tells the GPU process to close the channel identified by IPC channel
 // handle.  If no channel can be identified, do nothing.
@@ -244,6 +249,11 @@ IPC_MESSAGE_CONTROL0(GpuMsg_CollectGraphicsInfo)
 // Tells the GPU process to report video_memory information for the task manager
 IPC_MESSAGE_CONTROL0(GpuMsg_GetVideoMemoryUsageStats)
 
+// Gives the GPU process a linked program that it saved in a previous run, as
+// sent in a GpuHostMsg_CacheProgram message.
+IPC_MESSAGE_CONTROL1(GpuMsg_LoadedProgram,
+                     std::string /* program */)
+
 // Tells the GPU process that the browser process has finished resizing the
 // view.
 IPC_MESSAGE_ROUTED0(AcceleratedSurfaceMsg_ResizeViewACK)
@@ -313,6 +323,12 @@ IPC_MESSAGE_CONTROL1(GpuHostMsg_GraphicsInfoCollected,
 IPC_MESSAGE_CONTROL1(GpuHostMsg_VideoMemoryUsageStats,
                      content::GPUVideoMemoryUsageStats /* GPU memory stats */)
 
+// Asks the browser to store a linked program in its disk cache, so that it
+// does not have to be linked again in the next run.
+IPC_MESSAGE_CONTROL2(GpuHostMsg_CacheProgram,
+                     std::string /* key */,
+                     std::string /* program */)
+
 // Message from GPU to add a GPU log message to the about:gpu page.
 IPC_MESSAGE_CONTROL3(GpuHostMsg_OnLogMessage,
                      int /*severity*/,
@@ -36,7 +36,6 @@ class GLSurface;
 
 namespace gpu {
 class GpuScheduler;
-struct RefCountedCounter;
 namespace gles2 {
 class GLES2Decoder;
 }
@@ -119,9 +118,6 @@ class ImageTransportHelper : public IPC::Listener {
 
   void DeferToFence(base::Closure task);
 
-  void SetPreemptByCounter(
-      scoped_refptr<gpu::RefCountedCounter> preempt_by_counter);
-
   // Make the surface's context current.
   bool MakeCurrent();
 
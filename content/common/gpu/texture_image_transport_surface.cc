@@ -7,13 +7,11 @@
 #include <string>
 #include <vector>
 
-#include "base/command_line.h"
 #include "content/common/gpu/gl_scoped_binders.h"
 #include "content/common/gpu/gpu_channel.h"
 #include "content/common/gpu/gpu_channel_manager.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/gpu/sync_point_manager.h"
-#include "content/public/common/content_switches.h"
 #include "gpu/command_buffer/service/context_group.h"
 #include "gpu/command_buffer/service/gpu_scheduler.h"
 #include "gpu/command_buffer/service/texture_manager.h"
@@ -95,10 +93,6 @@ bool TextureImageTransportSurface::Initialize() {
   if (!helper_->Initialize())
     return false;
 
-  const CommandLine* command_line = CommandLine::ForCurrentProcess();
-  if (command_line->HasSwitch(switches::kUIPrioritizeInGpuProcess))
-    helper_->SetPreemptByCounter(parent_channel->MessagesPendingCount());
-
   return true;
 }
 
@@ -215,7 +209,6 @@ void TextureImageTransportSurface::OnWillDestroyStub(
     GpuCommandBufferStub* stub) {
   if (stub == parent_stub_) {
     ReleaseParentStub();
-    helper_->SetPreemptByCounter(NULL);
   } else {
     DCHECK(stub == helper_->stub());
     stub->RemoveDestructionObserver(this);
@@ -17,6 +17,11 @@
 
 IPC_ENUM_TRAITS(content::P2PSocketType)
 
+IPC_STRUCT_TRAITS_BEGIN(content::P2PPacket)
+  IPC_STRUCT_TRAITS_MEMBER(address)
+  IPC_STRUCT_TRAITS_MEMBER(data)
+IPC_STRUCT_TRAITS_END()
+
 IPC_STRUCT_TRAITS_BEGIN(net::NetworkInterface)
   IPC_STRUCT_TRAITS_MEMBER(name)
   IPC_STRUCT_TRAITS_MEMBER(address)
@@ -42,10 +47,10 @@ IPC_MESSAGE_CONTROL2(P2PMsg_OnIncomingTcpConnection,
                      int /* socket_id */,
                      net::IPEndPoint /* socket_address */)
 
-IPC_MESSAGE_CONTROL3(P2PMsg_OnDataReceived,
+// Carries all the packets received on the socket since the last message.
+IPC_MESSAGE_CONTROL2(P2PMsg_OnDataReceived,
                      int /* socket_id */,
-                     net::IPEndPoint /* socket_address */,
-                     std::vector<char> /* data */)
+                     std::vector<content::P2PPacket> /* packets */)
 
 // P2P Socket messages sent from the renderer to the browser.
 
@@ -69,11 +74,11 @@ IPC_MESSAGE_CONTROL3(P2PHostMsg_AcceptIncomingTcpConnection,
                     net::IPEndPoint /* remote_address */,
                     int /* connected_socket_id */)
 
+// Carries all the packets sent on the socket since the last message.
 // TODO(sergeyu): Use shared memory to pass the data.
-IPC_MESSAGE_CONTROL3(P2PHostMsg_Send,
+IPC_MESSAGE_CONTROL2(P2PHostMsg_Send,
                      int /* socket_id */,
-                     net::IPEndPoint /* socket_address */,
-                     std::vector<char> /* data */)
+                     std::vector<content::P2PPacket> /* packets */)
 
 IPC_MESSAGE_CONTROL1(P2PHostMsg_DestroySocket,
                      int /* socket_id */)
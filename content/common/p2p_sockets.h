@@ -8,6 +8,10 @@
 #ifndef CONTENT_COMMON_P2P_SOCKETS_H_
 #define CONTENT_COMMON_P2P_SOCKETS_H_
 
+#include <vector>
+
+#include "net/base/ip_endpoint.h"
+
 namespace content {
 
 // Type of P2P Socket.
@@ -17,6 +21,14 @@ enum P2PSocketType {
   P2P_SOCKET_TCP_CLIENT,
 };
 
+// A packet sent or received on a P2P socket. Packets are passed over IPC in
+// batches, in the order they were sent or received. |address| is the
+// recipient of a sent packet and the sender of a received one.
+struct P2PPacket {
+  net::IPEndPoint address;
+  std::vector<char> data;
+};
+
 }  // namespace content
 
 #endif  // CONTENT_COMMON_P2P_SOCKETS_H_
@@ -213,9 +213,11 @@ void GpuChildThread::OnCollectGraphicsInfo() {
 
 void GpuChildThread::OnGetVideoMemoryUsageStats() {
   content::GPUVideoMemoryUsageStats video_memory_usage_stats;
-  if (gpu_channel_manager_.get())
+  if (gpu_channel_manager_.get()) {
     gpu_channel_manager_->gpu_memory_manager()->GetVideoMemoryUsageStats(
         video_memory_usage_stats);
+    gpu_channel_manager_->GetProcessingTimes(&video_memory_usage_stats);
+  }
   Send(new GpuHostMsg_VideoMemoryUsageStats(video_memory_usage_stats));
 }
 
@@ -232,6 +232,10 @@ std::string ContentBrowserClient::GetDefaultDownloadName() {
   return std::string();
 }
 
+FilePath ContentBrowserClient::GetShaderDiskCacheDirectory() {
+  return FilePath();
+}
+
 bool ContentBrowserClient::AllowPepperSocketAPI(
     BrowserContext* browser_context, const GURL& url) {
   return false;
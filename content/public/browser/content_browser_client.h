@@ -436,6 +436,11 @@ class CONTENT_EXPORT ContentBrowserClient {
   // else we should do with the file.
   virtual std::string GetDefaultDownloadName();
 
+  // Returns the directory where the programs linked by the GPU process are
+  // stored across restarts, or an empty path to not store them.
+  // This is called on the IO thread.
+  virtual FilePath GetShaderDiskCacheDirectory();
+
   // Notifification that a pepper plugin has just been spawned. This allows the
   // embedder to add filters onto the host to implement interfaces.
   // This is called on the IO thread.
@@ -107,6 +107,10 @@ class CONTENT_EXPORT RenderWidgetHost : public IPC::Sender {
   // Free all backing stores used for rendering to drop memory usage.
   static void RemoveAllBackingStores();
 
+  // Free the backing stores of all but the most recently used tab, keeping
+  // compressed copies of them where supported. Called on memory pressure.
+  static void ReduceBackingStoreMemory();
+
   // Returns the size of all the backing stores used for rendering
   static size_t BackingStoreMemorySize();
 
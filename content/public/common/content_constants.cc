@@ -43,4 +43,7 @@ const char kStage3DFieldTrialName[] = "EnableStage3D";
 const char kStage3DFieldTrialBlacklistedName[] = "blacklisted";
 const char kStage3DFieldTrialEnabledName[] = "enabled";
 
+const char kResourceSchedulerFieldTrialName[] = "ResourceScheduler";
+const char kResourceSchedulerFieldTrialControlName[] = "control";
+
 }  // namespace content
@@ -65,6 +65,11 @@ CONTENT_EXPORT extern const char kStage3DFieldTrialName[];
 CONTENT_EXPORT extern const char kStage3DFieldTrialBlacklistedName[];
 CONTENT_EXPORT extern const char kStage3DFieldTrialEnabledName[];
 
+// The resource scheduler holds back requests unless the browser is in the
+// control group of this field trial.
+CONTENT_EXPORT extern const char kResourceSchedulerFieldTrialName[];
+CONTENT_EXPORT extern const char kResourceSchedulerFieldTrialControlName[];
+
 }  // namespace content
 
 #endif  // CONTENT_PUBLIC_COMMON_CONTENT_CONSTANTS_H_
@@ -535,6 +535,10 @@ const char kRendererCmdPrefix[]             = "renderer-cmd-prefix";
 // Causes the process to run as renderer instead of as browser.
 const char kRendererProcess[]               = "renderer";
 
+// The number of renderer processes the Linux zygote forks ahead of time, so
+// that new tabs do not have to wait for a fork. 0 disables the pool.
+const char kRendererPoolSize[]              = "renderer-pool-size";
+
 // Overrides the default/calculated limit to the number of renderer processes.
 // Very high values for this setting can lead to high memory/resource usage
 // or instability.
@@ -168,6 +168,7 @@ CONTENT_EXPORT extern const char kRemoteDebuggingPort[];
 CONTENT_EXPORT extern const char kRendererAssertTest[];
 extern const char kRendererCmdPrefix[];
 CONTENT_EXPORT extern const char kRendererProcess[];
+extern const char kRendererPoolSize[];
 extern const char kRendererProcessLimit[];
 extern const char kRendererStartupDialog[];
 // TODO(jam): this doesn't belong in content.
@@ -12,6 +12,7 @@
 
 #include "base/basictypes.h"
 #include "base/process.h"
+#include "base/time.h"
 #include "content/common/content_export.h"
 
 namespace content {
@@ -31,6 +32,10 @@ struct CONTENT_EXPORT GPUVideoMemoryUsageStats {
     // it is counting other processes' resources (e.g, the GPU process has
     // duplicate set to true because it is the aggregate of all processes)
     bool has_duplicates;
+
+    // The time the GPU process spent processing the commands of this
+    // process' contexts. The GPU process counts the time of all processes.
+    base::TimeDelta gpu_time;
   };
   typedef std::map<base::ProcessId, ProcessStats> ProcessMap;
 
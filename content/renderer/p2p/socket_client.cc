@@ -58,9 +58,29 @@ void P2PSocketClient::Send(const net::IPEndPoint& address,
 
   // Can send data only when the socket is open.
   DCHECK(state_ == STATE_OPEN || state_ == STATE_ERROR);
-  if (state_ == STATE_OPEN) {
-    dispatcher_->SendP2PMessage(new P2PHostMsg_Send(socket_id_, address, data));
+  if (state_ != STATE_OPEN)
+    return;
+
+  // The packets of the Send() calls already queued on the IPC thread behind
+  // this one are batched with it.
+  if (pending_packets_.empty()) {
+    ipc_message_loop_->PostTask(
+        FROM_HERE, base::Bind(&P2PSocketClient::SendPendingPackets, this));
   }
+  pending_packets_.push_back(P2PPacket());
+  pending_packets_.back().address = address;
+  pending_packets_.back().data = data;
+}
+
+void P2PSocketClient::SendPendingPackets() {
+  DCHECK(ipc_message_loop_->BelongsToCurrentThread());
+  if (pending_packets_.empty())
+    return;
+  if (state_ == STATE_OPEN && dispatcher_) {
+    dispatcher_->SendP2PMessage(
+        new P2PHostMsg_Send(socket_id_, pending_packets_));
+  }
+  pending_packets_.clear();
 }
 
 void P2PSocketClient::Close() {
@@ -74,6 +94,8 @@ void P2PSocketClient::Close() {
 
 void P2PSocketClient::DoClose() {
   DCHECK(ipc_message_loop_->BelongsToCurrentThread());
+  // Packets sent before the socket was closed still go out.
+  SendPendingPackets();
   if (dispatcher_) {
     if (state_ == STATE_OPEN || state_ == STATE_OPENING ||
         state_ == STATE_ERROR) {
@@ -144,20 +166,21 @@ void P2PSocketClient::DeliverOnError() {
     delegate_->OnError();
 }
 
-void P2PSocketClient::OnDataReceived(const net::IPEndPoint& address,
-                                     const std::vector<char>& data) {
+void P2PSocketClient::OnDataReceived(const std::vector<P2PPacket>& packets) {
   DCHECK(ipc_message_loop_->BelongsToCurrentThread());
   DCHECK_EQ(STATE_OPEN, state_);
   delegate_message_loop_->PostTask(
       FROM_HERE,
-      base::Bind(&P2PSocketClient::DeliverOnDataReceived, this, address, data));
+      base::Bind(&P2PSocketClient::DeliverOnDataReceived, this, packets));
 }
 
-void P2PSocketClient::DeliverOnDataReceived(const net::IPEndPoint& address,
-                                            const std::vector<char>& data) {
+void P2PSocketClient::DeliverOnDataReceived(
+    const std::vector<P2PPacket>& packets) {
   DCHECK(delegate_message_loop_->BelongsToCurrentThread());
-  if (delegate_)
-    delegate_->OnDataReceived(address, data);
+  // The delegate may close the socket from a callback, which resets
+  // |delegate_|.
+  for (size_t i = 0; i < packets.size() && delegate_; ++i)
+    delegate_->OnDataReceived(packets[i].address, packets[i].data);
 }
 
 void P2PSocketClient::Detach() {
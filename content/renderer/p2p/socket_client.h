@@ -50,7 +50,8 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
             const net::IPEndPoint& remote_address,
             Delegate* delegate);
 
-  // Send the |data| to the |address|.
+  // Send the |data| to the |address|. Packets sent in quick succession are
+  // passed to the browser in one IPC message.
   void Send(const net::IPEndPoint& address, const std::vector<char>& data);
 
   // Must be called before the socket is destroyed. The delegate may
@@ -81,8 +82,7 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   void OnSocketCreated(const net::IPEndPoint& address);
   void OnIncomingTcpConnection(const net::IPEndPoint& address);
   void OnError();
-  void OnDataReceived(const net::IPEndPoint& address,
-                      const std::vector<char>& data);
+  void OnDataReceived(const std::vector<P2PPacket>& packets);
 
   // Proxy methods that deliver messages to the delegate thread.
   void DeliverOnSocketCreated(const net::IPEndPoint& address);
@@ -90,8 +90,7 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
       const net::IPEndPoint& address,
       scoped_refptr<P2PSocketClient> new_client);
   void DeliverOnError();
-  void DeliverOnDataReceived(const net::IPEndPoint& address,
-                             const std::vector<char>& data);
+  void DeliverOnDataReceived(const std::vector<P2PPacket>& packets);
 
   // Scheduled on the IPC thread to finish initialization.
   void DoInit(P2PSocketType type,
@@ -101,6 +100,10 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   // Scheduled on the IPC thread to finish closing the connection.
   void DoClose();
 
+  // Scheduled on the IPC thread by the first Send() of a batch to send all
+  // of |pending_packets_| in one message.
+  void SendPendingPackets();
+
   // Called by the dispatcher when it is destroyed.
   void Detach();
 
@@ -111,6 +114,10 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   Delegate* delegate_;
   State state_;
 
+  // Packets passed to Send() that have not been sent to the browser yet.
+  // Only accessed on the IPC thread.
+  std::vector<P2PPacket> pending_packets_;
+
   DISALLOW_COPY_AND_ASSIGN(P2PSocketClient);
 };
 
@@ -160,11 +160,10 @@ void P2PSocketDispatcher::OnError(int socket_id) {
 }
 
 void P2PSocketDispatcher::OnDataReceived(
-    int socket_id, const net::IPEndPoint& address,
-    const std::vector<char>& data) {
+    int socket_id, const std::vector<P2PPacket>& packets) {
   P2PSocketClient* client = GetClient(socket_id);
   if (client) {
-    client->OnDataReceived(address, data);
+    client->OnDataReceived(packets);
   }
 }
 
@@ -104,8 +104,7 @@ class CONTENT_EXPORT P2PSocketDispatcher
   void OnSocketCreated(int socket_id, const net::IPEndPoint& address);
   void OnIncomingTcpConnection(int socket_id, const net::IPEndPoint& address);
   void OnError(int socket_id);
-  void OnDataReceived(int socket_id, const net::IPEndPoint& address,
-                      const std::vector<char>& data);
+  void OnDataReceived(int socket_id, const std::vector<P2PPacket>& packets);
 
   P2PSocketClient* GetClient(int socket_id);
 
@@ -453,6 +453,7 @@ void RenderWidget::OnUpdateRectAck() {
   // Notify subclasses that software rendering was flushed to the screen.
   if (!is_accelerated_compositing_active_) {
     DidFlushPaint();
+    InputLatencyDidFlushPaint();
   }
 
   // Continue painting if necessary...
@@ -501,6 +502,7 @@ void RenderWidget::OnSwapBuffersComplete() {
 
   // Notify subclasses that composited rendering was flushed to the screen.
   DidFlushPaint();
+  InputLatencyDidFlushPaint();
 
   // When compositing deactivates, we reset the swapbuffers pending count.  The
   // swapbuffers acks may still arrive, however.
@@ -537,8 +539,31 @@ void RenderWidget::OnSwapBuffersComplete() {
   DoDeferredUpdateAndSendInputAck();
 }
 
+void RenderWidget::InputLatencyDidInitiatePaint() {
+  if (input_awaiting_paint_time_.is_null())
+    return;
+  TRACE_EVENT_ASYNC_STEP0("renderer", "InputLatency", this, "PaintInitiated");
+  // Events handled while an earlier paint is in flight are timed from the
+  // oldest one, as the screen shows none of them until that paint is flushed.
+  if (input_awaiting_flush_time_.is_null())
+    input_awaiting_flush_time_ = input_awaiting_paint_time_;
+  input_awaiting_paint_time_ = base::TimeTicks();
+}
+
+void RenderWidget::InputLatencyDidFlushPaint() {
+  if (input_awaiting_flush_time_.is_null())
+    return;
+  base::TimeDelta latency = base::TimeTicks::Now() - input_awaiting_flush_time_;
+  UMA_HISTOGRAM_CUSTOM_TIMES("Renderer4.InputEventToFlushPaint", latency,
+                             base::TimeDelta::FromMilliseconds(1),
+                             base::TimeDelta::FromSeconds(1), 50);
+  input_awaiting_flush_time_ = base::TimeTicks();
+  TRACE_EVENT_ASYNC_END0("renderer", "InputLatency", this);
+}
+
 void RenderWidget::OnHandleInputEvent(const IPC::Message& message) {
   TRACE_EVENT0("renderer", "RenderWidget::OnHandleInputEvent");
+  base::TimeTicks handle_start_time = base::TimeTicks::Now();
   PickleIterator iter(message);
 
   const char* data;
@@ -579,6 +604,13 @@ void RenderWidget::OnHandleInputEvent(const IPC::Message& message) {
   if (!processed && is_keyboard_shortcut)
     suppress_next_char_events_ = true;
 
+  // Time how long it takes for the effect of this event to reach the screen.
+  if (processed && input_awaiting_paint_time_.is_null()) {
+    input_awaiting_paint_time_ = handle_start_time;
+    TRACE_EVENT_ASYNC_BEGIN1("renderer", "InputLatency", this,
+                             "type", input_event->type);
+  }
+
   IPC::Message* response =
       new ViewHostMsg_HandleInputEvent_ACK(routing_id_, input_event->type,
                                            processed);
@@ -1039,8 +1071,10 @@ void RenderWidget::DoDeferredUpdate() {
   }
 
   // If we're software rendering then we're done initiating the paint.
-  if (!is_accelerated_compositing_active_)
+  if (!is_accelerated_compositing_active_) {
     DidInitiatePaint();
+    InputLatencyDidInitiatePaint();
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1189,6 +1223,7 @@ void RenderWidget::didCommitAndDrawCompositorFrame() {
   UNSHIPPED_TRACE_EVENT_INSTANT0("test_fps", "TestFrameTickGPU");
   // Notify subclasses that we initiated the paint operation.
   DidInitiatePaint();
+  InputLatencyDidInitiatePaint();
 }
 
 void RenderWidget::didCompleteSwapBuffers() {
@@ -1196,6 +1231,7 @@ void RenderWidget::didCompleteSwapBuffers() {
 
   // Notify subclasses threaded composited rendering was flushed to the screen.
   DidFlushPaint();
+  InputLatencyDidFlushPaint();
 
   if (update_reply_pending_)
     return;
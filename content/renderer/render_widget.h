@@ -302,6 +302,11 @@ class CONTENT_EXPORT RenderWidget
   virtual void DidInitiatePaint() {}
   virtual void DidFlushPaint() {}
 
+  // Called next to DidInitiatePaint and DidFlushPaint to trace and record the
+  // time from handling an input event to flushing the first paint after it.
+  void InputLatencyDidInitiatePaint();
+  void InputLatencyDidFlushPaint();
+
   // Override and return true when the widget is rendered with a graphics
   // context that supports asynchronous swapbuffers. When returning true, the
   // subclass must call OnSwapBuffersPosted() when swap is posted,
@@ -521,6 +526,12 @@ class CONTENT_EXPORT RenderWidget
   // Are we currently handling an input event?
   bool handling_input_event_;
 
+  // When the oldest input event handled since the last paint was initiated
+  // arrived, and when the oldest input event covered by a paint that has been
+  // initiated but not yet flushed arrived. Null if there is no such event.
+  base::TimeTicks input_awaiting_paint_time_;
+  base::TimeTicks input_awaiting_flush_time_;
+
   // True if we have requested this widget be closed.  No more messages will
   // be sent, except for a Close.
   bool closing_;
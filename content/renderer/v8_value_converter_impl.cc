@@ -19,6 +19,23 @@ using base::ListValue;
 using base::StringValue;
 using base::Value;
 
+namespace {
+
+// Converts |str| to UTF-8, writing straight into the result rather than
+// through the intermediate buffer of v8::String::Utf8Value.
+std::string V8StringToUTF8(v8::Handle<v8::String> str) {
+  int length = str->Utf8Length();
+  std::string result;
+  if (length > 0) {
+    result.resize(length);
+    str->WriteUtf8(&result[0], length, NULL,
+                   v8::String::NO_NULL_TERMINATION);
+  }
+  return result;
+}
+
+}  // namespace
+
 namespace content {
 
 V8ValueConverter* V8ValueConverter::create() {
@@ -115,6 +132,9 @@ v8::Handle<v8::Value> V8ValueConverterImpl::ToV8Array(
     const ListValue* val) const {
   v8::Handle<v8::Array> result(v8::Array::New(val->GetSize()));
 
+  // A single TryCatch is reset after each exception, rather than one being
+  // set up for every element of what can be a large list.
+  v8::TryCatch try_catch;
   for (size_t i = 0; i < val->GetSize(); ++i) {
     const Value* child = NULL;
     CHECK(val->Get(i, &child));
@@ -122,10 +142,11 @@ v8::Handle<v8::Value> V8ValueConverterImpl::ToV8Array(
     v8::Handle<v8::Value> child_v8 = ToV8ValueImpl(child);
     CHECK(!child_v8.IsEmpty());
 
-    v8::TryCatch try_catch;
     result->Set(static_cast<uint32>(i), child_v8);
-    if (try_catch.HasCaught())
+    if (try_catch.HasCaught()) {
       LOG(ERROR) << "Setter for index " << i << " threw an exception.";
+      try_catch.Reset();
+    }
   }
 
   return result;
@@ -135,6 +156,7 @@ v8::Handle<v8::Value> V8ValueConverterImpl::ToV8Object(
     const DictionaryValue* val) const {
   v8::Handle<v8::Object> result(v8::Object::New());
 
+  v8::TryCatch try_catch;
   for (DictionaryValue::key_iterator iter = val->begin_keys();
        iter != val->end_keys(); ++iter) {
     const Value* child = NULL;
@@ -144,11 +166,13 @@ v8::Handle<v8::Value> V8ValueConverterImpl::ToV8Object(
     v8::Handle<v8::Value> child_v8 = ToV8ValueImpl(child);
     CHECK(!child_v8.IsEmpty());
 
-    v8::TryCatch try_catch;
-    result->Set(v8::String::New(key.c_str(), key.length()), child_v8);
+    // Property names are internalized by V8 anyway. Creating them as symbols
+    // up front lets the many objects of a large list share their keys.
+    result->Set(v8::String::NewSymbol(key.c_str(), key.length()), child_v8);
     if (try_catch.HasCaught()) {
       LOG(ERROR) << "Setter for property " << key.c_str() << " threw an "
                  << "exception.";
+      try_catch.Reset();
     }
   }
 
@@ -179,10 +203,8 @@ Value* V8ValueConverterImpl::FromV8ValueImpl(v8::Handle<v8::Value> val,
   if (val->IsNumber())
     return Value::CreateDoubleValue(val->ToNumber()->Value());
 
-  if (val->IsString()) {
-    v8::String::Utf8Value utf8(val->ToString());
-    return Value::CreateStringValue(std::string(*utf8, utf8.length()));
-  }
+  if (val->IsString())
+    return Value::CreateStringValue(V8StringToUTF8(val->ToString()));
 
   if (val->IsUndefined())
     // JSON.stringify ignores undefined.
@@ -245,11 +267,12 @@ Value* V8ValueConverterImpl::FromV8Array(v8::Handle<v8::Array> val,
   if (unique_set)
     unique_set->insert(val->GetIdentityHash());
   // Only fields with integer keys are carried over to the ListValue.
+  v8::TryCatch try_catch;
   for (uint32 i = 0; i < val->Length(); ++i) {
-    v8::TryCatch try_catch;
     v8::Handle<v8::Value> child_v8 = val->Get(i);
     if (try_catch.HasCaught()) {
       LOG(ERROR) << "Getter for index " << i << " threw an exception.";
+      try_catch.Reset();
       child_v8 = v8::Null();
     }
 
@@ -310,6 +333,7 @@ Value* V8ValueConverterImpl::FromV8Object(
   if (unique_set)
     unique_set->insert(val->GetIdentityHash());
 
+  v8::TryCatch try_catch;
   for (uint32 i = 0; i < property_names->Length(); ++i) {
     v8::Handle<v8::Value> key(property_names->Get(i));
 
@@ -325,14 +349,14 @@ Value* V8ValueConverterImpl::FromV8Object(
     if (val->HasRealNamedCallbackProperty(key->ToString()))
       continue;
 
-    v8::String::Utf8Value name_utf8(key->ToString());
+    std::string name_utf8 = V8StringToUTF8(key->ToString());
 
-    v8::TryCatch try_catch;
     v8::Handle<v8::Value> child_v8 = val->Get(key);
 
     if (try_catch.HasCaught()) {
-      LOG(ERROR) << "Getter for property " << *name_utf8
+      LOG(ERROR) << "Getter for property " << name_utf8
                  << " threw an exception.";
+      try_catch.Reset();
       child_v8 = v8::Null();
     }
 
@@ -365,8 +389,7 @@ Value* V8ValueConverterImpl::FromV8Object(
     if (strip_null_from_objects_ && child->IsType(Value::TYPE_NULL))
       continue;
 
-    result->SetWithoutPathExpansion(std::string(*name_utf8, name_utf8.length()),
-                                    child.release());
+    result->SetWithoutPathExpansion(name_utf8, child.release());
   }
 
   return result.release();
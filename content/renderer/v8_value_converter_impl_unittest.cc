@@ -547,3 +547,29 @@ TEST_F(V8ValueConverterImplTest, UndefinedValueBehavior) {
   scoped_ptr<Value> actual_array(converter.FromV8Value(array, context_));
   EXPECT_TRUE(Value::Equals(&expected_array, actual_array.get()));
 }
+
+TEST_F(V8ValueConverterImplTest, LargeListRoundTrip) {
+  // Multi-byte characters and embedded NULs must survive the UTF-8 copies.
+  const std::string kTitle("caf\xC3\xA9 \xE2\x82\xAC\0end", 13);
+
+  ListValue original;
+  for (int i = 0; i < 1000; ++i) {
+    DictionaryValue* entry = new DictionaryValue();
+    entry->SetInteger("id", i);
+    entry->SetString("title", kTitle);
+    entry->SetString("url", "http://www.example.com/");
+    original.Append(entry);
+  }
+
+  v8::Context::Scope context_scope(context_);
+  v8::HandleScope handle_scope;
+
+  V8ValueConverterImpl converter;
+  v8::Handle<v8::Array> v8_array =
+      converter.ToV8Value(&original, context_).As<v8::Array>();
+  ASSERT_FALSE(v8_array.IsEmpty());
+  EXPECT_EQ(original.GetSize(), v8_array->Length());
+
+  scoped_ptr<Value> copy(converter.FromV8Value(v8_array, context_));
+  EXPECT_TRUE(original.Equals(copy.get()));
+}
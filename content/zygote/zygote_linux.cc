@@ -7,6 +7,7 @@
 #include <fcntl.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/sysinfo.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
@@ -24,10 +25,12 @@
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/posix/unix_domain_socket.h"
+#include "base/string_number_conversions.h"
 #include "content/common/set_process_title.h"
 #include "content/common/sandbox_linux.h"
 #include "content/common/zygote_commands_linux.h"
 #include "content/public/common/content_descriptors.h"
+#include "content/public/common/content_switches.h"
 #include "content/public/common/zygote_fork_delegate_linux.h"
 
 #if defined(CHROMIUM_SELINUX)
@@ -41,6 +44,17 @@ namespace content {
 
 namespace {
 
+// The number of renderers kept in the pool, unless overridden with
+// --renderer-pool-size.
+const size_t kDefaultRendererPoolSize = 1;
+
+// Pooled renderers are only forked while the system has at least this much
+// free memory, counting buffers.
+const uint64 kMinFreeMemoryForPooledRenderer = 256 * 1024 * 1024;
+
+// The largest fork request we accept, from the browser or the zygote.
+const unsigned kMaxMessageLength = 2048;
+
 // NOP function. See below where this handler is installed.
 void SIGCHLDHandler(int signal) {
 }
@@ -69,7 +83,8 @@ void SELinuxTransitionToTypeOrDie(const char* type) {
 
 Zygote::Zygote(int sandbox_flags,
                ZygoteForkDelegate* helper)
-    : sandbox_flags_(sandbox_flags),
+    : renderer_pool_size_(kDefaultRendererPoolSize),
+      sandbox_flags_(sandbox_flags),
       helper_(helper),
       initial_uma_sample_(0),
       initial_uma_boundary_value_(0) {
@@ -78,6 +93,15 @@ Zygote::Zygote(int sandbox_flags,
                         &initial_uma_sample_,
                         &initial_uma_boundary_value_);
   }
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch(switches::kRendererPoolSize)) {
+    unsigned pool_size;
+    if (base::StringToUint(
+            command_line.GetSwitchValueASCII(switches::kRendererPoolSize),
+            &pool_size)) {
+      renderer_pool_size_ = pool_size;
+    }
+  }
 }
 
 Zygote::~Zygote() {
@@ -115,6 +139,10 @@ bool Zygote::ProcessRequests() {
 #endif
   }
 
+  // This function call can return multiple times, once per fork().
+  if (FillRendererPool())
+    return true;
+
   for (;;) {
     // This function call can return multiple times, once per fork().
     if (HandleRequestFromBrowser(kBrowserDescriptor))
@@ -128,7 +156,6 @@ bool Zygote::UsingSUIDSandbox() const {
 
 bool Zygote::HandleRequestFromBrowser(int fd) {
   std::vector<int> fds;
-  static const unsigned kMaxMessageLength = 2048;
   char buf[kMaxMessageLength];
   const ssize_t len = UnixDomainSocket::RecvMsg(fd, buf, sizeof(buf), &fds);
 
@@ -369,81 +396,105 @@ int Zygote::ForkWithRealPid(const std::string& process_type,
   return -1;
 }
 
-base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
-                                        PickleIterator iter,
-                                        std::vector<int>& fds,
-                                        std::string* uma_name,
-                                        int* uma_sample,
-                                        int* uma_boundary_value) {
-  std::vector<std::string> args;
+bool Zygote::ReadArgs(const Pickle& pickle,
+                      PickleIterator iter,
+                      const std::vector<int>& fds,
+                      std::string* process_type,
+                      std::vector<std::string>* args,
+                      std::string* channel_id,
+                      base::GlobalDescriptors::Mapping* mapping) {
   int argc = 0;
   int numfds = 0;
-  base::GlobalDescriptors::Mapping mapping;
-  std::string process_type;
-  std::string channel_id;
   const std::string channel_id_prefix = std::string("--")
       + switches::kProcessChannelID + std::string("=");
 
-  if (!pickle.ReadString(&iter, &process_type))
-    return -1;
+  if (!pickle.ReadString(&iter, process_type))
+    return false;
   if (!pickle.ReadInt(&iter, &argc))
-    return -1;
+    return false;
 
   for (int i = 0; i < argc; ++i) {
     std::string arg;
     if (!pickle.ReadString(&iter, &arg))
-      return -1;
-    args.push_back(arg);
+      return false;
+    args->push_back(arg);
     if (arg.compare(0, channel_id_prefix.length(), channel_id_prefix) == 0)
-      channel_id = arg;
+      *channel_id = arg;
   }
 
   if (!pickle.ReadInt(&iter, &numfds))
-    return -1;
+    return false;
   if (numfds != static_cast<int>(fds.size()))
-    return -1;
+    return false;
 
   for (int i = 0; i < numfds; ++i) {
     base::GlobalDescriptors::Key key;
     if (!pickle.ReadUInt32(&iter, &key))
-      return -1;
-    mapping.push_back(std::make_pair(key, fds[i]));
+      return false;
+    mapping->push_back(std::make_pair(key, fds[i]));
   }
 
-  mapping.push_back(std::make_pair(
+  mapping->push_back(std::make_pair(
       static_cast<uint32_t>(kSandboxIPCChannel), kMagicSandboxIPCDescriptor));
+  return true;
+}
 
-  // Returns twice, once per process.
-  base::ProcessId child_pid = ForkWithRealPid(process_type, fds, channel_id,
-                                              uma_name, uma_sample,
-                                              uma_boundary_value);
-  if (!child_pid) {
-    // This is the child process.
-
-    // At this point, we finally know our process type.
-    LinuxSandbox::GetInstance()->PreinitializeSandboxFinish(process_type);
+void Zygote::SetUpChild(const std::string& process_type,
+                        const std::vector<std::string>& args,
+                        const base::GlobalDescriptors::Mapping& mapping) {
+  // At this point, we finally know our process type.
+  LinuxSandbox::GetInstance()->PreinitializeSandboxFinish(process_type);
 
-    close(kBrowserDescriptor);  // Our socket from the browser.
-    if (UsingSUIDSandbox())
-      close(kZygoteIdFd);  // Another socket from the browser.
-    base::GlobalDescriptors::GetInstance()->Reset(mapping);
+  close(kBrowserDescriptor);  // Our socket from the browser.
+  if (UsingSUIDSandbox())
+    close(kZygoteIdFd);  // Another socket from the browser.
+  // The sockets to the pooled renderers belong to the zygote.
+  for (size_t i = 0; i < renderer_pool_.size(); ++i)
+    close(renderer_pool_[i].fd);
+  renderer_pool_.clear();
+  base::GlobalDescriptors::GetInstance()->Reset(mapping);
 
 #if defined(CHROMIUM_SELINUX)
-    SELinuxTransitionToTypeOrDie("chromium_renderer_t");
+  SELinuxTransitionToTypeOrDie("chromium_renderer_t");
 #endif
 
-    // Reset the process-wide command line to our new command line.
-    CommandLine::Reset();
-    CommandLine::Init(0, NULL);
-    CommandLine::ForCurrentProcess()->InitFromArgv(args);
+  // Reset the process-wide command line to our new command line.
+  CommandLine::Reset();
+  CommandLine::Init(0, NULL);
+  CommandLine::ForCurrentProcess()->InitFromArgv(args);
+
+  // Update the process title. The argv was already cached by the call to
+  // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
+  // (we don't have the original argv at this point).
+  SetProcessTitleFromCommandLine(NULL);
+}
+
+base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
+                                        PickleIterator iter,
+                                        std::vector<int>& fds,
+                                        std::string* uma_name,
+                                        int* uma_sample,
+                                        int* uma_boundary_value) {
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string process_type;
+  std::string channel_id;
+
+  if (!ReadArgs(pickle, iter, fds, &process_type, &args, &channel_id,
+                &mapping)) {
+    return -1;
+  }
 
-    // Update the process title. The argv was already cached by the call to
-    // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
-    // (we don't have the original argv at this point).
-    SetProcessTitleFromCommandLine(NULL);
+  // Returns twice, once per process.
+  base::ProcessId child_pid = ForkWithRealPid(process_type, fds, channel_id,
+                                              uma_name, uma_sample,
+                                              uma_boundary_value);
+  if (!child_pid) {
+    // This is the child process.
+    SetUpChild(process_type, args, mapping);
   } else if (child_pid < 0) {
     LOG(ERROR) << "Zygote could not fork: process_type " << process_type
-        << " numfds " << numfds << " child_pid " << child_pid;
+        << " numfds " << fds.size() << " child_pid " << child_pid;
   }
   return child_pid;
 }
@@ -455,11 +506,23 @@ bool Zygote::HandleForkRequest(int fd,
   std::string uma_name;
   int uma_sample;
   int uma_boundary_value;
-  base::ProcessId child_pid = ReadArgsAndFork(pickle, iter, fds,
-                                              &uma_name, &uma_sample,
-                                              &uma_boundary_value);
-  if (child_pid == 0)
-    return true;
+  base::ProcessId child_pid = -1;
+
+  // Renderers are taken from the pool when possible.
+  std::string process_type;
+  PickleIterator type_iter(iter);
+  if (pickle.ReadString(&type_iter, &process_type) &&
+      process_type == switches::kRendererProcess) {
+    child_pid = TakePooledRenderer(static_cast<const char*>(pickle.data()),
+                                   pickle.size(), fds);
+  }
+  if (child_pid < 0) {
+    child_pid = ReadArgsAndFork(pickle, iter, fds,
+                                &uma_name, &uma_sample,
+                                &uma_boundary_value);
+    if (child_pid == 0)
+      return true;
+  }
   for (std::vector<int>::const_iterator
        i = fds.begin(); i != fds.end(); ++i)
     close(*i);
@@ -483,7 +546,11 @@ bool Zygote::HandleForkRequest(int fd,
   if (HANDLE_EINTR(write(fd, reply_pickle.data(), reply_pickle.size())) !=
       static_cast<ssize_t> (reply_pickle.size()))
     PLOG(ERROR) << "write";
-  return false;
+
+  // Replace the renderer taken from the pool, now that the browser is not
+  // waiting for us anymore. This function call can return multiple times,
+  // once per fork().
+  return FillRendererPool();
 }
 
 bool Zygote::HandleGetSandboxStatus(int fd,
@@ -497,4 +564,105 @@ bool Zygote::HandleGetSandboxStatus(int fd,
   return false;
 }
 
+bool Zygote::FillRendererPool() {
+  while (renderer_pool_.size() < renderer_pool_size_ &&
+         HasMemoryForPooledRenderer()) {
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) != 0) {
+      PLOG(ERROR) << "socketpair";
+      return false;
+    }
+
+    std::vector<int> fds;
+    std::string uma_name;
+    int uma_sample;
+    int uma_boundary_value;
+    base::ProcessId pid = ForkWithRealPid(switches::kRendererProcess, fds,
+                                          std::string(), &uma_name,
+                                          &uma_sample, &uma_boundary_value);
+    if (pid == 0) {
+      // In the pooled renderer. Only keep our own end of the socket pair.
+      close(sockets[0]);
+      for (size_t i = 0; i < renderer_pool_.size(); ++i)
+        close(renderer_pool_[i].fd);
+      renderer_pool_.clear();
+      WaitForPooledRendererRequest(sockets[1]);
+      return true;
+    }
+
+    close(sockets[1]);
+    if (pid < 0) {
+      close(sockets[0]);
+      return false;
+    }
+    PooledRenderer renderer;
+    renderer.pid = pid;
+    renderer.fd = sockets[0];
+    renderer_pool_.push_back(renderer);
+  }
+  return false;
+}
+
+bool Zygote::HasMemoryForPooledRenderer() const {
+  // /proc/meminfo is not available in the sandbox, but sysinfo() is.
+  struct sysinfo info;
+  if (sysinfo(&info) != 0)
+    return false;
+  uint64 free_memory =
+      (static_cast<uint64>(info.freeram) + info.bufferram) * info.mem_unit;
+  return free_memory >= kMinFreeMemoryForPooledRenderer;
+}
+
+base::ProcessId Zygote::TakePooledRenderer(const char* buf,
+                                           size_t len,
+                                           const std::vector<int>& fds) {
+  while (!renderer_pool_.empty()) {
+    PooledRenderer renderer = renderer_pool_.back();
+    renderer_pool_.pop_back();
+    bool sent = UnixDomainSocket::SendMsg(renderer.fd, buf, len, fds);
+    close(renderer.fd);
+    if (sent)
+      return renderer.pid;
+
+    // The renderer died while waiting, e.g. because it was killed when memory
+    // ran out. Reap it and try the next one.
+    LOG(WARNING) << "Pooled renderer " << renderer.pid << " went away";
+    base::ProcessId child = renderer.pid;
+    if (UsingSUIDSandbox()) {
+      child = real_pids_to_sandbox_pids[renderer.pid];
+      real_pids_to_sandbox_pids.erase(renderer.pid);
+    }
+    if (child)
+      base::EnsureProcessTerminated(child);
+  }
+  return -1;
+}
+
+void Zygote::WaitForPooledRendererRequest(int fd) {
+  std::vector<int> fds;
+  char buf[kMaxMessageLength];
+  const ssize_t len = UnixDomainSocket::RecvMsg(fd, buf, sizeof(buf), &fds);
+  close(fd);
+  if (len <= 0) {
+    // The zygote went away before it needed us.
+    _exit(0);
+  }
+
+  Pickle pickle(buf, len);
+  PickleIterator iter(pickle);
+  int kind;
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string process_type;
+  std::string channel_id;
+  if (!pickle.ReadInt(&iter, &kind) || kind != kZygoteCommandFork ||
+      !ReadArgs(pickle, iter, fds, &process_type, &args, &channel_id,
+                &mapping) ||
+      process_type != switches::kRendererProcess) {
+    LOG(ERROR) << "Pooled renderer got an invalid fork request";
+    _exit(1);
+  }
+  SetUpChild(process_type, args, mapping);
+}
+
 }  // namespace content
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "base/global_descriptors_posix.h"
 #include "base/hash_tables.h"
 #include "base/process.h"
 
@@ -61,6 +62,22 @@ class Zygote {
                       int* uma_sample,
                       int* uma_boundary_value);
 
+  // Unpacks the process type, arguments and file descriptor mapping of a fork
+  // request from |pickle|. |fds| are the descriptors sent with the request.
+  bool ReadArgs(const Pickle& pickle,
+                PickleIterator iter,
+                const std::vector<int>& fds,
+                std::string* process_type,
+                std::vector<std::string>* args,
+                std::string* channel_id,
+                base::GlobalDescriptors::Mapping* mapping);
+
+  // Called in a new child process once its arguments are known, to turn it
+  // into a process of |process_type|.
+  void SetUpChild(const std::string& process_type,
+                  const std::vector<std::string>& args,
+                  const base::GlobalDescriptors::Mapping& mapping);
+
   // Unpacks process type and arguments from |pickle| and forks a new process.
   // Returns -1 on error, otherwise returns twice, returning 0 to the child
   // process and the child process ID to the parent process, like fork().
@@ -84,12 +101,43 @@ class Zygote {
                               const Pickle& pickle,
                               PickleIterator iter);
 
+  // ---------------------------------------------------------------------------
+  // Renderer pool...
+
+  // Forks renderers until the pool is full, unless memory is getting short.
+  // Returns true if we are in a new process, which has been handed a fork
+  // request and thus needs to unwind back into ChromeMain.
+  bool FillRendererPool();
+
+  // Returns true if there is enough free memory to keep another idle renderer
+  // around.
+  bool HasMemoryForPooledRenderer() const;
+
+  // Hands the fork request in |buf| to a pooled renderer. Returns its PID, or
+  // -1 if the pool is empty or the renderer could not take the request.
+  base::ProcessId TakePooledRenderer(const char* buf,
+                                     size_t len,
+                                     const std::vector<int>& fds);
+
+  // Run by a pooled renderer: waits for the fork request from the zygote and
+  // sets the process up accordingly. Exits if the zygote goes away.
+  void WaitForPooledRendererRequest(int fd);
+
   // In the SUID sandbox, we try to use a new PID namespace. Thus the PIDs
   // fork() returns are not the real PIDs, so we need to map the Real PIDS
   // into the sandbox PID namespace.
   typedef base::hash_map<base::ProcessHandle, base::ProcessHandle> ProcessMap;
   ProcessMap real_pids_to_sandbox_pids;
 
+  // A renderer forked ahead of time, waiting for its arguments on |fd|.
+  struct PooledRenderer {
+    base::ProcessId pid;
+    int fd;
+  };
+  std::vector<PooledRenderer> renderer_pool_;
+  // How many renderers to keep in the pool.
+  size_t renderer_pool_size_;
+
   const int sandbox_flags_;
   ZygoteForkDelegate* helper_;
 
@@ -27,6 +27,8 @@ enum OP {
   DEFBYTE,        // DEFBYTE <value> - emit a byte literal.
   REL32,          // REL32 <label> - emit a rel32 encoded reference to 'label'.
   ABS32,          // REL32 <label> - emit am abs32 encoded reference to 'label'.
+  ABS64,          // ABS64 <label> - emit an abs64 encoded reference to 'label'.
+  MAKEPE64RELOCS, // Generates a PE32+ base relocation table.
   LAST_OP
 };
 
@@ -65,6 +67,12 @@ class PeRelocsInstruction : public Instruction {
   PeRelocsInstruction() : Instruction(MAKEPERELOCS) {}
 };
 
+// Emits an entire PE32+ base relocation table.
+class Pe64RelocsInstruction : public Instruction {
+ public:
+  Pe64RelocsInstruction() : Instruction(MAKEPE64RELOCS) {}
+};
+
 // Emits an ELF relocation table.
 class ElfRelocsInstruction : public Instruction {
  public:
@@ -119,6 +127,10 @@ CheckBool AssemblyProgram::EmitPeRelocsInstruction() {
   return Emit(new(std::nothrow) PeRelocsInstruction());
 }
 
+CheckBool AssemblyProgram::EmitPe64RelocsInstruction() {
+  return Emit(new(std::nothrow) Pe64RelocsInstruction());
+}
+
 CheckBool AssemblyProgram::EmitElfRelocationInstruction() {
   return Emit(new(std::nothrow) ElfRelocsInstruction());
 }
@@ -139,6 +151,10 @@ CheckBool AssemblyProgram::EmitAbs32(Label* label) {
   return Emit(new(std::nothrow) InstructionWithLabel(ABS32, label));
 }
 
+CheckBool AssemblyProgram::EmitAbs64(Label* label) {
+  return Emit(new(std::nothrow) InstructionWithLabel(ABS64, label));
+}
+
 Label* AssemblyProgram::FindOrMakeAbs32Label(RVA rva) {
   return FindLabel(rva, &abs32_labels_);
 }
@@ -164,7 +180,7 @@ void AssemblyProgram::AssignRemainingIndexes() {
 
 Label* AssemblyProgram::InstructionAbs32Label(
     const Instruction* instruction) const {
-  if (instruction->op() == ABS32)
+  if (instruction->op() == ABS32 || instruction->op() == ABS64)
     return static_cast<const InstructionWithLabel*>(instruction)->label();
   return NULL;
 }
@@ -368,11 +384,22 @@ EncodedProgram* AssemblyProgram::Encode() const {
           return NULL;
         break;
       }
+      case ABS64: {
+        Label* label = static_cast<InstructionWithLabel*>(instruction)->label();
+        if (!encoded->AddAbs64(label->index_))
+          return NULL;
+        break;
+      }
       case MAKEPERELOCS: {
         if (!encoded->AddPeMakeRelocs())
           return NULL;
         break;
       }
+      case MAKEPE64RELOCS: {
+        if (!encoded->AddPe64MakeRelocs())
+          return NULL;
+        break;
+      }
       case MAKEELFRELOCS: {
         if (!encoded->AddElfMakeRelocs())
           return NULL;
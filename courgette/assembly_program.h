@@ -71,6 +71,9 @@ class AssemblyProgram {
   // Generates an entire base relocation table.
   CheckBool EmitPeRelocsInstruction() WARN_UNUSED_RESULT;
 
+  // Generates an entire PE32+ base relocation table.
+  CheckBool EmitPe64RelocsInstruction() WARN_UNUSED_RESULT;
+
   // Generates an ELF style relocation table.
   CheckBool EmitElfRelocationInstruction() WARN_UNUSED_RESULT;
 
@@ -86,6 +89,10 @@ class AssemblyProgram {
   // Generates 4-byte absolute reference to address of 'label'.
   CheckBool EmitAbs32(Label* label) WARN_UNUSED_RESULT;
 
+  // Generates 8-byte absolute reference to address of 'label'.  ABS64 labels
+  // share the abs32 label space.
+  CheckBool EmitAbs64(Label* label) WARN_UNUSED_RESULT;
+
   // Looks up a label or creates a new one.  Might return NULL.
   Label* FindOrMakeAbs32Label(RVA rva);
 
@@ -103,8 +110,8 @@ class AssemblyProgram {
     return instructions_;
   }
 
-  // Returns the label if the instruction contains and absolute address,
-  // otherwise returns NULL.
+  // Returns the label if the instruction contains and absolute address (32 or
+  // 64 bit), otherwise returns NULL.
   Label* InstructionAbs32Label(const Instruction* instruction) const;
 
   // Returns the label if the instruction contains and rel32 offset,
@@ -107,6 +107,39 @@ TEST_F(BSDiffMemoryTest, TestNearPageArrayPageSize) {
   GenerateAndTestPatch(file1c, file2);
 }
 
+TEST_F(BSDiffMemoryTest, TestApplyToConcatenation) {
+  std::string old_text = GenerateSyntheticInput(10000, 0);
+  std::string new_text = old_text.substr(5000) +
+                         GenerateSyntheticInput(100, 2) +
+                         old_text.substr(0, 4000);
+
+  courgette::SourceStream old1;
+  courgette::SourceStream new1;
+  old1.Init(old_text.c_str(), old_text.length());
+  new1.Init(new_text.c_str(), new_text.length());
+  courgette::SinkStream patch1;
+  EXPECT_EQ(courgette::OK, CreateBinaryPatch(&old1, &new1, &patch1));
+
+  // Split the old text at the ends, in the middle of a copied range and at
+  // the boundary between two copied ranges.
+  const size_t kSplits[] = { 0, 1, 2500, 5000, 9999, 10000 };
+  for (size_t i = 0; i < arraysize(kSplits); ++i) {
+    courgette::SourceStream old_prefix;
+    courgette::SourceStream old_suffix;
+    courgette::SourceStream patch2;
+    old_prefix.Init(old_text.c_str(), kSplits[i]);
+    old_suffix.Init(old_text.c_str() + kSplits[i],
+                    old_text.length() - kSplits[i]);
+    patch2.Init(patch1);
+
+    courgette::SinkStream new2;
+    EXPECT_EQ(courgette::OK,
+              ApplyBinaryPatch(&old_prefix, &old_suffix, &patch2, &new2));
+    ASSERT_EQ(new_text.length(), new2.Length());
+    EXPECT_EQ(0, memcmp(new_text.c_str(), new2.Buffer(), new_text.length()));
+  }
+}
+
 TEST_F(BSDiffMemoryTest, TestIndenticalDlls) {
   std::string file1 = FileContents("en-US.dll");
   GenerateAndTestPatch(file1, file1);
@@ -0,0 +1,76 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/process_util.h"
+#include "courgette/streams.h"
+#include "courgette/third_party/bsdiff.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Size of the synthetic old and new files, roughly that of a large DLL.
+const size_t kInputSize = 32 * 1024 * 1024;
+
+// Builds a pseudo-random input with the low entropy and long repeats of real
+// executables, which are the slow case for suffix sorting.
+std::string GenerateInput(size_t length, int seed) {
+  static const char* const kPieces[] = {
+    "\x8b\x45\x08", "\xe8\x10\x20", "\x55\x8b\xec", "\x83\xc4\x04",
+    "\xc3", "\x90\x90\x90\x90", "\x5d\xc2\x04", "\xff\x15",
+  };
+  std::string result;
+  result.reserve(length);
+  while (result.length() < length) {
+    seed = (seed + 17) * 1049 + (seed >> 27);
+    result.append(kPieces[seed & 7]);
+    if ((seed & 0x3f0) == 0)
+      result.append(result, result.length() / 2, 4096);
+  }
+  result.resize(length);
+  return result;
+}
+
+size_t GetPeakMemory() {
+#if defined(OS_MACOSX)
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle(), NULL));
+#else
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+#endif
+  return metrics->GetPeakWorkingSetSize();
+}
+
+}  // namespace
+
+// Measures the time and peak memory of generating a patch between two large
+// inputs.  The peak includes the inputs themselves.
+TEST(BSDiffPerfTest, LargeInput) {
+  const std::string old_text = GenerateInput(kInputSize, 0);
+  std::string new_text = old_text;
+  for (size_t i = 0; i < new_text.length(); i += 4099)
+    new_text[i] ^= 0x5a;
+
+  courgette::SourceStream old_stream;
+  courgette::SourceStream new_stream;
+  old_stream.Init(old_text.c_str(), old_text.length());
+  new_stream.Init(new_text.c_str(), new_text.length());
+
+  courgette::SinkStream patch_stream;
+  PerfTimeLogger timer("BSDiff_create_patch");
+  EXPECT_EQ(courgette::OK,
+            CreateBinaryPatch(&old_stream, &new_stream, &patch_stream));
+  timer.Done();
+
+  LogPerfResult("BSDiff_peak_memory",
+                GetPeakMemory() / (1024.0 * 1024.0), "MB");
+  LogPerfResult("BSDiff_patch_size",
+                patch_stream.Length() / 1024.0, "kB");
+}
@@ -24,6 +24,10 @@
       'disassembler.h',
       'disassembler_elf_32_x86.cc',
       'disassembler_elf_32_x86.h',
+      'disassembler_win32.cc',
+      'disassembler_win32.h',
+      'disassembler_win32_x64.cc',
+      'disassembler_win32_x64.h',
       'disassembler_win32_x86.cc',
       'disassembler_win32_x86.h',
       'encoded_program.cc',
@@ -94,6 +98,7 @@
         'base_test_unittest.h',
         'difference_estimator_unittest.cc',
         'disassembler_elf_32_x86_unittest.cc',
+        'disassembler_win32_x64_unittest.cc',
         'disassembler_win32_x86_unittest.cc',
         'encoded_program_unittest.cc',
         'encode_decode_unittest.cc',
@@ -149,6 +154,31 @@
         }],
       ],
     },
+    {
+      'target_name': 'courgette_perftests',
+      'type': 'executable',
+      'sources': [
+        'bsdiff_perftest.cc',
+      ],
+      'dependencies': [
+        'courgette_lib',
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_base',
+        '../base/base.gyp:test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'conditions': [
+        [ 'toolkit_uses_gtk == 1', {
+          'dependencies': [
+            # Workaround for gyp bug 69.
+            # Needed to handle the #include chain:
+            #   base/test_suite.h
+            #   gtk/gtk.h
+            '../build/linux/system.gyp:gtk',
+          ],
+        }],
+      ],
+    },
   ],
   'conditions': [
     ['OS=="win"', {
@@ -56,6 +56,7 @@ enum ExecutableType {
   EXE_UNKNOWN = 0,
   EXE_WIN_32_X86 = 1,
   EXE_ELF_32_X86 = 2,
+  EXE_WIN_32_X64 = 3,
 };
 
 class SinkStream;
@@ -13,6 +13,7 @@
 #include "base/logging.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
+#include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "courgette/third_party/bsdiff.h"
 #include "courgette/courgette.h"
@@ -28,6 +29,8 @@ void PrintHelp() {
     "  courgette -disadj <executable_file> <reference> <binary_assembly_file>\n"
     "  courgette -gen <v1> <v2> <patch>\n"
     "  courgette -apply <v1> <patch> <v2>\n"
+    "\n"
+    "Add --v=1 to -gen to log the time taken by each stage.\n"
     "\n");
 }
 
@@ -135,6 +138,11 @@ bool Supported(const FilePath& input_file) {
       format = "ELF 32 X86";
       result = true;
       break;
+
+    case courgette::EXE_WIN_32_X64:
+      format = "Windows 64 PE";
+      result = true;
+      break;
   }
 
   printf("%s Executable\n", format.c_str());
@@ -309,10 +317,13 @@ void GenerateEnsemblePatch(const FilePath& old_file,
   new_stream.Init(new_buffer);
 
   courgette::SinkStream patch_stream;
+  base::Time start_time = base::Time::Now();
   courgette::Status status =
       courgette::GenerateEnsemblePatch(&old_stream, &new_stream, &patch_stream);
 
   if (status != courgette::C_OK) Problem("-gen failed.");
+  printf("Generated patch in %.2fs\n",
+         (base::Time::Now() - start_time).InSecondsF());
 
   WriteSinkToFile(&patch_stream, patch_file);
 }
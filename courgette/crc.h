@@ -13,5 +13,10 @@ namespace courgette {
 //
 uint32 CalculateCrc(const uint8* buffer, size_t size);
 
+// Calculates Crc of the concatenation of the two given buffers.
+//
+uint32 CalculateCrc(const uint8* buffer1, size_t size1,
+                    const uint8* buffer2, size_t size2);
+
 }  // namespace courgette
 #endif  // COURGETTE_CRC_H_
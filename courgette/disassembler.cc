@@ -14,6 +14,7 @@
 #include "courgette/assembly_program.h"
 #include "courgette/courgette.h"
 #include "courgette/disassembler_elf_32_x86.h"
+#include "courgette/disassembler_win32_x64.h"
 #include "courgette/disassembler_win32_x86.h"
 #include "courgette/encoded_program.h"
 
@@ -34,6 +35,12 @@ Disassembler* DetectDisassembler(const void* buffer, size_t length) {
   else
     delete disassembler;
 
+  disassembler = new DisassemblerWin32X64(buffer, length);
+  if (disassembler->ParseHeader())
+    return disassembler;
+  else
+    delete disassembler;
+
   disassembler = new DisassemblerElf32X86(buffer, length);
   if (disassembler->ParseHeader())
     return disassembler;
@@ -0,0 +1,161 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COURGETTE_DISASSEMBLER_WIN32_H_
+#define COURGETTE_DISASSEMBLER_WIN32_H_
+
+#include "base/basictypes.h"
+#include "courgette/disassembler.h"
+#include "courgette/memory_allocator.h"
+#include "courgette/types_win_pe.h"
+
+namespace courgette {
+
+class AssemblyProgram;
+class Label;
+
+// Disassembles Windows 'Portable Executable' files.  PE32 and PE32+ (64 bit)
+// executables share their layout; subclasses supply the parts that differ,
+// which are the width of absolute addresses and how they are relocated.
+class DisassemblerWin32 : public Disassembler {
+ public:
+  // Returns 'true' if the buffer appears to point to a Windows executable of
+  // the kind accepted by CheckSupportedTarget(), 'false' otherwise.  If
+  // ParseHeader() succeeds, other member functions may be called.
+  virtual bool ParseHeader();
+
+  virtual bool Disassemble(AssemblyProgram* target);
+
+  //
+  // Exposed for test purposes
+  //
+
+  bool has_text_section() const { return has_text_section_; }
+  uint32 size_of_code() const { return size_of_code_; }
+  bool is_32bit() const { return !is_PE32_plus_; }
+  bool is_64bit() const { return is_PE32_plus_; }
+
+  // Returns 'true' if the base relocation table can be parsed.
+  // Output is a vector of the RVAs corresponding to locations within executable
+  // that are listed in the base relocation table.
+  bool ParseRelocs(std::vector<RVA> *addresses);
+
+  // Returns Section containing the relative virtual address, or NULL if none.
+  const Section* RVAToSection(RVA rva) const;
+
+  static const int kNoOffset = -1;
+  // Returns kNoOffset if there is no file offset corresponding to 'rva'.
+  int RVAToFileOffset(RVA rva) const;
+
+  // Returns same as FileOffsetToPointer(RVAToFileOffset(rva)) except that NULL
+  // is returned if there is no file offset corresponding to 'rva'.
+  const uint8* RVAToPointer(RVA rva) const;
+
+  static std::string SectionName(const Section* section);
+
+ protected:
+  DisassemblerWin32(const void* start, size_t length);
+
+  // Called at the end of ParseHeader().  Returns 'true' if the executable is
+  // for the target handled by the subclass, or calls Bad() with the reason.
+  virtual bool CheckSupportedTarget() = 0;
+
+  // The base relocation type of absolute addresses, e.g. 3 for
+  // IMAGE_REL_BASED_HIGHLOW.
+  virtual int RelocType() const = 0;
+
+  // The width of absolute addresses in bytes.
+  virtual int AbsVAWidth() const = 0;
+
+  // Emits an absolute address reference to |label|.
+  virtual CheckBool EmitAbs(Label* label,
+                            AssemblyProgram* program) WARN_UNUSED_RESULT = 0;
+
+  // Emits the instruction that regenerates the base relocation table.
+  virtual CheckBool EmitPeRelocs(AssemblyProgram* program)
+      WARN_UNUSED_RESULT = 0;
+
+  CheckBool ParseFile(AssemblyProgram* target) WARN_UNUSED_RESULT;
+  bool ParseAbs32Relocs();
+  void ParseRel32RelocsFromSections();
+  void ParseRel32RelocsFromSection(const Section* section);
+
+  CheckBool ParseNonSectionFileRegion(uint32 start_file_offset,
+      uint32 end_file_offset, AssemblyProgram* program) WARN_UNUSED_RESULT;
+  CheckBool ParseFileRegion(const Section* section,
+      uint32 start_file_offset, uint32 end_file_offset,
+      AssemblyProgram* program) WARN_UNUSED_RESULT;
+
+  // Most addresses are represented as 32-bit RVAs.  The one address we can't
+  // do this with is the image base address, which is 64 bits wide in PE32+
+  // executables.
+  uint64 image_base() const { return image_base_; }
+
+  uint16 machine_type() const { return machine_type_; }
+
+  const ImageDataDirectory& base_relocation_table() const {
+    return base_relocation_table_;
+  }
+
+  bool IsValidRVA(RVA rva) const { return rva < size_of_image_; }
+
+  // Finds the first section at file_offset or above.  Does not return sections
+  // that have no raw bytes in the file.
+  const Section* FindNextSection(uint32 file_offset) const;
+
+  // There are 2 'coordinate systems' for reasoning about executables.
+  //   FileOffset - the the offset within a single .EXE or .DLL *file*.
+  //   RVA - relative virtual address (offset within *loaded image*)
+  // FileOffsetToRVA and RVAToFileOffset convert between these representations.
+
+  RVA FileOffsetToRVA(uint32 offset) const;
+
+ private:
+  bool ReadDataDirectory(int index, ImageDataDirectory* dir);
+
+  bool incomplete_disassembly_;  // 'true' if can leave out 'uninteresting' bits
+
+  std::vector<RVA> abs32_locations_;
+  std::vector<RVA> rel32_locations_;
+
+  //
+  // Information that is valid after successful ParseHeader.
+  //
+  bool is_PE32_plus_;   // PE32_plus is for 64 bit executables.
+
+  // Location and size of IMAGE_OPTIONAL_HEADER in the buffer.
+  const uint8 *optional_header_;
+  uint16 size_of_optional_header_;
+  uint16 offset_of_data_directories_;
+
+  uint16 machine_type_;
+  uint16 number_of_sections_;
+  const Section *sections_;
+  bool has_text_section_;
+
+  uint32 size_of_code_;
+  uint32 size_of_initialized_data_;
+  uint32 size_of_uninitialized_data_;
+  RVA base_of_code_;
+  RVA base_of_data_;
+
+  uint64 image_base_;  // range limited to 32 bits for 32 bit executable
+  uint32 size_of_image_;
+  int number_of_data_directories_;
+
+  ImageDataDirectory export_table_;
+  ImageDataDirectory import_table_;
+  ImageDataDirectory resource_table_;
+  ImageDataDirectory exception_table_;
+  ImageDataDirectory base_relocation_table_;
+  ImageDataDirectory bound_import_table_;
+  ImageDataDirectory import_address_table_;
+  ImageDataDirectory delay_import_descriptor_;
+  ImageDataDirectory clr_runtime_header_;
+
+  DISALLOW_COPY_AND_ASSIGN(DisassemblerWin32);
+};
+
+}  // namespace courgette
+#endif  // COURGETTE_DISASSEMBLER_WIN32_H_
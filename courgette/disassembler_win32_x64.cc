@@ -0,0 +1,40 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/disassembler_win32_x64.h"
+
+#include "courgette/assembly_program.h"
+
+namespace courgette {
+
+DisassemblerWin32X64::DisassemblerWin32X64(const void* start, size_t length)
+  : DisassemblerWin32(start, length) {
+}
+
+bool DisassemblerWin32X64::CheckSupportedTarget() {
+  if (!is_64bit())
+    return Bad("32 bit executables are handled by DisassemblerWin32X86");
+  if (machine_type() != kImageFileMachineAmd64)
+    return Bad("Only x86-64 is supported for 64 bit executables");
+  return true;
+}
+
+int DisassemblerWin32X64::RelocType() const {
+  return 10;  // IMAGE_REL_BASED_DIR64
+}
+
+int DisassemblerWin32X64::AbsVAWidth() const {
+  return 8;
+}
+
+CheckBool DisassemblerWin32X64::EmitAbs(Label* label,
+                                        AssemblyProgram* program) {
+  return program->EmitAbs64(label);
+}
+
+CheckBool DisassemblerWin32X64::EmitPeRelocs(AssemblyProgram* program) {
+  return program->EmitPe64RelocsInstruction();
+}
+
+}  // namespace courgette
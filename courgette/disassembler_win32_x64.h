@@ -0,0 +1,37 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COURGETTE_DISASSEMBLER_WIN32_X64_H_
+#define COURGETTE_DISASSEMBLER_WIN32_X64_H_
+
+#include "base/basictypes.h"
+#include "courgette/disassembler_win32.h"
+
+namespace courgette {
+
+class AssemblyProgram;
+class Label;
+
+// Disassembles Windows 64 bit (PE32+) x86-64 executables.  Absolute
+// addresses are 8 bytes wide and relocated with IMAGE_REL_BASED_DIR64.
+class DisassemblerWin32X64 : public DisassemblerWin32 {
+ public:
+  explicit DisassemblerWin32X64(const void* start, size_t length);
+
+  virtual ExecutableType kind() { return EXE_WIN_32_X64; }
+
+ protected:
+  virtual bool CheckSupportedTarget();
+  virtual int RelocType() const;
+  virtual int AbsVAWidth() const;
+  virtual CheckBool EmitAbs(Label* label,
+                            AssemblyProgram* program) WARN_UNUSED_RESULT;
+  virtual CheckBool EmitPeRelocs(AssemblyProgram* program) WARN_UNUSED_RESULT;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(DisassemblerWin32X64);
+};
+
+}  // namespace courgette
+#endif  // COURGETTE_DISASSEMBLER_WIN32_X64_H_
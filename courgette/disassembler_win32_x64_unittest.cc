@@ -0,0 +1,196 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/disassembler_win32_x64.h"
+
+#include <string.h>
+
+#include "courgette/assembly_program.h"
+#include "courgette/base_test_unittest.h"
+#include "courgette/disassembler_win32_x86.h"
+#include "courgette/encoded_program.h"
+#include "courgette/streams.h"
+
+namespace {
+
+const uint64 kImageBase = GG_UINT64_C(0x140000000);
+
+void Put16(char* p, uint16 value) { memcpy(p, &value, sizeof(value)); }
+void Put32(char* p, uint32 value) { memcpy(p, &value, sizeof(value)); }
+void Put64(char* p, uint64 value) { memcpy(p, &value, sizeof(value)); }
+
+void PutSection(char* p, const char* name, uint32 rva, uint32 file_offset) {
+  courgette::Section section;
+  memset(&section, 0, sizeof(section));
+  strncpy(section.name, name, sizeof(section.name));
+  section.virtual_size = 0x200;
+  section.virtual_address = rva;
+  section.size_of_raw_data = 0x200;
+  section.file_offset_of_raw_data = file_offset;
+  memcpy(p, &section, sizeof(section));
+}
+
+// Returns a minimal PE32+ x86-64 image.  Its .text section holds an 8-byte
+// absolute reference to RVA 0x1100 at RVA 0x1010 and a call rel32 to RVA
+// 0x1080 at RVA 0x1020.  Its .reloc section holds the IMAGE_REL_BASED_DIR64
+// entry for the absolute reference.
+std::string MakePE32PlusImage() {
+  std::string image(0x600, '\0');
+  char* p = &image[0];
+
+  // DOS header, with the offset of the PE header.
+  p[0] = 'M';
+  p[1] = 'Z';
+  Put32(p + courgette::kOffsetOfFileAddressOfNewExeHeader, 0x40);
+
+  // PE signature and COFF header.
+  memcpy(p + 0x40, "PE\0\0", 4);
+  char* coff_header = p + 0x44;
+  Put16(coff_header, courgette::kImageFileMachineAmd64);
+  Put16(coff_header + 2, 2);      // Number of sections.
+  Put16(coff_header + 16, 0xF0);  // Size of optional header.
+
+  // IMAGE_OPTIONAL_HEADER64.
+  char* optional_header = coff_header + courgette::kSizeOfCoffHeader;
+  Put16(optional_header, courgette::kImageNtOptionalHdr64Magic);
+  Put32(optional_header + 4, 0x200);    // Size of code.
+  Put32(optional_header + 20, 0x1000);  // Base of code.
+  Put64(optional_header + 24, kImageBase);
+  Put32(optional_header + 56, 0x3000);  // Size of image.
+  Put32(optional_header + 108, 16);     // Number of data directories.
+  char* base_relocation_table = optional_header +
+      courgette::kOffsetOfDataDirectoryFromImageOptionalHeader64 + 5 * 8;
+  Put32(base_relocation_table, 0x2000);
+  Put32(base_relocation_table + 4, 12);
+
+  char* sections = optional_header + 0xF0;
+  PutSection(sections, ".text", 0x1000, 0x200);
+  PutSection(sections + sizeof(courgette::Section), ".reloc", 0x2000, 0x400);
+
+  char* text = p + 0x200;
+  Put64(text + 0x10, kImageBase + 0x1100);
+  text[0x20] = '\xE8';  // call rel32
+  Put32(text + 0x21, 0x1080 - 0x1025);
+
+  // One relocation block for the page at RVA 0x1000, padded to 4 bytes.
+  char* relocs = p + 0x400;
+  Put32(relocs, 0x1000);
+  Put32(relocs + 4, 12);
+  Put16(relocs + 8, (10 << 12) | 0x10);  // IMAGE_REL_BASED_DIR64
+  Put16(relocs + 10, 0);                 // IMAGE_REL_BASED_ABSOLUTE
+
+  return image;
+}
+
+}  // namespace
+
+class DisassemblerWin32X64Test : public BaseTest {
+ public:
+
+  void TestExe() const;
+  void TestSyntheticExe() const;
+  void TestExe32() const;
+};
+
+void DisassemblerWin32X64Test::TestExe() const {
+  std::string file1 = FileContents("pe-64.exe");
+
+  scoped_ptr<courgette::DisassemblerWin32X64> disassembler(
+      new courgette::DisassemblerWin32X64(file1.c_str(), file1.length()));
+
+  bool can_parse_header = disassembler->ParseHeader();
+  EXPECT_TRUE(can_parse_header);
+
+  // The executable is the whole file, not 'embedded' with the file
+  EXPECT_EQ(file1.length(), disassembler->length());
+
+  EXPECT_TRUE(disassembler->ok());
+  EXPECT_TRUE(disassembler->has_text_section());
+  EXPECT_EQ(43008U, disassembler->size_of_code());
+  EXPECT_TRUE(disassembler->is_64bit());
+
+  std::vector<courgette::RVA> relocs;
+  bool can_parse_relocs = disassembler->ParseRelocs(&relocs);
+  EXPECT_TRUE(can_parse_relocs);
+
+  const uint8* offset_p = disassembler->OffsetToPointer(0);
+  EXPECT_EQ(reinterpret_cast<const void*>(file1.c_str()),
+            reinterpret_cast<const void*>(offset_p));
+  EXPECT_EQ('M', offset_p[0]);
+  EXPECT_EQ('Z', offset_p[1]);
+}
+
+void DisassemblerWin32X64Test::TestSyntheticExe() const {
+  std::string file1 = MakePE32PlusImage();
+
+  scoped_ptr<courgette::DisassemblerWin32X64> disassembler(
+      new courgette::DisassemblerWin32X64(file1.c_str(), file1.length()));
+
+  EXPECT_TRUE(disassembler->ParseHeader());
+  EXPECT_TRUE(disassembler->ok());
+  EXPECT_TRUE(disassembler->has_text_section());
+  EXPECT_EQ(0x200U, disassembler->size_of_code());
+  EXPECT_TRUE(disassembler->is_64bit());
+  EXPECT_EQ(0x210, disassembler->RVAToFileOffset(0x1010));
+
+  std::vector<courgette::RVA> relocs;
+  ASSERT_TRUE(disassembler->ParseRelocs(&relocs));
+  ASSERT_EQ(1U, relocs.size());
+  EXPECT_EQ(0x1010U, relocs[0]);
+
+  courgette::AssemblyProgram program;
+  ASSERT_TRUE(disassembler->Disassemble(&program));
+
+  // The absolute reference is found through the relocation table and the call
+  // through the rel32 heuristic.
+  std::vector<courgette::RVA> abs_targets;
+  std::vector<courgette::RVA> rel_targets;
+  const courgette::InstructionVector& instructions = program.instructions();
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    courgette::Label* label = program.InstructionAbs32Label(instructions[i]);
+    if (label)
+      abs_targets.push_back(label->rva_);
+    label = program.InstructionRel32Label(instructions[i]);
+    if (label)
+      rel_targets.push_back(label->rva_);
+  }
+  ASSERT_EQ(1U, abs_targets.size());
+  EXPECT_EQ(0x1100U, abs_targets[0]);
+  ASSERT_EQ(1U, rel_targets.size());
+  EXPECT_EQ(0x1080U, rel_targets[0]);
+
+  // Assembling the program reproduces the image, including the regenerated
+  // base relocation table.
+  scoped_ptr<courgette::EncodedProgram> encoded(program.Encode());
+  ASSERT_TRUE(encoded.get() != NULL);
+  courgette::SinkStream assembled;
+  ASSERT_TRUE(encoded->AssembleTo(&assembled));
+  std::string assembled_image(
+      reinterpret_cast<const char*>(assembled.Buffer()), assembled.Length());
+  EXPECT_EQ(file1, assembled_image);
+
+  // A PE32+ image is left to the 64 bit disassembler.
+  courgette::DisassemblerWin32X86 x86_disassembler(file1.c_str(),
+                                                   file1.length());
+  EXPECT_FALSE(x86_disassembler.ParseHeader());
+  EXPECT_TRUE(x86_disassembler.is_64bit());
+}
+
+void DisassemblerWin32X64Test::TestExe32() const {
+  std::string file1 = FileContents("setup1.exe");
+
+  scoped_ptr<courgette::DisassemblerWin32X64> disassembler(
+      new courgette::DisassemblerWin32X64(file1.c_str(), file1.length()));
+
+  bool can_parse_header = disassembler->ParseHeader();
+  EXPECT_FALSE(can_parse_header);
+  EXPECT_FALSE(disassembler->ok());
+  EXPECT_TRUE(disassembler->is_32bit());
+}
+
+TEST_F(DisassemblerWin32X64Test, All) {
+  TestExe();
+  TestSyntheticExe();
+  TestExe32();
+}
@@ -29,6 +29,7 @@ const int kStreamRel32Indexes = 4;
 const int kStreamAbs32Addresses = 5;
 const int kStreamRel32Addresses = 6;
 const int kStreamCopyCounts = 7;
+const int kStreamImageBaseHigh = 8;
 const int kStreamOriginAddresses = kStreamMisc;
 
 const int kStreamLimit = 9;
@@ -238,6 +239,10 @@ CheckBool EncodedProgram::AddAbs32(int label_index) {
   return ops_.push_back(ABS32) && abs32_ix_.push_back(label_index);
 }
 
+CheckBool EncodedProgram::AddAbs64(int label_index) {
+  return ops_.push_back(ABS64) && abs32_ix_.push_back(label_index);
+}
+
 CheckBool EncodedProgram::AddRel32(int label_index) {
   return ops_.push_back(REL32) && rel32_ix_.push_back(label_index);
 }
@@ -246,6 +251,10 @@ CheckBool EncodedProgram::AddPeMakeRelocs() {
   return ops_.push_back(MAKE_PE_RELOCATION_TABLE);
 }
 
+CheckBool EncodedProgram::AddPe64MakeRelocs() {
+  return ops_.push_back(MAKE_PE64_RELOCATION_TABLE);
+}
+
 CheckBool EncodedProgram::AddElfMakeRelocs() {
   return ops_.push_back(MAKE_ELF_RELOCATION_TABLE);
 }
@@ -307,11 +316,18 @@ CheckBool EncodedProgram::WriteTo(SinkStreamSet* streams) {
   // the rest can be interleaved.
 
   if (select & INCLUDE_MISC) {
-    // TODO(sra): write 64 bits.
     if (!streams->stream(kStreamMisc)->WriteVarint32(
             static_cast<uint32>(image_base_))) {
       return false;
     }
+    // The high half of a 64 bit image base goes in a stream of its own, which
+    // is left empty for 32 bit executables so their patches are unchanged.
+    uint32 image_base_high = static_cast<uint32>(image_base_ >> 32);
+    if (image_base_high != 0 &&
+        !streams->stream(kStreamImageBaseHigh)->WriteVarint32(
+            image_base_high)) {
+      return false;
+    }
   }
 
   bool success = true;
@@ -351,12 +367,18 @@ CheckBool EncodedProgram::WriteTo(SinkStreamSet* streams) {
 }
 
 bool EncodedProgram::ReadFrom(SourceStreamSet* streams) {
-  // TODO(sra): read 64 bits.
   uint32 temp;
   if (!streams->stream(kStreamMisc)->ReadVarint32(&temp))
     return false;
   image_base_ = temp;
 
+  SourceStream* image_base_high_stream = streams->stream(kStreamImageBaseHigh);
+  if (image_base_high_stream->Remaining() > 0) {
+    if (!image_base_high_stream->ReadVarint32(&temp))
+      return false;
+    image_base_ |= static_cast<uint64>(temp) << 32;
+  }
+
   if (!ReadU32Delta(&abs32_rva_, streams->stream(kStreamAbs32Addresses)))
     return false;
   if (!ReadU32Delta(&rel32_rva_, streams->stream(kStreamRel32Addresses)))
@@ -405,6 +427,7 @@ CheckBool EncodedProgram::AssembleTo(SinkStream* final_buffer) {
   RVA current_rva = 0;
 
   bool pending_pe_relocation_table = false;
+  uint16 pe_relocation_type = 0;
   bool pending_elf_relocation_table = false;
   SinkStream bytes_following_relocation_table;
 
@@ -484,7 +507,23 @@ CheckBool EncodedProgram::AssembleTo(SinkStream* final_buffer) {
         break;
       }
 
-      case MAKE_PE_RELOCATION_TABLE: {
+      case ABS64: {
+        uint32 index;
+        if (!VectorAt(abs32_ix_, ix_abs32_ix, &index))
+          return false;
+        ++ix_abs32_ix;
+        RVA rva;
+        if (!VectorAt(abs32_rva_, index, &rva))
+          return false;
+        uint64 abs64 = rva + image_base_;
+        if (!abs32_relocs_.push_back(current_rva) || !output->Write(&abs64, 8))
+          return false;
+        current_rva += 8;
+        break;
+      }
+
+      case MAKE_PE_RELOCATION_TABLE:
+      case MAKE_PE64_RELOCATION_TABLE: {
         // We can see the base relocation anywhere, but we only have the
         // information to generate it at the very end.  So we divert the bytes
         // we are generating to a temporary stream.
@@ -493,6 +532,9 @@ CheckBool EncodedProgram::AssembleTo(SinkStream* final_buffer) {
           return false;
 
         pending_pe_relocation_table = true;
+        // IMAGE_REL_BASED_HIGHLOW or IMAGE_REL_BASED_DIR64.
+        pe_relocation_type =
+            (op == MAKE_PE_RELOCATION_TABLE) ? 0x3000 : 0xA000;
         output = &bytes_following_relocation_table;
         break;
         // There is a potential problem *if* the instruction stream contains
@@ -521,7 +563,7 @@ CheckBool EncodedProgram::AssembleTo(SinkStream* final_buffer) {
   }
 
   if (pending_pe_relocation_table) {
-    if (!GeneratePeRelocations(final_buffer) ||
+    if (!GeneratePeRelocations(final_buffer, pe_relocation_type) ||
         !final_buffer->Append(&bytes_following_relocation_table))
       return false;
   }
@@ -582,7 +624,8 @@ class RelocBlock {
   RelocBlockPOD pod;
 };
 
-CheckBool EncodedProgram::GeneratePeRelocations(SinkStream* buffer) {
+CheckBool EncodedProgram::GeneratePeRelocations(SinkStream* buffer,
+                                               uint16 reloc_type) {
   std::sort(abs32_relocs_.begin(), abs32_relocs_.end());
 
   RelocBlock block;
@@ -596,7 +639,7 @@ CheckBool EncodedProgram::GeneratePeRelocations(SinkStream* buffer) {
       block.pod.page_rva = page_rva;
     }
     if (ok)
-      block.Add(0x3000 | (rva & 0xFFF));
+      block.Add(reloc_type | (rva & 0xFFF));
   }
   ok &= block.Flush(buffer);
   return ok;
@@ -43,7 +43,9 @@ class EncodedProgram {
   CheckBool AddCopy(uint32 count, const void* bytes) WARN_UNUSED_RESULT;
   CheckBool AddRel32(int label_index) WARN_UNUSED_RESULT;
   CheckBool AddAbs32(int label_index) WARN_UNUSED_RESULT;
+  CheckBool AddAbs64(int label_index) WARN_UNUSED_RESULT;
   CheckBool AddPeMakeRelocs() WARN_UNUSED_RESULT;
+  CheckBool AddPe64MakeRelocs() WARN_UNUSED_RESULT;
   CheckBool AddElfMakeRelocs() WARN_UNUSED_RESULT;
 
   // (3) Serialize binary assembly language tables to a set of streams.
@@ -71,6 +73,9 @@ class EncodedProgram {
                    // address table offset <index>
     MAKE_PE_RELOCATION_TABLE = 5,  // Emit PE base relocation table blocks.
     MAKE_ELF_RELOCATION_TABLE = 6, // Emit Elf relocation table.
+    ABS64 = 7,     // ABS64 <index> - emit abs64 encoded reference to address at
+                   // address table offset <index>
+    MAKE_PE64_RELOCATION_TABLE = 8,  // Emit PE32+ base relocation table blocks.
   };
 
   typedef NoThrowBuffer<RVA> RvaVector;
@@ -79,7 +84,8 @@ class EncodedProgram {
   typedef NoThrowBuffer<OP> OPVector;
 
   void DebuggingSummary();
-  CheckBool GeneratePeRelocations(SinkStream *buffer) WARN_UNUSED_RESULT;
+  CheckBool GeneratePeRelocations(SinkStream *buffer,
+                                  uint16 reloc_type) WARN_UNUSED_RESULT;
   CheckBool GenerateElfRelocations(SinkStream *buffer) WARN_UNUSED_RESULT;
   CheckBool DefineLabelCommon(RvaVector*, int, RVA) WARN_UNUSED_RESULT;
   void FinishLabelsCommon(RvaVector* addresses);
@@ -93,10 +99,10 @@ class EncodedProgram {
   UInt32Vector copy_counts_;
   UInt8Vector copy_bytes_;
   UInt32Vector rel32_ix_;
-  UInt32Vector abs32_ix_;
+  UInt32Vector abs32_ix_;  // Indexes of both ABS32 and ABS64 references.
 
-  // Table of the addresses containing abs32 relocations; computed during
-  // assembly, used to generate base relocation table.
+  // Table of the addresses containing abs32 and abs64 relocations; computed
+  // during assembly, used to generate base relocation table.
   UInt32Vector abs32_relocs_;
 
   DISALLOW_COPY_AND_ASSIGN(EncodedProgram);
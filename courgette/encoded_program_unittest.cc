@@ -64,3 +64,47 @@ TEST(EncodedProgramTest, Test) {
 
   EXPECT_EQ(0, memcmp(assembled_buffer, golden, 8));
 }
+
+TEST(EncodedProgramTest, Abs64) {
+  // A 64 bit image base must survive serialization, and ABS64 references must
+  // be assembled with their PE32+ base relocations.
+  courgette::EncodedProgram* program = new courgette::EncodedProgram();
+
+  uint64 base = GG_UINT64_C(0x0000000140000000);
+  program->set_image_base(base);
+
+  EXPECT_TRUE(program->DefineAbs32Label(0, 0x10));  // ABS64 index 0
+  program->EndLabels();
+
+  EXPECT_TRUE(program->AddOrigin(0));  // Start at base.
+  EXPECT_TRUE(program->AddAbs64(0));
+  EXPECT_TRUE(program->AddPe64MakeRelocs());
+
+  courgette::SinkStreamSet sinks;
+  EXPECT_TRUE(program->WriteTo(&sinks));
+  delete program;
+
+  courgette::SinkStream sink;
+  EXPECT_TRUE(sinks.CopyTo(&sink));
+
+  courgette::SourceStreamSet sources;
+  EXPECT_TRUE(sources.Init(sink.Buffer(), sink.Length()));
+
+  courgette::EncodedProgram* encoded2 = new courgette::EncodedProgram();
+  EXPECT_TRUE(encoded2->ReadFrom(&sources));
+
+  courgette::SinkStream assembled;
+  EXPECT_TRUE(encoded2->AssembleTo(&assembled));
+  delete encoded2;
+
+  static const uint8 golden[] = {
+    0x10, 0x00, 0x00, 0x40, 0x01, 0x00, 0x00, 0x00,  // ABS64 to base + 0x10
+    0x00, 0x00, 0x00, 0x00,  // Relocation block page RVA 0
+    0x0C, 0x00, 0x00, 0x00,  // of 12 bytes,
+    0x00, 0xA0,              // IMAGE_REL_BASED_DIR64 at RVA 0
+    0x00, 0x00               // and padding.
+  };
+
+  EXPECT_EQ(sizeof(golden), assembled.Length());
+  EXPECT_EQ(0, memcmp(assembled.Buffer(), golden, sizeof(golden)));
+}
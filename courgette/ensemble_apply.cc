@@ -49,7 +49,7 @@ class EnsemblePatchApplication {
   Status TransformDown(SourceStreamSet* transformed_elements,
                        SinkStream* basic_elements);
 
-  Status SubpatchFinalOutput(SourceStream* original,
+  Status SubpatchFinalOutput(SourceStream* basic_elements,
                              SourceStream* correction,
                              SinkStream* corrected_ensemble);
 
@@ -145,6 +145,9 @@ Status EnsemblePatchApplication::ReadInitialParameters(
       case EXE_ELF_32_X86:
         patcher = new PatcherX86_32(base_region_);
         break;
+      case EXE_WIN_32_X64:
+        patcher = new PatcherX86_32(base_region_);
+        break;
     }
 
     if (patcher)
@@ -210,6 +213,10 @@ Status EnsemblePatchApplication::TransformUp(
 
   if (!parameters->Empty())
     return C_STREAM_NOT_CONSUMED;
+  // We have totally consumed parameters, so can free the storage to which it
+  // referred.
+  corrected_parameters_storage_.Retire();
+
   return C_OK;
 }
 
@@ -226,16 +233,17 @@ Status EnsemblePatchApplication::SubpatchTransformedElements(
 Status EnsemblePatchApplication::TransformDown(
     SourceStreamSet* transformed_elements,
     SinkStream* basic_elements) {
-  // Construct blob of original input followed by reformed elements.
+  // Construct blob of reformed elements.  The final patch applies to the
+  // original input followed by this blob, but the original input is not
+  // copied; SubpatchFinalOutput reads it from |base_region_|.
+  if (final_patch_input_size_prediction_ < base_region_.length())
+    return C_BAD_ENSEMBLE_HEADER;
 
-  if (!basic_elements->Reserve(final_patch_input_size_prediction_)) {
+  if (!basic_elements->Reserve(final_patch_input_size_prediction_ -
+                               base_region_.length())) {
     return C_STREAM_ERROR;
   }
 
-  // The original input:
-  if (!basic_elements->Write(base_region_.start(), base_region_.length()))
-    return C_STREAM_ERROR;
-
   for (size_t i = 0;  i < patchers_.size();  ++i) {
     SourceStreamSet single_corrected_element;
     if (!transformed_elements->ReadSet(&single_corrected_element))
@@ -258,10 +266,12 @@ Status EnsemblePatchApplication::TransformDown(
 }
 
 Status EnsemblePatchApplication::SubpatchFinalOutput(
-    SourceStream* original,
+    SourceStream* basic_elements,
     SourceStream* correction,
     SinkStream* corrected_ensemble) {
-  Status delta_status = ApplySimpleDelta(original, correction,
+  SourceStream original;
+  original.Init(base_region_);
+  Status delta_status = ApplySimpleDelta(&original, basic_elements, correction,
                                          corrected_ensemble);
   if (delta_status != C_OK)
     return delta_status;
@@ -355,15 +365,14 @@ Status ApplyEnsemblePatch(SourceStream* base,
   if (status != C_OK)
     return status;
 
-  SinkStream original_ensemble_and_corrected_base_elements;
-  status = patch_process.TransformDown(
-      &corrected_transformed_elements,
-      &original_ensemble_and_corrected_base_elements);
+  SinkStream corrected_base_elements;
+  status = patch_process.TransformDown(&corrected_transformed_elements,
+                                       &corrected_base_elements);
   if (status != C_OK)
     return status;
 
   SourceStream final_patch_prediction;
-  final_patch_prediction.Init(original_ensemble_and_corrected_base_elements);
+  final_patch_prediction.Init(corrected_base_elements);
   status = patch_process.SubpatchFinalOutput(&final_patch_prediction,
                                              ensemble_correction, output);
   if (status != C_OK)
@@ -14,11 +14,15 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
 #include <vector>
 #include <limits>
 
 #include "base/basictypes.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/time.h"
 
 #include "courgette/third_party/bsdiff.h"
@@ -85,6 +89,15 @@ TransformationPatchGenerator* MakeGenerator(Element* old_element,
               EXE_ELF_32_X86);
       return generator;
     }
+    case EXE_WIN_32_X64: {
+      TransformationPatchGenerator* generator =
+          new PatchGeneratorX86_32(
+              old_element,
+              new_element,
+              new PatcherX86_32(old_element->region()),
+              EXE_WIN_32_X64);
+      return generator;
+    }
   }
 
   LOG(WARNING) << "Unexpected Element::Kind " << old_element->kind();
@@ -220,6 +233,66 @@ void FreeGenerators(std::vector<TransformationPatchGenerator*>* generators) {
   generators->clear();
 }
 
+// Transforms one element pair.  The disassembly, adjustment and encoding of
+// each pair is independent of the others, so the pairs are transformed on a
+// pool of threads.  The results are collected in the task and written out in
+// element order afterwards so that the patch does not depend on scheduling.
+class TransformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit TransformTask(TransformationPatchGenerator* generator)
+      : generator_(generator),
+        status_(C_GENERAL_ERROR) {
+  }
+
+  virtual void Run() {
+    base::Time start_time = base::Time::Now();
+    status_ = generator_->Transform(&parameters_,
+                                    &predicted_transformed_element_,
+                                    &corrected_transformed_element_);
+    elapsed_ = base::Time::Now() - start_time;
+  }
+
+  SourceStreamSet* parameters() { return &parameters_; }
+  SinkStreamSet* predicted_transformed_element() {
+    return &predicted_transformed_element_;
+  }
+  SinkStreamSet* corrected_transformed_element() {
+    return &corrected_transformed_element_;
+  }
+  Status status() const { return status_; }
+  base::TimeDelta elapsed() const { return elapsed_; }
+
+ private:
+  TransformationPatchGenerator* generator_;
+  SourceStreamSet parameters_;
+  SinkStreamSet predicted_transformed_element_;
+  SinkStreamSet corrected_transformed_element_;
+  Status status_;
+  base::TimeDelta elapsed_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransformTask);
+};
+
+// Runs |tasks| on up to one thread per processor.
+void RunTransformTasks(const std::vector<TransformTask*>& tasks) {
+  if (tasks.empty())
+    return;
+
+  int num_threads = std::min(base::SysInfo::NumberOfProcessors(),
+                             static_cast<int>(tasks.size()));
+  if (num_threads <= 1) {
+    for (size_t i = 0;  i < tasks.size();  ++i)
+      tasks[i]->Run();
+    return;
+  }
+
+  base::DelegateSimpleThreadPool pool("courgette_transform", num_threads);
+  for (size_t i = 0;  i < tasks.size();  ++i)
+    pool.AddWork(tasks[i]);
+  pool.Start();
+  pool.JoinAll();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Status GenerateEnsemblePatch(SourceStream* base,
@@ -300,11 +373,14 @@ Status GenerateEnsemblePatch(SourceStream* base,
   predicted_parameters_source.Init(linearized_predicted_parameters);
   corrected_parameters_source.Init(linearized_corrected_parameters);
 
+  base::Time start_delta1_time = base::Time::Now();
   Status delta1_status = GenerateSimpleDelta(&predicted_parameters_source,
                                              &corrected_parameters_source,
                                              parameter_correction);
   if (delta1_status != C_OK)
     return delta1_status;
+  VLOG(1) << "done parameter delta "
+          << (base::Time::Now() - start_delta1_time).InSecondsF() << "s";
 
   //
   // Generate sub-patch for elements.
@@ -317,30 +393,39 @@ Status GenerateEnsemblePatch(SourceStream* base,
   SinkStreamSet predicted_transformed_elements;
   SinkStreamSet corrected_transformed_elements;
 
+  ScopedVector<TransformTask> transform_tasks;
   for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_parameters;
-    if (!corrected_parameters_source_set.ReadSet(&single_parameters))
+    TransformTask* task = new TransformTask(generators[i]);
+    transform_tasks.push_back(task);
+    if (!corrected_parameters_source_set.ReadSet(task->parameters()))
       return C_STREAM_ERROR;
-    SinkStreamSet single_predicted_transformed_element;
-    SinkStreamSet single_corrected_transformed_element;
-    Status status = generators[i]->Transform(
-        &single_parameters,
-        &single_predicted_transformed_element,
-        &single_corrected_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
+  }
+
+  if (!corrected_parameters_source_set.Empty())
+    return C_STREAM_NOT_CONSUMED;
+
+  base::Time start_transform_time = base::Time::Now();
+  RunTransformTasks(transform_tasks.get());
+  VLOG(1) << "done Transform "
+          << (base::Time::Now() - start_transform_time).InSecondsF() << "s";
+
+  for (size_t i = 0;  i < number_of_transformations;  ++i) {
+    TransformTask* task = transform_tasks[i];
+    VLOG(1) << "Transform " << i << " in "
+            << task->elapsed().InSecondsF() << "s";
+    if (task->status() != C_OK)
+      return task->status();
+    if (!task->parameters()->Empty())
       return C_STREAM_NOT_CONSUMED;
     if (!predicted_transformed_elements.WriteSet(
-            &single_predicted_transformed_element))
+            task->predicted_transformed_element()))
       return C_STREAM_ERROR;
     if (!corrected_transformed_elements.WriteSet(
-            &single_corrected_transformed_element))
+            task->corrected_transformed_element()))
       return C_STREAM_ERROR;
   }
-
-  if (!corrected_parameters_source_set.Empty())
-    return C_STREAM_NOT_CONSUMED;
+  // Last use, free storage.
+  transform_tasks.clear();
 
   SinkStream linearized_predicted_transformed_elements;
   SinkStream linearized_corrected_transformed_elements;
@@ -359,12 +444,15 @@ Status GenerateEnsemblePatch(SourceStream* base,
   corrected_transformed_elements_source
       .Init(linearized_corrected_transformed_elements);
 
+  base::Time start_delta2_time = base::Time::Now();
   Status delta2_status =
       GenerateSimpleDelta(&predicted_transformed_elements_source,
                           &corrected_transformed_elements_source,
                           transformed_elements_correction);
   if (delta2_status != C_OK)
     return delta2_status;
+  VLOG(1) << "done transformed elements delta "
+          << (base::Time::Now() - start_delta2_time).InSecondsF() << "s";
 
   // Last use, free storage.
   linearized_predicted_transformed_elements.Retire();
@@ -408,11 +496,14 @@ Status GenerateEnsemblePatch(SourceStream* base,
   size_t final_patch_input_size = predicted_ensemble.Length();
   SourceStream predicted_ensemble_source;
   predicted_ensemble_source.Init(predicted_ensemble);
+  base::Time start_delta3_time = base::Time::Now();
   Status delta3_status = GenerateSimpleDelta(&predicted_ensemble_source,
                                              update,
                                              ensemble_correction);
   if (delta3_status != C_OK)
     return delta3_status;
+  VLOG(1) << "done ensemble delta "
+          << (base::Time::Now() - start_delta3_time).InSecondsF() << "s";
 
   //
   // Final output stream has a header followed by a StreamSet.
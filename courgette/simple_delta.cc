@@ -31,6 +31,12 @@ Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
   return BSDiffStatusToStatus(ApplyBinaryPatch(old, delta, target));
 }
 
+Status ApplySimpleDelta(SourceStream* old_prefix, SourceStream* old_suffix,
+                        SourceStream* delta, SinkStream* target) {
+  return BSDiffStatusToStatus(
+      ApplyBinaryPatch(old_prefix, old_suffix, delta, target));
+}
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta) {
   VLOG(1) << "GenerateSimpleDelta " << old->Remaining()
@@ -15,6 +15,11 @@ namespace courgette {
 Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
                         SinkStream* target);
 
+// Like ApplySimpleDelta, where the old data is |old_prefix| followed by
+// |old_suffix|.
+Status ApplySimpleDelta(SourceStream* old_prefix, SourceStream* old_suffix,
+                        SourceStream* delta, SinkStream* target);
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta);
 
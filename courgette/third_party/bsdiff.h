@@ -64,6 +64,15 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
                               SourceStream* patch_stream,
                               SinkStream* new_stream);
 
+// Applies the given patch file to a source file that is the concatenation of
+// |old_prefix_stream| and |old_suffix_stream|.  This avoids copying two large
+// buffers into one just to patch them.
+//
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_prefix_stream,
+                              SourceStream* old_suffix_stream,
+                              SourceStream* patch_stream,
+                              SinkStream* new_stream);
+
 
 // The following declarations are common to the patch-creation and
 // patch-application code.
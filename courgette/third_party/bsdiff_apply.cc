@@ -26,6 +26,8 @@
  * Changelog:
  * 2009-03-31 - Change to use Streams.  Move CRC code to crc.{h,cc}
  *                --Stephen Adams <sra@chromium.org>
+ * 2012-10-15 - Allow the old file to be in two pieces, so that callers need
+ *              not concatenate them.
  */
 
 // Copyright (c) 2009 The Chromium Authors. All rights reserved.
@@ -34,6 +36,8 @@
 
 #include "courgette/third_party/bsdiff.h"
 
+#include <algorithm>
+
 #include "courgette/crc.h"
 #include "courgette/streams.h"
 
@@ -54,11 +58,14 @@ BSDiffStatus MBS_ReadHeader(SourceStream* stream, MBSPatchHeader* header) {
   return OK;
 }
 
+// The old file is the concatenation of [old_prefix, old_prefix + prefix_size)
+// and [old_suffix, old_suffix + suffix_size).
 BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
                             SourceStream* patch_stream,
-                            const uint8* old_start, size_t old_size,
+                            const uint8* old_prefix, size_t prefix_size,
+                            const uint8* old_suffix, size_t suffix_size,
                             SinkStream* new_stream) {
-  const uint8* old_end = old_start + old_size;
+  const size_t old_size = prefix_size + suffix_size;
 
   SourceStreamSet patch_streams;
   if (!patch_streams.Init(patch_stream))
@@ -75,7 +82,7 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
   const uint8* extra_end = extra_start + extra_bytes->Remaining();
   const uint8* extra_position = extra_start;
 
-  const uint8* old_position = old_start;
+  size_t old_position = 0;
 
   if (header->dlen && !new_stream->Reserve(header->dlen))
     return MEM_ERROR;
@@ -100,25 +107,39 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
 #endif
     // Byte-wise arithmetically add bytes from old file to bytes from the diff
     // block.
-    if (copy_count > static_cast<size_t>(old_end - old_position))
+    if (copy_count > old_size - old_position)
       return UNEXPECTED_ERROR;
 
-    // Add together bytes from the 'old' file and the 'diff' stream.
-    for (size_t i = 0;  i < copy_count;  ++i) {
-      uint8 diff_byte = 0;
-      if (pending_diff_zeros) {
-        --pending_diff_zeros;
+    // Add together bytes from the 'old' file and the 'diff' stream, a piece
+    // of the old file at a time.
+    size_t copy_remaining = copy_count;
+    while (copy_remaining > 0) {
+      const uint8* old_piece;
+      size_t piece_count;
+      if (old_position < prefix_size) {
+        old_piece = old_prefix + old_position;
+        piece_count = std::min(copy_remaining, prefix_size - old_position);
       } else {
-        if (!diff_skips->ReadVarint32(&pending_diff_zeros))
-          return UNEXPECTED_ERROR;
-        if (!diff_bytes->Read(&diff_byte, 1))
-          return UNEXPECTED_ERROR;
+        old_piece = old_suffix + (old_position - prefix_size);
+        piece_count = copy_remaining;
+      }
+      for (size_t i = 0;  i < piece_count;  ++i) {
+        uint8 diff_byte = 0;
+        if (pending_diff_zeros) {
+          --pending_diff_zeros;
+        } else {
+          if (!diff_skips->ReadVarint32(&pending_diff_zeros))
+            return UNEXPECTED_ERROR;
+          if (!diff_bytes->Read(&diff_byte, 1))
+            return UNEXPECTED_ERROR;
+        }
+        uint8 byte = old_piece[i] + diff_byte;
+        if (!new_stream->Write(&byte, 1))
+          return MEM_ERROR;
       }
-      uint8 byte = old_position[i] + diff_byte;
-      if (!new_stream->Write(&byte, 1))
-        return MEM_ERROR;
+      old_position += piece_count;
+      copy_remaining -= piece_count;
     }
-    old_position += copy_count;
 
     // Copy bytes from the extra block.
     if (extra_count > static_cast<size_t>(extra_end - extra_position))
@@ -130,11 +151,11 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
     extra_position += extra_count;
 
     // "seek" forwards (or backwards) in oldfile.
-    if (old_position + seek_adjustment < old_start ||
-        old_position + seek_adjustment > old_end)
+    int64 new_position = static_cast<int64>(old_position) + seek_adjustment;
+    if (new_position < 0 || new_position > static_cast<int64>(old_size))
       return UNEXPECTED_ERROR;
 
-    old_position += seek_adjustment;
+    old_position = static_cast<size_t>(new_position);
   }
 
   if (!control_stream_copy_counts->Empty() ||
@@ -163,9 +184,31 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
   if (CalculateCrc(old_start, old_size) != header.scrc32)
     return CRC_ERROR;
 
-  MBS_ApplyPatch(&header, patch_stream, old_start, old_size, new_stream);
+  return MBS_ApplyPatch(&header, patch_stream, old_start, old_size, NULL, 0,
+                        new_stream);
+}
 
-  return OK;
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_prefix_stream,
+                              SourceStream* old_suffix_stream,
+                              SourceStream* patch_stream,
+                              SinkStream* new_stream) {
+  MBSPatchHeader header;
+  BSDiffStatus ret = MBS_ReadHeader(patch_stream, &header);
+  if (ret != OK) return ret;
+
+  const uint8* prefix_start = old_prefix_stream->Buffer();
+  size_t prefix_size = old_prefix_stream->Remaining();
+  const uint8* suffix_start = old_suffix_stream->Buffer();
+  size_t suffix_size = old_suffix_stream->Remaining();
+
+  if (prefix_size + suffix_size != header.slen) return UNEXPECTED_ERROR;
+
+  if (CalculateCrc(prefix_start, prefix_size, suffix_start, suffix_size) !=
+      header.scrc32)
+    return CRC_ERROR;
+
+  return MBS_ApplyPatch(&header, patch_stream, prefix_start, prefix_size,
+                        suffix_start, suffix_size, new_stream);
 }
 
 }  // namespace
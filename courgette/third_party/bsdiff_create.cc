@@ -20,12 +20,15 @@
   2010-05-26 - Use a paged array for V and I. The address space may be too
                fragmented for these big arrays to be contiguous.
                  --Stephen Adams <sra@chromium.org>
+  2012-10-15 - Replace qsufsort with SA-IS, which runs in linear time and
+               does not need V.
 */
 
 #include "courgette/third_party/bsdiff.h"
 
 #include <stdlib.h>
 #include <algorithm>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -40,116 +43,208 @@ namespace courgette {
 
 // ------------------------------------------------------------------------
 //
-// The following code is taken verbatim from 'bsdiff.c'. Please keep all the
-// code formatting and variable names.  The changes from the original are (1)
-// replacing tabs with spaces, (2) indentation, (3) using 'const', and (4)
-// changing the V and I parameters from int* to PagedArray<int>&.
-//
-// The code appears to be a rewritten version of the suffix array algorithm
-// presented in "Faster Suffix Sorting" by N. Jesper Larsson and Kunihiko
-// Sadakane, special cased for bytes.
+// Suffix array construction by induced sorting (SA-IS), as described in "Two
+// Efficient Algorithms for Linear Time Suffix Array Construction" by Ge Nong,
+// Sen Zhang and Wai Hong Chan.  This replaces the qsufsort of the original
+// bsdiff.c, which takes O(n log n) time and needs a second full-size array V.
+// SA-IS runs in linear time and, apart from the suffix array itself, needs
+// only one bit per byte of input and the buckets.
+
+namespace {
+
+// A view of a PagedArray<int> starting at |offset|.  The recursive step of
+// SA-IS keeps both the reduced string and its suffix array inside the
+// caller's suffix array, so no other full-size array is needed.
+class PagedArraySlice {
+ public:
+  PagedArraySlice(PagedArray<int>* array, size_t offset)
+      : array_(array), offset_(offset) {
+  }
 
-static void
-split(PagedArray<int>& I,PagedArray<int>& V,int start,int len,int h)
-{
-  int i,j,k,x,tmp,jj,kk;
-
-  if(len<16) {
-    for(k=start;k<start+len;k+=j) {
-      j=1;x=V[I[k]+h];
-      for(i=1;k+i<start+len;i++) {
-        if(V[I[k+i]+h]<x) {
-          x=V[I[k+i]+h];
-          j=0;
-        };
-        if(V[I[k+i]+h]==x) {
-          tmp=I[k+j];I[k+j]=I[k+i];I[k+i]=tmp;
-          j++;
-        };
-      };
-      for(i=0;i<j;i++) V[I[k+i]]=k+j-1;
-      if(j==1) I[k]=-1;
-    };
-    return;
-  };
-
-  x=V[I[start+len/2]+h];
-  jj=0;kk=0;
-  for(i=start;i<start+len;i++) {
-    if(V[I[i]+h]<x) jj++;
-    if(V[I[i]+h]==x) kk++;
-  };
-  jj+=start;kk+=jj;
-
-  i=start;j=0;k=0;
-  while(i<jj) {
-    if(V[I[i]+h]<x) {
-      i++;
-    } else if(V[I[i]+h]==x) {
-      tmp=I[i];I[i]=I[jj+j];I[jj+j]=tmp;
-      j++;
-    } else {
-      tmp=I[i];I[i]=I[kk+k];I[kk+k]=tmp;
-      k++;
-    };
-  };
-
-  while(jj+j<kk) {
-    if(V[I[jj+j]+h]==x) {
-      j++;
-    } else {
-      tmp=I[jj+j];I[jj+j]=I[kk+k];I[kk+k]=tmp;
-      k++;
-    };
-  };
+  int& operator[](int i) const { return (*array_)[offset_ + i]; }
+
+  PagedArraySlice Slice(int offset) const {
+    return PagedArraySlice(array_, offset_ + offset);
+  }
+
+ private:
+  PagedArray<int>* array_;
+  size_t offset_;
+};
+
+// The bytes of the old file followed by a sentinel that is smaller than any
+// of them, as SA-IS requires.
+class SentinelText {
+ public:
+  SentinelText(const unsigned char* text, int length)
+      : text_(text), length_(length) {
+  }
+
+  int operator[](int i) const { return i == length_ ? 0 : text_[i] + 1; }
+
+ private:
+  const unsigned char* text_;
+  int length_;
+};
+
+// The type of each suffix: true for S-type, i.e. smaller than the suffix that
+// follows it, and false for L-type.
+typedef std::vector<bool> SuffixTypes;
+
+// Returns whether the suffix at |i| is a leftmost S-type suffix.
+bool IsLMS(const SuffixTypes& t, int i) {
+  return i > 0 && t[i] && !t[i - 1];
+}
+
+// Computes the start (or end, if |end|) of the bucket for each character in
+// [0, K] of |s|.
+template <typename Text>
+void GetBuckets(const Text& s, int n, int K, bool end, std::vector<int>* bkt) {
+  bkt->assign(K + 1, 0);
+  for (int i = 0; i < n; ++i)
+    ++(*bkt)[s[i]];
+  int sum = 0;
+  for (int i = 0; i <= K; ++i) {
+    sum += (*bkt)[i];
+    (*bkt)[i] = end ? sum : sum - (*bkt)[i];
+  }
+}
+
+// Induces the order of the L-type suffixes from the sorted LMS suffixes.
+template <typename Text>
+void InduceL(const Text& s, const SuffixTypes& t, PagedArraySlice SA,
+             int n, int K, std::vector<int>* bkt) {
+  GetBuckets(s, n, K, false, bkt);
+  for (int i = 0; i < n; ++i) {
+    int j = SA[i] - 1;
+    if (j >= 0 && !t[j])
+      SA[(*bkt)[s[j]]++] = j;
+  }
+}
+
+// Induces the order of the S-type suffixes from the sorted L-type suffixes.
+template <typename Text>
+void InduceS(const Text& s, const SuffixTypes& t, PagedArraySlice SA,
+             int n, int K, std::vector<int>* bkt) {
+  GetBuckets(s, n, K, true, bkt);
+  for (int i = n - 1; i >= 0; --i) {
+    int j = SA[i] - 1;
+    if (j >= 0 && t[j])
+      SA[--(*bkt)[s[j]]] = j;
+  }
+}
 
-  if(jj>start) split(I,V,start,jj-start,h);
+// Stores the suffix array of |s| in |SA|.  |s| has |n| >= 2 characters in
+// [0, K] and ends with a unique smallest character.
+template <typename Text>
+void SuffixSort(const Text& s, PagedArraySlice SA, int n, int K) {
+  SuffixTypes t(n);
+  t[n - 1] = true;
+  t[n - 2] = false;
+  for (int i = n - 3; i >= 0; --i)
+    t[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && t[i + 1]);
+
+  // Stage 1: sort the LMS substrings.
+  std::vector<int> bkt;
+  GetBuckets(s, n, K, true, &bkt);
+  for (int i = 0; i < n; ++i)
+    SA[i] = -1;
+  for (int i = 1; i < n; ++i) {
+    if (IsLMS(t, i))
+      SA[--bkt[s[i]]] = i;
+  }
+  InduceL(s, t, SA, n, K, &bkt);
+  InduceS(s, t, SA, n, K, &bkt);
+  std::vector<int>().swap(bkt);
+
+  // Move the sorted LMS substrings to the front of |SA| and name them.  Equal
+  // substrings get equal names.
+  int n1 = 0;
+  for (int i = 0; i < n; ++i) {
+    if (IsLMS(t, SA[i]))
+      SA[n1++] = SA[i];
+  }
+  for (int i = n1; i < n; ++i)
+    SA[i] = -1;
+  int name = 0;
+  int prev = -1;
+  for (int i = 0; i < n1; ++i) {
+    int pos = SA[i];
+    bool diff = false;
+    for (int d = 0; d < n; ++d) {
+      if (prev == -1 || s[pos + d] != s[prev + d] ||
+          t[pos + d] != t[prev + d]) {
+        diff = true;
+        break;
+      }
+      if (d > 0 && (IsLMS(t, pos + d) || IsLMS(t, prev + d)))
+        break;
+    }
+    if (diff) {
+      ++name;
+      prev = pos;
+    }
+    // LMS positions are at least two apart, so |pos| / 2 is unique.
+    SA[n1 + pos / 2] = name - 1;
+  }
+  for (int i = n - 1, j = n - 1; i >= n1; --i) {
+    if (SA[i] >= 0)
+      SA[j--] = SA[i];
+  }
 
-  for(i=0;i<kk-jj;i++) V[I[jj+i]]=kk-1;
-  if(jj==kk-1) I[jj]=-1;
+  // Stage 2: sort the reduced string of names, recursing if the names are not
+  // yet unique.
+  PagedArraySlice SA1 = SA;
+  PagedArraySlice s1 = SA.Slice(n - n1);
+  if (name < n1) {
+    SuffixSort(s1, SA1, n1, name - 1);
+  } else {
+    for (int i = 0; i < n1; ++i)
+      SA1[s1[i]] = i;
+  }
 
-  if(start+len>kk) split(I,V,kk,start+len-kk,h);
+  // Stage 3: induce the full suffix array from the sorted LMS suffixes.
+  GetBuckets(s, n, K, true, &bkt);
+  for (int i = 1, j = 0; i < n; ++i) {
+    if (IsLMS(t, i))
+      s1[j++] = i;
+  }
+  for (int i = 0; i < n1; ++i)
+    SA1[i] = s1[SA1[i]];
+  for (int i = n1; i < n; ++i)
+    SA[i] = -1;
+  for (int i = n1 - 1; i >= 0; --i) {
+    int j = SA[i];
+    SA[i] = -1;
+    SA[--bkt[s[j]]] = j;
+  }
+  InduceL(s, t, SA, n, K, &bkt);
+  InduceS(s, t, SA, n, K, &bkt);
 }
 
+}  // namespace
+
+// Stores the suffix array of |old| in |I|, which has room for |oldsize| + 1
+// entries.  As with qsufsort, I[0] is |oldsize|, the empty suffix.
 static void
-qsufsort(PagedArray<int>& I, PagedArray<int>& V,const unsigned char *old,int oldsize)
+sais(PagedArray<int>& I, const unsigned char* old, int oldsize)
 {
-  int buckets[256];
-  int i,h,len;
-
-  for(i=0;i<256;i++) buckets[i]=0;
-  for(i=0;i<oldsize;i++) buckets[old[i]]++;
-  for(i=1;i<256;i++) buckets[i]+=buckets[i-1];
-  for(i=255;i>0;i--) buckets[i]=buckets[i-1];
-  buckets[0]=0;
-
-  for(i=0;i<oldsize;i++) I[++buckets[old[i]]]=i;
-  I[0]=oldsize;
-  for(i=0;i<oldsize;i++) V[i]=buckets[old[i]];
-  V[oldsize]=0;
-  for(i=1;i<256;i++) if(buckets[i]==buckets[i-1]+1) I[buckets[i]]=-1;
-  I[0]=-1;
-
-  for(h=1;I[0]!=-(oldsize+1);h+=h) {
-    len=0;
-    for(i=0;i<oldsize+1;) {
-      if(I[i]<0) {
-        len-=I[i];
-        i-=I[i];
-      } else {
-        if(len) I[i-len]=-len;
-        len=V[I[i]]+1-i;
-        split(I,V,i,len,h);
-        i+=len;
-        len=0;
-      };
-    };
-    if(len) I[i-len]=-len;
-  };
-
-  for(i=0;i<oldsize+1;i++) I[V[i]]=i;
+  if (oldsize == 0) {
+    I[0] = 0;
+    return;
+  }
+  // The sentinel shifts the bytes up by one, so the alphabet is [0, 256].
+  SuffixSort(SentinelText(old, oldsize), PagedArraySlice(&I, 0),
+             oldsize + 1, 256);
 }
 
+// ------------------------------------------------------------------------
+//
+// The following code is taken verbatim from 'bsdiff.c'. Please keep all the
+// code formatting and variable names.  The changes from the original are (1)
+// replacing tabs with spaces, (2) indentation, (3) using 'const', and (4)
+// changing the I parameter from int* to PagedArray<int>&.
+
 static int
 matchlen(const unsigned char *old,int oldsize,const unsigned char *newbuf,int newsize)
 {
@@ -221,7 +316,6 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
   uint32 pending_diff_zeros = 0;
 
   PagedArray<int> I;
-  PagedArray<int> V;
 
   if (!I.Allocate(oldsize + 1)) {
     LOG(ERROR) << "Could not allocate I[], " << ((oldsize + 1) * sizeof(int))
@@ -229,17 +323,10 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
     return MEM_ERROR;
   }
 
-  if (!V.Allocate(oldsize + 1)) {
-    LOG(ERROR) << "Could not allocate V[], " << ((oldsize + 1) * sizeof(int))
-               << " bytes";
-    return MEM_ERROR;
-  }
-
-  base::Time q_start_time = base::Time::Now();
-  qsufsort(I, V, old, oldsize);
-  VLOG(1) << " done qsufsort "
-          << (base::Time::Now() - q_start_time).InSecondsF();
-  V.clear();
+  base::Time sais_start_time = base::Time::Now();
+  sais(I, old, oldsize);
+  VLOG(1) << " done sais "
+          << (base::Time::Now() - sais_start_time).InSecondsF();
 
   const uint8* newbuf = new_stream->Buffer();
   const int newsize = static_cast<int>(new_stream->Remaining());
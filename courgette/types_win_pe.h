@@ -57,6 +57,9 @@ const size_t kOffsetOfFileAddressOfNewExeHeader = 0x3c;
 const uint16 kImageNtOptionalHdr32Magic = 0x10b;
 const uint16 kImageNtOptionalHdr64Magic = 0x20b;
 
+// IMAGE_FILE_MACHINE_AMD64, the COFF machine type of x86-64 executables.
+const uint16 kImageFileMachineAmd64 = 0x8664;
+
 const size_t kSizeOfCoffHeader = 20;
 const size_t kOffsetOfDataDirectoryFromImageOptionalHeader32 = 96;
 const size_t kOffsetOfDataDirectoryFromImageOptionalHeader64 = 112;
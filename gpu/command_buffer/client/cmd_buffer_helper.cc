@@ -10,6 +10,21 @@
 
 namespace gpu {
 
+namespace {
+
+// Commands are issued in bursts, so the policy for flushing before the buffer
+// is half full is only applied once every this many commands. This keeps the
+// cost of clock() off each command, and batches small commands into fewer
+// flushes.
+const int kCommandsPerFlushCheck = 100;
+
+// Pending commands are flushed at least this often, in seconds, so that the
+// service does not wait on a client that keeps issuing commands without
+// flushing.
+const double kPeriodicFlushDelay = 1.0 / (5.0 * 60.0);
+
+}  // namespace
+
 CommandBufferHelper::CommandBufferHelper(CommandBuffer* command_buffer)
     : command_buffer_(command_buffer),
       ring_buffer_id_(-1),
@@ -228,14 +243,20 @@ void CommandBufferHelper::WaitForAvailableEntries(int32 count) {
         return;
     }
   }
-  // Force a flush if the buffer is getting half full, or even earlier if the
-  // reader is known to be idle.
+  // Force a flush if the buffer is getting half full. Every
+  // kCommandsPerFlushCheck commands, also flush earlier if the reader is known
+  // to be idle and there is enough work for it, or if commands have been
+  // pending for too long.
   int32 pending =
       (put_ + usable_entry_count_ - last_put_sent_) % usable_entry_count_;
-  int32 limit = usable_entry_count_ /
-      ((get_offset() == last_put_sent_) ? 16 : 2);
-  if (pending > limit) {
+  if (pending > usable_entry_count_ / 2) {
     Flush();
+  } else if (pending > 0 && commands_issued_ % kCommandsPerFlushCheck == 0) {
+    bool reader_idle = get_offset() == last_put_sent_;
+    if ((reader_idle && pending > usable_entry_count_ / 16) ||
+        clock() - last_flush_time_ > kPeriodicFlushDelay * CLOCKS_PER_SEC) {
+      Flush();
+    }
   }
 }
 
@@ -92,6 +92,8 @@ class CommandBufferHelperTest : public testing::Test {
 
     helper_.reset(new CommandBufferHelper(command_buffer_.get()));
     helper_->Initialize(kCommandBufferSizeBytes);
+
+    num_flushes_ = 0;
   }
 
   virtual void TearDown() {
@@ -162,6 +164,12 @@ class CommandBufferHelperTest : public testing::Test {
 
   CommandBufferOffset get_helper_put() { return helper_->put_; }
 
+  // Counts the flushes received by the service.
+  void CountFlushAndPutChanged() {
+    ++num_flushes_;
+    gpu_scheduler_->PutChanged();
+  }
+
 #if defined(OS_MACOSX)
   base::mac::ScopedNSAutoreleasePool autorelease_pool_;
 #endif
@@ -173,6 +181,7 @@ class CommandBufferHelperTest : public testing::Test {
   scoped_ptr<CommandBufferHelper> helper_;
   Sequence sequence_;
   scoped_ptr<DoJumpCommand> do_jump_command_;
+  int num_flushes_;
 };
 
 // Checks that commands in the buffer are properly executed, and that the
@@ -343,6 +352,31 @@ TEST_F(CommandBufferHelperTest, FreeRingBuffer) {
   Mock::VerifyAndClearExpectations(api_mock_.get());
 }
 
+// Checks that a stream of small commands is batched into few flushes, even
+// though the service is idle after each flush.
+TEST_F(CommandBufferHelperTest, TestFlushBatching) {
+  command_buffer_->SetPutOffsetChangeCallback(base::Bind(
+      &CommandBufferHelperTest::CountFlushAndPutChanged,
+      base::Unretained(this)));
+
+  const int kNumCommands = 60;
+  for (int ii = 0; ii < kNumCommands; ++ii) {
+    AddCommandWithExpect(error::kNoError, kUnusedCommandId, 0, NULL);
+  }
+  helper_->Finish();
+
+  // The buffer is flushed when it gets half full, rather than for each
+  // command.
+  EXPECT_GE(kNumCommands * 2 / kUsableNumCommandEntries + 1, num_flushes_);
+  EXPECT_LT(0, num_flushes_);
+
+  // Check that the commands did happen.
+  Mock::VerifyAndClearExpectations(api_mock_.get());
+
+  // Check the error status.
+  EXPECT_EQ(error::kNoError, GetError());
+}
+
 TEST_F(CommandBufferHelperTest, Noop) {
   for (int ii = 1; ii < 4; ++ii) {
     CommandBufferOffset put_before = get_helper_put();
@@ -416,6 +416,8 @@ GLES2Implementation::GLES2Implementation(
       bound_renderbuffer_(0),
       bound_array_buffer_id_(0),
       bound_element_array_buffer_id_(0),
+      bound_pixel_unpack_transfer_buffer_id_(0),
+      bound_pixel_pack_transfer_buffer_id_(0),
       client_side_array_id_(0),
       client_side_element_array_id_(0),
       error_bits_(0),
@@ -1087,6 +1089,7 @@ void GLES2Implementation::Flush() {
   // Flush our command buffer
   // (tell the service to execute up to the flush cmd.)
   helper_->CommandBufferHelper::Flush();
+  transfer_buffer_->ResizeIfNeeded();
 }
 
 void GLES2Implementation::ShallowFlushCHROMIUM() {
@@ -1142,6 +1145,7 @@ void GLES2Implementation::SwapBuffers() {
     helper_->WaitForToken(swap_buffers_tokens_.front());
     swap_buffers_tokens_.pop();
   }
+  transfer_buffer_->ResizeIfNeeded();
 }
 
 void GLES2Implementation::GenSharedIdsCHROMIUM(
@@ -1570,14 +1574,74 @@ void GLES2Implementation::ShaderSource(
   helper_->SetBucketSize(kResultBucketId, 0);
 }
 
+GLES2Implementation::PixelTransferBuffer*
+GLES2Implementation::GetBoundPixelTransferBuffer(
+    GLenum target, const char* function_name,
+    GLintptr offset, GLsizeiptr size) {
+  GLuint buffer_id = target == GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM ?
+      bound_pixel_pack_transfer_buffer_id_ :
+      bound_pixel_unpack_transfer_buffer_id_;
+  if (!buffer_id) {
+    SetGLError(GL_INVALID_OPERATION, function_name, "no buffer bound");
+    return NULL;
+  }
+  PixelTransferBuffer* buffer = &pixel_transfer_buffers_[buffer_id];
+  if (offset < 0 || size < 0 || offset > buffer->size ||
+      size > buffer->size - offset) {
+    SetGLError(GL_INVALID_VALUE, function_name, "out of range");
+    return NULL;
+  }
+  return buffer;
+}
+
+void GLES2Implementation::FreePixelTransferBufferMemory(
+    PixelTransferBuffer* buffer) {
+  if (buffer->address) {
+    mapped_memory_->FreePendingToken(buffer->address, helper_->InsertToken());
+  }
+  *buffer = PixelTransferBuffer();
+}
+
+void GLES2Implementation::WaitForPixelTransferBuffer(
+    PixelTransferBuffer* buffer) {
+  if (buffer->last_usage_token) {
+    helper_->WaitForToken(buffer->last_usage_token);
+    buffer->last_usage_token = 0;
+  }
+}
+
 void GLES2Implementation::BufferDataHelper(
     GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
-  if (size == 0) {
+  if (size < 0) {
+    SetGLError(GL_INVALID_VALUE, "glBufferData", "size < 0");
     return;
   }
 
-  if (size < 0) {
-    SetGLError(GL_INVALID_VALUE, "glBufferData", "size < 0");
+  if (target == GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM ||
+      target == GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM) {
+    PixelTransferBuffer* buffer =
+        GetBoundPixelTransferBuffer(target, "glBufferData", 0, 0);
+    if (!buffer) {
+      return;
+    }
+    FreePixelTransferBufferMemory(buffer);
+    if (size == 0) {
+      return;
+    }
+    buffer->address =
+        mapped_memory_->Alloc(size, &buffer->shm_id, &buffer->shm_offset);
+    if (!buffer->address) {
+      SetGLError(GL_OUT_OF_MEMORY, "glBufferData", "out of memory");
+      return;
+    }
+    buffer->size = size;
+    if (data) {
+      memcpy(buffer->address, data, size);
+    }
+    return;
+  }
+
+  if (size == 0) {
     return;
   }
 
@@ -1631,6 +1695,18 @@ void GLES2Implementation::BufferSubDataHelper(
     return;
   }
 
+  if (target == GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM ||
+      target == GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM) {
+    PixelTransferBuffer* buffer = GetBoundPixelTransferBuffer(
+        target, "glBufferSubData", offset, size);
+    if (!buffer) {
+      return;
+    }
+    WaitForPixelTransferBuffer(buffer);
+    memcpy(static_cast<int8*>(buffer->address) + offset, data, size);
+    return;
+  }
+
   ScopedTransferBufferPtr buffer(size, helper_, transfer_buffer_);
   BufferSubDataHelperImpl(target, offset, size, data, &buffer);
 }
@@ -1783,6 +1859,22 @@ void GLES2Implementation::TexImage2D(
     return;
   }
 
+  // With a pixel unpack transfer buffer bound, pixels is an offset in it, and
+  // the service reads the data straight from the buffer's shared memory.
+  if (bound_pixel_unpack_transfer_buffer_id_) {
+    GLintptr offset = reinterpret_cast<GLintptr>(pixels);
+    PixelTransferBuffer* buffer = GetBoundPixelTransferBuffer(
+        GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, "glTexImage2D", offset, size);
+    if (!buffer) {
+      return;
+    }
+    helper_->TexImage2D(
+        target, level, internalformat, width, height, border, format, type,
+        buffer->shm_id, buffer->shm_offset + offset);
+    buffer->last_usage_token = helper_->InsertToken();
+    return;
+  }
+
   // If there's no data just issue TexImage2D
   if (!pixels) {
     helper_->TexImage2D(
@@ -1870,6 +1962,21 @@ void GLES2Implementation::TexSubImage2D(
     return;
   }
 
+  if (bound_pixel_unpack_transfer_buffer_id_) {
+    GLintptr offset = reinterpret_cast<GLintptr>(pixels);
+    PixelTransferBuffer* buffer = GetBoundPixelTransferBuffer(
+        GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, "glTexSubImage2D", offset,
+        temp_size);
+    if (!buffer) {
+      return;
+    }
+    helper_->TexSubImage2D(
+        target, level, xoffset, yoffset, width, height, format, type,
+        buffer->shm_id, buffer->shm_offset + offset, false);
+    buffer->last_usage_token = helper_->InsertToken();
+    return;
+  }
+
   // compute the advance bytes per row for the src pixels
   uint32 src_padded_row_size;
   if (unpack_row_length_ > 0) {
@@ -2174,6 +2281,7 @@ const GLubyte* GLES2Implementation::GetStringHelper(GLenum name) {
         str += std::string(str.empty() ? "" : " ") +
             "GL_CHROMIUM_flipy "
             "GL_CHROMIUM_map_sub "
+            "GL_CHROMIUM_pixel_transfer_buffer_object "
             "GL_CHROMIUM_shallow_flush "
             "GL_EXT_unpack_subimage";
         break;
@@ -2290,6 +2398,31 @@ void GLES2Implementation::ReadPixels(
   TRACE_EVENT0("gpu", "GLES2::ReadPixels");
   typedef gles2::ReadPixels::Result Result;
 
+  // With a pixel pack transfer buffer bound, pixels is an offset in it. The
+  // service writes the pixels straight into the buffer's shared memory, and
+  // nothing waits for the command. Mapping the buffer waits for the pixels;
+  // a GL_ASYNC_READ_PIXELS_COMPLETED_CHROMIUM query tells when that would not
+  // block.
+  if (bound_pixel_pack_transfer_buffer_id_) {
+    uint32 size;
+    if (!GLES2Util::ComputeImageDataSizes(
+        width, height, format, type, pack_alignment_, &size, NULL, NULL)) {
+      SetGLError(GL_INVALID_VALUE, "glReadPixels", "size too large.");
+      return;
+    }
+    GLintptr offset = reinterpret_cast<GLintptr>(pixels);
+    PixelTransferBuffer* buffer = GetBoundPixelTransferBuffer(
+        GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM, "glReadPixels", offset, size);
+    if (!buffer) {
+      return;
+    }
+    helper_->ReadPixels(
+        xoffset, yoffset, width, height, format, type,
+        buffer->shm_id, buffer->shm_offset + offset, 0, 0);
+    buffer->last_usage_token = helper_->InsertToken();
+    return;
+  }
+
   int8* dest = reinterpret_cast<int8*>(pixels);
   uint32 temp_size;
   uint32 unpadded_row_size;
@@ -2376,9 +2509,10 @@ void GLES2Implementation::ActiveTexture(GLenum texture) {
 // the old model but possibly not true in the new model if another context has
 // deleted the resource.
 
-void GLES2Implementation::BindBufferHelper(
+bool GLES2Implementation::BindBufferHelper(
     GLenum target, GLuint buffer) {
   // TODO(gman): See note #1 above.
+  bool send_to_service = true;
   switch (target) {
     case GL_ARRAY_BUFFER:
       bound_array_buffer_id_ = buffer;
@@ -2386,12 +2520,25 @@ void GLES2Implementation::BindBufferHelper(
     case GL_ELEMENT_ARRAY_BUFFER:
       bound_element_array_buffer_id_ = buffer;
       break;
+    case GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM:
+      bound_pixel_unpack_transfer_buffer_id_ = buffer;
+      if (buffer)
+        pixel_transfer_buffers_[buffer];
+      send_to_service = false;
+      break;
+    case GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM:
+      bound_pixel_pack_transfer_buffer_id_ = buffer;
+      if (buffer)
+        pixel_transfer_buffers_[buffer];
+      send_to_service = false;
+      break;
     default:
       break;
   }
   // TODO(gman): There's a bug here. If the target is invalid the ID will not be
   // used even though it's marked it as used here.
   GetIdHandler(id_namespaces::kBuffers)->MarkAsUsedForBind(buffer);
+  return send_to_service;
 }
 
 void GLES2Implementation::BindFramebufferHelper(
@@ -2473,6 +2620,18 @@ void GLES2Implementation::DeleteBuffersHelper(
     if (buffers[ii] == bound_element_array_buffer_id_) {
       bound_element_array_buffer_id_ = 0;
     }
+    if (buffers[ii] == bound_pixel_unpack_transfer_buffer_id_) {
+      bound_pixel_unpack_transfer_buffer_id_ = 0;
+    }
+    if (buffers[ii] == bound_pixel_pack_transfer_buffer_id_) {
+      bound_pixel_pack_transfer_buffer_id_ = 0;
+    }
+    PixelTransferBufferMap::iterator it =
+        pixel_transfer_buffers_.find(buffers[ii]);
+    if (it != pixel_transfer_buffers_.end()) {
+      FreePixelTransferBufferMemory(&it->second);
+      pixel_transfer_buffers_.erase(it);
+    }
   }
 }
 
@@ -2730,7 +2889,11 @@ void* GLES2Implementation::MapBufferSubDataCHROMIUM(
       << GLES2Util::GetStringEnum(access) << ")");
   // NOTE: target is NOT checked because the service will check it
   // and we don't know what targets are valid.
-  if (access != GL_WRITE_ONLY) {
+  // Pixel pack transfer buffers are read back, so they are mapped for
+  // reading instead.
+  GLenum expected_access = target == GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM ?
+      GL_READ_ONLY : GL_WRITE_ONLY;
+  if (access != expected_access) {
     SetGLErrorInvalidEnum(
         "glMapBufferSubDataCHROMIUM", access, "access");
     return NULL;
@@ -2739,6 +2902,31 @@ void* GLES2Implementation::MapBufferSubDataCHROMIUM(
     SetGLError(GL_INVALID_VALUE, "glMapBufferSubDataCHROMIUM", "bad range");
     return NULL;
   }
+  if (target == GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM ||
+      target == GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM) {
+    // The data of the buffer is mapped directly; nothing is copied on unmap.
+    // Mapping waits until the service is done with the buffer.
+    PixelTransferBuffer* buffer = GetBoundPixelTransferBuffer(
+        target, "glMapBufferSubDataCHROMIUM", offset, size);
+    if (!buffer || !buffer->address) {
+      return NULL;
+    }
+    WaitForPixelTransferBuffer(buffer);
+    void* mem = static_cast<int8*>(buffer->address) + offset;
+    std::pair<MappedBufferMap::iterator, bool> result =
+       mapped_buffers_.insert(std::make_pair(
+           mem,
+           MappedBuffer(
+               access, buffer->shm_id, mem, buffer->shm_offset + offset,
+               target, offset, size)));
+    if (!result.second) {
+      SetGLError(GL_INVALID_OPERATION, "glMapBufferSubDataCHROMIUM",
+                 "already mapped");
+      return NULL;
+    }
+    GPU_CLIENT_LOG("  returned " << mem);
+    return mem;
+  }
   int32 shm_id;
   unsigned int shm_offset;
   void* mem = mapped_memory_->Alloc(size, &shm_id, &shm_offset);
@@ -2768,6 +2956,11 @@ void GLES2Implementation::UnmapBufferSubDataCHROMIUM(const void* mem) {
     return;
   }
   const MappedBuffer& mb = it->second;
+  if (mb.target == GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM ||
+      mb.target == GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM) {
+    mapped_buffers_.erase(it);
+    return;
+  }
   helper_->BufferSubData(
       mb.target, mb.offset, mb.size, mb.shm_id, mb.shm_offset);
   mapped_memory_->FreePendingToken(mb.shm_memory, helper_->InsertToken());
@@ -3056,6 +3249,7 @@ void GLES2Implementation::PostSubBufferCHROMIUM(
     helper_->WaitForToken(swap_buffers_tokens_.front());
     swap_buffers_tokens_.pop();
   }
+  transfer_buffer_->ResizeIfNeeded();
 }
 
 void GLES2Implementation::DeleteQueriesEXTHelper(
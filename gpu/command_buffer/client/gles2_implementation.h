@@ -322,6 +322,25 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
     GLsizeiptr size;
   };
 
+  // Used to track buffers of GL_CHROMIUM_pixel_transfer_buffer_object. Their
+  // data lives in shared memory, and they are never sent to the service.
+  struct PixelTransferBuffer {
+    PixelTransferBuffer()
+        : size(0),
+          shm_id(0),
+          shm_offset(0),
+          address(NULL),
+          last_usage_token(0) {
+    }
+
+    GLsizeiptr size;
+    int32 shm_id;
+    uint32 shm_offset;
+    void* address;
+    // Token inserted after the last command that reads or writes the buffer.
+    int32 last_usage_token;
+  };
+
   struct TextureUnit {
     TextureUnit()
         : bound_texture_2d(0),
@@ -401,7 +420,8 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   bool IsRenderbufferReservedId(GLuint id) { return false; }
   bool IsTextureReservedId(GLuint id) { return false; }
 
-  void BindBufferHelper(GLenum target, GLuint texture);
+  // Returns false if the binding is handled on the client side only.
+  bool BindBufferHelper(GLenum target, GLuint texture);
   void BindFramebufferHelper(GLenum target, GLuint texture);
   void BindRenderbufferHelper(GLenum target, GLuint texture);
   void BindTextureHelper(GLenum target, GLuint texture);
@@ -423,6 +443,16 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   // TODO(gman): Remove this as queries are not shared.
   void DeleteQueriesStub(GLsizei n, const GLuint* queries);
 
+  // Returns the pixel transfer buffer bound to |target|, or NULL and sets a
+  // GL error if none is bound or [offset, offset + size) does not fit in it.
+  PixelTransferBuffer* GetBoundPixelTransferBuffer(
+      GLenum target, const char* function_name,
+      GLintptr offset, GLsizeiptr size);
+  // Frees the memory of |buffer| once the service is done with it.
+  void FreePixelTransferBufferMemory(PixelTransferBuffer* buffer);
+  // Waits until the service is done reading the data of |buffer|.
+  void WaitForPixelTransferBuffer(PixelTransferBuffer* buffer);
+
   void BufferDataHelper(
       GLenum target, GLsizeiptr size, const void* data, GLenum usage);
   void BufferSubDataHelper(
@@ -526,6 +556,12 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   // The currently bound element array buffer.
   GLuint bound_element_array_buffer_id_;
 
+  // The currently bound pixel unpack transfer buffer.
+  GLuint bound_pixel_unpack_transfer_buffer_id_;
+
+  // The currently bound pixel pack transfer buffer.
+  GLuint bound_pixel_pack_transfer_buffer_id_;
+
   // GL names for the buffers used to emulate client side buffers.
   GLuint client_side_array_id_;
   GLuint client_side_element_array_id_;
@@ -554,6 +590,9 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   // have an enum for this so handle it separately.
   std::set<std::string> requestable_extensions_set_;
 
+  typedef std::map<GLuint, PixelTransferBuffer> PixelTransferBufferMap;
+  PixelTransferBufferMap pixel_transfer_buffers_;
+
   typedef std::map<const void*, MappedBuffer> MappedBufferMap;
   MappedBufferMap mapped_buffers_;
 
@@ -28,8 +28,9 @@ void BindBuffer(GLenum target, GLuint buffer) {
     SetGLError(GL_INVALID_OPERATION, "BindBuffer", "buffer reserved id");
     return;
   }
-  BindBufferHelper(target, buffer);
-  helper_->BindBuffer(target, buffer);
+  if (BindBufferHelper(target, buffer)) {
+    helper_->BindBuffer(target, buffer);
+  }
 }
 
 void BindFramebuffer(GLenum target, GLuint framebuffer) {
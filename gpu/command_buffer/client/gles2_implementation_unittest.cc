@@ -129,6 +129,7 @@ class MockTransferBuffer : public TransferBufferInterface {
   virtual void* Alloc(unsigned int size) OVERRIDE;
   virtual RingBuffer::Offset GetOffset(void* pointer) const OVERRIDE;
   virtual void FreePendingToken(void* p, unsigned int /* token */) OVERRIDE;
+  virtual void ResizeIfNeeded() OVERRIDE;
 
   size_t MaxTransferBufferSize() {
     return size_ - result_size_;
@@ -294,6 +295,9 @@ void MockTransferBuffer::FreePendingToken(void* p, unsigned int /* token */) {
   last_alloc_ = NULL;
 }
 
+void MockTransferBuffer::ResizeIfNeeded() {
+}
+
 class GLES2ImplementationTest : public testing::Test {
  protected:
   static const uint8 kInitialValue = 0xBD;
@@ -1404,6 +1408,77 @@ TEST_F(GLES2ImplementationTest, MapUnmapBufferSubDataCHROMIUMBadArgs) {
   EXPECT_EQ(static_cast<GLenum>(GL_INVALID_VALUE), gl_->GetError());
 }
 
+TEST_F(GLES2ImplementationTest, PixelTransferBufferTexSubImage2D) {
+  struct Cmds {
+    TexSubImage2D tex;
+    cmd::SetToken set_token;
+  };
+  const GLenum kTarget = GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM;
+  const GLuint kBufferId = 123;
+  const GLsizei kWidth = 4;
+  const GLsizei kHeight = 3;
+  const GLsizeiptr kSize = kWidth * kHeight * 4;
+
+  Cmds expected;
+  expected.tex.Init(
+      GL_TEXTURE_2D, 0, 1, 2, kWidth, kHeight, GL_RGBA, GL_UNSIGNED_BYTE,
+      command_buffer()->GetNextFreeTransferBufferId(), 0, false);
+  expected.set_token.Init(GetNextToken());
+
+  // Binding, allocating and mapping the buffer do not send any command, and
+  // the texture data is read from the buffer without being copied.
+  gl_->BindBuffer(kTarget, kBufferId);
+  gl_->BufferData(kTarget, kSize, NULL, GL_STREAM_DRAW);
+  void* mem = gl_->MapBufferSubDataCHROMIUM(kTarget, 0, kSize, GL_WRITE_ONLY);
+  ASSERT_TRUE(mem != NULL);
+  memset(mem, 0xAB, kSize);
+  gl_->UnmapBufferSubDataCHROMIUM(mem);
+  gl_->TexSubImage2D(
+      GL_TEXTURE_2D, 0, 1, 2, kWidth, kHeight, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+  EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
+  EXPECT_EQ(static_cast<GLenum>(GL_NO_ERROR), CheckError());
+}
+
+TEST_F(GLES2ImplementationTest, PixelTransferBufferReadPixels) {
+  struct Cmds {
+    ReadPixels read;
+    cmd::SetToken set_token;
+  };
+  const GLenum kTarget = GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM;
+  const GLuint kBufferId = 123;
+  const GLsizei kWidth = 4;
+  const GLsizei kHeight = 3;
+  const GLsizeiptr kSize = kWidth * kHeight * 4;
+  const GLintptr kOffset = 16;
+
+  Cmds expected;
+  expected.read.Init(
+      1, 2, kWidth, kHeight, GL_RGBA, GL_UNSIGNED_BYTE,
+      command_buffer()->GetNextFreeTransferBufferId(), kOffset, 0, 0);
+  expected.set_token.Init(GetNextToken());
+
+  // The service writes the pixels straight into the buffer, and the client
+  // does not wait for a result.
+  gl_->BindBuffer(kTarget, kBufferId);
+  gl_->BufferData(kTarget, kOffset + kSize, NULL, GL_STREAM_DRAW);
+  gl_->ReadPixels(
+      1, 2, kWidth, kHeight, GL_RGBA, GL_UNSIGNED_BYTE,
+      reinterpret_cast<void*>(kOffset));
+  EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
+  EXPECT_EQ(static_cast<GLenum>(GL_NO_ERROR), CheckError());
+
+  // The pixels do not fit in the buffer.
+  gl_->ReadPixels(
+      1, 2, kWidth, kHeight, GL_RGBA, GL_UNSIGNED_BYTE,
+      reinterpret_cast<void*>(kOffset + 1));
+  EXPECT_EQ(static_cast<GLenum>(GL_INVALID_VALUE), CheckError());
+
+  // Pack buffers are only mapped for reading.
+  EXPECT_TRUE(gl_->MapBufferSubDataCHROMIUM(
+      kTarget, 0, kSize, GL_WRITE_ONLY) == NULL);
+  EXPECT_EQ(static_cast<GLenum>(GL_INVALID_ENUM), CheckError());
+}
+
 TEST_F(GLES2ImplementationTest, MapUnmapTexSubImage2DCHROMIUM) {
   struct Cmds {
     TexSubImage2D tex;
@@ -2307,6 +2382,7 @@ TEST_F(GLES2ImplementationTest, GetString) {
       "foobar "
       "GL_CHROMIUM_flipy "
       "GL_CHROMIUM_map_sub "
+      "GL_CHROMIUM_pixel_transfer_buffer_object "
       "GL_CHROMIUM_shallow_flush "
       "GL_EXT_unpack_subimage";
   const char kBad = 0x12;
@@ -9,6 +9,10 @@
 
 namespace gpu {
 
+// Number of allocations between two calls to ResizeIfNeeded that may wait for
+// free space before the buffer is replaced by a larger one.
+static const unsigned int kWaitsBeforeGrowing = 4;
+
 AlignedRingBuffer::~AlignedRingBuffer() {
 }
 
@@ -19,6 +23,10 @@ TransferBuffer::TransferBuffer(
       default_buffer_size_(0),
       min_buffer_size_(0),
       max_buffer_size_(0),
+      preferred_buffer_size_(0),
+      waits_since_resize_check_(0),
+      num_waits_(0),
+      wait_time_(0),
       alignment_(0),
       size_to_flush_(0),
       bytes_since_last_flush_(0),
@@ -43,6 +51,7 @@ bool TransferBuffer::Initialize(
   default_buffer_size_ = default_buffer_size;
   min_buffer_size_ = min_buffer_size;
   max_buffer_size_ = max_buffer_size;
+  preferred_buffer_size_ = default_buffer_size;
   alignment_ = alignment;
   size_to_flush_ = size_to_flush;
   ReallocateRingBuffer(default_buffer_size_ - result_size);
@@ -138,7 +147,7 @@ void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
   // What size buffer would we ask for if we needed a new one?
   unsigned int needed_buffer_size = ComputePOTSize(size + result_size_);
   needed_buffer_size = std::max(needed_buffer_size, min_buffer_size_);
-  needed_buffer_size = std::max(needed_buffer_size, default_buffer_size_);
+  needed_buffer_size = std::max(needed_buffer_size, preferred_buffer_size_);
   needed_buffer_size = std::min(needed_buffer_size, max_buffer_size_);
 
   if (usable_ && (!HaveBuffer() || needed_buffer_size > buffer_.size)) {
@@ -162,7 +171,7 @@ void* TransferBuffer::AllocUpTo(
   unsigned int max_size = ring_buffer_->GetLargestFreeOrPendingSize();
   *size_allocated = std::min(max_size, size);
   bytes_since_last_flush_ += *size_allocated;
-  return ring_buffer_->Alloc(*size_allocated);
+  return AllocFromRingBuffer(*size_allocated);
 }
 
 void* TransferBuffer::Alloc(unsigned int size) {
@@ -178,7 +187,35 @@ void* TransferBuffer::Alloc(unsigned int size) {
   }
 
   bytes_since_last_flush_ += size;
-  return ring_buffer_->Alloc(size);
+  return AllocFromRingBuffer(size);
+}
+
+void* TransferBuffer::AllocFromRingBuffer(unsigned int size) {
+  unsigned int aligned_size = (size + alignment_ - 1) & ~(alignment_ - 1);
+  if (aligned_size <= ring_buffer_->GetLargestFreeSizeNoWaiting())
+    return ring_buffer_->Alloc(size);
+
+  ++num_waits_;
+  ++waits_since_resize_check_;
+  clock_t start_time = clock();
+  void* ptr = ring_buffer_->Alloc(size);
+  wait_time_ += clock() - start_time;
+  return ptr;
+}
+
+void TransferBuffer::ResizeIfNeeded() {
+  unsigned int waits = waits_since_resize_check_;
+  waits_since_resize_check_ = 0;
+  if (!HaveBuffer() || waits <= kWaitsBeforeGrowing ||
+      buffer_.size >= max_buffer_size_) {
+    return;
+  }
+  // The service can't keep up with the uploads at this size. Waiting for it
+  // once to replace the buffer is cheaper than waiting on every upload.
+  preferred_buffer_size_ = std::min(
+      static_cast<unsigned int>(buffer_.size) * 2, max_buffer_size_);
+  Free();
+  AllocateRingBuffer(preferred_buffer_size_);
 }
 
 void* TransferBuffer::GetResultBuffer() {
@@ -204,6 +241,14 @@ unsigned int TransferBuffer::GetMaxAllocation() const {
   return HaveBuffer() ? max_buffer_size_ - result_size_ : 0;
 }
 
+unsigned int TransferBuffer::GetNumWaits() const {
+  return num_waits_;
+}
+
+clock_t TransferBuffer::GetWaitTime() const {
+  return wait_time_;
+}
+
 void ScopedTransferBufferPtr::Release() {
   if (buffer_) {
     transfer_buffer_->FreePendingToken(buffer_, helper_->InsertToken());
@@ -5,6 +5,8 @@
 #ifndef GPU_COMMAND_BUFFER_CLIENT_TRANSFER_BUFFER_H_
 #define GPU_COMMAND_BUFFER_CLIENT_TRANSFER_BUFFER_H_
 
+#include <time.h>
+
 #include "../../gpu_export.h"
 #include "../common/buffer.h"
 #include "../common/compiler_specific.h"
@@ -82,9 +84,19 @@ class GPU_EXPORT TransferBufferInterface {
   virtual RingBuffer::Offset GetOffset(void* pointer) const = 0;
 
   virtual void FreePendingToken(void* p, unsigned int token) = 0;
+
+  // Replaces the buffer with one of a better size for the recent
+  // allocations, if needed. Must not be called while an allocation or the
+  // result buffer is in use.
+  virtual void ResizeIfNeeded() = 0;
 };
 
 // Class that manages the transfer buffer.
+//
+// When the allocations made between two calls to ResizeIfNeeded keep having to
+// wait for the service to consume earlier ones, the buffer is replaced by a
+// larger one, up to max_buffer_size, so that steady streams of uploads stop
+// stalling the client.
 class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
  public:
   TransferBuffer(CommandBufferHelper* helper);
@@ -108,17 +120,26 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   virtual void* Alloc(unsigned int size) OVERRIDE;
   virtual RingBuffer::Offset GetOffset(void* pointer) const OVERRIDE;
   virtual void FreePendingToken(void* p, unsigned int token) OVERRIDE;
+  virtual void ResizeIfNeeded() OVERRIDE;
 
   // These are for testing.
   unsigned int GetCurrentMaxAllocationWithoutRealloc() const;
   unsigned int GetMaxAllocation() const;
 
+  // The number of times the client waited for the service to free space in
+  // the transfer buffer, and the total time it waited, in clock() ticks.
+  unsigned int GetNumWaits() const;
+  clock_t GetWaitTime() const;
+
  private:
   // Tries to reallocate the ring buffer if it's not large enough for size.
   void ReallocateRingBuffer(unsigned int size);
 
   void AllocateRingBuffer(unsigned int size);
 
+  // Allocates size bytes from the ring buffer, keeping track of the waits.
+  void* AllocFromRingBuffer(unsigned int size);
+
   CommandBufferHelper* helper_;
   scoped_ptr<AlignedRingBuffer> ring_buffer_;
 
@@ -134,6 +155,17 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   // max size we'll let the buffer grow
   unsigned int max_buffer_size_;
 
+  // Size we want when allocating a new buffer. Starts at the default size and
+  // grows when the allocations wait too often.
+  unsigned int preferred_buffer_size_;
+
+  // Number of allocations that waited since the last call to ResizeIfNeeded.
+  unsigned int waits_since_resize_check_;
+
+  // Stats on the waits for free space.
+  unsigned int num_waits_;
+  clock_t wait_time_;
+
   // alignment for allocations
   unsigned int alignment_;
 
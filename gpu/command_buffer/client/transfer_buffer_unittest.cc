@@ -436,6 +436,67 @@ TEST_F(TransferBufferExpandContractTest, OutOfMemory) {
   EXPECT_FALSE(transfer_buffer_->HaveBuffer());
 }
 
+TEST_F(TransferBufferExpandContractTest, GrowsWhenAllocationsWait) {
+  const size_t kSize = (kStartTransferBufferSize - kStartingOffset) / 2;
+  unsigned int size_allocated = 0;
+
+  // Two allocations fit without waiting.
+  for (int i = 0; i < 2; ++i) {
+    void* ptr = transfer_buffer_->AllocUpTo(kSize, &size_allocated);
+    ASSERT_TRUE(ptr != NULL);
+    transfer_buffer_->FreePendingToken(ptr, 1);
+  }
+  EXPECT_EQ(0u, transfer_buffer_->GetNumWaits());
+  transfer_buffer_->ResizeIfNeeded();
+
+  // A few waits are not enough to grow the buffer.
+  for (int i = 0; i < 4; ++i) {
+    void* ptr = transfer_buffer_->AllocUpTo(kSize, &size_allocated);
+    ASSERT_TRUE(ptr != NULL);
+    transfer_buffer_->FreePendingToken(ptr, 1);
+  }
+  EXPECT_EQ(4u, transfer_buffer_->GetNumWaits());
+  transfer_buffer_->ResizeIfNeeded();
+  EXPECT_EQ(
+      kStartTransferBufferSize - kStartingOffset,
+      transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+
+  // Waiting on every allocation does.
+  for (int i = 0; i < 5; ++i) {
+    void* ptr = transfer_buffer_->AllocUpTo(kSize, &size_allocated);
+    ASSERT_TRUE(ptr != NULL);
+    transfer_buffer_->FreePendingToken(ptr, 1);
+  }
+  EXPECT_EQ(9u, transfer_buffer_->GetNumWaits());
+
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kStartTransferBufferSize * 2, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  transfer_buffer_->ResizeIfNeeded();
+  EXPECT_EQ(
+      kStartTransferBufferSize * 2 - kStartingOffset,
+      transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+
+  // The larger size is kept when the buffer is reallocated.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  transfer_buffer_->Free();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kStartTransferBufferSize * 2, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  EXPECT_TRUE(transfer_buffer_->GetResultBuffer() != NULL);
+}
+
 TEST_F(TransferBufferExpandContractTest, ReallocsToDefault) {
   // Free buffer.
   EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
@@ -89,6 +89,9 @@
 /* GL_CHROMIUM_get_error_query */
 #define GL_GET_ERROR_QUERY_CHROMIUM            0x84F3
 
+/* GL_CHROMIUM_async_read_pixels */
+#define GL_ASYNC_READ_PIXELS_COMPLETED_CHROMIUM 0x84F5
+
 // GL_OES_texure_3D
 #define GL_SAMPLER_3D_OES                      0x8B5F
 
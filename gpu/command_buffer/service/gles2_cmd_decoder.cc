@@ -6440,11 +6440,18 @@ error::Error GLES2DecoderImpl::HandleReadPixels(
   }
   void* pixels = GetSharedMemoryAs<void*>(
       c.pixels_shm_id, c.pixels_shm_offset, pixels_size);
-  Result* result = GetSharedMemoryAs<Result*>(
-        c.result_shm_id, c.result_shm_offset, sizeof(*result));
-  if (!pixels || !result) {
+  if (!pixels) {
     return error::kOutOfBounds;
   }
+  // Reads into a pixel pack transfer buffer do not wait for a result.
+  Result* result = NULL;
+  if (c.result_shm_id != 0) {
+    result = GetSharedMemoryAs<Result*>(
+        c.result_shm_id, c.result_shm_offset, sizeof(*result));
+    if (!result) {
+      return error::kOutOfBounds;
+    }
+  }
 
   if (!validators_->read_pixel_format.IsValid(format)) {
     SetGLErrorInvalidEnum("glReadPixels", format, "format");
@@ -6521,7 +6528,9 @@ error::Error GLES2DecoderImpl::HandleReadPixels(
   }
   GLenum error = PeekGLError();
   if (error == GL_NO_ERROR) {
-    *result = true;
+    if (result) {
+      *result = true;
+    }
 
     GLenum read_format = GetBoundReadFrameBufferInternalFormat();
     uint32 channels_exist = GLES2Util::GetChannelsForFormat(read_format);
@@ -8646,6 +8655,7 @@ error::Error GLES2DecoderImpl::HandleBeginQueryEXT(
 
   switch (target) {
     case GL_COMMANDS_ISSUED_CHROMIUM:
+    case GL_ASYNC_READ_PIXELS_COMPLETED_CHROMIUM:
       break;
     default:
       if (!feature_info_->feature_flags().occlusion_query_boolean) {
@@ -36,10 +36,10 @@ TextureDefinition* MailboxManager::ConsumeTexture(unsigned target,
 
   TextureDefinitionMap::iterator it =
       textures_.find(TargetName(target, name));
-  if (it == textures_.end()) {
-    NOTREACHED();
+  // A consumer that does not wait on the producer's sync point can get here
+  // before the texture is produced, which is a client error.
+  if (it == textures_.end())
     return NULL;
-  }
 
   TextureDefinition* definition = it->second.definition.release();
   textures_.erase(it);
@@ -44,6 +44,7 @@ class GPU_EXPORT MailboxManager : public base::RefCounted<MailboxManager> {
   void GenerateMailboxName(MailboxName* name);
 
   // Remove the texture definition from the named mailbox and empty the mailbox.
+  // Returns NULL if the name is invalid or nothing was produced into it.
   TextureDefinition* ConsumeTexture(unsigned target, const MailboxName& name);
 
   // Put the texture definition in the named mailbox.
@@ -6,6 +6,7 @@
 
 #include "base/command_line.h"
 #include "base/metrics/histogram.h"
+#include "base/pickle.h"
 #include "base/sha1.h"
 #include "base/string_number_conversions.h"
 #include "gpu/command_buffer/service/gl_utils.h"
@@ -13,6 +14,12 @@
 #include "ui/gl/gl_bindings.h"
 
 namespace {
+
+typedef gpu::gles2::ShaderTranslator::VariableMap VariableMap;
+
+// Bumped whenever the serialized form of the programs changes.
+const int kPersistedProgramVersion = 1;
+
 size_t GetCacheSizeBytes() {
   size_t size;
   const CommandLine* command_line = CommandLine::ForCurrentProcess();
@@ -24,6 +31,54 @@ size_t GetCacheSizeBytes() {
   }
   return gpu::gles2::MemoryProgramCache::kDefaultMaxProgramCacheMemoryBytes;
 }
+
+// The switches that change how shaders are translated, and so the binaries
+// and variable maps of the programs.
+std::string GetTranslatorOptions() {
+  static const char* const kTranslatorSwitches[] = {
+    switches::kDisableGLSLTranslator,
+    switches::kDisableGpuDriverBugWorkarounds,
+    switches::kEnforceGLMinimums,
+  };
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  std::string options;
+  for (size_t i = 0; i < arraysize(kTranslatorSwitches); ++i) {
+    if (command_line->HasSwitch(kTranslatorSwitches[i])) {
+      options += kTranslatorSwitches[i];
+      options += " ";
+    }
+  }
+  return options;
+}
+
+void WriteVariableMap(const VariableMap& map, Pickle* pickle) {
+  pickle->WriteInt(static_cast<int>(map.size()));
+  for (VariableMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+    pickle->WriteString(it->first);
+    pickle->WriteInt(it->second.type);
+    pickle->WriteInt(it->second.size);
+    pickle->WriteString(it->second.name);
+  }
+}
+
+bool ReadVariableMap(PickleIterator* iter, VariableMap* map) {
+  int count;
+  if (!iter->ReadInt(&count) || count < 0)
+    return false;
+  for (int i = 0; i < count; ++i) {
+    std::string key;
+    gpu::gles2::ShaderTranslator::VariableInfo info;
+    if (!iter->ReadString(&key) ||
+        !iter->ReadInt(&info.type) ||
+        !iter->ReadInt(&info.size) ||
+        !iter->ReadString(&info.name)) {
+      return false;
+    }
+    (*map)[key] = info;
+  }
+  return true;
+}
+
 }  // anonymous namespace
 
 namespace gpu {
@@ -39,6 +94,68 @@ MemoryProgramCache::MemoryProgramCache(const size_t max_cache_size_bytes)
 
 MemoryProgramCache::~MemoryProgramCache() {}
 
+void MemoryProgramCache::EnablePersistence(
+    const std::string& driver_identity,
+    const PersistProgramCallback& callback) {
+  persistence_salt_ = driver_identity + "\n" + GetTranslatorOptions();
+  persist_callback_ = callback;
+}
+
+void MemoryProgramCache::LoadProgram(const std::string& program) {
+  Pickle pickle(program.data(), static_cast<int>(program.size()));
+  PickleIterator iter(pickle);
+  int version;
+  std::string salt;
+  std::string sha_string;
+  uint32 format;
+  const char* binary;
+  int length;
+  std::string shader_0_hash;
+  VariableMap attrib_map_0;
+  VariableMap uniform_map_0;
+  std::string shader_1_hash;
+  VariableMap attrib_map_1;
+  VariableMap uniform_map_1;
+  if (!iter.ReadInt(&version) ||
+      version != kPersistedProgramVersion ||
+      !iter.ReadString(&salt) ||
+      salt != persistence_salt_ ||
+      !iter.ReadString(&sha_string) ||
+      !iter.ReadUInt32(&format) ||
+      !iter.ReadData(&binary, &length) ||
+      !iter.ReadString(&shader_0_hash) ||
+      !ReadVariableMap(&iter, &attrib_map_0) ||
+      !ReadVariableMap(&iter, &uniform_map_0) ||
+      !iter.ReadString(&shader_1_hash) ||
+      !ReadVariableMap(&iter, &attrib_map_1) ||
+      !ReadVariableMap(&iter, &uniform_map_1)) {
+    return;
+  }
+  if (sha_string.length() != kHashLength ||
+      shader_0_hash.length() != kHashLength ||
+      shader_1_hash.length() != kHashLength ||
+      length <= 0 ||
+      static_cast<size_t>(length) > max_size_bytes_) {
+    return;
+  }
+  // The program may have been linked again since it was saved.
+  if (store_.find(sha_string) != store_.end())
+    return;
+
+  char* data = new char[length];
+  memcpy(data, binary, length);
+  StoreProgram(sha_string, new ProgramCacheValue(length,
+                                                 format,
+                                                 data,
+                                                 shader_0_hash.data(),
+                                                 attrib_map_0,
+                                                 uniform_map_0,
+                                                 shader_1_hash.data(),
+                                                 attrib_map_1,
+                                                 uniform_map_1));
+  LinkedProgramLoaded(sha_string, shader_0_hash, shader_1_hash);
+}
+
 void MemoryProgramCache::ClearBackend() {
   curr_size_bytes_ = 0;
   store_.clear();
@@ -117,15 +234,56 @@ void MemoryProgramCache::SaveLinkedProgram(
   UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeBeforeKb",
                        curr_size_bytes_ / 1024);
 
-  if (store_.find(sha_string) != store_.end()) {
-    const StoreMap::iterator found = store_.find(sha_string);
+  scoped_refptr<ProgramCacheValue> value(
+      new ProgramCacheValue(length,
+                            format,
+                            binary.release(),
+                            a_sha,
+                            shader_a->attrib_map(),
+                            shader_a->uniform_map(),
+                            b_sha,
+                            shader_b->attrib_map(),
+                            shader_b->uniform_map()));
+  StoreProgram(sha_string, value);
+
+  UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeAfterKb",
+                         curr_size_bytes_ / 1024);
+
+  LinkedProgramCacheSuccess(sha_string,
+                            std::string(a_sha, kHashLength),
+                            std::string(b_sha, kHashLength));
+
+  if (!persist_callback_.is_null()) {
+    Pickle pickle;
+    pickle.WriteInt(kPersistedProgramVersion);
+    pickle.WriteString(persistence_salt_);
+    pickle.WriteString(sha_string);
+    pickle.WriteUInt32(value->format);
+    pickle.WriteData(value->data.get(), value->length);
+    pickle.WriteString(value->shader_0_hash);
+    WriteVariableMap(value->attrib_map_0, &pickle);
+    WriteVariableMap(value->uniform_map_0, &pickle);
+    pickle.WriteString(value->shader_1_hash);
+    WriteVariableMap(value->attrib_map_1, &pickle);
+    WriteVariableMap(value->uniform_map_1, &pickle);
+    persist_callback_.Run(
+        base::HexEncode(sha_string.data(), sha_string.length()),
+        std::string(static_cast<const char*>(pickle.data()), pickle.size()));
+  }
+}
+
+void MemoryProgramCache::StoreProgram(
+    const std::string& program_hash,
+    const scoped_refptr<ProgramCacheValue>& value) {
+  if (store_.find(program_hash) != store_.end()) {
+    const StoreMap::iterator found = store_.find(program_hash);
     const ProgramCacheValue* evicting = found->second;
     curr_size_bytes_ -= evicting->length;
-    Evict(sha_string, evicting->shader_0_hash, evicting->shader_1_hash);
+    Evict(program_hash, evicting->shader_0_hash, evicting->shader_1_hash);
     store_.erase(found);
   }
 
-  while (curr_size_bytes_ + length > max_size_bytes_) {
+  while (curr_size_bytes_ + value->length > max_size_bytes_) {
     DCHECK(!eviction_helper_.IsEmpty());
     const std::string* program = eviction_helper_.PeekKey();
     const StoreMap::iterator found = store_.find(*program);
@@ -135,24 +293,9 @@ void MemoryProgramCache::SaveLinkedProgram(
     store_.erase(found);
     eviction_helper_.PopKey();
   }
-  store_[sha_string] = new ProgramCacheValue(length,
-                                             format,
-                                             binary.release(),
-                                             a_sha,
-                                             shader_a->attrib_map(),
-                                             shader_a->uniform_map(),
-                                             b_sha,
-                                             shader_b->attrib_map(),
-                                             shader_b->uniform_map());
-  curr_size_bytes_ += length;
-  eviction_helper_.KeyUsed(sha_string);
-
-  UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeAfterKb",
-                         curr_size_bytes_ / 1024);
-
-  LinkedProgramCacheSuccess(sha_string,
-                            std::string(a_sha, kHashLength),
-                            std::string(b_sha, kHashLength));
+  store_[program_hash] = value;
+  curr_size_bytes_ += value->length;
+  eviction_helper_.KeyUsed(program_hash);
 }
 
 MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 
+#include "base/callback.h"
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -23,6 +24,11 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
  public:
   static const size_t kDefaultMaxProgramCacheMemoryBytes = 6 * 1024 * 1024;
 
+  // Called with a key and the serialized contents of each program saved to
+  // the cache, so that they can be stored across restarts.
+  typedef base::Callback<void(const std::string&, const std::string&)>
+      PersistProgramCallback;
+
   MemoryProgramCache();
   explicit MemoryProgramCache(const size_t max_cache_size_bytes);
   virtual ~MemoryProgramCache();
@@ -38,6 +44,17 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
       const ShaderManager::ShaderInfo* shader_b,
       const LocationMap* bind_attrib_location_map) OVERRIDE;
 
+  // Passes the programs saved from now on to |callback|. |driver_identity|
+  // should change whenever the driver could produce different binaries.
+  // Programs are only loaded back by a cache with the same driver identity
+  // and shader translator options.
+  void EnablePersistence(const std::string& driver_identity,
+                         const PersistProgramCallback& callback);
+
+  // Adds a program serialized by a previous instance of the cache. Programs
+  // that were saved for another driver or translator options are ignored.
+  void LoadProgram(const std::string& program);
+
  private:
   virtual void ClearBackend() OVERRIDE;
 
@@ -74,10 +91,16 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
   typedef base::hash_map<std::string,
                          scoped_refptr<ProgramCacheValue> > StoreMap;
 
+  // Inserts |value|, evicting the least recently used programs to make room.
+  void StoreProgram(const std::string& program_hash,
+                    const scoped_refptr<ProgramCacheValue>& value);
+
   const size_t max_size_bytes_;
   size_t curr_size_bytes_;
   StoreMap store_;
   ProgramCacheLruHelper eviction_helper_;
+  std::string persistence_salt_;
+  PersistProgramCallback persist_callback_;
 
   DISALLOW_COPY_AND_ASSIGN(MemoryProgramCache);
 };
@@ -4,6 +4,7 @@
 
 #include "gpu/command_buffer/service/memory_program_cache.h"
 
+#include "base/bind.h"
 #include "gpu/command_buffer/common/gl_mock.h"
 #include "gpu/command_buffer/common/gles2_cmd_format.h"
 #include "gpu/command_buffer/service/gl_utils.h"
@@ -19,6 +20,22 @@ using ::testing::SetArrayArgument;
 
 namespace {
 typedef gpu::gles2::ShaderTranslator::VariableMap VariableMap;
+
+// Records the last program passed to the persistence callback.
+class PersistedProgramRecorder {
+ public:
+  void Persist(const std::string& key, const std::string& program) {
+    key_ = key;
+    program_ = program;
+  }
+
+  const std::string& key() const { return key_; }
+  const std::string& program() const { return program_; }
+
+ private:
+  std::string key_;
+  std::string program_;
+};
 }  // anonymous namespace
 
 namespace gpu {
@@ -445,5 +462,58 @@ TEST_F(MemoryProgramCacheTest, OverwriteOnNewSave) {
       NULL));
 }
 
+TEST_F(MemoryProgramCacheTest, PersistedProgramLoadsIntoNewCache) {
+  const GLenum kFormat = 1;
+  const int kProgramId = 10;
+  const int kBinaryLength = 20;
+  char test_binary[kBinaryLength];
+  for (int i = 0; i < kBinaryLength; ++i) {
+    test_binary[i] = i;
+  }
+  ProgramBinaryEmulator emulator(kBinaryLength, kFormat, test_binary);
+
+  PersistedProgramRecorder recorder;
+  cache_->EnablePersistence(
+      "driver", base::Bind(&PersistedProgramRecorder::Persist,
+                           base::Unretained(&recorder)));
+  SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
+  cache_->SaveLinkedProgram(kProgramId, vertex_shader_, fragment_shader_, NULL);
+  EXPECT_FALSE(recorder.key().empty());
+  EXPECT_FALSE(recorder.program().empty());
+
+  MemoryProgramCache same_driver_cache(kCacheSizeBytes);
+  same_driver_cache.EnablePersistence(
+      "driver", MemoryProgramCache::PersistProgramCallback());
+  same_driver_cache.LoadProgram(recorder.program());
+  EXPECT_EQ(ProgramCache::LINK_SUCCEEDED,
+            same_driver_cache.GetLinkedProgramStatus(
+                *vertex_shader_->deferred_compilation_source(),
+                *fragment_shader_->deferred_compilation_source(),
+                NULL));
+
+  // A program linked by another driver must not be used.
+  MemoryProgramCache other_driver_cache(kCacheSizeBytes);
+  other_driver_cache.EnablePersistence(
+      "other driver", MemoryProgramCache::PersistProgramCallback());
+  other_driver_cache.LoadProgram(recorder.program());
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN,
+            other_driver_cache.GetLinkedProgramStatus(
+                *vertex_shader_->deferred_compilation_source(),
+                *fragment_shader_->deferred_compilation_source(),
+                NULL));
+
+  // Nor a truncated one.
+  MemoryProgramCache truncated_cache(kCacheSizeBytes);
+  truncated_cache.EnablePersistence(
+      "driver", MemoryProgramCache::PersistProgramCallback());
+  truncated_cache.LoadProgram(
+      recorder.program().substr(0, recorder.program().size() / 2));
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN,
+            truncated_cache.GetLinkedProgramStatus(
+                *vertex_shader_->deferred_compilation_source(),
+                *fragment_shader_->deferred_compilation_source(),
+                NULL));
+}
+
 }  // namespace gles2
 }  // namespace gpu
@@ -99,6 +99,14 @@ void ProgramCache::LinkedProgramCacheSuccess(const std::string& program_hash,
   shader_status_[shader_b_hash].ref_count++;
 }
 
+void ProgramCache::LinkedProgramLoaded(const std::string& program_hash,
+                                       const std::string& shader_a_hash,
+                                       const std::string& shader_b_hash) {
+  LinkedProgramCacheSuccess(program_hash, shader_a_hash, shader_b_hash);
+  shader_status_[shader_a_hash].status = COMPILATION_SUCCEEDED;
+  shader_status_[shader_b_hash].status = COMPILATION_SUCCEEDED;
+}
+
 void ProgramCache::ComputeShaderHash(const std::string& str,
                                      char* result) const {
   base::SHA1HashBytes(reinterpret_cast<const unsigned char*>(str.c_str()),
@@ -80,6 +80,12 @@ class GPU_EXPORT ProgramCache {
                                  const std::string& shader_a_hash,
                                  const std::string& shader_b_hash);
 
+  // called by implementing class after adding a program that was linked by a
+  // previous instance of the cache, so its shaders are known to compile
+  void LinkedProgramLoaded(const std::string& program_hash,
+                           const std::string& shader_a_hash,
+                           const std::string& shader_b_hash);
+
   // result is not null terminated
   void ComputeShaderHash(const std::string& shader,
                          char* result) const;
@@ -564,6 +564,30 @@ TEST_F(QueryManagerTest, GetErrorQuery) {
   manager->Destroy(false);
 }
 
+TEST_F(QueryManagerTest, AsyncReadPixelsCompletedQuery) {
+  const GLuint kClient1Id = 1;
+  const GLenum kTarget = GL_ASYNC_READ_PIXELS_COMPLETED_CHROMIUM;
+  const uint32 kSubmitCount = 123;
+
+  QueryManager::Query* query = manager_->CreateQuery(
+      kTarget, kClient1Id, kSharedMemoryId, kSharedMemoryOffset);
+  ASSERT_TRUE(query != NULL);
+
+  // Setup shared memory like client would.
+  QuerySync* sync = decoder_->GetSharedMemoryAs<QuerySync*>(
+      kSharedMemoryId, kSharedMemoryOffset, sizeof(*sync));
+  ASSERT_TRUE(sync != NULL);
+  sync->Reset();
+
+  EXPECT_TRUE(manager_->BeginQuery(query));
+  EXPECT_TRUE(manager_->EndQuery(query, kSubmitCount));
+  EXPECT_FALSE(query->pending());
+  EXPECT_FALSE(manager_->HavePendingQueries());
+
+  EXPECT_EQ(kSubmitCount, sync->process_count);
+  EXPECT_EQ(1u, sync->result);
+}
+
 }  // namespace gles2
 }  // namespace gpu
 
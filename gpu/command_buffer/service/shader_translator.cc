@@ -9,11 +9,15 @@
 
 #include "base/at_exit.h"
 #include "base/logging.h"
+#include "base/sha1.h"
 
 namespace {
 
 using gpu::gles2::ShaderTranslator;
 
+// The number of translation results kept by each translator.
+const size_t kMaxCachedTranslations = 64;
+
 void FinalizeShaderTranslator(void* /* dummy */) {
   ShFinalize();
 }
@@ -86,10 +90,20 @@ ShaderTranslator::DestructionObserver::DestructionObserver() {
 ShaderTranslator::DestructionObserver::~DestructionObserver() {
 }
 
+ShaderTranslator::TranslationResult::TranslationResult()
+    : success(false) {
+}
+
+ShaderTranslator::TranslationResult::~TranslationResult() {
+}
+
 ShaderTranslator::ShaderTranslator()
     : compiler_(NULL),
       implementation_is_glsl_es_(false),
-      needs_built_in_function_emulation_(false) {
+      needs_built_in_function_emulation_(false),
+      translation_cache_(kMaxCachedTranslations),
+      translation_cache_hits_(0),
+      translation_cache_misses_(0) {
 }
 
 bool ShaderTranslator::Init(
@@ -123,6 +137,29 @@ bool ShaderTranslator::Translate(const char* shader) {
   // Make sure this instance is initialized.
   DCHECK(compiler_ != NULL);
   DCHECK(shader != NULL);
+
+  std::string hash = base::SHA1HashString(shader);
+  TranslationCache::iterator it = translation_cache_.Get(hash);
+  if (it != translation_cache_.end()) {
+    ++translation_cache_hits_;
+    SetResults(it->second);
+    return it->second.success;
+  }
+  ++translation_cache_misses_;
+
+  TranslationResult result;
+  result.success = TranslateUncached(shader);
+  if (translated_shader_.get())
+    result.translated_shader = translated_shader_.get();
+  if (info_log_.get())
+    result.info_log = info_log_.get();
+  result.attrib_map = attrib_map_;
+  result.uniform_map = uniform_map_;
+  translation_cache_.Put(hash, result);
+  return result.success;
+}
+
+bool ShaderTranslator::TranslateUncached(const char* shader) {
   ClearResults();
 
   bool success = false;
@@ -194,6 +231,22 @@ ShaderTranslator::~ShaderTranslator() {
     ShDestruct(compiler_);
 }
 
+void ShaderTranslator::SetResults(const TranslationResult& result) {
+  ClearResults();
+  if (!result.translated_shader.empty()) {
+    translated_shader_.reset(new char[result.translated_shader.size() + 1]);
+    memcpy(translated_shader_.get(), result.translated_shader.c_str(),
+           result.translated_shader.size() + 1);
+  }
+  if (!result.info_log.empty()) {
+    info_log_.reset(new char[result.info_log.size() + 1]);
+    memcpy(info_log_.get(), result.info_log.c_str(),
+           result.info_log.size() + 1);
+  }
+  attrib_map_ = result.attrib_map;
+  uniform_map_ = result.uniform_map;
+}
+
 void ShaderTranslator::ClearResults() {
   translated_shader_.reset();
   info_log_.reset();
@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/hash_tables.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
@@ -85,7 +86,12 @@ class ShaderTranslatorInterface {
   virtual ~ShaderTranslatorInterface() {}
 };
 
-// Implementation of ShaderTranslatorInterface
+// Implementation of ShaderTranslatorInterface.
+//
+// The results of the recent translations are kept, keyed by the hash of the
+// source. As the translators are shared by all the contexts that use the
+// same options (see ShaderTranslatorCache), a shader that is compiled by
+// several contexts is only translated once.
 class GPU_EXPORT ShaderTranslator
     : public base::RefCounted<ShaderTranslator>,
       NON_EXPORTED_BASE(public ShaderTranslatorInterface) {
@@ -125,11 +131,33 @@ class GPU_EXPORT ShaderTranslator
   void AddDestructionObserver(DestructionObserver* observer);
   void RemoveDestructionObserver(DestructionObserver* observer);
 
+  // The number of translations whose results were, or were not, found in
+  // the cache of the recent translations.
+  int translation_cache_hits() const { return translation_cache_hits_; }
+  int translation_cache_misses() const { return translation_cache_misses_; }
+
  private:
   friend class base::RefCounted<ShaderTranslator>;
 
+  // The results of a translation.
+  struct TranslationResult {
+    TranslationResult();
+    ~TranslationResult();
+
+    bool success;
+    std::string translated_shader;
+    std::string info_log;
+    VariableMap attrib_map;
+    VariableMap uniform_map;
+  };
+
+  // Maps the SHA1 hash of a shader source to the results of its translation.
+  typedef base::MRUCache<std::string, TranslationResult> TranslationCache;
+
   virtual ~ShaderTranslator();
   void ClearResults();
+  bool TranslateUncached(const char* shader);
+  void SetResults(const TranslationResult& result);
 
   ShHandle compiler_;
   scoped_array<char> translated_shader_;
@@ -139,6 +167,9 @@ class GPU_EXPORT ShaderTranslator
   bool implementation_is_glsl_es_;
   bool needs_built_in_function_emulation_;
   ObserverList<DestructionObserver> destruction_observers_;
+  TranslationCache translation_cache_;
+  int translation_cache_hits_;
+  int translation_cache_misses_;
 
   DISALLOW_COPY_AND_ASSIGN(ShaderTranslator);
 };
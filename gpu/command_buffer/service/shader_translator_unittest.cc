@@ -199,6 +199,42 @@ TEST_F(ShaderTranslatorTest, GetUniforms) {
   EXPECT_EQ("bar[1].foo.color[0]", iter->second.name);
 }
 
+TEST_F(ShaderTranslatorTest, CachedTranslation) {
+  const char* shader =
+      "attribute vec4 vPosition;\n"
+      "void main() {\n"
+      "  gl_Position = vPosition;\n"
+      "}";
+  const char* bad_shader = "foo-bar";
+
+  EXPECT_TRUE(vertex_translator_->Translate(shader));
+  std::string translated_shader = vertex_translator_->translated_shader();
+  ShaderTranslator::VariableMap attrib_map = vertex_translator_->attrib_map();
+  EXPECT_EQ(0, vertex_translator_->translation_cache_hits());
+  EXPECT_EQ(1, vertex_translator_->translation_cache_misses());
+
+  EXPECT_FALSE(vertex_translator_->Translate(bad_shader));
+  EXPECT_TRUE(vertex_translator_->info_log() != NULL);
+  EXPECT_EQ(2, vertex_translator_->translation_cache_misses());
+
+  // Translating the same sources again gives the same results without
+  // running the translator.
+  EXPECT_TRUE(vertex_translator_->Translate(shader));
+  EXPECT_EQ(1, vertex_translator_->translation_cache_hits());
+  EXPECT_STREQ(translated_shader.c_str(),
+               vertex_translator_->translated_shader());
+  EXPECT_TRUE(vertex_translator_->info_log() == NULL);
+  EXPECT_EQ(1u, vertex_translator_->attrib_map().size());
+  EXPECT_TRUE(vertex_translator_->attrib_map().find(
+      attrib_map.begin()->first) != vertex_translator_->attrib_map().end());
+
+  EXPECT_FALSE(vertex_translator_->Translate(bad_shader));
+  EXPECT_EQ(2, vertex_translator_->translation_cache_hits());
+  EXPECT_TRUE(vertex_translator_->translated_shader() == NULL);
+  EXPECT_TRUE(vertex_translator_->info_log() != NULL);
+  EXPECT_TRUE(vertex_translator_->attrib_map().empty());
+}
+
 #if defined(OS_MACOSX)
 TEST_F(ShaderTranslatorTest, BuiltInFunctionEmulation) {
   // This test might become invalid in the future when ANGLE Translator is no
@@ -46,6 +46,8 @@
       'sources': [
         'file_descriptor_set_posix_unittest.cc',
         'ipc_channel_posix_unittest.cc',
+        'ipc_channel_proxy_unittest.cc',
+        'ipc_channel_reader_unittest.cc',
         'ipc_fuzzing_tests.cc',
         'ipc_message_unittest.cc',
         'ipc_message_utils_unittest.cc',
@@ -79,6 +81,32 @@
         }]
       ],
     },
+    {
+      'target_name': 'ipc_perftests',
+      'type': '<(gtest_target_type)',
+      'dependencies': [
+        'ipc',
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_base',
+        '../base/base.gyp:test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'include_dirs': [
+        '..'
+      ],
+      'sources': [
+        'ipc_message_utils_perftest.cc',
+        'ipc_sync_channel_perftest.cc',
+        'ipc_sync_message_unittest.h',
+      ],
+      'conditions': [
+        ['toolkit_uses_gtk == 1', {
+          'dependencies': [
+            '../build/linux/system.gyp:gtk',
+          ],
+        }],
+      ],
+    },
     {
       'target_name': 'test_support_ipc',
       'type': 'static_library',
@@ -90,6 +90,14 @@ class IPC_EXPORT Channel : public Sender {
                                      // constants starting from 0.
   };
 
+  // On POSIX, a message larger than a few hundred kilobytes is copied into
+  // shared memory, and only a descriptor for it is written to the pipe. The
+  // wrapping message has a routing id of MSG_ROUTING_NONE and a type of
+  // OUT_OF_LINE_MESSAGE_TYPE, and is unwrapped by the receiving Channel.
+  enum {
+    OUT_OF_LINE_MESSAGE_TYPE = kuint16max - 1
+  };
+
   // The maximum message size in bytes. Attempting to receive a message of this
   // size or bigger results in a channel error.
   static const size_t kMaximumMessageSize = 128 * 1024 * 1024;
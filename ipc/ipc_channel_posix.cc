@@ -29,8 +29,10 @@
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/singleton.h"
+#include "base/metrics/histogram.h"
 #include "base/process_util.h"
 #include "base/rand_util.h"
+#include "base/shared_memory.h"
 #include "base/stl_util.h"
 #include "base/string_util.h"
 #include "base/synchronization/lock.h"
@@ -38,6 +40,7 @@
 #include "ipc/ipc_switches.h"
 #include "ipc/file_descriptor_set_posix.h"
 #include "ipc/ipc_logging.h"
+#include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_utils.h"
 
 namespace IPC {
@@ -293,6 +296,51 @@ bool SocketWriteErrorIsRecoverable() {
 #endif  // OS_MACOSX
 }
 
+// Messages at least this large are sent through shared memory, so that
+// neither side has to copy them through the socket buffers.
+const size_t kOutOfLineMessageThreshold = 256 * 1024;
+
+void RecordLargeMessage(const Message& message) {
+  if (message.size() < Channel::kReadBufferSize)
+    return;
+  UMA_HISTOGRAM_CUSTOM_COUNTS("IPC.LargeMessageSize", message.size(),
+                              Channel::kReadBufferSize,
+                              Channel::kMaximumMessageSize, 50);
+  UMA_HISTOGRAM_ENUMERATION("IPC.LargeMessageClass",
+                            IPC_MESSAGE_ID_CLASS(message.type()),
+                            LastIPCMsgStart);
+}
+
+// Returns a message carrying a copy of |message| in shared memory, or NULL if
+// |message| should be sent as is. Messages carrying file descriptors are
+// always sent as is, as are all messages when shared memory can not be
+// created. Must only be called where creating shared memory can not fail
+// fatally, which rules out sandboxed processes; see Send().
+Message* CreateOutOfLineMessage(const Message& message) {
+  if (message.size() < kOutOfLineMessageThreshold ||
+      message.HasFileDescriptors()) {
+    return NULL;
+  }
+
+  base::SharedMemory shared_memory;
+  if (!shared_memory.CreateAndMapAnonymous(message.size()))
+    return NULL;
+  memcpy(shared_memory.memory(), message.data(), message.size());
+
+  base::SharedMemoryHandle handle;
+  if (!shared_memory.GiveToProcess(base::GetCurrentProcessHandle(), &handle))
+    return NULL;
+
+  scoped_ptr<Message> out_of_line(new Message(
+      MSG_ROUTING_NONE, Channel::OUT_OF_LINE_MESSAGE_TYPE,
+      message.priority()));
+  if (!out_of_line->WriteUInt32(message.size()) ||
+      !out_of_line->WriteFileDescriptor(handle)) {
+    return NULL;
+  }
+  return out_of_line.release();
+}
+
 }  // namespace
 //------------------------------------------------------------------------------
 
@@ -632,6 +680,18 @@ bool Channel::ChannelImpl::Send(Message* message) {
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
   message->TraceMessageBegin();
+  RecordLargeMessage(*message);
+  // Only the server end of a channel sends messages out of line. Clients are
+  // child processes which may be sandboxed, and there creating shared memory
+  // fails with a fatal error because /dev/shm can not be opened. Mapping a
+  // segment received from the server works in the sandbox.
+  if (mode_ & MODE_SERVER_FLAG) {
+    Message* out_of_line = CreateOutOfLineMessage(*message);
+    if (out_of_line) {
+      delete message;
+      message = out_of_line;
+    }
+  }
   output_queue_.push(message);
   if (!is_blocked_on_write_ && !waiting_connect_) {
     return ProcessOutgoingMessages();
@@ -1091,6 +1151,52 @@ void Channel::ChannelImpl::HandleHelloMessage(const Message& msg) {
   listener()->OnChannelConnected(pid);
 }
 
+bool Channel::ChannelImpl::DispatchOutOfLineMessage(const Message& msg) {
+  PickleIterator iter(msg);
+  uint32 size;
+  base::FileDescriptor descriptor;
+  if (!msg.ReadUInt32(&iter, &size) ||
+      !msg.ReadFileDescriptor(&iter, &descriptor)) {
+    LOG(ERROR) << "Malformed out of line IPC message";
+    return false;
+  }
+
+  // Copy the message out of the shared memory, so that the sender can not
+  // modify it while it is being read.
+  std::string data;
+  {
+    base::SharedMemory shared_memory(descriptor, true);
+    // Mapping more than the segment holds would fault on access, so the size
+    // chosen by the peer is checked against that of the segment.
+    struct stat st;
+    if (fstat(descriptor.fd, &st) != 0 ||
+        static_cast<uint64>(st.st_size) < size) {
+      LOG(ERROR) << "Out of line IPC message of size " << size
+                 << " does not fit in its shared memory segment";
+      return false;
+    }
+    if (size > Channel::kMaximumMessageSize || !shared_memory.Map(size)) {
+      LOG(ERROR) << "Could not map out of line IPC message of size " << size;
+      return false;
+    }
+    data.assign(static_cast<const char*>(shared_memory.memory()), size);
+  }
+
+  const char* start = data.data();
+  const char* end = start + data.size();
+  if (Message::FindNext(start, end) != end) {
+    LOG(ERROR) << "Out of line IPC message is not a single message";
+    return false;
+  }
+  Message m(start, static_cast<int>(data.size()));
+  if (m.header()->num_fds || IsHelloMessage(m) || IsOutOfLineMessage(m)) {
+    LOG(ERROR) << "Invalid out of line IPC message of type " << m.type();
+    return false;
+  }
+  listener()->OnMessageReceived(m);
+  return true;
+}
+
 void Channel::ChannelImpl::Close() {
   // Close can be called multiple time, so we need to make sure we're
   // idempotent.
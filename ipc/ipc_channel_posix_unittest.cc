@@ -18,9 +18,12 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
 #include "base/path_service.h"
+#include "base/process_util.h"
+#include "base/shared_memory.h"
 #include "base/test/multiprocess_test.h"
 #include "base/test/test_timeouts.h"
 #include "ipc/ipc_listener.h"
+#include "ipc/ipc_message.h"
 #include "testing/multiprocess_func_list.h"
 
 namespace {
@@ -39,13 +42,16 @@ class IPCChannelPosixTestListener : public IPC::Listener {
   };
 
   IPCChannelPosixTestListener(bool quit_only_on_message)
-      : status_(DISCONNECTED), quit_only_on_message_(quit_only_on_message) {}
+      : status_(DISCONNECTED),
+        quit_only_on_message_(quit_only_on_message),
+        last_message_size_(0) {}
 
   virtual ~IPCChannelPosixTestListener() {}
 
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
     EXPECT_EQ(message.type(), kQuitMessage);
     status_ = MESSAGE_RECEIVED;
+    last_message_size_ = message.size();
     QuitRunLoop();
     return true;
   }
@@ -80,6 +86,8 @@ class IPCChannelPosixTestListener : public IPC::Listener {
 
   STATUS status() { return status_; }
 
+  size_t last_message_size() const { return last_message_size_; }
+
   void QuitRunLoop() {
     MessageLoopForIO::current()->QuitNow();
   }
@@ -90,6 +98,8 @@ class IPCChannelPosixTestListener : public IPC::Listener {
   // If |quit_only_on_message_| then the listener will only break out of
   // the run loop when kQuitMessage is received.
   bool quit_only_on_message_;
+  // The size of the last message received.
+  size_t last_message_size_;
 };
 
 }  // namespace
@@ -231,6 +241,96 @@ TEST_F(IPCChannelPosixTest, BasicConnected) {
   ASSERT_FALSE(channel2.AcceptsConnections());
 }
 
+TEST_F(IPCChannelPosixTest, LargeMessage) {
+  // Test sending messages large enough to be sent out of line by the server,
+  // and inline by the client, which may be sandboxed.
+  int pipe_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pipe_fds));
+  ASSERT_GE(fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK), 0);
+  ASSERT_GE(fcntl(pipe_fds[1], F_SETFL, O_NONBLOCK), 0);
+
+  IPCChannelPosixTestListener server_listener(true);
+  IPC::ChannelHandle server_handle(
+      "IPCChannelPosixTest_LargeMessage_Server",
+      base::FileDescriptor(pipe_fds[0], true));
+  IPC::Channel server(server_handle, IPC::Channel::MODE_SERVER,
+                      &server_listener);
+  ASSERT_TRUE(server.Connect());
+
+  IPCChannelPosixTestListener client_listener(true);
+  IPC::ChannelHandle client_handle(
+      "IPCChannelPosixTest_LargeMessage_Client",
+      base::FileDescriptor(pipe_fds[1], true));
+  IPC::Channel client(client_handle, IPC::Channel::MODE_CLIENT,
+                      &client_listener);
+  ASSERT_TRUE(client.Connect());
+
+  IPC::Message* message = new IPC::Message(0,  // routing_id
+                                           kQuitMessage,  // message type
+                                           IPC::Message::PRIORITY_NORMAL);
+  message->WriteString(std::string(1024 * 1024, 'a'));
+  size_t message_size = message->size();
+  ASSERT_TRUE(server.Send(message));
+  SpinRunLoop(TestTimeouts::action_max_timeout());
+  ASSERT_EQ(IPCChannelPosixTestListener::MESSAGE_RECEIVED,
+            client_listener.status());
+  EXPECT_EQ(message_size, client_listener.last_message_size());
+
+  message = new IPC::Message(0,  // routing_id
+                             kQuitMessage,  // message type
+                             IPC::Message::PRIORITY_NORMAL);
+  message->WriteString(std::string(1024 * 1024, 'b'));
+  ASSERT_TRUE(client.Send(message));
+  SpinRunLoop(TestTimeouts::action_max_timeout());
+  ASSERT_EQ(IPCChannelPosixTestListener::MESSAGE_RECEIVED,
+            server_listener.status());
+  EXPECT_EQ(message_size, server_listener.last_message_size());
+}
+
+TEST_F(IPCChannelPosixTest, OutOfLineMessageLargerThanSegment) {
+  // Test that an out of line message claiming more data than its shared
+  // memory segment holds is rejected instead of being mapped.
+  int pipe_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pipe_fds));
+  ASSERT_GE(fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK), 0);
+  ASSERT_GE(fcntl(pipe_fds[1], F_SETFL, O_NONBLOCK), 0);
+
+  IPCChannelPosixTestListener server_listener(false);
+  IPC::ChannelHandle server_handle(
+      "IPCChannelPosixTest_OutOfLineMessageLargerThanSegment_Server",
+      base::FileDescriptor(pipe_fds[0], true));
+  IPC::Channel server(server_handle, IPC::Channel::MODE_SERVER,
+                      &server_listener);
+  ASSERT_TRUE(server.Connect());
+
+  IPCChannelPosixTestListener client_listener(true);
+  IPC::ChannelHandle client_handle(
+      "IPCChannelPosixTest_OutOfLineMessageLargerThanSegment_Client",
+      base::FileDescriptor(pipe_fds[1], true));
+  IPC::Channel client(client_handle, IPC::Channel::MODE_CLIENT,
+                      &client_listener);
+  ASSERT_TRUE(client.Connect());
+
+  base::SharedMemory shared_memory;
+  ASSERT_TRUE(shared_memory.CreateAndMapAnonymous(4096));
+  base::SharedMemoryHandle shared_memory_handle;
+  ASSERT_TRUE(shared_memory.GiveToProcess(base::GetCurrentProcessHandle(),
+                                          &shared_memory_handle));
+  IPC::Message* message = new IPC::Message(
+      MSG_ROUTING_NONE, IPC::Channel::OUT_OF_LINE_MESSAGE_TYPE,
+      IPC::Message::PRIORITY_NORMAL);
+  message->WriteUInt32(1024 * 1024);
+  message->WriteFileDescriptor(shared_memory_handle);
+  ASSERT_TRUE(client.Send(message));
+
+  // The hello message may be dispatched on its own first.
+  SpinRunLoop(TestTimeouts::action_max_timeout());
+  if (server_listener.status() == IPCChannelPosixTestListener::CONNECTED)
+    SpinRunLoop(TestTimeouts::action_max_timeout());
+  ASSERT_EQ(IPCChannelPosixTestListener::CHANNEL_ERROR,
+            server_listener.status());
+}
+
 TEST_F(IPCChannelPosixTest, AdvancedConnected) {
   // Test creating a connection to an external process.
   IPCChannelPosixTestListener listener(false);
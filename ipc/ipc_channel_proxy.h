@@ -88,6 +88,14 @@ class IPC_EXPORT ChannelProxy : public Sender {
     // the message be handled in the default way.
     virtual bool OnMessageReceived(const Message& message);
 
+    // Called on the background thread when the filter is added. A filter that
+    // only handles some message classes (see IPCMessageStart) can list them
+    // in |supported_message_classes| and return true, so that it is not
+    // offered messages of other classes. Returns false by default, which means
+    // the filter is offered every message.
+    virtual bool GetSupportedMessageClasses(
+        std::vector<uint32>* supported_message_classes) const;
+
     // Called when the message filter is about to be deleted.  This gives
     // derived classes the option of controlling which thread they're deleted
     // on etc.
@@ -241,6 +249,9 @@ class IPC_EXPORT ChannelProxy : public Sender {
     void OnAddFilter();
     void OnRemoveFilter(MessageFilter* filter);
 
+    // Rebuilds message_class_filters_ from filters_.
+    void UpdateMessageClassFilters();
+
     // Methods called on the listener thread.
     void AddFilter(MessageFilter* filter);
     void OnDispatchConnected();
@@ -251,6 +262,10 @@ class IPC_EXPORT ChannelProxy : public Sender {
 
     // List of filters.  This is only accessed on the IPC thread.
     std::vector<scoped_refptr<MessageFilter> > filters_;
+    // The filters offered the messages of each message class, in the order of
+    // filters_. Indexed by IPCMessageStart, and only accessed on the IPC
+    // thread.
+    std::vector<std::vector<MessageFilter*> > message_class_filters_;
     scoped_refptr<base::SingleThreadTaskRunner> ipc_task_runner_;
     scoped_ptr<Channel> channel_;
     std::string channel_id_;
@@ -0,0 +1,154 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_channel_proxy.h"
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "ipc/ipc_listener.h"
+#include "ipc/ipc_message.h"
+#include "ipc/ipc_message_macros.h"
+#include "ipc/ipc_message_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+
+namespace {
+
+Message* CreateMessage(uint32 message_class) {
+  return new Message(MSG_ROUTING_CONTROL,
+                     (message_class << 16) + 1,
+                     Message::PRIORITY_NORMAL);
+}
+
+// Counts the messages it is offered, and handles them if it was given a
+// message class.
+class CountingFilter : public ChannelProxy::MessageFilter {
+ public:
+  CountingFilter(bool has_message_class, uint32 message_class)
+      : has_message_class_(has_message_class),
+        message_class_(message_class),
+        messages_received_(0),
+        wrong_class_received_(false),
+        filter_added_(false, false) {
+  }
+
+  virtual void OnFilterAdded(Channel* channel) OVERRIDE {
+    filter_added_.Signal();
+  }
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    ++messages_received_;
+    if (!has_message_class_)
+      return false;
+    if (IPC_MESSAGE_ID_CLASS(message.type()) != message_class_)
+      wrong_class_received_ = true;
+    return true;
+  }
+
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE {
+    if (!has_message_class_)
+      return false;
+    supported_message_classes->push_back(message_class_);
+    return true;
+  }
+
+  void WaitUntilAdded() { filter_added_.Wait(); }
+
+  int messages_received() const { return messages_received_; }
+  bool wrong_class_received() const { return wrong_class_received_; }
+
+ private:
+  virtual ~CountingFilter() {}
+
+  bool has_message_class_;
+  uint32 message_class_;
+  int messages_received_;
+  bool wrong_class_received_;
+  base::WaitableEvent filter_added_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingFilter);
+};
+
+// Quits the message loop when a message reaches it.
+class QuitListener : public Listener {
+ public:
+  QuitListener() : messages_received_(0) {}
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    ++messages_received_;
+    MessageLoop::current()->QuitNow();
+    return true;
+  }
+
+  int messages_received() const { return messages_received_; }
+
+ private:
+  int messages_received_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuitListener);
+};
+
+class NullListener : public Listener {
+ public:
+  NullListener() {}
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    return true;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(NullListener);
+};
+
+}  // namespace
+
+// Checks that a filter which lists its message classes is only offered
+// messages of those classes, while other filters still see every message.
+TEST(IPCChannelProxyTest, MessageClassFilters) {
+  MessageLoopForIO message_loop;
+  base::Thread io_thread("ChannelProxyTestIOThread");
+  base::Thread::Options options;
+  options.message_loop_type = MessageLoop::TYPE_IO;
+  ASSERT_TRUE(io_thread.StartWithOptions(options));
+
+  std::string channel_id = Channel::GenerateUniqueRandomChannelID();
+  QuitListener server_listener;
+  scoped_ptr<ChannelProxy> server(new ChannelProxy(
+      channel_id, Channel::MODE_SERVER, &server_listener,
+      io_thread.message_loop_proxy()));
+
+  scoped_refptr<CountingFilter> global_filter(new CountingFilter(false, 0));
+  scoped_refptr<CountingFilter> test_filter(
+      new CountingFilter(true, TestMsgStart));
+  server->AddFilter(global_filter);
+  server->AddFilter(test_filter);
+  global_filter->WaitUntilAdded();
+  test_filter->WaitUntilAdded();
+
+  NullListener client_listener;
+  Channel client(channel_id, Channel::MODE_CLIENT, &client_listener);
+  ASSERT_TRUE(client.Connect());
+  client.Send(CreateMessage(TestMsgStart));
+  client.Send(CreateMessage(TestMsgStart));
+  // Not handled by any filter, so this one reaches the listener.
+  client.Send(CreateMessage(ViewMsgStart));
+  MessageLoop::current()->Run();
+
+  server.reset();
+  io_thread.Stop();
+
+  EXPECT_EQ(1, server_listener.messages_received());
+  EXPECT_EQ(3, global_filter->messages_received());
+  EXPECT_EQ(2, test_filter->messages_received());
+  EXPECT_FALSE(test_filter->wrong_class_received());
+}
+
+}  // namespace IPC
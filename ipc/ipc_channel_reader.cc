@@ -10,6 +10,15 @@
 namespace IPC {
 namespace internal {
 
+namespace {
+
+// The overflow buffer is released once it is empty if it grew larger than
+// this, so that one large message does not pin its memory for the lifetime
+// of the channel.
+const size_t kMaximumRetainedOverflowBufferSize = 64 * 1024;
+
+}  // namespace
+
 ChannelReader::ChannelReader(Listener* listener) : listener_(listener) {
   memset(input_buf_, 0, sizeof(input_buf_));
 }
@@ -42,6 +51,16 @@ bool ChannelReader::IsHelloMessage(const Message& m) const {
          m.type() == Channel::HELLO_MESSAGE_TYPE;
 }
 
+bool ChannelReader::IsOutOfLineMessage(const Message& m) const {
+  return m.routing_id() == MSG_ROUTING_NONE &&
+         m.type() == Channel::OUT_OF_LINE_MESSAGE_TYPE;
+}
+
+bool ChannelReader::DispatchOutOfLineMessage(const Message& msg) {
+  LOG(ERROR) << "Out of line IPC messages are not supported by this channel";
+  return false;
+}
+
 bool ChannelReader::DispatchInputData(const char* input_data,
                                       int input_data_len) {
   const char* p;
@@ -83,10 +102,14 @@ bool ChannelReader::DispatchInputData(const char* input_data,
                    "line", IPC_MESSAGE_ID_LINE(m.type()));
 #endif
       m.TraceMessageEnd();
-      if (IsHelloMessage(m))
+      if (IsHelloMessage(m)) {
         HandleHelloMessage(m);
-      else
+      } else if (IsOutOfLineMessage(m)) {
+        if (!DispatchOutOfLineMessage(m))
+          return false;
+      } else {
         listener_->OnMessageReceived(m);
+      }
       p = message_tail;
     } else {
       // Last message is partial.
@@ -94,11 +117,32 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     }
   }
 
-  // Save any partial data in the overflow buffer.
-  input_overflow_buf_.assign(p, end - p);
+  // Save any partial data in the overflow buffer. If the data already lives
+  // there, only drop the dispatched messages, so that a large message is not
+  // copied again for every read.
+  if (input_overflow_buf_.empty())
+    input_overflow_buf_.assign(p, end - p);
+  else
+    input_overflow_buf_.erase(0, p - input_overflow_buf_.data());
+
+  if (input_overflow_buf_.empty()) {
+    if (input_overflow_buf_.capacity() > kMaximumRetainedOverflowBufferSize)
+      std::string().swap(input_overflow_buf_);
+    return DidEmptyInputBuffers();
+  }
 
-  if (input_overflow_buf_.empty() && !DidEmptyInputBuffers())
+  // Once the size of the partial message is known, make room for all of it so
+  // that the buffer is not reallocated as the rest of it arrives.
+  size_t message_size = Message::PeekSize(
+      input_overflow_buf_.data(),
+      input_overflow_buf_.data() + input_overflow_buf_.size());
+  if (message_size > Channel::kMaximumMessageSize) {
+    input_overflow_buf_.clear();
+    LOG(ERROR) << "IPC message is too big";
     return false;
+  }
+  if (message_size > input_overflow_buf_.capacity())
+    input_overflow_buf_.reserve(message_size);
   return true;
 }
 
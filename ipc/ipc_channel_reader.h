@@ -7,6 +7,7 @@
 
 #include "base/basictypes.h"
 #include "ipc/ipc_channel.h"
+#include "ipc/ipc_export.h"
 
 namespace IPC {
 namespace internal {
@@ -23,7 +24,7 @@ namespace internal {
 // functionality that would benefit from being factored out. If we add
 // something like that in the future, it would be more appropriate to add it
 // here (and rename appropriately) rather than writing a different class.
-class ChannelReader {
+class IPC_EXPORT ChannelReader {
  public:
   explicit ChannelReader(Listener* listener);
   virtual ~ChannelReader();
@@ -46,6 +47,10 @@ class ChannelReader {
   // set-up.
   bool IsHelloMessage(const Message& m) const;
 
+  // Returns true if the given message wraps a large message stored out of
+  // line, see Channel::OUT_OF_LINE_MESSAGE_TYPE.
+  bool IsOutOfLineMessage(const Message& m) const;
+
  protected:
   enum ReadState { READ_SUCCEEDED, READ_FAILED, READ_PENDING };
 
@@ -79,6 +84,12 @@ class ChannelReader {
   // Handles the first message sent over the pipe which contains setup info.
   virtual void HandleHelloMessage(const Message& msg) = 0;
 
+  // Unwraps a message stored out of line and dispatches it to the listener.
+  // Returns false if the message could not be read, which is a fatal channel
+  // error. Channels that never send such messages can keep the default,
+  // which rejects them.
+  virtual bool DispatchOutOfLineMessage(const Message& msg);
+
  private:
   // Takes the given data received from the IPC channel and dispatches any
   // fully completed messages.
@@ -0,0 +1,134 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_channel_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ipc/ipc_listener.h"
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+class MockListener : public Listener {
+ public:
+  MockListener() {}
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    PickleIterator iter(message);
+    std::string payload;
+    EXPECT_TRUE(message.ReadString(&iter, &payload));
+    payloads_.push_back(payload);
+    return true;
+  }
+
+  const std::vector<std::string>& payloads() const { return payloads_; }
+
+ private:
+  std::vector<std::string> payloads_;
+
+  DISALLOW_COPY_AND_ASSIGN(MockListener);
+};
+
+// Hands out the given data in reads of at most |read_size| bytes.
+class MockChannelReader : public ChannelReader {
+ public:
+  MockChannelReader(Listener* listener, const std::string& data, int read_size)
+      : ChannelReader(listener),
+        data_(data),
+        read_size_(read_size),
+        offset_(0) {
+  }
+
+  virtual ReadState ReadData(char* buffer,
+                             int buffer_len,
+                             int* bytes_read) OVERRIDE {
+    if (offset_ == data_.size())
+      return READ_PENDING;
+    size_t len = std::min(data_.size() - offset_,
+                          static_cast<size_t>(std::min(buffer_len,
+                                                       read_size_)));
+    memcpy(buffer, data_.data() + offset_, len);
+    offset_ += len;
+    *bytes_read = static_cast<int>(len);
+    return READ_SUCCEEDED;
+  }
+
+  virtual bool WillDispatchInputMessage(Message* msg) OVERRIDE {
+    return true;
+  }
+
+  virtual bool DidEmptyInputBuffers() OVERRIDE {
+    return true;
+  }
+
+  virtual void HandleHelloMessage(const Message& msg) OVERRIDE {
+  }
+
+ private:
+  std::string data_;
+  int read_size_;
+  size_t offset_;
+
+  DISALLOW_COPY_AND_ASSIGN(MockChannelReader);
+};
+
+void AppendMessage(const std::string& payload, std::string* data) {
+  Message message(0, 1, Message::PRIORITY_NORMAL);
+  message.WriteString(payload);
+  data->append(static_cast<const char*>(message.data()), message.size());
+}
+
+}  // namespace
+
+// Checks that messages larger than the read buffer are put back together,
+// whether they are read in small or in buffer-sized pieces.
+TEST(ChannelReaderTest, LargeMessagesSpanningManyReads) {
+  const std::string kSmall(100, 'a');
+  const std::string kLarge(1024 * 1024, 'b');
+  std::string data;
+  AppendMessage(kSmall, &data);
+  AppendMessage(kLarge, &data);
+  AppendMessage(kSmall, &data);
+  AppendMessage(kLarge, &data);
+
+  const int kReadSizes[] = { 7, static_cast<int>(Channel::kReadBufferSize) };
+  for (size_t ii = 0; ii < arraysize(kReadSizes); ++ii) {
+    MockListener listener;
+    MockChannelReader reader(&listener, data, kReadSizes[ii]);
+    EXPECT_TRUE(reader.ProcessIncomingMessages());
+
+    ASSERT_EQ(4u, listener.payloads().size());
+    EXPECT_EQ(kSmall, listener.payloads()[0]);
+    EXPECT_EQ(kLarge, listener.payloads()[1]);
+    EXPECT_EQ(kSmall, listener.payloads()[2]);
+    EXPECT_EQ(kLarge, listener.payloads()[3]);
+  }
+}
+
+// Checks that a message announcing a size above the limit is rejected as soon
+// as its header is read.
+TEST(ChannelReaderTest, MessageTooBig) {
+  Message message(0, 1, Message::PRIORITY_NORMAL);
+  message.WriteInt(1);
+  std::string data(static_cast<const char*>(message.data()), message.size());
+  uint32 payload_size = Channel::kMaximumMessageSize;
+  memcpy(&data[0], &payload_size, sizeof(payload_size));
+
+  MockListener listener;
+  MockChannelReader reader(&listener, data, 7);
+  EXPECT_FALSE(reader.ProcessIncomingMessages());
+  EXPECT_TRUE(listener.payloads().empty());
+}
+
+}  // namespace internal
+}  // namespace IPC
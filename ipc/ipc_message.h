@@ -188,6 +188,12 @@ class IPC_EXPORT Message : public Pickle {
     return Pickle::FindNext(sizeof(Header), range_start, range_end);
   }
 
+  // Returns the size of the message that starts at range_start, or 0 if its
+  // header is not entirely in the given data range.
+  static size_t PeekSize(const char* range_start, const char* range_end) {
+    return Pickle::PeekSize(sizeof(Header), range_start, range_end);
+  }
+
 #if defined(OS_POSIX)
   // On POSIX, a message supports reading / writing FileDescriptor objects.
   // This is used to pass a file descriptor to the peer of an IPC channel.
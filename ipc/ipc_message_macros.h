@@ -144,6 +144,11 @@
 // Enum types are registered with a single IPC_ENUM_TRAITS() macro.  There
 // is no need to enumerate each value to the IPC mechanism.
 //
+// Plain structs whose members are all numbers, for which every bit pattern is
+// valid and which have no padding, can be registered with a single
+// IPC_STRUCT_TRAITS_POD() macro instead. They, and vectors of them, are then
+// copied as a block of bytes rather than member by member.
+//
 // Do not place semicolons following these IPC_ macro invocations.  There
 // is no reason to expect that their expansion corresponds one-to-one with
 // C++ statements.
@@ -14,6 +14,7 @@
 #undef IPC_STRUCT_TRAITS_MEMBER
 #undef IPC_STRUCT_TRAITS_PARENT
 #undef IPC_STRUCT_TRAITS_END
+#undef IPC_STRUCT_TRAITS_POD
 #undef IPC_ENUM_TRAITS
 #undef IPC_MESSAGE_DECL
 
@@ -25,6 +26,7 @@
 #define IPC_STRUCT_TRAITS_MEMBER(name)
 #define IPC_STRUCT_TRAITS_PARENT(type)
 #define IPC_STRUCT_TRAITS_END()
+#define IPC_STRUCT_TRAITS_POD(struct_name)
 #define IPC_ENUM_TRAITS(enum_name)
 #define IPC_MESSAGE_DECL(sync, kind, msg_class, \
                          in_cnt, out_cnt, in_list, out_list)
@@ -47,6 +47,15 @@ void LogBytes(const std::vector<CharType>& data, std::string* out) {
 #endif
 }
 
+// Returns a view of the bytes in |data|, which is empty when |data| is.
+template<typename CharType>
+base::StringPiece BytesAsStringPiece(const std::vector<CharType>& data) {
+  if (data.empty())
+    return base::StringPiece();
+  return base::StringPiece(reinterpret_cast<const char*>(&data.front()),
+                           data.size());
+}
+
 bool ReadValue(const Message* m, PickleIterator* iter, Value** value,
                int recursion);
 
@@ -374,23 +383,17 @@ void ParamTraits<string16>::Log(const param_type& p, std::string* l) {
 #endif
 
 void ParamTraits<std::vector<char> >::Write(Message* m, const param_type& p) {
-  if (p.empty()) {
-    m->WriteData(NULL, 0);
-  } else {
-    m->WriteData(&p.front(), static_cast<int>(p.size()));
-  }
+  base::StringPiece data = BytesAsStringPiece(p);
+  m->WriteData(data.data(), static_cast<int>(data.size()));
 }
 
 bool ParamTraits<std::vector<char> >::Read(const Message* m,
                                            PickleIterator* iter,
                                            param_type* r) {
-  const char *data;
-  int data_size = 0;
-  if (!m->ReadData(iter, &data, &data_size) || data_size < 0)
+  base::StringPiece data;
+  if (!m->ReadStringPiece(iter, &data))
     return false;
-  r->resize(data_size);
-  if (data_size)
-    memcpy(&r->front(), data, data_size);
+  r->assign(data.begin(), data.end());
   return true;
 }
 
@@ -400,24 +403,19 @@ void ParamTraits<std::vector<char> >::Log(const param_type& p, std::string* l) {
 
 void ParamTraits<std::vector<unsigned char> >::Write(Message* m,
                                                      const param_type& p) {
-  if (p.empty()) {
-    m->WriteData(NULL, 0);
-  } else {
-    m->WriteData(reinterpret_cast<const char*>(&p.front()),
-                 static_cast<int>(p.size()));
-  }
+  base::StringPiece data = BytesAsStringPiece(p);
+  m->WriteData(data.data(), static_cast<int>(data.size()));
 }
 
 bool ParamTraits<std::vector<unsigned char> >::Read(const Message* m,
                                                     PickleIterator* iter,
                                                     param_type* r) {
-  const char *data;
-  int data_size = 0;
-  if (!m->ReadData(iter, &data, &data_size) || data_size < 0)
+  base::StringPiece data;
+  if (!m->ReadStringPiece(iter, &data))
     return false;
-  r->resize(data_size);
-  if (data_size)
-    memcpy(&r->front(), data, data_size);
+  const unsigned char* bytes =
+      reinterpret_cast<const unsigned char*>(data.data());
+  r->assign(bytes, bytes + data.size());
   return true;
 }
 
@@ -751,6 +749,16 @@ void ParamTraits<Message>::Write(Message* m, const Message& p) {
   // could be 64-bit and the host browser could be 32-bits. The nested message
   // may or may not be safe to send between 32-bit and 64-bit systems, but we
   // leave that up to the code sending the message to ensure.
+  //
+  // The nested payload can be large, so size the writes up front and grow the
+  // message once.
+  PickleSizer sizer;
+  sizer.AddUInt32();
+  sizer.AddUInt32();
+  sizer.AddUInt32();
+  sizer.AddData(p.payload_size());
+  m->Reserve(sizer.payload_size());
+
   m->WriteUInt32(static_cast<uint32>(p.routing_id()));
   m->WriteUInt32(p.type());
   m->WriteUInt32(p.flags());
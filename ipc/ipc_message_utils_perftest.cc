@@ -0,0 +1,97 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_utils.h"
+
+#include <vector>
+
+#include "base/perftimer.h"
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+struct TestRect {
+  int32 x;
+  int32 y;
+  int32 width;
+  int32 height;
+};
+
+// The same struct, serialized member by member.
+struct TestMemberwiseRect {
+  int32 x;
+  int32 y;
+  int32 width;
+  int32 height;
+};
+
+}  // namespace
+
+namespace IPC {
+
+template <>
+struct IsPODParam<TestRect> {
+  static const bool value = true;
+};
+
+template <>
+struct ParamTraits<TestRect> : PODParamTraits<TestRect> {
+};
+
+template <>
+struct ParamTraits<TestMemberwiseRect> {
+  typedef TestMemberwiseRect param_type;
+  static void Write(Message* m, const param_type& p) {
+    WriteParam(m, p.x);
+    WriteParam(m, p.y);
+    WriteParam(m, p.width);
+    WriteParam(m, p.height);
+  }
+  static bool Read(const Message* m, PickleIterator* iter, param_type* r) {
+    return ReadParam(m, iter, &r->x) &&
+           ReadParam(m, iter, &r->y) &&
+           ReadParam(m, iter, &r->width) &&
+           ReadParam(m, iter, &r->height);
+  }
+  static void Log(const param_type& p, std::string* l) {
+  }
+};
+
+namespace {
+
+template <class Rect>
+void WriteAndReadRects(const char* name) {
+  const size_t kRectCount = 100000;
+  const int kIterations = 20;
+  std::vector<Rect> rects(kRectCount);
+  for (size_t i = 0; i < kRectCount; ++i) {
+    rects[i].x = i;
+    rects[i].y = 2 * i;
+    rects[i].width = 3 * i;
+    rects[i].height = 4 * i;
+  }
+
+  PerfTimeLogger logger(name);
+  for (int i = 0; i < kIterations; ++i) {
+    Message message(0, 1, Message::PRIORITY_NORMAL);
+    WriteParam(&message, rects);
+    PickleIterator iter(message);
+    std::vector<Rect> result;
+    ASSERT_TRUE(ReadParam(&message, &iter, &result));
+    ASSERT_EQ(kRectCount, result.size());
+  }
+  logger.Done();
+}
+
+}  // namespace
+
+// Compares the time taken to serialize POD structs as blocks of bytes and
+// member by member.
+TEST(IPCMessageUtilsPerfTest, PODStructs) {
+  WriteAndReadRects<TestRect>("IPC_PODStructVector");
+  WriteAndReadRects<TestMemberwiseRect>("IPC_MemberwiseStructVector");
+}
+
+}  // namespace IPC
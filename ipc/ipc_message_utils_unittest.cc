@@ -2,12 +2,51 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include "ipc/ipc_message.h"
 #include "ipc/ipc_message_utils.h"
+
+#include <vector>
+
+#include "ipc/ipc_message.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+struct TestRect {
+  int32 x;
+  int32 y;
+  int32 width;
+  int32 height;
+};
+
+}  // namespace
+
 namespace IPC {
 
+template <>
+struct IsPODParam<TestRect> {
+  static const bool value = true;
+};
+
+template <>
+struct ParamTraits<TestRect> : PODParamTraits<TestRect> {
+};
+
+namespace {
+
+template <class Rect>
+std::vector<Rect> CreateRects(size_t count) {
+  std::vector<Rect> rects(count);
+  for (size_t i = 0; i < count; ++i) {
+    rects[i].x = i;
+    rects[i].y = 2 * i;
+    rects[i].width = 3 * i;
+    rects[i].height = 4 * i;
+  }
+  return rects;
+}
+
+}  // namespace
+
 // Tests nesting of messages as parameters to other messages.
 TEST(IPCMessageUtilsTest, NestedMessages) {
   int32 nested_routing = 12;
@@ -50,4 +89,44 @@ TEST(IPCMessageUtilsTest, NestedMessages) {
                                       &result_content));
 }
 
+// Tests that POD structs and vectors of them are copied as blocks of bytes.
+TEST(IPCMessageUtilsTest, PODStructs) {
+  TestRect rect = { 1, 2, 3, 4 };
+  std::vector<TestRect> rects = CreateRects<TestRect>(10);
+  std::vector<TestRect> empty_rects;
+
+  Message message(0, 1, Message::PRIORITY_NORMAL);
+  size_t header_size = message.size();
+  WriteParam(&message, rect);
+  WriteParam(&message, rects);
+  WriteParam(&message, empty_rects);
+  EXPECT_EQ(sizeof(TestRect) * 11 + sizeof(int) * 2,
+            message.size() - header_size);
+
+  PickleIterator iter(message);
+  TestRect result_rect;
+  std::vector<TestRect> result_rects;
+  std::vector<TestRect> result_empty_rects(5);
+  ASSERT_TRUE(ReadParam(&message, &iter, &result_rect));
+  ASSERT_TRUE(ReadParam(&message, &iter, &result_rects));
+  ASSERT_TRUE(ReadParam(&message, &iter, &result_empty_rects));
+  EXPECT_EQ(0, memcmp(&rect, &result_rect, sizeof(rect)));
+  ASSERT_EQ(rects.size(), result_rects.size());
+  EXPECT_EQ(0, memcmp(&rects[0], &result_rects[0],
+                      rects.size() * sizeof(TestRect)));
+  EXPECT_TRUE(result_empty_rects.empty());
+}
+
+// Tests that a vector of POD structs longer than the message is rejected.
+TEST(IPCMessageUtilsTest, PODStructsTruncated) {
+  std::vector<TestRect> rects = CreateRects<TestRect>(10);
+  Message message(0, 1, Message::PRIORITY_NORMAL);
+  WriteParam(&message, static_cast<int>(rects.size() + 1));
+  message.WriteBytes(&rects[0], rects.size() * sizeof(TestRect));
+
+  PickleIterator iter(message);
+  std::vector<TestRect> result;
+  EXPECT_FALSE(ReadParam(&message, &iter, &result));
+}
+
 }  // namespace IPC
@@ -18,6 +18,13 @@ struct SimilarTypeTraits {
   typedef P Type;
 };
 
+// True for the types registered with IPC_STRUCT_TRAITS_POD, which are
+// serialized as a single block of bytes.
+template <class P>
+struct IsPODParam {
+  static const bool value = false;
+};
+
 }  // namespace IPC
 
 #endif  // IPC_IPC_PARAM_TRAITS_H_
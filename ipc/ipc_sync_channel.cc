@@ -9,6 +9,7 @@
 #include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/sys_info.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/synchronization/waitable_event_watcher.h"
 #include "base/thread_task_runner_handle.h"
@@ -22,6 +23,16 @@ using base::TimeTicks;
 using base::WaitableEvent;
 
 namespace IPC {
+
+namespace {
+
+// How long a thread blocked in Send() polls for the reply before going to
+// sleep. Most replies from a busy peer arrive well within this time, and
+// polling saves the two context switches of a blocking wait.
+const int kSpinBeforeWaitMicroseconds = 50;
+
+}  // namespace
+
 // When we're blocked in a Send(), we need to process incoming synchronous
 // messages right away because it could be blocking our reply (either
 // directly from the same object we're calling, or indirectly through one or
@@ -158,18 +169,26 @@ class SyncChannel::ReceivedSyncMsgQueue :
       lazy_tls_ptr_;
 
   // Called on the ipc thread to check if we can unblock any current Send()
-  // calls based on a queued reply.
+  // calls based on the queued replies. All the replies that can be delivered
+  // are, so that the listener thread does not need a round trip through the
+  // ipc thread for each of them.
   void DispatchReplies() {
-    for (size_t i = 0; i < received_replies_.size(); ++i) {
+    size_t i = 0;
+    while (i < received_replies_.size()) {
       Message* message = received_replies_[i].message;
       if (received_replies_[i].context->TryToUnblockListener(message)) {
         delete message;
         received_replies_.erase(received_replies_.begin() + i);
-        return;
+      } else {
+        ++i;
       }
     }
   }
 
+  // Whether a thread blocked in Send() should poll for a while before
+  // waiting. Only useful if the peer can run at the same time.
+  bool spin_before_wait() const { return spin_before_wait_; }
+
   base::WaitableEventWatcher* top_send_done_watcher() {
     return top_send_done_watcher_;
   }
@@ -189,7 +208,8 @@ class SyncChannel::ReceivedSyncMsgQueue :
       listener_task_runner_(base::ThreadTaskRunnerHandle::Get()),
       task_pending_(false),
       listener_count_(0),
-      top_send_done_watcher_(NULL) {
+      top_send_done_watcher_(NULL),
+      spin_before_wait_(base::SysInfo::NumberOfProcessors() > 1) {
   }
 
   ~ReceivedSyncMsgQueue() {}
@@ -220,6 +240,8 @@ class SyncChannel::ReceivedSyncMsgQueue :
   // a local global stack of send done watchers to ensure that nested sync
   // message loops complete correctly.
   base::WaitableEventWatcher* top_send_done_watcher_;
+
+  bool spin_before_wait_;
 };
 
 base::LazyInstance<base::ThreadLocalPointer<SyncChannel::ReceivedSyncMsgQueue> >
@@ -492,7 +514,11 @@ void SyncChannel::WaitForReply(
     };
 
     unsigned count = pump_messages_event ? 3: 2;
-    size_t result = WaitableEvent::WaitMany(objects, count);
+    size_t result = count;
+    if (context->received_sync_msgs()->spin_before_wait())
+      result = SpinForEvents(objects, count);
+    if (result == count)
+      result = WaitableEvent::WaitMany(objects, count);
     if (result == 0 /* dispatch event */) {
       // We're waiting for a reply, but we received a blocking synchronous
       // call.  We must process it or otherwise a deadlock might occur.
@@ -508,6 +534,18 @@ void SyncChannel::WaitForReply(
   }
 }
 
+size_t SyncChannel::SpinForEvents(WaitableEvent** waitables, size_t count) {
+  TimeTicks deadline = TimeTicks::Now() +
+      TimeDelta::FromMicroseconds(kSpinBeforeWaitMicroseconds);
+  do {
+    for (size_t i = 0; i < count; ++i) {
+      if (waitables[i]->IsSignaled())
+        return i;
+    }
+  } while (TimeTicks::Now() < deadline);
+  return count;
+}
+
 void SyncChannel::WaitForReplyWithNestedMessageLoop(SyncContext* context) {
   base::WaitableEventWatcher send_done_watcher;
 
@@ -206,6 +206,10 @@ class IPC_EXPORT SyncChannel : public ChannelProxy,
   static void WaitForReply(
       SyncContext* context, base::WaitableEvent* pump_messages_event);
 
+  // Polls |waitables| for a short while, and returns the index of the first
+  // one found signaled, or |count| if none was.
+  static size_t SpinForEvents(base::WaitableEvent** waitables, size_t count);
+
   // Runs a nested message loop until a reply arrives, times out, or the process
   // shuts down.
   static void WaitForReplyWithNestedMessageLoop(SyncContext* context);
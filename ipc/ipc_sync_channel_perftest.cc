@@ -0,0 +1,163 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_sync_channel.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "ipc/ipc_listener.h"
+#include "ipc/ipc_message.h"
+#include "ipc/ipc_message_utils.h"
+#include "ipc/ipc_sender.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#define IPC_MESSAGE_IMPL
+#include "ipc/ipc_sync_message_unittest.h"
+
+using base::WaitableEvent;
+
+namespace IPC {
+
+namespace {
+
+const int kRoundTrips = 1000;
+
+// One end of a sync channel, created and destroyed on its own listener
+// thread. Answers SyncChannelTestMsg_AnswerToLife with 42.
+class ChannelEnd : public Listener, public Sender {
+ public:
+  ChannelEnd(const std::string& channel_name,
+             Channel::Mode mode,
+             const char* thread_name,
+             base::Thread* ipc_thread)
+      : channel_name_(channel_name),
+        mode_(mode),
+        ipc_thread_(ipc_thread),
+        listener_thread_(thread_name),
+        shutdown_event_(true, false) {
+  }
+
+  void Start() {
+    listener_thread_.Start();
+    WaitableEvent created(false, false);
+    listener_thread_.message_loop()->PostTask(
+        FROM_HERE, base::Bind(&ChannelEnd::CreateChannel,
+                              base::Unretained(this), &created));
+    created.Wait();
+  }
+
+  void Stop() {
+    listener_thread_.message_loop()->PostTask(
+        FROM_HERE, base::Bind(&ChannelEnd::DestroyChannel,
+                              base::Unretained(this)));
+    listener_thread_.Stop();
+  }
+
+  // Sends |round_trips| sync messages back to back from the listener thread
+  // and logs the total time.
+  void TimeRoundTrips(bool pump_during_send, int round_trips) {
+    WaitableEvent done(false, false);
+    listener_thread_.message_loop()->PostTask(
+        FROM_HERE, base::Bind(&ChannelEnd::SendRoundTrips,
+                              base::Unretained(this), pump_during_send,
+                              round_trips, &done));
+    done.Wait();
+  }
+
+  virtual bool Send(Message* msg) OVERRIDE {
+    return channel_->Send(msg);
+  }
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    IPC_BEGIN_MESSAGE_MAP(ChannelEnd, message)
+      IPC_MESSAGE_HANDLER_DELAY_REPLY(SyncChannelTestMsg_AnswerToLife,
+                                      OnAnswerToLife)
+    IPC_END_MESSAGE_MAP()
+    return true;
+  }
+
+ private:
+  void CreateChannel(WaitableEvent* created) {
+    channel_.reset(new SyncChannel(
+        channel_name_, mode_, this, ipc_thread_->message_loop_proxy(), true,
+        &shutdown_event_));
+    created->Signal();
+  }
+
+  void DestroyChannel() {
+    channel_.reset();
+  }
+
+  void SendRoundTrips(bool pump_during_send, int round_trips,
+                      WaitableEvent* done) {
+    PerfTimeLogger logger(pump_during_send ? "IPC_SyncRoundTrip_Pump" :
+                                             "IPC_SyncRoundTrip");
+    for (int i = 0; i < round_trips; ++i) {
+      int answer = 0;
+      SyncMessage* msg = new SyncChannelTestMsg_AnswerToLife(&answer);
+      if (pump_during_send)
+        msg->EnableMessagePumping();
+      bool sent = Send(msg);
+      EXPECT_TRUE(sent);
+      EXPECT_EQ(42, answer);
+      if (!sent)
+        break;
+    }
+    logger.Done();
+    done->Signal();
+  }
+
+  void OnAnswerToLife(Message* reply_msg) {
+    SyncChannelTestMsg_AnswerToLife::WriteReplyParams(reply_msg, 42);
+    Send(reply_msg);
+  }
+
+  std::string channel_name_;
+  Channel::Mode mode_;
+  base::Thread* ipc_thread_;
+  base::Thread listener_thread_;
+  WaitableEvent shutdown_event_;
+  scoped_ptr<SyncChannel> channel_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChannelEnd);
+};
+
+// Times sync message round trips, where the latency of waking up the blocked
+// sender matters most.
+void RoundTrip(bool pump_during_send) {
+  base::Thread ipc_thread("sync_round_trip_ipc");
+  base::Thread::Options options;
+  options.message_loop_type = MessageLoop::TYPE_IO;
+  ASSERT_TRUE(ipc_thread.StartWithOptions(options));
+
+  ChannelEnd server("sync_round_trip", Channel::MODE_SERVER,
+                    "round_trip_server", &ipc_thread);
+  ChannelEnd client("sync_round_trip", Channel::MODE_CLIENT,
+                    "round_trip_client", &ipc_thread);
+  server.Start();
+  client.Start();
+
+  server.TimeRoundTrips(pump_during_send, kRoundTrips);
+
+  // The IPC thread has to outlive both channels.
+  client.Stop();
+  server.Stop();
+  ipc_thread.Stop();
+}
+
+}  // namespace
+
+TEST(IPCSyncChannelPerfTest, RoundTripLatency) {
+  RoundTrip(false);
+  RoundTrip(true);
+}
+
+}  // namespace IPC
@@ -922,6 +922,60 @@ TEST_F(IPCSyncChannelTest, ChattyServer) {
 
 namespace {
 
+class RoundTripServer : public Worker {
+ public:
+  RoundTripServer(bool pump_during_send, int round_trips)
+      : Worker(Channel::MODE_SERVER, "round_trip_server"),
+        pump_during_send_(pump_during_send),
+        round_trips_(round_trips) { }
+
+  void Run() {
+    for (int i = 0; i < round_trips_; ++i) {
+      if (!SendAnswerToLife(pump_during_send_, base::kNoTimeout, true))
+        break;
+    }
+    Done();
+  }
+
+  bool pump_during_send_;
+  int round_trips_;
+};
+
+class RoundTripClient : public Worker {
+ public:
+  explicit RoundTripClient(int round_trips)
+      : Worker(Channel::MODE_CLIENT, "round_trip_client"),
+        round_trips_(round_trips) { }
+
+  void OnAnswer(int* answer) {
+    *answer = 42;
+    if (--round_trips_ == 0)
+      Done();
+  }
+
+  int round_trips_;
+};
+
+void RoundTrip(bool pump_during_send) {
+  std::vector<Worker*> workers;
+  const int kRoundTrips = 100;
+  workers.push_back(new RoundTripServer(pump_during_send, kRoundTrips));
+  workers.push_back(new RoundTripClient(kRoundTrips));
+  RunTest(workers);
+}
+
+}  // namespace
+
+// Tests that back to back sync messages each get their reply.
+TEST_F(IPCSyncChannelTest, RoundTrips) {
+  RoundTrip(false);
+  RoundTrip(true);
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
 class TimeoutServer : public Worker {
  public:
   TimeoutServer(int timeout_ms,
@@ -44,6 +44,12 @@
     l->append(")"); \
   }
 
+#undef IPC_STRUCT_TRAITS_POD
+#define IPC_STRUCT_TRAITS_POD(struct_name) \
+  void ParamTraits<struct_name>::Log(const param_type& p, std::string* l) { \
+    PODParamTraits<struct_name>::Log(p, l); \
+  }
+
 #undef IPC_ENUM_TRAITS
 #define IPC_ENUM_TRAITS(enum_name) \
   void ParamTraits<enum_name>::Log(const param_type& p, std::string* l) { \
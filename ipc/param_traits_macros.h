@@ -24,6 +24,21 @@
 #define IPC_STRUCT_TRAITS_END()
 
 // Traits generation for enums.
+#define IPC_STRUCT_TRAITS_POD(struct_name) \
+  namespace IPC { \
+    template <> \
+    struct IsPODParam<struct_name> { \
+      static const bool value = true; \
+    }; \
+    template <> \
+    struct IPC_MESSAGE_EXPORT ParamTraits<struct_name> { \
+      typedef struct_name param_type; \
+      static void Write(Message* m, const param_type& p); \
+      static bool Read(const Message* m, PickleIterator* iter, param_type* p); \
+      static void Log(const param_type& p, std::string* l); \
+    }; \
+  }
+
 #define IPC_ENUM_TRAITS(enum_name) \
   namespace IPC { \
     template <> \
@@ -32,6 +32,13 @@
 #define IPC_STRUCT_TRAITS_PARENT(type) ParamTraits<type>::Read(m, iter, p) &&
 #define IPC_STRUCT_TRAITS_END() 1; }
 
+#undef IPC_STRUCT_TRAITS_POD
+#define IPC_STRUCT_TRAITS_POD(struct_name) \
+  bool ParamTraits<struct_name>:: \
+      Read(const Message* m, PickleIterator* iter, param_type* p) { \
+    return PODParamTraits<struct_name>::Read(m, iter, p); \
+  }
+
 #undef IPC_ENUM_TRAITS
 #define IPC_ENUM_TRAITS(enum_name) \
   bool ParamTraits<enum_name>:: \
@@ -30,6 +30,12 @@
 #define IPC_STRUCT_TRAITS_PARENT(type) ParamTraits<type>::Write(m, p);
 #define IPC_STRUCT_TRAITS_END() }
 
+#undef IPC_STRUCT_TRAITS_POD
+#define IPC_STRUCT_TRAITS_POD(struct_name) \
+  void ParamTraits<struct_name>::Write(Message* m, const param_type& p) { \
+    PODParamTraits<struct_name>::Write(m, p); \
+  }
+
 #undef IPC_ENUM_TRAITS
 #define IPC_ENUM_TRAITS(enum_name) \
   void ParamTraits<enum_name>::Write(Message* m, const param_type& p) { \
@@ -4,9 +4,12 @@
 
 #include "media/base/audio_renderer_mixer.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/logging.h"
+#include "base/threading/platform_thread.h"
 #include "media/audio/audio_util.h"
 #include "media/base/limits.h"
 #include "media/base/vector_math.h"
@@ -17,6 +20,10 @@ AudioRendererMixer::AudioRendererMixer(
     const AudioParameters& input_params, const AudioParameters& output_params,
     const scoped_refptr<AudioRendererSink>& sink)
     : audio_sink_(sink),
+      mixer_inputs_(reinterpret_cast<base::subtle::AtomicWord>(
+          new MixerInputList())),
+      read_generation_(0),
+      glitch_count_(0),
       current_audio_delay_milliseconds_(0) {
   // Sanity check sample rates.
   DCHECK_LE(input_params.sample_rate(), limits::kMaxSampleRate);
@@ -43,19 +50,71 @@ AudioRendererMixer::~AudioRendererMixer() {
 
   // Ensures that all mixer inputs have stopped themselves prior to destruction
   // and have called RemoveMixerInput().
-  DCHECK_EQ(mixer_inputs_.size(), 0U);
+  scoped_ptr<MixerInputList> inputs(reinterpret_cast<MixerInputList*>(
+      base::subtle::NoBarrier_Load(&mixer_inputs_)));
+  DCHECK_EQ(inputs->size(), 0U);
 }
 
 void AudioRendererMixer::AddMixerInput(
     const scoped_refptr<AudioRendererMixerInput>& input) {
   base::AutoLock auto_lock(mixer_inputs_lock_);
-  mixer_inputs_.insert(input);
+  const MixerInputList* inputs = reinterpret_cast<const MixerInputList*>(
+      base::subtle::NoBarrier_Load(&mixer_inputs_));
+  DCHECK(std::find(inputs->begin(), inputs->end(), input) == inputs->end());
+
+  scoped_ptr<MixerInputList> new_inputs(new MixerInputList(*inputs));
+  new_inputs->push_back(input);
+  SwapMixerInputs(new_inputs.Pass());
 }
 
 void AudioRendererMixer::RemoveMixerInput(
     const scoped_refptr<AudioRendererMixerInput>& input) {
   base::AutoLock auto_lock(mixer_inputs_lock_);
-  mixer_inputs_.erase(input);
+  const MixerInputList* inputs = reinterpret_cast<const MixerInputList*>(
+      base::subtle::NoBarrier_Load(&mixer_inputs_));
+
+  scoped_ptr<MixerInputList> new_inputs(new MixerInputList(*inputs));
+  new_inputs->erase(
+      std::remove(new_inputs->begin(), new_inputs->end(), input),
+      new_inputs->end());
+  SwapMixerInputs(new_inputs.Pass());
+}
+
+int AudioRendererMixer::glitch_count() const {
+  return base::subtle::NoBarrier_Load(&glitch_count_);
+}
+
+void AudioRendererMixer::SwapMixerInputs(
+    scoped_ptr<MixerInputList> new_inputs) {
+  mixer_inputs_lock_.AssertAcquired();
+
+  scoped_ptr<MixerInputList> old_inputs(reinterpret_cast<MixerInputList*>(
+      base::subtle::NoBarrier_Load(&mixer_inputs_)));
+  base::subtle::Release_Store(
+      &mixer_inputs_,
+      reinterpret_cast<base::subtle::AtomicWord>(new_inputs.release()));
+  base::subtle::MemoryBarrier();
+
+  // A read that began before the store above may still be using
+  // |old_inputs|; wait for it to finish.  Reads that begin after the store
+  // will see the new list.  Reads are short, so yielding is cheap enough.
+  base::subtle::Atomic32 generation =
+      base::subtle::Acquire_Load(&read_generation_);
+  if (generation & 1) {
+    while (base::subtle::Acquire_Load(&read_generation_) == generation)
+      base::PlatformThread::YieldCurrentThread();
+  }
+}
+
+const AudioRendererMixer::MixerInputList*
+AudioRendererMixer::BeginReadingMixerInputs() {
+  base::subtle::Barrier_AtomicIncrement(&read_generation_, 1);
+  return reinterpret_cast<const MixerInputList*>(
+      base::subtle::Acquire_Load(&mixer_inputs_));
+}
+
+void AudioRendererMixer::EndReadingMixerInputs() {
+  base::subtle::Barrier_AtomicIncrement(&read_generation_, 1);
 }
 
 int AudioRendererMixer::Render(AudioBus* audio_bus,
@@ -73,8 +132,6 @@ int AudioRendererMixer::Render(AudioBus* audio_bus,
 }
 
 void AudioRendererMixer::ProvideInput(AudioBus* audio_bus) {
-  base::AutoLock auto_lock(mixer_inputs_lock_);
-
   // Allocate staging area for each mixer input's audio data on first call.  We
   // won't know how much to allocate until here because of resampling.  Ensure
   // our intermediate AudioBus is sized exactly as the original.  Resize should
@@ -94,8 +151,9 @@ void AudioRendererMixer::ProvideInput(AudioBus* audio_bus) {
   audio_bus->Zero();
 
   // Have each mixer render its data into an output buffer then mix the result.
-  for (AudioRendererMixerInputSet::iterator it = mixer_inputs_.begin();
-       it != mixer_inputs_.end(); ++it) {
+  const MixerInputList* inputs = BeginReadingMixerInputs();
+  for (MixerInputList::const_iterator it = inputs->begin();
+       it != inputs->end(); ++it) {
     const scoped_refptr<AudioRendererMixerInput>& input = *it;
 
     double volume;
@@ -107,6 +165,8 @@ void AudioRendererMixer::ProvideInput(AudioBus* audio_bus) {
 
     int frames_filled = input->callback()->Render(
         mixer_input_audio_bus_.get(), current_audio_delay_milliseconds_);
+    if (frames_filled < mixer_input_audio_bus_->frames())
+      base::subtle::NoBarrier_AtomicIncrement(&glitch_count_, 1);
     if (frames_filled == 0)
       continue;
 
@@ -117,14 +177,19 @@ void AudioRendererMixer::ProvideInput(AudioBus* audio_bus) {
           audio_bus->channel(i));
     }
   }
+  EndReadingMixerInputs();
 }
 
 void AudioRendererMixer::OnRenderError() {
+  // Called on a thread other than the audio thread, so the list is read under
+  // |mixer_inputs_lock_|; BeginReadingMixerInputs() supports a single reader.
   base::AutoLock auto_lock(mixer_inputs_lock_);
+  const MixerInputList* inputs = reinterpret_cast<const MixerInputList*>(
+      base::subtle::NoBarrier_Load(&mixer_inputs_));
 
   // Call each mixer input and signal an error.
-  for (AudioRendererMixerInputSet::iterator it = mixer_inputs_.begin();
-       it != mixer_inputs_.end(); ++it) {
+  for (MixerInputList::const_iterator it = inputs->begin();
+       it != inputs->end(); ++it) {
     (*it)->callback()->OnRenderError();
   }
 }
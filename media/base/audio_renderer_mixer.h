@@ -5,8 +5,9 @@
 #ifndef MEDIA_BASE_AUDIO_RENDERER_MIXER_H_
 #define MEDIA_BASE_AUDIO_RENDERER_MIXER_H_
 
-#include <set>
+#include <vector>
 
+#include "base/atomicops.h"
 #include "base/synchronization/lock.h"
 #include "media/base/audio_renderer_mixer_input.h"
 #include "media/base/audio_renderer_sink.h"
@@ -31,7 +32,14 @@ class MEDIA_EXPORT AudioRendererMixer
   void AddMixerInput(const scoped_refptr<AudioRendererMixerInput>& input);
   void RemoveMixerInput(const scoped_refptr<AudioRendererMixerInput>& input);
 
+  // Returns the number of times a playing mixer input provided fewer frames
+  // than were requested of it, each of which is an audible glitch.  Safe to
+  // call from any thread.
+  int glitch_count() const;
+
  private:
+  typedef std::vector< scoped_refptr<AudioRendererMixerInput> >
+      MixerInputList;
   // AudioRendererSink::RenderCallback implementation.
   virtual int Render(AudioBus* audio_bus,
                      int audio_delay_milliseconds) OVERRIDE;
@@ -42,16 +50,35 @@ class MEDIA_EXPORT AudioRendererMixer
   // by MultiChannelResampler when more data is necessary.
   void ProvideInput(AudioBus* audio_bus);
 
+  // Brackets each use of the current mixer input list on the audio thread.
+  // The returned list stays valid until EndReadingMixerInputs().  Only one
+  // thread may read this way; other threads read under |mixer_inputs_lock_|.
+  const MixerInputList* BeginReadingMixerInputs();
+  void EndReadingMixerInputs();
+
+  // Publishes |new_inputs| as the current mixer input list, then waits for
+  // any reader of the previous list to finish before deleting it.  Must be
+  // called with |mixer_inputs_lock_| held.
+  void SwapMixerInputs(scoped_ptr<MixerInputList> new_inputs);
+
   // Output sink for this mixer.
   scoped_refptr<AudioRendererSink> audio_sink_;
 
-  // Set of mixer inputs to be mixed by this mixer.  Access is thread-safe
-  // through |mixer_inputs_lock_|.
-  typedef std::set< scoped_refptr<AudioRendererMixerInput> >
-      AudioRendererMixerInputSet;
-  AudioRendererMixerInputSet mixer_inputs_;
+  // Immutable list of mixer inputs to be mixed by this mixer, stored as a
+  // MixerInputList*.  AddMixerInput() and RemoveMixerInput() replace it with
+  // an updated copy under |mixer_inputs_lock_|; the audio thread reads it
+  // without locking so that it never blocks behind them.
+  base::subtle::AtomicWord mixer_inputs_;
   base::Lock mixer_inputs_lock_;
 
+  // Incremented on entry to and exit from each read of |mixer_inputs_| by the
+  // audio thread, so it is odd while a read is in progress.  This relies on
+  // the audio thread being the only lock-free reader.
+  base::subtle::Atomic32 read_generation_;
+
+  // Number of glitches seen so far; see glitch_count().
+  base::subtle::Atomic32 glitch_count_;
+
   // Vector for rendering audio data from each mixer input.
   scoped_ptr<AudioBus> mixer_input_audio_bus_;
 
@@ -192,6 +192,9 @@ class AudioRendererMixerTest
     for (int i = 0; i < kMixerCycles; ++i)
       ASSERT_TRUE(RenderAndValidateAudioData(mixer_inputs_.size()));
 
+    // Every input fulfilled every request, so nothing should have glitched.
+    EXPECT_EQ(0, mixer_->glitch_count());
+
     for (size_t i = 0; i < mixer_inputs_.size(); ++i)
       mixer_inputs_[i]->Stop();
   }
@@ -232,6 +235,9 @@ class AudioRendererMixerTest
     half_fill_ = true;
     ASSERT_TRUE(RenderAndValidateAudioData(mixer_inputs_.size()));
 
+    // Each input should have glitched at least once.
+    EXPECT_GE(mixer_->glitch_count(), static_cast<int>(mixer_inputs_.size()));
+
     for (size_t i = 0; i < mixer_inputs_.size(); ++i)
       mixer_inputs_[i]->Stop();
   }
@@ -54,6 +54,8 @@ const char* MediaLog::EventTypeToString(MediaLogEvent::Type type) {
       return "AUDIO_RENDERER_DISABLED";
     case MediaLogEvent::BUFFERED_EXTENTS_CHANGED:
       return "BUFFERED_EXTENTS_CHANGED";
+    case MediaLogEvent::SOURCE_BUFFER_GARBAGE_COLLECTED:
+      return "SOURCE_BUFFER_GARBAGE_COLLECTED";
   }
   NOTREACHED();
   return NULL;
@@ -178,4 +180,14 @@ scoped_ptr<MediaLogEvent> MediaLog::CreateBufferedExtentsChangedEvent(
   return event.Pass();
 }
 
+scoped_ptr<MediaLogEvent> MediaLog::CreateSourceBufferGarbageCollectedEvent(
+    const std::string& stream_type, int bytes_freed, int bytes_buffered) {
+  scoped_ptr<MediaLogEvent> event(
+      CreateEvent(MediaLogEvent::SOURCE_BUFFER_GARBAGE_COLLECTED));
+  event->params.SetString("stream_type", stream_type);
+  event->params.SetInteger("bytes_freed", bytes_freed);
+  event->params.SetInteger("bytes_buffered", bytes_buffered);
+  return event.Pass();
+}
+
 }  //namespace media
@@ -43,6 +43,8 @@ class MEDIA_EXPORT MediaLog : public base::RefCountedThreadSafe<MediaLog> {
       size_t width, size_t height);
   scoped_ptr<MediaLogEvent> CreateBufferedExtentsChangedEvent(
       size_t start, size_t current, size_t end);
+  scoped_ptr<MediaLogEvent> CreateSourceBufferGarbageCollectedEvent(
+      const std::string& stream_type, int bytes_freed, int bytes_buffered);
 
  protected:
   friend class base::RefCountedThreadSafe<MediaLog>;
@@ -68,6 +68,13 @@ struct MediaLogEvent {
     //         "buffer_current": <current offset>.
     //         "buffer_end": <last buffered byte>.
     BUFFERED_EXTENTS_CHANGED,
+
+    // A media source stream has garbage collected buffered data to stay
+    // within its memory limit.
+    // params: "stream_type": <"audio" or "video">.
+    //         "bytes_freed": <bytes evicted by this collection>.
+    //         "bytes_buffered": <bytes still buffered by the stream>.
+    SOURCE_BUFFER_GARBAGE_COLLECTED,
   };
 
   int32 id;
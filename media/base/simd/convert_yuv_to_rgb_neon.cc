@@ -0,0 +1,143 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/yuv_to_rgb_table.h"
+#include "media/base/yuv_convert.h"
+
+namespace {
+
+// Converts two pixels that share a chroma sample, the same way the MMX
+// kernels do: the table entries for u, v and y are added with signed
+// saturation, shifted down by 6 and packed with unsigned saturation. The
+// output is identical to ConvertYUVToRGB32Row_C().
+inline void ConvertTwoPixels(uint8 y0, uint8 y1, uint8 u, uint8 v,
+                             uint8* rgb_buf) {
+  int16x4_t uv = vqadd_s16(vld1_s16(kCoefficientsRgbY[256 + u]),
+                           vld1_s16(kCoefficientsRgbY[512 + v]));
+  int16x8_t pixels =
+      vcombine_s16(vqadd_s16(uv, vld1_s16(kCoefficientsRgbY[y0])),
+                   vqadd_s16(uv, vld1_s16(kCoefficientsRgbY[y1])));
+  vst1_u8(rgb_buf, vqmovun_s16(vshrq_n_s16(pixels, 6)));
+}
+
+// Converts the last pixel of an odd width row.
+inline void ConvertOnePixel(uint8 y, uint8 u, uint8 v, uint8* rgb_buf) {
+  int16x4_t uv = vqadd_s16(vld1_s16(kCoefficientsRgbY[256 + u]),
+                           vld1_s16(kCoefficientsRgbY[512 + v]));
+  int16x4_t pixel = vqadd_s16(uv, vld1_s16(kCoefficientsRgbY[y]));
+  uint8x8_t packed = vqmovun_s16(vshrq_n_s16(vcombine_s16(pixel, pixel), 6));
+  vst1_lane_u32(reinterpret_cast<uint32*>(rgb_buf),
+                vreinterpret_u32_u8(packed), 0);
+}
+
+}  // namespace
+
+extern "C" {
+
+void ConvertYUVToRGB32Row_NEON(const uint8* y_buf,
+                               const uint8* u_buf,
+                               const uint8* v_buf,
+                               uint8* rgb_buf,
+                               int width) {
+  int x = 0;
+  for (; x + 1 < width; x += 2) {
+    ConvertTwoPixels(y_buf[x], y_buf[x + 1], u_buf[x >> 1], v_buf[x >> 1],
+                     rgb_buf);
+    rgb_buf += 8;
+  }
+  if (x < width)
+    ConvertOnePixel(y_buf[x], u_buf[x >> 1], v_buf[x >> 1], rgb_buf);
+}
+
+// See ScaleYUVToRGB32Row_C() for the meaning of the 16.16 fixed point
+// |source_dx|. Both pixels of a pair use the chroma of the first one.
+void ScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             int width,
+                             int source_dx) {
+  int x = 0;
+  int i = 0;
+  for (; i + 1 < width; i += 2) {
+    uint8 u = u_buf[x >> 17];
+    uint8 v = v_buf[x >> 17];
+    uint8 y0 = y_buf[x >> 16];
+    x += source_dx;
+    uint8 y1 = y_buf[x >> 16];
+    x += source_dx;
+    ConvertTwoPixels(y0, y1, u, v, rgb_buf);
+    rgb_buf += 8;
+  }
+  if (i < width)
+    ConvertOnePixel(y_buf[x >> 16], u_buf[x >> 17], v_buf[x >> 17], rgb_buf);
+}
+
+void LinearScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                                   const uint8* u_buf,
+                                   const uint8* v_buf,
+                                   uint8* rgb_buf,
+                                   int width,
+                                   int source_dx) {
+  // Avoid point-sampling for down-scaling by > 2:1.
+  int x = 0;
+  if (source_dx >= 0x20000)
+    x += 0x8000;
+
+  for (int i = 0; i < width; i += 2) {
+    int y_frac = x & 65535;
+    int uv_frac = (x >> 1) & 65535;
+    int y0 = (y_frac * y_buf[(x >> 16) + 1] +
+              (y_frac ^ 65535) * y_buf[x >> 16]) >> 16;
+    int u = (uv_frac * u_buf[(x >> 17) + 1] +
+             (uv_frac ^ 65535) * u_buf[x >> 17]) >> 16;
+    int v = (uv_frac * v_buf[(x >> 17) + 1] +
+             (uv_frac ^ 65535) * v_buf[x >> 17]) >> 16;
+    x += source_dx;
+    if (i + 1 == width) {
+      ConvertOnePixel(y0, u, v, rgb_buf);
+      break;
+    }
+    y_frac = x & 65535;
+    int y1 = (y_frac * y_buf[(x >> 16) + 1] +
+              (y_frac ^ 65535) * y_buf[x >> 16]) >> 16;
+    x += source_dx;
+    ConvertTwoPixels(y0, y1, u, v, rgb_buf);
+    rgb_buf += 8;
+  }
+}
+
+}  // extern "C"
+
+namespace media {
+
+void ConvertYUVToRGB32_NEON(const uint8* yplane,
+                            const uint8* uplane,
+                            const uint8* vplane,
+                            uint8* rgbframe,
+                            int width,
+                            int height,
+                            int ystride,
+                            int uvstride,
+                            int rgbstride,
+                            YUVType yuv_type) {
+  unsigned int y_shift = yuv_type;
+  for (int y = 0; y < height; ++y) {
+    uint8* rgb_row = rgbframe + y * rgbstride;
+    const uint8* y_ptr = yplane + y * ystride;
+    const uint8* u_ptr = uplane + (y >> y_shift) * uvstride;
+    const uint8* v_ptr = vplane + (y >> y_shift) * uvstride;
+
+    ConvertYUVToRGB32Row_NEON(y_ptr,
+                              u_ptr,
+                              v_ptr,
+                              rgb_row,
+                              width);
+  }
+}
+
+}  // namespace media
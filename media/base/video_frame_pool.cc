@@ -0,0 +1,51 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+namespace media {
+
+VideoFramePool::VideoFramePool(size_t max_frames)
+    : max_frames_(max_frames) {
+}
+
+VideoFramePool::~VideoFramePool() {
+}
+
+scoped_refptr<VideoFrame> VideoFramePool::CreateFrame(
+    VideoFrame::Format format,
+    const gfx::Size& data_size,
+    const gfx::Size& natural_size,
+    base::TimeDelta timestamp) {
+  // A frame only referenced by |frames_| is idle and can be handed out again.
+  FrameList::iterator idle_frame = frames_.end();
+  for (FrameList::iterator iter = frames_.begin(); iter != frames_.end();
+       ++iter) {
+    if (!(*iter)->HasOneRef())
+      continue;
+    if ((*iter)->format() == format && (*iter)->data_size() == data_size &&
+        (*iter)->natural_size() == natural_size) {
+      (*iter)->SetTimestamp(timestamp);
+      return *iter;
+    }
+    if (idle_frame == frames_.end())
+      idle_frame = iter;
+  }
+
+  scoped_refptr<VideoFrame> frame =
+      VideoFrame::CreateFrame(format, data_size, natural_size, timestamp);
+
+  // Make room by evicting an idle frame of a different configuration.
+  if (frames_.size() >= max_frames_ && idle_frame != frames_.end())
+    frames_.erase(idle_frame);
+  if (frames_.size() < max_frames_)
+    frames_.push_back(frame);
+  return frame;
+}
+
+void VideoFramePool::Clear() {
+  frames_.clear();
+}
+
+}  // namespace media
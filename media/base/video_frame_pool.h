@@ -0,0 +1,54 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_BASE_VIDEO_FRAME_POOL_H_
+#define MEDIA_BASE_VIDEO_FRAME_POOL_H_
+
+#include <list>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "media/base/video_frame.h"
+
+namespace media {
+
+// Hands out system memory VideoFrames, recycling the buffers of frames that
+// are no longer referenced by anyone but the pool. Frames are matched on
+// format, data size and natural size, so a stream of same-sized frames stops
+// allocating once the pool has warmed up.
+//
+// The pool itself is not thread safe and must be used on a single thread.
+// Returned frames may be released on any thread.
+class MEDIA_EXPORT VideoFramePool {
+ public:
+  // At most |max_frames| frames are retained. Frames requested beyond that
+  // are still created but are not recycled.
+  explicit VideoFramePool(size_t max_frames);
+  ~VideoFramePool();
+
+  // Returns a frame with the given parameters. The contents of a recycled
+  // frame's planes are left as they were; callers must overwrite them.
+  scoped_refptr<VideoFrame> CreateFrame(VideoFrame::Format format,
+                                        const gfx::Size& data_size,
+                                        const gfx::Size& natural_size,
+                                        base::TimeDelta timestamp);
+
+  // Releases the pool's references to all frames.
+  void Clear();
+
+  // Returns the number of frames currently retained, in use or idle.
+  size_t size() const { return frames_.size(); }
+
+ private:
+  typedef std::list<scoped_refptr<VideoFrame> > FrameList;
+
+  const size_t max_frames_;
+  FrameList frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoFramePool);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_BASE_VIDEO_FRAME_POOL_H_
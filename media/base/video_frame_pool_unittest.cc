@@ -0,0 +1,69 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static const gfx::Size kSize(320, 240);
+static const gfx::Size kOtherSize(640, 480);
+
+static scoped_refptr<VideoFrame> CreateFrame(VideoFramePool* pool,
+                                             const gfx::Size& size) {
+  return pool->CreateFrame(VideoFrame::YV12, size, size, kNoTimestamp());
+}
+
+TEST(VideoFramePoolTest, RecyclesIdleFrames) {
+  VideoFramePool pool(4);
+  scoped_refptr<VideoFrame> frame = CreateFrame(&pool, kSize);
+  uint8* y_plane = frame->data(VideoFrame::kYPlane);
+
+  // The frame is still in use, so a new one has to be allocated.
+  scoped_refptr<VideoFrame> second_frame = CreateFrame(&pool, kSize);
+  EXPECT_NE(y_plane, second_frame->data(VideoFrame::kYPlane));
+  EXPECT_EQ(2u, pool.size());
+
+  // Once released, its buffers are handed out again with the new timestamp.
+  frame = NULL;
+  const base::TimeDelta kTimestamp = base::TimeDelta::FromSeconds(1);
+  frame = pool.CreateFrame(VideoFrame::YV12, kSize, kSize, kTimestamp);
+  EXPECT_EQ(y_plane, frame->data(VideoFrame::kYPlane));
+  EXPECT_EQ(kTimestamp, frame->GetTimestamp());
+  EXPECT_EQ(2u, pool.size());
+}
+
+TEST(VideoFramePoolTest, DoesNotRecycleMismatchedFrames) {
+  VideoFramePool pool(4);
+  scoped_refptr<VideoFrame> frame = CreateFrame(&pool, kSize);
+  frame = NULL;
+
+  frame = CreateFrame(&pool, kOtherSize);
+  EXPECT_EQ(kOtherSize, frame->data_size());
+  EXPECT_EQ(2u, pool.size());
+}
+
+TEST(VideoFramePoolTest, EvictsIdleFramesWhenFull) {
+  VideoFramePool pool(1);
+  scoped_refptr<VideoFrame> frame = CreateFrame(&pool, kSize);
+
+  // The pool is full of in-use frames, so the new frame isn't retained.
+  scoped_refptr<VideoFrame> other_frame = CreateFrame(&pool, kOtherSize);
+  EXPECT_EQ(1u, pool.size());
+
+  // After the first frame is released it makes room for the new size.
+  frame = NULL;
+  other_frame = CreateFrame(&pool, kOtherSize);
+  EXPECT_EQ(1u, pool.size());
+  uint8* y_plane = other_frame->data(VideoFrame::kYPlane);
+  other_frame = NULL;
+  other_frame = CreateFrame(&pool, kOtherSize);
+  EXPECT_EQ(y_plane, other_frame->data(VideoFrame::kYPlane));
+
+  pool.Clear();
+  EXPECT_EQ(0u, pool.size());
+}
+
+}  // namespace media
@@ -53,6 +53,8 @@ static ConvertYUVToRGB32RowProc ChooseConvertYUVToRGB32RowProc() {
     return &ConvertYUVToRGB32Row_SSE;
   if (cpu.has_mmx())
     return &ConvertYUVToRGB32Row_MMX;
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  return &ConvertYUVToRGB32Row_NEON;
 #endif
   return &ConvertYUVToRGB32Row_C;
 }
@@ -68,6 +70,8 @@ static ScaleYUVToRGB32RowProc ChooseScaleYUVToRGB32RowProc() {
     return &ScaleYUVToRGB32Row_SSE;
   if (cpu.has_mmx())
     return &ScaleYUVToRGB32Row_MMX;
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  return &ScaleYUVToRGB32Row_NEON;
 #endif  // defined(ARCH_CPU_X86_64)
   return &ScaleYUVToRGB32Row_C;
 }
@@ -83,6 +87,8 @@ static ScaleYUVToRGB32RowProc ChooseLinearScaleYUVToRGB32RowProc() {
     return &LinearScaleYUVToRGB32Row_SSE;
   if (cpu.has_mmx())
     return &LinearScaleYUVToRGB32Row_MMX;
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  return &LinearScaleYUVToRGB32Row_NEON;
 #endif  // defined(ARCH_CPU_X86_64)
   return &LinearScaleYUVToRGB32Row_C;
 }
@@ -542,7 +548,10 @@ void ConvertYUVToRGB32(const uint8* yplane,
                        int uvstride,
                        int rgbstride,
                        YUVType yuv_type) {
-#if defined(ARCH_CPU_ARM_FAMILY) || defined(ARCH_CPU_MIPS_FAMILY)
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  ConvertYUVToRGB32_NEON(yplane, uplane, vplane, rgbframe,
+                         width, height, ystride, uvstride, rgbstride, yuv_type);
+#elif defined(ARCH_CPU_ARM_FAMILY) || defined(ARCH_CPU_MIPS_FAMILY)
   ConvertYUVToRGB32_C(yplane, uplane, vplane, rgbframe,
                       width, height, ystride, uvstride, rgbstride, yuv_type);
 #else
@@ -0,0 +1,159 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/cpu.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/yuv_convert.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+namespace {
+
+const int kIterations = 10;
+const int kBpp = 4;
+
+struct FrameSize {
+  const char* name;
+  int width;
+  int height;
+};
+
+const FrameSize kFrameSizes[] = {
+  { "720p", 1280, 720 },
+  { "1080p", 1920, 1080 },
+};
+
+// A kernel without a |convert_proc| only has a scaling variant.
+struct RowKernel {
+  const char* name;
+  ConvertYUVToRGB32RowProc convert_proc;
+  ScaleYUVToRGB32RowProc scale_proc;
+  bool supported;
+};
+
+// Returns the row kernels that can run on this machine, C first.
+std::vector<RowKernel> GetRowKernels() {
+  std::vector<RowKernel> kernels;
+  RowKernel c_kernel =
+      { "C", &ConvertYUVToRGB32Row_C, &ScaleYUVToRGB32Row_C, true };
+  kernels.push_back(c_kernel);
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  RowKernel mmx_kernel =
+      { "MMX", &ConvertYUVToRGB32Row_MMX, &ScaleYUVToRGB32Row_MMX,
+        cpu.has_mmx() };
+  kernels.push_back(mmx_kernel);
+  RowKernel sse_kernel =
+      { "SSE", &ConvertYUVToRGB32Row_SSE, &ScaleYUVToRGB32Row_SSE,
+        cpu.has_sse() };
+  kernels.push_back(sse_kernel);
+#if defined(ARCH_CPU_X86_64)
+  RowKernel sse2_x64_kernel =
+      { "SSE2_X64", NULL, &ScaleYUVToRGB32Row_SSE2_X64, true };
+  kernels.push_back(sse2_x64_kernel);
+#endif
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  RowKernel neon_kernel =
+      { "NEON", &ConvertYUVToRGB32Row_NEON, &ScaleYUVToRGB32Row_NEON, true };
+  kernels.push_back(neon_kernel);
+#endif
+  return kernels;
+}
+
+// Fills a YV12 frame with a gradient so every table entry gets exercised.
+void FillYV12Frame(uint8* y_plane, uint8* u_plane, uint8* v_plane,
+                   int width, int height) {
+  for (int row = 0; row < height; ++row) {
+    for (int col = 0; col < width; ++col)
+      y_plane[row * width + col] = static_cast<uint8>(row + col);
+  }
+  for (int row = 0; row < height / 2; ++row) {
+    for (int col = 0; col < width / 2; ++col) {
+      u_plane[row * width / 2 + col] = static_cast<uint8>(row);
+      v_plane[row * width / 2 + col] = static_cast<uint8>(col);
+    }
+  }
+}
+
+}  // namespace
+
+// Converts whole frames one row at a time with each kernel.
+TEST(YUVConvertPerfTest, ConvertYUVToRGB32Row) {
+  std::vector<RowKernel> kernels = GetRowKernels();
+  for (size_t i = 0; i < arraysize(kFrameSizes); ++i) {
+    const FrameSize& size = kFrameSizes[i];
+    int y_size = size.width * size.height;
+    scoped_array<uint8> yuv_bytes(new uint8[y_size * 3 / 2]);
+    scoped_array<uint8> rgb_bytes(new uint8[y_size * kBpp]);
+    uint8* y_plane = yuv_bytes.get();
+    uint8* u_plane = y_plane + y_size;
+    uint8* v_plane = u_plane + y_size / 4;
+    FillYV12Frame(y_plane, u_plane, v_plane, size.width, size.height);
+
+    for (size_t k = 0; k < kernels.size(); ++k) {
+      if (!kernels[k].supported || !kernels[k].convert_proc)
+        continue;
+      PerfTimeLogger timer(base::StringPrintf(
+          "ConvertYUVToRGB32Row_%s_%s", kernels[k].name, size.name).c_str());
+      for (int j = 0; j < kIterations; ++j) {
+        for (int row = 0; row < size.height; ++row) {
+          kernels[k].convert_proc(
+              y_plane + row * size.width,
+              u_plane + (row / 2) * (size.width / 2),
+              v_plane + (row / 2) * (size.width / 2),
+              rgb_bytes.get() + row * size.width * kBpp,
+              size.width);
+        }
+      }
+      EmptyRegisterState();
+      timer.Done();
+    }
+  }
+}
+
+// Scales the 720p frame up to 1080p, one row at a time, with each kernel.
+TEST(YUVConvertPerfTest, ScaleYUVToRGB32Row) {
+  std::vector<RowKernel> kernels = GetRowKernels();
+  const FrameSize& source = kFrameSizes[0];
+  const FrameSize& dest = kFrameSizes[1];
+  int y_size = source.width * source.height;
+  scoped_array<uint8> yuv_bytes(new uint8[y_size * 3 / 2]);
+  scoped_array<uint8> rgb_bytes(new uint8[dest.width * dest.height * kBpp]);
+  uint8* y_plane = yuv_bytes.get();
+  uint8* u_plane = y_plane + y_size;
+  uint8* v_plane = u_plane + y_size / 4;
+  FillYV12Frame(y_plane, u_plane, v_plane, source.width, source.height);
+  int source_dx = (source.width << 16) / dest.width;
+
+  for (size_t k = 0; k < kernels.size(); ++k) {
+    if (!kernels[k].supported)
+      continue;
+    PerfTimeLogger timer(base::StringPrintf(
+        "ScaleYUVToRGB32Row_%s_%s_to_%s", kernels[k].name, source.name,
+        dest.name).c_str());
+    for (int j = 0; j < kIterations; ++j) {
+      for (int row = 0; row < dest.height; ++row) {
+        int source_row = row * source.height / dest.height;
+        kernels[k].scale_proc(
+            y_plane + source_row * source.width,
+            u_plane + (source_row / 2) * (source.width / 2),
+            v_plane + (source_row / 2) * (source.width / 2),
+            rgb_bytes.get() + row * dest.width * kBpp,
+            dest.width,
+            source_dx);
+      }
+    }
+    EmptyRegisterState();
+    timer.Done();
+  }
+}
+
+}  // namespace media
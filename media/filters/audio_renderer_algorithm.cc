@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -29,6 +30,10 @@ static const double kWindowDuration = 0.08;
 // Duration of crossfade between audio segments (in seconds).
 static const double kCrossfadeDuration = 0.008;
 
+// Maximum distance the intro of a sped-up window may be moved in either
+// direction to find the best match for the outtro (in seconds).
+static const double kSearchDuration = 0.004;
+
 // Max/min supported playback rates for fast/slow audio. Audio outside of these
 // ranges are muted.
 // Audio at these speeds would sound better under a frequency domain algorithm.
@@ -43,6 +48,8 @@ AudioRendererAlgorithm::AudioRendererAlgorithm()
       audio_buffer_(0, kStartingBufferSizeInBytes),
       bytes_in_crossfade_(0),
       bytes_per_frame_(0),
+      bytes_in_search_(0),
+      search_drift_(0),
       index_into_window_(0),
       crossfade_frame_number_(0),
       muted_(false),
@@ -102,6 +109,18 @@ void AudioRendererAlgorithm::Initialize(
   AlignToFrameBoundary(&bytes_in_crossfade_);
 
   crossfade_buffer_.reset(new uint8[bytes_in_crossfade_]);
+
+  bytes_in_search_ =
+      samples_per_second_ * bytes_per_channel_ * channels_ * kSearchDuration;
+  AlignToFrameBoundary(&bytes_in_search_);
+
+  int frames_in_crossfade = bytes_in_crossfade_ / bytes_per_frame_;
+  int frames_in_search =
+      2 * bytes_in_search_ / bytes_per_frame_ + frames_in_crossfade;
+  search_buffer_.reset(new uint8[frames_in_search * bytes_per_frame_]);
+  outtro_mix_.reset(new float[frames_in_crossfade]);
+  search_mix_.reset(new float[frames_in_search]);
+  intro_frame_.reset(new uint8[bytes_per_frame_]);
 }
 
 int AudioRendererAlgorithm::FillBuffer(
@@ -154,7 +173,8 @@ bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
   //
   //  a) Output raw data.
   //  b) Save bytes for crossfade in |crossfade_buffer_|.
-  //  c) Drop data.
+  //  c) Drop data, then search for the intro that best lines up with the
+  //     saved outtro.
   //  d) Output crossfaded audio leading up to the next window.
   //
   // The duration of each phase is computed below based on the |window_size_|
@@ -200,8 +220,17 @@ bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
     index_into_window_ += bytes_per_frame_;
   }
 
-  // c) Drop frames until we reach the intro crossfade section.
-  while (index_into_window_ < intro_crossfade_begin) {
+  // The intro may be moved up to |search_bytes| in either direction, as long
+  // as it does not reach back into the outtro.
+  int search_bytes = 0;
+  if (bytes_to_crossfade > 0) {
+    search_bytes = std::max(0, std::min(
+        bytes_in_search_, intro_crossfade_begin - outtro_crossfade_end));
+  }
+  int search_begin = intro_crossfade_begin - search_bytes;
+
+  // c) Drop frames until we reach the start of the intro search region.
+  while (index_into_window_ < search_begin) {
     if (audio_buffer_.forward_bytes() < bytes_per_frame_)
       return false;
 
@@ -209,6 +238,34 @@ bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
     index_into_window_ += bytes_per_frame_;
   }
 
+  //    Then skip ahead to the candidate intro that best matches the outtro.
+  //    Candidates are limited so that |search_drift_| never exceeds
+  //    |search_bytes|, which keeps the average input step at |input_step|.
+  if (index_into_window_ < intro_crossfade_begin) {
+    DCHECK_EQ(index_into_window_, search_begin);
+    int nominal_offset = search_bytes / bytes_per_frame_;
+    int crossfade_frames = bytes_to_crossfade / bytes_per_frame_;
+    if (audio_buffer_.forward_bytes() <
+        (2 * nominal_offset + crossfade_frames) * bytes_per_frame_) {
+      return false;
+    }
+
+    int drift_frames = search_drift_ / bytes_per_frame_;
+    int min_offset =
+        std::max(0, std::min(-drift_frames, 2 * nominal_offset));
+    int max_offset =
+        std::max(0, std::min(2 * nominal_offset - drift_frames,
+                             2 * nominal_offset));
+    int offset =
+        FindBestIntroOffset(min_offset, max_offset, crossfade_frames);
+
+    audio_buffer_.Seek(offset * bytes_per_frame_);
+    if (!IsQueueFull())
+      request_read_cb_.Run();
+    search_drift_ += (offset - nominal_offset) * bytes_per_frame_;
+    index_into_window_ = intro_crossfade_begin;
+  }
+
   // Return if we have run out of data after Phase c).
   if (audio_buffer_.forward_bytes() < bytes_per_frame_)
     return false;
@@ -224,9 +281,8 @@ bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
   int offset_into_buffer = index_into_window_ - intro_crossfade_begin;
   memcpy(dest, crossfade_buffer_.get() + offset_into_buffer,
          bytes_per_frame_);
-  scoped_array<uint8> intro_frame_ptr(new uint8[bytes_per_frame_]);
-  audio_buffer_.Read(intro_frame_ptr.get(), bytes_per_frame_);
-  OutputCrossfadedFrame(dest, intro_frame_ptr.get());
+  audio_buffer_.Read(intro_frame_.get(), bytes_per_frame_);
+  OutputCrossfadedFrame(dest, intro_frame_.get());
   index_into_window_ += bytes_per_frame_;
   return true;
 }
@@ -349,6 +405,79 @@ void AudioRendererAlgorithm::DropFrame() {
     request_read_cb_.Run();
 }
 
+int AudioRendererAlgorithm::FindBestIntroOffset(
+    int min_offset, int max_offset, int crossfade_frames) {
+  DCHECK_LE(min_offset, max_offset);
+  DCHECK_GT(crossfade_frames, 0);
+
+  int search_frames = max_offset + crossfade_frames;
+  int copied = audio_buffer_.Peek(
+      search_buffer_.get(), search_frames * bytes_per_frame_);
+  DCHECK_EQ(search_frames * bytes_per_frame_, copied);
+
+  DownmixToMono(crossfade_buffer_.get(), crossfade_frames, outtro_mix_.get());
+  DownmixToMono(search_buffer_.get(), search_frames, search_mix_.get());
+  const float* outtro = outtro_mix_.get();
+  const float* search = search_mix_.get();
+
+  // Energy of the current candidate, updated as the candidate slides forward.
+  double energy = 0.0;
+  for (int i = min_offset; i < min_offset + crossfade_frames; ++i)
+    energy += search[i] * search[i];
+
+  int best_offset = min_offset;
+  double best_score = -std::numeric_limits<double>::max();
+  for (int offset = min_offset; offset <= max_offset; ++offset) {
+    if (offset > min_offset) {
+      float entering = search[offset + crossfade_frames - 1];
+      float leaving = search[offset - 1];
+      energy += entering * entering - leaving * leaving;
+    }
+
+    const float* candidate = search + offset;
+    double correlation = 0.0;
+    for (int i = 0; i < crossfade_frames; ++i)
+      correlation += outtro[i] * candidate[i];
+
+    double score = energy > 0.0 ? correlation / sqrt(energy) : 0.0;
+    if (score > best_score) {
+      best_score = score;
+      best_offset = offset;
+    }
+  }
+  return best_offset;
+}
+
+void AudioRendererAlgorithm::DownmixToMono(
+    const uint8* src, int frames, float* dest) {
+  switch (bytes_per_channel_) {
+    case 4:
+      DoDownmixToMono<int32>(src, frames, 0.0f, dest);
+      break;
+    case 2:
+      DoDownmixToMono<int16>(src, frames, 0.0f, dest);
+      break;
+    case 1:
+      // 8-bit audio is unsigned with silence at 128.
+      DoDownmixToMono<uint8>(src, frames, 128.0f, dest);
+      break;
+    default:
+      NOTREACHED() << "Unsupported audio bit depth in downmix.";
+  }
+}
+
+template <class Type>
+void AudioRendererAlgorithm::DoDownmixToMono(
+    const uint8* src_bytes, int frames, float bias, float* dest) {
+  const Type* src = reinterpret_cast<const Type*>(src_bytes);
+  for (int i = 0; i < frames; ++i) {
+    float sum = 0.0f;
+    for (int channel = 0; channel < channels_; ++channel)
+      sum += *src++ - bias;
+    dest[i] = sum;
+  }
+}
+
 void AudioRendererAlgorithm::OutputCrossfadedFrame(
     uint8* outtro, const uint8* intro) {
   DCHECK_LE(index_into_window_, window_size_);
@@ -388,6 +517,7 @@ void AudioRendererAlgorithm::CrossfadeFrame(
 void AudioRendererAlgorithm::SetPlaybackRate(float new_rate) {
   DCHECK_GE(new_rate, 0.0);
   playback_rate_ = new_rate;
+  search_drift_ = 0;
   muted_ =
       playback_rate_ < kMinPlaybackRate || playback_rate_ > kMaxPlaybackRate;
 
@@ -400,6 +530,7 @@ void AudioRendererAlgorithm::AlignToFrameBoundary(int* value) {
 
 void AudioRendererAlgorithm::FlushBuffers() {
   ResetWindow();
+  search_drift_ = 0;
 
   // Clear the queue of decoded packets (releasing the buffers).
   audio_buffer_.Clear();
@@ -15,7 +15,9 @@
 //
 // AudioRendererAlgorithm uses a simple pitch-preservation algorithm to
 // stretch and compress audio data to meet playback speeds less than and
-// greater than the natural playback of the audio stream.
+// greater than the natural playback of the audio stream. When speeding up,
+// the point at which the next segment is spliced in is chosen by waveform
+// similarity (WSOLA) to avoid phase cancellation in the crossfade.
 //
 // Audio at very low or very high playback rates are muted to preserve quality.
 
@@ -141,6 +143,19 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Moves the |audio_buffer_| forward by one frame.
   void DropFrame();
 
+  // Returns the offset, in frames from the current |audio_buffer_| position
+  // and between |min_offset| and |max_offset| inclusive, at which the next
+  // |crossfade_frames| frames best match the outtro saved in
+  // |crossfade_buffer_|. Similarity is the normalized cross-correlation of the
+  // mono downmixes. Assumes enough data is buffered to cover every candidate.
+  int FindBestIntroOffset(int min_offset, int max_offset,
+                          int crossfade_frames);
+
+  // Downmixes |frames| frames of interleaved audio in |src| into |dest|.
+  void DownmixToMono(const uint8* src, int frames, float* dest);
+  template <class Type>
+  void DoDownmixToMono(const uint8* src, int frames, float bias, float* dest);
+
   // Does a linear crossfade from |intro| into |outtro| for one frame.
   // Assumes pointers are valid and are at least size of |bytes_per_frame_|.
   void OutputCrossfadedFrame(uint8* outtro, const uint8* intro);
@@ -174,6 +189,14 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Length of frame in bytes.
   int bytes_per_frame_;
 
+  // Maximum distance, in bytes, that the intro of a sped-up window may be
+  // moved in either direction to line it up with the outtro.
+  int bytes_in_search_;
+
+  // Net number of bytes consumed beyond the nominal input step because of
+  // intro searches. Bounded so that the average playback rate is preserved.
+  int search_drift_;
+
   // The current location in the audio window, between 0 and |window_size_|.
   // When |index_into_window_| reaches |window_size_|, the window resets.
   // Indexed by byte.
@@ -190,6 +213,13 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Temporary buffer to hold crossfade data.
   scoped_array<uint8> crossfade_buffer_;
 
+  // Scratch space for the intro search and the crossfade, allocated once in
+  // Initialize() so that rendering never allocates.
+  scoped_array<uint8> search_buffer_;
+  scoped_array<float> outtro_mix_;
+  scoped_array<float> search_mix_;
+  scoped_array<uint8> intro_frame_;
+
   // Window size, in bytes (calculated from audio properties).
   int window_size_;
 
@@ -0,0 +1,84 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "media/base/data_buffer.h"
+#include "media/filters/audio_renderer_algorithm.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+namespace {
+
+const int kChannels = 2;
+const int kSampleBits = 16;
+const int kSamplesPerSecond = 44100;
+const int kFramesPerBuffer = 2048;
+const int kSecondsOfOutput = 10;
+
+const float kPlaybackRates[] = { 0.5f, 0.75f, 1.25f, 1.5f, 2.0f, 3.0f };
+
+}  // namespace
+
+class AudioRendererAlgorithmPerfTest : public testing::Test {
+ public:
+  AudioRendererAlgorithmPerfTest() : phase_(0) {}
+
+  // Keeps |algorithm_| topped up with a two tone signal so the intro search
+  // has something to lock onto.
+  void EnqueueData() {
+    if (algorithm_.IsQueueFull())
+      return;
+
+    int bytes = kFramesPerBuffer * algorithm_.bytes_per_frame();
+    scoped_array<uint8> data(new uint8[bytes]);
+    int16* samples = reinterpret_cast<int16*>(data.get());
+    for (int i = 0; i < kFramesPerBuffer; ++i, ++phase_) {
+      int16 value = 8192 * (sin(2.0 * M_PI * phase_ * 440 / kSamplesPerSecond) +
+                            sin(2.0 * M_PI * phase_ * 660 / kSamplesPerSecond));
+      for (int channel = 0; channel < kChannels; ++channel)
+        *samples++ = value;
+    }
+    algorithm_.EnqueueBuffer(new DataBuffer(data.Pass(), bytes));
+  }
+
+ protected:
+  AudioRendererAlgorithm algorithm_;
+  int phase_;
+};
+
+TEST_F(AudioRendererAlgorithmPerfTest, FillBuffer) {
+  for (size_t i = 0; i < arraysize(kPlaybackRates); ++i) {
+    float rate = kPlaybackRates[i];
+    algorithm_.Initialize(
+        kChannels, kSamplesPerSecond, kSampleBits, rate,
+        base::Bind(&AudioRendererAlgorithmPerfTest::EnqueueData,
+                   base::Unretained(this)));
+    algorithm_.FlushBuffers();
+
+    scoped_array<uint8> output(
+        new uint8[kFramesPerBuffer * algorithm_.bytes_per_frame()]);
+    int frames_remaining = kSecondsOfOutput * kSamplesPerSecond;
+
+    PerfTimeLogger timer(
+        base::StringPrintf("FillBuffer at %.2fx", rate).c_str());
+    while (frames_remaining > 0) {
+      int frames_written = algorithm_.FillBuffer(
+          output.get(), std::min(kFramesPerBuffer, frames_remaining));
+      ASSERT_GT(frames_written, 0);
+      frames_remaining -= frames_written;
+    }
+    timer.Done();
+  }
+}
+
+}  // namespace media
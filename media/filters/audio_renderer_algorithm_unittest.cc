@@ -11,6 +11,7 @@
 #include <cmath>
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "media/base/data_buffer.h"
 #include "media/filters/audio_renderer_algorithm.h"
@@ -284,4 +285,38 @@ TEST_F(AudioRendererAlgorithmTest, FillBuffer_HigherQualityAudio) {
   TestPlaybackRate(1.5);
 }
 
+// Sped up playback of a pure tone should splice windows together in phase, so
+// the crossfades never attenuate the signal.
+TEST_F(AudioRendererAlgorithmTest, FillBuffer_SpeedUpPreservesPhase) {
+  static const int kChannels = 1;
+  static const int kSampleBits = 16;
+  static const int kFramesPerPeriod = 100;
+  static const int kInputFrames = 2 * kSamplesPerSecond;
+  static const int kOutputFrames = kSamplesPerSecond;
+  static const int16 kAmplitude = 16384;
+  algorithm_.Initialize(kChannels, kSamplesPerSecond, kSampleBits, 1.5f,
+                        base::Bind(&base::DoNothing));
+
+  scoped_array<uint8> input(new uint8[kInputFrames * sizeof(int16)]);
+  int16* samples = reinterpret_cast<int16*>(input.get());
+  for (int i = 0; i < kInputFrames; ++i)
+    samples[i] = kAmplitude * sin(2.0 * M_PI * i / kFramesPerPeriod);
+  algorithm_.EnqueueBuffer(
+      new DataBuffer(input.Pass(), kInputFrames * sizeof(int16)));
+
+  scoped_array<uint8> output(new uint8[kOutputFrames * sizeof(int16)]);
+  ASSERT_EQ(kOutputFrames,
+            algorithm_.FillBuffer(output.get(), kOutputFrames));
+
+  // Every period of the output should still reach close to full amplitude.
+  const int16* output_samples = reinterpret_cast<int16*>(output.get());
+  for (int i = 0; i + kFramesPerPeriod <= kOutputFrames;
+       i += kFramesPerPeriod) {
+    int peak = 0;
+    for (int j = i; j < i + kFramesPerPeriod; ++j)
+      peak = std::max(peak, std::abs(static_cast<int>(output_samples[j])));
+    EXPECT_GE(peak, 0.9 * kAmplitude) << "Period starting at frame " << i;
+  }
+}
+
 }  // namespace media
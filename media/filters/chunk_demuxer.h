@@ -13,6 +13,7 @@
 #include "base/synchronization/lock.h"
 #include "media/base/byte_queue.h"
 #include "media/base/demuxer.h"
+#include "media/base/media_log.h"
 #include "media/base/ranges.h"
 #include "media/base/stream_parser.h"
 #include "media/filters/source_buffer_stream.h"
@@ -39,7 +40,10 @@ class MEDIA_EXPORT ChunkDemuxer : public Demuxer {
   //   is ready to receive media data via AppenData().
   // |need_key_cb| Run when the demuxer determines that an encryption key is
   //   needed to decrypt the content.
-  ChunkDemuxer(const base::Closure& open_cb, const NeedKeyCB& need_key_cb);
+  // |media_log| Receives events about the demuxer's buffering, such as
+  //   garbage collection of appended data.
+  ChunkDemuxer(const base::Closure& open_cb, const NeedKeyCB& need_key_cb,
+               const scoped_refptr<MediaLog>& media_log);
 
   // Demuxer implementation.
   virtual void Initialize(DemuxerHost* host,
@@ -168,6 +172,7 @@ class MEDIA_EXPORT ChunkDemuxer : public Demuxer {
   DemuxerHost* host_;
   base::Closure open_cb_;
   NeedKeyCB need_key_cb_;
+  scoped_refptr<MediaLog> media_log_;
 
   PipelineStatusCB init_cb_;
   PipelineStatusCB seek_cb_;
@@ -13,6 +13,7 @@
 #include "base/location.h"
 #include "base/message_loop_proxy.h"
 #include "base/string_number_conversions.h"
+#include "base/sys_info.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/demuxer_stream.h"
 #include "media/base/limits.h"
@@ -38,11 +39,20 @@ namespace media {
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
+// Upper bound on the number of frames GetVideoBuffer() keeps for reuse. Frame
+// threaded decoding keeps one frame in flight per thread in addition to the
+// reference frames, so the pool has to cover at least that many.
+static const size_t kMaxPooledFrames = 2 * kMaxDecodeThreads;
+
 // Returns the number of threads given the FFmpeg CodecID. Also inspects the
 // command line for a valid --video-threads flag.
 static int GetThreadCount(CodecID codec_id) {
   // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
-  int decode_threads = kDecodeThreads;
+  // Frame threading keeps one frame in flight per thread, so use every core
+  // available by default.
+  int decode_threads =
+      std::max(kDecodeThreads, base::SysInfo::NumberOfProcessors());
+  decode_threads = std::min(decode_threads, kMaxDecodeThreads);
 
   const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
   std::string threads(cmd_line->GetSwitchValueASCII(switches::kVideoThreads));
@@ -62,6 +72,7 @@ FFmpegVideoDecoder::FFmpegVideoDecoder(
       state_(kUninitialized),
       codec_context_(NULL),
       av_frame_(NULL),
+      frame_pool_(kMaxPooledFrames),
       decryptor_(decryptor) {
 }
 
@@ -95,7 +106,7 @@ int FFmpegVideoDecoder::GetVideoBuffer(AVCodecContext* codec_context,
     return AVERROR(EINVAL);
 
   scoped_refptr<VideoFrame> video_frame =
-      VideoFrame::CreateFrame(format, size, natural_size, kNoTimestamp());
+      frame_pool_.CreateFrame(format, size, natural_size, kNoTimestamp());
 
   for (int i = 0; i < 3; i++) {
     frame->base[i] = video_frame->data(i);
@@ -500,6 +511,7 @@ void FFmpegVideoDecoder::ReleaseFFmpegResources() {
     av_free(av_frame_);
     av_frame_ = NULL;
   }
+  frame_pool_.Clear();
 }
 
 bool FFmpegVideoDecoder::ConfigureDecoder() {
@@ -522,6 +534,7 @@ bool FFmpegVideoDecoder::ConfigureDecoder() {
   codec_context_->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
   codec_context_->err_recognition = AV_EF_CAREFUL;
   codec_context_->thread_count = GetThreadCount(codec_context_->codec_id);
+  codec_context_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
   codec_context_->opaque = this;
   codec_context_->flags |= CODEC_FLAG_EMU_EDGE;
   codec_context_->get_buffer = GetVideoBufferImpl;
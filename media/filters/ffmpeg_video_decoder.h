@@ -10,6 +10,7 @@
 #include "media/base/decryptor.h"
 #include "media/base/demuxer_stream.h"
 #include "media/base/video_decoder.h"
+#include "media/base/video_frame_pool.h"
 
 struct AVCodecContext;
 struct AVFrame;
@@ -111,6 +112,10 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   AVCodecContext* codec_context_;
   AVFrame* av_frame_;
 
+  // Recycles the frames handed to FFmpeg through GetVideoBuffer() once
+  // neither FFmpeg nor the renderer references them anymore.
+  VideoFramePool frame_pool_;
+
   // Pointer to the demuxer stream that will feed us compressed buffers.
   scoped_refptr<DemuxerStream> demuxer_stream_;
 
@@ -284,7 +284,9 @@ static int kDefaultVideoMemoryLimit = 150 * 1024 * 1024;
 
 namespace media {
 
-SourceBufferStream::SourceBufferStream(const AudioDecoderConfig& audio_config)
+SourceBufferStream::SourceBufferStream(
+    const AudioDecoderConfig& audio_config,
+    const scoped_refptr<MediaLog>& media_log)
     : current_config_index_(0),
       append_config_index_(0),
       seek_pending_(false),
@@ -296,13 +298,16 @@ SourceBufferStream::SourceBufferStream(const AudioDecoderConfig& audio_config)
       last_buffer_timestamp_(kNoTimestamp()),
       max_interbuffer_distance_(kNoTimestamp()),
       memory_limit_(kDefaultAudioMemoryLimit),
+      media_log_(media_log),
       config_change_pending_(false) {
   DCHECK(audio_config.IsValidConfig());
   audio_configs_.push_back(new AudioDecoderConfig());
   audio_configs_.back()->CopyFrom(audio_config);
 }
 
-SourceBufferStream::SourceBufferStream(const VideoDecoderConfig& video_config)
+SourceBufferStream::SourceBufferStream(
+    const VideoDecoderConfig& video_config,
+    const scoped_refptr<MediaLog>& media_log)
     : current_config_index_(0),
       append_config_index_(0),
       seek_pending_(false),
@@ -314,6 +319,7 @@ SourceBufferStream::SourceBufferStream(const VideoDecoderConfig& video_config)
       last_buffer_timestamp_(kNoTimestamp()),
       max_interbuffer_distance_(kNoTimestamp()),
       memory_limit_(kDefaultVideoMemoryLimit),
+      media_log_(media_log),
       config_change_pending_(false) {
   DCHECK(video_config.IsValidConfig());
   video_configs_.push_back(new VideoDecoderConfig());
@@ -512,20 +518,24 @@ void SourceBufferStream::SetConfigIds(const BufferQueue& buffers) {
 }
 
 void SourceBufferStream::GarbageCollectIfNeeded() {
-  // Compute size of |ranges_|.
-  int ranges_size = 0;
-  for (RangeList::iterator itr = ranges_.begin(); itr != ranges_.end(); ++itr)
-    ranges_size += (*itr)->size_in_bytes();
+  int ranges_size = GetBufferedBytes();
 
   // Return if we're under or at the memory limit.
   if (ranges_size <= memory_limit_)
     return;
 
   int bytes_to_free = ranges_size - memory_limit_;
+  base::TimeDelta playback_position = GetPlaybackPosition();
 
-  // Begin deleting from the front.
+  // Begin deleting from the front. Ranges that lie entirely after the
+  // playback position are closer to it than anything at the back, so stop
+  // there. If the position is unknown, everything is fair game.
   while (!ranges_.empty() && bytes_to_free > 0) {
     SourceBufferRange* current_range = ranges_.front();
+    if (playback_position != kNoTimestamp() &&
+        current_range->GetStartTimestamp() >= playback_position) {
+      break;
+    }
     bytes_to_free -= current_range->FreeFromStart(bytes_to_free);
 
     // If the |current_range| still has data left after freeing, we should not
@@ -552,6 +562,32 @@ void SourceBufferStream::GarbageCollectIfNeeded() {
     delete current_range;
     ranges_.pop_back();
   }
+
+  int bytes_freed = ranges_size - GetBufferedBytes();
+  DVLOG(1) << "Garbage collected " << bytes_freed << " of " << ranges_size
+           << " buffered bytes";
+  if (bytes_freed > 0) {
+    media_log_->AddEvent(media_log_->CreateSourceBufferGarbageCollectedEvent(
+        audio_configs_.empty() ? "video" : "audio", bytes_freed,
+        ranges_size - bytes_freed));
+  }
+}
+
+base::TimeDelta SourceBufferStream::GetPlaybackPosition() const {
+  if (!track_buffer_.empty())
+    return track_buffer_.front()->GetDecodeTimestamp();
+
+  if (selected_range_) {
+    base::TimeDelta next_timestamp = selected_range_->GetNextTimestamp();
+    if (next_timestamp != kNoTimestamp())
+      return next_timestamp;
+    return selected_range_->GetBufferedEndTimestamp();
+  }
+
+  if (seek_pending_)
+    return seek_buffer_timestamp_;
+
+  return kNoTimestamp();
 }
 
 void SourceBufferStream::InsertIntoExistingRange(
@@ -921,6 +957,15 @@ Ranges<base::TimeDelta> SourceBufferStream::GetBufferedTime() const {
   return ranges;
 }
 
+int SourceBufferStream::GetBufferedBytes() const {
+  int bytes = 0;
+  for (RangeList::const_iterator itr = ranges_.begin();
+       itr != ranges_.end(); ++itr) {
+    bytes += (*itr)->size_in_bytes();
+  }
+  return bytes;
+}
+
 bool SourceBufferStream::IsEndSelected() const {
   return ranges_.empty() || selected_range_ == ranges_.back();
 }
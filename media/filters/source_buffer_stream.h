@@ -18,6 +18,7 @@
 #include "base/memory/ref_counted.h"
 #include "media/base/audio_decoder_config.h"
 #include "media/base/media_export.h"
+#include "media/base/media_log.h"
 #include "media/base/ranges.h"
 #include "media/base/stream_parser_buffer.h"
 #include "media/base/video_decoder_config.h"
@@ -42,8 +43,11 @@ class MEDIA_EXPORT SourceBufferStream {
     kConfigChange,
   };
 
-  explicit SourceBufferStream(const AudioDecoderConfig& audio_config);
-  explicit SourceBufferStream(const VideoDecoderConfig& video_config);
+  // |media_log| is notified whenever buffered data is garbage collected.
+  SourceBufferStream(const AudioDecoderConfig& audio_config,
+                     const scoped_refptr<MediaLog>& media_log);
+  SourceBufferStream(const VideoDecoderConfig& video_config,
+                     const scoped_refptr<MediaLog>& media_log);
 
   ~SourceBufferStream();
 
@@ -56,7 +60,8 @@ class MEDIA_EXPORT SourceBufferStream {
   // of order or overlapping. Assumes all buffers within |buffers| are in
   // presentation order and are non-overlapping.
   // Returns true if Append() was successful, false if |buffers| are not added.
-  // TODO(vrk): Implement garbage collection. (crbug.com/125070)
+  // If the stream exceeds its memory limit afterwards, buffered data is
+  // garbage collected; see GarbageCollectIfNeeded().
   bool Append(const BufferQueue& buffers);
 
   // Changes the SourceBufferStream's state so that it will start returning
@@ -84,6 +89,9 @@ class MEDIA_EXPORT SourceBufferStream {
   // Returns a list of the buffered time ranges.
   Ranges<base::TimeDelta> GetBufferedTime() const;
 
+  // Returns the number of bytes of media data currently buffered.
+  int GetBufferedBytes() const;
+
   // Returns true if we don't have any ranges or the last range is selected.
   bool IsEndSelected() const;
 
@@ -110,8 +118,16 @@ class MEDIA_EXPORT SourceBufferStream {
   void set_memory_limit(int memory_limit) { memory_limit_ = memory_limit; }
 
   // Frees up space if the SourceBufferStream is taking up too much memory.
+  // Data before the playback position is freed first, oldest first, followed
+  // by data after it, farthest first. The GOP containing the next buffer to be
+  // returned is never freed.
   void GarbageCollectIfNeeded();
 
+  // Returns the timestamp playback will continue from: the next buffer to be
+  // returned, the end of the selected range if it is waiting for more data,
+  // or the pending seek time. Returns kNoTimestamp() if unknown.
+  base::TimeDelta GetPlaybackPosition() const;
+
   // Appends |new_buffers| into |range_for_new_buffers_itr|, handling start and
   // end overlaps if necessary.
   // |deleted_next_buffer| is an output parameter that is true if the next
@@ -281,6 +297,9 @@ class MEDIA_EXPORT SourceBufferStream {
   // The maximum amount of data in bytes the stream will keep in memory.
   int memory_limit_;
 
+  // Receives an event each time garbage collection frees data.
+  scoped_refptr<MediaLog> media_log_;
+
   // Indicates that a kConfigChanged status has been reported by GetNextBuffer()
   // and GetCurrentXXXDecoderConfig() must be called to update the current
   // config. GetNextBuffer() must not be called again until
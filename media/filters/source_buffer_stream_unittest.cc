@@ -28,7 +28,7 @@ class SourceBufferStreamTest : public testing::Test {
     config_.Initialize(kCodecVP8, VIDEO_CODEC_PROFILE_UNKNOWN,
                        VideoFrame::YV12, kCodedSize, gfx::Rect(kCodedSize),
                        kCodedSize, NULL, 0, false, false);
-    stream_.reset(new SourceBufferStream(config_));
+    stream_.reset(new SourceBufferStream(config_, new MediaLog()));
     SetStreamInfo(kDefaultFramesPerSecond, kDefaultKeyframesPerSecond);
   }
 
@@ -1920,9 +1920,9 @@ TEST_F(SourceBufferStreamTest, GarbageCollection_PendingSeek) {
   // Append 5 buffers as positions 30 to 34 to trigger GC.
   AppendBuffers(30, 5, &kDataA);
 
-  // The current algorithm will delete from the beginning until the memory is
-  // under cap.
-  CheckExpectedRanges("{ [30,34) }");
+  // GC deletes the data before the seek position first, then the data after
+  // it that is farthest away.
+  CheckExpectedRanges("{ [25,29) }");
 
   // Expand memory limit again so that GC won't be triggered.
   SetMemoryLimit(100);
@@ -1931,10 +1931,31 @@ TEST_F(SourceBufferStreamTest, GarbageCollection_PendingSeek) {
   NewSegmentAppend(15, 5, &kDataA);
 
   // Check to make sure all is well.
-  CheckExpectedRanges("{ [15,19) [30,34) }");
+  CheckExpectedRanges("{ [15,19) [25,29) }");
   CheckExpectedBuffers(15, 19, &kDataA);
-  Seek(30);
-  CheckExpectedBuffers(30, 34, &kDataA);
+  Seek(25);
+  CheckExpectedBuffers(25, 29, &kDataA);
+}
+
+TEST_F(SourceBufferStreamTest, GarbageCollection_DeleteFarthestRangeAhead) {
+  // Seek to position 45 before any data is appended.
+  Seek(45);
+
+  // Append 10 buffers at positions 50 through 59.
+  NewSegmentAppend(50, 10, &kDataA);
+  CheckNoNextBuffer();
+
+  // Set memory limit to 10 buffers.
+  SetMemoryLimit(10);
+
+  // Append 10 buffers at positions 70 through 79 to trigger GC.
+  NewSegmentAppend(70, 10, &kDataA);
+
+  // Both ranges are ahead of the seek position, so the one farthest from it
+  // is deleted.
+  CheckExpectedRanges("{ [50,59) }");
+  CheckNoNextBuffer();
+  EXPECT_EQ(10 * kDataSize, stream_->GetBufferedBytes());
 }
 
 TEST_F(SourceBufferStreamTest, GarbageCollection_NeedsMoreData) {
@@ -0,0 +1,127 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "media/base/audio_decoder_config.h"
+#include "media/base/decoder_buffer.h"
+#include "media/base/stream_parser.h"
+#include "media/base/test_data_util.h"
+#include "media/base/video_decoder_config.h"
+#include "media/webm/webm_stream_parser.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if defined(GOOGLE_CHROME_BUILD) || defined(USE_PROPRIETARY_CODECS)
+#include "media/mp4/mp4_stream_parser.h"
+#endif
+
+namespace media {
+
+static const int kIterations = 20;
+
+// Append sizes to measure: small network reads and whole media segments.
+static const int kAppendSizes[] = { 4096, 64 * 1024, 1024 * 1024 };
+
+class StreamParserPerfTest : public testing::Test {
+ public:
+  StreamParserPerfTest() : buffers_received_(0) {}
+
+  // Parses |filename| |kIterations| times with parsers from |create_parser|,
+  // once for each of |kAppendSizes|.
+  template <class Parser>
+  void RunAppendBenchmark(const std::string& filename,
+                          Parser* (*create_parser)()) {
+    scoped_refptr<DecoderBuffer> file = ReadTestDataFile(filename);
+
+    for (size_t i = 0; i < arraysize(kAppendSizes); ++i) {
+      int append_size = kAppendSizes[i];
+      PerfTimeLogger timer(base::StringPrintf(
+          "Append %s in %d byte chunks (%d bytes x %d)", filename.c_str(),
+          append_size, file->GetDataSize(), kIterations).c_str());
+
+      for (int j = 0; j < kIterations; ++j) {
+        scoped_ptr<Parser> parser(create_parser());
+        InitializeParser(parser.get());
+
+        const uint8* data = file->GetData();
+        int remaining = file->GetDataSize();
+        while (remaining > 0) {
+          int size = std::min(append_size, remaining);
+          ASSERT_TRUE(parser->Parse(data, size));
+          data += size;
+          remaining -= size;
+        }
+      }
+      timer.Done();
+    }
+    EXPECT_GT(buffers_received_, 0);
+  }
+
+ private:
+  void InitializeParser(StreamParser* parser) {
+    parser->Init(
+        base::Bind(&StreamParserPerfTest::OnInit, base::Unretained(this)),
+        base::Bind(&StreamParserPerfTest::OnNewConfig, base::Unretained(this)),
+        base::Bind(&StreamParserPerfTest::OnNewBuffers,
+                   base::Unretained(this)),
+        base::Bind(&StreamParserPerfTest::OnNewBuffers,
+                   base::Unretained(this)),
+        base::Bind(&StreamParserPerfTest::OnNeedKey, base::Unretained(this)),
+        base::Bind(&StreamParserPerfTest::OnNewSegment,
+                   base::Unretained(this)),
+        base::Bind(&StreamParserPerfTest::OnEndOfSegment,
+                   base::Unretained(this)));
+  }
+
+  void OnInit(bool success, base::TimeDelta duration) {
+    EXPECT_TRUE(success);
+  }
+
+  bool OnNewConfig(const AudioDecoderConfig& audio_config,
+                   const VideoDecoderConfig& video_config) {
+    return true;
+  }
+
+  bool OnNewBuffers(const StreamParser::BufferQueue& buffers) {
+    buffers_received_ += static_cast<int>(buffers.size());
+    return true;
+  }
+
+  bool OnNeedKey(scoped_array<uint8> init_data, int init_data_size) {
+    return true;
+  }
+
+  void OnNewSegment(base::TimeDelta start_timestamp) {}
+  void OnEndOfSegment() {}
+
+  int buffers_received_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamParserPerfTest);
+};
+
+static WebMStreamParser* CreateWebMParser() {
+  return new WebMStreamParser();
+}
+
+TEST_F(StreamParserPerfTest, WebMAppend) {
+  RunAppendBenchmark("bear-320x240.webm", &CreateWebMParser);
+}
+
+#if defined(GOOGLE_CHROME_BUILD) || defined(USE_PROPRIETARY_CODECS)
+static mp4::MP4StreamParser* CreateMP4Parser() {
+  return new mp4::MP4StreamParser(false);
+}
+
+TEST_F(StreamParserPerfTest, MP4Append) {
+  RunAppendBenchmark("bear.1280x720_dash.mp4", &CreateMP4Parser);
+}
+#endif
+
+}  // namespace media
@@ -404,10 +404,10 @@ bool MP4StreamParser::EnqueueSample(BufferQueue* audio_buffers,
     subsamples = decrypt_config->subsamples();
   }
 
-  std::vector<uint8> frame_buf(buf, buf + runs_->sample_size());
+  frame_buf_.assign(buf, buf + runs_->sample_size());
   if (video) {
     if (!PrepareAVCBuffer(runs_->video_description().avcc,
-                          &frame_buf, &subsamples)) {
+                          &frame_buf_, &subsamples)) {
       DLOG(ERROR) << "Failed to prepare AVC sample for decode";
       *err = true;
       return false;
@@ -416,7 +416,7 @@ bool MP4StreamParser::EnqueueSample(BufferQueue* audio_buffers,
 
   if (audio) {
     if (!PrepareAACBuffer(runs_->audio_description().esds.aac,
-                          &frame_buf, &subsamples)) {
+                          &frame_buf_, &subsamples)) {
       DLOG(ERROR) << "Failed to prepare AAC sample for decode";
       *err = true;
       return false;
@@ -432,7 +432,7 @@ bool MP4StreamParser::EnqueueSample(BufferQueue* audio_buffers,
   }
 
   scoped_refptr<StreamParserBuffer> stream_buf =
-    StreamParserBuffer::CopyFrom(&frame_buf[0], frame_buf.size(),
+    StreamParserBuffer::CopyFrom(&frame_buf_[0], frame_buf_.size(),
                                  runs_->is_keyframe());
 
   if (runs_->is_encrypted())
@@ -88,6 +88,10 @@ class MEDIA_EXPORT MP4StreamParser : public StreamParser {
 
   OffsetByteQueue queue_;
 
+  // Scratch space for converting a sample before it is copied into its
+  // StreamParserBuffer. Kept across samples to avoid an allocation each.
+  std::vector<uint8> frame_buf_;
+
   // These two parameters are only valid in the |kEmittingSegments| state.
   //
   // |moof_head_| is the offset of the start of the most recently parsed moof
@@ -232,14 +232,41 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
   if (state_ == kError)
     return false;
 
+  const uint8* queued = NULL;
+  int queued_size = 0;
+  byte_queue_.Peek(&queued, &queued_size);
+
+  // If nothing is left over from a previous append, parse straight out of
+  // |buf| and only queue the trailing bytes of an incomplete element. Appends
+  // usually carry whole clusters, so this avoids copying most of the data
+  // through |byte_queue_|.
+  if (queued_size == 0) {
+    int bytes_parsed = ParseBytes(buf, size);
+    if (bytes_parsed < 0)
+      return false;
+
+    if (bytes_parsed < size)
+      byte_queue_.Push(buf + bytes_parsed, size - bytes_parsed);
+    return true;
+  }
+
   byte_queue_.Push(buf, size);
+  byte_queue_.Peek(&queued, &queued_size);
 
+  int bytes_parsed = ParseBytes(queued, queued_size);
+  if (bytes_parsed < 0)
+    return false;
+
+  byte_queue_.Pop(bytes_parsed);
+  return true;
+}
+
+int WebMStreamParser::ParseBytes(const uint8* data, int size) {
   int result = 0;
   int bytes_parsed = 0;
-  const uint8* cur = NULL;
-  int cur_size = 0;
+  const uint8* cur = data;
+  int cur_size = size;
 
-  byte_queue_.Peek(&cur, &cur_size);
   while (cur_size > 0) {
     State oldState = state_;
     switch (state_) {
@@ -253,12 +280,12 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
 
       case kWaitingForInit:
       case kError:
-        return false;
+        return -1;
     }
 
     if (result < 0) {
       ChangeState(kError);
-      return false;
+      return -1;
     }
 
     if (state_ == oldState && result == 0)
@@ -270,8 +297,7 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
     bytes_parsed += result;
   }
 
-  byte_queue_.Pop(bytes_parsed);
-  return true;
+  return bytes_parsed;
 }
 
 void WebMStreamParser::ChangeState(State new_state) {
@@ -41,6 +41,10 @@ class WebMStreamParser : public StreamParser {
 
   void ChangeState(State new_state);
 
+  // Parses as many complete elements from |data| as possible, dispatching on
+  // |state_|. Returns the number of bytes parsed, or < 0 if the parse fails.
+  int ParseBytes(const uint8* data, int size);
+
   // Parses WebM Header, Info, Tracks elements. It also skips other level 1
   // elements that are not used right now. Once the Info & Tracks elements have
   // been parsed, this method will transition the parser from PARSING_HEADERS to
@@ -0,0 +1,292 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/cert_verifier_disk_cache.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/stringprintf.h"
+#include "net/base/x509_cert_types.h"
+#include "net/base/x509_certificate.h"
+
+namespace net {
+
+namespace {
+
+// Identifies the format of the cache file. Files in any other format are
+// ignored.
+const uint32 kFileVersion = 1;
+
+// Files larger than this are not loaded.
+const int64 kMaxFileSize = 4 * 1024 * 1024;
+
+// How long to wait after a result is added before writing the file, so that
+// a burst of new connections results in a single write.
+const int kWriteDelaySeconds = 10;
+
+void ReadData(const FilePath& path, std::string* data) {
+  int64 size;
+  if (!file_util::GetFileSize(path, &size) || size > kMaxFileSize)
+    return;
+  if (!file_util::ReadFileToString(path, data))
+    data->clear();
+}
+
+void WriteData(const FilePath& path, const std::string& data) {
+  FilePath temp_file;
+  if (!file_util::CreateTemporaryFileInDir(path.DirName(), &temp_file))
+    return;
+
+  int size = static_cast<int>(data.size());
+  if (file_util::WriteFile(temp_file, data.data(), size) != size ||
+      !file_util::ReplaceFile(temp_file, path)) {
+    LOG(ERROR) << "Failed to write the certificate verification cache";
+    file_util::Delete(temp_file, false);
+  }
+}
+
+void PersistResult(const CertVerifyResult& result, Pickle* pickle) {
+  pickle->WriteUInt32(result.cert_status);
+  pickle->WriteBool(result.has_md5);
+  pickle->WriteBool(result.has_md2);
+  pickle->WriteBool(result.has_md4);
+  pickle->WriteBool(result.has_md5_ca);
+  pickle->WriteBool(result.has_md2_ca);
+  pickle->WriteBool(result.is_issued_by_known_root);
+  pickle->WriteInt(static_cast<int>(result.public_key_hashes.size()));
+  for (size_t i = 0; i < result.public_key_hashes.size(); ++i) {
+    const HashValue& hash = result.public_key_hashes[i];
+    pickle->WriteInt(hash.tag);
+    pickle->WriteData(reinterpret_cast<const char*>(hash.data()),
+                      static_cast<int>(hash.size()));
+  }
+  result.verified_cert->Persist(pickle);
+}
+
+bool RestoreResult(const Pickle& pickle,
+                   PickleIterator* iter,
+                   CertVerifyResult* result) {
+  int num_hashes;
+  if (!pickle.ReadUInt32(iter, &result->cert_status) ||
+      !pickle.ReadBool(iter, &result->has_md5) ||
+      !pickle.ReadBool(iter, &result->has_md2) ||
+      !pickle.ReadBool(iter, &result->has_md4) ||
+      !pickle.ReadBool(iter, &result->has_md5_ca) ||
+      !pickle.ReadBool(iter, &result->has_md2_ca) ||
+      !pickle.ReadBool(iter, &result->is_issued_by_known_root) ||
+      !pickle.ReadInt(iter, &num_hashes) || num_hashes < 0) {
+    return false;
+  }
+  for (int i = 0; i < num_hashes; ++i) {
+    int tag;
+    const char* data;
+    int length;
+    if (!pickle.ReadInt(iter, &tag) || tag < 0 ||
+        tag >= HASH_VALUE_TAGS_COUNT ||
+        !pickle.ReadData(iter, &data, &length)) {
+      return false;
+    }
+    HashValue hash(static_cast<HashValueTag>(tag));
+    if (static_cast<size_t>(length) != hash.size())
+      return false;
+    memcpy(hash.data(), data, length);
+    result->public_key_hashes.push_back(hash);
+  }
+  result->verified_cert = X509Certificate::CreateFromPickle(
+      pickle, iter, X509Certificate::PICKLETYPE_CERTIFICATE_CHAIN_V3);
+  return result->verified_cert != NULL;
+}
+
+}  // namespace
+
+CertVerifierDiskCache::Entry::Entry() {}
+
+CertVerifierDiskCache::Entry::~Entry() {}
+
+CertVerifierDiskCache::CertVerifierDiskCache(
+    const FilePath& path,
+    base::SequencedTaskRunner* file_task_runner,
+    size_t max_entries,
+    base::TimeDelta ttl)
+    : path_(path),
+      file_task_runner_(file_task_runner),
+      max_entries_(max_entries),
+      ttl_(ttl),
+      loaded_(false),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+  DCHECK_GT(max_entries, 0u);
+}
+
+CertVerifierDiskCache::~CertVerifierDiskCache() {
+  DCHECK(CalledOnValidThread());
+  if (write_timer_.IsRunning())
+    Flush();
+}
+
+void CertVerifierDiskCache::Load() {
+  DCHECK(CalledOnValidThread());
+  std::string* data = new std::string;
+  file_task_runner_->PostTaskAndReply(
+      FROM_HERE, base::Bind(&ReadData, path_, data),
+      base::Bind(&CertVerifierDiskCache::OnLoaded, weak_factory_.GetWeakPtr(),
+                 base::Owned(data)));
+}
+
+bool CertVerifierDiskCache::Get(X509Certificate* cert,
+                                const std::string& hostname,
+                                int flags,
+                                uint32 crl_set_sequence,
+                                const base::Time& now,
+                                CertVerifyResult* verify_result) {
+  DCHECK(CalledOnValidThread());
+  EntryMap::iterator it =
+      entries_.find(MakeKey(cert, hostname, flags, crl_set_sequence));
+  if (it == entries_.end())
+    return false;
+
+  // As in MultiThreadedCertVerifier, a clock that has moved backwards makes
+  // the result as stale as one that has expired.
+  if (now < it->second.verification_time ||
+      now >= it->second.expiration_time) {
+    entries_.erase(it);
+    ScheduleWrite();
+    return false;
+  }
+  *verify_result = it->second.result;
+  return true;
+}
+
+void CertVerifierDiskCache::Put(X509Certificate* cert,
+                                const std::string& hostname,
+                                int flags,
+                                uint32 crl_set_sequence,
+                                const base::Time& now,
+                                const CertVerifyResult& verify_result) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(verify_result.verified_cert);
+  Entry entry;
+  entry.verification_time = now;
+  entry.expiration_time = now + ttl_;
+  entry.result = verify_result;
+  Insert(MakeKey(cert, hostname, flags, crl_set_sequence), entry);
+  ScheduleWrite();
+}
+
+void CertVerifierDiskCache::Clear() {
+  DCHECK(CalledOnValidThread());
+  entries_.clear();
+  Flush();
+}
+
+void CertVerifierDiskCache::Flush() {
+  DCHECK(CalledOnValidThread());
+  write_timer_.Stop();
+  Pickle pickle;
+  SerializeEntries(&pickle);
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&WriteData, path_,
+                 std::string(static_cast<const char*>(pickle.data()),
+                             pickle.size())));
+}
+
+// static
+std::string CertVerifierDiskCache::MakeKey(X509Certificate* cert,
+                                           const std::string& hostname,
+                                           int flags,
+                                           uint32 crl_set_sequence) {
+  const SHA1HashValue& cert_fingerprint = cert->fingerprint();
+  const SHA1HashValue& ca_fingerprint = cert->ca_fingerprint();
+  std::string key(reinterpret_cast<const char*>(cert_fingerprint.data),
+                  sizeof(cert_fingerprint.data));
+  key.append(reinterpret_cast<const char*>(ca_fingerprint.data),
+             sizeof(ca_fingerprint.data));
+  base::StringAppendF(&key, "%d/%u/", flags, crl_set_sequence);
+  key.append(hostname);
+  return key;
+}
+
+void CertVerifierDiskCache::OnLoaded(const std::string* data) {
+  DCHECK(CalledOnValidThread());
+  loaded_ = true;
+  if (data->empty())
+    return;
+
+  Pickle pickle(data->data(), static_cast<int>(data->size()));
+  if (!DeserializeEntries(pickle, base::Time::Now()))
+    LOG(WARNING) << "Invalid certificate verification cache file";
+}
+
+void CertVerifierDiskCache::Insert(const std::string& key,
+                                   const Entry& entry) {
+  if (entries_.size() >= max_entries_ && !entries_.count(key)) {
+    EntryMap::iterator oldest = entries_.begin();
+    for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->second.verification_time < oldest->second.verification_time)
+        oldest = it;
+    }
+    entries_.erase(oldest);
+  }
+  entries_[key] = entry;
+}
+
+void CertVerifierDiskCache::ScheduleWrite() {
+  if (write_timer_.IsRunning())
+    return;
+  write_timer_.Start(FROM_HERE,
+                     base::TimeDelta::FromSeconds(kWriteDelaySeconds),
+                     this, &CertVerifierDiskCache::Flush);
+}
+
+void CertVerifierDiskCache::SerializeEntries(Pickle* pickle) const {
+  pickle->WriteUInt32(kFileVersion);
+  pickle->WriteInt(static_cast<int>(entries_.size()));
+  for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+       ++it) {
+    pickle->WriteString(it->first);
+    pickle->WriteInt64(it->second.verification_time.ToInternalValue());
+    pickle->WriteInt64(it->second.expiration_time.ToInternalValue());
+    PersistResult(it->second.result, pickle);
+  }
+}
+
+bool CertVerifierDiskCache::DeserializeEntries(const Pickle& pickle,
+                                               const base::Time& now) {
+  PickleIterator iter(pickle);
+  uint32 version;
+  int num_entries;
+  if (!pickle.ReadUInt32(&iter, &version) || version != kFileVersion ||
+      !pickle.ReadInt(&iter, &num_entries) || num_entries < 0) {
+    return false;
+  }
+
+  for (int i = 0; i < num_entries; ++i) {
+    std::string key;
+    int64 verification_time;
+    int64 expiration_time;
+    Entry entry;
+    if (!pickle.ReadString(&iter, &key) ||
+        !pickle.ReadInt64(&iter, &verification_time) ||
+        !pickle.ReadInt64(&iter, &expiration_time) ||
+        !RestoreResult(pickle, &iter, &entry.result)) {
+      return false;
+    }
+    entry.verification_time = base::Time::FromInternalValue(verification_time);
+    entry.expiration_time = base::Time::FromInternalValue(expiration_time);
+
+    // Results added since Load() was called are newer than those in the file.
+    if (entries_.count(key) || now < entry.verification_time ||
+        now >= entry.expiration_time) {
+      continue;
+    }
+    Insert(key, entry);
+  }
+  return true;
+}
+
+}  // namespace net
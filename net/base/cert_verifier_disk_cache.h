@@ -0,0 +1,128 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_CERT_VERIFIER_DISK_CACHE_H_
+#define NET_BASE_CERT_VERIFIER_DISK_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "net/base/cert_verify_result.h"
+#include "net/base/net_export.h"
+
+class Pickle;
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace net {
+
+class X509Certificate;
+
+// CertVerifierDiskCache keeps successful certificate verification results in
+// a file, so that they survive restarts. Results are keyed by the
+// fingerprints of the certificate chain, the hostname, the verification flags
+// and the sequence number of the CRLSet used, so a CRLSet update makes all
+// earlier results miss.
+//
+// The file is read once, by Load(), and rewritten a few seconds after results
+// are added. All file access happens on |file_task_runner|; everything else
+// happens on the thread that created the cache.
+class NET_EXPORT_PRIVATE CertVerifierDiskCache
+    : NON_EXPORTED_BASE(public base::NonThreadSafe) {
+ public:
+  // |max_entries| bounds the size of the cache, both in memory and on disk.
+  // Results are used for |ttl| after the verification that produced them.
+  CertVerifierDiskCache(const FilePath& path,
+                        base::SequencedTaskRunner* file_task_runner,
+                        size_t max_entries,
+                        base::TimeDelta ttl);
+
+  // Writes any results that have not been written yet.
+  ~CertVerifierDiskCache();
+
+  // Starts reading the cache file. Get() misses until the file has been read.
+  void Load();
+
+  // Looks up the result of verifying |cert| for |hostname| with |flags| and
+  // the CRLSet numbered |crl_set_sequence|, at time |now|. On a hit, fills in
+  // |verify_result| and returns true.
+  bool Get(X509Certificate* cert,
+           const std::string& hostname,
+           int flags,
+           uint32 crl_set_sequence,
+           const base::Time& now,
+           CertVerifyResult* verify_result);
+
+  // Stores |verify_result|, the successful result of verifying |cert| at time
+  // |now|, evicting the oldest result if the cache is full.
+  void Put(X509Certificate* cert,
+           const std::string& hostname,
+           int flags,
+           uint32 crl_set_sequence,
+           const base::Time& now,
+           const CertVerifyResult& verify_result);
+
+  // Removes all results, in memory and on disk.
+  void Clear();
+
+  // Writes the results now instead of waiting for the write delay.
+  void Flush();
+
+  bool loaded() const { return loaded_; }
+  size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    base::Time verification_time;
+    base::Time expiration_time;
+    CertVerifyResult result;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+
+  static std::string MakeKey(X509Certificate* cert,
+                             const std::string& hostname,
+                             int flags,
+                             uint32 crl_set_sequence);
+
+  // Called on the origin thread with the contents of the cache file.
+  void OnLoaded(const std::string* data);
+
+  // Adds |entry| under |key|, evicting the oldest entry if the cache is full.
+  void Insert(const std::string& key, const Entry& entry);
+
+  // Schedules a write of the cache file.
+  void ScheduleWrite();
+
+  void SerializeEntries(Pickle* pickle) const;
+  bool DeserializeEntries(const Pickle& pickle, const base::Time& now);
+
+  const FilePath path_;
+  const scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  const size_t max_entries_;
+  const base::TimeDelta ttl_;
+
+  EntryMap entries_;
+  bool loaded_;
+  base::OneShotTimer<CertVerifierDiskCache> write_timer_;
+
+  base::WeakPtrFactory<CertVerifierDiskCache> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(CertVerifierDiskCache);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_CERT_VERIFIER_DISK_CACHE_H_
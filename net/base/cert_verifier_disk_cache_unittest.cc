@@ -0,0 +1,145 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/cert_verifier_disk_cache.h"
+
+#include "base/file_util.h"
+#include "base/message_loop.h"
+#include "base/message_loop_proxy.h"
+#include "base/scoped_temp_dir.h"
+#include "net/base/cert_test_util.h"
+#include "net/base/x509_certificate.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const size_t kMaxEntries = 2;
+const int kTTLHours = 24;
+
+class CertVerifierDiskCacheTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.path().AppendASCII("cert_verifier_cache");
+    cert_ = ImportCertFromFile(GetTestCertsDirectory(), "ok_cert.pem");
+    ASSERT_TRUE(cert_);
+    result_.verified_cert = cert_;
+    result_.is_issued_by_known_root = true;
+    HashValue hash(HASH_VALUE_SHA256);
+    memset(hash.data(), 0x42, hash.size());
+    result_.public_key_hashes.push_back(hash);
+  }
+
+  CertVerifierDiskCache* NewCache() {
+    return new CertVerifierDiskCache(path_, base::MessageLoopProxy::current(),
+                                     kMaxEntries,
+                                     base::TimeDelta::FromHours(kTTLHours));
+  }
+
+  // Writes |cache| to disk and returns a new cache loaded from the file.
+  CertVerifierDiskCache* Reload(CertVerifierDiskCache* cache) {
+    cache->Flush();
+    MessageLoop::current()->RunAllPending();
+    CertVerifierDiskCache* loaded = NewCache();
+    loaded->Load();
+    MessageLoop::current()->RunAllPending();
+    EXPECT_TRUE(loaded->loaded());
+    return loaded;
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+  scoped_refptr<X509Certificate> cert_;
+  CertVerifyResult result_;
+};
+
+}  // namespace
+
+TEST_F(CertVerifierDiskCacheTest, PutAndGetAfterReload) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<CertVerifierDiskCache> cache(NewCache());
+  cache->Put(cert_, "www.example.com", 0, 1, now, result_);
+  cache.reset(Reload(cache.get()));
+  EXPECT_EQ(1u, cache->size());
+
+  CertVerifyResult result;
+  ASSERT_TRUE(cache->Get(cert_, "www.example.com", 0, 1, now, &result));
+  EXPECT_TRUE(result.is_issued_by_known_root);
+  ASSERT_EQ(1u, result.public_key_hashes.size());
+  EXPECT_TRUE(
+      result.public_key_hashes[0].Equals(result_.public_key_hashes[0]));
+  EXPECT_TRUE(result.verified_cert->Equals(cert_));
+
+  // Any other hostname or flags miss.
+  EXPECT_FALSE(cache->Get(cert_, "www.example.org", 0, 1, now, &result));
+  EXPECT_FALSE(cache->Get(cert_, "www.example.com", 1, 1, now, &result));
+}
+
+// A newer CRLSet may revoke the certificate, so its results must not be used.
+TEST_F(CertVerifierDiskCacheTest, NewCRLSetMisses) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<CertVerifierDiskCache> cache(NewCache());
+  cache->Put(cert_, "www.example.com", 0, 1, now, result_);
+
+  CertVerifyResult result;
+  EXPECT_FALSE(cache->Get(cert_, "www.example.com", 0, 2, now, &result));
+  EXPECT_TRUE(cache->Get(cert_, "www.example.com", 0, 1, now, &result));
+}
+
+TEST_F(CertVerifierDiskCacheTest, Expiration) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<CertVerifierDiskCache> cache(NewCache());
+  cache->Put(cert_, "www.example.com", 0, 1, now, result_);
+
+  CertVerifyResult result;
+  // A clock that moved backwards misses.
+  EXPECT_FALSE(cache->Get(cert_, "www.example.com", 0, 1,
+                          now - base::TimeDelta::FromMinutes(1), &result));
+  EXPECT_EQ(0u, cache->size());
+
+  cache->Put(cert_, "www.example.com", 0, 1, now, result_);
+  EXPECT_FALSE(cache->Get(cert_, "www.example.com", 0, 1,
+                          now + base::TimeDelta::FromHours(kTTLHours),
+                          &result));
+  EXPECT_EQ(0u, cache->size());
+}
+
+TEST_F(CertVerifierDiskCacheTest, EvictsOldest) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<CertVerifierDiskCache> cache(NewCache());
+  cache->Put(cert_, "a.example.com", 0, 1, now, result_);
+  cache->Put(cert_, "b.example.com", 0, 1,
+             now - base::TimeDelta::FromMinutes(1), result_);
+  cache->Put(cert_, "c.example.com", 0, 1, now, result_);
+  EXPECT_EQ(kMaxEntries, cache->size());
+
+  CertVerifyResult result;
+  EXPECT_TRUE(cache->Get(cert_, "a.example.com", 0, 1, now, &result));
+  EXPECT_FALSE(cache->Get(cert_, "b.example.com", 0, 1, now, &result));
+  EXPECT_TRUE(cache->Get(cert_, "c.example.com", 0, 1, now, &result));
+}
+
+TEST_F(CertVerifierDiskCacheTest, ClearRemovesFile) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<CertVerifierDiskCache> cache(NewCache());
+  cache->Put(cert_, "www.example.com", 0, 1, now, result_);
+  cache->Clear();
+  cache.reset(Reload(cache.get()));
+  EXPECT_EQ(0u, cache->size());
+}
+
+TEST_F(CertVerifierDiskCacheTest, LoadInvalidFile) {
+  const char kGarbage[] = "not a certificate cache";
+  ASSERT_EQ(static_cast<int>(sizeof(kGarbage)),
+            file_util::WriteFile(path_, kGarbage, sizeof(kGarbage)));
+  scoped_ptr<CertVerifierDiskCache> cache(NewCache());
+  cache->Load();
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(cache->loaded());
+  EXPECT_EQ(0u, cache->size());
+}
+
+}  // namespace net
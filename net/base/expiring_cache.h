@@ -120,6 +120,21 @@ class ExpiringCache {
     return &it->second.first;
   }
 
+  // Returns the value matching |key| and sets |*expiration| to its expiration,
+  // whether or not it has expired. Returns NULL if the item is not found.
+  // Unlike Get(), this method does not remove expired items.
+  // Note: The returned pointer remains owned by the ExpiringCache and is
+  // invalidated by a call to a non-const method.
+  const ValueType* GetIncludingExpired(const KeyType& key,
+                                       ExpirationType* expiration) const {
+    typename EntryMap::const_iterator it = entries_.find(key);
+    if (it == entries_.end())
+      return NULL;
+
+    *expiration = it->second.second;
+    return &it->second.first;
+  }
+
   // Updates or replaces the value associated with |key|.
   void Put(const KeyType& key,
            const ValueType& value,
@@ -254,6 +254,31 @@ TEST(ExpiringCacheTest, GetTruncatesExpiredEntries) {
   EXPECT_EQ(6U, cache.size());
 }
 
+TEST(ExpiringCacheTest, GetIncludingExpired) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  Cache cache(kMaxCacheEntries);
+
+  // Start at t=0.
+  base::TimeTicks now;
+  cache.Put("test1", "foo1", now, now + kTTL);
+
+  base::TimeTicks expiration;
+  EXPECT_FALSE(cache.GetIncludingExpired("test2", &expiration));
+  EXPECT_THAT(cache.GetIncludingExpired("test1", &expiration),
+              Pointee(StrEq("foo1")));
+  EXPECT_EQ(now + kTTL, expiration);
+
+  // The entry is still returned once it has expired, and it is not removed.
+  now += 2 * kTTL;
+  EXPECT_THAT(cache.GetIncludingExpired("test1", &expiration),
+              Pointee(StrEq("foo1")));
+  EXPECT_EQ(1U, cache.size());
+
+  EXPECT_FALSE(cache.Get("test1", now));
+  EXPECT_FALSE(cache.GetIncludingExpired("test1", &expiration));
+}
+
 TEST(ExpiringCacheTest, CustomFunctor) {
   ExpiringCache<std::string, std::string, std::string, TestFunctor> cache(5);
 
@@ -0,0 +1,224 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/file_aio_context_linux.h"
+
+#include <errno.h>
+#include <linux/aio_abi.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "base/eintr_wrapper.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/stl_util.h"
+#include "base/threading/thread_local.h"
+#include "net/base/io_buffer.h"
+
+namespace net {
+namespace internal {
+
+namespace {
+
+// The header stores the context without including the kernel's AIO header.
+COMPILE_ASSERT(sizeof(aio_context_t) == sizeof(unsigned long),
+               aio_context_t_is_unsigned_long);
+
+// The number of reads that may be in flight on a thread. Reads beyond that
+// fail to submit and use the WorkerPool instead.
+const unsigned kMaxPendingReads = 256;
+
+// The number of completions reaped by each io_getevents() call.
+const long kMaxEventsPerCall = 32;
+
+bool g_enabled = false;
+
+// Set once setting up a context has failed, most likely because the kernel
+// has no native asynchronous I/O, so that it is not tried again.
+bool g_unavailable = false;
+
+base::LazyInstance<base::ThreadLocalPointer<FileAIOContextLinux> >
+    g_current_context = LAZY_INSTANCE_INITIALIZER;
+
+// glibc has no wrappers for the AIO system calls, and libaio is not worth a
+// dependency for these four.
+int IoSetup(unsigned max_events, aio_context_t* context) {
+  return syscall(__NR_io_setup, max_events, context);
+}
+
+int IoDestroy(aio_context_t context) {
+  return syscall(__NR_io_destroy, context);
+}
+
+int IoSubmit(aio_context_t context, long count, struct iocb** iocbs) {
+  return syscall(__NR_io_submit, context, count, iocbs);
+}
+
+int IoGetEvents(aio_context_t context, long min_count, long max_count,
+                struct io_event* events, struct timespec* timeout) {
+  return syscall(__NR_io_getevents, context, min_count, max_count, events,
+                 timeout);
+}
+
+}  // namespace
+
+struct FileAIOContextLinux::Request {
+  struct iocb control_block;
+  // Keeps the buffer alive until the kernel is done with it.
+  scoped_refptr<IOBuffer> buf;
+  ReadCallback callback;
+};
+
+// static
+void FileAIOContextLinux::SetEnabled(bool enabled) {
+  g_enabled = enabled;
+}
+
+// static
+FileAIOContextLinux* FileAIOContextLinux::GetForCurrentThread() {
+  if (!g_enabled || g_unavailable)
+    return NULL;
+  MessageLoop* loop = MessageLoop::current();
+  if (!loop || loop->type() != MessageLoop::TYPE_IO)
+    return NULL;
+
+  FileAIOContextLinux* context = g_current_context.Pointer()->Get();
+  if (context)
+    return context;
+
+  context = new FileAIOContextLinux;
+  if (!context->Init()) {
+    delete context;
+    g_unavailable = true;
+    return NULL;
+  }
+  g_current_context.Pointer()->Set(context);
+  loop->AddDestructionObserver(context);
+  return context;
+}
+
+bool FileAIOContextLinux::Read(base::PlatformFile file,
+                               int64 offset,
+                               IOBuffer* buf,
+                               int buf_len,
+                               const ReadCallback& callback) {
+  DCHECK_GT(buf_len, 0);
+  // Kernels that cannot queue a read of some file perform it synchronously
+  // in io_submit(), which would block this thread on a pipe or a socket.
+  struct stat file_info;
+  if (fstat(file, &file_info) != 0 || !S_ISREG(file_info.st_mode))
+    return false;
+
+  scoped_ptr<Request> request(new Request);
+  memset(&request->control_block, 0, sizeof(request->control_block));
+  request->control_block.aio_data = reinterpret_cast<uintptr_t>(request.get());
+  request->control_block.aio_lio_opcode = IOCB_CMD_PREAD;
+  request->control_block.aio_fildes = file;
+  request->control_block.aio_buf = reinterpret_cast<uintptr_t>(buf->data());
+  request->control_block.aio_nbytes = buf_len;
+  request->control_block.aio_offset = offset;
+  request->control_block.aio_flags = IOCB_FLAG_RESFD;
+  request->control_block.aio_resfd = event_fd_;
+  request->buf = buf;
+  request->callback = callback;
+
+  struct iocb* control_blocks[] = { &request->control_block };
+  // Fails with EAGAIN once kMaxPendingReads are in flight.
+  if (HANDLE_EINTR(IoSubmit(aio_context_, 1, control_blocks)) != 1) {
+    DVLOG(1) << "io_submit: " << strerror(errno);
+    return false;
+  }
+  pending_.insert(request.release());
+  return true;
+}
+
+FileAIOContextLinux::FileAIOContextLinux()
+    : aio_context_(0),
+      event_fd_(-1) {
+}
+
+FileAIOContextLinux::~FileAIOContextLinux() {
+  event_fd_watcher_.StopWatchingFileDescriptor();
+  // io_destroy() waits for the reads in flight, so that their buffers can be
+  // released.
+  if (aio_context_ && IoDestroy(aio_context_) != 0)
+    DPLOG(ERROR) << "io_destroy";
+  STLDeleteElements(&pending_);
+  if (event_fd_ >= 0 && HANDLE_EINTR(close(event_fd_)) != 0)
+    DPLOG(ERROR) << "close";
+  if (g_current_context.Pointer()->Get() == this)
+    g_current_context.Pointer()->Set(NULL);
+}
+
+bool FileAIOContextLinux::Init() {
+  aio_context_t aio_context = 0;
+  if (IoSetup(kMaxPendingReads, &aio_context) != 0) {
+    DPLOG(WARNING) << "io_setup";
+    return false;
+  }
+  aio_context_ = aio_context;
+
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd_ < 0) {
+    DPLOG(WARNING) << "eventfd";
+    return false;
+  }
+
+  return MessageLoopForIO::current()->WatchFileDescriptor(
+      event_fd_, true, MessageLoopForIO::WATCH_READ, &event_fd_watcher_,
+      this);
+}
+
+void FileAIOContextLinux::ProcessCompletions() {
+  // The kernel queues each completion before it adds to the eventfd's
+  // counter, so that many completions can be reaped now. Later ones signal
+  // the eventfd again, which keeps a callback that reads again from
+  // starving the message loop.
+  uint64 count = 0;
+  if (HANDLE_EINTR(read(event_fd_, &count, sizeof(count))) != sizeof(count)) {
+    DPLOG_IF(ERROR, errno != EAGAIN) << "read";
+    return;
+  }
+
+  struct io_event events[kMaxEventsPerCall];
+  struct timespec no_wait = { 0, 0 };
+  while (count > 0) {
+    long max_count = std::min(count, static_cast<uint64>(kMaxEventsPerCall));
+    int event_count = HANDLE_EINTR(IoGetEvents(
+        aio_context_, max_count, max_count, events, &no_wait));
+    if (event_count <= 0) {
+      DPLOG_IF(ERROR, event_count < 0) << "io_getevents";
+      return;
+    }
+    count -= event_count;
+    for (int i = 0; i < event_count; ++i) {
+      scoped_ptr<Request> request(reinterpret_cast<Request*>(events[i].data));
+      pending_.erase(request.get());
+      request->callback.Run(static_cast<int>(events[i].res));
+    }
+  }
+}
+
+void FileAIOContextLinux::OnFileCanReadWithoutBlocking(int fd) {
+  DCHECK_EQ(event_fd_, fd);
+  ProcessCompletions();
+}
+
+void FileAIOContextLinux::OnFileCanWriteWithoutBlocking(int fd) {
+  NOTREACHED();
+}
+
+void FileAIOContextLinux::WillDestroyCurrentMessageLoop() {
+  delete this;
+}
+
+}  // namespace internal
+}  // namespace net
@@ -0,0 +1,99 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_FILE_AIO_CONTEXT_LINUX_H_
+#define NET_BASE_FILE_AIO_CONTEXT_LINUX_H_
+
+#include <set>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/message_loop.h"
+#include "base/platform_file.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+class IOBuffer;
+
+namespace internal {
+
+// Reads files with the kernel's native asynchronous I/O (io_submit()), with
+// completions signaled through an eventfd that the thread's MessageLoopForIO
+// watches. A read then completes on the thread that started it, without the
+// two thread hops of reading on a WorkerPool thread.
+//
+// The kernel only queues reads of files opened with O_DIRECT. For other
+// files the data is copied during io_submit() when it is in the page cache,
+// and io_submit() may block to read it from the disk otherwise. That suits
+// small reads of hot files, such as cache index and entry reads, but not
+// large cold reads, so the backend is disabled unless SetEnabled() is called.
+class NET_EXPORT_PRIVATE FileAIOContextLinux
+    : public MessageLoopForIO::Watcher,
+      public MessageLoop::DestructionObserver {
+ public:
+  // Runs with the number of bytes read, or with -errno if the read failed.
+  typedef base::Callback<void(int)> ReadCallback;
+
+  // Enables or disables the backend for the whole process. Call it before
+  // any file is read.
+  static void SetEnabled(bool enabled);
+
+  // Returns the context of the current thread, creating it on first use.
+  // Returns NULL if the backend is disabled, if the current thread does not
+  // run a MessageLoopForIO or if the kernel does not support native
+  // asynchronous I/O.
+  static FileAIOContextLinux* GetForCurrentThread();
+
+  // Starts reading |buf_len| bytes at |offset| in |file| into |buf|, and
+  // returns true. |callback| runs on this thread when the read completes,
+  // unless this thread's MessageLoop is destroyed first. Returns false if
+  // |file| is not a regular file or if the read could not be submitted;
+  // |callback| is not run then.
+  bool Read(base::PlatformFile file,
+            int64 offset,
+            IOBuffer* buf,
+            int buf_len,
+            const ReadCallback& callback);
+
+  // Returns the number of reads that have not completed yet.
+  size_t pending_reads() const { return pending_.size(); }
+
+ private:
+  struct Request;
+
+  FileAIOContextLinux();
+  virtual ~FileAIOContextLinux();
+
+  // Sets up the kernel context and the eventfd. Returns false on failure.
+  bool Init();
+
+  // Runs the callbacks of the reads that have completed.
+  void ProcessCompletions();
+
+  // MessageLoopForIO::Watcher:
+  virtual void OnFileCanReadWithoutBlocking(int fd) OVERRIDE;
+  virtual void OnFileCanWriteWithoutBlocking(int fd) OVERRIDE;
+
+  // MessageLoop::DestructionObserver:
+  virtual void WillDestroyCurrentMessageLoop() OVERRIDE;
+
+  // The kernel AIO context (an aio_context_t).
+  unsigned long aio_context_;
+
+  // Signaled by the kernel when a read completes.
+  int event_fd_;
+  MessageLoopForIO::FileDescriptorWatcher event_fd_watcher_;
+
+  // The reads that have been submitted and have not completed.
+  std::set<Request*> pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileAIOContextLinux);
+};
+
+}  // namespace internal
+}  // namespace net
+
+#endif  // NET_BASE_FILE_AIO_CONTEXT_LINUX_H_
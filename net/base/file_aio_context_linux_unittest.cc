@@ -0,0 +1,162 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/file_aio_context_linux.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/scoped_temp_dir.h"
+#include "net/base/io_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace internal {
+
+namespace {
+
+const char kData[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+const int kDataSize = sizeof(kData) - 1;
+
+void OnRead(int* result_out, int result) {
+  *result_out = result;
+  MessageLoop::current()->Quit();
+}
+
+class FileAIOContextLinuxTest : public testing::Test {
+ protected:
+  FileAIOContextLinuxTest() : file_(-1) {}
+
+  virtual void SetUp() OVERRIDE {
+    FileAIOContextLinux::SetEnabled(true);
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    FilePath path = temp_dir_.path().AppendASCII("data");
+    ASSERT_EQ(kDataSize, file_util::WriteFile(path, kData, kDataSize));
+    file_ = open(path.value().c_str(), O_RDONLY);
+    ASSERT_LE(0, file_);
+  }
+
+  virtual void TearDown() OVERRIDE {
+    FileAIOContextLinux::SetEnabled(false);
+    if (file_ >= 0)
+      close(file_);
+  }
+
+  // Reads |buf_len| bytes at |offset| and returns the result, or INT_MIN if
+  // the read could not be submitted.
+  int ReadAt(int64 offset, IOBuffer* buf, int buf_len) {
+    FileAIOContextLinux* aio = FileAIOContextLinux::GetForCurrentThread();
+    if (!aio)
+      return kint32min;
+    int result = kint32min;
+    if (!aio->Read(file_, offset, buf, buf_len, base::Bind(&OnRead, &result)))
+      return kint32min;
+    EXPECT_EQ(1u, aio->pending_reads());
+    MessageLoop::current()->Run();
+    EXPECT_EQ(0u, aio->pending_reads());
+    return result;
+  }
+
+  ScopedTempDir temp_dir_;
+  int file_;
+};
+
+}  // namespace
+
+TEST_F(FileAIOContextLinuxTest, Read) {
+  MessageLoopForIO loop;
+  if (!FileAIOContextLinux::GetForCurrentThread())
+    return;  // The kernel has no native asynchronous I/O.
+
+  scoped_refptr<IOBuffer> buf(new IOBuffer(kDataSize));
+  EXPECT_EQ(kDataSize, ReadAt(0, buf, kDataSize));
+  EXPECT_EQ(std::string(kData), std::string(buf->data(), kDataSize));
+
+  EXPECT_EQ(4, ReadAt(10, buf, 4));
+  EXPECT_EQ("abcd", std::string(buf->data(), 4));
+
+  // A read that crosses the end of the file is short, and one past it
+  // returns 0.
+  EXPECT_EQ(2, ReadAt(kDataSize - 2, buf, 4));
+  EXPECT_EQ("yz", std::string(buf->data(), 2));
+  EXPECT_EQ(0, ReadAt(kDataSize + 10, buf, 4));
+
+  // Reading must not move the file position.
+  EXPECT_EQ(0, lseek(file_, 0, SEEK_CUR));
+}
+
+TEST_F(FileAIOContextLinuxTest, ManyReads) {
+  MessageLoopForIO loop;
+  FileAIOContextLinux* aio = FileAIOContextLinux::GetForCurrentThread();
+  if (!aio)
+    return;
+
+  const int kReads = 64;
+  scoped_refptr<IOBuffer> bufs[kReads];
+  int results[kReads];
+  for (int i = 0; i < kReads; ++i) {
+    bufs[i] = new IOBuffer(1);
+    results[i] = kint32min;
+    ASSERT_TRUE(aio->Read(file_, i % kDataSize, bufs[i], 1,
+                          base::Bind(&OnRead, &results[i])));
+  }
+  while (aio->pending_reads() > 0)
+    loop.Run();
+
+  for (int i = 0; i < kReads; ++i) {
+    EXPECT_EQ(1, results[i]);
+    EXPECT_EQ(kData[i % kDataSize], bufs[i]->data()[0]);
+  }
+}
+
+TEST_F(FileAIOContextLinuxTest, BadFile) {
+  MessageLoopForIO loop;
+  if (!FileAIOContextLinux::GetForCurrentThread())
+    return;
+
+  scoped_refptr<IOBuffer> buf(new IOBuffer(4));
+  close(file_);
+  file_ = -1;
+  EXPECT_EQ(kint32min, ReadAt(0, buf, 4));
+
+  // Only regular files are read with native asynchronous I/O.
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  file_ = fds[0];
+  EXPECT_EQ(kint32min, ReadAt(0, buf, 4));
+  close(fds[1]);
+}
+
+TEST_F(FileAIOContextLinuxTest, NoContext) {
+  {
+    // Completions are only watched for on a MessageLoopForIO.
+    MessageLoop loop(MessageLoop::TYPE_DEFAULT);
+    EXPECT_FALSE(FileAIOContextLinux::GetForCurrentThread());
+  }
+
+  MessageLoopForIO loop;
+  FileAIOContextLinux::SetEnabled(false);
+  EXPECT_FALSE(FileAIOContextLinux::GetForCurrentThread());
+}
+
+// Destroying the loop with a read in flight must not run its callback.
+TEST_F(FileAIOContextLinuxTest, DestroyLoopWithPendingRead) {
+  int result = kint32min;
+  {
+    MessageLoopForIO loop;
+    FileAIOContextLinux* aio = FileAIOContextLinux::GetForCurrentThread();
+    if (!aio)
+      return;
+    scoped_refptr<IOBuffer> buf(new IOBuffer(4));
+    ASSERT_TRUE(aio->Read(file_, 0, buf, 4, base::Bind(&OnRead, &result)));
+  }
+  EXPECT_EQ(kint32min, result);
+}
+
+}  // namespace internal
+}  // namespace net
@@ -0,0 +1,80 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdlib.h>
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/platform_file.h"
+#include "base/scoped_temp_dir.h"
+#include "net/base/file_stream.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if defined(OS_LINUX)
+#include "net/base/file_aio_context_linux.h"
+#endif
+
+namespace net {
+
+namespace {
+
+const int kFileSize = 4 * 1024 * 1024;
+const int kReadSize = 4 * 1024;
+const int kNumReads = 5000;
+
+class FileStreamPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.path().AppendASCII("data");
+    std::string data(kFileSize, 'x');
+    ASSERT_EQ(kFileSize,
+              file_util::WriteFile(path_, data.data(), kFileSize));
+  }
+
+  // Reads kNumReads blocks of kReadSize bytes at random offsets of the file,
+  // which is in the page cache, as the disk cache reads its entries.
+  void TimeRandomReads(const char* name) {
+    FileStream stream(NULL);
+    ASSERT_EQ(OK, stream.OpenSync(path_, base::PLATFORM_FILE_OPEN |
+                                         base::PLATFORM_FILE_READ |
+                                         base::PLATFORM_FILE_ASYNC));
+    scoped_refptr<IOBuffer> buf(new IOBuffer(kReadSize));
+    srand(1);
+
+    PerfTimeLogger timer(name);
+    for (int i = 0; i < kNumReads; ++i) {
+      int64 offset = (rand() % (kFileSize / kReadSize)) * kReadSize;
+      ASSERT_EQ(offset, stream.SeekSync(FROM_BEGIN, offset));
+      TestCompletionCallback callback;
+      int rv = stream.Read(buf, kReadSize, callback.callback());
+      ASSERT_EQ(kReadSize, callback.GetResult(rv));
+    }
+    timer.Done();
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+};
+
+}  // namespace
+
+TEST_F(FileStreamPerfTest, RandomReads) {
+  MessageLoopForIO loop;
+  TimeRandomReads("FileStream random reads (WorkerPool)");
+
+#if defined(OS_LINUX)
+  internal::FileAIOContextLinux::SetEnabled(true);
+  TimeRandomReads("FileStream random reads (native AIO)");
+  internal::FileAIOContextLinux::SetEnabled(false);
+#endif
+}
+
+}  // namespace net
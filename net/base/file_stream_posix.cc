@@ -31,6 +31,10 @@
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 
+#if defined(OS_LINUX)
+#include "net/base/file_aio_context_linux.h"
+#endif
+
 #if defined(OS_ANDROID)
 // Android's bionic libc only supports the LFS transitional API.
 #define off_t off64_t
@@ -466,6 +470,26 @@ int FileStreamPosix::Read(
   DCHECK(!weak_ptr_factory_.HasWeakPtrs());
   DCHECK(!on_io_complete_.get());
 
+#if defined(OS_LINUX)
+  // Read on this thread with native asynchronous I/O when it is enabled. The
+  // kernel keeps its own reference to the file, so closing |file_| while the
+  // read is in flight is safe, and nothing needs waiting for.
+  internal::FileAIOContextLinux* aio =
+      internal::FileAIOContextLinux::GetForCurrentThread();
+  if (aio) {
+    off_t offset = lseek(file_, 0, SEEK_CUR);
+    if (offset >= 0 &&
+        aio->Read(file_, offset, in_buf, buf_len,
+                  base::Bind(&FileStreamPosix::OnNativeReadComplete,
+                             weak_ptr_factory_.GetWeakPtr(),
+                             static_cast<int64>(offset), callback))) {
+      return ERR_IO_PENDING;
+    }
+    // Otherwise, such as for a pipe, read on the WorkerPool.
+    weak_ptr_factory_.InvalidateWeakPtrs();
+  }
+#endif
+
   on_io_complete_.reset(new base::WaitableEvent(
       false  /* manual_reset */, false  /* initially_signaled */));
 
@@ -636,6 +660,23 @@ void FileStreamPosix::OnClosed(const CompletionCallback& callback) {
   callback.Run(OK);
 }
 
+#if defined(OS_LINUX)
+void FileStreamPosix::OnNativeReadComplete(int64 offset,
+                                           const CompletionCallback& callback,
+                                           int result) {
+  // Reset this before Run() as Run() may issue a new async operation.
+  ResetOnIOComplete();
+  if (result < 0) {
+    callback.Run(RecordAndMapError(-result, FILE_ERROR_SOURCE_READ,
+                                   record_uma_, bound_net_log_));
+    return;
+  }
+  // The read did not move the file position, unlike read() does.
+  lseek(file_, offset + result, SEEK_SET);
+  callback.Run(result);
+}
+#endif
+
 void FileStreamPosix::WaitForIOCompletion() {
   // http://crbug.com/115067
   base::ThreadRestrictions::ScopedAllowWait allow_wait;
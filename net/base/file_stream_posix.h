@@ -62,6 +62,14 @@ class NET_EXPORT FileStreamPosix {
   // Called when the file_ is closed asynchronously.
   void OnClosed(const CompletionCallback& callback);
 
+#if defined(OS_LINUX)
+  // Called when a read started with native asynchronous I/O at |offset|
+  // completes, with the number of bytes read or -errno.
+  void OnNativeReadComplete(int64 offset,
+                            const CompletionCallback& callback,
+                            int result);
+#endif
+
   // Waits until the in-flight async open/close/read/write operation is
   // complete.
   void WaitForIOCompletion();
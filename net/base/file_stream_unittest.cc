@@ -19,6 +19,10 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
+#if defined(OS_LINUX)
+#include "net/base/file_aio_context_linux.h"
+#endif
+
 namespace net {
 
 namespace {
@@ -438,6 +442,42 @@ TEST_F(FileStreamTest, AsyncRead_FromOffset) {
   EXPECT_EQ(kTestData + kOffset, data_read);
 }
 
+#if defined(OS_LINUX)
+// Reads use the kernel's native asynchronous I/O when it is enabled, and the
+// file position must still advance as it does with read().
+TEST_F(FileStreamTest, AsyncRead_NativeAIO) {
+  internal::FileAIOContextLinux::SetEnabled(true);
+
+  FileStream stream(NULL);
+  int flags = base::PLATFORM_FILE_OPEN |
+              base::PLATFORM_FILE_READ |
+              base::PLATFORM_FILE_ASYNC;
+  int rv = stream.OpenSync(temp_file_path(), flags);
+  EXPECT_EQ(OK, rv);
+
+  const int64 kOffset = 3;
+  EXPECT_EQ(kOffset, stream.SeekSync(FROM_BEGIN, kOffset));
+
+  TestCompletionCallback callback;
+  std::string data_read;
+  for (;;) {
+    scoped_refptr<IOBufferWithSize> buf = new IOBufferWithSize(4);
+    rv = stream.Read(buf, buf->size(), callback.callback());
+    if (rv == ERR_IO_PENDING)
+      rv = callback.WaitForResult();
+    EXPECT_LE(0, rv);
+    if (rv <= 0)
+      break;
+    data_read.append(buf->data(), rv);
+    EXPECT_EQ(kOffset + static_cast<int64>(data_read.size()),
+              stream.SeekSync(FROM_CURRENT, 0));
+  }
+  EXPECT_EQ(kTestData + kOffset, data_read);
+
+  internal::FileAIOContextLinux::SetEnabled(false);
+}
+#endif
+
 TEST_F(FileStreamTest, SeekAround) {
   FileStream stream(NULL);
   int flags = base::PLATFORM_FILE_OPEN |
@@ -4,8 +4,12 @@
 
 #include "net/base/filter.h"
 
+#include <vector>
+
 #include "base/file_path.h"
+#include "base/lazy_instance.h"
 #include "base/string_util.h"
+#include "base/synchronization/lock.h"
 #include "net/base/gzip_filter.h"
 #include "net/base/io_buffer.h"
 #include "net/base/mime_util.h"
@@ -37,6 +41,50 @@ const char kTextHtml[]             = "text/html";
 // Buffer size allocated when de-compressing data.
 const int kFilterBufSize = 32 * 1024;
 
+// The largest a stream buffer grows to for a big, fast response.
+const int kMaxFilterBufSize = 256 * 1024;
+
+// Number of consecutive fills of the whole stream buffer after which it grows.
+const int kFullFlushesBeforeGrowing = 4;
+
+// Number of idle kFilterBufSize buffers kept for reuse by new filters.
+const size_t kMaxPooledFilterBuffers = 8;
+
+// Recycles the kFilterBufSize stream buffers of destroyed filters, so that a
+// page with many compressed resources doesn't allocate and free 32KB for
+// each of them.
+class FilterBufferPool {
+ public:
+  FilterBufferPool() {}
+
+  // Returns a pooled buffer, or a new one if the pool is empty.
+  scoped_refptr<net::IOBuffer> Take() {
+    base::AutoLock lock(lock_);
+    if (buffers_.empty())
+      return new net::IOBuffer(kFilterBufSize);
+    scoped_refptr<net::IOBuffer> buffer = buffers_.back();
+    buffers_.pop_back();
+    return buffer;
+  }
+
+  // Keeps |buffer|, a kFilterBufSize buffer nobody else references, for
+  // reuse if the pool has room.
+  void Return(const scoped_refptr<net::IOBuffer>& buffer) {
+    base::AutoLock lock(lock_);
+    if (buffers_.size() < kMaxPooledFilterBuffers)
+      buffers_.push_back(buffer);
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<scoped_refptr<net::IOBuffer> > buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(FilterBufferPool);
+};
+
+base::LazyInstance<FilterBufferPool>::Leaky g_filter_buffer_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 namespace net {
@@ -44,7 +92,12 @@ namespace net {
 FilterContext::~FilterContext() {
 }
 
-Filter::~Filter() {}
+Filter::~Filter() {
+  if (stream_buffer_ && stream_buffer_size_ == kFilterBufSize &&
+      stream_buffer_->HasOneRef()) {
+    g_filter_buffer_pool.Get().Return(stream_buffer_);
+  }
+}
 
 // static
 Filter* Filter::Factory(const std::vector<FilterType>& filter_types,
@@ -134,6 +187,10 @@ bool Filter::FlushStreamBuffer(int stream_data_len) {
 
   next_stream_data_ = stream_buffer()->data();
   stream_data_len_ = stream_data_len;
+  if (stream_data_len == stream_buffer_size_)
+    ++full_flush_count_;
+  else
+    full_flush_count_ = 0;
   return true;
 }
 
@@ -321,6 +378,7 @@ Filter::Filter()
       stream_buffer_size_(0),
       next_stream_data_(NULL),
       stream_data_len_(0),
+      full_flush_count_(0),
       next_filter_(NULL),
       last_status_(FILTER_NEED_MORE_DATA) {
 }
@@ -392,10 +450,23 @@ Filter* Filter::PrependNewFilter(FilterType type_id,
 void Filter::InitBuffer(int buffer_size) {
   DCHECK(!stream_buffer());
   DCHECK_GT(buffer_size, 0);
-  stream_buffer_ = new IOBuffer(buffer_size);
+  if (buffer_size == kFilterBufSize)
+    stream_buffer_ = g_filter_buffer_pool.Get().Take();
+  else
+    stream_buffer_ = new IOBuffer(buffer_size);
   stream_buffer_size_ = buffer_size;
 }
 
+void Filter::MaybeGrowStreamBuffer() {
+  if (stream_data_len_ || full_flush_count_ < kFullFlushesBeforeGrowing ||
+      stream_buffer_size_ * 2 > kMaxFilterBufSize) {
+    return;
+  }
+  stream_buffer_size_ *= 2;
+  stream_buffer_ = new IOBuffer(stream_buffer_size_);
+  full_flush_count_ = 0;
+}
+
 void Filter::PushDataIntoNextFilter() {
   IOBuffer* next_buffer = next_filter_->stream_buffer();
   int next_size = next_filter_->stream_buffer_size();
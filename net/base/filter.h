@@ -182,6 +182,13 @@ class NET_EXPORT_PRIVATE Filter {
   // The function returns true if success, and false otherwise.
   bool FlushStreamBuffer(int stream_data_len);
 
+  // Called by the owner of the filter before it refills an empty
+  // stream_buffer_.  When the last few fills have each used the whole buffer,
+  // the response is large and arriving quickly, so the buffer is doubled (up
+  // to a limit) to cut the number of read and decode rounds.  Callers must
+  // fetch stream_buffer() and stream_buffer_size() again afterwards.
+  void MaybeGrowStreamBuffer();
+
   // Translate the text of a filter name (from Content-Encoding header) into a
   // FilterType.
   static FilterType ConvertEncodingToType(const std::string& filter_type);
@@ -232,6 +239,10 @@ class NET_EXPORT_PRIVATE Filter {
   // Total number of remaining chars in stream_buffer_ to be filtered.
   int stream_data_len_;
 
+  // Number of consecutive FlushStreamBuffer() calls that filled the whole
+  // stream_buffer_.
+  int full_flush_count_;
+
  private:
   // Allocates and initializes stream_buffer_ and stream_buffer_size_.
   void InitBuffer(int size);
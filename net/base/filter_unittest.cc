@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "net/base/filter.h"
+
+#include "base/memory/scoped_ptr.h"
+#include "net/base/io_buffer.h"
 #include "net/base/mock_filter_context.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -347,4 +350,16 @@ TEST(FilterTest, SupportedMimeGzip) {
   EXPECT_TRUE(encoding_types.empty());
 }
 
+// The stream buffer of a destroyed filter is handed to the next filter.
+TEST(FilterTest, StreamBufferIsRecycled) {
+  scoped_ptr<Filter> filter(Filter::GZipFactory());
+  ASSERT_TRUE(filter.get());
+  IOBuffer* buffer = filter->stream_buffer();
+  filter.reset();
+
+  filter.reset(Filter::GZipFactory());
+  ASSERT_TRUE(filter.get());
+  EXPECT_EQ(buffer, filter->stream_buffer());
+}
+
 }  // namespace net
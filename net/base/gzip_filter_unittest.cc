@@ -330,6 +330,41 @@ TEST_F(GZipUnitTest, DecodeWithOneByteInputAndOutputBuffer) {
                              gzip_encode_buffer_, gzip_encode_len_, 1);
 }
 
+// Tests that the stream buffer grows while the response keeps filling it, as
+// URLRequestJob does for large responses, and that decoding is unaffected.
+TEST_F(GZipUnitTest, StreamBufferGrowsWhileFull) {
+  InitFilterWithBufferSize(Filter::FILTER_TYPE_GZIP, 1);
+
+  char decode_buffer[kDefaultBufferSize];
+  char* decode_next = decode_buffer;
+  int decode_avail_size = kDefaultBufferSize;
+  const char* encode_next = gzip_encode_buffer_;
+  int encode_avail_size = gzip_encode_len_;
+
+  int code = Filter::FILTER_OK;
+  while (code != Filter::FILTER_DONE && encode_avail_size > 0) {
+    filter_->MaybeGrowStreamBuffer();
+    int encode_data_len = std::min(encode_avail_size,
+                                   filter_->stream_buffer_size());
+    memcpy(filter_->stream_buffer()->data(), encode_next, encode_data_len);
+    filter_->FlushStreamBuffer(encode_data_len);
+    encode_next += encode_data_len;
+    encode_avail_size -= encode_data_len;
+
+    do {
+      int decode_data_len = decode_avail_size;
+      code = filter_->ReadData(decode_next, &decode_data_len);
+      ASSERT_NE(Filter::FILTER_ERROR, code);
+      decode_next += decode_data_len;
+      decode_avail_size -= decode_data_len;
+    } while (code == Filter::FILTER_OK);
+  }
+
+  EXPECT_GT(filter_->stream_buffer_size(), 1);
+  EXPECT_EQ(source_len(), kDefaultBufferSize - decode_avail_size);
+  EXPECT_EQ(0, memcmp(source_buffer(), decode_buffer, source_len()));
+}
+
 // Decoding deflate stream with corrupted data.
 TEST_F(GZipUnitTest, DecodeCorruptedData) {
   char corrupt_data[kDefaultBufferSize];
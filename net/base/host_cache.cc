@@ -5,15 +5,33 @@
 #include "net/base/host_cache.h"
 
 #include "base/logging.h"
+#include "base/pickle.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 
 namespace net {
 
+namespace {
+
+// Version of the data written by HostCache::Persist().
+const int kPersistVersion = 1;
+
+// Only successful resolutions that are still valid are persisted; failures
+// are cheap to retry and are usually cached for a short time.
+bool IsPersistable(const HostCache::Entry& entry,
+                   base::TimeTicks expiration,
+                   base::TimeTicks now) {
+  return entry.error == OK && now < expiration;
+}
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist)
     : error(error),
-      addrlist(addrlist) {
+      addrlist(addrlist),
+      hit_count(0) {
 }
 
 HostCache::Entry::~Entry() {
@@ -34,7 +52,25 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   if (caching_is_disabled())
     return NULL;
 
-  return entries_.Get(key, now);
+  const Entry* entry = entries_.Get(key, now);
+  if (entry)
+    ++entry->hit_count;
+  return entry;
+}
+
+const HostCache::Entry* HostCache::LookupStale(
+    const Key& key,
+    base::TimeTicks now,
+    base::TimeDelta* staleness) const {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return NULL;
+
+  base::TimeTicks expiration;
+  const Entry* entry = entries_.GetIncludingExpired(key, &expiration);
+  if (entry)
+    *staleness = now - expiration;
+  return entry;
 }
 
 void HostCache::Set(const Key& key,
@@ -46,7 +82,12 @@ void HostCache::Set(const Key& key,
   if (caching_is_disabled())
     return;
 
-  entries_.Put(key, Entry(error, addrlist), now, now + ttl);
+  Entry entry(error, addrlist);
+  base::TimeTicks expiration;
+  const Entry* old_entry = entries_.GetIncludingExpired(key, &expiration);
+  if (old_entry)
+    entry.hit_count = old_entry->hit_count;
+  entries_.Put(key, entry, now, now + ttl);
 }
 
 void HostCache::clear() {
@@ -54,6 +95,90 @@ void HostCache::clear() {
   entries_.Clear();
 }
 
+void HostCache::Persist(Pickle* pickle,
+                        base::TimeTicks now,
+                        base::Time wall_now) const {
+  DCHECK(CalledOnValidThread());
+  int num_entries = 0;
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    if (IsPersistable(it.value(), it.expiration(), now))
+      ++num_entries;
+  }
+
+  pickle->WriteInt(kPersistVersion);
+  pickle->WriteInt(num_entries);
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    if (!IsPersistable(it.value(), it.expiration(), now))
+      continue;
+    const AddressList& addrlist = it.value().addrlist;
+    pickle->WriteString(it.key().hostname);
+    pickle->WriteInt(it.key().address_family);
+    pickle->WriteInt(it.key().host_resolver_flags);
+    pickle->WriteInt64((wall_now + (it.expiration() - now)).ToInternalValue());
+    pickle->WriteString(addrlist.canonical_name());
+    pickle->WriteInt(static_cast<int>(addrlist.size()));
+    for (size_t i = 0; i < addrlist.size(); ++i) {
+      const IPAddressNumber& address = addrlist[i].address();
+      pickle->WriteData(reinterpret_cast<const char*>(&address[0]),
+                        static_cast<int>(address.size()));
+      pickle->WriteUInt16(static_cast<uint16>(addrlist[i].port()));
+    }
+  }
+}
+
+bool HostCache::Restore(const Pickle& pickle,
+                        base::TimeTicks now,
+                        base::Time wall_now) {
+  DCHECK(CalledOnValidThread());
+  PickleIterator iter(pickle);
+  int version;
+  int num_entries;
+  if (!iter.ReadInt(&version) || version != kPersistVersion ||
+      !iter.ReadInt(&num_entries)) {
+    return false;
+  }
+
+  for (int i = 0; i < num_entries; ++i) {
+    std::string hostname;
+    int address_family;
+    int host_resolver_flags;
+    int64 expiration;
+    std::string canonical_name;
+    int num_addresses;
+    if (!iter.ReadString(&hostname) || !iter.ReadInt(&address_family) ||
+        !iter.ReadInt(&host_resolver_flags) || !iter.ReadInt64(&expiration) ||
+        !iter.ReadString(&canonical_name) || !iter.ReadInt(&num_addresses) ||
+        address_family < ADDRESS_FAMILY_UNSPECIFIED ||
+        address_family > ADDRESS_FAMILY_IPV6 || num_addresses < 0) {
+      return false;
+    }
+
+    AddressList addrlist;
+    addrlist.set_canonical_name(canonical_name);
+    for (int j = 0; j < num_addresses; ++j) {
+      const char* data;
+      int length;
+      uint16 port;
+      if (!iter.ReadData(&data, &length) || !iter.ReadUInt16(&port) ||
+          (length != kIPv4AddressSize && length != kIPv6AddressSize)) {
+        return false;
+      }
+      addrlist.push_back(IPEndPoint(IPAddressNumber(data, data + length),
+                                    port));
+    }
+
+    Key key(hostname, static_cast<AddressFamily>(address_family),
+            host_resolver_flags);
+    base::TimeDelta ttl =
+        base::Time::FromInternalValue(expiration) - wall_now;
+    base::TimeTicks unused;
+    if (ttl <= base::TimeDelta() || entries_.GetIncludingExpired(key, &unused))
+      continue;
+    Set(key, OK, addrlist, now, ttl);
+  }
+  return true;
+}
+
 size_t HostCache::size() const {
   DCHECK(CalledOnValidThread());
   return entries_.size();
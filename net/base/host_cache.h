@@ -16,6 +16,8 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+class Pickle;
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -29,6 +31,11 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
     // The resolve results for this entry.
     int error;
     AddressList addrlist;
+
+    // Number of times this entry was returned by Lookup(), kept when the
+    // entry is overwritten by Set(). Used to find popular entries that are
+    // worth refreshing before they expire.
+    mutable int hit_count;
   };
 
   struct Key {
@@ -63,12 +70,21 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   ~HostCache();
 
   // Returns a pointer to the entry for |key|, which is valid at time
-  // |now|. If there is no such entry, returns NULL.
+  // |now|, and counts a hit on it. If there is no such entry, returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
+  // Returns a pointer to the entry for |key| whether or not it is valid at
+  // time |now|, and sets |*staleness| to how long ago it expired (a negative
+  // value if it is still valid). Unlike Lookup(), an expired entry is not
+  // removed. If there is no such entry, returns NULL.
+  const Entry* LookupStale(const Key& key,
+                           base::TimeTicks now,
+                           base::TimeDelta* staleness) const;
+
   // Overwrites or creates an entry for |key|.
   // (|error|, |addrlist|) is the value to set, |now| is the current time
-  // |ttl| is the "time to live".
+  // |ttl| is the "time to live". The hit count of an overwritten entry is
+  // kept.
   void Set(const Key& key,
            int error,
            const AddressList& addrlist,
@@ -78,6 +94,19 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // Empties the cache
   void clear();
 
+  // Writes the successful resolutions that are valid at time |now| to
+  // |pickle|, so that a later run can Restore() them. The expiration of each
+  // entry is written as a wall clock time; |wall_now| is the wall clock time
+  // that corresponds to |now|.
+  void Persist(Pickle* pickle, base::TimeTicks now, base::Time wall_now) const;
+
+  // Adds the entries written by Persist() to |pickle| that have not expired by
+  // |wall_now|, in wall clock time, keeping their remaining time to live.
+  // Entries that are already in the cache are kept as they are. Returns false
+  // if |pickle| is not valid, in which case the entries read before the error
+  // are kept.
+  bool Restore(const Pickle& pickle, base::TimeTicks now, base::Time wall_now);
+
   // Returns the number of entries in the cache.
   size_t size() const;
 
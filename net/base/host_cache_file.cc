@@ -0,0 +1,89 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/host_cache_file.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/time.h"
+#include "net/base/host_cache.h"
+
+namespace net {
+
+namespace {
+
+// Files larger than this are not loaded; a full cache is much smaller.
+const int64 kMaxFileSize = 1024 * 1024;
+
+void ReadData(const FilePath& path, std::string* data) {
+  int64 size;
+  if (!file_util::GetFileSize(path, &size) || size > kMaxFileSize)
+    return;
+  if (!file_util::ReadFileToString(path, data))
+    data->clear();
+}
+
+void WriteData(const FilePath& path, const std::string& data) {
+  FilePath temp_file;
+  if (!file_util::CreateTemporaryFileInDir(path.DirName(), &temp_file))
+    return;
+
+  int size = static_cast<int>(data.size());
+  if (file_util::WriteFile(temp_file, data.data(), size) != size ||
+      !file_util::ReplaceFile(temp_file, path)) {
+    LOG(ERROR) << "Failed to write the host cache";
+    file_util::Delete(temp_file, false);
+  }
+}
+
+}  // namespace
+
+HostCacheFile::HostCacheFile(const FilePath& path,
+                             base::SequencedTaskRunner* task_runner)
+    : path_(path),
+      task_runner_(task_runner),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+}
+
+HostCacheFile::~HostCacheFile() {
+  DCHECK(CalledOnValidThread());
+}
+
+void HostCacheFile::Load(HostCache* cache, const base::Closure& callback) {
+  DCHECK(CalledOnValidThread());
+  std::string* data = new std::string;
+  task_runner_->PostTaskAndReply(
+      FROM_HERE, base::Bind(&ReadData, path_, data),
+      base::Bind(&HostCacheFile::OnLoadComplete, weak_factory_.GetWeakPtr(),
+                 cache, callback, base::Owned(data)));
+}
+
+void HostCacheFile::Save(const HostCache& cache) {
+  DCHECK(CalledOnValidThread());
+  Pickle pickle;
+  cache.Persist(&pickle, base::TimeTicks::Now(), base::Time::Now());
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&WriteData, path_,
+                 std::string(static_cast<const char*>(pickle.data()),
+                             pickle.size())));
+}
+
+void HostCacheFile::OnLoadComplete(HostCache* cache,
+                                   const base::Closure& callback,
+                                   const std::string* data) {
+  DCHECK(CalledOnValidThread());
+  if (!data->empty()) {
+    Pickle pickle(data->data(), static_cast<int>(data->size()));
+    if (!cache->Restore(pickle, base::TimeTicks::Now(), base::Time::Now()))
+      LOG(WARNING) << "Invalid host cache file";
+  }
+  callback.Run();
+}
+
+}  // namespace net
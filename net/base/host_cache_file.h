@@ -0,0 +1,65 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_HOST_CACHE_FILE_H_
+#define NET_BASE_HOST_CACHE_FILE_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "net/base/net_export.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace net {
+
+class HostCache;
+
+// Keeps the successful entries of a HostCache in a file, so that the next
+// run of the browser can resolve the hosts it used recently without waiting
+// for the network. The entries keep their time to live across restarts;
+// entries that expire while the browser is not running are dropped when the
+// file is loaded.
+//
+// The file is read and written on |task_runner|, which must allow blocking
+// I/O. The cache itself is only touched on the thread that owns this object.
+class NET_EXPORT HostCacheFile
+    : NON_EXPORTED_BASE(public base::NonThreadSafe) {
+ public:
+  HostCacheFile(const FilePath& path, base::SequencedTaskRunner* task_runner);
+  ~HostCacheFile();
+
+  // Reads the file and adds its entries to |cache|, then runs |callback|.
+  // The entries already in |cache| are kept. |cache| must outlive this
+  // object; if this object is destroyed first, |cache| is left as it is and
+  // |callback| is not run.
+  void Load(HostCache* cache, const base::Closure& callback);
+
+  // Replaces the contents of the file with the entries of |cache| that are
+  // valid now. The write happens on the task runner; |cache| is not used
+  // after this method returns.
+  void Save(const HostCache& cache);
+
+ private:
+  void OnLoadComplete(HostCache* cache,
+                      const base::Closure& callback,
+                      const std::string* data);
+
+  const FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::WeakPtrFactory<HostCacheFile> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostCacheFile);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_HOST_CACHE_FILE_H_
@@ -0,0 +1,112 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/host_cache_file.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/message_loop.h"
+#include "base/message_loop_proxy.h"
+#include "base/scoped_temp_dir.h"
+#include "net/base/host_cache.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kMaxCacheEntries = 10;
+
+void SetTrue(bool* value) {
+  *value = true;
+}
+
+class HostCacheFileTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.path().AppendASCII("host_cache");
+  }
+
+  HostCacheFile* NewFile() {
+    return new HostCacheFile(path_, base::MessageLoopProxy::current());
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+};
+
+}  // namespace
+
+TEST_F(HostCacheFileTest, SaveAndLoad) {
+  HostCache::Key key("foobar.com", ADDRESS_FAMILY_UNSPECIFIED, 0);
+  IPAddressNumber address;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &address));
+  AddressList addrlist(IPEndPoint(address, 80));
+
+  HostCache cache(kMaxCacheEntries);
+  cache.Set(key, OK, addrlist, base::TimeTicks::Now(),
+            base::TimeDelta::FromHours(1));
+  scoped_ptr<HostCacheFile> file(NewFile());
+  file->Save(cache);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(file_util::PathExists(path_));
+
+  HostCache loaded(kMaxCacheEntries);
+  bool done = false;
+  file.reset(NewFile());
+  file->Load(&loaded, base::Bind(&SetTrue, &done));
+  EXPECT_FALSE(done);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(done);
+
+  const HostCache::Entry* entry = loaded.Lookup(key, base::TimeTicks::Now());
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(1U, entry->addrlist.size());
+  EXPECT_TRUE(entry->addrlist[0] == addrlist[0]);
+}
+
+TEST_F(HostCacheFileTest, LoadInvalidFile) {
+  HostCache cache(kMaxCacheEntries);
+  scoped_ptr<HostCacheFile> file(NewFile());
+
+  // A missing file leaves the cache empty.
+  bool done = false;
+  file->Load(&cache, base::Bind(&SetTrue, &done));
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(0U, cache.size());
+
+  const char kGarbage[] = "not a host cache";
+  ASSERT_EQ(static_cast<int>(sizeof(kGarbage)),
+            file_util::WriteFile(path_, kGarbage, sizeof(kGarbage)));
+  done = false;
+  file->Load(&cache, base::Bind(&SetTrue, &done));
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(0U, cache.size());
+}
+
+// Destroying the file before the load completes must not touch the cache.
+TEST_F(HostCacheFileTest, DestroyDuringLoad) {
+  HostCache cache(kMaxCacheEntries);
+  cache.Set(HostCache::Key("foobar.com", ADDRESS_FAMILY_UNSPECIFIED, 0), OK,
+            AddressList(), base::TimeTicks::Now(),
+            base::TimeDelta::FromHours(1));
+  scoped_ptr<HostCacheFile> file(NewFile());
+  file->Save(cache);
+  MessageLoop::current()->RunAllPending();
+
+  HostCache loaded(kMaxCacheEntries);
+  bool done = false;
+  file->Load(&loaded, base::Bind(&SetTrue, &done));
+  file.reset();
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(done);
+  EXPECT_EQ(0U, loaded.size());
+}
+
+}  // namespace net
@@ -5,10 +5,12 @@
 #include "net/base/host_cache.h"
 
 #include "base/format_macros.h"
+#include "base/pickle.h"
 #include "base/stl_util.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -22,6 +24,13 @@ HostCache::Key Key(const std::string& hostname) {
   return HostCache::Key(hostname, ADDRESS_FAMILY_UNSPECIFIED, 0);
 }
 
+// Returns an AddressList with the single address |literal|:|port|.
+AddressList MakeAddressList(const char* literal, int port) {
+  IPAddressNumber address;
+  EXPECT_TRUE(ParseIPLiteralToNumber(literal, &address));
+  return AddressList(IPEndPoint(address, port));
+}
+
 }  // namespace
 
 TEST(HostCacheTest, Basic) {
@@ -376,4 +385,162 @@ TEST(HostCacheTest, KeyComparators) {
   }
 }
 
+// Tests that LookupStale() returns expired entries without removing them.
+TEST(HostCacheTest, LookupStale) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now;
+  HostCache::Key key1 = Key("foobar.com");
+  base::TimeDelta staleness;
+
+  EXPECT_FALSE(cache.LookupStale(key1, now, &staleness));
+  cache.Set(key1, OK, AddressList(), now, kTTL);
+
+  // At t=5 the entry is still valid.
+  now += base::TimeDelta::FromSeconds(5);
+  EXPECT_EQ(cache.Lookup(key1, now), cache.LookupStale(key1, now, &staleness));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(-5), staleness);
+
+  // At t=12 the entry expired 2 seconds ago, and is still there.
+  now += base::TimeDelta::FromSeconds(7);
+  EXPECT_TRUE(cache.LookupStale(key1, now, &staleness));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(2), staleness);
+  EXPECT_EQ(1U, cache.size());
+
+  // Lookup() removes it.
+  EXPECT_FALSE(cache.Lookup(key1, now));
+  EXPECT_FALSE(cache.LookupStale(key1, now, &staleness));
+}
+
+// Tests that Lookup() counts hits, and that they survive Set().
+TEST(HostCacheTest, HitCount) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now;
+  HostCache::Key key1 = Key("foobar.com");
+  base::TimeDelta staleness;
+
+  cache.Set(key1, OK, AddressList(), now, kTTL);
+  EXPECT_EQ(0, cache.LookupStale(key1, now, &staleness)->hit_count);
+  EXPECT_EQ(1, cache.Lookup(key1, now)->hit_count);
+  EXPECT_EQ(2, cache.Lookup(key1, now)->hit_count);
+
+  // LookupStale() does not count as a hit.
+  EXPECT_EQ(2, cache.LookupStale(key1, now, &staleness)->hit_count);
+
+  // Refreshing the entry keeps the count, even after it expired.
+  now += base::TimeDelta::FromSeconds(12);
+  cache.Set(key1, OK, MakeAddressList("192.168.1.1", 80), now, kTTL);
+  EXPECT_EQ(3, cache.Lookup(key1, now)->hit_count);
+
+  // A new entry starts from zero.
+  cache.clear();
+  cache.Set(key1, OK, AddressList(), now, kTTL);
+  EXPECT_EQ(1, cache.Lookup(key1, now)->hit_count);
+}
+
+// Tests that the entries written by Persist() are restored with their
+// remaining time to live.
+TEST(HostCacheTest, PersistAndRestore) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now;
+  base::Time wall_now = base::Time::Now();
+
+  HostCache::Key key1 = Key("foobar.com");
+  HostCache::Key key2 = HostCache::Key("foobar2.com", ADDRESS_FAMILY_IPV6,
+                                       HOST_RESOLVER_CANONNAME);
+  HostCache::Key key3 = Key("foobar3.com");
+  HostCache::Key key4 = Key("foobar4.com");
+
+  AddressList addrlist1 = MakeAddressList("192.168.1.1", 80);
+  addrlist1.push_back(MakeAddressList("192.168.1.2", 81).front());
+  AddressList addrlist2 = MakeAddressList("::1", 443);
+  addrlist2.set_canonical_name("canonical.foobar2.com");
+
+  cache.Set(key1, OK, addrlist1, now, kTTL);
+  cache.Set(key2, OK, addrlist2, now, kTTL * 2);
+  // Failures and expired entries are not persisted.
+  cache.Set(key3, ERR_NAME_NOT_RESOLVED, AddressList(), now, kTTL);
+  cache.Set(key4, OK, AddressList(), now - kTTL, kTTL);
+
+  // Save at t=5.
+  now += base::TimeDelta::FromSeconds(5);
+  wall_now += base::TimeDelta::FromSeconds(5);
+  Pickle pickle;
+  cache.Persist(&pickle, now, wall_now);
+
+  // Restore 8 seconds later, with a different monotonic clock.
+  HostCache restored(kMaxCacheEntries);
+  base::TimeTicks later = now + base::TimeDelta::FromHours(1);
+  wall_now += base::TimeDelta::FromSeconds(8);
+  EXPECT_TRUE(restored.Restore(pickle, later, wall_now));
+
+  // key1 had expired by then.
+  EXPECT_EQ(1U, restored.size());
+  EXPECT_FALSE(restored.Lookup(key1, later));
+  EXPECT_FALSE(restored.Lookup(key3, later));
+  EXPECT_FALSE(restored.Lookup(key4, later));
+
+  // key2 has 7 seconds left.
+  const HostCache::Entry* entry = restored.Lookup(key2, later);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(OK, entry->error);
+  EXPECT_EQ("canonical.foobar2.com", entry->addrlist.canonical_name());
+  ASSERT_EQ(1U, entry->addrlist.size());
+  EXPECT_TRUE(entry->addrlist[0] == addrlist2[0]);
+  EXPECT_TRUE(restored.Lookup(key2, later + base::TimeDelta::FromSeconds(6)));
+  EXPECT_FALSE(restored.Lookup(key2, later + base::TimeDelta::FromSeconds(7)));
+
+  // Restoring right after saving brings both successful entries back, with
+  // all of their addresses.
+  HostCache restored2(kMaxCacheEntries);
+  wall_now -= base::TimeDelta::FromSeconds(8);
+  EXPECT_TRUE(restored2.Restore(pickle, later, wall_now));
+  EXPECT_EQ(2U, restored2.size());
+  entry = restored2.Lookup(key1, later);
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(2U, entry->addrlist.size());
+  EXPECT_TRUE(entry->addrlist[0] == addrlist1[0]);
+  EXPECT_TRUE(entry->addrlist[1] == addrlist1[1]);
+}
+
+// Tests that Restore() keeps the entries that are already in the cache and
+// rejects invalid data.
+TEST(HostCacheTest, RestoreExisting) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now;
+  base::Time wall_now = base::Time::Now();
+  HostCache::Key key1 = Key("foobar.com");
+
+  cache.Set(key1, OK, MakeAddressList("192.168.1.1", 80), now, kTTL);
+  Pickle pickle;
+  cache.Persist(&pickle, now, wall_now);
+
+  HostCache restored(kMaxCacheEntries);
+  AddressList newer = MakeAddressList("10.0.0.1", 80);
+  restored.Set(key1, OK, newer, now, kTTL);
+  EXPECT_TRUE(restored.Restore(pickle, now, wall_now));
+  const HostCache::Entry* entry = restored.Lookup(key1, now);
+  ASSERT_TRUE(entry);
+  EXPECT_TRUE(entry->addrlist[0] == newer[0]);
+
+  // The version is written first; an entry is missing.
+  int version;
+  PickleIterator iter(pickle);
+  ASSERT_TRUE(iter.ReadInt(&version));
+  Pickle truncated;
+  truncated.WriteInt(version);
+  truncated.WriteInt(1);
+  HostCache restored2(kMaxCacheEntries);
+  EXPECT_FALSE(restored2.Restore(truncated, now, wall_now));
+  EXPECT_FALSE(restored2.Restore(Pickle(), now, wall_now));
+  EXPECT_EQ(0U, restored2.size());
+}
+
 }  // namespace net
@@ -28,6 +28,7 @@
 #include "base/string_util.h"
 #include "base/threading/worker_pool.h"
 #include "base/time.h"
+#include "base/timer.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
 #include "net/base/address_family.h"
@@ -63,6 +64,11 @@ const unsigned kCacheEntryTTLSeconds = 60;
 // Default TTL for unsuccessful resolutions with ProcTask.
 const unsigned kNegativeCacheEntryTTLSeconds = 0;
 
+// Maximum TTL for unsuccessful resolutions, when the DNS server gave one.
+// RFC 2308 section 5 suggests one to three hours, but a name that does not
+// exist yet is often about to be created, so retry sooner than that.
+const unsigned kMaxNegativeCacheEntryTTLSeconds = 15 * 60;
+
 // Maximum of 6 concurrent resolver threads (excluding retries).
 // Some routers (or resolvers) appear to start to provide host-not-found if
 // too many simultaneous resolutions are pending.  This number needs to be
@@ -1045,6 +1051,8 @@ class HostResolverImpl::IPv6ProbeJob
 // TODO(szym): This could be moved to separate source file as well.
 class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
  public:
+  // On failure, |ttl| is how long the failure can be cached according to the
+  // DNS server, or zero if it did not say.
   typedef base::Callback<void(int net_error,
                               const AddressList& addr_list,
                               base::TimeDelta ttl)> Callback;
@@ -1060,26 +1068,43 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
     DCHECK(client);
     DCHECK(!callback.is_null());
 
-    // If unspecified, do IPv4 first, because suffix search will be faster.
-    uint16 qtype = (family_ == ADDRESS_FAMILY_IPV6) ?
-                   dns_protocol::kTypeAAAA :
-                   dns_protocol::kTypeA;
-    transaction_ = client_->GetTransactionFactory()->CreateTransaction(
-        key.hostname,
-        qtype,
-        base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
-                   true /* first_query */, base::TimeTicks::Now()),
-        net_log_);
+    // If unspecified, query for A and AAAA records at the same time, so that
+    // the slower query does not add to the latency of the other one.
+    if (family_ != ADDRESS_FAMILY_IPV6)
+      transaction_a_ = CreateTransaction(key.hostname, dns_protocol::kTypeA);
+    if (family_ != ADDRESS_FAMILY_IPV4) {
+      transaction_aaaa_ = CreateTransaction(key.hostname,
+                                            dns_protocol::kTypeAAAA);
+    }
   }
 
   int Start() {
     net_log_.BeginEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK);
-    return transaction_->Start();
+    int rv = ERR_IO_PENDING;
+    if (transaction_a_.get())
+      rv = transaction_a_->Start();
+    if (rv == ERR_IO_PENDING && transaction_aaaa_.get())
+      rv = transaction_aaaa_->Start();
+    if (rv != ERR_IO_PENDING) {
+      // Don't leave the other transaction running.
+      transaction_a_.reset();
+      transaction_aaaa_.reset();
+    }
+    return rv;
   }
 
  private:
-  void OnTransactionComplete(bool first_query,
-                             const base::TimeTicks& start_time,
+  scoped_ptr<DnsTransaction> CreateTransaction(const std::string& hostname,
+                                               uint16 qtype) {
+    return client_->GetTransactionFactory()->CreateTransaction(
+        hostname,
+        qtype,
+        base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
+                   base::TimeTicks::Now()),
+        net_log_);
+  }
+
+  void OnTransactionComplete(const base::TimeTicks& start_time,
                              DnsTransaction* transaction,
                              int net_error,
                              const DnsResponse* response) {
@@ -1088,7 +1113,11 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
     if (net_error != OK) {
       DNS_HISTOGRAM("AsyncDNS.TransactionFailure",
                     base::TimeTicks::Now() - start_time);
-      OnFailure(net_error, DnsResponse::DNS_PARSE_OK);
+      // An NXDOMAIN response says for how long the name does not exist.
+      base::TimeDelta negative_ttl;
+      if (net_error == ERR_NAME_NOT_RESOLVED && response)
+        response->ParseNegativeTTL(&negative_ttl);
+      OnFailure(net_error, DnsResponse::DNS_PARSE_OK, negative_ttl);
       return;
     }
 
@@ -1103,46 +1132,55 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
                               DnsResponse::DNS_PARSE_RESULT_MAX);
     if (result != DnsResponse::DNS_PARSE_OK) {
       // Fail even if the other query succeeds.
-      OnFailure(ERR_DNS_MALFORMED_RESPONSE, result);
+      OnFailure(ERR_DNS_MALFORMED_RESPONSE, result, base::TimeDelta());
       return;
     }
 
-    bool needs_sort = false;
-    if (first_query) {
-      DCHECK(client_->GetConfig()) <<
-          "Transaction should have been aborted when config changed!";
-      if (family_ == ADDRESS_FAMILY_IPV6) {
-        needs_sort = (addr_list.size() > 1);
-      } else if (family_ == ADDRESS_FAMILY_UNSPECIFIED) {
-        first_addr_list_ = addr_list;
-        first_ttl_ = ttl;
-        // Use fully-qualified domain name to avoid search.
-        transaction_ = client_->GetTransactionFactory()->CreateTransaction(
-            response->GetDottedName() + ".",
-            dns_protocol::kTypeAAAA,
-            base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
-                       false /* first_query */, base::TimeTicks::Now()),
-            net_log_);
-        net_error = transaction_->Start();
-        if (net_error != ERR_IO_PENDING)
-          OnFailure(net_error, DnsResponse::DNS_PARSE_OK);
-        return;
-      }
+    // Without addresses, keep the TTL of the negative answer instead, in case
+    // the other query has no addresses either.
+    if (addr_list.empty() && !response->ParseNegativeTTL(&ttl))
+      ttl = base::TimeDelta();
+
+    DCHECK(client_->GetConfig()) <<
+        "Transaction should have been aborted when config changed!";
+
+    if (transaction == transaction_a_.get()) {
+      transaction_a_.reset();
+      a_addr_list_ = addr_list;
+      a_ttl_ = ttl;
     } else {
-      DCHECK_EQ(ADDRESS_FAMILY_UNSPECIFIED, family_);
-      bool has_ipv6_addresses = !addr_list.empty();
-      if (!first_addr_list_.empty()) {
-        ttl = std::min(ttl, first_ttl_);
-        // Place IPv4 addresses after IPv6.
-        addr_list.insert(addr_list.end(), first_addr_list_.begin(),
-                                          first_addr_list_.end());
-      }
-      needs_sort = (has_ipv6_addresses && addr_list.size() > 1);
+      DCHECK_EQ(transaction_aaaa_.get(), transaction);
+      transaction_aaaa_.reset();
+      aaaa_addr_list_ = addr_list;
+      aaaa_ttl_ = ttl;
+    }
+
+    // Wait for the other query, if any.
+    if (transaction_a_.get() || transaction_aaaa_.get())
+      return;
+
+    // Place IPv4 addresses after IPv6.
+    addr_list = aaaa_addr_list_;
+    addr_list.insert(addr_list.end(), a_addr_list_.begin(),
+                                      a_addr_list_.end());
+    if (family_ == ADDRESS_FAMILY_IPV4) {
+      ttl = a_ttl_;
+    } else if (family_ == ADDRESS_FAMILY_IPV6) {
+      ttl = aaaa_ttl_;
+    } else if (addr_list.empty()) {
+      ttl = std::min(a_ttl_, aaaa_ttl_);
+    } else if (a_addr_list_.empty()) {
+      ttl = aaaa_ttl_;
+    } else if (aaaa_addr_list_.empty()) {
+      ttl = a_ttl_;
+    } else {
+      ttl = std::min(a_ttl_, aaaa_ttl_);
     }
+    bool needs_sort = (!aaaa_addr_list_.empty() && addr_list.size() > 1);
 
     if (addr_list.empty()) {
       // TODO(szym): Don't fallback to ProcTask in this case.
-      OnFailure(ERR_NAME_NOT_RESOLVED, DnsResponse::DNS_PARSE_OK);
+      OnFailure(ERR_NAME_NOT_RESOLVED, DnsResponse::DNS_PARSE_OK, ttl);
       return;
     }
 
@@ -1166,7 +1204,8 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
     if (!success) {
       DNS_HISTOGRAM("AsyncDNS.SortFailure",
                     base::TimeTicks::Now() - start_time);
-      OnFailure(ERR_DNS_SORT_ERROR, DnsResponse::DNS_PARSE_OK);
+      OnFailure(ERR_DNS_SORT_ERROR, DnsResponse::DNS_PARSE_OK,
+                base::TimeDelta());
       return;
     }
 
@@ -1176,19 +1215,26 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
     // AddressSorter prunes unusable destinations.
     if (addr_list.empty()) {
       LOG(WARNING) << "Address list empty after RFC3484 sort";
-      OnFailure(ERR_NAME_NOT_RESOLVED, DnsResponse::DNS_PARSE_OK);
+      OnFailure(ERR_NAME_NOT_RESOLVED, DnsResponse::DNS_PARSE_OK,
+                base::TimeDelta());
       return;
     }
 
     OnSuccess(addr_list, ttl);
   }
 
-  void OnFailure(int net_error, DnsResponse::Result result) {
+  // |negative_ttl| is how long the DNS server said the failure can be cached,
+  // or zero if it did not say.
+  void OnFailure(int net_error,
+                 DnsResponse::Result result,
+                 base::TimeDelta negative_ttl) {
     DCHECK_NE(OK, net_error);
+    transaction_a_.reset();
+    transaction_aaaa_.reset();
     net_log_.EndEvent(
         NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK,
         base::Bind(&NetLogDnsTaskFailedCallback, net_error, result));
-    callback_.Run(net_error, AddressList(), base::TimeDelta());
+    callback_.Run(net_error, AddressList(), negative_ttl);
   }
 
   void OnSuccess(const AddressList& addr_list, base::TimeDelta ttl) {
@@ -1203,11 +1249,15 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
   Callback callback_;
   const BoundNetLog net_log_;
 
-  scoped_ptr<DnsTransaction> transaction_;
+  // The queries for A and AAAA records, reset when they complete.
+  scoped_ptr<DnsTransaction> transaction_a_;
+  scoped_ptr<DnsTransaction> transaction_aaaa_;
 
-  // Results from the first transaction. Used only if |family_| is unspecified.
-  AddressList first_addr_list_;
-  base::TimeDelta first_ttl_;
+  // Results of the completed queries.
+  AddressList a_addr_list_;
+  base::TimeDelta a_ttl_;
+  AddressList aaaa_addr_list_;
+  base::TimeDelta aaaa_ttl_;
 
   DISALLOW_COPY_AND_ASSIGN(DnsTask);
 };
@@ -1229,10 +1279,13 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
         had_non_speculative_request_(false),
         had_dns_config_(false),
         dns_task_error_(OK),
+        serving_stale_(false),
+        is_refresh_(false),
         creation_time_(base::TimeTicks::Now()),
         priority_change_time_(creation_time_),
         net_log_(BoundNetLog::Make(request_net_log.net_log(),
-                                   NetLog::SOURCE_HOST_RESOLVER_IMPL_JOB)) {
+                                   NetLog::SOURCE_HOST_RESOLVER_IMPL_JOB)),
+        ALLOW_THIS_IN_INITIALIZER_LIST(weak_ptr_factory_(this)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CREATE_JOB);
 
     net_log_.BeginEvent(
@@ -1325,7 +1378,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
                    req->request_net_log().source(),
                    priority()));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || caches_without_requests()) {
+      // A Job that served stale addresses or that was started to refresh the
+      // cache keeps running to update the cache.
       UpdatePriority();
     } else {
       // If we were called from a Request's callback within CompleteRequests,
@@ -1335,6 +1390,36 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     }
   }
 
+  // Completes the requests that allow cached responses with |addr_list|, the
+  // addresses of an expired cache entry, if this Job has not completed after
+  // |delay|. Only the first call has any effect.
+  void SetStaleAddresses(const AddressList& addr_list, base::TimeDelta delay) {
+    if (serving_stale_ || stale_timer_.IsRunning())
+      return;
+    stale_addresses_ = addr_list;
+    stale_timer_.Start(FROM_HERE, delay, this, &Job::ServeStaleAddresses);
+  }
+
+  // True once the requests of this Job have been completed with stale
+  // addresses. New requests that allow cached responses should be completed
+  // with stale_addresses() right away.
+  bool is_serving_stale() const {
+    return serving_stale_;
+  }
+
+  const AddressList& stale_addresses() const {
+    return stale_addresses_;
+  }
+
+  // Marks this Job as a refresh of the cache entry for its key, so that it
+  // runs and updates the cache without any requests. Must be called before
+  // Schedule().
+  void MarkAsRefresh() {
+    DCHECK(requests_.empty());
+    DCHECK(!is_queued());
+    is_refresh_ = true;
+  }
+
   // Called from AbortAllInProgressJobs. Completes all requests as aborted
   // and destroys the job.
   void Abort() {
@@ -1360,7 +1445,11 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
   // Attempts to serve the job from HOSTS. Returns true if succeeded and
   // this Job was destroyed.
   bool ServeFromHosts() {
-    DCHECK_GT(num_active_requests(), 0u);
+    DCHECK(num_active_requests() > 0 || caches_without_requests());
+    // A refresh Job might have no request to take the port from. It updates
+    // the cache from DNS instead.
+    if (requests_.empty())
+      return false;
     AddressList addr_list;
     if (resolver_->ServeFromHosts(key(),
                                   requests_.front()->info(),
@@ -1425,6 +1514,33 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     }
   }
 
+  // Called by |stale_timer_| when the Job is taking too long.
+  void ServeStaleAddresses() {
+    serving_stale_ = true;
+    net_log_.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_STALE_CACHE_HIT);
+
+    base::WeakPtr<Job> self = weak_ptr_factory_.GetWeakPtr();
+    // A callback can attach new requests to this Job, so don't use iterators.
+    for (size_t i = 0; i < requests_.size(); ++i) {
+      Request* req = requests_[i];
+      if (req->was_canceled() || !req->info().allow_cached_response())
+        continue;
+
+      DCHECK_EQ(this, req->job());
+      priority_tracker_.Remove(req->info().priority());
+      req->request_net_log().AddEvent(
+          NetLog::TYPE_HOST_RESOLVER_IMPL_STALE_CACHE_HIT);
+      LogFinishRequest(req->source_net_log(), req->request_net_log(),
+                       req->info(), OK);
+      req->OnComplete(OK, stale_addresses_);
+
+      // The callback could have destroyed the resolver, and this Job with it.
+      if (!self)
+        return;
+    }
+    UpdatePriority();
+  }
+
   // TODO(szym): Since DnsTransaction does not consume threads, we can increase
   // the limits on |dispatcher_|. But in order to keep the number of WorkerPool
   // threads low, we will need to use an "inner" PrioritizedDispatcher with
@@ -1466,8 +1582,15 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
 
     base::TimeDelta ttl = base::TimeDelta::FromSeconds(
         kNegativeCacheEntryTTLSeconds);
-    if (net_error == OK)
+    if (net_error == OK) {
       ttl = base::TimeDelta::FromSeconds(kCacheEntryTTLSeconds);
+    } else if (net_error == ERR_NAME_NOT_RESOLVED &&
+               dns_task_error_ == ERR_NAME_NOT_RESOLVED) {
+      // Both agree that the name does not exist, so trust the DNS server on
+      // how long that lasts.
+      ttl = std::min(dns_task_negative_ttl_, base::TimeDelta::FromSeconds(
+          kMaxNegativeCacheEntryTTLSeconds));
+    }
 
     CompleteRequests(net_error, addr_list, ttl);
   }
@@ -1497,6 +1620,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
 
     if (net_error != OK) {
       dns_task_error_ = net_error;
+      dns_task_negative_ttl_ = ttl;
       dns_task_.reset();
 
       // TODO(szym): Run ServeFromHosts now if nsswitch.conf says so.
@@ -1546,7 +1670,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
       handle_.Reset();
     }
 
-    if (num_active_requests() == 0) {
+    // If the requests were completed with stale addresses, or this Job is a
+    // refresh, the result is still cached below.
+    if (num_active_requests() == 0 && !caches_without_requests()) {
       net_log_.AddEvent(NetLog::TYPE_CANCELLED);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1556,9 +1682,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                       net_error);
 
-    DCHECK(!requests_.empty());
+    DCHECK(!requests_.empty() || is_refresh_);
 
-    if (net_error == OK) {
+    if (net_error == OK && !requests_.empty()) {
       SetPortOnAddressList(requests_.front()->info().port(), &list);
       // Record this histogram here, when we know the system has a valid DNS
       // configuration.
@@ -1606,6 +1732,12 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     return priority_tracker_.total_count();
   }
 
+  // True if this Job should complete and cache its result even when it has
+  // no active requests.
+  bool caches_without_requests() const {
+    return serving_stale_ || is_refresh_;
+  }
+
   bool is_dns_running() const {
     return dns_task_.get() != NULL;
   }
@@ -1629,6 +1761,19 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
   // Result of DnsTask.
   int dns_task_error_;
 
+  // Addresses of the expired cache entry, served by |stale_timer_|.
+  AddressList stale_addresses_;
+  base::OneShotTimer<Job> stale_timer_;
+
+  // True once the requests have been completed with |stale_addresses_|.
+  bool serving_stale_;
+
+  // True if this Job was started to refresh a cache entry before it expires.
+  bool is_refresh_;
+
+  // How long the failure of DnsTask can be cached, according to the server.
+  base::TimeDelta dns_task_negative_ttl_;
+
   const base::TimeTicks creation_time_;
   base::TimeTicks priority_change_time_;
 
@@ -1645,6 +1790,8 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
 
   // A handle used in |HostResolverImpl::dispatcher_|.
   PrioritizedDispatcher::Handle handle_;
+
+  base::WeakPtrFactory<Job> weak_ptr_factory_;
 };
 
 //-----------------------------------------------------------------------------
@@ -1667,10 +1814,14 @@ HostResolverImpl::HostResolverImpl(
     scoped_ptr<DnsClient> dns_client,
     NetLog* net_log)
     : cache_(cache),
+      memory_pressure_listener_(
+          base::Bind(&HostResolverImpl::OnMemoryPressure,
+                     base::Unretained(this))),
       dispatcher_(job_limits),
       max_queued_jobs_(job_limits.total_jobs * 100u),
       proc_params_(proc_params),
       default_address_family_(ADDRESS_FAMILY_UNSPECIFIED),
+      refresh_min_hits_(0),
       weak_ptr_factory_(this),
       dns_client_(dns_client.Pass()),
       received_dns_config_(false),
@@ -1719,6 +1870,24 @@ void HostResolverImpl::SetMaxQueuedJobs(size_t value) {
   max_queued_jobs_ = value;
 }
 
+void HostResolverImpl::SetServeStaleOptions(base::TimeDelta max_staleness,
+                                            base::TimeDelta delay) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_GE(max_staleness.InMicroseconds(), 0);
+  DCHECK_GE(delay.InMicroseconds(), 0);
+  max_stale_age_ = max_staleness;
+  stale_delay_ = delay;
+}
+
+void HostResolverImpl::SetRefreshOptions(int min_hits,
+                                         base::TimeDelta window) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_GE(min_hits, 0);
+  DCHECK_GE(window.InMicroseconds(), 0);
+  refresh_min_hits_ = min_hits;
+  refresh_window_ = window;
+}
+
 int HostResolverImpl::Resolve(const RequestInfo& info,
                               AddressList* addresses,
                               const CompletionCallback& callback,
@@ -1738,6 +1907,10 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
   // outstanding jobs map.
   Key key = GetEffectiveKeyForRequest(info);
 
+  // Look for an expired entry first, since ResolveHelper() removes it.
+  AddressList stale_addresses;
+  bool have_stale_addresses = ServeStaleFromCache(key, info, &stale_addresses);
+
   int rv = ResolveHelper(key, info, addresses, request_net_log);
   if (rv != ERR_DNS_CACHE_MISS) {
     LogFinishRequest(source_net_log, request_net_log, info, rv);
@@ -1750,6 +1923,15 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
 
   JobMap::iterator jobit = jobs_.find(key);
   Job* job;
+  if (jobit != jobs_.end() && jobit->second->is_serving_stale() &&
+      info.allow_cached_response()) {
+    // The Job is already late, don't wait for it.
+    *addresses = jobit->second->stale_addresses();
+    EnsurePortOnAddressList(info.port(), addresses);
+    request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_STALE_CACHE_HIT);
+    LogFinishRequest(source_net_log, request_net_log, info, OK);
+    return OK;
+  }
   if (jobit == jobs_.end()) {
     // If we couldn't find the desired address family, check to see if the
     // other family is in the cache or another job, which indicates waste,
@@ -1820,7 +2002,10 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
     *out_req = reinterpret_cast<RequestHandle>(req.get());
 
   job->AddRequest(req.Pass());
-  // Completion happens during Job::CompleteRequests().
+  if (have_stale_addresses)
+    job->SetStaleAddresses(stale_addresses, stale_delay_);
+  // Completion happens during Job::CompleteRequests(), or
+  // Job::ServeStaleAddresses().
   return ERR_IO_PENDING;
 }
 
@@ -1839,6 +2024,7 @@ int HostResolverImpl::ResolveHelper(const Key& key,
     return net_error;
   if (ServeFromCache(key, info, &net_error, addresses)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT);
+    MaybeRefreshCacheEntry(key, request_net_log);
     return net_error;
   }
   // TODO(szym): Do not do this if nsswitch.conf instructs not to.
@@ -1964,6 +2150,55 @@ bool HostResolverImpl::ServeFromCache(const Key& key,
   return true;
 }
 
+bool HostResolverImpl::ServeStaleFromCache(const Key& key,
+                                           const RequestInfo& info,
+                                           AddressList* addresses) {
+  DCHECK(addresses);
+  if (max_stale_age_ == base::TimeDelta() || !info.allow_cached_response() ||
+      !cache_.get()) {
+    return false;
+  }
+
+  base::TimeDelta staleness;
+  const HostCache::Entry* cache_entry = cache_->LookupStale(
+      key, base::TimeTicks::Now(), &staleness);
+  if (!cache_entry || cache_entry->error != OK ||
+      staleness < base::TimeDelta() || staleness > max_stale_age_) {
+    return false;
+  }
+
+  *addresses = cache_entry->addrlist;
+  return true;
+}
+
+void HostResolverImpl::MaybeRefreshCacheEntry(
+    const Key& key,
+    const BoundNetLog& request_net_log) {
+  if (refresh_window_ == base::TimeDelta() || !cache_.get() ||
+      jobs_.count(key) > 0) {
+    return;
+  }
+
+  base::TimeDelta staleness;
+  const HostCache::Entry* cache_entry = cache_->LookupStale(
+      key, base::TimeTicks::Now(), &staleness);
+  if (!cache_entry || cache_entry->error != OK ||
+      cache_entry->hit_count < refresh_min_hits_ ||
+      -staleness > refresh_window_) {
+    return;
+  }
+
+  // Refreshing is only an optimization, don't evict Jobs that have requests.
+  if (dispatcher_.num_queued_jobs() >= max_queued_jobs_)
+    return;
+
+  request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_REFRESH);
+  Job* job = new Job(this, key, IDLE, request_net_log);
+  job->MarkAsRefresh();
+  job->Schedule();
+  jobs_.insert(std::make_pair(key, job));
+}
+
 bool HostResolverImpl::ServeFromHosts(const Key& key,
                                       const RequestInfo& info,
                                       AddressList* addresses) {
@@ -2148,6 +2383,14 @@ void HostResolverImpl::OnDNSChanged() {
     TryServingAllJobsFromHosts();
 }
 
+void HostResolverImpl::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL &&
+      cache_.get()) {
+    cache_->clear();
+  }
+}
+
 bool HostResolverImpl::HaveDnsConfig() const {
   return (dns_client_.get() != NULL) && (dns_client_->GetConfig() != NULL);
 }
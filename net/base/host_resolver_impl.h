@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
@@ -130,6 +131,22 @@ class NET_EXPORT HostResolverImpl
   // Only allowed when the queue is empty.
   void SetMaxQueuedJobs(size_t value);
 
+  // Allows requests for a host whose cache entry expired less than
+  // |max_staleness| ago to be completed with the expired addresses if the
+  // Job that refreshes the entry has not finished after |delay|. The Job
+  // keeps running and caches the fresh result when it is done. Requests that
+  // don't allow cached responses always wait for the Job. Serving stale
+  // entries is disabled when |max_staleness| is zero, which is the default.
+  void SetServeStaleOptions(base::TimeDelta max_staleness,
+                            base::TimeDelta delay);
+
+  // Refreshes a successful cache entry in the background, at the lowest
+  // priority, when a request is served from it less than |window| before it
+  // expires and it has served at least |min_hits| requests, so that popular
+  // hosts don't wait for a resolution when their entries expire. Refreshing
+  // is disabled when |window| is zero, which is the default.
+  void SetRefreshOptions(int min_hits, base::TimeDelta window);
+
   // HostResolver methods:
   virtual int Resolve(const RequestInfo& info,
                       AddressList* addresses,
@@ -181,6 +198,19 @@ class NET_EXPORT HostResolverImpl
                       int* net_error,
                       AddressList* addresses);
 
+  // If serving stale entries is enabled and |key| is found in cache with a
+  // positive entry that has expired less than |max_stale_age_| ago, returns
+  // true and fills |addresses|. Otherwise returns false.
+  bool ServeStaleFromCache(const Key& key,
+                           const RequestInfo& info,
+                           AddressList* addresses);
+
+  // Starts a Job to refresh the cache entry for |key|, which just served a
+  // request, if refreshing is enabled and the entry is due for it. See
+  // SetRefreshOptions().
+  void MaybeRefreshCacheEntry(const Key& key,
+                              const BoundNetLog& request_net_log);
+
   // If we have a DnsClient with a valid DnsConfig, and |key| is found in the
   // HOSTS file, returns true and fills |addresses|. Otherwise returns false.
   bool ServeFromHosts(const Key& key,
@@ -221,6 +251,10 @@ class NET_EXPORT HostResolverImpl
   // NetworkChangeNotifier::DNSObserver:
   virtual void OnDNSChanged() OVERRIDE;
 
+  // Drops the cached results when the system is critically low on memory.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   // True if have a DnsClient with a valid DnsConfig.
   bool HaveDnsConfig() const;
 
@@ -232,6 +266,8 @@ class NET_EXPORT HostResolverImpl
   // Cache of host resolution results.
   scoped_ptr<HostCache> cache_;
 
+  base::MemoryPressureListener memory_pressure_listener_;
+
   // Map from HostCache::Key to a Job.
   JobMap jobs_;
 
@@ -247,6 +283,14 @@ class NET_EXPORT HostResolverImpl
   // Address family to use when the request doesn't specify one.
   AddressFamily default_address_family_;
 
+  // Options for serving expired cache entries, see SetServeStaleOptions().
+  base::TimeDelta max_stale_age_;
+  base::TimeDelta stale_delay_;
+
+  // Options for refreshing cache entries, see SetRefreshOptions().
+  int refresh_min_hits_;
+  base::TimeDelta refresh_window_;
+
   base::WeakPtrFactory<HostResolverImpl> weak_ptr_factory_;
 
   // If present, used by DnsTask and ServeFromHosts to resolve requests.
@@ -1174,6 +1174,139 @@ TEST_F(HostResolverImplTest, ResolveFromCache) {
   EXPECT_TRUE(requests_[2]->HasOneAddress("192.168.1.42", 80));
 }
 
+// Test that an expired cache entry is served while its Job is late, and that
+// the Job still refreshes the cache.
+TEST_F(HostResolverImplTest, ServeStale) {
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+
+  // The entry expired a second ago.
+  HostCache::Key key("just.testing", ADDRESS_FAMILY_UNSPECIFIED, 0);
+  IPAddressNumber stale_ip;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &stale_ip));
+  resolver_->GetHostCache()->Set(
+      key, OK, AddressList(IPEndPoint(stale_ip, 0)),
+      base::TimeTicks::Now() - base::TimeDelta::FromSeconds(2),
+      base::TimeDelta::FromSeconds(1));
+  resolver_->SetServeStaleOptions(base::TimeDelta::FromHours(1),
+                                  base::TimeDelta());
+
+  Request* req0 = CreateRequest("just.testing", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req0->Resolve());
+  EXPECT_EQ(OK, req0->WaitForResult());
+  EXPECT_TRUE(req0->HasOneAddress("192.168.1.1", 80));
+
+  // While the Job is running, requests get the stale addresses right away,
+  // unless they don't allow cached responses.
+  Request* req1 = CreateRequest("just.testing", 81);
+  EXPECT_EQ(OK, req1->Resolve());
+  EXPECT_TRUE(req1->HasOneAddress("192.168.1.1", 81));
+
+  HostResolver::RequestInfo info(HostPortPair("just.testing", 82));
+  info.set_allow_cached_response(false);
+  Request* req2 = CreateRequest(info);
+  EXPECT_EQ(ERR_IO_PENDING, req2->Resolve());
+
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, req2->WaitForResult());
+  EXPECT_TRUE(req2->HasOneAddress("192.168.1.42", 82));
+  EXPECT_EQ(1u, proc_->GetCaptureList().size());
+
+  // The fresh result was cached.
+  Request* req3 = CreateRequest("just.testing", 83);
+  EXPECT_EQ(OK, req3->Resolve());
+  EXPECT_TRUE(req3->HasOneAddress("192.168.1.42", 83));
+}
+
+// Test that the Job caches its result when all of its requests were completed
+// with stale addresses, and that entries that are too old are not served.
+TEST_F(HostResolverImplTest, ServeStaleLimits) {
+  CreateSerialResolver();
+  proc_->AddRuleForAllFamilies("a", "192.168.1.42");
+  proc_->AddRuleForAllFamilies("b", "192.168.1.43");
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  IPAddressNumber stale_ip;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &stale_ip));
+  AddressList stale_list(IPEndPoint(stale_ip, 0));
+  HostCache* cache = resolver_->GetHostCache();
+  cache->Set(HostCache::Key("a", ADDRESS_FAMILY_UNSPECIFIED, 0), OK,
+             stale_list, now - base::TimeDelta::FromSeconds(2),
+             base::TimeDelta::FromSeconds(1));
+  cache->Set(HostCache::Key("b", ADDRESS_FAMILY_UNSPECIFIED, 0), OK,
+             stale_list, now - base::TimeDelta::FromHours(2),
+             base::TimeDelta::FromSeconds(1));
+  resolver_->SetServeStaleOptions(base::TimeDelta::FromHours(1),
+                                  base::TimeDelta());
+
+  Request* req0 = CreateRequest("a", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req0->Resolve());
+  Request* req1 = CreateRequest("b", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req1->Resolve());
+  EXPECT_EQ(OK, req0->WaitForResult());
+  EXPECT_TRUE(req0->HasOneAddress("192.168.1.1", 80));
+  EXPECT_FALSE(req1->completed());
+
+  proc_->SignalMultiple(2u);
+  EXPECT_EQ(OK, req1->WaitForResult());
+  EXPECT_TRUE(req1->HasOneAddress("192.168.1.43", 80));
+
+  // The Job of "b" ran after the Job of "a", which had no requests left.
+  Request* req2 = CreateRequest("a", 80);
+  EXPECT_EQ(OK, req2->Resolve());
+  EXPECT_TRUE(req2->HasOneAddress("192.168.1.42", 80));
+}
+
+// Test that a popular cache entry is refreshed in the background shortly
+// before it expires.
+TEST_F(HostResolverImplTest, RefreshCacheEntry) {
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+
+  IPAddressNumber old_ip;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &old_ip));
+  HostCache::Key key("just.testing", ADDRESS_FAMILY_UNSPECIFIED, 0);
+  HostCache* cache = resolver_->GetHostCache();
+  cache->Set(key, OK, AddressList(IPEndPoint(old_ip, 0)),
+             base::TimeTicks::Now(), base::TimeDelta::FromSeconds(10));
+  resolver_->SetRefreshOptions(2, base::TimeDelta::FromSeconds(20));
+
+  // The first hit does not make the entry popular enough.
+  Request* req0 = CreateRequest("just.testing", 80);
+  EXPECT_EQ(OK, req0->Resolve());
+  EXPECT_TRUE(req0->HasOneAddress("192.168.1.1", 80));
+  EXPECT_EQ(0u, num_running_jobs());
+
+  // The second one starts a refresh, and the next ones don't start more.
+  Request* req1 = CreateRequest("just.testing", 81);
+  EXPECT_EQ(OK, req1->Resolve());
+  EXPECT_TRUE(req1->HasOneAddress("192.168.1.1", 81));
+  EXPECT_EQ(1u, num_running_jobs());
+  Request* req2 = CreateRequest("just.testing", 82);
+  EXPECT_EQ(OK, req2->Resolve());
+  EXPECT_TRUE(req2->HasOneAddress("192.168.1.1", 82));
+  EXPECT_EQ(1u, num_running_jobs());
+
+  // Requests that don't allow cached responses wait for the refresh.
+  HostResolver::RequestInfo info(HostPortPair("just.testing", 83));
+  info.set_allow_cached_response(false);
+  Request* req3 = CreateRequest(info);
+  EXPECT_EQ(ERR_IO_PENDING, req3->Resolve());
+
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, req3->WaitForResult());
+  EXPECT_TRUE(req3->HasOneAddress("192.168.1.42", 83));
+  EXPECT_EQ(1u, proc_->GetCaptureList().size());
+
+  // The fresh result was cached and kept the hits. It is not refreshed again
+  // until it is about to expire.
+  Request* req4 = CreateRequest("just.testing", 84);
+  EXPECT_EQ(OK, req4->Resolve());
+  EXPECT_TRUE(req4->HasOneAddress("192.168.1.42", 84));
+  EXPECT_EQ(0u, num_running_jobs());
+  base::TimeDelta staleness;
+  EXPECT_EQ(4, cache->LookupStale(key, base::TimeTicks::Now(),
+                                  &staleness)->hit_count);
+}
+
 // Test the retry attempts simulating host resolver proc that takes too long.
 TEST_F(HostResolverImplTest, MultipleAttempts) {
   // Total number of attempts would be 3 and we want the 3rd attempt to resolve
@@ -1244,6 +1377,8 @@ class HostResolverImplDnsTest : public HostResolverImplTest {
     AddDnsRule("6ok", dns_protocol::kTypeAAAA, MockDnsClientRule::OK);
     AddDnsRule("4nx", dns_protocol::kTypeA, MockDnsClientRule::OK);
     AddDnsRule("4nx", dns_protocol::kTypeAAAA, MockDnsClientRule::FAIL_ASYNC);
+    AddDnsRule("soa", dns_protocol::kTypeA, MockDnsClientRule::NXDOMAIN);
+    AddDnsRule("soa", dns_protocol::kTypeAAAA, MockDnsClientRule::NXDOMAIN);
     CreateResolver();
   }
 
@@ -1316,6 +1451,42 @@ TEST_F(HostResolverImplDnsTest, DnsTask) {
   EXPECT_TRUE(requests_[5]->HasOneAddress("192.168.1.102", 80));
 }
 
+// Test that failures are cached for as long as the NXDOMAIN response says, if
+// ProcTask fails as well.
+TEST_F(HostResolverImplDnsTest, NegativeCacheTTL) {
+  ChangeDnsConfig(CreateValidDnsConfig());
+
+  proc_->AddRuleForAllFamilies("soa_succeed", "192.168.1.101");
+  // All other hostnames will fail in proc_.
+
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("soa_fail", 80)->Resolve());
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("soa_succeed", 80)->Resolve());
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("nx_fail", 80)->Resolve());
+
+  proc_->SignalMultiple(requests_.size());
+
+  EXPECT_EQ(ERR_NAME_NOT_RESOLVED, requests_[0]->WaitForResult());
+  EXPECT_EQ(OK, requests_[1]->WaitForResult());
+  EXPECT_TRUE(requests_[1]->HasOneAddress("192.168.1.101", 80));
+  EXPECT_EQ(ERR_NAME_NOT_RESOLVED, requests_[2]->WaitForResult());
+
+  HostCache* cache = resolver_->GetHostCache();
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta staleness;
+  const HostCache::Entry* entry = cache->LookupStale(
+      HostCache::Key("soa_fail", ADDRESS_FAMILY_UNSPECIFIED, 0), now,
+      &staleness);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(ERR_NAME_NOT_RESOLVED, entry->error);
+  EXPECT_LE(-staleness, base::TimeDelta::FromSeconds(kMockNegativeTTL));
+  EXPECT_GT(-staleness, base::TimeDelta::FromSeconds(kMockNegativeTTL / 2));
+
+  // Without a response, the failure is not cached.
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("nx_fail", 80)->Resolve());
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(ERR_NAME_NOT_RESOLVED, requests_[3]->WaitForResult());
+}
+
 TEST_F(HostResolverImplDnsTest, DnsTaskUnspec) {
   ChangeDnsConfig(CreateValidDnsConfig());
 
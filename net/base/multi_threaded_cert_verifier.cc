@@ -15,6 +15,7 @@
 #include "base/synchronization/lock.h"
 #include "base/time.h"
 #include "base/threading/worker_pool.h"
+#include "net/base/cert_verifier_disk_cache.h"
 #include "net/base/cert_verify_proc.h"
 #include "net/base/crl_set.h"
 #include "net/base/net_errors.h"
@@ -248,6 +249,7 @@ class CertVerifierWorker {
       base::AutoLock locked(lock_);
       if (!canceled_) {
         cert_verifier_->HandleResult(cert_, hostname_, flags_,
+                                     crl_set_ ? crl_set_->sequence() : 0,
                                      error_, verify_result_);
       }
     }
@@ -381,6 +383,7 @@ MultiThreadedCertVerifier::MultiThreadedCertVerifier(
     : cache_(kMaxCacheEntries),
       requests_(0),
       cache_hits_(0),
+      disk_cache_hits_(0),
       inflight_joins_(0),
       verify_proc_(verify_proc) {
   CertDatabase::GetInstance()->AddObserver(this);
@@ -419,6 +422,23 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
     return cached_entry->error;
   }
 
+  if (disk_cache_.get()) {
+    base::Time now = base::Time::Now();
+    CachedResult cached_result;
+    cached_result.error = OK;
+    if (disk_cache_->Get(cert, hostname, flags,
+                         crl_set ? crl_set->sequence() : 0, now,
+                         &cached_result.result)) {
+      ++disk_cache_hits_;
+      cache_.Put(key, cached_result, CacheValidityPeriod(now),
+                 CacheValidityPeriod(
+                     now, now + base::TimeDelta::FromSeconds(kTTLSecs)));
+      *out_req = NULL;
+      *verify_result = cached_result.result;
+      return OK;
+    }
+  }
+
   // No cache hit. See if an identical request is currently in flight.
   CertVerifierJob* job;
   std::map<RequestParams, CertVerifierJob*>::const_iterator j;
@@ -460,6 +480,13 @@ void MultiThreadedCertVerifier::CancelRequest(RequestHandle req) {
   request->Cancel();
 }
 
+void MultiThreadedCertVerifier::SetDiskCache(
+    CertVerifierDiskCache* disk_cache) {
+  DCHECK(CalledOnValidThread());
+  disk_cache_.reset(disk_cache);
+  disk_cache_->Load();
+}
+
 MultiThreadedCertVerifier::RequestParams::RequestParams(
     const SHA1HashValue& cert_fingerprint_arg,
     const SHA1HashValue& ca_fingerprint_arg,
@@ -476,6 +503,7 @@ void MultiThreadedCertVerifier::HandleResult(
     X509Certificate* cert,
     const std::string& hostname,
     int flags,
+    uint32 crl_set_sequence,
     int error,
     const CertVerifyResult& verify_result) {
   DCHECK(CalledOnValidThread());
@@ -490,6 +518,11 @@ void MultiThreadedCertVerifier::HandleResult(
   cache_.Put(
       key, cached_result, CacheValidityPeriod(now),
       CacheValidityPeriod(now, now + base::TimeDelta::FromSeconds(kTTLSecs)));
+  // Failures are often transient, so only successes are kept across restarts.
+  if (disk_cache_.get() && error == OK) {
+    disk_cache_->Put(cert, hostname, flags, crl_set_sequence, now,
+                     verify_result);
+  }
 
   std::map<RequestParams, CertVerifierJob*>::iterator j;
   j = inflight_.find(key);
@@ -509,6 +542,8 @@ void MultiThreadedCertVerifier::OnCertTrustChanged(
   DCHECK(CalledOnValidThread());
 
   ClearCache();
+  if (disk_cache_.get())
+    disk_cache_->Clear();
 }
 
 }  // namespace net
@@ -11,6 +11,7 @@
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
 #include "net/base/cert_database.h"
 #include "net/base/cert_verifier.h"
@@ -22,6 +23,7 @@
 
 namespace net {
 
+class CertVerifierDiskCache;
 class CertVerifierJob;
 class CertVerifierRequest;
 class CertVerifierWorker;
@@ -52,9 +54,15 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
 
   virtual void CancelRequest(CertVerifier::RequestHandle req) OVERRIDE;
 
+  // Takes ownership of |disk_cache| and starts loading it. Successful results
+  // are then looked up in, and added to, |disk_cache| as well as the
+  // in-memory cache.
+  void SetDiskCache(CertVerifierDiskCache* disk_cache);
+
  private:
   friend class CertVerifierWorker;  // Calls HandleResult.
   friend class CertVerifierRequest;
+  friend class CertVerifierDiskCache;
   friend class CertVerifierJob;
   friend class MultiThreadedCertVerifierTest;
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, CacheHit);
@@ -63,6 +71,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, CancelRequest);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
                            RequestParamsComparators);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, DiskCacheHit);
 
   // Input parameters of a certificate verification request.
   struct NET_EXPORT_PRIVATE RequestParams {
@@ -131,6 +140,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   void HandleResult(X509Certificate* cert,
                     const std::string& hostname,
                     int flags,
+                    uint32 crl_set_sequence,
                     int error,
                     const CertVerifyResult& verify_result);
 
@@ -141,18 +151,23 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   void ClearCache() { cache_.Clear(); }
   size_t GetCacheSize() const { return cache_.size(); }
   uint64 cache_hits() const { return cache_hits_; }
+  uint64 disk_cache_hits() const { return disk_cache_hits_; }
   uint64 requests() const { return requests_; }
   uint64 inflight_joins() const { return inflight_joins_; }
 
   // cache_ maps from a request to a cached result.
   CertVerifierCache cache_;
 
+  // disk_cache_, if set, holds successful results across restarts.
+  scoped_ptr<CertVerifierDiskCache> disk_cache_;
+
   // inflight_ maps from a request to an active verification which is taking
   // place.
   std::map<RequestParams, CertVerifierJob*> inflight_;
 
   uint64 requests_;
   uint64 cache_hits_;
+  uint64 disk_cache_hits_;
   uint64 inflight_joins_;
 
   scoped_refptr<CertVerifyProc> verify_proc_;
@@ -7,8 +7,12 @@
 #include "base/bind.h"
 #include "base/file_path.h"
 #include "base/format_macros.h"
+#include "base/message_loop.h"
+#include "base/message_loop_proxy.h"
+#include "base/scoped_temp_dir.h"
 #include "base/stringprintf.h"
 #include "net/base/cert_test_util.h"
+#include "net/base/cert_verifier_disk_cache.h"
 #include "net/base/cert_verify_proc.h"
 #include "net/base/cert_verify_result.h"
 #include "net/base/net_errors.h"
@@ -240,6 +244,52 @@ TEST_F(MultiThreadedCertVerifierTest, CancelRequestThenQuit) {
   // Destroy |verifier| by going out of scope.
 }
 
+// Tests that a result from the disk cache completes the request synchronously,
+// but only with the CRLSet it was verified with.
+TEST_F(MultiThreadedCertVerifierTest, DiskCacheHit) {
+  FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), test_cert);
+
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  CertVerifierDiskCache* disk_cache = new CertVerifierDiskCache(
+      temp_dir.path().AppendASCII("cert_verifier_cache"),
+      base::MessageLoopProxy::current(), 10, base::TimeDelta::FromHours(1));
+  CertVerifyResult cached_result;
+  cached_result.verified_cert = test_cert;
+  // The verifier is not given a CRLSet, which is sequence number 0.
+  disk_cache->Put(test_cert, "www.example.com", 0, 0, base::Time::Now(),
+                  cached_result);
+  disk_cache->Put(test_cert, "www.example.org", 0, 1, base::Time::Now(),
+                  cached_result);
+  verifier_.SetDiskCache(disk_cache);
+  MessageLoop::current()->RunAllPending();
+
+  int error;
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+
+  error = verifier_.Verify(test_cert, "www.example.com", 0, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  ASSERT_EQ(OK, error);
+  ASSERT_TRUE(request_handle == NULL);
+  ASSERT_EQ(1u, verifier_.disk_cache_hits());
+  ASSERT_EQ(1u, verifier_.GetCacheSize());
+
+  // A result from another CRLSet is not used.
+  error = verifier_.Verify(test_cert, "www.example.org", 0, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  error = callback.WaitForResult();
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(1u, verifier_.disk_cache_hits());
+}
+
 TEST_F(MultiThreadedCertVerifierTest, RequestParamsComparators) {
   SHA1HashValue a_key;
   memset(a_key.data, 'a', sizeof(a_key.data));
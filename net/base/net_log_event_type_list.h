@@ -65,6 +65,16 @@ EVENT_TYPE(HOST_RESOLVER_IMPL_CACHE_HIT)
 // This event is logged when a request is handled by a HOSTS entry.
 EVENT_TYPE(HOST_RESOLVER_IMPL_HOSTS_HIT)
 
+// This event is logged when a request is handled by an expired cache entry,
+// while its Job refreshes the entry. See
+// HostResolverImpl::SetServeStaleOptions().
+EVENT_TYPE(HOST_RESOLVER_IMPL_STALE_CACHE_HIT)
+
+// This event is logged when a request is handled by a popular cache entry that
+// is about to expire, and a Job is created to refresh it in the background.
+// See HostResolverImpl::SetRefreshOptions().
+EVENT_TYPE(HOST_RESOLVER_IMPL_CACHE_REFRESH)
+
 // This event is created when a new HostResolverImpl::Job is about to be created
 // for a request.
 EVENT_TYPE(HOST_RESOLVER_IMPL_CREATE_JOB)
@@ -326,6 +336,8 @@ EVENT_TYPE(WAITING_FOR_PROXY_RESOLVER_THREAD)
 //   {
 //     "thread_number": <Identifier for the PAC thread that is going to
 //                       run this request>,
+//     "context_reuse_count": <Number of requests that thread's PAC script
+//                             context has already run>,
 //   }
 EVENT_TYPE(SUBMITTED_TO_RESOLVER_THREAD)
 
@@ -622,6 +634,22 @@ EVENT_TYPE(CONNECT_JOB_SET_SOCKET)
 // Whether the connect job timed out.
 EVENT_TYPE(SOCKET_POOL_CONNECT_JOB_TIMED_OUT)
 
+// This event is logged when a TransportConnectJob starts connecting to the
+// IPv4 addresses while it is still waiting for an IPv6 connect. The following
+// parameters are attached:
+//   {
+//     "delay_ms": <How long the IPv6 connect ran before this one started>,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_IPV6_FALLBACK)
+
+// This event is logged when the IPv6 and IPv4 connects of a TransportConnectJob
+// have raced, and one of them has connected. The following parameters are
+// attached:
+//   {
+//     "winner": <"ipv6" or "ipv4">,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_RACE_WINNER)
+
 // ------------------------------------------------------------------------
 // ClientSocketPoolBaseHelper
 // ------------------------------------------------------------------------
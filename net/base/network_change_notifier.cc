@@ -325,10 +325,12 @@ void NetworkChangeNotifier::RemoveDNSObserver(DNSObserver* observer) {
 NetworkChangeNotifier::NetworkChangeNotifier()
     : ip_address_observer_list_(
         new ObserverListThreadSafe<IPAddressObserver>(
-            ObserverListBase<IPAddressObserver>::NOTIFY_EXISTING_ONLY)),
+            ObserverListBase<IPAddressObserver>::NOTIFY_EXISTING_ONLY,
+            ObserverListThreadSafe<IPAddressObserver>::DISPATCH_COALESCED)),
       connection_type_observer_list_(
         new ObserverListThreadSafe<ConnectionTypeObserver>(
-            ObserverListBase<ConnectionTypeObserver>::NOTIFY_EXISTING_ONLY)),
+            ObserverListBase<ConnectionTypeObserver>::NOTIFY_EXISTING_ONLY,
+            ObserverListThreadSafe<ConnectionTypeObserver>::DISPATCH_COALESCED)),
       resolver_state_observer_list_(
         new ObserverListThreadSafe<DNSObserver>(
             ObserverListBase<DNSObserver>::NOTIFY_EXISTING_ONLY)),
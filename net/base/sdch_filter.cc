@@ -33,6 +33,8 @@ SdchFilter::SdchFilter(const FilterContext& filter_context)
   DCHECK(success);
   success = filter_context.GetURL(&url_);
   DCHECK(success);
+  if (SdchManager::Global())
+    SdchManager::Global()->GetDecodeBuffer(&dest_buffer_excess_);
 }
 
 SdchFilter::~SdchFilter() {
@@ -71,6 +73,9 @@ SdchFilter::~SdchFilter() {
     UMA_HISTOGRAM_COUNTS("Sdch3.UnflushedVcdiffOut", output_bytes_);
   }
 
+  if (SdchManager::Global())
+    SdchManager::Global()->ReleaseDecodeBuffer(&dest_buffer_excess_);
+
   if (filter_context_.IsCachedContent()) {
     // Not a real error, but it is useful to have this tally.
     // TODO(jar): Remove this stat after SDCH stability is validated.
@@ -5,6 +5,7 @@
 #include <limits.h>
 
 #include <algorithm>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include "third_party/zlib/zlib.h"
 #endif
 
+#include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "net/base/filter.h"
@@ -1395,4 +1397,80 @@ TEST_F(SdchFilterTest, LatencyTestControls) {
   EXPECT_FALSE(sdch_manager_->AllowLatencyExperiment(url2));
 }
 
+// Records the calls made by the SdchManager to its dictionary store.
+class FakeDictionaryStore : public SdchDictionaryStore {
+ public:
+  FakeDictionaryStore() : load_all_count_(0) {}
+  virtual ~FakeDictionaryStore() {}
+
+  virtual void Save(const std::string& server_hash,
+                    const GURL& dictionary_url,
+                    const std::string& dictionary_text) OVERRIDE {
+    saved_.insert(server_hash);
+  }
+  virtual void LoadAll(const LoadCallback& callback) OVERRIDE {
+    load_all_count_++;
+    callback_ = callback;
+  }
+  virtual void Load(const std::string& server_hash,
+                    const LoadCallback& callback) OVERRIDE {
+    requested_.push_back(server_hash);
+    callback_ = callback;
+  }
+
+  int load_all_count() const { return load_all_count_; }
+  const std::set<std::string>& saved() const { return saved_; }
+  const std::vector<std::string>& requested() const { return requested_; }
+  const LoadCallback& callback() const { return callback_; }
+
+ private:
+  int load_all_count_;
+  std::set<std::string> saved_;
+  std::vector<std::string> requested_;
+  LoadCallback callback_;
+};
+
+TEST_F(SdchFilterTest, DictionaryStore) {
+  FakeDictionaryStore* store = new FakeDictionaryStore;
+  sdch_manager_->set_dictionary_store(store);
+  EXPECT_EQ(1, store->load_all_count());
+
+  const std::string kSampleDomain = "sdchtest.com";
+  GURL url("http://" + kSampleDomain);
+  std::string dictionary(NewSdchDictionary(kSampleDomain));
+  std::string client_hash, server_hash;
+  SdchManager::GenerateHash(dictionary, &client_hash, &server_hash);
+
+  // New dictionaries are stored.
+  EXPECT_TRUE(sdch_manager_->AddSdchDictionary(dictionary, url));
+  EXPECT_EQ(1u, store->saved().count(server_hash));
+
+  // Unknown dictionaries are requested from the store.
+  std::string dictionary2(NewSdchDictionary(kSampleDomain) + " ");
+  std::string client_hash2, server_hash2;
+  SdchManager::GenerateHash(dictionary2, &client_hash2, &server_hash2);
+  SdchManager::Dictionary* found = NULL;
+  sdch_manager_->GetVcdiffDictionary(server_hash2, url, &found);
+  EXPECT_TRUE(found == NULL);
+  ASSERT_EQ(1u, store->requested().size());
+  EXPECT_EQ(server_hash2, store->requested()[0]);
+
+  // And can be used once loaded.
+  store->callback().Run(url, dictionary2);
+  sdch_manager_->GetVcdiffDictionary(server_hash2, url, &found);
+  EXPECT_TRUE(found != NULL);
+}
+
+TEST_F(SdchFilterTest, DecodeBuffers) {
+  std::string buffer("some data");
+  buffer.reserve(1000);
+  sdch_manager_->ReleaseDecodeBuffer(&buffer);
+  EXPECT_TRUE(buffer.empty());
+
+  std::string recycled;
+  sdch_manager_->GetDecodeBuffer(&recycled);
+  EXPECT_TRUE(recycled.empty());
+  EXPECT_LE(1000u, recycled.capacity());
+}
+
 }  // namespace net
@@ -5,6 +5,8 @@
 #include "net/base/sdch_manager.h"
 
 #include "base/base64.h"
+#include "base/bind.h"
+#include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/string_number_conversions.h"
@@ -22,6 +24,14 @@ const size_t SdchManager::kMaxDictionarySize = 1000000;
 // static
 const size_t SdchManager::kMaxDictionaryCount = 20;
 
+namespace {
+
+// Limits for the recycled decode buffers.
+const size_t kMaxDecodeBuffers = 4;
+const size_t kMaxDecodeBufferCapacity = 256 * 1024;
+
+}  // namespace
+
 // static
 SdchManager* SdchManager::global_ = NULL;
 
@@ -204,7 +214,8 @@ bool SdchManager::Dictionary::DomainMatch(const GURL& gurl,
 }
 
 //------------------------------------------------------------------------------
-SdchManager::SdchManager() {
+SdchManager::SdchManager()
+    : ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
   DCHECK(!global_);
   DCHECK(CalledOnValidThread());
   global_ = this;
@@ -227,6 +238,7 @@ void SdchManager::Shutdown() {
   if (!global_ )
     return;
   global_->set_sdch_fetcher(NULL);
+  global_->set_dictionary_store(NULL);
 }
 
 // static
@@ -244,6 +256,15 @@ void SdchManager::set_sdch_fetcher(SdchFetcher* fetcher) {
   fetcher_.reset(fetcher);
 }
 
+void SdchManager::set_dictionary_store(SdchDictionaryStore* store) {
+  DCHECK(CalledOnValidThread());
+  store_.reset(store);
+  if (store_.get()) {
+    store_->LoadAll(base::Bind(&SdchManager::OnDictionaryLoaded,
+                               weak_factory_.GetWeakPtr()));
+  }
+}
+
 // static
 void SdchManager::EnableSdchSupport(bool enabled) {
   g_sdch_enabled_ = enabled;
@@ -466,15 +487,29 @@ bool SdchManager::AddSdchDictionary(const std::string& dictionary_text,
                      dictionary_url, domain, path, expiration, ports);
   dictionary->AddRef();
   dictionaries_[server_hash] = dictionary;
+  if (store_.get())
+    store_->Save(server_hash, dictionary_url, dictionary_text);
   return true;
 }
 
+void SdchManager::OnDictionaryLoaded(const GURL& dictionary_url,
+                                     const std::string& dictionary_text) {
+  DCHECK(CalledOnValidThread());
+  AddSdchDictionary(dictionary_text, dictionary_url);
+}
+
 void SdchManager::GetVcdiffDictionary(const std::string& server_hash,
     const GURL& referring_url, Dictionary** dictionary) {
   DCHECK(CalledOnValidThread());
   *dictionary = NULL;
   DictionaryMap::iterator it = dictionaries_.find(server_hash);
   if (it == dictionaries_.end()) {
+    // This response cannot be decoded, but the dictionary may be stored from
+    // a previous session, and the next response could use it.
+    if (store_.get()) {
+      store_->Load(server_hash, base::Bind(&SdchManager::OnDictionaryLoaded,
+                                           weak_factory_.GetWeakPtr()));
+    }
     return;
   }
   Dictionary* matching_dictionary = it->second;
@@ -541,6 +576,26 @@ void SdchManager::SetAllowLatencyExperiment(const GURL& url, bool enable) {
   allow_latency_experiment_.erase(it);
 }
 
+void SdchManager::GetDecodeBuffer(std::string* buffer) {
+  DCHECK(CalledOnValidThread());
+  if (decode_buffers_.empty())
+    return;
+  buffer->swap(decode_buffers_.back());
+  decode_buffers_.pop_back();
+}
+
+void SdchManager::ReleaseDecodeBuffer(std::string* buffer) {
+  DCHECK(CalledOnValidThread());
+  buffer->clear();
+  if (decode_buffers_.size() >= kMaxDecodeBuffers ||
+      buffer->capacity() > kMaxDecodeBufferCapacity) {
+    std::string().swap(*buffer);
+    return;
+  }
+  decode_buffers_.push_back(std::string());
+  decode_buffers_.back().swap(*buffer);
+}
+
 // static
 void SdchManager::UrlSafeBase64Encode(const std::string& input,
                                       std::string* output) {
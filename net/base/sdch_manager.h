@@ -23,10 +23,13 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "base/callback.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/time.h"
 #include "base/threading/non_thread_safe.h"
 #include "googleurl/src/gurl.h"
@@ -53,6 +56,35 @@ class SdchFetcher {
   DISALLOW_COPY_AND_ASSIGN(SdchFetcher);
 };
 
+//------------------------------------------------------------------------------
+// Persists dictionaries across sessions. Dictionaries are identified by their
+// server hash, so that a dictionary named by a response can be looked up
+// directly.
+class SdchDictionaryStore {
+ public:
+  // Receives the url and the text of a dictionary that was loaded.
+  typedef base::Callback<void(const GURL&, const std::string&)> LoadCallback;
+
+  SdchDictionaryStore() {}
+  virtual ~SdchDictionaryStore() {}
+
+  // Stores a dictionary that was just added to the SdchManager.
+  virtual void Save(const std::string& server_hash,
+                    const GURL& dictionary_url,
+                    const std::string& dictionary_text) = 0;
+
+  // Loads all the stored dictionaries in the background, calling |callback|
+  // for each one.
+  virtual void LoadAll(const LoadCallback& callback) = 0;
+
+  // Loads the dictionary with the given |server_hash|, if it is stored.
+  virtual void Load(const std::string& server_hash,
+                    const LoadCallback& callback) = 0;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SdchDictionaryStore);
+};
+
 //------------------------------------------------------------------------------
 
 class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
@@ -246,6 +278,12 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   // Register a fetcher that this class can use to obtain dictionaries.
   void set_sdch_fetcher(SdchFetcher* fetcher);
 
+  // Register a store to persist dictionaries, and start loading the
+  // dictionaries that it holds. Takes ownership of |store|.
+  void set_dictionary_store(SdchDictionaryStore* store);
+
+  bool has_dictionary_store() const { return store_.get() != NULL; }
+
   // Enables or disables SDCH compression.
   static void EnableSdchSupport(bool enabled);
 
@@ -331,6 +369,13 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
 
   void SetAllowLatencyExperiment(const GURL& url, bool enable);
 
+  // Decode buffers are recycled across responses, so that their memory does
+  // not have to grow again for every SDCH response. GetDecodeBuffer() swaps a
+  // recycled (empty) buffer into |buffer|, and ReleaseDecodeBuffer() takes the
+  // memory of |buffer| back, leaving it empty.
+  void GetDecodeBuffer(std::string* buffer);
+  void ReleaseDecodeBuffer(std::string* buffer);
+
  private:
   typedef std::map<std::string, int> DomainCounter;
   typedef std::set<std::string> ExperimentSet;
@@ -347,11 +392,22 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   // A simple implementation of a RFC 3548 "URL safe" base64 encoder.
   static void UrlSafeBase64Encode(const std::string& input,
                                   std::string* output);
+
+  // Adds a dictionary read from |store_|.
+  void OnDictionaryLoaded(const GURL& dictionary_url,
+                          const std::string& dictionary_text);
+
   DictionaryMap dictionaries_;
 
   // An instance that can fetch a dictionary given a URL.
   scoped_ptr<SdchFetcher> fetcher_;
 
+  // Where dictionaries are kept across sessions. May be NULL.
+  scoped_ptr<SdchDictionaryStore> store_;
+
+  // Recycled decode buffers.
+  std::vector<std::string> decode_buffers_;
+
   // List domains where decode failures have required disabling sdch, along with
   // count of how many additonal uses should be blacklisted.
   DomainCounter blacklisted_domains_;
@@ -364,6 +420,8 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   // round trip test has recently passed).
   ExperimentSet allow_latency_experiment_;
 
+  base::WeakPtrFactory<SdchManager> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(SdchManager);
 };
 
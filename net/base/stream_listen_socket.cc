@@ -381,8 +381,14 @@ void StreamListenSocket::SendData() {
   if (!send_buffers_.empty()) {
     DCHECK(!send_timer_.IsRunning());
     send_timer_.Start(FROM_HERE, send_backoff_.GetTimeUntilRelease(),
-                      this, &StreamListenSocket::SendData);
+                      this, &StreamListenSocket::ResumeSend);
   }
 }
 
+void StreamListenSocket::ResumeSend() {
+  SendData();
+  if (send_buffers_.empty() && !send_error_)
+    socket_delegate_->DidDrainSendBuffer(this);
+}
+
 }  // namespace net
@@ -72,6 +72,10 @@ class NET_EXPORT StreamListenSocket
                          const char* data,
                          int len) = 0;
     virtual void DidClose(StreamListenSocket* sock) = 0;
+    // Called once data that could not be written when it was passed to
+    // Send() has all been written to |connection|. Not called if Send()
+    // writes everything immediately.
+    virtual void DidDrainSendBuffer(StreamListenSocket* connection) {}
 
    protected:
     virtual ~Delegate() {}
@@ -84,6 +88,10 @@ class NET_EXPORT StreamListenSocket
   // Copies the local address to |address|. Returns a network error code.
   int GetLocalAddress(IPEndPoint* address);
 
+  // Returns the number of bytes passed to Send() that have not been written
+  // to the socket yet.
+  int send_pending_size() const { return send_pending_size_; }
+
   static const SocketDescriptor kInvalidSocket;
   static const int kSocketError;
 
@@ -117,6 +125,9 @@ class NET_EXPORT StreamListenSocket
   friend class TransportClientSocketTest;
 
   void SendData();
+  // Called by |send_timer_| to write the data that could not be written
+  // earlier.
+  void ResumeSend();
   void SendInternal(const char* bytes, int len);
 
 #if defined(OS_WIN)
@@ -16,13 +16,18 @@
 #endif
 
 #include <algorithm>
+#include <map>
+#include <vector>
 
 #include "base/base64.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
 #include "base/sha1.h"
 #include "base/string_number_conversions.h"
+#include "base/string_piece.h"
 #include "base/string_tokenizer.h"
 #include "base/string_util.h"
 #include "base/time.h"
@@ -135,6 +140,10 @@ bool TransportSecurityState::GetDomainState(const std::string& host,
       return true;
     }
 
+    // Most users have few dynamic entries, if any; don't hash for nothing.
+    if (enabled_hosts_.empty())
+      continue;
+
     std::map<std::string, DomainState>::iterator j =
         enabled_hosts_.find(HashHost(host_sub_chunk));
     if (j == enabled_hosts_.end())
@@ -827,46 +836,175 @@ struct HSTSPreload {
   SecondLevelDomainName second_level_domain_name;
 };
 
-static bool HasPreload(const struct HSTSPreload* entries, size_t num_entries,
-                       const std::string& canonicalized_host, size_t i,
-                       TransportSecurityState::DomainState* out, bool* ret) {
-  for (size_t j = 0; j < num_entries; j++) {
-    if (entries[j].length == canonicalized_host.size() - i &&
-        memcmp(entries[j].dns_name, &canonicalized_host[i],
-               entries[j].length) == 0) {
-      if (!entries[j].include_subdomains && i != 0) {
-        *ret = false;
-      } else {
-        out->include_subdomains = entries[j].include_subdomains;
-        *ret = true;
-        if (!entries[j].https_required)
-          out->upgrade_mode = TransportSecurityState::DomainState::MODE_DEFAULT;
-        if (entries[j].pins.required_hashes) {
-          const char* const* hash = entries[j].pins.required_hashes;
-          while (*hash) {
-            bool ok = AddHash(*hash, &out->static_spki_hashes);
-            DCHECK(ok) << " failed to parse " << *hash;
-            hash++;
-          }
-        }
-        if (entries[j].pins.excluded_hashes) {
-          const char* const* hash = entries[j].pins.excluded_hashes;
-          while (*hash) {
-            bool ok = AddHash(*hash, &out->bad_static_spki_hashes);
-            DCHECK(ok) << " failed to parse " << *hash;
-            hash++;
-          }
-        }
+// Updates |out| from the preload |entry|, which matched either the host
+// itself or, if |is_subdomain|, one of its parent domains. Returns whether
+// the entry applies to the host.
+static bool ApplyPreload(const struct HSTSPreload& entry,
+                         bool is_subdomain,
+                         TransportSecurityState::DomainState* out) {
+  if (!entry.include_subdomains && is_subdomain)
+    return false;
+
+  out->include_subdomains = entry.include_subdomains;
+  if (!entry.https_required)
+    out->upgrade_mode = TransportSecurityState::DomainState::MODE_DEFAULT;
+  if (entry.pins.required_hashes) {
+    const char* const* hash = entry.pins.required_hashes;
+    while (*hash) {
+      bool ok = AddHash(*hash, &out->static_spki_hashes);
+      DCHECK(ok) << " failed to parse " << *hash;
+      hash++;
+    }
+  }
+  if (entry.pins.excluded_hashes) {
+    const char* const* hash = entry.pins.excluded_hashes;
+    while (*hash) {
+      bool ok = AddHash(*hash, &out->bad_static_spki_hashes);
+      DCHECK(ok) << " failed to parse " << *hash;
+      hash++;
+    }
+  }
+  return true;
+}
+
+// Appends the labels of |dns_name|, a name in the form returned by
+// CanonicalizeHost, to |labels|, leftmost label first.
+static void SplitDNSName(const char* dns_name,
+                         size_t length,
+                         std::vector<base::StringPiece>* labels) {
+  for (size_t i = 0; i < length && dns_name[i]; i += dns_name[i] + 1)
+    labels->push_back(base::StringPiece(dns_name + i + 1, dns_name[i]));
+}
+
+namespace {
+
+// PreloadTrie indexes a table of HSTSPreload entries by name, one label per
+// level starting from the TLD, so that the entries for a host and all of its
+// parent domains are found in a single pass over the host's labels instead
+// of a scan of the whole table per label.
+//
+// The nodes are kept in one array in breadth-first order, so the children of
+// a node are contiguous and sorted by label, and a lookup touches a handful
+// of cache lines. Labels point into the static table; nothing is copied.
+class PreloadTrie {
+ public:
+  PreloadTrie(const struct HSTSPreload* entries, size_t num_entries);
+  ~PreloadTrie();
+
+  // Sets |matches| to one element per label of |canonicalized_host|: the
+  // entry for the name starting at that label, or NULL. The first element is
+  // for the host itself, the last for its TLD.
+  void FindMatches(const std::string& canonicalized_host,
+                   std::vector<const struct HSTSPreload*>* matches) const;
+
+ private:
+  // The tree the array is built from.
+  struct BuildNode {
+    BuildNode() : entry(NULL) {}
+
+    const struct HSTSPreload* entry;
+    std::map<base::StringPiece, BuildNode*> children;
+  };
+
+  struct Node {
+    base::StringPiece label;
+    const struct HSTSPreload* entry;
+    uint32 first_child;
+    uint32 num_children;
+  };
+
+  static bool LabelLess(const Node& node, const base::StringPiece& label) {
+    return node.label < label;
+  }
+
+  std::vector<Node> nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadTrie);
+};
+
+PreloadTrie::PreloadTrie(const struct HSTSPreload* entries,
+                         size_t num_entries) {
+  ScopedVector<BuildNode> build_nodes;
+  build_nodes.push_back(new BuildNode);
+
+  for (size_t i = 0; i < num_entries; ++i) {
+    std::vector<base::StringPiece> labels;
+    SplitDNSName(entries[i].dns_name, entries[i].length, &labels);
+    BuildNode* node = build_nodes[0];
+    for (size_t k = labels.size(); k > 0; --k) {
+      BuildNode*& child = node->children[labels[k - 1]];
+      if (!child) {
+        child = new BuildNode;
+        build_nodes.push_back(child);
       }
-      return true;
+      node = child;
+    }
+    // As with a linear scan of the table, the first entry for a name wins.
+    if (!node->entry)
+      node->entry = &entries[i];
+  }
+
+  Node root = { base::StringPiece(), NULL, 0, 0 };
+  nodes_.push_back(root);
+  std::vector<BuildNode*> queue(1, build_nodes[0]);
+  for (size_t index = 0; index < queue.size(); ++index) {
+    const BuildNode* build_node = queue[index];
+    nodes_[index].first_child = static_cast<uint32>(nodes_.size());
+    nodes_[index].num_children =
+        static_cast<uint32>(build_node->children.size());
+    for (std::map<base::StringPiece, BuildNode*>::const_iterator it =
+             build_node->children.begin();
+         it != build_node->children.end(); ++it) {
+      Node node = { it->first, it->second->entry, 0, 0 };
+      nodes_.push_back(node);
+      queue.push_back(it->second);
     }
   }
-  return false;
 }
 
+PreloadTrie::~PreloadTrie() {}
+
+void PreloadTrie::FindMatches(
+    const std::string& canonicalized_host,
+    std::vector<const struct HSTSPreload*>* matches) const {
+  std::vector<base::StringPiece> labels;
+  SplitDNSName(canonicalized_host.data(), canonicalized_host.size(), &labels);
+  matches->assign(labels.size(), NULL);
+
+  const Node* node = &nodes_[0];
+  for (size_t k = labels.size(); k > 0; --k) {
+    const Node* begin = &nodes_[0] + node->first_child;
+    const Node* end = begin + node->num_children;
+    const Node* child = std::lower_bound(begin, end, labels[k - 1], LabelLess);
+    if (child == end || child->label != labels[k - 1])
+      break;
+    (*matches)[k - 1] = child->entry;
+    node = child;
+  }
+}
+
+}  // namespace
+
 #include "net/base/transport_security_state_static.h"
 
-// Returns the HSTSPreload entry for the |canonicalized_host| in |entries|,
+namespace {
+
+struct PreloadTries {
+  PreloadTries()
+      : sts(kPreloadedSTS, kNumPreloadedSTS),
+        sni_sts(kPreloadedSNISTS, kNumPreloadedSNISTS) {}
+
+  const PreloadTrie sts;
+  const PreloadTrie sni_sts;
+};
+
+// Built on first use and never destroyed.
+base::LazyInstance<PreloadTries>::Leaky g_preload_tries =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// Returns the HSTSPreload entry for the |canonicalized_host| in |trie|,
 // or NULL if there is none. Prefers exact hostname matches to those that
 // match only because HSTSPreload.include_subdomains is true.
 //
@@ -874,20 +1012,12 @@ static bool HasPreload(const struct HSTSPreload* entries, size_t num_entries,
 // CanonicalizeHost.
 static const struct HSTSPreload* GetHSTSPreload(
     const std::string& canonicalized_host,
-    const struct HSTSPreload* entries,
-    size_t num_entries) {
-  for (size_t i = 0; canonicalized_host[i]; i += canonicalized_host[i] + 1) {
-    for (size_t j = 0; j < num_entries; j++) {
-      const struct HSTSPreload* entry = entries + j;
-
-      if (i != 0 && !entry->include_subdomains)
-        continue;
-
-      if (entry->length == canonicalized_host.size() - i &&
-          memcmp(entry->dns_name, &canonicalized_host[i], entry->length) == 0) {
-        return entry;
-      }
-    }
+    const PreloadTrie& trie) {
+  std::vector<const struct HSTSPreload*> matches;
+  trie.FindMatches(canonicalized_host, &matches);
+  for (size_t k = 0; k < matches.size(); ++k) {
+    if (matches[k] && (k == 0 || matches[k]->include_subdomains))
+      return matches[k];
   }
 
   return NULL;
@@ -898,14 +1028,14 @@ bool TransportSecurityState::IsGooglePinnedProperty(const std::string& host,
                                                     bool sni_enabled) {
   std::string canonicalized_host = CanonicalizeHost(host);
   const struct HSTSPreload* entry =
-      GetHSTSPreload(canonicalized_host, kPreloadedSTS, kNumPreloadedSTS);
+      GetHSTSPreload(canonicalized_host, g_preload_tries.Get().sts);
 
   if (entry && entry->pins.required_hashes == kGoogleAcceptableCerts)
     return true;
 
   if (sni_enabled) {
-    entry = GetHSTSPreload(canonicalized_host, kPreloadedSNISTS,
-                           kNumPreloadedSNISTS);
+    entry = GetHSTSPreload(canonicalized_host,
+                           g_preload_tries.Get().sni_sts);
     if (entry && entry->pins.required_hashes == kGoogleAcceptableCerts)
       return true;
   }
@@ -918,11 +1048,11 @@ void TransportSecurityState::ReportUMAOnPinFailure(const std::string& host) {
   std::string canonicalized_host = CanonicalizeHost(host);
 
   const struct HSTSPreload* entry =
-      GetHSTSPreload(canonicalized_host, kPreloadedSTS, kNumPreloadedSTS);
+      GetHSTSPreload(canonicalized_host, g_preload_tries.Get().sts);
 
   if (!entry) {
-    entry = GetHSTSPreload(canonicalized_host, kPreloadedSNISTS,
-                           kNumPreloadedSNISTS);
+    entry = GetHSTSPreload(canonicalized_host,
+                           g_preload_tries.Get().sni_sts);
   }
 
   if (!entry) {
@@ -962,25 +1092,35 @@ bool TransportSecurityState::GetStaticDomainState(
   out->upgrade_mode = DomainState::MODE_FORCE_HTTPS;
   out->include_subdomains = false;
 
-  for (size_t i = 0; canonicalized_host[i]; i += canonicalized_host[i] + 1) {
-    std::string host_sub_chunk(&canonicalized_host[i],
-                               canonicalized_host.size() - i);
-    out->domain = DNSDomainToString(host_sub_chunk);
-    std::string hashed_host(HashHost(host_sub_chunk));
-    if (forced_hosts_.find(hashed_host) != forced_hosts_.end()) {
-      *out = forced_hosts_[hashed_host];
-      out->domain = DNSDomainToString(host_sub_chunk);
-      return true;
-    }
-    bool ret;
-    if (HasPreload(kPreloadedSTS, kNumPreloadedSTS, canonicalized_host, i, out,
-                   &ret)) {
-      return ret;
+  std::vector<const struct HSTSPreload*> sts_matches;
+  std::vector<const struct HSTSPreload*> sni_matches;
+  g_preload_tries.Get().sts.FindMatches(canonicalized_host, &sts_matches);
+  if (sni_enabled) {
+    g_preload_tries.Get().sni_sts.FindMatches(canonicalized_host,
+                                              &sni_matches);
+  }
+
+  for (size_t i = 0, k = 0; canonicalized_host[i];
+       i += canonicalized_host[i] + 1, ++k) {
+    if (!forced_hosts_.empty()) {
+      std::string host_sub_chunk(&canonicalized_host[i],
+                                 canonicalized_host.size() - i);
+      std::map<std::string, DomainState>::const_iterator j =
+          forced_hosts_.find(HashHost(host_sub_chunk));
+      if (j != forced_hosts_.end()) {
+        *out = j->second;
+        out->domain = DNSDomainToString(host_sub_chunk);
+        return true;
+      }
     }
-    if (sni_enabled &&
-        HasPreload(kPreloadedSNISTS, kNumPreloadedSNISTS, canonicalized_host, i,
-                   out, &ret)) {
-      return ret;
+
+    const struct HSTSPreload* entry = sts_matches[k];
+    if (!entry && sni_enabled)
+      entry = sni_matches[k];
+    if (entry) {
+      out->domain = DNSDomainToString(
+          canonicalized_host.substr(i, canonicalized_host.size() - i));
+      return ApplyPreload(*entry, i != 0, out);
     }
   }
 
@@ -0,0 +1,89 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/transport_security_state.h"
+
+#include "base/basictypes.h"
+#include "base/format_macros.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kIterations = 10000;
+
+// A mix of the hosts seen while browsing: preloaded hosts, subdomains of
+// preloaded hosts and, mostly, hosts without any transport security state.
+const char* const kHosts[] = {
+  "www.google.com",
+  "mail.google.com",
+  "ssl.gstatic.com",
+  "plus.google.com",
+  "accounts.google.com",
+  "www.paypal.com",
+  "twitter.com",
+  "api.twitter.com",
+  "www.facebook.com",
+  "static.ak.fbcdn.net",
+  "en.wikipedia.org",
+  "upload.wikimedia.org",
+  "www.youtube.com",
+  "i1.ytimg.com",
+  "www.amazon.com",
+  "images-na.ssl-images-amazon.com",
+  "www.nytimes.com",
+  "graphics8.nytimes.com",
+  "ajax.googleapis.com",
+  "pagead2.googlesyndication.com",
+  "www.google-analytics.com",
+  "news.ycombinator.com",
+  "a.b.c.d.example.com",
+  "localhost",
+};
+
+}  // namespace
+
+TEST(TransportSecurityStatePerfTest, GetDomainState) {
+  TransportSecurityState state;
+  TransportSecurityState::DomainState domain_state;
+  int found = 0;
+
+  PerfTimeLogger timer(base::StringPrintf(
+      "TransportSecurityState_GetDomainState_%" PRIuS "_hosts",
+      arraysize(kHosts)).c_str());
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < arraysize(kHosts); ++j) {
+      if (state.GetDomainState(kHosts[j], true /* sni_enabled */,
+                               &domain_state)) {
+        ++found;
+      }
+    }
+  }
+  timer.Done();
+  EXPECT_GT(found, 0);
+}
+
+// Dynamic entries are hashed, so they are still probed once per label.
+TEST(TransportSecurityStatePerfTest, GetDomainStateWithDynamicEntries) {
+  TransportSecurityState state;
+  TransportSecurityState::DomainState domain_state;
+  domain_state.upgrade_expiry =
+      base::Time::Now() + base::TimeDelta::FromDays(365);
+  for (size_t j = 0; j < arraysize(kHosts); j += 2)
+    state.EnableHost(kHosts[j], domain_state);
+
+  PerfTimeLogger timer(
+      "TransportSecurityState_GetDomainState_with_dynamic_entries");
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < arraysize(kHosts); ++j)
+      state.GetDomainState(kHosts[j], true /* sni_enabled */, &domain_state);
+  }
+  timer.Done();
+}
+
+}  // namespace net
@@ -1072,7 +1072,6 @@ CookieList CookieMonster::GetAllCookiesForURLWithOptions(
 
   std::vector<CanonicalCookie*> cookie_ptrs;
   FindCookiesForHostAndDomain(url, options, false, &cookie_ptrs);
-  std::sort(cookie_ptrs.begin(), cookie_ptrs.end(), CookieSorter);
 
   CookieList cookies;
   for (std::vector<CanonicalCookie*>::const_iterator it = cookie_ptrs.begin();
@@ -1231,7 +1230,6 @@ std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
 
   std::vector<CanonicalCookie*> cookies;
   FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
 
   std::string cookie_line = BuildCookieLine(cookies);
 
@@ -1258,7 +1256,6 @@ void CookieMonster::GetCookiesWithInfo(const GURL& url,
 
   std::vector<CanonicalCookie*> cookies;
   FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
   *cookie_line = BuildCookieLine(cookies);
 
   histogram_time_get_->AddTime(TimeTicks::Now() - start_time);
@@ -1291,9 +1288,11 @@ void CookieMonster::DeleteCookie(const GURL& url,
     matching_cookies.insert(*it);
   }
 
-  for (CookieMap::iterator it = cookies_.begin(); it != cookies_.end();) {
-    CookieMap::iterator curit = it;
-    ++it;
+  // All of the matching cookies are stored under the key of the url's host.
+  for (CookieMapItPair its = cookies_.equal_range(GetKey(url.host()));
+       its.first != its.second; ) {
+    CookieMap::iterator curit = its.first;
+    ++its.first;
     if (matching_cookies.find(curit->second) != matching_cookies.end()) {
       InternalDeleteCookie(curit, true, DELETE_COOKIE_EXPLICIT);
     }
@@ -1682,7 +1681,13 @@ void CookieMonster::InternalInsertCookie(const std::string& key,
   if ((cc->IsPersistent() || persist_session_cookies_) &&
       store_ && sync_to_store)
     store_->AddCookie(*cc);
-  cookies_.insert(CookieMap::value_type(key, cc));
+  // Insert before the first cookie of |key| that is sent after |cc|.
+  CookieMapItPair its = cookies_.equal_range(key);
+  for (; its.first != its.second; ++its.first) {
+    if (CookieSorter(cc, its.first->second))
+      break;
+  }
+  cookies_.insert(its.first, CookieMap::value_type(key, cc));
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, CookieMonster::Delegate::CHANGE_COOKIE_EXPLICIT);
@@ -468,6 +468,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   void SetDefaultCookieableSchemes();
 
+  // Appends the cookies that match |url| to |cookies|, in the order in which
+  // they should be sent.
   void FindCookiesForHostAndDomain(const GURL& url,
                                    const CookieOptions& options,
                                    bool update_access_time,
@@ -491,7 +493,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
                                  bool skip_httponly,
                                  bool already_expired);
 
-  // Takes ownership of *cc.
+  // Takes ownership of *cc. Inserts it after the cookies of |key| that are
+  // sent before it.
   void InternalInsertCookie(const std::string& key,
                             CanonicalCookie* cc,
                             bool sync_to_store);
@@ -588,6 +591,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
   base::Histogram* histogram_time_mac_;
   base::Histogram* histogram_time_blocked_on_load_;
 
+  // The cookies of each key are kept in the order in which they are sent to
+  // servers, so that FindCookiesForKey() does not need to sort them.
   CookieMap cookies_;
 
   // Indicates whether the cookie store has been initialized. This happens
@@ -5,10 +5,12 @@
 #include <algorithm>
 
 #include "base/bind.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop.h"
 #include "base/perftimer.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
+#include "base/threading/thread.h"
 #include "googleurl/src/gurl.h"
 #include "net/cookies/canonical_cookie.h"
 #include "net/cookies/cookie_monster.h"
@@ -225,6 +227,59 @@ TEST_F(CookieMonsterTest, TestGetCookiesWithInfo) {
   timer.Done();
 }
 
+static void CountCookieLine(int* count, const std::string& cookie_line) {
+  if (!cookie_line.empty())
+    ++*count;
+}
+
+// Queries the cookies of each of |gurls| from the current thread. The
+// callbacks complete synchronously since |cm| has no backing store.
+static void QueryCookiesOnHosts(CookieMonster* cm,
+                                const std::vector<GURL>* gurls) {
+  CookieOptions options;
+  int count = 0;
+  for (std::vector<GURL>::const_iterator it = gurls->begin();
+       it != gurls->end(); ++it) {
+    cm->GetCookiesWithOptionsAsync(*it, options,
+                                   base::Bind(&CountCookieLine, &count));
+  }
+  EXPECT_EQ(static_cast<int>(gurls->size()), count);
+}
+
+// Measures readers on several threads querying the same CookieMonster at once,
+// as when it is shared with other threads than the IO thread.
+TEST_F(CookieMonsterTest, TestConcurrentReaders) {
+  const int kNumThreads = 4;
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+
+  std::vector<GURL> gurls;
+  for (int i = 0; i < kNumCookies; ++i)
+    gurls.push_back(GURL(base::StringPrintf("https://a%04d.izzle", i)));
+
+  SetCookieCallback setCookieCallback;
+  for (std::vector<GURL>::const_iterator it = gurls.begin();
+       it != gurls.end(); ++it) {
+    setCookieCallback.SetCookie(cm, *it, kCookieLine);
+  }
+
+  ScopedVector<base::Thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(
+        new base::Thread(base::StringPrintf("CookieReader%d", i).c_str()));
+    ASSERT_TRUE(threads.back()->Start());
+  }
+
+  PerfTimeLogger timer("Cookie_monster_query_concurrent_readers");
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i]->message_loop()->PostTask(
+        FROM_HERE, base::Bind(&QueryCookiesOnHosts, cm, &gurls));
+  }
+  // Stop() lets the queries finish first.
+  for (int i = 0; i < kNumThreads; ++i)
+    threads[i]->Stop();
+  timer.Done();
+}
+
 static int CountInString(const std::string& str, char c) {
   return std::count(str.begin(), str.end(), c);
 }
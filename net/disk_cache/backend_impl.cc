@@ -52,6 +52,9 @@ const int kDefaultCacheSize = 80 * 1024 * 1024;
 // Avoid trimming the cache for the first 5 minutes (10 timer ticks).
 const int kTrimDelay = 10;
 
+// Time to spend compacting block files before yielding to other tasks.
+const int kMaxCompactionTimeMs = 20;
+
 int DesiredIndexTableLen(int32 storage_size) {
   if (storage_size <= k64kEntriesStore)
     return kBaseTableLen;
@@ -150,6 +153,10 @@ bool InitExperiment(disk_cache::IndexHeader* header) {
     return false;
   }
 
+  // The eviction experiment stays with the files.
+  if (header->experiment == disk_cache::EXPERIMENT_FREQUENCY_EVICTION)
+    return true;
+
   header->experiment = disk_cache::NO_EXPERIMENT;
   return true;
 }
@@ -160,7 +167,7 @@ bool InitExperiment(disk_cache::IndexHeader* header) {
 class CacheCreator {
  public:
   CacheCreator(const FilePath& path, bool force, int max_bytes,
-               net::CacheType type, uint32 flags,
+               net::CacheType type, uint32 flags, int shard, int num_shards,
                base::MessageLoopProxy* thread, net::NetLog* net_log,
                disk_cache::Backend** backend,
                const net::CompletionCallback& callback)
@@ -170,6 +177,8 @@ class CacheCreator {
         max_bytes_(max_bytes),
         type_(type),
         flags_(flags),
+        shard_(shard),
+        num_shards_(num_shards),
         thread_(thread),
         backend_(backend),
         callback_(callback),
@@ -193,6 +202,8 @@ class CacheCreator {
   int max_bytes_;
   net::CacheType type_;
   uint32 flags_;
+  int shard_;
+  int num_shards_;
   scoped_refptr<base::MessageLoopProxy> thread_;
   disk_cache::Backend** backend_;
   net::CompletionCallback callback_;
@@ -207,6 +218,8 @@ int CacheCreator::Run() {
   cache_->SetMaxSize(max_bytes_);
   cache_->SetType(type_);
   cache_->SetFlags(flags_);
+  if (num_shards_)
+    cache_->SetShard(shard_, num_shards_);
   int rv = cache_->Init(
       base::Bind(&CacheCreator::OnIOComplete, base::Unretained(this)));
   DCHECK_EQ(net::ERR_IO_PENDING, rv);
@@ -313,6 +326,8 @@ BackendImpl::BackendImpl(const FilePath& path,
       cache_type_(net::DISK_CACHE),
       uma_report_(0),
       user_flags_(0),
+      shard_(0),
+      num_shards_(0),
       init_(false),
       restarted_(false),
       unit_test_(false),
@@ -321,6 +336,8 @@ BackendImpl::BackendImpl(const FilePath& path,
       new_eviction_(false),
       first_timer_(true),
       user_load_(false),
+      compacting_(false),
+      compaction_bucket_(0),
       net_log_(net_log),
       done_(true, false),
       ALLOW_THIS_IN_INITIALIZER_LIST(ptr_factory_(this)) {
@@ -339,6 +356,8 @@ BackendImpl::BackendImpl(const FilePath& path,
       cache_type_(net::DISK_CACHE),
       uma_report_(0),
       user_flags_(kMask),
+      shard_(0),
+      num_shards_(0),
       init_(false),
       restarted_(false),
       unit_test_(false),
@@ -347,6 +366,8 @@ BackendImpl::BackendImpl(const FilePath& path,
       new_eviction_(false),
       first_timer_(true),
       user_load_(false),
+      compacting_(false),
+      compaction_bucket_(0),
       net_log_(net_log),
       done_(true, false),
       ALLOW_THIS_IN_INITIALIZER_LIST(ptr_factory_(this)) {
@@ -390,10 +411,22 @@ int BackendImpl::CreateBackend(const FilePath& full_path, bool force,
                                uint32 flags, base::MessageLoopProxy* thread,
                                net::NetLog* net_log, Backend** backend,
                                const CompletionCallback& callback) {
+  return CreateShard(full_path, force, max_bytes, type, flags, 0, 0, thread,
+                     net_log, backend, callback);
+}
+
+// Static.
+int BackendImpl::CreateShard(const FilePath& full_path, bool force,
+                             int max_bytes, net::CacheType type, uint32 flags,
+                             int shard, int num_shards,
+                             base::MessageLoopProxy* thread,
+                             net::NetLog* net_log, Backend** backend,
+                             const CompletionCallback& callback) {
   DCHECK(!callback.is_null());
+  DCHECK(!num_shards || (shard >= 0 && shard < num_shards));
   CacheCreator* creator =
-      new CacheCreator(full_path, force, max_bytes, type, flags, thread,
-                       net_log, backend, callback);
+      new CacheCreator(full_path, force, max_bytes, type, flags, shard,
+                       num_shards, thread, net_log, backend, callback);
   // This object will self-destroy when finished.
   return creator->Run();
 }
@@ -457,6 +490,11 @@ int BackendImpl::SyncInit() {
       cache_type_ == net::DISK_CACHE && !InitExperiment(&data_->header))
     return net::ERR_FAILED;
 
+  if ((user_flags_ & kFrequencyEviction) && cache_type_ == net::DISK_CACHE) {
+    DCHECK(new_eviction_);
+    data_->header.experiment = EXPERIMENT_FREQUENCY_EVICTION;
+  }
+
   // We don't care if the value overflows. The only thing we care about is that
   // the id cannot be zero, because that value is used as "not dirty".
   // Increasing the value once per second gives us many years before we start
@@ -1249,6 +1287,11 @@ void BackendImpl::OnStatsTimer() {
   // Save stats to disk at 5 min intervals.
   if (time % 10 == 0)
     stats_.Store();
+
+  if (!compacting_ && !IsLoaded() &&
+      (up_ticks_ > kTrimDelay || user_flags_ & kNoRandom)) {
+    CompactBlockFiles();
+  }
 }
 
 void BackendImpl::IncrementIoCount() {
@@ -1274,10 +1317,21 @@ void BackendImpl::SetNewEviction() {
   new_eviction_ = true;
 }
 
+void BackendImpl::SetFrequencyEviction() {
+  SetNewEviction();
+  user_flags_ |= kFrequencyEviction;
+}
+
 void BackendImpl::SetFlags(uint32 flags) {
   user_flags_ |= flags;
 }
 
+void BackendImpl::SetShard(int shard, int num_shards) {
+  DCHECK(!init_);
+  shard_ = shard;
+  num_shards_ = num_shards;
+}
+
 void BackendImpl::ClearRefCountForTest() {
   num_refs_ = 0;
 }
@@ -1451,6 +1505,8 @@ bool BackendImpl::CreateBackingStore(disk_cache::File* file) {
     header.version = 0x20001;
 
   header.create_time = Time::Now().ToInternalValue();
+  header.num_shards = num_shards_;
+  header.shard = shard_;
 
   if (!file->Write(&header, sizeof(header), 0))
     return false;
@@ -1525,6 +1581,10 @@ void BackendImpl::AdjustMaxCacheSize(int table_len) {
   if (max_size_ > kDefaultCacheSize * 4)
     max_size_ = kDefaultCacheSize * 4;
 
+  // Each shard gets its part of the space of the whole cache.
+  if (num_shards_)
+    max_size_ /= num_shards_;
+
   if (!table_len)
     return;
 
@@ -1937,6 +1997,97 @@ void BackendImpl::DestroyInvalidEntry(EntryImpl* entry) {
   stats_.OnEvent(Stats::INVALID_ENTRY);
 }
 
+// A block can only be moved when we know every reference to it, so we only move
+// data and long keys, and only from entries that are not open. The new block is
+// written before the entry points to it, and the old one is deleted after that,
+// so a crash can leak a block but never leaves an entry pointing to the wrong
+// data.
+void BackendImpl::CompactBlockFiles() {
+  compacting_ = false;
+  if (disabled_ || read_only_ || !data_)
+    return;
+
+  if (!block_files_.compaction_file()) {
+    if (!block_files_.StartCompaction())
+      return;
+    compaction_bucket_ = 0;
+    stats_.OnEvent(Stats::COMPACTION_FILE);
+  }
+
+  int file_index = block_files_.compaction_file();
+  TimeTicks start = TimeTicks::Now();
+  for (; compaction_bucket_ <= static_cast<int>(mask_); compaction_bucket_++) {
+    if (!block_files_.compaction_file()) {
+      // The last block is gone, so the file was deleted.
+      stats_.OnEvent(Stats::COMPACTION_DONE);
+      return;
+    }
+
+    if ((TimeTicks::Now() - start).InMilliseconds() > kMaxCompactionTimeMs) {
+      // Keep going later, or on the next timer tick if we are busy.
+      if (!IsLoaded()) {
+        compacting_ = true;
+        MessageLoop::current()->PostTask(FROM_HERE, base::Bind(
+            &BackendImpl::CompactBlockFiles, ptr_factory_.GetWeakPtr()));
+      }
+      return;
+    }
+
+    Addr address(data_->table[compaction_bucket_]);
+    while (address.is_initialized()) {
+      bool open = open_entries_.find(address.value()) != open_entries_.end();
+      EntryImpl* entry;
+      if (NewEntry(address, &entry))
+        break;
+
+      if (!open)
+        MoveEntryBlocks(entry, file_index);
+      address.set_value(entry->GetNextAddress());
+      entry->Release();
+    }
+  }
+
+  // Some blocks belong to open entries, so the file is still there. We'll pick
+  // a file again after a while.
+  if (block_files_.compaction_file())
+    block_files_.FinishCompaction();
+  else
+    stats_.OnEvent(Stats::COMPACTION_DONE);
+}
+
+void BackendImpl::MoveEntryBlocks(EntryImpl* entry, int file_index) {
+  EntryStore* store = entry->entry()->Data();
+  CacheAddr* addresses[arraysize(store->data_addr) + 1];
+  for (size_t i = 0; i < arraysize(store->data_addr); i++)
+    addresses[i] = &store->data_addr[i];
+  addresses[arraysize(store->data_addr)] = &store->long_key;
+
+  CacheAddr old_addresses[arraysize(addresses)];
+  int num_moved = 0;
+  for (size_t i = 0; i < arraysize(addresses); i++) {
+    Addr address(*addresses[i]);
+    if (!address.is_initialized() || !address.is_block_file() ||
+        address.FileNumber() != file_index) {
+      continue;
+    }
+
+    Addr new_address;
+    if (!block_files_.CopyBlock(address, &new_address))
+      break;
+    old_addresses[num_moved++] = address.value();
+    *addresses[i] = new_address.value();
+  }
+
+  if (!num_moved)
+    return;
+
+  entry->entry()->Store();
+  for (int i = 0; i < num_moved; i++) {
+    block_files_.DeleteBlock(Addr(old_addresses[i]), true);
+    stats_.OnEvent(Stats::COMPACTION_MOVE);
+  }
+}
+
 void BackendImpl::AddStorageSize(int32 bytes) {
   data_->header.num_bytes += bytes;
   DCHECK_GE(data_->header.num_bytes, 0);
@@ -2125,6 +2276,12 @@ bool BackendImpl::CheckIndex() {
     }
   }
 
+  if (data_->header.num_shards != num_shards_ ||
+      data_->header.shard != shard_) {
+    LOG(ERROR) << "Invalid shard";
+    return false;
+  }
+
   if (!data_->header.table_len) {
     LOG(ERROR) << "Invalid table size";
     return false;
@@ -34,7 +34,8 @@ enum BackendFlags {
   kNewEviction = 1 << 4,        // Use of new eviction was specified.
   kNoRandom = 1 << 5,           // Don't add randomness to the behavior.
   kNoLoadProtection = 1 << 6,   // Don't act conservatively under load.
-  kNoBuffering = 1 << 7         // Disable extended IO buffering.
+  kNoBuffering = 1 << 7,        // Disable extended IO buffering.
+  kFrequencyEviction = 1 << 8   // Use of frequency eviction was specified.
 };
 
 // This class implements the Backend interface. An object of this
@@ -57,6 +58,15 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
                            net::NetLog* net_log, Backend** backend,
                            const CompletionCallback& callback);
 
+  // Returns a new backend for shard |shard| of a cache split in |num_shards|
+  // shards (see ShardedBackendImpl). The other arguments are the same as for
+  // CreateBackend().
+  static int CreateShard(const FilePath& full_path, bool force,
+                         int max_bytes, net::CacheType type, uint32 flags,
+                         int shard, int num_shards,
+                         base::MessageLoopProxy* thread, net::NetLog* net_log,
+                         Backend** backend, const CompletionCallback& callback);
+
   // Performs general initialization for this current instance of the cache.
   int Init(const CompletionCallback& callback);
 
@@ -230,9 +240,18 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   // Sets the eviction algorithm to version 2.
   void SetNewEviction();
 
+  // Sets the eviction algorithm to version 2, taking into account the size and
+  // recent use of the entries (EXPERIMENT_FREQUENCY_EVICTION).
+  void SetFrequencyEviction();
+
   // Sets an explicit set of BackendFlags.
   void SetFlags(uint32 flags);
 
+  // Makes this instance store shard |shard| of a cache split in |num_shards|
+  // shards. The stored files are only valid for that shard, and the maximum
+  // size that is not set explicitly is split between the shards.
+  void SetShard(int shard, int num_shards);
+
   // Clears the counter of references to test handling of corruptions.
   void ClearRefCountForTest();
 
@@ -324,6 +343,13 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
 
   void DestroyInvalidEntry(EntryImpl* entry);
 
+  // Moves blocks out of the file selected by BlockFiles::StartCompaction(),
+  // walking the index table a few buckets at a time while the cache is idle.
+  void CompactBlockFiles();
+
+  // Moves to other files the blocks of |entry| that are stored on |file_index|.
+  void MoveEntryBlocks(EntryImpl* entry, int file_index);
+
   // Handles the used storage count.
   void AddStorageSize(int32 bytes);
   void SubstractStorageSize(int32 bytes);
@@ -375,6 +401,8 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   net::CacheType cache_type_;
   int uma_report_;  // Controls transmission of UMA data.
   uint32 user_flags_;  // Flags set by the user.
+  int shard_;  // The shard stored by this instance, if num_shards_ is not 0.
+  int num_shards_;  // Number of shards of a sharded cache.
   bool init_;  // controls the initialization of the system.
   bool restarted_;
   bool unit_test_;
@@ -383,6 +411,8 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   bool new_eviction_;  // What eviction algorithm should be used.
   bool first_timer_;  // True if the timer has not been called.
   bool user_load_;  // True if we see a high load coming from the caller.
+  bool compacting_;  // True if a CompactBlockFiles() task is pending.
+  int compaction_bucket_;  // Next bucket to visit by CompactBlockFiles().
 
   net::NetLog* net_log_;
 
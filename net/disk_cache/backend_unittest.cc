@@ -20,6 +20,7 @@
 #include "net/disk_cache/histogram_macros.h"
 #include "net/disk_cache/mapped_file.h"
 #include "net/disk_cache/mem_backend_impl.h"
+#include "net/disk_cache/sharded_backend_impl.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 #if defined(OS_WIN)
@@ -649,6 +650,43 @@ TEST_F(DiskCacheBackendTest, NewEvictionTrim) {
   entry->Close();
 }
 
+// Tests that a small entry that is used often survives a trim that evicts a
+// big entry used less often, even if the small one is older.
+TEST_F(DiskCacheBackendTest, FrequencyEvictionTrim) {
+  SetFrequencyEviction();
+  SetDirectMode();
+  InitCache();
+
+  const int kSmallSize = 100;
+  const int kBigSize = 200 * 1024;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kBigSize));
+  CacheTestFillBuffer(buffer->data(), kBigSize, false);
+
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("small", &entry));
+  EXPECT_EQ(kSmallSize, WriteData(entry, 1, 0, buffer, kSmallSize, false));
+  entry->Close();
+  ASSERT_EQ(net::OK, CreateEntry("big", &entry));
+  EXPECT_EQ(kBigSize, WriteData(entry, 1, 0, buffer, kBigSize, false));
+  entry->Close();
+
+  // Both entries end up on list 1, with the small one at the tail.
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(net::OK, OpenEntry("small", &entry));
+    entry->Close();
+  }
+  ASSERT_EQ(net::OK, OpenEntry("big", &entry));
+  entry->Close();
+
+  // The first trim gives the small entry another pass, and the second one
+  // evicts the big entry.
+  TrimForTest(false);
+  TrimForTest(false);
+  EXPECT_NE(net::OK, OpenEntry("big", &entry));
+  ASSERT_EQ(net::OK, OpenEntry("small", &entry));
+  entry->Close();
+}
+
 // Before looking for invalid entries, let's check a valid entry.
 void DiskCacheBackendTest::BackendValidEntry() {
   SetDirectMode();
@@ -2575,3 +2613,163 @@ TEST_F(DiskCacheBackendTest, UpdateRankForExternalCacheHit) {
   ASSERT_EQ(net::OK, OpenEntry("key0", &entry));
   entry->Close();
 }
+
+// Tests that the keys of a sharded cache are spread between the shards, and
+// that the backend behaves as a regular one.
+TEST_F(DiskCacheTest, ShardedBackend) {
+  const int kNumShards = 4;
+  const int kNumEntries = 100;
+  net::TestCompletionCallback cb;
+
+  ASSERT_TRUE(CleanupCacheDir());
+  base::Thread thread0("CacheThread0"), thread1("CacheThread1");
+  base::Thread::Options options(MessageLoop::TYPE_IO, 0);
+  ASSERT_TRUE(thread0.StartWithOptions(options));
+  ASSERT_TRUE(thread1.StartWithOptions(options));
+  // Shards can share a thread.
+  disk_cache::ShardedBackendImpl::ThreadList threads;
+  for (int i = 0; i < kNumShards; i++) {
+    threads.push_back(i % 2 ? thread1.message_loop_proxy() :
+                              thread0.message_loop_proxy());
+  }
+
+  int keys_per_shard[kNumShards] = {0};
+  for (int i = 0; i < kNumEntries; i++) {
+    int shard = disk_cache::ShardedBackendImpl::GetShardForKey(
+        base::StringPrintf("key%d", i), kNumShards);
+    ASSERT_LE(0, shard);
+    ASSERT_GT(kNumShards, shard);
+    keys_per_shard[shard]++;
+  }
+  for (int i = 0; i < kNumShards; i++)
+    EXPECT_LT(0, keys_per_shard[i]);
+
+  disk_cache::Backend* cache = NULL;
+  int rv = disk_cache::ShardedBackendImpl::CreateBackend(
+      cache_path_, false, 0, net::DISK_CACHE, disk_cache::kNoRandom, threads,
+      NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  ASSERT_TRUE(cache);
+
+  const int kSize = 100;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+  for (int i = 0; i < kNumEntries; i++) {
+    disk_cache::Entry* entry;
+    rv = cache->CreateEntry(base::StringPrintf("key%d", i), &entry,
+                            cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+    rv = entry->WriteData(0, 0, buffer, kSize, cb.callback(), false);
+    EXPECT_EQ(kSize, cb.GetResult(rv));
+    entry->Close();
+  }
+  EXPECT_EQ(kNumEntries, cache->GetEntryCount());
+  delete cache;
+  cache = NULL;
+
+  for (int i = 0; i < kNumShards; i++) {
+    EXPECT_TRUE(file_util::PathExists(
+        disk_cache::ShardedBackendImpl::GetShardPath(cache_path_, i)
+            .AppendASCII("index")));
+  }
+
+  // Reopen the cache and find all the entries again.
+  rv = disk_cache::ShardedBackendImpl::CreateBackend(
+      cache_path_, false, 0, net::DISK_CACHE, disk_cache::kNoRandom, threads,
+      NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_EQ(kNumEntries, cache->GetEntryCount());
+
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  for (int i = 0; i < kNumEntries; i++) {
+    disk_cache::Entry* entry;
+    rv = cache->OpenEntry(base::StringPrintf("key%d", i), &entry,
+                          cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+    rv = entry->ReadData(0, 0, buffer2, kSize, cb.callback());
+    EXPECT_EQ(kSize, cb.GetResult(rv));
+    EXPECT_EQ(0, memcmp(buffer->data(), buffer2->data(), kSize));
+    entry->Close();
+  }
+
+  // The enumeration walks all the shards.
+  void* iter = NULL;
+  disk_cache::Entry* entry;
+  int count = 0;
+  while (net::OK == cb.GetResult(cache->OpenNextEntry(&iter, &entry,
+                                                      cb.callback()))) {
+    entry->Close();
+    count++;
+  }
+  EXPECT_EQ(kNumEntries, count);
+  EXPECT_TRUE(iter == NULL);
+
+  // Ending an enumeration half way releases it.
+  ASSERT_EQ(net::OK, cb.GetResult(cache->OpenNextEntry(&iter, &entry,
+                                                       cb.callback())));
+  entry->Close();
+  cache->EndEnumeration(&iter);
+  EXPECT_TRUE(iter == NULL);
+
+  rv = cache->DoomEntry("key0", cb.callback());
+  EXPECT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_EQ(kNumEntries - 1, cache->GetEntryCount());
+
+  rv = cache->DoomAllEntries(cb.callback());
+  EXPECT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_EQ(0, cache->GetEntryCount());
+  delete cache;
+  MessageLoop::current()->RunAllPending();
+}
+
+// Tests that the files of a cache with a different number of shards are
+// only used when they can be discarded.
+TEST_F(DiskCacheTest, ShardedBackend_NumShardsChanged) {
+  net::TestCompletionCallback cb;
+
+  ASSERT_TRUE(CleanupCacheDir());
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(MessageLoop::TYPE_IO, 0)));
+  disk_cache::ShardedBackendImpl::ThreadList threads(
+      3, cache_thread.message_loop_proxy());
+
+  disk_cache::Backend* cache = NULL;
+  int rv = disk_cache::ShardedBackendImpl::CreateBackend(
+      cache_path_, false, 0, net::DISK_CACHE, disk_cache::kNoRandom, threads,
+      NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  disk_cache::Entry* entry;
+  for (int i = 0; i < 10; i++) {
+    rv = cache->CreateEntry(base::StringPrintf("key%d", i), &entry,
+                            cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+    entry->Close();
+  }
+  delete cache;
+  cache = NULL;
+
+  threads.pop_back();
+  rv = disk_cache::ShardedBackendImpl::CreateBackend(
+      cache_path_, false, 0, net::DISK_CACHE, disk_cache::kNoRandom, threads,
+      NULL, &cache, cb.callback());
+  EXPECT_NE(net::OK, cb.GetResult(rv));
+  EXPECT_TRUE(cache == NULL);
+
+  rv = disk_cache::ShardedBackendImpl::CreateBackend(
+      cache_path_, true, 0, net::DISK_CACHE, disk_cache::kNoRandom, threads,
+      NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_EQ(0, cache->GetEntryCount());
+  EXPECT_FALSE(file_util::PathExists(
+      disk_cache::ShardedBackendImpl::GetShardPath(cache_path_, 2)));
+  delete cache;
+
+  // A regular cache can't use the files of a shard.
+  rv = disk_cache::BackendImpl::CreateBackend(
+      disk_cache::ShardedBackendImpl::GetShardPath(cache_path_, 0), false, 0,
+      net::DISK_CACHE, disk_cache::kNoRandom, cache_thread.message_loop_proxy(),
+      NULL, &cache, cb.callback());
+  EXPECT_NE(net::OK, cb.GetResult(rv));
+  MessageLoop::current()->RunAllPending();
+}
@@ -219,7 +219,7 @@ bool ValidateCounters(const disk_cache::BlockFileHeader* header) {
 namespace disk_cache {
 
 BlockFiles::BlockFiles(const FilePath& path)
-    : init_(false), zero_buffer_(NULL), path_(path) {
+    : init_(false), compaction_file_(0), zero_buffer_(NULL), path_(path) {
 }
 
 BlockFiles::~BlockFiles() {
@@ -345,6 +345,7 @@ void BlockFiles::CloseFiles() {
     DCHECK(thread_checker_->CalledOnValidThread());
   }
   init_ = false;
+  compaction_file_ = 0;
   for (unsigned int i = 0; i < block_files_.size(); i++) {
     if (block_files_[i]) {
       block_files_[i]->Release();
@@ -402,6 +403,60 @@ bool BlockFiles::IsValid(Addr address) {
 #endif
 }
 
+bool BlockFiles::StartCompaction() {
+  DCHECK(thread_checker_->CalledOnValidThread());
+  compaction_file_ = 0;
+  if (!init_)
+    return false;
+
+  // The rankings and entries files are not compacted, because the addresses
+  // of their blocks are stored all over the cache.
+  for (int i = BLOCK_1K; i <= BLOCK_4K; i++) {
+    compaction_file_ = FileToCompact(static_cast<FileType>(i));
+    if (compaction_file_)
+      return true;
+  }
+  return false;
+}
+
+void BlockFiles::FinishCompaction() {
+  DCHECK(thread_checker_->CalledOnValidThread());
+  compaction_file_ = 0;
+}
+
+bool BlockFiles::CopyBlock(Addr source, Addr* destination) {
+  DCHECK(thread_checker_->CalledOnValidThread());
+  if (!source.is_initialized() || source.is_separate_file())
+    return false;
+
+  MappedFile* file = GetFile(source);
+  if (!file)
+    return false;
+
+  size_t size = source.BlockSize() * source.num_blocks();
+  size_t offset = source.start_block() * source.BlockSize() + kBlockHeaderSize;
+  scoped_array<char> buffer(new char[size]);
+  if (!file->Read(buffer.get(), size, offset))
+    return false;
+
+  Addr address;
+  if (!CreateBlock(source.file_type(), source.num_blocks(), &address))
+    return false;
+  DCHECK_NE(compaction_file_, address.FileNumber());
+
+  // CreateBlock() may have opened more files, so |file| could be stale.
+  file = GetFile(address);
+  offset = address.start_block() * address.BlockSize() + kBlockHeaderSize;
+  if (!file || !file->Write(buffer.get(), size, offset)) {
+    DeleteBlock(address, false);
+    return false;
+  }
+
+  destination->set_value(address.value());
+  Trace("CopyBlock 0x%x to 0x%x", source.value(), address.value());
+  return true;
+}
+
 bool BlockFiles::CreateBlockFile(int index, FileType file_type, bool force) {
   FilePath name = Name(index);
   int flags =
@@ -511,8 +566,9 @@ MappedFile* BlockFiles::FileForNewBlock(FileType block_type, int block_count) {
   BlockFileHeader* header = reinterpret_cast<BlockFileHeader*>(file->buffer());
 
   TimeTicks start = TimeTicks::Now();
-  while (NeedToGrowBlockFile(header, block_count)) {
-    if (kMaxBlocks == header->max_entries) {
+  while (NeedToGrowBlockFile(header, block_count) ||
+         IsCompactionFile(header)) {
+    if (kMaxBlocks == header->max_entries || IsCompactionFile(header)) {
       file = NextFile(file);
       if (!file)
         return NULL;
@@ -580,6 +636,8 @@ bool BlockFiles::RemoveEmptyFile(FileType block_type) {
       // Delete next_file and remove it from the chain.
       int file_index = header->next_file;
       header->next_file = next_header->next_file;
+      if (file_index == compaction_file_)
+        compaction_file_ = 0;
       DCHECK(block_files_.size() >= static_cast<unsigned int>(file_index));
       file->Flush();
 
@@ -604,6 +662,54 @@ bool BlockFiles::RemoveEmptyFile(FileType block_type) {
   return true;
 }
 
+// A file is a good candidate for compaction when it stores less than a quarter
+// of the blocks that it can store, and another file of the chain can take all
+// of them and still have enough space to be used for new blocks (see
+// NeedToGrowBlockFile). Out of the candidates, we pick the one with less data
+// to move.
+int BlockFiles::FileToCompact(FileType block_type) {
+  std::vector<int> files;
+  std::vector<int> used_blocks;
+  std::vector<int> empty_blocks;
+  int index = block_type - 1;
+  for (;;) {
+    if (!block_files_[index] && !OpenBlockFile(index))
+      return 0;
+
+    BlockFileHeader* header =
+        reinterpret_cast<BlockFileHeader*>(block_files_[index]->buffer());
+    int empty = EmptyBlocks(header);
+    files.push_back(index);
+    empty_blocks.push_back(empty);
+    used_blocks.push_back(header->max_entries - empty);
+
+    if (!header->next_file)
+      break;
+    index = header->next_file;
+  }
+
+  int best_file = 0;
+  int best_used = kMaxBlocks / 4;
+  for (size_t i = 0; i < files.size(); i++) {
+    if (files[i] < kFirstAdditionalBlockFile || used_blocks[i] >= best_used)
+      continue;
+
+    for (size_t j = 0; j < files.size(); j++) {
+      if (j != i &&
+          empty_blocks[j] - used_blocks[i] >= kMaxBlocks / 10) {
+        best_file = files[i];
+        best_used = used_blocks[i];
+        break;
+      }
+    }
+  }
+  return best_file;
+}
+
+bool BlockFiles::IsCompactionFile(const BlockFileHeader* header) const {
+  return compaction_file_ && header->this_file == compaction_file_;
+}
+
 // Note that we expect to be called outside of a FileLock... however, we cannot
 // DCHECK on header->updating because we may be fixing a crash.
 bool BlockFiles::FixBlockFileHeader(MappedFile* file) {
@@ -56,6 +56,22 @@ class NET_EXPORT_PRIVATE BlockFiles {
   // This method is only intended for debugging.
   bool IsValid(Addr address);
 
+  // Looks for a mostly empty additional file of the 1K or 4K chains whose
+  // blocks fit on the rest of the chain, and returns true if one is found.
+  // New blocks are not allocated on that file (the compaction file) until
+  // FinishCompaction() is called or the file is deleted when its last block
+  // goes away.
+  bool StartCompaction();
+  void FinishCompaction();
+
+  // Returns the index of the compaction file, or zero if there is none.
+  int compaction_file() const { return compaction_file_; }
+
+  // Allocates a block of the same type and size as |source| on a file other
+  // than the compaction file, and copies the data from |source| to it. The
+  // caller has to update the references to |source| and delete it.
+  bool CopyBlock(Addr source, Addr* destination);
+
  private:
   // Set force to true to overwrite the file if it exists.
   bool CreateBlockFile(int index, FileType file_type, bool force);
@@ -76,6 +92,12 @@ class NET_EXPORT_PRIVATE BlockFiles {
   // Removes a chained block file that is now empty.
   bool RemoveEmptyFile(FileType block_type);
 
+  // Returns the file of the |block_type| chain that should be emptied, or zero.
+  int FileToCompact(FileType block_type);
+
+  // Returns true if |header| belongs to the compaction file.
+  bool IsCompactionFile(const BlockFileHeader* header) const;
+
   // Restores the header of a potentially inconsistent file.
   bool FixBlockFileHeader(MappedFile* file);
 
@@ -86,6 +108,7 @@ class NET_EXPORT_PRIVATE BlockFiles {
   FilePath Name(int index);
 
   bool init_;
+  int compaction_file_;  // File that is being emptied, or zero.
   char* zero_buffer_;  // Buffer to speed-up cleaning deleted entries.
   FilePath path_;  // Path to the backing folder.
   std::vector<MappedFile*> block_files_;  // The actual files.
@@ -95,6 +118,7 @@ class NET_EXPORT_PRIVATE BlockFiles {
   FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_TruncatedFile);
   FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_InvalidFile);
   FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_Stats);
+  FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_Compaction);
 
   DISALLOW_COPY_AND_ASSIGN(BlockFiles);
 };
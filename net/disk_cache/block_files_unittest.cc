@@ -297,6 +297,67 @@ TEST_F(DiskCacheTest, BlockFiles_Stats) {
   EXPECT_EQ(0, load);
 }
 
+// Tests that a mostly empty file can be emptied by moving its blocks.
+TEST_F(DiskCacheTest, BlockFiles_Compaction) {
+  ASSERT_TRUE(CleanupCacheDir());
+  ASSERT_TRUE(file_util::CreateDirectory(cache_path_));
+
+  BlockFiles files(cache_path_);
+  ASSERT_TRUE(files.Init(true));
+
+  // Fill up the 1KB block file, and place a few blocks on a second file.
+  const int kExtraBlocks = 1000;
+  std::vector<Addr> address(kMaxBlocks + kExtraBlocks);
+  for (size_t i = 0; i < address.size(); i++)
+    ASSERT_TRUE(files.CreateBlock(BLOCK_1K, 1, &address[i]));
+  EXPECT_EQ(2, address[0].FileNumber());
+  const int kSecondFile = address[kMaxBlocks].FileNumber();
+  EXPECT_LE(kFirstAdditionalBlockFile, kSecondFile);
+  EXPECT_EQ(5, NumberOfFiles(cache_path_));
+
+  // There is no room for the blocks of the second file.
+  EXPECT_FALSE(files.StartCompaction());
+
+  for (int i = 0; i < kMaxBlocks / 5; i++)
+    files.DeleteBlock(address[i], false);
+  ASSERT_TRUE(files.StartCompaction());
+  EXPECT_EQ(kSecondFile, files.compaction_file());
+
+  // New blocks don't go to the compaction file.
+  Addr new_block;
+  EXPECT_TRUE(files.CreateBlock(BLOCK_1K, 1, &new_block));
+  EXPECT_NE(kSecondFile, new_block.FileNumber());
+  files.DeleteBlock(new_block, false);
+
+  char buffer[1024];
+  CacheTestFillBuffer(buffer, sizeof(buffer), false);
+  Addr source(address[kMaxBlocks]);
+  size_t offset = source.start_block() * source.BlockSize() + kBlockHeaderSize;
+  EXPECT_TRUE(files.GetFile(source)->Write(buffer, sizeof(buffer), offset));
+
+  for (int i = kMaxBlocks; i < kMaxBlocks + kExtraBlocks; i++) {
+    EXPECT_EQ(kSecondFile, files.compaction_file());
+    Addr destination;
+    ASSERT_TRUE(files.CopyBlock(address[i], &destination));
+    EXPECT_EQ(2, destination.FileNumber());
+    if (i == kMaxBlocks) {
+      char data[1024];
+      offset = destination.start_block() * destination.BlockSize() +
+               kBlockHeaderSize;
+      EXPECT_TRUE(files.GetFile(destination)->Read(data, sizeof(data),
+                                                   offset));
+      EXPECT_EQ(0, memcmp(buffer, data, sizeof(data)));
+    }
+    files.DeleteBlock(address[i], false);
+    address[i] = destination;
+  }
+
+  // The second file is gone.
+  EXPECT_EQ(0, files.compaction_file());
+  EXPECT_EQ(4, NumberOfFiles(cache_path_));
+  EXPECT_FALSE(files.StartCompaction());
+}
+
 // Tests that we add and remove blocks correctly.
 TEST_F(DiskCacheTest, AllocationMap) {
   ASSERT_TRUE(CleanupCacheDir());
@@ -8,8 +8,11 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/hash.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/perftimer.h"
 #include "base/string_util.h"
+#include "base/stringprintf.h"
 #include "base/threading/thread.h"
 #include "base/test/test_file_util.h"
 #include "base/timer.h"
@@ -21,6 +24,8 @@
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
+#include "net/disk_cache/mem_backend_impl.h"
+#include "net/disk_cache/sharded_backend_impl.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
@@ -138,6 +143,111 @@ bool TimeRead(int num_entries, disk_cache::Backend* cache,
   return (expected == helper.callbacks_called());
 }
 
+// Opens (or creates) an entry and reads (or writes) its data, without waiting
+// for other entries, the way a server handling many requests uses the cache.
+class ConcurrentEntryOperation {
+ public:
+  ConcurrentEntryOperation(disk_cache::Backend* cache, const TestEntry& entry,
+                           net::IOBuffer* buffer, bool create, int* pending)
+      : cache_(cache),
+        key_(entry.key),
+        buffer_(buffer),
+        data_len_(entry.data_len),
+        create_(create),
+        pending_(pending),
+        entry_(NULL),
+        success_(false) {
+  }
+
+  void Start() {
+    net::CompletionCallback callback =
+        base::Bind(&ConcurrentEntryOperation::OnEntryReady,
+                   base::Unretained(this));
+    int rv = create_ ? cache_->CreateEntry(key_, &entry_, callback) :
+                       cache_->OpenEntry(key_, &entry_, callback);
+    if (rv != net::ERR_IO_PENDING)
+      OnEntryReady(rv);
+  }
+
+  bool success() const { return success_; }
+
+ private:
+  void OnEntryReady(int result) {
+    if (result != net::OK)
+      return Done(false);
+
+    net::CompletionCallback callback =
+        base::Bind(&ConcurrentEntryOperation::OnIOComplete,
+                   base::Unretained(this));
+    int rv = create_ ?
+        entry_->WriteData(1, 0, buffer_, data_len_, callback, false) :
+        entry_->ReadData(1, 0, buffer_, data_len_, callback);
+    if (rv != net::ERR_IO_PENDING)
+      OnIOComplete(rv);
+  }
+
+  void OnIOComplete(int result) {
+    entry_->Close();
+    Done(result == data_len_);
+  }
+
+  void Done(bool success) {
+    success_ = success;
+    if (!--*pending_)
+      MessageLoop::current()->Quit();
+  }
+
+  disk_cache::Backend* cache_;
+  std::string key_;
+  scoped_refptr<net::IOBuffer> buffer_;
+  int data_len_;
+  bool create_;
+  int* pending_;
+  disk_cache::Entry* entry_;
+  bool success_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentEntryOperation);
+};
+
+// Starts the creation (with a write) or the opening (with a read) of all the
+// |entries| at once, and waits until all of them are done.
+bool TimeConcurrent(const char* message, disk_cache::Backend* cache,
+                    const TestEntries& entries, bool create) {
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kMaxSize));
+  CacheTestFillBuffer(buffer->data(), kMaxSize, false);
+
+  PerfTimeLogger timer(message);
+
+  int pending = static_cast<int>(entries.size());
+  ScopedVector<ConcurrentEntryOperation> operations;
+  for (size_t i = 0; i < entries.size(); i++) {
+    operations.push_back(
+        new ConcurrentEntryOperation(cache, entries[i], buffer, create,
+                                     &pending));
+    operations.back()->Start();
+  }
+  if (pending)
+    MessageLoop::current()->Run();
+  timer.Done();
+
+  for (size_t i = 0; i < operations.size(); i++) {
+    if (!operations[i]->success())
+      return false;
+  }
+  return true;
+}
+
+bool TimeConcurrentBackend(const std::string& name,
+                           disk_cache::Backend* cache,
+                           const TestEntries& entries) {
+  bool success = TimeConcurrent(
+      (name + ": create disk cache entries (concurrent)").c_str(), cache,
+      entries, true);
+  return success && TimeConcurrent(
+      (name + ": read disk cache entries (concurrent)").c_str(), cache,
+      entries, false);
+}
+
 int BlockSize() {
   // We can use form 1 to 4 blocks.
   return (rand() & 0x3) + 1;
@@ -206,6 +316,86 @@ TEST_F(DiskCacheTest, CacheBackendPerformance) {
   delete cache;
 }
 
+// Compares a regular backend with a sharded one when many requests are issued
+// at the same time. The regular backend serves all of them from a single cache
+// thread.
+TEST_F(DiskCacheTest, ConcurrentBackendPerformance) {
+  const int kNumShards = 4;
+  const int kNumEntries = 2000;
+
+  disk_cache::ShardedBackendImpl::ThreadList threads;
+  ScopedVector<base::Thread> cache_threads;
+  for (int i = 0; i < kNumShards; i++) {
+    cache_threads.push_back(new base::Thread("CacheThread"));
+    ASSERT_TRUE(cache_threads.back()->StartWithOptions(
+                    base::Thread::Options(MessageLoop::TYPE_IO, 0)));
+    threads.push_back(cache_threads.back()->message_loop_proxy());
+  }
+
+  int seed = static_cast<int>(Time::Now().ToInternalValue());
+  srand(seed);
+
+  TestEntries entries;
+  for (int i = 0; i < kNumEntries; i++) {
+    TestEntry entry;
+    entry.key = GenerateKey(true);
+    entry.data_len = rand() % kMaxSize + 1;
+    entries.push_back(entry);
+  }
+
+  ASSERT_TRUE(CleanupCacheDir());
+  net::TestCompletionCallback cb;
+  disk_cache::Backend* cache;
+  int rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, cache_path_.AppendASCII("regular"), 0, false,
+      threads[0], NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_TRUE(TimeConcurrentBackend("Regular", cache, entries));
+  MessageLoop::current()->RunAllPending();
+  delete cache;
+
+  rv = disk_cache::ShardedBackendImpl::CreateBackend(
+      cache_path_.AppendASCII("sharded"), false, 0, net::DISK_CACHE,
+      disk_cache::kNone, threads, NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_TRUE(TimeConcurrentBackend(
+      base::StringPrintf("%d shards", kNumShards), cache, entries));
+  MessageLoop::current()->RunAllPending();
+  delete cache;
+}
+
+// Compares the memory-only backend keeping its data on the heap with the one
+// keeping it in memory mappings. The cache only holds a few hundred entries,
+// so most writes evict older entries.
+TEST_F(DiskCacheTest, MemoryBackendPerformance) {
+  const int kNumEntries = 10000;
+  const int kNumEntriesToRead = 100;
+
+  int seed = static_cast<int>(Time::Now().ToInternalValue());
+  for (int mapped = 0; mapped < 2; mapped++) {
+    srand(seed);
+    scoped_ptr<disk_cache::MemBackendImpl> cache(
+        new disk_cache::MemBackendImpl(NULL));
+    cache->SetUseMappedMemory(mapped != 0);
+    ASSERT_TRUE(cache->SetMaxSize(2 * 1024 * 1024));
+    ASSERT_TRUE(cache->Init());
+
+    PerfTimeLogger timer(mapped ? "Memory cache with mapped memory" :
+                                  "Memory cache with heap memory");
+    TestEntries entries;
+    EXPECT_TRUE(TimeWrite(kNumEntries, cache.get(), &entries));
+
+    // Read the newest entries, which have not been evicted.
+    TestEntries newest(entries.end() - kNumEntriesToRead, entries.end());
+    EXPECT_TRUE(TimeRead(kNumEntriesToRead, cache.get(), newest, false));
+    timer.Done();
+
+    LogPerfResult(mapped ? "Memory cache with mapped memory reserved" :
+                           "Memory cache with heap memory reserved",
+                  cache->allocator()->reserved_bytes() / 1024.0, "KB");
+  }
+}
+
 // Creating and deleting "entries" on a block-file is something quite frequent
 // (after all, almost everything is stored on block files). The operation is
 // almost free when the file is empty, but can be expensive if the file gets
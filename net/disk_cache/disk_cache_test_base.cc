@@ -55,6 +55,7 @@ DiskCacheTestWithCache::DiskCacheTestWithCache()
       implementation_(false),
       force_creation_(false),
       new_eviction_(false),
+      frequency_eviction_(false),
       first_cleanup_(true),
       integrity_(true),
       use_current_thread_(false),
@@ -289,7 +290,9 @@ void DiskCacheTestWithCache::InitDiskCacheImpl() {
   if (size_)
     EXPECT_TRUE(cache_impl_->SetMaxSize(size_));
 
-  if (new_eviction_)
+  if (frequency_eviction_)
+    cache_impl_->SetFrequencyEviction();
+  else if (new_eviction_)
     cache_impl_->SetNewEviction();
 
   cache_impl_->SetType(type_);
@@ -14,6 +14,12 @@
 // a CacheAddr value. Linking for a given hash bucket is handled internally
 // by the cache entry.
 //
+// A sharded cache (see sharded_backend_impl.h) splits the keys between a
+// number of independent sets of files, one per sub-folder, each with its own
+// index. The index header of each set records the number of shards and the
+// shard that it stores; both fields are zero for a cache that is not sharded,
+// so that the format (and kCurrentVersion) is unchanged for regular caches.
+//
 // The last element of the cache is the block-file. A block file is a file
 // designed to store blocks of data of a given size. It is able to store data
 // that spans from one to four consecutive "blocks", and it grows as needed to
@@ -93,7 +99,9 @@ struct NET_EXPORT_PRIVATE IndexHeader {
   int32       crash;         // Signals a previous crash.
   int32       experiment;    // Id of an ongoing test.
   uint64      create_time;   // Creation time for this set of files.
-  int32       pad[52];
+  int32       num_shards;    // Shards of a sharded cache (0 == not sharded).
+  int32       shard;         // The shard stored by this set of files.
+  int32       pad[50];
   LruData     lru;           // Eviction control data.
 };
 
@@ -26,6 +26,16 @@
 // size so that we have a chance to see an element again and move it to another
 // list.
 
+// The frequency-aware variant of the new eviction (enabled by the
+// EXPERIMENT_FREQUENCY_EVICTION group) keeps an in-memory estimate of how often
+// each key was used recently, including entries that were already evicted, and
+// takes the size of the entries into account: when an entry reaches the end of
+// its list but its recent uses make up for its size (kBytesPerUse bytes per
+// use), it is moved back to the head of the list and the next entry is evicted
+// instead. This keeps small, popular resources around when the cache also
+// holds huge objects that are used only once or twice. The estimate is not
+// stored on disk, so it starts from scratch when the cache is restarted.
+
 #include "net/disk_cache/eviction.h"
 
 #include "base/bind.h"
@@ -50,6 +60,13 @@ const int kHighUse = 10;  // Reuse count to be on the HIGH_USE list.
 const int kTargetTime = 24 * 7;  // Time to be evicted (hours since last use).
 const int kMaxDelayedTrims = 60;
 
+// Frequency-aware eviction: an entry needs at least kMinSpareFrequency recent
+// uses, and one use for every kBytesPerUse bytes, to avoid being evicted.
+// Up to kMaxSparedEntries entries are skipped per trim.
+const int kMinSpareFrequency = 2;
+const int kBytesPerUse = 64 * 1024;
+const int kMaxSparedEntries = 20;
+
 int LowWaterAdjust(int high_water) {
   if (high_water < kCleanUpMargin)
     return 0;
@@ -80,7 +97,12 @@ void Eviction::Init(BackendImpl* backend) {
   header_ = &backend_->data_->header;
   max_size_ = LowWaterAdjust(backend_->max_size_);
   index_size_ = backend->mask_ + 1;
+  spared_entries_ = 0;
   new_eviction_ = backend->new_eviction_;
+  frequency_eviction_ = new_eviction_ &&
+      header_->experiment == EXPERIMENT_FREQUENCY_EVICTION;
+  if (frequency_eviction_)
+    sketch_.Init(index_size_);
   first_trim_ = true;
   trimming_ = false;
   delay_trim_ = false;
@@ -278,6 +300,11 @@ bool Eviction::EvictEntry(CacheRankingsBlock* node, bool empty,
     return false;
   }
 
+  if (!empty && frequency_eviction_ && SpareEntry(entry, list)) {
+    entry->Release();
+    return false;
+  }
+
   ReportTrimTimes(entry);
   if (empty || !new_eviction_) {
     entry->DoomImpl();
@@ -304,6 +331,7 @@ bool Eviction::EvictEntry(CacheRankingsBlock* node, bool empty,
 void Eviction::TrimCacheV2(bool empty) {
   Trace("*** Trim Cache ***");
   trimming_ = true;
+  spared_entries_ = 0;
   TimeTicks start = TimeTicks::Now();
 
   const int kListsToSearch = 3;
@@ -377,6 +405,8 @@ void Eviction::TrimCacheV2(bool empty) {
     CACHE_UMA(AGE_MS, "TotalTrimTimeV2", 0, start);
   }
   CACHE_UMA(COUNTS, "TrimItemsV2", 0, deleted_entries);
+  if (frequency_eviction_)
+    CACHE_UMA(COUNTS, "SparedItems", 0, spared_entries_);
 
   Trace("*** Trim Cache end ***");
   trimming_ = false;
@@ -391,6 +421,9 @@ void Eviction::OnOpenEntryV2(EntryImpl* entry) {
   EntryStore* info = entry->entry()->Data();
   DCHECK_EQ(ENTRY_NORMAL, info->state);
 
+  if (frequency_eviction_)
+    sketch_.Increment(info->hash);
+
   if (info->reuse_count < kint32max) {
     info->reuse_count++;
     entry->entry()->set_modified();
@@ -410,6 +443,9 @@ void Eviction::OnOpenEntryV2(EntryImpl* entry) {
 
 void Eviction::OnCreateEntryV2(EntryImpl* entry) {
   EntryStore* info = entry->entry()->Data();
+  if (frequency_eviction_)
+    sketch_.Increment(info->hash);
+
   switch (info->state) {
     case ENTRY_NORMAL: {
       DCHECK(!info->reuse_count);
@@ -523,6 +559,27 @@ bool Eviction::RemoveDeletedNode(CacheRankingsBlock* node) {
   return !doomed;
 }
 
+bool Eviction::SpareEntry(EntryImpl* entry, Rankings::List list) {
+  if (spared_entries_ >= kMaxSparedEntries)
+    return false;
+
+  EntryStore* info = entry->entry()->Data();
+  int frequency = sketch_.Estimate(info->hash);
+  if (frequency < kMinSpareFrequency)
+    return false;
+
+  int64 size = 0;
+  for (size_t i = 0; i < arraysize(info->data_size); i++)
+    size += info->data_size[i];
+  if (size > static_cast<int64>(frequency) * kBytesPerUse)
+    return false;
+
+  Trace("Spare entry 0x%x", entry->entry()->address().value());
+  rankings_->UpdateRank(entry->rankings(), false, list);
+  spared_entries_++;
+  return true;
+}
+
 bool Eviction::NodeIsOldEnough(CacheRankingsBlock* node, int list) {
   if (!node)
     return false;
@@ -8,6 +8,7 @@
 #include "base/basictypes.h"
 #include "base/memory/weak_ptr.h"
 #include "net/disk_cache/disk_format.h"
+#include "net/disk_cache/frequency_sketch.h"
 #include "net/disk_cache/rankings.h"
 
 namespace disk_cache {
@@ -65,6 +66,12 @@ class Eviction {
   void TrimDeleted(bool empty);
   bool RemoveDeletedNode(CacheRankingsBlock* node);
 
+  // Size and frequency aware eviction (EXPERIMENT_FREQUENCY_EVICTION). Returns
+  // true if |entry| is used often enough for its size to be given another pass
+  // on |list| instead of being evicted, in which case it is moved to the head of
+  // the list.
+  bool SpareEntry(EntryImpl* entry, Rankings::List list);
+
   bool NodeIsOldEnough(CacheRankingsBlock* node, int list);
   int SelectListByLength(Rankings::ScopedRankingsBlock* next);
   void ReportListStats();
@@ -75,12 +82,15 @@ class Eviction {
   int max_size_;
   int trim_delays_;
   int index_size_;
+  int spared_entries_;  // Entries given another pass by the current trim.
   bool new_eviction_;
+  bool frequency_eviction_;
   bool first_trim_;
   bool trimming_;
   bool delay_trim_;
   bool init_;
   bool test_mode_;
+  FrequencySketch sketch_;  // Recent uses of the entries, by key hash.
   base::WeakPtrFactory<Eviction> ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Eviction);
@@ -17,7 +17,8 @@ enum {
   EXPERIMENT_DELETED_LIST_OUT = 11,
   EXPERIMENT_DELETED_LIST_CONTROL = 12,
   EXPERIMENT_DELETED_LIST_IN = 13,
-  EXPERIMENT_DELETED_LIST_OUT2 = 14
+  EXPERIMENT_DELETED_LIST_OUT2 = 14,
+  EXPERIMENT_FREQUENCY_EVICTION = 15  // Size and frequency aware eviction.
 };
 
 }  // namespace disk_cache
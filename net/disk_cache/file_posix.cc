@@ -7,8 +7,10 @@
 #include <fcntl.h>
 
 #include "base/bind.h"
+#include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/threading/thread_local.h"
 #include "base/threading/worker_pool.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/disk_cache.h"
@@ -146,22 +148,27 @@ void FileInFlightIO::OnOperationComplete(disk_cache::BackgroundIO* operation,
   callback->OnFileIOComplete(bytes);
 }
 
-// A static object tha will broker all async operations.
-FileInFlightIO* s_file_operations = NULL;
+// An object per thread that will broker all async operations started on that
+// thread, so that the completions are delivered to the thread that started
+// them when there is more than one cache thread (see ShardedBackendImpl).
+base::LazyInstance<base::ThreadLocalPointer<FileInFlightIO> >
+    s_file_operations = LAZY_INSTANCE_INITIALIZER;
 
 // Returns the current FileInFlightIO.
 FileInFlightIO* GetFileInFlightIO() {
-  if (!s_file_operations) {
-    s_file_operations = new FileInFlightIO;
+  FileInFlightIO* file_operations = s_file_operations.Pointer()->Get();
+  if (!file_operations) {
+    file_operations = new FileInFlightIO;
+    s_file_operations.Pointer()->Set(file_operations);
   }
-  return s_file_operations;
+  return file_operations;
 }
 
 // Deletes the current FileInFlightIO.
 void DeleteFileInFlightIO() {
-  DCHECK(s_file_operations);
-  delete s_file_operations;
-  s_file_operations = NULL;
+  DCHECK(s_file_operations.Pointer()->Get());
+  delete s_file_operations.Pointer()->Get();
+  s_file_operations.Pointer()->Set(NULL);
 }
 
 }  // namespace
@@ -0,0 +1,89 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/frequency_sketch.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace {
+
+const int kMinWidth = 64;
+
+// The counters are halved after this many uses per counter on a row.
+const int kSampleFactor = 10;
+
+// Odd multipliers used to derive a different hash for each row.
+const uint32 kSeeds[] = { 0x9E3779B1, 0x85EBCA77, 0xC2B2AE3D, 0x27D4EB2F };
+
+}  // namespace
+
+namespace disk_cache {
+
+const int FrequencySketch::kMaxFrequency;
+
+FrequencySketch::FrequencySketch()
+    : width_(0),
+      additions_(0),
+      sample_size_(0) {
+  COMPILE_ASSERT(arraysize(kSeeds) == kNumHashes, bad_number_of_seeds);
+}
+
+FrequencySketch::~FrequencySketch() {
+}
+
+void FrequencySketch::Init(int num_keys) {
+  // Use a power of two, so that a mask selects the counter.
+  width_ = kMinWidth;
+  while (width_ < num_keys && width_ < (1 << 24))
+    width_ <<= 1;
+
+  table_.assign(width_ * kNumHashes, 0);
+  additions_ = 0;
+  sample_size_ = width_ * kSampleFactor;
+}
+
+void FrequencySketch::Increment(uint32 hash) {
+  if (table_.empty())
+    return;
+
+  bool added = false;
+  for (int row = 0; row < kNumHashes; row++) {
+    uint8* counter = &table_[GetIndex(hash, row)];
+    if (*counter < kMaxFrequency) {
+      (*counter)++;
+      added = true;
+    }
+  }
+
+  if (added && ++additions_ >= sample_size_)
+    Age();
+}
+
+int FrequencySketch::Estimate(uint32 hash) const {
+  if (table_.empty())
+    return 0;
+
+  int frequency = kMaxFrequency;
+  for (int row = 0; row < kNumHashes; row++) {
+    int counter = table_[GetIndex(hash, row)];
+    frequency = std::min(frequency, counter);
+  }
+  return frequency;
+}
+
+int FrequencySketch::GetIndex(uint32 hash, int row) const {
+  uint32 value = hash * kSeeds[row];
+  value ^= value >> 16;
+  return row * width_ + static_cast<int>(value & (width_ - 1));
+}
+
+void FrequencySketch::Age() {
+  for (size_t i = 0; i < table_.size(); i++)
+    table_[i] >>= 1;
+  additions_ /= 2;
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,60 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_FREQUENCY_SKETCH_H_
+#define NET_DISK_CACHE_FREQUENCY_SKETCH_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// This class estimates how often a key was used recently, using a small table
+// of saturating counters indexed by a few hashes of the key (a count-min
+// sketch). The estimate is never lower than the real count, and can be higher
+// when other keys collide on all the counters. When the table has seen enough
+// uses, all the counters are halved, so that keys that were popular a long time
+// ago are eventually forgotten.
+class NET_EXPORT_PRIVATE FrequencySketch {
+ public:
+  static const int kMaxFrequency = 15;
+
+  FrequencySketch();
+  ~FrequencySketch();
+
+  // Sizes the table to track about |num_keys| keys, and forgets everything
+  // recorded so far.
+  void Init(int num_keys);
+
+  // Records one use of the key with the given |hash|.
+  void Increment(uint32 hash);
+
+  // Returns the estimated number of recent uses of the key with |hash|, from 0
+  // to kMaxFrequency.
+  int Estimate(uint32 hash) const;
+
+ private:
+  enum {
+    kNumHashes = 4
+  };
+
+  // Returns the index of the counter for |hash| on the given |row|.
+  int GetIndex(uint32 hash, int row) const;
+
+  // Halves all the counters.
+  void Age();
+
+  std::vector<uint8> table_;  // kNumHashes rows of |width_| counters.
+  int width_;
+  int additions_;
+  int sample_size_;  // Number of additions between calls to Age().
+
+  DISALLOW_COPY_AND_ASSIGN(FrequencySketch);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_FREQUENCY_SKETCH_H_
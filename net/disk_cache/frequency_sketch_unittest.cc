@@ -0,0 +1,41 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/frequency_sketch.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using disk_cache::FrequencySketch;
+
+TEST(FrequencySketchTest, Counts) {
+  FrequencySketch sketch;
+  EXPECT_EQ(0, sketch.Estimate(1234));
+  sketch.Increment(1234);
+  EXPECT_EQ(0, sketch.Estimate(1234));
+
+  sketch.Init(1000);
+  for (int i = 0; i < 3; i++)
+    sketch.Increment(1234);
+  sketch.Increment(5678);
+  EXPECT_EQ(3, sketch.Estimate(1234));
+  EXPECT_EQ(1, sketch.Estimate(5678));
+  EXPECT_EQ(0, sketch.Estimate(9999));
+
+  for (int i = 0; i < 2 * FrequencySketch::kMaxFrequency; i++)
+    sketch.Increment(1234);
+  EXPECT_EQ(FrequencySketch::kMaxFrequency, sketch.Estimate(1234));
+}
+
+TEST(FrequencySketchTest, Aging) {
+  FrequencySketch sketch;
+  sketch.Init(64);
+  for (int i = 0; i < 8; i++)
+    sketch.Increment(42);
+  EXPECT_EQ(8, sketch.Estimate(42));
+
+  // Enough uses of other keys halve the old counts, even with collisions.
+  for (uint32 i = 0; i < 64 * 10; i++)
+    sketch.Increment(i * 7919 + 100000);
+  EXPECT_LT(sketch.Estimate(42), 8);
+}
@@ -87,6 +87,11 @@ bool MemBackendImpl::SetMaxSize(int max_bytes) {
   return true;
 }
 
+void MemBackendImpl::SetUseMappedMemory(bool use_mapped_memory) {
+  DCHECK(entries_.empty());
+  allocator_.SetUseMappedMemory(use_mapped_memory);
+}
+
 void MemBackendImpl::InternalDoomEntry(MemEntryImpl* entry) {
   // Only parent entries can be passed into this method.
   DCHECK(entry->type() == MemEntryImpl::kParentEntry);
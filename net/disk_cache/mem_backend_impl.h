@@ -11,6 +11,7 @@
 #include "base/hash_tables.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/mem_rankings.h"
+#include "net/disk_cache/mem_slab_allocator.h"
 
 namespace net {
 class NetLog;
@@ -40,6 +41,14 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // Sets the maximum size for the total amount of data stored by this instance.
   bool SetMaxSize(int max_bytes);
 
+  // Stores the data of the entries in anonymous memory mappings instead of the
+  // heap, so that the memory of evicted entries goes back to the system. Must
+  // be called before any entry is created.
+  void SetUseMappedMemory(bool use_mapped_memory);
+
+  // Returns the allocator for the data of the entries.
+  MemSlabAllocator* allocator() { return &allocator_; }
+
   // Permanently deletes an entry.
   void InternalDoomEntry(MemEntryImpl* entry);
 
@@ -105,6 +114,7 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   void AddStorageSize(int32 bytes);
   void SubstractStorageSize(int32 bytes);
 
+  MemSlabAllocator allocator_;  // Holds the data of the entries.
   EntryMap entries_;
   MemRankings rankings_;  // Rankings to be able to trim the cache.
   int32 max_size_;        // Maximum data size for this instance.
@@ -4,6 +4,8 @@
 
 #include "net/disk_cache/mem_entry_impl.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/stringprintf.h"
@@ -67,8 +69,11 @@ MemEntryImpl::MemEntryImpl(MemBackendImpl* backend) {
   child_first_pos_ = 0;
   next_ = NULL;
   prev_ = NULL;
-  for (int i = 0; i < NUM_STREAMS; i++)
+  for (int i = 0; i < NUM_STREAMS; i++) {
+    data_[i] = NULL;
+    data_capacity_[i] = 0;
     data_size_[i] = 0;
+  }
 }
 
 // ------------------------------------------------------------------------
@@ -272,8 +277,10 @@ int MemEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
 // ------------------------------------------------------------------------
 
 MemEntryImpl::~MemEntryImpl() {
-  for (int i = 0; i < NUM_STREAMS; i++)
+  for (int i = 0; i < NUM_STREAMS; i++) {
     backend_->ModifyStorageSize(data_size_[i], 0);
+    backend_->allocator()->Free(data_[i], data_capacity_[i]);
+  }
   backend_->ModifyStorageSize(static_cast<int32>(key_.size()), 0);
   net_log_.EndEvent(net::NetLog::TYPE_DISK_CACHE_MEM_ENTRY_IMPL);
 }
@@ -297,7 +304,7 @@ int MemEntryImpl::InternalReadData(int index, int offset, IOBuffer* buf,
 
   UpdateRank(false);
 
-  memcpy(buf->data(), &(data_[index])[offset], buf_len);
+  memcpy(buf->data(), data_[index] + offset, buf_len);
   return buf_len;
 }
 
@@ -322,7 +329,8 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
   // Read the size at this point.
   int entry_size = GetDataSize(index);
 
-  PrepareTarget(index, offset, buf_len);
+  if (!PrepareTarget(index, offset, buf_len))
+    return net::ERR_OUT_OF_MEMORY;
 
   if (entry_size < offset + buf_len) {
     backend_->ModifyStorageSize(entry_size, offset + buf_len);
@@ -331,6 +339,7 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
     if (entry_size > offset + buf_len) {
       backend_->ModifyStorageSize(entry_size, offset + buf_len);
       data_size_[index] = offset + buf_len;
+      ShrinkBuffer(index);
     }
   }
 
@@ -339,7 +348,7 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
   if (!buf_len)
     return 0;
 
-  memcpy(&(data_[index])[offset], buf->data(), buf_len);
+  memcpy(data_[index] + offset, buf->data(), buf_len);
   return buf_len;
 }
 
@@ -510,21 +519,58 @@ int MemEntryImpl::GetAvailableRange(int64 offset, int len, int64* start) {
   return 0;
 }
 
-void MemEntryImpl::PrepareTarget(int index, int offset, int buf_len) {
+bool MemEntryImpl::PrepareTarget(int index, int offset, int buf_len) {
   int entry_size = GetDataSize(index);
 
   if (entry_size >= offset + buf_len)
-    return;  // Not growing the stored data.
-
-  if (static_cast<int>(data_[index].size()) < offset + buf_len)
-    data_[index].resize(offset + buf_len);
+    return true;  // Not growing the stored data.
+
+  if (data_capacity_[index] < offset + buf_len) {
+    // Grow geometrically, so that appending to a stream copies its data a
+    // logarithmic number of times.
+    int size = std::max(offset + buf_len,
+                        std::min(data_capacity_[index] * 2,
+                                 backend_->MaxFileSize()));
+    if (!ResizeBuffer(index, size))
+      return false;
+  }
 
   if (offset <= entry_size)
-    return;  // There is no "hole" on the stored data.
+    return true;  // There is no "hole" on the stored data.
 
   // Cleanup the hole not written by the user. The point is to avoid returning
   // random stuff later on.
-  memset(&(data_[index])[entry_size], 0, offset - entry_size);
+  memset(data_[index] + entry_size, 0, offset - entry_size);
+  return true;
+}
+
+bool MemEntryImpl::ResizeBuffer(int index, int size) {
+  DCHECK_GE(size, data_size_[index]);
+  MemSlabAllocator* allocator = backend_->allocator();
+  int capacity = 0;
+  char* buffer = NULL;
+  if (size) {
+    buffer = allocator->Allocate(size, &capacity);
+    if (!buffer)
+      return false;
+    if (data_size_[index])
+      memcpy(buffer, data_[index], data_size_[index]);
+  }
+  allocator->Free(data_[index], data_capacity_[index]);
+  data_[index] = buffer;
+  data_capacity_[index] = capacity;
+  return true;
+}
+
+void MemEntryImpl::ShrinkBuffer(int index) {
+  if (data_size_[index] > data_capacity_[index] / 4)
+    return;
+  if (data_size_[index] &&
+      data_capacity_[index] <= MemSlabAllocator::kMinBlockSize) {
+    return;
+  }
+  // Keep the current buffer if a smaller one cannot be allocated.
+  ResizeBuffer(index, data_size_[index]);
 }
 
 void MemEntryImpl::UpdateRank(bool modified) {
@@ -132,8 +132,17 @@ class MemEntryImpl : public Entry {
   // Old Entry interface.
   int GetAvailableRange(int64 offset, int len, int64* start);
 
-  // Grows and cleans up the data buffer.
-  void PrepareTarget(int index, int offset, int buf_len);
+  // Grows and cleans up the data buffer. Returns false if the buffer cannot
+  // grow.
+  bool PrepareTarget(int index, int offset, int buf_len);
+
+  // Moves the data of stream |index| to a buffer of at least |size| bytes,
+  // which must not be smaller than the data.
+  bool ResizeBuffer(int index, int size);
+
+  // Gives back the buffer of stream |index| if it is mostly unused after the
+  // data was truncated.
+  void ShrinkBuffer(int index);
 
   // Updates ranking information.
   void UpdateRank(bool modified);
@@ -162,7 +171,8 @@ class MemEntryImpl : public Entry {
   void DetachChild(int child_id);
 
   std::string key_;
-  std::vector<char> data_[NUM_STREAMS];  // User data.
+  char* data_[NUM_STREAMS];  // User data, from the backend's allocator.
+  int32 data_capacity_[NUM_STREAMS];
   int32 data_size_[NUM_STREAMS];
   int ref_count_;
 
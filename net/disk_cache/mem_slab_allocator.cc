@@ -0,0 +1,195 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/mem_slab_allocator.h"
+
+#include "base/logging.h"
+
+namespace {
+
+// Big buffers and the pages given back to the system are multiples of this.
+const int kPageSize = 4096;
+
+int RoundUpToPageSize(int size) {
+  return (size + kPageSize - 1) & ~(kPageSize - 1);
+}
+
+}  // namespace
+
+namespace disk_cache {
+
+const int MemSlabAllocator::kMinBlockSize;
+const int MemSlabAllocator::kMaxBlockSize;
+const int MemSlabAllocator::kSlabSize;
+
+struct MemSlabAllocator::Slab {
+  char* memory;
+  int size_class;
+  int block_size;
+  int num_blocks;
+  int used_blocks;
+  // Blocks from this one on have never been used.
+  int first_unused_block;
+  // The freed blocks, each one storing the address of the next one.
+  char* free_list;
+};
+
+MemSlabAllocator::MemSlabAllocator()
+    : use_mapped_memory_(false),
+      reserved_bytes_(0) {
+  for (int i = 0; i < kNumSizeClasses; i++)
+    empty_slabs_[i] = NULL;
+}
+
+MemSlabAllocator::~MemSlabAllocator() {
+  // All the buffers should be freed by now, but the slabs are released anyway.
+  while (!slabs_.empty())
+    DeleteSlab(slabs_.begin()->second);
+  DCHECK(!reserved_bytes_);
+}
+
+void MemSlabAllocator::SetUseMappedMemory(bool use_mapped_memory) {
+  DCHECK(!reserved_bytes_);
+  use_mapped_memory_ = use_mapped_memory;
+}
+
+char* MemSlabAllocator::Allocate(int size, int* capacity) {
+  DCHECK_GT(size, 0);
+  int size_class = GetSizeClass(size);
+  if (size_class < 0) {
+    *capacity = RoundUpToPageSize(size);
+    return AllocateMemory(*capacity);
+  }
+
+  *capacity = kMinBlockSize << size_class;
+  return AllocateBlock(size_class);
+}
+
+void MemSlabAllocator::Free(char* buffer, int capacity) {
+  if (!buffer)
+    return;
+
+  int size_class = GetSizeClass(capacity);
+  if (size_class < 0) {
+    FreeMemory(buffer, capacity);
+    return;
+  }
+  DCHECK_EQ(kMinBlockSize << size_class, capacity);
+  FreeBlock(buffer, size_class);
+}
+
+// static
+int MemSlabAllocator::GetSizeClass(int size) {
+  if (size > kMaxBlockSize)
+    return -1;
+
+  int size_class = 0;
+  while ((kMinBlockSize << size_class) < size)
+    size_class++;
+  return size_class;
+}
+
+char* MemSlabAllocator::AllocateBlock(int size_class) {
+  Slab* slab;
+  if (!partial_slabs_[size_class].empty()) {
+    // Use the slab with the lowest address, so that the buffers are packed
+    // into as few slabs as possible.
+    slab = *partial_slabs_[size_class].begin();
+  } else if (empty_slabs_[size_class]) {
+    slab = empty_slabs_[size_class];
+    empty_slabs_[size_class] = NULL;
+    partial_slabs_[size_class].insert(slab);
+  } else {
+    slab = CreateSlab(size_class);
+    if (!slab)
+      return NULL;
+    partial_slabs_[size_class].insert(slab);
+  }
+
+  char* block;
+  if (slab->free_list) {
+    block = slab->free_list;
+    slab->free_list = *reinterpret_cast<char**>(block);
+  } else {
+    DCHECK_LT(slab->first_unused_block, slab->num_blocks);
+    block = slab->memory + slab->first_unused_block * slab->block_size;
+    slab->first_unused_block++;
+  }
+
+  slab->used_blocks++;
+  if (slab->used_blocks == slab->num_blocks)
+    partial_slabs_[size_class].erase(slab);
+  return block;
+}
+
+void MemSlabAllocator::FreeBlock(char* block, int size_class) {
+  SlabMap::iterator it = slabs_.upper_bound(block);
+  DCHECK(it != slabs_.begin());
+  --it;
+  Slab* slab = it->second;
+  DCHECK_EQ(size_class, slab->size_class);
+  DCHECK_LT(block, slab->memory + kSlabSize);
+
+  // The pages of big blocks can be given back to the system right away. The
+  // first page is kept, since it holds the link of the free list.
+  if (use_mapped_memory_ && slab->block_size > kPageSize)
+    DiscardMemory(block + kPageSize, slab->block_size - kPageSize);
+
+  *reinterpret_cast<char**>(block) = slab->free_list;
+  slab->free_list = block;
+
+  if (slab->used_blocks == slab->num_blocks)
+    partial_slabs_[size_class].insert(slab);
+  slab->used_blocks--;
+  if (slab->used_blocks)
+    return;
+
+  partial_slabs_[size_class].erase(slab);
+  if (empty_slabs_[size_class])
+    DeleteSlab(empty_slabs_[size_class]);
+  empty_slabs_[size_class] = slab;
+}
+
+MemSlabAllocator::Slab* MemSlabAllocator::CreateSlab(int size_class) {
+  char* memory = AllocateMemory(kSlabSize);
+  if (!memory)
+    return NULL;
+
+  Slab* slab = new Slab;
+  slab->memory = memory;
+  slab->size_class = size_class;
+  slab->block_size = kMinBlockSize << size_class;
+  slab->num_blocks = kSlabSize / slab->block_size;
+  slab->used_blocks = 0;
+  slab->first_unused_block = 0;
+  slab->free_list = NULL;
+  slabs_[memory] = slab;
+  return slab;
+}
+
+void MemSlabAllocator::DeleteSlab(Slab* slab) {
+  partial_slabs_[slab->size_class].erase(slab);
+  if (empty_slabs_[slab->size_class] == slab)
+    empty_slabs_[slab->size_class] = NULL;
+  slabs_.erase(slab->memory);
+  FreeMemory(slab->memory, kSlabSize);
+  delete slab;
+}
+
+char* MemSlabAllocator::AllocateMemory(size_t size) {
+  char* memory = use_mapped_memory_ ? MapMemory(size) : new char[size];
+  if (memory)
+    reserved_bytes_ += size;
+  return memory;
+}
+
+void MemSlabAllocator::FreeMemory(char* memory, size_t size) {
+  reserved_bytes_ -= size;
+  if (use_mapped_memory_)
+    UnmapMemory(memory, size);
+  else
+    delete[] memory;
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,91 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_MEM_SLAB_ALLOCATOR_H_
+#define NET_DISK_CACHE_MEM_SLAB_ALLOCATOR_H_
+
+#include <map>
+#include <set>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// This class allocates the buffers that hold the data of the memory-only
+// cache. Buffers of up to kMaxBlockSize bytes are rounded up to a power of two
+// and carved out of slabs that only hold buffers of that size, so entries of
+// similar size share memory instead of fragmenting the heap. Bigger buffers
+// get an allocation of their own.
+//
+// With mapped memory, slabs and big buffers come from anonymous memory
+// mappings, and the pages of freed buffers are given back to the system as
+// soon as evicted entries release them. Otherwise the memory comes from the
+// heap.
+class NET_EXPORT_PRIVATE MemSlabAllocator {
+ public:
+  static const int kMinBlockSize = 256;
+  static const int kMaxBlockSize = 64 * 1024;
+  static const int kSlabSize = 256 * 1024;
+
+  MemSlabAllocator();
+  ~MemSlabAllocator();
+
+  // Selects where the memory comes from. This can only be changed while
+  // nothing is allocated.
+  void SetUseMappedMemory(bool use_mapped_memory);
+  bool use_mapped_memory() const { return use_mapped_memory_; }
+
+  // Returns a buffer of at least |size| bytes, or NULL if the memory is not
+  // available. |capacity| is set to the usable size of the buffer.
+  char* Allocate(int size, int* capacity);
+
+  // Releases a |buffer| returned by Allocate() with the given |capacity|.
+  void Free(char* buffer, int capacity);
+
+  // Returns the number of bytes currently obtained from the system.
+  int64 reserved_bytes() const { return reserved_bytes_; }
+
+ private:
+  struct Slab;
+  typedef std::map<char*, Slab*> SlabMap;  // Indexed by the first byte.
+  typedef std::set<Slab*> SlabSet;
+
+  enum {
+    kNumSizeClasses = 9  // From kMinBlockSize to kMaxBlockSize.
+  };
+
+  // Returns the size class of buffers of |size| bytes, or -1 if they are
+  // bigger than kMaxBlockSize.
+  static int GetSizeClass(int size);
+
+  char* AllocateBlock(int size_class);
+  void FreeBlock(char* block, int size_class);
+  Slab* CreateSlab(int size_class);
+  void DeleteSlab(Slab* slab);
+
+  char* AllocateMemory(size_t size);
+  void FreeMemory(char* memory, size_t size);
+
+  // Platform specific: anonymous memory mappings, and returning the pages of
+  // part of a mapping to the system while keeping it mapped.
+  static char* MapMemory(size_t size);
+  static void UnmapMemory(char* memory, size_t size);
+  static void DiscardMemory(char* memory, size_t size);
+
+  bool use_mapped_memory_;
+  SlabMap slabs_;
+  // The slabs of each size class that have both used and free blocks.
+  SlabSet partial_slabs_[kNumSizeClasses];
+  // An unused slab kept for each size class, so that a buffer being freed and
+  // allocated again does not map and unmap a slab every time.
+  Slab* empty_slabs_[kNumSizeClasses];
+  int64 reserved_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemSlabAllocator);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_MEM_SLAB_ALLOCATOR_H_
@@ -0,0 +1,34 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/mem_slab_allocator.h"
+
+#include <sys/mman.h>
+
+#include "base/logging.h"
+
+namespace disk_cache {
+
+// static
+char* MemSlabAllocator::MapMemory(size_t size) {
+  void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED)
+    return NULL;
+  return static_cast<char*>(memory);
+}
+
+// static
+void MemSlabAllocator::UnmapMemory(char* memory, size_t size) {
+  int rv = munmap(memory, size);
+  DCHECK_EQ(0, rv);
+}
+
+// static
+void MemSlabAllocator::DiscardMemory(char* memory, size_t size) {
+  // The pages read as zeros the next time they are used.
+  madvise(memory, size, MADV_DONTNEED);
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,83 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/mem_slab_allocator.h"
+
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using disk_cache::MemSlabAllocator;
+
+TEST(MemSlabAllocatorTest, SizeClasses) {
+  MemSlabAllocator allocator;
+  int capacity = 0;
+
+  char* small = allocator.Allocate(1, &capacity);
+  ASSERT_TRUE(small != NULL);
+  EXPECT_EQ(MemSlabAllocator::kMinBlockSize, capacity);
+  allocator.Free(small, capacity);
+
+  char* medium = allocator.Allocate(1000, &capacity);
+  ASSERT_TRUE(medium != NULL);
+  EXPECT_EQ(1024, capacity);
+  allocator.Free(medium, capacity);
+
+  char* big = allocator.Allocate(MemSlabAllocator::kMaxBlockSize + 1,
+                                 &capacity);
+  ASSERT_TRUE(big != NULL);
+  EXPECT_EQ(MemSlabAllocator::kMaxBlockSize + 4096, capacity);
+  allocator.Free(big, capacity);
+}
+
+TEST(MemSlabAllocatorTest, ReusesFreedBlocks) {
+  MemSlabAllocator allocator;
+  int capacity = 0;
+  char* first = allocator.Allocate(300, &capacity);
+  char* second = allocator.Allocate(300, &capacity);
+  ASSERT_TRUE(first != NULL);
+  ASSERT_TRUE(second != NULL);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(MemSlabAllocator::kSlabSize, allocator.reserved_bytes());
+
+  allocator.Free(first, capacity);
+  EXPECT_EQ(first, allocator.Allocate(300, &capacity));
+  allocator.Free(first, capacity);
+  allocator.Free(second, capacity);
+}
+
+TEST(MemSlabAllocatorTest, ReleasesMemory) {
+  for (int mapped = 0; mapped < 2; mapped++) {
+    MemSlabAllocator allocator;
+    allocator.SetUseMappedMemory(mapped != 0);
+
+    // Fill three slabs with 64 KB blocks.
+    const int kNumBlocks =
+        3 * MemSlabAllocator::kSlabSize / MemSlabAllocator::kMaxBlockSize;
+    char* blocks[kNumBlocks];
+    int capacity = 0;
+    for (int i = 0; i < kNumBlocks; i++) {
+      blocks[i] = allocator.Allocate(MemSlabAllocator::kMaxBlockSize,
+                                     &capacity);
+      ASSERT_TRUE(blocks[i] != NULL);
+      memset(blocks[i], i, capacity);
+    }
+    EXPECT_EQ(3 * MemSlabAllocator::kSlabSize, allocator.reserved_bytes());
+
+    // One empty slab is kept, the other one is released.
+    for (int i = 0; i < kNumBlocks; i++) {
+      EXPECT_EQ(static_cast<char>(i), blocks[i][capacity - 1]);
+      allocator.Free(blocks[i], capacity);
+    }
+    EXPECT_EQ(MemSlabAllocator::kSlabSize, allocator.reserved_bytes());
+
+    // Big buffers are released right away.
+    char* big = allocator.Allocate(1024 * 1024, &capacity);
+    ASSERT_TRUE(big != NULL);
+    EXPECT_EQ(MemSlabAllocator::kSlabSize + 1024 * 1024,
+              allocator.reserved_bytes());
+    allocator.Free(big, capacity);
+    EXPECT_EQ(MemSlabAllocator::kSlabSize, allocator.reserved_bytes());
+  }
+}
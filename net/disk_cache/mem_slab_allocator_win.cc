@@ -0,0 +1,31 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/mem_slab_allocator.h"
+
+#include <windows.h>
+
+#include "base/logging.h"
+
+namespace disk_cache {
+
+// static
+char* MemSlabAllocator::MapMemory(size_t size) {
+  return static_cast<char*>(VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE,
+                                         PAGE_READWRITE));
+}
+
+// static
+void MemSlabAllocator::UnmapMemory(char* memory, size_t size) {
+  BOOL rv = VirtualFree(memory, 0, MEM_RELEASE);
+  DCHECK(rv);
+}
+
+// static
+void MemSlabAllocator::DiscardMemory(char* memory, size_t size) {
+  // The pages stay committed, but the system can drop their contents.
+  VirtualAlloc(memory, size, MEM_RESET, PAGE_READWRITE);
+}
+
+}  // namespace disk_cache
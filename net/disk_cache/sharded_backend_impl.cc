@@ -0,0 +1,364 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/sharded_backend_impl.h"
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/file_util.h"
+#include "base/hash.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop_proxy.h"
+#include "base/stl_util.h"
+#include "base/stringprintf.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/backend_impl.h"
+#include "net/disk_cache/cache_util.h"
+
+namespace {
+
+// Deletes the files of a regular cache stored on |path|, and the shards of a
+// sharded cache from |first_unused_shard| on. Both are left behind when the
+// number of shards changes.
+void DeleteUnusedFiles(const FilePath& path, int first_unused_shard) {
+  disk_cache::DeleteCache(path, false);
+  for (int i = first_unused_shard;; i++) {
+    FilePath shard_path =
+        disk_cache::ShardedBackendImpl::GetShardPath(path, i);
+    if (!file_util::PathExists(shard_path))
+      break;
+    disk_cache::DeleteCache(shard_path, true);
+  }
+}
+
+// Runs |callback| when an operation is done on every shard, with the first
+// error returned by a shard (or net::OK).
+class ShardedOperation : public base::RefCounted<ShardedOperation> {
+ public:
+  explicit ShardedOperation(const net::CompletionCallback& callback)
+      : callback_(callback),
+        pending_(1),
+        result_(net::OK) {
+  }
+
+  // Returns the callback to pass to the operation of a shard.
+  net::CompletionCallback GetShardCallback() {
+    pending_++;
+    return base::Bind(&ShardedOperation::OnShardComplete, this);
+  }
+
+  // Records |result|, returned by starting the operation on a shard.
+  void AddResult(int result) {
+    if (result == net::ERR_IO_PENDING)
+      return;
+    OnShardComplete(result);
+  }
+
+  // Returns the result of the whole operation, once it was started on every
+  // shard. |callback_| will be invoked if net::ERR_IO_PENDING is returned.
+  int Finish() {
+    DCHECK_GT(pending_, 0);
+    if (--pending_)
+      return net::ERR_IO_PENDING;
+    callback_.Reset();
+    return result_;
+  }
+
+ private:
+  friend class base::RefCounted<ShardedOperation>;
+  ~ShardedOperation() {}
+
+  void OnShardComplete(int result) {
+    if (result != net::OK && result_ == net::OK)
+      result_ = result;
+    DCHECK_GT(pending_, 0);
+    if (--pending_ || callback_.is_null())
+      return;
+    callback_.Run(result_);
+  }
+
+  net::CompletionCallback callback_;
+  int pending_;
+  int result_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedOperation);
+};
+
+// This class takes care of building all the shards of a sharded backend.
+class ShardedCacheCreator {
+ public:
+  ShardedCacheCreator(const FilePath& path, bool force, int max_bytes,
+                      net::CacheType type, uint32 flags,
+                      const disk_cache::ShardedBackendImpl::ThreadList& threads,
+                      net::NetLog* net_log, disk_cache::Backend** backend,
+                      const net::CompletionCallback& callback)
+      : path_(path),
+        force_(force),
+        max_bytes_(max_bytes),
+        type_(type),
+        flags_(flags),
+        threads_(threads),
+        net_log_(net_log),
+        backend_(backend),
+        callback_(callback),
+        pending_(0),
+        result_(net::OK) {
+  }
+  ~ShardedCacheCreator() {}
+
+  // Creates the backend.
+  int Run();
+
+ private:
+  // Callback implementation.
+  void OnShardCreated(int result);
+
+  const FilePath path_;
+  bool force_;
+  int max_bytes_;
+  net::CacheType type_;
+  uint32 flags_;
+  disk_cache::ShardedBackendImpl::ThreadList threads_;
+  net::NetLog* net_log_;
+  disk_cache::Backend** backend_;
+  net::CompletionCallback callback_;
+  // BackendImpl::CreateShard() keeps a reference to the path of the shard.
+  std::vector<FilePath> shard_paths_;
+  std::vector<disk_cache::Backend*> shards_;
+  int pending_;
+  int result_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedCacheCreator);
+};
+
+int ShardedCacheCreator::Run() {
+  int num_shards = static_cast<int>(threads_.size());
+  if (force_) {
+    // This runs before the first shard is created on the same thread, and
+    // doesn't touch the files of the shards that are in use.
+    threads_[0]->PostTask(FROM_HERE,
+                          base::Bind(&DeleteUnusedFiles, path_, num_shards));
+  }
+
+  for (int i = 0; i < num_shards; i++)
+    shard_paths_.push_back(
+        disk_cache::ShardedBackendImpl::GetShardPath(path_, i));
+  shards_.resize(num_shards);
+  pending_ = num_shards;
+
+  for (int i = 0; i < num_shards; i++) {
+    int rv = disk_cache::BackendImpl::CreateShard(
+        shard_paths_[i], force_, max_bytes_ / num_shards, type_, flags_, i,
+        num_shards, threads_[i], net_log_, &shards_[i],
+        base::Bind(&ShardedCacheCreator::OnShardCreated,
+                   base::Unretained(this)));
+    DCHECK_EQ(net::ERR_IO_PENDING, rv);
+  }
+  return net::ERR_IO_PENDING;
+}
+
+void ShardedCacheCreator::OnShardCreated(int result) {
+  DCHECK_NE(net::ERR_IO_PENDING, result);
+  if (result != net::OK && result_ == net::OK)
+    result_ = result;
+  if (--pending_)
+    return;
+
+  if (result_ == net::OK) {
+    *backend_ = new disk_cache::ShardedBackendImpl(type_, shards_);
+  } else {
+    LOG(ERROR) << "Unable to create sharded cache";
+    *backend_ = NULL;
+    STLDeleteElements(&shards_);
+  }
+  callback_.Run(result_);
+  delete this;
+}
+
+}  // namespace
+
+// ------------------------------------------------------------------------
+
+namespace disk_cache {
+
+// The position of an enumeration: the shard being enumerated, and the iterator
+// of that shard.
+struct ShardedBackendImpl::ShardIterator {
+  ShardIterator() : shard(0), shard_iter(NULL) {}
+
+  int shard;
+  void* shard_iter;
+};
+
+ShardedBackendImpl::ShardedBackendImpl(net::CacheType type,
+                                       const std::vector<Backend*>& shards)
+    : cache_type_(type),
+      shards_(shards),
+      ALLOW_THIS_IN_INITIALIZER_LIST(ptr_factory_(this)) {
+  DCHECK(!shards_.empty());
+}
+
+ShardedBackendImpl::~ShardedBackendImpl() {
+  // Each shard cancels its own pending operations.
+  STLDeleteElements(&shards_);
+}
+
+// Static.
+int ShardedBackendImpl::CreateBackend(const FilePath& full_path, bool force,
+                                      int max_bytes, net::CacheType type,
+                                      uint32 flags, const ThreadList& threads,
+                                      net::NetLog* net_log, Backend** backend,
+                                      const CompletionCallback& callback) {
+  DCHECK(!callback.is_null());
+  DCHECK(!threads.empty());
+  ShardedCacheCreator* creator =
+      new ShardedCacheCreator(full_path, force, max_bytes, type, flags,
+                              threads, net_log, backend, callback);
+  // This object will self-destroy when finished.
+  return creator->Run();
+}
+
+// Static.
+int ShardedBackendImpl::GetShardForKey(const std::string& key,
+                                       int num_shards) {
+  // Each shard looks up the low bits of the hash on its own index, so the
+  // shard is selected with the high bits.
+  uint64 hash = base::Hash(key);
+  return static_cast<int>((hash * num_shards) >> 32);
+}
+
+// Static.
+FilePath ShardedBackendImpl::GetShardPath(const FilePath& path, int shard) {
+  return path.AppendASCII(base::StringPrintf("shard_%d", shard));
+}
+
+net::CacheType ShardedBackendImpl::GetCacheType() const {
+  return cache_type_;
+}
+
+int32 ShardedBackendImpl::GetEntryCount() const {
+  int32 count = 0;
+  for (size_t i = 0; i < shards_.size(); i++)
+    count += shards_[i]->GetEntryCount();
+  return count;
+}
+
+int ShardedBackendImpl::OpenEntry(const std::string& key, Entry** entry,
+                                  const CompletionCallback& callback) {
+  return GetShard(key)->OpenEntry(key, entry, callback);
+}
+
+int ShardedBackendImpl::CreateEntry(const std::string& key, Entry** entry,
+                                    const CompletionCallback& callback) {
+  return GetShard(key)->CreateEntry(key, entry, callback);
+}
+
+int ShardedBackendImpl::DoomEntry(const std::string& key,
+                                  const CompletionCallback& callback) {
+  return GetShard(key)->DoomEntry(key, callback);
+}
+
+int ShardedBackendImpl::DoomAllEntries(const CompletionCallback& callback) {
+  scoped_refptr<ShardedOperation> operation(new ShardedOperation(callback));
+  for (size_t i = 0; i < shards_.size(); i++) {
+    operation->AddResult(
+        shards_[i]->DoomAllEntries(operation->GetShardCallback()));
+  }
+  return operation->Finish();
+}
+
+int ShardedBackendImpl::DoomEntriesBetween(const base::Time initial_time,
+                                           const base::Time end_time,
+                                           const CompletionCallback& callback) {
+  scoped_refptr<ShardedOperation> operation(new ShardedOperation(callback));
+  for (size_t i = 0; i < shards_.size(); i++) {
+    operation->AddResult(shards_[i]->DoomEntriesBetween(
+        initial_time, end_time, operation->GetShardCallback()));
+  }
+  return operation->Finish();
+}
+
+int ShardedBackendImpl::DoomEntriesSince(const base::Time initial_time,
+                                         const CompletionCallback& callback) {
+  scoped_refptr<ShardedOperation> operation(new ShardedOperation(callback));
+  for (size_t i = 0; i < shards_.size(); i++) {
+    operation->AddResult(shards_[i]->DoomEntriesSince(
+        initial_time, operation->GetShardCallback()));
+  }
+  return operation->Finish();
+}
+
+int ShardedBackendImpl::OpenNextEntry(void** iter, Entry** next_entry,
+                                      const CompletionCallback& callback) {
+  if (!*iter)
+    *iter = new ShardIterator;
+  return OpenNextEntryFromShards(iter, next_entry, callback);
+}
+
+void ShardedBackendImpl::EndEnumeration(void** iter) {
+  scoped_ptr<ShardIterator> iterator(reinterpret_cast<ShardIterator*>(*iter));
+  *iter = NULL;
+  if (iterator.get() && iterator->shard_iter)
+    shards_[iterator->shard]->EndEnumeration(&iterator->shard_iter);
+}
+
+void ShardedBackendImpl::GetStats(
+    std::vector<std::pair<std::string, std::string> >* stats) {
+  for (size_t i = 0; i < shards_.size(); i++) {
+    std::vector<std::pair<std::string, std::string> > shard_stats;
+    shards_[i]->GetStats(&shard_stats);
+    for (size_t j = 0; j < shard_stats.size(); j++) {
+      shard_stats[j].first = base::StringPrintf(
+          "Shard %d: %s", static_cast<int>(i), shard_stats[j].first.c_str());
+      stats->push_back(shard_stats[j]);
+    }
+  }
+}
+
+void ShardedBackendImpl::OnExternalCacheHit(const std::string& key) {
+  GetShard(key)->OnExternalCacheHit(key);
+}
+
+Backend* ShardedBackendImpl::GetShard(const std::string& key) {
+  return shards_[GetShardForKey(key, num_shards())];
+}
+
+int ShardedBackendImpl::OpenNextEntryFromShards(
+    void** iter, Entry** next_entry, const CompletionCallback& callback) {
+  ShardIterator* iterator = reinterpret_cast<ShardIterator*>(*iter);
+  while (iterator->shard < num_shards()) {
+    int rv = shards_[iterator->shard]->OpenNextEntry(
+        &iterator->shard_iter, next_entry,
+        base::Bind(&ShardedBackendImpl::OnOpenNextEntryComplete,
+                   ptr_factory_.GetWeakPtr(), iter, next_entry, callback));
+    if (rv == net::OK || rv == net::ERR_IO_PENDING)
+      return rv;
+
+    // The shard has no more entries, and it already released its iterator.
+    iterator->shard++;
+    iterator->shard_iter = NULL;
+  }
+
+  // Like the shards, release the iterator at the end of the enumeration.
+  delete iterator;
+  *iter = NULL;
+  return net::ERR_FAILED;
+}
+
+void ShardedBackendImpl::OnOpenNextEntryComplete(
+    void** iter, Entry** next_entry, const CompletionCallback& callback,
+    int result) {
+  if (result != net::OK) {
+    ShardIterator* iterator = reinterpret_cast<ShardIterator*>(*iter);
+    iterator->shard++;
+    iterator->shard_iter = NULL;
+    result = OpenNextEntryFromShards(iter, next_entry, callback);
+    if (result == net::ERR_IO_PENDING)
+      return;
+  }
+  callback.Run(result);
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,103 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// See net/disk_cache/disk_cache.h for the public interface of the cache.
+
+#ifndef NET_DISK_CACHE_SHARDED_BACKEND_IMPL_H_
+#define NET_DISK_CACHE_SHARDED_BACKEND_IMPL_H_
+
+#include <string>
+#include <vector>
+
+#include "base/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace base {
+class MessageLoopProxy;
+}
+
+namespace disk_cache {
+
+// This class implements the Backend interface by splitting the keys between a
+// number of shards. Each shard is a regular BackendImpl with its own index,
+// block files and sub-folder, that runs its operations on its own cache
+// thread. Operations on keys that go to different shards don't wait for each
+// other, so the cache is not limited by what a single cache thread can do.
+//
+// The eviction of each shard is independent, so the cache is trimmed when any
+// of the shards reaches its part of the maximum size.
+class NET_EXPORT_PRIVATE ShardedBackendImpl : public Backend {
+ public:
+  typedef std::vector<scoped_refptr<base::MessageLoopProxy> > ThreadList;
+
+  // Takes ownership of |shards|, which store the keys that GetShardForKey()
+  // assigns to them.
+  ShardedBackendImpl(net::CacheType type, const std::vector<Backend*>& shards);
+  virtual ~ShardedBackendImpl();
+
+  // Returns a new backend with one shard per element of |threads|, each one
+  // running its operations on that thread. The same thread can be used by
+  // more than one shard. See the declaration of CreateCacheBackend() for the
+  // other arguments; |max_bytes| is the size of the whole cache.
+  static int CreateBackend(const FilePath& full_path, bool force,
+                           int max_bytes, net::CacheType type,
+                           uint32 flags, const ThreadList& threads,
+                           net::NetLog* net_log, Backend** backend,
+                           const CompletionCallback& callback);
+
+  // Returns the shard that stores |key|, out of |num_shards|.
+  static int GetShardForKey(const std::string& key, int num_shards);
+
+  // Returns the folder that stores the files of |shard|, for the cache stored
+  // on |path|.
+  static FilePath GetShardPath(const FilePath& path, int shard);
+
+  int num_shards() const { return static_cast<int>(shards_.size()); }
+
+  // Backend interface.
+  virtual net::CacheType GetCacheType() const OVERRIDE;
+  virtual int32 GetEntryCount() const OVERRIDE;
+  virtual int OpenEntry(const std::string& key, Entry** entry,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int CreateEntry(const std::string& key, Entry** entry,
+                          const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntry(const std::string& key,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomAllEntries(const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesBetween(const base::Time initial_time,
+                                 const base::Time end_time,
+                                 const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesSince(const base::Time initial_time,
+                               const CompletionCallback& callback) OVERRIDE;
+  virtual int OpenNextEntry(void** iter, Entry** next_entry,
+                            const CompletionCallback& callback) OVERRIDE;
+  virtual void EndEnumeration(void** iter) OVERRIDE;
+  virtual void GetStats(
+      std::vector<std::pair<std::string, std::string> >* stats) OVERRIDE;
+  virtual void OnExternalCacheHit(const std::string& key) OVERRIDE;
+
+ private:
+  struct ShardIterator;
+
+  Backend* GetShard(const std::string& key);
+
+  // Returns the next entry of the enumeration |iter| (a ShardIterator),
+  // moving on to the next shard when the current one has no more entries.
+  int OpenNextEntryFromShards(void** iter, Entry** next_entry,
+                              const CompletionCallback& callback);
+  void OnOpenNextEntryComplete(void** iter, Entry** next_entry,
+                               const CompletionCallback& callback, int result);
+
+  net::CacheType cache_type_;
+  std::vector<Backend*> shards_;
+  base::WeakPtrFactory<ShardedBackendImpl> ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedBackendImpl);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_SHARDED_BACKEND_IMPL_H_
@@ -48,6 +48,9 @@ class Stats {
     LAST_REPORT,  // Time of the last time we sent a report.
     LAST_REPORT_TIMER,  // Timer count of the last time we sent a report.
     DOOM_RECENT,  // The cache was partially cleared.
+    COMPACTION_FILE,  // A block file was selected to be emptied.
+    COMPACTION_MOVE,  // A block was moved out of the compaction file.
+    COMPACTION_DONE,  // The compaction file was emptied and deleted.
     MAX_COUNTER
   };
 
@@ -190,6 +190,11 @@ unsigned DnsResponse::answer_count() const {
   return base::NetToHost16(header()->ancount);
 }
 
+unsigned DnsResponse::authority_count() const {
+  DCHECK(parser_.IsValid());
+  return base::NetToHost16(header()->nscount);
+}
+
 base::StringPiece DnsResponse::qname() const {
   DCHECK(parser_.IsValid());
   // The response is HEADER QNAME QTYPE QCLASS ANSWER.
@@ -279,7 +284,7 @@ DnsResponse::Result DnsResponse::ParseToAddressList(
     }
   }
 
-  // TODO(szym): Extract TTL for NODATA results. http://crbug.com/115051
+  // The TTL of NODATA results is extracted by ParseNegativeTTL().
 
   // getcanonname in eglibc returns the first owner name of an A or AAAA RR.
   // If the response passed all the checks so far, then |expected_name| is it.
@@ -289,4 +294,37 @@ DnsResponse::Result DnsResponse::ParseToAddressList(
   return DNS_PARSE_OK;
 }
 
+bool DnsResponse::ParseNegativeTTL(base::TimeDelta* ttl) const {
+  DCHECK(IsValid());
+  DnsRecordParser parser = Parser();
+  DnsResourceRecord record;
+  unsigned ancount = answer_count();
+  unsigned count = ancount + authority_count();
+  for (unsigned i = 0; i < count; ++i) {
+    if (!parser.ReadRecord(&record))
+      return false;
+    if (i < ancount || record.type != dns_protocol::kTypeSOA)
+      continue;
+
+    // RDATA is MNAME RNAME SERIAL REFRESH RETRY EXPIRE MINIMUM.
+    // See RFC 1035 section 3.3.13.
+    size_t mname_size = parser.ReadName(record.rdata.begin(), NULL);
+    if (!mname_size || mname_size >= record.rdata.size())
+      return false;
+    size_t rname_size = parser.ReadName(record.rdata.begin() + mname_size,
+                                        NULL);
+    if (!rname_size || mname_size + rname_size > record.rdata.size())
+      return false;
+    BigEndianReader reader(record.rdata.begin() + mname_size + rname_size,
+                           record.rdata.size() - mname_size - rname_size);
+    uint32 minimum_ttl_sec;
+    if (!reader.Skip(4 * sizeof(uint32)) || !reader.ReadU32(&minimum_ttl_sec))
+      return false;
+
+    *ttl = base::TimeDelta::FromSeconds(std::min(record.ttl, minimum_ttl_sec));
+    return true;
+  }
+  return false;
+}
+
 }  // namespace net
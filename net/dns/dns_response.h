@@ -120,6 +120,7 @@ class NET_EXPORT_PRIVATE DnsResponse {
   uint16 flags() const;  // excluding rcode
   uint8 rcode() const;
   unsigned answer_count() const;
+  unsigned authority_count() const;
 
   // Accessors to the question. The qname is unparsed.
   base::StringPiece qname() const;
@@ -137,6 +138,12 @@ class NET_EXPORT_PRIVATE DnsResponse {
   // Otherwise returns a detailed error number.
   Result ParseToAddressList(AddressList* addr_list, base::TimeDelta* ttl) const;
 
+  // Extracts the time for which a negative answer (NXDOMAIN or no addresses)
+  // can be cached, that is the smaller of the TTL and the MINIMUM field of the
+  // SOA record in the authority section. See RFC 2308 section 5. Returns false
+  // if there is no such record or the response is malformed.
+  bool ParseNegativeTTL(base::TimeDelta* ttl) const;
+
  private:
   // Convenience for header access.
   const dns_protocol::Header* header() const;
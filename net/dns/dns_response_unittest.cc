@@ -447,6 +447,99 @@ TEST(DnsResponseTest, ParseToAddressListFail) {
   }
 }
 
+const uint8 kResponseNXDomain[] = {
+  // Header: rcode = NXDOMAIN, 1 question, 1 authority RR
+  0x00, 0x00, 0x81, 0x83, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+  // Question: name = 'a', type = A (0x1)
+  0x01,  'a', 0x00, 0x00, 0x01, 0x00, 0x01,
+  // Authority: name = 'a', type = SOA (0x6), TTL = 0xE10
+  0xc0, 0x0c, 0x00, 0x06, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x10, 0x00, 0x1D,
+  // MNAME = 'ns.a', RNAME = 'h.a'
+  0x02,  'n',  's', 0xc0, 0x0c, 0x01,  'h', 0xc0, 0x0c,
+  // SERIAL, REFRESH, RETRY, EXPIRE
+  0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x10,
+  0x00, 0x00, 0x02, 0x58, 0x00, 0x09, 0x3A, 0x80,
+  // MINIMUM = 0x12C
+  0x00, 0x00, 0x01, 0x2C,
+};
+
+const uint8 kResponseNoDataAfterCNAME[] = {
+  // Header: 1 question, 1 answer RR, 1 authority RR
+  0x00, 0x00, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+  // Question: name = 'a', type = A (0x1)
+  0x01,  'a', 0x00, 0x00, 0x01, 0x00, 0x01,
+  // Answer: name = 'a', type = CNAME, TTL = 0xFF, RDATA = 'b'
+  0x01,  'a', 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0xFF,
+  0x00, 0x03, 0x01,  'b', 0x00,
+  // Authority: name = 'b', type = SOA (0x6), TTL = 0x3C
+  0x01,  'b', 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3C,
+  0x00, 0x18,
+  // MNAME = 'b', RNAME = 'b'
+  0xc0, 0x20, 0xc0, 0x20,
+  // SERIAL, REFRESH, RETRY, EXPIRE
+  0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x10,
+  0x00, 0x00, 0x02, 0x58, 0x00, 0x09, 0x3A, 0x80,
+  // MINIMUM = 0x12C
+  0x00, 0x00, 0x01, 0x2C,
+};
+
+const uint8 kResponseTruncatedSOA[] = {
+  // Header: rcode = NXDOMAIN, 1 question, 1 authority RR
+  0x00, 0x00, 0x81, 0x83, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+  // Question: name = 'a', type = A (0x1)
+  0x01,  'a', 0x00, 0x00, 0x01, 0x00, 0x01,
+  // Authority: name = 'a', type = SOA (0x6), TTL = 0xE10
+  0xc0, 0x0c, 0x00, 0x06, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x10, 0x00, 0x0C,
+  // MNAME = 'a', RNAME = 'a', SERIAL, REFRESH, no RETRY, EXPIRE nor MINIMUM
+  0xc0, 0x0c, 0xc0, 0x0c, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x10,
+};
+
+TEST(DnsResponseTest, ParseNegativeTTL) {
+  const struct TestCase {
+    const uint8* data;
+    size_t size;
+    int expected_ttl_sec;
+  } cases[] = {
+    // The MINIMUM is smaller than the TTL of the SOA record.
+    { kResponseNXDomain, arraysize(kResponseNXDomain), 0x12C },
+    // The TTL of the SOA record is smaller than the MINIMUM.
+    { kResponseNoDataAfterCNAME, arraysize(kResponseNoDataAfterCNAME), 0x3C },
+  };
+
+  const size_t kQuerySize = 12 + 7;
+
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(cases); ++i) {
+    const TestCase& t = cases[i];
+
+    DnsResponse response(t.data, t.size, kQuerySize);
+    base::TimeDelta ttl;
+    EXPECT_TRUE(response.ParseNegativeTTL(&ttl));
+    EXPECT_EQ(base::TimeDelta::FromSeconds(t.expected_ttl_sec), ttl);
+  }
+}
+
+TEST(DnsResponseTest, ParseNegativeTTLFail) {
+  const struct TestCase {
+    const uint8* data;
+    size_t size;
+  } cases[] = {
+    // No SOA record in the authority section.
+    { kResponseNoAddresses, arraysize(kResponseNoAddresses) },
+    { kResponseTruncatedSOA, arraysize(kResponseTruncatedSOA) },
+    { kResponseTruncatedRecord, arraysize(kResponseTruncatedRecord) },
+  };
+
+  const size_t kQuerySize = 12 + 7;
+
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(cases); ++i) {
+    const TestCase& t = cases[i];
+
+    DnsResponse response(t.data, t.size, kQuerySize);
+    base::TimeDelta ttl;
+    EXPECT_FALSE(response.ParseNegativeTTL(&ttl));
+  }
+}
+
 }  // namespace
 
 }  // namespace net
@@ -75,7 +75,8 @@ class MockTransaction : public DnsTransaction,
   void Finish() {
     switch (result_) {
       case MockDnsClientRule::EMPTY:
-      case MockDnsClientRule::OK: {
+      case MockDnsClientRule::OK:
+      case MockDnsClientRule::NXDOMAIN: {
         std::string qname;
         DNSDomainFromDot(hostname_, &qname);
         DnsQuery query(0, qname, qtype_);
@@ -88,12 +89,12 @@ class MockTransaction : public DnsTransaction,
             reinterpret_cast<dns_protocol::Header*>(buffer);
         header->flags |= dns_protocol::kFlagResponse;
 
-        if (MockDnsClientRule::OK == result_) {
-          const uint16 kPointerToQueryName =
-              static_cast<uint16>(0xc000 | sizeof(*header));
+        const uint16 kPointerToQueryName =
+            static_cast<uint16>(0xc000 | sizeof(*header));
 
-          const uint32 kTTL = 86400;  // One day.
+        const uint32 kTTL = 86400;  // One day.
 
+        if (MockDnsClientRule::OK == result_) {
           // Size of RDATA which is a IPv4 or IPv6 address.
           size_t rdata_size = qtype_ == net::dns_protocol::kTypeA ?
                               net::kIPv4AddressSize : net::kIPv6AddressSize;
@@ -119,9 +120,35 @@ class MockTransaction : public DnsTransaction,
             writer.WriteBytes(kIPv6Loopback, sizeof(kIPv6Loopback));
           }
           nbytes += answer_size;
+        } else if (MockDnsClientRule::NXDOMAIN == result_) {
+          header->flags |= base::HostToNet16(dns_protocol::kRcodeNXDOMAIN);
+
+          // RDATA of SOA is two compressed name references and five uint32s.
+          size_t rdata_size = 2 * sizeof(uint16) + 5 * sizeof(uint32);
+          size_t authority_size = 12 + rdata_size;
+
+          // Write authority with the SOA record.
+          header->nscount = base::HostToNet16(1);
+          BigEndianWriter writer(buffer + nbytes, authority_size);
+          writer.WriteU16(kPointerToQueryName);
+          writer.WriteU16(net::dns_protocol::kTypeSOA);
+          writer.WriteU16(net::dns_protocol::kClassIN);
+          writer.WriteU32(kTTL);
+          writer.WriteU16(rdata_size);
+          writer.WriteU16(kPointerToQueryName);  // MNAME
+          writer.WriteU16(kPointerToQueryName);  // RNAME
+          writer.WriteU32(1);  // SERIAL
+          writer.WriteU32(kTTL);  // REFRESH
+          writer.WriteU32(kTTL);  // RETRY
+          writer.WriteU32(kTTL);  // EXPIRE
+          writer.WriteU32(kMockNegativeTTL);  // MINIMUM
+          nbytes += authority_size;
         }
         EXPECT_TRUE(response.InitParse(nbytes, query));
-        callback_.Run(this, OK, &response);
+        callback_.Run(this,
+                      MockDnsClientRule::NXDOMAIN == result_ ?
+                          ERR_NAME_NOT_RESOLVED : OK,
+                      &response);
       } break;
       case MockDnsClientRule::FAIL_ASYNC:
         callback_.Run(this, ERR_NAME_NOT_RESOLVED, NULL);
@@ -170,12 +170,18 @@ static const unsigned kT3RecordCount = arraysize(kT3IpAddresses) + 2;
 
 class DnsClient;
 
+// Negative caching TTL of the NXDOMAIN responses of the mock DnsClient.
+static const int kMockNegativeTTL = 300;
+
 struct MockDnsClientRule {
   enum Result {
     FAIL_SYNC,   // Fail synchronously with ERR_NAME_NOT_RESOLVED.
     FAIL_ASYNC,  // Fail asynchronously with ERR_NAME_NOT_RESOLVED.
     EMPTY,       // Return an empty response.
     OK,          // Return a response with loopback address.
+    NXDOMAIN,    // Fail asynchronously with ERR_NAME_NOT_RESOLVED and an
+                 // NXDOMAIN response that can be cached for
+                 // kMockNegativeTTL seconds.
   };
 
   std::string prefix;
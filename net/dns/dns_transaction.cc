@@ -211,7 +211,8 @@ class DnsUDPAttempt {
     }
     if (response_->flags() & dns_protocol::kFlagTC)
       return ERR_DNS_SERVER_REQUIRES_TCP;
-    // TODO(szym): Extract TTL for NXDOMAIN results. http://crbug.com/115051
+    // The response is kept so that the TTL of NXDOMAIN results can be read
+    // from its authority section.
     if (response_->rcode() == dns_protocol::kRcodeNXDOMAIN)
       return ERR_NAME_NOT_RESOLVED;
     if (response_->rcode() != dns_protocol::kRcodeNOERROR)
@@ -496,7 +497,8 @@ class DnsTransactionImpl : public DnsTransaction,
           // Try next suffix.
           qnames_.pop_front();
           if (qnames_.empty()) {
-            return AttemptResult(ERR_NAME_NOT_RESOLVED, NULL);
+            // Pass on the NXDOMAIN response for the last name.
+            return result;
           } else {
             result = StartQuery();
           }
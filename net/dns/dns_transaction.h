@@ -47,6 +47,8 @@ class NET_EXPORT_PRIVATE DnsTransaction {
 class NET_EXPORT_PRIVATE DnsTransactionFactory {
  public:
   // Called with the response or NULL if no matching response was received.
+  // On ERR_NAME_NOT_RESOLVED, the response is the NXDOMAIN response for the
+  // last name of the search, if any.
   // Note that the |GetDottedName()| of the response may be different than the
   // original |hostname| as a result of suffix search.
   typedef base::Callback<void(DnsTransaction* transaction,
@@ -20,6 +20,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/message_loop.h"
 #include "base/metrics/field_trial.h"
+#include "base/metrics/histogram.h"
 #include "base/pickle.h"
 #include "base/stl_util.h"
 #include "base/string_number_conversions.h"
@@ -70,7 +71,9 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      read_while_writing(false),
+      truncated(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -243,6 +246,100 @@ void HttpCache::MetadataWriter::OnIOComplete(int result) {
 
 //-----------------------------------------------------------------------------
 
+// This class encapsulates a transaction that validates an entry that was used
+// while stale (see HttpResponseHeaders::CanUseStaleWhileRevalidate). The
+// transaction updates the entry with the new response, and it has to read the
+// whole body to do so if the server sends a new version of the resource.
+class HttpCache::AsyncValidation {
+ public:
+  AsyncValidation(HttpCache* cache, const std::string& key)
+      : cache_(cache),
+        key_(key) {
+  }
+
+  ~AsyncValidation() {}
+
+  // Starts validating the entry for a copy of |request|.
+  void Start(const HttpRequestInfo& request);
+
+ private:
+  void OnStartComplete(int result);
+  void ReadBody();
+  void OnReadComplete(int result);
+
+  // Reports the result and deletes this object.
+  void Done(int result);
+
+  static const int kBufferSize = 32 * 1024;
+
+  HttpCache* cache_;
+  std::string key_;
+  HttpRequestInfo request_info_;
+  scoped_ptr<HttpCache::Transaction> transaction_;
+  scoped_refptr<IOBuffer> buf_;
+  base::TimeTicks start_time_;
+  DISALLOW_COPY_AND_ASSIGN(AsyncValidation);
+};
+
+void HttpCache::AsyncValidation::Start(const HttpRequestInfo& request) {
+  request_info_ = request;
+  request_info_.load_flags &= ~(LOAD_PREFERRING_CACHE | LOAD_ONLY_FROM_CACHE);
+  request_info_.load_flags |= LOAD_VALIDATE_CACHE;
+  request_info_.priority = LOWEST;
+  start_time_ = base::TimeTicks::Now();
+
+  transaction_.reset(new HttpCache::Transaction(cache_, NULL, NULL));
+  int rv = transaction_->Start(
+      &request_info_,
+      base::Bind(&AsyncValidation::OnStartComplete, base::Unretained(this)),
+      BoundNetLog());
+  if (rv != ERR_IO_PENDING)
+    OnStartComplete(rv);
+}
+
+void HttpCache::AsyncValidation::OnStartComplete(int result) {
+  if (result != OK)
+    return Done(result);
+
+  // This is the time that the request would have waited for the validation.
+  UMA_HISTOGRAM_TIMES("HttpCache.StaleWhileRevalidate.TimeSaved",
+                      base::TimeTicks::Now() - start_time_);
+
+  // A validated entry was already updated, and there is no need to read it.
+  const HttpResponseInfo* response = transaction_->GetResponseInfo();
+  if (response && response->was_cached)
+    return Done(OK);
+
+  buf_ = new IOBuffer(kBufferSize);
+  ReadBody();
+}
+
+void HttpCache::AsyncValidation::ReadBody() {
+  for (;;) {
+    int rv = transaction_->Read(
+        buf_, kBufferSize,
+        base::Bind(&AsyncValidation::OnReadComplete, base::Unretained(this)));
+    if (rv == ERR_IO_PENDING)
+      return;
+    if (rv <= 0)
+      return Done(rv);
+  }
+}
+
+void HttpCache::AsyncValidation::OnReadComplete(int result) {
+  if (result <= 0)
+    return Done(result);
+  ReadBody();
+}
+
+void HttpCache::AsyncValidation::Done(int result) {
+  UMA_HISTOGRAM_BOOLEAN("HttpCache.StaleWhileRevalidate.Success",
+                        result == OK);
+  cache_->OnAsyncValidationComplete(key_);
+}
+
+//-----------------------------------------------------------------------------
+
 HttpCache::HttpCache(const net::HttpNetworkSession::Params& params,
                      BackendFactory* backend_factory)
     : net_log_(params.net_log),
@@ -273,6 +370,10 @@ HttpCache::HttpCache(HttpTransactionFactory* network_layer,
 }
 
 HttpCache::~HttpCache() {
+  // The validations are regular transactions that should be done with their
+  // entries before we start destroying them.
+  STLDeleteValues(&async_validations_);
+
   // If we have any active entries remaining, then we need to deactivate them.
   // We may have some pending calls to OnProcessPendingQueue, but since those
   // won't run (due to our destruction), we can simply ignore the corresponding
@@ -741,6 +842,10 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   // use (since any existing entry should have already been doomed).
 
   if (entry->writer || entry->will_process_pending_queue) {
+    // A writer that is storing the response body may be joined by readers.
+    if (AddReaderWhileWriting(entry, trans))
+      return OK;
+
     entry->pending_queue.push_back(trans);
     return ERR_IO_PENDING;
   }
@@ -774,9 +879,7 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
   if (entry->will_process_pending_queue && entry->readers.empty())
     return;
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
-
+  if (entry->writer == trans) {
     // Assume there was a failure.
     bool success = false;
     if (cancel) {
@@ -795,9 +898,11 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
 }
 
 void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
-  DCHECK(entry->readers.empty());
+  DCHECK(entry->readers.empty() || entry->read_while_writing);
 
   entry->writer = NULL;
+  entry->read_while_writing = false;
+  NotifyWaitingReaders(entry);
 
   if (success) {
     ProcessPendingQueue(entry);
@@ -808,8 +913,18 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (entry->readers.empty()) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    } else {
+      // The readers that joined the writer will find out that the body is
+      // incomplete and fetch the rest of it from the network, and the last
+      // one will destroy the entry.
+      entry->truncated = true;
+      if (!entry->doomed)
+        DoomActiveEntry(entry->disk_entry->GetKey());
+      entry->disk_entry->Doom();
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -822,15 +937,18 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
+  DCHECK(!entry->writer || entry->read_while_writing);
 
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
   DCHECK(it != entry->readers.end());
 
   entry->readers.erase(it);
+  entry->waiting_readers.remove(trans);
 
-  ProcessPendingQueue(entry);
+  // The writer will process the pending queue when it is done.
+  if (!entry->writer)
+    ProcessPendingQueue(entry);
 }
 
 void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
@@ -846,6 +964,58 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::AllowReadingWhileWriting(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  DCHECK(entry->waiting_readers.empty());
+  entry->read_while_writing = true;
+  // A previous writer may have left the entry truncated.
+  entry->truncated = false;
+
+  // Move the transactions that can use this response out of the pending queue,
+  // keeping the rest in the same order.
+  TransactionList::iterator it = entry->pending_queue.begin();
+  while (it != entry->pending_queue.end()) {
+    Transaction* trans = *it;
+    if (!AddReaderWhileWriting(entry, trans)) {
+      ++it;
+      continue;
+    }
+    it = entry->pending_queue.erase(it);
+    MessageLoop::current()->PostTask(FROM_HERE,
+                                     base::Bind(trans->io_callback(), OK));
+  }
+}
+
+bool HttpCache::AddReaderWhileWriting(ActiveEntry* entry, Transaction* trans) {
+  if (!entry->writer || !entry->read_while_writing ||
+      !trans->CanReadWhileWriting(entry->writer)) {
+    return false;
+  }
+
+  trans->StartReadingWhileWriting();
+  entry->readers.push_back(trans);
+  return true;
+}
+
+void HttpCache::WaitForWriter(ActiveEntry* entry, Transaction* trans) {
+  DCHECK(entry->writer);
+  DCHECK(std::find(entry->waiting_readers.begin(), entry->waiting_readers.end(),
+                   trans) == entry->waiting_readers.end());
+  entry->waiting_readers.push_back(trans);
+}
+
+void HttpCache::NotifyWaitingReaders(ActiveEntry* entry) {
+  // The readers are notified asynchronously, so that they cannot destroy the
+  // writer while it is still using the entry.
+  TransactionList waiting_readers;
+  waiting_readers.swap(entry->waiting_readers);
+  for (TransactionList::iterator it = waiting_readers.begin();
+       it != waiting_readers.end(); ++it) {
+    MessageLoop::current()->PostTask(FROM_HERE,
+                                     base::Bind((*it)->io_callback(), OK));
+  }
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -939,6 +1109,23 @@ void HttpCache::ProcessPendingQueue(ActiveEntry* entry) {
                  entry));
 }
 
+void HttpCache::StartAsyncValidation(const HttpRequestInfo& request,
+                                     const std::string& key) {
+  if (async_validations_.find(key) != async_validations_.end())
+    return;  // There is already a validation in progress.
+
+  AsyncValidation* validation = new AsyncValidation(this, key);
+  async_validations_[key] = validation;
+  validation->Start(request);
+}
+
+void HttpCache::OnAsyncValidationComplete(const std::string& key) {
+  AsyncValidationMap::iterator it = async_validations_.find(key);
+  DCHECK(it != async_validations_.end());
+  delete it->second;
+  async_validations_.erase(it);
+}
+
 void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   entry->will_process_pending_queue = false;
   DCHECK(!entry->writer);
@@ -208,6 +208,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
  private:
   // Types --------------------------------------------------------------------
 
+  class AsyncValidation;
   class MetadataWriter;
   class Transaction;
   class WorkItem;
@@ -228,12 +229,25 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
     bool               doomed;
+
+    // True while readers may join the writer and read the part of the
+    // response body that it has already stored.
+    bool               read_while_writing;
+
+    // Readers that reached the end of the stored data and are waiting for the
+    // writer to store more.
+    TransactionList    waiting_readers;
+
+    // True if the writer stopped before storing the whole response body. The
+    // readers fetch the rest of it from the network when they can.
+    bool               truncated;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
   typedef base::hash_map<std::string, PendingOp*> PendingOpsMap;
   typedef std::set<ActiveEntry*> ActiveEntriesSet;
   typedef base::hash_map<std::string, int> PlaybackCacheMap;
+  typedef base::hash_map<std::string, AsyncValidation*> AsyncValidationMap;
 
   // Methods ------------------------------------------------------------------
 
@@ -327,6 +341,24 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Called when the writer of |entry| has stored the first part of the
+  // response body. From now on, the transactions that can use that response
+  // are added to the entry as readers without waiting for the writer to
+  // finish.
+  void AllowReadingWhileWriting(ActiveEntry* entry);
+
+  // Adds |trans| to the readers of |entry| while the writer is still storing
+  // the response, if it can use that response. Returns true on success.
+  bool AddReaderWhileWriting(ActiveEntry* entry, Transaction* trans);
+
+  // Called when the reader |trans| has read all the data stored so far on
+  // |entry|. |trans| will be notified via its IO callback when the writer
+  // stores more data or stops writing.
+  void WaitForWriter(ActiveEntry* entry, Transaction* trans);
+
+  // Notifies the readers waiting for the writer of |entry|.
+  void NotifyWaitingReaders(ActiveEntry* entry);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -345,6 +377,14 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // Resumes processing the pending list of |entry|.
   void ProcessPendingQueue(ActiveEntry* entry);
 
+  // Starts validating the entry for |key| in the background, with a copy of
+  // |request|, unless that is already in progress.
+  void StartAsyncValidation(const HttpRequestInfo& request,
+                            const std::string& key);
+
+  // Called when the validation of the entry for |key| is done.
+  void OnAsyncValidationComplete(const std::string& key);
+
   // Events (called via PostTask) ---------------------------------------------
 
   void OnProcessPendingQueue(ActiveEntry* entry);
@@ -391,6 +431,9 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   scoped_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  // The validations of entries that were used while stale, by cache key.
+  AsyncValidationMap async_validations_;
+
   InfiniteCache infinite_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(HttpCache);
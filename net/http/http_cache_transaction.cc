@@ -18,6 +18,7 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/string_util.h"
+#include "base/stringprintf.h"
 #include "base/time.h"
 #include "net/base/cert_status_flags.h"
 #include "net/base/completion_callback.h"
@@ -134,9 +135,12 @@ HttpCache::Transaction::Transaction(
       handling_206_(false),
       cache_pending_(false),
       done_reading_(false),
+      read_while_writing_(false),
       read_offset_(0),
       effective_load_flags_(0),
       write_len_(0),
+      stored_info_len_(0),
+      stored_info_entry_(NULL),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)),
       ALLOW_THIS_IN_INITIALIZER_LIST(io_callback_(
           base::Bind(&Transaction::OnIOComplete,
@@ -169,6 +173,9 @@ HttpCache::Transaction::~Transaction() {
       }
 
       cache_->DoneWithEntry(entry_, this, cancel_request);
+    } else if (cache_pending_ && read_while_writing_) {
+      // We were added to the entry but never got to use it.
+      cache_->DoneWithEntry(new_entry_, this, false);
     } else if (cache_pending_) {
       cache_->RemovePendingTransaction(this);
     }
@@ -217,6 +224,7 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
     infinite_cache_transaction_->OnTruncatedResponse();
 
   truncated_ = true;
+  entry_->truncated = true;
   target_state_ = STATE_NONE;
   next_state_ = STATE_CACHE_WRITE_TRUNCATED_RESPONSE;
   DoLoop(OK);
@@ -402,9 +410,10 @@ void HttpCache::Transaction::StopCaching() {
   // free, that would be an asynchronous operation). In other words, keep the
   // entry how it is (it will be marked as truncated at destruction), and let
   // the next piece of code that executes know that we are now reading directly
-  // from the net.
+  // from the net. Readers that joined this transaction still need the rest of
+  // the response, so in that case we keep writing.
   if (cache_ && entry_ && (mode_ & WRITE) && network_trans_.get() &&
-      !is_sparse_ && !range_requested_) {
+      !is_sparse_ && !range_requested_ && entry_->readers.empty()) {
     mode_ = NONE;
   }
 }
@@ -561,6 +570,13 @@ int HttpCache::Transaction::DoLoop(int result) {
       case STATE_NETWORK_READ_COMPLETE:
         rv = DoNetworkReadComplete(rv);
         break;
+      case STATE_RESUME_NETWORK_REQUEST:
+        DCHECK_EQ(OK, rv);
+        rv = DoResumeNetworkRequest();
+        break;
+      case STATE_RESUME_NETWORK_REQUEST_COMPLETE:
+        rv = DoResumeNetworkRequestComplete(rv);
+        break;
       case STATE_INIT_ENTRY:
         DCHECK_EQ(OK, rv);
         rv = DoInitEntry();
@@ -892,6 +908,47 @@ int HttpCache::Transaction::DoNetworkReadComplete(int result) {
   return result;
 }
 
+int HttpCache::Transaction::DoResumeNetworkRequest() {
+  DCHECK_EQ(NONE, mode_);
+  DCHECK(!network_trans_.get());
+
+  int rv = cache_->network_layer_->CreateTransaction(&network_trans_, NULL);
+  if (rv != OK)
+    return rv;
+
+  ReportNetworkActionStart();
+  next_state_ = STATE_RESUME_NETWORK_REQUEST_COMPLETE;
+  return network_trans_->Start(request_, io_callback_, net_log_);
+}
+
+int HttpCache::Transaction::DoResumeNetworkRequestComplete(int result) {
+  ReportNetworkActionFinish();
+
+  if (!cache_)
+    return ERR_UNEXPECTED;
+
+  if (result != OK) {
+    network_trans_.reset();
+    return ERR_CACHE_READ_FAILURE;
+  }
+
+  // Only the rest of the body we have been returning will do. If the resource
+  // changed, If-Range makes the server send all of it instead.
+  const HttpResponseInfo* response = network_trans_->GetResponseInfo();
+  int64 first, last, total;
+  if (!response || !response->headers ||
+      response->headers->response_code() != 206 ||
+      !response->headers->GetContentRange(&first, &last, &total) ||
+      first != read_offset_ ||
+      total != response_.headers->GetContentLength()) {
+    network_trans_.reset();
+    return ERR_CACHE_READ_FAILURE;
+  }
+
+  next_state_ = STATE_NETWORK_READ;
+  return OK;
+}
+
 int HttpCache::Transaction::DoInitEntry() {
   DCHECK(!new_entry_);
 
@@ -1301,6 +1358,9 @@ int HttpCache::Transaction::DoCacheReadResponseComplete(int result) {
     return OnCacheReadError(result, true);
   }
   bytes_read_from_cache_ += result;
+  stored_info_ = read_buf_;
+  stored_info_len_ = io_buf_len_;
+  stored_info_entry_ = entry_->disk_entry;
 
   // Some resources may have slipped in as truncated when they're not.
   int current_size = entry_->disk_entry->GetDataSize(kResponseContentIndex);
@@ -1450,6 +1510,25 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
     return DoPartialCacheReadCompleted(result);
   }
 
+  if (result == 0 && read_while_writing_) {
+    if (entry_->writer) {
+      // We have read all the data stored so far.
+      next_state_ = STATE_CACHE_READ_DATA;
+      cache_->WaitForWriter(entry_, this);
+      return ERR_IO_PENDING;
+    }
+    if (read_offset_ <
+        entry_->disk_entry->GetDataSize(kResponseContentIndex)) {
+      // The writer stored more data before going away.
+      next_state_ = STATE_CACHE_READ_DATA;
+      return OK;
+    }
+    if (entry_->truncated) {
+      // The writer went away before storing the whole body.
+      return ResumeFromNetwork();
+    }
+  }
+
   if (result > 0) {
     read_offset_ += result;
     bytes_read_from_cache_ += result;
@@ -1494,11 +1573,24 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
     // We want to ignore errors writing to disk and just keep reading from
     // the network.
     result = write_len_;
-  } else if (!done_reading_ && entry_) {
-    int current_size = entry_->disk_entry->GetDataSize(kResponseContentIndex);
-    int64 body_size = response_.headers->GetContentLength();
-    if (body_size >= 0 && body_size <= current_size)
-      done_reading_ = true;
+  } else if (entry_) {
+    if (!done_reading_) {
+      int current_size =
+          entry_->disk_entry->GetDataSize(kResponseContentIndex);
+      int64 body_size = response_.headers->GetContentLength();
+      if (body_size >= 0 && body_size <= current_size)
+        done_reading_ = true;
+    }
+
+    if (result && mode_ == WRITE && !partial_.get() &&
+        !entry_->read_while_writing) {
+      // Other requests for this resource don't have to wait until the whole
+      // body is stored; they can read it as we go.
+      cache_->AllowReadingWhileWriting(entry_);
+    } else {
+      // There is more data for the readers that joined this transaction.
+      cache_->NotifyWaitingReaders(entry_);
+    }
   }
 
   if (partial_.get()) {
@@ -1682,6 +1774,11 @@ int HttpCache::Transaction::BeginCacheValidation() {
   bool skip_validation = effective_load_flags_ & LOAD_PREFERRING_CACHE ||
                          !RequiresValidation();
 
+  // A stale entry may be returned right away, and validated later.
+  bool async_validation = false;
+  if (!skip_validation && CanServeStaleWhileRevalidate())
+    skip_validation = async_validation = true;
+
   if (truncated_) {
     // Truncated entries can cause partial gets, so we shouldn't record this
     // load in histograms.
@@ -1712,6 +1809,10 @@ int HttpCache::Transaction::BeginCacheValidation() {
     cache_->ConvertWriterToReader(entry_);
     mode_ = READ;
 
+    // The validation will wait until we are done reading the entry.
+    if (async_validation)
+      cache_->StartAsyncValidation(*request_, cache_key_);
+
     if (entry_->disk_entry->GetDataSize(kMetadataIndex))
       next_state_ = STATE_CACHE_READ_METADATA;
   } else {
@@ -1874,6 +1975,64 @@ bool HttpCache::Transaction::RequiresValidation() {
   return false;
 }
 
+bool HttpCache::Transaction::CanReadWhileWriting(
+    const Transaction* writer) const {
+  // Only plain GETs of the whole resource, that would use the stored response
+  // as it is.
+  if (cache_->mode() != NORMAL || request_->method != "GET" ||
+      effective_load_flags_ & LOAD_VALIDATE_CACHE || partial_.get() ||
+      (mode_ != READ && mode_ != READ_WRITE)) {
+    return false;
+  }
+
+  const HttpResponseInfo& response = writer->response_;
+  if (response.headers->response_code() != 200)
+    return false;
+
+  if (response.vary_data.is_valid() &&
+      !response.vary_data.MatchesRequest(*request_, *response.headers)) {
+    return false;
+  }
+
+  // The response is not validated again by this transaction.
+  return mode_ == READ || effective_load_flags_ & LOAD_PREFERRING_CACHE ||
+         !response.headers->RequiresValidation(response.request_time,
+                                               response.response_time,
+                                               Time::Now());
+}
+
+void HttpCache::Transaction::StartReadingWhileWriting() {
+  DCHECK(cache_pending_);
+  mode_ = READ;
+  read_while_writing_ = true;
+}
+
+bool HttpCache::Transaction::CanServeStaleWhileRevalidate() {
+  // The validation is performed by a plain GET of the whole resource.
+  if (cache_->mode() != NORMAL || request_->method != "GET" ||
+      effective_load_flags_ & LOAD_VALIDATE_CACHE || partial_.get() ||
+      truncated_ || response_.headers->response_code() != 200) {
+    return false;
+  }
+
+  // A stored response that doesn't match the request cannot be used at all.
+  if (response_.vary_data.is_valid() &&
+      !response_.vary_data.MatchesRequest(*request_, *response_.headers)) {
+    return false;
+  }
+
+  TimeDelta stale_while_revalidate;
+  if (!response_.headers->GetStaleWhileRevalidateValue(
+          &stale_while_revalidate)) {
+    return false;
+  }
+
+  bool can_use = response_.headers->CanUseStaleWhileRevalidate(
+      response_.request_time, response_.response_time, Time::Now());
+  UMA_HISTOGRAM_BOOLEAN("HttpCache.StaleWhileRevalidate", can_use);
+  return can_use;
+}
+
 bool HttpCache::Transaction::ConditionalizeRequest() {
   DCHECK(response_.headers);
 
@@ -2142,9 +2301,44 @@ int HttpCache::Transaction::WriteResponseInfoToEntry(bool truncated) {
   response_.Persist(data->pickle(), skip_transient_headers, truncated);
   data->Done();
 
-  io_buf_len_ = data->pickle()->size();
-  return entry_->disk_entry->WriteData(kResponseInfoIndex, 0, data,
-                                       io_buf_len_, io_callback_, true);
+  int data_len = data->pickle()->size();
+  disk_cache::Entry* disk_entry = entry_->disk_entry;
+  bool can_update = stored_info_ && stored_info_entry_ == disk_entry &&
+                    stored_info_len_ == data_len &&
+                    disk_entry->GetDataSize(kResponseInfoIndex) == data_len;
+  scoped_refptr<IOBuffer> stored_info = stored_info_;
+  stored_info_ = data;
+  stored_info_len_ = data_len;
+  stored_info_entry_ = disk_entry;
+
+  if (can_update) {
+    // Revalidations usually change a few fields of the stored response (the
+    // times and some headers) without changing its size, so there is no need
+    // to rewrite all of it.
+    const char* old_data = stored_info->data();
+    const char* new_data = data->data();
+    int first = 0;
+    while (first < data_len && old_data[first] == new_data[first])
+      first++;
+    if (first == data_len) {
+      // Nothing changed.
+      io_buf_len_ = 0;
+      return 0;
+    }
+    int last = data_len - 1;
+    while (old_data[last] == new_data[last])
+      last--;
+
+    io_buf_len_ = last - first + 1;
+    scoped_refptr<IOBuffer> delta(new IOBuffer(io_buf_len_));
+    memcpy(delta->data(), new_data + first, io_buf_len_);
+    return disk_entry->WriteData(kResponseInfoIndex, first, delta,
+                                 io_buf_len_, io_callback_, false);
+  }
+
+  io_buf_len_ = data_len;
+  return disk_entry->WriteData(kResponseInfoIndex, 0, data, io_buf_len_,
+                               io_callback_, true);
 }
 
 int HttpCache::Transaction::AppendResponseDataToEntry(
@@ -2263,6 +2457,40 @@ bool HttpCache::Transaction::CanResume(bool has_data) {
   return true;
 }
 
+int HttpCache::Transaction::ResumeFromNetwork() {
+  DCHECK(read_while_writing_);
+  bool can_resume = CanResume(false) &&
+      !(effective_load_flags_ & LOAD_ONLY_FROM_CACHE) &&
+      read_offset_ < response_.headers->GetContentLength();
+
+  cache_->DoneReadingFromEntry(entry_, this);
+  entry_ = NULL;
+  read_while_writing_ = false;
+  mode_ = NONE;
+  if (!can_resume)
+    return ERR_CACHE_READ_FAILURE;
+
+  std::string validator;
+  if (!response_.headers->EnumerateHeader(NULL, "etag", &validator) ||
+      StartsWithASCII(validator, "W/", true)) {
+    validator.clear();
+    response_.headers->EnumerateHeader(NULL, "last-modified", &validator);
+  }
+  if (validator.empty())
+    return ERR_CACHE_READ_FAILURE;
+
+  custom_request_.reset(new HttpRequestInfo(*request_));
+  request_ = custom_request_.get();
+  custom_request_->extra_headers.SetHeader(
+      HttpRequestHeaders::kRange,
+      base::StringPrintf("bytes=%d-", read_offset_));
+  custom_request_->extra_headers.SetHeader(HttpRequestHeaders::kIfRange,
+                                           validator);
+
+  next_state_ = STATE_RESUME_NETWORK_REQUEST;
+  return OK;
+}
+
 void HttpCache::Transaction::OnIOComplete(int result) {
   DoLoop(result);
 }
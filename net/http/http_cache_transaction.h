@@ -93,6 +93,13 @@ class HttpCache::Transaction : public HttpTransaction {
 
   HttpCache::ActiveEntry* entry() { return entry_; }
 
+  // Returns true if this transaction, waiting to be added to the entry that
+  // |writer| is storing, can read the response while it is being stored.
+  bool CanReadWhileWriting(const Transaction* writer) const;
+
+  // Makes this transaction a reader of the entry that is being stored.
+  void StartReadingWhileWriting();
+
   // Returns the LoadState of the writer transaction of a given ActiveEntry. In
   // other words, returns the LoadState of this transaction without asking the
   // http cache, because this transaction should be the one currently writing
@@ -143,6 +150,8 @@ class HttpCache::Transaction : public HttpTransaction {
     STATE_SUCCESSFUL_SEND_REQUEST,
     STATE_NETWORK_READ,
     STATE_NETWORK_READ_COMPLETE,
+    STATE_RESUME_NETWORK_REQUEST,
+    STATE_RESUME_NETWORK_REQUEST_COMPLETE,
     STATE_INIT_ENTRY,
     STATE_OPEN_ENTRY,
     STATE_OPEN_ENTRY_COMPLETE,
@@ -210,6 +219,8 @@ class HttpCache::Transaction : public HttpTransaction {
   int DoSuccessfulSendRequest();
   int DoNetworkRead();
   int DoNetworkReadComplete(int result);
+  int DoResumeNetworkRequest();
+  int DoResumeNetworkRequestComplete(int result);
   int DoInitEntry();
   int DoOpenEntry();
   int DoOpenEntryComplete(int result);
@@ -285,6 +296,10 @@ class HttpCache::Transaction : public HttpTransaction {
   // Called to determine if we need to validate the cache entry before using it.
   bool RequiresValidation();
 
+  // Called when the cache entry requires validation, to determine if the
+  // stale entry can be used while it is revalidated in the background.
+  bool CanServeStaleWhileRevalidate();
+
   // Called to make the request conditional (to ask the server if the cached
   // copy is valid).  Returns true if able to make the request conditional.
   bool ConditionalizeRequest();
@@ -314,7 +329,8 @@ class HttpCache::Transaction : public HttpTransaction {
                    const CompletionCallback& callback);
 
   // Called to write response_ to the cache entry. |truncated| indicates if the
-  // entry should be marked as incomplete.
+  // entry should be marked as incomplete. If the entry already holds a response
+  // of the same size, only the bytes that differ are written.
   int WriteResponseInfoToEntry(bool truncated);
 
   // Called to append response data to the cache entry.  Returns a network error
@@ -352,6 +368,13 @@ class HttpCache::Transaction : public HttpTransaction {
   // data is considered for the result.
   bool CanResume(bool has_data);
 
+  // Called when this transaction was reading the response while it was being
+  // stored, and the writer went away before storing the whole body. Detaches
+  // from the entry and, if the response can be resumed, sets things up to get
+  // the rest of the body from the network. Returns OK on success, or
+  // ERR_CACHE_READ_FAILURE.
+  int ResumeFromNetwork();
+
   // Called to signal completion of asynchronous IO.
   void OnIOComplete(int result);
 
@@ -390,11 +413,17 @@ class HttpCache::Transaction : public HttpTransaction {
   bool handling_206_;  // We must deal with this 206 response.
   bool cache_pending_;  // We are waiting for the HttpCache.
   bool done_reading_;
+  bool read_while_writing_;  // Reading an entry that is still being stored.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
   int effective_load_flags_;
   int write_len_;
+  // The response info stored in |stored_info_entry_|, so that updates only
+  // write the bytes that changed.
+  scoped_refptr<IOBuffer> stored_info_;
+  int stored_info_len_;
+  disk_cache::Entry* stored_info_entry_;
   scoped_ptr<PartialData> partial_;  // We are dealing with range requests.
   UploadProgress final_upload_progress_;
   base::WeakPtrFactory<Transaction> weak_factory_;
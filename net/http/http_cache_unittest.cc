@@ -1043,11 +1043,12 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   c->result = c->callback.WaitForResult();
   ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // Now we have 2 active readers and two queued transactions.
+  // Now we have 4 active readers, that joined the writer as soon as it stored
+  // part of the response body.
 
   EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[2]->trans->GetLoadState());
-  EXPECT_EQ(net::LOAD_STATE_WAITING_FOR_CACHE,
+  EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[3]->trans->GetLoadState());
 
   c = context_list[1];
@@ -1056,10 +1057,8 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   if (c->result == net::OK)
     ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // At this point we have one reader, two pending transactions and a task on
-  // the queue to move to the next transaction. Now we cancel the request that
-  // is the current reader, and expect the queued task to be able to start the
-  // next request.
+  // Now we cancel one of the readers, and expect the rest of them to be able
+  // to finish reading the entry.
 
   c = context_list[2];
   c->trans.reset();
@@ -1243,6 +1242,221 @@ TEST(HttpCache, SimpleGET_ManyWriters_CancelFirst) {
   }
 }
 
+// Tests that a request for a resource that is being stored reads the part of
+// the body that is already in the cache, and then waits for the writer.
+TEST(HttpCache, SimpleGET_ReadWhileWriting) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  Context reader;
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&writer.trans,
+                                                           NULL));
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&reader.trans,
+                                                           NULL));
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  // The reader waits until the writer stores part of the body.
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  const int kChunkSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(kChunkSize));
+  int rv = writer.trans->Read(buf, kChunkSize, writer.callback.callback());
+  EXPECT_EQ(kChunkSize, writer.callback.GetResult(rv));
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+
+  scoped_refptr<net::IOBuffer> reader_buf(new net::IOBuffer(256));
+  rv = reader.trans->Read(reader_buf, 256, reader.callback.callback());
+  EXPECT_EQ(kChunkSize, reader.callback.GetResult(rv));
+  std::string content(reader_buf->data(), kChunkSize);
+
+  // There is nothing else to read until the writer stores more data.
+  rv = reader.trans->Read(reader_buf, 256, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  std::string writer_content;
+  EXPECT_EQ(net::OK, ReadTransaction(writer.trans.get(), &writer_content));
+
+  rv = reader.callback.WaitForResult();
+  ASSERT_LT(0, rv);
+  content.append(reader_buf->data(), rv);
+  std::string rest;
+  EXPECT_EQ(net::OK, ReadTransaction(reader.trans.get(), &rest));
+  content.append(rest);
+  EXPECT_EQ(kSimpleGET_Transaction.data, content);
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a reader that joined the writer fails if the writer goes away
+// before storing the whole body and the response cannot be resumed, and that
+// the entry is not kept.
+TEST(HttpCache, SimpleGET_ReadWhileWriting_CancelWriter) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  Context reader;
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&writer.trans,
+                                                           NULL));
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&reader.trans,
+                                                           NULL));
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  const int kChunkSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(kChunkSize));
+  int rv = writer.trans->Read(buf, kChunkSize, writer.callback.callback());
+  EXPECT_EQ(kChunkSize, writer.callback.GetResult(rv));
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+
+  rv = reader.trans->Read(buf, kChunkSize, reader.callback.callback());
+  EXPECT_EQ(kChunkSize, reader.callback.GetResult(rv));
+  rv = reader.trans->Read(buf, kChunkSize, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  writer.trans.reset();
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, reader.callback.WaitForResult());
+  reader.trans.reset();
+
+  // The next request goes to the network again.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(2, cache.disk_cache()->create_count());
+}
+
+// Serves the whole 80 byte resource of kRangeGET_TransactionOK, or the byte
+// range that was requested.
+void ResumableGETHandler(const net::HttpRequestInfo* request,
+                         std::string* response_status,
+                         std::string* response_headers,
+                         std::string* response_data) {
+  if (!request->extra_headers.HasHeader(net::HttpRequestHeaders::kRange))
+    return;
+
+  EXPECT_TRUE(
+      request->extra_headers.HasHeader(net::HttpRequestHeaders::kIfRange));
+  response_status->assign("HTTP/1.1 206 Partial Content");
+  RangeTransactionServer::RangeHandler(request, response_status,
+                                       response_headers, response_data);
+}
+
+// The whole resource of kRangeGET_TransactionOK, which can be resumed.
+const MockTransaction kResumableGET_Transaction = {
+  "http://www.google.com/range",
+  "GET",
+  base::Time(),
+  EXTRA_HEADER,
+  net::LOAD_NORMAL,
+  "HTTP/1.1 200 OK",
+  "Last-Modified: Sat, 18 Apr 2007 01:10:43 GMT\n"
+  "ETag: \"foo\"\n"
+  "Accept-Ranges: bytes\n"
+  "Cache-Control: max-age=3600\n"
+  "Content-Length: 80\n",
+  base::Time(),
+  "rg: 00-09 rg: 10-19 rg: 20-29 rg: 30-39 "
+  "rg: 40-49 rg: 50-59 rg: 60-69 rg: 70-79 ",
+  TEST_MODE_NORMAL,
+  &ResumableGETHandler,
+  0
+};
+
+// Starts |writer| and |reader| for |transaction|, lets the reader join the
+// writer and read the first 10 bytes into |content|, and then cancels the
+// writer while the reader waits for more data. Returns the result of that
+// read, which goes to |buf|.
+int CancelWriterWhileReading(MockHttpCache* cache,
+                             const MockTransaction& transaction,
+                             Context* writer, Context* reader,
+                             net::IOBuffer* buf, int buf_len,
+                             std::string* content) {
+  MockHttpRequest request(transaction);
+  EXPECT_EQ(net::OK, cache->http_cache()->CreateTransaction(&writer->trans,
+                                                            NULL));
+  EXPECT_EQ(net::OK, cache->http_cache()->CreateTransaction(&reader->trans,
+                                                            NULL));
+  writer->result = writer->trans->Start(
+      &request, writer->callback.callback(), net::BoundNetLog());
+  reader->result = reader->trans->Start(
+      &request, reader->callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer->callback.GetResult(writer->result));
+
+  const int kChunkSize = 10;
+  int rv = writer->trans->Read(buf, kChunkSize, writer->callback.callback());
+  EXPECT_EQ(kChunkSize, writer->callback.GetResult(rv));
+  EXPECT_EQ(net::OK, reader->callback.GetResult(reader->result));
+
+  rv = reader->trans->Read(buf, buf_len, reader->callback.callback());
+  EXPECT_EQ(kChunkSize, reader->callback.GetResult(rv));
+  content->assign(buf->data(), kChunkSize);
+  rv = reader->trans->Read(buf, buf_len, reader->callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  writer->trans.reset();
+  return reader->callback.WaitForResult();
+}
+
+// Tests that a reader that joined the writer gets the rest of the body from
+// the network if the writer goes away before storing all of it.
+TEST(HttpCache, SimpleGET_ReadWhileWriting_CancelWriterResume) {
+  MockHttpCache cache;
+
+  ScopedMockTransaction transaction(kResumableGET_Transaction);
+
+  Context writer;
+  Context reader;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  std::string content;
+  int rv = CancelWriterWhileReading(&cache, transaction, &writer, &reader,
+                                    buf, 256, &content);
+  ASSERT_LT(0, rv);
+  content.append(buf->data(), rv);
+  std::string rest;
+  EXPECT_EQ(net::OK, ReadTransaction(reader.trans.get(), &rest));
+  content.append(rest);
+  EXPECT_EQ(transaction.data, content);
+
+  // The reader still reports the response it started with.
+  EXPECT_EQ(200, reader.trans->GetResponseInfo()->headers->response_code());
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+}
+
+// Tests that a reader that joined the writer fails if the writer goes away
+// before storing the whole body and the server does not return the rest of
+// it.
+TEST(HttpCache, SimpleGET_ReadWhileWriting_CancelWriterResumeFails) {
+  MockHttpCache cache;
+  RangeTransactionServer handler;
+  handler.set_bad_200(true);
+
+  ScopedMockTransaction transaction(kResumableGET_Transaction);
+
+  Context writer;
+  Context reader;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  std::string content;
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE,
+            CancelWriterWhileReading(&cache, transaction, &writer, &reader,
+                                     buf, 256, &content));
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+}
+
 // Tests that we can cancel requests that are queued waiting to open the disk
 // cache entry.
 TEST(HttpCache, SimpleGET_ManyWriters_CancelCreate) {
@@ -1664,6 +1878,43 @@ TEST(HttpCache, ETagGET_ConditionalRequest_304) {
   EXPECT_EQ(1, cache.disk_cache()->create_count());
 }
 
+// Tests that a stale entry with a stale-while-revalidate window is returned
+// right away, and validated in the background.
+TEST(HttpCache, ETagGET_StaleWhileRevalidate) {
+  MockHttpCache cache;
+
+  ScopedMockTransaction transaction(kETagGET_Transaction);
+  transaction.response_headers =
+      "Cache-Control: max-age=0, stale-while-revalidate=3600\n"
+      "Etag: \"foopy\"\n";
+
+  // Write to the cache.
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  // The stale entry is used without going to the network.
+  transaction.handler = ETagGet_ConditionalRequest_Handler;
+  net::HttpResponseInfo response;
+  RunTransactionTestWithResponseInfo(cache.http_cache(), transaction,
+                                     &response);
+  EXPECT_TRUE(response.was_cached);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  // Now the entry is validated, and updated with the headers of the 304.
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  // So the next request doesn't need a validation.
+  transaction.handler = NULL;
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
 static void ETagGet_UnconditionalRequest_Handler(
     const net::HttpRequestInfo* request,
     std::string* response_status,
@@ -4721,6 +4972,81 @@ TEST(HttpCache, UpdatesRequestResponseTimeOn304) {
   RemoveMockTransaction(&mock_network_response);
 }
 
+// Tests that a 304 updates the response stored in the cache, not only the one
+// returned to the caller.
+TEST(HttpCache, UpdatesStoredResponseOn304) {
+  MockHttpCache cache;
+
+  const char* kUrl = "http://foobar";
+  const char* kData = "body";
+
+  MockTransaction mock_network_response = { 0 };
+  mock_network_response.url = kUrl;
+
+  AddMockTransaction(&mock_network_response);
+
+  MockTransaction request = { 0 };
+  request.url = kUrl;
+  request.method = "GET";
+  request.request_headers = "";
+  request.data = kData;
+
+  static const Response kNetResponse1 = {
+    "HTTP/1.1 200 OK",
+    "Date: Fri, 12 Jun 2009 21:46:42 GMT\n"
+    "Last-Modified: Wed, 06 Feb 2008 22:38:21 GMT\n",
+    kData
+  };
+
+  kNetResponse1.AssignTo(&mock_network_response);
+
+  RunTransactionTest(cache.http_cache(), request);
+
+  // Validate the entry. The new Date header has the same size as the old one.
+  request.load_flags = net::LOAD_VALIDATE_CACHE;
+
+  static const Response kNetResponse2 = {
+    "HTTP/1.1 304 Not Modified",
+    "Date: Wed, 22 Jul 2009 03:15:26 GMT\n",
+    ""
+  };
+
+  kNetResponse2.AssignTo(&mock_network_response);
+
+  base::Time request_time = base::Time() + base::TimeDelta::FromHours(1234);
+  base::Time response_time = base::Time() + base::TimeDelta::FromHours(1235);
+
+  mock_network_response.request_time = request_time;
+  mock_network_response.response_time = response_time;
+
+  RunTransactionTest(cache.http_cache(), request);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+
+  // Now read the stored response.
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(kUrl, &entry));
+
+  net::HttpResponseInfo response;
+  bool truncated = true;
+  ASSERT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+  EXPECT_FALSE(truncated);
+  entry->Close();
+
+  EXPECT_EQ(request_time.ToInternalValue(),
+            response.request_time.ToInternalValue());
+  EXPECT_EQ(response_time.ToInternalValue(),
+            response.response_time.ToInternalValue());
+
+  std::string headers;
+  response.headers->GetNormalizedHeaders(&headers);
+  EXPECT_EQ("HTTP/1.1 200 OK\n"
+            "Date: Wed, 22 Jul 2009 03:15:26 GMT\n"
+            "Last-Modified: Wed, 06 Feb 2008 22:38:21 GMT\n",
+            headers);
+
+  RemoveMockTransaction(&mock_network_response);
+}
+
 // Tests that we can write metadata to an entry.
 TEST(HttpCache, WriteMetadata_OK) {
   MockHttpCache cache;
@@ -37,6 +37,7 @@ net::ClientSocketPoolManager* CreateSocketPoolManager(
       params.server_bound_cert_service,
       params.transport_security_state,
       params.ssl_session_cache_shard,
+      params.ssl_session_cache,
       params.proxy_service,
       params.ssl_config_service,
       pool_type);
@@ -53,6 +54,7 @@ HttpNetworkSession::Params::Params()
       server_bound_cert_service(NULL),
       transport_security_state(NULL),
       proxy_service(NULL),
+      ssl_session_cache(NULL),
       ssl_config_service(NULL),
       http_auth_handler_factory(NULL),
       network_delegate(NULL),
@@ -38,6 +38,7 @@ class ProxyService;
 class SOCKSClientSocketPool;
 class SSLClientSocketPool;
 class SSLConfigService;
+class SSLSessionCache;
 class TransportClientSocketPool;
 class TransportSecurityState;
 
@@ -56,6 +57,8 @@ class NET_EXPORT HttpNetworkSession
     TransportSecurityState* transport_security_state;
     ProxyService* proxy_service;
     std::string ssl_session_cache_shard;
+    // Optional. Shared by all the SSL socket pools of the session.
+    SSLSessionCache* ssl_session_cache;
     SSLConfigService* ssl_config_service;
     HttpAuthHandlerFactory* http_auth_handler_factory;
     NetworkDelegate* network_delegate;
@@ -99,6 +99,79 @@ bool ShouldUpdateHeader(const std::string::const_iterator& name_begin,
   return true;
 }
 
+// The names of the headers that are interned when headers are parsed, in
+// lowercase and sorted. The name id of a header is its index in this list.
+const char* const kInternedHeaderNames[] = {
+  "accept-ranges",
+  "access-control-allow-origin",
+  "age",
+  "cache-control",
+  "connection",
+  "content-disposition",
+  "content-encoding",
+  "content-language",
+  "content-length",
+  "content-location",
+  "content-md5",
+  "content-range",
+  "content-type",
+  "date",
+  "etag",
+  "expires",
+  "keep-alive",
+  "last-modified",
+  "location",
+  "p3p",
+  "pragma",
+  "proxy-authenticate",
+  "proxy-connection",
+  "public-key-pins",
+  "refresh",
+  "server",
+  "set-cookie",
+  "set-cookie2",
+  "strict-transport-security",
+  "trailer",
+  "transfer-encoding",
+  "upgrade",
+  "vary",
+  "via",
+  "www-authenticate",
+  "x-content-type-options",
+  "x-frame-options",
+  "x-xss-protection"
+};
+
+// The name id of headers that are not in kInternedHeaderNames.
+const int kUninternedHeaderId = -1;
+
+// Returns the name id of the header named [name_begin, name_end).
+int GetHeaderNameId(std::string::const_iterator name_begin,
+                    std::string::const_iterator name_end) {
+  int low = 0;
+  int high = static_cast<int>(arraysize(kInternedHeaderNames)) - 1;
+  while (low <= high) {
+    const int middle = (low + high) / 2;
+    const char* interned = kInternedHeaderNames[middle];
+    std::string::const_iterator it = name_begin;
+    while (it != name_end && *interned &&
+           base::ToLowerASCII(*it) == *interned) {
+      ++it;
+      ++interned;
+    }
+    if (it == name_end && !*interned)
+      return middle;
+    if (it == name_end ||
+        (*interned && static_cast<unsigned char>(base::ToLowerASCII(*it)) <
+                          static_cast<unsigned char>(*interned))) {
+      high = middle - 1;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return kUninternedHeaderId;
+}
+
 void CheckDoesNotHaveEmbededNulls(const std::string& str) {
   // Care needs to be taken when adding values to the raw headers string to
   // make sure it does not contain embeded NULLs. Any embeded '\0' may be
@@ -113,6 +186,8 @@ struct HttpResponseHeaders::ParsedHeader {
   // preceding header.  (Header values are comma separated.)
   bool is_continuation() const { return name_begin == name_end; }
 
+  // The index of the name in kInternedHeaderNames, or kUninternedHeaderId.
+  int name_id;
   std::string::const_iterator name_begin;
   std::string::const_iterator name_end;
   std::string::const_iterator value_begin;
@@ -152,12 +227,82 @@ HttpResponseHeaders::HttpResponseHeaders(const Pickle& pickle,
     Parse(raw_input);
 }
 
+HttpResponseHeaders::HttpResponseHeaders(const Pickle& pickle,
+                                         PickleIterator* iter,
+                                         PickleFormat format)
+    : response_code_(-1) {
+  std::string raw_input;
+  if (!pickle.ReadString(iter, &raw_input))
+    return;
+  if (format == PICKLE_RAW_HEADERS) {
+    Parse(raw_input);
+    return;
+  }
+
+  int num_offsets;
+  if (!pickle.ReadInt(iter, &num_offsets) || num_offsets < 0 ||
+      static_cast<size_t>(num_offsets) > raw_input.size() * 4) {
+    return;
+  }
+  std::vector<uint32> offsets(num_offsets);
+  for (int i = 0; i < num_offsets; ++i) {
+    if (!pickle.ReadUInt32(iter, &offsets[i]))
+      return;
+  }
+
+  if (!InitFromParsedForm(raw_input, offsets)) {
+    raw_headers_.clear();
+    parsed_.clear();
+    Parse(raw_input);
+  }
+}
+
 void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
   if (options == PERSIST_RAW) {
     pickle->WriteString(raw_headers_);
     return;  // Done.
   }
 
+  std::string blob;
+  GetPersistedHeaders(options, &blob, NULL);
+  pickle->WriteString(blob);
+}
+
+void HttpResponseHeaders::PersistParsed(Pickle* pickle,
+                                        PersistOptions options) {
+  std::string blob;
+  std::vector<uint32> offsets;
+  GetPersistedHeaders(options, &blob, &offsets);
+  pickle->WriteString(blob);
+  pickle->WriteInt(static_cast<int>(offsets.size()));
+  for (size_t i = 0; i < offsets.size(); ++i)
+    pickle->WriteUInt32(offsets[i]);
+}
+
+void HttpResponseHeaders::GetPersistedHeaders(
+    PersistOptions options,
+    std::string* blob,
+    std::vector<uint32>* offsets) const {
+  // Each entry of parsed_ is stored as four offsets: the beginning and end of
+  // its name, which are both 0 for continuations, and of its value.
+  const std::string::const_iterator raw_begin = raw_headers_.begin();
+  if (offsets)
+    offsets->reserve(parsed_.size() * 4);
+
+  if (options == PERSIST_RAW) {
+    *blob = raw_headers_;
+    for (size_t i = 0; offsets && i < parsed_.size(); ++i) {
+      const ParsedHeader& header = parsed_[i];
+      offsets->push_back(header.is_continuation() ?
+                         0 : header.name_begin - raw_begin);
+      offsets->push_back(header.is_continuation() ?
+                         0 : header.name_end - raw_begin);
+      offsets->push_back(header.value_begin - raw_begin);
+      offsets->push_back(header.value_end - raw_begin);
+    }
+    return;
+  }
+
   HeaderSet filter_headers;
 
   // Construct set of headers to filter out based on options.
@@ -179,13 +324,13 @@ void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
   if ((options & PERSIST_SANS_SECURITY_STATE) == PERSIST_SANS_SECURITY_STATE)
     AddSecurityStateHeaders(&filter_headers);
 
-  std::string blob;
-  blob.reserve(raw_headers_.size());
+  blob->clear();
+  blob->reserve(raw_headers_.size());
 
   // This copies the status line w/ terminator null.
   // Note raw_headers_ has embedded nulls instead of \n,
   // so this just copies the first header line.
-  blob.assign(raw_headers_.c_str(), strlen(raw_headers_.c_str()) + 1);
+  blob->assign(raw_headers_.c_str(), strlen(raw_headers_.c_str()) + 1);
 
   for (size_t i = 0; i < parsed_.size(); ++i) {
     DCHECK(!parsed_[i].is_continuation());
@@ -195,20 +340,32 @@ void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
     while (++k < parsed_.size() && parsed_[k].is_continuation()) {}
     --k;
 
-    std::string header_name(parsed_[i].name_begin, parsed_[i].name_end);
-    StringToLowerASCII(&header_name);
+    if (filter_headers.find(GetLowerCaseName(i)) == filter_headers.end()) {
+      if (offsets) {
+        // The header moves from name_begin to the end of |blob|.
+        const size_t header_begin = parsed_[i].name_begin - raw_begin;
+        const size_t moved_begin = blob->size();
+        for (size_t j = i; j <= k; ++j) {
+          const ParsedHeader& header = parsed_[j];
+          offsets->push_back(header.is_continuation() ? 0 :
+              header.name_begin - raw_begin - header_begin + moved_begin);
+          offsets->push_back(header.is_continuation() ? 0 :
+              header.name_end - raw_begin - header_begin + moved_begin);
+          offsets->push_back(
+              header.value_begin - raw_begin - header_begin + moved_begin);
+          offsets->push_back(
+              header.value_end - raw_begin - header_begin + moved_begin);
+        }
+      }
 
-    if (filter_headers.find(header_name) == filter_headers.end()) {
       // Make sure there is a null after the value.
-      blob.append(parsed_[i].name_begin, parsed_[k].value_end);
-      blob.push_back('\0');
+      blob->append(parsed_[i].name_begin, parsed_[k].value_end);
+      blob->push_back('\0');
     }
 
     i = k;
   }
-  blob.push_back('\0');
-
-  pickle->WriteString(blob);
+  blob->push_back('\0');
 }
 
 void HttpResponseHeaders::Update(const HttpResponseHeaders& new_headers) {
@@ -238,9 +395,7 @@ void HttpResponseHeaders::Update(const HttpResponseHeaders& new_headers) {
     const std::string::const_iterator& name_begin = new_parsed[i].name_begin;
     const std::string::const_iterator& name_end = new_parsed[i].name_end;
     if (ShouldUpdateHeader(name_begin, name_end)) {
-      std::string name(name_begin, name_end);
-      StringToLowerASCII(&name);
-      updated_headers.insert(name);
+      updated_headers.insert(new_headers.GetLowerCaseName(i));
 
       // Preserve this header line in the merged result, making sure there is
       // a null after the value.
@@ -266,9 +421,8 @@ void HttpResponseHeaders::MergeWithHeaders(const std::string& raw_headers,
     while (++k < parsed_.size() && parsed_[k].is_continuation()) {}
     --k;
 
-    std::string name(parsed_[i].name_begin, parsed_[i].name_end);
-    StringToLowerASCII(&name);
-    if (headers_to_remove.find(name) == headers_to_remove.end()) {
+    if (headers_to_remove.find(GetLowerCaseName(i)) ==
+        headers_to_remove.end()) {
       // It's ok to preserve this header in the final result.
       new_raw_headers.append(parsed_[i].name_begin, parsed_[k].value_end);
       new_raw_headers.push_back('\0');
@@ -410,6 +564,61 @@ void HttpResponseHeaders::Parse(const std::string& raw_input) {
   DCHECK_EQ('\0', raw_headers_[raw_headers_.size() - 1]);
 }
 
+bool HttpResponseHeaders::InitFromParsedForm(
+    const std::string& raw_input,
+    const std::vector<uint32>& offsets) {
+  // Like raw_headers_, the input must hold a status line and end with a
+  // double null.
+  const size_t size = raw_input.size();
+  const size_t status_line_end = raw_input.find('\0');
+  if (size < 2 || raw_input[size - 2] != '\0' ||
+      raw_input[size - 1] != '\0' || offsets.size() % 4 != 0) {
+    return false;
+  }
+
+  // The stored status line is already normalized, so parsing it again must
+  // reproduce it.
+  const bool has_headers = raw_input[status_line_end + 1] != '\0';
+  ParseStatusLine(raw_input.begin(), raw_input.begin() + status_line_end,
+                  has_headers);
+  if (raw_headers_.compare(0, std::string::npos, raw_input, 0,
+                           status_line_end) != 0) {
+    return false;
+  }
+
+  raw_headers_ = raw_input;
+  const std::string::const_iterator raw_begin = raw_headers_.begin();
+  parsed_.reserve(offsets.size() / 4);
+  for (size_t i = 0; i < offsets.size(); i += 4) {
+    const uint32 name_begin = offsets[i];
+    const uint32 name_end = offsets[i + 1];
+    const uint32 value_begin = offsets[i + 2];
+    const uint32 value_end = offsets[i + 3];
+    const bool is_continuation = name_begin == name_end;
+    // Everything must lie between the status line and the final null, and
+    // the first entry must start a header.
+    if ((is_continuation && parsed_.empty()) ||
+        (!is_continuation && name_begin <= status_line_end) ||
+        name_begin > name_end || name_end > value_begin ||
+        value_begin <= status_line_end || value_begin > value_end ||
+        value_end >= size) {
+      return false;
+    }
+
+    if (is_continuation) {
+      AddToParsed(raw_headers_.end(), raw_headers_.end(),
+                  raw_begin + value_begin, raw_begin + value_end,
+                  kUninternedHeaderId);
+    } else {
+      AddToParsed(raw_begin + name_begin, raw_begin + name_end,
+                  raw_begin + value_begin, raw_begin + value_end,
+                  GetHeaderNameId(raw_begin + name_begin,
+                                  raw_begin + name_end));
+    }
+  }
+  return true;
+}
+
 // Append all of our headers to the final output string.
 void HttpResponseHeaders::GetNormalizedHeaders(std::string* output) const {
   // copy up to the null byte.  this just copies the status line.
@@ -436,7 +645,7 @@ void HttpResponseHeaders::GetNormalizedHeaders(std::string* output) const {
     DCHECK(!parsed_[i].is_continuation());
 
     std::string name(parsed_[i].name_begin, parsed_[i].name_end);
-    std::string lower_name = StringToLowerASCII(name);
+    std::string lower_name = GetLowerCaseName(i);
 
     iter = headers_map.find(lower_name);
     if (iter == headers_map.end()) {
@@ -700,9 +909,12 @@ void HttpResponseHeaders::ParseStatusLine(
 
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const std::string& search) const {
+  const int search_id = GetHeaderNameId(search.begin(), search.end());
   for (size_t i = from; i < parsed_.size(); ++i) {
-    if (parsed_[i].is_continuation())
+    if (parsed_[i].is_continuation() || parsed_[i].name_id != search_id)
       continue;
+    if (search_id != kUninternedHeaderId)
+      return i;
     const std::string::const_iterator& name_begin = parsed_[i].name_begin;
     const std::string::const_iterator& name_end = parsed_[i].name_end;
     if (static_cast<size_t>(name_end - name_begin) == search.size() &&
@@ -714,20 +926,30 @@ size_t HttpResponseHeaders::FindHeader(size_t from,
   return std::string::npos;
 }
 
+std::string HttpResponseHeaders::GetLowerCaseName(size_t index) const {
+  const ParsedHeader& header = parsed_[index];
+  if (header.name_id != kUninternedHeaderId)
+    return kInternedHeaderNames[header.name_id];
+  return StringToLowerASCII(std::string(header.name_begin, header.name_end));
+}
+
 void HttpResponseHeaders::AddHeader(std::string::const_iterator name_begin,
                                     std::string::const_iterator name_end,
                                     std::string::const_iterator values_begin,
                                     std::string::const_iterator values_end) {
+  int name_id = GetHeaderNameId(name_begin, name_end);
   // If the header can be coalesced, then we should split it up.
   if (values_begin == values_end ||
       HttpUtil::IsNonCoalescingHeader(name_begin, name_end)) {
-    AddToParsed(name_begin, name_end, values_begin, values_end);
+    AddToParsed(name_begin, name_end, values_begin, values_end, name_id);
   } else {
     HttpUtil::ValuesIterator it(values_begin, values_end, ',');
     while (it.GetNext()) {
-      AddToParsed(name_begin, name_end, it.value_begin(), it.value_end());
+      AddToParsed(name_begin, name_end, it.value_begin(), it.value_end(),
+                  name_id);
       // clobber these so that subsequent values are treated as continuations
       name_begin = name_end = raw_headers_.end();
+      name_id = kUninternedHeaderId;
     }
   }
 }
@@ -735,8 +957,10 @@ void HttpResponseHeaders::AddHeader(std::string::const_iterator name_begin,
 void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
                                       std::string::const_iterator name_end,
                                       std::string::const_iterator value_begin,
-                                      std::string::const_iterator value_end) {
+                                      std::string::const_iterator value_end,
+                                      int name_id) {
   ParsedHeader header;
+  header.name_id = name_id;
   header.name_begin = name_begin;
   header.name_end = name_end;
   header.value_begin = value_begin;
@@ -744,6 +968,41 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
   parsed_.push_back(header);
 }
 
+bool HttpResponseHeaders::HasNoCacheHeaders() const {
+  // For backwards compat, we treat "Pragma: no-cache" as a synonym for
+  // "Cache-Control: no-cache" even though RFC 2616 does not specify it.
+  return HasHeaderValue("cache-control", "no-cache") ||
+         HasHeaderValue("cache-control", "no-store") ||
+         HasHeaderValue("pragma", "no-cache") ||
+         HasHeaderValue("vary", "*");  // see RFC 2616 section 13.6
+}
+
+bool HttpResponseHeaders::GetCacheControlDirective(const char* directive,
+                                                   TimeDelta* result) const {
+  std::string name = "cache-control";
+  std::string value;
+
+  std::string prefix = std::string(directive) + "=";
+
+  void* iter = NULL;
+  while (EnumerateHeader(&iter, name, &value)) {
+    if (value.size() > prefix.size()) {
+      if (LowerCaseEqualsASCII(value.begin(),
+                               value.begin() + prefix.size(),
+                               prefix.c_str())) {
+        int64 seconds;
+        base::StringToInt64(StringPiece(value.begin() + prefix.size(),
+                                        value.end()),
+                            &seconds);
+        *result = TimeDelta::FromSeconds(seconds);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
 void HttpResponseHeaders::AddNonCacheableHeaders(HeaderSet* result) const {
   // Add server specified transients.  Any 'cache-control: no-cache="foo,bar"'
   // headers present in the response specify additional headers that we should
@@ -919,13 +1178,7 @@ bool HttpResponseHeaders::RequiresValidation(const Time& request_time,
 //
 TimeDelta HttpResponseHeaders::GetFreshnessLifetime(
     const Time& response_time) const {
-  // Check for headers that force a response to never be fresh.  For backwards
-  // compat, we treat "Pragma: no-cache" as a synonym for "Cache-Control:
-  // no-cache" even though RFC 2616 does not specify it.
-  if (HasHeaderValue("cache-control", "no-cache") ||
-      HasHeaderValue("cache-control", "no-store") ||
-      HasHeaderValue("pragma", "no-cache") ||
-      HasHeaderValue("vary", "*"))  // see RFC 2616 section 13.6
+  if (HasNoCacheHeaders())
     return TimeDelta();  // not fresh
 
   // NOTE: "Cache-Control: max-age" overrides Expires, so we only check the
@@ -1042,30 +1295,44 @@ TimeDelta HttpResponseHeaders::GetCurrentAge(const Time& request_time,
   return current_age;
 }
 
-bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
-  std::string name = "cache-control";
-  std::string value;
-
-  const char kMaxAgePrefix[] = "max-age=";
-  const size_t kMaxAgePrefixLen = arraysize(kMaxAgePrefix) - 1;
+// From RFC 5861 section 3:
+//
+//   When present in an HTTP response, the stale-while-revalidate Cache-Control
+//   extension indicates that caches MAY serve the response in which it
+//   appears after it becomes stale, up to the indicated number of seconds.
+//
+// Headers that force every use of the response to be validated, and
+// must-revalidate (see RFC 2616 section 14.9.4), still take priority.
+//
+bool HttpResponseHeaders::CanUseStaleWhileRevalidate(
+    const Time& request_time,
+    const Time& response_time,
+    const Time& current_time) const {
+  TimeDelta stale_while_revalidate;
+  if (!GetStaleWhileRevalidateValue(&stale_while_revalidate) ||
+      stale_while_revalidate <= TimeDelta()) {
+    return false;
+  }
 
-  void* iter = NULL;
-  while (EnumerateHeader(&iter, name, &value)) {
-    if (value.size() > kMaxAgePrefixLen) {
-      if (LowerCaseEqualsASCII(value.begin(),
-                               value.begin() + kMaxAgePrefixLen,
-                               kMaxAgePrefix)) {
-        int64 seconds;
-        base::StringToInt64(StringPiece(value.begin() + kMaxAgePrefixLen,
-                                        value.end()),
-                            &seconds);
-        *result = TimeDelta::FromSeconds(seconds);
-        return true;
-      }
-    }
+  if (HasNoCacheHeaders() ||
+      HasHeaderValue("cache-control", "must-revalidate") ||
+      HasHeaderValue("cache-control", "proxy-revalidate")) {
+    return false;
   }
 
-  return false;
+  TimeDelta staleness =
+      GetCurrentAge(request_time, response_time, current_time) -
+      GetFreshnessLifetime(response_time);
+  return staleness < stale_while_revalidate;
+}
+
+bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
+  return GetCacheControlDirective("max-age", result);
+}
+
+bool HttpResponseHeaders::GetStaleWhileRevalidateValue(
+    TimeDelta* result) const {
+  return GetCacheControlDirective("stale-while-revalidate", result);
 }
 
 bool HttpResponseHeaders::GetAgeValue(TimeDelta* result) const {
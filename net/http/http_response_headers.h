@@ -40,6 +40,12 @@ class NET_EXPORT HttpResponseHeaders
   static const PersistOptions PERSIST_SANS_RANGES = 1 << 4;
   static const PersistOptions PERSIST_SANS_SECURITY_STATE = 1 << 5;
 
+  // The formats in which headers can be stored in a pickle.
+  enum PickleFormat {
+    PICKLE_RAW_HEADERS,     // Written by Persist().
+    PICKLE_PARSED_HEADERS,  // Written by PersistParsed().
+  };
+
   // Parses the given raw_headers.  raw_headers should be formatted thus:
   // includes the http status response line, each line is \0-terminated, and
   // it's terminated by an empty line (ie, 2 \0s in a row).
@@ -55,10 +61,20 @@ class NET_EXPORT HttpResponseHeaders
   // be passed to the pickle's various Read* methods.
   HttpResponseHeaders(const Pickle& pickle, PickleIterator* pickle_iter);
 
+  // Like the above, but reads a pickle in the given |format|.
+  HttpResponseHeaders(const Pickle& pickle,
+                      PickleIterator* pickle_iter,
+                      PickleFormat format);
+
   // Appends a representation of this object to the given pickle.
   // The options argument can be a combination of PersistOptions.
   void Persist(Pickle* pickle, PersistOptions options);
 
+  // Like Persist(), but also appends where each header name and value lies
+  // in the persisted headers, so that they can be restored without being
+  // parsed again. The result must be read with PICKLE_PARSED_HEADERS.
+  void PersistParsed(Pickle* pickle, PersistOptions options);
+
   // Performs header merging as described in 13.5.3 of RFC 2616.
   void Update(const HttpResponseHeaders& new_headers);
 
@@ -206,10 +222,19 @@ class NET_EXPORT HttpResponseHeaders
                                 const base::Time& response_time,
                                 const base::Time& current_time) const;
 
+  // Returns true if the response is stale, but it can still be used while it
+  // is revalidated in the background, as allowed by the
+  // "Cache-Control: stale-while-revalidate" extension of RFC 5861.  See
+  // RequiresValidation for a description of this method's parameters.
+  bool CanUseStaleWhileRevalidate(const base::Time& request_time,
+                                  const base::Time& response_time,
+                                  const base::Time& current_time) const;
+
   // The following methods extract values from the response headers.  If a
   // value is not present, then false is returned.  Otherwise, true is returned
   // and the out param is assigned to the corresponding value.
   bool GetMaxAgeValue(base::TimeDelta* value) const;
+  bool GetStaleWhileRevalidateValue(base::TimeDelta* value) const;
   bool GetAgeValue(base::TimeDelta* value) const;
   bool GetDateValue(base::Time* value) const;
   bool GetLastModifiedValue(base::Time* value) const;
@@ -279,6 +304,23 @@ class NET_EXPORT HttpResponseHeaders
   // Initializes from the given raw headers.
   void Parse(const std::string& raw_input);
 
+  // Initializes from headers written by PersistParsed(): |raw_input| holds
+  // the headers and |offsets| the position of each entry of parsed_ in them.
+  // Returns false, leaving this object partly initialized, if they are not
+  // consistent.
+  bool InitFromParsedForm(const std::string& raw_input,
+                          const std::vector<uint32>& offsets);
+
+  // Sets |blob| to the headers to persist with |options|. If |offsets| is
+  // not NULL, it is set to the positions in |blob| of the name and value of
+  // every entry of parsed_ that is kept.
+  void GetPersistedHeaders(PersistOptions options,
+                           std::string* blob,
+                           std::vector<uint32>* offsets) const;
+
+  // Returns the lowercase name of the header at |index| in parsed_.
+  std::string GetLowerCaseName(size_t index) const;
+
   // Helper function for ParseStatusLine.
   // Tries to extract the "HTTP/X.Y" from a status line formatted like:
   //    HTTP/1.1 200 OK
@@ -312,7 +354,8 @@ class NET_EXPORT HttpResponseHeaders
   void AddToParsed(std::string::const_iterator name_begin,
                    std::string::const_iterator name_end,
                    std::string::const_iterator value_begin,
-                   std::string::const_iterator value_end);
+                   std::string::const_iterator value_end,
+                   int name_id);
 
   // Replaces the current headers with the merged version of |raw_headers| and
   // the current headers without the headers in |headers_to_remove|. Note that
@@ -321,6 +364,14 @@ class NET_EXPORT HttpResponseHeaders
   void MergeWithHeaders(const std::string& raw_headers,
                         const HeaderSet& headers_to_remove);
 
+  // Returns true if there are headers that force the response to never be
+  // fresh.
+  bool HasNoCacheHeaders() const;
+
+  // Extracts the value of a 'cache-control: <directive>=<seconds>' header.
+  bool GetCacheControlDirective(const char* directive,
+                                base::TimeDelta* value) const;
+
   // Adds the values from any 'cache-control: no-cache="foo,bar"' headers.
   void AddNonCacheableHeaders(HeaderSet* header_names) const;
 
@@ -343,7 +394,8 @@ class NET_EXPORT HttpResponseHeaders
   static void AddSecurityStateHeaders(HeaderSet* header_names);
 
   // We keep a list of ParsedHeader objects.  These tell us where to locate the
-  // header-value pairs within raw_headers_.
+  // header-value pairs within raw_headers_, and identify common header names
+  // by a small integer so that looking them up does not compare strings.
   HeaderList parsed_;
 
   // The raw_headers_ consists of the normalized status line (terminated with a
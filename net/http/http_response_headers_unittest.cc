@@ -484,9 +484,93 @@ TEST(HttpResponseHeadersTest, Persist) {
     std::string h2;
     parsed2->GetNormalizedHeaders(&h2);
     EXPECT_EQ(std::string(tests[i].expected_headers), h2);
+
+    // The parsed form must restore the same headers.
+    Pickle parsed_pickle;
+    parsed1->PersistParsed(&parsed_pickle, tests[i].options);
+
+    PickleIterator parsed_iter(parsed_pickle);
+    scoped_refptr<net::HttpResponseHeaders> parsed3(
+        new net::HttpResponseHeaders(
+            parsed_pickle, &parsed_iter,
+            net::HttpResponseHeaders::PICKLE_PARSED_HEADERS));
+
+    std::string h3;
+    parsed3->GetNormalizedHeaders(&h3);
+    EXPECT_EQ(std::string(tests[i].expected_headers), h3);
   }
 }
 
+TEST(HttpResponseHeadersTest, PersistParsedKeepsValues) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "Cache-control: private, max-age=60\n"
+      "X-Custom: a, b\n"
+      "Content-Length: 10\n"
+      "set-cookie: foo=bar\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<net::HttpResponseHeaders> parsed1(
+      new net::HttpResponseHeaders(headers));
+
+  Pickle pickle;
+  parsed1->PersistParsed(&pickle, net::HttpResponseHeaders::PERSIST_RAW);
+  PickleIterator iter(pickle);
+  scoped_refptr<net::HttpResponseHeaders> parsed2(
+      new net::HttpResponseHeaders(
+          pickle, &iter, net::HttpResponseHeaders::PICKLE_PARSED_HEADERS));
+
+  EXPECT_EQ(200, parsed2->response_code());
+  EXPECT_EQ(10, parsed2->GetContentLength());
+  EXPECT_TRUE(parsed2->HasHeaderValue("cache-control", "max-age=60"));
+  EXPECT_TRUE(parsed2->HasHeaderValue("x-custom", "b"));
+  std::string value;
+  EXPECT_TRUE(parsed2->GetNormalizedHeader("Set-Cookie", &value));
+  EXPECT_EQ("foo=bar", value);
+}
+
+TEST(HttpResponseHeadersTest, PersistParsedCorruptOffsets) {
+  std::string headers = "HTTP/1.1 200 OK\nContent-Length: 10\n";
+  HeadersToRaw(&headers);
+
+  // Offsets that point past the headers are ignored and the headers are
+  // parsed instead.
+  Pickle pickle;
+  pickle.WriteString(headers);
+  pickle.WriteInt(4);
+  pickle.WriteUInt32(16);
+  pickle.WriteUInt32(30);
+  pickle.WriteUInt32(32);
+  pickle.WriteUInt32(1000);
+  PickleIterator iter(pickle);
+  scoped_refptr<net::HttpResponseHeaders> parsed(
+      new net::HttpResponseHeaders(
+          pickle, &iter, net::HttpResponseHeaders::PICKLE_PARSED_HEADERS));
+
+  EXPECT_EQ(200, parsed->response_code());
+  EXPECT_EQ(10, parsed->GetContentLength());
+}
+
+TEST(HttpResponseHeadersTest, FindHeaderIgnoresCase) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "CONTENT-type: text/html\n"
+      "X-Mixed-Case: yes\n"
+      "Content-Typ: no\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<net::HttpResponseHeaders> parsed(
+      new net::HttpResponseHeaders(headers));
+
+  std::string value;
+  EXPECT_TRUE(parsed->GetNormalizedHeader("content-TYPE", &value));
+  EXPECT_EQ("text/html", value);
+  EXPECT_TRUE(parsed->GetNormalizedHeader("x-mixed-case", &value));
+  EXPECT_EQ("yes", value);
+  EXPECT_TRUE(parsed->GetNormalizedHeader("Content-Typ", &value));
+  EXPECT_EQ("no", value);
+  EXPECT_FALSE(parsed->HasHeader("content-types"));
+  EXPECT_FALSE(parsed->HasHeader("x-mixed"));
+}
+
 TEST(HttpResponseHeadersTest, EnumerateHeader_Coalesced) {
   // Ensure that commas in quoted strings are not regarded as value separators.
   // Ensure that whitespace following a value is trimmed properly
@@ -842,6 +926,69 @@ TEST(HttpResponseHeadersTest, RequiresValidation) {
   }
 }
 
+TEST(HttpResponseHeadersTest, CanUseStaleWhileRevalidate) {
+  const struct {
+    const char* headers;
+    bool can_use_stale;
+  } tests[] = {
+    // stale for about 5 minutes, inside the window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10, stale-while-revalidate=600\n"
+      "\n",
+      true
+    },
+    // the directives may come from different headers
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10\n"
+      "cache-control: stale-while-revalidate=600\n"
+      "\n",
+      true
+    },
+    // outside of the window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10, stale-while-revalidate=60\n"
+      "\n",
+      false
+    },
+    // no window at all
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10\n"
+      "\n",
+      false
+    },
+    // must-revalidate forbids using stale responses
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10, stale-while-revalidate=600\n"
+      "cache-control: must-revalidate\n"
+      "\n",
+      false
+    },
+    // no-cache requires validation of every use
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: no-cache, stale-while-revalidate=600\n"
+      "\n",
+      false
+    },
+  };
+  base::Time request_time, response_time, current_time;
+  base::Time::FromString("Wed, 28 Nov 2007 00:40:09 GMT", &request_time);
+  base::Time::FromString("Wed, 28 Nov 2007 00:40:12 GMT", &response_time);
+  base::Time::FromString("Wed, 28 Nov 2007 00:45:20 GMT", &current_time);
+
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(tests); ++i) {
+    std::string headers(tests[i].headers);
+    HeadersToRaw(&headers);
+    scoped_refptr<net::HttpResponseHeaders> parsed(
+        new net::HttpResponseHeaders(headers));
+
+    EXPECT_TRUE(parsed->RequiresValidation(request_time, response_time,
+                                           current_time));
+    EXPECT_EQ(tests[i].can_use_stale,
+              parsed->CanUseStaleWhileRevalidate(request_time, response_time,
+                                                 current_time)) << i;
+  }
+}
+
 TEST(HttpResponseHeadersTest, Update) {
   const struct {
     const char* orig_headers;
@@ -27,6 +27,7 @@ X509Certificate::PickleType GetPickleTypeForVersion(int version) {
     case 2:
       return X509Certificate::PICKLETYPE_CERTIFICATE_CHAIN_V2;
     case 3:
+    case 4:
     default:
       return X509Certificate::PICKLETYPE_CERTIFICATE_CHAIN_V3;
   }
@@ -38,7 +39,9 @@ X509Certificate::PickleType GetPickleTypeForVersion(int version) {
 // serialized HttpResponseInfo.
 enum {
   // The version of the response info used when persisting response info.
-  RESPONSE_INFO_VERSION = 3,
+  // Version 4 added RESPONSE_INFO_HAS_PARSED_HEADERS, which older readers do
+  // not understand.
+  RESPONSE_INFO_VERSION = 4,
 
   // The minimum version supported for deserializing response info.
   RESPONSE_INFO_MINIMUM_VERSION = 1,
@@ -81,6 +84,10 @@ enum {
   // This bit is set if the response info has protocol version.
   RESPONSE_INFO_HAS_NPN_NEGOTIATED_PROTOCOL = 1 << 17,
 
+  // This bit is set if the headers were persisted along with the offsets of
+  // their parsed form, see HttpResponseHeaders::PersistParsed().
+  RESPONSE_INFO_HAS_PARSED_HEADERS = 1 << 18,
+
   // TODO(darin): Add other bits to indicate alternate request methods.
   // For now, we don't support storing those.
 };
@@ -158,7 +165,11 @@ bool HttpResponseInfo::InitFromPickle(const Pickle& pickle,
   response_time = Time::FromInternalValue(time_val);
 
   // read response-headers
-  headers = new HttpResponseHeaders(pickle, &iter);
+  headers = new HttpResponseHeaders(
+      pickle, &iter,
+      (flags & RESPONSE_INFO_HAS_PARSED_HEADERS) ?
+          HttpResponseHeaders::PICKLE_PARSED_HEADERS :
+          HttpResponseHeaders::PICKLE_RAW_HEADERS);
   if (headers->response_code() == -1)
     return false;
 
@@ -229,7 +240,7 @@ bool HttpResponseInfo::InitFromPickle(const Pickle& pickle,
 void HttpResponseInfo::Persist(Pickle* pickle,
                                bool skip_transient_headers,
                                bool response_truncated) const {
-  int flags = RESPONSE_INFO_VERSION;
+  int flags = RESPONSE_INFO_VERSION | RESPONSE_INFO_HAS_PARSED_HEADERS;
   if (ssl_info.is_valid()) {
     flags |= RESPONSE_INFO_HAS_CERT;
     flags |= RESPONSE_INFO_HAS_CERT_STATUS;
@@ -268,7 +279,7 @@ void HttpResponseInfo::Persist(Pickle* pickle,
         net::HttpResponseHeaders::PERSIST_SANS_SECURITY_STATE;
   }
 
-  headers->Persist(pickle, persist_options);
+  headers->PersistParsed(pickle, persist_options);
 
   if (ssl_info.is_valid()) {
     ssl_info.cert->Persist(pickle);
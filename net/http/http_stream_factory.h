@@ -182,6 +182,15 @@ class NET_EXPORT HttpStreamFactory {
                                  const SSLConfig& server_ssl_config,
                                  const SSLConfig& proxy_ssl_config) = 0;
 
+  // Warms up a connection to each of |origins|, using |info| as the template
+  // for the preconnect requests.  One connection is opened per origin, which
+  // is all a SPDY server needs; an origin whose address and certificate are
+  // covered by an existing SpdySession is skipped once its host is resolved.
+  virtual void PreconnectOrigins(const std::vector<GURL>& origins,
+                                 const HttpRequestInfo& info,
+                                 const SSLConfig& server_ssl_config,
+                                 const SSLConfig& proxy_ssl_config) = 0;
+
   // If pipelining is supported, creates a Value summary of the currently active
   // pipelines. Caller assumes ownership of the returned value. Otherwise,
   // returns an empty Value.
@@ -119,6 +119,21 @@ void HttpStreamFactoryImpl::PreconnectStreams(
   job->Preconnect(num_streams);
 }
 
+void HttpStreamFactoryImpl::PreconnectOrigins(
+    const std::vector<GURL>& origins,
+    const HttpRequestInfo& info,
+    const SSLConfig& server_ssl_config,
+    const SSLConfig& proxy_ssl_config) {
+  HttpRequestInfo request_info = info;
+  for (std::vector<GURL>::const_iterator it = origins.begin();
+       it != origins.end(); ++it) {
+    if (!it->is_valid())
+      continue;
+    request_info.url = it->GetOrigin();
+    PreconnectStreams(1, request_info, server_ssl_config, proxy_ssl_config);
+  }
+}
+
 base::Value* HttpStreamFactoryImpl::PipelineInfoToValue() const {
   return http_pipelined_host_pool_.PipelineInfoToValue();
 }
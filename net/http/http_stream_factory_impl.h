@@ -42,6 +42,10 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl :
                                  const HttpRequestInfo& info,
                                  const SSLConfig& server_ssl_config,
                                  const SSLConfig& proxy_ssl_config) OVERRIDE;
+  virtual void PreconnectOrigins(const std::vector<GURL>& origins,
+                                 const HttpRequestInfo& info,
+                                 const SSLConfig& server_ssl_config,
+                                 const SSLConfig& proxy_ssl_config) OVERRIDE;
   virtual base::Value* PipelineInfoToValue() const OVERRIDE;
   virtual const HostMappingRules* GetHostMappingRules() const OVERRIDE;
 
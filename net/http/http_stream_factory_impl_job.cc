@@ -723,6 +723,14 @@ int HttpStreamFactoryImpl::Job::DoInitConnection() {
     InitSSLConfig(origin_, &server_ssl_config_);
   }
 
+  // If we can't use a SPDY session, don't both checking for one after
+  // the hostname is resolved.  Preconnects check too, so that warming up an
+  // origin which turns out to share an address and certificate with an
+  // existing SpdySession doesn't cost an extra handshake.
+  OnHostResolutionCallback resolution_callback = CanUseExistingSpdySession() ?
+      base::Bind(&Job::OnHostResolution, session_->spdy_session_pool(),
+                 GetSpdySessionKey()) :
+      OnHostResolutionCallback();
   if (IsPreconnecting()) {
     return PreconnectSocketsForHttpRequest(
         origin_url_,
@@ -736,14 +744,9 @@ int HttpStreamFactoryImpl::Job::DoInitConnection() {
         server_ssl_config_,
         proxy_ssl_config_,
         net_log_,
-        num_streams_);
+        num_streams_,
+        resolution_callback);
   } else {
-    // If we can't use a SPDY session, don't both checking for one after
-    // the hostname is resolved.
-    OnHostResolutionCallback resolution_callback = CanUseExistingSpdySession() ?
-        base::Bind(&Job::OnHostResolution, session_->spdy_session_pool(),
-                   GetSpdySessionKey()) :
-        OnHostResolutionCallback();
     return InitSocketHandleForHttpRequest(
         origin_url_, request_info_.extra_headers, request_info_.load_flags,
         request_info_.priority, session_, proxy_info_, ShouldForceSpdySSL(),
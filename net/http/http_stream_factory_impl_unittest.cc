@@ -5,6 +5,7 @@
 #include "net/http/http_stream_factory_impl.h"
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "net/base/mock_cert_verifier.h"
@@ -34,28 +35,34 @@ class MockHttpStreamFactoryImpl : public HttpStreamFactoryImpl {
  public:
   MockHttpStreamFactoryImpl(HttpNetworkSession* session)
       : HttpStreamFactoryImpl(session),
-        preconnect_done_(false),
-        waiting_for_preconnect_(false) {}
+        num_preconnects_done_(0),
+        num_preconnects_to_wait_for_(0) {}
 
 
   void WaitForPreconnects() {
-    while (!preconnect_done_) {
-      waiting_for_preconnect_ = true;
+    WaitForNumPreconnects(1);
+  }
+
+  void WaitForNumPreconnects(int num_preconnects) {
+    while (num_preconnects_done_ < num_preconnects) {
+      num_preconnects_to_wait_for_ = num_preconnects;
       MessageLoop::current()->Run();
-      waiting_for_preconnect_ = false;
+      num_preconnects_to_wait_for_ = 0;
     }
   }
 
  private:
   // HttpStreamFactoryImpl methods.
   virtual void OnPreconnectsCompleteInternal() OVERRIDE {
-    preconnect_done_ = true;
-    if (waiting_for_preconnect_)
+    ++num_preconnects_done_;
+    if (num_preconnects_to_wait_for_ &&
+        num_preconnects_done_ >= num_preconnects_to_wait_for_) {
       MessageLoop::current()->Quit();
+    }
   }
 
-  bool preconnect_done_;
-  bool waiting_for_preconnect_;
+  int num_preconnects_done_;
+  int num_preconnects_to_wait_for_;
 };
 
 class StreamRequestWaiter : public HttpStreamRequest::Delegate {
@@ -198,6 +205,10 @@ class CapturePreconnectsSocketPool : public ParentPool {
     return last_num_streams_;
   }
 
+  int num_preconnect_requests() const {
+    return num_preconnect_requests_;
+  }
+
   virtual int RequestSocket(const std::string& group_name,
                             const void* socket_params,
                             RequestPriority priority,
@@ -213,6 +224,7 @@ class CapturePreconnectsSocketPool : public ParentPool {
                               int num_sockets,
                               const BoundNetLog& net_log) OVERRIDE {
     last_num_streams_ = num_sockets;
+    ++num_preconnect_requests_;
   }
 
   virtual void CancelRequest(const std::string& group_name,
@@ -248,6 +260,7 @@ class CapturePreconnectsSocketPool : public ParentPool {
 
  private:
   int last_num_streams_;
+  int num_preconnect_requests_;
 };
 
 typedef CapturePreconnectsSocketPool<TransportClientSocketPool>
@@ -263,20 +276,24 @@ template<typename ParentPool>
 CapturePreconnectsSocketPool<ParentPool>::CapturePreconnectsSocketPool(
     HostResolver* host_resolver, CertVerifier* /* cert_verifier */)
     : ParentPool(0, 0, NULL, host_resolver, NULL, NULL),
-      last_num_streams_(-1) {}
+      last_num_streams_(-1),
+      num_preconnect_requests_(0) {}
 
 template<>
 CapturePreconnectsHttpProxySocketPool::CapturePreconnectsSocketPool(
     HostResolver* host_resolver, CertVerifier* /* cert_verifier */)
     : HttpProxyClientSocketPool(0, 0, NULL, host_resolver, NULL, NULL, NULL),
-      last_num_streams_(-1) {}
+      last_num_streams_(-1),
+      num_preconnect_requests_(0) {}
 
 template<>
 CapturePreconnectsSSLSocketPool::CapturePreconnectsSocketPool(
     HostResolver* host_resolver, CertVerifier* cert_verifier)
     : SSLClientSocketPool(0, 0, NULL, host_resolver, cert_verifier, NULL,
-                          NULL, "", NULL, NULL, NULL, NULL, NULL, NULL),
-      last_num_streams_(-1) {}
+                          NULL, "", NULL, NULL, NULL, NULL, NULL, NULL,
+                          NULL),
+      last_num_streams_(-1),
+      num_preconnect_requests_(0) {}
 
 TEST(HttpStreamFactoryTest, PreconnectDirect) {
   for (size_t i = 0; i < arraysize(kTests); ++i) {
@@ -394,6 +411,57 @@ TEST(HttpStreamFactoryTest, PreconnectDirectWithExistingSpdySession) {
   }
 }
 
+// Verify that PreconnectOrigins() opens one connection per origin, and none
+// for an origin that already has a SpdySession.
+TEST(HttpStreamFactoryTest, PreconnectOrigins) {
+  SessionDependencies session_deps(ProxyService::CreateDirect());
+  scoped_refptr<HttpNetworkSession> session(CreateSession(&session_deps));
+  HttpNetworkSessionPeer peer(session);
+
+  // Set an existing SpdySession in the pool.
+  HostPortPair host_port_pair("www.google.com", 443);
+  HostPortProxyPair pair(host_port_pair, ProxyServer::Direct());
+  scoped_refptr<SpdySession> spdy_session =
+      session->spdy_session_pool()->Get(pair, BoundNetLog());
+
+  CapturePreconnectsTransportSocketPool* transport_conn_pool =
+      new CapturePreconnectsTransportSocketPool(
+          session_deps.host_resolver.get(),
+          session_deps.cert_verifier.get());
+  CapturePreconnectsSSLSocketPool* ssl_conn_pool =
+      new CapturePreconnectsSSLSocketPool(
+          session_deps.host_resolver.get(),
+          session_deps.cert_verifier.get());
+  MockClientSocketPoolManager* mock_pool_manager =
+      new MockClientSocketPoolManager;
+  mock_pool_manager->SetTransportSocketPool(transport_conn_pool);
+  mock_pool_manager->SetSSLSocketPool(ssl_conn_pool);
+  peer.SetClientSocketPoolManager(mock_pool_manager);
+
+  MockHttpStreamFactoryImpl* mock_factory =
+      new MockHttpStreamFactoryImpl(session);
+  peer.SetHttpStreamFactory(mock_factory);
+  SSLConfig ssl_config;
+  session->ssl_config_service()->GetSSLConfig(&ssl_config);
+
+  std::vector<GURL> origins;
+  origins.push_back(GURL("https://www.google.com/search?q=spdy"));
+  origins.push_back(GURL("https://images.google.com/logo.png"));
+  origins.push_back(GURL("http://static.google.com/"));
+
+  HttpRequestInfo request;
+  request.method = "GET";
+  request.load_flags = 0;
+  session->http_stream_factory()->PreconnectOrigins(
+      origins, request, ssl_config, ssl_config);
+  mock_factory->WaitForNumPreconnects(static_cast<int>(origins.size()));
+
+  EXPECT_EQ(1, ssl_conn_pool->num_preconnect_requests());
+  EXPECT_EQ(1, ssl_conn_pool->last_num_streams());
+  EXPECT_EQ(1, transport_conn_pool->num_preconnect_requests());
+  EXPECT_EQ(1, transport_conn_pool->last_num_streams());
+}
+
 // Verify that preconnects to unsafe ports are cancelled before they reach
 // the SocketPool.
 TEST(HttpStreamFactoryTest, PreconnectUnsafePort) {
@@ -4,6 +4,8 @@
 
 #include "net/http/http_stream_parser.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/metrics/histogram.h"
@@ -21,7 +23,6 @@
 
 namespace {
 
-const size_t kMaxMergedHeaderAndBodySize = 1400;
 const size_t kRequestBodyBufferSize = 1 << 14;  // 16KB
 
 std::string GetResponseHeaderLines(const net::HttpResponseHeaders& headers) {
@@ -225,16 +226,26 @@ int HttpStreamParser::SendRequest(const std::string& request_line,
       // is large enough to hold the encoded chunk.
       chunk_buf_ = new IOBufferWithSize(kRequestBodyBufferSize -
                                         kChunkHeaderFooterSize);
+    } else if (!request_body_->IsInMemory() &&
+               request_body_->size() > kRequestBodyBufferSize) {
+      // Large file uploads are double-buffered, so that reading the file
+      // overlaps with sending what was read before.
+      request_body_read_ahead_buf_ =
+          new SeekableIOBuffer(kRequestBodyBufferSize);
     }
   }
 
   io_state_ = STATE_SENDING_HEADERS;
 
-  // If we have a small request body, then we'll merge with the headers into a
-  // single write.
+  // If we have a non-chunked request body, then we'll merge the headers with
+  // the first buffer's worth of it into a single write, rather than sending
+  // the headers in a segment of their own.
   bool did_merge = false;
   if (ShouldMergeRequestHeadersAndBody(request, request_body_.get())) {
-    size_t merged_size = request.size() + request_body_->size();
+    size_t body_size = static_cast<size_t>(
+        std::min(request_body_->size(),
+                 static_cast<uint64>(kRequestBodyBufferSize)));
+    size_t merged_size = request.size() + body_size;
     scoped_refptr<IOBuffer> merged_request_headers_and_body(
         new IOBuffer(merged_size));
     // We'll repurpose |request_headers_| to store the merged headers and
@@ -245,14 +256,13 @@ int HttpStreamParser::SendRequest(const std::string& request_line,
     memcpy(request_headers_->data(), request.data(), request.size());
     request_headers_->DidConsume(request.size());
 
-    size_t todo = request_body_->size();
+    size_t todo = body_size;
     while (todo) {
       int consumed = request_body_->Read(request_headers_, todo);
       DCHECK_GT(consumed, 0);  // Read() won't fail if not chunked.
       request_headers_->DidConsume(consumed);
       todo -= consumed;
     }
-    DCHECK(request_body_->IsEOF());
     // Reset the offset, so the buffer can be read from the beginning.
     request_headers_->SetOffset(0);
 
@@ -432,7 +442,8 @@ int HttpStreamParser::DoSendHeaders(int result) {
     io_state_ = STATE_SENDING_CHUNKED_BODY;
     result = OK;
   } else if (request_body_ != NULL && request_body_->size() > 0 &&
-             // !IsEOF() indicates that the body wasn't merged.
+             // !IsEOF() indicates that the body wasn't merged, or was
+             // only partly merged.
              !request_body_->IsEOF()) {
     io_state_ = STATE_SENDING_NON_CHUNKED_BODY;
     result = OK;
@@ -494,28 +505,32 @@ int HttpStreamParser::DoSendNonChunkedBody(int result) {
   // |result| is the number of bytes sent from the last call to
   // DoSendNonChunkedBody(), or 0 (i.e. OK) the first time.
 
-  // Send the remaining data in the request body buffer.
   request_body_buf_->DidConsume(result);
-  if (request_body_buf_->BytesRemaining() > 0) {
-    return connection_->socket()->Write(request_body_buf_,
-                                        request_body_buf_->BytesRemaining(),
-                                        io_callback_);
+  if (request_body_buf_->BytesRemaining() == 0) {
+    if (request_body_read_ahead_buf_ &&
+        request_body_read_ahead_buf_->BytesRemaining() > 0) {
+      // The next buffer was read while the last write was pending.
+      request_body_buf_.swap(request_body_read_ahead_buf_);
+    } else {
+      request_body_buf_->Clear();
+      const int consumed = request_body_->Read(request_body_buf_,
+                                               request_body_buf_->capacity());
+      if (consumed == 0) {  // Reached the end.
+        io_state_ = STATE_REQUEST_SENT;
+        return result;
+      }
+      // UploadDataStream::Read() won't fail if not chunked.
+      DCHECK_GT(consumed, 0);
+      request_body_buf_->DidAppend(consumed);
+    }
   }
 
-  request_body_buf_->Clear();
-  const int consumed = request_body_->Read(request_body_buf_,
-                                           request_body_buf_->capacity());
-  if (consumed == 0) {  // Reached the end.
-    io_state_ = STATE_REQUEST_SENT;
-  } else if (consumed > 0) {
-    request_body_buf_->DidAppend(consumed);
-    result = connection_->socket()->Write(request_body_buf_,
-                                          request_body_buf_->BytesRemaining(),
-                                          io_callback_);
-  } else {
-    // UploadDataStream::Read() won't fail if not chunked.
-    NOTREACHED();
-  }
+  // Send the remaining data in the request body buffer.
+  result = connection_->socket()->Write(request_body_buf_,
+                                        request_body_buf_->BytesRemaining(),
+                                        io_callback_);
+  if (result == ERR_IO_PENDING)
+    ReadAheadRequestBody();
   return result;
 }
 
@@ -877,6 +892,20 @@ void HttpStreamParser::CalculateResponseBodySize() {
   }
 }
 
+void HttpStreamParser::ReadAheadRequestBody() {
+  if (!request_body_read_ahead_buf_ ||
+      request_body_read_ahead_buf_->BytesRemaining() > 0 ||
+      request_body_->IsEOF()) {
+    return;
+  }
+  request_body_read_ahead_buf_->Clear();
+  const int consumed = request_body_->Read(
+      request_body_read_ahead_buf_, request_body_read_ahead_buf_->capacity());
+  DCHECK_GE(consumed, 0);
+  if (consumed > 0)
+    request_body_read_ahead_buf_->DidAppend(consumed);
+}
+
 UploadProgress HttpStreamParser::GetUploadProgress() const {
   if (!request_body_.get())
     return UploadProgress();
@@ -965,12 +994,9 @@ bool HttpStreamParser::ShouldMergeRequestHeadersAndBody(
     const std::string& request_headers,
     const UploadDataStream* request_body) {
   if (request_body != NULL &&
-      // IsInMemory() ensures that the request body is not chunked.
-      request_body->IsInMemory() &&
+      !request_body->is_chunked() &&
       request_body->size() > 0) {
-    size_t merged_size = request_headers.size() + request_body->size();
-    if (merged_size <= kMaxMergedHeaderAndBodySize)
-      return true;
+    return true;
   }
   return false;
 }
@@ -94,7 +94,8 @@ class NET_EXPORT_PRIVATE HttpStreamParser  : public ChunkCallback {
                          size_t output_size);
 
   // Returns true if request headers and body should be merged (i.e. the
-  // sum is small enough and the body is in memory, and not chunked).
+  // body is non-empty and not chunked).  Up to 16KB of the body is sent in
+  // the same write as the headers, and the rest follows as usual.
   static bool ShouldMergeRequestHeadersAndBody(
       const std::string& request_headers,
       const UploadDataStream* request_body);
@@ -154,6 +155,11 @@ class NET_EXPORT_PRIVATE HttpStreamParser  : public ChunkCallback {
   int DoReadBody();
   int DoReadBodyComplete(int result);
 
+  // Reads the next buffer of a file-backed request body into
+  // |request_body_read_ahead_buf_|, while the socket is busy sending
+  // |request_body_buf_|.
+  void ReadAheadRequestBody();
+
   // Examines |read_buf_| to find the start and end of the headers. If they are
   // found, parse them with DoParseResponseHeaders().  Return the offset for
   // the end of the headers, or -1 if the complete headers were not found, or
@@ -231,6 +237,10 @@ class NET_EXPORT_PRIVATE HttpStreamParser  : public ChunkCallback {
   scoped_refptr<IOBufferWithSize> chunk_buf_;
   // Temporary buffer to read the request body from UploadDataStream.
   scoped_refptr<SeekableIOBuffer> request_body_buf_;
+  // Second buffer for non-chunked, file-backed request bodies, filled while
+  // a write of |request_body_buf_| is pending so the next write can start
+  // as soon as that one completes.  NULL for other bodies.
+  scoped_refptr<SeekableIOBuffer> request_body_read_ahead_buf_;
   size_t chunk_length_without_encoding_;
   bool sent_last_chunk_;
 
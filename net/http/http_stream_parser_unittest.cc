@@ -4,6 +4,8 @@
 
 #include "net/http/http_stream_parser.h"
 
+#include <string>
+
 #include "base/file_path.h"
 #include "base/file_util.h"
 #include "base/memory/ref_counted.h"
@@ -11,6 +13,7 @@
 #include "base/string_piece.h"
 #include "base/stringprintf.h"
 #include "googleurl/src/gurl.h"
+#include "net/base/address_list.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/base/test_completion_callback.h"
@@ -130,7 +133,7 @@ TEST(HttpStreamParser, ShouldMergeRequestHeadersAndBody_FileBody) {
 
   scoped_ptr<UploadDataStream> body(new UploadDataStream(upload_data));
   ASSERT_EQ(OK, body->InitSync());
-  // Shouldn't be merged if upload data carries a file, as it's not in-memory.
+  // Shouldn't be merged if the file is empty.
   ASSERT_FALSE(HttpStreamParser::ShouldMergeRequestHeadersAndBody(
       "some header", body.get()));
 }
@@ -154,11 +157,149 @@ TEST(HttpStreamParser, ShouldMergeRequestHeadersAndBody_LargeBodyInMemory) {
 
   scoped_ptr<UploadDataStream> body(new UploadDataStream(upload_data));
   ASSERT_EQ(OK, body->InitSync());
-  // Shouldn't be merged if the in-memory body is large here.
-  ASSERT_FALSE(HttpStreamParser::ShouldMergeRequestHeadersAndBody(
+  // Should be merged even if the in-memory body is large; only its first
+  // buffer goes out with the headers.
+  ASSERT_TRUE(HttpStreamParser::ShouldMergeRequestHeadersAndBody(
       "some header", body.get()));
 }
 
+// Counts the socket writes needed to send a POST whose body is larger than a
+// single body buffer.  The headers go out with the first 16KB of the body, so
+// the whole request takes two writes rather than three.
+TEST(HttpStreamParser, LargeBodyMergedWithHeaders) {
+  static const char kHeaders[] =
+      "POST /upload HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "Content-Length: 20000\r\n\r\n";
+  static const size_t kFirstBufferSize = 16384;
+  const std::string payload(20000, 'a');
+  const std::string first_write =
+      std::string(kHeaders) + payload.substr(0, kFirstBufferSize);
+  const std::string second_write = payload.substr(kFirstBufferSize);
+
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, first_write.data(), first_write.size()),
+    MockWrite(SYNCHRONOUS, second_write.data(), second_write.size()),
+  };
+  StaticSocketDataProvider data(NULL, 0, writes, arraysize(writes));
+  data.set_connect_data(MockConnect(SYNCHRONOUS, OK));
+
+  scoped_ptr<MockTCPClientSocket> transport(
+      new MockTCPClientSocket(AddressList(), NULL, &data));
+  TestCompletionCallback callback;
+  ASSERT_EQ(OK, callback.GetResult(transport->Connect(callback.callback())));
+
+  scoped_ptr<ClientSocketHandle> socket_handle(new ClientSocketHandle);
+  socket_handle->set_socket(transport.release());
+
+  HttpRequestInfo request_info;
+  request_info.method = "POST";
+  request_info.url = GURL("http://localhost/upload");
+  request_info.load_flags = LOAD_NORMAL;
+
+  scoped_refptr<GrowableIOBuffer> read_buffer(new GrowableIOBuffer);
+  HttpStreamParser parser(socket_handle.get(), &request_info, read_buffer,
+                          BoundNetLog());
+
+  scoped_refptr<UploadData> upload_data(new UploadData);
+  upload_data->AppendBytes(payload.data(), payload.size());
+  scoped_ptr<UploadDataStream> upload_stream(
+      new UploadDataStream(upload_data));
+  ASSERT_EQ(OK, upload_stream->InitSync());
+
+  HttpRequestHeaders request_headers;
+  request_headers.SetHeader("Host", "localhost");
+  request_headers.SetHeader("Content-Length", "20000");
+
+  HttpResponseInfo response_info;
+  EXPECT_EQ(OK, parser.SendRequest("POST /upload HTTP/1.1\r\n",
+                                   request_headers, upload_stream.Pass(),
+                                   &response_info, callback.callback()));
+  EXPECT_EQ(arraysize(writes), data.write_index());
+  EXPECT_TRUE(data.at_write_eof());
+}
+
+// Verify that a large file upload reads its next buffer while the previous
+// write is still pending, so the socket never waits on the file.
+TEST(HttpStreamParser, FileBodyReadAheadWhileWritePending) {
+  static const char kHeaders[] =
+      "POST /upload HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "Content-Length: 40000\r\n\r\n";
+  static const int kBufferSize = 16384;
+  static const int kFileSize = 40000;
+  const std::string payload(kFileSize, 'f');
+  const std::string first_write =
+      std::string(kHeaders) + payload.substr(0, kBufferSize);
+  const std::string second_write = payload.substr(kBufferSize, kBufferSize);
+  const std::string third_write = payload.substr(2 * kBufferSize);
+
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath temp_file_path;
+  ASSERT_TRUE(file_util::CreateTemporaryFileInDir(temp_dir.path(),
+                                                  &temp_file_path));
+  ASSERT_EQ(kFileSize, file_util::WriteFile(temp_file_path, payload.data(),
+                                            kFileSize));
+
+  MockWrite writes[] = {
+    MockWrite(ASYNC, first_write.data(), first_write.size(), 0),
+    MockWrite(ASYNC, second_write.data(), second_write.size(), 1),
+    MockWrite(ASYNC, third_write.data(), third_write.size(), 2),
+  };
+  DeterministicSocketData data(NULL, 0, writes, arraysize(writes));
+  data.set_connect_data(MockConnect(SYNCHRONOUS, OK));
+
+  scoped_ptr<DeterministicMockTCPClientSocket> transport(
+      new DeterministicMockTCPClientSocket(NULL, &data));
+  data.set_socket(transport->AsWeakPtr());
+
+  TestCompletionCallback callback;
+  ASSERT_EQ(OK, callback.GetResult(transport->Connect(callback.callback())));
+
+  scoped_ptr<ClientSocketHandle> socket_handle(new ClientSocketHandle);
+  socket_handle->set_socket(transport.release());
+
+  HttpRequestInfo request_info;
+  request_info.method = "POST";
+  request_info.url = GURL("http://localhost/upload");
+  request_info.load_flags = LOAD_NORMAL;
+
+  scoped_refptr<GrowableIOBuffer> read_buffer(new GrowableIOBuffer);
+  HttpStreamParser parser(socket_handle.get(), &request_info, read_buffer,
+                          BoundNetLog());
+
+  scoped_refptr<UploadData> upload_data(new UploadData);
+  upload_data->AppendFileRange(temp_file_path, 0, kuint64max, base::Time());
+  scoped_ptr<UploadDataStream> upload_stream(
+      new UploadDataStream(upload_data));
+  ASSERT_EQ(OK, upload_stream->InitSync());
+
+  HttpRequestHeaders request_headers;
+  request_headers.SetHeader("Host", "localhost");
+  request_headers.SetHeader("Content-Length", "40000");
+
+  HttpResponseInfo response_info;
+  ASSERT_EQ(ERR_IO_PENDING,
+            parser.SendRequest("POST /upload HTTP/1.1\r\n", request_headers,
+                               upload_stream.Pass(), &response_info,
+                               callback.callback()));
+  EXPECT_EQ(static_cast<uint64>(kBufferSize),
+            parser.GetUploadProgress().position());
+
+  // Completing the headers write starts writing the second buffer, and the
+  // rest of the file is read while that write is pending.
+  data.RunFor(1);
+  ASSERT_FALSE(callback.have_result());
+  EXPECT_EQ(static_cast<uint64>(kFileSize),
+            parser.GetUploadProgress().position());
+
+  data.RunFor(2);
+  ASSERT_TRUE(callback.have_result());
+  EXPECT_LE(0, callback.WaitForResult());
+  EXPECT_TRUE(data.at_write_eof());
+}
+
 // Test to ensure the HttpStreamParser state machine does not get confused
 // when sending a request with a chunked body, where chunks become available
 // asynchronously, over a socket where writes may also complete
@@ -5,6 +5,7 @@
 #include "net/http/infinite_cache.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/bind.h"
@@ -28,6 +29,7 @@
 #include "net/http/http_response_headers.h"
 #include "net/http/http_response_info.h"
 #include "net/http/http_util.h"
+#include "net/http/infinite_cache_trace.h"
 #include "third_party/zlib/zlib.h"
 
 using base::PlatformFile;
@@ -78,6 +80,9 @@ uint32 kCurrentVersion = 0x10001;
 int kMaxNumEntries = 200 * 1000;
 int kMaxTrackingSize = 40 * 1024 * 1024;
 
+// Maximum number of requests written to a trace file.
+int kMaxTraceRecords = 2 * 1000 * 1000;
+
 // Settings that control how we generate histograms.
 int kTimerMinutes = 5;
 int kReportSizeStep = 100 * 1024 * 1024;
@@ -348,7 +353,7 @@ void InfiniteCacheTransaction::Finish() {
 // be as behind as it has to when processing requests.
 class InfiniteCache::Worker : public base::RefCountedThreadSafe<Worker> {
  public:
-  Worker() : init_(false), flushed_(false) {}
+  Worker() : init_(false), flushed_(false), num_trace_records_(0) {}
 
   // Construction and destruction helpers.
   void Init(const FilePath& path);
@@ -362,6 +367,9 @@ class InfiniteCache::Worker : public base::RefCountedThreadSafe<Worker> {
                          base::Time end_time,
                          int* result);
 
+  // Starts recording requests to the trace file at |path|.
+  void EnableTrace(const FilePath& path);
+
   // Performs the actual processing of a new transaction. Takes ownership of
   // the transaction |data|.
   void Process(scoped_ptr<InfiniteCacheTransaction::ResourceData> data);
@@ -413,6 +421,13 @@ class InfiniteCache::Worker : public base::RefCountedThreadSafe<Worker> {
   bool WriteData(PlatformFile file);
   bool ReadAndVerifyHeader(PlatformFile file);
 
+  // Methods to record the trace. AddTraceRecord() returns the new record, or
+  // NULL if no trace is being recorded.
+  InfiniteCacheTraceRecord* AddTraceRecord(const Key& key,
+                                           const Details& details);
+  void StoreTrace();
+  void DeleteTrace();
+
   // Book-keeping methods.
   void Add(const Details& details);
   void Remove(const Details& details);
@@ -433,6 +448,9 @@ class InfiniteCache::Worker : public base::RefCountedThreadSafe<Worker> {
   bool flushed_;
   scoped_ptr<Header> header_;
   FilePath path_;
+  FilePath trace_path_;
+  std::vector<InfiniteCacheTraceRecord> trace_records_;  // Not yet stored.
+  int num_trace_records_;
 
   DISALLOW_COPY_AND_ASSIGN(Worker);
 };
@@ -445,6 +463,7 @@ void InfiniteCache::Worker::Init(const FilePath& path) {
 void InfiniteCache::Worker::Cleanup() {
   if (init_)
     StoreData();
+  StoreTrace();
 
   map_.clear();
 }
@@ -456,6 +475,7 @@ void InfiniteCache::Worker::DeleteData(int* result) {
   map_.clear();
   InitializeData();
   file_util::Delete(path_, false);
+  DeleteTrace();
   *result = OK;
   UMA_HISTOGRAM_BOOLEAN("InfiniteCache.DeleteAll", true);
 }
@@ -481,15 +501,25 @@ void InfiniteCache::Worker::DeleteDataBetween(base::Time initial_time,
 
   file_util::Delete(path_, false);
   StoreData();
+
+  // The trace is not indexed by time, so it is discarded as a whole.
+  DeleteTrace();
   *result = OK;
   UMA_HISTOGRAM_BOOLEAN("InfiniteCache.DeleteRange", true);
 }
 
+void InfiniteCache::Worker::EnableTrace(const FilePath& path) {
+  trace_path_ = path;
+}
+
 void InfiniteCache::Worker::Process(
     scoped_ptr<InfiniteCacheTransaction::ResourceData> data) {
   if (!init_)
     return;
 
+  // Requests that are not tracked by this object are still part of the trace.
+  InfiniteCacheTraceRecord* record = AddTraceRecord(data->key, data->details);
+
   if (data->details.response_size > kMaxTrackingSize)
     return;
 
@@ -513,6 +543,12 @@ void InfiniteCache::Worker::Process(
     if (reused && data_changed)
       header_->num_bad_hits++;
 
+    if (record && reused)
+      record->flags |= TRACE_REUSABLE;
+
+    if (record && data_changed)
+      record->flags |= TRACE_CHANGED;
+
     if (reused)
       RecordHit(i->second, &data->details);
 
@@ -722,6 +758,43 @@ bool InfiniteCache::Worker::ReadAndVerifyHeader(PlatformFile file) {
   return true;
 }
 
+InfiniteCacheTraceRecord* InfiniteCache::Worker::AddTraceRecord(
+    const Key& key, const Details& details) {
+  if (trace_path_.empty() || num_trace_records_ >= kMaxTraceRecords)
+    return NULL;
+
+  InfiniteCacheTraceRecord record;
+  memset(&record, 0, sizeof(record));
+  memcpy(&record.key_hash, key.value, sizeof(record.key_hash));
+  record.time = details.last_access;
+  record.size = details.headers_size + details.response_size;
+  if (details.flags & NO_STORE)
+    record.flags |= TRACE_NO_STORE;
+  if (details.flags & DOOM_METHOD)
+    record.flags |= TRACE_DOOM;
+  if (details.flags & CACHED)
+    record.flags |= TRACE_CACHED;
+
+  num_trace_records_++;
+  trace_records_.push_back(record);
+  return &trace_records_.back();
+}
+
+void InfiniteCache::Worker::StoreTrace() {
+  if (trace_records_.empty())
+    return;
+
+  if (!AppendInfiniteCacheTrace(trace_path_, trace_records_))
+    LOG(ERROR) << "Failed to write the trace";
+  trace_records_.clear();
+}
+
+void InfiniteCache::Worker::DeleteTrace() {
+  trace_records_.clear();
+  if (!trace_path_.empty())
+    file_util::Delete(trace_path_, false);
+}
+
 void InfiniteCache::Worker::Query(int* result) {
   *result = static_cast<int>(map_.size());
 }
@@ -729,6 +802,7 @@ void InfiniteCache::Worker::Query(int* result) {
 void InfiniteCache::Worker::Flush(int* result) {
   flushed_ = false;
   StoreData();
+  StoreTrace();
   flushed_ = true;
   *result = OK;
 }
@@ -737,6 +811,7 @@ void InfiniteCache::Worker::OnTimer() {
   header_->use_minutes += kTimerMinutes;
   GenerateHistograms();
   StoreData();
+  StoreTrace();
 }
 
 void InfiniteCache::Worker::Add(const Details& details) {
@@ -959,6 +1034,14 @@ InfiniteCacheTransaction* InfiniteCache::CreateInfiniteCacheTransaction() {
   return new InfiniteCacheTransaction(this);
 }
 
+void InfiniteCache::EnableTrace(const FilePath& path) {
+  if (!worker_)
+    return;
+  task_runner_->PostTask(FROM_HERE,
+                         base::Bind(&InfiniteCache::Worker::EnableTrace,
+                                    worker_, path));
+}
+
 int InfiniteCache::DeleteData(const CompletionCallback& callback) {
   if (!worker_)
     return OK;
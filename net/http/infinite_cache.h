@@ -82,6 +82,11 @@ class NET_EXPORT_PRIVATE InfiniteCache
 
   InfiniteCacheTransaction* CreateInfiniteCacheTransaction();
 
+  // Starts appending every request processed by this object to the trace file
+  // at |path| (see infinite_cache_trace.h). The trace is written along with
+  // the regular data, so it should be called after Init().
+  void EnableTrace(const FilePath& path);
+
   // Removes all data for this experiment. Returns a net error code.
   int DeleteData(const CompletionCallback& callback);
 
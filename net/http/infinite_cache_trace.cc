@@ -0,0 +1,114 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/infinite_cache_trace.h"
+
+#include <algorithm>
+
+#include "base/file_path.h"
+#include "base/logging.h"
+#include "base/platform_file.h"
+
+using base::PlatformFile;
+
+namespace {
+
+struct TraceHeader {
+  uint32 magic;
+  uint32 version;
+  uint32 record_size;
+  uint32 reserved;
+};
+
+const uint32 kTraceMagic = 0x1f01cace;
+const uint32 kTraceVersion = 1;
+
+// Maximum number of records read or written at once.
+const size_t kRecordsPerChunk = 16 * 1024;
+
+bool WriteAll(PlatformFile file, int64 offset, const char* data, int size) {
+  return base::WritePlatformFile(file, offset, data, size) == size;
+}
+
+}  // namespace
+
+namespace net {
+
+bool AppendInfiniteCacheTrace(
+    const FilePath& path,
+    const std::vector<InfiniteCacheTraceRecord>& records) {
+  PlatformFile file = base::CreatePlatformFile(
+      path, base::PLATFORM_FILE_OPEN_ALWAYS | base::PLATFORM_FILE_READ |
+                base::PLATFORM_FILE_WRITE,
+      NULL, NULL);
+  if (file == base::kInvalidPlatformFileValue)
+    return false;
+
+  bool success = false;
+  base::PlatformFileInfo info;
+  if (base::GetPlatformFileInfo(file, &info)) {
+    int64 offset = info.size;
+    success = true;
+    if (!offset) {
+      TraceHeader header = { kTraceMagic, kTraceVersion,
+                             sizeof(InfiniteCacheTraceRecord), 0 };
+      success = WriteAll(file, 0, reinterpret_cast<const char*>(&header),
+                         sizeof(header));
+      offset = sizeof(header);
+    } else {
+      // Drop any incomplete record left by a previous failure.
+      int64 records_size = offset - static_cast<int64>(sizeof(TraceHeader));
+      offset -= records_size % sizeof(InfiniteCacheTraceRecord);
+    }
+
+    for (size_t i = 0; success && i < records.size(); i += kRecordsPerChunk) {
+      size_t num_records = std::min(kRecordsPerChunk, records.size() - i);
+      int size = static_cast<int>(num_records *
+                                  sizeof(InfiniteCacheTraceRecord));
+      success = WriteAll(file, offset,
+                         reinterpret_cast<const char*>(&records[i]), size);
+      offset += size;
+    }
+  }
+
+  base::ClosePlatformFile(file);
+  return success;
+}
+
+bool ReadInfiniteCacheTrace(const FilePath& path,
+                            std::vector<InfiniteCacheTraceRecord>* records) {
+  PlatformFile file = base::CreatePlatformFile(
+      path, base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ, NULL, NULL);
+  if (file == base::kInvalidPlatformFileValue)
+    return false;
+
+  bool success = false;
+  base::PlatformFileInfo info;
+  TraceHeader header;
+  if (base::GetPlatformFileInfo(file, &info) &&
+      info.size >= static_cast<int64>(sizeof(header)) &&
+      base::ReadPlatformFile(file, 0, reinterpret_cast<char*>(&header),
+                             sizeof(header)) == sizeof(header) &&
+      header.magic == kTraceMagic && header.version == kTraceVersion &&
+      header.record_size == sizeof(InfiniteCacheTraceRecord)) {
+    size_t num_records = static_cast<size_t>(
+        (info.size - sizeof(header)) / sizeof(InfiniteCacheTraceRecord));
+    records->resize(num_records);
+
+    int64 offset = sizeof(header);
+    success = true;
+    for (size_t i = 0; success && i < num_records; i += kRecordsPerChunk) {
+      size_t chunk = std::min(kRecordsPerChunk, num_records - i);
+      int size = static_cast<int>(chunk * sizeof(InfiniteCacheTraceRecord));
+      success = base::ReadPlatformFile(
+          file, offset, reinterpret_cast<char*>(&(*records)[i]), size) == size;
+      offset += size;
+    }
+  }
+
+  base::ClosePlatformFile(file);
+  return success;
+}
+
+}  // namespace net
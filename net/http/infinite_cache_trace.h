@@ -0,0 +1,54 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A trace of the requests seen by an InfiniteCache. The trace records every
+// request in order, with enough information to replay the traffic against a
+// cache of any size (see net/tools/cache_simulator), but without the URLs:
+// resources are identified by a hash of the cache key.
+
+#ifndef NET_HTTP_INFINITE_CACHE_TRACE_H_
+#define NET_HTTP_INFINITE_CACHE_TRACE_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+
+class FilePath;
+
+namespace net {
+
+// Flags of a trace record.
+enum InfiniteCacheTraceFlags {
+  TRACE_NO_STORE = 1 << 0,   // The response cannot be stored.
+  TRACE_DOOM = 1 << 1,       // The request invalidates the stored resource.
+  TRACE_REUSABLE = 1 << 2,   // A stored copy could have served the request.
+  TRACE_CHANGED = 1 << 3,    // The response differs from the stored copy.
+  TRACE_CACHED = 1 << 4      // The response came from the real cache.
+};
+
+// One request of the trace. The layout of this structure is the file format.
+struct InfiniteCacheTraceRecord {
+  uint64 key_hash;  // The first bytes of the SHA-1 hash of the cache key.
+  int32 time;       // Request time, in seconds since the Unix epoch.
+  int32 size;       // Size of the headers plus the response body.
+  uint32 flags;     // Combination of InfiniteCacheTraceFlags.
+  uint32 reserved;
+};
+
+// Appends |records| to the trace stored at |path|, creating the file if
+// needed. Returns false on failure.
+NET_EXPORT_PRIVATE bool AppendInfiniteCacheTrace(
+    const FilePath& path,
+    const std::vector<InfiniteCacheTraceRecord>& records);
+
+// Reads all the records stored at |path|. An incomplete record at the end of
+// the file is ignored. Returns false if the file is not a valid trace.
+NET_EXPORT_PRIVATE bool ReadInfiniteCacheTrace(
+    const FilePath& path,
+    std::vector<InfiniteCacheTraceRecord>* records);
+
+}  // namespace net
+
+#endif  // NET_HTTP_INFINITE_CACHE_TRACE_H_
@@ -11,6 +11,7 @@
 #include "net/base/net_errors.h"
 #include "net/base/test_completion_callback.h"
 #include "net/http/http_transaction_unittest.h"
+#include "net/http/infinite_cache_trace.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using base::Time;
@@ -234,3 +235,38 @@ TEST(InfiniteCache, DeleteBetween) {
   EXPECT_EQ(1, cb.GetResult(cache->QueryItemsForTest(cb.callback())));
 #endif  // OS_ANDROID
 }
+
+TEST(InfiniteCache, Trace) {
+  ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  FilePath trace_path = dir.path().Append(FILE_PATH_LITERAL("trace"));
+
+  scoped_ptr<InfiniteCache> cache(new InfiniteCache);
+  cache->Init(FilePath());
+  cache->EnableTrace(trace_path);
+  net::TestCompletionCallback cb;
+
+  ProcessRequest(kTypicalGET_Transaction, cache.get());
+  ProcessRequest(kSimpleGET_Transaction, cache.get());
+  ProcessRequest(kTypicalGET_Transaction, cache.get());
+  EXPECT_EQ(net::OK, cb.GetResult(cache->FlushDataForTest(cb.callback())));
+
+  // The trace is appended to the existing file.
+  MockTransaction request(kSimpleGET_Transaction);
+  request.method = "DELETE";
+  ProcessRequest(request, cache.get());
+  EXPECT_EQ(net::OK, cb.GetResult(cache->FlushDataForTest(cb.callback())));
+
+  std::vector<net::InfiniteCacheTraceRecord> records;
+  ASSERT_TRUE(net::ReadInfiniteCacheTrace(trace_path, &records));
+  ASSERT_EQ(4U, records.size());
+  EXPECT_EQ(records[0].key_hash, records[2].key_hash);
+  EXPECT_EQ(records[1].key_hash, records[3].key_hash);
+  EXPECT_NE(records[0].key_hash, records[1].key_hash);
+  EXPECT_LT(0, records[0].size);
+  EXPECT_FALSE(records[1].flags & net::TRACE_DOOM);
+  EXPECT_TRUE(records[3].flags & net::TRACE_DOOM);
+
+  EXPECT_EQ(net::OK, cb.GetResult(cache->DeleteData(cb.callback())));
+  EXPECT_FALSE(file_util::PathExists(trace_path));
+}
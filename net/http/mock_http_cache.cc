@@ -115,7 +115,6 @@ int MockDiskEntry::WriteData(
     const net::CompletionCallback& callback, bool truncate) {
   DCHECK(index >= 0 && index < kNumCacheEntryDataIndices);
   DCHECK(!callback.is_null());
-  DCHECK(truncate);
 
   if (fail_requests_) {
     CallbackLater(callback, net::ERR_CACHE_READ_FAILURE);
@@ -125,7 +124,8 @@ int MockDiskEntry::WriteData(
   if (offset < 0 || offset > static_cast<int>(data_[index].size()))
     return net::ERR_FAILED;
 
-  data_[index].resize(offset + buf_len);
+  if (truncate || offset + buf_len > static_cast<int>(data_[index].size()))
+    data_[index].resize(offset + buf_len);
   if (buf_len)
     memcpy(&data_[index][offset], buf->data(), buf_len);
 
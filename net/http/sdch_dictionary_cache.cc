@@ -0,0 +1,376 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/sdch_dictionary_cache.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/string_split.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache.h"
+
+namespace {
+
+// Keys of the cache entries. Regular cache keys are URLs, so these cannot
+// collide with them.
+const char kDictionaryKeyPrefix[] = "sdch-dictionary:";
+const char kIndexKey[] = "sdch-dictionary:index";
+
+// The stored dictionaries are the text plus the URL, and the index is small.
+const int kMaxDataSize =
+    static_cast<int>(net::SdchManager::kMaxDictionarySize) + 4096;
+
+typedef base::Callback<void(int, const std::string&)> OperationCallback;
+
+}  // namespace
+
+namespace net {
+
+// Reads or writes the data of a single entry. Operations delete themselves
+// when done. If the cache goes away first, nothing is reported.
+class SdchDictionaryCache::Operation {
+ public:
+  // Reads the data stored under |key|, and passes it to |callback|.
+  static void Read(HttpCache* cache, const std::string& key,
+                   const OperationCallback& callback);
+
+  // Replaces the data stored under |key| with |data|.
+  static void Write(HttpCache* cache, const std::string& key,
+                    const std::string& data);
+
+ private:
+  enum State {
+    STATE_NONE,
+    STATE_GET_BACKEND,
+    STATE_GET_BACKEND_COMPLETE,
+    STATE_OPEN_ENTRY,
+    STATE_OPEN_ENTRY_COMPLETE,
+    STATE_CREATE_ENTRY,
+    STATE_CREATE_ENTRY_COMPLETE,
+    STATE_READ_DATA,
+    STATE_READ_DATA_COMPLETE,
+    STATE_WRITE_DATA,
+    STATE_WRITE_DATA_COMPLETE
+  };
+
+  Operation(HttpCache* cache, const std::string& key, bool write);
+  ~Operation();
+
+  void Start();
+  void OnIOComplete(int result);
+  void DoLoop(int result);
+
+  int DoGetBackend();
+  int DoGetBackendComplete(int result);
+  int DoOpenEntry();
+  int DoOpenEntryComplete(int result);
+  int DoCreateEntry();
+  int DoCreateEntryComplete(int result);
+  int DoReadData();
+  int DoReadDataComplete(int result);
+  int DoWriteData();
+  int DoWriteDataComplete(int result);
+
+  HttpCache* cache_;
+  std::string key_;
+  bool write_;
+  State next_state_;
+  disk_cache::Backend* backend_;
+  disk_cache::Entry* entry_;
+  scoped_refptr<IOBuffer> buf_;
+  int buf_len_;
+  std::string data_;
+  OperationCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(Operation);
+};
+
+SdchDictionaryCache::Operation::Operation(HttpCache* cache,
+                                          const std::string& key,
+                                          bool write)
+    : cache_(cache),
+      key_(key),
+      write_(write),
+      next_state_(STATE_NONE),
+      backend_(NULL),
+      entry_(NULL),
+      buf_len_(0) {
+}
+
+SdchDictionaryCache::Operation::~Operation() {
+  if (entry_)
+    entry_->Close();
+}
+
+// static
+void SdchDictionaryCache::Operation::Read(HttpCache* cache,
+                                          const std::string& key,
+                                          const OperationCallback& callback) {
+  Operation* operation = new Operation(cache, key, false);
+  operation->callback_ = callback;
+  operation->Start();
+}
+
+// static
+void SdchDictionaryCache::Operation::Write(HttpCache* cache,
+                                           const std::string& key,
+                                           const std::string& data) {
+  Operation* operation = new Operation(cache, key, true);
+  operation->data_ = data;
+  operation->Start();
+}
+
+void SdchDictionaryCache::Operation::Start() {
+  next_state_ = STATE_GET_BACKEND;
+  DoLoop(OK);
+}
+
+void SdchDictionaryCache::Operation::OnIOComplete(int result) {
+  DoLoop(result);
+}
+
+void SdchDictionaryCache::Operation::DoLoop(int result) {
+  DCHECK_NE(STATE_NONE, next_state_);
+  do {
+    State state = next_state_;
+    next_state_ = STATE_NONE;
+    switch (state) {
+      case STATE_GET_BACKEND:
+        DCHECK_EQ(OK, result);
+        result = DoGetBackend();
+        break;
+      case STATE_GET_BACKEND_COMPLETE:
+        result = DoGetBackendComplete(result);
+        break;
+      case STATE_OPEN_ENTRY:
+        result = DoOpenEntry();
+        break;
+      case STATE_OPEN_ENTRY_COMPLETE:
+        result = DoOpenEntryComplete(result);
+        break;
+      case STATE_CREATE_ENTRY:
+        DCHECK_EQ(OK, result);
+        result = DoCreateEntry();
+        break;
+      case STATE_CREATE_ENTRY_COMPLETE:
+        result = DoCreateEntryComplete(result);
+        break;
+      case STATE_READ_DATA:
+        DCHECK_EQ(OK, result);
+        result = DoReadData();
+        break;
+      case STATE_READ_DATA_COMPLETE:
+        result = DoReadDataComplete(result);
+        break;
+      case STATE_WRITE_DATA:
+        DCHECK_EQ(OK, result);
+        result = DoWriteData();
+        break;
+      case STATE_WRITE_DATA_COMPLETE:
+        result = DoWriteDataComplete(result);
+        break;
+      default:
+        NOTREACHED() << "bad state";
+        result = ERR_FAILED;
+        break;
+    }
+  } while (result != ERR_IO_PENDING && next_state_ != STATE_NONE);
+
+  if (result == ERR_IO_PENDING)
+    return;
+
+  if (!callback_.is_null())
+    callback_.Run(result, data_);
+  delete this;
+}
+
+int SdchDictionaryCache::Operation::DoGetBackend() {
+  next_state_ = STATE_GET_BACKEND_COMPLETE;
+  return cache_->GetBackend(
+      &backend_,
+      base::Bind(&Operation::OnIOComplete, base::Unretained(this)));
+}
+
+int SdchDictionaryCache::Operation::DoGetBackendComplete(int result) {
+  // The HttpCache may be gone at this point.
+  cache_ = NULL;
+  if (result != OK || !backend_)
+    return ERR_FAILED;
+
+  next_state_ = write_ ? STATE_CREATE_ENTRY : STATE_OPEN_ENTRY;
+  return OK;
+}
+
+int SdchDictionaryCache::Operation::DoOpenEntry() {
+  next_state_ = STATE_OPEN_ENTRY_COMPLETE;
+  return backend_->OpenEntry(
+      key_, &entry_,
+      base::Bind(&Operation::OnIOComplete, base::Unretained(this)));
+}
+
+int SdchDictionaryCache::Operation::DoOpenEntryComplete(int result) {
+  if (result != OK)
+    return result;
+
+  next_state_ = write_ ? STATE_WRITE_DATA : STATE_READ_DATA;
+  return OK;
+}
+
+int SdchDictionaryCache::Operation::DoCreateEntry() {
+  next_state_ = STATE_CREATE_ENTRY_COMPLETE;
+  return backend_->CreateEntry(
+      key_, &entry_,
+      base::Bind(&Operation::OnIOComplete, base::Unretained(this)));
+}
+
+int SdchDictionaryCache::Operation::DoCreateEntryComplete(int result) {
+  // The entry may exist already.
+  next_state_ = (result == OK) ? STATE_WRITE_DATA : STATE_OPEN_ENTRY;
+  return OK;
+}
+
+int SdchDictionaryCache::Operation::DoReadData() {
+  buf_len_ = entry_->GetDataSize(0);
+  if (buf_len_ <= 0 || buf_len_ > kMaxDataSize)
+    return ERR_FAILED;
+
+  next_state_ = STATE_READ_DATA_COMPLETE;
+  buf_ = new IOBuffer(buf_len_);
+  return entry_->ReadData(
+      0, 0, buf_, buf_len_,
+      base::Bind(&Operation::OnIOComplete, base::Unretained(this)));
+}
+
+int SdchDictionaryCache::Operation::DoReadDataComplete(int result) {
+  if (result != buf_len_)
+    return ERR_FAILED;
+
+  data_.assign(buf_->data(), buf_len_);
+  return OK;
+}
+
+int SdchDictionaryCache::Operation::DoWriteData() {
+  next_state_ = STATE_WRITE_DATA_COMPLETE;
+  buf_ = new StringIOBuffer(data_);
+  buf_len_ = static_cast<int>(data_.size());
+  return entry_->WriteData(
+      0, 0, buf_, buf_len_,
+      base::Bind(&Operation::OnIOComplete, base::Unretained(this)), true);
+}
+
+int SdchDictionaryCache::Operation::DoWriteDataComplete(int result) {
+  return (result == buf_len_) ? OK : ERR_FAILED;
+}
+
+//-----------------------------------------------------------------------------
+
+SdchDictionaryCache::SdchDictionaryCache(HttpCache* cache)
+    : cache_(cache->AsWeakPtr()),
+      index_loaded_(false),
+      index_dirty_(false),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+}
+
+SdchDictionaryCache::~SdchDictionaryCache() {
+  DCHECK(CalledOnValidThread());
+}
+
+void SdchDictionaryCache::Save(const std::string& server_hash,
+                               const GURL& dictionary_url,
+                               const std::string& dictionary_text) {
+  DCHECK(CalledOnValidThread());
+  if (!cache_ || hashes_.count(server_hash))
+    return;
+
+  std::string data(dictionary_url.spec());
+  data.append("\n");
+  data.append(dictionary_text);
+  Operation::Write(cache_.get(), kDictionaryKeyPrefix + server_hash, data);
+
+  hashes_.insert(server_hash);
+  index_dirty_ = true;
+  WriteIndex();
+}
+
+void SdchDictionaryCache::LoadAll(const LoadCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  if (!cache_)
+    return;
+
+  Operation::Read(cache_.get(), kIndexKey,
+                  base::Bind(&SdchDictionaryCache::OnIndexLoaded,
+                             weak_factory_.GetWeakPtr(), callback));
+}
+
+void SdchDictionaryCache::Load(const std::string& server_hash,
+                               const LoadCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  // Once the index is known, there is no need to look for other hashes.
+  if (!cache_ || (index_loaded_ && !hashes_.count(server_hash)) ||
+      loading_.count(server_hash)) {
+    return;
+  }
+
+  loading_.insert(server_hash);
+  Operation::Read(cache_.get(), kDictionaryKeyPrefix + server_hash,
+                  base::Bind(&SdchDictionaryCache::OnDictionaryLoaded,
+                             weak_factory_.GetWeakPtr(), server_hash,
+                             callback));
+}
+
+void SdchDictionaryCache::OnIndexLoaded(const LoadCallback& callback,
+                                        int result,
+                                        const std::string& data) {
+  index_loaded_ = true;
+  if (result == OK) {
+    std::vector<std::string> hashes;
+    base::SplitString(data, '\n', &hashes);
+    for (size_t i = 0; i < hashes.size(); i++) {
+      if (hashes[i].empty())
+        continue;
+      hashes_.insert(hashes[i]);
+      Load(hashes[i], callback);
+    }
+  }
+  WriteIndex();
+}
+
+void SdchDictionaryCache::OnDictionaryLoaded(const std::string& server_hash,
+                                             const LoadCallback& callback,
+                                             int result,
+                                             const std::string& data) {
+  loading_.erase(server_hash);
+  size_t url_end = data.find('\n');
+  if (result != OK || url_end == std::string::npos) {
+    // The entry was evicted (or is not valid).
+    if (hashes_.erase(server_hash)) {
+      index_dirty_ = true;
+      WriteIndex();
+    }
+    return;
+  }
+
+  callback.Run(GURL(data.substr(0, url_end)), data.substr(url_end + 1));
+}
+
+void SdchDictionaryCache::WriteIndex() {
+  if (!index_loaded_ || !index_dirty_ || !cache_)
+    return;
+
+  std::string data;
+  for (std::set<std::string>::const_iterator it = hashes_.begin();
+       it != hashes_.end(); ++it) {
+    data.append(*it);
+    data.append("\n");
+  }
+  Operation::Write(cache_.get(), kIndexKey, data);
+  index_dirty_ = false;
+}
+
+}  // namespace net
@@ -0,0 +1,75 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SdchDictionaryCache keeps SDCH dictionaries in the disk cache of an
+// HttpCache, so that they are available right after a restart.
+//
+// Each dictionary is stored in its own entry, keyed by its server hash, and an
+// index entry lists the hashes of all the stored dictionaries so that they can
+// be loaded at startup without enumerating the cache. Entries may be evicted
+// (or deleted by the user) as any other cache entry.
+
+#ifndef NET_HTTP_SDCH_DICTIONARY_CACHE_H_
+#define NET_HTTP_SDCH_DICTIONARY_CACHE_H_
+
+#include <set>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "net/base/net_export.h"
+#include "net/base/sdch_manager.h"
+
+namespace net {
+
+class HttpCache;
+
+class NET_EXPORT SdchDictionaryCache
+    : public SdchDictionaryStore,
+      public NON_EXPORTED_BASE(base::NonThreadSafe) {
+ public:
+  explicit SdchDictionaryCache(HttpCache* cache);
+  virtual ~SdchDictionaryCache();
+
+  // SdchDictionaryStore implementation:
+  virtual void Save(const std::string& server_hash,
+                    const GURL& dictionary_url,
+                    const std::string& dictionary_text) OVERRIDE;
+  virtual void LoadAll(const LoadCallback& callback) OVERRIDE;
+  virtual void Load(const std::string& server_hash,
+                    const LoadCallback& callback) OVERRIDE;
+
+ private:
+  class Operation;
+
+  void OnIndexLoaded(const LoadCallback& callback, int result,
+                     const std::string& data);
+  void OnDictionaryLoaded(const std::string& server_hash,
+                          const LoadCallback& callback, int result,
+                          const std::string& data);
+
+  // Writes the list of stored hashes, once the previous list is known.
+  void WriteIndex();
+
+  base::WeakPtr<HttpCache> cache_;
+
+  // The hashes of the stored dictionaries.
+  std::set<std::string> hashes_;
+
+  // The hashes being loaded.
+  std::set<std::string> loading_;
+
+  bool index_loaded_;
+  bool index_dirty_;
+
+  base::WeakPtrFactory<SdchDictionaryCache> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SdchDictionaryCache);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_SDCH_DICTIONARY_CACHE_H_
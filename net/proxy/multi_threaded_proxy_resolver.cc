@@ -10,6 +10,7 @@
 #include "base/stringprintf.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
 #include "net/proxy/proxy_info.h"
@@ -32,6 +33,16 @@ class PurgeMemoryTask : public base::RefCountedThreadSafe<PurgeMemoryTask> {
   ProxyResolver* resolver_;
 };
 
+Value* NetLogSubmittedToResolverThreadCallback(
+    int thread_number,
+    int context_reuse_count,
+    NetLog::LogLevel /* log_level */) {
+  DictionaryValue* dict = new DictionaryValue();
+  dict->SetInteger("thread_number", thread_number);
+  dict->SetInteger("context_reuse_count", context_reuse_count);
+  return dict;
+}
+
 }  // namespace
 
 // An "executor" is a job-runner for PAC requests. It encapsulates a worker
@@ -68,12 +79,17 @@ class MultiThreadedProxyResolver::Executor
 
   int thread_number() const { return thread_number_; }
 
+  // Returns the number of requests |resolver_| has run since its PAC script
+  // was last set, that is, how many times its script context was reused.
+  int context_reuse_count() const { return context_reuse_count_; }
+
  private:
   friend class base::RefCountedThreadSafe<Executor>;
   ~Executor();
 
   MultiThreadedProxyResolver* coordinator_;
   const int thread_number_;
+  int context_reuse_count_;
 
   // The currently active job for this executor (either a SetPacScript or
   // GetProxyForURL task).
@@ -251,7 +267,9 @@ class MultiThreadedProxyResolver::GetProxyForURLJob
 
     net_log_.AddEvent(
         NetLog::TYPE_SUBMITTED_TO_RESOLVER_THREAD,
-        NetLog::IntegerCallback("thread_number", executor()->thread_number()));
+        base::Bind(&NetLogSubmittedToResolverThreadCallback,
+                   executor()->thread_number(),
+                   executor()->context_reuse_count()));
   }
 
   // Runs on the worker thread.
@@ -303,6 +321,7 @@ MultiThreadedProxyResolver::Executor::Executor(
     int thread_number)
     : coordinator_(coordinator),
       thread_number_(thread_number),
+      context_reuse_count_(0),
       resolver_(resolver) {
   DCHECK(coordinator);
   DCHECK(resolver);
@@ -319,10 +338,16 @@ void MultiThreadedProxyResolver::Executor::StartJob(Job* job) {
   DCHECK(!outstanding_job_);
   outstanding_job_ = job;
 
+  // Setting the PAC script gives |resolver_| a fresh script context.
+  if (job->type() != Job::TYPE_GET_PROXY_FOR_URL)
+    context_reuse_count_ = 0;
+
   // Run the job. Once it has completed (regardless of whether it was
   // cancelled), it will invoke OnJobCompleted() on this thread.
   job->set_executor(this);
   job->FinishedWaitingForThread();
+  if (job->type() == Job::TYPE_GET_PROXY_FOR_URL)
+    ++context_reuse_count_;
   thread_->message_loop()->PostTask(
       FROM_HERE,
       base::Bind(&Job::Run, job, base::MessageLoopProxy::current()));
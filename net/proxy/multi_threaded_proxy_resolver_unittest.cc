@@ -296,13 +296,19 @@ TEST(MultiThreadedProxyResolverTest, SingleThread_Basic) {
 
   ASSERT_EQ(2u, entries0.size());
   EXPECT_EQ(NetLog::TYPE_SUBMITTED_TO_RESOLVER_THREAD, entries0[0].type);
+  // Request 0 is the first to run in the PAC script's context.
+  int context_reuse_count = -1;
+  EXPECT_TRUE(entries0[0].GetIntegerValue("context_reuse_count",
+                                          &context_reuse_count));
+  EXPECT_EQ(0, context_reuse_count);
 
   // Start 3 more requests (request1 to request3).
 
   TestCompletionCallback callback1;
+  CapturingBoundNetLog log1;
   ProxyInfo results1;
   rv = resolver.GetProxyForURL(GURL("http://request1"), &results1,
-                               callback1.callback(), NULL, BoundNetLog());
+                               callback1.callback(), NULL, log1.bound());
   EXPECT_EQ(ERR_IO_PENDING, rv);
 
   TestCompletionCallback callback2;
@@ -324,6 +330,15 @@ TEST(MultiThreadedProxyResolverTest, SingleThread_Basic) {
   EXPECT_EQ(1, rv);
   EXPECT_EQ("PROXY request1:80", results1.ToPacString());
 
+  // Request 1 reused the context that request 0 ran in.
+  CapturingNetLog::CapturedEntryList entries1;
+  log1.GetEntries(&entries1);
+  ASSERT_LE(1u, entries1.size());
+  EXPECT_EQ(NetLog::TYPE_SUBMITTED_TO_RESOLVER_THREAD, entries1[0].type);
+  EXPECT_TRUE(entries1[0].GetIntegerValue("context_reuse_count",
+                                          &context_reuse_count));
+  EXPECT_EQ(1, context_reuse_count);
+
   rv = callback2.WaitForResult();
   EXPECT_EQ(2, rv);
   EXPECT_EQ("PROXY request2:80", results2.ToPacString());
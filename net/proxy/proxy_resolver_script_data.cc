@@ -4,9 +4,56 @@
 
 #include "net/proxy/proxy_resolver_script_data.h"
 
+#include <set>
+#include <string>
+#include <vector>
+
 #include "base/logging.h"
 #include "base/utf_string_conversions.h"
 
+namespace {
+
+// Identifiers which let a PAC script's result depend on something other than
+// the host, either by reaching the URL without naming the parameter, or by
+// depending on the time of day.
+const char* const kDisqualifyingIdentifiers[] = {
+  "arguments",
+  "eval",
+  "Function",
+  "FindProxyForURLEx",
+  "Date",
+  "dateRange",
+  "timeRange",
+  "weekdayRange",
+};
+
+bool IsIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9') || c == '_' || c == '$';
+}
+
+// Splits |script| into its identifiers (and keywords), in order. Every other
+// character is dropped, except for parentheses and commas.
+std::vector<std::string> TokenizeScript(const std::string& script) {
+  std::vector<std::string> tokens;
+  size_t i = 0;
+  while (i < script.size()) {
+    if (IsIdentifierChar(script[i])) {
+      size_t start = i;
+      while (i < script.size() && IsIdentifierChar(script[i]))
+        ++i;
+      tokens.push_back(script.substr(start, i - start));
+    } else {
+      if (script[i] == '(' || script[i] == ')' || script[i] == ',')
+        tokens.push_back(std::string(1, script[i]));
+      ++i;
+    }
+  }
+  return tokens;
+}
+
+}  // namespace
+
 namespace net {
 
 // static
@@ -62,6 +109,33 @@ bool ProxyResolverScriptData::Equals(
   return false;  // Shouldn't be reached.
 }
 
+bool ProxyResolverScriptData::DependsOnlyOnHost() const {
+  std::vector<std::string> tokens = TokenizeScript(UTF16ToUTF8(utf16()));
+
+  // Find the name of the |url| parameter in
+  // "function FindProxyForURL(url, host)".
+  size_t url_param = tokens.size();
+  for (size_t i = 0; i + 4 < tokens.size(); ++i) {
+    if (tokens[i] == "function" && tokens[i + 1] == "FindProxyForURL" &&
+        tokens[i + 2] == "(" && tokens[i + 4] == ",") {
+      url_param = i + 3;
+      break;
+    }
+  }
+  if (url_param == tokens.size())
+    return false;
+
+  std::set<std::string> disqualifying(
+      kDisqualifyingIdentifiers,
+      kDisqualifyingIdentifiers + arraysize(kDisqualifyingIdentifiers));
+  disqualifying.insert(tokens[url_param]);
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    if (i != url_param && disqualifying.count(tokens[i]))
+      return false;
+  }
+  return true;
+}
+
 ProxyResolverScriptData::ProxyResolverScriptData(Type type,
                                                  const GURL& url,
                                                  const string16& utf16)
@@ -56,6 +56,14 @@ class NET_EXPORT_PRIVATE ProxyResolverScriptData
   // Returns true if |this| matches |other|.
   bool Equals(const ProxyResolverScriptData* other) const;
 
+  // Returns true if the result of the script's FindProxyForURL(url, host)
+  // can only depend on |host| (and on the network, through functions like
+  // dnsResolve()). This is a conservative textual check: it returns false
+  // if the script mentions the |url| parameter anywhere outside of the
+  // parameter list, or uses the time-of-day functions, |arguments| or
+  // eval(). Only valid for type() == TYPE_SCRIPT_CONTENTS.
+  bool DependsOnlyOnHost() const;
+
  private:
   friend class base::RefCountedThreadSafe<ProxyResolverScriptData>;
   ProxyResolverScriptData(Type type,
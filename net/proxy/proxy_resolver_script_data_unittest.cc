@@ -0,0 +1,56 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/proxy/proxy_resolver_script_data.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace {
+
+TEST(ProxyResolverScriptDataTest, DependsOnlyOnHost) {
+  struct TestCase {
+    const char* script;
+    bool depends_only_on_host;
+  };
+  static const TestCase kTests[] = {
+    // Only uses |host|.
+    { "function FindProxyForURL(url, host) {\n"
+      "  if (dnsDomainIs(host, '.example.com')) return 'DIRECT';\n"
+      "  return 'PROXY proxy:80';\n"
+      "}\n",
+      true },
+    // Parameters may have any name.
+    { "function FindProxyForURL(u, h) { return h == 'a' ? 'DIRECT' : ''; }",
+      true },
+    // Uses the URL.
+    { "function FindProxyForURL(url, host) {\n"
+      "  if (shExpMatch(url, 'https:*')) return 'DIRECT';\n"
+      "  return 'PROXY proxy:80';\n"
+      "}\n",
+      false },
+    // Passes the URL on to a helper.
+    { "function FindProxyForURL(url, host) { return helper(url); }", false },
+    // Reaches the URL without naming it.
+    { "function FindProxyForURL(url, host) { return arguments[0]; }", false },
+    // Depends on the time of day.
+    { "function FindProxyForURL(url, host) {\n"
+      "  return timeRange(9, 17) ? 'PROXY proxy:80' : 'DIRECT';\n"
+      "}\n",
+      false },
+    // No recognizable FindProxyForURL().
+    { "var FindProxyForURL = function(url, host) { return 'DIRECT'; };",
+      false },
+  };
+
+  for (size_t i = 0; i < arraysize(kTests); ++i) {
+    scoped_refptr<ProxyResolverScriptData> script_data =
+        ProxyResolverScriptData::FromUTF8(kTests[i].script);
+    EXPECT_EQ(kTests[i].depends_only_on_host, script_data->DependsOnlyOnHost())
+        << kTests[i].script;
+  }
+}
+
+}  // namespace
+}  // namespace net
@@ -26,6 +26,7 @@
 #include "net/proxy/network_delegate_error_observer.h"
 #include "net/proxy/proxy_config_service_fixed.h"
 #include "net/proxy/proxy_resolver.h"
+#include "net/proxy/proxy_resolver_script_data.h"
 #include "net/proxy/proxy_script_decider.h"
 #include "net/proxy/proxy_script_fetcher.h"
 #include "net/proxy/sync_host_resolver_bridge.h"
@@ -75,6 +76,10 @@ const size_t kMaxNumNetLogEntries = 100;
 // sorts of problems.
 const int64 kDelayAfterNetworkChangesMs = 2000;
 
+// The largest number of hosts to keep PAC results for. The cache is simply
+// emptied when it gets full.
+const size_t kMaxPacResultCacheEntries = 1000;
+
 // This is the default policy for polling the PAC script.
 //
 // In response to a failure, the poll intervals are:
@@ -733,6 +738,7 @@ class ProxyService::PacRequest
         results_(results),
         url_(url),
         resolve_job_(NULL),
+        used_resolver_(false),
         config_id_(ProxyConfig::kInvalidConfigID),
         config_source_(PROXY_CONFIG_SOURCE_UNKNOWN),
         net_log_(net_log) {
@@ -748,6 +754,7 @@ class ProxyService::PacRequest
 
     config_id_ = service_->config_.id();
     config_source_ = service_->config_.source();
+    used_resolver_ = true;
 
     return resolver()->GetProxyForURL(
         url_, results_,
@@ -806,8 +813,12 @@ class ProxyService::PacRequest
     results_->config_source_ = config_source_;
     results_->did_use_pac_script_ = true;
 
+    if (result_code == OK && used_resolver_)
+      service_->MaybeCachePacResult(url_, config_id_, *results_);
+
     // Reset the state associated with in-progress-resolve.
     resolve_job_ = NULL;
+    used_resolver_ = false;
     config_id_ = ProxyConfig::kInvalidConfigID;
     config_source_ = PROXY_CONFIG_SOURCE_UNKNOWN;
 
@@ -850,6 +861,7 @@ class ProxyService::PacRequest
   ProxyInfo* results_;
   GURL url_;
   ProxyResolver::RequestHandle resolve_job_;
+  bool used_resolver_;  // True once the resolve has been started.
   ProxyConfig::ID config_id_;  // The config id when the resolve was started.
   ProxyConfigSource config_source_;  // The source of proxy settings.
   BoundNetLog net_log_;
@@ -865,7 +877,9 @@ ProxyService::ProxyService(ProxyConfigService* config_service,
       current_state_(STATE_NONE) ,
       net_log_(net_log),
       stall_proxy_auto_config_delay_(TimeDelta::FromMilliseconds(
-          kDelayAfterNetworkChangesMs)) {
+          kDelayAfterNetworkChangesMs)),
+      pac_result_cache_enabled_(false),
+      pac_script_depends_only_on_host_(false) {
   NetworkChangeNotifier::AddIPAddressObserver(this);
   NetworkChangeNotifier::AddDNSObserver(this);
   ResetConfigService(config_service);
@@ -1011,8 +1025,11 @@ int ProxyService::TryToCompleteSynchronously(const GURL& url,
   if (permanent_error_ != OK)
     return permanent_error_;
 
-  if (config_.HasAutomaticSettings())
+  if (config_.HasAutomaticSettings()) {
+    if (GetCachedPacResult(url, result))
+      return OK;
     return ERR_IO_PENDING;  // Must submit the request to the proxy resolver.
+  }
 
   // Use the manual proxy settings.
   config_.proxy_rules().Apply(url, result);
@@ -1021,6 +1038,32 @@ int ProxyService::TryToCompleteSynchronously(const GURL& url,
   return OK;
 }
 
+bool ProxyService::GetCachedPacResult(const GURL& url, ProxyInfo* result) {
+  PacResultCache::const_iterator it = pac_result_cache_.find(url.host());
+  if (it == pac_result_cache_.end())
+    return false;
+
+  result->Use(it->second);
+  result->config_source_ = config_.source();
+  result->config_id_ = config_.id();
+  result->did_use_pac_script_ = true;
+  return true;
+}
+
+void ProxyService::MaybeCachePacResult(const GURL& url,
+                                       ProxyConfig::ID config_id,
+                                       const ProxyInfo& result) {
+  if (!pac_result_cache_enabled_ || !pac_script_depends_only_on_host_)
+    return;
+  // The result may be for a PAC script that has since been replaced.
+  if (current_state_ != STATE_READY || config_id != config_.id())
+    return;
+
+  if (pac_result_cache_.size() >= kMaxPacResultCacheEntries)
+    pac_result_cache_.clear();
+  pac_result_cache_[url.host()].Use(result);
+}
+
 ProxyService::~ProxyService() {
   NetworkChangeNotifier::RemoveIPAddressObserver(this);
   NetworkChangeNotifier::RemoveDNSObserver(this);
@@ -1117,6 +1160,12 @@ void ProxyService::OnInitProxyResolverComplete(int result) {
       init_proxy_resolver_->script_data(),
       NULL));
 
+  ProxyResolverScriptData* script_data = init_proxy_resolver_->script_data();
+  pac_script_depends_only_on_host_ =
+      result == OK && script_data &&
+      script_data->type() == ProxyResolverScriptData::TYPE_SCRIPT_CONTENTS &&
+      script_data->DependsOnlyOnHost();
+
   init_proxy_resolver_.reset();
 
   if (result != OK) {
@@ -1278,6 +1327,8 @@ ProxyService::State ProxyService::ResetProxyConfig(bool reset_fetched_config) {
 
   permanent_error_ = OK;
   proxy_retry_info_.clear();
+  pac_script_depends_only_on_host_ = false;
+  pac_result_cache_.clear();
   script_poller_.reset();
   init_proxy_resolver_.reset();
   SuspendAllPendingRequests();
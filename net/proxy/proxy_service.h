@@ -5,6 +5,7 @@
 #ifndef NET_PROXY_PROXY_SERVICE_H_
 #define NET_PROXY_PROXY_SERVICE_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -201,6 +202,18 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // to downloading and testing the PAC files.
   void ForceReloadProxyConfig();
 
+  // Enables caching of PAC script results by host. The cache is only used
+  // when the PAC script's result depends on nothing but the host (see
+  // ProxyResolverScriptData::DependsOnlyOnHost()), and is cleared whenever
+  // the PAC script is reloaded or the network changes. Off by default.
+  void set_pac_result_cache_enabled(bool enabled) {
+    pac_result_cache_enabled_ = enabled;
+    pac_result_cache_.clear();
+  }
+
+  // Returns the number of hosts with a cached PAC result. Used by tests.
+  size_t pac_result_cache_size() const { return pac_result_cache_.size(); }
+
   // Same as CreateProxyServiceUsingV8ProxyResolver, except it uses system
   // libraries for evaluating the PAC script if available, otherwise skips
   // proxy autoconfig.
@@ -264,6 +277,9 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // which expects requests to finish in the order they were added.
   typedef std::vector<scoped_refptr<PacRequest> > PendingRequests;
 
+  // PAC script results, keyed by host.
+  typedef std::map<std::string, ProxyInfo> PacResultCache;
+
   enum State {
     STATE_NONE,
     STATE_WAITING_FOR_PROXY_CONFIG,
@@ -292,6 +308,17 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // Completing synchronously means we don't need to query ProxyResolver.
   int TryToCompleteSynchronously(const GURL& url, ProxyInfo* result);
 
+  // Fills |result| from |pac_result_cache_| and returns true if there is a
+  // cached PAC result for the host of |url|.
+  bool GetCachedPacResult(const GURL& url, ProxyInfo* result);
+
+  // Adds |result|, which the ProxyResolver returned for |url| under the
+  // configuration |config_id|, to |pac_result_cache_| if it can be reused for
+  // other URLs on the same host.
+  void MaybeCachePacResult(const GURL& url,
+                           ProxyConfig::ID config_id,
+                           const ProxyInfo& result);
+
   // Cancels all of the requests sent to the ProxyResolver. These will be
   // restarted when calling ResumeAllPendingRequests().
   void SuspendAllPendingRequests();
@@ -394,6 +421,12 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // The amount of time to stall requests following IP address changes.
   base::TimeDelta stall_proxy_auto_config_delay_;
 
+  // Whether PAC results may be cached by host, whether the current PAC
+  // script allows it, and the cached results.
+  bool pac_result_cache_enabled_;
+  bool pac_script_depends_only_on_host_;
+  PacResultCache pac_result_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(ProxyService);
 };
 
@@ -1414,6 +1414,109 @@ TEST_F(ProxyServiceTest, InitialPACScriptDownload) {
   EXPECT_EQ("request3:80", info3.proxy_server().ToURI());
 }
 
+// Test that results of a PAC script which only looks at the host are cached
+// by host, until the PAC script is reloaded.
+TEST_F(ProxyServiceTest, PacResultCacheForHostOnlyScript) {
+  static const char kHostOnlyPacScript[] =
+      "function FindProxyForURL(url, host) {\n"
+      "  return isPlainHostName(host) ? 'DIRECT' : 'PROXY foopy:80';\n"
+      "}\n";
+
+  MockProxyConfigService* config_service =
+      new MockProxyConfigService("http://foopy/proxy.pac");
+
+  MockAsyncProxyResolverExpectsBytes* resolver =
+      new MockAsyncProxyResolverExpectsBytes;
+
+  ProxyService service(config_service, resolver, NULL);
+  service.set_pac_result_cache_enabled(true);
+
+  MockProxyScriptFetcher* fetcher = new MockProxyScriptFetcher;
+  service.SetProxyScriptFetchers(fetcher,
+                                 new DoNothingDhcpProxyScriptFetcher());
+
+  ProxyInfo info1;
+  TestCompletionCallback callback1;
+  int rv = service.ResolveProxy(GURL("http://request1/a"), &info1,
+                                callback1.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  fetcher->NotifyFetchCompletion(OK, kHostOnlyPacScript);
+  resolver->pending_set_pac_script_request()->CompleteNow(OK);
+
+  ASSERT_EQ(1u, resolver->pending_requests().size());
+  resolver->pending_requests()[0]->results()->UseNamedProxy("foopy:80");
+  resolver->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback1.WaitForResult());
+  EXPECT_EQ("foopy:80", info1.proxy_server().ToURI());
+  EXPECT_EQ(1u, service.pac_result_cache_size());
+
+  // Another URL on the same host completes synchronously from the cache.
+  ProxyInfo info2;
+  TestCompletionCallback callback2;
+  rv = service.ResolveProxy(GURL("https://request1/b"), &info2,
+                            callback2.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(OK, rv);
+  EXPECT_EQ("foopy:80", info2.proxy_server().ToURI());
+  EXPECT_TRUE(info2.did_use_pac_script());
+  EXPECT_TRUE(resolver->pending_requests().empty());
+
+  // A different host still goes to the resolver.
+  ProxyInfo info3;
+  TestCompletionCallback callback3;
+  rv = service.ResolveProxy(GURL("http://request2/a"), &info3,
+                            callback3.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  ASSERT_EQ(1u, resolver->pending_requests().size());
+  resolver->pending_requests()[0]->results()->UseNamedProxy("foopy:80");
+  resolver->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback3.WaitForResult());
+  EXPECT_EQ(2u, service.pac_result_cache_size());
+
+  // Reloading the PAC script empties the cache.
+  service.ForceReloadProxyConfig();
+  EXPECT_EQ(0u, service.pac_result_cache_size());
+}
+
+// Test that results of a PAC script which looks at the URL are not cached.
+TEST_F(ProxyServiceTest, NoPacResultCacheForUrlDependentScript) {
+  MockProxyConfigService* config_service =
+      new MockProxyConfigService("http://foopy/proxy.pac");
+
+  MockAsyncProxyResolverExpectsBytes* resolver =
+      new MockAsyncProxyResolverExpectsBytes;
+
+  ProxyService service(config_service, resolver, NULL);
+  service.set_pac_result_cache_enabled(true);
+
+  MockProxyScriptFetcher* fetcher = new MockProxyScriptFetcher;
+  service.SetProxyScriptFetchers(fetcher,
+                                 new DoNothingDhcpProxyScriptFetcher());
+
+  ProxyInfo info1;
+  TestCompletionCallback callback1;
+  int rv = service.ResolveProxy(GURL("http://request1/a"), &info1,
+                                callback1.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  // kValidPacScript1 is not known to depend only on the host.
+  fetcher->NotifyFetchCompletion(OK, kValidPacScript1);
+  resolver->pending_set_pac_script_request()->CompleteNow(OK);
+
+  ASSERT_EQ(1u, resolver->pending_requests().size());
+  resolver->pending_requests()[0]->results()->UseNamedProxy("foopy:80");
+  resolver->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback1.WaitForResult());
+  EXPECT_EQ(0u, service.pac_result_cache_size());
+
+  ProxyInfo info2;
+  TestCompletionCallback callback2;
+  rv = service.ResolveProxy(GURL("http://request1/b"), &info2,
+                            callback2.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(1u, resolver->pending_requests().size());
+}
+
 // Test changing the ProxyScriptFetcher while PAC download is in progress.
 TEST_F(ProxyServiceTest, ChangeScriptFetcherWhilePACDownloadInProgress) {
   MockProxyConfigService* config_service =
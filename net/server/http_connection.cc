@@ -12,6 +12,14 @@
 
 namespace net {
 
+namespace {
+
+// The body of a streamed response is only produced while less than this much
+// data is waiting to be written to the socket.
+const int kMaxPendingBodySize = 256 * 1024;
+
+}  // namespace
+
 int HttpConnection::last_id_ = 0;
 
 void HttpConnection::Send(const std::string& data) {
@@ -62,9 +70,26 @@ void HttpConnection::Send500(const std::string& message) {
       message.c_str()));
 }
 
+void HttpConnection::SendStreamed200(const HttpServer::BodyProducer& producer,
+                                     const std::string& content_type) {
+  if (!socket_)
+    return;
+  DCHECK(!streaming());
+  socket_->Send(base::StringPrintf(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type:%s\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n",
+      content_type.c_str()));
+  body_producer_ = producer;
+  PumpBody();
+}
+
 HttpConnection::HttpConnection(HttpServer* server, StreamListenSocket* sock)
     : server_(server),
-      socket_(sock) {
+      socket_(sock),
+      close_after_response_(false),
+      close_when_drained_(false) {
   id_ = last_id_++;
 }
 
@@ -77,8 +102,27 @@ void HttpConnection::DetachSocket() {
   socket_ = NULL;
 }
 
+void HttpConnection::PumpBody() {
+  while (socket_ && socket_->send_pending_size() < kMaxPendingBodySize) {
+    std::string data;
+    bool more = body_producer_.Run(&data);
+    DCHECK(!more || !data.empty());
+    if (!data.empty()) {
+      socket_->Send(base::StringPrintf("%X\r\n",
+                                       static_cast<unsigned>(data.length())));
+      socket_->Send(data, true /* append_linefeed */);
+    }
+    if (!more) {
+      body_producer_.Reset();
+      socket_->Send("0\r\n\r\n");
+      server_->DidFinishResponse(this);
+      return;
+    }
+  }
+}
+
 void HttpConnection::Shift(int num_bytes) {
-  recv_data_ = recv_data_.substr(num_bytes);
+  recv_data_.erase(0, num_bytes);
 }
 
 }  // namespace net
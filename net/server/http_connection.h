@@ -10,10 +10,10 @@
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "net/server/http_server.h"
 
 namespace net {
 
-class HttpServer;
 class StreamListenSocket;
 class WebSocket;
 
@@ -26,12 +26,18 @@ class HttpConnection {
   void Send200(const std::string& data, const std::string& content_type);
   void Send404();
   void Send500(const std::string& message);
+  void SendStreamed200(const HttpServer::BodyProducer& producer,
+                       const std::string& content_type);
 
   void Shift(int num_bytes);
 
   const std::string& recv_data() const { return recv_data_; }
   int id() const { return id_; }
 
+  // Whether the body of a response sent with SendStreamed200() is still
+  // being produced.
+  bool streaming() const { return !body_producer_.is_null(); }
+
  private:
   friend class HttpServer;
   static int last_id_;
@@ -40,11 +46,24 @@ class HttpConnection {
 
   void DetachSocket();
 
+  // Sends chunks of the streamed response body until the socket has enough
+  // data waiting to be written or the body is complete.
+  void PumpBody();
+
   HttpServer* server_;
   scoped_refptr<StreamListenSocket> socket_;
   scoped_ptr<WebSocket> web_socket_;
   std::string recv_data_;
   int id_;
+
+  HttpServer::BodyProducer body_producer_;
+  // Set when a request asks for the connection to be closed. Requests after
+  // it are ignored.
+  bool close_after_response_;
+  // Set when the response to that request has been passed to the socket but
+  // not all of it has been written yet.
+  bool close_when_drained_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpConnection);
 };
 
@@ -4,9 +4,13 @@
 
 #include "net/server/http_server.h"
 
+#include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/message_loop.h"
 #include "base/stl_util.h"
+#include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/sys_byteorder.h"
@@ -18,6 +22,14 @@
 
 namespace net {
 
+namespace {
+
+// Connections that have more than this many bytes of requests or WebSocket
+// messages waiting to be processed are closed.
+const size_t kMaxRecvDataSize = 10 * 1024 * 1024;
+
+}  // namespace
+
 HttpServer::HttpServer(const StreamListenSocketFactory& factory,
                        HttpServer::Delegate* delegate)
     : delegate_(delegate),
@@ -67,6 +79,7 @@ void HttpServer::Send200(int connection_id,
   if (connection == NULL)
     return;
   connection->Send200(data, content_type);
+  DidFinishResponse(connection);
 }
 
 void HttpServer::Send404(int connection_id) {
@@ -74,6 +87,7 @@ void HttpServer::Send404(int connection_id) {
   if (connection == NULL)
     return;
   connection->Send404();
+  DidFinishResponse(connection);
 }
 
 void HttpServer::Send500(int connection_id, const std::string& message) {
@@ -81,6 +95,16 @@ void HttpServer::Send500(int connection_id, const std::string& message) {
   if (connection == NULL)
     return;
   connection->Send500(message);
+  DidFinishResponse(connection);
+}
+
+void HttpServer::SendStreamed200(int connection_id,
+                                 const BodyProducer& producer,
+                                 const std::string& content_type) {
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL)
+    return;
+  connection->SendStreamed200(producer, content_type);
 }
 
 void HttpServer::Close(int connection_id) {
@@ -113,43 +137,13 @@ void HttpServer::DidRead(StreamListenSocket* socket,
     return;
 
   connection->recv_data_.append(data, len);
-  while (connection->recv_data_.length()) {
-    if (connection->web_socket_.get()) {
-      std::string message;
-      WebSocket::ParseResult result = connection->web_socket_->Read(&message);
-      if (result == WebSocket::FRAME_INCOMPLETE)
-        break;
-
-      if (result == WebSocket::FRAME_CLOSE ||
-          result == WebSocket::FRAME_ERROR) {
-        Close(connection->id());
-        break;
-      }
-      delegate_->OnWebSocketMessage(connection->id(), message);
-      continue;
-    }
-
-    HttpServerRequestInfo request;
-    size_t pos = 0;
-    if (!ParseHeaders(connection, &request, &pos))
-      break;
-
-    std::string connection_header = request.GetHeaderValue("Connection");
-    if (connection_header == "Upgrade") {
-      connection->web_socket_.reset(WebSocket::CreateWebSocket(connection,
-                                                               request,
-                                                               &pos));
-
-      if (!connection->web_socket_.get())  // Not enought data was received.
-        break;
-      delegate_->OnWebSocketRequest(connection->id(), request);
-      connection->Shift(pos);
-      continue;
-    }
-    // Request body is not supported. It is always empty.
-    delegate_->OnHttpRequest(connection->id(), request);
-    connection->Shift(pos);
+  if (connection->recv_data_.length() > kMaxRecvDataSize) {
+    LOG(ERROR) << "Closing connection " << connection->id()
+               << ": too much unprocessed data";
+    Close(connection->id());
+    return;
   }
+  ProcessRecvData(connection->id());
 }
 
 void HttpServer::DidClose(StreamListenSocket* socket) {
@@ -160,6 +154,19 @@ void HttpServer::DidClose(StreamListenSocket* socket) {
   delete connection;
 }
 
+void HttpServer::DidDrainSendBuffer(StreamListenSocket* socket) {
+  HttpConnection* connection = FindConnection(socket);
+  if (connection == NULL)
+    return;
+
+  if (connection->streaming()) {
+    connection->PumpBody();
+  } else if (connection->close_when_drained_) {
+    MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&HttpServer::Close, this, connection->id()));
+  }
+}
+
 HttpServer::~HttpServer() {
   STLDeleteContainerPairSecondPointers(
       id_to_connection_.begin(), id_to_connection_.end());
@@ -256,7 +263,6 @@ bool HttpServer::ParseHeaders(HttpConnection* connection,
           break;
         case ST_PROTO:
           // TODO(mbelshe): Deal better with parsing protocol.
-          DCHECK(buffer == "HTTP/1.1");
           buffer.clear();
           break;
         case ST_NAME:
@@ -297,6 +303,94 @@ bool HttpServer::ParseHeaders(HttpConnection* connection,
   return false;
 }
 
+void HttpServer::ProcessRecvData(int connection_id) {
+  HttpConnection* connection = FindConnection(connection_id);
+  // Requests pipelined behind a streamed response wait until its body is
+  // complete, and requests after one that closes the connection are ignored.
+  // The delegate may close the connection, so it is looked up again after
+  // every call.
+  while (connection && !connection->recv_data_.empty() &&
+         !connection->streaming() && !connection->close_after_response_) {
+    if (connection->web_socket_.get()) {
+      std::string message;
+      WebSocket::ParseResult result = connection->web_socket_->Read(&message);
+      if (result == WebSocket::FRAME_INCOMPLETE)
+        break;
+
+      if (result == WebSocket::FRAME_CLOSE ||
+          result == WebSocket::FRAME_ERROR) {
+        Close(connection_id);
+        break;
+      }
+      delegate_->OnWebSocketMessage(connection_id, message);
+      connection = FindConnection(connection_id);
+      continue;
+    }
+
+    HttpServerRequestInfo request;
+    size_t pos = 0;
+    if (!ParseHeaders(connection, &request, &pos))
+      break;
+
+    std::string connection_header = request.GetHeaderValue("Connection");
+    if (connection_header == "Upgrade") {
+      connection->web_socket_.reset(WebSocket::CreateWebSocket(connection,
+                                                               request,
+                                                               &pos));
+
+      if (!connection->web_socket_.get())  // Not enought data was received.
+        break;
+      connection->Shift(pos);
+      delegate_->OnWebSocketRequest(connection_id, request);
+      connection = FindConnection(connection_id);
+      continue;
+    }
+
+    std::string content_length = request.GetHeaderValue("Content-Length");
+    if (!content_length.empty()) {
+      int body_length;
+      if (!base::StringToInt(content_length, &body_length) ||
+          body_length < 0 ||
+          static_cast<size_t>(body_length) > kMaxRecvDataSize) {
+        Close(connection_id);
+        break;
+      }
+      if (connection->recv_data_.length() - pos <
+          static_cast<size_t>(body_length)) {
+        break;
+      }
+      request.data = connection->recv_data_.substr(pos, body_length);
+      pos += body_length;
+    }
+
+    if (LowerCaseEqualsASCII(connection_header, "close"))
+      connection->close_after_response_ = true;
+    connection->Shift(pos);
+    delegate_->OnHttpRequest(connection_id, request);
+    connection = FindConnection(connection_id);
+  }
+}
+
+void HttpServer::DidFinishResponse(HttpConnection* connection) {
+  if (connection->close_after_response_) {
+    // Close once the socket has written the whole response.
+    if (connection->socket_->send_pending_size() > 0) {
+      connection->close_when_drained_ = true;
+    } else {
+      MessageLoop::current()->PostTask(
+          FROM_HERE, base::Bind(&HttpServer::Close, this, connection->id()));
+    }
+    return;
+  }
+
+  // Requests pipelined behind a streamed response were held back.
+  if (!connection->recv_data_.empty()) {
+    MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&HttpServer::ProcessRecvData, this, connection->id()));
+  }
+}
+
 HttpConnection* HttpServer::FindConnection(int connection_id) {
   IdToConnectionMap::iterator it = id_to_connection_.find(connection_id);
   if (it == id_to_connection_.end())
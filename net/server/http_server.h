@@ -9,6 +9,7 @@
 #include <map>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/stream_listen_socket.h"
 
@@ -24,6 +25,8 @@ class HttpServer : public StreamListenSocket::Delegate,
  public:
   class Delegate {
    public:
+    // Requests pipelined on a connection are passed in order, and must be
+    // answered in the same order.
     virtual void OnHttpRequest(int connection_id,
                                const HttpServerRequestInfo& info) = 0;
 
@@ -39,6 +42,11 @@ class HttpServer : public StreamListenSocket::Delegate,
     virtual ~Delegate() {}
   };
 
+  // Supplies the body of a response sent with SendStreamed200(), a piece at
+  // a time. Appends the next piece to |data| and returns true if more of the
+  // body follows, or returns false once the whole body has been supplied.
+  typedef base::Callback<bool(std::string* data)> BodyProducer;
+
   HttpServer(const StreamListenSocketFactory& socket_factory,
              HttpServer::Delegate* delegate);
 
@@ -52,6 +60,14 @@ class HttpServer : public StreamListenSocket::Delegate,
                const std::string& mime_type);
   void Send404(int connection_id);
   void Send500(int connection_id, const std::string& message);
+  // Sends a 200 response with chunked transfer encoding whose body is pulled
+  // from |producer|. |producer| is only run while little of the response is
+  // waiting to be written to the socket, so large bodies are never held in
+  // memory at once. Requests pipelined behind this one are not passed to the
+  // delegate until the whole body has been sent.
+  void SendStreamed200(int connection_id,
+                       const BodyProducer& producer,
+                       const std::string& content_type);
   void Close(int connection_id);
 
   // Copies the local address to |address|. Returns a network error code.
@@ -64,6 +80,7 @@ class HttpServer : public StreamListenSocket::Delegate,
                        const char* data,
                        int len) OVERRIDE;
   virtual void DidClose(StreamListenSocket* socket) OVERRIDE;
+  virtual void DidDrainSendBuffer(StreamListenSocket* socket) OVERRIDE;
 
  protected:
   virtual ~HttpServer();
@@ -79,6 +96,14 @@ class HttpServer : public StreamListenSocket::Delegate,
                     HttpServerRequestInfo* info,
                     size_t* pos);
 
+  // Passes the complete requests or WebSocket messages buffered on the
+  // connection to the delegate, in order.
+  void ProcessRecvData(int connection_id);
+
+  // Called once the whole response to a request on |connection| has been
+  // passed to its socket.
+  void DidFinishResponse(HttpConnection* connection);
+
   HttpConnection* FindConnection(int connection_id);
   HttpConnection* FindConnection(StreamListenSocket* socket);
 
@@ -125,6 +125,7 @@ void ClientSocketHandle::HandleInitCompletion(int result) {
 
   ClientSocketPoolHistograms* histograms = pool_->histograms();
   histograms->AddSocketType(reuse_type());
+  histograms->AddWarmSocket(reuse_type() != ClientSocketHandle::UNUSED);
   switch (reuse_type()) {
     case ClientSocketHandle::UNUSED:
       histograms->AddRequestTime(setup_time());
@@ -5,6 +5,10 @@
 #include "net/socket/client_socket_pool_base.h"
 
 #include <math.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "base/compiler_specific.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
@@ -39,6 +43,14 @@ const int kCleanupInterval = 10;  // DO NOT INCREASE THIS TIMEOUT.
 // after a certain timeout has passed without receiving an ACK.
 bool g_connect_backup_jobs_enabled = true;
 
+// Indicate whether pools learn how many sockets each group needs. See
+// ClientSocketPoolBaseHelper::set_adaptive_preconnect_enabled().
+bool g_adaptive_preconnect_enabled = false;
+
+// The number of groups whose concurrency is remembered by adaptive
+// preconnects. The least recently requested group is forgotten first.
+const size_t kMaxGroupHistoryEntries = 1000;
+
 double g_socket_reuse_policy_penalty_exponent = -1;
 int g_socket_reuse_policy = -1;
 
@@ -161,6 +173,11 @@ ClientSocketPoolBaseHelper::Request::Request(
 
 ClientSocketPoolBaseHelper::Request::~Request() {}
 
+ClientSocketPoolBaseHelper::Request*
+ClientSocketPoolBaseHelper::Request::CreatePreconnectRequest() const {
+  return NULL;
+}
+
 ClientSocketPoolBaseHelper::ClientSocketPoolBaseHelper(
     int max_sockets,
     int max_sockets_per_group,
@@ -177,6 +194,7 @@ ClientSocketPoolBaseHelper::ClientSocketPoolBaseHelper(
       used_idle_socket_timeout_(used_idle_socket_timeout),
       connect_job_factory_(connect_job_factory),
       connect_backup_jobs_enabled_(false),
+      adaptive_preconnect_enabled_(g_adaptive_preconnect_enabled),
       pool_generation_number_(0),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
   DCHECK_LE(0, max_sockets_per_group);
@@ -260,6 +278,12 @@ int ClientSocketPoolBaseHelper::RequestSocket(
   request->net_log().BeginEvent(NetLog::TYPE_SOCKET_POOL);
   Group* group = GetOrCreateGroup(group_name);
 
+  if (adaptive_preconnect_enabled_) {
+    RecordRequestInHistory(group_name, *group);
+    if (!group->preconnect_request())
+      group->set_preconnect_request(request->CreatePreconnectRequest());
+  }
+
   int rv = RequestSocketInternal(group_name, request);
   if (rv != ERR_IO_PENDING) {
     request->net_log().EndEventWithNetErrorCode(NetLog::TYPE_SOCKET_POOL, rv);
@@ -282,6 +306,13 @@ void ClientSocketPoolBaseHelper::RequestSockets(
   if (!use_cleanup_timer_)
     CleanupIdleSockets(false);
 
+  if (adaptive_preconnect_enabled_) {
+    // Preconnect as many sockets as the group has needed at once before.
+    GroupHistoryMap::const_iterator it = group_history_.find(group_name);
+    if (it != group_history_.end())
+      num_sockets = it->second.max_concurrency;
+  }
+
   if (num_sockets > max_sockets_per_group_) {
     num_sockets = max_sockets_per_group_;
   }
@@ -291,6 +322,8 @@ void ClientSocketPoolBaseHelper::RequestSockets(
       NetLog::IntegerCallback("num_sockets", num_sockets));
 
   Group* group = GetOrCreateGroup(group_name);
+  if (adaptive_preconnect_enabled_ && !group->preconnect_request())
+    group->set_preconnect_request(request.CreatePreconnectRequest());
 
   // RequestSocketsInternal() may delete the group.
   bool deleted_group = false;
@@ -662,6 +695,9 @@ void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
   // inside the inner loop, since it shouldn't change by any meaningful amount.
   base::TimeTicks now = base::TimeTicks::Now();
 
+  // Groups with unused sockets that the server closed before they timed out.
+  std::vector<std::string> groups_to_refill;
+
   GroupMap::iterator i = group_map_.begin();
   while (i != group_map_.end()) {
     Group* group = i->second;
@@ -672,6 +708,10 @@ void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
           j->socket->WasEverUsed() ?
           used_idle_socket_timeout_ : unused_idle_socket_timeout_;
       if (force || j->ShouldCleanup(now, timeout)) {
+        if (!force && adaptive_preconnect_enabled_ &&
+            !j->socket->WasEverUsed() && now - j->start_time < timeout) {
+          groups_to_refill.push_back(i->first);
+        }
         delete j->socket;
         j = group->mutable_idle_sockets()->erase(j);
         DecrementIdleCount();
@@ -680,13 +720,17 @@ void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
       }
     }
 
-    // Delete group if no longer needed.
-    if (group->IsEmpty()) {
+    // Delete group if no longer needed, unless it is about to be refilled.
+    if (group->IsEmpty() &&
+        (groups_to_refill.empty() || groups_to_refill.back() != i->first)) {
       RemoveGroup(i++);
     } else {
       ++i;
     }
   }
+
+  for (size_t k = 0; k < groups_to_refill.size(); ++k)
+    ReplaceIdleSocket(groups_to_refill[k], now);
 }
 
 ClientSocketPoolBaseHelper::Group* ClientSocketPoolBaseHelper::GetOrCreateGroup(
@@ -727,6 +771,75 @@ void ClientSocketPoolBaseHelper::EnableConnectBackupJobs() {
   connect_backup_jobs_enabled_ = g_connect_backup_jobs_enabled;
 }
 
+// static
+bool ClientSocketPoolBaseHelper::adaptive_preconnect_enabled() {
+  return g_adaptive_preconnect_enabled;
+}
+
+// static
+bool ClientSocketPoolBaseHelper::set_adaptive_preconnect_enabled(bool enabled) {
+  bool old_value = g_adaptive_preconnect_enabled;
+  g_adaptive_preconnect_enabled = enabled;
+  return old_value;
+}
+
+int ClientSocketPoolBaseHelper::ObservedConcurrencyInGroup(
+    const std::string& group_name) const {
+  GroupHistoryMap::const_iterator it = group_history_.find(group_name);
+  return it == group_history_.end() ? 0 : it->second.max_concurrency;
+}
+
+void ClientSocketPoolBaseHelper::RecordRequestInHistory(
+    const std::string& group_name,
+    const Group& group) {
+  GroupHistoryMap::iterator it = group_history_.find(group_name);
+  if (it == group_history_.end()) {
+    if (group_history_.size() >= kMaxGroupHistoryEntries) {
+      GroupHistoryMap::iterator oldest = group_history_.begin();
+      for (GroupHistoryMap::iterator h = group_history_.begin();
+           h != group_history_.end(); ++h) {
+        if (h->second.last_request_time < oldest->second.last_request_time)
+          oldest = h;
+      }
+      group_history_.erase(oldest);
+    }
+    it = group_history_.insert(std::make_pair(group_name, GroupHistory())).first;
+  }
+
+  // Requests that are waiting or hold a socket, plus this one.
+  int concurrency = group.active_socket_count() +
+      static_cast<int>(group.pending_requests().size()) + 1;
+  it->second.max_concurrency = std::max(it->second.max_concurrency,
+                                        concurrency);
+  it->second.last_request_time = base::TimeTicks::Now();
+}
+
+void ClientSocketPoolBaseHelper::ReplaceIdleSocket(
+    const std::string& group_name,
+    base::TimeTicks now) {
+  GroupMap::iterator group_it = group_map_.find(group_name);
+  if (group_it == group_map_.end())
+    return;
+  Group* group = group_it->second;
+
+  // Only keep sockets warm for groups that were used about as recently as an
+  // unused socket is kept around.
+  GroupHistoryMap::const_iterator history = group_history_.find(group_name);
+  bool recently_used = history != group_history_.end() &&
+      now - history->second.last_request_time < unused_idle_socket_timeout_;
+  if (recently_used && group->preconnect_request() &&
+      group->NumActiveSocketSlots() < history->second.max_concurrency) {
+    scoped_ptr<const Request> request(
+        group->preconnect_request()->CreatePreconnectRequest());
+    // May delete the group on a synchronous error.
+    RequestSocketInternal(group_name, request.get());
+    return;
+  }
+
+  if (group->IsEmpty())
+    RemoveGroup(group_it);
+}
+
 void ClientSocketPoolBaseHelper::IncrementIdleCount() {
   if (++idle_socket_count_ == 1 && use_cleanup_timer_)
     StartIdleSocketTimer();
@@ -19,6 +19,10 @@
 // passed to each new ConnectJob instance via their ConnectJobFactory subclass
 // and templated SocketParams parameter.
 //
+// ConnectJobs are not bound to the request that started them: whenever a job
+// completes, its socket goes to the highest priority request waiting in the
+// group, whichever request (or preconnect) started the job.
+//
 #ifndef NET_SOCKET_CLIENT_SOCKET_POOL_BASE_H_
 #define NET_SOCKET_CLIENT_SOCKET_POOL_BASE_H_
 
@@ -175,6 +179,10 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
     virtual ~Request();
 
+    // Returns a new preconnect request for the same destination, or NULL if
+    // the request does not know its destination.
+    virtual Request* CreatePreconnectRequest() const;
+
     ClientSocketHandle* handle() const { return handle_; }
     const CompletionCallback& callback() const { return callback_; }
     RequestPriority priority() const { return priority_; }
@@ -320,6 +328,19 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
   void EnableConnectBackupJobs();
 
+  // Called to enable/disable adaptive preconnects in pools created afterwards.
+  // When enabled, a pool remembers the largest number of concurrent requests
+  // seen for each group and preconnects that many sockets, rather than the
+  // number asked for, when asked to preconnect to the group. It also replaces
+  // unused idle sockets that the server closes while the group is in use, so
+  // that the next request still finds a warm socket.
+  static bool adaptive_preconnect_enabled();
+  static bool set_adaptive_preconnect_enabled(bool enabled);
+
+  // Returns the largest number of concurrent requests seen for |group_name|,
+  // or 0 if adaptive preconnects are disabled or none have been seen.
+  int ObservedConcurrencyInGroup(const std::string& group_name) const;
+
   // ConnectJob::Delegate methods:
   virtual void OnConnectJobComplete(int result, ConnectJob* job) OVERRIDE;
 
@@ -411,6 +432,15 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
     RequestQueue* mutable_pending_requests() { return &pending_requests_; }
     std::list<IdleSocket>* mutable_idle_sockets() { return &idle_sockets_; }
 
+    // A request for a socket like the ones in the group, used to replace idle
+    // sockets. May be NULL.
+    const Request* preconnect_request() const {
+      return preconnect_request_.get();
+    }
+    void set_preconnect_request(const Request* request) {
+      preconnect_request_.reset(request);
+    }
+
    private:
     // Called when the backup socket timer fires.
     void OnBackupSocketTimerFired(
@@ -433,12 +463,24 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
     std::set<ConnectJob*> jobs_;
     RequestQueue pending_requests_;
     int active_socket_count_;  // number of active sockets used by clients
+    scoped_ptr<const Request> preconnect_request_;
     // A factory to pin the backup_job tasks.
     base::WeakPtrFactory<Group> weak_factory_;
   };
 
   typedef std::map<std::string, Group*> GroupMap;
 
+  // What adaptive preconnects have learned about a group. Outlives the Group,
+  // which is deleted whenever it has no sockets or requests.
+  struct GroupHistory {
+    GroupHistory() : max_concurrency(0) {}
+
+    int max_concurrency;
+    base::TimeTicks last_request_time;
+  };
+
+  typedef std::map<std::string, GroupHistory> GroupHistoryMap;
+
   typedef std::set<ConnectJob*> ConnectJobSet;
 
   struct CallbackResultPair {
@@ -469,6 +511,15 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   // Start cleanup timer for idle sockets.
   void StartIdleSocketTimer();
 
+  // Records a new request for |group_name| in |group_history_|. |group| must
+  // not yet include the request.
+  void RecordRequestInHistory(const std::string& group_name,
+                              const Group& group);
+
+  // Starts a connect job to replace an idle socket of |group_name| that the
+  // server closed, if the group has been used recently.
+  void ReplaceIdleSocket(const std::string& group_name, base::TimeTicks now);
+
   // Scans the group map for groups which have an available socket slot and
   // at least one pending request. Returns true if any groups are stalled, and
   // if so (and if both |group| and |group_name| are not NULL), fills |group|
@@ -584,6 +635,11 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   // TODO(vandebo) Remove when backup jobs move to TransportClientSocketPool
   bool connect_backup_jobs_enabled_;
 
+  bool adaptive_preconnect_enabled_;
+
+  // Only used when |adaptive_preconnect_enabled_| is true.
+  GroupHistoryMap group_history_;
+
   // A unique id for the pool.  It gets incremented every time we Flush() the
   // pool.  This is so that when sockets get released back to the pool, we can
   // make sure that they are discarded rather than reused.
@@ -614,6 +670,13 @@ class ClientSocketPoolBase {
               handle, callback, priority, ignore_limits, flags, net_log),
           params_(params) {}
 
+    virtual internal::ClientSocketPoolBaseHelper::Request*
+        CreatePreconnectRequest() const OVERRIDE {
+      return new Request(NULL /* no handle */, CompletionCallback(), LOWEST,
+                         internal::ClientSocketPoolBaseHelper::NO_IDLE_SOCKETS,
+                         ignore_limits(), params_, BoundNetLog());
+    }
+
     const scoped_refptr<SocketParams>& params() const { return params_; }
 
    private:
@@ -764,6 +827,10 @@ class ClientSocketPoolBase {
 
   void EnableConnectBackupJobs() { helper_.EnableConnectBackupJobs(); }
 
+  int ObservedConcurrencyInGroup(const std::string& group_name) const {
+    return helper_.ObservedConcurrencyInGroup(group_name);
+  }
+
   bool CloseOneIdleSocket() { return helper_.CloseOneIdleSocket(); }
 
   bool CloseOneIdleConnectionInLayeredPool() {
@@ -544,6 +544,10 @@ class TestClientSocketPool : public ClientSocketPool {
     return base_.HasGroup(group_name);
   }
 
+  int ObservedConcurrencyInGroup(const std::string& group_name) const {
+    return base_.ObservedConcurrencyInGroup(group_name);
+  }
+
   void CleanupTimedOutIdleSockets() { base_.CleanupIdleSockets(false); }
 
   void EnableConnectBackupJobs() { base_.EnableConnectBackupJobs(); }
@@ -616,6 +620,8 @@ class ClientSocketPoolBaseTest : public testing::Test {
     internal::ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(true);
     cleanup_timer_enabled_ =
         internal::ClientSocketPoolBaseHelper::cleanup_timer_enabled();
+    adaptive_preconnect_enabled_ =
+        internal::ClientSocketPoolBaseHelper::adaptive_preconnect_enabled();
   }
 
   virtual ~ClientSocketPoolBaseTest() {
@@ -623,6 +629,8 @@ class ClientSocketPoolBaseTest : public testing::Test {
         connect_backup_jobs_enabled_);
     internal::ClientSocketPoolBaseHelper::set_cleanup_timer_enabled(
         cleanup_timer_enabled_);
+    internal::ClientSocketPoolBaseHelper::set_adaptive_preconnect_enabled(
+        adaptive_preconnect_enabled_);
   }
 
   void CreatePool(int max_sockets, int max_sockets_per_group) {
@@ -673,6 +681,7 @@ class ClientSocketPoolBaseTest : public testing::Test {
 
   bool connect_backup_jobs_enabled_;
   bool cleanup_timer_enabled_;
+  bool adaptive_preconnect_enabled_;
   MockClientSocketFactory client_socket_factory_;
   TestConnectJobFactory* connect_job_factory_;
   scoped_refptr<TestSocketParams> params_;
@@ -3528,6 +3537,46 @@ TEST_F(ClientSocketPoolBaseTest, PreconnectWithBackupJob) {
   EXPECT_EQ(1, pool_->NumActiveSocketsInGroup("a"));
 }
 
+// With adaptive preconnects, the pool remembers how many sockets a group has
+// needed at once and preconnects that many.
+TEST_F(ClientSocketPoolBaseTest, AdaptivePreconnectUsesObservedConcurrency) {
+  internal::ClientSocketPoolBaseHelper::set_adaptive_preconnect_enabled(true);
+  CreatePool(kDefaultMaxSockets, kDefaultMaxSocketsPerGroup);
+  EXPECT_EQ(0, pool_->ObservedConcurrencyInGroup("a"));
+
+  EXPECT_EQ(OK, StartRequest("a", kDefaultPriority));
+  EXPECT_EQ(OK, StartRequest("a", kDefaultPriority));
+  EXPECT_EQ(OK, StartRequest("a", kDefaultPriority));
+  EXPECT_EQ(3, pool_->ObservedConcurrencyInGroup("a"));
+
+  // The peak is kept after the sockets are released.
+  ReleaseAllConnections(ClientSocketPoolTest::NO_KEEP_ALIVE);
+  EXPECT_FALSE(pool_->HasGroup("a"));
+  EXPECT_EQ(OK, StartRequest("a", kDefaultPriority));
+  EXPECT_EQ(3, pool_->ObservedConcurrencyInGroup("a"));
+  ReleaseAllConnections(ClientSocketPoolTest::NO_KEEP_ALIVE);
+
+  connect_job_factory_->set_job_type(TestConnectJob::kMockPendingJob);
+  pool_->RequestSockets("a", &params_, 1, BoundNetLog());
+  ASSERT_TRUE(pool_->HasGroup("a"));
+  EXPECT_EQ(3, pool_->NumConnectJobsInGroup("a"));
+}
+
+TEST_F(ClientSocketPoolBaseTest, AdaptivePreconnectDisabled) {
+  internal::ClientSocketPoolBaseHelper::set_adaptive_preconnect_enabled(false);
+  CreatePool(kDefaultMaxSockets, kDefaultMaxSocketsPerGroup);
+
+  EXPECT_EQ(OK, StartRequest("a", kDefaultPriority));
+  EXPECT_EQ(OK, StartRequest("a", kDefaultPriority));
+  EXPECT_EQ(0, pool_->ObservedConcurrencyInGroup("a"));
+  ReleaseAllConnections(ClientSocketPoolTest::NO_KEEP_ALIVE);
+
+  connect_job_factory_->set_job_type(TestConnectJob::kMockPendingJob);
+  pool_->RequestSockets("a", &params_, 1, BoundNetLog());
+  ASSERT_TRUE(pool_->HasGroup("a"));
+  EXPECT_EQ(1, pool_->NumConnectJobsInGroup("a"));
+}
+
 }  // namespace
 
 }  // namespace net
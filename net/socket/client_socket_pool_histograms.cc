@@ -41,6 +41,14 @@ ClientSocketPoolHistograms::ClientSocketPoolHistograms(
       base::TimeDelta::FromMilliseconds(1),
       base::TimeDelta::FromMinutes(6),
       100, Histogram::kUmaTargetedHistogramFlag);
+  // UMA_HISTOGRAM_BOOLEAN
+  ssl_session_resumed_ = base::BooleanHistogram::FactoryGet(
+      "Net.SSLSessionResumed_" + pool_name,
+      Histogram::kUmaTargetedHistogramFlag);
+  // UMA_HISTOGRAM_BOOLEAN
+  warm_socket_ = base::BooleanHistogram::FactoryGet(
+      "Net.SocketWarm_" + pool_name,
+      Histogram::kUmaTargetedHistogramFlag);
 
   if (pool_name == "HTTPProxy")
     is_http_proxy_connection_ = true;
@@ -86,4 +94,12 @@ void ClientSocketPoolHistograms::AddReusedIdleTime(base::TimeDelta time) const {
   reused_idle_time_->AddTime(time);
 }
 
+void ClientSocketPoolHistograms::AddSSLHandshakeType(bool resumed) const {
+  ssl_session_resumed_->AddBoolean(resumed);
+}
+
+void ClientSocketPoolHistograms::AddWarmSocket(bool warm) const {
+  warm_socket_->AddBoolean(warm);
+}
+
 }  // namespace net
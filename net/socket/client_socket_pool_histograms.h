@@ -26,12 +26,20 @@ class NET_EXPORT_PRIVATE ClientSocketPoolHistograms {
   void AddRequestTime(base::TimeDelta time) const;
   void AddUnusedIdleTime(base::TimeDelta time) const;
   void AddReusedIdleTime(base::TimeDelta time) const;
+  // Records whether an SSL handshake resumed a session (abbreviated) or
+  // negotiated a new one (full).
+  void AddSSLHandshakeType(bool resumed) const;
+  // Records whether a request got a socket that was already connected, i.e.
+  // an idle or preconnected socket, rather than waiting for a new one.
+  void AddWarmSocket(bool warm) const;
 
  private:
   base::Histogram* socket_type_;
   base::Histogram* request_time_;
   base::Histogram* unused_idle_time_;
   base::Histogram* reused_idle_time_;
+  base::Histogram* ssl_session_resumed_;
+  base::Histogram* warm_socket_;
 
   bool is_http_proxy_connection_;
   bool is_socks_connection_;
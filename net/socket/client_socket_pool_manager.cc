@@ -416,12 +416,13 @@ int PreconnectSocketsForHttpRequest(
     const SSLConfig& ssl_config_for_origin,
     const SSLConfig& ssl_config_for_proxy,
     const BoundNetLog& net_log,
-    int num_preconnect_streams) {
+    int num_preconnect_streams,
+    const OnHostResolutionCallback& resolution_callback) {
   return InitSocketPoolHelper(
       request_url, request_extra_headers, request_load_flags, request_priority,
       session, proxy_info, force_spdy_over_ssl, want_spdy_over_npn,
       ssl_config_for_origin, ssl_config_for_proxy, false, net_log,
-      num_preconnect_streams, NULL, OnHostResolutionCallback(),
+      num_preconnect_streams, NULL, resolution_callback,
       CompletionCallback());
 }
 
@@ -120,7 +120,8 @@ NET_EXPORT int InitSocketHandleForRawConnect(
     const CompletionCallback& callback);
 
 // Similar to InitSocketHandleForHttpRequest except that it initiates the
-// desired number of preconnect streams from the relevant socket pool.
+// desired number of preconnect streams from the relevant socket pool.  If
+// |resolution_callback| does not return OK, the preconnect is dropped.
 int PreconnectSocketsForHttpRequest(
     const GURL& request_url,
     const HttpRequestHeaders& request_extra_headers,
@@ -133,7 +134,8 @@ int PreconnectSocketsForHttpRequest(
     const SSLConfig& ssl_config_for_origin,
     const SSLConfig& ssl_config_for_proxy,
     const BoundNetLog& net_log,
-    int num_preconnect_streams);
+    int num_preconnect_streams,
+    const OnHostResolutionCallback& resolution_callback);
 
 }  // namespace net
 
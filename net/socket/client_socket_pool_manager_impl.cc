@@ -41,6 +41,7 @@ ClientSocketPoolManagerImpl::ClientSocketPoolManagerImpl(
     ServerBoundCertService* server_bound_cert_service,
     TransportSecurityState* transport_security_state,
     const std::string& ssl_session_cache_shard,
+    SSLSessionCache* ssl_session_cache,
     ProxyService* proxy_service,
     SSLConfigService* ssl_config_service,
     HttpNetworkSession::SocketPoolType pool_type)
@@ -51,6 +52,7 @@ ClientSocketPoolManagerImpl::ClientSocketPoolManagerImpl(
       server_bound_cert_service_(server_bound_cert_service),
       transport_security_state_(transport_security_state),
       ssl_session_cache_shard_(ssl_session_cache_shard),
+      ssl_session_cache_(ssl_session_cache),
       proxy_service_(proxy_service),
       ssl_config_service_(ssl_config_service),
       pool_type_(pool_type),
@@ -70,6 +72,7 @@ ClientSocketPoolManagerImpl::ClientSocketPoolManagerImpl(
           server_bound_cert_service,
           transport_security_state,
           ssl_session_cache_shard,
+          ssl_session_cache,
           socket_factory,
           transport_socket_pool_.get(),
           NULL /* no socks proxy */,
@@ -289,6 +292,7 @@ ClientSocketPoolManagerImpl::GetSocketPoolForHTTPProxy(
                   server_bound_cert_service_,
                   transport_security_state_,
                   ssl_session_cache_shard_,
+                  ssl_session_cache_,
                   socket_factory_,
                   tcp_https_ret.first->second /* https proxy */,
                   NULL /* no socks proxy */,
@@ -328,6 +332,7 @@ SSLClientSocketPool* ClientSocketPoolManagerImpl::GetSocketPoolForSSLWithProxy(
       server_bound_cert_service_,
       transport_security_state_,
       ssl_session_cache_shard_,
+      ssl_session_cache_,
       socket_factory_,
       NULL, /* no tcp pool, we always go through a proxy */
       GetSocketPoolForSOCKSProxy(proxy_server),
@@ -31,6 +31,7 @@ class ProxyService;
 class SOCKSClientSocketPool;
 class SSLClientSocketPool;
 class SSLConfigService;
+class SSLSessionCache;
 class TransportClientSocketPool;
 class TransportSecurityState;
 
@@ -63,6 +64,7 @@ class ClientSocketPoolManagerImpl : public base::NonThreadSafe,
                               ServerBoundCertService* server_bound_cert_service,
                               TransportSecurityState* transport_security_state,
                               const std::string& ssl_session_cache_shard,
+                              SSLSessionCache* ssl_session_cache,
                               ProxyService* proxy_service,
                               SSLConfigService* ssl_config_service,
                               HttpNetworkSession::SocketPoolType pool_type);
@@ -109,6 +111,7 @@ class ClientSocketPoolManagerImpl : public base::NonThreadSafe,
   ServerBoundCertService* const server_bound_cert_service_;
   TransportSecurityState* const transport_security_state_;
   const std::string ssl_session_cache_shard_;
+  SSLSessionCache* const ssl_session_cache_;
   ProxyService* const proxy_service_;
   const scoped_refptr<SSLConfigService> ssl_config_service_;
   const HttpNetworkSession::SocketPoolType pool_type_;
@@ -19,6 +19,7 @@ class CertVerifier;
 class ServerBoundCertService;
 class SSLCertRequestInfo;
 class SSLInfo;
+class SSLSessionCache;
 class TransportSecurityState;
 
 // This struct groups together several fields which are used by various
@@ -27,16 +28,19 @@ struct SSLClientSocketContext {
   SSLClientSocketContext()
       : cert_verifier(NULL),
         server_bound_cert_service(NULL),
-        transport_security_state(NULL) {}
+        transport_security_state(NULL),
+        ssl_session_cache(NULL) {}
 
   SSLClientSocketContext(CertVerifier* cert_verifier_arg,
                          ServerBoundCertService* server_bound_cert_service_arg,
                          TransportSecurityState* transport_security_state_arg,
-                         const std::string& ssl_session_cache_shard_arg)
+                         const std::string& ssl_session_cache_shard_arg,
+                         SSLSessionCache* ssl_session_cache_arg)
       : cert_verifier(cert_verifier_arg),
         server_bound_cert_service(server_bound_cert_service_arg),
         transport_security_state(transport_security_state_arg),
-        ssl_session_cache_shard(ssl_session_cache_shard_arg) {}
+        ssl_session_cache_shard(ssl_session_cache_shard_arg),
+        ssl_session_cache(ssl_session_cache_arg) {}
 
   CertVerifier* cert_verifier;
   ServerBoundCertService* server_bound_cert_service;
@@ -45,6 +49,9 @@ struct SSLClientSocketContext {
   // SSL session cache. SSL sockets with the same ssl_session_cache_shard may
   // resume each other's SSL sessions but we'll never sessions between shards.
   const std::string ssl_session_cache_shard;
+  // ssl_session_cache, if not NULL, keeps sessions across restarts and shares
+  // them between all the socket pools of a session.
+  SSLSessionCache* ssl_session_cache;
 };
 
 // A client socket that uses SSL as the transport layer.
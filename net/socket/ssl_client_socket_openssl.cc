@@ -25,6 +25,7 @@
 #include "net/base/ssl_info.h"
 #include "net/base/x509_certificate_net_log_param.h"
 #include "net/socket/ssl_error_params.h"
+#include "net/socket/ssl_session_cache.h"
 
 namespace net {
 
@@ -209,9 +210,9 @@ int NoOpVerifyCallback(X509_STORE_CTX*, void *) {
 // OpenSSL manages a cache of SSL_SESSION, this class provides the application
 // side policy for that cache about session re-use: we retain one session per
 // unique HostPortPair, per shard.
-class SSLSessionCache {
+class SSLSessionCacheOpenSSL {
  public:
-  SSLSessionCache() {}
+  SSLSessionCacheOpenSSL() {}
 
   void OnSessionAdded(const HostPortPair& host_and_port,
                       const std::string& shard,
@@ -304,14 +305,14 @@ class SSLSessionCache {
   // Protects access to both the above maps.
   base::Lock lock_;
 
-  DISALLOW_COPY_AND_ASSIGN(SSLSessionCache);
+  DISALLOW_COPY_AND_ASSIGN(SSLSessionCacheOpenSSL);
 };
 
 class SSLContext {
  public:
   static SSLContext* GetInstance() { return Singleton<SSLContext>::get(); }
   SSL_CTX* ssl_ctx() { return ssl_ctx_.get(); }
-  SSLSessionCache* session_cache() { return &session_cache_; }
+  SSLSessionCacheOpenSSL* session_cache() { return &session_cache_; }
 
   SSLClientSocketOpenSSL* GetClientSocketFromSSL(SSL* ssl) {
     DCHECK(ssl);
@@ -355,6 +356,19 @@ class SSLContext {
 
   int NewSessionCallback(SSL* ssl, SSL_SESSION* session) {
     SSLClientSocketOpenSSL* socket = GetClientSocketFromSSL(ssl);
+    if (socket->ssl_session_cache()) {
+      // Keep a serialized copy, including any session ticket, that outlives
+      // this process and OpenSSL's own cache.
+      int length = i2d_SSL_SESSION(session, NULL);
+      if (length > 0) {
+        std::string data(length, '\0');
+        unsigned char* p = reinterpret_cast<unsigned char*>(&data[0]);
+        i2d_SSL_SESSION(session, &p);
+        socket->ssl_session_cache()->Insert(socket->host_and_port(),
+                                            socket->ssl_session_cache_shard(),
+                                            base::Time::Now(), data);
+      }
+    }
     session_cache_.OnSessionAdded(socket->host_and_port(),
                                   socket->ssl_session_cache_shard(),
                                   session);
@@ -391,7 +405,7 @@ class SSLContext {
   // session_cache_ must appear before |ssl_ctx_| because the destruction of
   // |ssl_ctx_| may trigger callbacks into |session_cache_|. Therefore,
   // |session_cache_| must be destructed after |ssl_ctx_|.
-  SSLSessionCache session_cache_;
+  SSLSessionCacheOpenSSL session_cache_;
   crypto::ScopedOpenSSL<SSL_CTX, SSL_CTX_free> ssl_ctx_;
 };
 
@@ -433,6 +447,7 @@ SSLClientSocketOpenSSL::SSLClientSocketOpenSSL(
       host_and_port_(host_and_port),
       ssl_config_(ssl_config),
       ssl_session_cache_shard_(context.ssl_session_cache_shard),
+      ssl_session_cache_(context.ssl_session_cache),
       trying_cached_session_(false),
       next_handshake_state_(STATE_NONE),
       npn_status_(kNextProtoUnsupported),
@@ -460,6 +475,8 @@ bool SSLClientSocketOpenSSL::Init() {
   trying_cached_session_ =
       context->session_cache()->SetSSLSession(ssl_, host_and_port_,
                                               ssl_session_cache_shard_);
+  if (!trying_cached_session_ && ssl_session_cache_)
+    trying_cached_session_ = SetPersistedSession();
 
   BIO* ssl_bio = NULL;
   // 0 => use default buffer sizes.
@@ -556,6 +573,23 @@ bool SSLClientSocketOpenSSL::Init() {
   return true;
 }
 
+bool SSLClientSocketOpenSSL::SetPersistedSession() {
+  std::string data;
+  if (!ssl_session_cache_->Lookup(host_and_port_, ssl_session_cache_shard_,
+                                  base::Time::Now(), &data)) {
+    return false;
+  }
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+  crypto::ScopedOpenSSL<SSL_SESSION, SSL_SESSION_free> session(
+      d2i_SSL_SESSION(NULL, &p, data.size()));
+  if (!session.get()) {
+    ssl_session_cache_->Remove(host_and_port_, ssl_session_cache_shard_);
+    return false;
+  }
+  // SSL_set_session() takes its own reference to the session.
+  return SSL_set_session(ssl_, session.get()) == 1;
+}
+
 int SSLClientSocketOpenSSL::ClientCertRequestCallback(SSL* ssl,
                                                       X509** x509,
                                                       EVP_PKEY** pkey) {
@@ -605,6 +639,8 @@ bool SSLClientSocketOpenSSL::GetSSLInfo(SSLInfo* ssl_info) {
   ssl_info->client_cert_sent =
       ssl_config_.send_client_cert && ssl_config_.client_cert;
   ssl_info->channel_id_sent = WasChannelIDSent();
+  ssl_info->handshake_type = SSL_session_reused(ssl_) ?
+      SSLInfo::HANDSHAKE_RESUME : SSLInfo::HANDSHAKE_FULL;
 
   const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl_);
   CHECK(cipher);
@@ -821,6 +857,8 @@ int SSLClientSocketOpenSSL::DoHandshake() {
         int rv = SSL_CTX_remove_session(SSL_get_SSL_CTX(ssl_), session);
         LOG_IF(WARNING, !rv) << "Couldn't invalidate SSL session: " << session;
       }
+      if (ssl_session_cache_)
+        ssl_session_cache_->Remove(host_and_port_, ssl_session_cache_shard_);
     }
   } else if (rv == 1) {
     if (trying_cached_session_ && logging::DEBUG_MODE) {
@@ -27,6 +27,7 @@ class CertVerifier;
 class SingleRequestCertVerifier;
 class SSLCertRequestInfo;
 class SSLInfo;
+class SSLSessionCache;
 
 // An SSL client socket implemented with OpenSSL.
 class SSLClientSocketOpenSSL : public SSLClientSocket {
@@ -45,6 +46,7 @@ class SSLClientSocketOpenSSL : public SSLClientSocket {
   const std::string& ssl_session_cache_shard() const {
     return ssl_session_cache_shard_;
   }
+  SSLSessionCache* ssl_session_cache() const { return ssl_session_cache_; }
 
   // Callback from the SSL layer that indicates the remote server is requesting
   // a certificate for this client.
@@ -95,6 +97,9 @@ class SSLClientSocketOpenSSL : public SSLClientSocket {
 
  private:
   bool Init();
+  // Offers the session for |host_and_port_| from |ssl_session_cache_|, if
+  // any, for resumption. Returns true if a session was offered.
+  bool SetPersistedSession();
   void DoReadCallback(int result);
   void DoWriteCallback(int result);
 
@@ -164,6 +169,9 @@ class SSLClientSocketOpenSSL : public SSLClientSocket {
   // session cache. i.e. sessions created with one value will not attempt to
   // resume on the socket with a different value.
   const std::string ssl_session_cache_shard_;
+  // ssl_session_cache_, if not NULL, holds sessions beyond the lifetime of
+  // OpenSSL's in-memory cache. See SSLClientSocketContext.
+  SSLSessionCache* const ssl_session_cache_;
 
   // Used for session cache diagnostics.
   bool trying_cached_session_;
@@ -83,6 +83,7 @@ SSLConnectJob::SSLConnectJob(const std::string& group_name,
                              ClientSocketFactory* client_socket_factory,
                              HostResolver* host_resolver,
                              const SSLClientSocketContext& context,
+                             ClientSocketPoolHistograms* histograms,
                              Delegate* delegate,
                              NetLog* net_log)
     : ConnectJob(group_name, timeout_duration, delegate,
@@ -94,6 +95,7 @@ SSLConnectJob::SSLConnectJob(const std::string& group_name,
       client_socket_factory_(client_socket_factory),
       host_resolver_(host_resolver),
       context_(context),
+      histograms_(histograms),
       ALLOW_THIS_IN_INITIALIZER_LIST(
           callback_(base::Bind(&SSLConnectJob::OnIOComplete,
                                base::Unretained(this)))) {}
@@ -321,6 +323,10 @@ int SSLConnectJob::DoSSLConnectComplete(int result) {
 
     SSLInfo ssl_info;
     ssl_socket_->GetSSLInfo(&ssl_info);
+    if (histograms_ && ssl_info.handshake_type != SSLInfo::HANDSHAKE_UNKNOWN) {
+      histograms_->AddSSLHandshakeType(
+          ssl_info.handshake_type == SSLInfo::HANDSHAKE_RESUME);
+    }
 
     if (ssl_info.handshake_type == SSLInfo::HANDSHAKE_RESUME) {
       UMA_HISTOGRAM_CUSTOM_TIMES("Net.SSL_Connection_Latency_Resume_Handshake",
@@ -401,6 +407,7 @@ SSLClientSocketPool::SSLConnectJobFactory::SSLConnectJobFactory(
     ClientSocketFactory* client_socket_factory,
     HostResolver* host_resolver,
     const SSLClientSocketContext& context,
+    ClientSocketPoolHistograms* histograms,
     NetLog* net_log)
     : transport_pool_(transport_pool),
       socks_pool_(socks_pool),
@@ -408,6 +415,7 @@ SSLClientSocketPool::SSLConnectJobFactory::SSLConnectJobFactory(
       client_socket_factory_(client_socket_factory),
       host_resolver_(host_resolver),
       context_(context),
+      histograms_(histograms),
       net_log_(net_log) {
   base::TimeDelta max_transport_timeout = base::TimeDelta();
   base::TimeDelta pool_timeout;
@@ -436,6 +444,7 @@ SSLClientSocketPool::SSLClientSocketPool(
     ServerBoundCertService* server_bound_cert_service,
     TransportSecurityState* transport_security_state,
     const std::string& ssl_session_cache_shard,
+    SSLSessionCache* ssl_session_cache,
     ClientSocketFactory* client_socket_factory,
     TransportClientSocketPool* transport_pool,
     SOCKSClientSocketPool* socks_pool,
@@ -457,7 +466,9 @@ SSLClientSocketPool::SSLClientSocketPool(
                                          cert_verifier,
                                          server_bound_cert_service,
                                          transport_security_state,
-                                         ssl_session_cache_shard),
+                                         ssl_session_cache_shard,
+                                         ssl_session_cache),
+                                     histograms,
                                      net_log)),
       ssl_config_service_(ssl_config_service) {
   if (ssl_config_service_)
@@ -488,7 +499,7 @@ ConnectJob* SSLClientSocketPool::SSLConnectJobFactory::NewConnectJob(
   return new SSLConnectJob(group_name, request.params(), ConnectionTimeout(),
                            transport_pool_, socks_pool_, http_proxy_pool_,
                            client_socket_factory_, host_resolver_,
-                           context_, delegate, net_log_);
+                           context_, histograms_, delegate, net_log_);
 }
 
 base::TimeDelta
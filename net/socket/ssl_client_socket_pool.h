@@ -30,6 +30,7 @@ class HttpProxySocketParams;
 class SOCKSClientSocketPool;
 class SOCKSSocketParams;
 class SSLClientSocket;
+class SSLSessionCache;
 class TransportClientSocketPool;
 class TransportSecurityState;
 class TransportSocketParams;
@@ -98,6 +99,7 @@ class SSLConnectJob : public ConnectJob {
       ClientSocketFactory* client_socket_factory,
       HostResolver* host_resolver,
       const SSLClientSocketContext& context,
+      ClientSocketPoolHistograms* histograms,
       Delegate* delegate,
       NetLog* net_log);
   virtual ~SSLConnectJob();
@@ -147,6 +149,7 @@ class SSLConnectJob : public ConnectJob {
   HostResolver* const host_resolver_;
 
   const SSLClientSocketContext context_;
+  ClientSocketPoolHistograms* const histograms_;
 
   State next_state_;
   CompletionCallback callback_;
@@ -177,6 +180,7 @@ class NET_EXPORT_PRIVATE SSLClientSocketPool
       ServerBoundCertService* server_bound_cert_service,
       TransportSecurityState* transport_security_state,
       const std::string& ssl_session_cache_shard,
+      SSLSessionCache* ssl_session_cache,
       ClientSocketFactory* client_socket_factory,
       TransportClientSocketPool* transport_pool,
       SOCKSClientSocketPool* socks_pool,
@@ -255,6 +259,7 @@ class NET_EXPORT_PRIVATE SSLClientSocketPool
         ClientSocketFactory* client_socket_factory,
         HostResolver* host_resolver,
         const SSLClientSocketContext& context,
+        ClientSocketPoolHistograms* histograms,
         NetLog* net_log);
 
     virtual ~SSLConnectJobFactory() {}
@@ -274,6 +279,7 @@ class NET_EXPORT_PRIVATE SSLClientSocketPool
     ClientSocketFactory* const client_socket_factory_;
     HostResolver* const host_resolver_;
     const SSLClientSocketContext context_;
+    ClientSocketPoolHistograms* const histograms_;
     base::TimeDelta timeout_;
     NetLog* net_log_;
 
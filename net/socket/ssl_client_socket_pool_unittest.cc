@@ -100,6 +100,7 @@ class SSLClientSocketPoolTest : public testing::Test {
         NULL /* server_bound_cert_service */,
         NULL /* transport_security_state */,
         ""   /* ssl_session_cache_shard */,
+        NULL /* ssl_session_cache */,
         &socket_factory_,
         transport_pool ? &transport_socket_pool_ : NULL,
         socks_pool ? &socks_socket_pool_ : NULL,
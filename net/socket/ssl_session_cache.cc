@@ -0,0 +1,262 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/ssl_session_cache.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/string_piece.h"
+#include "crypto/encryptor.h"
+#include "crypto/random.h"
+#include "crypto/symmetric_key.h"
+#include "net/base/host_port_pair.h"
+
+namespace net {
+
+namespace {
+
+// Identifies the format of the cache file. Files in any other format are
+// ignored.
+const uint32 kFileVersion = 1;
+
+// Files larger than this are not loaded.
+const int64 kMaxFileSize = 1024 * 1024;
+
+// How long to wait after a session is added before writing the file, so that
+// the sessions of a page load are written together.
+const int kWriteDelaySeconds = 10;
+
+// The size of the AES-CBC initialization vector stored before the encrypted
+// sessions.
+const size_t kIVSize = 16;
+
+void ReadData(const FilePath& path, std::string* data) {
+  int64 size;
+  if (!file_util::GetFileSize(path, &size) || size > kMaxFileSize)
+    return;
+  if (!file_util::ReadFileToString(path, data))
+    data->clear();
+}
+
+void WriteData(const FilePath& path, const std::string& data) {
+  FilePath temp_file;
+  if (!file_util::CreateTemporaryFileInDir(path.DirName(), &temp_file))
+    return;
+
+  int size = static_cast<int>(data.size());
+  if (file_util::WriteFile(temp_file, data.data(), size) != size ||
+      !file_util::ReplaceFile(temp_file, path)) {
+    LOG(ERROR) << "Failed to write the SSL session cache";
+    file_util::Delete(temp_file, false);
+  }
+}
+
+}  // namespace
+
+SSLSessionCache::Entry::Entry() {}
+
+SSLSessionCache::Entry::~Entry() {}
+
+SSLSessionCache::SSLSessionCache(size_t max_entries, base::TimeDelta lifetime)
+    : max_entries_(max_entries),
+      lifetime_(lifetime),
+      loaded_(false),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+  DCHECK_GT(max_entries, 0u);
+}
+
+SSLSessionCache::~SSLSessionCache() {
+  DCHECK(CalledOnValidThread());
+  if (write_timer_.IsRunning())
+    Flush();
+}
+
+void SSLSessionCache::EnablePersistence(
+    const FilePath& path,
+    base::SequencedTaskRunner* file_task_runner,
+    crypto::SymmetricKey* key) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(!file_task_runner_);
+  path_ = path;
+  file_task_runner_ = file_task_runner;
+  key_.reset(key);
+}
+
+void SSLSessionCache::Load() {
+  DCHECK(CalledOnValidThread());
+  DCHECK(file_task_runner_);
+  std::string* data = new std::string;
+  file_task_runner_->PostTaskAndReply(
+      FROM_HERE, base::Bind(&ReadData, path_, data),
+      base::Bind(&SSLSessionCache::OnLoaded, weak_factory_.GetWeakPtr(),
+                 base::Owned(data)));
+}
+
+bool SSLSessionCache::Lookup(const HostPortPair& host_and_port,
+                             const std::string& shard,
+                             const base::Time& now,
+                             std::string* session) {
+  DCHECK(CalledOnValidThread());
+  EntryMap::iterator it = entries_.find(GetCacheKey(host_and_port, shard));
+  if (it == entries_.end())
+    return false;
+
+  if (now < it->second.creation_time ||
+      now >= it->second.creation_time + lifetime_) {
+    entries_.erase(it);
+    ScheduleWrite();
+    return false;
+  }
+  *session = it->second.session;
+  return true;
+}
+
+void SSLSessionCache::Insert(const HostPortPair& host_and_port,
+                             const std::string& shard,
+                             const base::Time& now,
+                             const std::string& session) {
+  DCHECK(CalledOnValidThread());
+  const std::string key = GetCacheKey(host_and_port, shard);
+  if (entries_.size() >= max_entries_ && !entries_.count(key)) {
+    EntryMap::iterator oldest = entries_.begin();
+    for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->second.creation_time < oldest->second.creation_time)
+        oldest = it;
+    }
+    entries_.erase(oldest);
+  }
+  Entry& entry = entries_[key];
+  entry.creation_time = now;
+  entry.session = session;
+  ScheduleWrite();
+}
+
+void SSLSessionCache::Remove(const HostPortPair& host_and_port,
+                             const std::string& shard) {
+  DCHECK(CalledOnValidThread());
+  if (entries_.erase(GetCacheKey(host_and_port, shard)))
+    ScheduleWrite();
+}
+
+void SSLSessionCache::Clear() {
+  DCHECK(CalledOnValidThread());
+  entries_.clear();
+  Flush();
+}
+
+void SSLSessionCache::Flush() {
+  DCHECK(CalledOnValidThread());
+  write_timer_.Stop();
+  if (!file_task_runner_)
+    return;
+  std::string data = Encode();
+  if (data.empty())
+    return;
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::Bind(&WriteData, path_, data));
+}
+
+// static
+std::string SSLSessionCache::GetCacheKey(const HostPortPair& host_and_port,
+                                         const std::string& shard) {
+  return host_and_port.ToString() + "/" + shard;
+}
+
+void SSLSessionCache::OnLoaded(const std::string* data) {
+  DCHECK(CalledOnValidThread());
+  loaded_ = true;
+  if (data->empty())
+    return;
+
+  if (!Decode(*data, base::Time::Now()))
+    LOG(WARNING) << "Invalid SSL session cache file";
+}
+
+void SSLSessionCache::ScheduleWrite() {
+  if (!file_task_runner_ || write_timer_.IsRunning())
+    return;
+  write_timer_.Start(FROM_HERE,
+                     base::TimeDelta::FromSeconds(kWriteDelaySeconds),
+                     this, &SSLSessionCache::Flush);
+}
+
+std::string SSLSessionCache::Encode() const {
+  Pickle pickle;
+  pickle.WriteUInt32(kFileVersion);
+  pickle.WriteInt(static_cast<int>(entries_.size()));
+  for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+       ++it) {
+    pickle.WriteString(it->first);
+    pickle.WriteInt64(it->second.creation_time.ToInternalValue());
+    pickle.WriteString(it->second.session);
+  }
+
+  char iv[kIVSize];
+  crypto::RandBytes(iv, sizeof(iv));
+  crypto::Encryptor encryptor;
+  std::string ciphertext;
+  if (!encryptor.Init(key_.get(), crypto::Encryptor::CBC,
+                      base::StringPiece(iv, sizeof(iv))) ||
+      !encryptor.Encrypt(base::StringPiece(
+                             static_cast<const char*>(pickle.data()),
+                             pickle.size()),
+                         &ciphertext)) {
+    return std::string();
+  }
+  return std::string(iv, sizeof(iv)) + ciphertext;
+}
+
+bool SSLSessionCache::Decode(const std::string& data, const base::Time& now) {
+  if (data.size() <= kIVSize)
+    return false;
+
+  crypto::Encryptor encryptor;
+  std::string plaintext;
+  if (!encryptor.Init(key_.get(), crypto::Encryptor::CBC,
+                      base::StringPiece(data.data(), kIVSize)) ||
+      !encryptor.Decrypt(base::StringPiece(data.data() + kIVSize,
+                                           data.size() - kIVSize),
+                         &plaintext)) {
+    return false;
+  }
+
+  // CBC does not authenticate the data, so everything read below is checked.
+  // A session that was tampered with at worst fails to resume.
+  Pickle pickle(plaintext.data(), static_cast<int>(plaintext.size()));
+  PickleIterator iter(pickle);
+  uint32 version;
+  int num_entries;
+  if (!pickle.ReadUInt32(&iter, &version) || version != kFileVersion ||
+      !pickle.ReadInt(&iter, &num_entries) || num_entries < 0) {
+    return false;
+  }
+
+  for (int i = 0; i < num_entries; ++i) {
+    std::string key;
+    int64 creation_time;
+    Entry entry;
+    if (!pickle.ReadString(&iter, &key) ||
+        !pickle.ReadInt64(&iter, &creation_time) ||
+        !pickle.ReadString(&iter, &entry.session)) {
+      return false;
+    }
+    entry.creation_time = base::Time::FromInternalValue(creation_time);
+
+    // Sessions established since Load() was called are newer than those in
+    // the file.
+    if (entries_.count(key) || entries_.size() >= max_entries_ ||
+        now < entry.creation_time ||
+        now >= entry.creation_time + lifetime_) {
+      continue;
+    }
+    entries_[key] = entry;
+  }
+  return true;
+}
+
+}  // namespace net
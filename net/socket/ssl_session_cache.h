@@ -0,0 +1,135 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SOCKET_SSL_SESSION_CACHE_H_
+#define NET_SOCKET_SSL_SESSION_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "net/base/net_export.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace crypto {
+class SymmetricKey;
+}
+
+namespace net {
+
+class HostPortPair;
+
+// SSLSessionCache holds serialized TLS sessions, including any session
+// ticket the server issued, so that later connections to the same server can
+// use an abbreviated handshake. Sessions are keyed by the server's host:port
+// and the ssl_session_cache_shard of the socket, not by the transport, so SSL
+// sockets tunnelled through an HTTP or SPDY proxy resume the sessions of
+// direct connections and vice versa.
+//
+// The cache can be written to a file, encrypted with a key supplied by the
+// embedder, so that sessions survive a restart. All file access happens on a
+// separate task runner; everything else happens on the network thread.
+class NET_EXPORT SSLSessionCache
+    : NON_EXPORTED_BASE(public base::NonThreadSafe) {
+ public:
+  // Keeps at most |max_entries| sessions, each for |lifetime| after it was
+  // established. Servers may expire sessions sooner.
+  SSLSessionCache(size_t max_entries, base::TimeDelta lifetime);
+
+  // Writes any sessions that have not been written yet.
+  ~SSLSessionCache();
+
+  // Makes the cache persistent: Load() reads |path|, and the sessions are
+  // written back to it a few seconds after they change. |key| must be an AES
+  // key; the cache takes ownership of it.
+  void EnablePersistence(const FilePath& path,
+                         base::SequencedTaskRunner* file_task_runner,
+                         crypto::SymmetricKey* key);
+
+  // Starts reading the sessions saved by a previous instance. Lookup()
+  // misses for those sessions until the file has been read.
+  void Load();
+
+  // Looks up the session for |host_and_port| in |shard| at time |now|. On a
+  // hit, sets |session| to the serialized session and returns true.
+  bool Lookup(const HostPortPair& host_and_port,
+              const std::string& shard,
+              const base::Time& now,
+              std::string* session);
+
+  // Stores |session|, established at time |now|, replacing any previous
+  // session for |host_and_port| in |shard|. Evicts the oldest session if the
+  // cache is full.
+  void Insert(const HostPortPair& host_and_port,
+              const std::string& shard,
+              const base::Time& now,
+              const std::string& session);
+
+  // Removes the session for |host_and_port| in |shard|, e.g. because the
+  // server refused to resume it.
+  void Remove(const HostPortPair& host_and_port, const std::string& shard);
+
+  // Removes all sessions, in memory and on disk.
+  void Clear();
+
+  // Writes the sessions now instead of waiting for the write delay. Does
+  // nothing unless persistence is enabled.
+  void Flush();
+
+  bool loaded() const { return loaded_; }
+  size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    base::Time creation_time;
+    std::string session;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+
+  static std::string GetCacheKey(const HostPortPair& host_and_port,
+                                 const std::string& shard);
+
+  // Called on the origin thread with the contents of the cache file.
+  void OnLoaded(const std::string* data);
+
+  // Schedules a write of the cache file if persistence is enabled.
+  void ScheduleWrite();
+
+  // Returns the sessions encrypted with |key_|, or an empty string on
+  // failure.
+  std::string Encode() const;
+  bool Decode(const std::string& data, const base::Time& now);
+
+  const size_t max_entries_;
+  const base::TimeDelta lifetime_;
+
+  EntryMap entries_;
+  bool loaded_;
+
+  FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  scoped_ptr<crypto::SymmetricKey> key_;
+  base::OneShotTimer<SSLSessionCache> write_timer_;
+
+  base::WeakPtrFactory<SSLSessionCache> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SSLSessionCache);
+};
+
+}  // namespace net
+
+#endif  // NET_SOCKET_SSL_SESSION_CACHE_H_
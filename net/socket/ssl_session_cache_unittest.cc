@@ -0,0 +1,140 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/ssl_session_cache.h"
+
+#include "base/file_util.h"
+#include "base/message_loop.h"
+#include "base/message_loop_proxy.h"
+#include "base/scoped_temp_dir.h"
+#include "crypto/symmetric_key.h"
+#include "net/base/host_port_pair.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const size_t kMaxEntries = 2;
+const int kLifetimeHours = 1;
+const char kSession[] = "serialized session with a ticket";
+
+class SSLSessionCacheTest : public testing::Test {
+ protected:
+  SSLSessionCacheTest()
+      : host_a_("a.example.com", 443),
+        host_b_("b.example.com", 443),
+        host_c_("c.example.com", 443) {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.path().AppendASCII("ssl_sessions");
+    key_ = std::string(16, 'k');
+  }
+
+  SSLSessionCache* NewCache() {
+    return new SSLSessionCache(kMaxEntries,
+                               base::TimeDelta::FromHours(kLifetimeHours));
+  }
+
+  SSLSessionCache* NewPersistentCache(const std::string& raw_key) {
+    SSLSessionCache* cache = NewCache();
+    cache->EnablePersistence(
+        path_, base::MessageLoopProxy::current(),
+        crypto::SymmetricKey::Import(crypto::SymmetricKey::AES, raw_key));
+    return cache;
+  }
+
+  const HostPortPair host_a_;
+  const HostPortPair host_b_;
+  const HostPortPair host_c_;
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+  std::string key_;
+};
+
+}  // namespace
+
+TEST_F(SSLSessionCacheTest, InsertAndLookup) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<SSLSessionCache> cache(NewCache());
+  std::string session;
+  EXPECT_FALSE(cache->Lookup(host_a_, "", now, &session));
+
+  cache->Insert(host_a_, "", now, kSession);
+  ASSERT_TRUE(cache->Lookup(host_a_, "", now, &session));
+  EXPECT_EQ(kSession, session);
+
+  // Sessions are not shared between shards or ports.
+  EXPECT_FALSE(cache->Lookup(host_a_, "other", now, &session));
+  EXPECT_FALSE(cache->Lookup(HostPortPair("a.example.com", 8443), "", now,
+                             &session));
+
+  cache->Remove(host_a_, "");
+  EXPECT_FALSE(cache->Lookup(host_a_, "", now, &session));
+}
+
+TEST_F(SSLSessionCacheTest, Expiration) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<SSLSessionCache> cache(NewCache());
+  cache->Insert(host_a_, "", now, kSession);
+
+  std::string session;
+  EXPECT_TRUE(cache->Lookup(host_a_, "",
+                            now + base::TimeDelta::FromMinutes(59),
+                            &session));
+  EXPECT_FALSE(cache->Lookup(host_a_, "",
+                             now + base::TimeDelta::FromHours(kLifetimeHours),
+                             &session));
+  EXPECT_EQ(0u, cache->size());
+}
+
+TEST_F(SSLSessionCacheTest, EvictsOldest) {
+  base::Time now = base::Time::Now();
+  scoped_ptr<SSLSessionCache> cache(NewCache());
+  cache->Insert(host_a_, "", now - base::TimeDelta::FromMinutes(1), kSession);
+  cache->Insert(host_b_, "", now, kSession);
+  cache->Insert(host_c_, "", now, kSession);
+  EXPECT_EQ(kMaxEntries, cache->size());
+
+  std::string session;
+  EXPECT_FALSE(cache->Lookup(host_a_, "", now, &session));
+  EXPECT_TRUE(cache->Lookup(host_b_, "", now, &session));
+  EXPECT_TRUE(cache->Lookup(host_c_, "", now, &session));
+}
+
+TEST_F(SSLSessionCacheTest, PersistAndLoad) {
+  scoped_ptr<SSLSessionCache> cache(NewPersistentCache(key_));
+  cache->Insert(host_a_, "shard", base::Time::Now(), kSession);
+  cache->Flush();
+  MessageLoop::current()->RunAllPending();
+
+  // The sessions are encrypted on disk.
+  std::string contents;
+  ASSERT_TRUE(file_util::ReadFileToString(path_, &contents));
+  EXPECT_EQ(std::string::npos, contents.find(kSession));
+
+  cache.reset(NewPersistentCache(key_));
+  cache->Load();
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(cache->loaded());
+  std::string session;
+  ASSERT_TRUE(cache->Lookup(host_a_, "shard", base::Time::Now(), &session));
+  EXPECT_EQ(kSession, session);
+}
+
+TEST_F(SSLSessionCacheTest, LoadWithWrongKey) {
+  scoped_ptr<SSLSessionCache> cache(NewPersistentCache(key_));
+  cache->Insert(host_a_, "", base::Time::Now(), kSession);
+  cache->Flush();
+  MessageLoop::current()->RunAllPending();
+
+  cache.reset(NewPersistentCache(std::string(16, 'x')));
+  cache->Load();
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(cache->loaded());
+  EXPECT_EQ(0u, cache->size());
+}
+
+}  // namespace net
@@ -33,6 +33,37 @@ const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
 
 namespace {
 
+// While the IPv4 fallback connect has won a race less than this long ago, the
+// IPv6 connect gets no head start.
+const int kIPv4PreferenceTimeInMinutes = 10;
+
+// The last time the IPv4 fallback connect won a race, as an internal TimeTicks
+// value, or 0 if the IPv6 connect won the last race.
+int64 g_last_ipv4_fallback_win = 0;
+
+// Returns how long the IPv6 connect runs before the IPv4 fallback connect is
+// started.
+base::TimeDelta GetIPv6FallbackDelay() {
+  if (g_last_ipv4_fallback_win != 0 &&
+      base::TimeTicks::Now() -
+          base::TimeTicks::FromInternalValue(g_last_ipv4_fallback_win) <
+          base::TimeDelta::FromMinutes(kIPv4PreferenceTimeInMinutes)) {
+    return base::TimeDelta();
+  }
+  return base::TimeDelta::FromMilliseconds(
+      TransportConnectJob::kIPv6FallbackTimerInMs);
+}
+
+// Remembers which connect won a race for GetIPv6FallbackDelay(), and logs it
+// to |net_log|.
+void RecordRaceWinner(bool ipv4_won, const BoundNetLog& net_log) {
+  g_last_ipv4_fallback_win =
+      ipv4_won ? base::TimeTicks::Now().ToInternalValue() : 0;
+  std::string winner = ipv4_won ? "ipv4" : "ipv6";
+  net_log.AddEvent(NetLog::TYPE_TRANSPORT_CONNECT_JOB_RACE_WINNER,
+                   NetLog::StringCallback("winner", &winner));
+}
+
 // Returns true iff all addresses in |list| are in the IPv6 family.
 bool AddressListOnlyContainsIPv6(const AddressList& list) {
   DCHECK(!list.empty());
@@ -91,7 +122,8 @@ TransportConnectJob::TransportConnectJob(
       params_(params),
       client_socket_factory_(client_socket_factory),
       resolver_(host_resolver),
-      next_state_(STATE_NONE) {
+      next_state_(STATE_NONE),
+      raced_(false) {
 }
 
 TransportConnectJob::~TransportConnectJob() {
@@ -113,6 +145,11 @@ LoadState TransportConnectJob::GetLoadState() const {
   }
 }
 
+// static
+void TransportConnectJob::ResetIPv6FallbackHistoryForTests() {
+  g_last_ipv4_fallback_win = 0;
+}
+
 // static
 void TransportConnectJob::MakeAddressListStartWithIPv4(AddressList* list) {
   for (AddressList::iterator i = list->begin(); i != list->end(); ++i) {
@@ -191,8 +228,7 @@ int TransportConnectJob::DoTransportConnect() {
   if (rv == ERR_IO_PENDING &&
       addresses_.front().GetFamily() == AF_INET6 &&
       !AddressListOnlyContainsIPv6(addresses_)) {
-    fallback_timer_.Start(FROM_HERE,
-        base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
+    fallback_timer_.Start(FROM_HERE, GetIPv6FallbackDelay(),
         this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
   }
   return rv;
@@ -240,6 +276,13 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
                                    100);
       }
     }
+    if (raced_) {
+      // The IPv6 connect may have moved on to the IPv4 addresses.
+      IPEndPoint peer;
+      bool ipv4_won = transport_socket_->GetPeerAddress(&peer) == OK &&
+                      peer.GetFamily() == AF_INET;
+      RecordRaceWinner(ipv4_won, net_log());
+    }
     set_socket(transport_socket_.release());
     fallback_timer_.Stop();
   } else {
@@ -262,6 +305,14 @@ void TransportConnectJob::DoIPv6FallbackTransportConnect() {
   DCHECK(!fallback_transport_socket_.get());
   DCHECK(!fallback_addresses_.get());
 
+  raced_ = true;
+  net_log().AddEvent(
+      NetLog::TYPE_TRANSPORT_CONNECT_JOB_IPV6_FALLBACK,
+      NetLog::IntegerCallback(
+          "delay_ms",
+          static_cast<int>(
+              (base::TimeTicks::Now() - connect_start_time_).InMilliseconds())));
+
   fallback_addresses_.reset(new AddressList(addresses_));
   MakeAddressListStartWithIPv4(fallback_addresses_.get());
   fallback_transport_socket_.reset(
@@ -311,6 +362,7 @@ void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
         base::TimeDelta::FromMilliseconds(1),
         base::TimeDelta::FromMinutes(10),
         100);
+    RecordRaceWinner(true, net_log());
     set_socket(fallback_transport_socket_.release());
     next_state_ = STATE_NONE;
     transport_socket_.reset();
@@ -66,6 +66,10 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 // (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
 // fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
 // a headstart) and return the one that completes first to the socket pool.
+//
+// As suggested by RFC 6555, the outcome of the races is remembered: while the
+// IPv4 connect() has won a race recently, later jobs start both connects at
+// once instead of waiting for the timer.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
   TransportConnectJob(const std::string& group_name,
@@ -86,6 +90,10 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
 
   static const int kIPv6FallbackTimerInMs;
 
+  // Forgets the outcome of the previous races, so that the next job waits
+  // for the fallback timer again.
+  static void ResetIPv6FallbackHistoryForTests();
+
  private:
   enum State {
     STATE_RESOLVE_HOST,
@@ -133,6 +141,9 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   base::TimeTicks fallback_connect_start_time_;
   base::OneShotTimer<TransportConnectJob> fallback_timer_;
 
+  // True once the IPv4 fallback connect has been started.
+  bool raced_;
+
   DISALLOW_COPY_AND_ASSIGN(TransportConnectJob);
 };
 
@@ -11,6 +11,7 @@
 #include "base/logging.h"
 #include "base/message_loop.h"
 #include "base/threading/platform_thread.h"
+#include "net/base/capturing_net_log.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/mock_host_resolver.h"
 #include "net/base/net_errors.h"
@@ -409,6 +410,7 @@ class TransportClientSocketPoolTest : public testing::Test {
               host_resolver_.get(),
               &client_socket_factory_,
               NULL) {
+    TransportConnectJob::ResetIPv6FallbackHistoryForTests();
   }
 
   ~TransportClientSocketPoolTest() {
@@ -1210,6 +1212,78 @@ TEST_F(TransportClientSocketPoolTest, IPv6FallbackSocketIPv6FinishesFirst) {
   EXPECT_EQ(2, client_socket_factory_.allocation_count());
 }
 
+// Test that once the IPv4 connect has won a race, the next job starts the IPv4
+// connect without waiting, and that the races are logged.
+TEST_F(TransportClientSocketPoolTest, IPv6FallbackRemembersIPv4Win) {
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  CapturingNetLog log;
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 &log);
+
+  MockClientSocketFactory::ClientSocketType case_types[] = {
+    // The first job: the IPv6 socket stalls, the IPv4 socket wins.
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+    MockClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET,
+    // The second job: the IPv6 socket wins.
+    MockClientSocketFactory::MOCK_DELAYED_CLIENT_SOCKET,
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET
+  };
+
+  client_socket_factory_.set_client_socket_types(case_types, 4);
+  client_socket_factory_.set_delay(base::TimeDelta::FromMilliseconds(50));
+
+  // Resolve an AddressList with a IPv6 address first and then a IPv4 address.
+  host_resolver_->rules()->AddIPLiteralRule(
+      "*", "2:abcd::3:4:ff,2.2.2.2", "");
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", low_params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  IPEndPoint endpoint;
+  handle.socket()->GetLocalAddress(&endpoint);
+  EXPECT_EQ(kIPv4AddressSize, endpoint.address().size());
+
+  ClientSocketHandle handle2;
+  rv = handle2.Init("b", low_params_, LOW, callback.callback(), &pool,
+                    BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  handle2.socket()->GetLocalAddress(&endpoint);
+  EXPECT_EQ(kIPv6AddressSize, endpoint.address().size());
+  EXPECT_EQ(4, client_socket_factory_.allocation_count());
+
+  CapturingNetLog::CapturedEntryList entries;
+  log.GetEntries(&entries);
+  std::vector<int> delays;
+  std::vector<std::string> winners;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    int delay_ms;
+    std::string winner;
+    if (entries[i].type == NetLog::TYPE_TRANSPORT_CONNECT_JOB_IPV6_FALLBACK &&
+        entries[i].GetIntegerValue("delay_ms", &delay_ms)) {
+      delays.push_back(delay_ms);
+    }
+    if (entries[i].type == NetLog::TYPE_TRANSPORT_CONNECT_JOB_RACE_WINNER &&
+        entries[i].GetStringValue("winner", &winner)) {
+      winners.push_back(winner);
+    }
+  }
+  ASSERT_EQ(2u, delays.size());
+  EXPECT_GE(delays[0], TransportConnectJob::kIPv6FallbackTimerInMs);
+  EXPECT_LT(delays[1], TransportConnectJob::kIPv6FallbackTimerInMs);
+  ASSERT_EQ(2u, winners.size());
+  EXPECT_EQ("ipv4", winners[0]);
+  EXPECT_EQ("ipv6", winners[1]);
+}
+
 TEST_F(TransportClientSocketPoolTest, IPv6NoIPv4AddressesToFallbackTo) {
   // Create a pool without backup jobs.
   ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
@@ -17,12 +17,13 @@ namespace net {
 BufferedSpdyFramer::BufferedSpdyFramer(int version)
     : spdy_framer_(version),
       visitor_(NULL),
+      header_block_builder_(&header_block_),
+      header_parser_(version, &header_block_builder_),
       header_buffer_used_(0),
       header_buffer_valid_(false),
       header_stream_id_(SpdyFramer::kInvalidStream),
       frames_received_(0) {
   spdy_framer_.set_enable_compression(g_enable_compression_default);
-  memset(header_buffer_, 0, sizeof(header_buffer_));
 }
 
 BufferedSpdyFramer::~BufferedSpdyFramer() {
@@ -98,10 +99,8 @@ bool BufferedSpdyFramer::OnControlFrameHeaderData(SpdyStreamId stream_id,
     // Indicates end-of-header-block.
     CHECK(header_buffer_valid_);
 
-    SpdyHeaderBlock headers;
-    bool parsed_headers = spdy_framer_.ParseHeaderBlockInBuffer(
-        header_buffer_, header_buffer_used_, &headers);
-    if (!parsed_headers) {
+    const SpdyHeaderBlock& headers = header_block_;
+    if (!header_parser_.IsComplete()) {
       visitor_->OnStreamError(
           stream_id, "Could not parse Spdy Control Frame Header.");
       return false;
@@ -143,8 +142,10 @@ bool BufferedSpdyFramer::OnControlFrameHeaderData(SpdyStreamId stream_id,
         stream_id, "Received more data than the allocated size.");
     return false;
   }
-  memcpy(header_buffer_ + header_buffer_used_, header_data, len);
   header_buffer_used_ += len;
+  // A malformed block is reported by the zero-length call above, as a stream
+  // error, so that the session can continue.
+  header_parser_.HandleData(header_data, len);
   return true;
 }
 
@@ -302,7 +303,8 @@ void BufferedSpdyFramer::set_enable_compression_default(bool value) {
 }
 
 void BufferedSpdyFramer::InitHeaderStreaming(SpdyStreamId stream_id) {
-  memset(header_buffer_, 0, kHeaderBufferSize);
+  header_block_.clear();
+  header_parser_.Reset();
   header_buffer_used_ = 0;
   header_buffer_valid_ = true;
   header_stream_id_ = stream_id;
@@ -184,7 +184,7 @@ class NET_EXPORT_PRIVATE BufferedSpdyFramer
   int frames_received() const { return frames_received_; }
 
  private:
-  // The size of the header_buffer_.
+  // The maximum size of a decompressed header block.
   enum { kHeaderBufferSize = 32 * 1024 };
 
   void InitHeaderStreaming(SpdyStreamId stream_id);
@@ -192,8 +192,11 @@ class NET_EXPORT_PRIVATE BufferedSpdyFramer
   SpdyFramer spdy_framer_;
   BufferedSpdyFramerVisitorInterface* visitor_;
 
-  // Header block streaming state:
-  char header_buffer_[kHeaderBufferSize];
+  // Header block streaming state. Headers are parsed into |header_block_| as
+  // their chunks arrive, rather than buffering the whole block first.
+  SpdyHeaderBlock header_block_;
+  SpdyHeaderBlockBuilder header_block_builder_;
+  SpdyHeaderBlockParser header_parser_;
   size_t header_buffer_used_;
   bool header_buffer_valid_;
   SpdyStreamId header_stream_id_;
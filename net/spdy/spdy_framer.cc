@@ -117,6 +117,136 @@ void SettingsFlagsAndId::ConvertFlagsAndIdForSpdy2(uint32* val) {
 SpdyCredential::SpdyCredential() : slot(0) {}
 SpdyCredential::~SpdyCredential() {}
 
+bool SpdyHeaderBlockBuilder::OnHeaderPair(const base::StringPiece& name,
+                                          const base::StringPiece& value) {
+  std::pair<SpdyHeaderBlock::iterator, bool> result =
+      block_->insert(SpdyHeaderBlock::value_type(name.as_string(),
+                                                 std::string()));
+  if (!result.second) {
+    DLOG(INFO) << "Duplicate header '" << name << "'.";
+    return false;
+  }
+  value.CopyToString(&result.first->second);
+  return true;
+}
+
+SpdyHeaderBlockParser::SpdyHeaderBlockParser(int version,
+                                             SpdyHeaderPairVisitor* visitor)
+    : length_field_size_(version < 3 ? sizeof(uint16) : sizeof(uint32)),
+      visitor_(visitor),
+      has_num_headers_(false),
+      num_headers_(0),
+      headers_parsed_(0),
+      error_(false) {
+  DCHECK(visitor_);
+}
+
+SpdyHeaderBlockParser::~SpdyHeaderBlockParser() {
+}
+
+bool SpdyHeaderBlockParser::HandleData(const char* data, size_t len) {
+  if (error_)
+    return false;
+
+  // Complete the item that the previous chunk ended in the middle of. Its
+  // size grows as its length fields arrive.
+  while (!buffer_.empty() && len > 0) {
+    size_t bytes = static_cast<size_t>(
+        std::min<uint64>(PendingItemSize() - buffer_.size(), len));
+    buffer_.append(data, bytes);
+    data += bytes;
+    len -= bytes;
+    if (PendingItemSize() == buffer_.size()) {
+      ParseItems(buffer_.data(), buffer_.size());
+      buffer_.clear();
+      if (error_)
+        return false;
+    }
+  }
+
+  size_t consumed = ParseItems(data, len);
+  if (error_)
+    return false;
+  buffer_.append(data + consumed, len - consumed);
+  return true;
+}
+
+bool SpdyHeaderBlockParser::IsComplete() const {
+  return !error_ && has_num_headers_ && headers_parsed_ == num_headers_;
+}
+
+void SpdyHeaderBlockParser::Reset() {
+  has_num_headers_ = false;
+  num_headers_ = 0;
+  headers_parsed_ = 0;
+  error_ = false;
+  buffer_.clear();
+}
+
+uint32 SpdyHeaderBlockParser::ReadLength(const char* data) const {
+  if (length_field_size_ == sizeof(uint16)) {
+    uint16 length;
+    memcpy(&length, data, sizeof(length));
+    return ntohs(length);
+  }
+  uint32 length;
+  memcpy(&length, data, sizeof(length));
+  return ntohl(length);
+}
+
+uint64 SpdyHeaderBlockParser::PendingItemSize() const {
+  const uint64 field_size = length_field_size_;
+  if (!has_num_headers_ || buffer_.size() < field_size)
+    return field_size;
+  const uint64 name_size = ReadLength(buffer_.data());
+  if (buffer_.size() < field_size + name_size + field_size)
+    return field_size + name_size + field_size;
+  return field_size + name_size + field_size +
+      ReadLength(buffer_.data() + field_size + name_size);
+}
+
+size_t SpdyHeaderBlockParser::ParseItems(const char* data, size_t len) {
+  const size_t field_size = length_field_size_;
+  size_t offset = 0;
+  if (!has_num_headers_) {
+    if (len < field_size)
+      return 0;
+    num_headers_ = ReadLength(data);
+    has_num_headers_ = true;
+    offset += field_size;
+  }
+
+  while (headers_parsed_ < num_headers_) {
+    size_t available = len - offset;
+    if (available < field_size)
+      break;
+    size_t name_size = ReadLength(data + offset);
+    if (available - field_size < name_size ||
+        available - field_size - name_size < field_size) {
+      break;
+    }
+    size_t value_size = ReadLength(data + offset + field_size + name_size);
+    if (available - field_size - name_size - field_size < value_size)
+      break;
+
+    base::StringPiece name(data + offset + field_size, name_size);
+    base::StringPiece value(data + offset + field_size + name_size +
+                                field_size,
+                            value_size);
+    offset += field_size + name_size + field_size + value_size;
+    ++headers_parsed_;
+    if (!visitor_->OnHeaderPair(name, value)) {
+      error_ = true;
+      break;
+    }
+  }
+
+  // Bytes after the last header are ignored.
+  if (IsComplete())
+    return len;
+  return offset;
+}
+
 SpdyFramer::SpdyFramer(int version)
     : state_(SPDY_RESET),
       previous_state_(SPDY_RESET),
@@ -1141,55 +1271,20 @@ size_t SpdyFramer::ProcessDataFramePayload(const char* data, size_t len) {
 bool SpdyFramer::ParseHeaderBlockInBuffer(const char* header_data,
                                           size_t header_length,
                                           SpdyHeaderBlock* block) const {
-  SpdyFrameReader reader(header_data, header_length);
-
-  // Read number of headers.
-  uint32 num_headers;
-  if (spdy_version_ < 3) {
-    uint16 temp;
-    if (!reader.ReadUInt16(&temp)) {
-      DLOG(INFO) << "Unable to read number of headers.";
-      return false;
-    }
-    num_headers = temp;
-  } else {
-    if (!reader.ReadUInt32(&num_headers)) {
-      DLOG(INFO) << "Unable to read number of headers.";
-      return false;
-    }
-  }
-
-  // Read each header.
-  for (uint32 index = 0; index < num_headers; ++index) {
-    base::StringPiece temp;
-
-    // Read header name.
-    if ((spdy_version_ < 3) ? !reader.ReadStringPiece16(&temp)
-                            : !reader.ReadStringPiece32(&temp)) {
-      DLOG(INFO) << "Unable to read header name (" << index + 1 << " of "
-                 << num_headers << ").";
-      return false;
-    }
-    std::string name = temp.as_string();
-
-    // Read header value.
-    if ((spdy_version_ < 3) ? !reader.ReadStringPiece16(&temp)
-                            : !reader.ReadStringPiece32(&temp)) {
-      DLOG(INFO) << "Unable to read header value (" << index + 1 << " of "
-                 << num_headers << ").";
-      return false;
-    }
-    std::string value = temp.as_string();
-
-    // Ensure no duplicates.
-    if (block->find(name) != block->end()) {
-      DLOG(INFO) << "Duplicate header '" << name << "' (" << index + 1 << " of "
-                 << num_headers << ").";
-      return false;
-    }
+  SpdyHeaderBlockBuilder builder(block);
+  return ParseHeaderBlockInBuffer(header_data, header_length, &builder);
+}
 
-    // Store header.
-    (*block)[name] = value;
+bool SpdyFramer::ParseHeaderBlockInBuffer(
+    const char* header_data,
+    size_t header_length,
+    SpdyHeaderPairVisitor* visitor) const {
+  SpdyHeaderBlockParser parser(spdy_version_, visitor);
+  if (!parser.HandleData(header_data, header_length))
+    return false;
+  if (!parser.IsComplete()) {
+    DLOG(INFO) << "Truncated header block.";
+    return false;
   }
   return true;
 }
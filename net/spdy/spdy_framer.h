@@ -12,8 +12,10 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/string_piece.h"
 #include "base/sys_byteorder.h"
 #include "net/base/net_export.h"
 #include "net/spdy/spdy_header_block.h"
@@ -102,6 +104,87 @@ struct NET_EXPORT_PRIVATE SpdySettingsScratch {
   uint32 last_setting_id;
 };
 
+// Receives the name/value pairs of a serialized header block as views into
+// the parsed data. The pieces are only valid for the duration of the call.
+class NET_EXPORT_PRIVATE SpdyHeaderPairVisitor {
+ public:
+  virtual ~SpdyHeaderPairVisitor() {}
+
+  // Called once for each header, in the order in which they appear in the
+  // block. Returning false stops the parse and makes it fail.
+  virtual bool OnHeaderPair(const base::StringPiece& name,
+                            const base::StringPiece& value) = 0;
+};
+
+// A SpdyHeaderPairVisitor that copies the headers into a SpdyHeaderBlock.
+// Rejects a block that contains the same header name twice.
+class NET_EXPORT_PRIVATE SpdyHeaderBlockBuilder
+    : public SpdyHeaderPairVisitor {
+ public:
+  explicit SpdyHeaderBlockBuilder(SpdyHeaderBlock* block) : block_(block) {}
+  virtual ~SpdyHeaderBlockBuilder() {}
+
+  // SpdyHeaderPairVisitor implementation.
+  virtual bool OnHeaderPair(const base::StringPiece& name,
+                            const base::StringPiece& value) OVERRIDE;
+
+ private:
+  SpdyHeaderBlock* block_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyHeaderBlockBuilder);
+};
+
+// Parses a decompressed header block that arrives in chunks, such as the
+// chunks passed to SpdyFramerVisitorInterface::OnControlFrameHeaderData().
+// Headers that lie within one chunk are passed to the visitor as views into
+// that chunk. Only a header that is split across two chunks is copied, into
+// an internal buffer, so the block is never buffered as a whole.
+class NET_EXPORT_PRIVATE SpdyHeaderBlockParser {
+ public:
+  // |visitor| must outlive the parser.
+  SpdyHeaderBlockParser(int version, SpdyHeaderPairVisitor* visitor);
+  ~SpdyHeaderBlockParser();
+
+  // Parses the next |len| bytes of the header block. Returns false if the
+  // visitor rejected a header, in which case the parser ignores all data
+  // until Reset(). Data after the last header of the block is ignored.
+  bool HandleData(const char* data, size_t len);
+
+  // Returns true once all the headers of the block have been parsed and
+  // accepted by the visitor.
+  bool IsComplete() const;
+
+  // Prepares the parser for a new header block.
+  void Reset();
+
+ private:
+  // Reads a header count or length field.
+  uint32 ReadLength(const char* data) const;
+
+  // Returns the size of the item (the header count or a header) that
+  // |buffer_| starts with, as far as it is known from the length fields
+  // already in |buffer_|.
+  uint64 PendingItemSize() const;
+
+  // Parses the complete items at the start of |data| and returns the number
+  // of bytes they take up.
+  size_t ParseItems(const char* data, size_t len);
+
+  // The size of the count and length fields: 2 bytes in SPDY/2, 4 in SPDY/3.
+  const size_t length_field_size_;
+  SpdyHeaderPairVisitor* visitor_;
+
+  bool has_num_headers_;
+  uint32 num_headers_;
+  uint32 headers_parsed_;
+  bool error_;
+
+  // The start of an item that was split across chunks.
+  std::string buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyHeaderBlockParser);
+};
+
 // SpdyFramerVisitorInterface is a set of callbacks for the SpdyFramer.
 // Implement this interface to receive event callbacks as frames are
 // decoded from the framer.
@@ -301,6 +384,13 @@ class NET_EXPORT_PRIVATE SpdyFramer {
                                 size_t header_length,
                                 SpdyHeaderBlock* block) const;
 
+  // Like above, but passes the headers to |visitor| as views into
+  // |header_data| instead of copying them into a SpdyHeaderBlock. Unlike
+  // above, duplicate header names are left for the visitor to reject.
+  bool ParseHeaderBlockInBuffer(const char* header_data,
+                                size_t header_length,
+                                SpdyHeaderPairVisitor* visitor) const;
+
   // Create a SpdySynStreamControlFrame.
   // |stream_id| is the id for this stream.
   // |associated_stream_id| is the associated stream id for this stream.
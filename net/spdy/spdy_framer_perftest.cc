@@ -0,0 +1,96 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/string_piece.h"
+#include "base/stringprintf.h"
+#include "net/spdy/spdy_framer.h"
+#include "net/spdy/spdy_protocol.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kIterations = 20000;
+
+// Counts the headers passed to it without copying them.
+class HeaderPairCounter : public SpdyHeaderPairVisitor {
+ public:
+  HeaderPairCounter() : count_(0) {}
+
+  virtual bool OnHeaderPair(const base::StringPiece& name,
+                            const base::StringPiece& value) OVERRIDE {
+    ++count_;
+    return true;
+  }
+
+  size_t count() const { return count_; }
+
+ private:
+  size_t count_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeaderPairCounter);
+};
+
+// Measures parsing of a typical response header block, copied into a
+// SpdyHeaderBlock and as views.
+void MeasureHeaderBlockParsing(int version) {
+  SpdyHeaderBlock headers;
+  headers["status"] = "200 OK";
+  headers["version"] = "HTTP/1.1";
+  headers["cache-control"] = "private, max-age=0";
+  headers["content-encoding"] = "gzip";
+  headers["content-type"] = "text/html; charset=UTF-8";
+  headers["date"] = "Mon, 12 Nov 2012 12:12:12 GMT";
+  headers["expires"] = "-1";
+  headers["server"] = "gws";
+  headers["set-cookie"] = std::string(200, 'c');
+  headers["x-frame-options"] = "SAMEORIGIN";
+  headers["x-xss-protection"] = "1; mode=block";
+
+  SpdyFramer framer(version);
+  scoped_ptr<SpdySynReplyControlFrame> frame(
+      framer.CreateSynReply(1, CONTROL_FLAG_NONE, false, &headers));
+  std::string serialized_headers(frame->header_block(),
+                                 frame->header_block_len());
+
+  {
+    PerfTimeLogger timer(base::StringPrintf(
+        "SpdyFramer_parse_header_block_spdy%d", version).c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      SpdyHeaderBlock new_headers;
+      ASSERT_TRUE(framer.ParseHeaderBlockInBuffer(serialized_headers.data(),
+                                                  serialized_headers.size(),
+                                                  &new_headers));
+    }
+    timer.Done();
+  }
+
+  {
+    PerfTimeLogger timer(base::StringPrintf(
+        "SpdyFramer_parse_header_views_spdy%d", version).c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      HeaderPairCounter counter;
+      ASSERT_TRUE(framer.ParseHeaderBlockInBuffer(serialized_headers.data(),
+                                                  serialized_headers.size(),
+                                                  &counter));
+      ASSERT_EQ(headers.size(), counter.count());
+    }
+    timer.Done();
+  }
+}
+
+}  // namespace
+
+TEST(SpdyFramerPerfTest, HeaderBlockParsing) {
+  MeasureHeaderBlockParsing(2);
+  MeasureHeaderBlockParsing(3);
+}
+
+}  // namespace net
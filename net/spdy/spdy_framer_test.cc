@@ -883,6 +883,135 @@ TEST_P(SpdyFramerTest, MultiValueHeader) {
   EXPECT_EQ(value, new_headers.find("name")->second);
 }
 
+// Records the headers passed to it, and whether they all pointed into
+// |data|.
+class HeaderPairRecorder : public SpdyHeaderPairVisitor {
+ public:
+  HeaderPairRecorder(const char* data, size_t len)
+      : data_(data), len_(len), all_views_(true) {}
+
+  virtual bool OnHeaderPair(const base::StringPiece& name,
+                            const base::StringPiece& value) OVERRIDE {
+    all_views_ = all_views_ && IsView(name) && IsView(value);
+    headers_.push_back(std::make_pair(name.as_string(), value.as_string()));
+    return true;
+  }
+
+  const std::vector<std::pair<string, string> >& headers() const {
+    return headers_;
+  }
+  bool all_views() const { return all_views_; }
+
+ private:
+  bool IsView(const base::StringPiece& piece) const {
+    return piece.data() >= data_ && piece.data() + piece.size() <= data_ + len_;
+  }
+
+  const char* data_;
+  size_t len_;
+  bool all_views_;
+  std::vector<std::pair<string, string> > headers_;
+};
+
+// Returns the serialized, uncompressed header block of a SYN_REPLY frame
+// carrying |headers|.
+string SerializeHeaderBlock(int version, const SpdyHeaderBlock& headers) {
+  SpdyFramer framer(version);
+  scoped_ptr<SpdySynReplyControlFrame> frame(
+      framer.CreateSynReply(1, CONTROL_FLAG_NONE, false, &headers));
+  return string(frame->header_block(), frame->header_block_len());
+}
+
+// Test that headers are handed out as views into the parsed buffer, in the
+// order in which they were serialized.
+TEST_P(SpdyFramerTest, HeaderBlockInBufferAsViews) {
+  SpdyHeaderBlock headers;
+  headers["alpha"] = "beta";
+  headers["gamma"] = "charlie";
+  string serialized_headers(SerializeHeaderBlock(spdy_version_, headers));
+
+  SpdyFramer framer(spdy_version_);
+  HeaderPairRecorder recorder(serialized_headers.data(),
+                              serialized_headers.size());
+  EXPECT_TRUE(framer.ParseHeaderBlockInBuffer(serialized_headers.data(),
+                                              serialized_headers.size(),
+                                              &recorder));
+  EXPECT_TRUE(recorder.all_views());
+  ASSERT_EQ(2u, recorder.headers().size());
+  EXPECT_EQ("alpha", recorder.headers()[0].first);
+  EXPECT_EQ("beta", recorder.headers()[0].second);
+  EXPECT_EQ("gamma", recorder.headers()[1].first);
+  EXPECT_EQ("charlie", recorder.headers()[1].second);
+}
+
+// Test that a header block can be parsed as it arrives, one byte at a time.
+TEST_P(SpdyFramerTest, HeaderBlockParserOneByteAtATime) {
+  SpdyHeaderBlock headers;
+  headers["alpha"] = "beta";
+  headers["empty"] = "";
+  headers["gamma"] = string(2000, 'c');
+  string serialized_headers(SerializeHeaderBlock(spdy_version_, headers));
+
+  SpdyHeaderBlock new_headers;
+  SpdyHeaderBlockBuilder builder(&new_headers);
+  SpdyHeaderBlockParser parser(spdy_version_, &builder);
+  for (size_t i = 0; i < serialized_headers.size(); ++i) {
+    EXPECT_FALSE(parser.IsComplete());
+    EXPECT_TRUE(parser.HandleData(&serialized_headers[i], 1));
+  }
+  EXPECT_TRUE(parser.IsComplete());
+  EXPECT_TRUE(CompareHeaderBlocks(&headers, &new_headers));
+
+  // The parser can be reused for the next block.
+  parser.Reset();
+  new_headers.clear();
+  EXPECT_TRUE(parser.HandleData(serialized_headers.data(),
+                                serialized_headers.size()));
+  EXPECT_TRUE(parser.IsComplete());
+  EXPECT_TRUE(CompareHeaderBlocks(&headers, &new_headers));
+}
+
+// Test that only the headers split across chunks are copied.
+TEST_P(SpdyFramerTest, HeaderBlockParserSplitHeader) {
+  SpdyHeaderBlock headers;
+  headers["alpha"] = "beta";
+  headers["gamma"] = "charlie";
+  string serialized_headers(SerializeHeaderBlock(spdy_version_, headers));
+  // Split in the middle of "charlie", the value of the second header.
+  const size_t split = serialized_headers.size() - 3;
+
+  HeaderPairRecorder recorder(serialized_headers.data(), split);
+  SpdyHeaderBlockParser parser(spdy_version_, &recorder);
+  EXPECT_TRUE(parser.HandleData(serialized_headers.data(), split));
+  ASSERT_EQ(1u, recorder.headers().size());
+  EXPECT_TRUE(recorder.all_views());
+  EXPECT_FALSE(parser.IsComplete());
+
+  EXPECT_TRUE(parser.HandleData(serialized_headers.data() + split,
+                                serialized_headers.size() - split));
+  EXPECT_TRUE(parser.IsComplete());
+  ASSERT_EQ(2u, recorder.headers().size());
+  EXPECT_FALSE(recorder.all_views());
+  EXPECT_EQ("charlie", recorder.headers()[1].second);
+}
+
+// Test that a duplicate header makes the parser fail for the rest of the
+// block.
+TEST_P(SpdyFramerTest, HeaderBlockParserRejectsDuplicate) {
+  SpdyHeaderBlock headers;
+  headers["name"] = "value";
+  string serialized_headers(SerializeHeaderBlock(spdy_version_, headers));
+
+  SpdyHeaderBlock new_headers;
+  new_headers["name"] = "other";
+  SpdyHeaderBlockBuilder builder(&new_headers);
+  SpdyHeaderBlockParser parser(spdy_version_, &builder);
+  EXPECT_FALSE(parser.HandleData(serialized_headers.data(),
+                                 serialized_headers.size()));
+  EXPECT_FALSE(parser.IsComplete());
+  EXPECT_FALSE(parser.HandleData(serialized_headers.data(), 1));
+}
+
 TEST_P(SpdyFramerTest, BasicCompression) {
   SpdyHeaderBlock headers;
   headers["server"] = "SpdyServer 1.0";
@@ -188,6 +188,11 @@ size_t g_default_initial_rcv_window_size = 10 * 1024 * 1024;  // 10MB
 bool g_enable_ping_based_connection_checking = true;
 bool g_enable_credential_frames = false;
 
+// The most bytes of queued frames that are combined into a single socket
+// write. Bounding the batch bounds how long a frame that is queued while the
+// batch is being written waits for it.
+const size_t kMaxWriteBatchSize = 16 * 1024;
+
 typedef base::TimeTicks (*ExternalTimeFunc)(void);
 
 static ExternalTimeFunc g_time_func = base::TimeTicks::Now;
@@ -444,9 +449,8 @@ bool SpdySession::VerifyDomainAuthentication(const std::string& domain) {
 
 void SpdySession::SetStreamHasWriteAvailable(SpdyStream* stream,
                                              SpdyIOBufferProducer* producer) {
-  write_queue_.push(producer);
   stream_producers_[producer] = stream;
-  WriteSocketLater();
+  EnqueueWrite(producer);
 }
 
 int SpdySession::GetPushStream(
@@ -867,8 +871,6 @@ void SpdySession::OnWriteComplete(int result) {
   last_activity_time_ = base::TimeTicks::Now();
   write_pending_ = false;
 
-  scoped_refptr<SpdyStream> stream = in_flight_write_.stream();
-
   if (result >= 0) {
     // It should not be possible to have written more bytes than our
     // in_flight_write_.
@@ -876,26 +878,37 @@ void SpdySession::OnWriteComplete(int result) {
 
     in_flight_write_.buffer()->DidConsume(result);
 
-    // We only notify the stream when we've fully written the pending frame.
-    if (!in_flight_write_.buffer()->BytesRemaining()) {
+    // We only notify a stream when we've fully written its frame.
+    int bytes_written = result;
+    while (bytes_written > 0 && !in_flight_frames_.empty()) {
+      SpdyIOBuffer frame = in_flight_frames_.front();
+      int consumed = std::min(bytes_written, frame.buffer()->BytesRemaining());
+      frame.buffer()->DidConsume(consumed);
+      bytes_written -= consumed;
+      if (frame.buffer()->BytesRemaining())
+        break;
+      in_flight_frames_.pop_front();
+
+      scoped_refptr<SpdyStream> stream = frame.stream();
       if (stream) {
         // Report the number of bytes written to the caller, but exclude the
         // frame size overhead.  NOTE: if this frame was compressed the
         // reported bytes written is the compressed size, not the original
         // size.
-        if (result > 0) {
-          result = in_flight_write_.buffer()->size();
-          DCHECK_GE(result, static_cast<int>(SpdyFrame::kHeaderSize));
-          result -= static_cast<int>(SpdyFrame::kHeaderSize);
-        }
+        int frame_result = frame.buffer()->size();
+        DCHECK_GE(frame_result, static_cast<int>(SpdyFrame::kHeaderSize));
+        frame_result -= static_cast<int>(SpdyFrame::kHeaderSize);
 
         // It is possible that the stream was cancelled while we were writing
         // to the socket.
         if (!stream->cancelled())
-          stream->OnWriteComplete(result);
+          stream->OnWriteComplete(frame_result);
       }
+    }
 
-      // Cleanup the write which just completed.
+    // Cleanup the write which just completed.
+    if (!in_flight_write_.buffer()->BytesRemaining()) {
+      DCHECK(in_flight_frames_.empty());
       in_flight_write_.release();
     }
 
@@ -905,6 +918,7 @@ void SpdySession::OnWriteComplete(int result) {
     WriteSocketLater();
   } else {
     in_flight_write_.release();
+    in_flight_frames_.clear();
 
     // The stream is now errored.  Close it down.
     CloseSessionOnError(
@@ -980,22 +994,12 @@ void SpdySession::WriteSocket() {
   // Loop sending frames until we've sent everything or until the write
   // returns error (or ERR_IO_PENDING).
   DCHECK(buffered_spdy_framer_.get());
-  while (in_flight_write_.buffer() || !write_queue_.empty()) {
+  while (in_flight_write_.buffer() || !IsWriteQueueEmpty()) {
     if (!in_flight_write_.buffer()) {
-      // Grab the next SpdyBuffer to send.
-      scoped_ptr<SpdyIOBufferProducer> producer(write_queue_.top());
-      write_queue_.pop();
-      scoped_ptr<SpdyIOBuffer> buffer(producer->ProduceNextBuffer(this));
-      stream_producers_.erase(producer.get());
-      // It is possible that a stream had data to write, but a
-      // WINDOW_UPDATE frame has been received which made that
-      // stream no longer writable.
-      // TODO(rch): consider handling that case by removing the
-      // stream from the writable queue?
-      if (buffer == NULL)
+      // Grab the next SpdyBuffers to send.
+      PrepareWriteBatch();
+      if (!in_flight_write_.buffer())
         continue;
-
-      in_flight_write_ = *buffer;
     } else {
       DCHECK(in_flight_write_.buffer()->BytesRemaining());
     }
@@ -1018,6 +1022,102 @@ void SpdySession::WriteSocket() {
   }
 }
 
+void SpdySession::EnqueueWrite(SpdyIOBufferProducer* producer) {
+  RequestPriority priority = producer->GetPriority();
+  DCHECK_GE(priority, MINIMUM_PRIORITY);
+  DCHECK_LT(priority, NUM_PRIORITIES);
+  write_queue_[priority].push_back(
+      QueuedWrite(producer, base::TimeTicks::Now()));
+  WriteSocketLater();
+}
+
+SpdySession::SpdyIOBufferProducer* SpdySession::DequeueWrite() {
+  for (int i = NUM_PRIORITIES - 1; i >= MINIMUM_PRIORITY; --i) {
+    if (write_queue_[i].empty())
+      continue;
+    QueuedWrite queued = write_queue_[i].front();
+    write_queue_[i].pop_front();
+
+    base::TimeDelta queue_time = base::TimeTicks::Now() - queued.queue_time;
+    switch (i) {
+      case IDLE:
+        UMA_HISTOGRAM_TIMES("Net.SpdyWriteQueueTime.Idle", queue_time);
+        break;
+      case LOWEST:
+        UMA_HISTOGRAM_TIMES("Net.SpdyWriteQueueTime.Lowest", queue_time);
+        break;
+      case LOW:
+        UMA_HISTOGRAM_TIMES("Net.SpdyWriteQueueTime.Low", queue_time);
+        break;
+      case MEDIUM:
+        UMA_HISTOGRAM_TIMES("Net.SpdyWriteQueueTime.Medium", queue_time);
+        break;
+      case HIGHEST:
+        UMA_HISTOGRAM_TIMES("Net.SpdyWriteQueueTime.Highest", queue_time);
+        break;
+    }
+    return queued.producer;
+  }
+  return NULL;
+}
+
+bool SpdySession::IsWriteQueueEmpty() const {
+  for (int i = MINIMUM_PRIORITY; i < NUM_PRIORITIES; ++i) {
+    if (!write_queue_[i].empty())
+      return false;
+  }
+  return true;
+}
+
+void SpdySession::PrepareWriteBatch() {
+  DCHECK(!in_flight_write_.buffer());
+  DCHECK(in_flight_frames_.empty());
+
+  size_t batch_size = 0;
+  while (batch_size < kMaxWriteBatchSize) {
+    scoped_ptr<SpdyIOBufferProducer> producer(DequeueWrite());
+    if (!producer.get())
+      break;
+    scoped_ptr<SpdyIOBuffer> buffer(producer->ProduceNextBuffer(this));
+    stream_producers_.erase(producer.get());
+    // It is possible that a stream had data to write, but a
+    // WINDOW_UPDATE frame has been received which made that
+    // stream no longer writable.
+    // TODO(rch): consider handling that case by removing the
+    // stream from the writable queue?
+    if (buffer == NULL)
+      continue;
+
+    batch_size += buffer->size();
+    in_flight_frames_.push_back(*buffer);
+  }
+
+  if (in_flight_frames_.empty())
+    return;
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Net.SpdyFramesPerWrite",
+                              static_cast<int>(in_flight_frames_.size()),
+                              1, 100, 50);
+
+  // The write gets its own DrainableIOBuffer, so that the frames keep track
+  // of how much of each of them has been written.
+  const SpdyIOBuffer& first = in_flight_frames_.front();
+  if (in_flight_frames_.size() == 1) {
+    in_flight_write_ = SpdyIOBuffer(first.buffer(), first.size(),
+                                    first.priority(), NULL);
+    return;
+  }
+
+  scoped_refptr<IOBufferWithSize> batch(new IOBufferWithSize(batch_size));
+  size_t offset = 0;
+  for (std::deque<SpdyIOBuffer>::const_iterator it = in_flight_frames_.begin();
+       it != in_flight_frames_.end(); ++it) {
+    memcpy(batch->data() + offset, it->buffer()->data(), it->size());
+    offset += it->size();
+  }
+  DCHECK_EQ(batch_size, offset);
+  in_flight_write_ = SpdyIOBuffer(batch, batch_size, first.priority(), NULL);
+}
+
 void SpdySession::CloseAllStreams(net::Error status) {
   base::StatsCounter abandoned_streams("spdy.abandoned_streams");
   base::StatsCounter abandoned_push_streams(
@@ -1055,10 +1155,13 @@ void SpdySession::CloseAllStreams(net::Error status) {
   }
 
   // We also need to drain the queue.
-  while (!write_queue_.empty()) {
-    scoped_ptr<SpdyIOBufferProducer> producer(write_queue_.top());
-    write_queue_.pop();
-    stream_producers_.erase(producer.get());
+  for (int i = MINIMUM_PRIORITY; i < NUM_PRIORITIES; ++i) {
+    while (!write_queue_[i].empty()) {
+      scoped_ptr<SpdyIOBufferProducer> producer(
+          write_queue_[i].front().producer);
+      write_queue_[i].pop_front();
+      stream_producers_.erase(producer.get());
+    }
   }
 }
 
@@ -1188,10 +1291,7 @@ class SimpleSpdyIOBufferProducer : public SpdySession::SpdyIOBufferProducer {
 
 void SpdySession::QueueFrame(SpdyFrame* frame,
                              RequestPriority priority) {
-  SimpleSpdyIOBufferProducer* producer =
-      new SimpleSpdyIOBufferProducer(frame, priority);
-  write_queue_.push(producer);
-  WriteSocketLater();
+  EnqueueWrite(new SimpleSpdyIOBufferProducer(frame, priority));
 }
 
 void SpdySession::ActivateStream(SpdyStream* stream) {
@@ -1227,17 +1327,19 @@ void SpdySession::DeleteStream(SpdyStreamId id, int status) {
     return;
 
   // Possibly remove from the write queue.
-  WriteQueue old = write_queue_;
-  write_queue_ = WriteQueue();
-  while (!old.empty()) {
-    scoped_ptr<SpdyIOBufferProducer> producer(old.top());
-    old.pop();
-    StreamProducerMap::iterator it = stream_producers_.find(producer.get());
-    if (it == stream_producers_.end() || it->second->stream_id() != id) {
-      write_queue_.push(producer.release());
-    } else {
-      stream_producers_.erase(producer.get());
-      producer.reset(NULL);
+  for (int i = MINIMUM_PRIORITY; i < NUM_PRIORITIES; ++i) {
+    WriteQueue old;
+    old.swap(write_queue_[i]);
+    for (WriteQueue::iterator queued = old.begin(); queued != old.end();
+         ++queued) {
+      StreamProducerMap::iterator it =
+          stream_producers_.find(queued->producer);
+      if (it == stream_producers_.end() || it->second->stream_id() != id) {
+        write_queue_[i].push_back(*queued);
+      } else {
+        stream_producers_.erase(it);
+        delete queued->producer;
+      }
     }
   }
 
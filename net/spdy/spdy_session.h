@@ -6,6 +6,7 @@
 #define NET_SPDY_SPDY_SESSION_H_
 
 #include <algorithm>
+#include <deque>
 #include <list>
 #include <map>
 #include <queue>
@@ -397,16 +398,16 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
 
   typedef std::set<scoped_refptr<SpdyStream> > CreatedStreamSet;
   typedef std::map<SpdyIOBufferProducer*, SpdyStream*> StreamProducerMap;
-  class SpdyIOBufferProducerCompare {
-   public:
-    bool operator() (const SpdyIOBufferProducer* lhs,
-                     const SpdyIOBufferProducer* rhs) const {
-      return lhs->GetPriority() < rhs->GetPriority();
-    }
+
+  // A producer waiting to write, and the time at which it was queued.
+  struct QueuedWrite {
+    QueuedWrite(SpdyIOBufferProducer* producer, base::TimeTicks queue_time)
+        : producer(producer), queue_time(queue_time) {}
+
+    SpdyIOBufferProducer* producer;
+    base::TimeTicks queue_time;
   };
-  typedef std::priority_queue<SpdyIOBufferProducer*,
-                              std::vector<SpdyIOBufferProducer*>,
-                              SpdyIOBufferProducerCompare> WriteQueue;
+  typedef std::deque<QueuedWrite> WriteQueue;
 
   struct CallbackResultPair {
     CallbackResultPair(const CompletionCallback& callback_in, int result_in);
@@ -479,6 +480,21 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   void WriteSocketLater();
   void WriteSocket();
 
+  // Adds |producer| to the end of the write queue for its priority, taking
+  // ownership of it, and schedules a write.
+  void EnqueueWrite(SpdyIOBufferProducer* producer);
+
+  // Removes the first producer of the highest priority queue that is not
+  // empty and returns it, or NULL if every queue is empty. The caller takes
+  // ownership of the returned producer.
+  SpdyIOBufferProducer* DequeueWrite();
+
+  bool IsWriteQueueEmpty() const;
+
+  // Takes frames from the write queue, up to |kMaxWriteBatchSize| bytes of
+  // them, and makes |in_flight_write_| a buffer holding all of them.
+  void PrepareWriteBatch();
+
   // Get a new stream id.
   int GetNewStreamId();
 
@@ -635,8 +651,10 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   // Set of all created streams but that have not yet sent any frames.
   CreatedStreamSet created_streams_;
 
-  // As streams have data to be sent, we put them into the write queue.
-  WriteQueue write_queue_;
+  // As streams have data to be sent, we put them into the write queue for
+  // their priority. Each producer writes a single frame, so streams of the
+  // same priority take turns.
+  WriteQueue write_queue_[NUM_PRIORITIES];
 
   // Mapping from SpdyIOBufferProducers to their corresponding SpdyStream
   // so that when a stream is destroyed, we can remove the corresponding
@@ -647,6 +665,10 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   bool write_pending_;            // Will be true when a write is in progress.
   SpdyIOBuffer in_flight_write_;  // This is the write buffer in progress.
 
+  // The frames that |in_flight_write_| is made of, in order. A frame is
+  // removed, and its stream notified, once all of its bytes are written.
+  std::deque<SpdyIOBuffer> in_flight_frames_;
+
   // Flag if we have a pending message scheduled for WriteSocket.
   bool delayed_write_pending_;
 
@@ -18,14 +18,6 @@ namespace net {
 
 namespace {
 
-enum SpdySessionGetTypes {
-  CREATED_NEW                 = 0,
-  FOUND_EXISTING              = 1,
-  FOUND_EXISTING_FROM_IP_POOL = 2,
-  IMPORTED_FROM_SOCKET        = 3,
-  SPDY_SESSION_GET_MAX        = 4
-};
-
 bool HostPortProxyPairsAreEqual(const HostPortProxyPair& a,
                                 const HostPortProxyPair& b) {
   return a.first.Equals(b.first) && a.second == b.second;
@@ -52,6 +44,7 @@ SpdySessionPool::SpdySessionPool(
       enable_sending_initial_settings_(true),
       trusted_spdy_proxy_(
           HostPortPair::FromString(trusted_spdy_proxy)) {
+  memset(session_get_counts_, 0, sizeof(session_get_counts_));
   NetworkChangeNotifier::AddIPAddressObserver(this);
   if (ssl_config_service_)
     ssl_config_service_->AddObserver(this);
@@ -89,9 +82,7 @@ scoped_refptr<SpdySession> SpdySessionPool::GetInternal(
     // Check if we have a Session through a domain alias.
     spdy_session = GetFromAlias(host_port_proxy_pair, net_log, true);
     if (spdy_session) {
-      UMA_HISTOGRAM_ENUMERATION("Net.SpdySessionGet",
-                                FOUND_EXISTING_FROM_IP_POOL,
-                                SPDY_SESSION_GET_MAX);
+      RecordSessionGet(FOUND_EXISTING_FROM_IP_POOL);
       net_log.AddEvent(
           NetLog::TYPE_SPDY_SESSION_POOL_FOUND_EXISTING_SESSION_FROM_IP_POOL,
           spdy_session->net_log().source().ToEventParametersCallback());
@@ -108,9 +99,7 @@ scoped_refptr<SpdySession> SpdySessionPool::GetInternal(
 
   DCHECK(list);
   if (list->size() && list->size() == g_max_sessions_per_domain) {
-    UMA_HISTOGRAM_ENUMERATION("Net.SpdySessionGet",
-                              FOUND_EXISTING,
-                              SPDY_SESSION_GET_MAX);
+    RecordSessionGet(FOUND_EXISTING);
     spdy_session = GetExistingSession(list, net_log);
     net_log.AddEvent(
       NetLog::TYPE_SPDY_SESSION_POOL_FOUND_EXISTING_SESSION,
@@ -126,9 +115,7 @@ scoped_refptr<SpdySession> SpdySessionPool::GetInternal(
                                  enable_sending_initial_settings_,
                                  trusted_spdy_proxy_,
                                  net_log.net_log());
-  UMA_HISTOGRAM_ENUMERATION("Net.SpdySessionGet",
-                            CREATED_NEW,
-                            SPDY_SESSION_GET_MAX);
+  RecordSessionGet(CREATED_NEW);
   list->push_back(spdy_session);
   net_log.AddEvent(
       NetLog::TYPE_SPDY_SESSION_POOL_CREATED_NEW_SESSION,
@@ -144,9 +131,7 @@ net::Error SpdySessionPool::GetSpdySessionFromSocket(
     int certificate_error_code,
     scoped_refptr<SpdySession>* spdy_session,
     bool is_secure) {
-  UMA_HISTOGRAM_ENUMERATION("Net.SpdySessionGet",
-                            IMPORTED_FROM_SOCKET,
-                            SPDY_SESSION_GET_MAX);
+  RecordSessionGet(IMPORTED_FROM_SOCKET);
   // Create the SPDY session and add it to the pool.
   *spdy_session = new SpdySession(host_port_proxy_pair, this,
                                   http_server_properties_,
@@ -199,6 +184,7 @@ void SpdySessionPool::Remove(const scoped_refptr<SpdySession>& session) {
       session->net_log().source().ToEventParametersCallback());
 
   const std::set<HostPortProxyPair>& aliases = session->pooled_aliases();
+  UMA_HISTOGRAM_COUNTS_100("Net.SpdySessionPooledAliases", aliases.size());
   for (std::set<HostPortProxyPair>::const_iterator it = aliases.begin();
        it != aliases.end(); ++it) {
     ok = RemoveFromSessionList(session, *it);
@@ -321,6 +307,11 @@ void SpdySessionPool::OnCertTrustChanged(const X509Certificate* cert) {
   CloseCurrentSessions();
 }
 
+void SpdySessionPool::RecordSessionGet(SpdySessionGetType type) {
+  UMA_HISTOGRAM_ENUMERATION("Net.SpdySessionGet", type, SPDY_SESSION_GET_MAX);
+  ++session_get_counts_[type];
+}
+
 const HostPortProxyPair& SpdySessionPool::NormalizeListPair(
     const HostPortProxyPair& host_port_proxy_pair) const {
   if (!g_force_single_domain)
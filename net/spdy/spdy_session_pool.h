@@ -11,6 +11,7 @@
 
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
+#include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/cert_database.h"
 #include "net/base/host_port_pair.h"
@@ -45,6 +46,16 @@ class NET_EXPORT SpdySessionPool
       public SSLConfigService::Observer,
       public CertDatabase::Observer {
  public:
+  // How a request for a session was satisfied.  These values are recorded in
+  // the Net.SpdySessionGet histogram, so do not renumber them.
+  enum SpdySessionGetType {
+    CREATED_NEW                 = 0,
+    FOUND_EXISTING              = 1,
+    FOUND_EXISTING_FROM_IP_POOL = 2,
+    IMPORTED_FROM_SOCKET        = 3,
+    SPDY_SESSION_GET_MAX        = 4
+  };
+
   SpdySessionPool(HostResolver* host_resolver,
                   SSLConfigService* ssl_config_service,
                   HttpServerProperties* http_server_properties,
@@ -114,6 +125,14 @@ class NET_EXPORT SpdySessionPool
     return http_server_properties_;
   }
 
+  // Returns the number of Get() and GetSpdySessionFromSocket() calls since
+  // the pool was created that were satisfied as |type|.  Comparing the
+  // FOUND_EXISTING* counts with the others gives the session reuse rate.
+  int session_get_count(SpdySessionGetType type) const {
+    DCHECK_LT(type, SPDY_SESSION_GET_MAX);
+    return session_get_counts_[type];
+  }
+
   // NetworkChangeNotifier::IPAddressObserver methods:
 
   // We flush all idle sessions and release references to the active ones so
@@ -164,6 +183,10 @@ class NET_EXPORT SpdySessionPool
       const BoundNetLog& net_log,
       bool record_histograms) const;
 
+  // Records in the histogram and in |session_get_counts_| that a request for
+  // a session was satisfied as |type|.
+  void RecordSessionGet(SpdySessionGetType type);
+
   // Helper functions for manipulating the lists.
   const HostPortProxyPair& NormalizeListPair(
       const HostPortProxyPair& host_port_proxy_pair) const;
@@ -197,6 +220,9 @@ class NET_EXPORT SpdySessionPool
   // A map of IPEndPoint aliases for sessions.
   SpdyAliasMap aliases_;
 
+  // Counts of each SpdySessionGetType handed out, indexed by type.
+  int session_get_counts_[SPDY_SESSION_GET_MAX];
+
   static size_t g_max_sessions_per_domain;
   static bool g_force_single_domain;
   static bool g_enable_ip_pooling;
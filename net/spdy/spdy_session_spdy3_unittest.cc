@@ -1019,6 +1019,14 @@ void IPPoolingTest(bool clean_via_close_current_sessions) {
   EXPECT_EQ(session.get(), session1.get());
   EXPECT_NE(session2.get(), session1.get());
 
+  // Hosts 0 and 2 each created a session, and host 1 reused host 0's.
+  EXPECT_EQ(2, spdy_session_pool->session_get_count(
+      SpdySessionPool::CREATED_NEW));
+  EXPECT_EQ(1, spdy_session_pool->session_get_count(
+      SpdySessionPool::FOUND_EXISTING_FROM_IP_POOL));
+  EXPECT_EQ(0, spdy_session_pool->session_get_count(
+      SpdySessionPool::FOUND_EXISTING));
+
   // Remove the aliases and observe that we still have a session for host1.
   pool_peer.RemoveAliases(test_hosts[0].pair);
   pool_peer.RemoveAliases(test_hosts[1].pair);
@@ -1483,6 +1491,91 @@ TEST_F(SpdySessionSpdy3Test, OutOfOrderSynStreams) {
   spdy_stream2 = NULL;
 }
 
+// Streams of the same priority are written in the order in which they asked
+// to write, even when their frames are combined into one socket write.
+TEST_F(SpdySessionSpdy3Test, SamePriorityStreamsWriteInOrder) {
+  MockConnect connect_data(SYNCHRONOUS, OK);
+  scoped_ptr<SpdyFrame> req1(ConstructSpdyGet(NULL, 0, false, 1, MEDIUM));
+  scoped_ptr<SpdyFrame> req2(ConstructSpdyGet(NULL, 0, false, 3, MEDIUM));
+  scoped_ptr<SpdyFrame> req3(ConstructSpdyGet(NULL, 0, false, 5, MEDIUM));
+  MockWrite writes[] = {
+    CreateMockWrite(*req1, 0),
+    CreateMockWrite(*req2, 1),
+    CreateMockWrite(*req3, 2),
+  };
+  MockRead reads[] = {
+    MockRead(ASYNC, 0, 3)  // EOF
+  };
+
+  SpdySessionDependencies session_deps;
+  session_deps.host_resolver->set_synchronous_mode(true);
+
+  StaticSocketDataProvider data(reads, arraysize(reads),
+                                writes, arraysize(writes));
+  data.set_connect_data(connect_data);
+  session_deps.socket_factory->AddSocketDataProvider(&data);
+
+  SSLSocketDataProvider ssl(SYNCHRONOUS, OK);
+  session_deps.socket_factory->AddSSLSocketDataProvider(&ssl);
+
+  scoped_refptr<HttpNetworkSession> http_session(
+      SpdySessionDependencies::SpdyCreateSession(&session_deps));
+
+  const std::string kTestHost("www.foo.com");
+  const int kTestPort = 80;
+  HostPortPair test_host_port_pair(kTestHost, kTestPort);
+  HostPortProxyPair pair(test_host_port_pair, ProxyServer::Direct());
+
+  SpdySessionPool* spdy_session_pool(http_session->spdy_session_pool());
+  scoped_refptr<SpdySession> session =
+      spdy_session_pool->Get(pair, BoundNetLog());
+
+  scoped_refptr<TransportSocketParams> transport_params(
+      new TransportSocketParams(test_host_port_pair,
+                                MEDIUM,
+                                false,
+                                false,
+                                OnHostResolutionCallback()));
+  scoped_ptr<ClientSocketHandle> connection(new ClientSocketHandle);
+  EXPECT_EQ(OK, connection->Init(test_host_port_pair.ToString(),
+                                 transport_params, MEDIUM, CompletionCallback(),
+                                 http_session->GetTransportSocketPool(
+                                     HttpNetworkSession::NORMAL_SOCKET_POOL),
+                                 BoundNetLog()));
+  EXPECT_EQ(OK, session->InitializeWithSocket(connection.release(), false, OK));
+
+  GURL url("http://www.google.com");
+  scoped_refptr<SpdyStream> spdy_streams[3];
+  for (size_t i = 0; i < arraysize(spdy_streams); ++i) {
+    TestCompletionCallback callback;
+    EXPECT_EQ(OK, session->CreateStream(url, MEDIUM, &spdy_streams[i],
+                                        BoundNetLog(), callback.callback()));
+
+    scoped_ptr<SpdyHeaderBlock> headers(new SpdyHeaderBlock);
+    (*headers)[":method"] = "GET";
+    (*headers)[":scheme"] = url.scheme();
+    (*headers)[":host"] = url.host();
+    (*headers)[":path"] = url.path();
+    (*headers)[":version"] = "HTTP/1.1";
+    spdy_streams[i]->set_spdy_headers(headers.Pass());
+    EXPECT_TRUE(spdy_streams[i]->HasUrl());
+  }
+
+  for (size_t i = 0; i < arraysize(spdy_streams); ++i)
+    spdy_streams[i]->SendRequest(false);
+  MessageLoop::current()->RunAllPending();
+
+  EXPECT_EQ(1u, spdy_streams[0]->stream_id());
+  EXPECT_EQ(3u, spdy_streams[1]->stream_id());
+  EXPECT_EQ(5u, spdy_streams[2]->stream_id());
+  EXPECT_TRUE(data.at_write_eof());
+
+  for (size_t i = 0; i < arraysize(spdy_streams); ++i) {
+    spdy_streams[i]->Cancel();
+    spdy_streams[i] = NULL;
+  }
+}
+
 TEST_F(SpdySessionSpdy3Test, CancelStream) {
   MockConnect connect_data(SYNCHRONOUS, OK);
   // Request 1, at HIGHEST priority, will be cancelled before it writes data.
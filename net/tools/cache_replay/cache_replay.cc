@@ -0,0 +1,231 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This command-line program replays a trace of requests against a new disk
+// cache and reports the resulting hit rate, so that the eviction algorithms can
+// be compared over recorded traffic.
+//
+// Each line of the trace holds the key of a request and the size of the
+// response, separated by white space. Empty lines and lines that start with #
+// are ignored. Every request opens the entry with that key, and when it is not
+// found, a new entry is created and the response is written to it.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop.h"
+#include "base/scoped_temp_dir.h"
+#include "base/string_number_conversions.h"
+#include "base/string_split.h"
+#include "base/threading/thread.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/disk_cache/backend_impl.h"
+#include "net/disk_cache/disk_cache.h"
+
+enum Errors {
+  GENERIC = -1,
+  ALL_GOOD = 0,
+  INVALID_ARGUMENT = 1,
+  FILE_ACCESS_ERROR,
+  CACHE_ERROR
+};
+
+// The file with the requests to replay.
+const char kTrace[] = "trace";
+
+// The maximum size of the cache, in bytes.
+const char kCacheSize[] = "cache-size";
+
+// The eviction algorithm: lru, new or frequency.
+const char kEviction[] = "eviction";
+
+const int kDefaultCacheSize = 80 * 1024 * 1024;
+
+// Responses are written to the cache in chunks of this size.
+const int kWriteSize = 64 * 1024;
+
+struct Request {
+  std::string key;
+  int64 size;
+};
+
+struct ReplayStats {
+  ReplayStats() : requests(0), hits(0), bytes(0), hit_bytes(0), errors(0) {}
+
+  int requests;
+  int hits;
+  int64 bytes;
+  int64 hit_bytes;
+  int errors;
+};
+
+int Help() {
+  printf("cache_replay --trace=file [--cache-size=bytes] "
+         "[--eviction=lru|new|frequency]\n");
+  printf("Each line of the trace is a key followed by the response size.\n");
+  return INVALID_ARGUMENT;
+}
+
+bool ReadTrace(const FilePath& path, std::vector<Request>* requests) {
+  std::string contents;
+  if (!file_util::ReadFileToString(path, &contents))
+    return false;
+
+  std::vector<std::string> lines;
+  base::SplitString(contents, '\n', &lines);
+  for (size_t i = 0; i < lines.size(); i++) {
+    std::vector<std::string> tokens;
+    base::SplitStringAlongWhitespace(lines[i], &tokens);
+    if (tokens.empty() || tokens[0][0] == '#')
+      continue;
+
+    Request request;
+    request.key = tokens[0];
+    if (tokens.size() != 2 || !base::StringToInt64(tokens[1], &request.size) ||
+        request.size < 0) {
+      printf("Invalid request on line %d\n", static_cast<int>(i + 1));
+      return false;
+    }
+    requests->push_back(request);
+  }
+  return true;
+}
+
+// Stores a response of |size| bytes on |entry|.
+bool WriteResponse(disk_cache::Entry* entry, int64 size,
+                   net::IOBuffer* buffer) {
+  net::TestCompletionCallback cb;
+  for (int64 offset = 0; offset < size; offset += kWriteSize) {
+    int len = static_cast<int>(std::min(size - offset,
+                                        static_cast<int64>(kWriteSize)));
+    int rv = entry->WriteData(1, static_cast<int>(offset), buffer, len,
+                              cb.callback(), false);
+    if (cb.GetResult(rv) != len)
+      return false;
+  }
+  return true;
+}
+
+void Replay(disk_cache::Backend* cache, const std::vector<Request>& requests,
+            ReplayStats* stats) {
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kWriteSize));
+  memset(buffer->data(), 0, kWriteSize);
+
+  net::TestCompletionCallback cb;
+  for (size_t i = 0; i < requests.size(); i++) {
+    const Request& request = requests[i];
+    stats->requests++;
+    stats->bytes += request.size;
+
+    disk_cache::Entry* entry;
+    int rv = cache->OpenEntry(request.key, &entry, cb.callback());
+    if (cb.GetResult(rv) == net::OK) {
+      stats->hits++;
+      stats->hit_bytes += request.size;
+      entry->Close();
+      continue;
+    }
+
+    rv = cache->CreateEntry(request.key, &entry, cb.callback());
+    if (cb.GetResult(rv) != net::OK) {
+      stats->errors++;
+      continue;
+    }
+    if (!WriteResponse(entry, request.size, buffer)) {
+      // The response does not fit on the cache.
+      stats->errors++;
+      entry->Doom();
+    }
+    entry->Close();
+  }
+}
+
+int main(int argc, const char* argv[]) {
+  // Setup an AtExitManager so Singleton objects will be destroyed.
+  base::AtExitManager at_exit_manager;
+
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+
+  FilePath trace_path = command_line.GetSwitchValuePath(kTrace);
+  if (trace_path.empty())
+    return Help();
+
+  int cache_size = kDefaultCacheSize;
+  if (command_line.HasSwitch(kCacheSize) &&
+      !base::StringToInt(command_line.GetSwitchValueASCII(kCacheSize),
+                         &cache_size)) {
+    return Help();
+  }
+
+  std::string eviction = command_line.GetSwitchValueASCII(kEviction);
+  if (eviction.empty())
+    eviction = "new";
+  if (eviction != "lru" && eviction != "new" && eviction != "frequency")
+    return Help();
+
+  std::vector<Request> requests;
+  if (!ReadTrace(trace_path, &requests)) {
+    printf("Unable to read the trace\n");
+    return FILE_ACCESS_ERROR;
+  }
+
+  ScopedTempDir cache_dir;
+  if (!cache_dir.CreateUniqueTempDir())
+    return FILE_ACCESS_ERROR;
+
+  MessageLoopForIO message_loop;
+  base::Thread cache_thread("CacheThread");
+  if (!cache_thread.StartWithOptions(
+          base::Thread::Options(MessageLoop::TYPE_IO, 0)))
+    return GENERIC;
+
+  disk_cache::BackendImpl* cache = new disk_cache::BackendImpl(
+      cache_dir.path(), cache_thread.message_loop_proxy(), NULL);
+  if (!cache->SetMaxSize(cache_size)) {
+    delete cache;
+    return Help();
+  }
+
+  // Trim as soon as the cache is full, without random experiments.
+  cache->SetFlags(disk_cache::kNoRandom | disk_cache::kNoLoadProtection);
+  if (eviction == "new")
+    cache->SetNewEviction();
+  else if (eviction == "frequency")
+    cache->SetFrequencyEviction();
+
+  net::TestCompletionCallback cb;
+  int rv = cache->Init(cb.callback());
+  if (cb.GetResult(rv) != net::OK) {
+    printf("Unable to initialize the cache\n");
+    delete cache;
+    return CACHE_ERROR;
+  }
+
+  ReplayStats stats;
+  Replay(cache, requests, &stats);
+
+  printf("Eviction: %s, cache size: %d bytes\n", eviction.c_str(), cache_size);
+  printf("Requests: %d, hits: %d, errors: %d\n", stats.requests, stats.hits,
+         stats.errors);
+  if (stats.requests)
+    printf("Hit rate: %.2f%%\n", stats.hits * 100.0 / stats.requests);
+  if (stats.bytes)
+    printf("Byte hit rate: %.2f%%\n", stats.hit_bytes * 100.0 / stats.bytes);
+  printf("Entries at the end: %d\n", cache->GetEntryCount());
+
+  delete cache;
+  return ALL_GOOD;
+}
@@ -0,0 +1,345 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This command-line program replays a trace recorded by the InfiniteCache
+// (see net/http/infinite_cache_trace.h) against simulated caches of different
+// sizes and eviction policies, and reports the hit rate of each one, next to
+// the hit rate of a cache without size limit.
+//
+// The simulated policies follow the ones of the disk cache:
+//   lru: a single list, where entries move to the head when used.
+//   new: the lists of the new eviction, by number of uses, with evicted entries
+//        remembered for a while so that they go back to the right list.
+//   frequency: new, plus sparing entries that are used often for their size
+//        (EXPERIMENT_FREQUENCY_EVICTION).
+// A request is a hit when the entry is stored and the InfiniteCache found that
+// the stored copy could be reused.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/string_number_conversions.h"
+#include "base/string_split.h"
+#include "net/disk_cache/frequency_sketch.h"
+#include "net/http/infinite_cache_trace.h"
+
+using net::InfiniteCacheTraceRecord;
+
+namespace {
+
+enum Errors {
+  ALL_GOOD = 0,
+  INVALID_ARGUMENT = 1,
+  FILE_ACCESS_ERROR
+};
+
+// The trace to replay.
+const char kTrace[] = "trace";
+
+// Comma separated list of cache sizes, in MB.
+const char kSizes[] = "sizes";
+
+// Comma separated list of policies.
+const char kPolicies[] = "policies";
+
+const char kDefaultSizes[] = "10,20,40,80,160,320";
+const char kDefaultPolicies[] = "lru,new,frequency";
+
+// These values mirror net/disk_cache.
+const int64 kCleanUpMargin = 1024 * 1024;
+const int kHighUse = 10;
+const int kMinSpareFrequency = 2;
+const int kBytesPerUse = 64 * 1024;
+const int kMaxSparedEntries = 20;
+
+enum Policy {
+  POLICY_LRU,
+  POLICY_NEW,
+  POLICY_FREQUENCY
+};
+
+bool ParsePolicy(const std::string& name, Policy* policy) {
+  if (name == "lru")
+    *policy = POLICY_LRU;
+  else if (name == "new")
+    *policy = POLICY_NEW;
+  else if (name == "frequency")
+    *policy = POLICY_FREQUENCY;
+  else
+    return false;
+  return true;
+}
+
+struct Results {
+  Results() : requests(0), hits(0), bytes(0), hit_bytes(0) {}
+
+  int64 requests;
+  int64 hits;
+  int64 bytes;
+  int64 hit_bytes;
+};
+
+// A cache that only tracks the keys and sizes of the stored entries.
+class SimulatedCache {
+ public:
+  SimulatedCache(Policy policy, int64 max_size);
+  ~SimulatedCache() {}
+
+  // Processes one request of the trace. Returns true if it was a hit.
+  bool Access(const InfiniteCacheTraceRecord& record);
+
+ private:
+  enum {
+    kNumLists = 3  // NO_USE, LOW_USE and HIGH_USE.
+  };
+
+  struct Entry {
+    uint64 key;
+    int64 size;
+    int reuse_count;
+    int list;
+  };
+  typedef std::list<Entry> EntryList;
+  typedef std::map<uint64, EntryList::iterator> EntryMap;
+  typedef std::list<std::pair<uint64, int> > DeletedList;
+  typedef std::map<uint64, DeletedList::iterator> DeletedMap;
+
+  int GetList(int reuse_count) const;
+  void Insert(const Entry& entry);
+  void Remove(EntryMap::iterator it, bool remember);
+  void Trim();
+  int SelectList() const;
+
+  Policy policy_;
+  int64 max_size_;
+  int64 size_;
+  EntryList lists_[kNumLists];
+  EntryMap entries_;
+  // Reuse counts of the evicted entries (the DELETED list).
+  DeletedList deleted_;
+  DeletedMap deleted_entries_;
+  disk_cache::FrequencySketch sketch_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimulatedCache);
+};
+
+SimulatedCache::SimulatedCache(Policy policy, int64 max_size)
+    : policy_(policy),
+      max_size_(max_size),
+      size_(0) {
+  // Size the sketch as the index of a disk cache of this size.
+  if (policy_ == POLICY_FREQUENCY)
+    sketch_.Init(static_cast<int>(std::min(max_size / (16 * 1024),
+                                           static_cast<int64>(1 << 20))));
+}
+
+bool SimulatedCache::Access(const InfiniteCacheTraceRecord& record) {
+  uint32 hash = static_cast<uint32>(record.key_hash ^ (record.key_hash >> 32));
+  if (policy_ == POLICY_FREQUENCY)
+    sketch_.Increment(hash);
+
+  EntryMap::iterator it = entries_.find(record.key_hash);
+  if (record.flags & (net::TRACE_DOOM | net::TRACE_NO_STORE)) {
+    if (it != entries_.end())
+      Remove(it, false);
+    return false;
+  }
+
+  bool hit = false;
+  Entry entry;
+  entry.key = record.key_hash;
+  entry.size = record.size;
+  entry.reuse_count = 0;
+  if (it != entries_.end()) {
+    hit = (record.flags & net::TRACE_REUSABLE) != 0;
+    entry.reuse_count = it->second->reuse_count + 1;
+    if (!hit)
+      entry.reuse_count = 0;  // The resource was replaced.
+    Remove(it, false);
+  } else {
+    DeletedMap::iterator deleted = deleted_entries_.find(record.key_hash);
+    if (deleted != deleted_entries_.end()) {
+      entry.reuse_count = deleted->second->second + 1;
+      deleted_.erase(deleted->second);
+      deleted_entries_.erase(deleted);
+    }
+  }
+
+  // The disk cache does not store entries bigger than 1/8 of its size.
+  if (entry.size <= max_size_ / 8) {
+    Insert(entry);
+    if (size_ > max_size_)
+      Trim();
+  }
+  return hit;
+}
+
+int SimulatedCache::GetList(int reuse_count) const {
+  if (policy_ == POLICY_LRU || !reuse_count)
+    return 0;
+  return reuse_count < kHighUse ? 1 : 2;
+}
+
+void SimulatedCache::Insert(const Entry& entry) {
+  Entry stored = entry;
+  stored.list = GetList(entry.reuse_count);
+  lists_[stored.list].push_front(stored);
+  entries_[stored.key] = lists_[stored.list].begin();
+  size_ += stored.size;
+}
+
+void SimulatedCache::Remove(EntryMap::iterator it, bool remember) {
+  EntryList::iterator entry = it->second;
+  size_ -= entry->size;
+  if (remember && policy_ != POLICY_LRU) {
+    deleted_.push_front(std::make_pair(entry->key, entry->reuse_count));
+    deleted_entries_[entry->key] = deleted_.begin();
+
+    // Keep the deleted list at about a quarter of the entries.
+    size_t max_deleted = entries_.size() / 4 + 1;
+    while (deleted_.size() > max_deleted) {
+      deleted_entries_.erase(deleted_.back().first);
+      deleted_.pop_back();
+    }
+  }
+  lists_[entry->list].erase(entry);
+  entries_.erase(it);
+}
+
+void SimulatedCache::Trim() {
+  int64 target = max_size_ < kCleanUpMargin ? 0 : max_size_ - kCleanUpMargin;
+  int spared = 0;
+  while (size_ > target && !entries_.empty()) {
+    int list = SelectList();
+    while (lists_[list].empty())
+      list = (list + 1) % kNumLists;
+
+    Entry& entry = lists_[list].back();
+    if (policy_ == POLICY_FREQUENCY && spared < kMaxSparedEntries) {
+      uint32 hash = static_cast<uint32>(entry.key ^ (entry.key >> 32));
+      int frequency = sketch_.Estimate(hash);
+      if (frequency >= kMinSpareFrequency &&
+          entry.size <= static_cast<int64>(frequency) * kBytesPerUse) {
+        lists_[list].splice(lists_[list].begin(), lists_[list],
+                            --lists_[list].end());
+        spared++;
+        continue;
+      }
+    }
+    Remove(entries_.find(entry.key), true);
+  }
+}
+
+// Same as Eviction::SelectListByLength(), without the time targets.
+int SimulatedCache::SelectList() const {
+  if (policy_ == POLICY_LRU)
+    return 0;
+
+  size_t data_entries = entries_.size();
+  if (lists_[0].size() > data_entries / 3)
+    return 0;
+  return lists_[1].size() > data_entries / 3 ? 1 : 2;
+}
+
+int Help() {
+  printf("cache_simulator --trace=file [--sizes=MB,MB,...] "
+         "[--policies=lru,new,frequency]\n");
+  return INVALID_ARGUMENT;
+}
+
+void PrintResults(const std::string& name, const Results& results) {
+  printf("%-24s %6.2f%% %6.2f%%\n", name.c_str(),
+         results.requests ? results.hits * 100.0 / results.requests : 0.0,
+         results.bytes ? results.hit_bytes * 100.0 / results.bytes : 0.0);
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  // Setup an AtExitManager so Singleton objects will be destroyed.
+  base::AtExitManager at_exit_manager;
+
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+
+  FilePath trace_path = command_line.GetSwitchValuePath(kTrace);
+  if (trace_path.empty())
+    return Help();
+
+  std::string sizes_list = command_line.GetSwitchValueASCII(kSizes);
+  if (sizes_list.empty())
+    sizes_list = kDefaultSizes;
+  std::vector<std::string> tokens;
+  base::SplitString(sizes_list, ',', &tokens);
+  std::vector<int64> sizes;
+  for (size_t i = 0; i < tokens.size(); i++) {
+    int64 size;
+    if (!base::StringToInt64(tokens[i], &size) || size <= 0)
+      return Help();
+    sizes.push_back(size * 1024 * 1024);
+  }
+
+  std::string policies_list = command_line.GetSwitchValueASCII(kPolicies);
+  if (policies_list.empty())
+    policies_list = kDefaultPolicies;
+  std::vector<std::string> policy_names;
+  base::SplitString(policies_list, ',', &policy_names);
+  std::vector<Policy> policies;
+  for (size_t i = 0; i < policy_names.size(); i++) {
+    Policy policy;
+    if (!ParsePolicy(policy_names[i], &policy))
+      return Help();
+    policies.push_back(policy);
+  }
+
+  std::vector<InfiniteCacheTraceRecord> records;
+  if (!net::ReadInfiniteCacheTrace(trace_path, &records)) {
+    printf("Unable to read the trace\n");
+    return FILE_ACCESS_ERROR;
+  }
+
+  // The cache without size limit hits whenever a stored copy is reusable.
+  Results infinite;
+  for (size_t i = 0; i < records.size(); i++) {
+    infinite.requests++;
+    infinite.bytes += records[i].size;
+    if (records[i].flags & net::TRACE_REUSABLE) {
+      infinite.hits++;
+      infinite.hit_bytes += records[i].size;
+    }
+  }
+
+  printf("%d requests\n", static_cast<int>(records.size()));
+  printf("%-24s %7s %7s\n", "cache", "hits", "bytes");
+  PrintResults("infinite", infinite);
+
+  for (size_t i = 0; i < sizes.size(); i++) {
+    for (size_t j = 0; j < policies.size(); j++) {
+      SimulatedCache cache(policies[j], sizes[i]);
+      Results results;
+      for (size_t k = 0; k < records.size(); k++) {
+        results.requests++;
+        results.bytes += records[k].size;
+        if (cache.Access(records[k])) {
+          results.hits++;
+          results.hit_bytes += records[k].size;
+        }
+      }
+      std::string name = base::Int64ToString(sizes[i] / (1024 * 1024)) +
+                         "MB " + policy_names[j];
+      PrintResults(name, results);
+    }
+  }
+
+  return ALL_GOOD;
+}
@@ -0,0 +1,251 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/dump_cache/cache_copier.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/backend_impl.h"
+#include "net/tools/dump_cache/cache_dumper.h"
+
+namespace {
+
+const int kNumStreams = 3;
+
+// Data is copied in chunks of this size.
+const int kChunkSize = 64 * 1024;
+
+// Progress is reported every time this many entries are copied.
+const int kProgressInterval = 1000;
+
+}  // namespace
+
+// Copies one entry at a time, streaming its data from the source to the writer.
+class ParallelCacheCopier::EntryCopier {
+ public:
+  EntryCopier(ParallelCacheCopier* owner, CacheDumpWriter* writer)
+      : owner_(owner),
+        writer_(writer),
+        source_(NULL),
+        target_(NULL),
+        buffer_(new net::IOBuffer(kChunkSize)),
+        created_(false),
+        stream_(0),
+        offset_(0),
+        stream_size_(0),
+        bytes_(0) {
+  }
+  ~EntryCopier() {}
+
+  // Copies |source|, and closes it when done.
+  void Start(disk_cache::Entry* source);
+
+ private:
+  void DoCreateEntryComplete(int result);
+  void CopyNextChunk();
+  void DoReadComplete(int result);
+  void DoWriteComplete(int result);
+  void Finish(bool success);
+
+  ParallelCacheCopier* owner_;
+  CacheDumpWriter* writer_;
+  disk_cache::Entry* source_;
+  disk_cache::Entry* target_;
+  scoped_refptr<net::IOBuffer> buffer_;
+  bool created_;
+  int stream_;
+  int offset_;
+  int stream_size_;
+  int64 bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(EntryCopier);
+};
+
+void ParallelCacheCopier::EntryCopier::Start(disk_cache::Entry* source) {
+  source_ = source;
+  target_ = NULL;
+  created_ = false;
+  bytes_ = 0;
+  int rv = writer_->CreateEntry(
+      source_->GetKey(), &target_,
+      base::Bind(&EntryCopier::DoCreateEntryComplete, base::Unretained(this)));
+  if (rv != net::ERR_IO_PENDING)
+    DoCreateEntryComplete(rv);
+}
+
+void ParallelCacheCopier::EntryCopier::DoCreateEntryComplete(int result) {
+  if (result != net::OK) {
+    printf("Skipping entry \"%s\": %d\n", source_->GetKey().c_str(), result);
+    return Finish(false);
+  }
+
+  created_ = true;
+  stream_ = 0;
+  offset_ = 0;
+  stream_size_ = source_->GetDataSize(0);
+  CopyNextChunk();
+}
+
+void ParallelCacheCopier::EntryCopier::CopyNextChunk() {
+  while (offset_ >= stream_size_) {
+    stream_++;
+    if (stream_ >= kNumStreams)
+      return Finish(true);
+    offset_ = 0;
+    stream_size_ = source_->GetDataSize(stream_);
+  }
+
+  int read_size = std::min(kChunkSize, stream_size_ - offset_);
+  int rv = source_->ReadData(
+      stream_, offset_, buffer_, read_size,
+      base::Bind(&EntryCopier::DoReadComplete, base::Unretained(this)));
+  if (rv != net::ERR_IO_PENDING)
+    DoReadComplete(rv);
+}
+
+void ParallelCacheCopier::EntryCopier::DoReadComplete(int result) {
+  if (result <= 0) {
+    printf("Read failed, entry \"%s\" truncated!\n",
+           source_->GetKey().c_str());
+    return Finish(false);
+  }
+
+  bytes_ += result;
+  int rv = writer_->WriteEntry(
+      target_, stream_, offset_, buffer_, result,
+      base::Bind(&EntryCopier::DoWriteComplete, base::Unretained(this)));
+  offset_ += result;
+  if (rv != net::ERR_IO_PENDING)
+    DoWriteComplete(rv);
+}
+
+void ParallelCacheCopier::EntryCopier::DoWriteComplete(int result) {
+  // Writers that transform the data (like DiskDumper) may write a different
+  // number of bytes than what was read.
+  if (result <= 0)
+    return Finish(false);
+
+  CopyNextChunk();
+}
+
+void ParallelCacheCopier::EntryCopier::Finish(bool success) {
+  if (created_)
+    writer_->CloseEntry(target_, source_->GetLastUsed(),
+                        source_->GetLastModified());
+  source_->Close();
+  source_ = NULL;
+  target_ = NULL;
+
+  owner_->OnEntryCopied(success, bytes_);
+  owner_->GetNextEntry(this);
+}
+
+// ----------------------------------------------------------------------------
+
+ParallelCacheCopier::ParallelCacheCopier(disk_cache::BackendImpl* source,
+                                         CacheDumpWriter* writer,
+                                         int num_copiers)
+    : source_(source),
+      writer_(writer),
+      iterator_(NULL),
+      next_entry_(NULL),
+      enumerating_(false),
+      enumeration_done_(false),
+      idle_copiers_(0) {
+  DCHECK_GT(num_copiers, 0);
+  for (int i = 0; i < num_copiers; i++)
+    copiers_.push_back(new EntryCopier(this, writer_));
+}
+
+ParallelCacheCopier::~ParallelCacheCopier() {
+  DCHECK(!enumerating_);
+}
+
+int ParallelCacheCopier::Run(const net::CompletionCallback& callback) {
+  callback_ = callback;
+  start_time_ = base::TimeTicks::Now();
+  for (size_t i = 0; i < copiers_.size(); i++)
+    GetNextEntry(copiers_[i]);
+  return net::ERR_IO_PENDING;
+}
+
+void ParallelCacheCopier::GetNextEntry(EntryCopier* copier) {
+  if (enumeration_done_)
+    return OnCopierIdle();
+
+  waiting_copiers_.push_back(copier);
+  if (!enumerating_)
+    StartEnumeration();
+}
+
+void ParallelCacheCopier::StartEnumeration() {
+  // The oldest entries go first, so that the copy keeps the same order.
+  enumerating_ = true;
+  int rv = source_->OpenPrevEntry(
+      &iterator_, &next_entry_,
+      base::Bind(&ParallelCacheCopier::OnEnumerationComplete,
+                 base::Unretained(this)));
+  if (rv != net::ERR_IO_PENDING)
+    OnEnumerationComplete(rv);
+}
+
+void ParallelCacheCopier::OnEnumerationComplete(int result) {
+  enumerating_ = false;
+  if (result != net::OK) {
+    enumeration_done_ = true;
+    std::deque<EntryCopier*> idle_copiers;
+    idle_copiers.swap(waiting_copiers_);
+    for (size_t i = 0; i < idle_copiers.size(); i++)
+      OnCopierIdle();
+    return;
+  }
+
+  EntryCopier* copier = waiting_copiers_.front();
+  waiting_copiers_.pop_front();
+  disk_cache::Entry* entry = next_entry_;
+  next_entry_ = NULL;
+  copier->Start(entry);
+
+  // Starting the copy may have started the next enumeration already.
+  if (!waiting_copiers_.empty() && !enumerating_)
+    StartEnumeration();
+}
+
+void ParallelCacheCopier::OnEntryCopied(bool success, int64 bytes) {
+  stats_.entries++;
+  if (!success)
+    stats_.failed_entries++;
+  stats_.bytes += bytes;
+  if (stats_.entries % kProgressInterval == 0)
+    ReportProgress();
+}
+
+void ParallelCacheCopier::OnCopierIdle() {
+  idle_copiers_++;
+  if (idle_copiers_ < static_cast<int>(copiers_.size()))
+    return;
+
+  if (iterator_)
+    source_->EndEnumeration(&iterator_);
+  stats_.elapsed_time = base::TimeTicks::Now() - start_time_;
+  callback_.Run(net::OK);
+}
+
+void ParallelCacheCopier::ReportProgress() {
+  double seconds = (base::TimeTicks::Now() - start_time_).InSecondsF();
+  if (seconds <= 0)
+    return;
+
+  printf("%d entries, %.1f MB (%.1f MB/s)\r", stats_.entries,
+         stats_.bytes / (1024.0 * 1024.0),
+         stats_.bytes / (1024.0 * 1024.0) / seconds);
+  fflush(stdout);
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_DUMP_CACHE_CACHE_COPIER_H_
+#define NET_TOOLS_DUMP_CACHE_CACHE_COPIER_H_
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "base/time.h"
+#include "net/base/completion_callback.h"
+
+namespace disk_cache {
+class BackendImpl;
+class Entry;
+}
+
+class CacheDumpWriter;
+
+// Copies all the entries of a cache to a CacheDumpWriter, with several entries
+// in flight at the same time. A single enumeration of the source cache (oldest
+// entries first) hands out entries to |num_copiers| copiers, and each copier
+// streams the data of its entry in small chunks, so the memory used does not
+// depend on the size of the entries.
+class ParallelCacheCopier {
+ public:
+  struct Stats {
+    Stats() : entries(0), failed_entries(0), bytes(0) {}
+
+    int entries;
+    int failed_entries;
+    int64 bytes;
+    base::TimeDelta elapsed_time;
+  };
+
+  ParallelCacheCopier(disk_cache::BackendImpl* source, CacheDumpWriter* writer,
+                      int num_copiers);
+  ~ParallelCacheCopier();
+
+  // Starts copying entries. |callback| is invoked when all the entries are
+  // copied. Returns a net error code.
+  int Run(const net::CompletionCallback& callback);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  class EntryCopier;
+
+  // Hands the next entry of the source cache to |copier|.
+  void GetNextEntry(EntryCopier* copier);
+  void StartEnumeration();
+  void OnEnumerationComplete(int result);
+
+  // Called by a copier when an entry is done.
+  void OnEntryCopied(bool success, int64 bytes);
+  void OnCopierIdle();
+  void ReportProgress();
+
+  disk_cache::BackendImpl* source_;
+  CacheDumpWriter* writer_;
+  ScopedVector<EntryCopier> copiers_;
+  std::deque<EntryCopier*> waiting_copiers_;
+  void* iterator_;
+  disk_cache::Entry* next_entry_;
+  bool enumerating_;
+  bool enumeration_done_;
+  int idle_copiers_;
+  base::TimeTicks start_time_;
+  Stats stats_;
+  net::CompletionCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelCacheCopier);
+};
+
+#endif  // NET_TOOLS_DUMP_CACHE_CACHE_COPIER_H_
@@ -188,6 +188,9 @@ int DiskDumper::WriteEntry(disk_cache::Entry* entry, int index, int offset,
   } else if (index == 1) {  // Stream 1 is the data.
     data = buf->data();
     len = buf_len;
+  } else {
+    // Other streams are not dumped.
+    return buf_len;
   }
 #ifdef WIN32_LARGE_FILENAME_SUPPORT
   DWORD bytes;
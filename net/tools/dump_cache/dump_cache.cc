@@ -10,7 +10,9 @@
 
 #include "base/at_exit.h"
 #include "base/command_line.h"
+#include "base/file_util.h"
 #include "base/process_util.h"
+#include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/win/scoped_handle.h"
@@ -30,6 +32,8 @@ int DumpContents(const FilePath& input_path);
 int DumpHeaders(const FilePath& input_path);
 int RunSlave(const FilePath& input_path, const std::wstring& pipe_number);
 int CopyCache(const FilePath& output_path, HANDLE pipe, bool copy_to_text);
+int ParallelCopyCache(const FilePath& input_path, const FilePath& output_path,
+                      bool copy_to_text, int num_copiers);
 HANDLE CreateServer(std::wstring* pipe_number);
 
 const char kUpgradeHelp[] =
@@ -56,6 +60,13 @@ const char kDumpToFiles[] = "dump-to-files";
 // Upgrade an old version to the current one.
 const char kUpgrade[] = "upgrade";
 
+// Copy entries from this process, with the given number of entries in flight.
+// Requires input files of the current version.
+const char kParallel[] = "parallel";
+
+// Replace the input files with the upgraded ones.
+const char kInPlace[] = "in-place";
+
 // Internal use:
 const char kSlave[] = "slave";
 const char kPipe[] = "pipe";
@@ -67,9 +78,28 @@ int Help() {
   printf("--dump-contents: display all entries\n");
   printf("--upgrade: copy contents to the output path\n");
   printf("--dump-to-files: write the contents of the cache to files\n");
+  printf("--parallel=n: copy n entries at the same time (current version)\n");
+  printf("--in-place: upgrade replacing the input files (no --output)\n");
   return INVALID_ARGUMENT;
 }
 
+// Replaces the cache at |input_path| with the one at |new_path|.
+int ReplaceCache(const FilePath& input_path, const FilePath& new_path) {
+  FilePath old_path = input_path.AddExtension(FILE_PATH_LITERAL("old"));
+  if (!file_util::Move(input_path, old_path)) {
+    printf("Unable to move the input files, the new files are at %ls\n",
+           new_path.value().c_str());
+    return FILE_ACCESS_ERROR;
+  }
+  if (!file_util::Move(new_path, input_path)) {
+    printf("Unable to replace the input files, they are now at %ls\n",
+           old_path.value().c_str());
+    return FILE_ACCESS_ERROR;
+  }
+  file_util::Delete(old_path, true);
+  return ALL_GOOD;
+}
+
 // Starts a new process, to generate the files.
 int LaunchSlave(CommandLine command_line,
                 const std::wstring& pipe_number,
@@ -118,6 +148,21 @@ int main(int argc, const char* argv[]) {
   if (command_line.HasSwitch(kDumpToFiles))
     copy_to_text = true;
 
+  bool in_place = command_line.HasSwitch(kInPlace);
+  if (in_place) {
+    if (!upgrade || !output_path.empty())
+      return Help();
+    input_path = input_path.StripTrailingSeparators();
+    output_path = input_path.AddExtension(FILE_PATH_LITERAL("new"));
+  }
+
+  int num_copiers = 0;
+  if (command_line.HasSwitch(kParallel) &&
+      (!base::StringToInt(command_line.GetSwitchValueASCII(kParallel),
+                          &num_copiers) || num_copiers <= 0)) {
+    return Help();
+  }
+
   if (upgrade || copy_to_text) {
     if (output_path.empty())
       return Help();
@@ -140,6 +185,18 @@ int main(int argc, const char* argv[]) {
   if (command_line.HasSwitch(kSlave) && slave_required)
     return RunSlave(input_path, pipe_number);
 
+  if (num_copiers && (upgrade || copy_to_text)) {
+    if (version != disk_cache::kCurrentVersion >> 16) {
+      printf("--parallel requires files of the current version\n");
+      return UNKNOWN_VERSION;
+    }
+    int ret = ParallelCopyCache(input_path, output_path, copy_to_text,
+                                num_copiers);
+    if (ret || !in_place)
+      return ret;
+    return ReplaceCache(input_path, output_path);
+  }
+
   base::win::ScopedHandle server;
   if (slave_required) {
     server.Set(CreateServer(&pipe_number));
@@ -153,8 +210,14 @@ int main(int argc, const char* argv[]) {
       return ret;
   }
 
-  if (upgrade || copy_to_text)
-    return CopyCache(output_path, server, copy_to_text);
+  if (upgrade || copy_to_text) {
+    int ret = CopyCache(output_path, server, copy_to_text);
+    if (ret || !in_place)
+      return ret;
+    // Give the slave a chance to release the input files.
+    Sleep(500);
+    return ReplaceCache(input_path, output_path);
+  }
 
   if (slave_required) {
     // Wait until the slave starts dumping data before we quit. Lazy "fix" for a
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_path.h"
@@ -21,6 +23,7 @@
 #include "net/http/http_cache.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_response_info.h"
+#include "net/tools/dump_cache/cache_copier.h"
 #include "net/tools/dump_cache/cache_dumper.h"
 
 namespace {
@@ -920,3 +923,58 @@ int RunSlave(const FilePath& input_path, const std::wstring& pipe_number) {
   loop.Run();
   return 0;
 }
+
+// Copies the cache from |input_path| without a helper process, with
+// |num_copiers| entries being copied at the same time. The input files must
+// use the current version.
+int ParallelCopyCache(const FilePath& input_path, const FilePath& output_path,
+                      bool copy_to_text, int num_copiers) {
+  MessageLoop loop(MessageLoop::TYPE_IO);
+  base::Thread cache_thread("cache");
+  CHECK(cache_thread.StartWithOptions(
+            base::Thread::Options(MessageLoop::TYPE_IO, 0)));
+
+  disk_cache::Backend* cache;
+  net::TestCompletionCallback cb;
+  int rv = disk_cache::CreateCacheBackend(net::DISK_CACHE, input_path, 0, false,
+                                          cache_thread.message_loop_proxy(),
+                                          NULL, &cache, cb.callback());
+  if (cb.GetResult(rv) != net::OK) {
+    printf("Unable to open cache files\n");
+    return -1;
+  }
+  scoped_ptr<disk_cache::BackendImpl> source(
+      reinterpret_cast<disk_cache::BackendImpl*>(cache));
+  source->SetUpgradeMode();
+
+  scoped_ptr<disk_cache::Backend> target;
+  scoped_ptr<CacheDumpWriter> writer;
+  if (copy_to_text) {
+    // DiskDumper only handles one entry at a time.
+    writer.reset(new DiskDumper(output_path));
+    num_copiers = 1;
+  } else {
+    rv = disk_cache::CreateCacheBackend(net::DISK_CACHE, output_path, 0, false,
+                                        cache_thread.message_loop_proxy(),
+                                        NULL, &cache, cb.callback());
+    if (cb.GetResult(rv) != net::OK) {
+      printf("Unable to initialize new files\n");
+      return -1;
+    }
+    target.reset(cache);
+    writer.reset(new CacheDumper(target.get()));
+  }
+
+  ParallelCacheCopier copier(source.get(), writer.get(), num_copiers);
+  rv = copier.Run(cb.callback());
+  cb.GetResult(rv);
+
+  const ParallelCacheCopier::Stats& stats = copier.stats();
+  double seconds = std::max(stats.elapsed_time.InSecondsF(), 0.001);
+  double megabytes = stats.bytes / (1024.0 * 1024.0);
+  printf("\n%d entries copied (%d failed), %.1f MB in %.1f seconds\n",
+         stats.entries, stats.failed_entries, megabytes, seconds);
+  printf("%.1f MB/s, %.0f entries/s\n", megabytes / seconds,
+         stats.entries / seconds);
+  return stats.failed_entries ? -1 : 0;
+}
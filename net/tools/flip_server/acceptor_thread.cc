@@ -6,6 +6,7 @@
 
 #include <netinet/in.h>
 #include <netinet/tcp.h>  // For TCP_NODELAY
+#include <sched.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -21,14 +22,22 @@
 namespace net {
 
 SMAcceptorThread::SMAcceptorThread(FlipAcceptor *acceptor,
-                                   MemoryCache* memory_cache)
+                                   MemoryCache* memory_cache,
+                                   int listen_fd,
+                                   int cpu)
     : SimpleThread("SMAcceptorThread"),
       acceptor_(acceptor),
+      listen_fd_(listen_fd),
+      cpu_(cpu),
+      accept_pending_(false),
       ssl_state_(NULL),
       use_ssl_(false),
       idle_socket_timeout_s_(acceptor->idle_socket_timeout_s_),
+      oldest_time_(time(NULL)),
       quitting_(false),
-      memory_cache_(memory_cache) {
+      memory_cache_(memory_cache),
+      cache_reload_interval_s_(0),
+      last_cache_reload_time_(time(NULL)) {
   if (!acceptor->ssl_cert_filename_.empty() &&
       !acceptor->ssl_key_filename_.empty()) {
     ssl_state_ = new SSLState;
@@ -77,7 +86,7 @@ SMConnection* SMAcceptorThread::FindOrMakeNewSMConnection() {
 }
 
 void SMAcceptorThread::InitWorker() {
-  epoll_server_.RegisterFD(acceptor_->listen_fd_, this, EPOLLIN | EPOLLET);
+  epoll_server_.RegisterFD(listen_fd_, this, EPOLLIN | EPOLLET);
 }
 
 void SMAcceptorThread::HandleConnection(int server_fd,
@@ -112,48 +121,34 @@ void SMAcceptorThread::HandleConnection(int server_fd,
 }
 
 void SMAcceptorThread::AcceptFromListenFD() {
-  if (acceptor_->accepts_per_wake_ > 0) {
-    for (int i = 0; i < acceptor_->accepts_per_wake_; ++i) {
-      struct sockaddr address;
-      socklen_t socklen = sizeof(address);
-      int fd = accept(acceptor_->listen_fd_, &address, &socklen);
-      if (fd == -1) {
-        if (errno != 11) {
-          VLOG(1) << ACCEPTOR_CLIENT_IDENT << "Acceptor: accept fail("
-                  << acceptor_->listen_fd_ << "): " << errno << ": "
-                  << strerror(errno);
-        }
-        break;
+  // With accepts_per_wake_ set, accept at most that many connections before
+  // going back to serving the connections we have; Run() calls us again for
+  // the rest.
+  accept_pending_ = false;
+  for (int i = 0; acceptor_->accepts_per_wake_ <= 0 ||
+                  i < acceptor_->accepts_per_wake_; ++i) {
+    struct sockaddr address;
+    socklen_t socklen = sizeof(address);
+    int fd = accept(listen_fd_, &address, &socklen);
+    if (fd == -1) {
+      if (errno != EAGAIN) {
+        VLOG(1) << ACCEPTOR_CLIENT_IDENT << "Acceptor: accept fail("
+                << listen_fd_ << "): " << errno << ": "
+                << strerror(errno);
       }
-      VLOG(1) << ACCEPTOR_CLIENT_IDENT << " Accepted connection";
-      HandleConnection(fd, (struct sockaddr_in *)&address);
-    }
-  } else {
-    while (true) {
-      struct sockaddr address;
-      socklen_t socklen = sizeof(address);
-      int fd = accept(acceptor_->listen_fd_, &address, &socklen);
-      if (fd == -1) {
-        if (errno != 11) {
-          VLOG(1) << ACCEPTOR_CLIENT_IDENT << "Acceptor: accept fail("
-                  << acceptor_->listen_fd_ << "): " << errno << ": "
-                  << strerror(errno);
-        }
-        break;
-      }
-      VLOG(1) << ACCEPTOR_CLIENT_IDENT << "Accepted connection";
-      HandleConnection(fd, (struct sockaddr_in *)&address);
+      return;
     }
+    VLOG(1) << ACCEPTOR_CLIENT_IDENT << "Accepted connection";
+    HandleConnection(fd, (struct sockaddr_in *)&address);
   }
+  accept_pending_ = true;
 }
 
 void SMAcceptorThread::HandleConnectionIdleTimeout() {
-  static time_t oldest_time = time(NULL);
-
   int cur_time = time(NULL);
   // Only iterate the list if we speculate that a connection is ready to be
   // expired
-  if ((cur_time - oldest_time) < idle_socket_timeout_s_)
+  if ((cur_time - oldest_time_) < idle_socket_timeout_s_)
     return;
 
   // TODO(mbelshe): This code could be optimized, active_server_connections_
@@ -167,18 +162,42 @@ void SMAcceptorThread::HandleConnectionIdleTimeout() {
       iter = active_server_connections_.erase(iter);
       continue;
     }
-    if (conn->last_read_time_ < oldest_time)
-      oldest_time = conn->last_read_time_;
+    if (conn->last_read_time_ < oldest_time_)
+      oldest_time_ = conn->last_read_time_;
     iter++;
   }
-  if ((cur_time - oldest_time) >= idle_socket_timeout_s_)
-    oldest_time = cur_time;
+  if ((cur_time - oldest_time_) >= idle_socket_timeout_s_)
+    oldest_time_ = cur_time;
+}
+
+void SMAcceptorThread::MaybeReloadMemoryCache() {
+  if (!memory_cache_ || cache_reload_interval_s_ <= 0)
+    return;
+  time_t cur_time = time(NULL);
+  if (cur_time - last_cache_reload_time_ < cache_reload_interval_s_)
+    return;
+  last_cache_reload_time_ = cur_time;
+  memory_cache_->ReloadChangedFiles();
 }
 
 void SMAcceptorThread::Run() {
+  if (cpu_ >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu_, &cpus);
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+      LOG(ERROR) << "Unable to bind acceptor thread to cpu " << cpu_ << ": "
+                 << strerror(errno);
+    }
+  }
+
   while (!quitting_.HasBeenNotified()) {
-    epoll_server_.set_timeout_in_us(10 * 1000);  // 10 ms
+    // Don't block in epoll while connections are still waiting to be
+    // accepted.
+    epoll_server_.set_timeout_in_us(accept_pending_ ? 0 : 10 * 1000);
     epoll_server_.WaitForEventsAndExecuteCallbacks();
+    if (accept_pending_)
+      AcceptFromListenFD();
     if (tmp_unused_server_connections_.size()) {
       VLOG(2) << "have " << tmp_unused_server_connections_.size()
               << " additional unused connections.  Total = "
@@ -189,7 +208,12 @@ void SMAcceptorThread::Run() {
       tmp_unused_server_connections_.clear();
     }
     HandleConnectionIdleTimeout();
+    MaybeReloadMemoryCache();
   }
+  VLOG(1) << "epoll_wait calls: " << epoll_server_.num_epoll_waits()
+          << " events: " << epoll_server_.num_epoll_events()
+          << " max events per call: "
+          << epoll_server_.max_events_per_epoll_wait();
 }
 
 void SMAcceptorThread::OnEvent(int fd, EpollEvent* event) {
@@ -42,11 +42,20 @@ class Notification {
    base::Lock lock_;
 };
 
+// Accepts and serves connections for a FlipAcceptor on its own thread. An
+// acceptor may have several threads; each then listens on its own socket,
+// bound to the same address with SO_REUSEPORT, so that the kernel spreads
+// incoming connections across threads instead of waking them all.
 class SMAcceptorThread : public base::SimpleThread,
                          public EpollCallbackInterface,
                          public SMConnectionPoolInterface {
  public:
-  SMAcceptorThread(FlipAcceptor *acceptor, MemoryCache* memory_cache);
+  // Accepts connections on |listen_fd|. If |cpu| is not -1, the thread only
+  // runs on that CPU.
+  SMAcceptorThread(FlipAcceptor *acceptor,
+                   MemoryCache* memory_cache,
+                   int listen_fd,
+                   int cpu);
   virtual ~SMAcceptorThread();
 
   // EpollCallbackInteface interface
@@ -75,14 +84,30 @@ class SMAcceptorThread : public base::SimpleThread,
   // idle longer than the configured timeout.
   void HandleConnectionIdleTimeout();
 
+  // Reloads the changed files of the memory cache every |seconds|, or never
+  // if |seconds| is 0. The memory cache must not be used by other threads.
+  void set_cache_reload_interval_s(int seconds) {
+    cache_reload_interval_s_ = seconds;
+  }
+
+  // Reloads the memory cache if the reload interval has passed.
+  void MaybeReloadMemoryCache();
+
   virtual void Run() OVERRIDE;
 
  private:
   EpollServer epoll_server_;
   FlipAcceptor* acceptor_;
+  int listen_fd_;
+  int cpu_;
+  // True if the last call to AcceptFromListenFD() stopped after
+  // |accepts_per_wake_| connections, so more may be waiting. The listen
+  // socket is edge triggered and will not signal them again.
+  bool accept_pending_;
   SSLState* ssl_state_;
   bool use_ssl_;
   int idle_socket_timeout_s_;
+  time_t oldest_time_;
 
   std::vector<SMConnection*> unused_server_connections_;
   std::vector<SMConnection*> tmp_unused_server_connections_;
@@ -90,6 +115,8 @@ class SMAcceptorThread : public base::SimpleThread,
   std::list<SMConnection*> active_server_connections_;
   Notification quitting_;
   MemoryCache* memory_cache_;
+  int cache_reload_interval_s_;
+  time_t last_cache_reload_time_;
 };
 
 }  // namespace net
@@ -1020,9 +1020,9 @@ size_t BalsaFrame::ProcessHeaders(const char* message_start,
           // Take the first bit of each byte, and put that into the first
           //   16 bits of a mask
           // If the mask is zero, no '\n' found. increment by 16 and try again
-          // Else scan forward to find the first set bit.
-          // Increment current by the index of the first set bit
-          //   (ffs returns index of first set bit + 1)
+          // Else handle every set bit of the mask in turn, lowest first
+          //   (ffs returns index of first set bit + 1), so that the 16 bytes
+          //   are loaded once however many lines end in them.
           __m128i msg_bytes =
             _mm_loadu_si128(const_cast<__m128i *>(
                     reinterpret_cast<const __m128i *>(message_current)));
@@ -1033,43 +1033,46 @@ size_t BalsaFrame::ProcessHeaders(const char* message_start,
             message_current += 16;
             continue;
           }
-          message_current += (ffs(newline_msk) - 1);
-          const size_t relative_idx = message_current - message_start;
-          const size_t message_current_idx = 1 + base_idx + relative_idx;
-          lines_.push_back(std::make_pair(last_slash_n_idx_,
-                                          message_current_idx));
-          if (lines_.size() == 1) {
-            headers_->WriteFromFramer(checkpoint,
-                                      1 + message_current - checkpoint);
-            checkpoint = message_current + 1;
-            const char* begin = headers_->OriginalHeaderStreamBegin();
+          const char* const block_start = message_current;
+          do {
+            message_current = block_start + (ffs(newline_msk) - 1);
+            newline_msk &= newline_msk - 1;
+            const size_t relative_idx = message_current - message_start;
+            const size_t message_current_idx = 1 + base_idx + relative_idx;
+            lines_.push_back(std::make_pair(last_slash_n_idx_,
+                                            message_current_idx));
+            if (lines_.size() == 1) {
+              headers_->WriteFromFramer(checkpoint,
+                                        1 + message_current - checkpoint);
+              checkpoint = message_current + 1;
+              const char* begin = headers_->OriginalHeaderStreamBegin();
 #if DEBUGFRAMER
-          LOG(INFO) << "First line " << std::string(begin, lines_[0].second);
-          LOG(INFO) << "is_request_: " << is_request_;
+            LOG(INFO) << "First line " << std::string(begin, lines_[0].second);
+            LOG(INFO) << "is_request_: " << is_request_;
 #endif
-            ProcessFirstLine(begin, begin + lines_[0].second);
-            if (parse_state_ == BalsaFrameEnums::MESSAGE_FULLY_READ)
+              ProcessFirstLine(begin, begin + lines_[0].second);
+              if (parse_state_ == BalsaFrameEnums::MESSAGE_FULLY_READ)
+                goto process_lines;
+              else if (parse_state_ == BalsaFrameEnums::PARSE_ERROR)
+                goto bottom;
+            }
+            const size_t chars_since_last_slash_n = (message_current_idx -
+                                                     last_slash_n_idx_);
+            last_slash_n_idx_ = message_current_idx;
+            if (chars_since_last_slash_n > 2) {
+              // We have a slash-n, but the last slash n was
+              // more than 2 characters away from this. Thus, we know
+              // that this cannot be an end-of-header.
+              continue;
+            }
+            if ((chars_since_last_slash_n == 1) ||
+                (((message_current > message_start) &&
+                  (*(message_current - 1) == '\r')) ||
+                 (last_char_was_slash_r_))) {
               goto process_lines;
-            else if (parse_state_ == BalsaFrameEnums::PARSE_ERROR)
-              goto bottom;
-          }
-          const size_t chars_since_last_slash_n = (message_current_idx -
-                                                   last_slash_n_idx_);
-          last_slash_n_idx_ = message_current_idx;
-          if (chars_since_last_slash_n > 2) {
-            // We have a slash-n, but the last slash n was
-            // more than 2 characters away from this. Thus, we know
-            // that this cannot be an end-of-header.
-            ++message_current;
-            continue;
-          }
-          if ((chars_since_last_slash_n == 1) ||
-              (((message_current > message_start) &&
-                (*(message_current - 1) == '\r')) ||
-               (last_char_was_slash_r_))) {
-            goto process_lines;
-          }
-          ++message_current;
+            }
+          } while (newline_msk != 0);
+          message_current = block_start + 16;
         }
       }
 #endif  // __SSE2__
@@ -1293,8 +1296,16 @@ size_t BalsaFrame::ProcessInput(const char* input, size_t size) {
         last_error_ = BalsaFrameEnums::HEADERS_TOO_LONG;
         visitor_->HandleHeaderError(this);
       }
+      goto bottom;
     }
-    goto bottom;
+    // When the body arrived in the same read as the headers, which is the
+    // common case for small messages, carry on framing it here instead of
+    // making the caller call back with the rest of the input.
+    if (parse_state_ == BalsaFrameEnums::MESSAGE_FULLY_READ ||
+        parse_state_ == BalsaFrameEnums::PARSE_ERROR) {
+      goto bottom;
+    }
+    on_entry = current;
   } else if (parse_state_ == BalsaFrameEnums::MESSAGE_FULLY_READ ||
              parse_state_ == BalsaFrameEnums::PARSE_ERROR) {
     // Can do nothing more 'till we're reset.
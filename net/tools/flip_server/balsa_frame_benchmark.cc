@@ -0,0 +1,156 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A microbenchmark for BalsaFrame. Frames a corpus of recorded HTTP messages
+// over and over and reports messages and megabytes framed per second.
+//
+// A corpus file holds complete messages back to back, as captured off the
+// wire, e.g.
+//   balsa_frame_benchmark --corpus=requests.txt --iterations=10000
+//   balsa_frame_benchmark --corpus=responses.txt --responses
+// Without --corpus a small built-in set of browser requests is used.
+// --read-size splits the input into reads of that many bytes, to measure
+// messages whose headers arrive in more than one read.
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+#include "net/tools/flip_server/balsa_frame.h"
+#include "net/tools/flip_server/balsa_headers.h"
+
+namespace {
+
+const char kDefaultCorpus[] =
+    "GET / HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/536.11 "
+    "(KHTML, like Gecko) Chrome/20.0.1132.57 Safari/536.11\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,"
+    "*/*;q=0.8\r\n"
+    "Accept-Encoding: gzip,deflate,sdch\r\n"
+    "Accept-Language: en-US,en;q=0.8\r\n"
+    "Accept-Charset: ISO-8859-1,utf-8;q=0.7,*;q=0.3\r\n"
+    "Cookie: PREF=ID=0123456789abcdef:U=0123456789abcdef:FF=0:TM=1340000000:"
+    "LM=1340000000:S=abcdefghijklmnop; NID=60=abcdefghijklmnopqrstuvwxyz\r\n"
+    "\r\n"
+    "GET /images/logo.png HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/536.11 "
+    "(KHTML, like Gecko) Chrome/20.0.1132.57 Safari/536.11\r\n"
+    "Accept: */*\r\n"
+    "Referer: http://www.example.com/\r\n"
+    "Accept-Encoding: gzip,deflate,sdch\r\n"
+    "Accept-Language: en-US,en;q=0.8\r\n"
+    "If-Modified-Since: Mon, 02 Jul 2012 17:00:00 GMT\r\n"
+    "\r\n"
+    "POST /submit HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Content-Type: application/x-www-form-urlencoded\r\n"
+    "Content-Length: 27\r\n"
+    "\r\n"
+    "q=balsa&hl=en&btnG=Search+!"
+    "GET /favicon.ico HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "\r\n";
+
+// Frames every message in |corpus|, passing it to the framer |read_size|
+// bytes at a time (all at once if 0). Returns the number of messages framed,
+// or -1 if the corpus does not frame cleanly.
+int FrameCorpus(const std::string& corpus, bool is_request, size_t read_size) {
+  net::BalsaHeaders headers;
+  net::BalsaFrame framer;
+  framer.set_balsa_headers(&headers);
+  framer.set_is_request(is_request);
+
+  int messages = 0;
+  const char* current = corpus.data();
+  const char* const end = current + corpus.size();
+  while (current < end) {
+    size_t size = end - current;
+    if (read_size)
+      size = std::min(size, read_size);
+    size_t consumed = framer.ProcessInput(current, size);
+    if (framer.Error() || (consumed == 0 && !framer.MessageFullyRead()))
+      return -1;
+    current += consumed;
+    if (framer.MessageFullyRead()) {
+      ++messages;
+      framer.Reset();
+    }
+  }
+  return messages;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CommandLine::Init(argc, argv);
+  const CommandLine& cl = *CommandLine::ForCurrentProcess();
+
+  if (cl.HasSwitch("help")) {
+    std::cout << argv[0] << " <options>\n"
+              << "\t--corpus=<file of recorded messages>\n"
+              << "\t--responses (the corpus holds responses)\n"
+              << "\t--read-size=<bytes per read> (default is the whole "
+              << "corpus)\n"
+              << "\t--iterations=<passes over the corpus> (default is "
+              << "10000)\n";
+    return 1;
+  }
+
+  std::string corpus(kDefaultCorpus);
+  if (cl.HasSwitch("corpus")) {
+    FilePath path = cl.GetSwitchValuePath("corpus");
+    if (!file_util::ReadFileToString(path, &corpus) || corpus.empty()) {
+      LOG(ERROR) << "Unable to read " << path.value();
+      return 1;
+    }
+  }
+  bool is_request = !cl.HasSwitch("responses");
+  int read_size = 0;
+  if (cl.HasSwitch("read-size"))
+    base::StringToInt(cl.GetSwitchValueASCII("read-size"), &read_size);
+  int iterations = 10000;
+  if (cl.HasSwitch("iterations"))
+    base::StringToInt(cl.GetSwitchValueASCII("iterations"), &iterations);
+  if (read_size < 0 || iterations <= 0) {
+    LOG(ERROR) << "--read-size must not be negative and --iterations must "
+               << "be positive";
+    return 1;
+  }
+
+  int messages_per_pass = FrameCorpus(corpus, is_request, read_size);
+  if (messages_per_pass <= 0) {
+    LOG(ERROR) << "The corpus does not frame as complete "
+               << (is_request ? "requests" : "responses");
+    return 1;
+  }
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < iterations; ++i)
+    FrameCorpus(corpus, is_request, read_size);
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  double seconds = elapsed.InSecondsF();
+  std::cout << "messages=" << messages_per_pass
+            << " bytes=" << corpus.size()
+            << " read_size=" << read_size
+            << " iterations=" << iterations
+            << " messages_per_second="
+            << messages_per_pass * static_cast<double>(iterations) / seconds
+            << " mb_per_second="
+            << corpus.size() * static_cast<double>(iterations) / seconds /
+                   (1024 * 1024)
+            << "\n";
+  return 0;
+}
@@ -75,14 +75,38 @@ class ReadPipeCallback : public EpollCallbackInterface {
   void OnUnregistration(int, bool) {}    // COV_NF_LINE
 };
 
+struct EpollServer::AlarmEntry {
+  AlarmEntry(int64 time_in_us, AlarmCB* cb)
+      : time_in_us(time_in_us),
+        tick(time_in_us / kMinimumEffectiveAlarmQuantum),
+        cb(cb),
+        level(-1) {
+  }
+
+  int64 time_in_us;
+  // The tick time_in_us falls in.
+  int64 tick;
+  AlarmCB* cb;
+  // The level of the wheel the alarm is in, or -1 if it is in |due_alarms_|.
+  int level;
+  LIST_ENTRY(AlarmEntry) entry;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 EpollServer::EpollServer()
   : epoll_fd_(epoll_create(1024)),
+    alarm_wheel_tick_(0),
     timeout_in_us_(0),
     recorded_now_in_us_(0),
+    alarm_round_tick_(-1),
     ready_list_size_(0),
+    events_(kMinEpollEvents),
+    num_epoll_waits_(0),
+    num_epoll_events_(0),
+    max_events_per_epoll_wait_(0),
+    last_epoll_wait_nfds_(0),
     wake_cb_(new ReadPipeCallback),
     read_fd_(-1),
     write_fd_(-1),
@@ -92,6 +116,12 @@ EpollServer::EpollServer()
   CHECK_NE(epoll_fd_, -1);
   LIST_INIT(&ready_list_);
   LIST_INIT(&tmp_list_);
+  for (int level = 0; level < kAlarmWheelLevels; ++level) {
+    for (int slot = 0; slot < kAlarmWheelSlots; ++slot)
+      LIST_INIT(&alarm_wheel_[level][slot]);
+    alarm_wheel_sizes_[level] = 0;
+  }
+  LIST_INIT(&due_alarms_);
 
   int pipe_fds[2];
   if (pipe(pipe_fds) < 0) {
@@ -125,21 +155,26 @@ void EpollServer::CleanupFDToCBMap() {
   }
 }
 
-void EpollServer::CleanupTimeToAlarmCBMap() {
-  TimeToAlarmCBMap::iterator erase_it;
-
-  // Call OnShutdown() on alarms. Note that the structure of the loop
-  // is similar to the structure of loop in the function HandleAlarms()
-  for (TimeToAlarmCBMap::iterator i = alarm_map_.begin();
-       i != alarm_map_.end();
-      ) {
-    // Note that OnShutdown() can call UnregisterAlarm() on
-    // other iterators. OnShutdown() should not call UnregisterAlarm()
-    // on self because by definition the iterator is not valid any more.
-    i->second->OnShutdown(this);
-    erase_it = i;
-    ++i;
-    alarm_map_.erase(erase_it);
+void EpollServer::CleanupAlarmWheel() {
+  // Call OnShutdown() on alarms. Note that OnShutdown() can call
+  // UnregisterAlarm() on other tokens, so each list is emptied from the
+  // front. OnShutdown() should not call UnregisterAlarm() on self because by
+  // definition the token is not valid any more.
+  for (int level = 0; level < kAlarmWheelLevels; ++level) {
+    for (int slot = 0; slot < kAlarmWheelSlots; ++slot) {
+      while (AlarmEntry* alarm = alarm_wheel_[level][slot].lh_first) {
+        RemoveAlarm(alarm);
+        AlarmCB* cb = alarm->cb;
+        delete alarm;
+        cb->OnShutdown(this);
+      }
+    }
+  }
+  while (AlarmEntry* alarm = due_alarms_.lh_first) {
+    RemoveAlarm(alarm);
+    AlarmCB* cb = alarm->cb;
+    delete alarm;
+    cb->OnShutdown(this);
   }
 }
 
@@ -155,7 +190,7 @@ EpollServer::~EpollServer() {
   LIST_INIT(&ready_list_);
   LIST_INIT(&tmp_list_);
 
-  CleanupTimeToAlarmCBMap();
+  CleanupAlarmWheel();
 
   close(read_fd_);
   close(write_fd_);
@@ -363,12 +398,14 @@ void EpollServer::WaitForEventsAndExecuteCallbacks() {
     return;  // COV_NF_LINE
   }
   TrueFalseGuard recursion_guard(&in_wait_for_events_and_execute_callbacks_);
-  if (alarm_map_.empty()) {
+  const int64 next_alarm_tick = NextAlarmTick();
+  if (next_alarm_tick == kint64max) {
     // no alarms, this is business as usual.
     WaitForEventsAndCallHandleEvents(timeout_in_us_,
-                                     events_,
-                                     events_size_);
+                                     &events_[0],
+                                     events_.size());
     recorded_now_in_us_ = 0;
+    GrowEventsIfFull();
     return;
   }
 
@@ -379,9 +416,9 @@ void EpollServer::WaitForEventsAndExecuteCallbacks() {
   // a more reasonable amount of work is done here.
   int64 now_in_us  = NowInUsec();
 
-  // Get the first timeout from the alarm_map where it is
-  // stored in absolute time.
-  int64 next_alarm_time_in_us =  alarm_map_.begin()->first;
+  // Get the first tick at which an alarm may be due from the alarm wheel.
+  int64 next_alarm_time_in_us =
+      next_alarm_tick * kMinimumEffectiveAlarmQuantum;
   VLOG(4) << "next_alarm_time = " << next_alarm_time_in_us
           << " now             = " << now_in_us
           << " timeout_in_us = " << timeout_in_us_;
@@ -403,10 +440,20 @@ void EpollServer::WaitForEventsAndExecuteCallbacks() {
   // wait for events.
 
   WaitForEventsAndCallHandleEvents(wait_time_in_us,
-                                   events_,
-                                   events_size_);
+                                   &events_[0],
+                                   events_.size());
   CallAndReregisterAlarmEvents();
   recorded_now_in_us_ = 0;
+  GrowEventsIfFull();
+}
+
+void EpollServer::GrowEventsIfFull() {
+  // If the last epoll_wait filled the buffer, more events were probably
+  // waiting; take more of them per call from now on.
+  if (events_.size() < kMaxEpollEvents &&
+      last_epoll_wait_nfds_ == static_cast<int>(events_.size())) {
+    events_.resize(events_.size() * 2);
+  }
 }
 
 void EpollServer::SetFDReady(int fd, int events_to_fake) {
@@ -463,19 +510,31 @@ void EpollServer::RegisterAlarm(int64 timeout_time_in_us, AlarmCB* ac) {
   }
   VLOG(4) << "RegisteringAlarm at : " << timeout_time_in_us;
 
-  TimeToAlarmCBMap::iterator alarm_iter =
-      alarm_map_.insert(std::make_pair(timeout_time_in_us, ac));
+  AlarmEntry* alarm = new AlarmEntry(timeout_time_in_us, ac);
+  if (alarm_round_tick_ >= 0 && alarm->tick <= alarm_round_tick_) {
+    LIST_INSERT_HEAD(&due_alarms_, alarm, entry);
+  } else {
+    if (alarm_round_tick_ < 0 && NextAlarmTick() == kint64max) {
+      // The wheel is empty, so it can start from the current time instead
+      // of stepping through the ticks since the last alarm.
+      alarm_wheel_tick_ = std::max(
+          alarm_wheel_tick_,
+          ApproximateNowInUsec() / kMinimumEffectiveAlarmQuantum);
+    }
+    InsertAlarm(alarm);
+  }
 
   all_alarms_.insert(ac);
-  // Pass the iterator to the EpollAlarmCallbackInterface.
-  ac->OnRegistration(alarm_iter, this);
+  // Pass the token to the EpollAlarmCallbackInterface.
+  ac->OnRegistration(alarm, this);
 }
 
 // Unregister a specific alarm callback: iterator_token must be a
-//  valid iterator. The caller must ensure the validity of the iterator.
+//  valid token. The caller must ensure the validity of the token.
 void EpollServer::UnregisterAlarm(const AlarmRegToken& iterator_token) {
-  AlarmCB* cb = iterator_token->second;
-  alarm_map_.erase(iterator_token);
+  AlarmCB* cb = iterator_token->cb;
+  RemoveAlarm(iterator_token);
+  delete iterator_token;
   all_alarms_.erase(cb);
   cb->OnUnregistration();
 }
@@ -526,15 +585,20 @@ void EpollServer::LogStateOnCrash() {
   LOG(ERROR) << "timeout_in_us_: " << timeout_in_us_;
 
   // Log sessions with alarms.
-  LOG(ERROR) << alarm_map_.size() << " alarms registered.";
-  for (TimeToAlarmCBMap::iterator it = alarm_map_.begin();
-       it != alarm_map_.end();
-       ++it) {
-    const bool skipped =
-        alarms_reregistered_and_should_be_skipped_.find(it->second)
-        != alarms_reregistered_and_should_be_skipped_.end();
-    LOG(ERROR) << "Alarm " << it->second << " registered at time " << it->first
-               << " and should be skipped = " << skipped;
+  LOG(ERROR) << all_alarms_.size() << " alarms registered.";
+  for (int level = 0; level < kAlarmWheelLevels; ++level) {
+    for (int slot = 0; slot < kAlarmWheelSlots; ++slot) {
+      for (AlarmEntry* alarm = alarm_wheel_[level][slot].lh_first; alarm;
+           alarm = alarm->entry.le_next) {
+        LOG(ERROR) << "Alarm " << alarm->cb << " registered at time "
+                   << alarm->time_in_us << " in level " << level;
+      }
+    }
+  }
+  for (AlarmEntry* alarm = due_alarms_.lh_first; alarm;
+       alarm = alarm->entry.le_next) {
+    LOG(ERROR) << "Alarm " << alarm->cb << " registered at time "
+               << alarm->time_in_us << " and already due";
   }
 
   LOG(ERROR) << cb_map_.size() << " fd callbacks registered.";
@@ -666,7 +730,11 @@ void EpollServer::WaitForEventsAndCallHandleEvents(int64 timeout_in_us,
   // done epoll_wait, which guarantees that the maximum error is the amount of
   // time it takes to process all the events generated by epoll_wait.
   recorded_now_in_us_ = NowInUsec();
+  ++num_epoll_waits_;
+  last_epoll_wait_nfds_ = nfds;
   if (nfds > 0) {
+    num_epoll_events_ += nfds;
+    max_events_per_epoll_wait_ = std::max(max_events_per_epoll_wait_, nfds);
     for (int i = 0; i < nfds; ++i) {
       int event_mask = events[i].events;
       int fd = events[i].data.fd;
@@ -746,48 +814,112 @@ void EpollServer::CallAndReregisterAlarmEvents() {
   DCHECK_NE(0, recorded_now_in_us_);
   now_in_us = DoRoundingOnNow(now_in_us);
 
-  TimeToAlarmCBMap::iterator erase_it;
+  // Alarms at or before this tick are due.
+  const int64 last_tick = now_in_us / kMinimumEffectiveAlarmQuantum;
+  alarm_round_tick_ = last_tick;
 
   // execute alarms.
-  for (TimeToAlarmCBMap::iterator i = alarm_map_.begin();
-       i != alarm_map_.end();
-      ) {
-    if (i->first > now_in_us) {
-      break;
+  for (int64 tick = NextAlarmTick(); tick <= last_tick;
+       tick = NextAlarmTick()) {
+    alarm_wheel_tick_ = tick;
+    CascadeAlarms(tick);
+    AlarmList* slot = &alarm_wheel_[0][tick & (kAlarmWheelSlots - 1)];
+    while (AlarmEntry* alarm = slot->lh_first) {
+      DCHECK_LE(alarm->tick, tick);
+      RemoveAlarm(alarm);
+      AlarmCB* cb = alarm->cb;
+      delete alarm;
+      all_alarms_.erase(cb);
+      const int64 new_timeout_time_in_us = cb->OnAlarm();
+      if (new_timeout_time_in_us > 0) {
+        DVLOG(3) << "Reregistering alarm "
+                 << " " << cb
+                 << " " << new_timeout_time_in_us
+                 << " " << now_in_us;
+        RegisterAlarm(new_timeout_time_in_us, cb);
+      }
     }
-    AlarmCB* cb = i->second;
-    // Execute the OnAlarm() only if we did not register
-    // it in this loop itself.
-    const bool added_in_this_round =
-        alarms_reregistered_and_should_be_skipped_.find(cb)
-        != alarms_reregistered_and_should_be_skipped_.end();
-    if (added_in_this_round) {
-      ++i;
+    alarm_wheel_tick_ = tick + 1;
+  }
+  alarm_wheel_tick_ = std::max(alarm_wheel_tick_, last_tick + 1);
+  alarm_round_tick_ = -1;
+
+  // Alarms that became due while alarms were being called are called next
+  // time, at the first tick.
+  while (AlarmEntry* alarm = due_alarms_.lh_first) {
+    RemoveAlarm(alarm);
+    InsertAlarm(alarm);
+  }
+}
+
+void EpollServer::InsertAlarm(AlarmEntry* alarm) {
+  const int64 max_delta =
+      static_cast<int64>(1) << (kAlarmWheelBits * kAlarmWheelLevels);
+  int64 tick = std::max(alarm->tick, alarm_wheel_tick_);
+  // Alarms too far in the future to fit in the wheel are put in the last
+  // slot of the top level, and put back when that slot comes.
+  tick = std::min(tick, alarm_wheel_tick_ + max_delta - 1);
+  const int64 delta = tick - alarm_wheel_tick_;
+  int level = 0;
+  while (delta >> (kAlarmWheelBits * (level + 1)))
+    ++level;
+  DCHECK(level < kAlarmWheelLevels);
+  const int slot = (tick >> (kAlarmWheelBits * level)) & (kAlarmWheelSlots - 1);
+  LIST_INSERT_HEAD(&alarm_wheel_[level][slot], alarm, entry);
+  alarm->level = level;
+  ++alarm_wheel_sizes_[level];
+}
+
+void EpollServer::RemoveAlarm(AlarmEntry* alarm) {
+  LIST_REMOVE(alarm, entry);
+  if (alarm->level >= 0)
+    --alarm_wheel_sizes_[alarm->level];
+  alarm->level = -1;
+}
+
+void EpollServer::CascadeAlarms(int64 tick) {
+  for (int level = kAlarmWheelLevels - 1; level > 0; --level) {
+    const int shift = kAlarmWheelBits * level;
+    if (tick & ((static_cast<int64>(1) << shift) - 1))
       continue;
+    AlarmList* slot = &alarm_wheel_[level][(tick >> shift) &
+                                           (kAlarmWheelSlots - 1)];
+    while (AlarmEntry* alarm = slot->lh_first) {
+      RemoveAlarm(alarm);
+      InsertAlarm(alarm);
+    }
+  }
+}
+
+int64 EpollServer::NextAlarmTick() const {
+  int64 next_tick = kint64max;
+  if (alarm_wheel_sizes_[0]) {
+    // Level 0 holds the alarms of the next kAlarmWheelSlots ticks.
+    for (int i = 0; i < kAlarmWheelSlots; ++i) {
+      const int64 tick = alarm_wheel_tick_ + i;
+      if (alarm_wheel_[0][tick & (kAlarmWheelSlots - 1)].lh_first) {
+        next_tick = tick;
+        break;
+      }
     }
-    all_alarms_.erase(cb);
-    const int64 new_timeout_time_in_us = cb->OnAlarm();
-
-    erase_it = i;
-    ++i;
-    alarm_map_.erase(erase_it);
-
-    if (new_timeout_time_in_us > 0) {
-      // We add to hash_set only if the new timeout is <= now_in_us.
-      // if timeout is > now_in_us then we have no fear that this alarm
-      // can be reexecuted in this loop, and hence we do not need to
-      // worry about a recursive loop.
-      DVLOG(3) << "Reregistering alarm "
-               << " " << cb
-               << " " << new_timeout_time_in_us
-               << " " << now_in_us;
-      if (new_timeout_time_in_us <= now_in_us) {
-        alarms_reregistered_and_should_be_skipped_.insert(cb);
+  }
+  for (int level = 1; level < kAlarmWheelLevels; ++level) {
+    if (!alarm_wheel_sizes_[level])
+      continue;
+    // The alarms of a slot are due no earlier than the first tick it covers.
+    // If that tick is the current one, the slot has not been cascaded yet.
+    const int shift = kAlarmWheelBits * level;
+    const int64 block = alarm_wheel_tick_ >> shift;
+    const bool at_block_start =
+        (alarm_wheel_tick_ & ((static_cast<int64>(1) << shift) - 1)) == 0;
+    for (int i = at_block_start ? 0 : 1; i <= kAlarmWheelSlots; ++i) {
+      if (alarm_wheel_[level][(block + i) & (kAlarmWheelSlots - 1)].lh_first) {
+        next_tick = std::min(next_tick, (block + i) << shift);
+        break;
       }
-      RegisterAlarm(new_timeout_time_in_us, cb);
     }
   }
-  alarms_reregistered_and_should_be_skipped_.clear();
+  return next_tick;
 }
 
 EpollAlarm::EpollAlarm() : eps_(NULL), registered_(false) {
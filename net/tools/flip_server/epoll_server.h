@@ -123,8 +123,9 @@ class EpollServer {
   typedef EpollAlarmCallbackInterface AlarmCB;
   typedef EpollCallbackInterface CB;
 
-  typedef std::multimap<int64, AlarmCB*> TimeToAlarmCBMap;
-  typedef TimeToAlarmCBMap::iterator AlarmRegToken;
+  // An alarm's place in the alarm timer wheel.
+  struct AlarmEntry;
+  typedef AlarmEntry* AlarmRegToken;
 
   // Summary:
   //   Constructor:
@@ -480,6 +481,14 @@ class EpollServer {
     return all_alarms_.find(alarm) != all_alarms_.end();
   }
 
+  // Summary:
+  //   Counters of the calls to epoll_wait, to see how well events are
+  //   batched: the number of calls, the number of events they returned in
+  //   total, and the most events returned by a single call.
+  int64 num_epoll_waits() const { return num_epoll_waits_; }
+  int64 num_epoll_events() const { return num_epoll_events_; }
+  int max_events_per_epoll_wait() const { return max_events_per_epoll_wait_; }
+
   // Summary:
   //   A function for implementing the ready list. It invokes OnEvent for each
   //   of the fd in the ready list, and takes care of adding them back to the
@@ -661,6 +670,35 @@ class EpollServer {
   // were recurring.
   virtual void CallAndReregisterAlarmEvents();
 
+  // Alarms are kept in a hierarchical timer wheel, so that registering and
+  // unregistering an alarm takes constant time however many alarms there
+  // are. Level 0 has a slot per kMinimumEffectiveAlarmQuantum tick; each
+  // slot of level n covers kAlarmWheelSlots^n ticks, and its alarms move
+  // down to the lower levels when the first of those ticks comes.
+  static const int kAlarmWheelBits = 8;
+  static const int kAlarmWheelSlots = 1 << kAlarmWheelBits;
+  static const int kAlarmWheelLevels = 4;
+
+  LIST_HEAD(AlarmList, AlarmEntry);
+
+  // Adds |alarm| to the slot for its tick.
+  void InsertAlarm(AlarmEntry* alarm);
+
+  // Takes |alarm| off its list.
+  void RemoveAlarm(AlarmEntry* alarm);
+
+  // Moves the alarms of the higher level slots that start at |tick| down.
+  void CascadeAlarms(int64 tick);
+
+  // Returns the first tick at which an alarm may be due, or kint64max if
+  // there are no alarms. Since alarms above level 0 are only known to the
+  // slot, this may be earlier than the first alarm.
+  int64 NextAlarmTick() const;
+
+  // Doubles |events_|, up to kMaxEpollEvents, if the last epoll_wait filled
+  // it.
+  void GrowEventsIfFull();
+
   // The file-descriptor created for epolling
   int epoll_fd_;
 
@@ -682,7 +720,11 @@ class EpollServer {
   typedef __gnu_cxx::hash_set<AlarmCB*, AlarmCBHash> AlarmCBMap;
   AlarmCBMap all_alarms_;
 
-  TimeToAlarmCBMap alarm_map_;
+  AlarmList alarm_wheel_[kAlarmWheelLevels][kAlarmWheelSlots];
+  // The number of alarms in each level of |alarm_wheel_|.
+  int alarm_wheel_sizes_[kAlarmWheelLevels];
+  // The first tick whose alarms have not been called.
+  int64 alarm_wheel_tick_;
 
   // The amount of time in microseconds that we'll wait before returning
   // from the WaitForEventsAndExecuteCallbacks() function.
@@ -698,21 +740,28 @@ class EpollServer {
   // ApproximateNowInUs() function. See that function for more details.
   int64 recorded_now_in_us_;
 
-  // This is used to implement CallAndReregisterAlarmEvents. This stores
-  // all alarms that were reregistered because OnAlarm() returned a
-  // value > 0 and the time at which they should be executed is less that
-  // the current time.  By storing such alarms in this map we ensure
-  // that while calling CallAndReregisterAlarmEvents we do not call
-  // OnAlarm on any alarm in this set. This ensures that we do not
-  // go in an infinite loop.
-  AlarmCBMap alarms_reregistered_and_should_be_skipped_;
+  // This is used to implement CallAndReregisterAlarmEvents. While alarms
+  // are being called, this is the last tick being called and alarms that
+  // are registered for it or an earlier tick, e.g. because OnAlarm()
+  // returned a time that has already passed, go to |due_alarms_| instead of
+  // the wheel. They are called by the next CallAndReregisterAlarmEvents, so
+  // that we do not go in an infinite loop. It is -1 at other times.
+  int64 alarm_round_tick_;
+  AlarmList due_alarms_;
 
   LIST_HEAD(ReadyList, CBAndEventMask) ready_list_;
   LIST_HEAD(TmpList, CBAndEventMask) tmp_list_;
   int ready_list_size_;
-  // TODO(alyssar): make this into something that scales up.
-  static const int events_size_ = 256;
-  struct epoll_event events_[256];
+  // The buffer for epoll_wait. It starts with kMinEpollEvents entries and
+  // doubles, up to kMaxEpollEvents, whenever a call fills it.
+  static const size_t kMinEpollEvents = 256;
+  static const size_t kMaxEpollEvents = 4096;
+  std::vector<struct epoll_event> events_;
+
+  int64 num_epoll_waits_;
+  int64 num_epoll_events_;
+  int max_events_per_epoll_wait_;
+  int last_epoll_wait_nfds_;
 
   // These controls the granularity for alarms
   // See function CallAndReregisterAlarmEvents()
@@ -955,7 +1004,7 @@ class EpollServer {
  private:
   // Helper functions used in the destructor.
   void CleanupFDToCBMap();
-  void CleanupTimeToAlarmCBMap();
+  void CleanupAlarmWheel();
 
   // The callback registered to the fds below.  As the purpose of their
   // registration is to wake the epoll server it just clears the pipe and
@@ -994,7 +1043,7 @@ class EpollAlarmCallbackInterface {
   // Summary:
   //   Called when the an alarm is registered. Invalidates an AlarmRegToken.
   // Args:
-  //   token: the iterator to the the alarm registered in the alarm map.
+  //   token: the token of the alarm registered in the alarm wheel.
   //   WARNING: this token becomes invalid when the alarm fires, is
   //   unregistered, or OnShutdown is called on that alarm.
   //   eps: the epoll server the alarm is registered with.
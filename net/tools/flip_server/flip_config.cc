@@ -37,6 +37,7 @@ FlipAcceptor::FlipAcceptor(enum FlipHandlerType flip_handler_type,
       accept_backlog_size_(accept_backlog_size),
       disable_nagle_(disable_nagle),
       accepts_per_wake_(accepts_per_wake),
+      reuseport_(reuseport),
       memory_cache_(memory_cache),
       ssl_session_expiry_(300),  // TODO(mbelshe):  Hook these up!
       ssl_disable_compression_(false),
@@ -95,10 +96,32 @@ FlipAcceptor::FlipAcceptor(enum FlipHandlerType flip_handler_type,
 
 FlipAcceptor::~FlipAcceptor() {}
 
+int FlipAcceptor::CreateAdditionalListenSocket() {
+  DCHECK(reuseport_);
+  int fd;
+  if (CreateListeningSocket(listen_ip_,
+                            listen_port_,
+                            true,
+                            accept_backlog_size_,
+                            true,
+                            reuseport_,
+                            false,
+                            disable_nagle_,
+                            &fd) != 0) {
+    LOG(ERROR) << "Unable to create additional listening socket for: "
+               << listen_ip_ << ":" << listen_port_;
+    return -1;
+  }
+  SetNonBlocking(fd);
+  return fd;
+}
+
 FlipConfig::FlipConfig()
     : server_think_time_in_s_(0),
       log_destination_(logging::LOG_ONLY_TO_SYSTEM_DEBUG_LOG),
-      wait_for_iface_(false) {
+      wait_for_iface_(false),
+      acceptor_threads_(1),
+      cache_reload_interval_s_(0) {
 }
 
 FlipConfig::~FlipConfig() {}
@@ -41,6 +41,10 @@ class FlipAcceptor {
                void *memory_cache);
   ~FlipAcceptor();
 
+  // Returns another non-blocking socket listening on the same address, for
+  // an additional acceptor thread, or -1 on failure. Requires |reuseport_|.
+  int CreateAdditionalListenSocket();
+
   enum FlipHandlerType flip_handler_type_;
   std::string listen_ip_;
   std::string listen_port_;
@@ -54,6 +58,7 @@ class FlipAcceptor {
   int accept_backlog_size_;
   bool disable_nagle_;
   int accepts_per_wake_;
+  bool reuseport_;
   int listen_fd_;
   void* memory_cache_;
   int ssl_session_expiry_;
@@ -91,6 +96,16 @@ class FlipConfig {
   int ssl_session_expiry_;
   bool ssl_disable_compression_;
   int idle_socket_timeout_s_;
+  // The number of threads accepting and serving connections for each
+  // acceptor. With more than one, each thread listens on its own socket if
+  // the acceptors use SO_REUSEPORT, and shares the acceptor's socket if not.
+  int acceptor_threads_;
+  // CPUs to run the acceptor threads on, assigned round robin. Threads may
+  // run on any CPU if empty.
+  std::vector<int> acceptor_cpus_;
+  // How often each acceptor thread reloads the files of its MemoryCache that
+  // changed on disk, or 0 to never reload them.
+  int cache_reload_interval_s_;
 };
 
 }  // namespace
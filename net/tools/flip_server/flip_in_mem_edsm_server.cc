@@ -204,6 +204,16 @@ int main (int argc, char**argv)
     cout << "\t--ssl-session-expiry=<seconds> (default is 300)\n";
     cout << "\t--ssl-disable-compression\n";
     cout << "\t--idle-timeout=<seconds> (default is 300)\n";
+    cout << "\t--acceptor-threads=<threads per listen ip:port> (default is 1)"
+         << "\n";
+    cout << "\t  * Use with --reuseport to give each thread its own listening"
+         << " socket.\n";
+    cout << "\t--reuseport\n";
+    cout << "\t--cpu-affinity=<cpu>[,<cpu>...]\n";
+    cout << "\t  * Acceptor threads are bound to the listed cpus in turn.\n";
+    cout << "\t--cache-reload-interval=<seconds> (default is 0, never)\n";
+    cout << "\t  * Changed files in the cache directory are served without"
+         << " a restart.\n";
     cout << "\t--pidfile=<filepath> (default /var/run/flip-server.pid)\n";
     cout << "\t--help\n";
     exit(0);
@@ -272,6 +282,27 @@ int main (int argc, char**argv)
   if (cl.HasSwitch("force_spdy"))
     net::SMConnection::set_force_spdy(true);
 
+  if (cl.HasSwitch("reuseport"))
+    FLAGS_reuseport = true;
+
+  if (cl.HasSwitch("acceptor-threads")) {
+    g_proxy_config.acceptor_threads_ =
+      atoi(cl.GetSwitchValueASCII("acceptor-threads").c_str());
+    CHECK_GT(g_proxy_config.acceptor_threads_, 0);
+  }
+
+  if (cl.HasSwitch("cpu-affinity")) {
+    std::vector<std::string> cpus =
+        split(cl.GetSwitchValueASCII("cpu-affinity"), ',');
+    for (size_t j = 0; j < cpus.size(); ++j)
+      g_proxy_config.acceptor_cpus_.push_back(atoi(cpus[j].c_str()));
+  }
+
+  if (cl.HasSwitch("cache-reload-interval")) {
+    g_proxy_config.cache_reload_interval_s_ =
+      atoi(cl.GetSwitchValueASCII("cache-reload-interval").c_str());
+  }
+
   InitLogging(g_proxy_config.log_filename_.c_str(),
               g_proxy_config.log_destination_,
               logging::DONT_LOCK_LOG_FILE,
@@ -299,6 +330,12 @@ int main (int argc, char**argv)
             << g_proxy_config.ssl_disable_compression_;
   LOG(INFO) << "Connection idle timeout : "
             << g_proxy_config.idle_socket_timeout_s_;
+  LOG(INFO) << "Acceptor threads        : "
+            << g_proxy_config.acceptor_threads_;
+  LOG(INFO) << "Acceptor cpus           : "
+            << (g_proxy_config.acceptor_cpus_.empty() ? "any" : "pinned");
+  LOG(INFO) << "Cache reload interval   : "
+            << g_proxy_config.cache_reload_interval_s_;
 
   // Proxy Acceptors
   while (true) {
@@ -371,23 +408,44 @@ int main (int argc, char**argv)
   }
 
   std::vector<net::SMAcceptorThread*> sm_worker_threads_;
+  std::vector<net::MemoryCache*> thread_memory_caches;
 
   for (i = 0; i < g_proxy_config.acceptors_.size(); i++) {
     net::FlipAcceptor *acceptor = g_proxy_config.acceptors_[i];
 
-    sm_worker_threads_.push_back(
-        new net::SMAcceptorThread(acceptor,
-                                  (net::MemoryCache *)acceptor->memory_cache_));
-    // Note that spdy_memory_cache is not threadsafe, it is merely
-    // thread compatible. Thus, if ever we are to spawn multiple threads,
-    // we either must make the MemoryCache threadsafe, or use
-    // a separate MemoryCache for each thread.
-    //
-    // The latter is what is currently being done as we spawn
-    // a separate thread for each http and spdy server acceptor.
-
-    sm_worker_threads_.back()->InitWorker();
-    sm_worker_threads_.back()->Start();
+    for (int t = 0; t < g_proxy_config.acceptor_threads_; ++t) {
+      int listen_fd = acceptor->listen_fd_;
+      if (t > 0 && acceptor->reuseport_) {
+        listen_fd = acceptor->CreateAdditionalListenSocket();
+        if (listen_fd < 0)
+          break;
+      }
+
+      // Note that spdy_memory_cache is not threadsafe, it is merely
+      // thread compatible. Thus each thread gets its own copy, which shares
+      // the parsed files and their mappings with the original.
+      net::MemoryCache* memory_cache =
+          static_cast<net::MemoryCache*>(acceptor->memory_cache_);
+      if (memory_cache) {
+        net::MemoryCache* copy = new net::MemoryCache;
+        copy->CloneFrom(*memory_cache);
+        thread_memory_caches.push_back(copy);
+        memory_cache = copy;
+      }
+
+      int cpu = -1;
+      if (!g_proxy_config.acceptor_cpus_.empty()) {
+        cpu = g_proxy_config.acceptor_cpus_[
+            sm_worker_threads_.size() % g_proxy_config.acceptor_cpus_.size()];
+      }
+
+      sm_worker_threads_.push_back(
+          new net::SMAcceptorThread(acceptor, memory_cache, listen_fd, cpu));
+      sm_worker_threads_.back()->set_cache_reload_interval_s(
+          g_proxy_config.cache_reload_interval_s_);
+      sm_worker_threads_.back()->InitWorker();
+      sm_worker_threads_.back()->Start();
+    }
   }
 
   while (!wantExit) {
@@ -405,6 +463,8 @@ int main (int argc, char**argv)
       for (unsigned int i = 0; i < sm_worker_threads_.size(); ++i) {
         sm_worker_threads_[i]->Join();
       }
+      for (unsigned int i = 0; i < thread_memory_caches.size(); ++i)
+        delete thread_memory_caches[i];
       break;
     }
     usleep(1000*10);  // 10 ms
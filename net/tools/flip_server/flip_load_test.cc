@@ -0,0 +1,199 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A load generator for flip_server. Each client thread repeatedly opens a
+// connection, sends an HTTP GET with "Connection: close" and reads until the
+// server closes the connection, so every request goes through the server's
+// accept path. Reports requests per second and latency percentiles.
+//
+// To compare acceptor configurations, run it once against a server started
+// with each --acceptor-threads value. For example, with each command on a
+// single line:
+//   flip_in_mem_edsm_server --http-server=127.0.0.1,8080
+//       --acceptor-threads=4 --reuseport --cpu-affinity=0,1,2,3
+//   flip_load_test --server=127.0.0.1:8080 --path=/index.html
+//       --clients=64 --seconds=10
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/compiler_specific.h"
+#include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/string_number_conversions.h"
+#include "base/string_split.h"
+#include "base/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "base/time.h"
+
+namespace {
+
+// Sends one request to |address| and waits for the whole response. Returns
+// false on any error.
+bool FetchOnce(const struct sockaddr_in& address, const std::string& request) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return false;
+
+  bool ok = connect(fd, reinterpret_cast<const struct sockaddr*>(&address),
+                    sizeof(address)) == 0;
+  size_t sent = 0;
+  while (ok && sent < request.size()) {
+    ssize_t rv = write(fd, request.data() + sent, request.size() - sent);
+    if (rv < 0 && errno == EINTR)
+      continue;
+    ok = rv > 0;
+    if (ok)
+      sent += rv;
+  }
+
+  size_t received = 0;
+  char buffer[16 * 1024];
+  while (ok) {
+    ssize_t rv = read(fd, buffer, sizeof(buffer));
+    if (rv < 0 && errno == EINTR)
+      continue;
+    if (rv <= 0) {
+      ok = rv == 0 && received > 0;
+      break;
+    }
+    received += rv;
+  }
+
+  close(fd);
+  return ok;
+}
+
+class ClientThread : public base::SimpleThread {
+ public:
+  ClientThread(const struct sockaddr_in& address,
+               const std::string& request,
+               base::TimeTicks end_time)
+      : base::SimpleThread("FlipLoadTestClient"),
+        address_(address),
+        request_(request),
+        end_time_(end_time),
+        errors_(0) {}
+
+  virtual void Run() OVERRIDE {
+    while (base::TimeTicks::Now() < end_time_) {
+      base::TimeTicks start = base::TimeTicks::Now();
+      if (FetchOnce(address_, request_))
+        latencies_.push_back(base::TimeTicks::Now() - start);
+      else
+        ++errors_;
+    }
+  }
+
+  const std::vector<base::TimeDelta>& latencies() const { return latencies_; }
+  int errors() const { return errors_; }
+
+ private:
+  const struct sockaddr_in address_;
+  const std::string request_;
+  const base::TimeTicks end_time_;
+  std::vector<base::TimeDelta> latencies_;
+  int errors_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClientThread);
+};
+
+// Returns the |percentile| latency of the sorted |latencies|.
+base::TimeDelta Percentile(const std::vector<base::TimeDelta>& latencies,
+                           int percentile) {
+  if (latencies.empty())
+    return base::TimeDelta();
+  size_t index = (latencies.size() - 1) * percentile / 100;
+  return latencies[index];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CommandLine::Init(argc, argv);
+  const CommandLine& cl = *CommandLine::ForCurrentProcess();
+
+  if (cl.HasSwitch("help") || !cl.HasSwitch("server")) {
+    std::cout << argv[0] << " <options>\n"
+              << "\t--server=<ip>:<port>\n"
+              << "\t--path=<path> (default is /)\n"
+              << "\t--host=<Host header> (default is the server ip)\n"
+              << "\t--clients=<concurrent connections> (default is 16)\n"
+              << "\t--seconds=<test duration> (default is 10)\n";
+    return 1;
+  }
+
+  std::string server = cl.GetSwitchValueASCII("server");
+  std::vector<std::string> host_and_port;
+  base::SplitString(server, ':', &host_and_port);
+  int port;
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  if (host_and_port.size() != 2 ||
+      !base::StringToInt(host_and_port[1], &port) || port <= 0 ||
+      port > 65535 ||
+      inet_pton(AF_INET, host_and_port[0].c_str(), &address.sin_addr) != 1) {
+    LOG(ERROR) << "Invalid --server: " << server;
+    return 1;
+  }
+  address.sin_port = htons(port);
+
+  std::string path = cl.HasSwitch("path") ? cl.GetSwitchValueASCII("path")
+                                          : "/";
+  std::string host = cl.HasSwitch("host") ? cl.GetSwitchValueASCII("host")
+                                          : host_and_port[0];
+  int clients = 16;
+  if (cl.HasSwitch("clients"))
+    base::StringToInt(cl.GetSwitchValueASCII("clients"), &clients);
+  int seconds = 10;
+  if (cl.HasSwitch("seconds"))
+    base::StringToInt(cl.GetSwitchValueASCII("seconds"), &seconds);
+  if (clients <= 0 || seconds <= 0) {
+    LOG(ERROR) << "--clients and --seconds must be positive";
+    return 1;
+  }
+
+  std::string request = base::StringPrintf(
+      "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n",
+      path.c_str(), host.c_str());
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  base::TimeTicks end_time = start + base::TimeDelta::FromSeconds(seconds);
+  ScopedVector<ClientThread> threads;
+  for (int i = 0; i < clients; ++i) {
+    threads.push_back(new ClientThread(address, request, end_time));
+    threads.back()->Start();
+  }
+
+  std::vector<base::TimeDelta> latencies;
+  int errors = 0;
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Join();
+    latencies.insert(latencies.end(), threads[i]->latencies().begin(),
+                     threads[i]->latencies().end());
+    errors += threads[i]->errors();
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << "clients=" << clients
+            << " requests=" << latencies.size()
+            << " errors=" << errors
+            << " requests_per_second="
+            << latencies.size() / elapsed.InSecondsF()
+            << " p50_ms=" << Percentile(latencies, 50).InMillisecondsF()
+            << " p99_ms=" << Percentile(latencies, 99).InMillisecondsF()
+            << "\n";
+  return errors && latencies.empty() ? 1 : 0;
+}
@@ -317,6 +317,28 @@ void HttpSM::SendDataFrameImpl(uint32 stream_id, const char* data, int64 len,
   EnqueueDataFrame(df);
 }
 
+void HttpSM::SendFileDataFrame(MappedFile* file, const char* data,
+                               size_t len) {
+  char chunk_buf[128];
+  int chunk_size = snprintf(chunk_buf, sizeof(chunk_buf), "%x\r\n",
+                            (unsigned int)len);
+  DataFrame* df = new DataFrame;
+  df->size = chunk_size;
+  char* buffer = new char[df->size];
+  df->data = buffer;
+  df->delete_when_done = true;
+  memcpy(buffer, chunk_buf, chunk_size);
+  EnqueueDataFrame(df);
+
+  EnqueueDataFrame(new FileDataFrame(file, data, len));
+
+  df = new DataFrame;
+  df->data = "\r\n";
+  df->size = 2;
+  df->delete_when_done = false;
+  EnqueueDataFrame(df);
+}
+
 void HttpSM::EnqueueDataFrame(DataFrame* df) {
   VLOG(2) << ACCEPTOR_CLIENT_IDENT << "HttpSM: Enqueue data frame: stream "
           << stream_id_;
@@ -350,9 +372,12 @@ void HttpSM::GetOutput() {
   if (num_to_write > mci->max_segment_size)
     num_to_write = mci->max_segment_size;
 
-  SendDataFrame(mci->stream_id,
-                mci->file_data->body.data() + mci->body_bytes_consumed,
-                num_to_write, 0, true);
+  const char* data = mci->file_data->body.data() + mci->body_bytes_consumed;
+  if (mci->file_data->file) {
+    SendFileDataFrame(mci->file_data->file, data, num_to_write);
+  } else {
+    SendDataFrame(mci->stream_id, data, num_to_write, 0, true);
+  }
   VLOG(2) << ACCEPTOR_CLIENT_IDENT << "HttpSM: GetOutput SendDataFrame["
           << mci->stream_id << "]: " << num_to_write;
   mci->body_bytes_consumed += num_to_write;
@@ -115,6 +115,9 @@ class HttpSM : public BalsaVisitorInterface,
   size_t SendSynStreamImpl(uint32 stream_id, const BalsaHeaders& headers);
   void SendDataFrameImpl(uint32 stream_id, const char* data, int64 len,
                          uint32 flags, bool compress);
+  // Like SendDataFrameImpl(), but |data| lies in |file| and is queued
+  // without being copied.
+  void SendFileDataFrame(MappedFile* file, const char* data, size_t len);
   void EnqueueDataFrame(DataFrame* df);
   virtual void GetOutput() OVERRIDE;
 
@@ -8,13 +8,16 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <deque>
+#include <set>
 
-#include "base/string_piece.h"
+#include "base/logging.h"
 #include "net/tools/dump_cache/url_to_filename_encoder.h"
 #include "net/tools/dump_cache/url_utilities.h"
 #include "net/tools/flip_server/balsa_frame.h"
@@ -27,7 +30,14 @@ namespace net {
 
 void StoreBodyAndHeadersVisitor::ProcessBodyData(const char *input,
                                                  size_t size) {
-  body.append(input, size);
+  if (decoded_body.empty() && (body.empty() || body.end() == input)) {
+    body.set(body.empty() ? input : body.data(), body.size() + size);
+    return;
+  }
+  if (decoded_body.empty())
+    body.CopyToString(&decoded_body);
+  decoded_body.append(input, size);
+  body = decoded_body;
 }
 
 void StoreBodyAndHeadersVisitor::HandleHeaderError(BalsaFrame* framer) {
@@ -46,40 +56,77 @@ void StoreBodyAndHeadersVisitor::HandleBodyError(BalsaFrame* framer) {
   HandleError();
 }
 
-FileData::FileData(BalsaHeaders* h, const std::string& b)
-    : headers(h), body(b) {
+// static
+MappedFile* MappedFile::Create(const char* filename) {
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1)
+    return NULL;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return NULL;
+  }
+  void* data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Unable to map " << filename << ": " << strerror(errno);
+    close(fd);
+    return NULL;
+  }
+  return new MappedFile(fd, static_cast<const char*>(data), st.st_size);
 }
 
-FileData::FileData() {}
+MappedFile::MappedFile(int fd, const char* data, size_t size)
+    : fd_(fd), data_(data), size_(size) {
+}
 
-FileData::~FileData() {}
+MappedFile::~MappedFile() {
+  munmap(const_cast<char*>(data_), size_);
+  close(fd_);
+}
 
-void FileData::CopyFrom(const FileData& file_data) {
-    headers = new BalsaHeaders;
-    headers->CopyFrom(*(file_data.headers));
-    filename = file_data.filename;
-    related_files = file_data.related_files;
-    body = file_data.body;
-  }
+FileData::FileData() : mtime(0), file_size(0) {}
+
+FileData::~FileData() {}
 
 MemoryCache::MemoryCache() {}
 
 MemoryCache::~MemoryCache() {}
 
 void MemoryCache::CloneFrom(const MemoryCache& mc) {
-  for (Files::const_iterator i = mc.files_.begin();
-       i != mc.files_.end();
-       ++i) {
-    Files::iterator out_i =
-        files_.insert(make_pair(i->first, FileData())).first;
-    out_i->second.CopyFrom(i->second);
-    cwd_ = mc.cwd_;
-  }
+  files_ = mc.files_;
+  cwd_ = mc.cwd_;
 }
 
 void MemoryCache::AddFiles() {
-  std::deque<std::string> paths;
   cwd_ = FLAGS_cache_base_dir;
+  std::vector<std::string> paths;
+  ListFiles(&paths);
+  for (size_t i = 0; i < paths.size(); ++i)
+    ReadAndStoreFileContents(paths[i].c_str());
+}
+
+void MemoryCache::ReloadChangedFiles() {
+  if (cwd_.empty())
+    return;
+  std::vector<std::string> paths;
+  ListFiles(&paths);
+  std::set<std::string> present;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    ReadAndStoreFileContents(paths[i].c_str());
+    present.insert(GetCacheKey(paths[i].c_str()));
+  }
+  for (Files::iterator it = files_.begin(); it != files_.end(); ) {
+    if (present.count(it->first)) {
+      ++it;
+      continue;
+    }
+    LOG(INFO) << "Removing file: " << it->first;
+    files_.erase(it++);
+  }
+}
+
+void MemoryCache::ListFiles(std::vector<std::string>* files) {
+  std::deque<std::string> paths;
   paths.push_back(cwd_ + "/GET_");
   DIR* current_dir = NULL;
   while (!paths.empty()) {
@@ -104,7 +151,7 @@ void MemoryCache::AddFiles() {
             current_dir_name + "/" + dir_data->d_name;
           if (dir_data->d_type == DT_REG) {
             VLOG(1) << "Found file: " << current_entry_name;
-            ReadAndStoreFileContents(current_entry_name.c_str());
+            files->push_back(current_entry_name);
           } else if (dir_data->d_type == DT_DIR) {
             VLOG(1) << "Found subdir: " << current_entry_name;
             if (std::string(dir_data->d_name) != "." &&
@@ -139,23 +186,32 @@ void MemoryCache::ReadToString(const char* filename, std::string* output) {
 }
 
 void MemoryCache::ReadAndStoreFileContents(const char* filename) {
+  std::string key = GetCacheKey(filename);
+  struct stat st;
+  if (stat(filename, &st) != 0)
+    return;
+  Files::const_iterator cached = files_.find(key);
+  if (cached != files_.end() && cached->second->mtime == st.st_mtime &&
+      cached->second->file_size == st.st_size) {
+    return;
+  }
+
+  scoped_refptr<MappedFile> file(MappedFile::Create(filename));
+  if (!file) {
+    LOG(ERROR) << "Unable to read file: " << filename;
+    return;
+  }
+
   StoreBodyAndHeadersVisitor visitor;
   BalsaFrame framer;
   framer.set_balsa_visitor(&visitor);
   framer.set_balsa_headers(&(visitor.headers));
-  std::string filename_contents;
-  ReadToString(filename, &filename_contents);
-
-  // Ugly hack to make everything look like 1.1.
-  if (filename_contents.find("HTTP/1.0") == 0)
-    filename_contents[7] = '1';
 
   size_t pos = 0;
   size_t old_pos = 0;
   while (true) {
     old_pos = pos;
-    pos += framer.ProcessInput(filename_contents.data() + pos,
-                               filename_contents.size() - pos);
+    pos += framer.ProcessInput(file->data() + pos, file->size() - pos);
     if (framer.Error() || pos == old_pos) {
       LOG(ERROR) << "Unable to make forward progress, or error"
         " framing file: " << filename;
@@ -169,11 +225,15 @@ void MemoryCache::ReadAndStoreFileContents(const char* filename) {
       // If no Content-Length or Transfer-Encoding was captured in the
       // file, then the rest of the data is the body.  Many of the captures
       // from within Chrome don't have content-lengths.
-      if (!visitor.body.length())
-        visitor.body = filename_contents.substr(pos);
+      if (visitor.body.empty())
+        visitor.body.set(file->data() + pos, file->size() - pos);
       break;
     }
   }
+
+  // Ugly hack to make everything look like 1.1.
+  if (visitor.headers.response_version() == "HTTP/1.0")
+    visitor.headers.SetResponseVersion("HTTP/1.1");
   visitor.headers.RemoveAllOfHeader("content-length");
   visitor.headers.RemoveAllOfHeader("transfer-encoding");
   visitor.headers.RemoveAllOfHeader("connection");
@@ -192,16 +252,24 @@ void MemoryCache::ReadAndStoreFileContents(const char* filename) {
                                "Fri, 30 Aug, 2019 12:00:00 GMT");
   }
 #endif
-  BalsaHeaders* headers = new BalsaHeaders;
-  headers->CopyFrom(visitor.headers);
-  std::string filename_stripped = std::string(filename).substr(cwd_.size() + 1);
-  LOG(INFO) << "Adding file (" << visitor.body.length() << " bytes): "
-            << filename_stripped;
-  files_[filename_stripped] = FileData();
-  FileData& fd = files_[filename_stripped];
-  fd = FileData(headers, visitor.body);
-  fd.filename = std::string(filename_stripped,
-                            filename_stripped.find_first_of('/'));
+  scoped_refptr<FileData> fd(new FileData);
+  fd->headers.reset(new BalsaHeaders);
+  fd->headers->CopyFrom(visitor.headers);
+  if (visitor.decoded_body.empty()) {
+    // The body is stored as is in the file, so it is served straight from
+    // the mapping.
+    fd->body = visitor.body;
+    fd->file = file;
+  } else {
+    fd->decoded_body.swap(visitor.decoded_body);
+    fd->body = fd->decoded_body;
+  }
+  fd->filename = std::string(key, key.find_first_of('/'));
+  fd->mtime = st.st_mtime;
+  fd->file_size = st.st_size;
+  LOG(INFO) << (cached == files_.end() ? "Adding" : "Reloading") << " file ("
+            << fd->body.length() << " bytes): " << key;
+  files_[key] = fd;
 }
 
 FileData* MemoryCache::GetFileData(const std::string& filename) {
@@ -217,7 +285,7 @@ FileData* MemoryCache::GetFileData(const std::string& filename) {
   if (fi == files_.end()) {
     return NULL;
   }
-  return &(fi->second);
+  return fi->second;
 }
 
 bool MemoryCache::AssignFileData(const std::string& filename,
@@ -230,5 +298,9 @@ bool MemoryCache::AssignFileData(const std::string& filename,
   return true;
 }
 
+std::string MemoryCache::GetCacheKey(const char* filename) const {
+  return std::string(filename).substr(cwd_.size() + 1);
+}
+
 }  // namespace net
 
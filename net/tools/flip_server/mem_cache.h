@@ -5,11 +5,17 @@
 #ifndef NET_TOOLS_FLIP_SERVER_MEM_CACHE_H_
 #define NET_TOOLS_FLIP_SERVER_MEM_CACHE_H_
 
+#include <sys/types.h>
+
 #include <map>
 #include <string>
 #include <vector>
 
+#include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_piece.h"
 #include "net/tools/flip_server/balsa_headers.h"
 #include "net/tools/flip_server/balsa_visitor_interface.h"
 #include "net/tools/flip_server/constants.h"
@@ -56,23 +62,69 @@ class StoreBodyAndHeadersVisitor: public BalsaVisitorInterface {
   virtual void HandleBodyError(BalsaFrame* framer) OVERRIDE;
 
   BalsaHeaders headers;
-  std::string body;
+  // The body, pointing into the framer's input for as long as the body data
+  // arrives back to back in it. Once it doesn't (e.g. a chunked body), the
+  // body is copied into |decoded_body| and |body| points there instead.
+  base::StringPiece body;
+  std::string decoded_body;
   bool error_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
-struct FileData {
+// A read-only mapping of a file in the cache directory. All the FileData, in
+// every thread's MemoryCache, that serve the file share its pages. The file
+// stays open so that it can be sent with sendfile().
+class MappedFile : public base::RefCountedThreadSafe<MappedFile> {
+ public:
+  // Maps |filename|. Returns NULL if it can't be opened, is empty or can't
+  // be mapped.
+  static MappedFile* Create(const char* filename);
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+  int fd() const { return fd_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<MappedFile>;
+
+  MappedFile(int fd, const char* data, size_t size);
+  ~MappedFile();
+
+  const int fd_;
+  const char* const data_;
+  const size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// A parsed cache file. FileData is immutable once it is in a MemoryCache, so
+// clones of the cache and the streams serving it share it. Reloading a file
+// replaces its FileData; streams that already started keep the old one.
+struct FileData : public base::RefCountedThreadSafe<FileData> {
   FileData();
-  FileData(BalsaHeaders* h, const std::string& b);
-  ~FileData();
-  void CopyFrom(const FileData& file_data);
 
-  BalsaHeaders* headers;
+  scoped_ptr<BalsaHeaders> headers;
   std::string filename;
   // priority, filename
   std::vector< std::pair<int, std::string> > related_files;
-  std::string body;
+  // Points into |file| if the body is stored as is in the file, or into
+  // |decoded_body| otherwise.
+  base::StringPiece body;
+  scoped_refptr<MappedFile> file;
+  std::string decoded_body;
+  // The modification time and size of the file when it was read, used to
+  // find the files that changed.
+  time_t mtime;
+  off_t file_size;
+
+ private:
+  friend class base::RefCountedThreadSafe<FileData>;
+  ~FileData();
+
+  DISALLOW_COPY_AND_ASSIGN(FileData);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -95,7 +147,7 @@ class MemCacheIter {
       stream_id(0),
       max_segment_size(kInitialDataSendersThreshold),
       bytes_sent(0) {}
-  FileData* file_data;
+  scoped_refptr<FileData> file_data;
   int priority;
   bool transformed_header;
   size_t body_bytes_consumed;
@@ -108,18 +160,26 @@ class MemCacheIter {
 
 class MemoryCache {
  public:
-  typedef std::map<std::string, FileData> Files;
+  typedef std::map<std::string, scoped_refptr<FileData> > Files;
 
  public:
   MemoryCache();
   ~MemoryCache();
 
+  // Shares the files of |mc|; nothing is copied or read again.
   void CloneFrom(const MemoryCache& mc);
 
   void AddFiles();
 
+  // Reads the files that were added to or changed in the cache directory
+  // since they were last read, and drops those that were deleted. Streams
+  // that are being served keep the contents they started with.
+  void ReloadChangedFiles();
+
   void ReadToString(const char* filename, std::string* output);
 
+  // Maps and parses |filename|, unless it is already cached and hasn't
+  // changed since.
   void ReadAndStoreFileContents(const char* filename);
 
   FileData* GetFileData(const std::string& filename);
@@ -128,6 +188,12 @@ class MemoryCache {
 
   Files files_;
   std::string cwd_;
+
+ private:
+  // Appends the paths of all the regular files in the cache directory.
+  void ListFiles(std::vector<std::string>* paths);
+
+  std::string GetCacheKey(const char* filename) const;
 };
 
 class NotifierInterface {
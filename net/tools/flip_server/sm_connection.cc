@@ -6,6 +6,7 @@
 
 #include <errno.h>
 #include <netinet/tcp.h>
+#include <sys/sendfile.h>
 #include <sys/socket.h>
 
 #include <list>
@@ -28,6 +29,23 @@ DataFrame::~DataFrame() {
     delete[] data;
 }
 
+MappedFile* DataFrame::mapped_file() const {
+  return NULL;
+}
+
+FileDataFrame::FileDataFrame(MappedFile* file, const char* data, size_t size)
+    : file_(file) {
+  DCHECK(data >= file->data() && data + size <= file->data() + file->size());
+  this->data = data;
+  this->size = size;
+}
+
+FileDataFrame::~FileDataFrame() {}
+
+MappedFile* FileDataFrame::mapped_file() const {
+  return file_;
+}
+
 SMConnection::SMConnection(EpollServer* epoll_server,
                            SSLState* ssl_state,
                            MemoryCache* memory_cache,
@@ -52,6 +70,7 @@ SMConnection::SMConnection(EpollServer* epoll_server,
       sm_interface_(NULL),
       log_prefix_(log_prefix),
       max_bytes_sent_per_dowrite_(4096),
+      max_bytes_read_per_doread_(kSpdySegmentSize * 4),
       ssl_(NULL) {
 }
 
@@ -224,6 +243,16 @@ int SMConnection::Send(const char* data, int len, int flags) {
   return rv;
 }
 
+int SMConnection::SendFile(const MappedFile* file, off_t offset, int len,
+                           int flags) {
+  DCHECK(!ssl_);
+  CorkSocket();
+  int rv = sendfile(fd_, file->fd(), &offset, len);
+  if (!(flags & MSG_MORE))
+    UncorkSocket();
+  return rv;
+}
+
 void SMConnection::OnRegistration(EpollServer* eps, int fd, int event_mask) {
   registered_in_epoll_server_ = true;
 }
@@ -407,7 +436,15 @@ bool SMConnection::SetupProtocolInterfaces() {
 
 bool SMConnection::DoRead() {
   VLOG(2) << log_prefix_ << ACCEPTOR_CLIENT_IDENT << "DoRead()";
+  size_t total_bytes_read = 0;
   while (!read_buffer_.Full()) {
+    if (total_bytes_read >= max_bytes_read_per_doread_) {
+      // Leave EPOLLIN set so that OnEvent() puts us back on the ready list.
+      VLOG(2) << log_prefix_ << ACCEPTOR_CLIENT_IDENT
+              << "bytes read >= max bytes read per read: "
+              << total_bytes_read;
+      goto done;
+    }
     char* bytes;
     int size;
     if (fd_ == -1) {
@@ -469,6 +506,7 @@ bool SMConnection::DoRead() {
         }
       }
       read_buffer_.AdvanceWritablePtr(bytes_read);
+      total_bytes_read += bytes_read;
       if (!DoConsumeReadData())
         goto error_or_close;
       continue;
@@ -575,7 +613,12 @@ bool SMConnection::DoWrite() {
       flags |= MSG_MORE;
     }
     VLOG(2) << log_prefix_ << "Attempting to send " << size << " bytes.";
-    ssize_t bytes_written = Send(bytes, size, flags);
+    MappedFile* file = data_frame->mapped_file();
+    ssize_t bytes_written;
+    if (file && !ssl_)
+      bytes_written = SendFile(file, bytes - file->data(), size, flags);
+    else
+      bytes_written = Send(bytes, size, flags);
     int stored_errno = errno;
     if (bytes_written == -1) {
       switch (stored_errno) {
@@ -6,6 +6,7 @@
 #define NET_TOOLS_FLIP_SERVER_SM_CONNECTION_H_
 
 #include <arpa/inet.h>  // in_addr_t
+#include <sys/types.h>
 #include <time.h>
 
 #include <list>
@@ -34,6 +35,22 @@ class DataFrame {
   size_t index;
   DataFrame() : data(NULL), size(0), delete_when_done(false), index(0) {}
   virtual ~DataFrame();
+
+  // The mapped file |data| points into, if any.
+  virtual MappedFile* mapped_file() const;
+};
+
+// A frame of data in a mapped cache file, which it keeps mapped until the
+// frame has been sent. Connections without SSL send it with sendfile().
+class FileDataFrame : public DataFrame {
+ public:
+  FileDataFrame(MappedFile* file, const char* data, size_t size);
+  virtual ~FileDataFrame();
+
+  virtual MappedFile* mapped_file() const OVERRIDE;
+
+ private:
+  scoped_refptr<MappedFile> file_;
 };
 
 typedef std::list<DataFrame*> OutputList;
@@ -79,6 +96,10 @@ class SMConnection : public SMConnectionInterface,
 
   int Send(const char* data, int len, int flags);
 
+  // Like Send(), but sends |len| bytes of |file| from |offset| without
+  // copying them. Must not be used on SSL connections.
+  int SendFile(const MappedFile* file, off_t offset, int len, int flags);
+
   // EpollCallbackInterface interface.
   virtual void OnRegistration(EpollServer* eps,
                               int fd,
@@ -151,6 +172,10 @@ class SMConnection : public SMConnectionInterface,
   std::string log_prefix_;
 
   size_t max_bytes_sent_per_dowrite_;
+  // The socket is edge triggered, so DoRead() would otherwise read until
+  // EAGAIN. After this many bytes it stops and the connection goes back on
+  // the epoll server's ready list, behind the other ready connections.
+  size_t max_bytes_read_per_doread_;
 
   SSL* ssl_;
 
@@ -7,8 +7,15 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
+#include <string.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#if defined(OS_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
+#include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/eintr_wrapper.h"
 #include "base/logging.h"
@@ -31,10 +38,70 @@ static const int kBindRetries = 10;
 static const int kPortStart = 1024;
 static const int kPortEnd = 65535;
 
-}  // namespace net
+// The kernel's struct mmsghdr, which older C libraries do not declare. Also
+// used for the one-datagram-at-a-time fallback.
+struct MMsgHdr {
+  struct msghdr msg_hdr;
+  unsigned int msg_len;
+};
+
+// Receives up to |count| datagrams into |msgs| with one recvmmsg() call where
+// the kernel supports it, or one recvmsg() call per datagram otherwise.
+// Returns the number received, or -1 with errno set if none were.
+int ReceiveBatch(int socket, MMsgHdr* msgs, unsigned int count) {
+#if defined(__NR_recvmmsg)
+  // Sockets live on several threads, so the probe result is shared atomically.
+  static base::subtle::Atomic32 recvmmsg_unsupported = 0;
+  if (!base::subtle::NoBarrier_Load(&recvmmsg_unsupported)) {
+    int rv = HANDLE_EINTR(syscall(__NR_recvmmsg, socket, msgs, count, 0,
+                                  NULL));
+    if (rv >= 0 || errno != ENOSYS)
+      return rv;
+    base::subtle::NoBarrier_Store(&recvmmsg_unsupported, 1);
+  }
+#endif
+  unsigned int received = 0;
+  for (; received < count; ++received) {
+    ssize_t rv = HANDLE_EINTR(recvmsg(socket, &msgs[received].msg_hdr, 0));
+    if (rv < 0)
+      break;
+    msgs[received].msg_len = rv;
+  }
+  return received > 0 ? received : -1;
+}
+
+// Sends |count| datagrams from |msgs| like ReceiveBatch(), with sendmmsg().
+// Returns the number sent, or -1 with errno set if none were.
+int SendBatch(int socket, MMsgHdr* msgs, unsigned int count) {
+#if defined(__NR_sendmmsg)
+  static base::subtle::Atomic32 sendmmsg_unsupported = 0;
+  if (!base::subtle::NoBarrier_Load(&sendmmsg_unsupported)) {
+    int rv = HANDLE_EINTR(syscall(__NR_sendmmsg, socket, msgs, count, 0));
+    if (rv >= 0 || errno != ENOSYS)
+      return rv;
+    base::subtle::NoBarrier_Store(&sendmmsg_unsupported, 1);
+  }
+#endif
+  unsigned int sent = 0;
+  for (; sent < count; ++sent) {
+    ssize_t rv = HANDLE_EINTR(sendmsg(socket, &msgs[sent].msg_hdr, 0));
+    if (rv < 0)
+      break;
+    msgs[sent].msg_len = rv;
+  }
+  return sent > 0 ? sent : -1;
+}
+
+}  // namespace
 
 namespace net {
 
+UDPDatagram::UDPDatagram() : buf_len(0), bytes_received(0) {
+}
+
+UDPDatagram::~UDPDatagram() {
+}
+
 UDPSocketLibevent::UDPSocketLibevent(
     DatagramSocket::BindType bind_type,
     const RandIntCallback& rand_int_cb,
@@ -49,6 +116,8 @@ UDPSocketLibevent::UDPSocketLibevent(
           read_buf_len_(0),
           recv_from_address_(NULL),
           write_buf_len_(0),
+          recv_datagrams_(NULL),
+          send_datagrams_(NULL),
           net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_UDP_SOCKET)) {
   net_log_.BeginEvent(NetLog::TYPE_SOCKET_ALIVE,
                       source.ToEventParametersCallback());
@@ -76,6 +145,8 @@ void UDPSocketLibevent::Close() {
   write_buf_len_ = 0;
   write_callback_.Reset();
   send_to_address_.reset();
+  recv_datagrams_ = NULL;
+  send_datagrams_ = NULL;
 
   bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
   DCHECK(ok);
@@ -211,6 +282,59 @@ int UDPSocketLibevent::SendToOrWrite(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int UDPSocketLibevent::RecvMultipleFrom(std::vector<UDPDatagram>* datagrams,
+                                        const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(read_callback_.is_null());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(!datagrams->empty());
+
+  int result = InternalRecvMultipleFrom(datagrams);
+  if (result != ERR_IO_PENDING)
+    return result;
+
+  if (!MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, MessageLoopForIO::WATCH_READ,
+          &read_socket_watcher_, &read_watcher_)) {
+    PLOG(ERROR) << "WatchFileDescriptor failed on read";
+    int result = MapSystemError(errno);
+    LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  recv_datagrams_ = datagrams;
+  read_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
+int UDPSocketLibevent::SendMultipleTo(
+    const std::vector<UDPDatagram>* datagrams,
+    const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(write_callback_.is_null());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(!datagrams->empty());
+
+  int result = InternalSendMultipleTo(datagrams);
+  if (result != ERR_IO_PENDING)
+    return result;
+
+  if (!MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, MessageLoopForIO::WATCH_WRITE,
+          &write_socket_watcher_, &write_watcher_)) {
+    DVLOG(1) << "WatchFileDescriptor failed on write, errno " << errno;
+    int result = MapSystemError(errno);
+    LogWrite(result, NULL, NULL);
+    return result;
+  }
+
+  send_datagrams_ = datagrams;
+  write_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
 int UDPSocketLibevent::Connect(const IPEndPoint& address) {
   net_log_.BeginEvent(NetLog::TYPE_UDP_CONNECT,
                       CreateNetLogUDPConnectCallback(&address));
@@ -323,11 +447,14 @@ void UDPSocketLibevent::DoWriteCallback(int rv) {
 }
 
 void UDPSocketLibevent::DidCompleteRead() {
-  int result = InternalRecvFrom(read_buf_, read_buf_len_, recv_from_address_);
+  int result = recv_datagrams_ ?
+      InternalRecvMultipleFrom(recv_datagrams_) :
+      InternalRecvFrom(read_buf_, read_buf_len_, recv_from_address_);
   if (result != ERR_IO_PENDING) {
     read_buf_ = NULL;
     read_buf_len_ = 0;
     recv_from_address_ = NULL;
+    recv_datagrams_ = NULL;
     bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
     DCHECK(ok);
     DoReadCallback(result);
@@ -373,13 +500,15 @@ int UDPSocketLibevent::CreateSocket(const IPEndPoint& address) {
 }
 
 void UDPSocketLibevent::DidCompleteWrite() {
-  int result = InternalSendTo(write_buf_, write_buf_len_,
-                              send_to_address_.get());
+  int result = send_datagrams_ ?
+      InternalSendMultipleTo(send_datagrams_) :
+      InternalSendTo(write_buf_, write_buf_len_, send_to_address_.get());
 
   if (result != ERR_IO_PENDING) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
     send_to_address_.reset();
+    send_datagrams_ = NULL;
     write_socket_watcher_.StopWatchingFileDescriptor();
     DoWriteCallback(result);
   }
@@ -458,6 +587,82 @@ int UDPSocketLibevent::InternalSendTo(IOBuffer* buf, int buf_len,
   return result;
 }
 
+int UDPSocketLibevent::InternalRecvMultipleFrom(
+    std::vector<UDPDatagram>* datagrams) {
+  const size_t count = datagrams->size();
+  std::vector<sockaddr_storage> addrs(count);
+  std::vector<struct iovec> iovs(count);
+  std::vector<MMsgHdr> msgs(count);
+  memset(&msgs[0], 0, count * sizeof(MMsgHdr));
+  for (size_t i = 0; i < count; ++i) {
+    UDPDatagram& datagram = (*datagrams)[i];
+    iovs[i].iov_base = datagram.buf->data();
+    iovs[i].iov_len = datagram.buf_len;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int received = ReceiveBatch(socket_, &msgs[0], count);
+  if (received < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  for (int i = 0; i < received; ++i) {
+    UDPDatagram& datagram = (*datagrams)[i];
+    const sockaddr* addr = reinterpret_cast<const sockaddr*>(&addrs[i]);
+    socklen_t addr_len = msgs[i].msg_hdr.msg_namelen;
+    datagram.bytes_received = msgs[i].msg_len;
+    if (!datagram.address.FromSockAddr(addr, addr_len))
+      datagram.bytes_received = ERR_FAILED;
+    LogRead(datagram.bytes_received, datagram.buf->data(), addr_len, addr);
+  }
+  return received;
+}
+
+int UDPSocketLibevent::InternalSendMultipleTo(
+    const std::vector<UDPDatagram>* datagrams) {
+  const size_t count = datagrams->size();
+  std::vector<sockaddr_storage> addrs(count);
+  std::vector<struct iovec> iovs(count);
+  std::vector<MMsgHdr> msgs(count);
+  memset(&msgs[0], 0, count * sizeof(MMsgHdr));
+  for (size_t i = 0; i < count; ++i) {
+    const UDPDatagram& datagram = (*datagrams)[i];
+    socklen_t addr_len = sizeof(addrs[i]);
+    if (!datagram.address.ToSockAddr(
+            reinterpret_cast<sockaddr*>(&addrs[i]), &addr_len)) {
+      int result = ERR_FAILED;
+      LogWrite(result, NULL, NULL);
+      return result;
+    }
+    iovs[i].iov_base = datagram.buf->data();
+    iovs[i].iov_len = datagram.buf_len;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = addr_len;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int sent = SendBatch(socket_, &msgs[0], count);
+  if (sent < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogWrite(result, NULL, NULL);
+    return result;
+  }
+
+  for (int i = 0; i < sent; ++i) {
+    const UDPDatagram& datagram = (*datagrams)[i];
+    LogWrite(msgs[i].msg_len, datagram.buf->data(), &datagram.address);
+  }
+  return sent;
+}
+
 int UDPSocketLibevent::SetSocketOptions() {
   int true_value = 1;
   if (socket_options_ & SOCKET_OPTION_REUSE_ADDRESS) {
@@ -5,6 +5,8 @@
 #ifndef NET_UDP_UDP_SOCKET_LIBEVENT_H_
 #define NET_UDP_UDP_SOCKET_LIBEVENT_H_
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
@@ -19,6 +21,22 @@
 
 namespace net {
 
+// One datagram of a batched receive or send on a UDPSocketLibevent.
+struct NET_EXPORT UDPDatagram {
+  UDPDatagram();
+  ~UDPDatagram();
+
+  // When receiving, |buf_len| is the space available in |buf| and
+  // |bytes_received| is set to the length of the datagram, or to a net error
+  // code. When sending, |buf_len| is the length of the datagram.
+  scoped_refptr<IOBuffer> buf;
+  int buf_len;
+  int bytes_received;
+
+  // The sender when receiving, the recipient when sending.
+  IPEndPoint address;
+};
+
 class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
  public:
   UDPSocketLibevent(DatagramSocket::BindType bind_type,
@@ -92,6 +110,28 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
              const IPEndPoint& address,
              const CompletionCallback& callback);
 
+  // Batched versions of RecvFrom() and SendTo() for sockets that handle many
+  // small datagrams. On Linux each batch is a single recvmmsg() or sendmmsg()
+  // system call. They share the single outstanding read and write with
+  // RecvFrom() and SendTo(). If ERR_IO_PENDING is returned, the caller must
+  // keep |datagrams| alive until the callback is called. Reusing the same
+  // |datagrams| and their buffers for every call avoids an allocation per
+  // datagram.
+
+  // Reads the datagrams already queued on the socket into the first entries
+  // of |datagrams|, at most one per entry, and returns how many were read.
+  // Like RecvFrom(), returns ERR_IO_PENDING if none are queued yet, in which
+  // case the callback is called with the count once some arrive.
+  int RecvMultipleFrom(std::vector<UDPDatagram>* datagrams,
+                       const CompletionCallback& callback);
+
+  // Sends |datagrams| in order and returns how many were sent. Fewer than all
+  // of them are sent if the socket's send buffer fills up; the caller sends
+  // the rest with another call. Like SendTo(), returns ERR_IO_PENDING if none
+  // can be sent yet, in which case the callback is called with the count.
+  int SendMultipleTo(const std::vector<UDPDatagram>* datagrams,
+                     const CompletionCallback& callback);
+
   // Set the receive buffer size (in bytes) for the socket.
   bool SetReceiveBufferSize(int32 size);
 
@@ -180,6 +220,8 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   int InternalConnect(const IPEndPoint& address);
   int InternalRecvFrom(IOBuffer* buf, int buf_len, IPEndPoint* address);
   int InternalSendTo(IOBuffer* buf, int buf_len, const IPEndPoint* address);
+  int InternalRecvMultipleFrom(std::vector<UDPDatagram>* datagrams);
+  int InternalSendMultipleTo(const std::vector<UDPDatagram>* datagrams);
 
   // Applies |socket_options_| to |socket_|. Should be called before
   // Bind().
@@ -223,6 +265,11 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   int write_buf_len_;
   scoped_ptr<IPEndPoint> send_to_address_;
 
+  // The datagrams of a pending RecvMultipleFrom() or SendMultipleTo(),
+  // retried in place of the single buffers above.
+  std::vector<UDPDatagram>* recv_datagrams_;
+  const std::vector<UDPDatagram>* send_datagrams_;
+
   // External callback; called when read is complete.
   CompletionCallback read_callback_;
 
@@ -0,0 +1,134 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/base/test_completion_callback.h"
+#include "net/udp/udp_socket.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+#if defined(OS_POSIX)
+
+// Size of the datagrams, about that of a small RTP packet.
+const int kDatagramSize = 100;
+
+// Size of the receive buffers.
+const int kMaxRead = 1024;
+
+// Number of datagrams sent and received per round, and per batch.
+const size_t kBatchSize = 16;
+
+// Binds |socket| to an ephemeral port on the loopback interface and returns
+// the bound address in |address|.
+void BindToLoopback(UDPSocket* socket, IPEndPoint* address) {
+  IPAddressNumber ip_number;
+  ASSERT_TRUE(ParseIPLiteralToNumber("127.0.0.1", &ip_number));
+  ASSERT_EQ(OK, socket->Bind(IPEndPoint(ip_number, 0)));
+  ASSERT_EQ(OK, socket->GetLocalAddress(address));
+}
+
+// Sends all of |datagrams|, in as many batches as it takes.
+void SendAll(UDPSocket* socket, const std::vector<UDPDatagram>& datagrams) {
+  std::vector<UDPDatagram> remaining(datagrams);
+  while (!remaining.empty()) {
+    TestCompletionCallback callback;
+    int rv = socket->SendMultipleTo(&remaining, callback.callback());
+    if (rv == ERR_IO_PENDING)
+      rv = callback.WaitForResult();
+    ASSERT_GT(rv, 0);
+    remaining.erase(remaining.begin(), remaining.begin() + rv);
+  }
+}
+
+// Receives |count| datagrams, in as many batches as it takes. |datagrams|
+// provides the receive buffers.
+void ReceiveAll(UDPSocket* socket,
+                size_t count,
+                std::vector<UDPDatagram>* datagrams) {
+  while (count > 0) {
+    TestCompletionCallback callback;
+    int rv = socket->RecvMultipleFrom(datagrams, callback.callback());
+    if (rv == ERR_IO_PENDING)
+      rv = callback.WaitForResult();
+    ASSERT_GT(rv, 0);
+    ASSERT_LE(static_cast<size_t>(rv), count);
+    count -= rv;
+  }
+}
+
+// Sends and receives |kBatchSize| datagrams per round over loopback, one
+// system call per datagram or batched, and logs the datagrams per second.
+void MeasurePacketsPerSecond(bool batched) {
+  const int kRounds = 1000;
+  MessageLoopForIO loop;
+  UDPSocket sender(DatagramSocket::DEFAULT_BIND, RandIntCallback(), NULL,
+                   NetLog::Source());
+  UDPSocket receiver(DatagramSocket::DEFAULT_BIND, RandIntCallback(), NULL,
+                     NetLog::Source());
+  IPEndPoint sender_address;
+  IPEndPoint receiver_address;
+  BindToLoopback(&sender, &sender_address);
+  BindToLoopback(&receiver, &receiver_address);
+
+  std::vector<UDPDatagram> datagrams(kBatchSize);
+  std::vector<UDPDatagram> receive_datagrams(kBatchSize);
+  for (size_t i = 0; i < kBatchSize; ++i) {
+    datagrams[i].buf = new StringIOBuffer(std::string(kDatagramSize, 'x'));
+    datagrams[i].buf_len = kDatagramSize;
+    datagrams[i].address = receiver_address;
+    receive_datagrams[i].buf = new IOBuffer(kMaxRead);
+    receive_datagrams[i].buf_len = kMaxRead;
+  }
+
+  PerfTimer timer;
+  for (int round = 0; round < kRounds; ++round) {
+    if (batched) {
+      SendAll(&sender, datagrams);
+      ReceiveAll(&receiver, kBatchSize, &receive_datagrams);
+      continue;
+    }
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      TestCompletionCallback callback;
+      int rv = sender.SendTo(datagrams[i].buf, kDatagramSize,
+                             receiver_address, callback.callback());
+      ASSERT_EQ(kDatagramSize, callback.GetResult(rv));
+    }
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      TestCompletionCallback callback;
+      IPEndPoint address;
+      int rv = receiver.RecvFrom(receive_datagrams[i].buf, kMaxRead,
+                                 &address, callback.callback());
+      ASSERT_EQ(kDatagramSize, callback.GetResult(rv));
+    }
+  }
+  double seconds = timer.Elapsed().InSecondsF();
+  LogPerfResult(batched ? "UDPSocket_batched_packets_per_second" :
+                          "UDPSocket_packets_per_second",
+                kRounds * kBatchSize / seconds, "packets/s");
+}
+
+// Measures how many datagrams per second go through the loopback interface,
+// one system call per datagram and batched.
+TEST(UDPSocketPerfTest, PacketsPerSecond) {
+  MeasurePacketsPerSecond(false);
+  MeasurePacketsPerSecond(true);
+}
+
+#endif  // defined(OS_POSIX)
+
+}  // namespace
+
+}  // namespace net
@@ -4,6 +4,7 @@
 
 #include "net/udp/udp_client_socket.h"
 #include "net/udp/udp_server_socket.h"
+#include "net/udp/udp_socket.h"
 
 #include "base/basictypes.h"
 #include "base/bind.h"
@@ -491,6 +492,95 @@ TEST_F(UDPSocketTest, CloseWithPendingRead) {
   EXPECT_FALSE(callback.have_result());
 }
 
+#if defined(OS_POSIX)
+
+// Binds |socket| to an ephemeral port on the loopback interface and returns
+// the bound address in |address|.
+void BindToLoopback(UDPSocket* socket, IPEndPoint* address) {
+  IPEndPoint bind_address;
+  CreateUDPAddress("127.0.0.1", 0, &bind_address);
+  ASSERT_EQ(OK, socket->Bind(bind_address));
+  ASSERT_EQ(OK, socket->GetLocalAddress(address));
+}
+
+// Sends all of |datagrams|, in as many batches as it takes.
+void SendAll(UDPSocket* socket, const std::vector<UDPDatagram>& datagrams) {
+  std::vector<UDPDatagram> remaining(datagrams);
+  while (!remaining.empty()) {
+    TestCompletionCallback callback;
+    int rv = socket->SendMultipleTo(&remaining, callback.callback());
+    if (rv == ERR_IO_PENDING)
+      rv = callback.WaitForResult();
+    ASSERT_GT(rv, 0);
+    remaining.erase(remaining.begin(), remaining.begin() + rv);
+  }
+}
+
+// Receives |count| datagrams, in as many batches as it takes, and appends
+// their contents to |messages|. |datagrams| provides the receive buffers.
+void ReceiveAll(UDPSocket* socket,
+                size_t count,
+                std::vector<UDPDatagram>* datagrams,
+                std::vector<std::string>* messages) {
+  while (count > 0) {
+    TestCompletionCallback callback;
+    int rv = socket->RecvMultipleFrom(datagrams, callback.callback());
+    if (rv == ERR_IO_PENDING)
+      rv = callback.WaitForResult();
+    ASSERT_GT(rv, 0);
+    ASSERT_LE(static_cast<size_t>(rv), count);
+    for (int i = 0; i < rv; ++i) {
+      const UDPDatagram& datagram = (*datagrams)[i];
+      ASSERT_GE(datagram.bytes_received, 0);
+      messages->push_back(
+          std::string(datagram.buf->data(), datagram.bytes_received));
+    }
+    count -= rv;
+  }
+}
+
+// Returns |count| receive datagrams with buffers of |buf_len| bytes.
+std::vector<UDPDatagram> CreateReceiveDatagrams(size_t count, int buf_len) {
+  std::vector<UDPDatagram> datagrams(count);
+  for (size_t i = 0; i < count; ++i) {
+    datagrams[i].buf = new IOBuffer(buf_len);
+    datagrams[i].buf_len = buf_len;
+  }
+  return datagrams;
+}
+
+TEST_F(UDPSocketTest, SendAndRecvMultiple) {
+  UDPSocket sender(DatagramSocket::DEFAULT_BIND, RandIntCallback(), NULL,
+                   NetLog::Source());
+  UDPSocket receiver(DatagramSocket::DEFAULT_BIND, RandIntCallback(), NULL,
+                     NetLog::Source());
+  IPEndPoint sender_address;
+  IPEndPoint receiver_address;
+  BindToLoopback(&sender, &sender_address);
+  BindToLoopback(&receiver, &receiver_address);
+
+  const char* const kMessages[] = { "first", "second", "third" };
+  std::vector<UDPDatagram> datagrams(arraysize(kMessages));
+  for (size_t i = 0; i < arraysize(kMessages); ++i) {
+    datagrams[i].buf = new StringIOBuffer(kMessages[i]);
+    datagrams[i].buf_len = strlen(kMessages[i]);
+    datagrams[i].address = receiver_address;
+  }
+  SendAll(&sender, datagrams);
+
+  // More receive buffers than datagrams, so that a batch can be partial.
+  std::vector<UDPDatagram> receive_datagrams =
+      CreateReceiveDatagrams(arraysize(kMessages) + 2, kMaxRead);
+  std::vector<std::string> messages;
+  ReceiveAll(&receiver, arraysize(kMessages), &receive_datagrams, &messages);
+  ASSERT_EQ(arraysize(kMessages), messages.size());
+  for (size_t i = 0; i < arraysize(kMessages); ++i)
+    EXPECT_EQ(kMessages[i], messages[i]);
+  EXPECT_EQ(sender_address, receive_datagrams[0].address);
+}
+
+#endif  // defined(OS_POSIX)
+
 }  // namespace
 
 }  // namespace net
@@ -119,6 +119,9 @@ int TestURLFetcher::GetMaxRetries() const {
   return fake_max_retries_;
 }
 
+void TestURLFetcher::SetMaxResumes(int max_resumes) {
+}
+
 base::TimeDelta TestURLFetcher::GetBackoffDelay() const {
   return fake_backoff_delay_;
 }
@@ -107,6 +107,7 @@ class TestURLFetcher : public URLFetcher {
   virtual void SetAutomaticallyRetryOn5xx(bool retry) OVERRIDE;
   virtual void SetMaxRetries(int max_retries) OVERRIDE;
   virtual int GetMaxRetries() const OVERRIDE;
+  virtual void SetMaxResumes(int max_resumes) OVERRIDE;
   virtual base::TimeDelta GetBackoffDelay() const OVERRIDE;
   virtual void SaveResponseToFileAtPath(
       const FilePath& file_path,
@@ -189,6 +189,12 @@ class NET_EXPORT URLFetcher {
   virtual void SetMaxRetries(int max_retries) = 0;
   virtual int GetMaxRetries() const = 0;
 
+  // If the response is saved to a file and a network error interrupts it,
+  // the rest of the response is requested with a range request, up to
+  // |max_resumes| times. Only 200 responses with a strong validator are
+  // resumed. 0 by default.
+  virtual void SetMaxResumes(int max_resumes) = 0;
+
   // Returns the back-off delay before the request will be retried,
   // when a 5xx response was received.
   virtual base::TimeDelta GetBackoffDelay() const = 0;
@@ -10,6 +10,8 @@
 #include "base/single_thread_task_runner.h"
 #include "base/metrics/histogram.h"
 #include "base/stl_util.h"
+#include "base/string_number_conversions.h"
+#include "base/string_util.h"
 #include "base/thread_task_runner_handle.h"
 #include "base/tracked_objects.h"
 #include "net/base/io_buffer.h"
@@ -24,6 +26,9 @@
 namespace {
 
 const int kBufferSize = 4096;
+// Responses saved to a file are read in larger chunks, since every read is
+// followed by a write on the file thread.
+const int kFileBufferSize = 64 * 1024;
 const int kUploadProgressTimerInterval = 100;
 bool g_interception_enabled = false;
 
@@ -61,7 +66,12 @@ URLFetcherCore::FileWriter::FileWriter(
       error_code_(base::PLATFORM_FILE_OK),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)),
       file_task_runner_(file_task_runner),
-      file_handle_(base::kInvalidPlatformFileValue) {
+      file_handle_(base::kInvalidPlatformFileValue),
+      total_bytes_written_(0),
+      pending_bytes_(0),
+      buffer_offset_(0),
+      queued_bytes_(0),
+      close_pending_(false) {
 }
 
 URLFetcherCore::FileWriter::~FileWriter() {
@@ -91,15 +101,65 @@ void URLFetcherCore::FileWriter::CreateTempFile() {
                  weak_factory_.GetWeakPtr()));
 }
 
-void URLFetcherCore::FileWriter::WriteBuffer(int num_bytes) {
+void URLFetcherCore::FileWriter::ReopenFileForResume() {
   DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
+  DCHECK_EQ(base::kInvalidPlatformFileValue, file_handle_);
+  DCHECK(!file_path_.empty());
+  base::FileUtilProxy::CreateOrOpen(
+      file_task_runner_,
+      file_path_,
+      base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_WRITE,
+      base::Bind(&URLFetcherCore::FileWriter::DidReopenFile,
+                 weak_factory_.GetWeakPtr()));
+}
+
+bool URLFetcherCore::FileWriter::WriteBuffer(int num_bytes) {
+  DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
+  DCHECK_EQ(0, queued_bytes_);
 
-  // Start writing to the file by setting the initial state
-  // of |pending_bytes_| and |buffer_offset_| to indicate that the
-  // entire buffer has not yet been written.
+  if (file_handle_ == base::kInvalidPlatformFileValue) {
+    // A file operation failed and the delegate has been told. Stop reading.
+    return false;
+  }
+
+  if (write_buffer_) {
+    // Leave the bytes in |core_->buffer_| until the write in progress is
+    // done.
+    queued_bytes_ = num_bytes;
+    return false;
+  }
+
+  // Write |core_->buffer_| and give the core another buffer to read into.
+  write_buffer_ = core_->buffer_;
+  if (spare_buffer_) {
+    core_->buffer_ = spare_buffer_;
+    spare_buffer_ = NULL;
+  } else {
+    core_->buffer_ = new IOBuffer(core_->buffer_size_);
+  }
   pending_bytes_ = num_bytes;
   buffer_offset_ = 0;
-  ContinueWrite(base::PLATFORM_FILE_OK, 0);
+  StartWrite();
+  return true;
+}
+
+void URLFetcherCore::FileWriter::DiscardWrittenBytes() {
+  DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
+  DCHECK(!write_buffer_);
+  total_bytes_written_ = 0;
+  if (file_handle_ != base::kInvalidPlatformFileValue) {
+    base::FileUtilProxy::Truncate(file_task_runner_, file_handle_, 0,
+                                  base::FileUtilProxy::StatusCallback());
+  }
+}
+
+void URLFetcherCore::FileWriter::StartWrite() {
+  base::FileUtilProxy::Write(
+      file_task_runner_, file_handle_,
+      total_bytes_written_,  // Append to the end
+      (write_buffer_->data() + buffer_offset_), pending_bytes_,
+      base::Bind(&URLFetcherCore::FileWriter::ContinueWrite,
+                 weak_factory_.GetWeakPtr()));
 }
 
 void URLFetcherCore::FileWriter::ContinueWrite(
@@ -115,19 +175,8 @@ void URLFetcherCore::FileWriter::ContinueWrite(
     return;
   }
 
-  // Every code path that resets |core_->request_| should reset
-  // |core->file_writer_| or cause the file writer to disown the file.  In the
-  // former case, this callback can not be called, because the weak pointer to
-  // |this| will be NULL. In the latter case, the check of |file_handle_| at the
-  // start of this method ensures that we can not reach this point.
-  CHECK(core_->request_.get());
-
   if (base::PLATFORM_FILE_OK != error_code) {
-    error_code_ = error_code;
-    CloseAndDeleteFile();
-    core_->delegate_task_runner_->PostTask(
-        FROM_HERE,
-        base::Bind(&URLFetcherCore::InformDelegateFetchIsComplete, core_));
+    OnFileError(error_code);
     return;
   }
 
@@ -136,15 +185,28 @@ void URLFetcherCore::FileWriter::ContinueWrite(
   pending_bytes_ -= bytes_written;
 
   if (pending_bytes_ > 0) {
-    base::FileUtilProxy::Write(
-        file_task_runner_, file_handle_,
-        total_bytes_written_,  // Append to the end
-        (core_->buffer_->data() + buffer_offset_), pending_bytes_,
-        base::Bind(&URLFetcherCore::FileWriter::ContinueWrite,
-                   weak_factory_.GetWeakPtr()));
-  } else {
-    // Finished writing core_->buffer_ to the file. Read some more.
+    StartWrite();
+    return;
+  }
+
+  // Finished writing |write_buffer_|, which becomes the spare buffer.
+  core_->InformDelegateFileDataWritten(total_bytes_written_);
+  spare_buffer_.swap(write_buffer_);
+  write_buffer_ = NULL;
+
+  if (queued_bytes_ > 0) {
+    // The core is waiting for its buffer to be taken before reading more.
+    // Every code path that resets |core_->request_| either waits for the
+    // writes to finish or resets |core_->file_writer_|, so the request must
+    // still be there.
+    CHECK(core_->request_.get());
+    int num_bytes = queued_bytes_;
+    queued_bytes_ = 0;
+    WriteBuffer(num_bytes);
     core_->ReadResponse();
+  } else if (close_pending_) {
+    close_pending_ = false;
+    CloseFileAndCompleteRequest();
   }
 }
 
@@ -162,6 +224,12 @@ void URLFetcherCore::FileWriter::DisownFile() {
 void URLFetcherCore::FileWriter::CloseFileAndCompleteRequest() {
   DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
 
+  if (write_buffer_) {
+    // ContinueWrite() closes the file once the last write is done.
+    close_pending_ = true;
+    return;
+  }
+
   if (file_handle_ != base::kInvalidPlatformFileValue) {
     base::FileUtilProxy::Close(
         file_task_runner_, file_handle_,
@@ -174,6 +242,10 @@ void URLFetcherCore::FileWriter::CloseFileAndCompleteRequest() {
 void URLFetcherCore::FileWriter::CloseAndDeleteFile() {
   DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
 
+  write_buffer_ = NULL;
+  queued_bytes_ = 0;
+  close_pending_ = false;
+
   if (file_handle_ == base::kInvalidPlatformFileValue) {
     DeleteFile(base::PLATFORM_FILE_OK);
     return;
@@ -221,11 +293,7 @@ void URLFetcherCore::FileWriter::DidCreateFileInternal(
   DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
 
   if (base::PLATFORM_FILE_OK != error_code) {
-    error_code_ = error_code;
-    CloseAndDeleteFile();
-    core_->delegate_task_runner_->PostTask(
-        FROM_HERE,
-        base::Bind(&URLFetcherCore::InformDelegateFetchIsComplete, core_));
+    OnFileError(error_code);
     return;
   }
 
@@ -238,16 +306,41 @@ void URLFetcherCore::FileWriter::DidCreateFileInternal(
       base::Bind(&URLFetcherCore::StartURLRequestWhenAppropriate, core_));
 }
 
+void URLFetcherCore::FileWriter::DidReopenFile(
+    base::PlatformFileError error_code,
+    base::PassPlatformFile file_handle,
+    bool created) {
+  DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
+
+  if (base::PLATFORM_FILE_OK != error_code) {
+    OnFileError(error_code);
+    return;
+  }
+
+  // Keep |total_bytes_written_|, so that the rest of the response is
+  // appended to what was written before.
+  file_handle_ = file_handle.ReleaseValue();
+
+  core_->network_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&URLFetcherCore::StartURLRequestWhenAppropriate, core_));
+}
+
+void URLFetcherCore::FileWriter::OnFileError(
+    base::PlatformFileError error_code) {
+  error_code_ = error_code;
+  CloseAndDeleteFile();
+  core_->delegate_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&URLFetcherCore::InformDelegateFetchIsComplete, core_));
+}
+
 void URLFetcherCore::FileWriter::DidCloseFile(
     base::PlatformFileError error_code) {
   DCHECK(core_->network_task_runner_->BelongsToCurrentThread());
 
   if (base::PLATFORM_FILE_OK != error_code) {
-    error_code_ = error_code;
-    CloseAndDeleteFile();
-    core_->delegate_task_runner_->PostTask(
-        FROM_HERE,
-        base::Bind(&URLFetcherCore::InformDelegateFetchIsComplete, core_));
+    OnFileError(error_code);
     return;
   }
 
@@ -276,12 +369,16 @@ URLFetcherCore::URLFetcherCore(URLFetcher* fetcher,
       load_flags_(LOAD_NORMAL),
       response_code_(URLFetcher::RESPONSE_CODE_INVALID),
       buffer_(new IOBuffer(kBufferSize)),
+      buffer_size_(kBufferSize),
       url_request_data_key_(NULL),
       was_fetched_via_proxy_(false),
       is_chunked_upload_(false),
       num_retries_(0),
       was_cancelled_(false),
       response_destination_(STRING),
+      max_resumes_(0),
+      num_resumes_(0),
+      resume_offset_(0),
       stop_on_redirect_(false),
       stopped_on_redirect_(false),
       automatically_retry_on_5xx_(true),
@@ -414,6 +511,10 @@ int URLFetcherCore::GetMaxRetries() const {
   return max_retries_;
 }
 
+void URLFetcherCore::SetMaxResumes(int max_resumes) {
+  max_resumes_ = max_resumes;
+}
+
 base::TimeDelta URLFetcherCore::GetBackoffDelay() const {
   return backoff_delay_;
 }
@@ -542,11 +643,32 @@ void URLFetcherCore::OnResponseStarted(URLRequest* request) {
   DCHECK_EQ(request, request_.get());
   DCHECK(network_task_runner_->BelongsToCurrentThread());
   if (request_->status().is_success()) {
+    if (resume_offset_ > 0) {
+      // Keep the response code and headers of the interrupted response if
+      // the server sent the rest of it.
+      int64 first_byte_position = -1;
+      int64 last_byte_position = -1;
+      int64 instance_length = -1;
+      if (request_->GetResponseCode() == 206 &&
+          request_->response_headers()->GetContentRange(
+              &first_byte_position, &last_byte_position, &instance_length) &&
+          first_byte_position == resume_offset_) {
+        current_response_bytes_ = resume_offset_;
+        total_response_bytes_ = instance_length;
+        ReadResponse();
+        return;
+      }
+      // Otherwise this is a new response, which replaces what was saved.
+      file_writer_->DiscardWrittenBytes();
+      resume_offset_ = 0;
+    }
     response_code_ = request_->GetResponseCode();
     response_headers_ = request_->response_headers();
     socket_address_ = request_->GetSocketAddress();
     was_fetched_via_proxy_ = request_->was_fetched_via_proxy();
     total_response_bytes_ = request_->GetExpectedContentSize();
+    if (file_writer_.get())
+      SaveResumeValidator();
   }
 
   ReadResponse();
@@ -580,7 +702,7 @@ void URLFetcherCore::OnReadCompleted(URLRequest* request,
       waiting_on_write = true;
       break;
     }
-  } while (request_->Read(buffer_, kBufferSize, &bytes_read));
+  } while (request_->Read(buffer_, buffer_size_, &bytes_read));
 
   const URLRequestStatus status = request_->status();
 
@@ -626,6 +748,8 @@ URLFetcherCore::~URLFetcherCore() {
 void URLFetcherCore::StartOnIOThread() {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
 
+  resume_offset_ = 0;
+  resume_validator_.clear();
   switch (response_destination_) {
     case STRING:
       StartURLRequestWhenAppropriate();
@@ -637,6 +761,10 @@ void URLFetcherCore::StartOnIOThread() {
           << "Need to set the file task runner.";
 
       file_writer_.reset(new FileWriter(this, file_task_runner_));
+      if (buffer_size_ != kFileBufferSize) {
+        buffer_size_ = kFileBufferSize;
+        buffer_ = new IOBuffer(buffer_size_);
+      }
 
       // If the file is successfully created,
       // URLFetcherCore::StartURLRequestWhenAppropriate() will be called.
@@ -730,15 +858,27 @@ void URLFetcherCore::StartURLRequest() {
       NOTREACHED();
   }
 
-  if (!extra_request_headers_.IsEmpty())
+  if (resume_offset_ > 0) {
+    // Ask for the rest of the interrupted response, or for all of it if it
+    // has changed since.
+    HttpRequestHeaders headers;
+    headers.CopyFrom(extra_request_headers_);
+    headers.SetHeader(HttpRequestHeaders::kRange,
+                      "bytes=" + base::Int64ToString(resume_offset_) + "-");
+    headers.SetHeader(HttpRequestHeaders::kIfRange, resume_validator_);
+    request_->SetExtraRequestHeaders(headers);
+  } else if (!extra_request_headers_.IsEmpty()) {
     request_->SetExtraRequestHeaders(extra_request_headers_);
+  }
 
   // There might be data left over from a previous request attempt.
   data_.clear();
 
   // If we are writing the response to a file, the only caller
-  // of this function should have created it and not written yet.
-  DCHECK(!file_writer_.get() || file_writer_->total_bytes_written() == 0);
+  // of this function should have created it and not written yet, unless
+  // the response is being resumed.
+  DCHECK(!file_writer_.get() ||
+         file_writer_->total_bytes_written() == resume_offset_);
 
   request_->Start();
 }
@@ -830,6 +970,14 @@ void URLFetcherCore::RetryOrCompleteUrlFetch() {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
   base::TimeDelta backoff_delay;
 
+  if (ShouldResumeFileDownload()) {
+    // Ask for the rest of the response once the file is open again.
+    ++num_resumes_;
+    resume_offset_ = file_writer_->total_bytes_written();
+    file_writer_->ReopenFileForResume();
+    return;
+  }
+
   // Checks the response from server.
   if (response_code_ >= 500 ||
       status_.error() == ERR_TEMPORARILY_THROTTLED) {
@@ -941,7 +1089,7 @@ void URLFetcherCore::ReadResponse() {
   int bytes_read = 0;
   if (request_->status().is_success() &&
       (request_type_ != URLFetcher::HEAD))
-    request_->Read(buffer_, kBufferSize, &bytes_read);
+    request_->Read(buffer_, buffer_size_, &bytes_read);
   OnReadCompleted(request_.get(), bytes_read);
 }
 
@@ -949,6 +1097,34 @@ void URLFetcherCore::DisownFile() {
   file_writer_->DisownFile();
 }
 
+bool URLFetcherCore::ShouldResumeFileDownload() const {
+  return file_writer_.get() && !was_cancelled_ &&
+      status_.status() == URLRequestStatus::FAILED &&
+      num_resumes_ < max_resumes_ && response_code_ == 200 &&
+      !resume_validator_.empty() &&
+      file_writer_->total_bytes_written() > 0;
+}
+
+void URLFetcherCore::SaveResumeValidator() {
+  resume_validator_.clear();
+  if (response_code_ != 200 || !response_headers_)
+    return;
+
+  // A weak ETag cannot be used in If-Range.
+  std::string etag;
+  if (response_headers_->EnumerateHeader(NULL, "etag", &etag) &&
+      !StartsWithASCII(etag, "w/", false)) {
+    resume_validator_ = etag;
+    return;
+  }
+  std::string last_modified;
+  if (response_headers_->HasStrongValidators() &&
+      response_headers_->EnumerateHeader(NULL, "last-modified",
+                                         &last_modified)) {
+    resume_validator_ = last_modified;
+  }
+}
+
 void URLFetcherCore::InformDelegateUploadProgress() {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
   if (request_.get()) {
@@ -1003,6 +1179,22 @@ void URLFetcherCore::InformDelegateDownloadDataIfNecessary(int bytes_read) {
   }
 }
 
+void URLFetcherCore::InformDelegateFileDataWritten(int64 bytes_written) {
+  DCHECK(network_task_runner_->BelongsToCurrentThread());
+  delegate_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(
+          &URLFetcherCore::InformDelegateFileDataWrittenInDelegateThread,
+          this, file_writer_->file_path(), bytes_written));
+}
+
+void URLFetcherCore::InformDelegateFileDataWrittenInDelegateThread(
+    const FilePath& file_path, int64 bytes_written) {
+  DCHECK(delegate_task_runner_->BelongsToCurrentThread());
+  if (delegate_)
+    delegate_->OnURLFetchFileDataWritten(fetcher_, file_path, bytes_written);
+}
+
 void URLFetcherCore::InformDelegateDownloadDataInDelegateThread(
     scoped_ptr<std::string> download_data) {
   DCHECK(delegate_task_runner_->BelongsToCurrentThread());
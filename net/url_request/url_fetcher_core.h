@@ -88,6 +88,7 @@ class URLFetcherCore
   void SetAutomaticallyRetryOn5xx(bool retry);
   void SetMaxRetries(int max_retries);
   int GetMaxRetries() const;
+  void SetMaxResumes(int max_resumes);
   base::TimeDelta GetBackoffDelay() const;
   void SaveResponseToFileAtPath(
       const FilePath& file_path,
@@ -164,6 +165,9 @@ class URLFetcherCore
   // instance of FileWriter is owned by a URLFetcherCore, which
   // manages its lifetime and never transfers ownership. All file operations
   // happen on |file_task_runner_|.
+  //
+  // Writes are pipelined with reads: while one buffer is being written, the
+  // next read goes into another one.
   class FileWriter {
    public:
     FileWriter(URLFetcherCore* core,
@@ -173,18 +177,26 @@ class URLFetcherCore
     void CreateFileAtPath(const FilePath& file_path);
     void CreateTempFile();
 
-    // Record |num_bytes_| response bytes in |core_->buffer_| to the file.
-    void WriteBuffer(int num_bytes);
+    // Reopens the file at |file_path_| to append the rest of a response
+    // whose request failed after |total_bytes_written_| bytes.
+    void ReopenFileForResume();
 
-    // Called when a write has been done.  Continues writing if there are
-    // any more bytes to write.  Otherwise, initiates a read in core_.
-    void ContinueWrite(base::PlatformFileError error_code, int bytes_written);
+    // Starts writing |num_bytes| response bytes in |core_->buffer_| to the
+    // file. Returns true if |core_->buffer_| was swapped with a free buffer,
+    // so that reading can go on while the write is in progress. Returns false
+    // if the bytes must wait for the previous write, in which case
+    // |core_->ReadResponse()| is called once they are being written.
+    bool WriteBuffer(int num_bytes);
+
+    // Discards the bytes written so far, so that the response starts again
+    // at the beginning of the file.
+    void DiscardWrittenBytes();
 
     // Drop ownership of the file at |file_path_|.
     // This class will not delete it or write to it again.
     void DisownFile();
 
-    // Close the file if it is open.
+    // Close the file if it is open, once all the pending writes are done.
     void CloseFileAndCompleteRequest();
 
     // Close the file if it is open and then delete it.
@@ -208,6 +220,19 @@ class URLFetcherCore
     void DidCreateFileInternal(const FilePath& file_path,
                                base::PlatformFileError error_code,
                                base::PassPlatformFile file_handle);
+    // Callback which gets the result of reopening the file to resume.
+    void DidReopenFile(base::PlatformFileError error_code,
+                       base::PassPlatformFile file_handle,
+                       bool created);
+
+    // Writes the unwritten part of |write_buffer_|.
+    void StartWrite();
+
+    // Callback which gets the result of a write.
+    void ContinueWrite(base::PlatformFileError error_code, int bytes_written);
+
+    // Records a failed file operation and completes the request.
+    void OnFileError(base::PlatformFileError error_code);
 
     // Callback which gets the result of closing the file.
     void DidCloseFile(base::PlatformFileError error);
@@ -239,7 +264,13 @@ class URLFetcherCore
     // written, so that writes know the offset to give.
     int64 total_bytes_written_;
 
-    // How many bytes did the last Write() try to write?  Needed so
+    // The buffer being written, or NULL if no write is in progress.
+    scoped_refptr<IOBuffer> write_buffer_;
+
+    // A free buffer to swap with |core_->buffer_|, or NULL if none.
+    scoped_refptr<IOBuffer> spare_buffer_;
+
+    // How many bytes of |write_buffer_| are left to write?  Needed so
     // that if not all the bytes get written on a Write(), we can
     // call Write() again with the rest.
     int pending_bytes_;
@@ -247,6 +278,13 @@ class URLFetcherCore
     // When writing, how many bytes from the buffer have been successfully
     // written so far?
     int buffer_offset_;
+
+    // The number of bytes in |core_->buffer_| waiting for the write in
+    // progress to finish, or 0 if none.
+    int queued_bytes_;
+
+    // True if the file must be closed once the write in progress is done.
+    bool close_pending_;
   };
 
   virtual ~URLFetcherCore();
@@ -286,6 +324,14 @@ class URLFetcherCore
   // Drop ownership of any file managed by |file_path_|.
   void DisownFile();
 
+  // Returns true if a response being saved to a file was cut short by a
+  // network error and can be resumed with a range request.
+  bool ShouldResumeFileDownload() const;
+
+  // Remembers a validator of the response being saved to a file, so that
+  // the response can be resumed if it is interrupted.
+  void SaveResumeValidator();
+
   // Notify Delegate about the progress of upload/download.
   void InformDelegateUploadProgress();
   void InformDelegateUploadProgressInDelegateThread(int64 current, int64 total);
@@ -295,6 +341,9 @@ class URLFetcherCore
   void InformDelegateDownloadDataIfNecessary(int bytes_read);
   void InformDelegateDownloadDataInDelegateThread(
       scoped_ptr<std::string> download_data);
+  void InformDelegateFileDataWritten(int64 bytes_written);
+  void InformDelegateFileDataWrittenInDelegateThread(const FilePath& file_path,
+                                                     int64 bytes_written);
 
   URLFetcher* fetcher_;              // Corresponding fetcher object
   GURL original_url_;                // The URL we were asked to fetch
@@ -316,6 +365,7 @@ class URLFetcherCore
                                      // storing the response as a string.
   scoped_refptr<IOBuffer> buffer_;
                                      // Read buffer
+  int buffer_size_;                  // Size of |buffer_|
   scoped_refptr<URLRequestContextGetter> request_context_getter_;
                                      // Cookie/cache info for the request
   GURL first_party_for_cookies_;     // The first party URL for the request
@@ -370,6 +420,16 @@ class URLFetcherCore
   // Path to the file where the response is written.
   FilePath response_destination_file_path_;
 
+  // How many times a response saved to a file may be resumed with a range
+  // request after a network error, and how many times it has been.
+  int max_resumes_;
+  int num_resumes_;
+  // The offset at which the current request resumes the response, or 0.
+  int64 resume_offset_;
+  // The strong ETag or Last-Modified date of the response, sent in If-Range
+  // when resuming. Empty if the response cannot be resumed.
+  std::string resume_validator_;
+
   // By default any server-initiated redirects are automatically followed.  If
   // this flag is set to true, however, a redirect will halt the fetch and call
   // back to to the delegate immediately.
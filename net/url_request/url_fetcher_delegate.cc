@@ -19,6 +19,10 @@ bool URLFetcherDelegate::ShouldSendDownloadData() {
   return false;
 }
 
+void URLFetcherDelegate::OnURLFetchFileDataWritten(
+    const URLFetcher* source, const FilePath& file_path,
+    int64 bytes_written) {}
+
 URLFetcherDelegate::~URLFetcherDelegate() {}
 
 }  // namespace net
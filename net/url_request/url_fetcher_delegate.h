@@ -11,6 +11,8 @@
 #include "base/memory/scoped_ptr.h"
 #include "net/base/net_export.h"
 
+class FilePath;
+
 namespace net {
 
 class URLFetcher;
@@ -41,6 +43,15 @@ class NET_EXPORT URLFetcherDelegate {
   // Default implementation is false.
   virtual bool ShouldSendDownloadData();
 
+  // This will be called when the response is saved to a file and more of it
+  // has been written to |file_path|. The first |bytes_written| bytes of the
+  // file hold the response so far and can be read before the fetch
+  // completes. |bytes_written| goes back to 0 if a resumed response has to
+  // be fetched again from the start.
+  virtual void OnURLFetchFileDataWritten(const URLFetcher* source,
+                                         const FilePath& file_path,
+                                         int64 bytes_written);
+
   // This will be called when uploading of POST or PUT requests proceeded.
   // |current| denotes the number of bytes sent so far, and |total| is the
   // total size of uploading data (or -1 if chunked upload is enabled).
@@ -97,6 +97,10 @@ int URLFetcherImpl::GetMaxRetries() const {
   return core_->GetMaxRetries();
 }
 
+void URLFetcherImpl::SetMaxResumes(int max_resumes) {
+  core_->SetMaxResumes(max_resumes);
+}
+
 
 base::TimeDelta URLFetcherImpl::GetBackoffDelay() const {
   return core_->GetBackoffDelay();
@@ -381,13 +381,17 @@ class URLFetcherMultipleAttemptTest : public URLFetcherTest {
 class URLFetcherFileTest : public URLFetcherTest {
  public:
   URLFetcherFileTest() : take_ownership_of_file_(false),
-                         expected_file_error_(base::PLATFORM_FILE_OK) {}
+                         expected_file_error_(base::PLATFORM_FILE_OK),
+                         bytes_written_(0) {}
 
   void CreateFetcherForFile(const GURL& url, const FilePath& file_path);
   void CreateFetcherForTempFile(const GURL& url);
 
   // URLFetcherDelegate
   virtual void OnURLFetchComplete(const URLFetcher* source) OVERRIDE;
+  virtual void OnURLFetchFileDataWritten(const URLFetcher* source,
+                                         const FilePath& file_path,
+                                         int64 bytes_written) OVERRIDE;
 
  protected:
   FilePath expected_file_;
@@ -401,6 +405,10 @@ class URLFetcherFileTest : public URLFetcherTest {
   // Expected file error code for the test.
   // PLATFORM_FILE_OK when expecting success.
   base::PlatformFileError expected_file_error_;
+
+  // The file and byte count last reported by OnURLFetchFileDataWritten().
+  FilePath written_file_path_;
+  int64 bytes_written_;
 };
 
 void URLFetcherPostTest::CreateFetcher(const GURL& url) {
@@ -733,6 +741,13 @@ void URLFetcherFileTest::OnURLFetchComplete(const URLFetcher* source) {
         take_ownership_of_file_, &file_path_));
 
     EXPECT_TRUE(file_util::ContentsEqual(expected_file_, file_path_));
+
+    // All of the response was reported as written before completion.
+    int64 file_size = 0;
+    EXPECT_TRUE(file_util::GetFileSize(file_path_, &file_size));
+    EXPECT_EQ(file_size, bytes_written_);
+    if (bytes_written_ > 0)
+      EXPECT_EQ(file_path_.value(), written_file_path_.value());
   } else {
     base::PlatformFileError error_code = base::PLATFORM_FILE_OK;
     EXPECT_TRUE(fetcher_->FileErrorOccurred(&error_code));
@@ -741,6 +756,14 @@ void URLFetcherFileTest::OnURLFetchComplete(const URLFetcher* source) {
   CleanupAfterFetchComplete();
 }
 
+void URLFetcherFileTest::OnURLFetchFileDataWritten(const URLFetcher* source,
+                                                   const FilePath& file_path,
+                                                   int64 bytes_written) {
+  EXPECT_GT(bytes_written, bytes_written_);
+  written_file_path_ = file_path;
+  bytes_written_ = bytes_written;
+}
+
 TEST_F(URLFetcherTest, SameThreadsTest) {
   TestServer test_server(TestServer::TYPE_HTTP,
                          TestServer::kLocalhost,
@@ -0,0 +1,177 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/websockets/websocket_deflater.h"
+
+#if defined(USE_SYSTEM_ZLIB)
+#include <zlib.h>
+#else
+#include "third_party/zlib/zlib.h"
+#endif
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "net/base/io_buffer.h"
+
+namespace {
+
+// The empty stored block that ends the output of a sync flush.
+const char kTrailer[] = "\x00\x00\xFF\xFF";
+const size_t kTrailerSize = arraysize(kTrailer) - 1;
+
+// The size of the buffer zlib writes its output to before it is appended to
+// the output of a deflater or inflater.
+const size_t kFixedBufferSize = 4096;
+
+// zlib's default, which needs 2^(memLevel + 9) bytes of compression state.
+const int kMemLevel = 8;
+
+// Removes up to |size| bytes from the front of |output| and returns them.
+scoped_refptr<net::IOBufferWithSize> TakeOutput(std::vector<char>* output,
+                                                size_t size) {
+  size = std::min(size, output->size());
+  scoped_refptr<net::IOBufferWithSize> buffer(
+      new net::IOBufferWithSize(size));
+  if (size) {
+    std::copy(output->begin(), output->begin() + size, buffer->data());
+    output->erase(output->begin(), output->begin() + size);
+  }
+  return buffer;
+}
+
+}  // namespace
+
+namespace net {
+
+WebSocketDeflater::WebSocketDeflater(ContextTakeOverMode mode)
+    : mode_(mode) {
+}
+
+WebSocketDeflater::~WebSocketDeflater() {
+  if (stream_.get())
+    deflateEnd(stream_.get());
+}
+
+bool WebSocketDeflater::Initialize(int window_bits) {
+  DCHECK(!stream_.get());
+  DCHECK_LE(kMinWindowBits, window_bits);
+  DCHECK_GE(kMaxWindowBits, window_bits);
+  stream_.reset(new z_stream);
+  memset(stream_.get(), 0, sizeof(z_stream));
+
+  // A negative |windowBits| makes zlib write raw DEFLATE data without a zlib
+  // header or checksum.
+  int result = deflateInit2(stream_.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                            -window_bits, kMemLevel, Z_DEFAULT_STRATEGY);
+  if (result != Z_OK) {
+    stream_.reset();
+    return false;
+  }
+  fixed_buffer_.resize(kFixedBufferSize);
+  return true;
+}
+
+bool WebSocketDeflater::AddBytes(const char* data, size_t size) {
+  DCHECK(stream_.get());
+  if (!size)
+    return true;
+
+  stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream_->avail_in = size;
+  return Deflate(Z_NO_FLUSH);
+}
+
+bool WebSocketDeflater::Finish() {
+  DCHECK(stream_.get());
+  stream_->next_in = NULL;
+  stream_->avail_in = 0;
+  if (!Deflate(Z_SYNC_FLUSH))
+    return false;
+
+  // The sync flush always ends with an empty stored block, which the peer
+  // puts back before decompressing.
+  DCHECK_GE(output_.size(), kTrailerSize);
+  DCHECK(std::equal(kTrailer, kTrailer + kTrailerSize,
+                    output_.end() - kTrailerSize));
+  output_.resize(output_.size() - kTrailerSize);
+
+  if (mode_ == DO_NOT_TAKE_OVER_CONTEXT)
+    return deflateReset(stream_.get()) == Z_OK;
+  return true;
+}
+
+scoped_refptr<IOBufferWithSize> WebSocketDeflater::GetOutput(size_t size) {
+  return TakeOutput(&output_, size);
+}
+
+bool WebSocketDeflater::Deflate(int flush) {
+  do {
+    stream_->next_out = reinterpret_cast<Bytef*>(&fixed_buffer_[0]);
+    stream_->avail_out = fixed_buffer_.size();
+    int result = deflate(stream_.get(), flush);
+    // Z_BUF_ERROR only means no progress was possible, which happens when
+    // the previous round filled the output buffer exactly.
+    if (result != Z_OK && result != Z_BUF_ERROR)
+      return false;
+    output_.insert(output_.end(), fixed_buffer_.begin(),
+                   fixed_buffer_.end() - stream_->avail_out);
+  } while (stream_->avail_in > 0 || stream_->avail_out == 0);
+  return true;
+}
+
+WebSocketInflater::WebSocketInflater() {
+}
+
+WebSocketInflater::~WebSocketInflater() {
+  if (stream_.get())
+    inflateEnd(stream_.get());
+}
+
+bool WebSocketInflater::Initialize(int window_bits) {
+  DCHECK(!stream_.get());
+  DCHECK_LE(WebSocketDeflater::kMinWindowBits, window_bits);
+  DCHECK_GE(WebSocketDeflater::kMaxWindowBits, window_bits);
+  stream_.reset(new z_stream);
+  memset(stream_.get(), 0, sizeof(z_stream));
+
+  int result = inflateInit2(stream_.get(), -window_bits);
+  if (result != Z_OK) {
+    stream_.reset();
+    return false;
+  }
+  fixed_buffer_.resize(kFixedBufferSize);
+  return true;
+}
+
+bool WebSocketInflater::AddBytes(const char* data, size_t size) {
+  DCHECK(stream_.get());
+  if (!size)
+    return true;
+
+  stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream_->avail_in = size;
+  do {
+    stream_->next_out = reinterpret_cast<Bytef*>(&fixed_buffer_[0]);
+    stream_->avail_out = fixed_buffer_.size();
+    int result = inflate(stream_.get(), Z_SYNC_FLUSH);
+    // The peer never ends the DEFLATE stream, so Z_STREAM_END means the data
+    // is corrupt as much as Z_DATA_ERROR does.
+    if (result != Z_OK && result != Z_BUF_ERROR)
+      return false;
+    output_.insert(output_.end(), fixed_buffer_.begin(),
+                   fixed_buffer_.end() - stream_->avail_out);
+  } while (stream_->avail_in > 0 || stream_->avail_out == 0);
+  return true;
+}
+
+bool WebSocketInflater::Finish() {
+  return AddBytes(kTrailer, kTrailerSize);
+}
+
+scoped_refptr<IOBufferWithSize> WebSocketInflater::GetOutput(size_t size) {
+  return TakeOutput(&output_, size);
+}
+
+}  // namespace net
@@ -0,0 +1,123 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// WebSocketDeflater and WebSocketInflater compress and decompress WebSocket
+// message payloads for the permessage-deflate extension. Each message is
+// compressed as raw DEFLATE data ended with a sync flush, and the empty stored
+// block the sync flush produces (0x00 0x00 0xFF 0xFF) is removed from the end
+// of the message on the wire.
+//
+// The zlib context of each object is reused for every message of a
+// connection. Its memory use is bounded by the sliding window size, which is
+// negotiated in the handshake (see WebSocketDeflateParameters in
+// websocket_handshake_handler.h).
+
+#ifndef NET_WEBSOCKETS_WEBSOCKET_DEFLATER_H_
+#define NET_WEBSOCKETS_WEBSOCKET_DEFLATER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/base/net_export.h"
+
+typedef struct z_stream_s z_stream;
+
+namespace net {
+
+class IOBufferWithSize;
+
+class NET_EXPORT_PRIVATE WebSocketDeflater {
+ public:
+  enum ContextTakeOverMode {
+    // The zlib context is reset after every message, so that each message
+    // can be decompressed on its own.
+    DO_NOT_TAKE_OVER_CONTEXT,
+    // The sliding window is kept across messages, which compresses similar
+    // messages much better.
+    TAKE_OVER_CONTEXT
+  };
+
+  // The range of sliding window sizes, as the base-two logarithm of the
+  // window size. zlib can not make raw DEFLATE data with a 256-byte window,
+  // so 9 is the smallest size we support.
+  enum {
+    kMinWindowBits = 9,
+    kMaxWindowBits = 15
+  };
+
+  explicit WebSocketDeflater(ContextTakeOverMode mode);
+  ~WebSocketDeflater();
+
+  // Sets up the zlib context with a sliding window of 2^|window_bits| bytes.
+  // Must be called before any other method. Returns false on failure.
+  bool Initialize(int window_bits);
+
+  // Compresses |size| bytes of |data| as part of the current message.
+  // Returns false on failure.
+  bool AddBytes(const char* data, size_t size);
+
+  // Ends the current message. Once this returns, the output holds the whole
+  // compressed message. Returns false on failure.
+  bool Finish();
+
+  // Returns up to |size| bytes of compressed output and removes them from
+  // the output.
+  scoped_refptr<IOBufferWithSize> GetOutput(size_t size);
+
+  // Returns the number of bytes of compressed output waiting to be taken by
+  // GetOutput().
+  size_t CurrentOutputSize() const { return output_.size(); }
+
+ private:
+  // Runs deflate() with |flush| until it has consumed all of its input and
+  // has no more output to give.
+  bool Deflate(int flush);
+
+  const ContextTakeOverMode mode_;
+  scoped_ptr<z_stream> stream_;
+  std::vector<char> output_;
+  std::vector<char> fixed_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketDeflater);
+};
+
+class NET_EXPORT_PRIVATE WebSocketInflater {
+ public:
+  WebSocketInflater();
+  ~WebSocketInflater();
+
+  // Sets up the zlib context with a sliding window of 2^|window_bits| bytes,
+  // which must be at least as large as the window the peer compresses with.
+  // Must be called before any other method. Returns false on failure.
+  bool Initialize(int window_bits);
+
+  // Decompresses |size| bytes of |data| from the current message. Returns
+  // false if the data is corrupt.
+  bool AddBytes(const char* data, size_t size);
+
+  // Ends the current message by decompressing the empty stored block that
+  // was removed from its end. Returns false if the data is corrupt.
+  bool Finish();
+
+  // Returns up to |size| bytes of decompressed output and removes them from
+  // the output.
+  scoped_refptr<IOBufferWithSize> GetOutput(size_t size);
+
+  // Returns the number of bytes of decompressed output waiting to be taken
+  // by GetOutput().
+  size_t CurrentOutputSize() const { return output_.size(); }
+
+ private:
+  scoped_ptr<z_stream> stream_;
+  std::vector<char> output_;
+  std::vector<char> fixed_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketInflater);
+};
+
+}  // namespace net
+
+#endif  // NET_WEBSOCKETS_WEBSOCKET_DEFLATER_H_
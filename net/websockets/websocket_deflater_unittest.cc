@@ -0,0 +1,127 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/websockets/websocket_deflater.h"
+
+#include <string>
+
+#include "base/memory/ref_counted.h"
+#include "net/base/io_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+std::string ToString(IOBufferWithSize* buffer) {
+  return std::string(buffer->data(), buffer->size());
+}
+
+std::string TakeAllOutput(WebSocketDeflater* deflater) {
+  scoped_refptr<IOBufferWithSize> output =
+      deflater->GetOutput(deflater->CurrentOutputSize());
+  return ToString(output);
+}
+
+std::string TakeAllOutput(WebSocketInflater* inflater) {
+  scoped_refptr<IOBufferWithSize> output =
+      inflater->GetOutput(inflater->CurrentOutputSize());
+  return ToString(output);
+}
+
+TEST(WebSocketDeflaterTest, Construct) {
+  WebSocketDeflater deflater(WebSocketDeflater::TAKE_OVER_CONTEXT);
+  ASSERT_TRUE(deflater.Initialize(9));
+  EXPECT_EQ(0u, deflater.CurrentOutputSize());
+  ASSERT_TRUE(deflater.Finish());
+  // An empty message compresses to a single empty block.
+  EXPECT_EQ(std::string("\x00", 1), TakeAllOutput(&deflater));
+}
+
+TEST(WebSocketDeflaterTest, DeflateHelloTakeOverContext) {
+  WebSocketDeflater deflater(WebSocketDeflater::TAKE_OVER_CONTEXT);
+  ASSERT_TRUE(deflater.Initialize(15));
+
+  ASSERT_TRUE(deflater.AddBytes("Hello", 5));
+  ASSERT_TRUE(deflater.Finish());
+  EXPECT_EQ(std::string("\xf2\x48\xcd\xc9\xc9\x07\x00", 7),
+            TakeAllOutput(&deflater));
+
+  // The second message refers back to the first one.
+  ASSERT_TRUE(deflater.AddBytes("Hello", 5));
+  ASSERT_TRUE(deflater.Finish());
+  EXPECT_EQ(std::string("\xf2\x00\x11\x00\x00", 5), TakeAllOutput(&deflater));
+}
+
+TEST(WebSocketDeflaterTest, DeflateHelloDoNotTakeOverContext) {
+  WebSocketDeflater deflater(WebSocketDeflater::DO_NOT_TAKE_OVER_CONTEXT);
+  ASSERT_TRUE(deflater.Initialize(15));
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(deflater.AddBytes("Hello", 5));
+    ASSERT_TRUE(deflater.Finish());
+    EXPECT_EQ(std::string("\xf2\x48\xcd\xc9\xc9\x07\x00", 7),
+              TakeAllOutput(&deflater));
+  }
+}
+
+TEST(WebSocketDeflaterTest, GetPartialOutput) {
+  WebSocketDeflater deflater(WebSocketDeflater::TAKE_OVER_CONTEXT);
+  ASSERT_TRUE(deflater.Initialize(15));
+
+  ASSERT_TRUE(deflater.AddBytes("Hello", 5));
+  ASSERT_TRUE(deflater.Finish());
+  EXPECT_EQ(std::string("\xf2\x48\xcd", 3),
+            ToString(deflater.GetOutput(3)));
+  EXPECT_EQ(std::string("\xc9\xc9\x07\x00", 4), TakeAllOutput(&deflater));
+}
+
+TEST(WebSocketInflaterTest, InflateHello) {
+  WebSocketInflater inflater;
+  ASSERT_TRUE(inflater.Initialize(15));
+
+  ASSERT_TRUE(inflater.AddBytes("\xf2\x48\xcd\xc9\xc9\x07\x00", 7));
+  ASSERT_TRUE(inflater.Finish());
+  EXPECT_EQ("Hello", TakeAllOutput(&inflater));
+
+  ASSERT_TRUE(inflater.AddBytes("\xf2\x00\x11\x00\x00", 5));
+  ASSERT_TRUE(inflater.Finish());
+  EXPECT_EQ("Hello", TakeAllOutput(&inflater));
+}
+
+TEST(WebSocketInflaterTest, InflateCorruptData) {
+  WebSocketInflater inflater;
+  ASSERT_TRUE(inflater.Initialize(15));
+
+  // 0xFF starts a block of the reserved type 3.
+  EXPECT_FALSE(inflater.AddBytes("\xff\xff\xff\xff", 4));
+}
+
+TEST(WebSocketDeflaterTest, RoundTripLargeMessages) {
+  static const int kWindowBits = 10;
+  WebSocketDeflater deflater(WebSocketDeflater::TAKE_OVER_CONTEXT);
+  WebSocketInflater inflater;
+  ASSERT_TRUE(deflater.Initialize(kWindowBits));
+  ASSERT_TRUE(inflater.Initialize(kWindowBits));
+
+  // Decompresses to many times the size of the inflater's output buffer.
+  std::string message;
+  for (int i = 0; message.size() < 64 * 1024; ++i)
+    message += "{\"id\":" + std::string(1, 'a' + i % 26) + "},";
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(deflater.AddBytes(message.data(), message.size()));
+    ASSERT_TRUE(deflater.Finish());
+    std::string compressed = TakeAllOutput(&deflater);
+    EXPECT_LT(compressed.size(), message.size());
+
+    ASSERT_TRUE(inflater.AddBytes(compressed.data(), compressed.size()));
+    ASSERT_TRUE(inflater.Finish());
+    EXPECT_EQ(message, TakeAllOutput(&inflater));
+  }
+}
+
+}  // namespace
+
+}  // namespace net
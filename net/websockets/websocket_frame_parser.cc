@@ -29,16 +29,41 @@ const uint64 kMaxPayloadLengthWithoutExtendedLengthField = 125;
 const uint64 kPayloadLengthWithTwoByteExtendedLengthField = 126;
 const uint64 kPayloadLengthWithEightByteExtendedLengthField = 127;
 
+// The longest a frame header can be.
+const size_t kMaximumFrameHeaderSize =
+    net::WebSocketFrameHeader::kBaseHeaderSize +
+    net::WebSocketFrameHeader::kMaximumExtendedLengthSize +
+    net::WebSocketFrameHeader::kMaskingKeyLength;
+
+// Refers to the payload of a frame inside a buffer given to DecodeInPlace(),
+// and keeps that buffer alive.
+class PayloadInPlaceIOBuffer : public net::IOBufferWithSize {
+ public:
+  PayloadInPlaceIOBuffer(net::IOBuffer* buffer, char* data, int size)
+      : net::IOBufferWithSize(data, size),
+        buffer_(buffer) {
+  }
+
+ private:
+  virtual ~PayloadInPlaceIOBuffer() {
+    // |data_| belongs to |buffer_|, so keep ~IOBuffer() from freeing it.
+    data_ = NULL;
+  }
+
+  scoped_refptr<net::IOBuffer> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(PayloadInPlaceIOBuffer);
+};
+
 }  // Unnamed namespace.
 
 namespace net {
 
 WebSocketFrameParser::WebSocketFrameParser()
-    : current_read_pos_(0),
-      frame_offset_(0),
+    : frame_offset_(0),
       websocket_error_(WEB_SOCKET_OK) {
-  std::fill(masking_key_,
-            masking_key_ + WebSocketFrameHeader::kMaskingKeyLength,
+  std::fill(masking_key_.key,
+            masking_key_.key + WebSocketFrameHeader::kMaskingKeyLength,
             '\0');
 }
 
@@ -49,66 +74,101 @@ bool WebSocketFrameParser::Decode(
     const char* data,
     size_t length,
     ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+  return DecodeInternal(NULL, data, length, frame_chunks);
+}
+
+bool WebSocketFrameParser::DecodeInPlace(
+    IOBuffer* buffer,
+    size_t length,
+    ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+  DCHECK(buffer);
+  return DecodeInternal(buffer, buffer->data(), length, frame_chunks);
+}
+
+bool WebSocketFrameParser::DecodeInternal(
+    IOBuffer* buffer,
+    const char* data,
+    size_t length,
+    ScopedVector<WebSocketFrameChunk>* frame_chunks) {
   if (websocket_error_ != WEB_SOCKET_OK)
     return false;
   if (!length)
     return true;
 
-  // TODO(yutak): Remove copy.
-  buffer_.insert(buffer_.end(), data, data + length);
-
-  while (current_read_pos_ < buffer_.size()) {
+  const char* current = data;
+  const char* end = data + length;
+  while (current < end) {
     bool first_chunk = false;
     if (!current_frame_header_.get()) {
-      DecodeFrameHeader();
+      current += DecodeFrameHeader(current, end - current);
       if (websocket_error_ != WEB_SOCKET_OK)
         return false;
-      // If frame header is incomplete, then carry over the remaining
-      // data to the next round of Decode().
+      // If frame header is incomplete, then it has been carried over to the
+      // next round of Decode().
       if (!current_frame_header_.get())
         break;
       first_chunk = true;
     }
 
     scoped_ptr<WebSocketFrameChunk> frame_chunk =
-        DecodeFramePayload(first_chunk);
+        DecodeFramePayload(first_chunk, buffer, &current, end);
     DCHECK(frame_chunk.get());
     frame_chunks->push_back(frame_chunk.release());
 
     if (current_frame_header_.get()) {
-      DCHECK(current_read_pos_ == buffer_.size());
+      DCHECK(current == end);
       break;
     }
   }
 
-  // Drain unnecessary data. TODO(yutak): Remove copy. (but how?)
-  buffer_.erase(buffer_.begin(), buffer_.begin() + current_read_pos_);
-  current_read_pos_ = 0;
-
   // Sanity check: the size of carried-over data should not exceed
   // the maximum possible length of a frame header.
-  static const size_t kMaximumFrameHeaderSize =
-      WebSocketFrameHeader::kBaseHeaderSize +
-      WebSocketFrameHeader::kMaximumExtendedLengthSize +
-      WebSocketFrameHeader::kMaskingKeyLength;
-  DCHECK_LT(buffer_.size(), kMaximumFrameHeaderSize);
+  DCHECK_LT(header_buffer_.size(), kMaximumFrameHeaderSize);
 
   return true;
 }
 
-void WebSocketFrameParser::DecodeFrameHeader() {
+size_t WebSocketFrameParser::DecodeFrameHeader(const char* data,
+                                               size_t length) {
+  DCHECK(!current_frame_header_.get());
+
+  if (header_buffer_.empty()) {
+    size_t header_size = ParseFrameHeader(data, data + length);
+    if (header_size || websocket_error_ != WEB_SOCKET_OK)
+      return header_size;
+    // Carry the incomplete header over. It must be shorter than the longest
+    // possible header, or it would have parsed.
+    DCHECK_LT(length, kMaximumFrameHeaderSize);
+    header_buffer_.assign(data, data + length);
+    return length;
+  }
+
+  // Complete the carried-over header with as much of |data| as a header
+  // could possibly need.
+  size_t carried_over = header_buffer_.size();
+  size_t appended = std::min(length, kMaximumFrameHeaderSize - carried_over);
+  header_buffer_.insert(header_buffer_.end(), data, data + appended);
+  size_t header_size = ParseFrameHeader(
+      &header_buffer_.front(), &header_buffer_.front() + header_buffer_.size());
+  if (!header_size && websocket_error_ == WEB_SOCKET_OK)
+    return appended;
+  header_buffer_.clear();
+  if (websocket_error_ != WEB_SOCKET_OK)
+    return 0;
+  DCHECK_GT(header_size, carried_over);
+  return header_size - carried_over;
+}
+
+size_t WebSocketFrameParser::ParseFrameHeader(const char* start,
+                                              const char* end) {
   typedef WebSocketFrameHeader::OpCode OpCode;
   static const int kMaskingKeyLength = WebSocketFrameHeader::kMaskingKeyLength;
 
-  DCHECK(!current_frame_header_.get());
-
-  const char* start = &buffer_.front() + current_read_pos_;
   const char* current = start;
-  const char* end = &buffer_.front() + buffer_.size();
 
   // Header needs 2 bytes at minimum.
   if (end - current < 2)
-    return;
+    return 0;
 
   uint8 first_byte = *current++;
   uint8 second_byte = *current++;
@@ -123,7 +183,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   uint64 payload_length = second_byte & kPayloadLengthMask;
   if (payload_length == kPayloadLengthWithTwoByteExtendedLengthField) {
     if (end - current < 2)
-      return;
+      return 0;
     uint16 payload_length_16;
     ReadBigEndian(current, &payload_length_16);
     current += 2;
@@ -132,7 +192,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
       websocket_error_ = WEB_SOCKET_ERR_PROTOCOL_ERROR;
   } else if (payload_length == kPayloadLengthWithEightByteExtendedLengthField) {
     if (end - current < 8)
-      return;
+      return 0;
     ReadBigEndian(current, &payload_length);
     current += 8;
     if (payload_length <= kuint16max ||
@@ -143,20 +203,19 @@ void WebSocketFrameParser::DecodeFrameHeader() {
     }
   }
   if (websocket_error_ != WEB_SOCKET_OK) {
-    buffer_.clear();
-    current_read_pos_ = 0;
+    header_buffer_.clear();
     current_frame_header_.reset();
     frame_offset_ = 0;
-    return;
+    return 0;
   }
 
   if (masked) {
     if (end - current < kMaskingKeyLength)
-      return;
-    std::copy(current, current + kMaskingKeyLength, masking_key_);
+      return 0;
+    std::copy(current, current + kMaskingKeyLength, masking_key_.key);
     current += kMaskingKeyLength;
   } else {
-    std::fill(masking_key_, masking_key_ + kMaskingKeyLength, '\0');
+    std::fill(masking_key_.key, masking_key_.key + kMaskingKeyLength, '\0');
   }
 
   current_frame_header_.reset(new WebSocketFrameHeader);
@@ -167,18 +226,17 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   current_frame_header_->opcode = opcode;
   current_frame_header_->masked = masked;
   current_frame_header_->payload_length = payload_length;
-  current_read_pos_ += current - start;
   DCHECK_EQ(0u, frame_offset_);
+  return current - start;
 }
 
 scoped_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
-    bool first_chunk) {
-  static const int kMaskingKeyLength = WebSocketFrameHeader::kMaskingKeyLength;
-
-  const char* current = &buffer_.front() + current_read_pos_;
-  const char* end = &buffer_.front() + buffer_.size();
+    bool first_chunk,
+    IOBuffer* buffer,
+    const char** current,
+    const char* end) {
   uint64 next_size = std::min<uint64>(
-      end - current,
+      end - *current,
       current_frame_header_->payload_length - frame_offset_);
   // This check must pass because |payload_length| is already checked to be
   // less than std::numeric_limits<int>::max() when the header is parsed.
@@ -190,21 +248,21 @@ scoped_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
   }
   frame_chunk->final_chunk = false;
   if (next_size) {
-    frame_chunk->data = new IOBufferWithSize(static_cast<int>(next_size));
-    char* io_data = frame_chunk->data->data();
-    memcpy(io_data, current, next_size);
+    int size = static_cast<int>(next_size);
+    if (buffer) {
+      char* payload = buffer->data() + (*current - buffer->data());
+      frame_chunk->data = new PayloadInPlaceIOBuffer(buffer, payload, size);
+    } else {
+      frame_chunk->data = new IOBufferWithSize(size);
+      memcpy(frame_chunk->data->data(), *current, size);
+    }
     if (current_frame_header_->masked) {
       // Unmask the payload.
-      // TODO(yutak): This could be faster by doing unmasking for each
-      // machine word (instead of each byte).
-      size_t key_offset = frame_offset_ % kMaskingKeyLength;
-      for (uint64 i = 0; i < next_size; ++i) {
-        io_data[i] ^= masking_key_[key_offset];
-        key_offset = (key_offset + 1) % kMaskingKeyLength;
-      }
+      MaskWebSocketFramePayload(masking_key_, frame_offset_,
+                                frame_chunk->data->data(), size);
     }
 
-    current_read_pos_ += next_size;
+    *current += next_size;
     frame_offset_ += next_size;
   }
 
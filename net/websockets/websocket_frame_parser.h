@@ -17,6 +17,8 @@
 
 namespace net {
 
+class IOBuffer;
+
 // Parses WebSocket frames from byte stream.
 //
 // Specification of WebSocket frame format is available at
@@ -40,6 +42,15 @@ class NET_EXPORT_PRIVATE WebSocketFrameParser {
               size_t length,
               ScopedVector<WebSocketFrameChunk>* frame_chunks);
 
+  // Like Decode(), but decodes the first |length| bytes of |buffer| without
+  // copying the payload: it is unmasked inside |buffer|, and the |data| of
+  // each chunk in |frame_chunks| refers to its part of |buffer| (keeping
+  // |buffer| alive) instead of to a copy. The caller must not read into
+  // |buffer| again while any of those chunks are in use.
+  bool DecodeInPlace(IOBuffer* buffer,
+                     size_t length,
+                     ScopedVector<WebSocketFrameChunk>* frame_chunks);
+
   // Returns WEB_SOCKET_OK if the parser has not failed to decode WebSocket
   // frames. Otherwise returns WebSocketError which is defined in
   // websocket_errors.h. We can convert net::WebSocketError to net::Error by
@@ -47,32 +58,45 @@ class NET_EXPORT_PRIVATE WebSocketFrameParser {
   WebSocketError websocket_error() const { return websocket_error_; }
 
  private:
-  // Tries to decode a frame header from |current_read_pos_|.
-  // If successful, this function updates |current_read_pos_|,
-  // |current_frame_header_|, and |masking_key_| (if available).
-  // This function may set |failed_| to true if it observes a corrupt frame.
-  // If there is not enough data in the remaining buffer to parse a frame
-  // header, this function returns without doing anything.
-  void DecodeFrameHeader();
-
-  // Decodes frame payload and creates a WebSocketFrameChunk object.
-  // This function updates |current_read_pos_| and |frame_offset_| after
-  // parsing. This function returns a frame object even if no payload data is
-  // available at this moment, so the receiver could make use of frame header
-  // information. If the end of frame is reached, this function clears
-  // |current_frame_header_|, |frame_offset_| and |masking_key_|.
-  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk);
-
-  // Internal buffer to store the data to parse.
-  std::vector<char> buffer_;
-
-  // Position in |buffer_| where the next round of parsing starts.
-  size_t current_read_pos_;
+  // Implements Decode() and DecodeInPlace(). |buffer| is NULL when decoding
+  // by copy; otherwise |data| is |buffer|->data().
+  bool DecodeInternal(IOBuffer* buffer,
+                      const char* data,
+                      size_t length,
+                      ScopedVector<WebSocketFrameChunk>* frame_chunks);
+
+  // Tries to decode a frame header from the start of |data|, first completing
+  // any partial header carried over in |header_buffer_|. Returns the number
+  // of bytes of |data| used. If the header is still incomplete, all of |data|
+  // is carried over and |current_frame_header_| stays NULL.
+  // This function may set |websocket_error_| if it observes a corrupt frame.
+  size_t DecodeFrameHeader(const char* data, size_t length);
+
+  // Parses the frame header in [start, end). Returns the size of the header
+  // and sets |current_frame_header_| and |masking_key_|, or returns 0 if the
+  // header is incomplete or corrupt.
+  size_t ParseFrameHeader(const char* start, const char* end);
+
+  // Decodes frame payload at |*current| and creates a WebSocketFrameChunk
+  // object. If |buffer| is non-NULL, the payload lies inside |buffer| and is
+  // unmasked and referred to in place; otherwise it is copied. This function
+  // advances |*current| and updates |frame_offset_|. It returns a frame
+  // object even if no payload data is available at this moment, so the
+  // receiver could make use of frame header information. If the end of frame
+  // is reached, this function clears |current_frame_header_| and
+  // |frame_offset_|.
+  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk,
+                                                     IOBuffer* buffer,
+                                                     const char** current,
+                                                     const char* end);
+
+  // The start of a frame header that was split across calls to Decode().
+  std::vector<char> header_buffer_;
 
   // Frame header and masking key of the current frame.
   // |masking_key_| is filled with zeros if the current frame is not masked.
   scoped_ptr<WebSocketFrameHeader> current_frame_header_;
-  char masking_key_[WebSocketFrameHeader::kMaskingKeyLength];
+  WebSocketMaskingKey masking_key_;
 
   // Amount of payload data read so far for the current frame.
   uint64 frame_offset_;
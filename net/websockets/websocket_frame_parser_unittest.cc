@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_vector.h"
 #include "base/port.h"
 #include "net/base/io_buffer.h"
@@ -103,6 +104,67 @@ TEST(WebSocketFrameParserTest, DecodeMaskedFrame) {
   EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength, frame->data->data()));
 }
 
+TEST(WebSocketFrameParserTest, DecodeInPlaceMaskedFrame) {
+  WebSocketFrameParser parser;
+
+  scoped_refptr<IOBufferWithSize> buffer(
+      new IOBufferWithSize(kMaskedHelloFrameLength));
+  memcpy(buffer->data(), kMaskedHelloFrame, kMaskedHelloFrameLength);
+
+  ScopedVector<WebSocketFrameChunk> frames;
+  EXPECT_TRUE(parser.DecodeInPlace(buffer, buffer->size(), &frames));
+  EXPECT_EQ(WEB_SOCKET_OK, parser.websocket_error());
+  ASSERT_EQ(1u, frames.size());
+  WebSocketFrameChunk* frame = frames[0];
+  ASSERT_TRUE(frame != NULL);
+  ASSERT_TRUE(frame->header.get() != NULL);
+  EXPECT_TRUE(frame->header->masked);
+  EXPECT_EQ(kHelloLength, frame->header->payload_length);
+  EXPECT_TRUE(frame->final_chunk);
+
+  // The payload is unmasked where it lies in |buffer|, right after the
+  // 6-byte header.
+  ASSERT_EQ(static_cast<int>(kHelloLength), frame->data->size());
+  EXPECT_EQ(buffer->data() + 6, frame->data->data());
+  EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength, frame->data->data()));
+
+  // The chunk keeps the buffer alive.
+  buffer = NULL;
+  EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength, frame->data->data()));
+}
+
+TEST(WebSocketFrameParserTest, DecodeInPlacePartialHeader) {
+  static const size_t kFrameHeaderSize = 6;
+
+  for (size_t cutting_pos = 1; cutting_pos < kFrameHeaderSize; ++cutting_pos) {
+    scoped_refptr<IOBufferWithSize> buffer1(new IOBufferWithSize(cutting_pos));
+    memcpy(buffer1->data(), kMaskedHelloFrame, cutting_pos);
+    size_t length2 = kMaskedHelloFrameLength - cutting_pos;
+    scoped_refptr<IOBufferWithSize> buffer2(new IOBufferWithSize(length2));
+    memcpy(buffer2->data(), kMaskedHelloFrame + cutting_pos, length2);
+
+    WebSocketFrameParser parser;
+
+    ScopedVector<WebSocketFrameChunk> frames1;
+    EXPECT_TRUE(parser.DecodeInPlace(buffer1, cutting_pos, &frames1));
+    EXPECT_EQ(WEB_SOCKET_OK, parser.websocket_error());
+    EXPECT_EQ(0u, frames1.size());
+
+    ScopedVector<WebSocketFrameChunk> frames2;
+    EXPECT_TRUE(parser.DecodeInPlace(buffer2, length2, &frames2));
+    EXPECT_EQ(WEB_SOCKET_OK, parser.websocket_error());
+    ASSERT_EQ(1u, frames2.size());
+    WebSocketFrameChunk* frame = frames2[0];
+    EXPECT_TRUE(frame->header.get() != NULL);
+    EXPECT_TRUE(frame->final_chunk);
+    ASSERT_EQ(static_cast<int>(kHelloLength), frame->data->size());
+    EXPECT_EQ(buffer2->data() + kFrameHeaderSize - cutting_pos,
+              frame->data->data());
+    EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength,
+                           frame->data->data()));
+  }
+}
+
 TEST(WebSocketFrameParserTest, DecodeManyFrames) {
   struct Input {
     const char* frame;
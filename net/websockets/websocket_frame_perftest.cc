@@ -0,0 +1,107 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "net/base/io_buffer.h"
+#include "net/websockets/websocket_frame.h"
+#include "net/websockets/websocket_frame_parser.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kIterations = 1000;
+const int kPayloadSizes[] = { 16, 1024, 64 * 1024 };
+const char kMaskingKey[] = "\xDE\xAD\xBE\xEF";
+
+WebSocketMaskingKey MakeMaskingKey() {
+  WebSocketMaskingKey masking_key;
+  std::copy(kMaskingKey, kMaskingKey + WebSocketFrameHeader::kMaskingKeyLength,
+            masking_key.key);
+  return masking_key;
+}
+
+// Returns a buffer holding |num_frames| masked binary frames, each carrying
+// |payload_size| bytes of payload.
+scoped_refptr<IOBufferWithSize> MakeMaskedFrames(int num_frames,
+                                                 int payload_size) {
+  WebSocketFrameHeader header;
+  header.final = true;
+  header.reserved1 = false;
+  header.reserved2 = false;
+  header.reserved3 = false;
+  header.opcode = WebSocketFrameHeader::kOpCodeBinary;
+  header.masked = true;
+  header.payload_length = payload_size;
+  WebSocketMaskingKey masking_key = MakeMaskingKey();
+
+  int header_size = GetWebSocketFrameHeaderSize(header);
+  int frame_size = header_size + payload_size;
+  scoped_refptr<IOBufferWithSize> buffer(
+      new IOBufferWithSize(num_frames * frame_size));
+  for (int i = 0; i < num_frames; ++i) {
+    char* frame = buffer->data() + i * frame_size;
+    EXPECT_EQ(header_size, WriteWebSocketFrameHeader(header, &masking_key,
+                                                     frame, header_size));
+    std::fill(frame + header_size, frame + frame_size, 'x');
+    MaskWebSocketFramePayload(masking_key, 0, frame + header_size,
+                              payload_size);
+  }
+  return buffer;
+}
+
+}  // namespace
+
+TEST(WebSocketFramePerfTest, MaskPayload) {
+  WebSocketMaskingKey masking_key = MakeMaskingKey();
+  for (size_t i = 0; i < arraysize(kPayloadSizes); ++i) {
+    std::string payload(kPayloadSizes[i], 'x');
+    PerfTimeLogger timer(base::StringPrintf(
+        "WebSocket_mask_payload_%d", kPayloadSizes[i]).c_str());
+    for (int j = 0; j < kIterations; ++j) {
+      MaskWebSocketFramePayload(masking_key, j, &payload[0], payload.size());
+    }
+    timer.Done();
+  }
+}
+
+TEST(WebSocketFramePerfTest, DecodeMaskedFrames) {
+  static const int kNumFrames = 16;
+  for (size_t i = 0; i < arraysize(kPayloadSizes); ++i) {
+    scoped_refptr<IOBufferWithSize> frames =
+        MakeMaskedFrames(kNumFrames, kPayloadSizes[i]);
+
+    WebSocketFrameParser copying_parser;
+    PerfTimeLogger copying_timer(base::StringPrintf(
+        "WebSocket_decode_copy_%d", kPayloadSizes[i]).c_str());
+    for (int j = 0; j < kIterations; ++j) {
+      ScopedVector<WebSocketFrameChunk> frame_chunks;
+      EXPECT_TRUE(copying_parser.Decode(frames->data(), frames->size(),
+                                        &frame_chunks));
+    }
+    copying_timer.Done();
+
+    // Decoding in place unmasks |frames| each time, which leaves the frame
+    // headers intact, so the same buffer can be decoded again.
+    WebSocketFrameParser in_place_parser;
+    PerfTimeLogger in_place_timer(base::StringPrintf(
+        "WebSocket_decode_in_place_%d", kPayloadSizes[i]).c_str());
+    for (int j = 0; j < kIterations; ++j) {
+      ScopedVector<WebSocketFrameChunk> frame_chunks;
+      EXPECT_TRUE(in_place_parser.DecodeInPlace(frames, frames->size(),
+                                                &frame_chunks));
+    }
+    in_place_timer.Done();
+  }
+}
+
+}  // namespace net
@@ -4,6 +4,7 @@
 
 #include "net/websockets/websocket_frame.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -267,4 +268,46 @@ TEST(WebSocketFrameTest, MaskPayload) {
   }
 }
 
+// Masking long payloads takes the word-at-a-time path, which must agree with
+// masking byte by byte for every alignment, offset and length.
+TEST(WebSocketFrameTest, MaskPayloadWordAtATime) {
+  static const char kMaskingKey[] = "\xDE\xAD\xBE\xEF";
+  static const int kMaxLength = 64;
+  static const int kMaxAlignment = 16;
+
+  WebSocketMaskingKey masking_key;
+  std::copy(kMaskingKey, kMaskingKey + WebSocketFrameHeader::kMaskingKeyLength,
+            masking_key.key);
+
+  std::vector<char> input(kMaxAlignment + kMaxLength);
+  for (size_t i = 0; i < input.size(); ++i)
+    input[i] = static_cast<char>(i * 7);
+
+  for (int alignment = 0; alignment < kMaxAlignment; ++alignment) {
+    for (uint64 frame_offset = 0; frame_offset < 4; ++frame_offset) {
+      for (int length = 0; length <= kMaxLength; ++length) {
+        std::vector<char> expected(input.begin() + alignment,
+                                   input.begin() + alignment + length);
+        for (int i = 0; i < length; ++i) {
+          expected[i] ^= kMaskingKey[(frame_offset + i) %
+                                     WebSocketFrameHeader::kMaskingKeyLength];
+        }
+
+        std::vector<char> frame_data(input);
+        MaskWebSocketFramePayload(masking_key, frame_offset,
+                                  &frame_data.front() + alignment, length);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                               frame_data.begin() + alignment))
+            << "alignment=" << alignment << " frame_offset=" << frame_offset
+            << " length=" << length;
+        // Bytes around the payload must be left alone.
+        EXPECT_TRUE(std::equal(input.begin(), input.begin() + alignment,
+                               frame_data.begin()));
+        EXPECT_TRUE(std::equal(input.begin() + alignment + length, input.end(),
+                               frame_data.begin() + alignment + length));
+      }
+    }
+  }
+}
+
 }  // namespace net
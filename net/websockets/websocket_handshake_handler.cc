@@ -9,11 +9,13 @@
 #include "base/sha1.h"
 #include "base/string_number_conversions.h"
 #include "base/string_piece.h"
+#include "base/string_split.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "googleurl/src/gurl.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_util.h"
+#include "net/websockets/websocket_deflater.h"
 
 namespace {
 
@@ -27,6 +29,13 @@ const int kMinVersionOfHybiNewHandshake = 4;
 // Used when we calculate the value of Sec-WebSocket-Accept.
 const char* const kWebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
+const char kSecWebSocketExtensions[] = "Sec-WebSocket-Extensions";
+const char kPerMessageDeflate[] = "permessage-deflate";
+const char kClientNoContextTakeover[] = "client_no_context_takeover";
+const char kServerNoContextTakeover[] = "server_no_context_takeover";
+const char kClientMaxWindowBits[] = "client_max_window_bits";
+const char kServerMaxWindowBits[] = "server_max_window_bits";
+
 void ParseHandshakeHeader(
     const char* handshake_message, int len,
     std::string* status_line,
@@ -156,10 +165,84 @@ int GetVersionFromRequest(const std::string& request_headers) {
   return version;
 }
 
+// Parses a window size parameter value of permessage-deflate into
+// |window_bits|. The value may be quoted.
+bool ParseWindowBits(const std::string& value, int* window_bits) {
+  std::string unquoted = value;
+  if (net::HttpUtil::IsQuote(value[0]))
+    unquoted = net::HttpUtil::Unquote(value);
+  return base::StringToInt(unquoted, window_bits) &&
+      *window_bits >= net::WebSocketDeflater::kMinWindowBits &&
+      *window_bits <= net::WebSocketDeflater::kMaxWindowBits;
+}
+
+// Parses the parameters of the permessage-deflate extension out of one
+// element of Sec-WebSocket-Extensions. Returns false if |extension| is not
+// permessage-deflate or has invalid parameters.
+bool ParsePerMessageDeflate(const std::string& extension,
+                            net::WebSocketDeflateParameters* parameters) {
+  std::vector<std::string> tokens;
+  base::SplitString(extension, ';', &tokens);
+  if (tokens.empty() || tokens[0] != kPerMessageDeflate)
+    return false;
+
+  net::WebSocketDeflateParameters result;
+  for (size_t i = 1; i < tokens.size(); ++i) {
+    std::string name = tokens[i];
+    std::string value;
+    size_t equals = tokens[i].find('=');
+    if (equals != std::string::npos) {
+      TrimWhitespaceASCII(tokens[i].substr(0, equals), TRIM_ALL, &name);
+      TrimWhitespaceASCII(tokens[i].substr(equals + 1), TRIM_ALL, &value);
+      if (value.empty())
+        return false;
+    }
+    if (name == kClientNoContextTakeover && value.empty()) {
+      result.client_no_context_takeover = true;
+    } else if (name == kServerNoContextTakeover && value.empty()) {
+      result.server_no_context_takeover = true;
+    } else if (name == kClientMaxWindowBits && !value.empty()) {
+      if (!ParseWindowBits(value, &result.client_max_window_bits))
+        return false;
+    } else if (name == kServerMaxWindowBits && !value.empty()) {
+      if (!ParseWindowBits(value, &result.server_max_window_bits))
+        return false;
+    } else {
+      return false;
+    }
+  }
+  *parameters = result;
+  return true;
+}
+
 }  // anonymous namespace
 
 namespace net {
 
+WebSocketDeflateParameters::WebSocketDeflateParameters()
+    : client_no_context_takeover(false),
+      server_no_context_takeover(false),
+      client_max_window_bits(WebSocketDeflater::kMaxWindowBits),
+      server_max_window_bits(WebSocketDeflater::kMaxWindowBits) {
+}
+
+std::string WebSocketDeflateParameters::ToExtensionOffer() const {
+  std::string offer = kPerMessageDeflate;
+  if (client_no_context_takeover)
+    offer += std::string("; ") + kClientNoContextTakeover;
+  if (server_no_context_takeover)
+    offer += std::string("; ") + kServerNoContextTakeover;
+  if (client_max_window_bits != WebSocketDeflater::kMaxWindowBits) {
+    base::StringAppendF(&offer, "; %s=%d", kClientMaxWindowBits,
+                        client_max_window_bits);
+  }
+  if (server_max_window_bits != WebSocketDeflater::kMaxWindowBits) {
+    base::StringAppendF(&offer, "; %s=%d", kServerMaxWindowBits,
+                        server_max_window_bits);
+  }
+  return offer;
+}
+
 WebSocketHandshakeRequestHandler::WebSocketHandshakeRequestHandler()
     : original_length_(0),
       raw_length_(0),
@@ -223,6 +306,12 @@ void WebSocketHandshakeRequestHandler::RemoveHeaders(
       headers_, headers_to_remove, headers_to_remove_len);
 }
 
+void WebSocketHandshakeRequestHandler::AppendPerMessageDeflateOfferIfMissing(
+    const WebSocketDeflateParameters& parameters) {
+  AppendHeaderIfMissing(kSecWebSocketExtensions,
+                        parameters.ToExtensionOffer());
+}
+
 HttpRequestInfo WebSocketHandshakeRequestHandler::GetRequestInfo(
     const GURL& url, std::string* challenge) {
   HttpRequestInfo request_info;
@@ -541,6 +630,24 @@ void WebSocketHandshakeResponseHandler::RemoveHeaders(
   headers_ = FilterHeaders(headers_, headers_to_remove, headers_to_remove_len);
 }
 
+bool WebSocketHandshakeResponseHandler::GetPerMessageDeflateParameters(
+    WebSocketDeflateParameters* parameters) {
+  static const char* const kExtensionHeaders[] = {
+    "sec-websocket-extensions"
+  };
+  std::vector<std::string> values;
+  GetHeaders(kExtensionHeaders, arraysize(kExtensionHeaders), &values);
+  for (size_t i = 0; i < values.size(); ++i) {
+    std::vector<std::string> extensions;
+    base::SplitString(values[i], ',', &extensions);
+    for (size_t j = 0; j < extensions.size(); ++j) {
+      if (ParsePerMessageDeflate(extensions[j], parameters))
+        return true;
+    }
+  }
+  return false;
+}
+
 std::string WebSocketHandshakeResponseHandler::GetRawResponse() const {
   DCHECK(HasResponse());
   return std::string(original_.data(),
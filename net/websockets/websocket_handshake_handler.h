@@ -40,6 +40,21 @@
 
 namespace net {
 
+// Parameters of the permessage-deflate extension, as offered by the client
+// or accepted by the server in Sec-WebSocket-Extensions. Window sizes are
+// given as the base-two logarithm of the size of the sliding window.
+struct NET_EXPORT_PRIVATE WebSocketDeflateParameters {
+  WebSocketDeflateParameters();
+
+  // The Sec-WebSocket-Extensions value offering these parameters.
+  std::string ToExtensionOffer() const;
+
+  bool client_no_context_takeover;
+  bool server_no_context_takeover;
+  int client_max_window_bits;
+  int server_max_window_bits;
+};
+
 class NET_EXPORT_PRIVATE WebSocketHandshakeRequestHandler {
  public:
   WebSocketHandshakeRequestHandler();
@@ -59,6 +74,10 @@ class NET_EXPORT_PRIVATE WebSocketHandshakeRequestHandler {
   // Removes the headers that matches (case insensitive).
   void RemoveHeaders(const char* const headers_to_remove[],
                      size_t headers_to_remove_len);
+  // Offers the permessage-deflate extension with |parameters|, unless the
+  // request already has a Sec-WebSocket-Extensions header.
+  void AppendPerMessageDeflateOfferIfMissing(
+      const WebSocketDeflateParameters& parameters);
 
   // Gets request info to open WebSocket connection.
   // Fills challange data (concatenation of key1, 2 and 3 for hybi-03 and
@@ -129,6 +148,10 @@ class NET_EXPORT_PRIVATE WebSocketHandshakeResponseHandler {
   // Removes the headers that matches (case insensitive).
   void RemoveHeaders(const char* const headers_to_remove[],
                      size_t headers_to_remove_len);
+  // Returns true if the server accepted the permessage-deflate extension
+  // with valid parameters, and fills them in |parameters|. Parameters the
+  // server left out keep their default values.
+  bool GetPerMessageDeflateParameters(WebSocketDeflateParameters* parameters);
 
   // Gets raw WebSocket handshake response received from WebSocket server.
   std::string GetRawResponse() const;
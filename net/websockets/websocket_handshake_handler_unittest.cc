@@ -161,6 +161,40 @@ TEST(WebSocketHandshakeRequestHandlerTest,
   EXPECT_EQ(kHandshakeRequestExpectedMessage, handler.GetRawRequest());
 }
 
+TEST(WebSocketHandshakeRequestHandlerTest, AppendPerMessageDeflateOffer) {
+  WebSocketHandshakeRequestHandler handler;
+
+  static const char kHandshakeRequestMessage[] =
+      "GET /demo HTTP/1.1\r\n"
+      "Host: example.com\r\n"
+      "Upgrade: websocket\r\n"
+      "Connection: Upgrade\r\n"
+      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+      "Sec-WebSocket-Version: 13\r\n"
+      "\r\n";
+
+  EXPECT_TRUE(handler.ParseRequest(kHandshakeRequestMessage,
+                                   strlen(kHandshakeRequestMessage)));
+
+  WebSocketDeflateParameters parameters;
+  parameters.client_no_context_takeover = true;
+  parameters.client_max_window_bits = 10;
+  handler.AppendPerMessageDeflateOfferIfMissing(parameters);
+
+  static const char kExpectedHandshakeRequestMessage[] =
+      "GET /demo HTTP/1.1\r\n"
+      "Host: example.com\r\n"
+      "Upgrade: websocket\r\n"
+      "Connection: Upgrade\r\n"
+      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+      "Sec-WebSocket-Version: 13\r\n"
+      "Sec-WebSocket-Extensions: permessage-deflate; "
+      "client_no_context_takeover; client_max_window_bits=10\r\n"
+      "\r\n";
+
+  EXPECT_EQ(kExpectedHandshakeRequestMessage, handler.GetRawRequest());
+}
+
 TEST(WebSocketHandshakeResponseHandlerTest, SimpleResponse) {
   WebSocketHandshakeResponseHandler handler;
   EXPECT_EQ(0, handler.protocol_version());
@@ -208,6 +242,52 @@ TEST(WebSocketHandshakeResponseHandlerTest, SimpleResponseHybi06Handshake) {
   EXPECT_EQ(kHandshakeResponseMessage, handler.GetResponse());
 }
 
+TEST(WebSocketHandshakeResponseHandlerTest, PerMessageDeflateParameters) {
+  struct TestCase {
+    const char* extensions;
+    bool accepted;
+    bool server_no_context_takeover;
+    int server_max_window_bits;
+  };
+  static const TestCase kTests[] = {
+    { "permessage-deflate", true, false, 15 },
+    { "x-foo, permessage-deflate; server_no_context_takeover", true, true, 15 },
+    { "permessage-deflate; server_max_window_bits=10", true, false, 10 },
+    { "permessage-deflate; server_max_window_bits=\"12\"", true, false, 12 },
+    { "x-foo", false, false, 15 },
+    { "permessage-deflate; server_max_window_bits=16", false, false, 15 },
+    { "permessage-deflate; server_max_window_bits", false, false, 15 },
+    { "permessage-deflate; x-unknown", false, false, 15 },
+  };
+
+  for (size_t i = 0; i < arraysize(kTests); ++i) {
+    WebSocketHandshakeResponseHandler handler;
+    handler.set_protocol_version(13);
+
+    std::string response =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"
+        "Sec-WebSocket-Extensions: ";
+    response += kTests[i].extensions;
+    response += "\r\n\r\n";
+    EXPECT_EQ(response.size(),
+              handler.ParseRawResponse(response.data(), response.size()));
+
+    WebSocketDeflateParameters parameters;
+    EXPECT_EQ(kTests[i].accepted,
+              handler.GetPerMessageDeflateParameters(&parameters))
+        << kTests[i].extensions;
+    EXPECT_EQ(kTests[i].server_no_context_takeover,
+              parameters.server_no_context_takeover);
+    EXPECT_EQ(kTests[i].server_max_window_bits,
+              parameters.server_max_window_bits);
+    EXPECT_FALSE(parameters.client_no_context_takeover);
+    EXPECT_EQ(15, parameters.client_max_window_bits);
+  }
+}
+
 TEST(WebSocketHandshakeResponseHandlerTest, ReplaceResponseCookies) {
   WebSocketHandshakeResponseHandler handler;
   EXPECT_EQ(0, handler.protocol_version());
@@ -6,6 +6,7 @@
 
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "ppapi/c/private/ppb_proxy_private.h"
 #include "ppapi/c/ppb_var.h"
 #include "ppapi/proxy/host_var_serialization_rules.h"
@@ -194,6 +195,21 @@ bool HostDispatcher::OnMessageReceived(const IPC::Message& msg) {
 
   if (handled)
     return true;
+
+  // Counts the calls the plugin makes to each interface, to find the ones
+  // whose call rate makes plugins IPC bound. Sync calls also block the plugin
+  // on the renderer, so they are counted separately. The buckets are ApiIDs,
+  // which are renumbered as interfaces are added, so only compare a version
+  // with itself.
+  if (msg.routing_id() > 0 && msg.routing_id() < API_ID_COUNT) {
+    if (msg.is_sync()) {
+      UMA_HISTOGRAM_ENUMERATION("Plugin.PpapiProxy.SyncMessagesFromPlugin",
+                                msg.routing_id(), API_ID_COUNT);
+    } else {
+      UMA_HISTOGRAM_ENUMERATION("Plugin.PpapiProxy.AsyncMessagesFromPlugin",
+                                msg.routing_id(), API_ID_COUNT);
+    }
+  }
   return Dispatcher::OnMessageReceived(msg);
 }
 
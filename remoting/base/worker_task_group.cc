@@ -0,0 +1,76 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "remoting/base/worker_task_group.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
+
+namespace {
+
+// Upper limit on the number of tasks run in parallel. Beyond this the gain
+// is small compared to the cost of the threads.
+const int kMaxParallelTasks = 8;
+
+}  // namespace
+
+namespace remoting {
+
+WorkerTaskGroup::WorkerTaskGroup()
+    : all_tasks_done_(&lock_),
+      pending_tasks_(0) {
+}
+
+WorkerTaskGroup::~WorkerTaskGroup() {
+  Wait();
+}
+
+// static
+int WorkerTaskGroup::GetMaxParallelTasks() {
+  return std::max(1, std::min(base::SysInfo::NumberOfProcessors(),
+                              kMaxParallelTasks));
+}
+
+void WorkerTaskGroup::PostTask(const base::Closure& task) {
+  if (GetMaxParallelTasks() == 1) {
+    task.Run();
+    return;
+  }
+
+  {
+    base::AutoLock auto_lock(lock_);
+    ++pending_tasks_;
+  }
+
+  // |this| outlives the task because the destructor waits for it.
+  if (!base::WorkerPool::PostTask(
+          FROM_HERE,
+          base::Bind(&WorkerTaskGroup::RunTask, base::Unretained(this), task),
+          false)) {
+    RunTask(task);
+  }
+}
+
+void WorkerTaskGroup::Wait() {
+  base::AutoLock auto_lock(lock_);
+  while (pending_tasks_ > 0)
+    all_tasks_done_.Wait();
+}
+
+void WorkerTaskGroup::RunTask(const base::Closure& task) {
+  task.Run();
+
+  base::AutoLock auto_lock(lock_);
+  --pending_tasks_;
+  DCHECK_GE(pending_tasks_, 0);
+  if (pending_tasks_ == 0)
+    all_tasks_done_.Broadcast();
+}
+
+}  // namespace remoting
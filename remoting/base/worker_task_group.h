@@ -0,0 +1,49 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// WorkerTaskGroup runs a batch of tasks on the base::WorkerPool and lets the
+// caller wait until all of them have finished. It is used by the codecs to
+// process independent parts of a frame in parallel.
+
+#ifndef REMOTING_BASE_WORKER_TASK_GROUP_H_
+#define REMOTING_BASE_WORKER_TASK_GROUP_H_
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+
+namespace remoting {
+
+class WorkerTaskGroup {
+ public:
+  WorkerTaskGroup();
+
+  // Waits for the tasks that are still running.
+  ~WorkerTaskGroup();
+
+  // Returns the number of tasks worth running in parallel on this machine.
+  static int GetMaxParallelTasks();
+
+  // Runs |task| on a worker thread. On single-core machines, or if the task
+  // cannot be posted, |task| is run before this method returns.
+  void PostTask(const base::Closure& task);
+
+  // Blocks until all the tasks posted so far have finished.
+  void Wait();
+
+ private:
+  void RunTask(const base::Closure& task);
+
+  // Protects |pending_tasks_|.
+  base::Lock lock_;
+  base::ConditionVariable all_tasks_done_;
+  int pending_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerTaskGroup);
+};
+
+}  // namespace remoting
+
+#endif  // REMOTING_BASE_WORKER_TASK_GROUP_H_
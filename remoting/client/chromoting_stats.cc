@@ -23,7 +23,8 @@ ChromotingStats::ChromotingStats()
       video_encode_ms_(kLatencyWindow),
       video_decode_ms_(kLatencyWindow),
       video_paint_ms_(kLatencyWindow),
-      round_trip_ms_(kLatencyWindow) {
+      round_trip_ms_(kLatencyWindow),
+      video_queue_ms_(kLatencyWindow) {
 }
 
 ChromotingStats::~ChromotingStats() {
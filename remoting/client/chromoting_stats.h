@@ -25,6 +25,9 @@ class ChromotingStats {
   RunningAverage* video_decode_ms() { return &video_decode_ms_; }
   RunningAverage* video_paint_ms() { return &video_paint_ms_; }
   RunningAverage* round_trip_ms() { return &round_trip_ms_; }
+  // Part of the round trip not spent capturing or encoding, i.e. waiting on
+  // the host and in transit over the network.
+  RunningAverage* video_queue_ms() { return &video_queue_ms_; }
 
  private:
   RateCounter video_bandwidth_;
@@ -34,6 +37,7 @@ class ChromotingStats {
   RunningAverage video_decode_ms_;
   RunningAverage video_paint_ms_;
   RunningAverage round_trip_ms_;
+  RunningAverage video_queue_ms_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromotingStats);
 };
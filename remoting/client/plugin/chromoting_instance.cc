@@ -629,6 +629,7 @@ void ChromotingInstance::SendPerfStats() {
   data->SetDouble("decodeLatency", stats->video_decode_ms()->Average());
   data->SetDouble("renderLatency", stats->video_paint_ms()->Average());
   data->SetDouble("roundtripLatency", stats->round_trip_ms()->Average());
+  data->SetDouble("queueLatency", stats->video_queue_ms()->Average());
   PostChromotingMessage("onPerfStats", data.Pass());
 }
 
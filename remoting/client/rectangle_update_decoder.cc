@@ -4,6 +4,8 @@
 
 #include "remoting/client/rectangle_update_decoder.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/callback.h"
@@ -251,6 +253,11 @@ void RectangleUpdateDecoder::ProcessVideoPacket(scoped_ptr<VideoPacket> packet,
         base::Time::Now() -
         base::Time::FromInternalValue(packet->client_sequence_number());
     stats_.round_trip_ms()->Record(round_trip_latency.InMilliseconds());
+    if (packet->has_capture_time_ms() && packet->has_encode_time_ms()) {
+      stats_.video_queue_ms()->Record(std::max<int64>(
+          round_trip_latency.InMilliseconds() - packet->capture_time_ms() -
+              packet->encode_time_ms(), 0));
+    }
   }
 
   // Measure the latency between the last packet being received and presented.
@@ -8,6 +8,7 @@
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "media/base/video_frame.h"
 #include "remoting/codec/codec_test.h"
 #include "remoting/codec/video_decoder.h"
@@ -277,6 +278,31 @@ void VerifyResultsApprox(const uint8* expected_view_data,
   DISALLOW_COPY_AND_ASSIGN(VideoDecoderTester);
 };
 
+// Collects the packets produced by an encoder.
+class VideoPacketCollector {
+ public:
+  VideoPacketCollector() {}
+
+  void DataAvailable(scoped_ptr<VideoPacket> packet) {
+    packets_.push_back(packet.release());
+  }
+
+  size_t packet_count() const { return packets_.size(); }
+  VideoPacket* packet(size_t index) { return packets_[index]; }
+
+  size_t TotalSize() const {
+    size_t size = 0;
+    for (size_t i = 0; i < packets_.size(); ++i)
+      size += packets_[i]->data().size();
+    return size;
+  }
+
+ private:
+  ScopedVector<VideoPacket> packets_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoPacketCollector);
+};
+
 // The VideoEncoderTester provides a hook for retrieving the data, and passing
 // the message to other subprograms for validaton.
 class VideoEncoderTester {
@@ -493,4 +519,38 @@ void TestVideoEncoderDecoderGradient(VideoEncoder* encoder,
                                      max_error_limit, mean_error_limit);
 }
 
+void TestVideoEncoderDecoderLargeFrame(VideoEncoder* encoder,
+                                       VideoDecoder* decoder,
+                                       const SkISize& screen_size) {
+  SkIRect screen_rect = SkIRect::MakeSize(screen_size);
+  scoped_array<uint8> screen_data(new uint8[
+      screen_size.width() * screen_size.height() * kBytesPerPixel]);
+  FillWithGradient(screen_data.get(), screen_size, screen_rect);
+
+  DataPlanes planes;
+  memset(planes.data, 0, sizeof(planes.data));
+  memset(planes.strides, 0, sizeof(planes.strides));
+  planes.data[0] = screen_data.get();
+  planes.strides[0] = screen_size.width() * kBytesPerPixel;
+
+  scoped_refptr<CaptureData> capture_data =
+      new CaptureData(planes, screen_size, media::VideoFrame::RGB32);
+  capture_data->mutable_dirty_region().op(screen_rect, SkRegion::kUnion_Op);
+
+  VideoDecoderTester decoder_tester(decoder, screen_size, screen_size);
+  decoder_tester.set_strict(true);
+  decoder_tester.set_capture_data(capture_data);
+
+  VideoPacketCollector collector;
+  encoder->Encode(capture_data, true,
+                  base::Bind(&VideoPacketCollector::DataAvailable,
+                             base::Unretained(&collector)));
+  EXPECT_GT(collector.packet_count(), 0U);
+
+  decoder_tester.AddRegion(capture_data->dirty_region());
+  for (size_t i = 0; i < collector.packet_count(); ++i)
+    decoder_tester.ReceivedPacket(collector.packet(i));
+  decoder_tester.VerifyResults();
+}
+
 }  // namespace remoting
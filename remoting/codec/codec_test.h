@@ -38,6 +38,12 @@ void TestVideoEncoderDecoderGradient(VideoEncoder* encoder,
                                      double max_error_limit,
                                      double mean_error_limit);
 
+// Encode and decode one frame of |screen_size| with the whole screen dirty,
+// using a lossless encoder and decoder pair, and verify the decoded frame.
+void TestVideoEncoderDecoderLargeFrame(VideoEncoder* encoder,
+                                       VideoDecoder* decoder,
+                                       const SkISize& screen_size);
+
 }  // namespace remoting
 
 #endif  // REMOTING_CODEC_CODEC_TEST_H_
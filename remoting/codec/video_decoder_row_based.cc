@@ -4,6 +4,7 @@
 
 #include "remoting/codec/video_decoder_row_based.h"
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "remoting/base/decompressor.h"
 #include "remoting/base/decompressor_zlib.h"
@@ -15,26 +16,24 @@ namespace remoting {
 namespace {
 // Both input and output data are assumed to be RGBA32.
 const int kBytesPerPixel = 4;
+
+// Maximum number of rectangles decompressed at a time. Frames with more
+// rectangles than this are decoded in several batches.
+const size_t kMaxPendingRects = 32;
 }
 
 VideoDecoderRowBased* VideoDecoderRowBased::CreateZlibDecoder() {
-  return new VideoDecoderRowBased(new DecompressorZlib(),
-                                  VideoPacketFormat::ENCODING_ZLIB);
+  return new VideoDecoderRowBased(VideoPacketFormat::ENCODING_ZLIB);
 }
 
 VideoDecoderRowBased* VideoDecoderRowBased::CreateVerbatimDecoder() {
-  return new VideoDecoderRowBased(new DecompressorVerbatim(),
-                                  VideoPacketFormat::ENCODING_VERBATIM);
+  return new VideoDecoderRowBased(VideoPacketFormat::ENCODING_VERBATIM);
 }
 
-VideoDecoderRowBased::VideoDecoderRowBased(Decompressor* decompressor,
-                                           VideoPacketFormat::Encoding encoding)
+VideoDecoderRowBased::VideoDecoderRowBased(VideoPacketFormat::Encoding encoding)
     : state_(kUninitialized),
       clip_(SkIRect::MakeEmpty()),
-      decompressor_(decompressor),
       encoding_(encoding),
-      row_pos_(0),
-      row_y_(0),
       screen_size_(SkISize::Make(0, 0)) {
 }
 
@@ -57,7 +56,9 @@ bool VideoDecoderRowBased::IsReadyForData() {
 }
 
 void VideoDecoderRowBased::Initialize(const SkISize& screen_size) {
-  decompressor_->Reset();
+  task_group_.Wait();
+  pending_rects_.clear();
+  rect_data_.clear();
   updated_region_.setEmpty();
   screen_buffer_.reset(NULL);
 
@@ -79,56 +80,104 @@ VideoDecoder::DecodeResult VideoDecoderRowBased::DecodePacket(
     return DECODE_ERROR;
   }
 
-  const uint8* in = reinterpret_cast<const uint8*>(packet->data().data());
-  const int in_size = packet->data().size();
-  const int row_size = clip_.width() * kBytesPerPixel;
+  rect_data_.append(packet->data());
+
+  if (state_ == kPartitionDone || state_ == kDone) {
+    if (pending_rects_.size() == kMaxPendingRects && !FinishPendingRects()) {
+      state_ = kError;
+      return DECODE_ERROR;
+    }
+
+    if (decompressors_.size() == pending_rects_.size())
+      decompressors_.push_back(CreateDecompressor());
+
+    PendingRect* rect = new PendingRect();
+    rect->clip = clip_;
+    rect->data.swap(rect_data_);
+    rect->decompressor = decompressors_[pending_rects_.size()];
+    rect->succeeded = false;
+    pending_rects_.push_back(rect);
+    task_group_.PostTask(base::Bind(&VideoDecoderRowBased::DecodeRect,
+                                    base::Unretained(this), rect));
+  }
+
+  if (state_ == kDone) {
+    if (!FinishPendingRects()) {
+      state_ = kError;
+      return DECODE_ERROR;
+    }
+    return DECODE_DONE;
+  } else {
+    return DECODE_IN_PROGRESS;
+  }
+}
+
+Decompressor* VideoDecoderRowBased::CreateDecompressor() {
+  if (encoding_ == VideoPacketFormat::ENCODING_ZLIB)
+    return new DecompressorZlib();
+  DCHECK_EQ(encoding_, VideoPacketFormat::ENCODING_VERBATIM);
+  return new DecompressorVerbatim();
+}
+
+void VideoDecoderRowBased::DecodeRect(PendingRect* rect) {
+  const uint8* in = reinterpret_cast<const uint8*>(rect->data.data());
+  const int in_size = rect->data.size();
+  const int row_size = rect->clip.width() * kBytesPerPixel;
 
   int out_stride = screen_size_.width() * kBytesPerPixel;
-  uint8* out = screen_buffer_.get() + out_stride * (clip_.top() + row_y_) +
-      kBytesPerPixel * clip_.left();
+  uint8* out = screen_buffer_.get() + out_stride * rect->clip.top() +
+      kBytesPerPixel * rect->clip.left();
+
+  rect->decompressor->Reset();
 
-  // Consume all the data in the message.
+  // Consume all the data received for the rectangle.
+  int row_pos = 0;  // The position in the row that we are updating.
+  int row_y = 0;  // The current row in the rect that we are updating.
   bool decompress_again = true;
   int used = 0;
   while (decompress_again && used < in_size) {
-    if (row_y_ >= clip_.height()) {
-      state_ = kError;
+    if (row_y >= rect->clip.height()) {
       LOG(WARNING) << "Too much data is received for the given rectangle.";
-      return DECODE_ERROR;
+      return;
     }
 
     int written = 0;
     int consumed = 0;
-    decompress_again = decompressor_->Process(
-        in + used, in_size - used, out + row_pos_, row_size - row_pos_,
+    decompress_again = rect->decompressor->Process(
+        in + used, in_size - used, out + row_pos, row_size - row_pos,
         &consumed, &written);
     used += consumed;
-    row_pos_ += written;
+    row_pos += written;
 
     // If this row is completely filled then move onto the next row.
-    if (row_pos_ == row_size) {
-      ++row_y_;
-      row_pos_ = 0;
+    if (row_pos == row_size) {
+      ++row_y;
+      row_pos = 0;
       out += out_stride;
     }
   }
 
-  if (state_ == kPartitionDone || state_ == kDone) {
-    if (row_y_ < clip_.height()) {
-      state_ = kError;
-      LOG(WARNING) << "Received LAST_PACKET, but didn't get enough data.";
-      return DECODE_ERROR;
-    }
-
-    updated_region_.op(clip_, SkRegion::kUnion_Op);
-    decompressor_->Reset();
+  if (row_y < rect->clip.height()) {
+    LOG(WARNING) << "Received LAST_PACKET, but didn't get enough data.";
+    return;
   }
 
-  if (state_ == kDone) {
-    return DECODE_DONE;
-  } else {
-    return DECODE_IN_PROGRESS;
+  rect->succeeded = true;
+}
+
+bool VideoDecoderRowBased::FinishPendingRects() {
+  task_group_.Wait();
+
+  bool succeeded = true;
+  for (size_t i = 0; i < pending_rects_.size(); ++i) {
+    if (pending_rects_[i]->succeeded) {
+      updated_region_.op(pending_rects_[i]->clip, SkRegion::kUnion_Op);
+    } else {
+      succeeded = false;
+    }
   }
+  pending_rects_.clear();
+  return succeeded;
 }
 
 void VideoDecoderRowBased::UpdateStateForPacket(const VideoPacket* packet) {
@@ -200,6 +249,10 @@ void VideoDecoderRowBased::RenderFrame(const SkISize& view_size,
                                        SkRegion* output_region) {
   output_region->setEmpty();
 
+  // Rectangles still being decompressed may overlap the region that is
+  // about to be copied.
+  task_group_.Wait();
+
   // TODO(alexeypa): scaling is not implemented.
   SkIRect clip_rect = SkIRect::MakeSize(screen_size_);
   if (!clip_rect.intersect(clip_area))
@@ -5,14 +5,22 @@
 #ifndef REMOTING_CODEC_VIDEO_DECODER_ROW_BASED_H_
 #define REMOTING_CODEC_VIDEO_DECODER_ROW_BASED_H_
 
+#include <string>
+
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "remoting/base/worker_task_group.h"
 #include "remoting/codec/video_decoder.h"
 
 namespace remoting {
 
 class Decompressor;
 
+// VideoDecoderRowBased decodes the output of VideoEncoderRowBased. Each
+// rectangle is compressed independently, so once a rectangle has been
+// received in full it is decompressed on a worker thread while the next one
+// is being received.
 class VideoDecoderRowBased : public VideoDecoder {
  public:
   virtual ~VideoDecoderRowBased();
@@ -43,29 +51,46 @@ class VideoDecoderRowBased : public VideoDecoder {
     kError,
   };
 
-  VideoDecoderRowBased(Decompressor* decompressor,
-                       VideoPacketFormat::Encoding encoding);
+  // A rectangle that has been received in full and is being decompressed.
+  struct PendingRect {
+    SkIRect clip;
+    std::string data;
+    Decompressor* decompressor;
+    bool succeeded;
+  };
+
+  explicit VideoDecoderRowBased(VideoPacketFormat::Encoding encoding);
+
+  // Creates a decompressor for |encoding_|.
+  Decompressor* CreateDecompressor();
 
   // Helper method. Called from DecodePacket to updated state of the decoder.
   void UpdateStateForPacket(const VideoPacket* packet);
 
+  // Decompresses |rect| into the screen buffer. Called on a worker thread.
+  void DecodeRect(PendingRect* rect);
+
+  // Waits for the pending rectangles to be decompressed and adds them to
+  // |updated_region_|. Returns false if any of them was invalid.
+  bool FinishPendingRects();
+
   // The internal state of the decoder.
   State state_;
 
   // Keeps track of the updating rect.
   SkIRect clip_;
 
-  // The compression for the input byte stream.
-  scoped_ptr<Decompressor> decompressor_;
-
   // The encoding of the incoming stream.
   VideoPacketFormat::Encoding encoding_;
 
-  // The position in the row that we are updating.
-  int row_pos_;
+  // The data received so far for the rect that we are updating.
+  std::string rect_data_;
 
-  // The current row in the rect that we are updaing.
-  int row_y_;
+  // Decompressors, one for each rectangle that can be pending at a time.
+  ScopedVector<Decompressor> decompressors_;
+
+  // Rectangles of the current frame that are being decompressed.
+  ScopedVector<PendingRect> pending_rects_;
 
   // The region updated that hasn't been copied to the screen yet.
   SkRegion updated_region_;
@@ -76,6 +101,10 @@ class VideoDecoderRowBased : public VideoDecoder {
   // The bitmap holding the remote screen bits.
   scoped_array<uint8> screen_buffer_;
 
+  // Runs DecodeRect(). Declared last so that it waits for the tasks before
+  // the buffers they use are destroyed.
+  WorkerTaskGroup task_group_;
+
   DISALLOW_COPY_AND_ASSIGN(VideoDecoderRowBased);
 };
 
@@ -0,0 +1,132 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/perftimer.h"
+#include "media/base/video_frame.h"
+#include "remoting/base/capture_data.h"
+#include "remoting/codec/video_decoder_row_based.h"
+#include "remoting/codec/video_encoder_row_based.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace remoting {
+
+namespace {
+
+const int kBytesPerPixel = 4;
+
+// Frames encoded and decoded per codec.
+const int kFrameCount = 5;
+
+// Collects the packets produced by an encoder.
+class VideoPacketCollector {
+ public:
+  VideoPacketCollector() {}
+
+  void DataAvailable(scoped_ptr<VideoPacket> packet) {
+    packets_.push_back(packet.release());
+  }
+
+  const ScopedVector<VideoPacket>& packets() const { return packets_; }
+
+ private:
+  ScopedVector<VideoPacket> packets_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoPacketCollector);
+};
+
+// Encodes and decodes full HD frames with the whole screen dirty and logs the
+// throughput of the encoder and of the decoder in MPixel/s.
+void MeasureThroughput(const char* name,
+                       VideoEncoder* encoder,
+                       VideoDecoder* decoder) {
+  const SkISize screen_size = SkISize::Make(1920, 1080);
+  const SkIRect screen_rect = SkIRect::MakeSize(screen_size);
+  const int stride = screen_size.width() * kBytesPerPixel;
+
+  // A gradient, which compresses about as well as typical desktop content.
+  scoped_array<uint8> screen_data(new uint8[stride * screen_size.height()]);
+  for (int y = 0; y < screen_size.height(); ++y) {
+    uint8* p = screen_data.get() + y * stride;
+    for (int x = 0; x < screen_size.width(); ++x) {
+      *p++ = static_cast<uint8>((255 * x) / screen_size.width());
+      *p++ = static_cast<uint8>((164 * y) / screen_size.height());
+      *p++ = static_cast<uint8>((82 * (x + y)) /
+                                (screen_size.width() + screen_size.height()));
+      *p++ = 0;
+    }
+  }
+  scoped_array<uint8> image_data(new uint8[stride * screen_size.height()]);
+
+  DataPlanes planes;
+  memset(planes.data, 0, sizeof(planes.data));
+  memset(planes.strides, 0, sizeof(planes.strides));
+  planes.data[0] = screen_data.get();
+  planes.strides[0] = stride;
+
+  scoped_refptr<CaptureData> capture_data =
+      new CaptureData(planes, screen_size, media::VideoFrame::RGB32);
+  capture_data->mutable_dirty_region().op(screen_rect, SkRegion::kUnion_Op);
+
+  decoder->Initialize(screen_size);
+
+  base::TimeDelta encode_time;
+  base::TimeDelta decode_time;
+  for (int i = 0; i < kFrameCount; ++i) {
+    VideoPacketCollector collector;
+    PerfTimer encode_timer;
+    encoder->Encode(capture_data, true,
+                    base::Bind(&VideoPacketCollector::DataAvailable,
+                               base::Unretained(&collector)));
+    encode_time += encode_timer.Elapsed();
+
+    PerfTimer decode_timer;
+    for (size_t j = 0; j < collector.packets().size(); ++j) {
+      VideoDecoder::DecodeResult result =
+          decoder->DecodePacket(collector.packets()[j]);
+      ASSERT_NE(VideoDecoder::DECODE_ERROR, result);
+      if (result == VideoDecoder::DECODE_DONE) {
+        SkRegion update_region;
+        decoder->RenderFrame(screen_size, screen_rect, image_data.get(),
+                             stride, &update_region);
+      }
+    }
+    decode_time += decode_timer.Elapsed();
+  }
+
+  double megapixels = static_cast<double>(kFrameCount) * screen_size.width() *
+      screen_size.height() / 1000000.0;
+  LogPerfResult((std::string(name) + "_encode").c_str(),
+                megapixels / encode_time.InSecondsF(), "MPixel/s");
+  LogPerfResult((std::string(name) + "_decode").c_str(),
+                megapixels / decode_time.InSecondsF(), "MPixel/s");
+}
+
+}  // namespace
+
+TEST(VideoEncodeDecodePerfTest, LargeFrameZlib) {
+  scoped_ptr<VideoEncoderRowBased> encoder(
+      VideoEncoderRowBased::CreateZlibEncoder());
+  scoped_ptr<VideoDecoderRowBased> decoder(
+      VideoDecoderRowBased::CreateZlibDecoder());
+  MeasureThroughput("RowBasedZlib", encoder.get(), decoder.get());
+}
+
+TEST(VideoEncodeDecodePerfTest, LargeFrameVerbatim) {
+  scoped_ptr<VideoEncoderRowBased> encoder(
+      VideoEncoderRowBased::CreateVerbatimEncoder());
+  scoped_ptr<VideoDecoderRowBased> decoder(
+      VideoDecoderRowBased::CreateVerbatimDecoder());
+  MeasureThroughput("RowBasedVerbatim", encoder.get(), decoder.get());
+}
+
+}  // namespace remoting
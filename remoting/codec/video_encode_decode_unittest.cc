@@ -35,4 +35,24 @@ TEST(EncodeDecodeTest, EncodeAndDecodeNoneStrictZlib) {
   TestVideoEncoderDecoder(encoder.get(), decoder.get(), false);
 }
 
+// A full HD frame is split into stripes that are encoded and decoded in
+// parallel.
+TEST(EncodeDecodeTest, EncodeAndDecodeLargeFrameZlib) {
+  scoped_ptr<VideoEncoderRowBased> encoder(
+      VideoEncoderRowBased::CreateZlibEncoder());
+  scoped_ptr<VideoDecoderRowBased> decoder(
+      VideoDecoderRowBased::CreateZlibDecoder());
+  TestVideoEncoderDecoderLargeFrame(encoder.get(), decoder.get(),
+                                    SkISize::Make(1920, 1080));
+}
+
+TEST(EncodeDecodeTest, EncodeAndDecodeLargeFrameVerbatim) {
+  scoped_ptr<VideoEncoderRowBased> encoder(
+      VideoEncoderRowBased::CreateVerbatimEncoder());
+  scoped_ptr<VideoDecoderRowBased> decoder(
+      VideoDecoderRowBased::CreateVerbatimDecoder());
+  TestVideoEncoderDecoderLargeFrame(encoder.get(), decoder.get(),
+                                    SkISize::Make(1920, 1080));
+}
+
 }  // namespace remoting
@@ -4,53 +4,58 @@
 
 #include "remoting/codec/video_encoder_row_based.h"
 
+#include <algorithm>
+
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/stl_util.h"
 #include "remoting/base/capture_data.h"
 #include "remoting/base/compressor_verbatim.h"
 #include "remoting/base/compressor_zlib.h"
 #include "remoting/base/util.h"
+#include "remoting/base/worker_task_group.h"
 #include "remoting/proto/video.pb.h"
 
 namespace remoting {
 
 static const int kPacketSize = 1024 * 1024;
 
+// Rectangles are split into stripes of at least this many pixels. Smaller
+// stripes compress worse and aren't worth the cost of a worker task.
+static const int kMinStripePixels = 256 * 256;
+
+// Extra output space kept on top of the remaining input when compressing, so
+// that the compressor can always finish the stream.
+static const int kOutputSlack = 64;
+
 VideoEncoderRowBased* VideoEncoderRowBased::CreateZlibEncoder() {
-  return new VideoEncoderRowBased(new CompressorZlib(),
-                                  VideoPacketFormat::ENCODING_ZLIB);
+  return new VideoEncoderRowBased(VideoPacketFormat::ENCODING_ZLIB);
 }
 
 VideoEncoderRowBased* VideoEncoderRowBased::CreateZlibEncoder(int packet_size) {
-  return new VideoEncoderRowBased(new CompressorZlib(),
-                                  VideoPacketFormat::ENCODING_ZLIB,
+  return new VideoEncoderRowBased(VideoPacketFormat::ENCODING_ZLIB,
                                   packet_size);
 }
 
 VideoEncoderRowBased* VideoEncoderRowBased::CreateVerbatimEncoder() {
-  return new VideoEncoderRowBased(new CompressorVerbatim(),
-                                  VideoPacketFormat::ENCODING_VERBATIM);
+  return new VideoEncoderRowBased(VideoPacketFormat::ENCODING_VERBATIM);
 }
 
 VideoEncoderRowBased* VideoEncoderRowBased::CreateVerbatimEncoder(
     int packet_size) {
-  return new VideoEncoderRowBased(new CompressorVerbatim(),
-                                  VideoPacketFormat::ENCODING_VERBATIM,
+  return new VideoEncoderRowBased(VideoPacketFormat::ENCODING_VERBATIM,
                                   packet_size);
 }
 
-VideoEncoderRowBased::VideoEncoderRowBased(Compressor* compressor,
-                                           VideoPacketFormat::Encoding encoding)
+VideoEncoderRowBased::VideoEncoderRowBased(VideoPacketFormat::Encoding encoding)
     : encoding_(encoding),
-      compressor_(compressor),
       screen_size_(SkISize::Make(0,0)),
       packet_size_(kPacketSize) {
 }
 
-VideoEncoderRowBased::VideoEncoderRowBased(Compressor* compressor,
-                                           VideoPacketFormat::Encoding encoding,
+VideoEncoderRowBased::VideoEncoderRowBased(VideoPacketFormat::Encoding encoding,
                                            int packet_size)
     : encoding_(encoding),
-      compressor_(compressor),
       screen_size_(SkISize::Make(0,0)),
       packet_size_(packet_size) {
 }
@@ -64,47 +69,93 @@ void VideoEncoderRowBased::Encode(
   CHECK(capture_data->pixel_format() == media::VideoFrame::RGB32)
       << "RowBased VideoEncoder only works with RGB32. Got "
       << capture_data->pixel_format();
+  CHECK(capture_data->data_planes().data[0]);
   capture_data_ = capture_data;
   callback_ = data_available_callback;
 
-  const SkRegion& region = capture_data->dirty_region();
-  SkRegion::Iterator iter(region);
-  while (!iter.done()) {
-    SkIRect rect = iter.rect();
-    iter.next();
-    EncodeRect(rect, iter.done());
+  std::vector<SkIRect> stripes;
+  GetStripes(&stripes);
+
+  // Each task compresses an interleaved subset of the stripes with its own
+  // compressor, so that the work is spread evenly.
+  size_t tasks = std::min(
+      stripes.size(),
+      static_cast<size_t>(WorkerTaskGroup::GetMaxParallelTasks()));
+  while (compressors_.size() < tasks)
+    compressors_.push_back(CreateCompressor());
+
+  std::vector<std::string> compressed(stripes.size());
+  {
+    WorkerTaskGroup task_group;
+    for (size_t i = 0; i < tasks; ++i) {
+      task_group.PostTask(base::Bind(
+          &VideoEncoderRowBased::CompressStripes, base::Unretained(this),
+          compressors_[i], &stripes, i, tasks, &compressed));
+    }
+    task_group.Wait();
   }
 
+  for (size_t i = 0; i < stripes.size(); ++i)
+    SubmitStripe(stripes[i], compressed[i], i == stripes.size() - 1);
+
   capture_data_ = NULL;
   callback_.Reset();
 }
 
-void VideoEncoderRowBased::EncodeRect(const SkIRect& rect, bool last) {
-  CHECK(capture_data_->data_planes().data[0]);
-  CHECK_EQ(capture_data_->pixel_format(), media::VideoFrame::RGB32);
+Compressor* VideoEncoderRowBased::CreateCompressor() {
+  if (encoding_ == VideoPacketFormat::ENCODING_ZLIB)
+    return new CompressorZlib();
+  DCHECK_EQ(encoding_, VideoPacketFormat::ENCODING_VERBATIM);
+  return new CompressorVerbatim();
+}
+
+void VideoEncoderRowBased::GetStripes(std::vector<SkIRect>* stripes) {
+  int max_stripes = WorkerTaskGroup::GetMaxParallelTasks();
+  for (SkRegion::Iterator iter(capture_data_->dirty_region()); !iter.done();
+       iter.next()) {
+    const SkIRect& rect = iter.rect();
+    int count = std::min(
+        max_stripes, rect.width() * rect.height() / kMinStripePixels);
+    count = std::max(count, 1);
+    for (int i = 0; i < count; ++i) {
+      stripes->push_back(SkIRect::MakeLTRB(
+          rect.fLeft, rect.fTop + rect.height() * i / count,
+          rect.fRight, rect.fTop + rect.height() * (i + 1) / count));
+    }
+  }
+}
+
+void VideoEncoderRowBased::CompressStripes(
+    Compressor* compressor,
+    const std::vector<SkIRect>* stripes,
+    size_t first,
+    size_t step,
+    std::vector<std::string>* output) {
+  for (size_t i = first; i < stripes->size(); i += step)
+    CompressStripe(compressor, (*stripes)[i], &(*output)[i]);
+}
+
+void VideoEncoderRowBased::CompressStripe(Compressor* compressor,
+                                          const SkIRect& rect,
+                                          std::string* output) {
   const int strides = capture_data_->data_planes().strides[0];
   const int bytes_per_pixel = 4;
   const int row_size = bytes_per_pixel * rect.width();
 
-  compressor_->Reset();
+  compressor->Reset();
 
-  scoped_ptr<VideoPacket> packet(new VideoPacket());
-  PrepareUpdateStart(rect, packet.get());
   const uint8* in = capture_data_->data_planes().data[0] +
       rect.fTop * strides + rect.fLeft * bytes_per_pixel;
-  // TODO(hclam): Fill in the sequence number.
-  uint8* out = GetOutputBuffer(packet.get(), packet_size_);
   int filled = 0;
   int row_pos = 0;  // Position in the current row in bytes.
   int row_y = 0;  // Current row.
   bool compress_again = true;
   while (compress_again) {
-    // Prepare a message for sending out.
-    if (!packet.get()) {
-      packet.reset(new VideoPacket());
-      out = GetOutputBuffer(packet.get(), packet_size_);
-      filled = 0;
-    }
+    // Keep room for at least the rest of the row, so that the last row can
+    // always be finished in one call.
+    size_t needed = filled + row_size - row_pos + kOutputSlack;
+    if (output->size() < needed)
+      output->resize(std::max(needed, output->size() * 2));
 
     Compressor::CompressorFlush flush = Compressor::CompressorNoFlush;
     if (row_y == rect.height() - 1) {
@@ -113,14 +164,44 @@ void VideoEncoderRowBased::EncodeRect(const SkIRect& rect, bool last) {
 
     int consumed = 0;
     int written = 0;
-    compress_again = compressor_->Process(in + row_pos, row_size - row_pos,
-                                          out + filled, packet_size_ - filled,
-                                          flush, &consumed, &written);
+    compress_again = compressor->Process(
+        in + row_pos, row_size - row_pos,
+        reinterpret_cast<uint8*>(string_as_array(output)) + filled,
+        output->size() - filled, flush, &consumed, &written);
     row_pos += consumed;
     filled += written;
 
+    // Reached the end of input row and we're not at the last row.
+    if (row_pos == row_size && row_y < rect.height() - 1) {
+      row_pos = 0;
+      in += strides;
+      ++row_y;
+    }
+  }
+  DCHECK_EQ(row_pos, row_size);
+  DCHECK_EQ(row_y, rect.height() - 1);
+  output->resize(filled);
+}
+
+void VideoEncoderRowBased::SubmitStripe(const SkIRect& rect,
+                                        const std::string& data,
+                                        bool last) {
+  size_t pos = 0;
+  bool first = true;
+  while (first || pos < data.size()) {
+    scoped_ptr<VideoPacket> packet(new VideoPacket());
+    if (first) {
+      PrepareUpdateStart(rect, packet.get());
+      first = false;
+    }
+
+    size_t size = std::min(data.size() - pos,
+                           static_cast<size_t>(packet_size_));
+    packet->mutable_data()->assign(data, pos, size);
+    pos += size;
+
     // We have reached the end of stream.
-    if (!compress_again) {
+    if (pos == data.size()) {
       packet->set_flags(packet->flags() | VideoPacket::LAST_PACKET);
       packet->set_capture_time_ms(capture_data_->capture_time_ms());
       packet->set_client_sequence_number(
@@ -132,22 +213,9 @@ void VideoEncoderRowBased::EncodeRect(const SkIRect& rect, bool last) {
         packet->mutable_format()->set_y_dpi(dpi.y());
       if (last)
         packet->set_flags(packet->flags() | VideoPacket::LAST_PARTITION);
-      DCHECK(row_pos == row_size);
-      DCHECK(row_y == rect.height() - 1);
-    }
-
-    // If we have filled the message or we have reached the end of stream.
-    if (filled == packet_size_ || !compress_again) {
-      packet->mutable_data()->resize(filled);
-      callback_.Run(packet.Pass());
     }
 
-    // Reached the end of input row and we're not at the last row.
-    if (row_pos == row_size && row_y < rect.height() - 1) {
-      row_pos = 0;
-      in += strides;
-      ++row_y;
-    }
+    callback_.Run(packet.Pass());
   }
 }
 
@@ -168,11 +236,4 @@ void VideoEncoderRowBased::PrepareUpdateStart(const SkIRect& rect,
   }
 }
 
-uint8* VideoEncoderRowBased::GetOutputBuffer(VideoPacket* packet, size_t size) {
-  packet->mutable_data()->resize(size);
-  // TODO(ajwong): Is there a better way to do this at all???
-  return const_cast<uint8*>(reinterpret_cast<const uint8*>(
-      packet->mutable_data()->data()));
-}
-
 }  // namespace remoting
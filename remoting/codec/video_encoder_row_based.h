@@ -5,6 +5,10 @@
 #ifndef REMOTING_CODEC_VIDEO_ENCODER_ROW_BASED_H_
 #define REMOTING_CODEC_VIDEO_ENCODER_ROW_BASED_H_
 
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_vector.h"
 #include "remoting/codec/video_encoder.h"
 #include "remoting/proto/video.pb.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -18,8 +22,9 @@ class Compressor;
 // CreateZlibEncoder(), verbatim encoder is created with
 // CreateVerbatimEncoder().
 //
-// Compressor is reset before encoding each rectangle, so that each
-// rectangle can be decoded independently.
+// Large rectangles are split into horizontal stripes. Compressor is reset
+// before encoding each stripe, so that each stripe can be decoded
+// independently, and the stripes of a frame are compressed in parallel.
 class VideoEncoderRowBased : public VideoEncoder {
  public:
   static VideoEncoderRowBased* CreateZlibEncoder();
@@ -35,29 +40,44 @@ class VideoEncoderRowBased : public VideoEncoder {
       const DataAvailableCallback& data_available_callback) OVERRIDE;
 
  private:
-  VideoEncoderRowBased(Compressor* compressor,
-                       VideoPacketFormat::Encoding encoding);
-  VideoEncoderRowBased(Compressor* compressor,
-                       VideoPacketFormat::Encoding encoding,
+  explicit VideoEncoderRowBased(VideoPacketFormat::Encoding encoding);
+  VideoEncoderRowBased(VideoPacketFormat::Encoding encoding,
                        int packet_size);
 
-  // Encode a single dirty rect using compressor.
-  void EncodeRect(const SkIRect& rect, bool last);
+  // Creates a compressor for |encoding_|.
+  Compressor* CreateCompressor();
+
+  // Splits the dirty region of |capture_data_| into the stripes that are
+  // compressed independently.
+  void GetStripes(std::vector<SkIRect>* stripes);
+
+  // Compresses every |step|th stripe in |stripes|, starting with |first|,
+  // into |output| using |compressor|. Called on a worker thread.
+  void CompressStripes(Compressor* compressor,
+                       const std::vector<SkIRect>* stripes,
+                       size_t first,
+                       size_t step,
+                       std::vector<std::string>* output);
+
+  // Compresses a single stripe into |output|.
+  void CompressStripe(Compressor* compressor,
+                      const SkIRect& rect,
+                      std::string* output);
+
+  // Splits the compressed data of a stripe into packets and submits them.
+  void SubmitStripe(const SkIRect& rect, const std::string& data, bool last);
 
   // Marks a packet as the first in a series of rectangle updates.
   void PrepareUpdateStart(const SkIRect& rect, VideoPacket* packet);
 
-  // Retrieves a pointer to the output buffer in |update| used for storing the
-  // encoded rectangle data.  Will resize the buffer to |size|.
-  uint8* GetOutputBuffer(VideoPacket* packet, size_t size);
-
   // Submit |message| to |callback_|.
   void SubmitMessage(VideoPacket* packet, size_t rect_index);
 
   // The encoding of the incoming stream.
   VideoPacketFormat::Encoding encoding_;
 
-  scoped_ptr<Compressor> compressor_;
+  // One compressor for each stripe that is compressed in parallel.
+  ScopedVector<Compressor> compressors_;
 
   scoped_refptr<CaptureData> capture_data_;
   DataAvailableCallback callback_;
@@ -4,6 +4,8 @@
 
 #include "remoting/codec/video_encoder_vp8.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/sys_info.h"
 #include "media/base/yuv_convert.h"
@@ -22,6 +24,40 @@ namespace {
 // map for the encoder.
 const int kMacroBlockSize = 16;
 
+// Quantizer range used while encoding keeps within the latency budget.
+const int kMinQuantizer = 20;
+const int kMaxQuantizer = 30;
+
+// Highest the top of the quantizer range is raised to while encoding is too
+// slow.  Text becomes hard to read beyond this.
+const int kMaxQuantizerLimit = 50;
+
+// Amount by which the quantizer range is moved at each adjustment.
+const int kQuantizerStep = 2;
+
+// Time each frame should be encoded within.  Frames are captured at up to 20
+// per second, so this leaves half of each frame interval for capturing and
+// sending.
+const int kEncodeTimeBudgetMs = 25;
+
+// Weight of the latest frame in the moving average of encode times.
+const double kEncodeTimeWeight = 0.2;
+
+// libvpx splits a frame's residual tokens into at most eight partitions, which
+// bounds how many threads it can encode with.
+const int kMaxEncoderThreads = 8;
+
+// Returns the number of threads to encode with.  Half the cores are left for
+// capturing and sending.  Machines with two or fewer cores get one thread,
+// since more threads can really hurt low-end Windows systems.
+// http://crbug.com/99179
+int GetEncoderThreadCount() {
+  int cores = base::SysInfo::NumberOfProcessors();
+  if (cores <= 2)
+    return 1;
+  return std::min(cores / 2, kMaxEncoderThreads);
+}
+
 }  // namespace remoting
 
 namespace remoting {
@@ -32,7 +68,8 @@ VideoEncoderVp8::VideoEncoderVp8()
       image_(NULL),
       active_map_width_(0),
       active_map_height_(0),
-      last_timestamp_(0) {
+      last_timestamp_(0),
+      average_encode_time_ms_(0) {
 }
 
 VideoEncoderVp8::~VideoEncoderVp8() {
@@ -100,8 +137,10 @@ bool VideoEncoderVp8::Init(const SkISize& size) {
   image_->stride[1] = uv_width;
   image_->stride[2] = uv_width;
 
-  // Configure the encoder.
-  vpx_codec_enc_cfg_t config;
+  // Configure the encoder.  The configuration is kept so that the quantizer
+  // range can be changed while encoding.
+  config_.reset(new vpx_codec_enc_cfg_t());
+  vpx_codec_enc_cfg_t& config = *config_;
   const vpx_codec_iface_t* algo = vpx_codec_vp8_cx();
   CHECK(algo);
   vpx_codec_err_t ret = vpx_codec_enc_config_default(algo, &config, 0);
@@ -119,19 +158,26 @@ bool VideoEncoderVp8::Init(const SkISize& size) {
   // encoding.
   config.g_profile = 2;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config.g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
-  config.rc_min_quantizer = 20;
-  config.rc_max_quantizer = 30;
+  config.g_threads = GetEncoderThreadCount();
+  config.rc_min_quantizer = kMinQuantizer;
+  config.rc_max_quantizer = kMaxQuantizer;
   config.g_timebase.num = 1;
   config.g_timebase.den = 20;
+  average_encode_time_ms_ = 0;
 
   if (vpx_codec_enc_init(codec_.get(), algo, &config, 0))
     return false;
 
+  // Threads encode the token partitions in parallel, so use one partition per
+  // thread.  The partition count is given as its log2.
+  int partitions = 0;
+  while ((2 << partitions) <= static_cast<int>(config.g_threads))
+    ++partitions;
+  if (vpx_codec_control(codec_.get(), VP8E_SET_TOKEN_PARTITIONS,
+                        static_cast<vp8e_token_partitions>(partitions))) {
+    return false;
+  }
+
   // Value of 16 will have the smallest CPU load. This turns off subpixel
   // motion search.
   if (vpx_codec_control(codec_.get(), VP8E_SET_CPUUSED, 16))
@@ -213,6 +259,28 @@ void VideoEncoderVp8::PrepareActiveMap(const SkRegion& updated_region) {
   }
 }
 
+void VideoEncoderVp8::AdjustQuantizer(base::TimeDelta encode_time) {
+  average_encode_time_ms_ =
+      kEncodeTimeWeight * encode_time.InMillisecondsF() +
+      (1 - kEncodeTimeWeight) * average_encode_time_ms_;
+
+  int step;
+  if (average_encode_time_ms_ > kEncodeTimeBudgetMs &&
+      static_cast<int>(config_->rc_max_quantizer) < kMaxQuantizerLimit) {
+    step = kQuantizerStep;
+  } else if (average_encode_time_ms_ < kEncodeTimeBudgetMs / 2 &&
+             static_cast<int>(config_->rc_min_quantizer) > kMinQuantizer) {
+    step = -kQuantizerStep;
+  } else {
+    return;
+  }
+
+  config_->rc_min_quantizer += step;
+  config_->rc_max_quantizer += step;
+  if (vpx_codec_enc_config_set(codec_.get(), config_.get()) != VPX_CODEC_OK)
+    LOG(ERROR) << "Unable to change the quantizer range";
+}
+
 void VideoEncoderVp8::Encode(
     scoped_refptr<CaptureData> capture_data,
     bool key_frame,
@@ -228,6 +296,8 @@ void VideoEncoderVp8::Encode(
     initialized_ = ret;
   }
 
+  base::Time encode_start_time = base::Time::Now();
+
   // Convert the updated capture data ready for encode.
   SkRegion updated_region;
   PrepareImage(capture_data, &updated_region);
@@ -281,6 +351,8 @@ void VideoEncoderVp8::Encode(
     }
   }
 
+  AdjustQuantizer(base::Time::Now() - encode_start_time);
+
   // Construct the VideoPacket message.
   packet->mutable_format()->set_encoding(VideoPacketFormat::ENCODING_VP8);
   packet->set_flags(VideoPacket::FIRST_PACKET | VideoPacket::LAST_PACKET |
@@ -6,10 +6,12 @@
 #define REMOTING_CODEC_VIDEO_ENCODER_VP8_H_
 
 #include "base/gtest_prod_util.h"
+#include "base/time.h"
 #include "remoting/codec/video_encoder.h"
 #include "third_party/skia/include/core/SkRegion.h"
 
 typedef struct vpx_codec_ctx vpx_codec_ctx_t;
+typedef struct vpx_codec_enc_cfg vpx_codec_enc_cfg_t;
 typedef struct vpx_image vpx_image_t;
 
 namespace remoting {
@@ -27,6 +29,7 @@ class VideoEncoderVp8 : public VideoEncoder {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(VideoEncoderVp8Test, AlignAndClipRect);
+  FRIEND_TEST_ALL_PREFIXES(VideoEncoderVp8Test, AdaptiveQuantizer);
 
   // Initialize the encoder. Returns true if successful.
   bool Init(const SkISize& size);
@@ -43,16 +46,25 @@ class VideoEncoderVp8 : public VideoEncoder {
   // given to the encoder to speed up encoding.
   void PrepareActiveMap(const SkRegion& updated_region);
 
+  // Moves the quantizer range up while frames take longer than the latency
+  // budget to encode, trading quality for speed, and back down once there is
+  // time to spare.  |encode_time| is the time taken by the latest frame.
+  void AdjustQuantizer(base::TimeDelta encode_time);
+
   // True if the encoder is initialized.
   bool initialized_;
 
   scoped_ptr<vpx_codec_ctx_t> codec_;
+  scoped_ptr<vpx_codec_enc_cfg_t> config_;
   scoped_ptr<vpx_image_t> image_;
   scoped_array<uint8> active_map_;
   int active_map_width_;
   int active_map_height_;
   int last_timestamp_;
 
+  // Moving average of the time taken to encode a frame.
+  double average_encode_time_ms_;
+
   // Buffer for storing the yuv image.
   scoped_array<uint8> yuv_image_;
 
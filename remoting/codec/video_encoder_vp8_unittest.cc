@@ -15,6 +15,11 @@
 #include "remoting/proto/video.pb.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+extern "C" {
+#define VPX_CODEC_DISABLE_COMPAT 1
+#include "third_party/libvpx/libvpx.h"
+}
+
 namespace {
 
 const int kIntMax = std::numeric_limits<int>::max();
@@ -94,4 +99,40 @@ TEST(VideoEncoderVp8Test, TestDpiPropagation) {
                             base::Unretained(&callback)));
 }
 
+// Test that the quantizer range rises while frames are slow to encode, stays
+// within its limit, and returns to the defaults once encoding is fast again.
+TEST(VideoEncoderVp8Test, AdaptiveQuantizer) {
+  int height = 32;
+  int width = 32;
+  const int kBytesPerPixel = 4;
+
+  VideoEncoderVp8 encoder;
+  VideoEncoderCallback callback;
+
+  std::vector<uint8> buffer(width * height * kBytesPerPixel);
+  DataPlanes planes;
+  planes.data[0] = &buffer.front();
+  planes.strides[0] = width;
+
+  scoped_refptr<CaptureData> capture_data(new CaptureData(
+      planes, SkISize::Make(width, height), media::VideoFrame::RGB32));
+  encoder.Encode(capture_data, false,
+                 base::Bind(&VideoEncoderCallback::DataAvailable,
+                            base::Unretained(&callback)));
+  const unsigned int min_quantizer = encoder.config_->rc_min_quantizer;
+  const unsigned int max_quantizer = encoder.config_->rc_max_quantizer;
+
+  for (int i = 0; i < 100; ++i)
+    encoder.AdjustQuantizer(base::TimeDelta::FromMilliseconds(200));
+  EXPECT_GT(encoder.config_->rc_max_quantizer, max_quantizer);
+  EXPECT_LE(encoder.config_->rc_max_quantizer, 63U);
+  EXPECT_LT(encoder.config_->rc_min_quantizer,
+            encoder.config_->rc_max_quantizer);
+
+  for (int i = 0; i < 100; ++i)
+    encoder.AdjustQuantizer(base::TimeDelta());
+  EXPECT_EQ(min_quantizer, encoder.config_->rc_min_quantizer);
+  EXPECT_EQ(max_quantizer, encoder.config_->rc_max_quantizer);
+}
+
 }  // namespace remoting
@@ -32,7 +32,8 @@ namespace remoting {
 CaptureScheduler::CaptureScheduler()
     : num_of_processors_(base::SysInfo::NumberOfProcessors()),
       capture_time_(kStatisticsWindow),
-      encode_time_(kStatisticsWindow) {
+      encode_time_(kStatisticsWindow),
+      send_time_(kStatisticsWindow) {
   DCHECK(num_of_processors_);
 }
 
@@ -47,6 +48,10 @@ base::TimeDelta CaptureScheduler::NextCaptureDelay() {
       (capture_time_.Average() + encode_time_.Average()) /
       (kRecordingCpuConsumption * num_of_processors_);
 
+  // Don't capture faster than the network sends frames, otherwise they
+  // queue up in the channel and latency grows with the queue.
+  delay = std::max(delay, send_time_.Average());
+
   if (delay < kMinimumRecordingDelay)
     return base::TimeDelta::FromMilliseconds(kMinimumRecordingDelay);
   return base::TimeDelta::FromMilliseconds(delay);
@@ -60,4 +65,8 @@ void CaptureScheduler::RecordEncodeTime(base::TimeDelta encode_time) {
   encode_time_.Record(encode_time.InMilliseconds());
 }
 
+void CaptureScheduler::RecordSendTime(base::TimeDelta send_time) {
+  send_time_.Record(send_time.InMilliseconds());
+}
+
 }  // namespace remoting
@@ -4,7 +4,8 @@
 
 // This class chooses a capture interval so as to limit CPU usage to not exceed
 // a specified %age. It bases this on the CPU usage of recent capture and encode
-// operations, and on the number of available CPUs.
+// operations, and on the number of available CPUs. Captures are also paced so
+// that frames are not produced faster than the network is sending them.
 
 #ifndef REMOTING_HOST_CAPTURE_SCHEDULER_H_
 #define REMOTING_HOST_CAPTURE_SCHEDULER_H_
@@ -26,10 +27,15 @@ class CaptureScheduler {
   void RecordCaptureTime(base::TimeDelta capture_time);
   void RecordEncodeTime(base::TimeDelta encode_time);
 
+  // Record time the network channel spent sending one frame, i.e. from when
+  // the channel started on the frame until the last packet was sent.
+  void RecordSendTime(base::TimeDelta send_time);
+
  private:
   int num_of_processors_;
   RunningAverage capture_time_;
   RunningAverage encode_time_;
+  RunningAverage send_time_;
 
   DISALLOW_COPY_AND_ASSIGN(CaptureScheduler);
 };
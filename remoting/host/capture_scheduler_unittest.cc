@@ -0,0 +1,37 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "remoting/host/capture_scheduler.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace remoting {
+
+TEST(CaptureSchedulerTest, MinimumDelay) {
+  CaptureScheduler scheduler;
+  EXPECT_EQ(50, scheduler.NextCaptureDelay().InMilliseconds());
+
+  scheduler.RecordCaptureTime(base::TimeDelta::FromMilliseconds(1));
+  scheduler.RecordEncodeTime(base::TimeDelta::FromMilliseconds(1));
+  scheduler.RecordSendTime(base::TimeDelta::FromMilliseconds(1));
+  EXPECT_EQ(50, scheduler.NextCaptureDelay().InMilliseconds());
+}
+
+// Captures should be paced to the network when it is the bottleneck.
+TEST(CaptureSchedulerTest, SlowNetwork) {
+  CaptureScheduler scheduler;
+  for (int i = 0; i < 3; ++i) {
+    scheduler.RecordCaptureTime(base::TimeDelta::FromMilliseconds(5));
+    scheduler.RecordEncodeTime(base::TimeDelta::FromMilliseconds(10));
+    scheduler.RecordSendTime(base::TimeDelta::FromMilliseconds(300));
+  }
+  EXPECT_EQ(300, scheduler.NextCaptureDelay().InMilliseconds());
+
+  // Once the network catches up the delay drops back.
+  for (int i = 0; i < 3; ++i)
+    scheduler.RecordSendTime(base::TimeDelta::FromMilliseconds(20));
+  EXPECT_EQ(50, scheduler.NextCaptureDelay().InMilliseconds());
+}
+
+}  // namespace remoting
@@ -4,6 +4,9 @@
 
 #include "remoting/host/differ.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/logging.h"
 #include "remoting/host/differ_block.h"
 
@@ -45,6 +48,21 @@ void Differ::CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
   MergeBlocks(region);
 }
 
+void Differ::CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
+                             const SkRegion& hint, SkRegion* region) {
+  if (!region) {
+    return;
+  }
+  region->setEmpty();
+
+  if (!prev_buffer || !curr_buffer) {
+    return;
+  }
+
+  MarkDirtyBlocksInRegion(prev_buffer, curr_buffer, hint);
+  MergeBlocks(region);
+}
+
 void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   memset(diff_info_.get(), 0, diff_info_size_);
 
@@ -118,6 +136,54 @@ void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   }
 }
 
+void Differ::MarkDirtyBlocksInRegion(const void* prev_buffer,
+                                     const void* curr_buffer,
+                                     const SkRegion& hint) {
+  memset(diff_info_.get(), 0, diff_info_size_);
+
+  // Diff each block touched by the hint once, even when several of the hint's
+  // rects share it.  Blocks that have been diffed are tracked separately from
+  // |diff_info_| so that MergeBlocks() sees only 0 or 1.
+  std::vector<bool> checked(diff_info_size_, false);
+  SkIRect screen_rect = SkIRect::MakeWH(width_, height_);
+
+  for (SkRegion::Iterator it(hint); !it.done(); it.next()) {
+    SkIRect rect = it.rect();
+    if (!rect.intersect(screen_rect))
+      continue;
+
+    int left = rect.left() / kBlockSize;
+    int top = rect.top() / kBlockSize;
+    int right = (rect.right() - 1) / kBlockSize;
+    int bottom = (rect.bottom() - 1) / kBlockSize;
+    for (int y = top; y <= bottom; ++y) {
+      for (int x = left; x <= right; ++x) {
+        int index = y * diff_info_width_ + x;
+        if (checked[index])
+          continue;
+        checked[index] = true;
+
+        int offset = y * kBlockSize * bytes_per_row_ +
+                     x * kBlockSize * bytes_per_pixel_;
+        const uint8* prev_block =
+            static_cast<const uint8*>(prev_buffer) + offset;
+        const uint8* curr_block =
+            static_cast<const uint8*>(curr_buffer) + offset;
+        int block_width = std::min(kBlockSize, width_ - x * kBlockSize);
+        int block_height = std::min(kBlockSize, height_ - y * kBlockSize);
+        if (block_width == kBlockSize && block_height == kBlockSize) {
+          diff_info_[index] =
+              BlockDifference(prev_block, curr_block, bytes_per_row_);
+        } else {
+          diff_info_[index] = DiffPartialBlock(prev_block, curr_block,
+                                               bytes_per_row_, block_width,
+                                               block_height);
+        }
+      }
+    }
+  }
+}
+
 DiffInfo Differ::DiffPartialBlock(const uint8* prev_buffer,
                                   const uint8* curr_buffer,
                                   int stride, int width, int height) {
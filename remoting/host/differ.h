@@ -36,6 +36,13 @@ class Differ {
   void CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
                        SkRegion* region);
 
+  // As above, but only the blocks touched by |hint| are compared; the rest of
+  // the screen is assumed not to have changed.  The hint typically comes from
+  // the OS, e.g. XDamage, and is refined down to the blocks that actually
+  // changed.
+  void CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
+                       const SkRegion& hint, SkRegion* region);
+
  private:
   // Allow tests to access our private parts.
   friend class DifferTest;
@@ -43,6 +50,11 @@ class Differ {
   // Identify all of the blocks that contain changed pixels.
   void MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer);
 
+  // Identify the changed blocks among those touched by |hint|.
+  void MarkDirtyBlocksInRegion(const void* prev_buffer,
+                               const void* curr_buffer,
+                               const SkRegion& hint);
+
   // After the dirty blocks have been identified, this routine merges adjacent
   // blocks into a region.
   // The goal is to minimize the region that covers the dirty blocks.
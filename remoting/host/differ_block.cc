@@ -32,8 +32,12 @@ int BlockDifference(const uint8* image1, const uint8* image2, int stride) {
     diff_proc = &BlockDifference_C;
 #else
     base::CPU cpu;
-    // For x86 processors, check if SSE2 is supported.
-    if (cpu.has_sse2() && kBlockSize == 32)
+    // For x86 processors, prefer AVX2 and then SSE2.
+    if (cpu.has_avx2() && kBlockSize == 32)
+      diff_proc = &BlockDifference_AVX2_W32;
+    else if (cpu.has_avx2() && kBlockSize == 16)
+      diff_proc = &BlockDifference_AVX2_W16;
+    else if (cpu.has_sse2() && kBlockSize == 32)
       diff_proc = &BlockDifference_SSE2_W32;
     else if (cpu.has_sse2() && kBlockSize == 16)
       diff_proc = &BlockDifference_SSE2_W16;
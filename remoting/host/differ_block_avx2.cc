@@ -0,0 +1,70 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+#include "remoting/host/differ_block.h"
+#include "remoting/host/differ_block_internal.h"
+
+namespace remoting {
+
+// Unlike the SSE2 versions these don't need a sum of absolute differences;
+// any set bit in the XOR of the two rows means the block has changed, and
+// VPTEST checks for that without leaving the vector unit.
+
+extern int BlockDifference_AVX2_W16(const uint8* image1, const uint8* image2,
+                                    int stride) {
+  __m256i v0;
+  __m256i v1;
+  __m256i acc;
+  for (int y = 0; y < kBlockSize; ++y) {
+    const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+    const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+    v0 = _mm256_loadu_si256(i1);
+    v1 = _mm256_loadu_si256(i2);
+    acc = _mm256_xor_si256(v0, v1);
+    v0 = _mm256_loadu_si256(i1 + 1);
+    v1 = _mm256_loadu_si256(i2 + 1);
+    acc = _mm256_or_si256(acc, _mm256_xor_si256(v0, v1));
+    if (!_mm256_testz_si256(acc, acc))
+      return 1;
+    image1 += stride;
+    image2 += stride;
+  }
+  return 0;
+}
+
+extern int BlockDifference_AVX2_W32(const uint8* image1, const uint8* image2,
+                                    int stride) {
+  __m256i v0;
+  __m256i v1;
+  __m256i acc;
+  for (int y = 0; y < kBlockSize; ++y) {
+    const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+    const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+    v0 = _mm256_loadu_si256(i1);
+    v1 = _mm256_loadu_si256(i2);
+    acc = _mm256_xor_si256(v0, v1);
+    v0 = _mm256_loadu_si256(i1 + 1);
+    v1 = _mm256_loadu_si256(i2 + 1);
+    acc = _mm256_or_si256(acc, _mm256_xor_si256(v0, v1));
+    v0 = _mm256_loadu_si256(i1 + 2);
+    v1 = _mm256_loadu_si256(i2 + 2);
+    acc = _mm256_or_si256(acc, _mm256_xor_si256(v0, v1));
+    v0 = _mm256_loadu_si256(i1 + 3);
+    v1 = _mm256_loadu_si256(i2 + 3);
+    acc = _mm256_or_si256(acc, _mm256_xor_si256(v0, v1));
+    if (!_mm256_testz_si256(acc, acc))
+      return 1;
+    image1 += stride;
+    image2 += stride;
+  }
+  return 0;
+}
+
+}  // namespace remoting
@@ -2,8 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-// This header file is used only differ_block.h. It defines the SSE2 rountines
-// for finding block difference.
+// This header file is used only differ_block.h. It defines the SSE2 and AVX2
+// rountines for finding block difference.
 
 #ifndef REMOTING_HOST_DIFFER_BLOCK_INTERNAL_H_
 #define REMOTING_HOST_DIFFER_BLOCK_INTERNAL_H_
@@ -20,6 +20,12 @@ extern int BlockDifference_SSE2_W16(const uint8* image1, const uint8* image2,
 extern int BlockDifference_SSE2_W32(const uint8* image1, const uint8* image2,
                                     int stride);
 
+// AVX2 versions of the above.
+extern int BlockDifference_AVX2_W16(const uint8* image1, const uint8* image2,
+                                    int stride);
+extern int BlockDifference_AVX2_W32(const uint8* image1, const uint8* image2,
+                                    int stride);
+
 }  // namespace remoting
 
 #endif  // REMOTING_HOST_DIFFER_BLOCK_INTERNAL_H_
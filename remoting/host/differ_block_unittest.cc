@@ -2,8 +2,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/cpu.h"
 #include "base/memory/ref_counted.h"
+#include "build/build_config.h"
 #include "remoting/host/differ_block.h"
+#include "remoting/host/differ_block_internal.h"
 #include "testing/gmock/include/gmock/gmock.h"
 
 namespace remoting {
@@ -78,4 +81,38 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+#if !defined(ARCH_CPU_ARM_FAMILY)
+typedef int (*BlockDifferenceProc)(const uint8*, const uint8*, int);
+
+// Checks a BlockDifference() implementation against identical blocks and
+// blocks differing in a single byte at a few positions.
+static void CheckBlockDifferenceProc(BlockDifferenceProc proc) {
+  uint8* block1;
+  uint8* block2;
+  PrepareBuffers(block1, block2);
+  const int stride = kBlockSize * kBytesPerPixel;
+
+  EXPECT_EQ(0, proc(block1, block2, stride));
+  for (int i = 0; i < kSizeOfBlock; i += kSizeOfBlock / 7) {
+    block2[i] += 1;
+    EXPECT_EQ(1, proc(block1, block2, stride)) << "at byte " << i;
+    block2[i] = block1[i];
+  }
+}
+
+// BlockDifference() only uses the best implementation for this CPU, so check
+// the others directly.
+TEST(BlockDifferenceTestImplementations, BlockDifference) {
+  base::CPU cpu;
+  if (cpu.has_sse2()) {
+    CheckBlockDifferenceProc(kBlockSize == 32 ? &BlockDifference_SSE2_W32 :
+                                                &BlockDifference_SSE2_W16);
+  }
+  if (cpu.has_avx2()) {
+    CheckBlockDifferenceProc(kBlockSize == 32 ? &BlockDifference_AVX2_W32 :
+                                                &BlockDifference_AVX2_W16);
+  }
+}
+#endif
+
 }  // namespace remoting
@@ -0,0 +1,85 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "remoting/host/differ.h"
+#include "remoting/host/differ_block.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace remoting {
+
+namespace {
+
+// Frames diffed per resolution.
+const int kFrameCount = 60;
+
+struct Resolution {
+  int width;
+  int height;
+};
+
+const Resolution kResolutions[] = {
+  { 1280, 720 },
+  { 1920, 1080 },
+  { 2560, 1600 },
+  { 3840, 2160 },
+};
+
+// Damage from typing into a text field: a short run of changed pixels.
+const int kDamageWidth = 200;
+const int kDamageHeight = 20;
+
+}  // namespace
+
+// Measures the time to find the dirty region of a frame in which only a small
+// area changed, the common case, both by diffing the whole screen and by
+// diffing only an OS-provided damage hint.
+TEST(DifferPerfTest, DirtyRegionByResolution) {
+  for (size_t i = 0; i < arraysize(kResolutions); ++i) {
+    const int width = kResolutions[i].width;
+    const int height = kResolutions[i].height;
+    const int stride = width * kBytesPerPixel;
+    const size_t size = stride * height;
+
+    scoped_array<uint8> prev(new uint8[size]);
+    scoped_array<uint8> curr(new uint8[size]);
+    for (size_t j = 0; j < size; ++j)
+      prev[j] = static_cast<uint8>(j * 7);
+    memcpy(curr.get(), prev.get(), size);
+
+    const SkIRect damage = SkIRect::MakeXYWH(width / 3, height / 2,
+                                             kDamageWidth, kDamageHeight);
+    for (int y = damage.top(); y < damage.bottom(); ++y)
+      curr[y * stride + damage.left() * kBytesPerPixel] ^= 0xff;
+    SkRegion hint(damage);
+
+    Differ differ(width, height, kBytesPerPixel, stride);
+    SkRegion dirty;
+    const std::string suffix = base::StringPrintf("%dx%d", width, height);
+
+    PerfTimer full_timer;
+    for (int frame = 0; frame < kFrameCount; ++frame)
+      differ.CalcDirtyRegion(prev.get(), curr.get(), &dirty);
+    LogPerfResult(("Differ_full_screen_" + suffix).c_str(),
+                  full_timer.Elapsed().InMillisecondsF() / kFrameCount,
+                  "ms/frame");
+    EXPECT_FALSE(dirty.isEmpty());
+
+    PerfTimer hint_timer;
+    for (int frame = 0; frame < kFrameCount; ++frame)
+      differ.CalcDirtyRegion(prev.get(), curr.get(), hint, &dirty);
+    LogPerfResult(("Differ_damage_hint_" + suffix).c_str(),
+                  hint_timer.Elapsed().InMillisecondsF() / kFrameCount,
+                  "ms/frame");
+    EXPECT_FALSE(dirty.isEmpty());
+  }
+}
+
+}  // namespace remoting
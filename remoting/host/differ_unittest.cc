@@ -256,6 +256,34 @@ TEST_F(DifferTest, MarkDirtyBlocks_Sampling) {
   EXPECT_EQ(0, GetDiffInfo(2, 2));
 }
 
+TEST_F(DifferTest, CalcDirtyRegion_Hint) {
+  InitDiffer(kPartialScreenWidth, kPartialScreenHeight);
+
+  // Change a block inside the hint, one outside it, and the partial block in
+  // the bottom-right corner, which the hint only partly covers.
+  WriteBlockPixel(curr_.get(), 0, 0, 10, 10, 0xff00ff);
+  WriteBlockPixel(curr_.get(), 1, 0, 10, 10, 0xff00ff);
+  WritePixel(curr_.get(), kPartialScreenWidth - 1, kPartialScreenHeight - 1,
+             0xff00ff);
+
+  SkRegion hint;
+  hint.op(SkIRect::MakeXYWH(5, 5, 10, 10), SkRegion::kUnion_Op);
+  hint.op(SkIRect::MakeXYWH(2 * kBlockSize, 2 * kBlockSize, 1, 1),
+          SkRegion::kUnion_Op);
+
+  SkRegion dirty;
+  differ_->CalcDirtyRegion(prev_.get(), curr_.get(), hint, &dirty);
+
+  // Only the hinted blocks are reported, clipped to the screen.
+  SkRegion expected;
+  expected.op(SkIRect::MakeXYWH(0, 0, kBlockSize, kBlockSize),
+              SkRegion::kUnion_Op);
+  expected.op(SkIRect::MakeLTRB(2 * kBlockSize, 2 * kBlockSize,
+                                kPartialScreenWidth, kPartialScreenHeight),
+              SkRegion::kUnion_Op);
+  EXPECT_EQ(expected, dirty);
+}
+
 TEST_F(DifferTest, DiffBlock) {
   InitDiffer(kScreenWidth, kScreenHeight);
 
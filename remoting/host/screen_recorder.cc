@@ -48,6 +48,8 @@ ScreenRecorder::ScreenRecorder(
       max_recordings_(kMaxRecordings),
       recordings_(0),
       frame_skipped_(false),
+      last_frame_dropped_(false),
+      frame_send_in_progress_(false),
       sequence_number_(0) {
   DCHECK(capture_task_runner_);
   DCHECK(encode_task_runner_);
@@ -215,7 +217,8 @@ void ScreenRecorder::CaptureDoneCallback(
   }
 
   encode_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&ScreenRecorder::DoEncode, this, capture_data));
+      FROM_HERE, base::Bind(&ScreenRecorder::DoEncode, this, capture_data,
+                            base::Time::Now()));
 }
 
 void ScreenRecorder::CursorShapeChangedCallback(
@@ -256,6 +259,12 @@ void ScreenRecorder::DoInvalidateFullScreen() {
   capturer_->InvalidateRegion(region);
 }
 
+void ScreenRecorder::DoInvalidateRegion(const SkRegion& region) {
+  DCHECK(capture_task_runner_->BelongsToCurrentThread());
+
+  capturer_->InvalidateRegion(region);
+}
+
 // Network thread --------------------------------------------------------------
 
 void ScreenRecorder::DoSendVideoPacket(scoped_ptr<VideoPacket> packet) {
@@ -264,9 +273,17 @@ void ScreenRecorder::DoSendVideoPacket(scoped_ptr<VideoPacket> packet) {
   if (network_stopped_ || connections_.empty())
     return;
 
+  if (!frame_send_in_progress_) {
+    send_start_time_ = base::Time::Now();
+    frame_send_in_progress_ = true;
+  }
+
   base::Closure callback;
-  if ((packet->flags() & VideoPacket::LAST_PARTITION) != 0)
-    callback = base::Bind(&ScreenRecorder::VideoFrameSentCallback, this);
+  if ((packet->flags() & VideoPacket::LAST_PARTITION) != 0) {
+    callback = base::Bind(&ScreenRecorder::VideoFrameSentCallback, this,
+                          send_start_time_);
+    frame_send_in_progress_ = false;
+  }
 
   // TODO(sergeyu): Currently we send the data only to the first
   // connection. Send it to all connections if necessary.
@@ -274,12 +291,19 @@ void ScreenRecorder::DoSendVideoPacket(scoped_ptr<VideoPacket> packet) {
       packet.Pass(), callback);
 }
 
-void ScreenRecorder::VideoFrameSentCallback() {
+void ScreenRecorder::VideoFrameSentCallback(base::Time send_start_time) {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
 
   if (network_stopped_)
     return;
 
+  // The channel may still have been busy with the previous frame when this
+  // one was handed to it, so only count the time since that one was sent.
+  base::Time now = base::Time::Now();
+  scheduler_.RecordSendTime(
+      now - std::max(send_start_time, last_frame_sent_time_));
+  last_frame_sent_time_ = now;
+
   capture_task_runner_->PostTask(
       FROM_HERE, base::Bind(&ScreenRecorder::DoFinishOneRecording, this));
 }
@@ -315,12 +339,28 @@ void ScreenRecorder::DoSendCursorShape(
 // Encoder thread --------------------------------------------------------------
 
 void ScreenRecorder::DoEncode(
-    scoped_refptr<CaptureData> capture_data) {
+    scoped_refptr<CaptureData> capture_data,
+    base::Time capture_done_time) {
   DCHECK(encode_task_runner_->BelongsToCurrentThread());
 
   if (encoder_stopped_)
     return;
 
+  // If the frame has waited for the encoder longer than the capture interval
+  // then a fresher capture is already due. Drop this one and merge its dirty
+  // region into the next capture instead of spending time encoding it. Never
+  // drop two frames in a row so that the screen keeps updating.
+  bool stale = capture_data && !capture_data->dirty_region().isEmpty() &&
+      !last_frame_dropped_ &&
+      base::Time::Now() - capture_done_time > scheduler_.NextCaptureDelay();
+  last_frame_dropped_ = stale;
+  if (stale) {
+    capture_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&ScreenRecorder::DoInvalidateRegion, this,
+                              capture_data->dirty_region()));
+    capture_data = NULL;
+  }
+
   // Early out if there's nothing to encode.
   if (!capture_data || capture_data->dirty_region().isEmpty()) {
     // Send an empty video packet to keep network active.
@@ -17,6 +17,8 @@
 #include "remoting/host/capture_scheduler.h"
 #include "remoting/proto/video.pb.h"
 
+class SkRegion;
+
 namespace base {
 class SingleThreadTaskRunner;
 }  // namespace base
@@ -127,6 +129,7 @@ class ScreenRecorder : public base::RefCountedThreadSafe<ScreenRecorder> {
       scoped_ptr<protocol::CursorShapeInfo> cursor_data);
   void DoFinishOneRecording();
   void DoInvalidateFullScreen();
+  void DoInvalidateRegion(const SkRegion& region);
 
   // Network thread -----------------------------------------------------------
 
@@ -139,15 +142,17 @@ class ScreenRecorder : public base::RefCountedThreadSafe<ScreenRecorder> {
   void DoStopOnNetworkThread(const base::Closure& done_task);
 
   // Callback for VideoStub::ProcessVideoPacket() that is used for
-  // each last packet in a frame.
-  void VideoFrameSentCallback();
+  // each last packet in a frame. |send_start_time| is the time the first
+  // packet of the frame was handed to the channel.
+  void VideoFrameSentCallback(base::Time send_start_time);
 
   // Send updated cursor shape to client.
   void DoSendCursorShape(scoped_ptr<protocol::CursorShapeInfo> cursor_shape);
 
   // Encoder thread -----------------------------------------------------------
 
-  void DoEncode(scoped_refptr<CaptureData> capture_data);
+  void DoEncode(scoped_refptr<CaptureData> capture_data,
+                base::Time capture_done_time);
 
   // Perform stop operations on encode thread.
   void DoStopOnEncodeThread(const base::Closure& done_task);
@@ -197,6 +202,20 @@ class ScreenRecorder : public base::RefCountedThreadSafe<ScreenRecorder> {
   // Time when encode is started.
   base::Time encode_start_time_;
 
+  // Set to true if the last frame was dropped for being stale, so that the
+  // next one is always encoded. Used on the encode thread only.
+  bool last_frame_dropped_;
+
+  // Time when the first packet of the frame being sent was handed to the
+  // channel, and whether a frame is part way through being sent. Used on the
+  // network thread only.
+  base::Time send_start_time_;
+  bool frame_send_in_progress_;
+
+  // Time when the channel finished sending the last frame. Used on the
+  // network thread only.
+  base::Time last_frame_sent_time_;
+
   // This is a number updated by client to trace performance.
   int64 sequence_number_;
 
@@ -318,7 +318,7 @@ void VideoFrameCapturerLinux::CaptureInvalidRegion(
   VideoFrameBuffer &current = buffers_[current_buffer_];
   current.Update(display_, root_window_);
   // Also refresh the Differ helper used by CaptureFrame(), if needed.
-  if (!use_damage_ && !last_buffer_) {
+  if (!last_buffer_) {
     differ_.reset(new Differ(current.size().width(), current.size().height(),
                              kBytesPerPixel, current.bytes_per_row()));
   }
@@ -429,13 +429,26 @@ CaptureData* VideoFrameCapturerLinux::CaptureFrame() {
                         SkRegion::kUnion_Op);
     }
     XFree(rects);
-    helper_.InvalidateRegion(invalid_region);
 
-    // Capture the damaged portions of the desktop.
-    helper_.SwapInvalidRegion(&invalid_region);
-    for (SkRegion::Iterator it(invalid_region); !it.done(); it.next()) {
+    // Capture the damaged portions of the desktop, along with anything the
+    // caller asked to be refreshed.
+    SkRegion requested_region;
+    helper_.SwapInvalidRegion(&requested_region);
+    SkRegion capture_region(invalid_region);
+    capture_region.op(requested_region, SkRegion::kUnion_Op);
+    for (SkRegion::Iterator it(capture_region); !it.done(); it.next()) {
       CaptureRect(it.rect(), capture_data);
     }
+
+    // XDamage reports everything that was repainted, which is often much more
+    // than what changed.  Diff only the damaged blocks to drop the unchanged
+    // ones.  Requested areas are always sent.
+    DCHECK(differ_ != NULL);
+    SkRegion damage_region;
+    damage_region.swap(invalid_region);
+    differ_->CalcDirtyRegion(last_buffer_, buffer.ptr(), damage_region,
+                             &invalid_region);
+    invalid_region.op(requested_region, SkRegion::kUnion_Op);
   } else {
     // Doing full-screen polling, or this is the first capture after a
     // screen-resolution change.  In either case, need a full-screen capture.
@@ -1283,6 +1283,8 @@
         'base/stoppable.h',
         'base/util.cc',
         'base/util.h',
+        'base/worker_task_group.cc',
+        'base/worker_task_group.h',
         'codec/audio_decoder.cc',
         'codec/audio_decoder.h',
         'codec/audio_decoder_speex.cc',
@@ -1830,6 +1832,7 @@
       'conditions': [
         [ 'target_arch == "ia32" or target_arch == "x64"', {
           'dependencies': [
+            'differ_block_avx2',
             'differ_block_sse2',
           ],
         }],
@@ -1855,6 +1858,28 @@
       ],
     }, # end of target differ_block_sse2
 
+    {
+      'target_name': 'differ_block_avx2',
+      'type': 'static_library',
+      'conditions': [
+        [ 'os_posix == 1 and OS != "mac"', {
+          'cflags': [
+            '-mavx2',
+          ],
+        }],
+        [ 'OS == "mac"', {
+          'xcode_settings': {
+            'OTHER_CFLAGS': [
+              '-mavx2',
+            ],
+          },
+        }],
+      ],
+      'sources': [
+        'host/differ_block_avx2.cc',
+      ],
+    }, # end of target differ_block_avx2
+
     # Remoting unit tests
     {
       'target_name': 'remoting_unittests',
@@ -1900,6 +1925,7 @@
         'codec/video_encoder_row_based_unittest.cc',
         'codec/video_encoder_vp8_unittest.cc',
         'host/audio_capturer_win_unittest.cc',
+        'host/capture_scheduler_unittest.cc',
         'host/chromoting_host_context_unittest.cc',
         'host/chromoting_host_unittest.cc',
         'host/client_session_unittest.cc',
@@ -2002,5 +2028,23 @@
         }],
       ],  # end of 'conditions'
     },  # end of target 'remoting_unittests'
+
+    # Remoting performance tests
+    {
+      'target_name': 'remoting_perftests',
+      'type': 'executable',
+      'dependencies': [
+        'remoting_base',
+        'remoting_host',
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_perf',
+        '../skia/skia.gyp:skia',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'sources': [
+        'codec/video_encode_decode_perftest.cc',
+        'host/differ_perftest.cc',
+      ],
+    },  # end of target 'remoting_perftests'
   ],  # end of targets
 }
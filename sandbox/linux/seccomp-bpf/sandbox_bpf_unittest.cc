@@ -2,7 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <ostream>
+#include <iostream>
 
 #include "sandbox/linux/seccomp-bpf/bpf_tests.h"
 #include "sandbox/linux/seccomp-bpf/verifier.h"
@@ -200,4 +200,56 @@ BPF_TEST(SandboxBpf, SyntheticPolicy, SyntheticPolicy) {
   }
 }
 
+// A policy that denies a handful of privileged system calls scattered through
+// the number space, so the compiled program is a jump table of realistic depth
+// rather than a single comparison.
+ErrorCode ScatteredDenialPolicy(int sysno) {
+  if (sysno < static_cast<int>(MIN_SYSCALL) ||
+      sysno > static_cast<int>(MAX_SYSCALL)) {
+    return ErrorCode(ENOSYS);
+  }
+  switch (sysno) {
+    case __NR_acct:
+    case __NR_adjtimex:
+    case __NR_chroot:
+    case __NR_delete_module:
+    case __NR_init_module:
+    case __NR_mount:
+    case __NR_personality:
+    case __NR_pivot_root:
+    case __NR_ptrace:
+    case __NR_quotactl:
+    case __NR_reboot:
+    case __NR_setdomainname:
+    case __NR_sethostname:
+    case __NR_settimeofday:
+    case __NR_swapoff:
+    case __NR_swapon:
+    case __NR_syslog:
+    case __NR_umount2:
+    case __NR_vhangup:
+      return ErrorCode(EPERM);
+    default:
+      return ErrorCode(ErrorCode::ERR_ALLOWED);
+  }
+}
+
+BPF_TEST(SandboxBpf, ScatteredDenialPolicy, ScatteredDenialPolicy) {
+  // Only denied calls that would be harmless if they did reach the kernel are
+  // exercised here.
+  static const int kDenied[] = {
+    __NR_acct, __NR_chroot, __NR_pivot_root, __NR_quotactl, __NR_swapon,
+    __NR_umount2,
+  };
+  for (size_t i = 0; i < arraysize(kDenied); ++i) {
+    errno = 0;
+    BPF_ASSERT(syscall(kDenied[i], NULL, NULL, NULL, NULL) == -1);
+    BPF_ASSERT(errno == EPERM);
+  }
+
+  // System calls in between the denied ones still reach the kernel.
+  BPF_ASSERT(syscall(__NR_getppid) == getppid());
+  BPF_ASSERT(syscall(__NR_getpid) == getpid());
+}
+
 } // namespace
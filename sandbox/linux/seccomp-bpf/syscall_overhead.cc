@@ -0,0 +1,102 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the per-system call overhead of a BPF filter. The policy denies a
+// handful of privileged system calls scattered through the number space, so
+// the compiled program is a jump table of realistic depth rather than a
+// single comparison. The cost of getppid() is printed before and after the
+// sandbox is started.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sandbox/linux/seccomp-bpf/sandbox_bpf.h"
+
+using playground2::ErrorCode;
+using playground2::Sandbox;
+
+namespace {
+
+const int kIterations = 200000;
+
+ErrorCode ScatteredDenialPolicy(int sysno) {
+  if (sysno < static_cast<int>(MIN_SYSCALL) ||
+      sysno > static_cast<int>(MAX_SYSCALL)) {
+    return ErrorCode(ENOSYS);
+  }
+  switch (sysno) {
+    case __NR_acct:
+    case __NR_adjtimex:
+    case __NR_chroot:
+    case __NR_delete_module:
+    case __NR_init_module:
+    case __NR_mount:
+    case __NR_personality:
+    case __NR_pivot_root:
+    case __NR_ptrace:
+    case __NR_quotactl:
+    case __NR_reboot:
+    case __NR_setdomainname:
+    case __NR_sethostname:
+    case __NR_settimeofday:
+    case __NR_swapoff:
+    case __NR_swapon:
+    case __NR_syslog:
+    case __NR_umount2:
+    case __NR_vhangup:
+      return ErrorCode(EPERM);
+    default:
+      return ErrorCode(ErrorCode::ERR_ALLOWED);
+  }
+}
+
+// Returns the average cost of a getppid() system call in nanoseconds.
+double TimeGetppid() {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < kIterations; ++i) {
+    syscall(__NR_getppid);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return ((end.tv_sec - start.tv_sec) * 1e9 +
+          (end.tv_nsec - start.tv_nsec)) / kIterations;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc) { }
+  if (argv) { }
+  int proc_fd = open("/proc", O_RDONLY|O_DIRECTORY);
+  if (Sandbox::supportsSeccompSandbox(proc_fd) !=
+      Sandbox::STATUS_AVAILABLE) {
+    perror("sandbox");
+    return 1;
+  }
+
+  double baseline = TimeGetppid();
+
+  Sandbox::setProcFd(proc_fd);
+  Sandbox::setSandboxPolicy(ScatteredDenialPolicy, NULL);
+  Sandbox::startSandbox();
+
+  // Make sure the policy is actually in effect.
+  errno = 0;
+  if (syscall(__NR_acct, NULL) != -1 || errno != EPERM) {
+    fprintf(stderr, "acct() was not denied by the sandbox\n");
+    return 1;
+  }
+
+  double sandboxed = TimeGetppid();
+  printf("getppid() without sandbox: %.1f ns\n", baseline);
+  printf("getppid() with sandbox:    %.1f ns\n", sandboxed);
+  printf("overhead:                  %.1f ns\n", sandboxed - baseline);
+  return 0;
+}
@@ -4,6 +4,11 @@
 
 #include <algorithm>
 
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/worker_pool.h"
 #include "skia/ext/convolver.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
@@ -15,6 +20,9 @@ namespace skia {
 
 namespace {
 
+// The fewest output rows BGRAConvolve2DInParallel() gives a thread.
+const int kMinRowsPerBand = 16;
+
 // Converts the argument to an 8-bit unsigned value by clamping to the range
 // 0-255.
 inline unsigned char ClampTo8(int a) {
@@ -223,13 +231,38 @@ void ConvolveVertically(const ConvolutionFilter1D::Fixed* filter_values,
   }
 }
 
+// Adapters giving the C routines the signatures used by ConvolveProcs.
+void ConvolveVertically_C(const ConvolutionFilter1D::Fixed* filter_values,
+                          int filter_length,
+                          unsigned char* const* source_data_rows,
+                          int pixel_width,
+                          unsigned char* out_row,
+                          bool has_alpha) {
+  if (has_alpha) {
+    ConvolveVertically<true>(filter_values, filter_length, source_data_rows,
+                             pixel_width, out_row);
+  } else {
+    ConvolveVertically<false>(filter_values, filter_length, source_data_rows,
+                              pixel_width, out_row);
+  }
+}
+
+void ConvolveHorizontally_C(const unsigned char* src_data,
+                            const ConvolutionFilter1D& filter,
+                            unsigned char* out_row,
+                            bool has_alpha) {
+  if (has_alpha)
+    ConvolveHorizontally<true>(src_data, filter, out_row);
+  else
+    ConvolveHorizontally<false>(src_data, filter, out_row);
+}
 
+#if defined(SIMD_SSE2)
 // Convolves horizontally along a single row. The row data is given in
 // |src_data| and continues for the num_values() of the filter.
 void ConvolveHorizontally_SSE2(const unsigned char* src_data,
                                const ConvolutionFilter1D& filter,
                                unsigned char* out_row) {
-#if defined(SIMD_SSE2)
   int num_values = filter.num_values();
 
   int filter_offset, filter_length;
@@ -350,7 +383,6 @@ void ConvolveHorizontally_SSE2(const unsigned char* src_data,
     *(reinterpret_cast<int*>(out_row)) = _mm_cvtsi128_si32(accum);
     out_row += 4;
   }
-#endif
 }
 
 // Convolves horizontally along four rows. The row data is given in
@@ -360,7 +392,6 @@ void ConvolveHorizontally_SSE2(const unsigned char* src_data,
 void ConvolveHorizontally4_SSE2(const unsigned char* src_data[4],
                                 const ConvolutionFilter1D& filter,
                                 unsigned char* out_row[4]) {
-#if defined(SIMD_SSE2)
   int num_values = filter.num_values();
 
   int filter_offset, filter_length;
@@ -471,7 +502,6 @@ void ConvolveHorizontally4_SSE2(const unsigned char* src_data[4],
     out_row[2] += 4;
     out_row[3] += 4;
   }
-#endif
 }
 
 // Does vertical convolution to produce one output row. The filter values and
@@ -486,7 +516,6 @@ void ConvolveVertically_SSE2(const ConvolutionFilter1D::Fixed* filter_values,
                              unsigned char* const* source_data_rows,
                              int pixel_width,
                              unsigned char* out_row) {
-#if defined(SIMD_SSE2)
   int width = pixel_width & ~3;
 
   __m128i zero = _mm_setzero_si128();
@@ -647,9 +676,241 @@ void ConvolveVertically_SSE2(const ConvolutionFilter1D::Fixed* filter_values,
       out_row += 4;
     }
   }
+}
+
+// Adapters giving the SSE2 routines the signatures used by ConvolveProcs.
+void ConvolveVertically_SSE2(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+  if (has_alpha) {
+    ConvolveVertically_SSE2<true>(filter_values, filter_length,
+                                  source_data_rows, pixel_width, out_row);
+  } else {
+    ConvolveVertically_SSE2<false>(filter_values, filter_length,
+                                   source_data_rows, pixel_width, out_row);
+  }
+}
+
+void ConvolveHorizontally_SSE2(const unsigned char* src_data,
+                               const ConvolutionFilter1D& filter,
+                               unsigned char* out_row,
+                               bool has_alpha) {
+  // The SSE2 version always computes the alpha channel.
+  ConvolveHorizontally_SSE2(src_data, filter, out_row);
+}
+#endif
+
+// The convolution routines to use, picked at run time by SetupProcs() from
+// what the CPU supports. Another instruction set is supported by adding its
+// routines here.
+struct ConvolveProcs {
+  // Number of rows the horizontal pass may run ahead of the vertical one,
+  // which the row buffer needs room for.
+  int extra_horizontal_reads;
+
+  void (*convolve_vertically)(const ConvolutionFilter1D::Fixed* filter_values,
+                              int filter_length,
+                              unsigned char* const* source_data_rows,
+                              int pixel_width,
+                              unsigned char* out_row,
+                              bool has_alpha);
+
+  // Convolves four rows at once. NULL when there is no such routine.
+  void (*convolve_4rows_horizontally)(const unsigned char* src_data[4],
+                                      const ConvolutionFilter1D& filter,
+                                      unsigned char* out_row[4]);
+
+  void (*convolve_horizontally)(const unsigned char* src_data,
+                                const ConvolutionFilter1D& filter,
+                                unsigned char* out_row,
+                                bool has_alpha);
+
+  // Number of bytes past the last pixel of a filter that the horizontal
+  // routines may read.
+  int horizontal_overread;
+};
+
+void SetupProcs(bool use_simd_if_possible, ConvolveProcs* procs) {
+  procs->extra_horizontal_reads = 0;
+  procs->convolve_vertically = &ConvolveVertically_C;
+  procs->convolve_4rows_horizontally = NULL;
+  procs->convolve_horizontally = &ConvolveHorizontally_C;
+  procs->horizontal_overread = 0;
+
+  if (!use_simd_if_possible)
+    return;
+
+#if defined(SIMD_SSE2)
+  base::CPU cpu;
+  if (cpu.has_sse2()) {
+    procs->extra_horizontal_reads = 4;
+    procs->convolve_vertically = &ConvolveVertically_SSE2;
+    procs->convolve_4rows_horizontally = &ConvolveHorizontally4_SSE2;
+    procs->convolve_horizontally = &ConvolveHorizontally_SSE2;
+    // Pixels are loaded 16 bytes at a time, so up to 12 bytes past the last
+    // pixel of a filter are read.
+    procs->horizontal_overread = 12;
+  }
 #endif
 }
 
+// Everything BGRAConvolve2D needs to convolve a band of output rows.
+struct ConvolveJob {
+  const unsigned char* source_data;
+  int source_byte_row_stride;
+  bool source_has_alpha;
+  const ConvolutionFilter1D* filter_x;
+  const ConvolutionFilter1D* filter_y;
+  int output_byte_row_stride;
+  unsigned char* output;
+  ConvolveProcs procs;
+
+  // The last source row any of the vertical filters reads.
+  int last_source_row;
+};
+
+void InitConvolveJob(const unsigned char* source_data,
+                     int source_byte_row_stride,
+                     bool source_has_alpha,
+                     const ConvolutionFilter1D& filter_x,
+                     const ConvolutionFilter1D& filter_y,
+                     int output_byte_row_stride,
+                     unsigned char* output,
+                     bool use_simd_if_possible,
+                     ConvolveJob* job) {
+  SkASSERT(output_byte_row_stride >= filter_x.num_values() * 4);
+  job->source_data = source_data;
+  job->source_byte_row_stride = source_byte_row_stride;
+  job->source_has_alpha = source_has_alpha;
+  job->filter_x = &filter_x;
+  job->filter_y = &filter_y;
+  job->output_byte_row_stride = output_byte_row_stride;
+  job->output = output;
+  SetupProcs(use_simd_if_possible, &job->procs);
+
+  // Filters have their zero factors trimmed, so the last one does not
+  // necessarily reach furthest down.
+  job->last_source_row = 0;
+  for (int out_y = 0; out_y < filter_y.num_values(); out_y++) {
+    int filter_offset, filter_length;
+    filter_y.FilterForValue(out_y, &filter_offset, &filter_length);
+    job->last_source_row = std::max(job->last_source_row,
+                                    filter_offset + filter_length - 1);
+  }
+}
+
+// Convolves the output rows in [out_y_begin, out_y_end).
+void ConvolveRows(const ConvolveJob& job, int out_y_begin, int out_y_end) {
+  const ConvolutionFilter1D& filter_x = *job.filter_x;
+  const ConvolutionFilter1D& filter_y = *job.filter_y;
+  const ConvolveProcs& procs = job.procs;
+  int source_byte_row_stride = job.source_byte_row_stride;
+
+  // The next row in the input that we will generate a horizontally
+  // convolved row for. If the filter doesn't start at the beginning of the
+  // image (this is the case when we are only resizing a subset or a band),
+  // then we don't want to generate any output rows before that. Compute the
+  // starting row for convolution as the first pixel any vertical filter of
+  // this band reads.
+  int filter_offset, filter_length;
+  const ConvolutionFilter1D::Fixed* filter_values =
+      filter_y.FilterForValue(out_y_begin, &filter_offset, &filter_length);
+  int next_x_row = filter_offset;
+  for (int out_y = out_y_begin + 1; out_y < out_y_end; out_y++) {
+    filter_y.FilterForValue(out_y, &filter_offset, &filter_length);
+    next_x_row = std::min(next_x_row, filter_offset);
+  }
+
+  // We loop over each row in the input doing a horizontal convolution. This
+  // will result in a horizontally convolved image. We write the results into
+  // a circular buffer of convolved rows and do vertical convolution as rows
+  // are available. This prevents us from having to store the entire
+  // intermediate image and helps cache coherency.
+  // We will need extra rows to allow horizontal convolution to be done on
+  // several rows simultaneously. We also pad each row in the row buffer to be
+  // aligned-up to 16 bytes.
+  // TODO(jiesun): We do not use aligned load from row buffer in vertical
+  // convolution pass yet. Somehow Windows does not like it.
+  int row_buffer_width = (filter_x.num_values() + 15) & ~0xF;
+  int row_buffer_height = filter_y.max_filter() +
+                          procs.extra_horizontal_reads;
+  CircularRowBuffer row_buffer(row_buffer_width,
+                               row_buffer_height,
+                               next_x_row);
+
+  // The horizontal routines may read |horizontal_overread| bytes past the
+  // last pixel they use, which would run past the end of the image on the
+  // last rows. Those rows are done by the C version.
+  int last_simd_row = job.last_source_row;
+  if (procs.horizontal_overread > 0) {
+    last_simd_row -= (procs.horizontal_overread + source_byte_row_stride - 1) /
+                     source_byte_row_stride;
+  }
+
+  // Loop over every output row of the band, processing just enough
+  // horizontal convolutions to run each subsequent vertical convolution.
+  for (int out_y = out_y_begin; out_y < out_y_end; out_y++) {
+    filter_values = filter_y.FilterForValue(out_y,
+                                            &filter_offset, &filter_length);
+
+    // Generate output rows until we have enough to run the current filter.
+    while (next_x_row < filter_offset + filter_length) {
+      if (procs.convolve_4rows_horizontally &&
+          next_x_row + 3 <= last_simd_row) {
+        const unsigned char* src[4];
+        unsigned char* out_row[4];
+        for (int i = 0; i < 4; ++i) {
+          src[i] = &job.source_data[(next_x_row + i) * source_byte_row_stride];
+          out_row[i] = row_buffer.AdvanceRow();
+        }
+        procs.convolve_4rows_horizontally(src, filter_x, out_row);
+        next_x_row += 4;
+      } else {
+        const unsigned char* src =
+            &job.source_data[next_x_row * source_byte_row_stride];
+        if (next_x_row <= last_simd_row) {
+          procs.convolve_horizontally(src, filter_x, row_buffer.AdvanceRow(),
+                                      job.source_has_alpha);
+        } else {
+          ConvolveHorizontally_C(src, filter_x, row_buffer.AdvanceRow(),
+                                 job.source_has_alpha);
+        }
+        next_x_row++;
+      }
+    }
+
+    // Compute where in the output image this row of final data will go.
+    unsigned char* cur_output_row =
+        &job.output[out_y * job.output_byte_row_stride];
+
+    // Get the list of rows that the circular buffer has, in order.
+    int first_row_in_circular_buffer;
+    unsigned char* const* rows_to_convolve =
+        row_buffer.GetRowAddresses(&first_row_in_circular_buffer);
+
+    // Now compute the start of the subset of those rows that the filter
+    // needs.
+    unsigned char* const* first_row_for_filter =
+        &rows_to_convolve[filter_offset - first_row_in_circular_buffer];
+
+    procs.convolve_vertically(filter_values, filter_length,
+                              first_row_for_filter, filter_x.num_values(),
+                              cur_output_row, job.source_has_alpha);
+  }
+}
+
+// Runs ConvolveRows() on a worker thread and signals |done| when finished.
+void ConvolveRowsAndSignal(const ConvolveJob* job,
+                           int out_y_begin,
+                           int out_y_end,
+                           base::WaitableEvent* done) {
+  ConvolveRows(*job, out_y_begin, out_y_end);
+  done->Signal();
+}
+
 }  // namespace
 
 // ConvolutionFilter1D ---------------------------------------------------------
@@ -715,6 +976,7 @@ void ConvolutionFilter1D::AddFilter(int filter_offset,
   max_filter_ = std::max(max_filter_, filter_length);
 }
 
+
 void BGRAConvolve2D(const unsigned char* source_data,
                     int source_byte_row_stride,
                     bool source_has_alpha,
@@ -722,139 +984,58 @@ void BGRAConvolve2D(const unsigned char* source_data,
                     const ConvolutionFilter1D& filter_y,
                     int output_byte_row_stride,
                     unsigned char* output,
-                    bool use_sse2) {
-#if !defined(SIMD_SSE2)
-  // Even we have runtime support for SSE2 instructions, since the binary
-  // was not built with SSE2 support, we had to fallback to C version.
-  use_sse2 = false;
-#endif
-
-  int max_y_filter_size = filter_y.max_filter();
-
-  // The next row in the input that we will generate a horizontally
-  // convolved row for. If the filter doesn't start at the beginning of the
-  // image (this is the case when we are only resizing a subset), then we
-  // don't want to generate any output rows before that. Compute the starting
-  // row for convolution as the first pixel for the first vertical filter.
-  int filter_offset, filter_length;
-  const ConvolutionFilter1D::Fixed* filter_values =
-      filter_y.FilterForValue(0, &filter_offset, &filter_length);
-  int next_x_row = filter_offset;
-
-  // We loop over each row in the input doing a horizontal convolution. This
-  // will result in a horizontally convolved image. We write the results into
-  // a circular buffer of convolved rows and do vertical convolution as rows
-  // are available. This prevents us from having to store the entire
-  // intermediate image and helps cache coherency.
-  // We will need four extra rows to allow horizontal convolution could be done
-  // simultaneously. We also padding each row in row buffer to be aligned-up to
-  // 16 bytes.
-  // TODO(jiesun): We do not use aligned load from row buffer in vertical
-  // convolution pass yet. Somehow Windows does not like it.
-  int row_buffer_width = (filter_x.num_values() + 15) & ~0xF;
-  int row_buffer_height = max_y_filter_size + (use_sse2 ? 4 : 0);
-  CircularRowBuffer row_buffer(row_buffer_width,
-                               row_buffer_height,
-                               filter_offset);
+                    bool use_simd_if_possible) {
+  ConvolveJob job;
+  InitConvolveJob(source_data, source_byte_row_stride, source_has_alpha,
+                  filter_x, filter_y, output_byte_row_stride, output,
+                  use_simd_if_possible, &job);
+  ConvolveRows(job, 0, filter_y.num_values());
+}
 
-  // Loop over every possible output row, processing just enough horizontal
-  // convolutions to run each subsequent vertical convolution.
-  SkASSERT(output_byte_row_stride >= filter_x.num_values() * 4);
+void BGRAConvolve2DInParallel(const unsigned char* source_data,
+                              int source_byte_row_stride,
+                              bool source_has_alpha,
+                              const ConvolutionFilter1D& filter_x,
+                              const ConvolutionFilter1D& filter_y,
+                              int output_byte_row_stride,
+                              unsigned char* output,
+                              bool use_simd_if_possible,
+                              int num_threads) {
+  // Each band repeats the horizontal convolution of the rows its first
+  // filters share with the previous band, so thin bands are not worth it.
   int num_output_rows = filter_y.num_values();
+  num_threads = std::min(num_threads, num_output_rows / kMinRowsPerBand);
+  if (num_threads <= 1) {
+    BGRAConvolve2D(source_data, source_byte_row_stride, source_has_alpha,
+                   filter_x, filter_y, output_byte_row_stride, output,
+                   use_simd_if_possible);
+    return;
+  }
 
-  // We need to check which is the last line to convolve before we advance 4
-  // lines in one iteration.
-  int last_filter_offset, last_filter_length;
-  filter_y.FilterForValue(num_output_rows - 1, &last_filter_offset,
-                          &last_filter_length);
-
-  for (int out_y = 0; out_y < num_output_rows; out_y++) {
-    filter_values = filter_y.FilterForValue(out_y,
-                                            &filter_offset, &filter_length);
-
-    // Generate output rows until we have enough to run the current filter.
-    if (use_sse2) {
-      while (next_x_row < filter_offset + filter_length) {
-        if (next_x_row + 3 < last_filter_offset + last_filter_length - 1) {
-          const unsigned char* src[4];
-          unsigned char* out_row[4];
-          for (int i = 0; i < 4; ++i) {
-            src[i] = &source_data[(next_x_row + i) * source_byte_row_stride];
-            out_row[i] = row_buffer.AdvanceRow();
-          }
-          ConvolveHorizontally4_SSE2(src, filter_x, out_row);
-          next_x_row += 4;
-        } else {
-          // For the last row, SSE2 load possibly to access data beyond the
-          // image area. therefore we use C version here. 
-          if (next_x_row == last_filter_offset + last_filter_length - 1) {
-            if (source_has_alpha) {
-              ConvolveHorizontally<true>(
-                  &source_data[next_x_row * source_byte_row_stride],
-                  filter_x, row_buffer.AdvanceRow());
-            } else {
-              ConvolveHorizontally<false>(
-                  &source_data[next_x_row * source_byte_row_stride],
-                  filter_x, row_buffer.AdvanceRow());
-            }
-          } else {
-            ConvolveHorizontally_SSE2(
-                &source_data[next_x_row * source_byte_row_stride],
-                filter_x, row_buffer.AdvanceRow());
-          }
-          next_x_row++;
-        }
-      }
-    } else {
-      while (next_x_row < filter_offset + filter_length) {
-        if (source_has_alpha) {
-          ConvolveHorizontally<true>(
-              &source_data[next_x_row * source_byte_row_stride],
-              filter_x, row_buffer.AdvanceRow());
-        } else {
-          ConvolveHorizontally<false>(
-              &source_data[next_x_row * source_byte_row_stride],
-              filter_x, row_buffer.AdvanceRow());
-        }
-        next_x_row++;
-      }
-    }
-
-    // Compute where in the output image this row of final data will go.
-    unsigned char* cur_output_row = &output[out_y * output_byte_row_stride];
-
-    // Get the list of rows that the circular buffer has, in order.
-    int first_row_in_circular_buffer;
-    unsigned char* const* rows_to_convolve =
-        row_buffer.GetRowAddresses(&first_row_in_circular_buffer);
-
-    // Now compute the start of the subset of those rows that the filter
-    // needs.
-    unsigned char* const* first_row_for_filter =
-        &rows_to_convolve[filter_offset - first_row_in_circular_buffer];
-
-    if (source_has_alpha) {
-      if (use_sse2) {
-        ConvolveVertically_SSE2<true>(filter_values, filter_length,
-                                      first_row_for_filter,
-                                      filter_x.num_values(), cur_output_row);
-      } else {
-        ConvolveVertically<true>(filter_values, filter_length,
-                                 first_row_for_filter,
-                                 filter_x.num_values(), cur_output_row);
-      }
-    } else {
-      if (use_sse2) {
-        ConvolveVertically_SSE2<false>(filter_values, filter_length,
-                                       first_row_for_filter,
-                                       filter_x.num_values(), cur_output_row);
-      } else {
-        ConvolveVertically<false>(filter_values, filter_length,
-                                 first_row_for_filter,
-                                 filter_x.num_values(), cur_output_row);
-      }
+  ConvolveJob job;
+  InitConvolveJob(source_data, source_byte_row_stride, source_has_alpha,
+                  filter_x, filter_y, output_byte_row_stride, output,
+                  use_simd_if_possible, &job);
+
+  // The first band is done on this thread, the others on the worker pool.
+  ScopedVector<base::WaitableEvent> done_events;
+  for (int band = 1; band < num_threads; ++band) {
+    int out_y_begin = num_output_rows * band / num_threads;
+    int out_y_end = num_output_rows * (band + 1) / num_threads;
+    base::WaitableEvent* done = new base::WaitableEvent(false, false);
+    done_events.push_back(done);
+    if (!base::WorkerPool::PostTask(
+            FROM_HERE,
+            base::Bind(&ConvolveRowsAndSignal, &job, out_y_begin, out_y_end,
+                       done),
+            false)) {
+      ConvolveRowsAndSignal(&job, out_y_begin, out_y_end, done);
     }
   }
+  ConvolveRows(job, 0, num_output_rows / num_threads);
+
+  for (size_t i = 0; i < done_events.size(); ++i)
+    done_events[i]->Wait();
 }
 
 }  // namespace skia
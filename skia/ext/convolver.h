@@ -14,9 +14,9 @@
 
 #if defined(ARCH_CPU_X86_FAMILY)
 #if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || _M_IX86_FP==2
-// This is where we had compiler support for SSE2 instructions.
-// FIXME: Known buggy, so disabling for M22.
-// #define SIMD_SSE2 1
+// This is where we had compiler support for SSE2 instructions. Whether the
+// CPU supports them is checked at run time.
+#define SIMD_SSE2 1
 #endif
 #endif
 
@@ -160,6 +160,10 @@ class ConvolutionFilter1D {
 //
 // The layout in memory is assumed to be 4-bytes per pixel in B-G-R-A order
 // (this is ARGB when loaded into 32-bit words on a little-endian machine).
+//
+// If |use_simd_if_possible| is true, the fastest instruction set the binary
+// was built with and the CPU supports is used. The filters should then have
+// been padded with PaddingForSIMD(8).
 SK_API void BGRAConvolve2D(const unsigned char* source_data,
                            int source_byte_row_stride,
                            bool source_has_alpha,
@@ -167,7 +171,22 @@ SK_API void BGRAConvolve2D(const unsigned char* source_data,
                            const ConvolutionFilter1D& yfilter,
                            int output_byte_row_stride,
                            unsigned char* output,
-                           bool use_sse2);
+                           bool use_simd_if_possible);
+
+// Same as BGRAConvolve2D(), but splits the output into up to |num_threads|
+// bands of rows which are convolved concurrently on the worker pool. This
+// blocks until all the bands are done, so it must not be called on threads
+// that disallow waiting, such as the browser UI and IO threads.
+SK_API void BGRAConvolve2DInParallel(const unsigned char* source_data,
+                                     int source_byte_row_stride,
+                                     bool source_has_alpha,
+                                     const ConvolutionFilter1D& xfilter,
+                                     const ConvolutionFilter1D& yfilter,
+                                     int output_byte_row_stride,
+                                     unsigned char* output,
+                                     bool use_simd_if_possible,
+                                     int num_threads);
+
 }  // namespace skia
 
 #endif  // SKIA_EXT_CONVOLVER_H_
@@ -4,6 +4,7 @@
 
 #include <string.h>
 #include <time.h>
+#include <algorithm>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -243,6 +244,8 @@ TEST(Convolver, SIMDVerification) {
           offset = source_height - arraysize(filter);
         y_filter.AddFilter(offset, filter, arraysize(filter));
       }
+      x_filter.PaddingForSIMD(8);
+      y_filter.PaddingForSIMD(8);
 
       // Allocate input and output skia bitmap.
       SkBitmap source, result_c, result_sse;
@@ -318,4 +321,46 @@ TEST(Convolver, SIMDVerification) {
 #endif
 }
 
+// Convolving bands of rows on several threads should give the same result as
+// convolving the whole image on one.
+TEST(Convolver, InParallel) {
+  static const int kSourceWidth = 317;
+  static const int kSourceHeight = 401;
+  static const int kDestWidth = 150;
+  static const int kDestHeight = 203;
+  static const float kFilter[] = { 0.125f, 0.25f, 0.25f, 0.25f, 0.125f };
+  static const int kFilterLength = static_cast<int>(arraysize(kFilter));
+
+  ConvolutionFilter1D x_filter, y_filter;
+  for (int p = 0; p < kDestWidth; ++p) {
+    int offset = std::min(kSourceWidth * p / kDestWidth,
+                          kSourceWidth - kFilterLength);
+    x_filter.AddFilter(offset, kFilter, kFilterLength);
+  }
+  for (int p = 0; p < kDestHeight; ++p) {
+    int offset = std::min(kSourceHeight * p / kDestHeight,
+                          kSourceHeight - kFilterLength);
+    y_filter.AddFilter(offset, kFilter, kFilterLength);
+  }
+  x_filter.PaddingForSIMD(8);
+  y_filter.PaddingForSIMD(8);
+
+  int source_stride = kSourceWidth * 4;
+  std::vector<unsigned char> source(source_stride * kSourceHeight);
+  for (size_t i = 0; i < source.size(); ++i)
+    source[i] = rand() % 255;
+
+  int dest_stride = kDestWidth * 4;
+  std::vector<unsigned char> serial(dest_stride * kDestHeight);
+  std::vector<unsigned char> parallel(dest_stride * kDestHeight);
+  for (int alpha = 0; alpha < 2; alpha++) {
+    BGRAConvolve2D(&source[0], source_stride, alpha ? true : false,
+                   x_filter, y_filter, dest_stride, &serial[0], true);
+    BGRAConvolve2DInParallel(&source[0], source_stride, alpha ? true : false,
+                             x_filter, y_filter, dest_stride, &parallel[0],
+                             true, 4);
+    EXPECT_TRUE(serial == parallel);
+  }
+}
+
 }  // namespace skia
@@ -346,15 +346,17 @@ SkBitmap ImageOperations::Resize(const SkBitmap& source,
                                  int dest_width, int dest_height,
                                  const SkIRect& dest_subset) {
   if (method == ImageOperations::RESIZE_SUBPIXEL)
-    return ResizeSubpixel(source, dest_width, dest_height, dest_subset);
+    return ResizeSubpixel(source, dest_width, dest_height, dest_subset, 1);
   else
-    return ResizeBasic(source, method, dest_width, dest_height, dest_subset);
+    return ResizeBasic(source, method, dest_width, dest_height, dest_subset,
+                       1);
 }
 
 // static
 SkBitmap ImageOperations::ResizeSubpixel(const SkBitmap& source,
                                          int dest_width, int dest_height,
-                                         const SkIRect& dest_subset) {
+                                         const SkIRect& dest_subset,
+                                         int num_threads) {
   TRACE_EVENT2("skia", "ImageOperations::ResizeSubpixel",
                "src_pixels", source.width()*source.height(),
                "dst_pixels", dest_width*dest_height);
@@ -385,7 +387,7 @@ SkBitmap ImageOperations::ResizeSubpixel(const SkBitmap& source,
                      dest_subset.fLeft + dest_subset.width() * w,
                      dest_subset.fTop + dest_subset.height() * h };
   SkBitmap img = ResizeBasic(source, ImageOperations::RESIZE_LANCZOS3, width,
-                             height, subset);
+                             height, subset, num_threads);
   const int row_words = img.rowBytes() / 4;
   if (w == 1 && h == 1)
     return img;
@@ -465,7 +467,8 @@ SkBitmap ImageOperations::ResizeSubpixel(const SkBitmap& source,
 SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
                                       ResizeMethod method,
                                       int dest_width, int dest_height,
-                                      const SkIRect& dest_subset) {
+                                      const SkIRect& dest_subset,
+                                      int num_threads) {
   TRACE_EVENT2("skia", "ImageOperations::ResizeBasic",
                "src_pixels", source.width()*source.height(),
                "dst_pixels", dest_width*dest_height);
@@ -507,7 +510,6 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
       reinterpret_cast<const uint8*>(source.getPixels());
 
   // Convolve into the result.
-  base::CPU cpu;
   SkBitmap result;
   result.setConfig(SkBitmap::kARGB_8888_Config,
                    dest_subset.width(), dest_subset.height());
@@ -515,11 +517,12 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   if (!result.readyToDraw())
     return SkBitmap();
 
-  BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
-                 !source.isOpaque(), filter.x_filter(), filter.y_filter(),
-                 static_cast<int>(result.rowBytes()),
-                 static_cast<unsigned char*>(result.getPixels()),
-                 cpu.has_sse2());
+  BGRAConvolve2DInParallel(source_subset, static_cast<int>(source.rowBytes()),
+                           !source.isOpaque(), filter.x_filter(),
+                           filter.y_filter(),
+                           static_cast<int>(result.rowBytes()),
+                           static_cast<unsigned char*>(result.getPixels()),
+                           true, num_threads);
 
   // Preserve the "opaque" flag for use as an optimization later.
   result.setIsOpaque(source.isOpaque());
@@ -538,4 +541,18 @@ SkBitmap ImageOperations::Resize(const SkBitmap& source,
   return Resize(source, method, dest_width, dest_height, dest_subset);
 }
 
+// static
+SkBitmap ImageOperations::ResizeInParallel(const SkBitmap& source,
+                                           ResizeMethod method,
+                                           int dest_width, int dest_height,
+                                           int num_threads) {
+  SkIRect dest_subset = { 0, 0, dest_width, dest_height };
+  if (method == ImageOperations::RESIZE_SUBPIXEL) {
+    return ResizeSubpixel(source, dest_width, dest_height, dest_subset,
+                          num_threads);
+  }
+  return ResizeBasic(source, method, dest_width, dest_height, dest_subset,
+                     num_threads);
+}
+
 }  // namespace skia
@@ -109,6 +109,15 @@ class SK_API ImageOperations {
                          ResizeMethod method,
                          int dest_width, int dest_height);
 
+  // Same as the above, but convolves bands of the destination on up to
+  // |num_threads| threads of the worker pool. This is worth it for large
+  // images only. It blocks until done, so it must not be called on threads
+  // that disallow waiting, such as the browser UI and IO threads.
+  static SkBitmap ResizeInParallel(const SkBitmap& source,
+                                   ResizeMethod method,
+                                   int dest_width, int dest_height,
+                                   int num_threads);
+
  private:
   ImageOperations();  // Class for scoping only.
 
@@ -116,12 +125,14 @@ class SK_API ImageOperations {
   static SkBitmap ResizeBasic(const SkBitmap& source,
                               ResizeMethod method,
                               int dest_width, int dest_height,
-                              const SkIRect& dest_subset);
+                              const SkIRect& dest_subset,
+                              int num_threads);
 
   // Subpixel renderer.
   static SkBitmap ResizeSubpixel(const SkBitmap& source,
                                  int dest_width, int dest_height,
-                                 const SkIRect& dest_subset);
+                                 const SkIRect& dest_subset,
+                                 int num_threads);
 };
 
 }  // namespace skia
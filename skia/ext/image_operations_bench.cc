@@ -16,6 +16,7 @@
 
 #include <stdio.h>
 
+#include "base/at_exit.h"
 #include "base/basictypes.h"
 #include "base/command_line.h"
 #include "base/format_macros.h"
@@ -141,6 +142,7 @@ class Benchmark {
 
   Benchmark()
       : num_iterations_(kDefaultNumberIterations),
+        num_threads_(1),
         method_(kDefaultResizeMethod) {}
 
   // Returns true if command line parsing was successful, false otherwise.
@@ -152,6 +154,7 @@ class Benchmark {
   static void Usage();
  private:
   int num_iterations_;
+  int num_threads_;
   skia::ImageOperations::ResizeMethod method_;
   Dimensions source_;
   Dimensions dest_;
@@ -165,10 +168,11 @@ const skia::ImageOperations::ResizeMethod Benchmark::kDefaultResizeMethod =
 // argument management
 void Benchmark::Usage() {
   printf("image_operations_bench -source wxh -destination wxh "
-         "[-iterations i] [-method m] [-help]\n"
+         "[-iterations i] [-threads n] [-method m] [-help]\n"
          "  -source wxh: specify source width and height\n"
          "  -destination wxh: specify destination width and height\n"
          "  -iter i: perform i iterations (default:%d)\n"
+         "  -threads n: resize in bands on n threads (default:1)\n"
          "  -method m: use method m (default:%s), which can be:",
          Benchmark::kDefaultNumberIterations,
          MethodToString(Benchmark::kDefaultResizeMethod));
@@ -198,6 +202,10 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
       if (base::StringToInt(value, &num_iterations_) == false) {
         fNeedHelp = true;
       }
+    } else if (s == "threads") {
+      if (base::StringToInt(value, &num_threads_) == false) {
+        fNeedHelp = true;
+      }
     } else if (s == "method") {
       if (!StringToMethod(value, &method_)) {
         printf("Invalid method '%s' specified\n", value.c_str());
@@ -212,6 +220,10 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
     printf("Invalid number of iterations: %d\n", num_iterations_);
     fNeedHelp = true;
   }
+  if (num_threads_ <= 0) {
+    printf("Invalid number of threads: %d\n", num_threads_);
+    fNeedHelp = true;
+  }
   if (!source_.IsValid()) {
     printf("Invalid source dimensions specified\n");
     fNeedHelp = true;
@@ -239,9 +251,17 @@ bool Benchmark::Run() const {
   const base::TimeTicks start = base::TimeTicks::Now();
 
   for (int i = 0; i < num_iterations_; ++i) {
-    dest = skia::ImageOperations::Resize(source,
-                                         method_,
-                                         dest_.width(), dest_.height());
+    if (num_threads_ == 1) {
+      dest = skia::ImageOperations::Resize(source,
+                                           method_,
+                                           dest_.width(), dest_.height());
+    } else {
+      dest = skia::ImageOperations::ResizeInParallel(source,
+                                                     method_,
+                                                     dest_.width(),
+                                                     dest_.height(),
+                                                     num_threads_);
+    }
   }
 
   const int64 elapsed_us = (base::TimeTicks::Now() - start).InMicroseconds();
@@ -249,10 +269,11 @@ bool Benchmark::Run() const {
   const uint64 num_bytes = static_cast<uint64>(num_iterations_) *
       (GetBitmapSize(&source) + GetBitmapSize(&dest));
 
-  printf("%"PRIu64" MB/s,\telapsed = %"PRIu64" source=%d dest=%d\n",
+  printf("%"PRIu64" MB/s,\telapsed = %"PRIu64" source=%d dest=%d "
+         "threads=%d\n",
          static_cast<uint64>(elapsed_us == 0 ? 0 : num_bytes / elapsed_us),
          static_cast<uint64>(elapsed_us),
-         GetBitmapSize(&source), GetBitmapSize(&dest));
+         GetBitmapSize(&source), GetBitmapSize(&dest), num_threads_);
 
   return true;
 }
@@ -276,6 +297,8 @@ class CommandLineAutoReset {
 }  // namespace
 
 int main(int argc, char** argv) {
+  // The worker pool used by ResizeInParallel() needs one.
+  base::AtExitManager at_exit_manager;
   Benchmark bench;
   CommandLineAutoReset command_line(argc, argv);
 
@@ -8,6 +8,8 @@
 
 #include "base/file_path.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
@@ -99,7 +101,15 @@ Connection::Connection()
     : db_(NULL),
       page_size_(0),
       cache_size_(0),
+      mmap_size_(0),
       exclusive_locking_(false),
+      wal_mode_(false),
+      statement_cache_size_(0),
+      in_wal_mode_(false),
+      mmap_enabled_(false),
+      statement_prepare_count_(0),
+      step_count_(0),
+      checkpoint_count_(0),
       transaction_nesting_(0),
       needs_rollback_(false),
       in_memory_(false) {
@@ -132,6 +142,7 @@ void Connection::Close() {
   // Release all cached statements, then assert that the client has
   // released all statements.
   statement_cache_.clear();
+  statement_lru_.clear();
   DCHECK(open_statements_.empty());
 
   // Additionally clear the prepared statements, because they contain
@@ -147,10 +158,18 @@ void Connection::Close() {
     // TODO(paivanof@gmail.com): This should move to the beginning
     // of the function. http://crbug.com/136655.
     AssertIOAllowed();
+    if (has_histogram_tag())
+      RecordStats();
     // TODO(shess): Histogram for failure.
     sqlite3_close(db_);
     db_ = NULL;
   }
+  in_wal_mode_ = false;
+  mmap_enabled_ = false;
+  statement_prepare_count_ = 0;
+  step_count_ = 0;
+  step_time_ = base::TimeDelta();
+  checkpoint_count_ = 0;
 }
 
 void Connection::Preload() {
@@ -273,6 +292,25 @@ bool Connection::RazeWithTimout(base::TimeDelta timeout) {
   return Raze();
 }
 
+bool Connection::CheckpointWal() {
+  AssertIOAllowed();
+
+  if (!db_) {
+    DLOG(FATAL) << "Cannot checkpoint null db";
+    return false;
+  }
+
+  if (!in_wal_mode_)
+    return true;
+
+  // A passive checkpoint copies what it can and never blocks, so this is
+  // safe to call whenever the caller has nothing better to do.
+  int rc = sqlite3_wal_checkpoint_v2(db_, NULL, SQLITE_CHECKPOINT_PASSIVE,
+                                     NULL, NULL);
+  ++checkpoint_count_;
+  return rc == SQLITE_OK || rc == SQLITE_BUSY;
+}
+
 bool Connection::BeginTransaction() {
   if (needs_rollback_) {
     DCHECK_GT(transaction_nesting_, 0);
@@ -371,14 +409,28 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     // one invalidating cached statements, and we'll remove it from the cache
     // if we do that. Make sure we reset it before giving out the cached one in
     // case it still has some stuff bound.
-    DCHECK(i->second->is_valid());
-    sqlite3_reset(i->second->stmt());
-    return i->second;
+    DCHECK(i->second.ref->is_valid());
+    sqlite3_reset(i->second.ref->stmt());
+    statement_lru_.splice(statement_lru_.begin(), statement_lru_,
+                          i->second.lru_position);
+    return i->second.ref;
   }
 
   scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
-  if (statement->is_valid())
-    statement_cache_[id] = statement;  // Only cache valid statements.
+  if (!statement->is_valid())
+    return statement;  // Only cache valid statements.
+
+  // An evicted statement stays usable by any Statement still holding it; it
+  // is only finalized once the last reference goes away.
+  if (statement_cache_size_ &&
+      statement_cache_.size() >= statement_cache_size_) {
+    statement_cache_.erase(statement_lru_.back());
+    statement_lru_.pop_back();
+  }
+  statement_lru_.push_front(id);
+  CachedStatement& cached = statement_cache_[id];
+  cached.ref = statement;
+  cached.lru_position = statement_lru_.begin();
   return statement;
 }
 
@@ -395,6 +447,7 @@ scoped_refptr<Connection::StatementRef> Connection::GetUniqueStatement(
     DLOG(FATAL) << "SQL compile error " << GetErrorMessage();
     return new StatementRef();
   }
+  ++statement_prepare_count_;
   return new StatementRef(this, stmt);
 }
 
@@ -541,8 +594,25 @@ bool Connection::OpenInternal(const std::string& file_name) {
   // TODO(shess): Figure out if PERSIST and journal_size_limit really
   // matter.  In theory, it keeps pages pre-allocated, so if
   // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
-  ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
+  //
+  // WAL - append to a -wal file, see set_wal_mode().  The pragma
+  // returns the resulting mode, which is unchanged if WAL is not
+  // supported.  With a write-ahead log the database stays consistent
+  // with synchronous=NORMAL, which only syncs on checkpoint.
+  if (wal_mode_ && !in_memory_) {
+    {
+      Statement s(GetUniqueStatement("PRAGMA journal_mode = WAL"));
+      in_wal_mode_ = s.Step() && s.ColumnString(0) == "wal";
+    }
+    if (in_wal_mode_)
+      ignore_result(Execute("PRAGMA synchronous = NORMAL"));
+    else
+      DLOG(WARNING) << "Could not enable WAL mode: " << GetErrorMessage();
+  }
+  if (!in_wal_mode_) {
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+    ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
+  }
 
   const base::TimeDelta kBusyTimeout =
     base::TimeDelta::FromSeconds(kBusyTimeoutSeconds);
@@ -564,6 +634,15 @@ bool Connection::OpenInternal(const std::string& file_name) {
       DLOG(FATAL) << "Could not set cache size: " << GetErrorMessage();
   }
 
+  if (mmap_size_ > 0 && !in_memory_) {
+    // Versions of sqlite without mmap support ignore the pragma and return
+    // no row, in which case reads keep going through the page cache.
+    const std::string sql =
+        "PRAGMA mmap_size=" + base::Int64ToString(mmap_size_);
+    Statement s(GetUniqueStatement(sql.c_str()));
+    mmap_enabled_ = s.Step() && s.ColumnInt64(0) > 0;
+  }
+
   if (!ExecuteWithTimeout("PRAGMA secure_delete=ON", kBusyTimeout)) {
     DLOG(FATAL) << "Could not enable secure_delete: " << GetErrorMessage();
     Close();
@@ -594,6 +673,7 @@ void Connection::StatementRefDeleted(StatementRef* ref) {
 
 void Connection::ClearCache() {
   statement_cache_.clear();
+  statement_lru_.clear();
 
   // The cache clear will get most statements. There may be still be references
   // to some statements that are held by others (including one-shot statements).
@@ -603,7 +683,54 @@ void Connection::ClearCache() {
     (*i)->Close();
 }
 
+void Connection::RecordStats() {
+  const std::string prefix = "Sqlite." + histogram_tag_;
+  base::Histogram::FactoryGet(
+      prefix + ".StatementPrepares", 1, 100000, 50,
+      base::Histogram::kUmaTargetedHistogramFlag)->Add(
+          statement_prepare_count_);
+  base::Histogram::FactoryGet(
+      prefix + ".Steps", 1, 1000000, 50,
+      base::Histogram::kUmaTargetedHistogramFlag)->Add(step_count_);
+  base::Histogram::FactoryTimeGet(
+      prefix + ".StepTime", base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromHours(1), 50,
+      base::Histogram::kUmaTargetedHistogramFlag)->AddTime(step_time_);
+  base::Histogram::FactoryGet(
+      prefix + ".Checkpoints", 1, 10000, 50,
+      base::Histogram::kUmaTargetedHistogramFlag)->Add(checkpoint_count_);
+  base::BooleanHistogram::FactoryGet(
+      prefix + ".MmapEnabled",
+      base::Histogram::kUmaTargetedHistogramFlag)->AddBoolean(mmap_enabled_);
+
+  int current = 0;
+  int highwater = 0;
+  if (sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater,
+                        0) == SQLITE_OK) {
+    base::Histogram::FactoryGet(
+        prefix + ".CacheUsedKB", 1, 100000, 50,
+        base::Histogram::kUmaTargetedHistogramFlag)->Add(current / 1024);
+  }
+#if defined(SQLITE_DBSTATUS_CACHE_MISS)
+  // Each page cache miss is a read from the file unless it was mapped, so
+  // comparing this across mmap settings gives the reads saved.
+  if (sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater,
+                        0) == SQLITE_OK) {
+    base::Histogram::FactoryGet(
+        prefix + ".CacheMisses", 1, 1000000, 50,
+        base::Histogram::kUmaTargetedHistogramFlag)->Add(current);
+  }
+#endif
+}
+
 int Connection::OnSqliteError(int err, sql::Statement *stmt) {
+  // An I/O error under a memory mapping may be the first of many, so fall
+  // back to read() calls, which report errors instead of faulting.
+  if (mmap_enabled_ && (err & 0xff) == SQLITE_IOERR) {
+    mmap_enabled_ = false;
+    ignore_result(sqlite3_exec(db_, "PRAGMA mmap_size=0", NULL, NULL, NULL));
+  }
+
   if (error_delegate_.get())
     return error_delegate_->OnError(err, this, stmt);
   // The default handling is to assert on debug and to ignore on release.
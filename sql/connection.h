@@ -5,6 +5,7 @@
 #ifndef SQL_CONNECTION_H_
 #define SQL_CONNECTION_H_
 
+#include <list>
 #include <map>
 #include <set>
 #include <string>
@@ -127,6 +128,14 @@ class SQL_EXPORT Connection {
   // called before Open() to have an effect.
   void set_cache_size(int cache_size) { cache_size_ = cache_size; }
 
+  // Allows sqlite to read up to |mmap_size| bytes of the database through a
+  // memory mapping instead of read() calls into its own page cache. This
+  // is only honored by sqlite 3.7.17 and later; older versions, including
+  // the bundled one, silently keep using read(). Mapping is turned back off
+  // for the rest of the connection's life after any I/O error. This must be
+  // called before Open() to have an effect.
+  void set_mmap_size(int64 mmap_size) { mmap_size_ = mmap_size; }
+
   // Call to put the database in exclusive locking mode. There is no "back to
   // normal" flag because of some additional requirements sqlite puts on this
   // transaition (requires another access to the DB) and because we don't
@@ -139,6 +148,27 @@ class SQL_EXPORT Connection {
   // This must be called before Open() to have an effect.
   void set_exclusive_locking() { exclusive_locking_ = true; }
 
+  // Call to use a write-ahead log instead of the default rollback journal.
+  // Commits then append to the -wal file and need no fsync of the main
+  // database, which is much cheaper for databases that commit often. SQLite
+  // folds the log back into the database once it grows past 1000 pages;
+  // CheckpointWal() allows doing that earlier, when the caller is idle.
+  //
+  // This has no effect on in-memory databases. It must be called before
+  // Open() to have an effect.
+  void set_wal_mode() { wal_mode_ = true; }
+
+  // Bounds the statement cache to |size| statements, evicting the least
+  // recently used one when it is full. Zero, the default, means unbounded.
+  void set_statement_cache_size(size_t size) {
+    statement_cache_size_ = size;
+  }
+
+  // Names the database in histograms, which are recorded as
+  // "Sqlite.<tag>.*" when the connection is closed. Without a tag no
+  // statistics are gathered. Should be called before Open().
+  void set_histogram_tag(const std::string& tag) { histogram_tag_ = tag; }
+
   // Sets the object that will handle errors. Recomended that it should be set
   // before calling Open(). If not set, the default is to ignore errors on
   // release and assert on debug builds.
@@ -201,6 +231,11 @@ class SQL_EXPORT Connection {
   bool Raze();
   bool RazeWithTimout(base::TimeDelta timeout);
 
+  // Copies as much of the write-ahead log into the database as can be done
+  // without waiting on readers or writers. Returns false on error. Returns
+  // true without doing anything if the database is not in WAL mode.
+  bool CheckpointWal();
+
   // Transactions --------------------------------------------------------------
 
   // Transaction management. We maintain a virtual transaction stack to emulate
@@ -397,6 +432,19 @@ class SQL_EXPORT Connection {
   // The return value is the error code reflected back to client code.
   int OnSqliteError(int err, Statement* stmt);
 
+  // True if statistics should be gathered for this connection.
+  bool has_histogram_tag() const { return !histogram_tag_.empty(); }
+
+  // Called by Statement objects after each sqlite3_step() when
+  // has_histogram_tag().
+  void RecordStep(base::TimeDelta elapsed) {
+    ++step_count_;
+    step_time_ += elapsed;
+  }
+
+  // Records the statistics gathered since Open() in histograms.
+  void RecordStats();
+
   // Like |Execute()|, but retries if the database is locked.
   bool ExecuteWithTimeout(const char* sql, base::TimeDelta ms_timeout)
       WARN_UNUSED_RESULT;
@@ -417,13 +465,34 @@ class SQL_EXPORT Connection {
   // use the default value.
   int page_size_;
   int cache_size_;
+  int64 mmap_size_;
   bool exclusive_locking_;
-
-  // All cached statements. Keeping a reference to these statements means that
-  // they'll remain active.
-  typedef std::map<StatementID, scoped_refptr<StatementRef> >
-      CachedStatementMap;
+  bool wal_mode_;
+  size_t statement_cache_size_;
+  std::string histogram_tag_;
+
+  // True if the database was actually put in WAL mode by Open().
+  bool in_wal_mode_;
+
+  // True while sqlite is reading the database through a memory mapping.
+  bool mmap_enabled_;
+
+  // All cached statements, most recently used first in |statement_lru_|.
+  // Keeping a reference to these statements means that they'll remain active.
+  typedef std::list<StatementID> StatementLRUList;
+  struct CachedStatement {
+    scoped_refptr<StatementRef> ref;
+    StatementLRUList::iterator lru_position;
+  };
+  typedef std::map<StatementID, CachedStatement> CachedStatementMap;
   CachedStatementMap statement_cache_;
+  StatementLRUList statement_lru_;
+
+  // Statistics reported by RecordStats().
+  int statement_prepare_count_;
+  int step_count_;
+  base::TimeDelta step_time_;
+  int checkpoint_count_;
 
   // A list of all StatementRefs we've given out. Each ref must register with
   // us when it's created or destroyed. This allows us to potentially close
@@ -87,6 +87,65 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+TEST_F(SQLConnectionTest, CachedStatementLRU) {
+  sql::StatementID id1("foo", 1);
+  sql::StatementID id2("foo", 2);
+  sql::StatementID id3("foo", 3);
+
+  db().Close();
+  db().set_statement_cache_size(2);
+  ASSERT_TRUE(db().Open(db_path()));
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+
+  { sql::Statement s(db().GetCachedStatement(id1, "SELECT a FROM foo")); }
+  { sql::Statement s(db().GetCachedStatement(id2, "SELECT b FROM foo")); }
+
+  // Using |id1| again makes |id2| the least recently used.
+  { sql::Statement s(db().GetCachedStatement(id1, "SELECT a FROM foo")); }
+  { sql::Statement s(db().GetCachedStatement(id3, "SELECT * FROM foo")); }
+
+  EXPECT_TRUE(db().HasCachedStatement(id1));
+  EXPECT_FALSE(db().HasCachedStatement(id2));
+  EXPECT_TRUE(db().HasCachedStatement(id3));
+}
+
+TEST_F(SQLConnectionTest, WALMode) {
+  db().Close();
+  db().set_wal_mode();
+  ASSERT_TRUE(db().Open(db_path()));
+
+  {
+    sql::Statement s(db().GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+  }
+
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (a, b) VALUES (1, 2)"));
+  EXPECT_TRUE(db().CheckpointWal());
+
+  // The data survives reopening.
+  db().Close();
+  ASSERT_TRUE(db().Open(db_path()));
+  sql::Statement s(db().GetUniqueStatement("SELECT b FROM foo"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(2, s.ColumnInt(0));
+}
+
+// Whether or not this sqlite supports memory mapping, the database must work
+// the same with it requested.
+TEST_F(SQLConnectionTest, MmapSize) {
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (a, b) VALUES (1, 2)"));
+  db().Close();
+
+  db().set_mmap_size(1024 * 1024);
+  ASSERT_TRUE(db().Open(db_path()));
+  sql::Statement s(db().GetUniqueStatement("SELECT b FROM foo"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(2, s.ColumnInt(0));
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
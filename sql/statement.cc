@@ -52,7 +52,7 @@ bool Statement::Run() {
   if (!CheckValid())
     return false;
 
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_DONE;
+  return CheckError(StepInternal()) == SQLITE_DONE;
 }
 
 bool Statement::Step() {
@@ -60,7 +60,7 @@ bool Statement::Step() {
   if (!CheckValid())
     return false;
 
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_ROW;
+  return CheckError(StepInternal()) == SQLITE_ROW;
 }
 
 void Statement::Reset(bool clear_bound_vars) {
@@ -303,6 +303,17 @@ bool Statement::CheckOk(int err) const {
   return err == SQLITE_OK;
 }
 
+int Statement::StepInternal() {
+  Connection* connection = ref_->connection();
+  if (!connection || !connection->has_histogram_tag())
+    return sqlite3_step(ref_->stmt());
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  int rc = sqlite3_step(ref_->stmt());
+  connection->RecordStep(base::TimeTicks::Now() - start);
+  return rc;
+}
+
 int Statement::CheckError(int err) {
   // Please don't add DCHECKs here, OnSqliteError() already has them.
   succeeded_ = (err == SQLITE_OK || err == SQLITE_ROW || err == SQLITE_DONE);
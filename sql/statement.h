@@ -149,6 +149,10 @@ class SQL_EXPORT Statement {
   const char* GetSQLStatement();
 
  private:
+  // Steps the statement, timing it for the connection's statistics if it
+  // gathers any.
+  int StepInternal();
+
   // This is intended to check for serious errors and report them to the
   // connection object. It takes a sqlite error code, and returns the same
   // code. Currently this function just updates the succeeded flag, but will be
@@ -13,6 +13,7 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "sync/engine/backoff_delay_provider.h"
 #include "sync/engine/syncer.h"
 #include "sync/engine/throttled_data_type_tracker.h"
@@ -169,6 +170,16 @@ namespace {
 
 const int kDefaultSessionsCommitDelaySeconds = 10;
 
+// A LOCAL nudge that arrives within this many nudge delays of the previous
+// one for the same type counts as part of a burst of changes.
+const int kNudgeBurstDelayFactor = 4;
+
+// The most a LOCAL nudge delay is stretched during a burst of changes.
+const int kMaxNudgeDelayMultiplier = 8;
+
+// Stretched nudge delays never exceed this, so bursts still sync promptly.
+const int kMaxAdaptiveNudgeDelaySeconds = 10;
+
 bool IsConfigRelatedUpdateSourceValue(
     GetUpdatesCallerInfo::GetUpdatesSource source) {
   switch (source) {
@@ -623,10 +634,11 @@ void SyncSchedulerImpl::ScheduleNudgeImpl(
       << (is_canary_job ? " (canary)" : "");
 
   SyncSourceInfo info(source, type_state_map);
+  const TimeDelta adaptive_delay = GetAdaptiveNudgeDelay(delay, info);
   UpdateNudgeTimeRecords(info);
 
   SyncSession* session(CreateSyncSession(info));
-  SyncSessionJob job(SyncSessionJob::NUDGE, TimeTicks::Now() + delay,
+  SyncSessionJob job(SyncSessionJob::NUDGE, TimeTicks::Now() + adaptive_delay,
                      make_linked_ptr(session), is_canary_job,
                      ConfigurationParams(), nudge_location);
 
@@ -828,8 +840,45 @@ void SyncSchedulerImpl::UpdateNudgeTimeRecords(const SyncSourceInfo& info) {
   }
 }
 
+TimeDelta SyncSchedulerImpl::GetAdaptiveNudgeDelay(
+    const TimeDelta& delay, const SyncSourceInfo& info) {
+  DCHECK_EQ(MessageLoop::current(), sync_loop_);
+  if (info.updates_source != GetUpdatesCallerInfo::LOCAL ||
+      delay <= TimeDelta())
+    return delay;
+
+  // While backing off a nudge can't reach the server any sooner anyway, so
+  // hold it for as long as a burst would.
+  int multiplier = IsBackingOff() ? kMaxNudgeDelayMultiplier : 1;
+  const TimeTicks now = TimeTicks::Now();
+  for (ModelTypeStateMap::const_iterator iter = info.types.begin();
+       iter != info.types.end(); ++iter) {
+    const TimeTicks previous = last_local_nudges_by_model_type_[iter->first];
+    int& type_multiplier = local_nudge_delay_multipliers_[iter->first];
+    if (!previous.is_null() &&
+        now - previous < delay * kNudgeBurstDelayFactor) {
+      type_multiplier = std::min(std::max(type_multiplier, 1) * 2,
+                                 kMaxNudgeDelayMultiplier);
+    } else {
+      type_multiplier = 1;
+    }
+    multiplier = std::max(multiplier, type_multiplier);
+  }
+
+  const TimeDelta max_delay = std::max(
+      delay, TimeDelta::FromSeconds(kMaxAdaptiveNudgeDelaySeconds));
+  return std::min(delay * multiplier, max_delay);
+}
+
 void SyncSchedulerImpl::FinishSyncSessionJob(const SyncSessionJob& job) {
   DCHECK_EQ(MessageLoop::current(), sync_loop_);
+  const TimeTicks now = TimeTicks::Now();
+  if (!last_sync_cycle_end_time_.is_null()) {
+    UMA_HISTOGRAM_LONG_TIMES("Sync.TimeBetweenCycles",
+                             now - last_sync_cycle_end_time_);
+  }
+  last_sync_cycle_end_time_ = now;
+
   // Now update the status of the connection from SCM. We need this to decide
   // whether we need to save/run future jobs. The notifications from SCM are not
   // reliable.
@@ -285,6 +285,13 @@ class SyncSchedulerImpl : public SyncScheduler {
   // is the most flexible place to do this bookkeeping.
   void UpdateNudgeTimeRecords(const sessions::SyncSourceInfo& info);
 
+  // Returns the delay to use for a nudge requested with |delay|. LOCAL nudges
+  // for types that keep changing in quick succession are held back longer so
+  // that a burst of changes is committed in a single sync cycle. Must be
+  // called before UpdateNudgeTimeRecords() for the same nudge.
+  base::TimeDelta GetAdaptiveNudgeDelay(const base::TimeDelta& delay,
+                                        const sessions::SyncSourceInfo& info);
+
   virtual void OnActionableError(const sessions::SyncSessionSnapshot& snapshot);
 
   base::WeakPtrFactory<SyncSchedulerImpl> weak_ptr_factory_;
@@ -342,6 +349,14 @@ class SyncSchedulerImpl : public SyncScheduler {
   typedef std::map<ModelType, base::TimeTicks> ModelTypeTimeMap;
   ModelTypeTimeMap last_local_nudges_by_model_type_;
 
+  // The factor by which LOCAL nudge delays are currently stretched for each
+  // datatype, see GetAdaptiveNudgeDelay().
+  typedef std::map<ModelType, int> ModelTypeMultiplierMap;
+  ModelTypeMultiplierMap local_nudge_delay_multipliers_;
+
+  // When the last sync cycle finished; used for histogramming.
+  base::TimeTicks last_sync_cycle_end_time_;
+
   // Used as an "anti-reentrancy defensive assertion".
   // While true, it is illegal for any new scheduling activity to take place.
   // Ensures that higher layers don't break this law in response to events that
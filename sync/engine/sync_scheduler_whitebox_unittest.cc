@@ -7,6 +7,7 @@
 #include "sync/engine/backoff_delay_provider.h"
 #include "sync/engine/sync_scheduler_impl.h"
 #include "sync/engine/throttled_data_type_tracker.h"
+#include "sync/internal_api/public/base/model_type_state_map.h"
 #include "sync/internal_api/public/engine/polling_constants.h"
 #include "sync/sessions/sync_session_context.h"
 #include "sync/sessions/test_util.h"
@@ -114,6 +115,16 @@ class SyncSchedulerWhiteboxTest : public testing::Test {
 
   SyncSessionContext* context() { return context_.get(); }
 
+  // Returns the delay a LOCAL nudge for |types| requested with |delay| would
+  // be scheduled with, and records the nudge.
+  TimeDelta NudgeAndGetDelay(const TimeDelta& delay, ModelTypeSet types) {
+    SyncSourceInfo info(GetUpdatesCallerInfo::LOCAL,
+                        ModelTypeSetToStateMap(types, std::string()));
+    TimeDelta adaptive_delay = scheduler_->GetAdaptiveNudgeDelay(delay, info);
+    scheduler_->UpdateNudgeTimeRecords(info);
+    return adaptive_delay;
+  }
+
  private:
   MessageLoop message_loop_;
   scoped_ptr<MockConnectionManager> connection_;
@@ -268,4 +279,29 @@ TEST_F(SyncSchedulerWhiteboxTest, ContinueCanaryJobConfig) {
   EXPECT_EQ(decision, SyncSchedulerImpl::CONTINUE);
 }
 
+TEST_F(SyncSchedulerWhiteboxTest, AdaptiveNudgeDelay) {
+  InitializeSyncerOnNormalMode();
+  const TimeDelta delay = TimeDelta::FromMilliseconds(200);
+
+  // The first nudge, and any with no delay, are left alone.
+  EXPECT_EQ(delay, NudgeAndGetDelay(delay, ModelTypeSet(BOOKMARKS)));
+  EXPECT_EQ(TimeDelta(), NudgeAndGetDelay(TimeDelta(),
+                                          ModelTypeSet(BOOKMARKS)));
+
+  // A burst of changes to the same type stretches the delay, up to a limit.
+  EXPECT_EQ(delay * 2, NudgeAndGetDelay(delay, ModelTypeSet(BOOKMARKS)));
+  EXPECT_EQ(delay * 4, NudgeAndGetDelay(delay, ModelTypeSet(BOOKMARKS)));
+  EXPECT_EQ(delay * 8, NudgeAndGetDelay(delay, ModelTypeSet(BOOKMARKS)));
+  EXPECT_EQ(delay * 8, NudgeAndGetDelay(delay, ModelTypeSet(BOOKMARKS)));
+
+  // Other types are unaffected unless nudged together with a busy one.
+  EXPECT_EQ(delay, NudgeAndGetDelay(delay, ModelTypeSet(PREFERENCES)));
+  EXPECT_EQ(delay * 8,
+            NudgeAndGetDelay(delay, ModelTypeSet(BOOKMARKS, PREFERENCES)));
+
+  // Nudges while backing off are held for the longest delay.
+  SetWaitIntervalToExponentialBackoff();
+  EXPECT_EQ(delay * 8, NudgeAndGetDelay(delay, ModelTypeSet(AUTOFILL)));
+}
+
 }  // namespace syncer
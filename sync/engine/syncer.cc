@@ -8,6 +8,7 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/time.h"
 #include "build/build_config.h"
 #include "sync/engine/apply_control_data_updates.h"
@@ -92,11 +93,21 @@ void Syncer::SyncShare(sessions::SyncSession* session,
   session->mutable_status_controller()->UpdateStartTime();
   SyncerStep current_step = first_step;
 
+  // A cycle that downloads types for the first time is timed, split into
+  // waiting on the server and local work, to show how much overlapping the
+  // two could save.
+  const bool is_initial_sync =
+      !session->context()->directory()->initial_sync_ended_types().HasAll(
+          GetRoutingInfoTypes(session->routing_info()));
+  const base::TimeTicks cycle_start = base::TimeTicks::Now();
+  TimeDelta download_time;
+
   SyncerStep next_step = current_step;
   while (!ExitRequested()) {
     TRACE_EVENT1("sync", "SyncerStateMachine",
                  "state", SyncerStepToString(current_step));
     DVLOG(1) << "Syncer step:" << SyncerStepToString(current_step);
+    const base::TimeTicks step_start = base::TimeTicks::Now();
 
     switch (current_step) {
       case SYNCER_BEGIN:
@@ -220,6 +231,8 @@ void Syncer::SyncShare(sessions::SyncSession* session,
       default:
         LOG(ERROR) << "Unknown command: " << current_step;
     }
+    if (current_step == DOWNLOAD_UPDATES)
+      download_time += base::TimeTicks::Now() - step_start;
     DVLOG(2) << "last step: " << SyncerStepToString(last_step) << ", "
              << "current step: " << SyncerStepToString(current_step) << ", "
              << "next step: " << SyncerStepToString(next_step) << ", "
@@ -230,6 +243,14 @@ void Syncer::SyncShare(sessions::SyncSession* session,
     }
     current_step = next_step;
   }
+
+  if (is_initial_sync) {
+    const TimeDelta cycle_time = base::TimeTicks::Now() - cycle_start;
+    UMA_HISTOGRAM_LONG_TIMES("Sync.InitialSyncCycleTime", cycle_time);
+    UMA_HISTOGRAM_LONG_TIMES("Sync.InitialSyncDownloadTime", download_time);
+    UMA_HISTOGRAM_LONG_TIMES("Sync.InitialSyncLocalTime",
+                             cycle_time - download_time);
+  }
 }
 
 void CopyServerFields(syncable::Entry* src, syncable::MutableEntry* dest) {
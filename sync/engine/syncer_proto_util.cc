@@ -5,6 +5,7 @@
 #include "sync/engine/syncer_proto_util.h"
 
 #include "base/format_macros.h"
+#include "base/metrics/histogram.h"
 #include "base/stringprintf.h"
 #include "google_apis/google_api_keys.h"
 #include "sync/engine/net/server_connection_manager.h"
@@ -193,6 +194,10 @@ bool SyncerProtoUtil::PostAndProcessHeaders(ServerConnectionManager* scm,
     LOG(WARNING) << "Error posting from syncer:" << params.response;
     return false;
   }
+  UMA_HISTOGRAM_COUNTS_10000("Sync.PostedKilobytes",
+                             params.buffer_in.size() / 1024);
+  UMA_HISTOGRAM_COUNTS_10000("Sync.ReceivedKilobytes",
+                             params.buffer_out.size() / 1024);
 
   std::string new_token = params.response.update_client_auth_header;
   if (!new_token.empty()) {
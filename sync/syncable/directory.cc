@@ -108,7 +108,7 @@ Directory::Kernel::Kernel(
     : next_write_transaction_id(0),
       name(name),
       metahandles_index(new Directory::MetahandlesIndex),
-      ids_index(new Directory::IdsIndex),
+      ids_map(new Directory::IdsMap),
       parent_id_child_index(new Directory::ParentIdChildIndex),
       client_tag_index(new Directory::ClientTagIndex),
       unsynced_metahandles(new MetahandleSet),
@@ -130,7 +130,7 @@ Directory::Kernel::~Kernel() {
   delete metahandles_to_purge;
   delete parent_id_child_index;
   delete client_tag_index;
-  delete ids_index;
+  delete ids_map;
   STLDeleteElements(metahandles_index);
   delete metahandles_index;
 }
@@ -176,7 +176,7 @@ void Directory::InitializeIndices() {
     EntryKernel* entry = *it;
     InitializeIndexEntry<ParentIdAndHandleIndexer>(entry,
         kernel_->parent_id_child_index);
-    InitializeIndexEntry<IdIndexer>(entry, kernel_->ids_index);
+    (*kernel_->ids_map)[entry->ref(ID).value()] = entry;
     InitializeIndexEntry<ClientTagIndexer>(entry, kernel_->client_tag_index);
     const int64 metahandle = entry->ref(META_HANDLE);
     if (entry->ref(IS_UNSYNCED))
@@ -244,10 +244,9 @@ EntryKernel* Directory::GetEntryById(const Id& id,
                                      ScopedKernelLock* const lock) {
   DCHECK(kernel_);
   // Find it in the in memory ID index.
-  kernel_->needle.put(ID, id);
-  IdsIndex::iterator id_found = kernel_->ids_index->find(&kernel_->needle);
-  if (id_found != kernel_->ids_index->end()) {
-    return *id_found;
+  IdsMap::iterator id_found = kernel_->ids_map->find(id.value());
+  if (id_found != kernel_->ids_map->end()) {
+    return id_found->second;
   }
   return NULL;
 }
@@ -362,7 +361,8 @@ bool Directory::InsertEntry(WriteTransaction* trans,
       return false;
     }
   }
-  if (!SyncAssert(kernel_->ids_index->insert(entry).second,
+  if (!SyncAssert(kernel_->ids_map->insert(
+                      std::make_pair(entry->ref(ID).value(), entry)).second,
                   FROM_HERE,
                   error,
                   trans))
@@ -385,10 +385,12 @@ bool Directory::ReindexId(WriteTransaction* trans,
 
   {
     // Update the indices that depend on the ID field.
-    ScopedIndexUpdater<IdIndexer> updater_a(lock, entry, kernel_->ids_index);
-    ScopedIndexUpdater<ParentIdAndHandleIndexer> updater_b(lock, entry,
+    ScopedIndexUpdater<ParentIdAndHandleIndexer> index_updater(lock, entry,
         kernel_->parent_id_child_index);
+    size_t num_erased = kernel_->ids_map->erase(entry->ref(ID).value());
+    DCHECK_EQ(1U, num_erased);
     entry->put(ID, new_id);
+    (*kernel_->ids_map)[entry->ref(ID).value()] = entry;
   }
   return true;
 }
@@ -525,7 +527,7 @@ bool Directory::VacuumAfterSaveChanges(const SaveChangesSnapshot& snapshot) {
       // We now drop deleted metahandles that are up to date on both the client
       // and the server.
       size_t num_erased = 0;
-      num_erased = kernel_->ids_index->erase(entry);
+      num_erased = kernel_->ids_map->erase(entry->ref(ID).value());
       DCHECK_EQ(1u, num_erased);
       num_erased = kernel_->metahandles_index->erase(entry);
       DCHECK_EQ(1u, num_erased);
@@ -573,7 +575,7 @@ bool Directory::PurgeEntriesWithTypeIn(ModelTypeSet types) {
 
           size_t num_erased = 0;
           EntryKernel* entry = *it;
-          num_erased = kernel_->ids_index->erase(entry);
+          num_erased = kernel_->ids_map->erase(entry->ref(ID).value());
           DCHECK_EQ(1u, num_erased);
           num_erased = kernel_->client_tag_index->erase(entry);
           DCHECK_EQ(entry->ref(UNIQUE_CLIENT_TAG).empty(), !num_erased);
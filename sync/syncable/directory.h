@@ -11,6 +11,7 @@
 
 #include "base/file_util.h"
 #include "base/gtest_prod_util.h"
+#include "base/hash_tables.h"
 #include "sync/internal_api/public/util/report_unrecoverable_error_function.h"
 #include "sync/internal_api/public/util/weak_handle.h"
 #include "sync/syncable/dir_open_result.h"
@@ -63,17 +64,6 @@ struct MetahandleIndexer {
   }
 };
 
-// Traits type for ID field index.
-struct IdIndexer {
-  // This index is of the ID field values.
-  typedef LessField<IdField, ID> Comparator;
-
-  // This index includes all entries.
-  inline static bool ShouldInclude(const EntryKernel* a) {
-    return true;
-  }
-};
-
 // Traits type for unique client tag index.
 struct ClientTagIndexer {
   // This index is of the client-tag values.
@@ -440,7 +430,7 @@ class Directory {
   bool CheckTreeInvariants(syncable::BaseTransaction* trans,
                            const MetahandleSet& handles);
 
-  // Helper to prime ids_index, parent_id_and_names_index, unsynced_metahandles
+  // Helper to prime ids_map, parent_id_and_names_index, unsynced_metahandles
   // and unapplied_metahandles from metahandles_index.
   void InitializeIndices();
 
@@ -478,9 +468,12 @@ class Directory {
 
  public:
   typedef Index<MetahandleIndexer>::Set MetahandlesIndex;
-  typedef Index<IdIndexer>::Set IdsIndex;
+  // Keyed by the ID's string value. Lookups by ID happen for nearly every
+  // entry the syncer touches, so this is hashed rather than ordered; nothing
+  // needs to walk it in ID order.
+  typedef base::hash_map<std::string, EntryKernel*> IdsMap;
   // All entries in memory must be in both the MetahandlesIndex and
-  // the IdsIndex, but only non-deleted entries will be the
+  // the IdsMap, but only non-deleted entries will be the
   // ParentIdChildIndex.
   typedef Index<ParentIdAndHandleIndexer>::Set ParentIdChildIndex;
 
@@ -528,7 +521,7 @@ class Directory {
     // Entries indexed by metahandle
     MetahandlesIndex* metahandles_index;
     // Entries indexed by id
-    IdsIndex* ids_index;
+    IdsMap* ids_map;
     ParentIdChildIndex* parent_id_child_index;
     ClientTagIndex* client_tag_index;
     // So we don't have to create an EntryKernel every time we want to
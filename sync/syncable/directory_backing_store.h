@@ -95,9 +95,11 @@ class DirectoryBackingStore : public base::NonThreadSafe {
   bool LoadInfo(Directory::KernelLoadInfo* info);
 
   // Save/update helpers for entries.  Return false if sqlite commit fails.
-  bool SaveEntryToDB(const EntryKernel& entry);
-  bool SaveNewEntryToDB(const EntryKernel& entry);
-  bool UpdateEntryToDB(const EntryKernel& entry);
+  // Each adds the number of bytes it bound to |bytes_bound|.
+  // UpdateEntryToDB() changes nothing if the entry has no row yet.
+  bool SaveEntryToDB(const EntryKernel& entry, size_t* bytes_bound);
+  bool SaveNewEntryToDB(const EntryKernel& entry, size_t* bytes_bound);
+  bool UpdateEntryToDB(const EntryKernel& entry, size_t* bytes_bound);
 
   DirOpenResult DoLoad(MetahandlesIndex* entry_bucket,
       Directory::KernelLoadInfo* kernel_load_info);
@@ -158,6 +160,7 @@ class DirectoryBackingStore : public base::NonThreadSafe {
 
   scoped_ptr<sql::Connection> db_;
   sql::Statement save_entry_statement_;
+  sql::Statement update_entry_statement_;
   std::string dir_name_;
 
   // Set to true if migration left some old columns around that need to be
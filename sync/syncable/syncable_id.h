@@ -112,8 +112,8 @@ class Id {
 
  private:
   friend EntryKernel* UnpackEntry(sql::Statement* statement);
-  friend void BindFields(const EntryKernel& entry,
-                         sql::Statement* statement);
+  friend size_t BindFields(const EntryKernel& entry,
+                           sql::Statement* statement);
   friend std::ostream& operator<<(std::ostream& out, const Id& id);
   friend class MockConnectionManager;
   friend class SyncableIdTest;
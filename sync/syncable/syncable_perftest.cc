@@ -0,0 +1,85 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "sync/syncable/directory.h"
+#include "sync/syncable/in_memory_directory_backing_store.h"
+#include "sync/syncable/mutable_entry.h"
+#include "sync/syncable/read_transaction.h"
+#include "sync/syncable/write_transaction.h"
+#include "sync/test/null_directory_change_delegate.h"
+#include "sync/test/null_transaction_observer.h"
+#include "sync/util/test_unrecoverable_error_handler.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace syncer {
+namespace syncable {
+
+namespace {
+
+// Number of entries, roughly that of a user with many synced bookmarks.
+const int kEntryCount = 100000;
+
+const char kName[] = "Perf";
+
+}  // namespace
+
+// Measures creating, looking up and saving a large directory.
+TEST(SyncableDirectoryPerfTest, LargeDirectory) {
+  MessageLoop message_loop;
+  TestUnrecoverableErrorHandler handler;
+  NullDirectoryChangeDelegate delegate;
+  scoped_ptr<Directory> dir(new Directory(
+      new InMemoryDirectoryBackingStore(kName), &handler, NULL, NULL, NULL));
+  ASSERT_EQ(OPENED, dir->Open(kName, &delegate, NullTransactionObserver()));
+
+  std::vector<Id> ids;
+  ids.reserve(kEntryCount);
+  {
+    PerfTimeLogger timer("SyncableDirectory_create");
+    WriteTransaction trans(FROM_HERE, UNITTEST, dir.get());
+    for (int i = 0; i < kEntryCount; ++i) {
+      MutableEntry e(&trans, CREATE, trans.root_id(),
+                     base::StringPrintf("entry %d", i));
+      e.Put(IS_UNSYNCED, true);
+      ids.push_back(e.Get(ID));
+    }
+  }
+
+  {
+    PerfTimeLogger timer("SyncableDirectory_save_all_dirty");
+    ASSERT_TRUE(dir->SaveChanges());
+  }
+
+  {
+    PerfTimeLogger timer("SyncableDirectory_lookup_by_id");
+    ReadTransaction trans(FROM_HERE, dir.get());
+    for (size_t i = 0; i < ids.size(); ++i) {
+      Entry e(&trans, GET_BY_ID, ids[i]);
+      ASSERT_TRUE(e.good());
+    }
+  }
+
+  {
+    PerfTimeLogger timer("SyncableDirectory_update");
+    WriteTransaction trans(FROM_HERE, UNITTEST, dir.get());
+    for (size_t i = 0; i < ids.size(); i += 10) {
+      MutableEntry e(&trans, GET_BY_ID, ids[i]);
+      e.Put(IS_UNSYNCED, false);
+    }
+  }
+
+  {
+    PerfTimeLogger timer("SyncableDirectory_save_tenth_dirty");
+    ASSERT_TRUE(dir->SaveChanges());
+  }
+}
+
+}  // namespace syncable
+}  // namespace syncer
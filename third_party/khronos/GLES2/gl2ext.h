@@ -1751,6 +1751,17 @@ typedef void* (GL_APIENTRYP PFNGLMAPTEXSUBIMAGE2DCHROMIUM) (GLenum target, GLint
 typedef void  (GL_APIENTRYP PFNGLUNMAPTEXSUBIMAGE2DCHROMIUM) (const void* mem);
 #endif
 
+/* GL_CHROMIUM_pixel_transfer_buffer_object */
+#ifndef GL_CHROMIUM_pixel_transfer_buffer_object
+#define GL_CHROMIUM_pixel_transfer_buffer_object 1
+#ifndef GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM
+#define GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM 0x78EC
+#endif
+#ifndef GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM
+#define GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM 0x78ED
+#endif
+#endif
+
 /* GL_CHROMIUM_resize */
 #ifndef GL_CHROMIUM_resize
 #define GL_CHROMIUM_resize 1
@@ -2003,6 +2014,14 @@ typedef void (GL_APIENTRYP PFNGLCOPYTEXTURECHROMIUM) (GLenum target, GLenum sour
 #define GL_GET_ERROR_QUERY_CHROMIUM 0x84F3
 #endif
 
+/* GL_CHROMIUM_async_read_pixels */
+/* Exposes GL_CHROMIUM_async_read_pixels.
+ */
+#ifndef GL_CHROMIUM_async_read_pixels
+#define GL_CHROMIUM_async_read_pixels 1
+#define GL_ASYNC_READ_PIXELS_COMPLETED_CHROMIUM 0x84F5
+#endif
+
 /* GL_CHROMIUM_texture_mailbox */
 #ifndef GL_CHROMIUM_texture_mailbox
 #define GL_CHROMIUM_texture_mailbox 1
@@ -0,0 +1,117 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Samples the counters of a running process's StatsTable at a fixed rate
+// and prints them on stdout, one line per counter per sample:
+//
+//   <milliseconds since start> <counter name> <value> <change since last>
+//
+// The table is read without taking its lock, so sampling does not slow down
+// the process being watched.  Chrome creates its table when started with
+// --enable-stats-table, and names it "ChromiumStats2-<browser pid>" (or
+// "ChromeStats2-<browser pid>" in official builds).
+
+#include <stdio.h>
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/format_macros.h"
+#include "base/metrics/stats_table.h"
+#include "base/string_number_conversions.h"
+#include "base/string_util.h"
+#include "base/threading/platform_thread.h"
+#include "base/time.h"
+
+// The name of the table to sample.
+static const char kOptionTable[] = "table";
+// The time between two samples, in milliseconds.
+static const char kOptionInterval[] = "interval-ms";
+// The number of samples to take before exiting.  Samples until killed when
+// absent.
+static const char kOptionCount[] = "count";
+// Only samples the counters whose name starts with this prefix.
+static const char kOptionFilter[] = "filter";
+// Prints every counter in each sample, and not only those that changed.
+static const char kOptionAll[] = "all";
+
+static const int kDefaultIntervalMs = 1000;
+
+static void PrintUsage() {
+  fprintf(stderr,
+          "Usage: stats_sampler --table=<name> [--interval-ms=<ms>] "
+          "[--count=<samples>] [--filter=<prefix>] [--all]\n");
+}
+
+int main(int argc, const char* argv[]) {
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+
+  std::string table_name = command_line.GetSwitchValueASCII(kOptionTable);
+  if (table_name.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  int interval_ms = kDefaultIntervalMs;
+  if (command_line.HasSwitch(kOptionInterval) &&
+      (!base::StringToInt(command_line.GetSwitchValueASCII(kOptionInterval),
+                          &interval_ms) || interval_ms <= 0)) {
+    PrintUsage();
+    return 1;
+  }
+
+  int count = -1;
+  if (command_line.HasSwitch(kOptionCount) &&
+      (!base::StringToInt(command_line.GetSwitchValueASCII(kOptionCount),
+                          &count) || count <= 0)) {
+    PrintUsage();
+    return 1;
+  }
+
+  const std::string filter = command_line.GetSwitchValueASCII(kOptionFilter);
+  const bool print_all = command_line.HasSwitch(kOptionAll);
+
+  base::StatsTableReader reader;
+  if (!reader.Open(table_name)) {
+    fprintf(stderr, "Cannot open the stats table \"%s\".\n",
+            table_name.c_str());
+    return 1;
+  }
+
+  // The values of the previous sample, by counter id.
+  std::map<int, int> previous;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  const base::TimeDelta interval =
+      base::TimeDelta::FromMilliseconds(interval_ms);
+  base::TimeTicks next_sample = start;
+  for (int sample = 0; count < 0 || sample < count; ++sample) {
+    const int64 elapsed_ms = (base::TimeTicks::Now() - start).InMilliseconds();
+    // Counters added since the last sample are picked up as they appear.
+    const int counter_count = reader.GetCounterCount();
+    for (int id = 1; id <= counter_count; ++id) {
+      const char* name = reader.GetCounterName(id);
+      if (!name || !StartsWithASCII(name, filter, true))
+        continue;
+      const int value = reader.GetCounterValue(id);
+      const int delta = value - previous[id];
+      previous[id] = value;
+      if (delta == 0 && sample > 0 && !print_all)
+        continue;
+      printf("%" PRId64 " %s %d %d\n", elapsed_ms, name, value, delta);
+    }
+    fflush(stdout);
+    if (sample + 1 == count)
+      break;
+
+    // Samples at a fixed rate, whatever the time printing took.
+    next_sample += interval;
+    const base::TimeDelta wait = next_sample - base::TimeTicks::Now();
+    if (wait > base::TimeDelta())
+      base::PlatformThread::Sleep(wait);
+  }
+  return 0;
+}
@@ -4,6 +4,8 @@
 
 #include "ui/base/resource/resource_bundle.h"
 
+#include <string.h>
+
 #include <vector>
 
 #include "base/command_line.h"
@@ -15,6 +17,8 @@
 #include "base/stl_util.h"
 #include "base/string_piece.h"
 #include "base/synchronization/lock.h"
+#include "base/sys_byteorder.h"
+#include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "skia/ext/image_operations.h"
@@ -47,6 +51,37 @@ bool ShouldHighlightMissingScaledResources() {
       switches::kHighlightMissingScaledResources);
 }
 
+// Reads the size of the PNG image in |data| from its IHDR chunk, which the
+// format requires to come first, so that the image can be sized without
+// being decoded. Returns false if |data| does not start like a PNG.
+bool GetPNGSize(const base::StringPiece& data, gfx::Size* size) {
+  static const char kPNGSignature[] = "\x89PNG\r\n\x1a\n";
+  // The 8 byte signature, the IHDR chunk length and type, then the width and
+  // height as big-endian 32 bit integers.
+  const size_t kSignatureSize = 8;
+  const size_t kChunkTypeOffset = 12;
+  const size_t kWidthOffset = 16;
+  const size_t kHeightOffset = 20;
+  if (data.size() < kHeightOffset + sizeof(uint32) ||
+      memcmp(data.data(), kPNGSignature, kSignatureSize) != 0 ||
+      memcmp(data.data() + kChunkTypeOffset, "IHDR", 4) != 0)
+    return false;
+
+  uint32 width;
+  uint32 height;
+  memcpy(&width, data.data() + kWidthOffset, sizeof(width));
+  memcpy(&height, data.data() + kHeightOffset, sizeof(height));
+  width = base::NetToHost32(width);
+  height = base::NetToHost32(height);
+  const uint32 kMaxDimension = kint32max;
+  if (width == 0 || height == 0 || width > kMaxDimension ||
+      height > kMaxDimension)
+    return false;
+
+  size->SetSize(width, height);
+  return true;
+}
+
 }  // namespace
 
 // An ImageSkiaSource that loads bitmaps for requested scale factor from
@@ -344,24 +379,34 @@ gfx::Image& ResourceBundle::GetImageNamed(int resource_id) {
     DCHECK(!delegate_ && !data_packs_.empty()) <<
         "Missing call to SetResourcesDataDLL?";
 
+    // PNGs are sized from their header and only decoded by the image source
+    // when first drawn, which keeps the many images looked up at startup but
+    // never shown from costing decode time and memory.
     // TODO(oshima): Pick the scale factor from currently used scale factors.
-    scoped_ptr<SkBitmap> bitmap(LoadBitmap(resource_id, SCALE_FACTOR_100P));
-    if (!bitmap.get()) {
-      LOG(WARNING) << "Unable to load image with id " << resource_id;
-      NOTREACHED();  // Want to assert in debug mode.
-      // The load failed to retrieve the image; show a debugging red square.
-      return GetEmptyImage();
+    gfx::Size size_in_dip;
+    scoped_ptr<SkBitmap> bitmap;
+    if (!GetPNGSize(GetRawDataResource(resource_id, SCALE_FACTOR_100P),
+                    &size_in_dip)) {
+      bitmap.reset(LoadBitmap(resource_id, SCALE_FACTOR_100P));
+      if (!bitmap.get()) {
+        LOG(WARNING) << "Unable to load image with id " << resource_id;
+        NOTREACHED();  // Want to assert in debug mode.
+        // The load failed to retrieve the image; show a debugging red square.
+        return GetEmptyImage();
+      }
+      size_in_dip.SetSize(bitmap->width(), bitmap->height());
     }
 
     // ResourceBundle::GetSharedInstance() is destroyed after the
     // BrowserMainLoop has finished running. |image_skia| is guaranteed to be
     // destroyed before the resource bundle is destroyed.
-    gfx::Size size_in_dip(bitmap->width(), bitmap->height());
     gfx::ImageSkia image_skia(
         new ResourceBundleImageSource(this, resource_id, size_in_dip),
         size_in_dip);
-    image_skia.AddRepresentation(gfx::ImageSkiaRep(*bitmap.get(),
-                                                   SCALE_FACTOR_100P));
+    if (bitmap.get()) {
+      image_skia.AddRepresentation(gfx::ImageSkiaRep(*bitmap.get(),
+                                                     SCALE_FACTOR_100P));
+    }
     image_skia.SetReadOnly();
     image = gfx::Image(image_skia);
   }
@@ -596,9 +641,13 @@ SkBitmap* ResourceBundle::LoadBitmap(const ResourceHandle& data_handle,
   if (!memory)
     return NULL;
 
+  base::TimeTicks start_time = base::TimeTicks::Now();
   SkBitmap bitmap;
-  if (gfx::PNGCodec::Decode(memory->front(), memory->size(), &bitmap))
+  if (gfx::PNGCodec::Decode(memory->front(), memory->size(), &bitmap)) {
+    UMA_HISTOGRAM_TIMES("Image.ResourceDecodeMS",
+                        base::TimeTicks::Now() - start_time);
     return new SkBitmap(bitmap);
+  }
 
   // 99% of our assets are PNGs, however fallback to JPEG.
   SkBitmap* allocated_bitmap =
@@ -368,4 +368,32 @@ TEST(ResourceBundle, GetImageNamed) {
   }
 }
 
+// Test that PNG images are sized without being decoded, and that the 1x
+// bitmap is only decoded once a representation is requested.
+TEST(ResourceBundle, GetImageNamedDecodesLazily) {
+  ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+
+  FilePath locale_path = dir.path().Append(FILE_PATH_LITERAL("empty.pak"));
+  FilePath data_path = dir.path().Append(FILE_PATH_LITERAL("sample.pak"));
+
+  ASSERT_EQ(file_util::WriteFile(locale_path, kEmptyPakContents,
+      kEmptyPakSize), static_cast<int>(kEmptyPakSize));
+  CreateDataPackWithSingleBitmap(data_path, 10);
+
+  ResourceBundle resource_bundle(NULL);
+  resource_bundle.LoadTestResources(data_path, locale_path);
+
+  gfx::ImageSkia* image_skia = resource_bundle.GetImageSkiaNamed(3);
+  EXPECT_EQ(10, image_skia->width());
+  EXPECT_EQ(10, image_skia->height());
+  EXPECT_TRUE(image_skia->image_reps().empty());
+
+  gfx::ImageSkiaRep image_rep =
+      image_skia->GetRepresentation(ui::SCALE_FACTOR_100P);
+  EXPECT_EQ(ui::SCALE_FACTOR_100P, image_rep.scale_factor());
+  EXPECT_EQ(10, image_rep.pixel_width());
+  EXPECT_EQ(1u, image_skia->image_reps().size());
+}
+
 }  // namespace ui
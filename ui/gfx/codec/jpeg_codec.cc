@@ -6,8 +6,15 @@
 
 #include <setjmp.h>
 
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
+#include "base/threading/worker_pool.h"
+#include "base/time.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorPriv.h"
 
@@ -202,6 +209,7 @@ class CompressDestroyer {
 bool JPEGCodec::Encode(const unsigned char* input, ColorFormat format,
                        int w, int h, int row_byte_width,
                        int quality, std::vector<unsigned char>* output) {
+  base::TimeTicks encode_start = base::TimeTicks::Now();
   jpeg_compress_struct cinfo;
   CompressDestroyer destroyer;
   destroyer.SetManagedObject(&cinfo);
@@ -313,9 +321,49 @@ bool JPEGCodec::Encode(const unsigned char* input, ColorFormat format,
 #endif
 
   jpeg_finish_compress(&cinfo);
+  UMA_HISTOGRAM_TIMES("Image.JPEGEncodeMS",
+                      base::TimeTicks::Now() - encode_start);
   return true;
 }
 
+namespace {
+
+void EncodeSkBitmapOnWorker(const SkBitmap& input, int quality,
+                            base::RefCountedBytes* output) {
+  SkAutoLockPixels lock_input(input);
+  if (input.empty() ||
+      !JPEGCodec::Encode(reinterpret_cast<const unsigned char*>(
+                             input.getAddr32(0, 0)),
+                         JPEGCodec::FORMAT_SkBitmap, input.width(),
+                         input.height(), static_cast<int>(input.rowBytes()),
+                         quality, &output->data())) {
+    output->data().clear();
+  }
+}
+
+void RunEncodeCallback(const JPEGCodec::EncodeCallback& callback,
+                       scoped_refptr<base::RefCountedBytes> output) {
+  callback.Run(output->data().empty() ? NULL : output);
+}
+
+}  // namespace
+
+// static
+void JPEGCodec::EncodeSkBitmapAsync(const SkBitmap& input, int quality,
+                                    const EncodeCallback& callback) {
+  // The caller may change the pixels while the worker encodes them. If the
+  // copy fails, encoding the empty bitmap fails and the callback gets NULL.
+  SkBitmap copy;
+  input.copyTo(&copy, SkBitmap::kARGB_8888_Config);
+
+  scoped_refptr<base::RefCountedBytes> output(new base::RefCountedBytes);
+  base::WorkerPool::PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&EncodeSkBitmapOnWorker, copy, quality, output),
+      base::Bind(&RunEncodeCallback, callback, output),
+      true);
+}
+
 // Decoder --------------------------------------------------------------------
 
 namespace {
@@ -8,10 +8,16 @@
 #include <stddef.h>
 #include <vector>
 
+#include "base/callback_forward.h"
+#include "base/memory/ref_counted.h"
 #include "ui/base/ui_export.h"
 
 class SkBitmap;
 
+namespace base {
+class RefCountedBytes;
+}
+
 namespace gfx {
 
 // Interface for encoding/decoding JPEG data. This is a wrapper around libjpeg,
@@ -37,6 +43,10 @@ class UI_EXPORT JPEGCodec {
     FORMAT_SkBitmap
   };
 
+  // Receives the encoded data of an asynchronous encode, or NULL on failure.
+  typedef base::Callback<void(scoped_refptr<base::RefCountedBytes>)>
+      EncodeCallback;
+
   enum LibraryVariant {
     SYSTEM_LIBJPEG = 0,
     LIBJPEG_TURBO,
@@ -60,6 +70,11 @@ class UI_EXPORT JPEGCodec {
                      int w, int h, int row_byte_width,
                      int quality, std::vector<unsigned char>* output);
 
+  // Encodes a copy of the skia bitmap |input| on the worker pool. |callback|
+  // is run on the calling thread, which must have a message loop.
+  static void EncodeSkBitmapAsync(const SkBitmap& input, int quality,
+                                  const EncodeCallback& callback);
+
   // Decodes the JPEG data contained in input of length input_size. The
   // decoded data will be placed in *output with the dimensions in *w and *h
   // on success (returns true). This data will be written in the'format'
@@ -5,7 +5,13 @@
 #include <math.h>
 
 #include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/run_loop.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 
 namespace {
@@ -98,6 +104,14 @@ static void MakeRGBImage(int w, int h, std::vector<unsigned char>* dat) {
   }
 }
 
+// Stores the result of an asynchronous encode and quits the run loop.
+static void SaveEncodeResult(const base::Closure& quit_closure,
+                             scoped_refptr<base::RefCountedBytes>* result,
+                             scoped_refptr<base::RefCountedBytes> encoded) {
+  *result = encoded;
+  quit_closure.Run();
+}
+
 TEST(JPEGCodec, EncodeDecodeRGB) {
   int w = 20, h = 20;
 
@@ -164,6 +178,39 @@ TEST(JPEGCodec, EncodeDecodeRGBA) {
   ASSERT_GE(jpeg_equality_threshold, AveragePixelDelta(original, decoded));
 }
 
+TEST(JPEGCodec, EncodeSkBitmapAsync) {
+  MessageLoop message_loop;
+  int w = 20, h = 20;
+
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kARGB_8888_Config, w, h);
+  bitmap.allocPixels();
+  bitmap.eraseARGB(0xFF, 0x40, 0x80, 0xC0);
+
+  base::RunLoop run_loop;
+  scoped_refptr<base::RefCountedBytes> encoded;
+  JPEGCodec::EncodeSkBitmapAsync(
+      bitmap, jpeg_quality,
+      base::Bind(&SaveEncodeResult, run_loop.QuitClosure(), &encoded));
+
+  // The caller may change the bitmap once the call returns.
+  bitmap.eraseARGB(0, 0, 0, 0);
+
+  run_loop.Run();
+  ASSERT_TRUE(encoded.get());
+  scoped_ptr<SkBitmap> decoded(JPEGCodec::Decode(encoded->front(),
+                                                 encoded->size()));
+  ASSERT_TRUE(decoded.get());
+  ASSERT_EQ(w, decoded->width());
+  ASSERT_EQ(h, decoded->height());
+
+  SkAutoLockPixels lock(*decoded);
+  SkColor color = decoded->getColor(w / 2, h / 2);
+  EXPECT_NEAR(0x40, static_cast<int>(SkColorGetR(color)), 2);
+  EXPECT_NEAR(0x80, static_cast<int>(SkColorGetG(color)), 2);
+  EXPECT_NEAR(0xC0, static_cast<int>(SkColorGetB(color)), 2);
+}
+
 // Test that corrupted data decompression causes failures.
 TEST(JPEGCodec, DecodeCorrupted) {
   int w = 20, h = 20;
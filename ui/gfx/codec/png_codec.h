@@ -9,10 +9,16 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/callback_forward.h"
+#include "base/memory/ref_counted.h"
 #include "ui/base/ui_export.h"
 
 class SkBitmap;
 
+namespace base {
+class RefCountedBytes;
+}
+
 namespace gfx {
 
 class Size;
@@ -42,6 +48,10 @@ class UI_EXPORT PNGCodec {
     FORMAT_SkBitmap
   };
 
+  // Receives the encoded data of an asynchronous encode, or NULL on failure.
+  typedef base::Callback<void(scoped_refptr<base::RefCountedBytes>)>
+      EncodeCallback;
+
   // Represents a comment in the tEXt ancillary chunk of the png.
   struct UI_EXPORT Comment {
     Comment(const std::string& k, const std::string& t);
@@ -97,6 +107,21 @@ class UI_EXPORT PNGCodec {
                                  bool discard_transparency,
                                  std::vector<unsigned char>* output);
 
+  // Same as EncodeBGRASkBitmap(), but trades size for speed by using zlib's
+  // fastest level and only trying the Sub and Up row filters. Meant for
+  // screenshots and other large images that are not stored for long.
+  static bool EncodeBGRASkBitmapFast(const SkBitmap& input,
+                                     bool discard_transparency,
+                                     std::vector<unsigned char>* output);
+
+  // Encodes a copy of |input| with EncodeBGRASkBitmapFast() if |fast| is true
+  // or EncodeBGRASkBitmap() otherwise, on the worker pool. |callback| is run
+  // on the calling thread, which must have a message loop.
+  static void EncodeBGRASkBitmapAsync(const SkBitmap& input,
+                                      bool discard_transparency,
+                                      bool fast,
+                                      const EncodeCallback& callback);
+
   // Decodes the PNG data contained in input of length input_size. The
   // decoded data will be placed in *output with the dimensions in *w and *h
   // on success (returns true). This data will be written in the 'format'
@@ -126,6 +151,23 @@ class UI_EXPORT PNGCodec {
       std::vector<unsigned char>& bgra, int width, int height);
 
  private:
+  // Shared by the Encode methods. |fast| restricts the row filters libpng
+  // chooses from to Sub and Up.
+  static bool EncodeInternal(const unsigned char* input,
+                             ColorFormat format,
+                             const Size& size,
+                             int row_byte_width,
+                             bool discard_transparency,
+                             const std::vector<Comment>& comments,
+                             int compression_level,
+                             bool fast,
+                             std::vector<unsigned char>* output);
+
+  static bool EncodeBGRASkBitmapInternal(const SkBitmap& input,
+                                         bool discard_transparency,
+                                         bool fast,
+                                         std::vector<unsigned char>* output);
+
   DISALLOW_COPY_AND_ASSIGN(PNGCodec);
 };
 
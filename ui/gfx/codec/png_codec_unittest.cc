@@ -11,7 +11,11 @@
 #include <algorithm>
 #include <cmath>
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/message_loop.h"
+#include "base/run_loop.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorPriv.h"
@@ -271,6 +275,29 @@ void MakeTestSkBitmap(int w, int h, SkBitmap* bmp) {
   }
 }
 
+// Stores the result of an asynchronous encode and quits the run loop.
+void SaveEncodeResult(const base::Closure& quit_closure,
+                      scoped_refptr<base::RefCountedBytes>* result,
+                      scoped_refptr<base::RefCountedBytes> encoded) {
+  *result = encoded;
+  quit_closure.Run();
+}
+
+// Decodes |encoded| and checks that it matches |original|.
+void ExpectDecodesTo(const std::vector<unsigned char>& encoded,
+                     const SkBitmap& original) {
+  SkBitmap decoded;
+  ASSERT_TRUE(PNGCodec::Decode(&encoded.front(), encoded.size(), &decoded));
+  ASSERT_EQ(original.width(), decoded.width());
+  ASSERT_EQ(original.height(), decoded.height());
+  for (int y = 0; y < original.height(); y++) {
+    for (int x = 0; x < original.width(); x++) {
+      EXPECT_TRUE(ColorsClose(original.getAddr32(0, y)[x],
+                              decoded.getAddr32(0, y)[x]));
+    }
+  }
+}
+
 TEST(PNGCodec, EncodeDecodeRGB) {
   const int w = 20, h = 20;
 
@@ -328,6 +355,40 @@ TEST(PNGCodec, EncodeDecodeRGBA) {
   ASSERT_TRUE(original == decoded);
 }
 
+TEST(PNGCodec, EncodeBGRASkBitmapFast) {
+  SkBitmap original_bitmap;
+  MakeTestSkBitmap(20, 20, &original_bitmap);
+
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(PNGCodec::EncodeBGRASkBitmapFast(original_bitmap, false,
+                                               &encoded));
+  ExpectDecodesTo(encoded, original_bitmap);
+}
+
+TEST(PNGCodec, EncodeBGRASkBitmapAsync) {
+  MessageLoop message_loop;
+  SkBitmap expected_bitmap;
+  MakeTestSkBitmap(20, 20, &expected_bitmap);
+
+  for (int fast = 0; fast < 2; fast++) {
+    SkBitmap bitmap;
+    MakeTestSkBitmap(20, 20, &bitmap);
+
+    base::RunLoop run_loop;
+    scoped_refptr<base::RefCountedBytes> encoded;
+    PNGCodec::EncodeBGRASkBitmapAsync(
+        bitmap, false, fast ? true : false,
+        base::Bind(&SaveEncodeResult, run_loop.QuitClosure(), &encoded));
+
+    // The caller may change the bitmap once the call returns.
+    bitmap.eraseARGB(0, 0, 0, 0);
+
+    run_loop.Run();
+    ASSERT_TRUE(encoded.get());
+    ExpectDecodesTo(encoded->data(), expected_bitmap);
+  }
+}
+
 TEST(PNGCodec, EncodeDecodeBGRA) {
   const int w = 20, h = 20;
 
@@ -1129,5 +1190,39 @@ TEST(PNGCodec, EncodeDecodeWithVaryingCompressionLevels) {
   ASSERT_TRUE(original == decoded);
 }
 
+TEST(PNGCodec, EncodeBGRASkBitmapFast) {
+  SkBitmap original_bitmap;
+  MakeTestSkBitmap(20, 20, &original_bitmap);
+
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(PNGCodec::EncodeBGRASkBitmapFast(original_bitmap, false,
+                                               &encoded));
+  ExpectDecodesTo(encoded, original_bitmap);
+}
+
+TEST(PNGCodec, EncodeBGRASkBitmapAsync) {
+  MessageLoop message_loop;
+  SkBitmap expected_bitmap;
+  MakeTestSkBitmap(20, 20, &expected_bitmap);
+
+  for (int fast = 0; fast < 2; fast++) {
+    SkBitmap bitmap;
+    MakeTestSkBitmap(20, 20, &bitmap);
+
+    base::RunLoop run_loop;
+    scoped_refptr<base::RefCountedBytes> encoded;
+    PNGCodec::EncodeBGRASkBitmapAsync(
+        bitmap, false, fast ? true : false,
+        base::Bind(&SaveEncodeResult, run_loop.QuitClosure(), &encoded));
+
+    // The caller may change the bitmap once the call returns.
+    bitmap.eraseARGB(0, 0, 0, 0);
+
+    run_loop.Run();
+    ASSERT_TRUE(encoded.get());
+    ExpectDecodesTo(encoded->data(), expected_bitmap);
+  }
+}
+
 
 }  // namespace gfx
@@ -10,7 +10,9 @@
 #include <vector>
 
 #include "base/i18n/break_iterator.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/mru_cache.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "ui/base/text/utf16_indexing.h"
 #include "ui/gfx/canvas.h"
@@ -61,6 +63,55 @@ void SetPangoUnderlineMetrics(PangoFontDescription *desc,
                                 PANGO_PIXELS(position));
 }
 
+// The number of shaped layouts kept by LayoutCache. UI labels repeat a lot,
+// so this covers the tab strip, bookmark bar and menus of a few windows.
+const size_t kLayoutCacheSize = 256;
+
+// Everything EnsureLayout() gives Pango to shape a layout. Layouts with equal
+// keys are identical and can be shared.
+struct LayoutCacheKey {
+  bool operator<(const LayoutCacheKey& other) const {
+    if (text != other.text)
+      return text < other.text;
+    if (font_description != other.font_description)
+      return font_description < other.font_description;
+    if (direction != other.direction)
+      return direction < other.direction;
+    if (flags != other.flags)
+      return flags < other.flags;
+    return font_styles < other.font_styles;
+  }
+
+  string16 text;
+  std::string font_description;
+  base::i18n::TextDirection direction;
+  int flags;
+  // The start, end and font style of each range whose font style differs
+  // from the default one, in that order.
+  std::vector<int> font_styles;
+};
+
+class LayoutUnrefDeletor {
+ public:
+  void operator()(PangoLayout*& layout) {
+    g_object_unref(layout);
+  }
+};
+
+// Shaped layouts shared by all the RenderTextLinux instances of the UI
+// thread, least recently used first out. A cached layout is never modified,
+// and each user holds its own reference.
+typedef base::MRUCacheBase<LayoutCacheKey, PangoLayout*, LayoutUnrefDeletor>
+    LayoutCacheBase;
+
+class LayoutCache : public LayoutCacheBase {
+ public:
+  LayoutCache() : LayoutCacheBase(kLayoutCacheSize) {}
+};
+
+base::LazyInstance<LayoutCache>::Leaky g_layout_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 // TODO(xji): index saved in upper layer is utf16 index. Pango uses utf8 index.
@@ -272,34 +323,64 @@ void RenderTextLinux::ResetLayout() {
 
 void RenderTextLinux::EnsureLayout() {
   if (layout_ == NULL) {
-    cairo_surface_t* surface =
-        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 0, 0);
-    cairo_t* cr = cairo_create(surface);
-
-    layout_ = pango_cairo_create_layout(cr);
-    cairo_destroy(cr);
-    cairo_surface_destroy(surface);
-
-    SetupPangoLayoutWithFontDescription(layout_,
-                                        GetDisplayText(),
-                                        font_list().GetFontDescriptionString(),
-                                        0,
-                                        GetTextDirection(),
-                                        Canvas::DefaultCanvasTextAlignment());
-
-    // No width set so that the x-axis position is relative to the start of the
-    // text. ToViewPoint and ToTextPoint take care of the position conversion
-    // between text space and view spaces.
-    pango_layout_set_width(layout_, -1);
-    // TODO(xji): If RenderText will be used for displaying purpose, such as
-    // label, we will need to remove the single-line-mode setting.
-    pango_layout_set_single_paragraph_mode(layout_, true);
-
-    // These are used by SetupPangoAttributes.
-    layout_text_ = pango_layout_get_text(layout_);
-    layout_text_len_ = strlen(layout_text_);
-
-    SetupPangoAttributes(layout_);
+    LayoutCacheKey key;
+    key.text = GetDisplayText();
+    key.font_description = font_list().GetFontDescriptionString();
+    key.direction = GetTextDirection();
+    key.flags = Canvas::DefaultCanvasTextAlignment();
+    int default_font_style = font_list().GetFontStyle();
+    for (StyleRanges::const_iterator i = style_ranges().begin();
+         i < style_ranges().end(); ++i) {
+      if (i->font_style != default_font_style) {
+        key.font_styles.push_back(i->range.start());
+        key.font_styles.push_back(i->range.end());
+        key.font_styles.push_back(i->font_style);
+      }
+    }
+
+    // Shaping is the expensive part, and the same labels are laid out over
+    // and over by different views.
+    LayoutCache& cache = g_layout_cache.Get();
+    LayoutCache::iterator cached = cache.Get(key);
+    if (cached != cache.end()) {
+      layout_ = cached->second;
+      g_object_ref(layout_);
+      layout_text_ = pango_layout_get_text(layout_);
+      layout_text_len_ = strlen(layout_text_);
+    } else {
+      cairo_surface_t* surface =
+          cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 0, 0);
+      cairo_t* cr = cairo_create(surface);
+
+      layout_ = pango_cairo_create_layout(cr);
+      cairo_destroy(cr);
+      cairo_surface_destroy(surface);
+
+      SetupPangoLayoutWithFontDescription(layout_,
+                                          key.text,
+                                          key.font_description,
+                                          0,
+                                          key.direction,
+                                          key.flags);
+
+      // No width set so that the x-axis position is relative to the start of
+      // the text. ToViewPoint and ToTextPoint take care of the position
+      // conversion between text space and view spaces.
+      pango_layout_set_width(layout_, -1);
+      // TODO(xji): If RenderText will be used for displaying purpose, such as
+      // label, we will need to remove the single-line-mode setting.
+      pango_layout_set_single_paragraph_mode(layout_, true);
+
+      // These are used by SetupPangoAttributes.
+      layout_text_ = pango_layout_get_text(layout_);
+      layout_text_len_ = strlen(layout_text_);
+
+      SetupPangoAttributes(layout_);
+
+      // The cache holds a reference of its own.
+      g_object_ref(layout_);
+      cache.Put(key, layout_);
+    }
 
     current_line_ = pango_layout_get_line_readonly(layout_, 0);
     pango_layout_line_ref(current_line_);
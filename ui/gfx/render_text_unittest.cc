@@ -986,6 +986,32 @@ TEST_F(RenderTextTest, MoveLeftRightByWordInChineseText) {
   render_text->MoveCursor(WORD_BREAK, CURSOR_RIGHT, false);
   EXPECT_EQ(6U, render_text->cursor_position());
 }
+
+// Instances laying out the same text share a shaped layout, which must not
+// leak between instances whose font styles differ.
+TEST_F(RenderTextTest, SharedLayoutFollowsFontStyle) {
+  const string16 text = ASCIIToUTF16("Shared label");
+  scoped_ptr<RenderText> plain(RenderText::CreateInstance());
+  plain->SetText(text);
+  scoped_ptr<RenderText> same(RenderText::CreateInstance());
+  same->SetText(text);
+  EXPECT_EQ(plain->GetStringSize(), same->GetStringSize());
+
+  scoped_ptr<RenderText> bold(RenderText::CreateInstance());
+  bold->SetText(text);
+  StyleRange bold_style;
+  bold_style.font_style = Font::BOLD;
+  bold_style.range = ui::Range(0, text.length());
+  bold->ApplyStyleRange(bold_style);
+  EXPECT_NE(plain->GetStringSize(), bold->GetStringSize());
+
+  // Changing the style of one instance leaves the others alone.
+  same->ApplyStyleRange(bold_style);
+  EXPECT_EQ(bold->GetStringSize(), same->GetStringSize());
+  scoped_ptr<RenderText> plain_again(RenderText::CreateInstance());
+  plain_again->SetText(text);
+  EXPECT_EQ(plain->GetStringSize(), plain_again->GetStringSize());
+}
 #endif
 
 TEST_F(RenderTextTest, StringSizeSanity) {
@@ -100,9 +100,13 @@ SkBitmap SkBitmapOperations::CreateBlendedBitmap(const SkBitmap& first,
   blended.setConfig(SkBitmap::kARGB_8888_Config, first.width(), first.height(),
                     0);
   blended.allocPixels();
-  blended.eraseARGB(0, 0, 0, 0);
 
-  double first_alpha = 1 - alpha;
+  // Blend in 8.8 fixed point, two channels per multiply: alpha and green in
+  // one word, red and blue in the other, as DownsampleByTwo() does. The
+  // weights add up to 256, so each 16-bit lane holds at most 255 * 256 and
+  // cannot carry into its neighbour.
+  const uint32 second_weight = static_cast<uint32>(alpha * 256 + 0.5);
+  const uint32 first_weight = 256 - second_weight;
 
   for (int y = 0; y < first.height(); ++y) {
     uint32* first_row = first.getAddr32(0, y);
@@ -113,16 +117,12 @@ SkBitmap SkBitmapOperations::CreateBlendedBitmap(const SkBitmap& first,
       uint32 first_pixel = first_row[x];
       uint32 second_pixel = second_row[x];
 
-      int a = static_cast<int>((SkColorGetA(first_pixel) * first_alpha) +
-                               (SkColorGetA(second_pixel) * alpha));
-      int r = static_cast<int>((SkColorGetR(first_pixel) * first_alpha) +
-                               (SkColorGetR(second_pixel) * alpha));
-      int g = static_cast<int>((SkColorGetG(first_pixel) * first_alpha) +
-                               (SkColorGetG(second_pixel) * alpha));
-      int b = static_cast<int>((SkColorGetB(first_pixel) * first_alpha) +
-                               (SkColorGetB(second_pixel) * alpha));
+      uint32 rb = (first_pixel & 0xFF00FF) * first_weight +
+                  (second_pixel & 0xFF00FF) * second_weight;
+      uint32 ag = ((first_pixel >> 8) & 0xFF00FF) * first_weight +
+                  ((second_pixel >> 8) & 0xFF00FF) * second_weight;
 
-      dst_row[x] = SkColorSetARGB(a, r, g, b);
+      dst_row[x] = ((rb >> 8) & 0xFF00FF) | (ag & 0xFF00FF00);
     }
   }
 
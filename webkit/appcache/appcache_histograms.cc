@@ -45,6 +45,23 @@ void AppCacheHistograms::AddMissingManifestEntrySample() {
   UMA_HISTOGRAM_BOOLEAN("appcache.MissingManifestEntry", true);
 }
 
+void AppCacheHistograms::AddResponseInfoPrefetchTimeSample(
+    const base::TimeDelta& duration) {
+  UMA_HISTOGRAM_TIMES("appcache.ResponseInfoPrefetchTime", duration);
+}
+
+void AppCacheHistograms::CountResponseInfoHotSetHit(bool hit) {
+  UMA_HISTOGRAM_BOOLEAN("appcache.ResponseInfoHotSetHit", hit);
+}
+
+void AppCacheHistograms::AddUpdateJobBytesSample(int64 bytes_fetched,
+                                                 int64 bytes_reused) {
+  UMA_HISTOGRAM_MEMORY_KB("appcache.UpdateJobKBFetched",
+                          static_cast<int>(bytes_fetched / 1024));
+  UMA_HISTOGRAM_MEMORY_KB("appcache.UpdateJobKBReused",
+                          static_cast<int>(bytes_reused / 1024));
+}
+
 void AppCacheHistograms::AddMissingManifestDetectedAtCallsite(
     MissingManifestCallsiteType callsite) {
   UMA_HISTOGRAM_ENUMERATION(
@@ -35,6 +35,12 @@ class AppCacheHistograms {
 
   static void AddMissingManifestEntrySample();
 
+  static void AddResponseInfoPrefetchTimeSample(
+      const base::TimeDelta& duration);
+  static void CountResponseInfoHotSetHit(bool hit);
+
+  static void AddUpdateJobBytesSample(int64 bytes_fetched, int64 bytes_reused);
+
   enum MissingManifestCallsiteType {
     CALLSITE_0, CALLSITE_1, CALLSITE_2, CALLSITE_3,
     NUM_MISSING_MANIFEST_CALLSITE_TYPES
@@ -39,6 +39,7 @@ static const int kDefaultQuota = 5 * 1024 * 1024;
 
 static const int kMaxDiskCacheSize = 250 * 1024 * 1024;
 static const int kMaxMemDiskCacheSize = 10 * 1024 * 1024;
+static const size_t kMaxHotResponseInfos = 1024;
 static const FilePath::CharType kDiskCacheDirectoryName[] =
     FILE_PATH_LITERAL("Cache");
 
@@ -514,6 +515,8 @@ void AppCacheStorageImpl::CacheLoadTask::RunCompleted() {
     CreateCacheAndGroupFromRecords(&cache, &group);
   }
   FOR_EACH_DELEGATE(delegates_, OnCacheLoaded(cache, cache_id_));
+  if (cache)
+    storage_->StartPrefetchingResponseInfos(cache);
 }
 
 // GroupLoadTask -------
@@ -1282,6 +1285,73 @@ void AppCacheStorageImpl::UpdateGroupLastAccessTimeTask::Run() {
   database_->UpdateGroupLastAccessTime(group_id_, last_access_time_);
 }
 
+// ResponseInfoPrefetcher -------
+
+// Loads the response infos of a cache's entries one at a time and adds
+// them to the storage's hot set.
+class AppCacheStorageImpl::ResponseInfoPrefetcher
+    : public AppCacheStorage::Delegate {
+ public:
+  ResponseInfoPrefetcher(AppCacheStorageImpl* storage, AppCache* cache)
+      : storage_(storage), cache_id_(cache->cache_id()),
+        manifest_url_(cache->owning_group()->manifest_url()),
+        group_id_(cache->owning_group()->group_id()),
+        start_time_(base::TimeTicks::Now()) {
+    AppCache::EntryMap::const_iterator iter = cache->entries().begin();
+    for (; iter != cache->entries().end() &&
+           response_ids_.size() < kMaxHotResponseInfos; ++iter) {
+      response_ids_.push_back(iter->second.response_id());
+    }
+  }
+
+  virtual ~ResponseInfoPrefetcher() {
+    storage_->CancelDelegateCallbacks(this);
+  }
+
+  // Loads the next response info not already in memory. Once they've all
+  // been loaded, the storage is notified, which deletes this object.
+  void LoadNext();
+
+  // AppCacheStorage::Delegate:
+  virtual void OnResponseInfoLoaded(AppCacheResponseInfo* response_info,
+                                    int64 response_id) OVERRIDE;
+
+ private:
+  AppCacheStorageImpl* storage_;
+  int64 cache_id_;
+  GURL manifest_url_;
+  int64 group_id_;
+  std::deque<int64> response_ids_;
+  base::TimeTicks start_time_;
+};
+
+void AppCacheStorageImpl::ResponseInfoPrefetcher::LoadNext() {
+  while (!response_ids_.empty()) {
+    int64 response_id = response_ids_.front();
+    AppCacheResponseInfo* info =
+        storage_->working_set()->GetResponseInfo(response_id);
+    if (!info) {
+      storage_->AppCacheStorage::LoadResponseInfo(
+          manifest_url_, group_id_, response_id, this);
+      return;
+    }
+    response_ids_.pop_front();
+    storage_->AddHotResponseInfo(info);
+  }
+  AppCacheHistograms::AddResponseInfoPrefetchTimeSample(
+      base::TimeTicks::Now() - start_time_);
+  storage_->OnResponseInfosPrefetched(cache_id_);
+}
+
+void AppCacheStorageImpl::ResponseInfoPrefetcher::OnResponseInfoLoaded(
+    AppCacheResponseInfo* response_info, int64 response_id) {
+  DCHECK(!response_ids_.empty() && response_ids_.front() == response_id);
+  response_ids_.pop_front();
+  if (response_info)
+    storage_->AddHotResponseInfo(response_info);
+  LoadNext();
+}
+
 
 // AppCacheStorageImpl ---------------------------------------------------
 
@@ -1290,11 +1360,13 @@ AppCacheStorageImpl::AppCacheStorageImpl(AppCacheService* service)
       is_response_deletion_scheduled_(false),
       did_start_deleting_responses_(false),
       last_deletable_response_rowid_(0),
+      hot_response_infos_(kMaxHotResponseInfos),
       database_(NULL), is_disabled_(false),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
 }
 
 AppCacheStorageImpl::~AppCacheStorageImpl() {
+  ClearHotResponseInfos();
   std::for_each(pending_quota_queries_.begin(),
                 pending_quota_queries_.end(),
                 std::mem_fun(&DatabaseTask::CancelCompletion));
@@ -1338,6 +1410,7 @@ void AppCacheStorageImpl::Disable() {
   VLOG(1) << "Disabling appcache storage.";
   is_disabled_ = true;
   ClearUsageMapAndNotify();
+  ClearHotResponseInfos();
   working_set()->Disable();
   if (disk_cache_.get())
     disk_cache_->Disable();
@@ -1596,6 +1669,21 @@ void AppCacheStorageImpl::MakeGroupObsolete(
   task->Schedule();
 }
 
+void AppCacheStorageImpl::LoadResponseInfo(
+    const GURL& manifest_url, int64 group_id, int64 response_id,
+    Delegate* delegate) {
+  HotResponseInfos::iterator found = hot_response_infos_.Get(response_id);
+  bool is_hot = found != hot_response_infos_.end();
+  AppCacheHistograms::CountResponseInfoHotSetHit(is_hot);
+  if (!is_hot) {
+    AppCacheResponseInfo* info = working_set_.GetResponseInfo(response_id);
+    if (info)
+      AddHotResponseInfo(info);
+  }
+  AppCacheStorage::LoadResponseInfo(
+      manifest_url, group_id, response_id, delegate);
+}
+
 AppCacheResponseReader* AppCacheStorageImpl::CreateResponseReader(
     const GURL& manifest_url, int64 group_id, int64 response_id) {
   return new AppCacheResponseReader(response_id, group_id, disk_cache());
@@ -1633,10 +1721,40 @@ void AppCacheStorageImpl::DeleteResponses(
 }
 
 void AppCacheStorageImpl::PurgeMemory() {
+  ClearHotResponseInfos();
   scoped_refptr<CloseConnectionTask> task(new CloseConnectionTask(this));
   task->Schedule();
 }
 
+void AppCacheStorageImpl::StartPrefetchingResponseInfos(AppCache* cache) {
+  // The in-memory disk cache used when incognito is already fast enough.
+  if (is_incognito_ || is_disabled_ || !cache->is_complete() ||
+      !cache->owning_group() ||
+      response_info_prefetchers_.count(cache->cache_id())) {
+    return;
+  }
+  ResponseInfoPrefetcher* prefetcher = new ResponseInfoPrefetcher(this, cache);
+  response_info_prefetchers_[cache->cache_id()] = prefetcher;
+  prefetcher->LoadNext();
+}
+
+void AppCacheStorageImpl::OnResponseInfosPrefetched(int64 cache_id) {
+  ResponseInfoPrefetchers::iterator found =
+      response_info_prefetchers_.find(cache_id);
+  DCHECK(found != response_info_prefetchers_.end());
+  delete found->second;
+  response_info_prefetchers_.erase(found);
+}
+
+void AppCacheStorageImpl::AddHotResponseInfo(AppCacheResponseInfo* info) {
+  hot_response_infos_.Put(info->response_id(), info);
+}
+
+void AppCacheStorageImpl::ClearHotResponseInfos() {
+  STLDeleteValues(&response_info_prefetchers_);
+  hot_response_infos_.Clear();
+}
+
 void AppCacheStorageImpl::DelayedStartDeletingUnusedResponses() {
   // Only if we haven't already begun.
   if (!did_start_deleting_responses_) {
@@ -1649,6 +1767,12 @@ void AppCacheStorageImpl::DelayedStartDeletingUnusedResponses() {
 void AppCacheStorageImpl::StartDeletingResponses(
     const std::vector<int64>& response_ids) {
   DCHECK(!response_ids.empty());
+  for (std::vector<int64>::const_iterator iter = response_ids.begin();
+       iter != response_ids.end(); ++iter) {
+    HotResponseInfos::iterator found = hot_response_infos_.Peek(*iter);
+    if (found != hot_response_infos_.end())
+      hot_response_infos_.Erase(found);
+  }
   did_start_deleting_responses_ = true;
   deletable_response_ids_.insert(
       deletable_response_ids_.end(),
@@ -13,6 +13,7 @@
 
 #include "base/callback.h"
 #include "base/file_path.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop_proxy.h"
 #include "webkit/appcache/appcache_database.h"
@@ -52,6 +53,9 @@ class AppCacheStorageImpl : public AppCacheStorage {
                                   int64 cache_id) OVERRIDE;
   virtual void MakeGroupObsolete(AppCacheGroup* group,
                                  Delegate* delegate) OVERRIDE;
+  virtual void LoadResponseInfo(const GURL& manifest_url, int64 group_id,
+                                int64 response_id,
+                                Delegate* delegate) OVERRIDE;
   virtual AppCacheResponseReader* CreateResponseReader(
       const GURL& manifest_url, int64 group_id, int64 response_id) OVERRIDE;
   virtual AppCacheResponseWriter* CreateResponseWriter(
@@ -84,12 +88,16 @@ class AppCacheStorageImpl : public AppCacheStorage {
   class InsertDeletableResponseIdsTask;
   class DeleteDeletableResponseIdsTask;
   class UpdateGroupLastAccessTimeTask;
+  class ResponseInfoPrefetcher;
 
   typedef std::deque<DatabaseTask*> DatabaseTaskQueue;
   typedef std::map<int64, CacheLoadTask*> PendingCacheLoads;
   typedef std::map<GURL, GroupLoadTask*> PendingGroupLoads;
   typedef std::deque<std::pair<GURL, int64> > PendingForeignMarkings;
   typedef std::set<StoreGroupAndCacheTask*> PendingQuotaQueries;
+  typedef std::map<int64, ResponseInfoPrefetcher*> ResponseInfoPrefetchers;
+  typedef base::MRUCache<int64, scoped_refptr<AppCacheResponseInfo> >
+      HotResponseInfos;
 
   bool IsInitTaskComplete() {
     return last_cache_id_ != AppCacheStorage::kUnitializedId;
@@ -111,6 +119,13 @@ class AppCacheStorageImpl : public AppCacheStorage {
   void OnDeletedOneResponse(int rv);
   void OnDiskCacheInitialized(int rv);
 
+  // Reads the response headers of all entries in a freshly loaded cache
+  // into the hot set so subresource loads can skip the disk read.
+  void StartPrefetchingResponseInfos(AppCache* cache);
+  void OnResponseInfosPrefetched(int64 cache_id);
+  void AddHotResponseInfo(AppCacheResponseInfo* info);
+  void ClearHotResponseInfos();
+
   // Sometimes we can respond without having to query the database.
   bool FindResponseForMainRequestInGroup(
       AppCacheGroup* group,  const GURL& url, Delegate* delegate);
@@ -153,6 +168,11 @@ class AppCacheStorageImpl : public AppCacheStorage {
   bool did_start_deleting_responses_;
   int64 last_deletable_response_rowid_;
 
+  // Recently used response infos are kept alive here, which in turn keeps
+  // them in the working set.
+  HotResponseInfos hot_response_infos_;
+  ResponseInfoPrefetchers response_info_prefetchers_;
+
   // Created on the IO thread, but only used on the DB thread.
   AppCacheDatabase* database_;
 
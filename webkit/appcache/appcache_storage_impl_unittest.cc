@@ -16,6 +16,7 @@
 #include "webkit/appcache/appcache_database.h"
 #include "webkit/appcache/appcache_entry.h"
 #include "webkit/appcache/appcache_group.h"
+#include "webkit/appcache/appcache_response.h"
 #include "webkit/appcache/appcache_service.h"
 #include "webkit/appcache/appcache_storage_impl.h"
 #include "webkit/quota/quota_manager.h"
@@ -1247,6 +1248,37 @@ class AppCacheStorageImplTest : public testing::Test {
     TestFinished();
   }
 
+  // ResponseInfoHotSet -------------------------------------------------
+
+  void ResponseInfoHotSet() {
+    // Loading an info that is in the working set adds it to the hot set,
+    // which keeps it in memory after its other references go away.
+    const int64 kResponseId = 1;
+    scoped_refptr<AppCacheResponseInfo> info(new AppCacheResponseInfo(
+        service(), kManifestUrl, kResponseId, new net::HttpResponseInfo,
+        kDefaultEntrySize));
+    AppCacheResponseInfo* raw_info = info.get();
+    storage()->LoadResponseInfo(kManifestUrl, 1, kResponseId, delegate());
+    info = NULL;
+    EXPECT_EQ(raw_info, storage()->working_set()->GetResponseInfo(kResponseId));
+
+    // Dooming the response drops it from the hot set.
+    std::vector<int64> response_ids(1, kResponseId);
+    storage()->DeleteResponses(kManifestUrl, response_ids);
+    EXPECT_FALSE(storage()->working_set()->GetResponseInfo(kResponseId));
+
+    // Purging memory releases the hot set.
+    info = new AppCacheResponseInfo(
+        service(), kManifestUrl, kResponseId + 1, new net::HttpResponseInfo,
+        kDefaultEntrySize);
+    storage()->LoadResponseInfo(kManifestUrl, 1, kResponseId + 1, delegate());
+    info = NULL;
+    EXPECT_TRUE(storage()->working_set()->GetResponseInfo(kResponseId + 1));
+    storage()->PurgeMemory();
+    EXPECT_FALSE(storage()->working_set()->GetResponseInfo(kResponseId + 1));
+    TestFinished();
+  }
+
   // Test case helpers --------------------------------------------------
 
   AppCacheService* service() {
@@ -1413,6 +1445,10 @@ TEST_F(AppCacheStorageImplTest, FindMainResponseExclusionsInWorkingSet) {
       &AppCacheStorageImplTest::FindMainResponseExclusionsInWorkingSet);
 }
 
+TEST_F(AppCacheStorageImplTest, ResponseInfoHotSet) {
+  RunTestOnIOThread(&AppCacheStorageImplTest::ResponseInfoHotSet);
+}
+
 // That's all folks!
 
 }  // namespace appcache
@@ -4,6 +4,8 @@
 
 #include "webkit/appcache/appcache_update_job.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/compiler_specific.h"
@@ -22,7 +24,8 @@
 namespace appcache {
 
 static const int kBufferSize = 32768;
-static const size_t kMaxConcurrentUrlFetches = 2;
+static const size_t kInitialConcurrentUrlFetches = 2;
+static const size_t kMaxConcurrentUrlFetches = 8;
 static const int kMax503Retries = 3;
 
 // Helper class for collecting hosts per frontend when sending notifications
@@ -302,6 +305,9 @@ AppCacheUpdateJob::AppCacheUpdateJob(AppCacheService* service,
       master_entries_completed_(0),
       url_fetches_completed_(0),
       manifest_fetcher_(NULL),
+      max_concurrent_url_fetches_(kInitialConcurrentUrlFetches),
+      bytes_fetched_(0),
+      bytes_reused_(0),
       stored_state_(UNSTORED) {
 }
 
@@ -548,6 +554,7 @@ void AppCacheUpdateJob::HandleUrlFetchCompleted(URLFetcher* fetcher) {
     DCHECK(fetcher->response_writer());
     entry.set_response_id(fetcher->response_writer()->response_id());
     entry.set_response_size(fetcher->response_writer()->amount_written());
+    bytes_fetched_ += entry.response_size();
     if (!inprogress_cache_->AddOrModifyEntry(url, entry))
       duplicate_response_ids_.push_back(entry.response_id());
 
@@ -570,6 +577,7 @@ void AppCacheUpdateJob::HandleUrlFetchCompleted(URLFetcher* fetcher) {
         // Keep the existing response.
         entry.set_response_id(fetcher->existing_entry().response_id());
         entry.set_response_size(fetcher->existing_entry().response_size());
+        bytes_reused_ += entry.response_size();
         inprogress_cache_->AddOrModifyEntry(url, entry);
       } else {
         const char* kFormatString = "Resource fetch failed (%d) %s";
@@ -588,12 +596,15 @@ void AppCacheUpdateJob::HandleUrlFetchCompleted(URLFetcher* fetcher) {
       // of the cache. Impossible to know one way or the other.
       entry.set_response_id(fetcher->existing_entry().response_id());
       entry.set_response_size(fetcher->existing_entry().response_size());
+      if (response_code == 304)
+        bytes_reused_ += entry.response_size();
       inprogress_cache_->AddOrModifyEntry(url, entry);
     }
   }
 
   // Fetch another URL now that one request has completed.
   DCHECK(internal_state_ != CACHE_FAILURE);
+  AdjustUrlFetchConcurrency(response_code / 100 == 2 || response_code == 304);
   FetchUrls();
   MaybeCompleteUpdate();
 }
@@ -931,7 +942,7 @@ void AppCacheUpdateJob::FetchUrls() {
   // Fetch each URL in the list according to section 6.9.4 step 17.1-17.3.
   // Fetch up to the concurrent limit. Other fetches will be triggered as each
   // each fetch completes.
-  while (pending_url_fetches_.size() < kMaxConcurrentUrlFetches &&
+  while (pending_url_fetches_.size() < max_concurrent_url_fetches_ &&
          !urls_to_fetch_.empty()) {
     UrlToFetch url_to_fetch = urls_to_fetch_.front();
     urls_to_fetch_.pop_front();
@@ -969,6 +980,16 @@ void AppCacheUpdateJob::FetchUrls() {
   }
 }
 
+void AppCacheUpdateJob::AdjustUrlFetchConcurrency(bool fetch_succeeded) {
+  if (fetch_succeeded) {
+    max_concurrent_url_fetches_ =
+        std::min(max_concurrent_url_fetches_ + 1, kMaxConcurrentUrlFetches);
+  } else {
+    max_concurrent_url_fetches_ =
+        std::max(max_concurrent_url_fetches_ / 2, static_cast<size_t>(1));
+  }
+}
+
 void AppCacheUpdateJob::CancelAllUrlFetches() {
   // Cancel any pending URL requests.
   for (PendingUrlFetches::iterator it = pending_url_fetches_.begin();
@@ -1049,7 +1070,7 @@ void AppCacheUpdateJob::FetchMasterEntries() {
 
   // Fetch each master entry in the list, up to the concurrent limit.
   // Additional fetches will be triggered as each fetch completes.
-  while (master_entry_fetches_.size() < kMaxConcurrentUrlFetches &&
+  while (master_entry_fetches_.size() < max_concurrent_url_fetches_ &&
          !master_entries_to_fetch_.empty()) {
     const GURL& url = *master_entries_to_fetch_.begin();
 
@@ -1183,6 +1204,7 @@ void AppCacheUpdateJob::OnResponseInfoLoaded(
       AppCacheEntry& entry = it->second;
       entry.set_response_id(response_id);
       entry.set_response_size(copy_me->response_size());
+      bytes_reused_ += entry.response_size();
       inprogress_cache_->AddOrModifyEntry(url, entry);
       NotifyAllProgress(url);
       ++url_fetches_completed_;
@@ -1242,6 +1264,8 @@ void AppCacheUpdateJob::MaybeCompleteUpdate() {
         NotifyAllAssociatedHosts(CACHED_EVENT);
       else
         NotifyAllAssociatedHosts(UPDATE_READY_EVENT);
+      AppCacheHistograms::AddUpdateJobBytesSample(bytes_fetched_,
+                                                  bytes_reused_);
       DiscardDuplicateResponses();
       internal_state_ = COMPLETED;
       break;
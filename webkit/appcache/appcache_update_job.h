@@ -192,6 +192,10 @@ class APPCACHE_EXPORT AppCacheUpdateJob : public AppCacheStorage::Delegate,
   void AddUrlToFileList(const GURL& url, int type);
   void FetchUrls();
   void CancelAllUrlFetches();
+
+  // Grows the number of concurrent fetches by one after each successful
+  // fetch and halves it after a failure, within fixed bounds.
+  void AdjustUrlFetchConcurrency(bool fetch_succeeded);
   bool ShouldSkipUrlFetch(const AppCacheEntry& entry);
 
   // If entry already exists in the cache currently being updated, merge
@@ -272,6 +276,12 @@ class APPCACHE_EXPORT AppCacheUpdateJob : public AppCacheStorage::Delegate,
   // Keep track of pending URL requests so we can cancel them if necessary.
   URLFetcher* manifest_fetcher_;
   PendingUrlFetches pending_url_fetches_;
+  size_t max_concurrent_url_fetches_;
+
+  // Response bytes downloaded by this job and bytes kept from the newest
+  // complete cache without downloading them again.
+  int64 bytes_fetched_;
+  int64 bytes_reused_;
 
   // Temporary storage of manifest response data for parsing and comparison.
   std::string manifest_data_;
@@ -300,6 +310,7 @@ class APPCACHE_EXPORT AppCacheUpdateJob : public AppCacheStorage::Delegate,
   StoredState stored_state_;
 
   FRIEND_TEST_ALL_PREFIXES(AppCacheGroupTest, QueueUpdate);
+  FRIEND_TEST_ALL_PREFIXES(AppCacheUpdateJobTest, AdjustUrlFetchConcurrency);
 
   DISALLOW_COPY_AND_ASSIGN(AppCacheUpdateJob);
 };
@@ -3339,6 +3339,28 @@ TEST_F(AppCacheUpdateJobTest, AlreadyChecking) {
   EXPECT_EQ(AppCacheGroup::CHECKING, group->update_status());
 }
 
+TEST_F(AppCacheUpdateJobTest, AdjustUrlFetchConcurrency) {
+  MockAppCacheService service;
+  scoped_refptr<AppCacheGroup> group(
+      new AppCacheGroup(&service, GURL("http://manifesturl.com"),
+                        service.storage()->NewGroupId()));
+
+  AppCacheUpdateJob update(&service, group);
+  EXPECT_EQ(2U, update.max_concurrent_url_fetches_);
+
+  // Successful fetches open up more connections, up to a limit.
+  for (int i = 0; i < 20; ++i)
+    update.AdjustUrlFetchConcurrency(true);
+  EXPECT_EQ(8U, update.max_concurrent_url_fetches_);
+
+  // Failures back off quickly but never stop fetching altogether.
+  update.AdjustUrlFetchConcurrency(false);
+  EXPECT_EQ(4U, update.max_concurrent_url_fetches_);
+  for (int i = 0; i < 5; ++i)
+    update.AdjustUrlFetchConcurrency(false);
+  EXPECT_EQ(1U, update.max_concurrent_url_fetches_);
+}
+
 TEST_F(AppCacheUpdateJobTest, AlreadyDownloading) {
   MockAppCacheService service;
   scoped_refptr<AppCacheGroup> group(
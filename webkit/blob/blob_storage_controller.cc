@@ -4,7 +4,14 @@
 
 #include "webkit/blob/blob_storage_controller.h"
 
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/platform_file.h"
+#include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "googleurl/src/gurl.h"
 #include "webkit/blob/blob_data.h"
 
@@ -30,15 +37,59 @@ GURL ClearBlobUrlRef(const GURL& url) {
 
 static const int64 kMaxMemoryUsage = 1024 * 1024 * 1024;  // 1G
 
+// Runs on the file thread. Writes the TYPE_BYTES items of |blob_data|, in
+// order, to a new temporary file and returns its path, or an empty path on
+// failure. |blob_data| is finished, so its items don't change meanwhile.
+FilePath WriteBlobBytesToTemporaryFile(const BlobData* blob_data) {
+  FilePath file_path;
+  if (!file_util::CreateTemporaryFile(&file_path))
+    return FilePath();
+
+  base::PlatformFile file = base::CreatePlatformFile(
+      file_path,
+      base::PLATFORM_FILE_CREATE_ALWAYS | base::PLATFORM_FILE_WRITE,
+      NULL, NULL);
+  bool success = file != base::kInvalidPlatformFileValue;
+  int64 file_offset = 0;
+  for (std::vector<BlobData::Item>::const_iterator iter =
+           blob_data->items().begin();
+       success && iter != blob_data->items().end(); ++iter) {
+    if (iter->type() != BlobData::Item::TYPE_BYTES)
+      continue;
+    int length = static_cast<int>(iter->length());
+    success = base::WritePlatformFile(
+        file, file_offset,
+        iter->bytes() + static_cast<size_t>(iter->offset()),
+        length) == length;
+    file_offset += length;
+  }
+  if (file != base::kInvalidPlatformFileValue)
+    success &= base::ClosePlatformFile(file);
+
+  if (!success) {
+    file_util::Delete(file_path, false);
+    return FilePath();
+  }
+  return file_path;
+}
+
 }  // namespace
 
 BlobStorageController::BlobStorageController()
-    : memory_usage_(0) {
+    : memory_usage_(0),
+      spill_memory_budget_(0),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
 }
 
 BlobStorageController::~BlobStorageController() {
 }
 
+void BlobStorageController::EnableDiskSpill(base::TaskRunner* file_task_runner,
+                                            int64 memory_budget) {
+  file_task_runner_ = file_task_runner;
+  spill_memory_budget_ = memory_budget;
+}
+
 void BlobStorageController::StartBuildingBlob(const GURL& url) {
   DCHECK(url.SchemeIs("blob"));
   DCHECK(!BlobUrlHasRef(url));
@@ -120,9 +171,15 @@ void BlobStorageController::FinishBuildingBlob(
   BlobMap::iterator found = unfinalized_blob_map_.find(url.spec());
   if (found == unfinalized_blob_map_.end())
     return;
-  found->second->set_content_type(content_type);
-  blob_map_[url.spec()] = found->second;
+  BlobData* blob_data = found->second;
+  blob_data->set_content_type(content_type);
+  blob_map_[url.spec()] = blob_data;
   unfinalized_blob_map_.erase(found);
+
+  if (file_task_runner_ && memory_usage_ > spill_memory_budget_ &&
+      blob_data->GetMemoryUsage() > 0) {
+    SpillBlobToDisk(blob_data);
+  }
 }
 
 void BlobStorageController::AddFinishedBlob(const GURL& url,
@@ -235,6 +292,85 @@ void BlobStorageController::AppendFileSystemFileItem(
                                          expected_modification_time);
 }
 
+void BlobStorageController::SpillBlobToDisk(BlobData* blob_data) {
+  if (!blobs_being_spilled_.insert(blob_data).second)
+    return;
+  // |blob_data| is kept alive by the reply, which is bound and destroyed on
+  // this thread.
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_,
+      FROM_HERE,
+      base::Bind(&WriteBlobBytesToTemporaryFile, base::Unretained(blob_data)),
+      base::Bind(&BlobStorageController::DidSpillBlobToDisk,
+                 weak_factory_.GetWeakPtr(),
+                 make_scoped_refptr(blob_data)));
+}
+
+void BlobStorageController::DidSpillBlobToDisk(
+    scoped_refptr<BlobData> blob_data,
+    FilePath file_path) {
+  blobs_being_spilled_.erase(blob_data.get());
+  UMA_HISTOGRAM_BOOLEAN("Storage.Blob.SpilledToDisk", !file_path.empty());
+  if (file_path.empty())
+    return;
+
+  scoped_refptr<ShareableFileReference> spill_file =
+      ShareableFileReference::GetOrCreate(
+          file_path, ShareableFileReference::DELETE_ON_FINAL_RELEASE,
+          file_task_runner_);
+
+  BlobDataUsageMap::iterator usage =
+      blob_data_usage_count_.find(blob_data.get());
+  if (usage == blob_data_usage_count_.end())
+    return;  // Removed meanwhile, |spill_file| gets deleted.
+
+  // Build a copy of the blob with each run of in-memory items replaced by a
+  // range of the file. Requests already reading |blob_data| hold on to it,
+  // new ones get the copy.
+  scoped_refptr<BlobData> spilled_blob_data(new BlobData);
+  spilled_blob_data->set_content_type(blob_data->content_type());
+  spilled_blob_data->set_content_disposition(
+      blob_data->content_disposition());
+  spilled_blob_data->AttachShareableFileReference(spill_file);
+  uint64 file_offset = 0;
+  uint64 run_length = 0;
+  const std::vector<BlobData::Item>& items = blob_data->items();
+  for (size_t i = 0; i <= items.size(); ++i) {
+    if (i < items.size() && items[i].type() == BlobData::Item::TYPE_BYTES) {
+      run_length += items[i].length();
+      continue;
+    }
+    if (run_length) {
+      spilled_blob_data->AppendFile(file_path, file_offset, run_length,
+                                    base::Time());
+      file_offset += run_length;
+      run_length = 0;
+    }
+    if (i == items.size())
+      break;
+    const BlobData::Item& item = items[i];
+    if (item.type() == BlobData::Item::TYPE_FILE) {
+      AppendFileItem(spilled_blob_data, item.path(), item.offset(),
+                     item.length(), item.expected_modification_time());
+    } else {
+      DCHECK_EQ(BlobData::Item::TYPE_FILE_FILESYSTEM, item.type());
+      AppendFileSystemFileItem(spilled_blob_data, item.url(), item.offset(),
+                               item.length(),
+                               item.expected_modification_time());
+    }
+  }
+
+  for (BlobMap::iterator iter = blob_map_.begin(); iter != blob_map_.end();
+       ++iter) {
+    if (iter->second.get() == blob_data.get())
+      iter->second = spilled_blob_data;
+  }
+  blob_data_usage_count_[spilled_blob_data.get()] = usage->second;
+  blob_data_usage_count_.erase(usage);
+  memory_usage_ -= blob_data->GetMemoryUsage();
+  memory_usage_ += spilled_blob_data->GetMemoryUsage();
+}
+
 void BlobStorageController::IncrementBlobDataUsage(BlobData* blob_data) {
   blob_data_usage_count_[blob_data] += 1;
 }
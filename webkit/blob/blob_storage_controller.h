@@ -6,10 +6,12 @@
 #define WEBKIT_BLOB_BLOB_STORAGE_CONTROLLER_H_
 
 #include <map>
+#include <set>
 #include <string>
 
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/process.h"
 #include "webkit/blob/blob_data.h"
 #include "webkit/blob/blob_export.h"
@@ -18,6 +20,7 @@ class GURL;
 class FilePath;
 
 namespace base {
+class TaskRunner;
 class Time;
 }
 
@@ -29,6 +32,12 @@ class BLOB_EXPORT BlobStorageController {
   BlobStorageController();
   ~BlobStorageController();
 
+  // Once blobs held in memory add up to more than |memory_budget| bytes,
+  // each blob finished afterwards has its bytes written to a temporary file
+  // on |file_task_runner| and is then backed by that file instead.
+  void EnableDiskSpill(base::TaskRunner* file_task_runner,
+                       int64 memory_budget);
+
   void StartBuildingBlob(const GURL& url);
   void AppendBlobDataItem(const GURL& url, const BlobData::Item& data_item);
   void FinishBuildingBlob(const GURL& url, const std::string& content_type);
@@ -43,6 +52,10 @@ class BLOB_EXPORT BlobStorageController {
   typedef base::hash_map<std::string, scoped_refptr<BlobData> > BlobMap;
   typedef std::map<BlobData*, int> BlobDataUsageMap;
 
+  void SpillBlobToDisk(BlobData* blob_data);
+  void DidSpillBlobToDisk(scoped_refptr<BlobData> blob_data,
+                          FilePath file_path);
+
   void AppendStorageItems(BlobData* target_blob_data,
                           BlobData* src_blob_data,
                           uint64 offset,
@@ -73,6 +86,13 @@ class BLOB_EXPORT BlobStorageController {
   // how many urls refer to a BlobData.
   BlobDataUsageMap blob_data_usage_count_;
 
+  // Disk spill is disabled while |file_task_runner_| is NULL.
+  scoped_refptr<base::TaskRunner> file_task_runner_;
+  int64 spill_memory_budget_;
+  std::set<BlobData*> blobs_being_spilled_;
+
+  base::WeakPtrFactory<BlobStorageController> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(BlobStorageController);
 };
 
@@ -3,8 +3,11 @@
 // found in the LICENSE file.
 
 #include "base/file_path.h"
+#include "base/file_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/message_loop_proxy.h"
 #include "base/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webkit/blob/blob_data.h"
@@ -73,4 +76,51 @@ TEST(BlobStorageControllerTest, RegisterBlobUrl) {
   EXPECT_TRUE(!blob_data_found);
 }
 
+TEST(BlobStorageControllerTest, SpillToDisk) {
+  MessageLoop message_loop;
+  BlobStorageController blob_storage_controller;
+  blob_storage_controller.EnableDiskSpill(
+      base::MessageLoopProxy::current(), 4);
+
+  scoped_refptr<BlobData> blob_data(new BlobData());
+  blob_data->AppendData("Data1");
+  blob_data->AppendData("Data2");
+  blob_data->set_content_type("text/plain");
+
+  GURL blob_url1("blob://url_1");
+  GURL blob_url2("blob://url_2");
+  blob_storage_controller.AddFinishedBlob(blob_url1, blob_data);
+  blob_storage_controller.CloneBlob(blob_url2, blob_url1);
+
+  // The data stays in memory until it has been written out.
+  BlobData* blob_data_found =
+      blob_storage_controller.GetBlobDataFromUrl(blob_url1);
+  ASSERT_TRUE(blob_data_found != NULL);
+  EXPECT_EQ(10, blob_data_found->GetMemoryUsage());
+  MessageLoop::current()->RunAllPending();
+
+  // Both urls now refer to a single range of the spill file.
+  blob_data_found = blob_storage_controller.GetBlobDataFromUrl(blob_url1);
+  ASSERT_TRUE(blob_data_found != NULL);
+  EXPECT_EQ(blob_data_found,
+            blob_storage_controller.GetBlobDataFromUrl(blob_url2));
+  EXPECT_EQ(0, blob_data_found->GetMemoryUsage());
+  EXPECT_EQ("text/plain", blob_data_found->content_type());
+  ASSERT_EQ(1u, blob_data_found->items().size());
+  const BlobData::Item& item = blob_data_found->items()[0];
+  EXPECT_EQ(BlobData::Item::TYPE_FILE, item.type());
+  EXPECT_EQ(0u, item.offset());
+  EXPECT_EQ(10u, item.length());
+  const FilePath file_path = item.path();
+  std::string contents;
+  EXPECT_TRUE(file_util::ReadFileToString(file_path, &contents));
+  EXPECT_EQ("Data1Data2", contents);
+
+  // The file goes away with the last reference to the blob.
+  blob_storage_controller.RemoveBlob(blob_url1);
+  blob_storage_controller.RemoveBlob(blob_url2);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(file_util::PathExists(file_path));
+}
+
 }  // namespace webkit_blob
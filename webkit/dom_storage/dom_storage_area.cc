@@ -4,6 +4,8 @@
 
 #include "webkit/dom_storage/dom_storage_area.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -24,13 +26,44 @@ using webkit_database::DatabaseUtil;
 
 namespace dom_storage {
 
+// Delay for a moment after a value is set in anticipation
+// of other values being set, so changes are batched.
 static const int kCommitTimerSeconds = 1;
 
+// Pages that write continuously would otherwise cause a disk write every
+// |kCommitTimerSeconds|. Beyond these rates commits are pushed further
+// out, so rapid changes to the same keys collapse into fewer, later writes.
+static const int64 kMaxCommitsPerHour = 60;
+static const int64 kMaxBytesPerHour = kPerAreaQuota;
+
+DomStorageArea::RateLimiter::RateLimiter(int64 desired_rate,
+                                         base::TimeDelta time_quantum)
+    : rate_(desired_rate), samples_(0), time_quantum_(time_quantum) {
+  DCHECK_GT(desired_rate, 0);
+}
+
+base::TimeDelta DomStorageArea::RateLimiter::ComputeDelayNeeded(
+    base::TimeDelta elapsed_time) const {
+  base::TimeDelta time_needed = (time_quantum_ / rate_) * samples_;
+  if (time_needed > elapsed_time)
+    return time_needed - elapsed_time;
+  return base::TimeDelta();
+}
+
 DomStorageArea::CommitBatch::CommitBatch()
   : clear_all_first(false) {
 }
 DomStorageArea::CommitBatch::~CommitBatch() {}
 
+size_t DomStorageArea::CommitBatch::GetDataSize() const {
+  size_t count = 0;
+  for (ValuesMap::const_iterator it = changed_values.begin();
+       it != changed_values.end(); ++it) {
+    count += it->first.length() + it->second.string().length();
+  }
+  return count * sizeof(char16);
+}
+
 
 // static
 const FilePath::CharType DomStorageArea::kDatabaseFileExtension[] =
@@ -62,7 +95,11 @@ DomStorageArea::DomStorageArea(const GURL& origin, const FilePath& directory,
       map_(new DomStorageMap(kPerAreaQuota + kPerAreaOverQuotaAllowance)),
       is_initial_import_done_(true),
       is_shutdown_(false),
-      commit_batches_in_flight_(0) {
+      commit_batches_in_flight_(0),
+      start_time_(base::TimeTicks::Now()),
+      data_rate_limiter_(kMaxBytesPerHour, base::TimeDelta::FromHours(1)),
+      commit_rate_limiter_(kMaxCommitsPerHour,
+                           base::TimeDelta::FromHours(1)) {
   if (!directory.empty()) {
     FilePath path = directory.Append(DatabaseFileNameFromOrigin(origin_));
     backing_.reset(new LocalStorageDatabaseAdapter(path));
@@ -84,7 +121,11 @@ DomStorageArea::DomStorageArea(
       session_storage_backing_(session_storage_backing),
       is_initial_import_done_(true),
       is_shutdown_(false),
-      commit_batches_in_flight_(0) {
+      commit_batches_in_flight_(0),
+      start_time_(base::TimeTicks::Now()),
+      data_rate_limiter_(kMaxBytesPerHour, base::TimeDelta::FromHours(1)),
+      commit_rate_limiter_(kMaxCommitsPerHour,
+                           base::TimeDelta::FromHours(1)) {
   DCHECK(namespace_id != kLocalStorageNamespaceId);
   if (session_storage_backing) {
     backing_.reset(new SessionStorageDatabaseAdapter(
@@ -270,16 +311,28 @@ DomStorageArea::CommitBatch* DomStorageArea::CreateCommitBatchIfNeeded() {
     // Start a timer to commit any changes that accrue in the batch, but only if
     // no commits are currently in flight. In that case the timer will be
     // started after the commits have happened.
-    if (!commit_batches_in_flight_) {
-      task_runner_->PostDelayedTask(
-          FROM_HERE,
-          base::Bind(&DomStorageArea::OnCommitTimer, this),
-          base::TimeDelta::FromSeconds(kCommitTimerSeconds));
-    }
+    if (!commit_batches_in_flight_)
+      StartCommitTimer();
   }
   return commit_batch_.get();
 }
 
+void DomStorageArea::StartCommitTimer() {
+  task_runner_->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&DomStorageArea::OnCommitTimer, this),
+      ComputeCommitDelay());
+}
+
+base::TimeDelta DomStorageArea::ComputeCommitDelay() const {
+  base::TimeDelta elapsed_time = base::TimeTicks::Now() - start_time_;
+  base::TimeDelta rate_delay = std::max(
+      commit_rate_limiter_.ComputeDelayNeeded(elapsed_time),
+      data_rate_limiter_.ComputeDelayNeeded(elapsed_time));
+  return std::max(base::TimeDelta::FromSeconds(kCommitTimerSeconds),
+                  rate_delay);
+}
+
 void DomStorageArea::OnCommitTimer() {
   if (is_shutdown_)
     return;
@@ -294,6 +347,8 @@ void DomStorageArea::OnCommitTimer() {
   // This method executes on the primary sequence, we schedule
   // a task for immediate execution on the commit sequence.
   DCHECK(task_runner_->IsRunningOnPrimarySequence());
+  commit_rate_limiter_.add_samples(1);
+  data_rate_limiter_.add_samples(commit_batch_->GetDataSize());
   bool success = task_runner_->PostShutdownBlockingTask(
       FROM_HERE,
       DomStorageTaskRunner::COMMIT_SEQUENCE,
@@ -322,10 +377,7 @@ void DomStorageArea::OnCommitComplete() {
     return;
   if (commit_batch_.get() && !commit_batches_in_flight_) {
     // More changes have accrued, restart the timer.
-    task_runner_->PostDelayedTask(
-        FROM_HERE,
-        base::Bind(&DomStorageArea::OnCommitTimer, this),
-        base::TimeDelta::FromSeconds(kCommitTimerSeconds));
+    StartCommitTimer();
   }
 }
 
@@ -11,6 +11,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/nullable_string16.h"
 #include "base/string16.h"
+#include "base/time.h"
 #include "googleurl/src/gurl.h"
 #include "webkit/dom_storage/dom_storage_types.h"
 
@@ -87,14 +88,35 @@ class DomStorageArea
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitChangesAtShutdown);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, DeleteOrigin);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, PurgeMemory);
+  FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, RateLimiter);
   FRIEND_TEST_ALL_PREFIXES(DomStorageContextTest, PersistentIds);
   friend class base::RefCountedThreadSafe<DomStorageArea>;
 
+  // Tracks an amount of work done, such as commits made or bytes written,
+  // and computes how long to wait before doing more so that the average
+  // stays under |desired_rate| units per |time_quantum|.
+  class RateLimiter {
+   public:
+    RateLimiter(int64 desired_rate, base::TimeDelta time_quantum);
+
+    void add_samples(int64 samples) { samples_ += samples; }
+
+    // Returns how much longer than |elapsed_time| it should have taken to
+    // produce the samples added so far, or zero if we're under the rate.
+    base::TimeDelta ComputeDelayNeeded(base::TimeDelta elapsed_time) const;
+
+   private:
+    int64 rate_;
+    int64 samples_;
+    base::TimeDelta time_quantum_;
+  };
+
   struct CommitBatch {
     bool clear_all_first;
     ValuesMap changed_values;
     CommitBatch();
     ~CommitBatch();
+    size_t GetDataSize() const;
   };
 
   ~DomStorageArea();
@@ -108,6 +130,8 @@ class DomStorageArea
   // disk on the commit sequence, and to call back on the primary
   // task sequence when complete.
   CommitBatch* CreateCommitBatchIfNeeded();
+  void StartCommitTimer();
+  base::TimeDelta ComputeCommitDelay() const;
   void OnCommitTimer();
   void CommitChanges(const CommitBatch* commit_batch);
   void OnCommitComplete();
@@ -126,6 +150,9 @@ class DomStorageArea
   bool is_shutdown_;
   scoped_ptr<CommitBatch> commit_batch_;
   int commit_batches_in_flight_;
+  base::TimeTicks start_time_;
+  RateLimiter data_rate_limiter_;
+  RateLimiter commit_rate_limiter_;
 };
 
 }  // namespace dom_storage
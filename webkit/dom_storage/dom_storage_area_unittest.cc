@@ -424,6 +424,29 @@ TEST_F(DomStorageAreaTest, PurgeMemory) {
   EXPECT_NE(original_map, area->map_.get());
 }
 
+TEST_F(DomStorageAreaTest, RateLimiter) {
+  // Limit to 1000 samples per second.
+  DomStorageArea::RateLimiter rate_limiter(
+      1000, base::TimeDelta::FromSeconds(1));
+
+  // No samples have been added, no time has elapsed.
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+
+  // Add 2000 samples, they should take 2 seconds.
+  rate_limiter.add_samples(2000);
+  EXPECT_EQ(base::TimeDelta::FromSeconds(2),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromSeconds(1)));
+
+  // Once enough time has passed no delay is needed.
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromSeconds(2)));
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromSeconds(5)));
+}
+
 TEST_F(DomStorageAreaTest, DatabaseFileNames) {
   struct {
     const char* origin;
@@ -71,6 +71,7 @@ const char kLastFileIdKey[] = "LAST_FILE_ID";
 const char kLastIntegerKey[] = "LAST_INTEGER";
 const int64 kMinimumReportIntervalHours = 1;
 const char kInitStatusHistogramLabel[] = "FileSystem.DirectoryDatabaseInit";
+const size_t kPathCacheSize = 1024;
 
 enum InitStatus {
   INIT_STATUS_OK = 0,
@@ -379,7 +380,8 @@ FileSystemDirectoryDatabase::FileInfo::~FileInfo() {
 
 FileSystemDirectoryDatabase::FileSystemDirectoryDatabase(
     const FilePath& filesystem_data_directory)
-    : filesystem_data_directory_(filesystem_data_directory) {
+    : filesystem_data_directory_(filesystem_data_directory),
+      path_cache_(kPathCacheSize) {
 }
 
 FileSystemDirectoryDatabase::~FileSystemDirectoryDatabase() {
@@ -411,15 +413,33 @@ bool FileSystemDirectoryDatabase::GetFileWithPath(
     const FilePath& path, FileId* file_id) {
   std::vector<FilePath::StringType> components;
   VirtualPath::GetComponents(path, &components);
-  FileId local_id = 0;
+  std::vector<FilePath::StringType> names;
+  std::vector<FilePath::StringType> keys;
+  FilePath::StringType key;
   std::vector<FilePath::StringType>::iterator iter;
   for (iter = components.begin(); iter != components.end(); ++iter) {
-    FilePath::StringType name;
-    name = *iter;
-    if (name == FILE_PATH_LITERAL("/"))
+    if (*iter == FILE_PATH_LITERAL("/"))
       continue;
-    if (!GetChildWithName(local_id, name, &local_id))
+    key.push_back(FilePath::kSeparators[0]);
+    key.append(*iter);
+    names.push_back(*iter);
+    keys.push_back(key);
+  }
+
+  // Start from the deepest ancestor we've already resolved.
+  FileId local_id = 0;
+  size_t resolved = names.size();
+  for (; resolved > 0; --resolved) {
+    PathCache::iterator found = path_cache_.Get(keys[resolved - 1]);
+    if (found != path_cache_.end()) {
+      local_id = found->second;
+      break;
+    }
+  }
+  for (; resolved < names.size(); ++resolved) {
+    if (!GetChildWithName(local_id, names[resolved], &local_id))
       return false;
+    path_cache_.Put(keys[resolved], local_id);
   }
   *file_id = local_id;
   return true;
@@ -522,6 +542,7 @@ bool FileSystemDirectoryDatabase::AddFileInfo(
 bool FileSystemDirectoryDatabase::RemoveFileInfo(FileId file_id) {
   if (!Init(REPAIR_ON_CORRUPTION))
     return false;
+  path_cache_.Clear();
   leveldb::WriteBatch batch;
   if (!RemoveFileInfoHelper(file_id, &batch))
     return false;
@@ -555,6 +576,8 @@ bool FileSystemDirectoryDatabase::UpdateFileInfo(
       return false;
     }
   }
+  // A move or rename changes the paths of everything below |file_id|.
+  path_cache_.Clear();
   leveldb::WriteBatch batch;
   if (!RemoveFileInfoHelper(file_id, &batch) ||
       !AddFileInfoHelper(new_info, file_id, &batch))
@@ -599,6 +622,7 @@ bool FileSystemDirectoryDatabase::OverwritingMoveFile(
     return false;
   if (src_file_info.is_directory() || dest_file_info.is_directory())
     return false;
+  path_cache_.Clear();
   leveldb::WriteBatch batch;
   // This is the only field that really gets moved over; if you add fields to
   // FileInfo, e.g. ctime, they might need to be copied here.
@@ -669,6 +693,10 @@ bool FileSystemDirectoryDatabase::Init(RecoveryOption recovery_option) {
   if (db_.get())
     return true;
 
+  // The database may have been repaired or recreated since we last had it
+  // open, so nothing we resolved before can be trusted.
+  path_cache_.Clear();
+
   std::string path =
       FilePathToString(filesystem_data_directory_.Append(
           kDirectoryDatabaseName));
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/file_path.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time.h"
 #include "webkit/fileapi/fileapi_export.h"
@@ -99,6 +100,11 @@ class FILEAPI_EXPORT_PRIVATE FileSystemDirectoryDatabase {
 
   friend class FileSystemDirectoryDatabaseTest;
 
+  // Maps normalized virtual paths to the FileIds GetFileWithPath resolved
+  // them to, so that repeated lookups under the same directory don't walk
+  // the database one component at a time.
+  typedef base::MRUCache<FilePath::StringType, FileId> PathCache;
+
   bool Init(RecoveryOption recovery_option);
   bool RepairDatabase(const std::string& db_path);
   void ReportInitStatus(const leveldb::Status& status);
@@ -113,6 +119,7 @@ class FILEAPI_EXPORT_PRIVATE FileSystemDirectoryDatabase {
 
   FilePath filesystem_data_directory_;
   scoped_ptr<leveldb::DB> db_;
+  PathCache path_cache_;
   base::Time last_reported_time_;
   DISALLOW_COPY_AND_ASSIGN(FileSystemDirectoryDatabase);
 };
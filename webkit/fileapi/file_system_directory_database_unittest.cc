@@ -314,6 +314,37 @@ TEST_F(FileSystemDirectoryDatabaseTest, TestGetFileWithPath) {
   EXPECT_EQ(file_id2, check_file_id);
 }
 
+TEST_F(FileSystemDirectoryDatabaseTest, TestGetFileWithPathAfterMove) {
+  FileId dir_id;
+  FileId subdir_id;
+  FileId file_id;
+  CreateDirectory(0, FPL("foo"), &dir_id);
+  CreateDirectory(dir_id, FPL("bar"), &subdir_id);
+  CreateFile(subdir_id, FPL("dog"), FPL("dog_data"), &file_id);
+
+  // Resolve the path once so that it is cached.
+  FileId check_file_id;
+  const FilePath old_path = FilePath(FPL("foo")).Append(FPL("bar"))
+      .Append(FPL("dog"));
+  EXPECT_TRUE(db()->GetFileWithPath(old_path, &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  // Renaming the parent directory moves everything below it.
+  FileInfo info;
+  ASSERT_TRUE(db()->GetFileInfo(subdir_id, &info));
+  info.name = FPL("cat");
+  EXPECT_TRUE(db()->UpdateFileInfo(subdir_id, info));
+
+  EXPECT_FALSE(db()->GetFileWithPath(old_path, &check_file_id));
+  const FilePath new_path = FilePath(FPL("foo")).Append(FPL("cat"))
+      .Append(FPL("dog"));
+  EXPECT_TRUE(db()->GetFileWithPath(new_path, &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  EXPECT_TRUE(db()->RemoveFileInfo(file_id));
+  EXPECT_FALSE(db()->GetFileWithPath(new_path, &check_file_id));
+}
+
 TEST_F(FileSystemDirectoryDatabaseTest, TestListChildren) {
   // No children in the root.
   std::vector<FileId> children;
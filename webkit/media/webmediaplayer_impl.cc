@@ -271,7 +271,8 @@ void WebMediaPlayerImpl::load(const WebKit::WebURL& url, CORSMode cors_mode) {
         BIND_TO_RENDER_LOOP(&WebMediaPlayerImpl::OnDemuxerOpened),
         base::Bind(&OnDemuxerNeedKeyTrampoline,
                    main_loop_->message_loop_proxy(),
-                   base::Bind(&WebMediaPlayerImpl::OnNeedKey, AsWeakPtr())));
+                   base::Bind(&WebMediaPlayerImpl::OnNeedKey, AsWeakPtr())),
+        media_log_);
 
     BuildMediaSourceCollection(chunk_demuxer_,
                                message_loop_factory_.get(),
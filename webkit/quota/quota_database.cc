@@ -23,12 +23,21 @@ namespace {
 
 // Definitions for database schema.
 
-const int kCurrentVersion = 4;
+const int kCurrentVersion = 5;
 const int kCompatibleVersion = 2;
 
 const char kHostQuotaTable[] = "HostQuotaTable";
 const char kOriginInfoTable[] = "OriginInfoTable";
+const char kOriginUsageTable[] = "OriginUsageTable";
 const char kIsOriginTableBootstrapped[] = "IsOriginTableBootstrapped";
+const char kIsOriginUsageTableValid[] = "IsOriginUsageTableValid";
+
+const char kOriginUsageTableColumns[] =
+    "(origin TEXT NOT NULL,"
+    " type INTEGER NOT NULL,"
+    " client_id INTEGER NOT NULL,"
+    " usage INTEGER DEFAULT 0,"
+    " UNIQUE(origin, type, client_id))";
 
 class HistogramUniquifier {
  public:
@@ -67,6 +76,8 @@ const QuotaDatabase::TableSchema QuotaDatabase::kTables[] = {
     " last_access_time INTEGER DEFAULT 0,"
     " last_modified_time INTEGER DEFAULT 0,"
     " UNIQUE(origin, type))" },
+  { kOriginUsageTable,
+    kOriginUsageTableColumns },
 };
 
 // static
@@ -130,6 +141,23 @@ QuotaDatabase::OriginInfoTableEntry::OriginInfoTableEntry(
       last_modified_time(last_modified_time) {
 }
 
+QuotaDatabase::OriginUsageTableEntry::OriginUsageTableEntry()
+    : type(kStorageTypeUnknown),
+      client_id(QuotaClient::kUnknown),
+      usage(0) {
+}
+
+QuotaDatabase::OriginUsageTableEntry::OriginUsageTableEntry(
+    const GURL& origin,
+    StorageType type,
+    QuotaClient::ID client_id,
+    int64 usage)
+    : origin(origin),
+      type(type),
+      client_id(client_id),
+      usage(usage) {
+}
+
 // QuotaDatabase ------------------------------------------------------------
 QuotaDatabase::QuotaDatabase(const FilePath& path)
     : db_file_path_(path),
@@ -385,6 +413,73 @@ bool QuotaDatabase::GetOriginsModifiedSince(
   return statement.Succeeded();
 }
 
+bool QuotaDatabase::SetOriginUsageCache(const OriginUsageEntries& entries) {
+  if (!LazyOpen(true))
+    return false;
+
+  if (!db_->Execute("DELETE FROM OriginUsageTable"))
+    return false;
+
+  const char* kSql =
+      "INSERT INTO OriginUsageTable"
+      " (origin, type, client_id, usage)"
+      " VALUES (?, ?, ?, ?)";
+  for (OriginUsageEntries::const_iterator iter = entries.begin();
+       iter != entries.end(); ++iter) {
+    sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+    statement.BindString(0, iter->origin.spec());
+    statement.BindInt(1, static_cast<int>(iter->type));
+    statement.BindInt(2, static_cast<int>(iter->client_id));
+    statement.BindInt64(3, iter->usage);
+
+    if (!statement.Run())
+      return false;
+  }
+
+  if (!meta_table_->SetValue(kIsOriginUsageTableValid, true))
+    return false;
+
+  Commit();
+  return true;
+}
+
+bool QuotaDatabase::TakeOriginUsageCache(OriginUsageEntries* entries) {
+  DCHECK(entries);
+  entries->clear();
+  if (!LazyOpen(false))
+    return false;
+
+  int valid = 0;
+  if (!meta_table_->GetValue(kIsOriginUsageTableValid, &valid) || !valid)
+    return false;
+
+  const char* kSql =
+      "SELECT origin, type, client_id, usage FROM OriginUsageTable";
+  sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+
+  while (statement.Step()) {
+    entries->push_back(OriginUsageTableEntry(
+        GURL(statement.ColumnString(0)),
+        static_cast<StorageType>(statement.ColumnInt(1)),
+        static_cast<QuotaClient::ID>(statement.ColumnInt(2)),
+        statement.ColumnInt64(3)));
+  }
+  if (!statement.Succeeded()) {
+    entries->clear();
+    return false;
+  }
+
+  // Make sure a crash during this session can't leave a stale snapshot
+  // looking valid to the next one.
+  if (!meta_table_->SetValue(kIsOriginUsageTableValid, false) ||
+      !db_->Execute("DELETE FROM OriginUsageTable")) {
+    entries->clear();
+    return false;
+  }
+  Commit();
+  return true;
+}
+
 bool QuotaDatabase::IsOriginDatabaseBootstrapped() {
   if (!LazyOpen(true))
     return false;
@@ -599,6 +694,15 @@ bool QuotaDatabase::UpgradeSchema(int current_version) {
     Commit();
     return true;
   }
+  if (current_version == 4) {
+    std::string sql("CREATE TABLE ");
+    sql += kOriginUsageTable;
+    sql += kOriginUsageTableColumns;
+    if (!db_->Execute(sql.c_str()))
+      return false;
+    meta_table_->SetVersionNumber(kCurrentVersion);
+    return true;
+  }
   return false;
 }
 
@@ -7,6 +7,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/callback.h"
@@ -16,6 +17,7 @@
 #include "base/time.h"
 #include "base/timer.h"
 #include "googleurl/src/gurl.h"
+#include "webkit/quota/quota_client.h"
 #include "webkit/quota/quota_types.h"
 
 namespace sql {
@@ -36,6 +38,20 @@ class QuotaDatabase {
   static const char kDesiredAvailableSpaceKey[];
   static const char kTemporaryQuotaOverrideKey[];
 
+  struct OriginUsageTableEntry {
+    OriginUsageTableEntry();
+    OriginUsageTableEntry(
+        const GURL& origin,
+        StorageType type,
+        QuotaClient::ID client_id,
+        int64 usage);
+    GURL origin;
+    StorageType type;
+    QuotaClient::ID client_id;
+    int64 usage;
+  };
+  typedef std::vector<OriginUsageTableEntry> OriginUsageEntries;
+
   // If 'path' is empty, an in memory database will be used.
   explicit QuotaDatabase(const FilePath& path);
   ~QuotaDatabase();
@@ -80,6 +96,17 @@ class QuotaDatabase {
                                std::set<GURL>* origins,
                                base::Time modified_since);
 
+  // Saves a snapshot of the per-client usage of each origin, replacing any
+  // previously saved one, so that the next session can start with a warm
+  // usage cache instead of asking every client to scan its storage.
+  bool SetOriginUsageCache(const OriginUsageEntries& entries);
+
+  // Populates |entries| with the snapshot saved by SetOriginUsageCache and
+  // discards it, since the usage recorded there goes stale as soon as the
+  // current session modifies any storage. Returns false, leaving |entries|
+  // empty, if there is no valid snapshot, e.g. after a crash.
+  bool TakeOriginUsageCache(OriginUsageEntries* entries);
+
   // Returns false if SetOriginDatabaseBootstrapped has never
   // been called before, which means existing origins may not have been
   // registered.
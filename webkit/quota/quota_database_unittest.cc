@@ -323,6 +323,44 @@ class QuotaDatabaseTest : public testing::Test {
     EXPECT_EQ(1, used_count);
   }
 
+  void OriginUsageCache(const FilePath& kDbFile) {
+    typedef QuotaDatabase::OriginUsageTableEntry Entry;
+    QuotaDatabase db(kDbFile);
+
+    // Nothing has been saved yet.
+    QuotaDatabase::OriginUsageEntries entries;
+    EXPECT_FALSE(db.TakeOriginUsageCache(&entries));
+    EXPECT_TRUE(entries.empty());
+
+    QuotaDatabase::OriginUsageEntries saved;
+    saved.push_back(Entry(GURL("http://a/"), kStorageTypeTemporary,
+                          QuotaClient::kFileSystem, 10));
+    saved.push_back(Entry(GURL("http://a/"), kStorageTypeTemporary,
+                          QuotaClient::kDatabase, 20));
+    saved.push_back(Entry(GURL("http://b/"), kStorageTypePersistent,
+                          QuotaClient::kFileSystem, 30));
+    EXPECT_TRUE(db.SetOriginUsageCache(saved));
+
+    EXPECT_TRUE(db.TakeOriginUsageCache(&entries));
+    ASSERT_EQ(saved.size(), entries.size());
+    for (size_t i = 0; i < saved.size(); ++i) {
+      bool found = false;
+      for (size_t j = 0; j < entries.size(); ++j) {
+        if (entries[j].origin == saved[i].origin &&
+            entries[j].type == saved[i].type &&
+            entries[j].client_id == saved[i].client_id) {
+          EXPECT_EQ(saved[i].usage, entries[j].usage);
+          found = true;
+        }
+      }
+      EXPECT_TRUE(found);
+    }
+
+    // Taking the snapshot invalidates it.
+    EXPECT_FALSE(db.TakeOriginUsageCache(&entries));
+    EXPECT_TRUE(entries.empty());
+  }
+
   template <typename EntryType>
   struct EntryVerifier {
     std::set<EntryType> table;
@@ -553,6 +591,14 @@ TEST_F(QuotaDatabaseTest, BootstrapFlag) {
   EXPECT_FALSE(db.IsOriginDatabaseBootstrapped());
 }
 
+TEST_F(QuotaDatabaseTest, OriginUsageCache) {
+  ScopedTempDir data_dir;
+  ASSERT_TRUE(data_dir.CreateUniqueTempDir());
+  const FilePath kDbFile = data_dir.path().AppendASCII("quota_manager.db");
+  OriginUsageCache(kDbFile);
+  OriginUsageCache(FilePath());
+}
+
 TEST_F(QuotaDatabaseTest, RegisterInitialOriginInfo) {
   ScopedTempDir data_dir;
   ASSERT_TRUE(data_dir.CreateUniqueTempDir());
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <map>
 #include <set>
 
 #include "base/bind.h"
@@ -93,15 +94,30 @@ bool SetPersistentHostQuotaOnDBThread(const std::string& host,
 
 bool InitializeOnDBThread(int64* temporary_quota_override,
                           int64* desired_available_space,
+                          QuotaDatabase::OriginUsageEntries* usage_entries,
                           QuotaDatabase* database) {
   DCHECK(database);
   database->GetQuotaConfigValue(QuotaDatabase::kTemporaryQuotaOverrideKey,
                                 temporary_quota_override);
   database->GetQuotaConfigValue(QuotaDatabase::kDesiredAvailableSpaceKey,
                                 desired_available_space);
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  if (database->TakeOriginUsageCache(usage_entries)) {
+    UMA_HISTOGRAM_TIMES("Quota.TimeToLoadUsageCache",
+                        base::TimeTicks::Now() - start_time);
+  }
+  UMA_HISTOGRAM_BOOLEAN("Quota.UsageCacheRestored", !usage_entries->empty());
   return true;
 }
 
+void SaveUsageCacheOnDBThread(
+    const QuotaDatabase::OriginUsageEntries* usage_entries,
+    QuotaDatabase* database) {
+  DCHECK(database);
+  database->SetOriginUsageCache(*usage_entries);
+}
+
 bool GetLRUOriginOnDBThread(StorageType type,
                             std::set<GURL>* exceptions,
                             SpecialStoragePolicy* policy,
@@ -1141,6 +1157,16 @@ bool QuotaManager::ResetUsageTracker(StorageType type) {
 }
 
 QuotaManager::~QuotaManager() {
+  if (database_.get() && !db_disabled_) {
+    QuotaDatabase::OriginUsageEntries* usage_entries =
+        new QuotaDatabase::OriginUsageEntries;
+    GetCachedUsageEntries(usage_entries);
+    db_thread_->PostTask(
+        FROM_HERE,
+        base::Bind(&SaveUsageCacheOnDBThread,
+                   base::Owned(usage_entries),
+                   base::Unretained(database_.get())));
+  }
   proxy_->manager_ = NULL;
   std::for_each(clients_.begin(), clients_.end(),
                 std::mem_fun(&QuotaClient::OnQuotaManagerDestroyed));
@@ -1178,15 +1204,19 @@ void QuotaManager::LazyInitialize() {
 
   int64* temporary_quota_override = new int64(-1);
   int64* desired_available_space = new int64(-1);
+  QuotaDatabase::OriginUsageEntries* usage_entries =
+      new QuotaDatabase::OriginUsageEntries;
   PostTaskAndReplyWithResultForDBThread(
       FROM_HERE,
       base::Bind(&InitializeOnDBThread,
                  base::Unretained(temporary_quota_override),
-                 base::Unretained(desired_available_space)),
+                 base::Unretained(desired_available_space),
+                 base::Unretained(usage_entries)),
       base::Bind(&QuotaManager::DidInitialize,
                  weak_factory_.GetWeakPtr(),
                  base::Owned(temporary_quota_override),
-                 base::Owned(desired_available_space)));
+                 base::Owned(desired_available_space),
+                 base::Owned(usage_entries)));
 }
 
 void QuotaManager::RegisterClient(QuotaClient* client) {
@@ -1507,14 +1537,20 @@ void QuotaManager::DidSetPersistentHostQuota(const std::string& host,
   callback.Run(success ? kQuotaStatusOk : kQuotaErrorInvalidAccess, *new_quota);
 }
 
-void QuotaManager::DidInitialize(int64* temporary_quota_override,
-                                 int64* desired_available_space,
-                                 bool success) {
+void QuotaManager::DidInitialize(
+    int64* temporary_quota_override,
+    int64* desired_available_space,
+    QuotaDatabase::OriginUsageEntries* usage_entries,
+    bool success) {
   temporary_quota_override_ = *temporary_quota_override;
   desired_available_space_ = *desired_available_space;
   temporary_quota_initialized_ = true;
   DidDatabaseWork(success);
 
+  // Seed the trackers before kicking the initial global usage query below,
+  // so that it only has to ask the clients about origins we don't know.
+  SeedUsageTrackers(*usage_entries);
+
   histogram_timer_.Start(FROM_HERE,
                          base::TimeDelta::FromMilliseconds(
                              kReportHistogramInterval),
@@ -1535,7 +1571,7 @@ void QuotaManager::DidInitialize(int64* temporary_quota_override,
   // caches) the usage of all origins and checks the available disk space.
   GetTemporaryGlobalQuota(
       base::Bind(&QuotaManager::DidGetInitialTemporaryGlobalQuota,
-                 weak_factory_.GetWeakPtr()));
+                 weak_factory_.GetWeakPtr(), base::TimeTicks::Now()));
 }
 
 void QuotaManager::DidGetLRUOrigin(const GURL* origin,
@@ -1553,7 +1589,9 @@ void QuotaManager::DidGetLRUOrigin(const GURL* origin,
 }
 
 void QuotaManager::DidGetInitialTemporaryGlobalQuota(
-    QuotaStatusCode status, int64 quota_unused) {
+    base::TimeTicks start_time, QuotaStatusCode status, int64 quota_unused) {
+  UMA_HISTOGRAM_TIMES("Quota.TimeToGetInitialTemporaryGlobalQuota",
+                      base::TimeTicks::Now() - start_time);
   if (eviction_disabled_)
     return;
 
@@ -1584,6 +1622,63 @@ void QuotaManager::DidDatabaseWork(bool success) {
   db_disabled_ = !success;
 }
 
+void QuotaManager::SeedUsageTrackers(
+    const QuotaDatabase::OriginUsageEntries& entries) {
+  typedef std::map<GURL, int64> OriginUsageMap;
+  typedef std::map<std::pair<StorageType, QuotaClient::ID>, OriginUsageMap>
+      ClientUsageMap;
+  ClientUsageMap client_usage;
+  for (QuotaDatabase::OriginUsageEntries::const_iterator iter =
+           entries.begin();
+       iter != entries.end(); ++iter) {
+    client_usage[std::make_pair(iter->type, iter->client_id)][iter->origin] =
+        iter->usage;
+  }
+
+  for (ClientUsageMap::const_iterator iter = client_usage.begin();
+       iter != client_usage.end(); ++iter) {
+    StorageType type = iter->first.first;
+    if (type != kStorageTypeTemporary &&
+        type != kStorageTypePersistent &&
+        type != kStorageTypeSyncable) {
+      continue;
+    }
+    ClientUsageTracker* client_tracker =
+        GetUsageTracker(type)->GetClientTracker(iter->first.second);
+    if (client_tracker)
+      client_tracker->SeedUsageCache(iter->second);
+  }
+}
+
+void QuotaManager::GetCachedUsageEntries(
+    QuotaDatabase::OriginUsageEntries* entries) const {
+  DCHECK(entries);
+  const StorageType kTypes[] = {
+    kStorageTypeTemporary,
+    kStorageTypePersistent,
+    kStorageTypeSyncable,
+  };
+  for (size_t i = 0; i < arraysize(kTypes); ++i) {
+    UsageTracker* tracker = GetUsageTracker(kTypes[i]);
+    if (!tracker)
+      continue;
+    for (QuotaClientList::const_iterator client = clients_.begin();
+         client != clients_.end(); ++client) {
+      ClientUsageTracker* client_tracker =
+          tracker->GetClientTracker((*client)->id());
+      if (!client_tracker)
+        continue;
+      std::map<GURL, int64> origin_usage;
+      client_tracker->GetCachedOriginsUsage(&origin_usage);
+      for (std::map<GURL, int64>::const_iterator iter = origin_usage.begin();
+           iter != origin_usage.end(); ++iter) {
+        entries->push_back(QuotaDatabase::OriginUsageTableEntry(
+            iter->first, kTypes[i], (*client)->id(), iter->second));
+      }
+    }
+  }
+}
+
 void QuotaManager::DeleteOnCorrectThread() const {
   if (!io_thread_->BelongsToCurrentThread() &&
       io_thread_->DeleteSoon(FROM_HERE, this)) {
@@ -344,16 +344,23 @@ class QuotaManager : public QuotaTaskObserver,
                                  bool success);
   void DidInitialize(int64* temporary_quota_override,
                      int64* desired_available_space,
+                     QuotaDatabase::OriginUsageEntries* usage_entries,
                      bool success);
   void DidGetLRUOrigin(const GURL* origin,
                        bool success);
-  void DidGetInitialTemporaryGlobalQuota(QuotaStatusCode status,
+  void DidGetInitialTemporaryGlobalQuota(base::TimeTicks start_time,
+                                         QuotaStatusCode status,
                                          int64 quota_unused);
   void DidInitializeTemporaryOriginsInfo(bool success);
   void DidGetAvailableSpace(const AvailableSpaceCallback& callback,
                             int64 space);
   void DidDatabaseWork(bool success);
 
+  // Moves usage cached by a previous session into the usage trackers, and
+  // collects the usage cached in this one to be saved at shutdown.
+  void SeedUsageTrackers(const QuotaDatabase::OriginUsageEntries& entries);
+  void GetCachedUsageEntries(QuotaDatabase::OriginUsageEntries* entries) const;
+
   void DeleteOnCorrectThread() const;
 
   void PostTaskAndReplyWithResultForDBThread(
@@ -54,6 +54,18 @@ class QuotaManagerTest : public testing::Test {
   void SetUp() {
     ASSERT_TRUE(data_dir_.CreateUniqueTempDir());
     mock_special_storage_policy_ = new MockSpecialStoragePolicy;
+    CreateQuotaManager();
+    additional_callback_count_ = 0;
+  }
+
+  void TearDown() {
+    // Make sure the quota manager cleans up correctly.
+    quota_manager_ = NULL;
+    MessageLoop::current()->RunAllPending();
+  }
+
+ protected:
+  void CreateQuotaManager() {
     quota_manager_ = new QuotaManager(
         false /* is_incognito */,
         data_dir_.path(),
@@ -64,16 +76,16 @@ class QuotaManagerTest : public testing::Test {
     quota_manager_->eviction_disabled_ = true;
     // Don't query the hard disk for remaining capacity.
     quota_manager_->get_disk_space_fn_ = &GetAvailableDiskSpaceForTest;
-    additional_callback_count_ = 0;
   }
 
-  void TearDown() {
-    // Make sure the quota manager cleans up correctly.
+  // Shuts down the quota manager and starts a new one on the same profile,
+  // as a browser restart would.
+  void RestartQuotaManager() {
     quota_manager_ = NULL;
     MessageLoop::current()->RunAllPending();
+    CreateQuotaManager();
   }
 
- protected:
   MockStorageClient* CreateClient(
       const MockOriginData* mock_data,
       size_t mock_data_size,
@@ -1067,6 +1079,45 @@ TEST_F(QuotaManagerTest, GetUsage_Simple) {
   EXPECT_EQ(usage(), 4000 + 50000);
 }
 
+TEST_F(QuotaManagerTest, GetUsage_RestoredAfterRestart) {
+  static const MockOriginData kData[] = {
+    { "http://foo.com/", kPerm, 10 },
+    { "http://bar.com/", kPerm, 20 },
+  };
+  RegisterClient(CreateClient(kData, ARRAYSIZE_UNSAFE(kData),
+      QuotaClient::kFileSystem));
+
+  GetGlobalUsage(kPerm);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(10 + 20, usage());
+
+  // Change the data behind the quota manager's back across a restart.
+  RestartQuotaManager();
+  static const MockOriginData kChangedData[] = {
+    { "http://foo.com/", kPerm, 15 },
+    { "http://bar.com/", kPerm, 20 },
+  };
+  MockStorageClient* client = CreateClient(
+      kChangedData, ARRAYSIZE_UNSAFE(kChangedData), QuotaClient::kFileSystem);
+  RegisterClient(client);
+
+  // Wait for the database to be read, then see that the usage saved by the
+  // previous session is served without asking the client.
+  GetUsageAndQuota(GURL("http://foo.com/"), kTemp);
+  MessageLoop::current()->RunAllPending();
+  GetHostUsage("foo.com", kPerm);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(10, usage());
+
+  // A delta that would make the cached usage negative reveals the
+  // inconsistency, and the host is gathered again.
+  client->ModifyOriginAndNotify(GURL("http://foo.com/"), kPerm, -12);
+  MessageLoop::current()->RunAllPending();
+  GetHostUsage("foo.com", kPerm);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(15 - 12, usage());
+}
+
 TEST_F(QuotaManagerTest, GetUsage_WithModification) {
   static const MockOriginData kData[] = {
     { "http://foo.com/",   kPerm,       1 },
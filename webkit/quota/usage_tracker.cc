@@ -399,6 +399,16 @@ void ClientUsageTracker::UpdateUsageCache(
     const GURL& origin, int64 delta) {
   std::string host = net::GetHostOrSpecFromURL(origin);
   if (cached_hosts_.find(host) != cached_hosts_.end()) {
+    if (cached_usage_[host][origin] + delta < 0) {
+      // The client's view disagrees with ours, e.g. the cached usage was
+      // restored from a previous session and the data changed since.
+      // Gather this host's usage again rather than trust either number.
+      InvalidateCachedHost(host);
+      GetHostUsage(host,
+                   base::Bind(&ClientUsageTracker::NoopHostUsageCallback,
+                              base::Unretained(this)));
+      return;
+    }
     cached_usage_[host][origin] += delta;
     global_usage_ += delta;
     if (global_unlimited_usage_is_valid_ && IsStorageUnlimited(origin))
@@ -436,6 +446,36 @@ void ClientUsageTracker::GetCachedOrigins(std::set<GURL>* origins) const {
   }
 }
 
+void ClientUsageTracker::GetCachedOriginsUsage(
+    std::map<GURL, int64>* origin_usage) const {
+  DCHECK(origin_usage);
+  for (HostUsageMap::const_iterator host_iter = cached_usage_.begin();
+       host_iter != cached_usage_.end(); host_iter++) {
+    if (cached_hosts_.find(host_iter->first) == cached_hosts_.end())
+      continue;
+    origin_usage->insert(host_iter->second.begin(), host_iter->second.end());
+  }
+}
+
+void ClientUsageTracker::SeedUsageCache(
+    const std::map<GURL, int64>& origin_usage) {
+  HostSet seeded_hosts;
+  for (std::map<GURL, int64>::const_iterator iter = origin_usage.begin();
+       iter != origin_usage.end(); ++iter) {
+    std::string host = net::GetHostOrSpecFromURL(iter->first);
+    if (seeded_hosts.find(host) == seeded_hosts.end()) {
+      if (cached_hosts_.find(host) != cached_hosts_.end() ||
+          cached_usage_.find(host) != cached_usage_.end() ||
+          host_usage_tasks_.find(host) != host_usage_tasks_.end()) {
+        continue;
+      }
+      seeded_hosts.insert(host);
+    }
+    AddCachedOrigin(iter->first, iter->second);
+  }
+  cached_hosts_.insert(seeded_hosts.begin(), seeded_hosts.end());
+}
+
 void ClientUsageTracker::AddCachedOrigin(
     const GURL& origin, int64 usage) {
   std::string host = net::GetHostOrSpecFromURL(origin);
@@ -480,6 +520,14 @@ void ClientUsageTracker::GatherHostUsageComplete(const std::string& host) {
   host_usage_callbacks_.Run(host, GetCachedHostUsage(host));
 }
 
+void ClientUsageTracker::InvalidateCachedHost(const std::string& host) {
+  global_usage_ -= GetCachedHostUsage(host);
+  DCHECK_GE(global_usage_, 0);
+  global_unlimited_usage_is_valid_ = false;
+  cached_usage_.erase(host);
+  cached_hosts_.erase(host);
+}
+
 int64 ClientUsageTracker::GetCachedHostUsage(const std::string& host) const {
   HostUsageMap::const_iterator found = cached_usage_.find(host);
   if (found == cached_usage_.end())
@@ -95,6 +95,15 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   void GetCachedHostsUsage(std::map<std::string, int64>* host_usage) const;
   void GetCachedOrigins(std::set<GURL>* origins) const;
 
+  // Populates |origin_usage| with the usage of origins on hosts whose usage
+  // has been fully gathered, suitable for SeedUsageCache in a later session.
+  void GetCachedOriginsUsage(std::map<GURL, int64>* origin_usage) const;
+
+  // Adds |origin_usage| saved by a previous session to the cache, so that
+  // the hosts it covers need not be gathered again. Hosts that are already
+  // cached or being gathered are left alone.
+  void SeedUsageCache(const std::map<GURL, int64>& origin_usage);
+
  private:
   typedef std::set<std::string> HostSet;
   typedef std::map<GURL, int64> UsageMap;
@@ -111,6 +120,9 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   void GatherGlobalUsageComplete();
   void GatherHostUsageComplete(const std::string& host);
 
+  // Drops the cached usage for |host| so it is gathered again.
+  void InvalidateCachedHost(const std::string& host);
+
   int64 GetCachedHostUsage(const std::string& host) const;
   int64 GetCachedGlobalUnlimitedUsage();
   virtual void OnSpecialStoragePolicyChanged() OVERRIDE;